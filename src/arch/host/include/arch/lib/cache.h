@@ -17,6 +17,7 @@ static inline void dcache_invalidate_region(void *addr, size_t size) {}
 static inline void icache_invalidate_region(void *addr, size_t size) {}
 static inline void dcache_writeback_invalidate_region(void *addr,
 	size_t size) {}
+static inline void dcache_prefetch_region(const void *addr, size_t size) {}
 
 #define DCACHE_LINE_SIZE 64
 
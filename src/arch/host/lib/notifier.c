@@ -13,10 +13,9 @@
 #include <ipc/topology.h>
 #include <rtos/alloc.h>
 #include <sof/lib/notifier.h>
-
-static struct notify *host_notify;
+#include <platform/lib/context.h>
 
 struct notify **arch_notify_get(void)
 {
-	return &host_notify;
+	return &sof_lib_context_get()->notify;
 }
@@ -149,6 +149,18 @@ static inline void dcache_writeback_invalidate_all(void)
 #endif
 }
 
+/* hints only, lines of uncached addresses are not fetched */
+static inline void dcache_prefetch_region(const void *addr, size_t size)
+{
+#if XCHAL_DCACHE_SIZE > 0
+	uintptr_t line = (uintptr_t)addr & ~(uintptr_t)(DCACHE_LINE_SIZE - 1);
+	const uintptr_t end = (uintptr_t)addr + size;
+
+	for (; line < end; line += DCACHE_LINE_SIZE)
+		__asm__ __volatile__ ("dpfr %0, 0" : : "a" (line));
+#endif
+}
+
 #endif /* !defined(__ASSEMBLER__) && !defined(LINKER) */
 
 #endif /* __ARCH_LIB_CACHE_H__ */
@@ -38,7 +38,7 @@ DECLARE_SOF_RT_UUID("aria", aria_comp_uuid, 0x99f7166d, 0x372c, 0x43ef,
 
 DECLARE_TR_CTX(aria_comp_tr, SOF_UUID(aria_comp_uuid), LOG_LEVEL_INFO);
 
-static size_t get_required_emory(size_t chan_cnt, size_t smpl_group_cnt)
+static size_t get_required_memory(size_t chan_cnt, size_t smpl_group_cnt)
 {
 	/* Current implementation is able to apply 1 ms transition */
 	/* internal circular buffer aligned to 8 bytes */
@@ -88,17 +88,17 @@ static inline void aria_process_data(struct processing_module *mod,
 
 	if (cd->att) {
 		aria_algo_calc_gain(cd, INDEX_TAB[cd->gain_state + 1], source, frames);
-		cd->aria_get_data(mod, sink, frames);
+		cd->aria_get_data(mod, source, sink, frames);
 	} else {
 		/* bypass processing gets unprocessed data from buffer */
 		cir_buf_copy(cd->data_ptr, cd->data_addr, cd->data_end,
 			     sink->w_ptr, sink->addr, sink->end_addr,
 			     data_size);
+		cir_buf_copy(source->r_ptr, source->addr, source->end_addr,
+			     cd->data_ptr, cd->data_addr, cd->data_end,
+			     data_size);
 	}
 
-	cir_buf_copy(source->r_ptr, source->addr, source->end_addr,
-		     cd->data_ptr, cd->data_addr, cd->data_end,
-		     data_size);
 	cd->data_ptr = cir_buf_wrap(cd->data_ptr + sample_size, cd->data_addr, cd->data_end);
 }
 
@@ -126,7 +126,7 @@ int aria_init(struct processing_module *mod)
 	chc = base_cfg->audio_fmt.channels_count;
 	sgs = (base_cfg->audio_fmt.depth >> 3) * chc;
 	sgc = ibs / sgs;
-	req_mem = get_required_emory(chc, sgc);
+	req_mem = get_required_memory(chc, sgc);
 	att = aria->attenuation;
 
 	if (aria->attenuation > ARIA_MAX_ATT) {
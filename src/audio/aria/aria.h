@@ -30,7 +30,9 @@
 
 #if defined(__XCC__)
 # include <xtensa/config/core-isa.h>
-# if XCHAL_HAVE_HIFI3 || XCHAL_HAVE_HIFI4
+# if XCHAL_HAVE_HIFI4
+#  define ARIA_HIFI4
+# elif XCHAL_HAVE_HIFI3
 #  define ARIA_HIFI3
 # else
 #  define ARIA_GENERIC
@@ -46,9 +48,11 @@
 #define ARIA_MAX_ATT 3
 
 /**
- * \brief aria get data function interface
+ * \brief aria get data function interface, outputs the delayed data to sink and
+ *	  replaces it with the same amount of source data in the delay line
  */
 typedef void (*aria_get_data_func)(struct processing_module *mod,
+				   struct audio_stream *source,
 				   struct audio_stream *sink, int frames);
 
 struct aria_data;
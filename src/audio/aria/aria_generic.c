@@ -48,7 +48,7 @@ inline void aria_algo_calc_gain(struct aria_data *cd, size_t gain_idx,
 	cd->gains[gain_idx] = (int32_t)(gain >> (att + 1));
 }
 
-void aria_algo_get_data(struct processing_module *mod,
+void aria_algo_get_data(struct processing_module *mod, struct audio_stream *source,
 			struct audio_stream *sink, int frames)
 {
 	struct aria_data *cd = module_get_private_data(mod);
@@ -92,6 +92,9 @@ void aria_algo_get_data(struct processing_module *mod,
 		in = cir_buf_wrap(in, cd->data_addr, cd->data_end);
 		out = audio_stream_wrap(sink, out);
 	}
+	cir_buf_copy(source->r_ptr, source->addr, source->end_addr,
+		     cd->data_ptr, cd->data_addr, cd->data_end,
+		     audio_stream_frame_bytes(source) * frames);
 	cd->gain_state = INDEX_TAB[cd->gain_state + 1];
 }
 
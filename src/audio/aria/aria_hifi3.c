@@ -61,6 +61,7 @@ inline void aria_algo_calc_gain(struct aria_data *cd, size_t gain_idx,
 }
 
 void aria_algo_get_data_odd_channel(struct processing_module *mod,
+				    struct audio_stream *source,
 				    struct audio_stream *sink,
 				    int frames)
 {
@@ -114,10 +115,14 @@ void aria_algo_get_data_odd_channel(struct processing_module *mod,
 		in = cir_buf_wrap(in, cd->data_addr, cd->data_end);
 		out = audio_stream_wrap(sink, out);
 	}
+	cir_buf_copy(source->r_ptr, source->addr, source->end_addr,
+		     cd->data_ptr, cd->data_addr, cd->data_end,
+		     audio_stream_frame_bytes(source) * frames);
 	cd->gain_state = INDEX_TAB[cd->gain_state + 1];
 }
 
 void aria_algo_get_data_even_channel(struct processing_module *mod,
+				     struct audio_stream *source,
 				     struct audio_stream *sink,
 				     int frames)
 {
@@ -170,6 +175,9 @@ void aria_algo_get_data_even_channel(struct processing_module *mod,
 		in = cir_buf_wrap(in, cd->data_addr, cd->data_end);
 		out = audio_stream_wrap(sink, out);
 	}
+	cir_buf_copy(source->r_ptr, source->addr, source->end_addr,
+		     cd->data_ptr, cd->data_addr, cd->data_end,
+		     audio_stream_frame_bytes(source) * frames);
 	cd->gain_state = INDEX_TAB[cd->gain_state + 1];
 }
 
@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include "aria.h"
+
+#ifdef ARIA_HIFI4
+#include <xtensa/config/defs.h>
+#include <xtensa/tie/xt_hifi4.h>
+
+/**
+ * \brief Aria gain index mapping table
+ */
+const uint8_t INDEX_TAB[] = {
+		0,    1,    2,    3,
+		4,    5,    6,    7,
+		8,    9,    0,    1,
+		2,    3,    4,    5,
+		6,    7,    8,    9,
+		0,    1,    2,    3
+};
+
+inline void aria_algo_calc_gain(struct aria_data *cd, size_t gain_idx,
+				struct audio_stream *source, int frames)
+{
+	/* two independent accumulators detect the maximum of 4 samples per iteration */
+	ae_int32x2 in_sample0, in_sample1;
+	ae_int32x2 max_data0 = AE_ZERO32();
+	ae_int32x2 max_data1 = AE_ZERO32();
+	int32_t att = cd->att;
+	ae_valign inu;
+	uint64_t gain = (1ULL << (att + 32)) - 1;
+	int32_t max;
+	int samples = frames * audio_stream_get_channels(source);
+	ae_int32x2 *in = audio_stream_get_rptr(source);
+	int i, n, m;
+
+	while (samples) {
+		n = audio_stream_samples_without_wrap_s32(source, in);
+		n = MIN(samples, n);
+		m = n >> 2;
+		inu = AE_LA64_PP(in);
+		for (i = 0; i < m; i++) {
+			AE_LA32X2_IP(in_sample0, inu, in);
+			AE_LA32X2_IP(in_sample1, inu, in);
+			max_data0 = AE_MAXABS32S(max_data0, in_sample0);
+			max_data1 = AE_MAXABS32S(max_data1, in_sample1);
+		}
+		for (i = m << 2; i < n; i++) {
+			AE_L32_IP(in_sample0, (ae_int32 *)in, sizeof(ae_int32));
+			max_data0 = AE_MAXABS32S(max_data0, in_sample0);
+		}
+		in = audio_stream_wrap(source, in);
+		samples -= n;
+	}
+
+	max_data0 = AE_MAXABS32S(max_data0, max_data1);
+	max = MAX(AE_MOVAD32_H(max_data0), AE_MOVAD32_L(max_data0));
+
+	/*zero check for maxis not needed since att is in range <0;3>*/
+	if (max > (0x7fffffff >> att))
+		gain = (0x7fffffffULL << 32) / max;
+
+	/* normalization by attenuation factor to obtain fractional range <1 / (2 pow att), 1> */
+	cd->gains[gain_idx] = (int32_t)(gain >> (att + 1));
+}
+
+static int32_t aria_algo_gain_begin(struct aria_data *cd, int32_t *gain_end)
+{
+	int32_t gain_state_add_2 = cd->gain_state + 2;
+	int32_t gain_state_add_3 = cd->gain_state + 3;
+	int32_t gain_begin = cd->gains[INDEX_TAB[gain_state_add_2]];
+	int i;
+
+	/* do linear approximation between points gain_begin and gain_end */
+	*gain_end = cd->gains[INDEX_TAB[gain_state_add_3]];
+	for (i = 1; i < ARIA_MAX_GAIN_STATES - 1; i++) {
+		if (cd->gains[INDEX_TAB[gain_state_add_2 + i]] < gain_begin)
+			gain_begin = cd->gains[INDEX_TAB[gain_state_add_2 + i]];
+		if (cd->gains[INDEX_TAB[gain_state_add_3 + i]] < *gain_end)
+			*gain_end = cd->gains[INDEX_TAB[gain_state_add_3 + i]];
+	}
+
+	return gain_begin;
+}
+
+/*
+ * The delayed samples are read from the delay line and replaced by the source
+ * samples in the same pass, so the delay line is never copied separately.
+ */
+void aria_algo_get_data_odd_channel(struct processing_module *mod,
+				    struct audio_stream *source,
+				    struct audio_stream *sink,
+				    int frames)
+{
+	struct aria_data *cd = module_get_private_data(mod);
+	size_t i, m, n, ch;
+	int32_t gain_end;
+	int32_t gain_begin = aria_algo_gain_begin(cd, &gain_end);
+	size_t samples = frames * audio_stream_get_channels(sink);
+	ae_int32 *out = audio_stream_get_wptr(sink);
+	ae_int32 *in = audio_stream_get_rptr(source);
+	ae_int32 *delay = (ae_int32 *)cd->data_ptr;
+	int32_t att = cd->att;
+	ae_int32x2 delay_sample, in_sample, out_sample;
+	const int inc = sizeof(ae_int32);
+	ae_int32x2 step = (gain_end - gain_begin) / frames;
+	ae_int32x2 gain = gain_begin;
+	const int ch_n = cd->chan_cnt;
+
+	while (samples) {
+		m = audio_stream_samples_without_wrap_s32(sink, out);
+		n = MIN(m, samples);
+		m = audio_stream_samples_without_wrap_s32(source, in);
+		n = MIN(m, n);
+		m = cir_buf_samples_without_wrap_s32(delay, cd->data_end);
+		n = MIN(m, n);
+		for (i = 0; i < n; i += ch_n) {
+			for (ch = 0; ch < ch_n; ch++) {
+				AE_L32_IP(in_sample, in, inc);
+				delay_sample = AE_L32_I(delay, 0);
+				AE_S32_L_XP(in_sample, delay, inc);
+				out_sample = AE_MULFP32X2RS(delay_sample, gain);
+				out_sample = AE_SLAA32S(out_sample, att);
+				AE_S32_L_XP(out_sample, out, inc);
+			}
+			gain = AE_ADD32S(gain, step);
+		}
+		samples -= n;
+		in = audio_stream_wrap(source, in);
+		delay = cir_buf_wrap(delay, cd->data_addr, cd->data_end);
+		out = audio_stream_wrap(sink, out);
+	}
+	cd->gain_state = INDEX_TAB[cd->gain_state + 1];
+}
+
+void aria_algo_get_data_even_channel(struct processing_module *mod,
+				     struct audio_stream *source,
+				     struct audio_stream *sink,
+				     int frames)
+{
+	struct aria_data *cd = module_get_private_data(mod);
+	size_t i, m, n, ch;
+	int32_t gain_end;
+	int32_t gain_begin = aria_algo_gain_begin(cd, &gain_end);
+	size_t samples = frames * audio_stream_get_channels(sink);
+	ae_int32x2 *out = audio_stream_get_wptr(sink);
+	ae_int32x2 *in = audio_stream_get_rptr(source);
+	ae_int32x2 *delay_rd = (ae_int32x2 *)cd->data_ptr;
+	ae_int32x2 *delay_wr = delay_rd;
+	int32_t att = cd->att;
+	ae_valign inu, delayu;
+	ae_valign outu = AE_ZALIGN64();
+	ae_valign delay_wru = AE_ZALIGN64();
+	ae_int32x2 delay_sample, in_sample, out_sample;
+	ae_int32x2 step = (gain_end - gain_begin) / frames;
+	ae_int32x2 gain = gain_begin;
+	const int ch_n = cd->chan_cnt;
+
+	while (samples) {
+		m = audio_stream_samples_without_wrap_s32(sink, out);
+		n = MIN(m, samples);
+		m = audio_stream_samples_without_wrap_s32(source, in);
+		n = MIN(m, n);
+		m = cir_buf_samples_without_wrap_s32(delay_rd, cd->data_end);
+		n = MIN(m, n);
+		inu = AE_LA64_PP(in);
+		delayu = AE_LA64_PP(delay_rd);
+		for (i = 0; i < n; i += ch_n) {
+			/* the writes to the delay line stay behind its reads */
+			for (ch = 0; ch < ch_n; ch += 2) {
+				AE_LA32X2_IP(in_sample, inu, in);
+				AE_LA32X2_IP(delay_sample, delayu, delay_rd);
+				AE_SA32X2_IP(in_sample, delay_wru, delay_wr);
+				out_sample = AE_MULFP32X2RS(delay_sample, gain);
+				out_sample = AE_SLAA32S(out_sample, att);
+				AE_SA32X2_IP(out_sample, outu, out);
+			}
+			gain = AE_ADD32S(gain, step);
+		}
+		AE_SA64POS_FP(outu, out);
+		AE_SA64POS_FP(delay_wru, delay_wr);
+		samples -= n;
+		in = audio_stream_wrap(source, in);
+		delay_rd = cir_buf_wrap(delay_rd, cd->data_addr, cd->data_end);
+		delay_wr = delay_rd;
+		out = audio_stream_wrap(sink, out);
+	}
+	cd->gain_state = INDEX_TAB[cd->gain_state + 1];
+}
+
+aria_get_data_func aria_algo_get_data_func(struct processing_module *mod)
+{
+	struct aria_data *cd = module_get_private_data(mod);
+
+	if (cd->chan_cnt & 1)
+		return aria_algo_get_data_odd_channel;
+	else
+		return aria_algo_get_data_even_channel;
+}
+#endif
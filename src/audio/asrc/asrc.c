@@ -16,6 +16,7 @@
 #include <sof/lib/memory.h>
 #include <sof/lib/uuid.h>
 #include <sof/math/numbers.h>
+#include <sof/math/trig.h>
 #include <sof/trace/trace.h>
 #include <sof/common.h>
 #include <sof/compiler_attributes.h>
@@ -41,12 +42,17 @@
  */
 #define TS_STABLE_DIFF_COUNT	2
 
-/* Low pass filter coefficient for measured drift factor,
- * The low pass function is y(n) = c1 * x(n) + c2 * y(n -1)
- * coefficient c2 needs to be 1 - c1.
+/* Bandwidth in mHz of the drift tracking loop. The measured skew is
+ * integrated to a phase error that is driven to zero by a PI controller,
+ * so in addition to the rate the ASRC follows the DAI sample position and
+ * the buffer levels do not wander with clock drift.
  */
-#define COEF_C1		Q_CONVERT_FLOAT(0.01, 30)
-#define COEF_C2		Q_CONVERT_FLOAT(0.99, 30)
+#define DRIFT_LOOP_BW_MHZ	1000
+
+/* Limit for the accumulated phase error, in Q2.30 skew times periods */
+#define DRIFT_PHASE_MAX		Q_CONVERT_FLOAT(1.0, 30)
+
+#define SQRT2_Q30		Q_CONVERT_FLOAT(1.41421356, 30)
 
 typedef void (*asrc_proc_func)(struct processing_module *mod,
 			       const struct audio_stream *source,
@@ -89,6 +95,10 @@ struct comp_data {
 	int32_t skew;		/* Rate factor in Q2.30 */
 	int32_t skew_min;
 	int32_t skew_max;
+	int32_t skew_integ;	/* Integral term of drift loop in Q2.30 */
+	int32_t phase_err;	/* Accumulated skew error in Q2.30 */
+	int32_t coef_kp;	/* Drift loop proportional gain in Q2.30 */
+	int32_t coef_ki;	/* Drift loop integral gain in Q2.30 */
 	int ts_count;
 	int asrc_size;		/* ASRC object size */
 	int buf_size;		/* Samples buffer size */
@@ -411,6 +421,10 @@ static void asrc_release_buffers(struct asrc_farrow *src_obj)
 	if (!src_obj)
 		return;
 
+	/* the ring buffer pointers are not set if asrc_initialise() failed */
+	if (!src_obj->ring_buffers32 && !src_obj->ring_buffers16)
+		return;
+
 	if (src_obj->bit_depth == 32)
 		for (ch = 0; ch < src_obj->num_channels; ch++) {
 			buf_32 = src_obj->ring_buffers32[ch];
@@ -614,88 +628,59 @@ static int asrc_dai_find(struct comp_dev *dev, struct comp_data *cd)
 	return 0;
 }
 
-#if CONFIG_IPC_MAJOR_4
+/* The DAI endpoint is reached via its driver ops, with IPC4 these are the
+ * module adapter ops that return -EOPNOTSUPP if the endpoint does not
+ * implement timestamping.
+ */
 static int asrc_dai_configure_timestamp(struct comp_data *cd)
 {
-	if (cd->dai_dev) {
-		struct processing_module *mod = comp_get_drvdata(cd->dai_dev);
-		struct module_data *md = &mod->priv;
-
-		return md->ops->endpoint_ops->dai_ts_config(cd->dai_dev);
-	}
+	if (!cd->dai_dev || !cd->dai_dev->drv->ops.dai_ts_config)
+		return -EINVAL;
 
-	return -EINVAL;
+	return cd->dai_dev->drv->ops.dai_ts_config(cd->dai_dev);
 }
 
 static int asrc_dai_start_timestamp(struct comp_data *cd)
 {
-	if (cd->dai_dev) {
-		struct processing_module *mod = comp_get_drvdata(cd->dai_dev);
-		struct module_data *md = &mod->priv;
-
-		return md->ops->endpoint_ops->dai_ts_start(cd->dai_dev);
-	}
+	if (!cd->dai_dev || !cd->dai_dev->drv->ops.dai_ts_start)
+		return -EINVAL;
 
-	return -EINVAL;
+	return cd->dai_dev->drv->ops.dai_ts_start(cd->dai_dev);
 }
 
 static int asrc_dai_stop_timestamp(struct comp_data *cd)
 {
-	if (cd->dai_dev) {
-		struct processing_module *mod = comp_get_drvdata(cd->dai_dev);
-		struct module_data *md = &mod->priv;
-
-		return md->ops->endpoint_ops->dai_ts_stop(cd->dai_dev);
-	}
+	if (!cd->dai_dev || !cd->dai_dev->drv->ops.dai_ts_stop)
+		return -EINVAL;
 
-	return -EINVAL;
+	return cd->dai_dev->drv->ops.dai_ts_stop(cd->dai_dev);
 }
 
-static int asrc_dai_get_timestamp(struct comp_data *cd,
-				  struct dai_ts_data *tsd)
-{
-	if (cd->dai_dev) {
-		struct processing_module *mod = comp_get_drvdata(cd->dai_dev);
-		struct module_data *md = &mod->priv;
-
-		return md->ops->endpoint_ops->dai_ts_get(cd->dai_dev, tsd);
-	}
-
-	return -EINVAL;
-}
+#if CONFIG_ZEPHYR_NATIVE_DRIVERS
+static int asrc_dai_get_timestamp(struct comp_data *cd, struct dai_ts_data *tsd)
 #else
-static int asrc_dai_configure_timestamp(struct comp_data *cd)
-{
-	if (cd->dai_dev)
-		return cd->dai_dev->drv->ops.dai_ts_config(cd->dai_dev);
-
-	return -EINVAL;
-}
-
-static int asrc_dai_start_timestamp(struct comp_data *cd)
-{
-	if (cd->dai_dev)
-		return cd->dai_dev->drv->ops.dai_ts_start(cd->dai_dev);
-
-	return -EINVAL;
-}
-
-static int asrc_dai_stop_timestamp(struct comp_data *cd)
+static int asrc_dai_get_timestamp(struct comp_data *cd, struct timestamp_data *tsd)
+#endif
 {
-	if (cd->dai_dev)
-		return cd->dai_dev->drv->ops.dai_ts_stop(cd->dai_dev);
+	if (!cd->dai_dev || !cd->dai_dev->drv->ops.dai_ts_get)
+		return -EINVAL;
 
-	return -EINVAL;
+	return cd->dai_dev->drv->ops.dai_ts_get(cd->dai_dev, tsd);
 }
 
-static int asrc_dai_get_timestamp(struct comp_data *cd, struct timestamp_data *tsd)
+/* Gains for a critically damped second order loop, kp = sqrt(2) * w and
+ * ki = w^2 with w = 2 * pi * bandwidth * period.
+ */
+static void asrc_drift_loop_init(struct comp_dev *dev, struct comp_data *cd)
 {
-	if (!cd->dai_dev)
-		return -EINVAL;
+	int32_t w;
 
-	return cd->dai_dev->drv->ops.dai_ts_get(cd->dai_dev, tsd);
+	w = ((int64_t)PI_MUL2_Q4_28 * DRIFT_LOOP_BW_MHZ * dev->period) / 250000000;
+	cd->coef_kp = q_multsr_32x32(w, SQRT2_Q30, 30);
+	cd->coef_ki = q_multsr_32x32(w, w, 30);
+	cd->skew_integ = cd->skew;
+	cd->phase_err = 0;
 }
-#endif
 
 static int asrc_trigger(struct processing_module *mod, int cmd)
 {
@@ -886,6 +871,8 @@ static int asrc_prepare(struct processing_module *mod,
 	cd->skew_min = cd->skew;
 	cd->skew_max = cd->skew;
 
+	asrc_drift_loop_init(dev, cd);
+
 	comp_info(dev, "asrc_prepare(), skew = %d", cd->skew);
 	ret = asrc_update_drift(dev, cd->asrc_obj, cd->skew);
 	if (ret) {
@@ -916,6 +903,7 @@ static int asrc_control_loop(struct comp_dev *dev, struct comp_data *cd)
 #else
 	struct timestamp_data tsd;
 #endif
+	int64_t phase;
 	int64_t tmp;
 	int32_t delta_sample;
 	int32_t delta_ts;
@@ -969,9 +957,17 @@ static int asrc_control_loop(struct comp_dev *dev, struct comp_data *cd)
 	f_ck_fs = ((int64_t)cd->asrc_obj->fs_sec << 31) / tsd.walclk_rate;
 	skew = q_multsr_sat_32x32(f_ds_dt, f_ck_fs, 13);
 
-	/* tmp is Q4.60, shift and round to Q2.30 */
-	tmp = ((int64_t)COEF_C1) * skew + ((int64_t)COEF_C2) * cd->skew;
-	cd->skew = sat_int32(Q_SHIFT_RND(tmp, 60, 30));
+	/* Integrate the difference of measured and applied skew to phase
+	 * error, then the PI controller output is the new skew. The
+	 * integral term converges to the mean measured skew. The products
+	 * are Q4.60, shift and round to Q2.30.
+	 */
+	phase = (int64_t)cd->phase_err + skew - cd->skew;
+	cd->phase_err = MAX(MIN(phase, DRIFT_PHASE_MAX), -DRIFT_PHASE_MAX);
+	tmp = (int64_t)cd->coef_ki * cd->phase_err;
+	cd->skew_integ = sat_int32((int64_t)cd->skew_integ + Q_SHIFT_RND(tmp, 60, 30));
+	tmp = (int64_t)cd->coef_kp * cd->phase_err;
+	cd->skew = sat_int32((int64_t)cd->skew_integ + Q_SHIFT_RND(tmp, 60, 30));
 	asrc_update_drift(dev, cd->asrc_obj, cd->skew);
 
 	/* Track skew variation, it helps to analyze possible problems
@@ -979,7 +975,8 @@ static int asrc_control_loop(struct comp_dev *dev, struct comp_data *cd)
 	 */
 	cd->skew_min = MIN(cd->skew, cd->skew_min);
 	cd->skew_max = MAX(cd->skew, cd->skew_max);
-	comp_dbg(dev, "skew %d %d %d %d", delta_sample, delta_ts, skew, cd->skew);
+	comp_dbg(dev, "skew %d %d %d %d %d", delta_sample, delta_ts, skew, cd->skew,
+		 cd->phase_err);
 	return 0;
 }
 
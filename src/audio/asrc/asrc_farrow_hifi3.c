@@ -15,11 +15,14 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 		       int index_output_frame)
 {
 	ae_f32x2 prod;
+	ae_f32x2 prod2;
 	ae_f32x2 filter01 = AE_ZERO32(); /* Note: Init is not needed */
 	ae_f32x2 filter23 = AE_ZERO32(); /* Note: Init is not needed */
 	ae_f16x4 buffer0123 = AE_ZERO16(); /* Note: Init is not needed */
+	ae_f16x4 buffer2_0123 = AE_ZERO16(); /* Note: Init is not needed */
 	ae_f32x2 *filter_p;
 	ae_f16x4 *buffer_p;
+	ae_f16x4 *buffer2_p;
 	int n_limit;
 	int ch;
 	int n;
@@ -36,8 +39,49 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 	else
 		i = index_output_frame;
 
-	/* Iterate over each channel */
-	for (ch = 0; ch < src_obj->num_channels; ch++) {
+	/* Filter channels in pairs, the impulse response is loaded once
+	 * for both and accumulated to two products.
+	 */
+	for (ch = 0; ch + 1 < src_obj->num_channels; ch += 2) {
+		filter_p = (ae_f32x2 *)&src_obj->impulse_response[0];
+		buffer_p =
+			(ae_f16x4 *)&src_obj->ring_buffers16[ch]
+			[src_obj->buffer_write_position];
+		buffer2_p =
+			(ae_f16x4 *)&src_obj->ring_buffers16[ch + 1]
+			[src_obj->buffer_write_position];
+
+		ae_valign align_filter = AE_LA64_PP(filter_p);
+		ae_valign align_buffer = AE_LA64_PP(buffer_p);
+		ae_valign align_buffer2 = AE_LA64_PP(buffer2_p);
+
+		prod = AE_ZERO32();
+		prod2 = AE_ZERO32();
+		for (n = 0; n < n_limit; n++) {
+			AE_LA16X4_RIP(buffer0123, align_buffer, buffer_p);
+			AE_LA16X4_RIP(buffer2_0123, align_buffer2, buffer2_p);
+			AE_LA32X2_IP(filter01, align_filter, filter_p);
+			AE_LA32X2_IP(filter23, align_filter, filter_p);
+			AE_MULAFP32X16X2RS_L(prod, filter23, buffer0123);
+			AE_MULAFP32X16X2RS_H(prod, filter01, buffer0123);
+			AE_MULAFP32X16X2RS_L(prod2, filter23, buffer2_0123);
+			AE_MULAFP32X16X2RS_H(prod2, filter01, buffer2_0123);
+		}
+
+		/* Saturated addition of the halves, the sum for the first
+		 * channel is in the high and for the second in the low half.
+		 */
+		prod = AE_ADD32S(AE_SEL32_HH(prod, prod2), AE_SEL32_LL(prod, prod2));
+		prod = AE_SLAI32S(prod, 1);
+		prod2 = AE_SEL32_HH(prod, prod);
+		AE_S16_0_X(AE_ROUND16X4F32SSYM(prod2, prod2),
+			   (ae_f16 *)&output_buffers[ch][i], 0);
+		AE_S16_0_X(AE_ROUND16X4F32SSYM(prod, prod),
+			   (ae_f16 *)&output_buffers[ch + 1][i], 0);
+	}
+
+	/* Filter the last channel of an odd count */
+	for (; ch < src_obj->num_channels; ch++) {
 		/* Pointer to the beginning of the impulse response */
 		filter_p = (ae_f32x2 *)&src_obj->impulse_response[0];
 
@@ -101,10 +145,13 @@ void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 		       int index_output_frame)
 {
 	ae_f32x2 prod;
+	ae_f32x2 prod2;
 	ae_f32x2 buffer01 = AE_ZERO32(); /* Note: Init is not needed */
+	ae_f32x2 buffer2_01 = AE_ZERO32(); /* Note: Init is not needed */
 	ae_f32x2 filter01 = AE_ZERO32(); /* Note: Init is not needed */
 	ae_f32x2 *filter_p;
 	ae_f32x2 *buffer_p;
+	ae_f32x2 *buffer2_p;
 	int n_limit;
 	int ch;
 	int n;
@@ -121,8 +168,38 @@ void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 	else
 		i = index_output_frame;
 
-	/* Iterate over each channel */
-	for (ch = 0; ch < src_obj->num_channels; ch++) {
+	/* Filter channels in pairs, see asrc_fir_filter16() */
+	for (ch = 0; ch + 1 < src_obj->num_channels; ch += 2) {
+		filter_p = (ae_f32x2 *)&src_obj->impulse_response[0];
+		buffer_p =
+			(ae_f32x2 *)&src_obj->ring_buffers32[ch]
+			[src_obj->buffer_write_position];
+		buffer2_p =
+			(ae_f32x2 *)&src_obj->ring_buffers32[ch + 1]
+			[src_obj->buffer_write_position];
+
+		ae_valign align_filter = AE_LA64_PP(filter_p);
+		ae_valign align_buffer = AE_LA64_PP(buffer_p);
+		ae_valign align_buffer2 = AE_LA64_PP(buffer2_p);
+
+		prod = AE_ZERO32();
+		prod2 = AE_ZERO32();
+		for (n = 0; n < n_limit; n++) {
+			AE_LA32X2_RIP(buffer01, align_buffer, buffer_p);
+			AE_LA32X2_RIP(buffer2_01, align_buffer2, buffer2_p);
+			AE_LA32X2_IP(filter01, align_filter, filter_p);
+			AE_MULAFP32X2RS(prod, buffer01, filter01);
+			AE_MULAFP32X2RS(prod2, buffer2_01, filter01);
+		}
+
+		prod = AE_ADD32S(AE_SEL32_HH(prod, prod2), AE_SEL32_LL(prod, prod2));
+		prod = AE_SLAI32S(prod, 1);
+		AE_S32_L_X(AE_SEL32_HH(prod, prod), (ae_f32 *)&output_buffers[ch][i], 0);
+		AE_S32_L_X(prod, (ae_f32 *)&output_buffers[ch + 1][i], 0);
+	}
+
+	/* Filter the last channel of an odd count */
+	for (; ch < src_obj->num_channels; ch++) {
 		/* Pointer to the beginning of the impulse response */
 		filter_p = (ae_f32x2 *)&src_obj->impulse_response[0];
 
@@ -8,12 +8,21 @@
 #include <ipc4/base_fw.h>
 #include <ipc4/pipeline.h>
 #include <ipc4/logging.h>
+#include <ipc4/notification.h>
 #include <sof_versions.h>
 #include <sof/lib/cpu-clk-manager.h>
 #include <sof/lib/cpu.h>
+#include <sof/ipc/time_corr.h>
 #include <rtos/init.h>
 #include <platform/lib/clk.h>
 
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+#include <sof/debug/telemetry/performance_monitor.h>
+#endif
+#if CONFIG_SOF_TELEMETRY
+#include <sof/debug/telemetry/telemetry.h>
+#endif
+
 #if CONFIG_ACE_V1X_ART_COUNTER || CONFIG_ACE_V1X_RTC_COUNTER
 #include <zephyr/device.h>
 #include <zephyr/drivers/counter.h>
@@ -111,6 +120,11 @@ static int basefw_config(uint32_t *data_offset, char *data)
 	sche_cfg.sys_tick_source = SOF_SCHEDULE_LL_TIMER;
 	tlv_value_set(tuple, IPC4_SCHEDULER_CONFIGURATION, sizeof(sche_cfg), &sche_cfg);
 
+#if CONFIG_SOF_TELEMETRY
+	tuple = tlv_next(tuple);
+	tlv_value_uint32_set(tuple, IPC4_TELEMETRY_BUFFER_SIZE, telemetry_get_buffer_size());
+#endif
+
 	tuple = tlv_next(tuple);
 	*data_offset = (int)((char *)tuple - data);
 
@@ -252,6 +266,9 @@ static uint32_t basefw_set_system_time(uint32_t param_id,
 	global_system_time_info.dsp_time.val_l = (uint32_t)(current_dsp_time);
 	global_system_time_info.dsp_time.val_u = (uint32_t)(current_dsp_time >> 32);
 
+	time_corr_set_host_time(((uint64_t)global_system_time_info.host_time.val_u << 32) |
+				global_system_time_info.host_time.val_l, current_dsp_time);
+
 	return IPC4_SUCCESS;
 }
 
@@ -387,6 +404,25 @@ static int basefw_power_state_info_get(uint32_t *data_offset, char *data)
 	return 0;
 }
 
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+static int basefw_perf_meas_state_get(uint32_t *data_offset, char *data)
+{
+	*(uint32_t *)data = perf_meas_get_state();
+	*data_offset = sizeof(uint32_t);
+
+	return 0;
+}
+
+static int basefw_perf_meas_state_set(bool first_block, bool last_block,
+				      uint32_t data_offset_or_size, const char *data)
+{
+	if (!(first_block && last_block) || data_offset_or_size < sizeof(uint32_t))
+		return -EINVAL;
+
+	return perf_meas_set_state(*(const uint32_t *)data);
+}
+#endif
+
 static int basefw_get_large_config(struct comp_dev *dev,
 				   uint32_t param_id,
 				   bool first_block,
@@ -425,6 +461,21 @@ static int basefw_get_large_config(struct comp_dev *dev,
 	break;
 	case IPC4_POWER_STATE_INFO_GET:
 		return basefw_power_state_info_get(data_offset, data);
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+	case IPC4_PERF_MEASUREMENTS_STATE:
+		return basefw_perf_meas_state_get(data_offset, data);
+	case IPC4_GLOBAL_PERF_DATA:
+		return perf_meas_get_global_data(data, SOF_IPC_MSG_MAX_SIZE, data_offset);
+	case IPC4_EXTENDED_GLOBAL_PERF_DATA:
+		return perf_meas_get_extended_global_data(data, SOF_IPC_MSG_MAX_SIZE,
+							  data_offset);
+#endif
+#if CONFIG_SOF_TELEMETRY
+	case IPC4_TELEMETRY_STATE:
+		return telemetry_get_state(data, data_offset);
+	case IPC4_TELEMETRY_DATA:
+		return telemetry_get_data(data, SOF_IPC_MSG_MAX_SIZE, data_offset);
+#endif
 	/* TODO: add more support */
 	case IPC4_DSP_RESOURCE_STATE:
 	case IPC4_NOTIFICATION_MASK:
@@ -465,6 +516,22 @@ static int basefw_set_large_config(struct comp_dev *dev,
 	case IPC4_RESOURCE_ALLOCATION_REQUEST:
 		return basefw_resource_allocation_request(first_block, last_block, data_offset,
 							  data);
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+	case IPC4_PERF_MEASUREMENTS_STATE:
+		return basefw_perf_meas_state_set(first_block, last_block, data_offset, data);
+#endif
+#if CONFIG_SOF_TELEMETRY
+	case IPC4_TELEMETRY_STATE:
+		if (!(first_block && last_block))
+			return -EINVAL;
+		return telemetry_set_state(data, data_offset);
+#endif
+#if CONFIG_XRUN_NOTIFICATIONS_BATCH
+	case IPC4_XRUN_NOTIFICATION_BATCH:
+		if (!(first_block && last_block))
+			return -EINVAL;
+		return xrun_notif_batch_set_config(data, data_offset);
+#endif
 	default:
 		break;
 	}
@@ -487,6 +554,13 @@ static SHARED_DATA struct comp_driver_info comp_basefw_info = {
 
 UT_STATIC void sys_comp_basefw_init(void)
 {
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+	perf_meas_init();
+#endif
+#if CONFIG_SOF_TELEMETRY
+	if (telemetry_init() < 0)
+		tr_err(&basefw_comp_tr, "telemetry buffers allocation failed");
+#endif
 	comp_register(platform_shared_get(&comp_basefw_info,
 					  sizeof(comp_basefw_info)));
 }
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/block_copy.h>
+#include <rtos/string.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if BLOCK_COPY_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/* shorter blocks are not worth the alignment setup */
+#define BLOCK_COPY_MIN_BYTES	32
+
+void audio_block_copy(void *dst, const void *src, size_t bytes)
+{
+	const ae_int16x4 *in = src;
+	ae_int16x4 *out = dst;
+	ae_int16x4 d0, d1;
+	ae_valign inu;
+	ae_valign outu = AE_ZALIGN64();
+	size_t n;
+
+	if (bytes < BLOCK_COPY_MIN_BYTES || (((uintptr_t)dst | (uintptr_t)src) & 1)) {
+		memcpy(dst, src, bytes);
+		return;
+	}
+
+	/* 16 bytes per loop */
+	n = bytes >> 4;
+	if (!(((uintptr_t)dst | (uintptr_t)src) & 7)) {
+		for (; n; n--) {
+			AE_L16X4_IP(d0, in, sizeof(ae_int16x4));
+			AE_L16X4_IP(d1, in, sizeof(ae_int16x4));
+			AE_S16X4_IP(d0, out, sizeof(ae_int16x4));
+			AE_S16X4_IP(d1, out, sizeof(ae_int16x4));
+		}
+	} else {
+		inu = AE_LA64_PP(in);
+		for (; n; n--) {
+			AE_LA16X4_IP(d0, inu, in);
+			AE_LA16X4_IP(d1, inu, in);
+			AE_SA16X4_IP(d0, outu, out);
+			AE_SA16X4_IP(d1, outu, out);
+		}
+		AE_SA64POS_FP(outu, out);
+	}
+
+	memcpy(out, in, bytes & 15);
+}
+
+void audio_block_zero(void *dst, size_t bytes)
+{
+	const ae_int16x4 zero = AE_ZERO16();
+	uint8_t *d8 = dst;
+	ae_int16x4 *out;
+	size_t head;
+	size_t n;
+
+	if (bytes < BLOCK_COPY_MIN_BYTES) {
+		memset(dst, 0, bytes);
+		return;
+	}
+
+	/* aligned stores after up to 7 head bytes */
+	head = -(uintptr_t)d8 & 7;
+	memset(d8, 0, head);
+	out = (ae_int16x4 *)(d8 + head);
+	bytes -= head;
+
+	for (n = bytes >> 4; n; n--) {
+		AE_S16X4_IP(zero, out, sizeof(ae_int16x4));
+		AE_S16X4_IP(zero, out, sizeof(ae_int16x4));
+	}
+
+	memset(out, 0, bytes & 15);
+}
+
+#endif /* BLOCK_COPY_HIFI3 */
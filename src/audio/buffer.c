@@ -5,6 +5,7 @@
 // Author: Liam Girdwood <liam.r.girdwood@linux.intel.com>
 //         Keyon Jie <yang.jie@linux.intel.com>
 
+#include <sof/audio/block_copy.h>
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
 #include <sof/common.h>
@@ -15,6 +16,7 @@
 #include <sof/lib/notifier.h>
 #include <sof/list.h>
 #include <rtos/spinlock.h>
+#include <rtos/string.h>
 #include <ipc/topology.h>
 #include <errno.h>
 #include <stddef.h>
@@ -27,6 +29,14 @@ DECLARE_SOF_RT_UUID("buffer", buffer_uuid, 0x42544c92, 0x8e92, 0x4e41,
 		 0xb6, 0x79, 0x34, 0x51, 0x9f, 0x1c, 0x1d, 0x28);
 DECLARE_TR_CTX(buffer_tr, SOF_UUID(buffer_uuid), LOG_LEVEL_INFO);
 
+/* Buffers between components of the same core stay in the memory of that
+ * core. DMA buffers and buffers shared by cores use the shared heap.
+ */
+static inline uint32_t buffer_mem_flags(uint32_t caps, bool is_shared)
+{
+	return is_shared || (caps & SOF_MEM_CAPS_DMA) ? 0 : SOF_MEM_FLAG_CORE_LOCAL;
+}
+
 struct comp_buffer *buffer_alloc(uint32_t size, uint32_t caps, uint32_t flags, uint32_t align,
 				 bool is_shared)
 {
@@ -45,7 +55,8 @@ struct comp_buffer *buffer_alloc(uint32_t size, uint32_t caps, uint32_t flags, u
 	/* allocate new buffer	 */
 	enum mem_zone zone = is_shared ? SOF_MEM_ZONE_RUNTIME_SHARED : SOF_MEM_ZONE_RUNTIME;
 
-	buffer = rzalloc(zone, 0, SOF_MEM_CAPS_RAM, sizeof(*buffer));
+	buffer = rzalloc(zone, is_shared ? 0 : SOF_MEM_FLAG_CORE_LOCAL, SOF_MEM_CAPS_RAM,
+			 sizeof(*buffer));
 
 	if (!buffer) {
 		tr_err(&buffer_tr, "buffer_alloc(): could not alloc structure");
@@ -55,7 +66,7 @@ struct comp_buffer *buffer_alloc(uint32_t size, uint32_t caps, uint32_t flags, u
 	CORE_CHECK_STRUCT_INIT(buffer, is_shared);
 
 	buffer->is_shared = is_shared;
-	stream_addr = rballoc_align(0, caps, size, align);
+	stream_addr = rballoc_align(buffer_mem_flags(caps, is_shared), caps, size, align);
 	if (!stream_addr) {
 		rfree(buffer);
 		tr_err(&buffer_tr, "buffer_alloc(): could not alloc size = %u bytes of type = %u",
@@ -81,7 +92,8 @@ void buffer_zero(struct comp_buffer *buffer)
 	buf_dbg(buffer, "stream_zero()");
 	CORE_CHECK_STRUCT(buffer);
 
-	bzero(audio_stream_get_addr(&buffer->stream), audio_stream_get_size(&buffer->stream));
+	audio_block_zero(audio_stream_get_addr(&buffer->stream),
+			 audio_stream_get_size(&buffer->stream));
 	if (buffer->caps & SOF_MEM_CAPS_DMA)
 		dcache_writeback_region((__sparse_force void __sparse_cache *)
 					audio_stream_get_addr(&buffer->stream),
@@ -90,6 +102,7 @@ void buffer_zero(struct comp_buffer *buffer)
 
 int buffer_set_size(struct comp_buffer *buffer, uint32_t size, uint32_t alignment)
 {
+	uint32_t mem_flags = buffer_mem_flags(buffer->caps, buffer->is_shared);
 	void *new_ptr = NULL;
 
 	CORE_CHECK_STRUCT(buffer);
@@ -103,12 +116,18 @@ int buffer_set_size(struct comp_buffer *buffer, uint32_t size, uint32_t alignmen
 	if (size == audio_stream_get_size(&buffer->stream))
 		return 0;
 
+	if (buffer->borrowed) {
+		buf_err(buffer, "resize of borrowed data");
+		return -EBUSY;
+	}
+
 	if (!alignment)
-		new_ptr = rbrealloc(audio_stream_get_addr(&buffer->stream), SOF_MEM_FLAG_NO_COPY,
-				    buffer->caps, size, audio_stream_get_size(&buffer->stream));
+		new_ptr = rbrealloc(audio_stream_get_addr(&buffer->stream),
+				    SOF_MEM_FLAG_NO_COPY | mem_flags, buffer->caps, size,
+				    audio_stream_get_size(&buffer->stream));
 	else
 		new_ptr = rbrealloc_align(audio_stream_get_addr(&buffer->stream),
-					  SOF_MEM_FLAG_NO_COPY, buffer->caps, size,
+					  SOF_MEM_FLAG_NO_COPY | mem_flags, buffer->caps, size,
 					  audio_stream_get_size(&buffer->stream), alignment);
 	/* we couldn't allocate bigger chunk */
 	if (!new_ptr && size > audio_stream_get_size(&buffer->stream)) {
@@ -126,6 +145,49 @@ int buffer_set_size(struct comp_buffer *buffer, uint32_t size, uint32_t alignmen
 	return 0;
 }
 
+#if CONFIG_BUFFER_COMPACTION
+uint32_t buffer_relocate(struct comp_buffer *buffer)
+{
+	struct audio_stream *stream = &buffer->stream;
+	uint32_t size = audio_stream_get_size(stream);
+	char *addr = audio_stream_get_addr(stream);
+	char *new_addr;
+
+	CORE_CHECK_STRUCT(buffer);
+
+	if (buffer->borrowed)
+		return 0;
+
+	new_addr = rballoc_align(buffer_mem_flags(buffer->caps, buffer->is_shared), buffer->caps,
+				 size, PLATFORM_DCACHE_ALIGN);
+	if (!new_addr)
+		return 0;
+
+	/* only moving down packs the heap */
+	if (new_addr > addr) {
+		rfree(new_addr);
+		return 0;
+	}
+
+	memcpy_s(new_addr, size, addr, size);
+	if (buffer->caps & SOF_MEM_CAPS_DMA)
+		dcache_writeback_region((__sparse_force void __sparse_cache *)new_addr, size);
+
+	stream->r_ptr = new_addr + ((char *)stream->r_ptr - addr);
+	stream->w_ptr = new_addr + ((char *)stream->w_ptr - addr);
+	stream->addr = new_addr;
+	stream->end_addr = new_addr + size;
+#if CONFIG_BUFFER_NOTIFY_COALESCE
+	if (buffer->notify_bytes)
+		buffer->notify_begin = new_addr + ((char *)buffer->notify_begin - addr);
+#endif
+
+	rfree(addr);
+
+	return size;
+}
+#endif
+
 int buffer_set_params(struct comp_buffer *buffer,
 		      struct sof_ipc_stream_params *params, bool force_update)
 {
@@ -178,13 +240,105 @@ bool buffer_params_match(struct comp_buffer *buffer,
 	return true;
 }
 
+#if CONFIG_BUFFER_NOTIFY_COALESCE
+/* deliver the produced data collected since the last notification */
+static void buffer_notify_flush(struct comp_buffer *buffer)
+{
+	struct buffer_cb_transact cb_data = {
+		.buffer = buffer,
+		.transaction_amount = buffer->notify_bytes,
+		.transaction_begin_address = buffer->notify_begin,
+	};
+
+	if (!buffer->notify_bytes)
+		return;
+
+	buffer->notify_bytes = 0;
+
+	notifier_event(buffer, NOTIFIER_ID_BUFFER_PRODUCE,
+		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
+}
+
+static void buffer_notify_tick(void *arg, enum notify_id type, void *data)
+{
+	buffer_notify_flush(arg);
+}
+
+static void buffer_notify_coalesce(struct comp_buffer *buffer, void *begin, uint32_t bytes)
+{
+	void *end = audio_stream_wrap(&buffer->stream,
+				      (char *)buffer->notify_begin + buffer->notify_bytes);
+
+	/*
+	 * The collected data must stay in place until the listener sees it:
+	 * flush before it gets longer than the buffer, the producer would
+	 * have wrapped over its start, or when it is not contiguous anymore.
+	 */
+	if (buffer->notify_bytes &&
+	    (end != begin || buffer->notify_bytes + bytes > audio_stream_get_size(&buffer->stream)))
+		buffer_notify_flush(buffer);
+
+	if (!buffer->notify_bytes)
+		buffer->notify_begin = begin;
+	buffer->notify_bytes += bytes;
+}
+#endif
+
+void buffer_notify_subscribe(struct comp_buffer *buffer, uint32_t mask)
+{
+	uint8_t old_mask = buffer->notify_mask;
+
+	/* a listener that needs every update cancels the coalescing */
+	if ((mask & (BUFF_CB_TYPE_PRODUCE | BUFF_CB_TYPE_COALESCE)) == BUFF_CB_TYPE_PRODUCE)
+		buffer_notify_unsubscribe(buffer, BUFF_CB_TYPE_COALESCE);
+	else if (old_mask & BUFF_CB_TYPE_PRODUCE && !(old_mask & BUFF_CB_TYPE_COALESCE))
+		mask &= ~BUFF_CB_TYPE_COALESCE;
+
+	buffer->notify_mask |= mask;
+
+#if CONFIG_BUFFER_NOTIFY_COALESCE
+	if ((mask & ~old_mask) & BUFF_CB_TYPE_COALESCE &&
+	    notifier_register(buffer, NULL, NOTIFIER_ID_LL_POST_RUN, buffer_notify_tick, 0) < 0)
+		buffer->notify_mask &= ~BUFF_CB_TYPE_COALESCE;
+#endif
+}
+
+void buffer_notify_unsubscribe(struct comp_buffer *buffer, uint32_t mask)
+{
+#if CONFIG_BUFFER_NOTIFY_COALESCE
+	if (buffer->notify_mask & BUFF_CB_TYPE_COALESCE &&
+	    mask & (BUFF_CB_TYPE_PRODUCE | BUFF_CB_TYPE_COALESCE)) {
+		buffer_notify_flush(buffer);
+		notifier_unregister(buffer, NULL, NOTIFIER_ID_LL_POST_RUN);
+	}
+#endif
+
+	/* coalescing is a mode of the produce notification */
+	if (mask & BUFF_CB_TYPE_PRODUCE)
+		mask |= BUFF_CB_TYPE_COALESCE;
+
+	buffer->notify_mask &= ~mask;
+}
+
 /* free component in the pipeline */
-void buffer_free(struct comp_buffer *buffer)
+static void buffer_release_listeners(struct comp_buffer *buffer)
 {
 	struct buffer_cb_free cb_data = {
 		.buffer = buffer,
 	};
 
+	/* deliver the coalesced data before the listeners see the buffer go */
+	buffer_notify_unsubscribe(buffer, buffer->notify_mask);
+
+	notifier_event(buffer, NOTIFIER_ID_BUFFER_FREE,
+		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
+
+	/* In case some listeners didn't unregister from buffer's callbacks */
+	notifier_unregister_all(NULL, buffer);
+}
+
+void buffer_free(struct comp_buffer *buffer)
+{
 	CORE_CHECK_STRUCT(buffer);
 
 	if (!buffer)
@@ -192,16 +346,44 @@ void buffer_free(struct comp_buffer *buffer)
 
 	buf_dbg(buffer, "buffer_free()");
 
-	notifier_event(buffer, NOTIFIER_ID_BUFFER_FREE,
-		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
-
-	/* In case some listeners didn't unregister from buffer's callbacks */
-	notifier_unregister_all(NULL, buffer);
+	buffer_release_listeners(buffer);
 
-	rfree(buffer->stream.addr);
+	/* the owner of borrowed data frees it */
+	if (buffer->borrowed)
+		buf_warn(buffer, "buffer_free(): data still borrowed");
+	else
+		rfree(buffer->stream.addr);
 	rfree(buffer);
 }
 
+#if CONFIG_IPC4_DEFERRED_FREE
+void buffer_reuse(struct comp_buffer *buffer, uint32_t flags)
+{
+	void *stream_addr = audio_stream_get_addr(&buffer->stream);
+	uint32_t size = audio_stream_get_size(&buffer->stream);
+	uint32_t caps = buffer->caps;
+
+	CORE_CHECK_STRUCT(buffer);
+
+	buf_dbg(buffer, "buffer_reuse()");
+
+	/* listeners of the freed buffer see it go as with buffer_free() */
+	buffer_release_listeners(buffer);
+
+	memset(buffer, 0, sizeof(*buffer));
+	CORE_CHECK_STRUCT_INIT(buffer, false);
+
+	audio_stream_set_addr(&buffer->stream, stream_addr);
+	buffer_init(buffer, size, caps);
+
+	audio_stream_set_underrun(&buffer->stream, !!(flags & SOF_BUF_UNDERRUN_PERMITTED));
+	audio_stream_set_overrun(&buffer->stream, !!(flags & SOF_BUF_OVERRUN_PERMITTED));
+
+	list_init(&buffer->source_list);
+	list_init(&buffer->sink_list);
+}
+#endif
+
 void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 {
 	struct buffer_cb_transact cb_data = {
@@ -224,8 +406,15 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 
 	audio_stream_produce(&buffer->stream, bytes);
 
-	notifier_event(buffer, NOTIFIER_ID_BUFFER_PRODUCE,
-		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
+	if (buffer->notify_mask & BUFF_CB_TYPE_PRODUCE) {
+#if CONFIG_BUFFER_NOTIFY_COALESCE
+		if (buffer->notify_mask & BUFF_CB_TYPE_COALESCE)
+			buffer_notify_coalesce(buffer, cb_data.transaction_begin_address, bytes);
+		else
+#endif
+			notifier_event(buffer, NOTIFIER_ID_BUFFER_PRODUCE,
+				       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
+	}
 
 #if CONFIG_SOF_LOG_DBG_BUFFER
 	buf_dbg(buffer, "comp_update_buffer_produce(), ((buffer->avail << 16) | buffer->free) = %08x, ((buffer->id << 16) | buffer->size) = %08x",
@@ -264,8 +453,9 @@ void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
 
 	audio_stream_consume(&buffer->stream, bytes);
 
-	notifier_event(buffer, NOTIFIER_ID_BUFFER_CONSUME,
-		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
+	if (buffer->notify_mask & BUFF_CB_TYPE_CONSUME)
+		notifier_event(buffer, NOTIFIER_ID_BUFFER_CONSUME,
+			       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
 
 #if CONFIG_SOF_LOG_DBG_BUFFER
 	buf_dbg(buffer, "comp_update_buffer_consume(), (buffer->avail << 16) | buffer->free = %08x, (buffer->id << 16) | buffer->size = %08x, (buffer->r_ptr - buffer->addr) << 16 | (buffer->w_ptr - buffer->addr)) = %08x",
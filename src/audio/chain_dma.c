@@ -24,7 +24,7 @@
 #include <sof/ut.h>
 #include <zephyr/pm/policy.h>
 #include <rtos/init.h>
-#if CONFIG_IPC4_XRUN_NOTIFICATIONS_ENABLE
+#if CONFIG_XRUN_NOTIFICATIONS_ENABLE
 #include <ipc4/notification.h>
 #include <sof/ipc/msg.h>
 #include <ipc/header.h>
@@ -52,7 +52,7 @@ struct chain_dma_data {
 	enum sof_ipc_stream_direction stream_direction;
 	/* container size in bytes */
 	uint8_t cs;
-#if CONFIG_IPC4_XRUN_NOTIFICATIONS_ENABLE
+#if CONFIG_XRUN_NOTIFICATIONS_ENABLE
 	bool xrun_notification_sent;
 	struct ipc_msg *msg_xrun;
 #endif
@@ -70,8 +70,24 @@ struct chain_dma_data {
 	struct dma_block_config dma_block_cfg_link;
 
 	struct comp_buffer *dma_buffer;
+
+#if CONFIG_CHAIN_DMA_AGGREGATE
+	/* item in the list of chains serviced by the core's group task */
+	struct list_item group_list;
+#endif
+};
+
+#if CONFIG_CHAIN_DMA_AGGREGATE
+/* all chain DMAs running on a core, serviced by a single LL task */
+struct chain_dma_group {
+	struct task task;
+	struct list_item chains;	/* list of struct chain_dma_data */
+	bool scheduled;
 };
 
+static struct chain_dma_group chain_dma_groups[CONFIG_CORE_COUNT];
+#endif
+
 static int chain_host_start(struct comp_dev *dev)
 {
 	struct chain_dma_data *cd = comp_get_drvdata(dev);
@@ -140,24 +156,28 @@ static size_t chain_get_transferred_data_size(const uint32_t out_read_pos, const
 	return buff_size - in_read_pos + out_read_pos;
 }
 
-#if CONFIG_IPC4_XRUN_NOTIFICATIONS_ENABLE
-static void handle_xrun(struct chain_dma_data *cd)
+#if CONFIG_XRUN_NOTIFICATIONS_ENABLE
+static void chain_xrun_notify(struct chain_dma_data *cd, uint32_t event_type)
 {
-	int ret;
+#if CONFIG_XRUN_NOTIFICATIONS_BATCH
+	xrun_notif_batch_event(SOF_IPC4_GATEWAY, cd->link_connector_node_id.dw, event_type);
+#else
+	xrun_notif_msg_init(cd->msg_xrun, cd->link_connector_node_id.dw, event_type);
+	ipc_msg_send(cd->msg_xrun, NULL, true);
+#endif
+}
 
+static void handle_xrun(struct chain_dma_data *cd)
+{
 	if (cd->link_connector_node_id.f.dma_type == ipc4_hda_link_output_class &&
 	    !cd->xrun_notification_sent) {
 		tr_warn(&chain_dma_tr, "handle_xrun(): underrun detected");
-		xrun_notif_msg_init(cd->msg_xrun, cd->link_connector_node_id.dw,
-				    SOF_IPC4_GATEWAY_UNDERRUN_DETECTED);
-		ipc_msg_send(cd->msg_xrun, NULL, true);
+		chain_xrun_notify(cd, SOF_IPC4_GATEWAY_UNDERRUN_DETECTED);
 		cd->xrun_notification_sent = true;
 	} else if (cd->link_connector_node_id.f.dma_type == ipc4_hda_link_input_class &&
 		   !cd->xrun_notification_sent) {
 		tr_warn(&chain_dma_tr, "handle_xrun(): overrun detected");
-		xrun_notif_msg_init(cd->msg_xrun, cd->link_connector_node_id.dw,
-				    SOF_IPC4_GATEWAY_OVERRUN_DETECTED);
-		ipc_msg_send(cd->msg_xrun, NULL, true);
+		chain_xrun_notify(cd, SOF_IPC4_GATEWAY_OVERRUN_DETECTED);
 		cd->xrun_notification_sent = true;
 	} else {
 		/* if xrun_notification_sent is already set, then it means that link was
@@ -187,7 +207,7 @@ static enum task_state chain_task_run(void *data)
 	case -EPIPE:
 		tr_warn(&chain_dma_tr, "chain_task_run(): dma_get_status() link xrun occurred,"
 			" ret = %u", ret);
-#if CONFIG_IPC4_XRUN_NOTIFICATIONS_ENABLE
+#if CONFIG_XRUN_NOTIFICATIONS_ENABLE
 		handle_xrun(cd);
 #endif
 		break;
@@ -282,6 +302,89 @@ static enum task_state chain_task_run(void *data)
 	return SOF_TASK_STATE_RESCHEDULE;
 }
 
+#if CONFIG_CHAIN_DMA_AGGREGATE
+static enum task_state chain_group_task_run(void *data)
+{
+	struct chain_dma_group *group = data;
+	struct chain_dma_data *cd;
+	struct list_item *clist, *tmp;
+
+	list_for_item_safe(clist, tmp, &group->chains) {
+		cd = container_of(clist, struct chain_dma_data, group_list);
+
+		/* stop servicing a chain after a critical DMA error, as the
+		 * dedicated task does, until it is restarted
+		 */
+		if (chain_task_run(cd) == SOF_TASK_STATE_COMPLETED) {
+			list_item_del(&cd->group_list);
+			cd->chain_task.state = SOF_TASK_STATE_COMPLETED;
+		}
+	}
+
+	return SOF_TASK_STATE_RESCHEDULE;
+}
+
+/* add the chain to the group of the current core, starting the group task
+ * with the first chain
+ */
+static int chain_group_join(struct comp_dev *dev)
+{
+	struct chain_dma_data *cd = comp_get_drvdata(dev);
+	struct chain_dma_group *group = chain_dma_groups + cpu_get_id();
+	int ret;
+
+	if (!group->scheduled) {
+		list_init(&group->chains);
+
+		ret = schedule_task_init_ll(&group->task, SOF_UUID(chain_dma_uuid),
+					    SOF_SCHEDULE_LL_TIMER, SOF_TASK_PRI_HIGH,
+					    chain_group_task_run, group, cpu_get_id(), 0);
+		if (ret < 0) {
+			comp_err(dev, "chain_group_join(), ll task initialization failed");
+			return ret;
+		}
+
+		ret = schedule_task(&group->task, 0, 0);
+		if (ret < 0) {
+			comp_err(dev, "chain_group_join(), ll schedule task failed");
+			schedule_task_free(&group->task);
+			return ret;
+		}
+
+		group->scheduled = true;
+		pm_policy_state_lock_get(PM_STATE_RUNTIME_IDLE, PM_ALL_SUBSTATES);
+	}
+
+	list_item_append(&cd->group_list, &group->chains);
+	cd->chain_task.state = SOF_TASK_STATE_QUEUED;
+
+	return 0;
+}
+
+/* remove the chain from its group, returns true if it was the last one */
+static bool chain_group_leave(struct chain_dma_data *cd)
+{
+	struct chain_dma_group *group = chain_dma_groups + cpu_get_id();
+
+	/* chains stopped on a DMA error have already left the list */
+	if (cd->chain_task.state == SOF_TASK_STATE_QUEUED)
+		list_item_del(&cd->group_list);
+	cd->chain_task.state = SOF_TASK_STATE_FREE;
+
+	return group->scheduled && list_is_empty(&group->chains);
+}
+
+/* stop the group task once no chain is left */
+static void chain_group_stop(void)
+{
+	struct chain_dma_group *group = chain_dma_groups + cpu_get_id();
+
+	schedule_task_free(&group->task);
+	group->scheduled = false;
+	pm_policy_state_lock_put(PM_STATE_RUNTIME_IDLE, PM_ALL_SUBSTATES);
+}
+#endif /* CONFIG_CHAIN_DMA_AGGREGATE */
+
 static int chain_task_start(struct comp_dev *dev)
 {
 	struct comp_driver_list *drivers = comp_drivers_get();
@@ -328,6 +431,11 @@ static int chain_task_start(struct comp_dev *dev)
 		}
 	}
 
+#if CONFIG_CHAIN_DMA_AGGREGATE
+	ret = chain_group_join(dev);
+	if (ret < 0)
+		goto error_task;
+#else
 	ret = schedule_task_init_ll(&cd->chain_task, SOF_UUID(chain_dma_uuid),
 				    SOF_SCHEDULE_LL_TIMER, SOF_TASK_PRI_HIGH,
 				    chain_task_run, cd, 0, 0);
@@ -344,6 +452,7 @@ static int chain_task_start(struct comp_dev *dev)
 	}
 
 	pm_policy_state_lock_get(PM_STATE_RUNTIME_IDLE, PM_ALL_SUBSTATES);
+#endif
 	k_spin_unlock(&drivers->lock, key);
 
 	return 0;
@@ -362,6 +471,9 @@ static int chain_task_pause(struct comp_dev *dev)
 	struct chain_dma_data *cd = comp_get_drvdata(dev);
 	k_spinlock_key_t key;
 	int ret, ret2;
+#if CONFIG_CHAIN_DMA_AGGREGATE
+	bool last;
+#endif
 
 	if (cd->chain_task.state == SOF_TASK_STATE_FREE)
 		return 0;
@@ -378,10 +490,18 @@ static int chain_task_pause(struct comp_dev *dev)
 	if (!ret)
 		ret = ret2;
 
+#if CONFIG_CHAIN_DMA_AGGREGATE
+	last = chain_group_leave(cd);
+	k_spin_unlock(&drivers->lock, key);
+
+	if (last)
+		chain_group_stop();
+#else
 	k_spin_unlock(&drivers->lock, key);
 
 	schedule_task_free(&cd->chain_task);
 	pm_policy_state_lock_put(PM_STATE_RUNTIME_IDLE, PM_ALL_SUBSTATES);
+#endif
 
 	return ret;
 }
@@ -660,11 +780,12 @@ static struct comp_dev *chain_task_create(const struct comp_driver *drv,
 	if (ret)
 		goto error_cd;
 
-#if CONFIG_IPC4_XRUN_NOTIFICATIONS_ENABLE
-	cd->msg_xrun = ipc_msg_init(header.dat,
-				    sizeof(struct ipc4_resource_event_data_notification));
+#if CONFIG_XRUN_NOTIFICATIONS_ENABLE
+#if !CONFIG_XRUN_NOTIFICATIONS_BATCH
+	cd->msg_xrun = ipc_msg_init(0, sizeof(struct ipc4_resource_event_data_notification));
 	if (!cd->msg_xrun)
 		goto error_cd;
+#endif
 	cd->xrun_notification_sent = false;
 #endif
 
@@ -682,6 +803,9 @@ static void chain_task_free(struct comp_dev *dev)
 	struct chain_dma_data *cd = comp_get_drvdata(dev);
 
 	chain_release(dev);
+#if CONFIG_XRUN_NOTIFICATIONS_ENABLE
+	ipc_msg_free(cd->msg_xrun);
+#endif
 	rfree(cd);
 	rfree(dev);
 }
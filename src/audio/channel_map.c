@@ -4,6 +4,7 @@
 //
 // Author: Slawomir Blauciak <slawomir.blauciak@linux.intel.com>
 
+#include <sof/audio/audio_stream.h>
 #include <sof/audio/channel_map.h>
 #include <sof/lib/uuid.h>
 #include <sof/trace/trace.h>
@@ -11,6 +12,7 @@
 #include <rtos/bit.h>
 #include <sof/common.h>
 #include <ipc/channel_map.h>
+#include <errno.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -44,3 +46,291 @@ struct sof_ipc_channel_map *chmap_get(struct sof_ipc_stream_map *smap,
 
 	return chmap;
 }
+
+void chmap_remap_reset(struct chmap_remap *remap)
+{
+	remap->num_terms = 0;
+	remap->num_outs = 0;
+	remap->kind = CHMAP_REMAP_NONE;
+	remap->func = NULL;
+}
+
+int chmap_remap_route(struct chmap_remap *remap, uint32_t in_ch, uint32_t out_ch)
+{
+	int i;
+
+	if (in_ch >= PLATFORM_MAX_CHANNELS || out_ch >= PLATFORM_MAX_CHANNELS)
+		return -EINVAL;
+
+	for (i = 0; i < remap->num_terms; i++) {
+		if (remap->terms[i].out_ch == out_ch) {
+			remap->terms[i].in_ch = in_ch;
+			remap->terms[i].gain = CHMAP_REMAP_GAIN_UNITY;
+			remap->func = NULL;
+			return 0;
+		}
+	}
+
+	return chmap_remap_mix(remap, in_ch, out_ch, CHMAP_REMAP_GAIN_UNITY);
+}
+
+int chmap_remap_mix(struct chmap_remap *remap, uint32_t in_ch, uint32_t out_ch,
+		    int32_t gain)
+{
+	struct chmap_remap_term *term;
+
+	if (in_ch >= PLATFORM_MAX_CHANNELS || out_ch >= PLATFORM_MAX_CHANNELS ||
+	    remap->num_terms >= CHMAP_REMAP_MAX_TERMS)
+		return -EINVAL;
+
+	term = &remap->terms[remap->num_terms++];
+	term->in_ch = in_ch;
+	term->out_ch = out_ch;
+	term->gain = gain;
+	remap->func = NULL;
+	return 0;
+}
+
+static chmap_remap_func chmap_remap_select(const struct chmap_remap *remap)
+{
+	enum sof_ipc_frame fmt = remap->in_fmt;
+	int i;
+
+	if (remap->in_fmt != remap->out_fmt) {
+		if (fmt != SOF_IPC_FRAME_S16_LE || remap->out_fmt != SOF_IPC_FRAME_S32_LE)
+			return NULL;
+
+		/* the matrix kernel covers the gains with one term per output */
+		if (remap->kind == CHMAP_REMAP_SHUFFLE)
+			return chmap_remap_shuffle_s16_s32;
+
+		return chmap_remap_matrix_s16_s32;
+	}
+
+	switch (remap->kind) {
+	case CHMAP_REMAP_SHUFFLE:
+		/* all channels in the same order is a plain copy */
+		if (remap->num_outs == remap->in_channels &&
+		    remap->num_outs == remap->out_channels) {
+			for (i = 0; i < remap->num_outs; i++)
+				if (remap->terms[i].in_ch != remap->terms[i].out_ch)
+					break;
+
+			if (i == remap->num_outs)
+				return chmap_remap_copy;
+		}
+
+		if (fmt == SOF_IPC_FRAME_S16_LE)
+			return chmap_remap_shuffle_s16;
+		if (fmt == SOF_IPC_FRAME_S24_4LE || fmt == SOF_IPC_FRAME_S32_LE)
+			return chmap_remap_shuffle_s32;
+		break;
+	case CHMAP_REMAP_GAIN:
+		if (fmt == SOF_IPC_FRAME_S16_LE)
+			return chmap_remap_gain_s16;
+		if (fmt == SOF_IPC_FRAME_S24_4LE)
+			return chmap_remap_gain_s24;
+		if (fmt == SOF_IPC_FRAME_S32_LE)
+			return chmap_remap_gain_s32;
+		break;
+	case CHMAP_REMAP_MATRIX:
+		if (fmt == SOF_IPC_FRAME_S16_LE)
+			return chmap_remap_matrix_s16;
+		if (fmt == SOF_IPC_FRAME_S24_4LE)
+			return chmap_remap_matrix_s24;
+		if (fmt == SOF_IPC_FRAME_S32_LE)
+			return chmap_remap_matrix_s32;
+		break;
+	default:
+		break;
+	}
+
+	return NULL;
+}
+
+int chmap_remap_compile(struct chmap_remap *remap, enum sof_ipc_frame in_fmt,
+			enum sof_ipc_frame out_fmt, uint32_t in_channels,
+			uint32_t out_channels)
+{
+	struct chmap_remap_term tmp;
+	uint32_t num_active = 0;
+	int i, j;
+
+	if (remap->func && remap->in_fmt == in_fmt && remap->out_fmt == out_fmt &&
+	    remap->in_channels == in_channels && remap->out_channels == out_channels)
+		return 0;
+
+	remap->in_fmt = in_fmt;
+	remap->out_fmt = out_fmt;
+	remap->in_channels = in_channels;
+	remap->out_channels = out_channels;
+	remap->num_outs = 0;
+	remap->func = NULL;
+
+	/* move the active terms first, sorted by the output channel */
+	for (i = 0; i < remap->num_terms; i++) {
+		if (remap->terms[i].in_ch >= in_channels || remap->terms[i].out_ch >= out_channels)
+			continue;
+
+		tmp = remap->terms[i];
+		remap->terms[i] = remap->terms[num_active];
+		for (j = num_active; j > 0 && remap->terms[j - 1].out_ch > tmp.out_ch; j--)
+			remap->terms[j] = remap->terms[j - 1];
+
+		remap->terms[j] = tmp;
+		num_active++;
+	}
+
+	remap->kind = num_active ? CHMAP_REMAP_SHUFFLE : CHMAP_REMAP_NONE;
+	for (i = 0; i < num_active; i++) {
+		if (!i || remap->terms[i].out_ch != remap->terms[i - 1].out_ch) {
+			remap->out_ch[remap->num_outs] = remap->terms[i].out_ch;
+			remap->out_terms[remap->num_outs] = 0;
+			remap->num_outs++;
+		}
+
+		remap->out_terms[remap->num_outs - 1]++;
+		if (remap->out_terms[remap->num_outs - 1] > 1)
+			remap->kind = CHMAP_REMAP_MATRIX;
+		else if (remap->terms[i].gain != CHMAP_REMAP_GAIN_UNITY &&
+			 remap->kind == CHMAP_REMAP_SHUFFLE)
+			remap->kind = CHMAP_REMAP_GAIN;
+	}
+
+	/* nothing is written, the kernel only marks the remap compiled */
+	if (remap->kind == CHMAP_REMAP_NONE) {
+		remap->func = chmap_remap_copy;
+		return 0;
+	}
+
+	remap->func = chmap_remap_select(remap);
+	if (!remap->func) {
+		tr_err(&chmap_tr, "chmap_remap_compile(): no kernel for kind %d, formats %d %d",
+		       remap->kind, in_fmt, out_fmt);
+		remap->num_outs = 0;
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+void chmap_remap_process(const struct chmap_remap *remap,
+			 const struct audio_stream *source,
+			 struct audio_stream *sink, uint32_t frames)
+{
+	uint8_t *src = audio_stream_get_rptr(source);
+	uint8_t *dst = audio_stream_get_wptr(sink);
+	uint32_t src_frame_bytes = audio_stream_frame_bytes(source);
+	uint32_t dst_frame_bytes = audio_stream_frame_bytes(sink);
+	uint32_t n;
+
+	if (!remap->num_outs)
+		return;
+
+	while (frames) {
+		n = MIN(audio_stream_frames_without_wrap(source, src),
+			audio_stream_frames_without_wrap(sink, dst));
+		n = MIN(n, frames);
+		remap->func(remap, src, dst, n);
+		src = audio_stream_wrap(source, src + n * src_frame_bytes);
+		dst = audio_stream_wrap(sink, dst + n * dst_frame_bytes);
+		frames -= n;
+	}
+}
+
+int chmap_split_compile(struct chmap_split *split, enum sof_ipc_frame fmt,
+			uint32_t channels, uint32_t num_parts,
+			const uint32_t *part_channels, const uint8_t *map)
+{
+	uint32_t total = 0;
+	bool pairs;
+	int i;
+
+	split->split = NULL;
+	split->merge = NULL;
+
+	if (!num_parts || num_parts > CHMAP_SPLIT_MAX_PARTS || !channels ||
+	    channels > PLATFORM_MAX_CHANNELS) {
+		tr_err(&chmap_tr, "chmap_split_compile(): invalid %u parts of %u channels",
+		       num_parts, channels);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < num_parts; i++) {
+		if (!part_channels[i] || total + part_channels[i] > PLATFORM_MAX_CHANNELS) {
+			tr_err(&chmap_tr, "chmap_split_compile(): invalid part %d channels %u",
+			       i, part_channels[i]);
+			return -EINVAL;
+		}
+
+		split->part_channels[i] = part_channels[i];
+		total += part_channels[i];
+	}
+
+	/* the pair kernels move the interleaved channels in order */
+	pairs = total == channels;
+	for (i = 0; i < num_parts; i++)
+		if (part_channels[i] & 1)
+			pairs = false;
+
+	for (i = 0; i < total; i++) {
+		if (map[i] >= channels) {
+			tr_err(&chmap_tr, "chmap_split_compile(): invalid channel %u", map[i]);
+			return -EINVAL;
+		}
+
+		split->map[i] = map[i];
+		if (map[i] != i)
+			pairs = false;
+	}
+
+	split->fmt = fmt;
+	split->channels = channels;
+	split->num_parts = num_parts;
+
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		split->split = chmap_split_s16;
+		split->merge = chmap_merge_s16;
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+	case SOF_IPC_FRAME_S32_LE:
+		split->split = pairs ? chmap_split_pairs_s32 : chmap_split_s32;
+		split->merge = pairs ? chmap_merge_pairs_s32 : chmap_merge_s32;
+		break;
+	default:
+		tr_err(&chmap_tr, "chmap_split_compile(): no kernel for format %d", fmt);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+void chmap_split_process(const struct chmap_split *split, struct audio_stream *inter,
+			 struct audio_stream **parts, uint32_t frames, bool merge)
+{
+	chmap_split_func func = merge ? split->merge : split->split;
+	void *part_ptr[CHMAP_SPLIT_MAX_PARTS];
+	uint8_t *ptr;
+	uint32_t n;
+	int i;
+
+	ptr = merge ? audio_stream_get_wptr(inter) : audio_stream_get_rptr(inter);
+	for (i = 0; i < split->num_parts; i++)
+		part_ptr[i] = merge ? audio_stream_get_rptr(parts[i]) :
+				      audio_stream_get_wptr(parts[i]);
+
+	while (frames) {
+		n = MIN(frames, audio_stream_frames_without_wrap(inter, ptr));
+		for (i = 0; i < split->num_parts; i++)
+			n = MIN(n, audio_stream_frames_without_wrap(parts[i], part_ptr[i]));
+
+		func(split, ptr, part_ptr, n);
+
+		ptr = audio_stream_wrap(inter, ptr + n * audio_stream_frame_bytes(inter));
+		for (i = 0; i < split->num_parts; i++)
+			part_ptr[i] = audio_stream_wrap(parts[i], (uint8_t *)part_ptr[i] +
+							n * audio_stream_frame_bytes(parts[i]));
+		frames -= n;
+	}
+}
@@ -0,0 +1,392 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/channel_map.h>
+#include <sof/audio/format.h>
+#include <rtos/string.h>
+#include <stdint.h>
+
+/* The shuffle, 16 bit and split kernels are shared by all code variants, the
+ * 24 and 32 bit gain and matrix kernels and the pair split kernels have a
+ * HiFi3 version.
+ */
+
+void chmap_remap_copy(const struct chmap_remap *remap, const void *src, void *dst,
+		      uint32_t frames)
+{
+	size_t bytes = (size_t)frames * remap->out_channels *
+		(remap->out_fmt == SOF_IPC_FRAME_S16_LE ? sizeof(int16_t) : sizeof(int32_t));
+
+	memcpy_s(dst, bytes, src, bytes);
+}
+
+void chmap_remap_shuffle_s16(const struct chmap_remap *remap, const void *src, void *dst,
+			     uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int16_t *x = src;
+	int16_t *y = dst;
+	const int num_outs = remap->num_outs;
+	int i, j;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++, term++)
+			y[term->out_ch] = x[term->in_ch];
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_remap_shuffle_s32(const struct chmap_remap *remap, const void *src, void *dst,
+			     uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int32_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	int i, j;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++, term++)
+			y[term->out_ch] = x[term->in_ch];
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_remap_shuffle_s16_s32(const struct chmap_remap *remap, const void *src,
+				 void *dst, uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int16_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	int i, j;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++, term++)
+			y[term->out_ch] = (int32_t)x[term->in_ch] << 16;
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_remap_gain_s16(const struct chmap_remap *remap, const void *src, void *dst,
+			  uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int16_t *x = src;
+	int16_t *y = dst;
+	const int num_outs = remap->num_outs;
+	int i, j;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++, term++)
+			y[term->out_ch] = q_multsr_sat_32x32_16(x[term->in_ch], term->gain,
+								CHMAP_REMAP_GAIN_SHIFT);
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_remap_matrix_s16(const struct chmap_remap *remap, const void *src, void *dst,
+			    uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int16_t *x = src;
+	int16_t *y = dst;
+	const int num_outs = remap->num_outs;
+	int64_t acc;
+	int i, j, k;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++) {
+			acc = 0;
+			for (k = 0; k < remap->out_terms[j]; k++, term++)
+				acc += (int64_t)x[term->in_ch] * term->gain;
+
+			y[remap->out_ch[j]] = sat_int16(Q_SHIFT_RND(acc, CHMAP_REMAP_GAIN_SHIFT, 0));
+		}
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+/* The s16 input is mixed to the 16 MSB of the s32 output */
+void chmap_remap_matrix_s16_s32(const struct chmap_remap *remap, const void *src,
+				void *dst, uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int16_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	int64_t acc;
+	int i, j, k;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++) {
+			acc = 0;
+			for (k = 0; k < remap->out_terms[j]; k++, term++)
+				acc += (int64_t)x[term->in_ch] * term->gain;
+
+			y[remap->out_ch[j]] = sat_int32(Q_SHIFT_RND(acc, CHMAP_REMAP_GAIN_SHIFT,
+								    16));
+		}
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_split_s16(const struct chmap_split *split, void *inter, void **parts,
+		     uint32_t frames)
+{
+	int16_t *y[CHMAP_SPLIT_MAX_PARTS];
+	const int16_t *x = inter;
+	const uint8_t *map;
+	const int num_parts = split->num_parts;
+	int i, j, k;
+
+	for (j = 0; j < num_parts; j++)
+		y[j] = parts[j];
+
+	for (i = 0; i < frames; i++) {
+		map = split->map;
+		for (j = 0; j < num_parts; j++) {
+			for (k = 0; k < split->part_channels[j]; k++)
+				y[j][k] = x[*map++];
+
+			y[j] += split->part_channels[j];
+		}
+
+		x += split->channels;
+	}
+}
+
+void chmap_merge_s16(const struct chmap_split *split, void *inter, void **parts,
+		     uint32_t frames)
+{
+	const int16_t *x[CHMAP_SPLIT_MAX_PARTS];
+	int16_t *y = inter;
+	const uint8_t *map;
+	const int num_parts = split->num_parts;
+	int i, j, k;
+
+	for (j = 0; j < num_parts; j++)
+		x[j] = parts[j];
+
+	for (i = 0; i < frames; i++) {
+		map = split->map;
+		for (j = 0; j < num_parts; j++) {
+			for (k = 0; k < split->part_channels[j]; k++)
+				y[*map++] = x[j][k];
+
+			x[j] += split->part_channels[j];
+		}
+
+		y += split->channels;
+	}
+}
+
+void chmap_split_s32(const struct chmap_split *split, void *inter, void **parts,
+		     uint32_t frames)
+{
+	int32_t *y[CHMAP_SPLIT_MAX_PARTS];
+	const int32_t *x = inter;
+	const uint8_t *map;
+	const int num_parts = split->num_parts;
+	int i, j, k;
+
+	for (j = 0; j < num_parts; j++)
+		y[j] = parts[j];
+
+	for (i = 0; i < frames; i++) {
+		map = split->map;
+		for (j = 0; j < num_parts; j++) {
+			for (k = 0; k < split->part_channels[j]; k++)
+				y[j][k] = x[*map++];
+
+			y[j] += split->part_channels[j];
+		}
+
+		x += split->channels;
+	}
+}
+
+void chmap_merge_s32(const struct chmap_split *split, void *inter, void **parts,
+		     uint32_t frames)
+{
+	const int32_t *x[CHMAP_SPLIT_MAX_PARTS];
+	int32_t *y = inter;
+	const uint8_t *map;
+	const int num_parts = split->num_parts;
+	int i, j, k;
+
+	for (j = 0; j < num_parts; j++)
+		x[j] = parts[j];
+
+	for (i = 0; i < frames; i++) {
+		map = split->map;
+		for (j = 0; j < num_parts; j++) {
+			for (k = 0; k < split->part_channels[j]; k++)
+				y[*map++] = x[j][k];
+
+			x[j] += split->part_channels[j];
+		}
+
+		y += split->channels;
+	}
+}
+
+#if CHMAP_REMAP_GENERIC
+
+void chmap_remap_gain_s24(const struct chmap_remap *remap, const void *src, void *dst,
+			  uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int32_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	int i, j;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++, term++)
+			y[term->out_ch] = q_multsr_sat_32x32_24(sign_extend_s24(x[term->in_ch]),
+								term->gain, CHMAP_REMAP_GAIN_SHIFT);
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_remap_gain_s32(const struct chmap_remap *remap, const void *src, void *dst,
+			  uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int32_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	int i, j;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++, term++)
+			y[term->out_ch] = q_multsr_sat_32x32(x[term->in_ch], term->gain,
+							     CHMAP_REMAP_GAIN_SHIFT);
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_remap_matrix_s24(const struct chmap_remap *remap, const void *src, void *dst,
+			    uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int32_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	int64_t acc;
+	int i, j, k;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++) {
+			acc = 0;
+			for (k = 0; k < remap->out_terms[j]; k++, term++)
+				acc += (int64_t)sign_extend_s24(x[term->in_ch]) * term->gain;
+
+			y[remap->out_ch[j]] = sat_int24(Q_SHIFT_RND(acc, CHMAP_REMAP_GAIN_SHIFT, 0));
+		}
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_remap_matrix_s32(const struct chmap_remap *remap, const void *src, void *dst,
+			    uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int32_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	int64_t acc;
+	int i, j, k;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++) {
+			acc = 0;
+			for (k = 0; k < remap->out_terms[j]; k++, term++)
+				acc += (int64_t)x[term->in_ch] * term->gain;
+
+			y[remap->out_ch[j]] = sat_int32(Q_SHIFT_RND(acc, CHMAP_REMAP_GAIN_SHIFT, 0));
+		}
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+/* The parts take the interleaved channels in order, a pair at a time */
+void chmap_split_pairs_s32(const struct chmap_split *split, void *inter, void **parts,
+			   uint32_t frames)
+{
+	int32_t *y[CHMAP_SPLIT_MAX_PARTS];
+	const int32_t *x = inter;
+	const int num_parts = split->num_parts;
+	int i, j, k;
+
+	for (j = 0; j < num_parts; j++)
+		y[j] = parts[j];
+
+	for (i = 0; i < frames; i++) {
+		for (j = 0; j < num_parts; j++) {
+			for (k = 0; k < split->part_channels[j]; k += 2) {
+				y[j][0] = x[0];
+				y[j][1] = x[1];
+				y[j] += 2;
+				x += 2;
+			}
+		}
+	}
+}
+
+void chmap_merge_pairs_s32(const struct chmap_split *split, void *inter, void **parts,
+			   uint32_t frames)
+{
+	const int32_t *x[CHMAP_SPLIT_MAX_PARTS];
+	int32_t *y = inter;
+	const int num_parts = split->num_parts;
+	int i, j, k;
+
+	for (j = 0; j < num_parts; j++)
+		x[j] = parts[j];
+
+	for (i = 0; i < frames; i++) {
+		for (j = 0; j < num_parts; j++) {
+			for (k = 0; k < split->part_channels[j]; k += 2) {
+				y[0] = x[j][0];
+				y[1] = x[j][1];
+				x[j] += 2;
+				y += 2;
+			}
+		}
+	}
+}
+
+#endif /* CHMAP_REMAP_GENERIC */
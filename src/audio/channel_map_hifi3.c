@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/channel_map.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#if CHMAP_REMAP_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/* The product of a Q1.31 sample and a Q2.30 gain is Q18.46 after the
+ * fractional multiply. It is shifted left by one to Q17.47 for the rounding
+ * to Q1.31, and by eight more for the 24 bit samples to saturate them to 24
+ * bits before they are shifted back. The matrix sums are accumulated in 64
+ * bits before the single rounding.
+ */
+
+void chmap_remap_gain_s24(const struct chmap_remap *remap, const void *src, void *dst,
+			  uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int32_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	ae_f64 acc;
+	ae_f32x2 sample;
+	ae_f32x2 gain;
+	int i, j;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++, term++) {
+			sample = AE_SLAI32(AE_MOVDA32(x[term->in_ch]), 8);
+			gain = AE_MOVDA32(term->gain);
+			acc = AE_MULF32R_LL(sample, gain);
+			acc = AE_SLAI64S(acc, 1);
+			sample = AE_SRAI32(AE_ROUND32F48SSYM(acc), 8);
+			y[term->out_ch] = AE_MOVAD32_L(sample);
+		}
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_remap_gain_s32(const struct chmap_remap *remap, const void *src, void *dst,
+			  uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int32_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	ae_f64 acc;
+	ae_f32x2 sample;
+	ae_f32x2 gain;
+	int i, j;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++, term++) {
+			sample = AE_MOVDA32(x[term->in_ch]);
+			gain = AE_MOVDA32(term->gain);
+			acc = AE_MULF32R_LL(sample, gain);
+			acc = AE_SLAI64S(acc, 1);
+			y[term->out_ch] = AE_MOVAD32_L(AE_ROUND32F48SSYM(acc));
+		}
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_remap_matrix_s24(const struct chmap_remap *remap, const void *src, void *dst,
+			    uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int32_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	ae_f64 acc;
+	ae_f32x2 sample;
+	ae_f32x2 gain;
+	int i, j, k;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++) {
+			acc = AE_ZERO64();
+			for (k = 0; k < remap->out_terms[j]; k++, term++) {
+				sample = AE_SLAI32(AE_MOVDA32(x[term->in_ch]), 8);
+				gain = AE_MOVDA32(term->gain);
+				AE_MULAF32R_LL(acc, sample, gain);
+			}
+
+			acc = AE_SLAI64S(acc, 1);
+			sample = AE_SRAI32(AE_ROUND32F48SSYM(acc), 8);
+			y[remap->out_ch[j]] = AE_MOVAD32_L(sample);
+		}
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+void chmap_remap_matrix_s32(const struct chmap_remap *remap, const void *src, void *dst,
+			    uint32_t frames)
+{
+	const struct chmap_remap_term *term;
+	const int32_t *x = src;
+	int32_t *y = dst;
+	const int num_outs = remap->num_outs;
+	ae_f64 acc;
+	ae_f32x2 sample;
+	ae_f32x2 gain;
+	int i, j, k;
+
+	for (i = 0; i < frames; i++) {
+		term = remap->terms;
+		for (j = 0; j < num_outs; j++) {
+			acc = AE_ZERO64();
+			for (k = 0; k < remap->out_terms[j]; k++, term++) {
+				sample = AE_MOVDA32(x[term->in_ch]);
+				gain = AE_MOVDA32(term->gain);
+				AE_MULAF32R_LL(acc, sample, gain);
+			}
+
+			acc = AE_SLAI64S(acc, 1);
+			y[remap->out_ch[j]] = AE_MOVAD32_L(AE_ROUND32F48SSYM(acc));
+		}
+
+		x += remap->in_channels;
+		y += remap->out_channels;
+	}
+}
+
+/* The pairs are moved with 64 bit loads and stores which need 64 bit aligned
+ * buffers. The frames of the pair layouts are multiples of 64 bits, so only
+ * the start addresses are checked, the generic kernels take the others.
+ */
+static bool chmap_split_aligned(const struct chmap_split *split, void *inter, void **parts)
+{
+	uintptr_t addr = (uintptr_t)inter;
+	int j;
+
+	for (j = 0; j < split->num_parts; j++)
+		addr |= (uintptr_t)parts[j];
+
+	return !(addr & (sizeof(ae_int32x2) - 1));
+}
+
+void chmap_split_pairs_s32(const struct chmap_split *split, void *inter, void **parts,
+			   uint32_t frames)
+{
+	ae_int32x2 *y[CHMAP_SPLIT_MAX_PARTS];
+	ae_int32x2 *x = inter;
+	ae_int32x2 *out;
+	ae_int32x2 pair;
+	const int num_parts = split->num_parts;
+	int i, j, k;
+
+	if (!chmap_split_aligned(split, inter, parts)) {
+		chmap_split_s32(split, inter, parts, frames);
+		return;
+	}
+
+	for (j = 0; j < num_parts; j++)
+		y[j] = parts[j];
+
+	for (i = 0; i < frames; i++) {
+		for (j = 0; j < num_parts; j++) {
+			out = y[j];
+			for (k = 0; k < split->part_channels[j]; k += 2) {
+				AE_L32X2_IP(pair, x, sizeof(ae_int32x2));
+				AE_S32X2_IP(pair, out, sizeof(ae_int32x2));
+			}
+			y[j] = out;
+		}
+	}
+}
+
+void chmap_merge_pairs_s32(const struct chmap_split *split, void *inter, void **parts,
+			   uint32_t frames)
+{
+	ae_int32x2 *x[CHMAP_SPLIT_MAX_PARTS];
+	ae_int32x2 *y = inter;
+	ae_int32x2 *in;
+	ae_int32x2 pair;
+	const int num_parts = split->num_parts;
+	int i, j, k;
+
+	if (!chmap_split_aligned(split, inter, parts)) {
+		chmap_merge_s32(split, inter, parts, frames);
+		return;
+	}
+
+	for (j = 0; j < num_parts; j++)
+		x[j] = parts[j];
+
+	for (i = 0; i < frames; i++) {
+		for (j = 0; j < num_parts; j++) {
+			in = x[j];
+			for (k = 0; k < split->part_channels[j]; k += 2) {
+				AE_L32X2_IP(pair, in, sizeof(ae_int32x2));
+				AE_S32X2_IP(pair, y, sizeof(ae_int32x2));
+			}
+			x[j] = in;
+		}
+	}
+}
+
+#endif /* CHMAP_REMAP_HIFI3 */
@@ -4,6 +4,7 @@
 //
 // Author: Liam Girdwood <liam.r.girdwood@linux.intel.com>
 
+#include <sof/audio/block_copy.h>
 #include <sof/audio/component_ext.h>
 #include <sof/common.h>
 #include <rtos/panic.h>
@@ -21,11 +22,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#if defined(__XCC__)
-#include <xtensa/config/core-isa.h>
-#if XCHAL_HAVE_HIFI3 || XCHAL_HAVE_HIFI4
-#define STREAMCOPY_HIFI3
-#endif
+#if CONFIG_COMP_DRIVER_TABLE
+#include <zephyr/sys/iterable_sections.h>
 #endif
 
 LOG_MODULE_REGISTER(component, CONFIG_SOF_LOG_LEVEL);
@@ -60,6 +58,18 @@ void comp_unregister(struct comp_driver_info *drv)
 	k_spin_unlock(&drivers->lock, key);
 }
 
+#if CONFIG_COMP_DRIVER_TABLE
+const struct comp_driver *comp_driver_table_get(const uint8_t *uuid)
+{
+	STRUCT_SECTION_FOREACH(comp_driver, drv) {
+		if (!memcmp(drv->uid, uuid, UUID_SIZE))
+			return drv;
+	}
+
+	return NULL;
+}
+#endif
+
 /* NOTE: Keep the component state diagram up to date:
  * sof-docs/developer_guides/firmware/components/images/comp-dev-states.pu
  */
@@ -180,53 +190,6 @@ void comp_get_copy_limits_frame_aligned(const struct comp_buffer *source,
 	cl->sink_bytes = cl->frames * cl->sink_frame_bytes;
 }
 
-#ifdef STREAMCOPY_HIFI3
-
-int audio_stream_copy(const struct audio_stream *source, uint32_t ioffset,
-		      struct audio_stream *sink, uint32_t ooffset, uint32_t samples)
-{
-	int ssize = audio_stream_sample_bytes(source); /* src fmt == sink fmt */
-	ae_int16x4 *src = (ae_int16x4 *)((int8_t *)audio_stream_get_rptr(source) + ioffset * ssize);
-	ae_int16x4 *dst = (ae_int16x4 *)((int8_t *)audio_stream_get_wptr(sink) + ooffset * ssize);
-	int shorts = samples * ssize >> 1;
-	int shorts_src;
-	int shorts_dst;
-	int shorts_copied;
-	int left, m, i;
-	ae_int16x4 in_sample = AE_ZERO16();
-	ae_valign inu = AE_ZALIGN64();
-	ae_valign outu = AE_ZALIGN64();
-
-	/* copy with 16bit as the minimum unit since the minimum sample size is 16 bit*/
-	while (shorts) {
-		src = audio_stream_wrap(source, src);
-		dst = audio_stream_wrap(sink, dst);
-		shorts_src = audio_stream_samples_without_wrap_s16(source, src);
-		shorts_dst = audio_stream_samples_without_wrap_s16(sink, dst);
-		shorts_copied = AE_MIN_32_signed(shorts_src, shorts_dst);
-		shorts_copied = AE_MIN_32_signed(shorts, shorts_copied);
-		m = shorts_copied >> 2;
-		left = shorts_copied & 0x03;
-		inu = AE_LA64_PP(src);
-		/* copy 4 * 16bit(8 bytes)per loop */
-		for (i = 0; i < m; i++) {
-			AE_LA16X4_IP(in_sample, inu, src);
-			AE_SA16X4_IP(in_sample, outu, dst);
-		}
-		AE_SA64POS_FP(outu, dst);
-
-		/* process the left bits that less than 4 * 16 */
-		for (i = 0; i < left ; i++) {
-			AE_L16_IP(in_sample, (ae_int16 *)src, sizeof(ae_int16));
-			AE_S16_0_IP(in_sample, (ae_int16 *)dst, sizeof(ae_int16));
-		}
-		shorts -= shorts_copied;
-	}
-	return samples;
-}
-
-#else
-
 int audio_stream_copy(const struct audio_stream *source, uint32_t ioffset,
 		      struct audio_stream *sink, uint32_t ooffset, uint32_t samples)
 {
@@ -245,7 +208,7 @@ int audio_stream_copy(const struct audio_stream *source, uint32_t ioffset,
 		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
 		bytes_copied = MIN(bytes_src, bytes_snk);
 		bytes_copied = MIN(bytes, bytes_copied);
-		memcpy(snk, src, bytes_copied);
+		audio_block_copy(snk, src, bytes_copied);
 		bytes -= bytes_copied;
 		src = audio_stream_wrap(source, src + bytes_copied);
 		snk = audio_stream_wrap(sink, snk + bytes_copied);
@@ -254,8 +217,6 @@ int audio_stream_copy(const struct audio_stream *source, uint32_t ioffset,
 	return samples;
 }
 
-#endif
-
 void cir_buf_copy(void *src, void *src_addr, void *src_end, void *dst,
 		  void *dst_addr, void *dst_end, size_t byte_size)
 {
@@ -271,7 +232,7 @@ void cir_buf_copy(void *src, void *src_addr, void *src_end, void *dst,
 		bytes_dst = cir_buf_bytes_without_wrap(out, dst_end);
 		bytes_copied = MIN(bytes_src, bytes_dst);
 		bytes_copied = MIN(bytes, bytes_copied);
-		memcpy_s(out, bytes_copied, in, bytes_copied);
+		audio_block_copy(out, in, bytes_copied);
 		bytes -= bytes_copied;
 		in = cir_buf_wrap(in + bytes_copied, src_addr, src_end);
 		out = cir_buf_wrap(out + bytes_copied, dst_addr, dst_end);
@@ -293,7 +254,7 @@ void audio_stream_copy_from_linear(const void *linear_source, int ioffset,
 	while (bytes) {
 		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
 		bytes_copied = MIN(bytes, bytes_snk);
-		memcpy(snk, src, bytes_copied);
+		audio_block_copy(snk, src, bytes_copied);
 		bytes -= bytes_copied;
 		src += bytes_copied;
 		snk = audio_stream_wrap(sink, snk + bytes_copied);
@@ -314,7 +275,7 @@ void audio_stream_copy_to_linear(const struct audio_stream *source, int ioffset,
 	while (bytes) {
 		bytes_src = audio_stream_bytes_without_wrap(source, src);
 		bytes_copied = MIN(bytes, bytes_src);
-		memcpy(snk, src, bytes_copied);
+		audio_block_copy(snk, src, bytes_copied);
 		bytes -= bytes_copied;
 		src = audio_stream_wrap(source, src + bytes_copied);
 		snk += bytes_copied;
@@ -40,6 +40,9 @@
 #include "host_copier.h"
 #include "dai_copier.h"
 #include "ipcgtw_copier.h"
+#if CONFIG_COPIER_GAIN
+#include "../volume/peak_volume.h"
+#endif
 
 #if CONFIG_ZEPHYR_NATIVE_DRIVERS
 #include <zephyr/drivers/dai.h>
@@ -243,7 +246,7 @@ static int copier_reset(struct processing_module *mod)
 		if (!cd->ipc_gtw)
 			host_common_reset(cd->hd, dev->state);
 		else
-			copier_ipcgtw_reset(dev);
+			copier_ipcgtw_reset(cd->ipcgtw_data, dev);
 		break;
 	case SOF_COMP_DAI:
 		copier_dai_reset(cd, dev);
@@ -395,8 +398,10 @@ static int do_conversion_copy(struct comp_dev *dev,
 			      struct copier_data *cd,
 			      struct comp_buffer *src,
 			      struct comp_buffer *sink,
-			      struct comp_copy_limits *processed_data)
+			      struct comp_copy_limits *processed_data,
+			      struct copier_fanout *fo)
 {
+	void *wptr;
 	int i;
 
 	/* buffer params might be not yet configured by component on another pipeline */
@@ -408,11 +413,21 @@ static int do_conversion_copy(struct comp_dev *dev,
 	i = IPC4_SINK_QUEUE_ID(sink->id);
 	if (i >= IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT)
 		return -EINVAL;
+
+	if (fo && copier_fanout_copy(fo, cd->converter[i], &sink->stream,
+				     processed_data->sink_bytes))
+		goto out;
+
+	wptr = audio_stream_get_wptr(&sink->stream);
 	buffer_stream_invalidate(src, processed_data->source_bytes);
 
 	cd->converter[i](&src->stream, 0, &sink->stream, 0,
 			 processed_data->frames * audio_stream_get_channels(&sink->stream));
 
+	if (fo)
+		copier_fanout_add(fo, cd->converter[i], &sink->stream, wptr,
+				  processed_data->sink_bytes);
+out:
 	buffer_stream_writeback(sink, processed_data->sink_bytes);
 	comp_update_buffer_produce(sink, processed_data->sink_bytes);
 
@@ -423,6 +438,7 @@ static int copier_copy_to_sinks(struct copier_data *cd, struct comp_dev *dev,
 				struct comp_buffer *src_c,
 				struct comp_copy_limits *processed_data)
 {
+	struct copier_fanout fo = { .count = 0 };
 	struct list_item *sink_list;
 	struct comp_buffer *sink;
 	int ret = 0;
@@ -435,7 +451,7 @@ static int copier_copy_to_sinks(struct copier_data *cd, struct comp_dev *dev,
 		sink_dev = sink->sink;
 		processed_data->sink_bytes = 0;
 		if (sink_dev->state == COMP_STATE_ACTIVE) {
-			ret = do_conversion_copy(dev, cd, src_c, sink, processed_data);
+			ret = do_conversion_copy(dev, cd, src_c, sink, processed_data, &fo);
 			cd->output_total_data_processed += processed_data->sink_bytes;
 		}
 		if (ret < 0) {
@@ -460,6 +476,7 @@ static int copier_module_copy(struct processing_module *mod,
 			      struct output_stream_buffer *output_buffers, int num_output_buffers)
 {
 	struct copier_data *cd = module_get_private_data(mod);
+	struct copier_fanout fo = { .count = 0 };
 	struct comp_buffer *src_c;
 	struct comp_copy_limits processed_data;
 	int i;
@@ -492,10 +509,19 @@ static int copier_module_copy(struct processing_module *mod,
 
 			comp_get_copy_limits(src_c, sink_c, &processed_data);
 
-			samples = processed_data.frames *
-					audio_stream_get_channels(output_buffers[i].data);
-			cd->converter[sink_queue_id](input_buffers[0].data, 0,
-						     output_buffers[i].data, 0, samples);
+			/* the output is produced by the module adapter after the copy */
+			if (!copier_fanout_copy(&fo, cd->converter[sink_queue_id],
+						output_buffers[i].data,
+						processed_data.sink_bytes)) {
+				struct audio_stream *out = output_buffers[i].data;
+				void *wptr = audio_stream_get_wptr(out);
+
+				samples = processed_data.frames * audio_stream_get_channels(out);
+				cd->converter[sink_queue_id](input_buffers[0].data, 0,
+							     out, 0, samples);
+				copier_fanout_add(&fo, cd->converter[sink_queue_id], out, wptr,
+						  processed_data.sink_bytes);
+			}
 
 			output_buffers[i].size = processed_data.sink_bytes;
 			cd->output_total_data_processed += processed_data.sink_bytes;
@@ -518,7 +544,7 @@ static int copier_multi_endpoint_dai_copy(struct copier_data *cd, struct comp_de
 	if (!cd->bsource_buffer) {
 		/* gateway(s) as input */
 		ret = dai_zephyr_multi_endpoint_copy(cd->dd, dev, cd->multi_endpoint_buffer,
-						     cd->endpoint_num);
+						     cd->endpoint_num, cd->split);
 		if (ret < 0)
 			return ret;
 
@@ -536,12 +562,12 @@ static int copier_multi_endpoint_dai_copy(struct copier_data *cd, struct comp_de
 	src = list_first_item(&dev->bsource_list, struct comp_buffer, sink_list);
 
 	/* gateway(s) on output */
-	ret = do_conversion_copy(dev, cd, src, cd->multi_endpoint_buffer, &processed_data);
+	ret = do_conversion_copy(dev, cd, src, cd->multi_endpoint_buffer, &processed_data, NULL);
 	if (ret < 0)
 		return ret;
 
 	ret = dai_zephyr_multi_endpoint_copy(cd->dd, dev, cd->multi_endpoint_buffer,
-					     cd->endpoint_num);
+					     cd->endpoint_num, cd->split);
 	if (!ret) {
 		comp_update_buffer_consume(src, processed_data.source_bytes);
 		cd->input_total_data_processed += processed_data.source_bytes;
@@ -678,6 +704,10 @@ static int copier_set_sink_fmt(struct comp_dev *dev, const void *data,
 	return 0;
 }
 
+#if CONFIG_COPIER_GAIN
+static int copier_gain_enable(struct comp_dev *dev, struct copier_data *cd);
+#endif
+
 static int set_attenuation(struct comp_dev *dev, uint32_t data_offset, const char *data)
 {
 	struct processing_module *mod = comp_get_drvdata(dev);
@@ -709,10 +739,155 @@ static int set_attenuation(struct comp_dev *dev, uint32_t data_offset, const cha
 	}
 
 	cd->attenuation = attenuation;
+	if (cd->hd)
+		cd->hd->attenuation = attenuation;
+
+#if CONFIG_COPIER_GAIN
+	/* the gain conversion of host playback applies the attenuation too,
+	 * the host DMA callback attenuates in a separate pass without it
+	 */
+	if (cd->hd && cd->direction == SOF_IPC_STREAM_PLAYBACK) {
+		if (!cd->gain_enabled && copier_gain_enable(dev, cd) < 0)
+			comp_warn(dev, "attenuation applied after the conversion");
+		if (cd->gain_enabled)
+			pcm_gain_set_attenuation(&cd->gain, attenuation);
+	}
+#endif
+
+	return 0;
+}
+
+#if CONFIG_COPIER_GAIN
+/*
+ * The first gain set up selects the fused conversion of the gateway, from
+ * then on the gateway copy applies the gain and ramps it to new targets.
+ */
+static int copier_gain_enable(struct comp_dev *dev, struct copier_data *cd)
+{
+	uint32_t ch;
+	int ret;
+
+	if (cd->config.base.audio_fmt.channels_count != cd->config.out_fmt.channels_count ||
+	    cd->config.base.audio_fmt.channels_count > SOF_IPC_MAX_CHANNELS) {
+		comp_err(dev, "gateway gain needs the same channels on both sides");
+		return -EINVAL;
+	}
+
+	cd->gain.channels = cd->config.base.audio_fmt.channels_count;
+	for (ch = 0; ch < cd->gain.channels; ch++) {
+		cd->gain.gain[ch] = PCM_GAIN_UNITY;
+		cd->gain.target[ch] = PCM_GAIN_UNITY;
+		cd->gain.step[ch] = 0;
+	}
+	cd->gain.ramp_frames = 0;
+	cd->gain.attenuation = 0;
+	cd->gain.unity = true;
+
+	if (cd->hd) {
+		cd->hd->process_gain = get_converter_gain_func(&cd->gain,
+							       &cd->config.base.audio_fmt,
+							       &cd->config.out_fmt);
+		if (!cd->hd->process_gain) {
+			comp_err(dev, "no gain conversion for the gateway formats");
+			return -EINVAL;
+		}
+		if (cd->direction == SOF_IPC_STREAM_PLAYBACK)
+			pcm_gain_set_attenuation(&cd->gain, cd->attenuation);
+		cd->hd->gain = &cd->gain;
+	} else if (cd->endpoint_num == 1 && cd->dd[0]) {
+		/* the conversion of a DAI is known once its buffers are set up */
+		if (cd->dd[0]->local_buffer && cd->dd[0]->dma_buffer) {
+			ret = copier_dai_gain_params(cd, dev);
+			if (ret < 0)
+				return ret;
+		}
+		cd->dd[0]->gain = &cd->gain;
+	} else {
+		comp_err(dev, "gateway gain needs a single host or DAI gateway");
+		return -EINVAL;
+	}
+
+	cd->gain_enabled = true;
+
+	return 0;
+}
+
+static int copier_set_gain(struct comp_dev *dev, const void *data, size_t size)
+{
+	const struct ipc4_peak_volume_config *cdata = data;
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct copier_data *cd = module_get_private_data(mod);
+	uint32_t fs = cd->config.base.audio_fmt.sampling_frequency;
+	uint64_t ramp_frames = 0;
+	uint32_t ch;
+	int ret;
+
+	if (size < sizeof(*cdata)) {
+		comp_err(dev, "gain data size %zu is incorrect", size);
+		return -EINVAL;
+	}
+
+	if (cdata->target_volume > INT32_MAX) {
+		comp_err(dev, "gain %u is out of range", cdata->target_volume);
+		return -EINVAL;
+	}
+
+	if (!cd->gain_enabled) {
+		ret = copier_gain_enable(dev, cd);
+		if (ret < 0)
+			return ret;
+	}
+
+	if (cdata->channel_id != IPC4_ALL_CHANNELS_MASK && cdata->channel_id >= cd->gain.channels) {
+		comp_err(dev, "gain channel %u is out of range", cdata->channel_id);
+		return -EINVAL;
+	}
+
+	/* all the curves ramp linearly, duration is in 100 ns units, a ramp too
+	 * long to be counted in frames is clamped
+	 */
+	if (cdata->curve_type != IPC4_AUDIO_CURVE_TYPE_NONE && fs) {
+		ramp_frames = MIN(cdata->curve_duration, UINT64_MAX / fs) * fs / 10000000;
+		ramp_frames = MIN(ramp_frames, UINT32_MAX);
+	}
+
+	if (cdata->channel_id != IPC4_ALL_CHANNELS_MASK) {
+		pcm_gain_set_target(&cd->gain, cdata->channel_id, cdata->target_volume,
+				    ramp_frames);
+		return 0;
+	}
+
+	for (ch = 0; ch < cd->gain.channels; ch++)
+		pcm_gain_set_target(&cd->gain, ch, cdata->target_volume, ramp_frames);
 
 	return 0;
 }
 
+static int copier_get_gain(struct copier_data *cd, uint32_t *data_offset_size,
+			   uint8_t *fragment)
+{
+	struct ipc4_peak_volume_config *cdata = (struct ipc4_peak_volume_config *)fragment;
+	uint32_t channels = cd->gain_enabled ? cd->gain.channels :
+			    cd->config.base.audio_fmt.channels_count;
+	uint32_t ch;
+
+	if (*data_offset_size < channels * sizeof(*cdata))
+		return -EINVAL;
+
+	for (ch = 0; ch < channels; ch++) {
+		cdata[ch].channel_id = ch;
+		cdata[ch].target_volume = cd->gain_enabled ? cd->gain.target[ch] : PCM_GAIN_UNITY;
+		cdata[ch].curve_type = IPC4_AUDIO_CURVE_TYPE_NONE;
+		cdata[ch].reserved = 0;
+		cdata[ch].curve_duration = 0;
+	}
+
+	*data_offset_size = channels * sizeof(*cdata);
+
+	return 0;
+}
+#endif
+
 static int copier_set_configuration(struct processing_module *mod,
 				    uint32_t config_id,
 				    enum module_cfg_fragment_position pos,
@@ -730,6 +905,10 @@ static int copier_set_configuration(struct processing_module *mod,
 		return copier_set_sink_fmt(dev, fragment, fragment_size);
 	case IPC4_COPIER_MODULE_CFG_ATTENUATION:
 		return set_attenuation(dev, fragment_size, fragment);
+#if CONFIG_COPIER_GAIN
+	case IPC4_COPIER_MODULE_CFG_PARAM_VOLUME:
+		return copier_set_gain(dev, fragment, fragment_size);
+#endif
 	default:
 		return -EINVAL;
 	}
@@ -819,6 +998,16 @@ static int copier_get_configuration(struct processing_module *mod,
 
 		return 0;
 
+#if CONFIG_COPIER_GAIN
+	case IPC4_COPIER_MODULE_CFG_PARAM_VOLUME:
+		if (copier_get_gain(cd, data_offset_size, fragment) < 0) {
+			comp_err(dev, "Config size %d is inadequate", *data_offset_size);
+			return -EINVAL;
+		}
+
+		return 0;
+#endif
+
 	default:
 		comp_err(dev, "unsupported param %d", config_id);
 		break;
@@ -24,6 +24,7 @@
 #ifndef __SOF_IPC4_COPIER_H__
 #define __SOF_IPC4_COPIER_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <ipc4/base-config.h>
 #include <ipc4/gateway.h>
@@ -191,7 +192,13 @@ enum ipc4_copier_module_config_params {
 	 * uint32_t. Config is only allowed when output pin is set up for 32bit and
 	 * source is connected to Gateway
 	 */
-	IPC4_COPIER_MODULE_CFG_ATTENUATION = 6
+	IPC4_COPIER_MODULE_CFG_ATTENUATION = 6,
+	/* Use LARGE_CONFIG_SET to set the gain of the gateway conversion, the
+	 * same as IPC4_VOLUME of peak volume. Ipc mailbox must contain properly
+	 * built ipc4_peak_volume_config struct. LARGE_CONFIG_GET returns one
+	 * for each channel. Requires CONFIG_COPIER_GAIN.
+	 */
+	IPC4_COPIER_MODULE_CFG_PARAM_VOLUME = 7
 };
 
 struct ipc4_copier_config_timestamp_init_data {
@@ -248,6 +255,8 @@ struct copier_data {
 
 	/* buffer to mux/demux data from/to multiple endpoint buffers for ALH multi-gateway case */
 	struct comp_buffer *multi_endpoint_buffer;
+	/* one pass copy of all the gateways, NULL if each one is copied alone */
+	struct chmap_split *split;
 
 	bool bsource_buffer;
 
@@ -269,6 +278,11 @@ struct copier_data {
 	uint32_t channels[IPC4_ALH_MAX_NUMBER_OF_GTW];
 	uint32_t chan_map[IPC4_ALH_MAX_NUMBER_OF_GTW];
 	struct ipcgtw_data *ipcgtw_data;
+#if CONFIG_COPIER_GAIN
+	/* gain of the gateway conversion, carries the attenuation of host playback */
+	struct pcm_gain gain;
+	bool gain_enabled;
+#endif
 };
 
 int apply_attenuation(struct comp_dev *dev, struct copier_data *cd,
@@ -279,6 +293,73 @@ pcm_converter_func get_converter_func(const struct ipc4_audio_format *in_fmt,
 				      enum ipc4_gateway_type type,
 				      enum ipc4_direction_type dir);
 
+/* conversion function with fused attenuation, NULL if not available for the formats */
+pcm_converter_att_func get_converter_att_func(const struct ipc4_audio_format *in_fmt,
+					      const struct ipc4_audio_format *out_fmt);
+
+#if CONFIG_COPIER_GAIN
+/* conversion function with fused gain, NULL if not available for the formats */
+pcm_converter_gain_func get_converter_gain_func(struct pcm_gain *gain,
+						const struct ipc4_audio_format *in_fmt,
+						const struct ipc4_audio_format *out_fmt);
+#endif
+
+/* Sinks converted by one copy. A later sink of the same converter and format
+ * gets the converted data block copied from the first one instead of running
+ * the conversion again.
+ */
+struct copier_fanout {
+	int count;
+	struct {
+		pcm_converter_func converter;
+		const struct audio_stream *stream;
+		void *wptr;		/* write pointer before the conversion */
+		uint32_t bytes;		/* bytes converted */
+	} done[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
+};
+
+/* records a sink converted from wptr on, to be replicated to later sinks */
+static inline void copier_fanout_add(struct copier_fanout *fo, pcm_converter_func converter,
+				     const struct audio_stream *stream, void *wptr,
+				     uint32_t bytes)
+{
+	if (fo->count == IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT)
+		return;
+
+	fo->done[fo->count].converter = converter;
+	fo->done[fo->count].stream = stream;
+	fo->done[fo->count].wptr = wptr;
+	fo->done[fo->count].bytes = bytes;
+	fo->count++;
+}
+
+/* copies bytes of an identical sink to the write pointer of stream if there
+ * is one, the copy doesn't produce. Returns false if stream needs conversion.
+ */
+static inline bool copier_fanout_copy(struct copier_fanout *fo, pcm_converter_func converter,
+				      struct audio_stream *stream, uint32_t bytes)
+{
+	const struct audio_stream *from;
+	int i;
+
+	for (i = 0; i < fo->count; i++) {
+		from = fo->done[i].stream;
+		if (fo->done[i].converter != converter || fo->done[i].bytes < bytes ||
+		    audio_stream_get_frm_fmt(from) != audio_stream_get_frm_fmt(stream) ||
+		    audio_stream_get_valid_fmt(from) != audio_stream_get_valid_fmt(stream) ||
+		    audio_stream_get_channels(from) != audio_stream_get_channels(stream))
+			continue;
+
+		cir_buf_copy(fo->done[i].wptr, audio_stream_get_addr(from),
+			     audio_stream_get_end_addr(from), audio_stream_get_wptr(stream),
+			     audio_stream_get_addr(stream), audio_stream_get_end_addr(stream),
+			     bytes);
+		return true;
+	}
+
+	return false;
+}
+
 struct comp_ipc_config;
 int create_endpoint_buffer(struct comp_dev *dev,
 			   struct copier_data *cd,
@@ -5,6 +5,7 @@
 // Author: Baofeng Tian <baofeng.tian@intel.com>
 
 #include <sof/trace/trace.h>
+#include <sof/audio/channel_map.h>
 #include <sof/audio/component_ext.h>
 #include <ipc/dai.h>
 #include <sof/audio/module_adapter/module/generic.h>
@@ -286,8 +287,11 @@ void copier_dai_free(struct copier_data *cd)
 {
 	for (int i = 0; i < cd->endpoint_num; i++) {
 		dai_common_free(cd->dd[i]);
+		rfree(cd->dd[i]->remap);
 		rfree(cd->dd[i]);
 	}
+	rfree(cd->split);
+
 	/* only dai have multi endpoint case */
 	if (cd->multi_endpoint_buffer)
 		buffer_free(cd->multi_endpoint_buffer);
@@ -310,87 +314,84 @@ int copier_dai_prepare(struct comp_dev *dev, struct copier_data *cd)
 	return 0;
 }
 
-static int copy_single_channel_c16(const struct audio_stream *src,
-				   unsigned int src_channel,
-				   struct audio_stream *dst,
-				   unsigned int dst_channel, unsigned int frame_count)
+/*
+ * Compiles the one pass copy of all the gateways once the params of the last
+ * one are set. The gateways are copied one at a time when it can't be used.
+ */
+static void copier_dai_split_compile(struct copier_data *cd, struct comp_dev *dev,
+				     enum sof_ipc_frame frame_fmt)
 {
-	int16_t *r_ptr = (int16_t *)audio_stream_get_rptr(src) + src_channel;
-	int16_t *w_ptr = (int16_t *)audio_stream_get_wptr(dst) + dst_channel;
-
-	/* We have to iterate over frames here. However, tracking frames requires using
-	 * of expensive division operations (e.g., inside audio_stream_frames_without_wrap()).
-	 * So let's track samples instead. Since we only copy one channel, src_stream_sample_count
-	 * is NOT number of samples we need to copy but total samples for all channels. We just
-	 * track them to know when to stop.
-	 */
-	int src_stream_sample_count = frame_count * audio_stream_get_channels(src);
-
-	while (src_stream_sample_count) {
-		int src_samples_without_wrap;
-		int16_t *r_end_ptr, *r_ptr_before_loop;
-
-		r_ptr = audio_stream_wrap(src, r_ptr);
-		w_ptr = audio_stream_wrap(dst, w_ptr);
+	uint32_t part_channels[CHMAP_SPLIT_MAX_PARTS];
+	uint8_t map[PLATFORM_MAX_CHANNELS];
+	uint32_t channels = 0;
+	int i, j;
 
-		src_samples_without_wrap = audio_stream_samples_without_wrap_s16(src, r_ptr);
-		r_end_ptr = src_stream_sample_count < src_samples_without_wrap ?
-			r_ptr + src_stream_sample_count : (int16_t *)audio_stream_get_end_addr(src);
+	if (cd->endpoint_num > CHMAP_SPLIT_MAX_PARTS)
+		return;
 
-		r_ptr_before_loop = r_ptr;
+	for (i = 0; i < cd->endpoint_num; i++) {
+		part_channels[i] = audio_stream_get_channels(&cd->dd[i]->dma_buffer->stream);
+		for (j = 0; j < part_channels[i]; j++) {
+			if (channels == PLATFORM_MAX_CHANNELS)
+				return;
 
-		do {
-			*w_ptr = *r_ptr;
-			r_ptr += audio_stream_get_channels(src);
-			w_ptr += audio_stream_get_channels(dst);
-		} while (r_ptr < r_end_ptr && w_ptr < (int16_t *)audio_stream_get_end_addr(dst));
+			map[channels++] = cd->dd[i]->dma_buffer->chmap[j];
+		}
+	}
 
-		src_stream_sample_count -= r_ptr - r_ptr_before_loop;
+	if (!cd->split) {
+		cd->split = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*cd->split));
+		if (!cd->split)
+			return;
 	}
 
-	return 0;
+	if (chmap_split_compile(cd->split, frame_fmt,
+				audio_stream_get_channels(&cd->multi_endpoint_buffer->stream),
+				cd->endpoint_num, part_channels, map) < 0) {
+		comp_warn(dev, "copier_dai_split_compile(): gateways are copied one at a time");
+		rfree(cd->split);
+		cd->split = NULL;
+	}
 }
 
-static int copy_single_channel_c32(const struct audio_stream *src,
-				   unsigned int src_channel,
-				   struct audio_stream *dst,
-				   unsigned int dst_channel, unsigned int frame_count)
+#if CONFIG_COPIER_GAIN
+int copier_dai_gain_params(struct copier_data *cd, struct comp_dev *dev)
 {
-	int32_t *r_ptr = (int32_t *)audio_stream_get_rptr(src) + src_channel;
-	int32_t *w_ptr = (int32_t *)audio_stream_get_wptr(dst) + dst_channel;
-
-	/* We have to iterate over frames here. However, tracking frames requires using
-	 * of expensive division operations (e.g., inside audio_stream_frames_without_wrap()).
-	 * So let's track samples instead. Since we only copy one channel, src_stream_sample_count
-	 * is NOT number of samples we need to copy but total samples for all channels. We just
-	 * track them to know when to stop.
-	 */
-	int src_stream_sample_count = frame_count * audio_stream_get_channels(src);
-
-	while (src_stream_sample_count) {
-		int src_samples_without_wrap;
-		int32_t *r_end_ptr, *r_ptr_before_loop;
-
-		r_ptr = audio_stream_wrap(src, r_ptr);
-		w_ptr = audio_stream_wrap(dst, w_ptr);
-
-		src_samples_without_wrap = audio_stream_samples_without_wrap_s32(src, r_ptr);
-		r_end_ptr = src_stream_sample_count < src_samples_without_wrap ?
-			r_ptr + src_stream_sample_count : (int32_t *)audio_stream_get_end_addr(src);
+	const struct ipc4_audio_format *in_fmt = &cd->config.base.audio_fmt;
+	const struct ipc4_audio_format *out_fmt = &cd->config.out_fmt;
+	enum sof_ipc_frame in_bits, in_valid_bits, out_bits, out_valid_bits;
+	enum sof_ipc_frame local_fmt, dma_fmt;
+	struct dai_data *dd = cd->dd[0];
 
-		r_ptr_before_loop = r_ptr;
+	audio_stream_fmt_conversion(in_fmt->depth, in_fmt->valid_bit_depth,
+				    &in_bits, &in_valid_bits, in_fmt->s_type);
+	audio_stream_fmt_conversion(out_fmt->depth, out_fmt->valid_bit_depth,
+				    &out_bits, &out_valid_bits, out_fmt->s_type);
 
-		do {
-			*w_ptr = *r_ptr;
-			r_ptr += audio_stream_get_channels(src);
-			w_ptr += audio_stream_get_channels(dst);
-		} while (r_ptr < r_end_ptr && w_ptr < (int32_t *)audio_stream_get_end_addr(dst));
+	/* same formats as the conversion chosen by copier_dai_params() */
+	if (in_bits != in_valid_bits || out_bits != out_valid_bits) {
+		dd->process_gain = get_converter_gain_func(&cd->gain, in_fmt, out_fmt);
+	} else {
+		local_fmt = audio_stream_get_frm_fmt(&dd->local_buffer->stream);
+		dma_fmt = audio_stream_get_frm_fmt(&dd->dma_buffer->stream);
+		if (dev->direction == SOF_IPC_STREAM_PLAYBACK)
+			dd->process_gain = pcm_get_conversion_gain_function(&cd->gain,
+									    local_fmt, local_fmt,
+									    dma_fmt, dma_fmt);
+		else
+			dd->process_gain = pcm_get_conversion_gain_function(&cd->gain,
+									    dma_fmt, dma_fmt,
+									    local_fmt, local_fmt);
+	}
 
-		src_stream_sample_count -= r_ptr - r_ptr_before_loop;
+	if (!dd->process_gain) {
+		comp_err(dev, "copier_dai_gain_params(): no gain conversion for the formats");
+		return -EINVAL;
 	}
 
 	return 0;
 }
+#endif
 
 int copier_dai_params(struct copier_data *cd, struct comp_dev *dev,
 		      struct sof_ipc_stream_params *params, int dai_index)
@@ -399,6 +400,9 @@ int copier_dai_params(struct copier_data *cd, struct comp_dev *dev,
 	const struct ipc4_audio_format *in_fmt = &cd->config.base.audio_fmt;
 	const struct ipc4_audio_format *out_fmt = &cd->config.out_fmt;
 	enum sof_ipc_frame in_bits, in_valid_bits, out_bits, out_valid_bits;
+	struct chmap_remap *remap;
+	enum sof_ipc_frame frame_fmt;
+	uint32_t dai_channels, multi_channels, multi_ch;
 	int container_size;
 	int j, ret;
 
@@ -424,6 +428,10 @@ int copier_dai_params(struct copier_data *cd, struct comp_dev *dev,
 		if (in_bits != in_valid_bits || out_bits != out_valid_bits)
 			cd->dd[0]->process =
 				cd->converter[IPC4_COPIER_GATEWAY_PIN];
+#if CONFIG_COPIER_GAIN
+		if (!ret && cd->gain_enabled)
+			ret = copier_dai_gain_params(cd, dev);
+#endif
 		return ret;
 	}
 
@@ -440,22 +448,64 @@ int copier_dai_params(struct copier_data *cd, struct comp_dev *dev,
 	for (j = 0; j < SOF_IPC_MAX_CHANNELS; j++)
 		cd->dd[dai_index]->dma_buffer->chmap[j] = (cd->chan_map[dai_index] >> j * 4) & 0xf;
 
-	/* set channel copy func */
+	/* compile the channel copy between the gateway and its channels of
+	 * the multi-endpoint buffer
+	 */
 	container_size = audio_stream_sample_bytes(&cd->multi_endpoint_buffer->stream);
 
 	switch (container_size) {
 	case 2:
-		cd->dd[dai_index]->process = copy_single_channel_c16;
+		frame_fmt = SOF_IPC_FRAME_S16_LE;
 		break;
 	case 4:
-		cd->dd[dai_index]->process = copy_single_channel_c32;
+		frame_fmt = SOF_IPC_FRAME_S32_LE;
 		break;
 	default:
 		comp_err(dev, "Unexpected container size: %d", container_size);
 		return -EINVAL;
 	}
 
-	return ret;
+	remap = cd->dd[dai_index]->remap;
+	if (!remap) {
+		remap = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*remap));
+		if (!remap) {
+			comp_err(dev, "failed to allocate channel remap");
+			return -ENOMEM;
+		}
+		cd->dd[dai_index]->remap = remap;
+	}
+
+	dai_channels = audio_stream_get_channels(&cd->dd[dai_index]->dma_buffer->stream);
+	multi_channels = audio_stream_get_channels(&cd->multi_endpoint_buffer->stream);
+
+	chmap_remap_reset(remap);
+	for (j = 0; j < dai_channels; j++) {
+		multi_ch = cd->dd[dai_index]->dma_buffer->chmap[j];
+		if (dev->direction == SOF_IPC_STREAM_PLAYBACK)
+			ret = chmap_remap_route(remap, multi_ch, j);
+		else
+			ret = chmap_remap_route(remap, j, multi_ch);
+		if (ret < 0) {
+			comp_err(dev, "invalid channel map %x", cd->chan_map[dai_index]);
+			return ret;
+		}
+	}
+
+	if (dev->direction == SOF_IPC_STREAM_PLAYBACK)
+		ret = chmap_remap_compile(remap, frame_fmt, frame_fmt, multi_channels,
+					  dai_channels);
+	else
+		ret = chmap_remap_compile(remap, frame_fmt, frame_fmt, dai_channels,
+					  multi_channels);
+	if (ret < 0) {
+		comp_err(dev, "failed to compile channel remap");
+		return ret;
+	}
+
+	if (dai_index == cd->endpoint_num - 1)
+		copier_dai_split_compile(cd, dev, frame_fmt);
+
+	return 0;
 }
 
 void copier_dai_reset(struct copier_data *cd, struct comp_dev *dev)
@@ -285,3 +285,39 @@ pcm_converter_func get_converter_func(const struct ipc4_audio_format *in_fmt,
 	else
 		return pcm_get_conversion_vc_function(in, in_valid, out, out_valid, type, dir);
 }
+
+pcm_converter_att_func get_converter_att_func(const struct ipc4_audio_format *in_fmt,
+					      const struct ipc4_audio_format *out_fmt)
+{
+	enum sof_ipc_frame in, in_valid, out, out_valid;
+
+	audio_stream_fmt_conversion(in_fmt->depth, in_fmt->valid_bit_depth, &in, &in_valid,
+				    in_fmt->s_type);
+	audio_stream_fmt_conversion(out_fmt->depth, out_fmt->valid_bit_depth, &out, &out_valid,
+				    out_fmt->s_type);
+
+	/* MSB aligned formats have no fused variant, attenuation is applied separately */
+	if (in_fmt->s_type == IPC4_TYPE_MSB_INTEGER || out_fmt->s_type == IPC4_TYPE_MSB_INTEGER)
+		return NULL;
+
+	return pcm_get_conversion_att_function(in, in_valid, out, out_valid);
+}
+
+#if CONFIG_COPIER_GAIN
+pcm_converter_gain_func get_converter_gain_func(struct pcm_gain *gain,
+						const struct ipc4_audio_format *in_fmt,
+						const struct ipc4_audio_format *out_fmt)
+{
+	enum sof_ipc_frame in, in_valid, out, out_valid;
+
+	audio_stream_fmt_conversion(in_fmt->depth, in_fmt->valid_bit_depth, &in, &in_valid,
+				    in_fmt->s_type);
+	audio_stream_fmt_conversion(out_fmt->depth, out_fmt->valid_bit_depth, &out, &out_valid,
+				    out_fmt->s_type);
+
+	if (in_fmt->s_type == IPC4_TYPE_MSB_INTEGER || out_fmt->s_type == IPC4_TYPE_MSB_INTEGER)
+		return NULL;
+
+	return pcm_get_conversion_gain_function(gain, in, in_valid, out, out_valid);
+}
+#endif
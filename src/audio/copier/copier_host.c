@@ -161,6 +161,17 @@ int copier_host_create(struct comp_dev *dev, struct copier_data *cd,
 		comp_err(dev, "copier: host new failed with exit");
 		goto e_data;
 	}
+
+#if CONFIG_IPC4_TIME_CORR
+	/* the position model is optional */
+	if (time_corr_get(&hd->time_corr, copier_cfg->gtw_cfg.node_id.dw & IPC4_NODE_ID_MASK) < 0)
+		comp_warn(dev, "no free time correlation slot");
+#endif
+#if CONFIG_IPC4_STREAM_POSN
+	ret = stream_posn_get(&hd->stream_posn, copier_cfg->gtw_cfg.node_id.dw & IPC4_NODE_ID_MASK);
+	if (ret < 0)
+		comp_warn(dev, "no free stream position slot");
+#endif
 #if CONFIG_HOST_DMA_STREAM_SYNCHRONIZATION
 	/* Size of a configuration without optional parameters. */
 	const uint32_t basic_size = sizeof(*copier_cfg) +
@@ -202,6 +213,14 @@ int copier_host_create(struct comp_dev *dev, struct copier_data *cd,
 		goto e_conv;
 	}
 
+	/* conversion and attenuation done in a single pass on playback, the
+	 * gain conversion carries the attenuation when the copier has a gain
+	 */
+	if (!IS_ENABLED(CONFIG_COPIER_GAIN) && cd->direction == SOF_IPC_STREAM_PLAYBACK)
+		hd->process_att = get_converter_att_func(&copier_cfg->base.audio_fmt,
+							 &copier_cfg->out_fmt);
+	hd->attenuation = cd->attenuation;
+
 	cd->endpoint_num++;
 	cd->hd = hd;
 
@@ -222,6 +241,12 @@ int copier_host_create(struct comp_dev *dev, struct copier_data *cd,
 	return 0;
 
 e_conv:
+#if CONFIG_IPC4_TIME_CORR
+	time_corr_put(&hd->time_corr);
+#endif
+#if CONFIG_IPC4_STREAM_POSN
+	stream_posn_put(&hd->stream_posn);
+#endif
 	host_common_free(hd);
 e_data:
 	rfree(hd);
@@ -234,6 +259,12 @@ void copier_host_free(struct copier_data *cd)
 #if CONFIG_HOST_DMA_STREAM_SYNCHRONIZATION
 	if (cd->hd->is_grouped)
 		delete_from_fpi_sync_group(cd->hd);
+#endif
+#if CONFIG_IPC4_TIME_CORR
+	time_corr_put(&cd->hd->time_corr);
+#endif
+#if CONFIG_IPC4_STREAM_POSN
+	stream_posn_put(&cd->hd->stream_posn);
 #endif
 	host_common_free(cd->hd);
 	rfree(cd->hd);
@@ -259,9 +290,11 @@ void copier_host_dma_cb(struct comp_dev *dev, size_t bytes)
 
 	/* Apply attenuation since copier copy missed this with host device
 	 * remove. Attenuation has to be applied in HOST Copier only with
-	 * playback scenario.
+	 * playback scenario. Nothing to do if it was already applied by the
+	 * fused conversion function.
 	 */
-	if (cd->attenuation && dev->direction == SOF_IPC_STREAM_PLAYBACK) {
+	if (cd->attenuation && dev->direction == SOF_IPC_STREAM_PLAYBACK &&
+	    !cd->hd->process_att && !cd->hd->gain) {
 		frames = bytes / audio_stream_frame_bytes(&cd->hd->dma_buffer->stream);
 
 		ret = apply_attenuation(dev, cd, cd->hd->local_buffer, frames);
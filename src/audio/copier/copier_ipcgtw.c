@@ -22,7 +22,7 @@ DECLARE_TR_CTX(ipcgtw_comp_tr, SOF_UUID(ipcgtw_comp_uuid), LOG_LEVEL_INFO);
 /* List of existing IPC gateways */
 static struct list_item ipcgtw_list_head = LIST_INIT(ipcgtw_list_head);
 
-static struct comp_dev *find_ipcgtw_by_node_id(union ipc4_connector_node_id node_id)
+static struct ipcgtw_data *find_ipcgtw_by_node_id(union ipc4_connector_node_id node_id)
 {
 	struct list_item *item;
 
@@ -30,7 +30,7 @@ static struct comp_dev *find_ipcgtw_by_node_id(union ipc4_connector_node_id node
 		struct ipcgtw_data *data = list_item(item, struct ipcgtw_data, item);
 
 		if (data->node_id.dw == node_id.dw)
-			return data->dev;
+			return data;
 	}
 
 	return NULL;
@@ -87,23 +87,232 @@ static inline struct comp_buffer *get_buffer(struct comp_dev *dev)
 	return list_first_item(&dev->bsource_list, struct comp_buffer, sink_list);
 }
 
+#if CONFIG_IPC4_GATEWAY_BULK
+/* invalidates or writes back bytes of the stream from ptr, with rollover */
+static void ipcgtw_dma_cache(struct audio_stream *stream, void *ptr, uint32_t bytes,
+			     bool invalidate)
+{
+	uint32_t head_size = MIN(bytes, (uint32_t)((char *)audio_stream_get_end_addr(stream) -
+						   (char *)ptr));
+	uint32_t tail_size = bytes - head_size;
+	void *addr = audio_stream_get_addr(stream);
+
+	if (invalidate) {
+		dcache_invalidate_region((__sparse_force void __sparse_cache *)ptr, head_size);
+		if (tail_size)
+			dcache_invalidate_region((__sparse_force void __sparse_cache *)addr,
+						 tail_size);
+	} else {
+		dcache_writeback_region((__sparse_force void __sparse_cache *)ptr, head_size);
+		if (tail_size)
+			dcache_writeback_region((__sparse_force void __sparse_cache *)addr,
+						tail_size);
+	}
+}
+
+/* (re)starts the DMA on the whole gateway buffer from its beginning */
+static int ipcgtw_dma_start(struct comp_dev *dev, struct ipcgtw_data *ipcgtw_data,
+			    struct comp_buffer *buf)
+{
+	int ret;
+
+	audio_stream_reset(&buf->stream);
+	ipcgtw_data->dma_pending = 0;
+
+	ret = dma_config(ipcgtw_data->dma->z_dev, ipcgtw_data->chan->index,
+			 &ipcgtw_data->z_config);
+	if (ret < 0) {
+		comp_err(dev, "ipcgtw_dma_start(): dma_config() failed, ret = %d", ret);
+		return ret;
+	}
+
+	ret = dma_start(ipcgtw_data->dma->z_dev, ipcgtw_data->chan->index);
+	if (ret < 0)
+		comp_err(dev, "ipcgtw_dma_start(): dma_start() failed, ret = %d", ret);
+
+	return ret;
+}
+
+static void ipcgtw_dma_detach(struct comp_dev *dev, struct ipcgtw_data *ipcgtw_data)
+{
+	if (!ipcgtw_data->chan)
+		return;
+
+	comp_info(dev, "ipcgtw_dma_detach()");
+
+	dma_stop(ipcgtw_data->dma->z_dev, ipcgtw_data->chan->index);
+	dma_release_channel(ipcgtw_data->dma->z_dev, ipcgtw_data->chan->index);
+	dma_put(ipcgtw_data->dma);
+	ipcgtw_data->chan = NULL;
+	ipcgtw_data->dma = NULL;
+}
+
+static int ipcgtw_dma_attach(struct comp_dev *dev, struct ipcgtw_data *ipcgtw_data,
+			     struct comp_buffer *buf, uint32_t stream_tag)
+{
+	struct dma_config *config = &ipcgtw_data->z_config;
+	struct dma_block_config *block = &ipcgtw_data->z_block;
+	uint32_t width = audio_stream_sample_bytes(&buf->stream);
+	uint32_t hda_chan = stream_tag - 1;
+	uint32_t dir;
+	int channel;
+	int ret;
+
+	comp_info(dev, "ipcgtw_dma_attach(): stream_tag %u", stream_tag);
+
+	if (ipcgtw_data->chan) {
+		comp_err(dev, "ipcgtw_dma_attach(): DMA already attached");
+		return -EBUSY;
+	}
+
+	if (!stream_tag)
+		return -EINVAL;
+
+	dir = dev->direction == SOF_IPC_STREAM_PLAYBACK ? DMA_DIR_HMEM_TO_LMEM :
+		DMA_DIR_LMEM_TO_HMEM;
+
+	ipcgtw_data->dma = dma_get(dir, 0, DMA_DEV_HOST, DMA_ACCESS_SHARED);
+	if (!ipcgtw_data->dma) {
+		comp_err(dev, "ipcgtw_dma_attach(): dma_get() returned NULL");
+		return -ENODEV;
+	}
+
+	channel = dma_request_channel(ipcgtw_data->dma->z_dev, &hda_chan);
+	if (channel < 0) {
+		comp_err(dev, "ipcgtw_dma_attach(): requested channel %u is busy", hda_chan);
+		dma_put(ipcgtw_data->dma);
+		ipcgtw_data->dma = NULL;
+		return -ENODEV;
+	}
+	ipcgtw_data->chan = &ipcgtw_data->dma->chan[channel];
+
+	/* the DMA runs cyclically over the whole buffer, in step with its pointers */
+	memset(config, 0, sizeof(*config));
+	memset(block, 0, sizeof(*block));
+	config->block_count = 1;
+	config->source_data_size = width ? width : sizeof(uint32_t);
+	config->dest_data_size = config->source_data_size;
+	config->head_block = block;
+	block->block_size = audio_stream_get_size(&buf->stream);
+
+	if (dir == DMA_DIR_HMEM_TO_LMEM) {
+		config->channel_direction = HOST_TO_MEMORY;
+		block->dest_address = (uintptr_t)audio_stream_get_addr(&buf->stream);
+	} else {
+		config->channel_direction = MEMORY_TO_HOST;
+		block->source_address = (uintptr_t)audio_stream_get_addr(&buf->stream);
+	}
+
+	ret = ipcgtw_dma_start(dev, ipcgtw_data, buf);
+	if (ret < 0)
+		ipcgtw_dma_detach(dev, ipcgtw_data);
+
+	return ret;
+}
+
+/* produces what the DMA has written and gives it back what was consumed */
+static int ipcgtw_dma_set_data(struct comp_dev *dev, struct ipcgtw_data *ipcgtw_data,
+			       struct comp_buffer *buf, uint32_t data_size)
+{
+	struct audio_stream *stream = &buf->stream;
+	struct dma_status stat;
+	uint32_t reload;
+	uint32_t bytes;
+	int ret;
+
+	ret = dma_get_status(ipcgtw_data->dma->z_dev, ipcgtw_data->chan->index, &stat);
+	if (ret < 0)
+		return ret;
+
+	bytes = stat.pending_length - MIN(stat.pending_length, ipcgtw_data->dma_pending);
+	bytes = MIN(bytes, data_size);
+	bytes = MIN(bytes, audio_stream_get_free_bytes(stream));
+	if (bytes) {
+		ipcgtw_dma_cache(stream, audio_stream_get_wptr(stream), bytes, true);
+		comp_update_buffer_produce(buf, bytes);
+		ipcgtw_data->dma_pending += bytes;
+	}
+
+	reload = ipcgtw_data->dma_pending -
+		MIN(audio_stream_get_avail_bytes(stream), ipcgtw_data->dma_pending);
+	if (reload) {
+		ret = dma_reload(ipcgtw_data->dma->z_dev, ipcgtw_data->chan->index, 0, 0,
+				 reload);
+		if (ret < 0)
+			return ret;
+		ipcgtw_data->dma_pending -= reload;
+	}
+
+	return bytes;
+}
+
+/* consumes what the DMA has sent and gives it the next data */
+static int ipcgtw_dma_get_data(struct comp_dev *dev, struct ipcgtw_data *ipcgtw_data,
+			       struct comp_buffer *buf, uint32_t data_size,
+			       uint32_t *size_avail)
+{
+	struct audio_stream *stream = &buf->stream;
+	uint32_t size = audio_stream_get_size(stream);
+	struct dma_status stat;
+	uint32_t bytes;
+	int ret;
+
+	ret = dma_get_status(ipcgtw_data->dma->z_dev, ipcgtw_data->chan->index, &stat);
+	if (ret < 0)
+		return ret;
+
+	/* the DMA still owns what it has not sent yet */
+	bytes = ipcgtw_data->dma_pending -
+		MIN(ipcgtw_data->dma_pending, size - MIN(size, stat.free));
+	if (bytes) {
+		comp_update_buffer_consume(buf, bytes);
+		ipcgtw_data->dma_pending -= bytes;
+	}
+
+	bytes = audio_stream_get_avail_bytes(stream) - ipcgtw_data->dma_pending;
+	bytes = MIN(bytes, data_size);
+	bytes = MIN(bytes, stat.free);
+	if (bytes) {
+		ipcgtw_dma_cache(stream, audio_stream_wrap(stream,
+							   (char *)audio_stream_get_rptr(stream) +
+							   ipcgtw_data->dma_pending),
+				 bytes, false);
+		ret = dma_reload(ipcgtw_data->dma->z_dev, ipcgtw_data->chan->index, 0, 0, bytes);
+		if (ret < 0)
+			return ret;
+		ipcgtw_data->dma_pending += bytes;
+	}
+
+	*size_avail = audio_stream_get_avail_bytes(stream) - ipcgtw_data->dma_pending;
+
+	return 0;
+}
+#endif /* CONFIG_IPC4_GATEWAY_BULK */
+
 int copier_ipcgtw_process(const struct ipc4_ipcgtw_cmd *cmd,
 			  void *reply_payload, uint32_t *reply_payload_size)
 {
 	const struct ipc4_ipc_gateway_cmd_data *in;
+	struct ipcgtw_data *ipcgtw_data;
 	struct comp_dev *dev;
 	struct comp_buffer *buf;
 	uint32_t data_size;
 	struct ipc4_ipc_gateway_cmd_data_reply *out;
+#if CONFIG_IPC4_GATEWAY_BULK
+	const struct ipc4_ipc_gateway_attach_dma *attach;
+	int ret;
+#endif
 
 	dcache_invalidate_region((__sparse_force void __sparse_cache *)MAILBOX_HOSTBOX_BASE,
 				 sizeof(struct ipc4_ipc_gateway_cmd_data));
 	in = (const struct ipc4_ipc_gateway_cmd_data *)MAILBOX_HOSTBOX_BASE;
 
-	dev = find_ipcgtw_by_node_id(in->node_id);
-	if (!dev)
+	ipcgtw_data = find_ipcgtw_by_node_id(in->node_id);
+	if (!ipcgtw_data)
 		return -ENODEV;
 
+	dev = ipcgtw_data->dev;
+
 	comp_dbg(dev, "copier_ipcgtw_process(): %x %x",
 		 cmd->primary.dat, cmd->extension.dat);
 
@@ -122,6 +331,16 @@ int copier_ipcgtw_process(const struct ipc4_ipcgtw_cmd *cmd,
 
 	switch (cmd->primary.r.cmd) {
 	case IPC4_IPCGWCMD_GET_DATA:
+#if CONFIG_IPC4_GATEWAY_BULK
+		if (buf && ipcgtw_data->chan) {
+			ret = ipcgtw_dma_get_data(dev, ipcgtw_data, buf, cmd->extension.r.data_size,
+						  &out->u.size_avail);
+			if (ret < 0)
+				return ret;
+			*reply_payload_size = 4;
+			break;
+		}
+#endif
 		if (buf) {
 			data_size = MIN(cmd->extension.r.data_size, SOF_IPC_MSG_MAX_SIZE - 4);
 			data_size = MIN(data_size, audio_stream_get_avail_bytes(&buf->stream));
@@ -137,6 +356,16 @@ int copier_ipcgtw_process(const struct ipc4_ipcgtw_cmd *cmd,
 		break;
 
 	case IPC4_IPCGWCMD_SET_DATA:
+#if CONFIG_IPC4_GATEWAY_BULK
+		if (buf && ipcgtw_data->chan) {
+			ret = ipcgtw_dma_set_data(dev, ipcgtw_data, buf, cmd->extension.r.data_size);
+			if (ret < 0)
+				return ret;
+			out->u.size_consumed = ret;
+			*reply_payload_size = 4;
+			break;
+		}
+#endif
 		if (buf) {
 			data_size = MIN(cmd->extension.r.data_size,
 					audio_stream_get_free_bytes(&buf->stream));
@@ -159,10 +388,34 @@ int copier_ipcgtw_process(const struct ipc4_ipcgtw_cmd *cmd,
 
 	case IPC4_IPCGWCMD_FLUSH_DATA:
 		*reply_payload_size = 0;
+#if CONFIG_IPC4_GATEWAY_BULK
+		if (buf && ipcgtw_data->chan) {
+			/* realign the DMA with the reset buffer */
+			dma_stop(ipcgtw_data->dma->z_dev, ipcgtw_data->chan->index);
+			return ipcgtw_dma_start(dev, ipcgtw_data, buf);
+		}
+#endif
 		if (buf)
 			audio_stream_reset(&buf->stream);
 		break;
 
+#if CONFIG_IPC4_GATEWAY_BULK
+	case IPC4_IPCGWCMD_ATTACH_DMA:
+		*reply_payload_size = 0;
+		if (!buf)
+			return -EINVAL;
+
+		dcache_invalidate_region((__sparse_force void __sparse_cache *)MAILBOX_HOSTBOX_BASE,
+					 sizeof(*attach));
+		attach = (const struct ipc4_ipc_gateway_attach_dma *)MAILBOX_HOSTBOX_BASE;
+		return ipcgtw_dma_attach(dev, ipcgtw_data, buf, attach->stream_tag);
+
+	case IPC4_IPCGWCMD_DETACH_DMA:
+		*reply_payload_size = 0;
+		ipcgtw_dma_detach(dev, ipcgtw_data);
+		break;
+#endif
+
 	default:
 		comp_err(dev, "copier_ipcgtw_process(): unexpected cmd: %u",
 			 (unsigned int)cmd->primary.r.cmd);
@@ -186,6 +439,11 @@ int copier_ipcgtw_params(struct ipcgtw_data *ipcgtw_data, struct comp_dev *dev,
 		return -EINVAL;
 	}
 
+#if CONFIG_IPC4_GATEWAY_BULK
+	/* the DMA is set up on the buffer memory which is about to change */
+	ipcgtw_dma_detach(dev, ipcgtw_data);
+#endif
+
 	/* resize buffer to size specified in IPC gateway config blob */
 	err = buffer_set_size(buf, ipcgtw_data->buf_size, 0);
 
@@ -198,7 +456,7 @@ int copier_ipcgtw_params(struct ipcgtw_data *ipcgtw_data, struct comp_dev *dev,
 	return 0;
 }
 
-void copier_ipcgtw_reset(struct comp_dev *dev)
+void copier_ipcgtw_reset(struct ipcgtw_data *ipcgtw_data, struct comp_dev *dev)
 {
 	struct comp_buffer *buf = get_buffer(dev);
 
@@ -207,6 +465,10 @@ void copier_ipcgtw_reset(struct comp_dev *dev)
 	} else {
 		comp_warn(dev, "ipcgtw_reset(): no buffer found");
 	}
+
+#if CONFIG_IPC4_GATEWAY_BULK
+	ipcgtw_dma_detach(dev, ipcgtw_data);
+#endif
 }
 
 int copier_ipcgtw_create(struct comp_dev *dev, struct copier_data *cd,
@@ -294,6 +556,9 @@ e_buf:
 
 void copier_ipcgtw_free(struct copier_data *cd)
 {
+#if CONFIG_IPC4_GATEWAY_BULK
+	ipcgtw_dma_detach(cd->ipcgtw_data->dev, cd->ipcgtw_data);
+#endif
 	list_item_del(&cd->ipcgtw_data->item);
 	rfree(cd->ipcgtw_data);
 	buffer_free(cd->endpoint_buffer[0]);
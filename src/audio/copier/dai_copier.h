@@ -17,6 +17,7 @@
 struct ipc_config_dai;
 struct comp_dev;
 struct dai_data;
+struct chmap_split;
 int dai_common_new(struct dai_data *dd, struct comp_dev *dev,
 		   const struct ipc_config_dai *dai_cfg);
 
@@ -55,7 +56,7 @@ int dai_common_get_hw_params(struct dai_data *dd, struct comp_dev *dev,
 
 int dai_zephyr_multi_endpoint_copy(struct dai_data **dd, struct comp_dev *dev,
 				   struct comp_buffer *multi_endpoint_buffer,
-				   int num_endpoints);
+				   int num_endpoints, const struct chmap_split *split);
 
 int dai_zephyr_unbind(struct dai_data *dd, struct comp_dev *dev, void *data);
 
@@ -72,6 +73,11 @@ int copier_dai_prepare(struct comp_dev *dev, struct copier_data *cd);
 int copier_dai_params(struct copier_data *cd, struct comp_dev *dev,
 		      struct sof_ipc_stream_params *params, int dai_index);
 
+#if CONFIG_COPIER_GAIN
+/* select the gain conversion of a single DAI, its buffers must be set up */
+int copier_dai_gain_params(struct copier_data *cd, struct comp_dev *dev);
+#endif
+
 void copier_dai_reset(struct copier_data *cd, struct comp_dev *dev);
 
 int copier_dai_trigger(struct copier_data *cd, struct comp_dev *dev, int cmd);
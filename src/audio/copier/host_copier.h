@@ -18,6 +18,8 @@
 #include <sof/audio/pcm_converter.h>
 #include <sof/lib/dma.h>
 #include <sof/audio/ipc-config.h>
+#include <sof/ipc/stream_posn.h>
+#include <sof/ipc/time_corr.h>
 #include <ipc/stream.h>
 #include <sof/lib/notifier.h>
 #include "copier.h"
@@ -77,6 +79,7 @@ struct host_data {
 	struct hc_buf local;
 
 	size_t partial_size;	/**< add up DMA updates for deep buffer */
+	uint32_t dma_ready_bytes;	/**< bytes known to be ready for copy in the DMA buffer */
 
 	/* pointers set during params to host or local above */
 	struct hc_buf *source;
@@ -89,6 +92,14 @@ struct host_data {
 
 	host_copy_func copy;	/**< host copy function */
 	pcm_converter_func process;	/**< processing function */
+	pcm_converter_att_func process_att;	/**< processing function with fused
+						  *  attenuation, playback only
+						  */
+	uint32_t attenuation;	/**< attenuation applied by process_att, 0 if none */
+	pcm_converter_gain_func process_gain;	/**< processing function with fused gain */
+	struct pcm_gain *gain;	/**< gain and attenuation applied by process_gain,
+				  *  NULL if none
+				  */
 
 	/* IPC host init info */
 	struct ipc_config_host ipc_host;
@@ -97,6 +108,18 @@ struct host_data {
 	struct sof_ipc_stream_posn posn; /* TODO: update this */
 	struct ipc_msg *msg;	/**< host notification */
 	uint32_t dma_buffer_size;	/* dma buffer size */
+#if CONFIG_IPC4_TIME_CORR
+	struct time_corr time_corr;	/**< processed data to wallclock model */
+#endif
+#if CONFIG_IPC4_STREAM_POSN
+	struct stream_posn stream_posn;	/**< slot of the stream positions */
+#endif
+#if CONFIG_HOST_DMA_BATCHED_SERVICE
+	struct list_item batch_list;	/**< in the host DMA batch of the core */
+	bool batched;		/**< serviced by the batch */
+	bool batch_status;	/**< dma_ready_bytes read by the batch in this tick */
+	bool batch_reload;	/**< partial_size to be reloaded by the batch */
+#endif
 #if CONFIG_HOST_DMA_STREAM_SYNCHRONIZATION
 	bool is_grouped;
 	uint8_t group_id;
@@ -15,6 +15,7 @@
 #define __SOF_IPCGTW_COPIER_H__
 
 #include <sof/audio/component_ext.h>
+#include <sof/lib/dma.h>
 #include <ipc4/gateway.h>
 #include <sof/list.h>
 #include <ipc/stream.h>
@@ -33,6 +34,19 @@ struct ipcgtw_data {
 	 * to resize buffer later at ipcgtw_params().
 	 */
 	uint32_t buf_size;
+
+#if CONFIG_IPC4_GATEWAY_BULK
+	/* host DMA moving the data when the host attached its stream buffer */
+	struct dma *dma;
+	struct dma_chan_data *chan;
+	struct dma_config z_config;
+	struct dma_block_config z_block;
+
+	/* playback: bytes produced in the buffer but not given back to the DMA,
+	 * capture: bytes given to the DMA but not consumed from the buffer
+	 */
+	uint32_t dma_pending;
+#endif
 };
 
 /**< IPC header format for IPC gateway messages */
@@ -69,7 +83,9 @@ struct ipc4_ipcgtw_cmd {
 enum {
 	IPC4_IPCGWCMD_GET_DATA = 1,
 	IPC4_IPCGWCMD_SET_DATA = 2,
-	IPC4_IPCGWCMD_FLUSH_DATA = 3
+	IPC4_IPCGWCMD_FLUSH_DATA = 3,
+	IPC4_IPCGWCMD_ATTACH_DMA = 4,
+	IPC4_IPCGWCMD_DETACH_DMA = 5
 };
 
 /* Incoming IPC gateway message */
@@ -80,6 +96,18 @@ struct ipc4_ipc_gateway_cmd_data {
 	uint8_t payload[];
 } __packed __aligned(4);
 
+/* Payload of IPC4_IPCGWCMD_ATTACH_DMA. The host has set up the HD-A stream on
+ * its buffer pages. Until IPC4_IPCGWCMD_DETACH_DMA, GET_DATA and SET_DATA move
+ * the data with the stream DMA, data_size then limits the size of the transfer
+ * and the messages carry no payload.
+ */
+struct ipc4_ipc_gateway_attach_dma {
+	/* node_id of the target gateway */
+	union ipc4_connector_node_id node_id;
+	/* HD-A stream tag of the host buffer */
+	uint32_t stream_tag;
+} __packed __aligned(4);
+
 /* Reply to IPC gateway message */
 struct ipc4_ipc_gateway_cmd_data_reply {
 	union {
@@ -98,7 +126,7 @@ int copier_ipcgtw_process(const struct ipc4_ipcgtw_cmd *cmd,
 int copier_ipcgtw_params(struct ipcgtw_data *ipcgtw_data, struct comp_dev *dev,
 			 struct sof_ipc_stream_params *params);
 
-void copier_ipcgtw_reset(struct comp_dev *dev);
+void copier_ipcgtw_reset(struct ipcgtw_data *ipcgtw_data, struct comp_dev *dev);
 
 int copier_ipcgtw_create(struct comp_dev *dev, struct copier_data *cd,
 			 const struct ipc4_copier_module_cfg *copier, struct pipeline *pipeline);
@@ -45,18 +45,14 @@ DECLARE_SOF_RT_UUID("crossover", crossover_uuid, 0x948c9ad1, 0x806a, 0x4131,
 
 DECLARE_TR_CTX(crossover_tr, SOF_UUID(crossover_uuid), LOG_LEVEL_INFO);
 
-static inline void crossover_free_config(struct sof_crossover_config **config)
-{
-	rfree(*config);
-	*config = NULL;
-}
-
 /**
  * \brief Reset the state of an LR4 filter.
  */
-static inline void crossover_reset_state_lr4(struct iir_state_df2t *lr4)
+static inline void crossover_reset_state_lr4(struct iir_state_df2t *lr4,
+					     bool coef_in_place)
 {
-	rfree(lr4->coef);
+	if (!coef_in_place)
+		rfree(lr4->coef);
 	rfree(lr4->delay);
 
 	lr4->coef = NULL;
@@ -72,9 +68,11 @@ inline void crossover_reset_state_ch(struct crossover_state *ch_state)
 	int i;
 
 	for (i = 0; i < CROSSOVER_MAX_LR4; i++) {
-		crossover_reset_state_lr4(&ch_state->lowpass[i]);
-		crossover_reset_state_lr4(&ch_state->highpass[i]);
+		crossover_reset_state_lr4(&ch_state->lowpass[i], ch_state->coef_in_place);
+		crossover_reset_state_lr4(&ch_state->highpass[i], ch_state->coef_in_place);
 	}
+
+	ch_state->coef_in_place = false;
 }
 
 /**
@@ -195,31 +193,37 @@ static int crossover_assign_sinks(struct processing_module *mod,
  * \param coef struct containing the coefficients of a butterworth
  *	       high/low pass filter.
  * \param[out] lr4 initialized struct
+ * \param in_place coef already holds both biquads of the LR4.
  */
 static int crossover_init_coef_lr4(struct sof_eq_iir_biquad *coef,
-				   struct iir_state_df2t *lr4)
+				   struct iir_state_df2t *lr4, bool in_place)
 {
 	int ret;
 
-	/* Only one set of coefficients is stored in config for both biquads
-	 * in series due to identity. To maintain the structure of
-	 * iir_state_df2t, it requires two copies of coefficients in a row.
-	 */
-	lr4->coef = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
-			    sizeof(struct sof_eq_iir_biquad) * 2);
-	if (!lr4->coef)
-		return -ENOMEM;
-
-	/* coefficients of the first biquad */
-	ret = memcpy_s(lr4->coef, sizeof(struct sof_eq_iir_biquad),
-		       coef, sizeof(struct sof_eq_iir_biquad));
-	assert(!ret);
-
-	/* coefficients of the second biquad */
-	ret = memcpy_s(lr4->coef + SOF_EQ_IIR_NBIQUAD,
-		       sizeof(struct sof_eq_iir_biquad),
-		       coef, sizeof(struct sof_eq_iir_biquad));
-	assert(!ret);
+	if (in_place) {
+		lr4->coef = ASSUME_ALIGNED((void *)coef, 4);
+	} else {
+		/* Only one set of coefficients is stored in config for both
+		 * biquads in series due to identity. To maintain the structure
+		 * of iir_state_df2t, it requires two copies of coefficients in
+		 * a row.
+		 */
+		lr4->coef = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+				    sizeof(struct sof_eq_iir_biquad) * 2);
+		if (!lr4->coef)
+			return -ENOMEM;
+
+		/* coefficients of the first biquad */
+		ret = memcpy_s(lr4->coef, sizeof(struct sof_eq_iir_biquad),
+			       coef, sizeof(struct sof_eq_iir_biquad));
+		assert(!ret);
+
+		/* coefficients of the second biquad */
+		ret = memcpy_s(lr4->coef + SOF_EQ_IIR_NBIQUAD,
+			       sizeof(struct sof_eq_iir_biquad),
+			       coef, sizeof(struct sof_eq_iir_biquad));
+		assert(!ret);
+	}
 
 	/* LR4 filters are two 2nd order filters, so only need 4 delay slots
 	 * delay[0..1] -> state for first biquad
@@ -241,25 +245,31 @@ static int crossover_init_coef_lr4(struct sof_eq_iir_biquad *coef,
  */
 int crossover_init_coef_ch(struct sof_eq_iir_biquad *coef,
 			   struct crossover_state *ch_state,
-			   int32_t num_sinks)
+			   int32_t num_sinks, uint32_t layout)
 {
 	int32_t i;
 	int32_t j = 0;
 	int32_t num_lr4s = num_sinks == CROSSOVER_2WAY_NUM_SINKS ? 1 : 3;
+	/* biquads of one LR4 in coef[] */
+	int32_t n = layout == SOF_CROSSOVER_LAYOUT_LR4 ? 2 : 1;
 	int err;
 
+	ch_state->coef_in_place = layout == SOF_CROSSOVER_LAYOUT_LR4;
+
 	for (i = 0; i < num_lr4s; i++) {
 		/* Get the low pass coefficients */
 		err = crossover_init_coef_lr4(&coef[j],
-					      &ch_state->lowpass[i]);
+					      &ch_state->lowpass[i],
+					      ch_state->coef_in_place);
 		if (err < 0)
 			return -EINVAL;
 		/* Get the high pass coefficients */
-		err = crossover_init_coef_lr4(&coef[j + 1],
-					      &ch_state->highpass[i]);
+		err = crossover_init_coef_lr4(&coef[j + n],
+					      &ch_state->highpass[i],
+					      ch_state->coef_in_place);
 		if (err < 0)
 			return -EINVAL;
-		j += 2;
+		j += 2 * n;
 	}
 
 	return 0;
@@ -296,7 +306,7 @@ static int crossover_init_coef(struct processing_module *mod, int nch)
 	crossover = config->coef;
 	for (ch = 0; ch < nch; ch++) {
 		err = crossover_init_coef_ch(crossover, &cd->state[ch],
-					     config->num_sinks);
+					     config->num_sinks, config->layout);
 		/* Free all previously allocated blocks in case of an error */
 		if (err < 0) {
 			comp_err(mod->dev, "crossover_init_coef(), could not assign coefficients to ch %d",
@@ -398,6 +408,9 @@ static int crossover_init(struct processing_module *mod)
 		goto cd_fail;
 	}
 
+	/* identical configurations of other instances use the same blob */
+	comp_data_blob_set_shared(cd->model_handler);
+
 	/* Get configuration data and reset Crossover state */
 	ret = comp_init_data_blob(cd->model_handler, bs, ipc_crossover->data);
 	if (ret < 0) {
@@ -526,6 +539,7 @@ static int crossover_validate_config(struct processing_module *mod,
 	struct comp_dev *dev = mod->dev;
 	uint32_t size = config->size;
 	int32_t num_assigned_sinks;
+	int32_t num_biquads;
 
 	if (size > SOF_CROSSOVER_MAX_SIZE || !size) {
 		comp_err(dev, "crossover_validate_config(), size %d is invalid", size);
@@ -539,6 +553,23 @@ static int crossover_validate_config(struct processing_module *mod,
 		return -EINVAL;
 	}
 
+	if (config->layout > SOF_CROSSOVER_LAYOUT_LR4) {
+		comp_err(dev, "crossover_validate_config(), unknown layout %u",
+			 config->layout);
+		return -EINVAL;
+	}
+
+	/* A low and a high pass LR4 for 2 way, three of them otherwise */
+	num_biquads = config->num_sinks == CROSSOVER_2WAY_NUM_SINKS ? 2 : 6;
+	if (config->layout == SOF_CROSSOVER_LAYOUT_LR4)
+		num_biquads *= 2;
+
+	if (size < sizeof(*config) + num_biquads * sizeof(struct sof_eq_iir_biquad)) {
+		comp_err(dev, "crossover_validate_config(), size %d too small for %d biquads",
+			 size, num_biquads);
+		return -EINVAL;
+	}
+
 	/* Align the crossover's sinks, to their respective configuration in
 	 * the config.
 	 */
@@ -602,6 +633,60 @@ static int crossover_get_config(struct processing_module *mod,
 	return comp_data_blob_get_cmd(cd->model_handler, cdata, fragment_size);
 }
 
+/* Outputs fed by lowpass[] and highpass[] of 2, 3 and 4 way crossovers */
+static const uint8_t crossover_lp_outputs[][CROSSOVER_MAX_LR4] = {
+	{ 0x1, 0x0, 0x0 },
+	{ 0x1, 0x1, 0x2 },
+	{ 0x1, 0x3, 0x4 },
+};
+
+static const uint8_t crossover_hp_outputs[][CROSSOVER_MAX_LR4] = {
+	{ 0x2, 0x0, 0x0 },
+	{ 0x6, 0x1, 0x4 },
+	{ 0x2, 0xc, 0x8 },
+};
+
+static void crossover_clear_lr4(struct crossover_state *state, int nch, int i, bool lowpass)
+{
+	struct iir_state_df2t *lr4;
+	int ch;
+
+	for (ch = 0; ch < nch; ch++) {
+		lr4 = lowpass ? &state[ch].lowpass[i] : &state[ch].highpass[i];
+		if (lr4->delay)
+			memset(lr4->delay, 0, sizeof(uint64_t) * CROSSOVER_NUM_DELAYS_LR4);
+	}
+}
+
+/**
+ * \brief Updates the outputs to compute.
+ *
+ * The split functions skip the LR4 filters feeding only inactive sinks, e.g.
+ * of a paused pipeline. A skipped filter holds stale history when one of its
+ * outputs becomes active again, so it restarts from silence.
+ */
+static void crossover_set_active(struct comp_data *cd, int nch, uint32_t num_sinks,
+				 uint32_t active)
+{
+	uint32_t resumed = active & ~cd->active_sinks;
+	const uint8_t *lp, *hp;
+	int i;
+
+	if (resumed && cd->config && num_sinks >= CROSSOVER_2WAY_NUM_SINKS &&
+	    num_sinks <= CROSSOVER_4WAY_NUM_SINKS) {
+		lp = crossover_lp_outputs[num_sinks - CROSSOVER_2WAY_NUM_SINKS];
+		hp = crossover_hp_outputs[num_sinks - CROSSOVER_2WAY_NUM_SINKS];
+		for (i = 0; i < CROSSOVER_MAX_LR4; i++) {
+			if ((lp[i] & resumed) && !(lp[i] & cd->active_sinks))
+				crossover_clear_lr4(cd->state, nch, i, true);
+			if ((hp[i] & resumed) && !(hp[i] & cd->active_sinks))
+				crossover_clear_lr4(cd->state, nch, i, false);
+		}
+	}
+
+	cd->active_sinks = active;
+}
+
 /**
  * \brief Copies and processes stream data.
  * \param[in,out] dev Crossover Filter base component device.
@@ -627,6 +712,7 @@ static int crossover_process_audio_stream(struct processing_module *mod,
 	uint32_t frames = input_buffers[0].size;
 	uint32_t frame_bytes = audio_stream_frame_bytes(input_buffers[0].data);
 	uint32_t processed_bytes;
+	uint32_t active;
 	int ret;
 	int i;
 
@@ -666,6 +752,12 @@ static int crossover_process_audio_stream(struct processing_module *mod,
 	if (!frames)
 		return -ENODATA;
 
+	active = 0;
+	for (i = 0; i < num_sinks; i++)
+		if (assigned_obufs[i])
+			active |= BIT(i);
+	crossover_set_active(cd, audio_stream_get_channels(source), num_sinks, active);
+
 	cd->crossover_process(cd, input_buffers, assigned_obufs, num_sinks, frames);
 
 	processed_bytes = frames * frame_bytes;
@@ -757,9 +849,9 @@ static int crossover_prepare(struct processing_module *mod,
 
 	/* Initialize Crossover */
 	if (cd->config && crossover_validate_config(mod, cd->config) < 0) {
-		/* If config is invalid then delete it */
+		/* If config is invalid then ignore it, the blob is owned by model_handler */
 		comp_err(dev, "crossover_prepare(), invalid binary config format");
-		crossover_free_config(&cd->config);
+		cd->config = NULL;
 	}
 
 	if (cd->config) {
@@ -12,22 +12,7 @@
 #include <sof/math/iir_df2t.h>
 #include <stdint.h>
 
-/*
- * \brief Splits x into two based on the coefficients set in the lp
- *        and hp filters. The output of the lp is in y1, the output of
- *        the hp is in y2.
- *
- * As a side effect, this function mutates the delay values of both
- * filters.
- */
-static inline void crossover_generic_lr4_split(struct iir_state_df2t *lp,
-					       struct iir_state_df2t *hp,
-					       int32_t x, int32_t *y1,
-					       int32_t *y2)
-{
-	*y1 = crossover_generic_process_lr4(x, lp);
-	*y2 = crossover_generic_process_lr4(x, hp);
-}
+#if CROSSOVER_GENERIC
 
 /*
  * \brief Splits input signal into two and merges it back to it's
@@ -49,43 +34,79 @@ static inline void crossover_generic_lr4_merge(struct iir_state_df2t *lp,
 	*y = sat_int32(((int64_t)z1) + z2);
 }
 
+/*
+ * The split functions run only the LR4 filters with an active output in
+ * their subtree. As a side effect, they mutate the delay values of those
+ * filters.
+ */
 static void crossover_generic_split_2way(int32_t in,
 					 int32_t out[],
-					 struct crossover_state *state)
+					 struct crossover_state *state,
+					 uint32_t active)
 {
-	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
-				    in, &out[0], &out[1]);
+	if (active & 0x1)
+		out[0] = crossover_generic_process_lr4(in, &state->lowpass[0]);
+	if (active & 0x2)
+		out[1] = crossover_generic_process_lr4(in, &state->highpass[0]);
 }
 
 static void crossover_generic_split_3way(int32_t in,
 					 int32_t out[],
-					 struct crossover_state *state)
+					 struct crossover_state *state,
+					 uint32_t active)
 {
-	int32_t z1, z2;
+	int32_t z;
+
+	if (active & 0x1) {
+		z = crossover_generic_process_lr4(in, &state->lowpass[0]);
+		/* Realign the phase of z */
+		crossover_generic_lr4_merge(&state->lowpass[1], &state->highpass[1],
+					    z, &out[0]);
+	}
 
-	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
-				    in, &z1, &z2);
-	/* Realign the phase of z1 */
-	crossover_generic_lr4_merge(&state->lowpass[1], &state->highpass[1],
-				    z1, &out[0]);
-	crossover_generic_lr4_split(&state->lowpass[2], &state->highpass[2],
-				    z2, &out[1], &out[2]);
+	if (active & 0x6) {
+		z = crossover_generic_process_lr4(in, &state->highpass[0]);
+		if (active & 0x2)
+			out[1] = crossover_generic_process_lr4(z, &state->lowpass[2]);
+		if (active & 0x4)
+			out[2] = crossover_generic_process_lr4(z, &state->highpass[2]);
+	}
 }
 
 static void crossover_generic_split_4way(int32_t in,
 					 int32_t out[],
-					 struct crossover_state *state)
+					 struct crossover_state *state,
+					 uint32_t active)
 {
-	int32_t z1, z2;
+	int32_t z;
+
+	if (active & 0x3) {
+		z = crossover_generic_process_lr4(in, &state->lowpass[1]);
+		if (active & 0x1)
+			out[0] = crossover_generic_process_lr4(z, &state->lowpass[0]);
+		if (active & 0x2)
+			out[1] = crossover_generic_process_lr4(z, &state->highpass[0]);
+	}
 
-	crossover_generic_lr4_split(&state->lowpass[1], &state->highpass[1],
-				    in, &z1, &z2);
-	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
-				    z1, &out[0], &out[1]);
-	crossover_generic_lr4_split(&state->lowpass[2], &state->highpass[2],
-				    z2, &out[2], &out[3]);
+	if (active & 0xc) {
+		z = crossover_generic_process_lr4(in, &state->highpass[1]);
+		if (active & 0x4)
+			out[2] = crossover_generic_process_lr4(z, &state->lowpass[2]);
+		if (active & 0x8)
+			out[3] = crossover_generic_process_lr4(z, &state->highpass[2]);
+	}
 }
 
+const crossover_split crossover_split_fnmap[] = {
+	crossover_generic_split_2way,
+	crossover_generic_split_3way,
+	crossover_generic_split_4way,
+};
+
+const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
+
+#endif /* CROSSOVER_GENERIC */
+
 #if CONFIG_FORMAT_S16LE
 static void crossover_s16_default_pass(struct comp_data *cd,
 				       struct input_stream_buffer *bsource,
@@ -162,7 +183,7 @@ static void crossover_s16_default(struct comp_data *cd,
 		state = &cd->state[ch];
 		for (i = 0; i < frames; i++) {
 			x = audio_stream_read_frag_s16(source_stream, idx);
-			cd->crossover_split(*x << 16, out, state);
+			cd->crossover_split(*x << 16, out, state, cd->active_sinks);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!bsinks[j])
@@ -200,7 +221,7 @@ static void crossover_s24_default(struct comp_data *cd,
 		state = &cd->state[ch];
 		for (i = 0; i < frames; i++) {
 			x = audio_stream_read_frag_s32(source_stream, idx);
-			cd->crossover_split(*x << 8, out, state);
+			cd->crossover_split(*x << 8, out, state, cd->active_sinks);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!bsinks[j])
@@ -238,7 +259,7 @@ static void crossover_s32_default(struct comp_data *cd,
 		state = &cd->state[ch];
 		for (i = 0; i < frames; i++) {
 			x = audio_stream_read_frag_s32(source_stream, idx);
-			cd->crossover_split(*x, out, state);
+			cd->crossover_split(*x, out, state, cd->active_sinks);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!bsinks[j])
@@ -286,11 +307,3 @@ const struct crossover_proc_fnmap crossover_proc_fnmap_pass[] = {
 };
 
 const size_t crossover_proc_fncount = ARRAY_SIZE(crossover_proc_fnmap);
-
-const crossover_split crossover_split_fnmap[] = {
-	crossover_generic_split_2way,
-	crossover_generic_split_3way,
-	crossover_generic_split_4way,
-};
-
-const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <ipc/stream.h>
+#include <sof/audio/module_adapter/module/module_interface.h>
+#include <sof/audio/component.h>
+#include <sof/audio/crossover/crossover.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/iir_df2t.h>
+#include <user/eq.h>
+#include <stdint.h>
+
+#if CROSSOVER_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/*
+ * \brief Runs the lowpass and highpass LR4 filters of a split in lockstep.
+ *
+ * The lowpass filter is in the H and the highpass filter in the L half of
+ * the registers. The computation per lane is the same as in iir_df2t() for
+ * HiFi3, see iir_df2t_hifi3.c for the delay line alignment.
+ *
+ * \param lp Lowpass LR4 filter state.
+ * \param hp Highpass LR4 filter state, same number of biquads as lp.
+ * \param in Input of the lowpass filter in H and of the highpass in L.
+ * \return Output of the lowpass filter in H and of the highpass in L.
+ */
+static inline ae_f32x2 crossover_hifi3_lr4_pair(struct iir_state_df2t *lp,
+						struct iir_state_df2t *hp,
+						ae_f32x2 in)
+{
+	ae_f64 acc_h;
+	ae_f64 acc_l;
+	ae_f32x2 a2;
+	ae_f32x2 a1;
+	ae_f32x2 b2;
+	ae_f32x2 b1;
+	ae_f32x2 b0;
+	ae_f32x2 gain;
+	ae_f32x2 tmp;
+	int32_t *lpc = lp->coef;
+	int32_t *hpc = hp->coef;
+	ae_f64 *lpd = (ae_f64 *)lp->delay;
+	ae_f64 *hpd = (ae_f64 *)hp->delay;
+	int i;
+
+	for (i = 0; i < lp->biquads; i++) {
+		/* Coefficients order is {a2, a1, b2, b1, b0, shift, gain} */
+		a2 = AE_MOVDA32X2(lpc[0], hpc[0]);
+		a1 = AE_MOVDA32X2(lpc[1], hpc[1]);
+		b2 = AE_MOVDA32X2(lpc[2], hpc[2]);
+		b1 = AE_MOVDA32X2(lpc[3], hpc[3]);
+		b0 = AE_MOVDA32X2(lpc[4], hpc[4]);
+		gain = AE_MOVDA32X2(lpc[6], hpc[6]);
+
+		/* Compute output with delay d0 converted to Q18.46 */
+		acc_h = AE_SRAI64(lpd[0], 1);
+		acc_l = AE_SRAI64(hpd[0], 1);
+		AE_MULAF32R_HH(acc_h, b0, in); /* Coef b0 */
+		AE_MULAF32R_LL(acc_l, b0, in);
+		acc_h = AE_SLAI64S(acc_h, 1); /* Convert to Q17.47 */
+		acc_l = AE_SLAI64S(acc_l, 1);
+		tmp = AE_ROUND32X2F48SSYM(acc_h, acc_l); /* Round to Q1.31 */
+
+		/* Compute 1st delay d0 */
+		acc_h = AE_SRAI64(lpd[1], 1); /* Convert d1 to Q18.46 */
+		acc_l = AE_SRAI64(hpd[1], 1);
+		AE_MULAF32R_HH(acc_h, b1, in); /* Coef b1 */
+		AE_MULAF32R_LL(acc_l, b1, in);
+		AE_MULAF32R_HH(acc_h, a1, tmp); /* Coef a1 */
+		AE_MULAF32R_LL(acc_l, a1, tmp);
+		lpd[0] = AE_SLAI64S(acc_h, 1); /* Store d0 as Q17.47 */
+		hpd[0] = AE_SLAI64S(acc_l, 1);
+
+		/* Compute delay d1 */
+		acc_h = AE_MULF32R_HH(b2, in); /* Coef b2 */
+		acc_l = AE_MULF32R_LL(b2, in);
+		AE_MULAF32R_HH(acc_h, a2, tmp); /* Coef a2 */
+		AE_MULAF32R_LL(acc_l, a2, tmp);
+		lpd[1] = AE_SLAI64S(acc_h, 1); /* Store d1 as Q17.47 */
+		hpd[1] = AE_SLAI64S(acc_l, 1);
+
+		/* Apply gain Q18.14 x Q1.31 -> Q34.30 */
+		acc_h = AE_MULF32R_HH(gain, tmp);
+		acc_l = AE_MULF32R_LL(gain, tmp);
+		acc_h = AE_SLAI64S(acc_h, 17); /* Convert to Q17.47 */
+		acc_l = AE_SLAI64S(acc_l, 17);
+
+		/* Apply biquad output shift right parameter and then round
+		 * and saturate to 32 bits Q1.31.
+		 */
+		acc_h = AE_SRAA64(acc_h, lpc[5]);
+		acc_l = AE_SRAA64(acc_l, hpc[5]);
+		in = AE_ROUND32X2F48SSYM(acc_h, acc_l);
+
+		/* Proceed to next biquad coefficients and delay lines */
+		lpc += SOF_EQ_IIR_NBIQUAD;
+		hpc += SOF_EQ_IIR_NBIQUAD;
+		lpd += IIR_DF2T_NUM_DELAYS;
+		hpd += IIR_DF2T_NUM_DELAYS;
+	}
+
+	return in;
+}
+
+/*
+ * \brief Splits x into two based on the coefficients set in the lp
+ *        and hp filters. The output of the lp is in H, the output of
+ *        the hp is in L.
+ */
+static inline ae_f32x2 crossover_hifi3_lr4_split(struct iir_state_df2t *lp,
+						 struct iir_state_df2t *hp,
+						 int32_t x)
+{
+	return crossover_hifi3_lr4_pair(lp, hp, AE_MOVDA32(x));
+}
+
+/*
+ * \brief Splits input signal into two and merges it back to it's
+ *        original form, see crossover_generic.c.
+ */
+static inline int32_t crossover_hifi3_lr4_merge(struct iir_state_df2t *lp,
+						struct iir_state_df2t *hp,
+						int32_t x)
+{
+	ae_f32x2 z = crossover_hifi3_lr4_pair(lp, hp, AE_MOVDA32(x));
+
+	/* Sum of lowpass and highpass outputs is in both halves */
+	z = AE_ADD32S(z, AE_SEL32_LH(z, z));
+	return AE_MOVAD32_H(z);
+}
+
+/*
+ * The lowpass and highpass filters of a pair run in lockstep, a pair is
+ * skipped when none of the outputs in its subtree is active.
+ */
+static void crossover_hifi3_split_2way(int32_t in,
+				       int32_t out[],
+				       struct crossover_state *state,
+				       uint32_t active)
+{
+	ae_f32x2 z;
+
+	z = crossover_hifi3_lr4_split(&state->lowpass[0], &state->highpass[0], in);
+	out[0] = AE_MOVAD32_H(z);
+	out[1] = AE_MOVAD32_L(z);
+}
+
+static void crossover_hifi3_split_3way(int32_t in,
+				       int32_t out[],
+				       struct crossover_state *state,
+				       uint32_t active)
+{
+	ae_f32x2 z;
+
+	z = crossover_hifi3_lr4_split(&state->lowpass[0], &state->highpass[0], in);
+
+	/* Realign the phase of the lowpass output */
+	if (active & 0x1)
+		out[0] = crossover_hifi3_lr4_merge(&state->lowpass[1], &state->highpass[1],
+						   AE_MOVAD32_H(z));
+	if (active & 0x6) {
+		z = crossover_hifi3_lr4_split(&state->lowpass[2], &state->highpass[2],
+					      AE_MOVAD32_L(z));
+		out[1] = AE_MOVAD32_H(z);
+		out[2] = AE_MOVAD32_L(z);
+	}
+}
+
+static void crossover_hifi3_split_4way(int32_t in,
+				       int32_t out[],
+				       struct crossover_state *state,
+				       uint32_t active)
+{
+	ae_f32x2 z;
+	ae_f32x2 y;
+
+	z = crossover_hifi3_lr4_split(&state->lowpass[1], &state->highpass[1], in);
+	if (active & 0x3) {
+		y = crossover_hifi3_lr4_split(&state->lowpass[0], &state->highpass[0],
+					      AE_MOVAD32_H(z));
+		out[0] = AE_MOVAD32_H(y);
+		out[1] = AE_MOVAD32_L(y);
+	}
+	if (active & 0xc) {
+		y = crossover_hifi3_lr4_split(&state->lowpass[2], &state->highpass[2],
+					      AE_MOVAD32_L(z));
+		out[2] = AE_MOVAD32_H(y);
+		out[3] = AE_MOVAD32_L(y);
+	}
+}
+
+const crossover_split crossover_split_fnmap[] = {
+	crossover_hifi3_split_2way,
+	crossover_hifi3_split_3way,
+	crossover_hifi3_split_4way,
+};
+
+const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
+
+#endif /* CROSSOVER_HIFI3 */
@@ -122,7 +122,14 @@ static void dai_dma_cb(void *arg, enum notify_id type, void *data)
 		return;
 	}
 
-	if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
+	if (dd->gain && !dd->gain->unity) {
+		if (dev->direction == SOF_IPC_STREAM_PLAYBACK)
+			ret = dma_buffer_copy_to_gain(dd->local_buffer, dd->dma_buffer,
+						      dd->process_gain, bytes, dd->gain);
+		else
+			ret = dma_buffer_copy_from_gain(dd->dma_buffer, dd->local_buffer,
+							dd->process_gain, bytes, dd->gain);
+	} else if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
 		ret = dma_buffer_copy_to(dd->local_buffer, dd->dma_buffer,
 					 dd->process, bytes);
 	} else {
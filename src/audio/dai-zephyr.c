@@ -6,10 +6,12 @@
 //         Keyon Jie <yang.jie@linux.intel.com>
 
 #include <sof/audio/buffer.h>
+#include <sof/audio/channel_map.h>
 #include <sof/audio/component_ext.h>
 #include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
 #include <sof/common.h>
+#include <sof/debug/telemetry/tracepoint.h>
 #include <rtos/panic.h>
 #include <sof/ipc/msg.h>
 #include <rtos/interrupt.h>
@@ -31,6 +33,9 @@
 #include <ipc/stream.h>
 #include <ipc/topology.h>
 #include <user/trace.h>
+#if CONFIG_XRUN_NOTIFICATIONS_BATCH
+#include <ipc4/notification.h>
+#endif
 #include <errno.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -61,9 +66,33 @@ static void dai_atomic_trigger(void *arg, enum notify_id type, void *data)
 	struct dai_data *dd = comp_get_drvdata(dev);
 	struct dai_group *group = dd->group;
 
+	int ret;
+
 	/* Atomic context set by the last DAI to receive trigger command */
-	group->trigger_ret = dai_comp_trigger_internal(dd, dev, group->trigger_cmd);
+	ret = dai_comp_trigger_internal(dd, dev, group->trigger_cmd);
+	if (ret)
+		group->trigger_ret = ret;
+}
+
+#if CONFIG_COMP_DAI_GROUP_HW_SYNC
+/* arm the hardware release of the group, NULL to trigger the DAIs one by one */
+static const struct dai_group_sync_ops *dai_group_sync_arm(struct dai_group *group, int cmd)
+{
+	const struct dai_group_sync_ops *ops = dai_group_sync_get();
+
+	if (!ops)
+		return NULL;
+
+	/* only the start is released by the hardware, DMAs are started by the walk */
+	if (cmd != COMP_TRIGGER_START && cmd != COMP_TRIGGER_RELEASE)
+		return NULL;
+
+	if (ops->arm(group, cmd) < 0)
+		return NULL;
+
+	return ops;
 }
+#endif
 
 /* Assign DAI to a group */
 int dai_assign_group(struct dai_data *dd, struct comp_dev *dev, uint32_t group_id)
@@ -252,21 +281,47 @@ dai_dma_cb(struct dai_data *dd, struct comp_dev *dev, uint32_t bytes,
 	}
 
 	if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
-		ret = dma_buffer_copy_to(dd->local_buffer, dd->dma_buffer,
-					 dd->process, bytes);
+		if (dd->gain && !dd->gain->unity)
+			ret = dma_buffer_copy_to_gain(dd->local_buffer, dd->dma_buffer,
+						      dd->process_gain, bytes, dd->gain);
+		else
+			ret = dma_buffer_copy_to(dd->local_buffer, dd->dma_buffer,
+						 dd->process, bytes);
 	} else {
+		bool gain = dd->gain && !dd->gain->unity;
 		struct list_item *sink_list;
+#if CONFIG_IPC_MAJOR_4
+		struct copier_fanout fo = { .count = 0 };
+		struct audio_stream *local = &dd->local_buffer->stream;
+		void *wptr = audio_stream_get_wptr(local);
+#endif
 
 		audio_stream_invalidate(&dd->dma_buffer->stream, bytes);
 		/*
 		 * The PCM converter functions used during DMA buffer copy can never fail,
 		 * so no need to check the return value of dma_buffer_copy_from_no_consume().
 		 */
-		ret = dma_buffer_copy_from_no_consume(dd->dma_buffer, dd->local_buffer,
-						      dd->process, bytes);
+		if (gain)
+			ret = dma_buffer_copy_from_gain_no_consume(dd->dma_buffer, dd->local_buffer,
+								   dd->process_gain, bytes,
+								   dd->gain);
+		else
+			ret = dma_buffer_copy_from_no_consume(dd->dma_buffer, dd->local_buffer,
+							      dd->process, bytes);
 #if CONFIG_IPC_MAJOR_4
 		/* Skip in case of endpoint DAI devices created by the copier */
 		if (converter) {
+			uint32_t sink_bytes;
+
+			/* sinks of the same converter and format as the local
+			 * buffer get its data copied instead of converted again,
+			 * the gain only applies to the local buffer
+			 */
+			sink_bytes = bytes / audio_stream_sample_bytes(&dd->dma_buffer->stream) *
+				audio_stream_sample_bytes(local);
+			if (!gain)
+				copier_fanout_add(&fo, dd->process, local, wptr, sink_bytes);
+
 			/*
 			 * copy from DMA buffer to all sink buffers using the right PCM converter
 			 * function
@@ -299,10 +354,25 @@ dai_dma_cb(struct dai_data *dd, struct comp_dev *dev, uint32_t bytes,
 					continue;
 				}
 
-				if (sink_dev && sink_dev->state == COMP_STATE_ACTIVE)
-					ret = dma_buffer_copy_from_no_consume(dd->dma_buffer,
-									      sink, converter[j],
-									      bytes);
+				if (!sink_dev || sink_dev->state != COMP_STATE_ACTIVE)
+					continue;
+
+				sink_bytes = bytes /
+					audio_stream_sample_bytes(&dd->dma_buffer->stream) *
+					audio_stream_sample_bytes(&sink->stream);
+				if (copier_fanout_copy(&fo, converter[j], &sink->stream,
+						       sink_bytes)) {
+					buffer_stream_writeback(sink, sink_bytes);
+					comp_update_buffer_produce(sink, sink_bytes);
+					continue;
+				}
+
+				wptr = audio_stream_get_wptr(&sink->stream);
+				ret = dma_buffer_copy_from_no_consume(dd->dma_buffer,
+								      sink, converter[j],
+								      bytes);
+				copier_fanout_add(&fo, converter[j], &sink->stream, wptr,
+						  sink_bytes);
 			}
 		}
 #endif
@@ -334,10 +404,10 @@ dai_dma_cb(struct dai_data *dd, struct comp_dev *dev, uint32_t bytes,
 /* this is called by DMA driver every time descriptor has completed */
 static enum dma_cb_status
 dai_dma_multi_endpoint_cb(struct dai_data *dd, struct comp_dev *dev, uint32_t frames,
-			  struct comp_buffer *multi_endpoint_buffer)
+			  struct comp_buffer *multi_endpoint_buffer, bool copied)
 {
 	enum dma_cb_status dma_status = DMA_CB_STATUS_RELOAD;
-	uint32_t i, bytes;
+	uint32_t bytes;
 
 	comp_dbg(dev, "dai_dma_multi_endpoint_cb()");
 
@@ -361,19 +431,20 @@ dai_dma_multi_endpoint_cb(struct dai_data *dd, struct comp_dev *dev, uint32_t fr
 	}
 
 	bytes = frames * audio_stream_frame_bytes(&dd->dma_buffer->stream);
-	if (dev->direction == SOF_IPC_STREAM_CAPTURE)
-		audio_stream_invalidate(&dd->dma_buffer->stream, bytes);
 
-	/* copy all channels one by one */
-	for (i = 0; i < audio_stream_get_channels(&dd->dma_buffer->stream); i++) {
-		uint32_t multi_buf_channel = dd->dma_buffer->chmap[i];
+	/* copy all channels of the gateway at once unless all the gateways
+	 * have been copied together
+	 */
+	if (!copied) {
+		if (dev->direction == SOF_IPC_STREAM_CAPTURE)
+			audio_stream_invalidate(&dd->dma_buffer->stream, bytes);
 
 		if (dev->direction == SOF_IPC_STREAM_PLAYBACK)
-			dd->process(&multi_endpoint_buffer->stream, multi_buf_channel,
-				    &dd->dma_buffer->stream, i, frames);
+			chmap_remap_process(dd->remap, &multi_endpoint_buffer->stream,
+					    &dd->dma_buffer->stream, frames);
 		else
-			dd->process(&dd->dma_buffer->stream, i, &multi_endpoint_buffer->stream,
-				    multi_buf_channel, frames);
+			chmap_remap_process(dd->remap, &dd->dma_buffer->stream,
+					    &multi_endpoint_buffer->stream, frames);
 	}
 
 	if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
@@ -389,6 +460,77 @@ dai_dma_multi_endpoint_cb(struct dai_data *dd, struct comp_dev *dev, uint32_t fr
 	return dma_status;
 }
 
+#if CONFIG_COMP_DAI_DIRECT_DMA
+/* invalidates or writes back bytes of the stream from ptr, with rollover */
+static void dai_direct_cache(struct audio_stream *stream, void *ptr, uint32_t bytes,
+			     bool invalidate)
+{
+	uint32_t head_size = MIN(bytes, (uint32_t)((char *)audio_stream_get_end_addr(stream) -
+						   (char *)ptr));
+	uint32_t tail_size = bytes - head_size;
+	void *addr = audio_stream_get_addr(stream);
+
+	if (invalidate) {
+		dcache_invalidate_region((__sparse_force void __sparse_cache *)ptr, head_size);
+		if (tail_size)
+			dcache_invalidate_region((__sparse_force void __sparse_cache *)addr,
+						 tail_size);
+	} else {
+		dcache_writeback_region((__sparse_force void __sparse_cache *)ptr, head_size);
+		if (tail_size)
+			dcache_writeback_region((__sparse_force void __sparse_cache *)addr,
+						tail_size);
+	}
+}
+
+/*
+ * Sets the local buffer up on the DMA buffer memory, so the copy only has to
+ * move the buffer and DMA positions. This is possible only when the stream
+ * needs no conversion and the local buffer is the only buffer of the DAI.
+ */
+static void dai_direct_attach(struct dai_data *dd, struct comp_dev *dev)
+{
+	struct comp_buffer *local = dd->local_buffer;
+	struct audio_stream *dma_stream = &dd->dma_buffer->stream;
+	struct list_item *buffers = dev->direction == SOF_IPC_STREAM_PLAYBACK ?
+				    &dev->bsource_list : &dev->bsink_list;
+
+	if (dd->direct_buffer || !local || local->is_shared || dd->remap)
+		return;
+
+	/* more than one buffer */
+	if (buffers->next->next != buffers)
+		return;
+
+	if (audio_stream_get_frm_fmt(&local->stream) != audio_stream_get_frm_fmt(dma_stream) ||
+	    audio_stream_get_channels(&local->stream) != audio_stream_get_channels(dma_stream) ||
+	    audio_stream_get_size(&local->stream) > audio_stream_get_size(dma_stream))
+		return;
+
+	dd->direct_buffer = local;
+	dd->direct_addr = audio_stream_get_addr(&local->stream);
+	dd->direct_size = audio_stream_get_size(&local->stream);
+	dd->direct_pending = 0;
+	audio_stream_init(&local->stream, audio_stream_get_addr(dma_stream),
+			  audio_stream_get_size(dma_stream));
+	/* the DMA buffer memory must not be freed or moved through the local buffer */
+	local->borrowed = true;
+
+	comp_info(dev, "dai_direct_attach(): local buffer %x uses the DMA buffer", local->id);
+}
+
+/* gives the local buffer its own memory back */
+static void dai_direct_detach(struct dai_data *dd)
+{
+	if (!dd->direct_buffer)
+		return;
+
+	audio_stream_init(&dd->direct_buffer->stream, dd->direct_addr, dd->direct_size);
+	dd->direct_buffer->borrowed = false;
+	dd->direct_buffer = NULL;
+}
+#endif /* CONFIG_COMP_DAI_DIRECT_DMA */
+
 int dai_common_new(struct dai_data *dd, struct comp_dev *dev,
 		   const struct ipc_config_dai *dai_cfg)
 {
@@ -726,6 +868,62 @@ static int dai_set_dma_config(struct dai_data *dd, struct comp_dev *dev)
 	return 0;
 }
 
+#if CONFIG_COMP_DAI_ADAPTIVE_WATERMARK
+/*
+ * The watermark limits how far ahead of the DMA a playback DAI fills the DMA
+ * buffer. It starts at the full buffer and follows the scheduling jitter: an
+ * underrun or a pipeline xrun widens it by a period, a window of copies that
+ * all found more than a period of slack left in the DMA narrows it by one.
+ */
+static void dai_watermark_init(struct dai_data *dd, struct comp_dev *dev,
+			       uint32_t buffer_size, uint32_t period_bytes)
+{
+	struct dai_watermark *wm = &dd->watermark;
+	uint32_t period = dev->pipeline ? dev->pipeline->period : 0;
+
+	wm->max_bytes = buffer_size;
+	wm->min_bytes = MIN(CONFIG_COMP_DAI_ADAPTIVE_WATERMARK_MIN * period_bytes, buffer_size);
+	wm->bytes = wm->max_bytes;
+	wm->low = UINT32_MAX;
+	wm->copies = 0;
+	wm->window = period ? CONFIG_COMP_DAI_ADAPTIVE_WATERMARK_WINDOW_MS * 1000 / period :
+		1000;
+	wm->xrun_count = dev->pipeline ? dev->pipeline->xrun_count : 0;
+}
+
+/* returns the bytes that can be queued on top of the pending ones */
+static uint32_t dai_watermark_limit(struct dai_data *dd, struct comp_dev *dev,
+				    uint32_t pending, bool underrun)
+{
+	struct dai_watermark *wm = &dd->watermark;
+	uint32_t xrun_count = dev->pipeline ? dev->pipeline->xrun_count : 0;
+
+	if (underrun || xrun_count != wm->xrun_count) {
+		wm->xrun_count = xrun_count;
+		wm->bytes = MIN(wm->bytes + dd->period_bytes, wm->max_bytes);
+		wm->low = UINT32_MAX;
+		wm->copies = 0;
+		comp_dbg(dev, "dai_watermark_limit(): widened to %u", wm->bytes);
+	} else {
+		wm->low = MIN(wm->low, pending);
+		if (++wm->copies >= wm->window) {
+			if (wm->low > dd->period_bytes &&
+			    wm->bytes >= wm->min_bytes + dd->period_bytes) {
+				wm->bytes -= dd->period_bytes;
+				comp_dbg(dev, "dai_watermark_limit(): narrowed to %u", wm->bytes);
+			}
+			wm->low = UINT32_MAX;
+			wm->copies = 0;
+		}
+	}
+
+	if (dev->pipeline)
+		dev->pipeline->dai_watermark = wm->bytes;
+
+	return wm->bytes > pending ? wm->bytes - pending : 0;
+}
+#endif
+
 static int dai_set_dma_buffer(struct dai_data *dd, struct comp_dev *dev,
 			      struct sof_ipc_stream_params *params, uint32_t *pb, uint32_t *pc)
 {
@@ -826,6 +1024,9 @@ static int dai_set_dma_buffer(struct dai_data *dd, struct comp_dev *dev,
 	}
 
 	dd->fast_mode = dd->ipc_config.feature_mask & BIT(IPC4_COPIER_FAST_MODE);
+#if CONFIG_COMP_DAI_ADAPTIVE_WATERMARK
+	dai_watermark_init(dd, dev, buffer_size, period_bytes);
+#endif
 	return 0;
 }
 
@@ -852,6 +1053,11 @@ int dai_common_params(struct dai_data *dd, struct comp_dev *dev,
 		return -EINVAL;
 	}
 
+#if CONFIG_COMP_DAI_DIRECT_DMA
+	/* the DMA buffer may be resized */
+	dai_direct_detach(dd);
+#endif
+
 	err = dai_set_dma_buffer(dd, dev, params, &period_bytes, &period_count);
 	if (err < 0) {
 		comp_err(dev, "dai_zephyr_params(): alloc dma buffer failed.");
@@ -865,8 +1071,14 @@ int dai_common_params(struct dai_data *dd, struct comp_dev *dev,
 	}
 
 	err = dai_set_dma_config(dd, dev);
-	if (err < 0)
+	if (err < 0) {
 		comp_err(dev, "dai_zephyr_params(): set dma config failed.");
+		goto out;
+	}
+
+#if CONFIG_COMP_DAI_DIRECT_DMA
+	dai_direct_attach(dd, dev);
+#endif
 out:
 	/*
 	 * Make sure to free all allocated items, all functions
@@ -960,6 +1172,13 @@ int dai_common_prepare(struct dai_data *dd, struct comp_dev *dev)
 	/* clear dma buffer to avoid pop noise */
 	buffer_zero(dd->dma_buffer);
 
+#if CONFIG_COMP_DAI_DIRECT_DMA
+	if (dd->direct_buffer) {
+		audio_stream_reset(&dd->direct_buffer->stream);
+		dd->direct_pending = 0;
+	}
+#endif
+
 	/* dma reconfig not required if XRUN handling */
 	if (dd->xrun) {
 		/* after prepare, we have recovered from xrun */
@@ -1014,6 +1233,9 @@ void dai_common_reset(struct dai_data *dd, struct comp_dev *dev)
 	}
 
 	if (dd->dma_buffer) {
+#if CONFIG_COMP_DAI_DIRECT_DMA
+		dai_direct_detach(dd);
+#endif
 		buffer_free(dd->dma_buffer);
 		dd->dma_buffer = NULL;
 	}
@@ -1147,6 +1369,9 @@ static int dai_comp_trigger_internal(struct dai_data *dd, struct comp_dev *dev,
 int dai_common_trigger(struct dai_data *dd, struct comp_dev *dev, int cmd)
 {
 	struct dai_group *group = dd->group;
+#if CONFIG_COMP_DAI_GROUP_HW_SYNC
+	const struct dai_group_sync_ops *sync;
+#endif
 	uint32_t irq_flags;
 	int ret = 0;
 
@@ -1186,12 +1411,28 @@ int dai_common_trigger(struct dai_data *dd, struct comp_dev *dev, int cmd)
 			 * synchronously.
 			 */
 
+			group->trigger_ret = 0;
+#if CONFIG_COMP_DAI_GROUP_HW_SYNC
+			sync = dai_group_sync_arm(group, cmd);
+			if (sync)
+				comp_dbg(dev, "dai_common_trigger(), hardware release of group %d",
+					 group->group_id);
+#endif
+
 			irq_local_disable(irq_flags);
 			notifier_event(group, NOTIFIER_ID_DAI_TRIGGER,
 				       BIT(cpu_get_id()), NULL, 0);
+#if CONFIG_COMP_DAI_GROUP_HW_SYNC
+			if (sync) {
+				if (group->trigger_ret)
+					sync->disarm(group);
+				else
+					sync->go(group);
+			}
+#endif
 			irq_local_enable(irq_flags);
 
-			/* return error of last trigger */
+			/* return error of a failed trigger */
 			ret = group->trigger_ret;
 		}
 	}
@@ -1216,12 +1457,101 @@ static void dai_report_xrun(struct dai_data *dd, struct comp_dev *dev, uint32_t
 		comp_err(dev, "dai_report_xrun(): overrun due to no space available");
 		comp_overrun(dev, dd->local_buffer, bytes);
 	}
+
+#if CONFIG_XRUN_NOTIFICATIONS_BATCH
+	/* dai_data has no gateway node id, the host maps the module instance */
+	xrun_notif_batch_event(SOF_IPC4_MODULE_INSTANCE, dev_comp_id(dev),
+			       dev->direction == SOF_IPC_STREAM_PLAYBACK ?
+			       SOF_IPC4_GATEWAY_UNDERRUN_DETECTED :
+			       SOF_IPC4_GATEWAY_OVERRUN_DETECTED);
+#endif
+}
+
+#if CONFIG_COMP_DAI_DIRECT_DMA
+/*
+ * Moves the local buffer and DMA positions when the local buffer is set up on
+ * the DMA buffer memory. direct_pending counts the bytes between the DMA and
+ * the local buffer positions: on capture the bytes produced in the local
+ * buffer but not given back to the DMA yet, on playback the bytes given to the
+ * DMA but not consumed from the local buffer yet.
+ */
+static int dai_direct_copy(struct dai_data *dd, struct comp_dev *dev, uint32_t dma_pending)
+{
+	struct comp_buffer *local = dd->local_buffer;
+	struct audio_stream *stream = &local->stream;
+	uint32_t avail = audio_stream_get_avail_bytes(stream);
+	uint32_t limit = dd->fast_mode ? UINT32_MAX : dd->period_bytes;
+	uint32_t reload;
+	uint32_t bytes;
+	int ret;
+
+	/* stop dma copy for pause/stop/xrun */
+	if (dev->state != COMP_STATE_ACTIVE || dd->xrun) {
+		dai_trigger_op(dd->dai, COMP_TRIGGER_STOP, dev->direction);
+		dma_stop(dd->chan->dma->z_dev, dd->chan->index);
+
+		/* make sure we only playback silence during an XRUN */
+		if (dd->xrun && dev->direction == SOF_IPC_STREAM_PLAYBACK)
+			buffer_zero(dd->dma_buffer);
+
+		return 0;
+	}
+
+	ret = dai_trigger(dd->dai->dev, dev->direction, DAI_TRIGGER_COPY);
+	if (ret < 0)
+		comp_warn(dev, "dai_direct_copy(): dai trigger copy failed");
+
+	if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
+		/* consume what the DMA has played */
+		bytes = dd->direct_pending - MIN(dma_pending, dd->direct_pending);
+		if (bytes)
+			comp_update_buffer_consume(local, bytes);
+		dd->direct_pending -= bytes;
+
+		/* give the DMA the new data */
+		reload = MIN(avail - bytes - dd->direct_pending, limit);
+		dai_direct_cache(stream, audio_stream_wrap(stream,
+							   (char *)audio_stream_get_rptr(stream) +
+							   dd->direct_pending),
+				 reload, false);
+		dd->direct_pending += reload;
+		bytes = reload;
+	} else {
+		/* give the DMA back what the sink has consumed */
+		reload = dd->direct_pending - MIN(avail, dd->direct_pending);
+		dd->direct_pending -= reload;
+
+		/* produce what the DMA has captured */
+		bytes = MIN(dma_pending - MIN(dma_pending, dd->direct_pending + reload), limit);
+		if (bytes) {
+			dai_direct_cache(stream, audio_stream_get_wptr(stream), bytes, true);
+			comp_update_buffer_produce(local, bytes);
+		}
+		dd->direct_pending += bytes;
+	}
+
+	/* update host position (in bytes offset) for drivers */
+	dd->total_data_processed += bytes;
+
+	SOF_TRACEPOINT(SOF_TRACEPOINT_DAI_COPY, SOF_TRACEPOINT_INSTANT, dev_comp_id(dev),
+		       bytes);
+
+	ret = dma_reload(dd->chan->dma->z_dev, dd->chan->index, 0, 0, reload);
+	if (ret < 0) {
+		dai_report_xrun(dd, dev, reload);
+		return ret;
+	}
+
+	dai_dma_position_update(dd, dev);
+
+	return 0;
 }
+#endif /* CONFIG_COMP_DAI_DIRECT_DMA */
 
 /* process and copy stream data from multiple DMA source buffers to sink buffer */
 int dai_zephyr_multi_endpoint_copy(struct dai_data **dd, struct comp_dev *dev,
 				   struct comp_buffer *multi_endpoint_buffer,
-				   int num_endpoints)
+				   int num_endpoints, const struct chmap_split *split)
 {
 	uint32_t avail_bytes = UINT32_MAX;
 	uint32_t free_bytes = UINT32_MAX;
@@ -1304,6 +1634,21 @@ int dai_zephyr_multi_endpoint_copy(struct dai_data **dd, struct comp_dev *dev,
 		buffer_stream_invalidate(multi_endpoint_buffer, frames * frame_bytes);
 	}
 
+	/* copy all the gateways in one pass over the multi-endpoint buffer */
+	if (split) {
+		struct audio_stream *parts[CHMAP_SPLIT_MAX_PARTS];
+
+		for (i = 0; i < num_endpoints; i++) {
+			parts[i] = &dd[i]->dma_buffer->stream;
+			if (direction == SOF_IPC_STREAM_CAPTURE)
+				audio_stream_invalidate(parts[i],
+							frames * audio_stream_frame_bytes(parts[i]));
+		}
+
+		chmap_split_process(split, &multi_endpoint_buffer->stream, parts, frames,
+				    direction == SOF_IPC_STREAM_CAPTURE);
+	}
+
 	for (i = 0; i < num_endpoints; i++) {
 		enum dma_cb_status status;
 		uint32_t copy_bytes;
@@ -1313,7 +1658,8 @@ int dai_zephyr_multi_endpoint_copy(struct dai_data **dd, struct comp_dev *dev,
 		if (ret < 0)
 			comp_warn(dev, "dai_zephyr_multi_endpoint_copy(): dai trigger copy failed");
 
-		status = dai_dma_multi_endpoint_cb(dd[i], dev, frames, multi_endpoint_buffer);
+		status = dai_dma_multi_endpoint_cb(dd[i], dev, frames, multi_endpoint_buffer,
+						   split);
 		if (status == DMA_CB_STATUS_END)
 			dma_stop(dd[i]->chan->dma->z_dev, dd[i]->chan->index);
 
@@ -1407,11 +1753,20 @@ int dai_common_copy(struct dai_data *dd, struct comp_dev *dev, pcm_converter_fun
 		}
 	}
 
+#if CONFIG_COMP_DAI_DIRECT_DMA
+	if (dd->direct_buffer && dd->direct_buffer == dd->local_buffer)
+		return dai_direct_copy(dd, dev, avail_bytes);
+#endif
+
 	/* calculate minimum size to copy */
 	if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
 		src_samples = audio_stream_get_avail_samples(&dd->local_buffer->stream);
 		sink_samples = free_bytes / sampling;
 		samples = MIN(src_samples, sink_samples);
+#if CONFIG_COMP_DAI_ADAPTIVE_WATERMARK
+		samples = MIN(samples, dai_watermark_limit(dd, dev, avail_bytes,
+							   ret == -EPIPE) / sampling);
+#endif
 	} else {
 		struct list_item *sink_list;
 
@@ -1485,6 +1840,9 @@ int dai_common_copy(struct dai_data *dd, struct comp_dev *dev, pcm_converter_fun
 	if (dai_dma_cb(dd, dev, copy_bytes, converter) == DMA_CB_STATUS_END)
 		dma_stop(dd->chan->dma->z_dev, dd->chan->index);
 
+	SOF_TRACEPOINT(SOF_TRACEPOINT_DAI_COPY, SOF_TRACEPOINT_INSTANT, dev_comp_id(dev),
+		       copy_bytes);
+
 	ret = dma_reload(dd->chan->dma->z_dev, dd->chan->index, 0, 0, copy_bytes);
 	if (ret < 0) {
 		dai_report_xrun(dd, dev, copy_bytes);
@@ -1646,6 +2004,9 @@ int dai_zephyr_unbind(struct dai_data *dd, struct comp_dev *dev, void *data)
 	if (dd && dd->local_buffer) {
 		if (dd->local_buffer->id == buf_id) {
 			comp_dbg(dev, "dai_zephyr_unbind: local_buffer %x unbound", buf_id);
+#if CONFIG_COMP_DAI_DIRECT_DMA
+			dai_direct_detach(dd);
+#endif
 			dd->local_buffer = NULL;
 		}
 	}
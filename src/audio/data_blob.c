@@ -11,6 +11,7 @@
 #include <ipc/control.h>
 #include <sof/audio/component.h>
 #include <sof/audio/data_blob.h>
+#include <user/blob_delta.h>
 
 LOG_MODULE_REGISTER(data_blob, CONFIG_SOF_LOG_LEVEL);
 
@@ -28,13 +29,120 @@ struct comp_data_blob_handler {
 	uint32_t single_blob:1; /**< Allocate only one blob. Module can not
 				  *  be active while reconfguring.
 				  */
+	uint32_t shared:1;	/**< Share identical blobs with other instances
+				  *  on the same core.
+				  */
+#if CONFIG_COMP_BLOB_DELTA
+	uint32_t delta:1;	/**< Accept delta updates of the current blob */
+	uint32_t delta_pending:1; /**< data_new is a delta update of data */
+	uint32_t delta_offset;	/**< offset of the range changed by the delta */
+	uint32_t delta_size;	/**< size of the range changed by the delta */
+#endif
 	void *(*alloc)(size_t size);	/**< alternate allocator, maybe null */
 	void (*free)(void *buf);	/**< alternate free(), maybe null */
 
 	/** validator for new data, maybe null */
 	int (*validator)(struct comp_dev *dev, void *new_data, uint32_t new_data_size);
+
+	/** builds the state derived from new data before it is applied, maybe null */
+	int (*preparer)(struct comp_dev *dev, void *new_data, uint32_t new_data_size);
+};
+
+/** \brief Blob image shared by instances with identical configuration */
+struct comp_data_blob_shared {
+	struct list_item list;	/**< entry in the per core list */
+	void *data;		/**< blob data, read only */
+	uint32_t size;		/**< size of blob data */
+	uint32_t crc;		/**< crc32 of blob data */
+	uint32_t refs;		/**< number of handlers using the blob */
 };
 
+/* per core lists of shared blobs, each accessed by its own core only */
+struct comp_data_blob_cache {
+	struct list_item list;
+} __aligned(PLATFORM_DCACHE_ALIGN);
+
+static struct comp_data_blob_cache blob_cache[CONFIG_CORE_COUNT];
+
+static struct list_item *comp_data_blob_cache_list(struct comp_data_blob_handler *blob_handler)
+{
+	struct list_item *list = &blob_cache[blob_handler->dev->ipc_config.core].list;
+
+	if (!list->next)
+		list_init(list);
+
+	return list;
+}
+
+/*
+ * Returns the shared image of a fully received blob. If an identical blob is
+ * already in use the new one is freed, otherwise it becomes the shared image.
+ */
+static void *comp_data_blob_share(struct comp_data_blob_handler *blob_handler,
+				  void *data, uint32_t size)
+{
+	struct list_item *list = comp_data_blob_cache_list(blob_handler);
+	struct comp_data_blob_shared *shared;
+	struct list_item *item;
+	uint32_t crc;
+
+	if (!data || !size)
+		return data;
+
+	crc = crc32(0, data, size);
+
+	list_for_item(item, list) {
+		shared = container_of(item, struct comp_data_blob_shared, list);
+		if (shared->size == size && shared->crc == crc &&
+		    !memcmp(shared->data, data, size)) {
+			shared->refs++;
+			blob_handler->free(data);
+			comp_dbg(blob_handler->dev, "comp_data_blob_share(): %u users", shared->refs);
+			return shared->data;
+		}
+	}
+
+	/* on allocation failure the blob simply stays private */
+	shared = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*shared));
+	if (!shared)
+		return data;
+
+	shared->data = data;
+	shared->size = size;
+	shared->crc = crc;
+	shared->refs = 1;
+	list_item_append(&shared->list, list);
+
+	return data;
+}
+
+/* frees a blob, or drops a reference to it if it is shared */
+static void comp_data_blob_free(struct comp_data_blob_handler *blob_handler, void *data)
+{
+	struct comp_data_blob_shared *shared;
+	struct list_item *item;
+
+	if (!data)
+		return;
+
+	if (blob_handler->shared) {
+		list_for_item(item, comp_data_blob_cache_list(blob_handler)) {
+			shared = container_of(item, struct comp_data_blob_shared, list);
+			if (shared->data != data)
+				continue;
+
+			if (--shared->refs)
+				return;
+
+			list_item_del(&shared->list);
+			rfree(shared);
+			break;
+		}
+	}
+
+	blob_handler->free(data);
+}
+
 static void comp_free_data_blob(struct comp_data_blob_handler *blob_handler)
 {
 	assert(blob_handler);
@@ -42,13 +150,120 @@ static void comp_free_data_blob(struct comp_data_blob_handler *blob_handler)
 	if (!blob_handler->data)
 		return;
 
-	blob_handler->free(blob_handler->data);
-	blob_handler->free(blob_handler->data_new);
+	comp_data_blob_free(blob_handler, blob_handler->data);
+	comp_data_blob_free(blob_handler, blob_handler->data_new);
 	blob_handler->data = NULL;
 	blob_handler->data_new = NULL;
 	blob_handler->data_size = 0;
 }
 
+void comp_data_blob_set_shared(struct comp_data_blob_handler *blob_handler)
+{
+	assert(blob_handler);
+
+	/* a single blob is updated in place */
+	if (blob_handler->single_blob) {
+		comp_warn(blob_handler->dev, "comp_data_blob_set_shared(): not supported in single blob mode");
+		return;
+	}
+
+	blob_handler->shared = true;
+}
+
+#if CONFIG_COMP_BLOB_DELTA
+void comp_data_blob_set_delta(struct comp_data_blob_handler *blob_handler)
+{
+	assert(blob_handler);
+
+	/* the current blob is needed when the delta is received */
+	if (blob_handler->single_blob) {
+		comp_warn(blob_handler->dev, "comp_data_blob_set_delta(): not supported in single blob mode");
+		return;
+	}
+
+	blob_handler->delta = true;
+}
+
+bool comp_data_blob_get_delta(struct comp_data_blob_handler *blob_handler,
+			      uint32_t *offset, uint32_t *size)
+{
+	assert(blob_handler);
+
+	if (!blob_handler->data_new || !blob_handler->delta_pending)
+		return false;
+
+	*offset = blob_handler->delta_offset;
+	*size = blob_handler->delta_size;
+	return true;
+}
+
+/*
+ * Replaces a fully received delta update with a copy of the current blob
+ * that has the delta applied. The rest of the update is then done as for
+ * a full blob. Nothing is done if data_new is a full blob.
+ */
+static int comp_data_blob_apply_delta(struct comp_data_blob_handler *blob_handler)
+{
+	struct sof_blob_delta *delta = blob_handler->data_new;
+	void *data;
+	int ret;
+
+	blob_handler->delta_pending = false;
+	if (!blob_handler->delta || blob_handler->new_data_size < sizeof(*delta) ||
+	    delta->magic != SOF_BLOB_DELTA_MAGIC)
+		return 0;
+
+	if (!blob_handler->data ||
+	    delta->size != blob_handler->new_data_size - sizeof(*delta) ||
+	    delta->offset > blob_handler->data_size ||
+	    delta->size > blob_handler->data_size - delta->offset) {
+		comp_err(blob_handler->dev, "comp_data_blob_apply_delta(): invalid delta, offset %u size %u",
+			 delta->offset, delta->size);
+		ret = -EINVAL;
+		goto err;
+	}
+
+	data = blob_handler->alloc(blob_handler->data_size);
+	if (!data) {
+		comp_err(blob_handler->dev, "comp_data_blob_apply_delta(): blob allocation failed");
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	ret = memcpy_s(data, blob_handler->data_size, blob_handler->data,
+		       blob_handler->data_size);
+	assert(!ret);
+	ret = memcpy_s((uint8_t *)data + delta->offset, blob_handler->data_size - delta->offset,
+		       delta->data, delta->size);
+	assert(!ret);
+
+	comp_dbg(blob_handler->dev, "comp_data_blob_apply_delta(): offset %u size %u",
+		 delta->offset, delta->size);
+
+	blob_handler->delta_offset = delta->offset;
+	blob_handler->delta_size = delta->size;
+	blob_handler->delta_pending = true;
+
+	/* a received delta is never shared */
+	blob_handler->free(blob_handler->data_new);
+	blob_handler->data_new = data;
+	blob_handler->new_data_size = blob_handler->data_size;
+	return 0;
+
+err:
+	blob_handler->free(blob_handler->data_new);
+	blob_handler->data_new = NULL;
+	blob_handler->new_data_size = 0;
+	blob_handler->data_pos = 0;
+	return ret;
+}
+#else
+static inline int comp_data_blob_apply_delta(struct comp_data_blob_handler *blob_handler)
+{
+	return 0;
+}
+#endif
+
 void comp_data_blob_set_validator(struct comp_data_blob_handler *blob_handler,
 				  int (*validator)(struct comp_dev *dev, void *new_data,
 						   uint32_t new_data_size))
@@ -58,6 +273,38 @@ void comp_data_blob_set_validator(struct comp_data_blob_handler *blob_handler,
 	blob_handler->validator = validator;
 }
 
+void comp_data_blob_set_preparer(struct comp_data_blob_handler *blob_handler,
+				 int (*preparer)(struct comp_dev *dev, void *new_data,
+						 uint32_t new_data_size))
+{
+	assert(blob_handler);
+
+	blob_handler->preparer = preparer;
+}
+
+/* Let the component build its state for a blob waiting to be applied in copy(),
+ * the blob is discarded when the component can not use it.
+ */
+static int comp_data_blob_prepare_new(struct comp_data_blob_handler *blob_handler)
+{
+	int ret;
+
+	if (!blob_handler->preparer)
+		return 0;
+
+	ret = blob_handler->preparer(blob_handler->dev, blob_handler->data_new,
+				     blob_handler->new_data_size);
+	if (ret < 0) {
+		comp_err(blob_handler->dev, "comp_data_blob_prepare_new(): new data blob can not be prepared, discarding");
+		comp_data_blob_free(blob_handler, blob_handler->data_new);
+		blob_handler->data_new = NULL;
+		blob_handler->new_data_size = 0;
+		blob_handler->data_pos = 0;
+	}
+
+	return ret;
+}
+
 void *comp_get_data_blob(struct comp_data_blob_handler *blob_handler,
 			 size_t *size, uint32_t *crc)
 {
@@ -73,7 +320,7 @@ void *comp_get_data_blob(struct comp_data_blob_handler *blob_handler,
 		comp_dbg(blob_handler->dev, "comp_get_data_blob(): new data available");
 
 		/* Free "old" data blob and set data to data_new pointer */
-		blob_handler->free(blob_handler->data);
+		comp_data_blob_free(blob_handler, blob_handler->data);
 		blob_handler->data = blob_handler->data_new;
 		blob_handler->data_size = blob_handler->new_data_size;
 
@@ -154,6 +401,9 @@ int comp_init_data_blob(struct comp_data_blob_handler *blob_handler,
 		bzero(blob_handler->data, size);
 	}
 
+	if (blob_handler->shared)
+		blob_handler->data = comp_data_blob_share(blob_handler, blob_handler->data, size);
+
 	blob_handler->data_new = NULL;
 	blob_handler->data_size = size;
 	blob_handler->new_data_size = 0;
@@ -226,7 +476,7 @@ int comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 
 		if (blob_handler->single_blob) {
 			if (data_offset_size != blob_handler->data_size) {
-				blob_handler->free(blob_handler->data);
+				comp_data_blob_free(blob_handler, blob_handler->data);
 				blob_handler->data = NULL;
 			} else {
 				blob_handler->data_new = blob_handler->data;
@@ -265,24 +515,34 @@ int comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 
 	if (pos == MODULE_CFG_FRAGMENT_SINGLE || pos == MODULE_CFG_FRAGMENT_LAST) {
 		comp_dbg(blob_handler->dev, "comp_data_blob_set_cmd(): final package received");
+
+		ret = comp_data_blob_apply_delta(blob_handler);
+		if (ret < 0)
+			return ret;
+
 		if (blob_handler->validator) {
 			comp_dbg(blob_handler->dev, "comp_data_blob_set_cmd(): validating new data...");
 			ret = blob_handler->validator(blob_handler->dev, blob_handler->data_new,
 						      blob_handler->new_data_size);
 			if (ret < 0) {
 				comp_err(blob_handler->dev, "comp_data_blob_set_cmd(): new data is invalid! discarding it...");
-				blob_handler->free(blob_handler->data_new);
+				comp_data_blob_free(blob_handler, blob_handler->data_new);
 				blob_handler->data_new = NULL;
 				return ret;
 			}
 		}
 
+		if (blob_handler->shared)
+			blob_handler->data_new = comp_data_blob_share(blob_handler,
+								      blob_handler->data_new,
+								      blob_handler->new_data_size);
+
 		/* If component state is READY we can omit old
 		 * configuration immediately. When in playback/capture
 		 * the new configuration presence is checked in copy().
 		 */
 		if (blob_handler->dev->state ==  COMP_STATE_READY) {
-			blob_handler->free(blob_handler->data);
+			comp_data_blob_free(blob_handler, blob_handler->data);
 			blob_handler->data = NULL;
 		}
 
@@ -301,6 +561,10 @@ int comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 			blob_handler->new_data_size = 0;
 			blob_handler->data_pos = 0;
 		} else {
+			ret = comp_data_blob_prepare_new(blob_handler);
+			if (ret < 0)
+				return ret;
+
 			/* The new configuration is ready to be applied */
 			blob_handler->data_ready = true;
 		}
@@ -333,7 +597,7 @@ int ipc4_comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 
 		if (blob_handler->single_blob) {
 			if (data_offset != blob_handler->data_size) {
-				blob_handler->free(blob_handler->data);
+				comp_data_blob_free(blob_handler, blob_handler->data);
 				blob_handler->data = NULL;
 			} else {
 				blob_handler->data_new = blob_handler->data;
@@ -395,12 +659,21 @@ int ipc4_comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 		comp_dbg(blob_handler->dev,
 			 "ipc4_comp_data_blob_set(): final package received");
 
+		ret = comp_data_blob_apply_delta(blob_handler);
+		if (ret < 0)
+			return ret;
+
+		if (blob_handler->shared)
+			blob_handler->data_new = comp_data_blob_share(blob_handler,
+								      blob_handler->data_new,
+								      blob_handler->new_data_size);
+
 		/* If component state is READY we can omit old
 		 * configuration immediately. When in playback/capture
 		 * the new configuration presence is checked in copy().
 		 */
 		if (blob_handler->dev->state ==  COMP_STATE_READY) {
-			blob_handler->free(blob_handler->data);
+			comp_data_blob_free(blob_handler, blob_handler->data);
 			blob_handler->data = NULL;
 		}
 
@@ -419,6 +692,10 @@ int ipc4_comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 			blob_handler->new_data_size = 0;
 			blob_handler->data_pos = 0;
 		} else {
+			ret = comp_data_blob_prepare_new(blob_handler);
+			if (ret < 0)
+				return ret;
+
 			/* The new configuration is ready to be applied */
 			blob_handler->data_ready = true;
 		}
@@ -478,7 +755,7 @@ int comp_data_blob_set_cmd(struct comp_data_blob_handler *blob_handler,
 
 		if (blob_handler->single_blob) {
 			if (cdata->data->size != blob_handler->data_size) {
-				blob_handler->free(blob_handler->data);
+				comp_data_blob_free(blob_handler, blob_handler->data);
 				blob_handler->data = NULL;
 			} else {
 				blob_handler->data_new = blob_handler->data;
@@ -518,24 +795,33 @@ int comp_data_blob_set_cmd(struct comp_data_blob_handler *blob_handler,
 	if (!cdata->elems_remaining) {
 		comp_dbg(blob_handler->dev, "comp_data_blob_set_cmd(): final package received");
 
+		ret = comp_data_blob_apply_delta(blob_handler);
+		if (ret < 0)
+			return ret;
+
 		if (blob_handler->validator) {
 			comp_dbg(blob_handler->dev, "comp_data_blob_set_cmd(): validating new data blob");
 			ret = blob_handler->validator(blob_handler->dev, blob_handler->data_new,
 						      blob_handler->new_data_size);
 			if (ret < 0) {
 				comp_err(blob_handler->dev, "comp_data_blob_set_cmd(): new data blob invalid, discarding");
-				blob_handler->free(blob_handler->data_new);
+				comp_data_blob_free(blob_handler, blob_handler->data_new);
 				blob_handler->data_new = NULL;
 				return ret;
 			}
 		}
 
+		if (blob_handler->shared)
+			blob_handler->data_new = comp_data_blob_share(blob_handler,
+								      blob_handler->data_new,
+								      blob_handler->new_data_size);
+
 		/* If component state is READY we can omit old
 		 * configuration immediately. When in playback/capture
 		 * the new configuration presence is checked in copy().
 		 */
 		if (blob_handler->dev->state ==  COMP_STATE_READY) {
-			blob_handler->free(blob_handler->data);
+			comp_data_blob_free(blob_handler, blob_handler->data);
 			blob_handler->data = NULL;
 		}
 
@@ -554,6 +840,10 @@ int comp_data_blob_set_cmd(struct comp_data_blob_handler *blob_handler,
 			blob_handler->new_data_size = 0;
 			blob_handler->data_pos = 0;
 		} else {
+			ret = comp_data_blob_prepare_new(blob_handler);
+			if (ret < 0)
+				return ret;
+
 			/* The new configuration is ready to be applied */
 			blob_handler->data_ready = true;
 		}
@@ -269,7 +269,8 @@ static int dcblock_prepare(struct processing_module *mod,
 	dcblock_set_frame_alignment(&sourceb->stream, &sinkb->stream);
 
 	dcblock_init_state(cd);
-	cd->dcblock_func = dcblock_find_func(cd->source_format);
+	cd->dcblock_func = dcblock_find_func(cd->source_format,
+					     audio_stream_get_channels(&sourceb->stream));
 	if (!cd->dcblock_func) {
 		comp_err(dev, "dcblock_prepare(), No processing function matching frames format");
 		return -EINVAL;
@@ -279,10 +280,12 @@ static int dcblock_prepare(struct processing_module *mod,
 		  cd->source_format, cd->sink_format);
 
 	cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
-	if (cd->config)
+	if (cd->config) {
 		dcblock_copy_coefficients(mod);
-	else
+	} else {
 		dcblock_set_passthrough(mod);
+		mod->bypass = true;
+	}
 
 	return 0;
 }
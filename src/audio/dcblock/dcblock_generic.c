@@ -151,8 +151,119 @@ static void dcblock_s32_default(struct comp_data *cd,
 }
 #endif /* CONFIG_FORMAT_S32LE */
 
+#if CONFIG_COMP_DCBLOCK_CHANNEL_KERNELS
+/* Frame by frame processing for a fixed number of channels. The filter
+ * states and coefficients are kept in locals so that the compiler can
+ * unroll the channel loop and keep them in registers.
+ */
+#define DCBLOCK_FUNC_CH(fmt, type, nch)						\
+static void dcblock_##fmt##_##nch##ch(struct comp_data *cd,			\
+				   const struct audio_stream *source,		\
+				   const struct audio_stream *sink,		\
+				   uint32_t frames)				\
+{										\
+	struct dcblock_state state[nch];					\
+	int32_t R[nch];								\
+	type *x = audio_stream_get_rptr(source);				\
+	type *y = audio_stream_get_wptr(sink);					\
+	int ch, i, n, nmax;							\
+										\
+	for (ch = 0; ch < (nch); ch++) {					\
+		state[ch] = cd->state[ch];					\
+		R[ch] = cd->R_coeffs[ch];					\
+	}									\
+										\
+	while (frames) {							\
+		nmax = audio_stream_frames_without_wrap(source, x);		\
+		n = MIN(frames, nmax);						\
+		nmax = audio_stream_frames_without_wrap(sink, y);		\
+		n = MIN(n, nmax);						\
+		for (i = 0; i < n; i++) {					\
+			for (ch = 0; ch < (nch); ch++)				\
+				y[ch] = dcblock_out_##fmt(dcblock_generic(&state[ch], R[ch], \
+							  dcblock_in_##fmt(x[ch]))); \
+			x += (nch);						\
+			y += (nch);						\
+		}								\
+		frames -= n;							\
+		x = audio_stream_wrap(source, x);				\
+		y = audio_stream_wrap(sink, y);					\
+	}									\
+										\
+	for (ch = 0; ch < (nch); ch++)						\
+		cd->state[ch] = state[ch];					\
+}
+
+#define DCBLOCK_FUNCS_CH(fmt, type)	\
+	DCBLOCK_FUNC_CH(fmt, type, 1)	\
+	DCBLOCK_FUNC_CH(fmt, type, 2)	\
+	DCBLOCK_FUNC_CH(fmt, type, 4)	\
+	DCBLOCK_FUNC_CH(fmt, type, 6)	\
+	DCBLOCK_FUNC_CH(fmt, type, 8)
+
+#define DCBLOCK_FNMAP_CH(frame_fmt, fmt)		\
+	{ frame_fmt, dcblock_##fmt##_1ch, 1 },		\
+	{ frame_fmt, dcblock_##fmt##_2ch, 2 },		\
+	{ frame_fmt, dcblock_##fmt##_4ch, 4 },		\
+	{ frame_fmt, dcblock_##fmt##_6ch, 6 },		\
+	{ frame_fmt, dcblock_##fmt##_8ch, 8 },
+
+#if CONFIG_FORMAT_S16LE
+static inline int32_t dcblock_in_s16(int16_t x)
+{
+	return (int32_t)x << 16;
+}
+
+static inline int16_t dcblock_out_s16(int32_t y)
+{
+	return sat_int16(Q_SHIFT_RND(y, 31, 15));
+}
+
+DCBLOCK_FUNCS_CH(s16, int16_t)
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static inline int32_t dcblock_in_s24(int32_t x)
+{
+	return x << 8;
+}
+
+static inline int32_t dcblock_out_s24(int32_t y)
+{
+	return sat_int24(Q_SHIFT_RND(y, 31, 23));
+}
+
+DCBLOCK_FUNCS_CH(s24, int32_t)
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static inline int32_t dcblock_in_s32(int32_t x)
+{
+	return x;
+}
+
+static inline int32_t dcblock_out_s32(int32_t y)
+{
+	return y;
+}
+
+DCBLOCK_FUNCS_CH(s32, int32_t)
+#endif /* CONFIG_FORMAT_S32LE */
+#endif /* CONFIG_COMP_DCBLOCK_CHANNEL_KERNELS */
+
 const struct dcblock_func_map dcblock_fnmap[] = {
-/* { SOURCE_FORMAT , PROCESSING FUNCTION } */
+/* { SOURCE_FORMAT , PROCESSING FUNCTION, CHANNELS } */
+#if CONFIG_COMP_DCBLOCK_CHANNEL_KERNELS
+#if CONFIG_FORMAT_S16LE
+	DCBLOCK_FNMAP_CH(SOF_IPC_FRAME_S16_LE, s16)
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	DCBLOCK_FNMAP_CH(SOF_IPC_FRAME_S24_4LE, s24)
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	DCBLOCK_FNMAP_CH(SOF_IPC_FRAME_S32_LE, s32)
+#endif /* CONFIG_FORMAT_S32LE */
+#endif /* CONFIG_COMP_DCBLOCK_CHANNEL_KERNELS */
 #if CONFIG_FORMAT_S16LE
 	{ SOF_IPC_FRAME_S16_LE, dcblock_s16_default },
 #endif /* CONFIG_FORMAT_S16LE */
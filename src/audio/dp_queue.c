@@ -10,6 +10,7 @@
 #include <sof/audio/dp_queue.h>
 
 #include <rtos/alloc.h>
+#include <rtos/string.h>
 #include <ipc/topology.h>
 
 LOG_MODULE_REGISTER(dp_queue, CONFIG_SOF_LOG_LEVEL);
@@ -34,42 +35,50 @@ static inline struct dp_queue *dp_queue_from_source(struct sof_source *source)
 	return container_of(source, struct dp_queue, _source_api);
 }
 
+#if CONFIG_SOF_CACHE_STATS
+#define dp_queue_cache_stats(dp_queue) (&(dp_queue)->_cache_stats)
+#else
+#define dp_queue_cache_stats(dp_queue) NULL
+#endif
+
 static inline void dp_queue_invalidate_shared(struct dp_queue *dp_queue,
 					      void __sparse_cache *ptr, size_t size)
 {
-	/* no cache required in case of not shared queue */
-	if (!dp_queue_is_shared(dp_queue))
+	/* no cache required in case of not shared or uncached queue */
+	if (!dp_queue_is_shared(dp_queue) || dp_queue->_flags & DP_QUEUE_MODE_UNCACHED)
 		return;
 
 	/* wrap-around? */
 	if ((uintptr_t)ptr + size > (uintptr_t)dp_queue_buffer_end(dp_queue)) {
+		size_t tail = (uintptr_t)dp_queue_buffer_end(dp_queue) - (uintptr_t)ptr;
+
 		/* writeback till the end of circular buffer */
-		dcache_invalidate_region
-			(ptr, (uintptr_t)dp_queue_buffer_end(dp_queue) - (uintptr_t)ptr);
-		size -= (uintptr_t)dp_queue_buffer_end(dp_queue) - (uintptr_t)ptr;
+		cache_stats_invalidate_region(dp_queue_cache_stats(dp_queue), ptr, tail);
+		size -= tail;
 		ptr = dp_queue->_data_buffer;
 	}
 	/* invalidate rest of data */
-	dcache_invalidate_region(ptr, size);
+	cache_stats_invalidate_region(dp_queue_cache_stats(dp_queue), ptr, size);
 }
 
 static inline void dp_queue_writeback_shared(struct dp_queue *dp_queue,
 					     void __sparse_cache *ptr, size_t size)
 {
-	/* no cache required in case of not shared queue */
-	if (!dp_queue_is_shared(dp_queue))
+	/* no cache required in case of not shared or uncached queue */
+	if (!dp_queue_is_shared(dp_queue) || dp_queue->_flags & DP_QUEUE_MODE_UNCACHED)
 		return;
 
 	/* wrap-around? */
 	if ((uintptr_t)ptr + size > (uintptr_t)dp_queue_buffer_end(dp_queue)) {
+		size_t tail = (uintptr_t)dp_queue_buffer_end(dp_queue) - (uintptr_t)ptr;
+
 		/* writeback till the end of circular buffer */
-		dcache_writeback_region
-			(ptr, (uintptr_t)dp_queue_buffer_end(dp_queue) - (uintptr_t)ptr);
-		size -= (uintptr_t)dp_queue_buffer_end(dp_queue) - (uintptr_t)ptr;
+		cache_stats_writeback_region(dp_queue_cache_stats(dp_queue), ptr, tail);
+		size -= tail;
 		ptr = dp_queue->_data_buffer;
 	}
 	/* writeback rest of data */
-	dcache_writeback_region(ptr, size);
+	cache_stats_writeback_region(dp_queue_cache_stats(dp_queue), ptr, size);
 }
 
 static inline
@@ -245,6 +254,37 @@ static const struct sink_ops dp_queue_sink_ops = {
 	.audio_set_ipc_params = dp_queue_set_ipc_params_sink,
 };
 
+#if CONFIG_BUFFER_COMPACTION
+size_t dp_queue_relocate(struct dp_queue *dp_queue)
+{
+	uint8_t __sparse_cache *new_buffer;
+
+	CORE_CHECK_STRUCT(dp_queue);
+
+	/* a shared queue is used by another core, it is moved by none */
+	if (dp_queue_is_shared(dp_queue))
+		return 0;
+
+	new_buffer = (__sparse_force __sparse_cache void *)
+			rballoc_align(0, 0, dp_queue->data_buffer_size, PLATFORM_DCACHE_ALIGN);
+	if (!new_buffer)
+		return 0;
+
+	/* the data is addressed by offsets, only the base changes */
+	if (new_buffer > dp_queue->_data_buffer) {
+		rfree((__sparse_force void *)new_buffer);
+		return 0;
+	}
+
+	memcpy_s((__sparse_force void *)new_buffer, dp_queue->data_buffer_size,
+		 (__sparse_force void *)dp_queue->_data_buffer, dp_queue->data_buffer_size);
+	rfree((__sparse_force void *)dp_queue->_data_buffer);
+	dp_queue->_data_buffer = new_buffer;
+
+	return dp_queue->data_buffer_size;
+}
+#endif
+
 struct dp_queue *dp_queue_create(size_t min_available, size_t min_free_space, uint32_t flags)
 {
 	struct dp_queue *dp_queue;
@@ -279,10 +319,11 @@ struct dp_queue *dp_queue_create(size_t min_available, size_t min_free_space, ui
 	/* calculate required buffer size */
 	dp_queue->data_buffer_size = 2 * max_ibs_obs;
 
-	/* allocate data buffer - always in cached memory alias */
+	/* allocate data buffer - in cached memory alias unless uncached mode is requested */
 	dp_queue->data_buffer_size = ALIGN_UP(dp_queue->data_buffer_size, PLATFORM_DCACHE_ALIGN);
 	dp_queue->_data_buffer = (__sparse_force __sparse_cache void *)
-			rballoc_align(0, 0, dp_queue->data_buffer_size, PLATFORM_DCACHE_ALIGN);
+			rballoc_align(flags & DP_QUEUE_MODE_UNCACHED ? SOF_MEM_FLAG_COHERENT : 0, 0,
+				      dp_queue->data_buffer_size, PLATFORM_DCACHE_ALIGN);
 	if (!dp_queue->_data_buffer)
 		goto err;
 
@@ -45,12 +45,8 @@ DECLARE_TR_CTX(drc_tr, SOF_UUID(drc_uuid), LOG_LEVEL_INFO);
 
 inline void drc_reset_state(struct drc_state *state)
 {
-	int i;
-
-	rfree(state->pre_delay_buffers[0]);
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; ++i) {
-		state->pre_delay_buffers[i] = NULL;
-	}
+	rfree(state->pre_delay_buffer);
+	state->pre_delay_buffer = NULL;
 
 	state->detector_average = 0;
 	state->compressor_gain = Q_CONVERT_FLOAT(1.0f, 30);
@@ -71,22 +67,14 @@ inline int drc_init_pre_delay_buffers(struct drc_state *state,
 				      size_t sample_bytes,
 				      int channels)
 {
-	size_t bytes_per_channel = sample_bytes * CONFIG_DRC_MAX_PRE_DELAY_FRAMES;
-	size_t bytes_total = bytes_per_channel * channels;
-	int i;
+	size_t bytes_total = sample_bytes * channels * CONFIG_DRC_MAX_PRE_DELAY_FRAMES;
 
-	/* Allocate pre-delay (lookahead) buffers */
-	state->pre_delay_buffers[0] = rballoc(0, SOF_MEM_CAPS_RAM, bytes_total);
-	if (!state->pre_delay_buffers[0])
+	/* Allocate pre-delay (lookahead) buffer for the interleaved frames */
+	state->pre_delay_buffer = rballoc(0, SOF_MEM_CAPS_RAM, bytes_total);
+	if (!state->pre_delay_buffer)
 		return -ENOMEM;
 
-	memset(state->pre_delay_buffers[0], 0, bytes_total);
-
-	for (i = 1; i < channels; ++i) {
-		state->pre_delay_buffers[i] =
-			state->pre_delay_buffers[i - 1] + bytes_per_channel;
-	}
-
+	memset(state->pre_delay_buffer, 0, bytes_total);
 	return 0;
 }
 
@@ -120,6 +108,16 @@ inline int drc_set_pre_delay_time(struct drc_state *state,
 	return 0;
 }
 
+static int drc_update_params(struct drc_comp_data *cd, uint32_t rate)
+{
+#if CONFIG_DRC_GAIN_CURVE_TABLE
+	drc_init_gain_table(&cd->state, &cd->config->params);
+#endif
+
+	/* Set pre-delay time, the indexes are reset only if it changed */
+	return drc_set_pre_delay_time(&cd->state, cd->config->params.pre_delay_time, rate);
+}
+
 static int drc_setup(struct drc_comp_data *cd, uint16_t channels, uint32_t rate)
 {
 	uint32_t sample_bytes = get_sample_bytes(cd->source_format);
@@ -133,8 +131,24 @@ static int drc_setup(struct drc_comp_data *cd, uint16_t channels, uint32_t rate)
 	if (ret < 0)
 		return ret;
 
-	/* Set pre-dely time */
-	return drc_set_pre_delay_time(&cd->state, cd->config->params.pre_delay_time, rate);
+	return drc_update_params(cd, rate);
+}
+
+/*
+ * A delta update within the DRC parameters is applied keeping the detector
+ * and compressor state and the contents of the pre-delay buffer. Only the
+ * state derived from the parameters is updated.
+ */
+static bool drc_delta_in_place(struct drc_comp_data *cd)
+{
+	uint32_t offset;
+	uint32_t size;
+
+	if (!cd->config || !comp_data_blob_get_delta(cd->model_handler, &offset, &size))
+		return false;
+
+	return comp_data_blob_delta_within(offset, size, cd->config, &cd->config->params,
+					   sizeof(cd->config->params));
 }
 
 /*
@@ -175,6 +189,8 @@ static int drc_init(struct processing_module *mod)
 		goto cd_fail;
 	}
 
+	comp_data_blob_set_delta(cd->model_handler);
+
 	/* Get configuration data and reset DRC state */
 	ret = comp_init_data_blob(cd->model_handler, bs, cfg->data);
 	if (ret < 0) {
@@ -197,6 +213,8 @@ static int drc_free(struct processing_module *mod)
 
 	comp_info(mod->dev, "drc_free()");
 
+	/* reset is skipped when prepare() failed, free the pre-delay buffer */
+	drc_reset_state(&cd->state);
 	comp_data_blob_handler_free(cd->model_handler);
 	rfree(cd);
 	return 0;
@@ -246,15 +264,20 @@ static int drc_process(struct processing_module *mod,
 	struct audio_stream *source = input_buffers[0].data;
 	struct audio_stream *sink = output_buffers[0].data;
 	int frames = input_buffers[0].size;
+	bool in_place;
 	int ret;
 
 	comp_dbg(dev, "drc_process()");
 
 	/* Check for changed configuration */
 	if (comp_is_new_data_blob_available(cd->model_handler)) {
+		in_place = drc_delta_in_place(cd);
 		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
-		ret = drc_setup(cd, audio_stream_get_channels(source),
-				audio_stream_get_rate(source));
+		if (in_place)
+			ret = drc_update_params(cd, audio_stream_get_rate(source));
+		else
+			ret = drc_setup(cd, audio_stream_get_channels(source),
+					audio_stream_get_rate(source));
 		if (ret < 0) {
 			comp_err(dev, "drc_copy(), failed DRC setup");
 			return ret;
@@ -333,6 +356,7 @@ static int drc_prepare(struct processing_module *mod,
 	} else {
 		/* Generic function for all formats */
 		cd->drc_func = drc_default_pass;
+		mod->bypass = true;
 	}
 
 	comp_info(dev, "drc_prepare(), DRC is configured.");
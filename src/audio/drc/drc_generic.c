@@ -73,6 +73,19 @@ static int32_t volume_gain(const struct sof_drc_params *p, int32_t x)
 	return y;
 }
 
+#if CONFIG_DRC_GAIN_CURVE_TABLE
+/* Samples the compression curve at the levels of drc_gain_table_lookup(). */
+void drc_init_gain_table(struct drc_state *state, const struct sof_drc_params *p)
+{
+	int i;
+
+	for (i = 0; i < DRC_GAIN_TABLE_SIZE - 1; i++)
+		state->gain_table[i] = volume_gain(p, drc_gain_table_level(i));
+
+	state->gain_table[i] = volume_gain(p, INT32_MAX);
+}
+#endif /* CONFIG_DRC_GAIN_CURVE_TABLE */
+
 /* Update detector_average from the last input division. */
 void drc_update_detector_average(struct drc_state *state,
 				 const struct sof_drc_params *p,
@@ -98,25 +111,27 @@ void drc_update_detector_average(struct drc_state *state,
 		div_start = state->pre_delay_write_index - DRC_DIVISION_FRAMES;
 	}
 
-	/* The max abs value across all channels for this frame */
+	/* The max abs value across all channels for this frame, the channels of
+	 * a frame are adjacent in the pre-delay buffer.
+	 */
 	if (nbyte == 2) { /* 2 bytes per sample */
+		sample16_p = (int16_t *)state->pre_delay_buffer + div_start * nch;
 		for (i = 0; i < DRC_DIVISION_FRAMES; i++) {
 			abs_input_array[i] = 0;
 			for (ch = 0; ch < nch; ch++) {
-				sample16_p =
-					(int16_t *)state->pre_delay_buffers[ch] + div_start + i;
 				sample = Q_SHIFT_LEFT((int32_t)*sample16_p, 15, 31);
 				abs_input_array[i] = MAX(abs_input_array[i], ABS(sample));
+				sample16_p++;
 			}
 		}
 	} else { /* 4 bytes per sample */
+		sample32_p = (int32_t *)state->pre_delay_buffer + div_start * nch;
 		for (i = 0; i < DRC_DIVISION_FRAMES; i++) {
 			abs_input_array[i] = 0;
 			for (ch = 0; ch < nch; ch++) {
-				sample32_p =
-					(int32_t *)state->pre_delay_buffers[ch] + div_start + i;
 				sample = *sample32_p;
 				abs_input_array[i] = MAX(abs_input_array[i], ABS(sample));
+				sample32_p++;
 			}
 		}
 	}
@@ -131,7 +146,11 @@ void drc_update_detector_average(struct drc_state *state,
 		 * derivative matched). The transition from the knee to the
 		 * ratio portion is smooth (1st derivative matched).
 		 */
+#if CONFIG_DRC_GAIN_CURVE_TABLE
+		gain = drc_gain_table_lookup(state, abs_input_array[i]); /* Q2.30 */
+#else
 		gain = volume_gain(p, abs_input_array[i]); /* Q2.30 */
+#endif
 		gain_diff = gain - detector_average; /* Q2.30 */
 		is_release = (gain_diff > 0);
 		if (is_release) {
@@ -270,7 +289,7 @@ void drc_compress_output(struct drc_state *state,
 	int32_t post_warp_compressor_gain;
 	int32_t total_gain;
 
-	int i, j, ch, inc;
+	int i, j, ch;
 	int16_t *sample16_p; /* for s16 format case */
 	int32_t *sample32_p; /* for s24 and s32 format cases */
 	int32_t sample;
@@ -289,8 +308,8 @@ void drc_compress_output(struct drc_state *state,
 		r4 = Q_MULTSR_32X32((int64_t)r2, r2, 30, 30, 30);
 
 		i = 0;
-		inc = 0;
 		if (is_2byte) { /* 2 bytes per sample */
+			sample16_p = (int16_t *)state->pre_delay_buffer + div_start * nch;
 			while (1) {
 				for (j = 0; j < 4; j++) {
 					/* Warp pre-compression gain to smooth out sharp
@@ -306,16 +325,13 @@ void drc_compress_output(struct drc_state *state,
 
 					/* Apply final gain. */
 					for (ch = 0; ch < nch; ch++) {
-						sample16_p =
-							(int16_t *)state->pre_delay_buffers[ch] +
-								div_start + inc;
 						sample = (int32_t)*sample16_p;
 						*sample16_p =
 							sat_int16(Q_MULTSR_32X32((int64_t)sample,
 										 total_gain,
 										 15, 24, 15));
+						sample16_p++;
 					}
-					inc++;
 				}
 
 				if (++i == count)
@@ -325,6 +341,7 @@ void drc_compress_output(struct drc_state *state,
 					x[j] = Q_MULTSR_32X32((int64_t)x[j], r4, 30, 30, 30);
 			}
 		} else { /* 4 bytes per sample */
+			sample32_p = (int32_t *)state->pre_delay_buffer + div_start * nch;
 			while (1) {
 				for (j = 0; j < 4; j++) {
 					/* Warp pre-compression gain to smooth out sharp
@@ -340,16 +357,13 @@ void drc_compress_output(struct drc_state *state,
 
 					/* Apply final gain. */
 					for (ch = 0; ch < nch; ch++) {
-						sample32_p =
-							(int32_t *)state->pre_delay_buffers[ch] +
-								div_start + inc;
 						sample = *sample32_p;
 						*sample32_p =
 							sat_int32(Q_MULTSR_32X32((int64_t)sample,
 										 total_gain,
 										 31, 24, 31));
+						sample32_p++;
 					}
-					inc++;
 				}
 
 				if (++i == count)
@@ -372,8 +386,8 @@ void drc_compress_output(struct drc_state *state,
 		r4 = Q_MULTSR_32X32((int64_t)r2, r2, 30, 30, 30);
 
 		i = 0;
-		inc = 0;
 		if (is_2byte) { /* 2 bytes per sample */
+			sample16_p = (int16_t *)state->pre_delay_buffer + div_start * nch;
 			while (1) {
 				for (j = 0; j < 4; j++) {
 					/* Warp pre-compression gain to smooth out sharp
@@ -388,16 +402,13 @@ void drc_compress_output(struct drc_state *state,
 
 					/* Apply final gain. */
 					for (ch = 0; ch < nch; ch++) {
-						sample16_p =
-							(int16_t *)state->pre_delay_buffers[ch] +
-								div_start + inc;
 						sample = (int32_t)*sample16_p;
 						*sample16_p =
 							sat_int16(Q_MULTSR_32X32((int64_t)sample,
 										 total_gain,
 										 15, 24, 15));
+						sample16_p++;
 					}
-					inc++;
 				}
 
 				if (++i == count)
@@ -408,6 +419,7 @@ void drc_compress_output(struct drc_state *state,
 						   Q_MULTSR_32X32((int64_t)x[j], r4, 30, 30, 30));
 			}
 		} else { /* 4 bytes per sample */
+			sample32_p = (int32_t *)state->pre_delay_buffer + div_start * nch;
 			while (1) {
 				for (j = 0; j < 4; j++) {
 					/* Warp pre-compression gain to smooth out sharp
@@ -422,16 +434,13 @@ void drc_compress_output(struct drc_state *state,
 
 					/* Apply final gain. */
 					for (ch = 0; ch < nch; ch++) {
-						sample32_p =
-							(int32_t *)state->pre_delay_buffers[ch] +
-								div_start + inc;
 						sample = *sample32_p;
 						*sample32_p =
 							sat_int32(Q_MULTSR_32X32((int64_t)sample,
 										 total_gain,
 										 31, 24, 31));
+						sample32_p++;
 					}
-					inc++;
 				}
 
 				if (++i == count)
@@ -483,12 +492,10 @@ static void drc_delay_input_sample_s16(struct drc_state *state,
 				       struct audio_stream *sink,
 				       int16_t **x, int16_t **y, int samples)
 {
-	int16_t *x1;
-	int16_t *y1;
-	int16_t *pd;
-	int pd_write_index, pd_read_index;
+	int16_t *pd = (int16_t *)state->pre_delay_buffer;
+	int16_t *pd_write;
+	int16_t *pd_read;
 	int nbuf, npcm, nfrm;
-	int ch;
 	int i;
 	int16_t *x0 = *x;
 	int16_t *y0 = *y;
@@ -500,21 +507,19 @@ static void drc_delay_input_sample_s16(struct drc_state *state,
 		npcm = MIN(remaining_samples, nbuf);
 		nbuf = audio_stream_samples_without_wrap_s16(sink, y0);
 		npcm = MIN(npcm, nbuf);
+
+		/* The frames are interleaved in the pre-delay buffer as well, so a block
+		 * that wraps none of the buffers is one linear pass.
+		 */
 		nfrm = npcm / nch;
-		for (ch = 0; ch < nch; ++ch) {
-			pd = (int16_t *)state->pre_delay_buffers[ch];
-			x1 = x0 + ch;
-			y1 = y0 + ch;
-			pd_write_index = state->pre_delay_write_index;
-			pd_read_index = state->pre_delay_read_index;
-			for (i = 0; i < nfrm; i++) {
-				*(pd + pd_write_index) = *x1;
-				*y1 = *(pd + pd_read_index);
-				drc_pre_delay_index_inc(&pd_write_index, 1);
-				drc_pre_delay_index_inc(&pd_read_index, 1);
-				x1 += nch;
-				y1 += nch;
-			}
+		nfrm = MIN(nfrm, CONFIG_DRC_MAX_PRE_DELAY_FRAMES - state->pre_delay_write_index);
+		nfrm = MIN(nfrm, CONFIG_DRC_MAX_PRE_DELAY_FRAMES - state->pre_delay_read_index);
+		npcm = nfrm * nch;
+		pd_write = pd + state->pre_delay_write_index * nch;
+		pd_read = pd + state->pre_delay_read_index * nch;
+		for (i = 0; i < npcm; i++) {
+			pd_write[i] = x0[i];
+			y0[i] = pd_read[i];
 		}
 		remaining_samples -= npcm;
 		x0 = audio_stream_wrap(source, x0 + npcm);
@@ -578,12 +583,10 @@ static void drc_delay_input_sample_s32(struct drc_state *state,
 				       struct audio_stream *sink,
 				       int32_t **x, int32_t **y, int samples)
 {
-	int32_t *x1;
-	int32_t *y1;
-	int32_t *pd;
-	int pd_write_index, pd_read_index;
+	int32_t *pd = (int32_t *)state->pre_delay_buffer;
+	int32_t *pd_write;
+	int32_t *pd_read;
 	int nbuf, npcm, nfrm;
-	int ch;
 	int i;
 	int32_t *x0 = *x;
 	int32_t *y0 = *y;
@@ -595,21 +598,19 @@ static void drc_delay_input_sample_s32(struct drc_state *state,
 		npcm = MIN(remaining_samples, nbuf);
 		nbuf = audio_stream_samples_without_wrap_s32(sink, y0);
 		npcm = MIN(npcm, nbuf);
+
+		/* The frames are interleaved in the pre-delay buffer as well, so a block
+		 * that wraps none of the buffers is one linear pass.
+		 */
 		nfrm = npcm / nch;
-		for (ch = 0; ch < nch; ++ch) {
-			pd = (int32_t *)state->pre_delay_buffers[ch];
-			x1 = x0 + ch;
-			y1 = y0 + ch;
-			pd_write_index = state->pre_delay_write_index;
-			pd_read_index = state->pre_delay_read_index;
-			for (i = 0; i < nfrm; i++) {
-				*(pd + pd_write_index) = *x1;
-				*y1 = *(pd + pd_read_index);
-				drc_pre_delay_index_inc(&pd_write_index, 1);
-				drc_pre_delay_index_inc(&pd_read_index, 1);
-				x1 += nch;
-				y1 += nch;
-			}
+		nfrm = MIN(nfrm, CONFIG_DRC_MAX_PRE_DELAY_FRAMES - state->pre_delay_write_index);
+		nfrm = MIN(nfrm, CONFIG_DRC_MAX_PRE_DELAY_FRAMES - state->pre_delay_read_index);
+		npcm = nfrm * nch;
+		pd_write = pd + state->pre_delay_write_index * nch;
+		pd_read = pd + state->pre_delay_read_index * nch;
+		for (i = 0; i < npcm; i++) {
+			pd_write[i] = x0[i];
+			y0[i] = pd_read[i];
 		}
 		remaining_samples -= npcm;
 		x0 = audio_stream_wrap(source, x0 + npcm);
@@ -629,12 +630,10 @@ static void drc_delay_input_sample_s24(struct drc_state *state,
 				       struct audio_stream *sink,
 				       int32_t **x, int32_t **y, int samples)
 {
-	int32_t *x1;
-	int32_t *y1;
-	int32_t *pd;
-	int pd_write_index, pd_read_index;
+	int32_t *pd = (int32_t *)state->pre_delay_buffer;
+	int32_t *pd_write;
+	int32_t *pd_read;
 	int nbuf, npcm, nfrm;
-	int ch;
 	int i;
 	int32_t *x0 = *x;
 	int32_t *y0 = *y;
@@ -646,21 +645,19 @@ static void drc_delay_input_sample_s24(struct drc_state *state,
 		npcm = MIN(remaining_samples, nbuf);
 		nbuf = audio_stream_samples_without_wrap_s24(sink, y0);
 		npcm = MIN(npcm, nbuf);
+
+		/* The frames are interleaved in the pre-delay buffer as well, so a block
+		 * that wraps none of the buffers is one linear pass.
+		 */
 		nfrm = npcm / nch;
-		for (ch = 0; ch < nch; ++ch) {
-			pd = (int32_t *)state->pre_delay_buffers[ch];
-			x1 = x0 + ch;
-			y1 = y0 + ch;
-			pd_write_index = state->pre_delay_write_index;
-			pd_read_index = state->pre_delay_read_index;
-			for (i = 0; i < nfrm; i++) {
-				*(pd + pd_write_index) = *x1 << 8;
-				*y1 = sat_int24(Q_SHIFT_RND(*(pd + pd_read_index), 31, 23));
-				drc_pre_delay_index_inc(&pd_write_index, 1);
-				drc_pre_delay_index_inc(&pd_read_index, 1);
-				x1 += nch;
-				y1 += nch;
-			}
+		nfrm = MIN(nfrm, CONFIG_DRC_MAX_PRE_DELAY_FRAMES - state->pre_delay_write_index);
+		nfrm = MIN(nfrm, CONFIG_DRC_MAX_PRE_DELAY_FRAMES - state->pre_delay_read_index);
+		npcm = nfrm * nch;
+		pd_write = pd + state->pre_delay_write_index * nch;
+		pd_read = pd + state->pre_delay_read_index * nch;
+		for (i = 0; i < npcm; i++) {
+			pd_write[i] = x0[i] << 8;
+			y0[i] = sat_int24(Q_SHIFT_RND(pd_read[i], 31, 23));
 		}
 		remaining_samples -= npcm;
 		x0 = audio_stream_wrap(source, x0 + npcm);
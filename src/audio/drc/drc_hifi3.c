@@ -84,6 +84,19 @@ static int32_t volume_gain(const struct sof_drc_params *p, int32_t x)
 	return y;
 }
 
+#if CONFIG_DRC_GAIN_CURVE_TABLE
+/* Samples the compression curve at the levels of drc_gain_table_lookup(). */
+void drc_init_gain_table(struct drc_state *state, const struct sof_drc_params *p)
+{
+	int i;
+
+	for (i = 0; i < DRC_GAIN_TABLE_SIZE - 1; i++)
+		state->gain_table[i] = volume_gain(p, drc_gain_table_level(i));
+
+	state->gain_table[i] = volume_gain(p, INT32_MAX);
+}
+#endif /* CONFIG_DRC_GAIN_CURVE_TABLE */
+
 /* Update detector_average from the last input division. */
 void drc_update_detector_average(struct drc_state *state,
 				 const struct sof_drc_params *p,
@@ -92,11 +105,14 @@ void drc_update_detector_average(struct drc_state *state,
 {
 	ae_f32 detector_average = state->detector_average; /* Q2.30 */
 	int32_t abs_input_array[DRC_DIVISION_FRAMES]; /* Q1.31 */
-	int32_t *abs_input_array_p;
 	int div_start, i, ch;
 	int16_t *sample16_p; /* for s16 format case */
 	int32_t *sample32_p; /* for s24 and s32 format cases */
 	int32_t sample;
+	ae_int32x2 *in;
+	ae_int32x2 pair;
+	ae_int32x2 peak;
+	ae_valign align;
 	ae_f32 gain;
 	ae_f32 gain_diff;
 	ae_f32 db_per_frame;
@@ -110,29 +126,40 @@ void drc_update_detector_average(struct drc_state *state,
 	else
 		div_start = state->pre_delay_write_index - DRC_DIVISION_FRAMES;
 
-	/* The max abs value across all channels for this frame */
-	memset(abs_input_array, 0, DRC_DIVISION_FRAMES * sizeof(int32_t));
+	/* The max abs value across all channels for this frame, the channels of
+	 * a frame are adjacent in the pre-delay buffer so the 32 bit samples are
+	 * compared in pairs.
+	 */
 	if (nbyte == 2) { /* 2 bytes per sample */
-		for (ch = 0; ch < nch; ch++) {
-			abs_input_array_p = abs_input_array;
-			sample16_p = (int16_t *)state->pre_delay_buffers[ch] + div_start;
-			for (i = 0; i < DRC_DIVISION_FRAMES; i++) {
+		sample16_p = (int16_t *)state->pre_delay_buffer + div_start * nch;
+		for (i = 0; i < DRC_DIVISION_FRAMES; i++) {
+			abs_input_array[i] = 0;
+			for (ch = 0; ch < nch; ch++) {
 				sample = (int32_t)*sample16_p << 16;
-				*abs_input_array_p = MAX(*abs_input_array_p, ABS(sample));
-				abs_input_array_p++;
+				abs_input_array[i] = MAX(abs_input_array[i], ABS(sample));
 				sample16_p++;
 			}
 		}
 	} else { /* 4 bytes per sample */
-		for (ch = 0; ch < nch; ch++) {
-			abs_input_array_p = abs_input_array;
-			sample32_p = (int32_t *)state->pre_delay_buffers[ch] + div_start;
-			for (i = 0; i < DRC_DIVISION_FRAMES; i++) {
-				sample = *sample32_p;
-				*abs_input_array_p = MAX(*abs_input_array_p, ABS(sample));
-				abs_input_array_p++;
-				sample32_p++;
+		sample32_p = (int32_t *)state->pre_delay_buffer + div_start * nch;
+		for (i = 0; i < DRC_DIVISION_FRAMES; i++) {
+			in = (ae_int32x2 *)sample32_p;
+			align = AE_LA64_PP(in);
+			peak = AE_ZERO32();
+			for (ch = 0; ch < nch - 1; ch += 2) {
+				AE_LA32X2_IP(pair, align, in);
+				peak = AE_MAX32(peak, AE_ABS32S(pair));
+			}
+
+			/* the last sample of an odd channels count goes to both lanes */
+			if (ch < nch) {
+				pair = AE_MOVDA32(sample32_p[ch]);
+				peak = AE_MAX32(peak, AE_ABS32S(pair));
 			}
+
+			peak = AE_MAX32(peak, AE_SEL32_LH(peak, peak));
+			abs_input_array[i] = AE_MOVAD32_H(peak);
+			sample32_p += nch;
 		}
 	}
 
@@ -146,7 +173,11 @@ void drc_update_detector_average(struct drc_state *state,
 		 * derivative matched). The transition from the knee to the
 		 * ratio portion is smooth (1st derivative matched).
 		 */
+#if CONFIG_DRC_GAIN_CURVE_TABLE
+		gain = drc_gain_table_lookup(state, abs_input_array[i]); /* Q2.30 */
+#else
 		gain = volume_gain(p, abs_input_array[i]); /* Q2.30 */
+#endif
 		gain_diff = AE_SUB32(gain, detector_average); /* Q2.30 */
 		is_release = ((int32_t)gain_diff > 0);
 		if (is_release) {
@@ -301,7 +332,7 @@ void drc_compress_output(struct drc_state *state,
 	ae_f32 total_gain;
 	ae_f32 tmp;
 
-	int i, j, ch, inc;
+	int i, j, ch;
 	int16_t *sample16_p; /* for s16 format case */
 	int32_t *sample32_p; /* for s24 and s32 format cases */
 	int32_t sample;
@@ -322,8 +353,8 @@ void drc_compress_output(struct drc_state *state,
 		r4 = drc_mult_lshift(r2, r2, lshift);
 
 		i = 0;
-		inc = 0;
 		if (is_2byte) { /* 2 bytes per sample */
+			sample16_p = (int16_t *)state->pre_delay_buffer + div_start * nch;
 			while (1) {
 				for (j = 0; j < 4; j++) {
 					/* Warp pre-compression gain to smooth out sharp
@@ -341,15 +372,12 @@ void drc_compress_output(struct drc_state *state,
 					/* Apply final gain. */
 					lshift = drc_get_lshift(15, 24, 15);
 					for (ch = 0; ch < nch; ch++) {
-						sample16_p =
-							(int16_t *)state->pre_delay_buffers[ch] +
-								div_start + inc;
 						sample = (int32_t)*sample16_p;
 						sample = drc_mult_lshift(sample, total_gain,
 									 lshift);
 						*sample16_p = sat_int16(sample);
+						sample16_p++;
 					}
-					inc++;
 				}
 
 				if (++i == count)
@@ -360,6 +388,7 @@ void drc_compress_output(struct drc_state *state,
 					x[j] = drc_mult_lshift(x[j], r4, lshift);
 			}
 		} else { /* 4 bytes per sample */
+			sample32_p = (int32_t *)state->pre_delay_buffer + div_start * nch;
 			while (1) {
 				for (j = 0; j < 4; j++) {
 					/* Warp pre-compression gain to smooth out sharp
@@ -377,15 +406,12 @@ void drc_compress_output(struct drc_state *state,
 					/* Apply final gain. */
 					lshift = drc_get_lshift(31, 24, 31);
 					for (ch = 0; ch < nch; ch++) {
-						sample32_p =
-							(int32_t *)state->pre_delay_buffers[ch] +
-								div_start + inc;
 						sample = *sample32_p;
 						sample = drc_mult_lshift(sample, total_gain,
 									 lshift);
 						*sample32_p = sample;
+						sample32_p++;
 					}
-					inc++;
 				}
 
 				if (++i == count)
@@ -411,8 +437,8 @@ void drc_compress_output(struct drc_state *state,
 		r4 = drc_mult_lshift(r2, r2, lshift);
 
 		i = 0;
-		inc = 0;
 		if (is_2byte) { /* 2 bytes per sample */
+			sample16_p = (int16_t *)state->pre_delay_buffer + div_start * nch;
 			while (1) {
 				for (j = 0; j < 4; j++) {
 					/* Warp pre-compression gain to smooth out sharp
@@ -429,15 +455,12 @@ void drc_compress_output(struct drc_state *state,
 					/* Apply final gain. */
 					lshift = drc_get_lshift(15, 24, 15);
 					for (ch = 0; ch < nch; ch++) {
-						sample16_p =
-							(int16_t *)state->pre_delay_buffers[ch] +
-								div_start + inc;
 						sample = (int32_t)*sample16_p;
 						sample = drc_mult_lshift(sample, total_gain,
 									 lshift);
 						*sample16_p = sat_int16(sample);
+						sample16_p++;
 					}
-					inc++;
 				}
 
 				if (++i == count)
@@ -450,6 +473,7 @@ void drc_compress_output(struct drc_state *state,
 				}
 			}
 		} else { /* 4 bytes per sample */
+			sample32_p = (int32_t *)state->pre_delay_buffer + div_start * nch;
 			while (1) {
 				for (j = 0; j < 4; j++) {
 					/* Warp pre-compression gain to smooth out sharp
@@ -466,15 +490,12 @@ void drc_compress_output(struct drc_state *state,
 					/* Apply final gain. */
 					lshift = drc_get_lshift(31, 24, 31);
 					for (ch = 0; ch < nch; ch++) {
-						sample32_p =
-							(int32_t *)state->pre_delay_buffers[ch] +
-								div_start + inc;
 						sample = *sample32_p;
 						sample = drc_mult_lshift(sample, total_gain,
 									 lshift);
 						*sample32_p = sample;
+						sample32_p++;
 					}
-					inc++;
 				}
 
 				if (++i == count)
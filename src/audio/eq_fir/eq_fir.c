@@ -74,6 +74,10 @@ static void eq_fir_free_delaylines(struct comp_data *cd)
 	cd->fir_delay_size = 0;
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		fir[i].delay = NULL;
+
+#if CONFIG_COMP_FIR_PARTITIONED
+	eq_fir_fft_free(cd);
+#endif
 }
 
 static int eq_fir_init_coef(struct comp_dev *dev, struct sof_eq_fir_config *config,
@@ -84,6 +88,9 @@ static int eq_fir_init_coef(struct comp_dev *dev, struct sof_eq_fir_config *conf
 	int16_t *assign_response;
 	int16_t *coef_data;
 	size_t size_sum = 0;
+#if CONFIG_COMP_FIR_PARTITIONED
+	bool partitioned;
+#endif
 	int resp = 0;
 	int i;
 	int j;
@@ -117,6 +124,13 @@ static int eq_fir_init_coef(struct comp_dev *dev, struct sof_eq_fir_config *conf
 		return -EINVAL;
 	}
 
+#if CONFIG_COMP_FIR_PARTITIONED
+	/* Long responses are filtered in frequency domain, the FIR states are
+	 * not used then.
+	 */
+	partitioned = eq_fir_fft_select(config);
+#endif
+
 	/* Collect index of response start positions in all_coefficients[]  */
 	j = 0;
 	assign_response = ASSUME_ALIGNED(&config->data[0], 4);
@@ -162,6 +176,16 @@ static int eq_fir_init_coef(struct comp_dev *dev, struct sof_eq_fir_config *conf
 
 		/* Initialize EQ coefficients. */
 		eq = lookup[resp];
+#if CONFIG_COMP_FIR_PARTITIONED
+		if (partitioned) {
+			if (eq_fir_fft_check_length(eq) < 0) {
+				comp_err(dev, "eq_fir_init_coef(), FIR length %d is invalid",
+					 eq->length);
+				return -EINVAL;
+			}
+			continue;
+		}
+#endif
 		s = fir_delay_size(eq);
 		if (s > 0) {
 			size_sum += s;
@@ -203,10 +227,17 @@ static void eq_fir_init_delay(struct fir_state_32x16 *fir,
 
 static int eq_fir_setup(struct comp_dev *dev, struct comp_data *cd, int nch)
 {
+#if CONFIG_MODULE_SILENCE_SKIP
+	struct processing_module *mod = comp_get_drvdata(dev);
+	int i;
+#endif
 	int delay_size;
 
 	/* Free existing FIR channels data if it was allocated */
 	eq_fir_free_delaylines(cd);
+#if CONFIG_MODULE_SILENCE_SKIP
+	mod->silence_tail_frames = 0;
+#endif
 
 	/* Update number of channels */
 	cd->nch = nch;
@@ -216,6 +247,11 @@ static int eq_fir_setup(struct comp_dev *dev, struct comp_data *cd, int nch)
 	if (delay_size < 0)
 		return delay_size; /* Contains error code */
 
+#if CONFIG_COMP_FIR_PARTITIONED
+	if (eq_fir_fft_select(cd->config))
+		return eq_fir_fft_setup(dev, cd, nch);
+#endif
+
 	/* If all channels were set to bypass there's no need to
 	 * allocate delay. Just return with success.
 	 */
@@ -234,9 +270,62 @@ static int eq_fir_setup(struct comp_dev *dev, struct comp_data *cd, int nch)
 
 	/* Assign delay line to each channel EQ */
 	eq_fir_init_delay(cd->fir, cd->fir_delay, nch);
+
+#if CONFIG_MODULE_SILENCE_SKIP
+	/* the delay lines hold only zeros after the longest filter of silence */
+	for (i = 0; i < nch; i++)
+		mod->silence_tail_frames = MAX(mod->silence_tail_frames, cd->fir[i].taps);
+#endif
 	return 0;
 }
 
+/*
+ * A delta update within the coefficients of one response leaves the blob
+ * layout unchanged. The filters then switch to the new coefficients keeping
+ * their delay lines. The partitioned filters keep the coefficient spectra
+ * and need the full setup.
+ */
+static bool eq_fir_delta_in_place(struct comp_data *cd)
+{
+	struct sof_fir_coef_data *eq;
+	int16_t *coef_data;
+	uint32_t offset;
+	uint32_t size;
+	int i;
+	int j = 0;
+
+	if (!cd->config || !comp_data_blob_get_delta(cd->model_handler, &offset, &size))
+		return false;
+
+#if CONFIG_COMP_FIR_PARTITIONED
+	if (cd->fft)
+		return false;
+#endif
+
+	coef_data = ASSUME_ALIGNED(&cd->config->data[cd->config->channels_in_config], 4);
+	for (i = 0; i < cd->config->number_of_responses; i++) {
+		eq = (struct sof_fir_coef_data *)&coef_data[j];
+		if (comp_data_blob_delta_within(offset, size, cd->config, eq->coef,
+						eq->length * sizeof(int16_t)))
+			return true;
+
+		j += SOF_FIR_COEF_NHEADER + eq->length;
+	}
+
+	return false;
+}
+
+static void eq_fir_rebase(struct comp_data *cd, void *old_config)
+{
+	int i;
+
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
+		if (cd->fir[i].coef)
+			cd->fir[i].coef = comp_data_blob_rebase(cd->fir[i].coef, old_config,
+								cd->config);
+	}
+}
+
 static int eq_fir_validator(struct comp_dev *dev, void *new_data, uint32_t new_data_size)
 {
 	return eq_fir_init_coef(dev, new_data, NULL, -1);
@@ -261,8 +350,8 @@ static int eq_fir_init(struct processing_module *mod)
 	/* Check first before proceeding with dev and cd that coefficients
 	 * blob size is sane.
 	 */
-	if (bs > SOF_EQ_FIR_MAX_SIZE) {
-		comp_err(dev, "eq_fir_init(): coefficients blob size = %u > SOF_EQ_FIR_MAX_SIZE",
+	if (bs > EQ_FIR_MAX_BLOB_SIZE) {
+		comp_err(dev, "eq_fir_init(): coefficients blob size = %u > EQ_FIR_MAX_BLOB_SIZE",
 			 bs);
 		return -EINVAL;
 	}
@@ -284,6 +373,10 @@ static int eq_fir_init(struct processing_module *mod)
 		goto err;
 	}
 
+	/* identical configurations of other instances use the same blob */
+	comp_data_blob_set_shared(cd->model_handler);
+	comp_data_blob_set_delta(cd->model_handler);
+
 	md->private = cd;
 
 	/* Allocate and make a copy of the coefficients blob and reset FIR. If
@@ -355,18 +448,27 @@ static int eq_fir_process(struct processing_module *mod,
 {
 	struct comp_data *cd = module_get_private_data(mod);
 	struct audio_stream *source = input_buffers[0].data;
+	struct sof_eq_fir_config *old_config;
 	uint32_t frame_count = input_buffers[0].size;
 	int ret;
 
 	comp_dbg(mod->dev, "eq_fir_process()");
 
 	/* Check for changed configuration */
-	if (comp_is_new_data_blob_available(cd->model_handler)) {
+	if (comp_is_new_data_blob_available(cd->model_handler) && eq_fir_delta_in_place(cd)) {
+		old_config = cd->config;
+		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+		eq_fir_rebase(cd, old_config);
+	} else if (comp_is_new_data_blob_available(cd->model_handler)) {
 		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
 		ret = eq_fir_setup(mod->dev, cd, audio_stream_get_channels(source));
 		if (ret < 0) {
 			comp_err(mod->dev, "eq_fir_process(), failed FIR setup");
 			return ret;
+#if CONFIG_COMP_FIR_PARTITIONED
+		} else if (cd->fft) {
+			comp_dbg(mod->dev, "eq_fir_process(), partitioned");
+#endif
 		} else if (cd->fir_delay_size) {
 			comp_dbg(mod->dev, "eq_fir_process(), active");
 			ret = set_fir_func(mod, audio_stream_get_frm_fmt(source));
@@ -374,6 +476,7 @@ static int eq_fir_process(struct processing_module *mod,
 				return ret;
 		} else {
 			cd->eq_fir_func = eq_fir_passthrough;
+			mod->bypass = true;
 			comp_dbg(mod->dev, "eq_fir_process(), pass-through");
 		}
 	}
@@ -389,7 +492,14 @@ static int eq_fir_process(struct processing_module *mod,
 
 	frame_count &= ~0x1;
 	if (frame_count) {
-		cd->eq_fir_func(cd->fir, &input_buffers[0], &output_buffers[0], frame_count);
+#if CONFIG_COMP_FIR_PARTITIONED
+		if (cd->fft)
+			eq_fir_fft_process(cd->fft, &input_buffers[0], &output_buffers[0],
+					   frame_count);
+		else
+#endif
+			cd->eq_fir_func(cd->fir, &input_buffers[0], &output_buffers[0],
+					frame_count);
 		module_update_buffer_position(&input_buffers[0], &output_buffers[0], frame_count);
 	}
 
@@ -438,12 +548,21 @@ static int eq_fir_prepare(struct processing_module *mod,
 		ret = eq_fir_setup(dev, cd, channels);
 		if (ret < 0)
 			comp_err(dev, "eq_fir_prepare(): eq_fir_setup failed.");
+#if CONFIG_COMP_FIR_PARTITIONED
+		else if (cd->fft)
+			comp_dbg(dev, "eq_fir_prepare(): partitioned");
+#endif
 		else if (cd->fir_delay_size)
 			ret = set_fir_func(mod, frame_fmt);
 		else
-			comp_dbg(dev, "eq_fir_prepare(): pass-through");
+			mod->bypass = true;
+	} else {
+		mod->bypass = true;
 	}
 
+	if (mod->bypass)
+		comp_dbg(dev, "eq_fir_prepare(): pass-through");
+
 	if (ret < 0)
 		comp_set_state(dev, COMP_TRIGGER_RESET);
 
@@ -21,6 +21,10 @@
 #if FIR_HIFI3
 #include <sof/math/fir_hifi3.h>
 #endif
+#if CONFIG_COMP_FIR_PARTITIONED
+#include <sof/math/fft.h>
+#endif
+#include <user/eq.h>
 #include <user/fir.h>
 #include <stdint.h>
 
@@ -28,6 +32,46 @@
 #define EQ_FIR_BYTES_TO_S16_SAMPLES(b)	((b) >> 1)
 #define EQ_FIR_BYTES_TO_S32_SAMPLES(b)	((b) >> 2)
 
+#if CONFIG_COMP_FIR_PARTITIONED
+/** \brief Blob size limit, allows for the long responses */
+#define EQ_FIR_MAX_BLOB_SIZE	(SOF_EQ_FIR_MAX_SIZE + SOF_EQ_FIR_MAX_RESPONSES * \
+				 CONFIG_COMP_FIR_PARTITIONED_MAX_LENGTH * sizeof(int16_t))
+
+/** \brief Partition length, FFT length and number of stored spectrum bins */
+#define EQ_FIR_FFT_BLOCK	CONFIG_COMP_FIR_PARTITION_SIZE
+#define EQ_FIR_FFT_SIZE		(2 * EQ_FIR_FFT_BLOCK)
+#define EQ_FIR_FFT_BINS		(EQ_FIR_FFT_BLOCK + 1)
+
+/* coefficient spectra of one response, shared by the channels using it */
+struct eq_fir_fft_resp {
+	struct icomplex32 *spectra;	/**< num_part x EQ_FIR_FFT_BINS, H * 2^-exp */
+	int num_part;			/**< number of partitions */
+	int exp;			/**< exponent of the spectra */
+	int out_shift;			/**< amount of right shifts at output */
+};
+
+/* per channel overlap-save state */
+struct eq_fir_fft_channel {
+	struct eq_fir_fft_resp *resp;	/**< NULL for bypass */
+	struct icomplex32 *fdl;		/**< frequency delay line of input spectra */
+	int fdl_head;			/**< index of the newest input spectrum */
+	int32_t *in;			/**< previous and current input block */
+	int32_t *out;			/**< output block, one partition behind */
+};
+
+struct eq_fir_fft {
+	struct fft_real_plan *plan;
+	int32_t *time;			/**< EQ_FIR_FFT_SIZE samples work buffer */
+	struct icomplex32 *spec;	/**< EQ_FIR_FFT_BINS bins work buffer */
+	struct eq_fir_fft_resp resp[SOF_EQ_FIR_MAX_RESPONSES];
+	struct eq_fir_fft_channel ch[PLATFORM_MAX_CHANNELS];
+	int fill;			/**< samples in the current block */
+	int nch;
+};
+#else
+#define EQ_FIR_MAX_BLOB_SIZE	SOF_EQ_FIR_MAX_SIZE
+#endif /* CONFIG_COMP_FIR_PARTITIONED */
+
 /* fir component private data */
 struct comp_data {
 	struct fir_state_32x16 fir[PLATFORM_MAX_CHANNELS]; /**< filters state */
@@ -35,6 +79,9 @@ struct comp_data {
 	struct sof_eq_fir_config *config;
 	int32_t *fir_delay;			/**< pointer to allocated RAM */
 	size_t fir_delay_size;			/**< allocated size */
+#if CONFIG_COMP_FIR_PARTITIONED
+	struct eq_fir_fft *fft;			/**< partitioned convolution, if active */
+#endif
 	void (*eq_fir_func)(struct fir_state_32x16 fir[],
 			    struct input_stream_buffer *bsource,
 			    struct output_stream_buffer *bsink,
@@ -68,6 +115,19 @@ void eq_fir_2x_s32(struct fir_state_32x16 *fir, struct input_stream_buffer *bsou
 
 int set_fir_func(struct processing_module *mod, enum sof_ipc_frame fmt);
 
+#if CONFIG_COMP_FIR_PARTITIONED
+bool eq_fir_fft_select(struct sof_eq_fir_config *config);
+
+int eq_fir_fft_check_length(struct sof_fir_coef_data *coef);
+
+int eq_fir_fft_setup(struct comp_dev *dev, struct comp_data *cd, int nch);
+
+void eq_fir_fft_free(struct comp_data *cd);
+
+int eq_fir_fft_process(struct eq_fir_fft *fft, struct input_stream_buffer *bsource,
+		       struct output_stream_buffer *bsink, int frames);
+#endif /* CONFIG_COMP_FIR_PARTITIONED */
+
 int eq_fir_params(struct processing_module *mod);
 
 /*
@@ -0,0 +1,357 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/module_adapter/module/generic.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/fft.h>
+#include <sof/math/numbers.h>
+#include <rtos/alloc.h>
+#include <rtos/string.h>
+#include <ipc/stream.h>
+#include <ipc/topology.h>
+#include <user/eq.h>
+#include <user/fir.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "eq_fir.h"
+
+LOG_MODULE_DECLARE(eq_fir, CONFIG_SOF_LOG_LEVEL);
+
+/*
+ * Uniformly partitioned overlap-save convolution. A response of L taps is
+ * split into P = L / B partitions of B taps. Each partition is transformed
+ * with a 2B point FFT once in setup. For each block of B input samples the
+ * spectrum of the last 2B input samples is pushed to a frequency delay line
+ * and the output spectrum is the sum of the P products of delayed input
+ * spectra and partition spectra. The second half of its IFFT is the output
+ * block. The output is delayed by B samples.
+ *
+ * Spectra are kept in the FFT library scale, i.e. divided by the FFT size,
+ * and only the bins 0 to B of the real signals are stored.
+ */
+
+STATIC_ASSERT(!(EQ_FIR_FFT_BLOCK & (EQ_FIR_FFT_BLOCK - 1)), eq_fir_partition_not_power_of_two);
+STATIC_ASSERT(EQ_FIR_FFT_SIZE <= FFT_SIZE_MAX, eq_fir_partition_exceeds_fft_size);
+
+static void eq_fir_fft_lookup(struct sof_eq_fir_config *config,
+			      struct sof_fir_coef_data *lookup[])
+{
+	int16_t *coef_data = ASSUME_ALIGNED(&config->data[config->channels_in_config], 4);
+	int i;
+	int j = 0;
+
+	for (i = 0; i < config->number_of_responses; i++) {
+		lookup[i] = (struct sof_fir_coef_data *)&coef_data[j];
+		j += SOF_FIR_COEF_NHEADER + coef_data[j];
+	}
+}
+
+bool eq_fir_fft_select(struct sof_eq_fir_config *config)
+{
+	struct sof_fir_coef_data *lookup[SOF_EQ_FIR_MAX_RESPONSES];
+	int i;
+
+	if (config->number_of_responses > SOF_EQ_FIR_MAX_RESPONSES ||
+	    config->channels_in_config > PLATFORM_MAX_CHANNELS)
+		return false;
+
+	eq_fir_fft_lookup(config, lookup);
+	for (i = 0; i < config->number_of_responses; i++) {
+		if (lookup[i]->length > CONFIG_COMP_FIR_PARTITIONED_THRESHOLD)
+			return true;
+	}
+
+	return false;
+}
+
+int eq_fir_fft_check_length(struct sof_fir_coef_data *coef)
+{
+	if (coef->length < 1 || coef->length > CONFIG_COMP_FIR_PARTITIONED_MAX_LENGTH)
+		return -EINVAL;
+
+	return 0;
+}
+
+static int eq_fir_fft_init_resp(struct eq_fir_fft *fft, struct eq_fir_fft_resp *resp,
+				struct sof_fir_coef_data *coef)
+{
+	struct icomplex32 *h;
+	int32_t peak = 0;
+	int shift;
+	int n;
+	int p;
+	int i;
+
+	resp->num_part = SOF_DIV_ROUND_UP(coef->length, EQ_FIR_FFT_BLOCK);
+	resp->out_shift = coef->out_shift;
+	resp->spectra = rballoc(0, SOF_MEM_CAPS_RAM, resp->num_part * EQ_FIR_FFT_BINS *
+				sizeof(struct icomplex32));
+	if (!resp->spectra)
+		return -ENOMEM;
+
+	for (p = 0; p < resp->num_part; p++) {
+		n = MIN(EQ_FIR_FFT_BLOCK, coef->length - p * EQ_FIR_FFT_BLOCK);
+		bzero(fft->time, EQ_FIR_FFT_SIZE * sizeof(int32_t));
+		for (i = 0; i < n; i++)
+			fft->time[i] = (int32_t)coef->coef[p * EQ_FIR_FFT_BLOCK + i] << 16;
+
+		h = &resp->spectra[p * EQ_FIR_FFT_BINS];
+		fft_real_execute_32(fft->plan, fft->time, h);
+		for (i = 0; i < EQ_FIR_FFT_BINS; i++)
+			peak |= ABS(h[i].real) | ABS(h[i].imag);
+	}
+
+	/* Normalize all partitions with a common exponent, the spectra are
+	 * then H * 2^-exp in Q1.31.
+	 */
+	shift = peak ? norm_int32(peak) : 0;
+	for (i = 0; i < resp->num_part * EQ_FIR_FFT_BINS; i++) {
+		resp->spectra[i].real <<= shift;
+		resp->spectra[i].imag <<= shift;
+	}
+
+	resp->exp = fft->plan->len - shift;
+	return 0;
+}
+
+static inline int32_t eq_fir_fft_scale(int64_t x, int shift)
+{
+	x = shift > 0 ? x << shift : x >> -shift;
+
+	/* symmetric range, the negated value is used for the mirrored bins */
+	return (int32_t)MAX(MIN(x, (int64_t)INT32_MAX), (int64_t)-INT32_MAX);
+}
+
+/* filter one block of a channel, the input block is complete */
+static void eq_fir_fft_block(struct eq_fir_fft *fft, struct eq_fir_fft_channel *ch)
+{
+	struct eq_fir_fft_resp *resp = ch->resp;
+	struct icomplex32 *buf = fft->spec;
+	struct icomplex32 *x;
+	struct icomplex32 *h;
+	int64_t re;
+	int64_t im;
+	int shift;
+	int part;
+	int p;
+	int k;
+
+	if (!resp) {
+		/* bypass keeps the latency of the filtered channels */
+		memcpy_s(ch->out, EQ_FIR_FFT_BLOCK * sizeof(int32_t),
+			 &ch->in[EQ_FIR_FFT_BLOCK], EQ_FIR_FFT_BLOCK * sizeof(int32_t));
+		goto slide;
+	}
+
+	/* newest input spectrum goes to the head of the frequency delay line */
+	ch->fdl_head = ch->fdl_head ? ch->fdl_head - 1 : resp->num_part - 1;
+	fft_real_execute_32(fft->plan, ch->in, &ch->fdl[ch->fdl_head * EQ_FIR_FFT_BINS]);
+
+	/* Q1.31 x Q1.31 products summed in Q33.31, the spectrum exponent and the
+	 * response output shift are applied at once.
+	 */
+	shift = resp->exp - resp->out_shift;
+	for (k = 0; k < EQ_FIR_FFT_BINS; k++) {
+		re = 0;
+		im = 0;
+		part = ch->fdl_head;
+		h = &resp->spectra[k];
+		for (p = 0; p < resp->num_part; p++) {
+			x = &ch->fdl[part * EQ_FIR_FFT_BINS + k];
+			re += ((int64_t)x->real * h->real >> 31) - ((int64_t)x->imag * h->imag >> 31);
+			im += ((int64_t)x->real * h->imag >> 31) + ((int64_t)x->imag * h->real >> 31);
+			h += EQ_FIR_FFT_BINS;
+			if (++part == resp->num_part)
+				part = 0;
+		}
+
+		buf[k].real = eq_fir_fft_scale(re, shift);
+		buf[k].imag = eq_fir_fft_scale(im, shift);
+	}
+
+	/* the DC and Nyquist bins of a real signal are real */
+	buf[0].imag = 0;
+	buf[EQ_FIR_FFT_BLOCK].imag = 0;
+	fft_real_inverse_32(fft->plan, buf, fft->time);
+
+	/* the first half is circular convolution wrap, overlap-save drops it */
+	memcpy_s(ch->out, EQ_FIR_FFT_BLOCK * sizeof(int32_t),
+		 &fft->time[EQ_FIR_FFT_BLOCK], EQ_FIR_FFT_BLOCK * sizeof(int32_t));
+
+slide:
+	memcpy_s(ch->in, EQ_FIR_FFT_BLOCK * sizeof(int32_t),
+		 &ch->in[EQ_FIR_FFT_BLOCK], EQ_FIR_FFT_BLOCK * sizeof(int32_t));
+}
+
+static inline int32_t eq_fir_fft_read(enum sof_ipc_frame fmt, const void *x)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return (int32_t)*(const int16_t *)x << 16;
+	case SOF_IPC_FRAME_S24_4LE:
+		return sign_extend_s24(*(const int32_t *)x) << 8;
+	default:
+		return *(const int32_t *)x;
+	}
+}
+
+static inline void eq_fir_fft_write(enum sof_ipc_frame fmt, void *y, int32_t z)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		*(int16_t *)y = sat_int16(Q_SHIFT_RND(z, 31, 15));
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		*(int32_t *)y = sat_int24(Q_SHIFT_RND(z, 31, 23));
+		break;
+	default:
+		*(int32_t *)y = z;
+		break;
+	}
+}
+
+int eq_fir_fft_process(struct eq_fir_fft *fft, struct input_stream_buffer *bsource,
+		       struct output_stream_buffer *bsink, int frames)
+{
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	const enum sof_ipc_frame fmt = audio_stream_get_frm_fmt(source);
+	const size_t sample_bytes = audio_stream_sample_bytes(source);
+	struct eq_fir_fft_channel *ch;
+	uint8_t *x = audio_stream_get_rptr(source);
+	uint8_t *y = audio_stream_get_wptr(sink);
+	int i;
+	int j;
+
+	for (i = 0; i < frames; i++) {
+		for (j = 0; j < fft->nch; j++) {
+			ch = &fft->ch[j];
+			ch->in[EQ_FIR_FFT_BLOCK + fft->fill] = eq_fir_fft_read(fmt, x);
+			eq_fir_fft_write(fmt, y, ch->out[fft->fill]);
+			x = audio_stream_wrap(source, x + sample_bytes);
+			y = audio_stream_wrap(sink, y + sample_bytes);
+		}
+
+		if (++fft->fill == EQ_FIR_FFT_BLOCK) {
+			for (j = 0; j < fft->nch; j++)
+				eq_fir_fft_block(fft, &fft->ch[j]);
+			fft->fill = 0;
+		}
+	}
+
+	return 0;
+}
+
+void eq_fir_fft_free(struct comp_data *cd)
+{
+	struct eq_fir_fft *fft = cd->fft;
+	int i;
+
+	if (!fft)
+		return;
+
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
+		rfree(fft->ch[i].fdl);
+		rfree(fft->ch[i].in);
+	}
+
+	for (i = 0; i < SOF_EQ_FIR_MAX_RESPONSES; i++)
+		rfree(fft->resp[i].spectra);
+
+	fft_real_plan_free(fft->plan);
+	rfree(fft->time);
+	rfree(fft->spec);
+	rfree(fft);
+	cd->fft = NULL;
+}
+
+/* Called with a configuration validated by eq_fir_init_coef() */
+int eq_fir_fft_setup(struct comp_dev *dev, struct comp_data *cd, int nch)
+{
+	struct sof_eq_fir_config *config = cd->config;
+	struct sof_fir_coef_data *lookup[SOF_EQ_FIR_MAX_RESPONSES];
+	struct eq_fir_fft_channel *ch;
+	struct eq_fir_fft_resp *resp_data;
+	struct eq_fir_fft *fft;
+	int16_t *assign_response = ASSUME_ALIGNED(&config->data[0], 4);
+	size_t size;
+	int resp = 0;
+	int ret;
+	int i;
+
+	fft = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*fft));
+	if (!fft)
+		return -ENOMEM;
+
+	cd->fft = fft;
+	fft->nch = nch;
+	fft->time = rballoc(0, SOF_MEM_CAPS_RAM, EQ_FIR_FFT_SIZE * sizeof(int32_t));
+	fft->spec = rballoc(0, SOF_MEM_CAPS_RAM, EQ_FIR_FFT_BINS * sizeof(struct icomplex32));
+	if (!fft->time || !fft->spec) {
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	fft->plan = fft_real_plan_new(EQ_FIR_FFT_SIZE);
+	if (!fft->plan) {
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	eq_fir_fft_lookup(config, lookup);
+	for (i = 0; i < nch; i++) {
+		ch = &fft->ch[i];
+
+		/* time domain input, two blocks, and the output block */
+		size = (EQ_FIR_FFT_SIZE + EQ_FIR_FFT_BLOCK) * sizeof(int32_t);
+		ch->in = rballoc(0, SOF_MEM_CAPS_RAM, size);
+		if (!ch->in) {
+			ret = -ENOMEM;
+			goto err;
+		}
+
+		bzero(ch->in, size);
+		ch->out = ch->in + EQ_FIR_FFT_SIZE;
+
+		/* same channel to response assignment as in eq_fir_init_coef() */
+		if (i < config->channels_in_config)
+			resp = assign_response[i];
+
+		if (resp < 0) {
+			comp_info(dev, "eq_fir_fft_setup(), ch %d is set to bypass", i);
+			continue;
+		}
+
+		resp_data = &fft->resp[resp];
+		if (!resp_data->spectra) {
+			ret = eq_fir_fft_init_resp(fft, resp_data, lookup[resp]);
+			if (ret < 0)
+				goto err;
+		}
+
+		size = resp_data->num_part * EQ_FIR_FFT_BINS * sizeof(struct icomplex32);
+		ch->fdl = rballoc(0, SOF_MEM_CAPS_RAM, size);
+		if (!ch->fdl) {
+			ret = -ENOMEM;
+			goto err;
+		}
+
+		bzero(ch->fdl, size);
+		ch->resp = resp_data;
+		comp_info(dev, "eq_fir_fft_setup(), ch %d response %d, %d partitions of %d",
+			  i, resp, resp_data->num_part, EQ_FIR_FFT_BLOCK);
+	}
+
+	return 0;
+
+err:
+	comp_err(dev, "eq_fir_fft_setup(), failed %d", ret);
+	eq_fir_fft_free(cd);
+	return ret;
+}
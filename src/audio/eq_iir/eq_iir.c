@@ -43,6 +43,65 @@ DECLARE_SOF_RT_UUID("eq-iir", eq_iir_uuid, 0x5150c0e6, 0x27f9, 0x4ec8,
 
 DECLARE_TR_CTX(eq_iir_tr, SOF_UUID(eq_iir_uuid), LOG_LEVEL_INFO);
 
+/* Switch processing to the filters of the given bank */
+static void eq_iir_activate_bank(struct comp_data *cd, struct eq_iir_bank *bank)
+{
+	cd->active = bank;
+	cd->eq_iir_func = bank->func;
+}
+
+/*
+ * A delta update that changes only biquad coefficients is applied to the
+ * active filters by switching them to the new blob, keeping their delay lines.
+ * The grouped channels keep their own copy of the coefficients and need the
+ * full setup.
+ */
+static bool eq_iir_delta_in_place(struct comp_data *cd)
+{
+	uint32_t offset;
+	uint32_t size;
+
+	if (!cd->config || !comp_data_blob_get_delta(cd->model_handler, &offset, &size))
+		return false;
+
+#if CONFIG_COMP_IIR_CHANNEL_PARALLEL
+	if (cd->active->num_groups)
+		return false;
+#endif
+
+	return eq_iir_delta_coef_only(cd->config, offset, size);
+}
+
+/*
+ * Set up the filters for a new blob received while streaming into the standby
+ * bank. This is done in the IPC context so that processing only needs to
+ * switch the banks when it picks up the blob.
+ */
+static int eq_iir_prepare_blob(struct comp_dev *dev, void *new_data, uint32_t new_data_size)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
+	struct eq_iir_bank *bank;
+	int ret;
+
+	/* The formats are not known before prepare(), the blob is then
+	 * set up in prepare() or in processing.
+	 */
+	cd->pending = NULL;
+	if (!cd->eq_iir_func || eq_iir_delta_in_place(cd))
+		return 0;
+
+	/* The standby bank is not used by processing, see eq_iir_process() */
+	bank = cd->active == &cd->bank[0] ? &cd->bank[1] : &cd->bank[0];
+	ret = eq_iir_new_blob(mod, bank, new_data, cd->source_format, cd->sink_format,
+			      cd->channels);
+	if (ret)
+		return ret;
+
+	cd->pending = bank;
+	return 0;
+}
+
 /*
  * End of EQ setup code. Next the standard component methods.
  */
@@ -77,6 +136,11 @@ static int eq_iir_init(struct processing_module *mod)
 		goto err;
 	}
 
+	/* identical configurations of other instances use the same blob */
+	comp_data_blob_set_shared(cd->model_handler);
+	comp_data_blob_set_preparer(cd->model_handler, eq_iir_prepare_blob);
+	comp_data_blob_set_delta(cd->model_handler);
+
 	/* Allocate and make a copy of the coefficients blob and reset IIR. If
 	 * the EQ is configured later in run-time the size is zero.
 	 */
@@ -87,8 +151,15 @@ static int eq_iir_init(struct processing_module *mod)
 		goto err;
 	}
 
+	ret = eq_iir_init_sub(mod);
+	if (ret < 0) {
+		comp_data_blob_handler_free(cd->model_handler);
+		goto err;
+	}
+
+	cd->active = &cd->bank[0];
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		iir_reset_df1(&cd->iir[i]);
+		iir_reset_df1(&cd->active->iir[i]);
 
 	return 0;
 err:
@@ -144,16 +215,31 @@ static int eq_iir_process(struct processing_module *mod,
 	struct audio_stream *source = input_buffers[0].data;
 	struct audio_stream *sink = output_buffers[0].data;
 	uint32_t frame_count = input_buffers[0].size;
+	struct sof_eq_iir_config *old_config;
+	bool in_place;
 	int ret;
 
 	/* Check for changed configuration */
 	if (comp_is_new_data_blob_available(cd->model_handler)) {
+		old_config = cd->config;
+		in_place = eq_iir_delta_in_place(cd);
 		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
-		ret = eq_iir_new_blob(mod, cd, audio_stream_get_frm_fmt(source),
-				      audio_stream_get_frm_fmt(sink),
-				      audio_stream_get_channels(source));
-		if (ret)
-			return ret;
+		if (cd->pending) {
+			/* Filters were set up in eq_iir_prepare_blob() */
+			eq_iir_activate_bank(cd, cd->pending);
+			cd->pending = NULL;
+		} else if (in_place) {
+			eq_iir_rebase_bank(cd->active, old_config, cd->config);
+		} else {
+			ret = eq_iir_new_blob(mod, cd->active, cd->config,
+					      audio_stream_get_frm_fmt(source),
+					      audio_stream_get_frm_fmt(sink),
+					      audio_stream_get_channels(source));
+			if (ret)
+				return ret;
+
+			eq_iir_activate_bank(cd, cd->active);
+		}
 	}
 
 	if (frame_count) {
@@ -207,6 +293,10 @@ static int eq_iir_prepare(struct processing_module *mod,
 	sink_format = audio_stream_get_frm_fmt(&sinkb->stream);
 
 	cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	cd->pending = NULL;
+	cd->source_format = source_format;
+	cd->sink_format = sink_format;
+	cd->channels = channels;
 
 	/* Initialize EQ */
 	comp_info(dev, "eq_iir_prepare(), source_format=%d, sink_format=%d",
@@ -216,9 +306,15 @@ static int eq_iir_prepare(struct processing_module *mod,
 
 	/* Initialize EQ */
 	if (cd->config) {
-		ret = eq_iir_new_blob(mod, cd, source_format, sink_format, channels);
+		ret = eq_iir_new_blob(mod, cd->active, cd->config, source_format, sink_format,
+				      channels);
 		if (ret)
 			return ret;
+
+		eq_iir_activate_bank(cd, cd->active);
+	} else {
+		/* Without a blob the EQ is transparent, unless it converts the format */
+		mod->bypass = cd->eq_iir_func == eq_iir_pass;
 	}
 
 	if (!cd->eq_iir_func) {
@@ -239,8 +335,9 @@ static int eq_iir_reset(struct processing_module *mod)
 	eq_iir_free_delaylines(cd);
 
 	cd->eq_iir_func = NULL;
+	cd->pending = NULL;
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		iir_reset_df1(&cd->iir[i]);
+		iir_reset_df1(&cd->active->iir[i]);
 
 	return 0;
 }
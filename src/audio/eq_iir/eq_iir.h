@@ -10,10 +10,14 @@
 #ifndef __SOF_AUDIO_EQ_IIR_EQ_IIR_H__
 #define __SOF_AUDIO_EQ_IIR_EQ_IIR_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <sof/audio/module_adapter/module/generic.h>
 #include <sof/math/iir_df2t.h>
 #include <sof/math/iir_df1.h>
+#if CONFIG_COMP_IIR_CHANNEL_PARALLEL
+#include <sof/math/iir_df2t_mc.h>
+#endif
 
 /** \brief Macros to convert without division bytes count to samples count */
 #define EQ_IIR_BYTES_TO_S16_SAMPLES(b)	((b) >> 1)
@@ -33,14 +37,42 @@ struct eq_iir_func_map {
 	eq_iir_func func;			/**< processing function */
 };
 
+#if CONFIG_COMP_IIR_CHANNEL_PARALLEL
+/** \brief Adjacent channels filtered in lockstep. */
+struct eq_iir_group {
+	struct iir_state_df2t_mc iir;		/**< filter state of all lanes */
+	int channel;				/**< first channel of the group */
+};
+#endif
+
+/** \brief Filters of all channels set up from one configuration blob. */
+struct eq_iir_bank {
+	struct iir_state_df1 iir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+	int32_t *iir_delay;			/**< pointer to allocated RAM */
+	size_t iir_delay_size;			/**< allocated size */
+	eq_iir_func func;			/**< processing function */
+#if CONFIG_COMP_IIR_CHANNEL_PARALLEL
+	struct eq_iir_group group[PLATFORM_MAX_CHANNELS / 2]; /**< channel groups */
+	int num_groups;				/**< number of channel groups */
+	uint32_t group_mask;			/**< channels filtered in groups */
+	int64_t *group_data;			/**< group coefficients and delays */
+#endif
+};
+
 /* IIR component private data */
 struct comp_data {
-	struct iir_state_df1 iir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+	struct eq_iir_bank bank[2];		/**< active and standby filters */
+	struct eq_iir_bank *active;		/**< filters used in processing */
+	struct eq_iir_bank *pending;		/**< filters prepared for new blob */
 	struct comp_data_blob_handler *model_handler;
 	struct sof_eq_iir_config *config;
-	int32_t *iir_delay;			/**< pointer to allocated RAM */
-	size_t iir_delay_size;			/**< allocated size */
 	eq_iir_func eq_iir_func;		/**< processing function */
+	enum sof_ipc_frame source_format;	/**< source frame format */
+	enum sof_ipc_frame sink_format;		/**< sink frame format */
+	int channels;				/**< stream channels count */
+#if CONFIG_IPC_MAJOR_4
+	bool s32_to_s16;			/**< output pin format is 16 bit */
+#endif
 };
 
 #ifdef UNIT_TEST
@@ -56,7 +88,15 @@ void eq_iir_s24_default(struct processing_module *mod, struct input_stream_buffe
 void eq_iir_s32_default(struct processing_module *mod, struct input_stream_buffer *bsource,
 			struct output_stream_buffer *bsink, uint32_t frames);
 
-int eq_iir_new_blob(struct processing_module *mod, struct comp_data *cd,
+void eq_iir_s32_16_default(struct processing_module *mod,
+			   struct input_stream_buffer *bsource,
+			   struct output_stream_buffer *bsink, uint32_t frames);
+
+void eq_iir_s32_s16_pass(struct processing_module *mod, struct input_stream_buffer *bsource,
+			 struct output_stream_buffer *bsink, uint32_t frames);
+
+int eq_iir_new_blob(struct processing_module *mod, struct eq_iir_bank *bank,
+		    struct sof_eq_iir_config *config,
 		    enum sof_ipc_frame source_format, enum sof_ipc_frame sink_format,
 		    int channels);
 
@@ -64,12 +104,39 @@ void eq_iir_set_passthrough_func(struct comp_data *cd,
 				 enum sof_ipc_frame source_format,
 				 enum sof_ipc_frame sink_format);
 
+int eq_iir_init_sub(struct processing_module *mod);
+
 int eq_iir_prepare_sub(struct processing_module *mod);
 
 void eq_iir_pass(struct processing_module *mod, struct input_stream_buffer *bsource,
 		 struct output_stream_buffer *bsink, uint32_t frames);
 
-int eq_iir_setup(struct processing_module *mod, int nch);
+int eq_iir_setup(struct processing_module *mod, struct eq_iir_bank *bank,
+		 struct sof_eq_iir_config *config, int nch);
+
+void eq_iir_free_bank(struct eq_iir_bank *bank);
+
+bool eq_iir_delta_coef_only(struct sof_eq_iir_config *config, uint32_t offset, uint32_t size);
+
+void eq_iir_rebase_bank(struct eq_iir_bank *bank, void *old_config, void *new_config);
 
 void eq_iir_free_delaylines(struct comp_data *cd);
+
+#if CONFIG_COMP_IIR_CHANNEL_PARALLEL
+void eq_iir_setup_groups(struct processing_module *mod, struct eq_iir_bank *bank,
+			 enum sof_ipc_frame source_format, enum sof_ipc_frame sink_format,
+			 int nch);
+
+void eq_iir_free_groups(struct eq_iir_bank *bank);
+#else
+static inline void eq_iir_setup_groups(struct processing_module *mod, struct eq_iir_bank *bank,
+				       enum sof_ipc_frame source_format,
+				       enum sof_ipc_frame sink_format, int nch)
+{
+}
+
+static inline void eq_iir_free_groups(struct eq_iir_bank *bank)
+{
+}
+#endif
 #endif /* __SOF_AUDIO_EQ_IIR_EQ_IIR_H__ */
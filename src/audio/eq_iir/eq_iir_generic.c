@@ -71,7 +71,7 @@ void eq_iir_s16_default(struct processing_module *mod, struct input_stream_buffe
 		for (i = 0; i < nch; i++) {
 			x0 = x + i;
 			y0 = y + i;
-			filter = &cd->iir[i];
+			filter = &cd->active->iir[i];
 			for (j = 0; j < n; j += nch) {
 				*y0 = iir_df1_s16(filter, *x0);
 				x0 += nch;
@@ -119,7 +119,7 @@ void eq_iir_s24_default(struct processing_module *mod, struct input_stream_buffe
 		for (i = 0; i < nch; i++) {
 			x0 = x + i;
 			y0 = y + i;
-			filter = &cd->iir[i];
+			filter = &cd->active->iir[i];
 			for (j = 0; j < n; j += nch) {
 				*y0 = iir_df1_s24(filter, *x0);
 				x0 += nch;
@@ -167,7 +167,7 @@ void eq_iir_s32_default(struct processing_module *mod, struct input_stream_buffe
 		for (i = 0; i < nch; i++) {
 			x0 = x + i;
 			y0 = y + i;
-			filter = &cd->iir[i];
+			filter = &cd->active->iir[i];
 			for (j = 0; j < n; j += nch) {
 				*y0 = iir_df1(filter, *x0);
 				x0 += nch;
@@ -181,11 +181,58 @@ void eq_iir_s32_default(struct processing_module *mod, struct input_stream_buffe
 }
 #endif /* CONFIG_FORMAT_S32LE */
 
-static int eq_iir_init_coef(struct processing_module *mod, int nch)
+#if CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE
+void eq_iir_s32_16_default(struct processing_module *mod,
+			   struct input_stream_buffer *bsource,
+			   struct output_stream_buffer *bsink, uint32_t frames)
 {
 	struct comp_data *cd = module_get_private_data(mod);
-	struct sof_eq_iir_config *config = cd->config;
-	struct iir_state_df1 *iir = cd->iir;
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	struct iir_state_df1 *filter;
+	int32_t *x0;
+	int16_t *y0;
+	int32_t *x;
+	int16_t *y;
+	int nmax;
+	int n1;
+	int n2;
+	int i;
+	int j;
+	int n;
+	const int nch = audio_stream_get_channels(source);
+	const int samples = frames * nch;
+	int processed = 0;
+
+	x = audio_stream_get_rptr(source);
+	y = audio_stream_get_wptr(sink);
+	while (processed < samples) {
+		nmax = samples - processed;
+		n1 = audio_stream_bytes_without_wrap(source, x) >> 2; /* divide 4 */
+		n2 = audio_stream_bytes_without_wrap(sink, y) >> 1; /* divide 2 */
+		n = MIN(n1, n2);
+		n = MIN(n, nmax);
+		for (i = 0; i < nch; i++) {
+			x0 = x + i;
+			y0 = y + i;
+			filter = &cd->active->iir[i];
+			for (j = 0; j < n; j += nch) {
+				*y0 = iir_df1_s32_s16(filter, *x0);
+				x0 += nch;
+				y0 += nch;
+			}
+		}
+		processed += n;
+		x = audio_stream_wrap(source, x + n);
+		y = audio_stream_wrap(sink, y + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE */
+
+static int eq_iir_init_coef(struct processing_module *mod, struct eq_iir_bank *bank,
+			    struct sof_eq_iir_config *config, int nch)
+{
+	struct iir_state_df1 *iir = bank->iir;
 	struct sof_eq_iir_header *lookup[SOF_EQ_IIR_MAX_RESPONSES];
 	struct sof_eq_iir_header *eq;
 	int32_t *assign_response;
@@ -286,19 +333,29 @@ static void eq_iir_init_delay(struct iir_state_df1 *iir,
 	}
 }
 
-void eq_iir_free_delaylines(struct comp_data *cd)
+void eq_iir_free_bank(struct eq_iir_bank *bank)
 {
-	struct iir_state_df1 *iir = cd->iir;
+	struct iir_state_df1 *iir = bank->iir;
 	int i = 0;
 
 	/* Free the common buffer for all EQs and point then
 	 * each IIR channel delay line to NULL.
 	 */
-	rfree(cd->iir_delay);
-	cd->iir_delay = NULL;
-	cd->iir_delay_size = 0;
+	rfree(bank->iir_delay);
+	bank->iir_delay = NULL;
+	bank->iir_delay_size = 0;
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		iir[i].delay = NULL;
+
+	eq_iir_free_groups(bank);
+}
+
+void eq_iir_free_delaylines(struct comp_data *cd)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cd->bank); i++)
+		eq_iir_free_bank(&cd->bank[i]);
 }
 
 void eq_iir_pass(struct processing_module *mod, struct input_stream_buffer *bsource,
@@ -310,16 +367,46 @@ void eq_iir_pass(struct processing_module *mod, struct input_stream_buffer *bsou
 	audio_stream_copy(source, 0, sink, 0, frames * audio_stream_get_channels(source));
 }
 
-int eq_iir_setup(struct processing_module *mod, int nch)
+#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE
+void eq_iir_s32_s16_pass(struct processing_module *mod, struct input_stream_buffer *bsource,
+			 struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	int32_t *x = audio_stream_get_rptr(source);
+	int16_t *y = audio_stream_get_wptr(sink);
+	int nmax;
+	int n;
+	int i;
+	int remaining_samples = frames * audio_stream_get_channels(source);
+
+	while (remaining_samples) {
+		nmax = EQ_IIR_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(source, x));
+		n = MIN(remaining_samples, nmax);
+		nmax = EQ_IIR_BYTES_TO_S16_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
+		n = MIN(n, nmax);
+		for (i = 0; i < n; i++) {
+			*y = sat_int16(Q_SHIFT_RND(*x, 31, 15));
+			x++;
+			y++;
+		}
+		remaining_samples -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE */
+
+int eq_iir_setup(struct processing_module *mod, struct eq_iir_bank *bank,
+		 struct sof_eq_iir_config *config, int nch)
 {
-	struct comp_data *cd = module_get_private_data(mod);
 	int delay_size;
 
 	/* Free existing IIR channels data if it was allocated */
-	eq_iir_free_delaylines(cd);
+	eq_iir_free_bank(bank);
 
 	/* Set coefficients for each channel EQ from coefficient blob */
-	delay_size = eq_iir_init_coef(mod, nch);
+	delay_size = eq_iir_init_coef(mod, bank, config, nch);
 	if (delay_size < 0)
 		return delay_size; /* Contains error code */
 
@@ -330,17 +417,51 @@ int eq_iir_setup(struct processing_module *mod, int nch)
 		return 0;
 
 	/* Allocate all IIR channels data in a big chunk and clear it */
-	cd->iir_delay = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
-				delay_size);
-	if (!cd->iir_delay) {
+	bank->iir_delay = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+				  delay_size);
+	if (!bank->iir_delay) {
 		comp_err(mod->dev, "eq_iir_setup(), delay allocation fail");
 		return -ENOMEM;
 	}
 
-	cd->iir_delay_size = delay_size;
+	bank->iir_delay_size = delay_size;
 
 	/* Assign delay line to each channel EQ */
-	eq_iir_init_delay(cd->iir, cd->iir_delay, nch);
+	eq_iir_init_delay(bank->iir, bank->iir_delay, nch);
 	return 0;
 }
 
+
+bool eq_iir_delta_coef_only(struct sof_eq_iir_config *config, uint32_t offset, uint32_t size)
+{
+	struct sof_eq_iir_header *eq;
+	int32_t *coef_data = ASSUME_ALIGNED(&config->data[config->channels_in_config], 4);
+	int i;
+	int j = 0;
+
+	/* A range within the biquads of one response leaves the blob layout
+	 * unchanged, the layout can then be seen from the current blob.
+	 */
+	for (i = 0; i < config->number_of_responses; i++) {
+		eq = (struct sof_eq_iir_header *)&coef_data[j];
+		if (comp_data_blob_delta_within(offset, size, config, eq->biquads,
+						eq->num_sections * sizeof(struct sof_eq_iir_biquad)))
+			return true;
+
+		j += SOF_EQ_IIR_NHEADER + SOF_EQ_IIR_NBIQUAD * eq->num_sections;
+	}
+
+	return false;
+}
+
+void eq_iir_rebase_bank(struct eq_iir_bank *bank, void *old_config, void *new_config)
+{
+	int i;
+
+	/* Only the coefficients move, the delay lines are kept */
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
+		if (bank->iir[i].coef)
+			bank->iir[i].coef = comp_data_blob_rebase(bank->iir[i].coef, old_config,
+								  new_config);
+	}
+}
@@ -38,53 +38,6 @@
 
 LOG_MODULE_DECLARE(eq_iir, CONFIG_SOF_LOG_LEVEL);
 
-#if CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE
-static void eq_iir_s32_16_default(struct processing_module *mod,
-				  struct input_stream_buffer *bsource,
-				  struct output_stream_buffer *bsink, uint32_t frames)
-{
-	struct comp_data *cd = module_get_private_data(mod);
-	struct audio_stream *source = bsource->data;
-	struct audio_stream *sink = bsink->data;
-	struct iir_state_df1 *filter;
-	int32_t *x0;
-	int16_t *y0;
-	int32_t *x;
-	int16_t *y;
-	int nmax;
-	int n1;
-	int n2;
-	int i;
-	int j;
-	int n;
-	const int nch = audio_stream_get_channels(source);
-	const int samples = frames * nch;
-	int processed = 0;
-
-	x = audio_stream_get_rptr(source);
-	y = audio_stream_get_wptr(sink);
-	while (processed < samples) {
-		nmax = samples - processed;
-		n1 = audio_stream_bytes_without_wrap(source, x) >> 2; /* divide 4 */
-		n2 = audio_stream_bytes_without_wrap(sink, y) >> 1; /* divide 2 */
-		n = MIN(n1, n2);
-		n = MIN(n, nmax);
-		for (i = 0; i < nch; i++) {
-			x0 = x + i;
-			y0 = y + i;
-			filter = &cd->iir[i];
-			for (j = 0; j < n; j += nch) {
-				*y0 = iir_df1_s32_s16(filter, *x0);
-				x0 += nch;
-				y0 += nch;
-			}
-		}
-		processed += n;
-		x = audio_stream_wrap(source, x + n);
-		y = audio_stream_wrap(sink, y + n);
-	}
-}
-#endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE
 static void eq_iir_s32_24_default(struct processing_module *mod,
@@ -120,7 +73,7 @@ static void eq_iir_s32_24_default(struct processing_module *mod,
 		for (i = 0; i < nch; i++) {
 			x0 = x + i;
 			y0 = y + i;
-			filter = &cd->iir[i];
+			filter = &cd->active->iir[i];
 			for (j = 0; j < n; j += nch) {
 				*y0 = iir_df1_s32_s24(filter, *x0);
 				x0 += nch;
@@ -134,35 +87,6 @@ static void eq_iir_s32_24_default(struct processing_module *mod,
 }
 #endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE */
 
-#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE
-static void eq_iir_s32_s16_pass(struct processing_module *mod, struct input_stream_buffer *bsource,
-				struct output_stream_buffer *bsink, uint32_t frames)
-{
-	struct audio_stream *source = bsource->data;
-	struct audio_stream *sink = bsink->data;
-	int32_t *x = audio_stream_get_rptr(source);
-	int16_t *y = audio_stream_get_wptr(sink);
-	int nmax;
-	int n;
-	int i;
-	int remaining_samples = frames * audio_stream_get_channels(source);
-
-	while (remaining_samples) {
-		nmax = EQ_IIR_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(source, x));
-		n = MIN(remaining_samples, nmax);
-		nmax = EQ_IIR_BYTES_TO_S16_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
-		n = MIN(n, nmax);
-		for (i = 0; i < n; i++) {
-			*y = sat_int16(Q_SHIFT_RND(*x, 31, 15));
-			x++;
-			y++;
-		}
-		remaining_samples -= n;
-		x = audio_stream_wrap(source, x);
-		y = audio_stream_wrap(sink, y);
-	}
-}
-#endif /* CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE */
 
 #if CONFIG_FORMAT_S24LE && CONFIG_FORMAT_S32LE
 static void eq_iir_s32_s24_pass(struct processing_module *mod, struct input_stream_buffer *bsource,
@@ -299,24 +223,26 @@ static int eq_iir_verify_params(struct comp_dev *dev,
 	return 0;
 }
 
-int eq_iir_new_blob(struct processing_module *mod, struct comp_data *cd,
+int eq_iir_new_blob(struct processing_module *mod, struct eq_iir_bank *bank,
+		    struct sof_eq_iir_config *config,
 		    enum sof_ipc_frame source_format, enum sof_ipc_frame sink_format,
 		    int channels)
 {
 	int ret;
 
-	ret = eq_iir_setup(mod, channels);
+	ret = eq_iir_setup(mod, bank, config, channels);
 	if (ret < 0) {
 		comp_err(mod->dev, "eq_iir_new_blob(), failed IIR setup");
 		return ret;
-	} else if (cd->iir_delay_size) {
+	} else if (bank->iir_delay_size) {
 		comp_dbg(mod->dev, "eq_iir_new_blob(), active");
-		cd->eq_iir_func = eq_iir_find_func(source_format, sink_format, fm_configured,
-						   ARRAY_SIZE(fm_configured));
+		bank->func = eq_iir_find_func(source_format, sink_format, fm_configured,
+					      ARRAY_SIZE(fm_configured));
+		eq_iir_setup_groups(mod, bank, source_format, sink_format, channels);
 	} else {
 		comp_dbg(mod->dev, "eq_iir_new_blob(), pass-through");
-		cd->eq_iir_func = eq_iir_find_func(source_format, sink_format, fm_passthrough,
-						   ARRAY_SIZE(fm_passthrough));
+		bank->func = eq_iir_find_func(source_format, sink_format, fm_passthrough,
+					      ARRAY_SIZE(fm_passthrough));
 	}
 
 	return 0;
@@ -330,6 +256,11 @@ void eq_iir_set_passthrough_func(struct comp_data *cd,
 					   ARRAY_SIZE(fm_passthrough));
 }
 
+int eq_iir_init_sub(struct processing_module *mod)
+{
+	return 0;
+}
+
 int eq_iir_prepare_sub(struct processing_module *mod)
 {
 	return eq_iir_verify_params(mod->dev, mod->stream_params);
@@ -50,14 +50,21 @@ LOG_MODULE_DECLARE(eq_iir, CONFIG_SOF_LOG_LEVEL);
  * (and some lowest non-audible frequencies) in signal.
  * It gave the headroom for signal for amplification.
 
- * If IPC4 systems ever need the memory save small 16 bit capture paths
- * the format conversion could be brought back.
+ * For the memory save small 16 bit capture paths the format conversion from 32 to 16 bits
+ * is brought back. It is selected by a 16 bit output pin format in the base config
+ * extension, the rest of the path after the IIR can then carry 16 bit data.
  */
 
 static eq_iir_func eq_iir_find_func(struct processing_module *mod)
 {
+	struct comp_data *cd = module_get_private_data(mod);
 	unsigned int valid_bit_depth = mod->priv.cfg.base_cfg.audio_fmt.valid_bit_depth;
 
+#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE
+	if (cd->s32_to_s16)
+		return eq_iir_s32_16_default;
+#endif
+
 	comp_dbg(mod->dev, "eq_iir_find_func(): valid_bit_depth %d", valid_bit_depth);
 	switch (valid_bit_depth) {
 #if CONFIG_FORMAT_S16LE
@@ -78,22 +85,29 @@ static eq_iir_func eq_iir_find_func(struct processing_module *mod)
 	return NULL;
 }
 
-int eq_iir_new_blob(struct processing_module *mod, struct comp_data *cd,
+int eq_iir_new_blob(struct processing_module *mod, struct eq_iir_bank *bank,
+		    struct sof_eq_iir_config *config,
 		    enum sof_ipc_frame source_format, enum sof_ipc_frame sink_format,
 		    int channels)
 {
+	struct comp_data *cd = module_get_private_data(mod);
 	int ret;
 
-	ret = eq_iir_setup(mod, channels);
+	ret = eq_iir_setup(mod, bank, config, channels);
 	if (ret < 0) {
 		comp_err(mod->dev, "eq_iir_new_blob(), failed IIR setup");
 		return ret;
-	} else if (cd->iir_delay_size) {
+	} else if (bank->iir_delay_size) {
 		comp_dbg(mod->dev, "eq_iir_new_blob(), active");
-		cd->eq_iir_func = eq_iir_find_func(mod);
+		bank->func = eq_iir_find_func(mod);
+		eq_iir_setup_groups(mod, bank, source_format, sink_format, channels);
 	} else {
 		comp_dbg(mod->dev, "eq_iir_new_blob(), pass-through");
-		cd->eq_iir_func = eq_iir_pass;
+		bank->func = eq_iir_pass;
+#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE
+		if (cd->s32_to_s16)
+			bank->func = eq_iir_s32_s16_pass;
+#endif
 	}
 
 	return 0;
@@ -102,6 +116,7 @@ int eq_iir_new_blob(struct processing_module *mod, struct comp_data *cd,
 static int eq_iir_params(struct processing_module *mod)
 {
 	struct sof_ipc_stream_params *params = mod->stream_params;
+	struct comp_data *cd = module_get_private_data(mod);
 	struct sof_ipc_stream_params comp_params;
 	struct comp_dev *dev = mod->dev;
 	struct comp_buffer *sinkb;
@@ -121,6 +136,12 @@ static int eq_iir_params(struct processing_module *mod)
 
 	comp_params.frame_fmt = valid_fmt;
 
+	if (cd->s32_to_s16) {
+		comp_params.frame_fmt = SOF_IPC_FRAME_S16_LE;
+		comp_params.sample_container_bytes = sizeof(int16_t);
+		comp_params.sample_valid_bytes = sizeof(int16_t);
+	}
+
 	for (i = 0; i < SOF_IPC_MAX_CHANNELS; i++)
 		comp_params.chmap[i] = (mod->priv.cfg.base_cfg.audio_fmt.ch_map >> i * 4) & 0xf;
 
@@ -134,9 +155,56 @@ void eq_iir_set_passthrough_func(struct comp_data *cd,
 				 enum sof_ipc_frame source_format,
 				 enum sof_ipc_frame sink_format)
 {
+#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE
+	if (cd->s32_to_s16) {
+		cd->eq_iir_func = eq_iir_s32_s16_pass;
+		return;
+	}
+#endif
 	cd->eq_iir_func = eq_iir_pass;
 }
 
+/*
+ * The host appends the base config extension with one input and one output pin
+ * format when the output format differs from the input format. Only the 32 to 16
+ * bit conversion is supported.
+ */
+int eq_iir_init_sub(struct processing_module *mod)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	const struct module_config *cfg = &mod->priv.cfg;
+	const struct ipc4_base_module_extended_cfg *ext_cfg = cfg->init_data;
+	const struct ipc4_input_pin_format *input_pin;
+	const struct ipc4_output_pin_format *output_pin;
+	const struct ipc4_audio_format *in_fmt = &cfg->base_cfg.audio_fmt;
+
+	if (cfg->size != sizeof(struct ipc4_base_module_cfg) +
+	    ipc4_calc_base_module_cfg_ext_size(1, 1))
+		return 0;
+
+	if (ext_cfg->base_cfg_ext.nb_input_pins != 1 ||
+	    ext_cfg->base_cfg_ext.nb_output_pins != 1)
+		return 0;
+
+	input_pin = (const struct ipc4_input_pin_format *)ext_cfg->base_cfg_ext.pin_formats;
+	output_pin = (const struct ipc4_output_pin_format *)(input_pin + 1);
+	if (output_pin->audio_fmt.valid_bit_depth == in_fmt->valid_bit_depth)
+		return 0;
+
+	if (!IS_ENABLED(CONFIG_FORMAT_S16LE) || !IS_ENABLED(CONFIG_FORMAT_S32LE) ||
+	    in_fmt->depth != IPC4_DEPTH_32BIT || in_fmt->valid_bit_depth != IPC4_DEPTH_32BIT ||
+	    output_pin->audio_fmt.depth != IPC4_DEPTH_16BIT ||
+	    output_pin->audio_fmt.valid_bit_depth != IPC4_DEPTH_16BIT) {
+		comp_err(mod->dev, "eq_iir_init_sub(), unsupported conversion from %u to %u bits",
+			 in_fmt->valid_bit_depth, output_pin->audio_fmt.valid_bit_depth);
+		return -EINVAL;
+	}
+
+	comp_info(mod->dev, "eq_iir_init_sub(), 32 to 16 bit output");
+	cd->s32_to_s16 = true;
+	return 0;
+}
+
 int eq_iir_prepare_sub(struct processing_module *mod)
 {
 	struct comp_dev *dev = mod->dev;
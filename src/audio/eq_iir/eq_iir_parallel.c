@@ -0,0 +1,314 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include "eq_iir.h"
+#include <sof/audio/component.h>
+#include <sof/audio/module_adapter/module/generic.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/iir_df1.h>
+#include <sof/math/iir_df2t_mc.h>
+#include <sof/trace/trace.h>
+#include <rtos/alloc.h>
+#include <rtos/bit.h>
+#include <ipc/stream.h>
+#include <ipc/topology.h>
+#include <user/eq.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+LOG_MODULE_DECLARE(eq_iir, CONFIG_SOF_LOG_LEVEL);
+
+/*
+ * Adjacent channels with the same number of biquads in series are filtered
+ * in groups of 4 or 2 channels with the channel-parallel DF2T filter, one
+ * channel per SIMD lane. The rest of the channels are filtered with the
+ * normal DF1 filter. Processing is done frame by frame to feed the lanes
+ * from the interleaved samples.
+ */
+
+#if CONFIG_FORMAT_S16LE
+static void eq_iir_s16_group(struct processing_module *mod, struct input_stream_buffer *bsource,
+			     struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct eq_iir_bank *bank = cd->active;
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	struct eq_iir_group *group;
+	int32_t lane[IIR_DF2T_MC_MAX_LANES] __aligned(8);
+	int16_t *x;
+	int16_t *y;
+	int remaining = frames;
+	int n;
+	int i;
+	int j;
+	int l;
+	const int nch = audio_stream_get_channels(source);
+
+	x = audio_stream_get_rptr(source);
+	y = audio_stream_get_wptr(sink);
+	while (remaining) {
+		n = MIN(audio_stream_frames_without_wrap(source, x),
+			audio_stream_frames_without_wrap(sink, y));
+		n = MIN(n, remaining);
+		for (j = 0; j < n; j++) {
+			for (i = 0; i < bank->num_groups; i++) {
+				group = &bank->group[i];
+				for (l = 0; l < group->iir.lanes; l++)
+					lane[l] = (int32_t)x[group->channel + l] << 16;
+
+				iir_df2t_mc(&group->iir, lane);
+				for (l = 0; l < group->iir.lanes; l++)
+					y[group->channel + l] = sat_int16(Q_SHIFT_RND(lane[l], 31, 15));
+			}
+
+			for (i = 0; i < nch; i++) {
+				if (!(bank->group_mask & BIT(i)))
+					y[i] = iir_df1_s16(&bank->iir[i], x[i]);
+			}
+
+			x += nch;
+			y += nch;
+		}
+		remaining -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void eq_iir_s24_group(struct processing_module *mod, struct input_stream_buffer *bsource,
+			     struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct eq_iir_bank *bank = cd->active;
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	struct eq_iir_group *group;
+	int32_t lane[IIR_DF2T_MC_MAX_LANES] __aligned(8);
+	int32_t *x;
+	int32_t *y;
+	int remaining = frames;
+	int n;
+	int i;
+	int j;
+	int l;
+	const int nch = audio_stream_get_channels(source);
+
+	x = audio_stream_get_rptr(source);
+	y = audio_stream_get_wptr(sink);
+	while (remaining) {
+		n = MIN(audio_stream_frames_without_wrap(source, x),
+			audio_stream_frames_without_wrap(sink, y));
+		n = MIN(n, remaining);
+		for (j = 0; j < n; j++) {
+			for (i = 0; i < bank->num_groups; i++) {
+				group = &bank->group[i];
+				for (l = 0; l < group->iir.lanes; l++)
+					lane[l] = x[group->channel + l] << 8;
+
+				iir_df2t_mc(&group->iir, lane);
+				for (l = 0; l < group->iir.lanes; l++)
+					y[group->channel + l] = sat_int24(Q_SHIFT_RND(lane[l], 31, 23));
+			}
+
+			for (i = 0; i < nch; i++) {
+				if (!(bank->group_mask & BIT(i)))
+					y[i] = iir_df1_s24(&bank->iir[i], x[i]);
+			}
+
+			x += nch;
+			y += nch;
+		}
+		remaining -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void eq_iir_s32_group(struct processing_module *mod, struct input_stream_buffer *bsource,
+			     struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct eq_iir_bank *bank = cd->active;
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	struct eq_iir_group *group;
+	int32_t lane[IIR_DF2T_MC_MAX_LANES] __aligned(8);
+	int32_t *x;
+	int32_t *y;
+	int remaining = frames;
+	int n;
+	int i;
+	int j;
+	int l;
+	const int nch = audio_stream_get_channels(source);
+
+	x = audio_stream_get_rptr(source);
+	y = audio_stream_get_wptr(sink);
+	while (remaining) {
+		n = MIN(audio_stream_frames_without_wrap(source, x),
+			audio_stream_frames_without_wrap(sink, y));
+		n = MIN(n, remaining);
+		for (j = 0; j < n; j++) {
+			for (i = 0; i < bank->num_groups; i++) {
+				group = &bank->group[i];
+				for (l = 0; l < group->iir.lanes; l++)
+					lane[l] = x[group->channel + l];
+
+				iir_df2t_mc(&group->iir, lane);
+				for (l = 0; l < group->iir.lanes; l++)
+					y[group->channel + l] = lane[l];
+			}
+
+			for (i = 0; i < nch; i++) {
+				if (!(bank->group_mask & BIT(i)))
+					y[i] = iir_df1(&bank->iir[i], x[i]);
+			}
+
+			x += nch;
+			y += nch;
+		}
+		remaining -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+static const struct eq_iir_func_map fm_group[] = {
+#if CONFIG_FORMAT_S16LE
+	{SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, eq_iir_s16_group},
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, eq_iir_s24_group},
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	{SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, eq_iir_s32_group},
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+/* Get the number of lanes for a group starting from channel ch, zero if the
+ * channel can't be grouped.
+ */
+static int eq_iir_group_lanes(struct eq_iir_bank *bank, int ch, int nch)
+{
+	unsigned int biquads = bank->iir[ch].biquads;
+	int lanes;
+	int i;
+
+	for (lanes = IIR_DF2T_MC_MAX_LANES; lanes >= 2; lanes >>= 1) {
+		if (ch + lanes > nch)
+			continue;
+
+		/* Parallel sections in a response are not supported */
+		for (i = 0; i < lanes; i++) {
+			if (!bank->iir[ch + i].biquads ||
+			    bank->iir[ch + i].biquads != biquads ||
+			    bank->iir[ch + i].biquads_in_series != biquads)
+				break;
+		}
+
+		if (i == lanes)
+			return lanes;
+	}
+
+	return 0;
+}
+
+void eq_iir_setup_groups(struct processing_module *mod, struct eq_iir_bank *bank,
+			 enum sof_ipc_frame source_format, enum sof_ipc_frame sink_format,
+			 int nch)
+{
+	struct sof_eq_iir_header *config[IIR_DF2T_MC_MAX_LANES];
+	struct eq_iir_group *group;
+	eq_iir_func func = NULL;
+	int64_t *data;
+	size_t size = 0;
+	int lanes;
+	int ret;
+	int i;
+	int l;
+
+	if (!bank->func)
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(fm_group); i++) {
+		if (source_format == fm_group[i].source && sink_format == fm_group[i].sink) {
+			func = fm_group[i].func;
+			break;
+		}
+	}
+
+	if (!func)
+		return;
+
+	/* Find the groups of adjacent channels, prefer the widest groups */
+	i = 0;
+	while (i < nch) {
+		lanes = eq_iir_group_lanes(bank, i, nch);
+		if (!lanes) {
+			i++;
+			continue;
+		}
+
+		group = &bank->group[bank->num_groups++];
+		group->channel = i;
+		size += iir_coef_size_df2t_mc(lanes, bank->iir[i].biquads) +
+			iir_delay_size_df2t_mc(lanes, bank->iir[i].biquads);
+		i += lanes;
+	}
+
+	if (!bank->num_groups)
+		return;
+
+	/* The coefficients and delays of all groups in one chunk, the heap
+	 * alignment is sufficient for the 64 bit delays.
+	 */
+	bank->group_data = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, size);
+	if (!bank->group_data) {
+		comp_warn(mod->dev, "eq_iir_setup_groups(), allocation fail, filter per channel");
+		bank->num_groups = 0;
+		return;
+	}
+
+	data = bank->group_data;
+	for (i = 0; i < bank->num_groups; i++) {
+		group = &bank->group[i];
+		lanes = eq_iir_group_lanes(bank, group->channel, nch);
+		for (l = 0; l < lanes; l++)
+			config[l] = container_of(bank->iir[group->channel + l].coef,
+						 struct sof_eq_iir_header, biquads[0]);
+
+		ret = iir_init_coef_df2t_mc(&group->iir, config, lanes, (int32_t *)data);
+		if (ret < 0) {
+			comp_warn(mod->dev, "eq_iir_setup_groups(), invalid group at ch %d",
+				  group->channel);
+			eq_iir_free_groups(bank);
+			return;
+		}
+
+		data += iir_coef_size_df2t_mc(lanes, group->iir.biquads) / sizeof(int64_t);
+		iir_init_delay_df2t_mc(&group->iir, &data);
+		bank->group_mask |= (BIT(lanes) - 1) << group->channel;
+	}
+
+	comp_info(mod->dev, "eq_iir_setup_groups(), %d channel groups, mask 0x%x",
+		  bank->num_groups, bank->group_mask);
+	bank->func = func;
+}
+
+void eq_iir_free_groups(struct eq_iir_bank *bank)
+{
+	rfree(bank->group_data);
+	bank->group_data = NULL;
+	bank->num_groups = 0;
+	bank->group_mask = 0;
+}
@@ -15,6 +15,8 @@
 #include <sof/audio/format.h>
 #include <sof/audio/kpb.h>
 #include <sof/audio/pipeline.h>
+#include <sof/audio/sink_api.h>
+#include <sof/audio/source_api.h>
 #include <sof/common.h>
 #include <rtos/panic.h>
 #include <sof/ipc/msg.h>
@@ -42,6 +44,9 @@
 #define GOOGLE_RTC_AUDIO_PROCESSING_FREQENCY_TO_PERIOD_FRAMES 100
 #define GOOGLE_RTC_NUM_INPUT_PINS 2
 
+/* Number of 10 ms blocks to track the minimum lead of the reference vs. microphone */
+#define GOOGLE_RTC_REF_LAG_WINDOW_BLOCKS 100
+
 LOG_MODULE_REGISTER(google_rtc_audio_processing, CONFIG_SOF_LOG_LEVEL);
 
 /* b780a0a6-269f-466f-b477-23dfa05af758 */
@@ -52,6 +57,13 @@ DECLARE_SOF_RT_UUID("google-rtc-audio-processing", google_rtc_audio_processing_u
 DECLARE_TR_CTX(google_rtc_audio_processing_tr, SOF_UUID(google_rtc_audio_processing_uuid),
 			   LOG_LEVEL_INFO);
 
+/* Block buffers and reference ring hold samples of the largest supported format */
+#if CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_FLOAT
+#define GOOGLE_RTC_SAMPLE_BYTES		sizeof(float)
+#else
+#define GOOGLE_RTC_SAMPLE_BYTES		sizeof(int16_t)
+#endif
+
 struct google_rtc_audio_processing_comp_data {
 #if CONFIG_IPC_MAJOR_4
 	struct sof_ipc4_aec_config config;
@@ -61,7 +73,15 @@ struct google_rtc_audio_processing_comp_data {
 	int num_capture_channels;
 	GoogleRtcAudioProcessingState *state;
 	int16_t *aec_reference_buffer;
-	int aec_reference_frame_index;
+	int16_t *ref_ring;		/* Reference frames for alignment with microphone */
+	int ref_ring_frames;
+	int ref_ring_index;		/* Write index of the newest reference frame plus one */
+	uint32_t ref_frame_count;	/* Total reference frames written to ring */
+	uint32_t mic_frame_count;	/* Total microphone frames buffered */
+	int32_t ref_lag;		/* Lead of newest reference vs. newest mic in frames */
+	int32_t ref_lag_min;		/* Minimum lead in current tracking window */
+	int ref_lag_blocks;		/* Blocks in current tracking window */
+	bool ref_lag_valid;
 	int16_t *raw_mic_buffer;
 	int raw_mic_buffer_frame_index;
 	int16_t *output_buffer;
@@ -71,6 +91,9 @@ struct google_rtc_audio_processing_comp_data {
 	bool reconfigure;
 	int aec_reference_source;
 	int raw_microphone_source;
+#if CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_FLOAT
+	bool float_fmt;			/* Float streams, block buffers are not interleaved */
+#endif
 };
 
 void *GoogleRtcMalloc(size_t size)
@@ -97,7 +120,7 @@ static void google_rtc_audio_processing_params(struct processing_module *mod)
 
 	list_for_item(source_list, &dev->bsource_list) {
 		sourceb = container_of(source_list, struct comp_buffer, sink_list);
-		if (IPC4_SINK_QUEUE_ID(source->id) == SOF_AEC_FEEDBACK_QUEUE_ID)
+		if (IPC4_SINK_QUEUE_ID(sourceb->id) == SOF_AEC_FEEDBACK_QUEUE_ID)
 			ipc4_update_buffer_format(sourceb, &cd->config.reference_fmt);
 		else
 			ipc4_update_buffer_format(sourceb, &mod->priv.cfg.base_cfg.audio_fmt);
@@ -417,6 +440,36 @@ static int google_rtc_audio_processing_init(struct processing_module *mod)
 	cd->num_frames = CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_SAMPLE_RATE_HZ /
 		GOOGLE_RTC_AUDIO_PROCESSING_FREQENCY_TO_PERIOD_FRAMES;
 
+	/* comp_is_new_data_blob_available always returns false for the first
+	 * control write with non-empty config. The first non-empty write may
+	 * happen after prepare (e.g. during copy). Default to true so that
+	 * copy keeps checking until a non-empty config is applied.
+	 */
+	cd->reconfigure = true;
+
+	/* Mic and reference */
+	mod->max_sources = 2;
+
+	comp_dbg(dev, "google_rtc_audio_processing_init(): Ready");
+	return 0;
+
+fail:
+	comp_err(dev, "google_rtc_audio_processing_init(): Failed");
+	if (cd) {
+		comp_data_blob_handler_free(cd->tuning_handler);
+		rfree(cd);
+	}
+
+	return ret;
+}
+
+/* creating the processing state takes milliseconds, it is done outside of init() */
+static int google_rtc_audio_processing_init_async(struct processing_module *mod)
+{
+	struct google_rtc_audio_processing_comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
+	int ret;
+
 	if (CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_MEMORY_BUFFER_SIZE_BYTES > 0) {
 		cd->memory_buffer = rballoc(0, SOF_MEM_CAPS_RAM,
 					    CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_MEMORY_BUFFER_SIZE_BYTES *
@@ -456,62 +509,64 @@ static int google_rtc_audio_processing_init(struct processing_module *mod)
 
 	cd->raw_mic_buffer = rballoc(
 		0, SOF_MEM_CAPS_RAM,
-		cd->num_frames * cd->num_capture_channels * sizeof(cd->raw_mic_buffer[0]));
+		cd->num_frames * cd->num_capture_channels * GOOGLE_RTC_SAMPLE_BYTES);
 	if (!cd->raw_mic_buffer) {
 		ret = -EINVAL;
 		goto fail;
 	}
-	bzero(cd->raw_mic_buffer, cd->num_frames * cd->num_capture_channels * sizeof(cd->raw_mic_buffer[0]));
+	bzero(cd->raw_mic_buffer, cd->num_frames * cd->num_capture_channels * GOOGLE_RTC_SAMPLE_BYTES);
 	cd->raw_mic_buffer_frame_index = 0;
 
 	cd->aec_reference_buffer = rballoc(
 		0, SOF_MEM_CAPS_RAM,
-		cd->num_frames * sizeof(cd->aec_reference_buffer[0]) *
+		cd->num_frames * GOOGLE_RTC_SAMPLE_BYTES *
 		cd->num_aec_reference_channels);
 	if (!cd->aec_reference_buffer) {
 		ret = -ENOMEM;
 		goto fail;
 	}
-	bzero(cd->aec_reference_buffer, cd->num_frames * cd->num_aec_reference_channels * sizeof(cd->aec_reference_buffer[0]));
-	cd->aec_reference_frame_index = 0;
+	bzero(cd->aec_reference_buffer, cd->num_frames * cd->num_aec_reference_channels * GOOGLE_RTC_SAMPLE_BYTES);
+
+	cd->ref_ring_frames = CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_SAMPLE_RATE_HZ / 1000 *
+		CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_REFERENCE_RING_MS;
+	cd->ref_ring = rballoc(0, SOF_MEM_CAPS_RAM, cd->ref_ring_frames *
+			       cd->num_aec_reference_channels * GOOGLE_RTC_SAMPLE_BYTES);
+	if (!cd->ref_ring) {
+		ret = -ENOMEM;
+		goto fail;
+	}
 
 	cd->output_buffer = rballoc(
 		0, SOF_MEM_CAPS_RAM,
-		cd->num_frames * cd->num_capture_channels * sizeof(cd->output_buffer[0]));
+		cd->num_frames * cd->num_capture_channels * GOOGLE_RTC_SAMPLE_BYTES);
 	if (!cd->output_buffer) {
 		ret = -ENOMEM;
 		goto fail;
 	}
-	bzero(cd->output_buffer, cd->num_frames * sizeof(cd->output_buffer[0]));
+	bzero(cd->output_buffer, cd->num_frames * GOOGLE_RTC_SAMPLE_BYTES);
 	cd->output_buffer_frame_index = 0;
 
-	/* comp_is_new_data_blob_available always returns false for the first
-	 * control write with non-empty config. The first non-empty write may
-	 * happen after prepare (e.g. during copy). Default to true so that
-	 * copy keeps checking until a non-empty config is applied.
-	 */
-	cd->reconfigure = true;
-
-	/* Mic and reference, needed for audio stream type copy module client */
-	mod->max_sources = 2;
-
-	comp_dbg(dev, "google_rtc_audio_processing_init(): Ready");
+	comp_dbg(dev, "google_rtc_audio_processing_init_async(): Ready");
 	return 0;
 
 fail:
-	comp_err(dev, "google_rtc_audio_processing_init(): Failed");
-	if (cd) {
-		rfree(cd->output_buffer);
-		rfree(cd->aec_reference_buffer);
-		if (cd->state) {
-			GoogleRtcAudioProcessingFree(cd->state);
-		}
-		GoogleRtcAudioProcessingDetachMemoryBuffer();
-		rfree(cd->memory_buffer);
-		rfree(cd->raw_mic_buffer);
-		comp_data_blob_handler_free(cd->tuning_handler);
-		rfree(cd);
+	/* the rest is freed by free() */
+	comp_err(dev, "google_rtc_audio_processing_init_async(): Failed");
+	rfree(cd->output_buffer);
+	cd->output_buffer = NULL;
+	rfree(cd->ref_ring);
+	cd->ref_ring = NULL;
+	rfree(cd->aec_reference_buffer);
+	cd->aec_reference_buffer = NULL;
+	if (cd->state) {
+		GoogleRtcAudioProcessingFree(cd->state);
+		cd->state = NULL;
 	}
+	GoogleRtcAudioProcessingDetachMemoryBuffer();
+	rfree(cd->memory_buffer);
+	cd->memory_buffer = NULL;
+	rfree(cd->raw_mic_buffer);
+	cd->raw_mic_buffer = NULL;
 
 	return ret;
 }
@@ -522,9 +577,12 @@ static int google_rtc_audio_processing_free(struct processing_module *mod)
 
 	comp_dbg(mod->dev, "google_rtc_audio_processing_free()");
 
-	GoogleRtcAudioProcessingFree(cd->state);
+	/* init_async() may not have run or may have failed */
+	if (cd->state)
+		GoogleRtcAudioProcessingFree(cd->state);
 	cd->state = NULL;
 	rfree(cd->output_buffer);
+	rfree(cd->ref_ring);
 	rfree(cd->aec_reference_buffer);
 	GoogleRtcAudioProcessingDetachMemoryBuffer();
 	rfree(cd->memory_buffer);
@@ -534,6 +592,19 @@ static int google_rtc_audio_processing_free(struct processing_module *mod)
 	return 0;
 }
 
+static void google_rtc_ref_ring_reset(struct google_rtc_audio_processing_comp_data *cd)
+{
+	bzero(cd->ref_ring, cd->ref_ring_frames * cd->num_aec_reference_channels *
+	      GOOGLE_RTC_SAMPLE_BYTES);
+	cd->ref_ring_index = 0;
+	cd->ref_frame_count = 0;
+	cd->mic_frame_count = 0;
+	cd->ref_lag = 0;
+	cd->ref_lag_min = INT32_MAX;
+	cd->ref_lag_blocks = 0;
+	cd->ref_lag_valid = false;
+}
+
 static int google_rtc_audio_processing_prepare(struct processing_module *mod,
 					       struct sof_source **sources,
 					       int num_of_sources,
@@ -613,11 +684,35 @@ static int google_rtc_audio_processing_prepare(struct processing_module *mod,
 	case SOF_IPC_FRAME_S16_LE:
 		break;
 #endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_FLOAT
+	case SOF_IPC_FRAME_FLOAT:
+		if (cd->num_capture_channels > PLATFORM_MAX_CHANNELS ||
+		    cd->num_aec_reference_channels > PLATFORM_MAX_CHANNELS) {
+			comp_err(dev, "unsupported number of float channels");
+			return -EINVAL;
+		}
+		break;
+#endif /* CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_FLOAT */
 	default:
 		comp_err(dev, "unsupported data format: %d", frame_fmt);
 		return -EINVAL;
 	}
 
+	/* samples are copied between the streams and the block buffers as they are */
+	list_for_item(source_buffer_list_item, &dev->bsource_list) {
+		struct comp_buffer *source = container_of(source_buffer_list_item,
+							  struct comp_buffer, sink_list);
+
+		if (audio_stream_get_frm_fmt(&source->stream) != frame_fmt) {
+			comp_err(dev, "source data format %d differs from output",
+				 audio_stream_get_frm_fmt(&source->stream));
+			return -EINVAL;
+		}
+	}
+#if CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_FLOAT
+	cd->float_fmt = frame_fmt == SOF_IPC_FRAME_FLOAT;
+#endif
+
 	if (rate != CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_SAMPLE_RATE_HZ) {
 		comp_err(dev, "unsupported samplerate: %d", rate);
 		return -EINVAL;
@@ -630,131 +725,299 @@ static int google_rtc_audio_processing_prepare(struct processing_module *mod,
 	if (ret)
 		return ret;
 
+	google_rtc_ref_ring_reset(cd);
 	return 0;
 }
 
 static int google_rtc_audio_processing_reset(struct processing_module *mod)
 {
+	struct google_rtc_audio_processing_comp_data *cd = module_get_private_data(mod);
+
 	comp_dbg(mod->dev, "google_rtc_audio_processing_reset()");
 
+	google_rtc_ref_ring_reset(cd);
+	cd->raw_mic_buffer_frame_index = 0;
+	cd->output_buffer_frame_index = 0;
 	return 0;
 }
 
-static int google_rtc_audio_processing_process(struct processing_module *mod,
-					       struct input_stream_buffer *input_buffers,
-					       int num_input_buffers,
-					       struct output_stream_buffer *output_buffers,
-					       int num_output_buffers)
+/* Append all available reference frames to the ring, the oldest frames are
+ * overwritten if the ring is full.
+ */
+static void google_rtc_ref_ring_write(struct google_rtc_audio_processing_comp_data *cd,
+				      struct sof_source *source)
+{
+	const uint8_t *ref;
+	size_t frame_bytes = source_get_frame_bytes(source);
+	size_t ring_frame_bytes = frame_bytes / source_get_channels(source) *
+				  cd->num_aec_reference_channels;
+	size_t size;
+	int remaining = source_get_data_frames_available(source);
+	uint8_t *w;
+	int i;
+	int n;
+
+	while (remaining) {
+		if (source_get_data_linear(source, remaining * frame_bytes,
+					   (const void **)&ref, &size))
+			return;
+
+		n = size / frame_bytes;
+		for (i = 0; i < n; i++) {
+			w = (uint8_t *)cd->ref_ring + cd->ref_ring_index * ring_frame_bytes;
+			memcpy_s(w, ring_frame_bytes, ref, ring_frame_bytes);
+
+			ref += frame_bytes;
+			if (++cd->ref_ring_index == cd->ref_ring_frames)
+				cd->ref_ring_index = 0;
+		}
+
+		source_release_data(source, n * frame_bytes);
+		cd->ref_frame_count += n;
+		remaining -= n;
+	}
+}
+
+/* The newest reference and microphone frames available at the same time are
+ * taken as simultaneous. The lead of the reference is tracked as its minimum
+ * over a window, a smaller lead is applied immediately to not read reference
+ * frames that have not arrived.
+ */
+static void google_rtc_ref_lag_update(struct processing_module *mod, uint32_t newest_mic)
 {
 	struct google_rtc_audio_processing_comp_data *cd = module_get_private_data(mod);
-	int16_t *src, *dst, *ref;
-	uint32_t num_aec_reference_frames;
-	uint32_t num_aec_reference_bytes;
-	int num_samples_remaining;
-	int num_frames_remaining;
+	int32_t lag = (int32_t)(cd->ref_frame_count - newest_mic);
+
+	cd->ref_lag_min = MIN(cd->ref_lag_min, lag);
+	if (!cd->ref_lag_valid || lag < cd->ref_lag) {
+		if (cd->ref_lag_valid)
+			comp_dbg(mod->dev, "reference lead %d -> %d frames", cd->ref_lag, lag);
+
+		cd->ref_lag = lag;
+		cd->ref_lag_valid = true;
+	}
+
+	if (cd->ref_lag_blocks >= GOOGLE_RTC_REF_LAG_WINDOW_BLOCKS) {
+		if (cd->ref_lag_min != cd->ref_lag)
+			comp_dbg(mod->dev, "reference lead %d -> %d frames",
+				 cd->ref_lag, cd->ref_lag_min);
+
+		cd->ref_lag = cd->ref_lag_min;
+		cd->ref_lag_min = INT32_MAX;
+		cd->ref_lag_blocks = 0;
+	}
+}
+
+#if CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_FLOAT
+/* Copy ring frame idx, or silence for a negative idx, to frame i of the
+ * non-interleaved float reference block.
+ */
+static void google_rtc_ref_ring_read_float(struct google_rtc_audio_processing_comp_data *cd,
+					   int idx, int i)
+{
+	const int nch = cd->num_aec_reference_channels;
+	const float *ring = (const float *)cd->ref_ring;
+	float *dst = (float *)cd->aec_reference_buffer + i;
 	int channel;
-	int frames;
-	int nmax;
-	int ret;
-	int i, j, n;
 
-	struct input_stream_buffer *ref_streamb, *mic_streamb;
-	struct output_stream_buffer *out_streamb;
-	struct audio_stream *ref_stream, *mic_stream, *out_stream;
+	for (channel = 0; channel < nch; channel++)
+		dst[channel * cd->num_frames] = idx < 0 ? 0.0f : ring[idx * nch + channel];
+}
+#endif
 
-	if (cd->reconfigure) {
-		ret = google_rtc_audio_processing_reconfigure(mod);
-		if (ret)
-			return ret;
+/* Get the reference block aligned to the microphone block that ended with frame
+ * mic_end, the frames that are not in the ring are zeros.
+ */
+static void google_rtc_ref_ring_read(struct google_rtc_audio_processing_comp_data *cd,
+				     uint32_t mic_end)
+{
+	const int nch = cd->num_aec_reference_channels;
+	uint32_t ref_start = mic_end + cd->ref_lag - cd->num_frames;
+	int16_t *dst = cd->aec_reference_buffer;
+	int32_t age;
+	int idx;
+	int i;
+
+	for (i = 0; i < cd->num_frames; i++) {
+		/* Age is one for the newest frame in the ring */
+		age = (int32_t)(cd->ref_frame_count - (ref_start + i));
+		if (age <= 0 || age > cd->ref_ring_frames) {
+			idx = -1;
+		} else {
+			idx = cd->ref_ring_index - age;
+			if (idx < 0)
+				idx += cd->ref_ring_frames;
+		}
+
+#if CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_FLOAT
+		if (cd->float_fmt) {
+			google_rtc_ref_ring_read_float(cd, idx, i);
+			continue;
+		}
+#endif
+		if (idx < 0)
+			bzero(dst, nch * sizeof(*dst));
+		else
+			memcpy_s(dst, nch * sizeof(*dst), &cd->ref_ring[idx * nch],
+				 nch * sizeof(*dst));
+
+		dst += nch;
+	}
+}
+
+#if CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_FLOAT
+/* The float interface takes one pointer per channel of the block buffers */
+static void google_rtc_process_block_float(struct google_rtc_audio_processing_comp_data *cd)
+{
+	const float *ref[PLATFORM_MAX_CHANNELS];
+	const float *mic[PLATFORM_MAX_CHANNELS];
+	float *out[PLATFORM_MAX_CHANNELS];
+	int channel;
+
+	for (channel = 0; channel < cd->num_aec_reference_channels; channel++)
+		ref[channel] = (const float *)cd->aec_reference_buffer + channel * cd->num_frames;
+
+	for (channel = 0; channel < cd->num_capture_channels; channel++) {
+		mic[channel] = (const float *)cd->raw_mic_buffer + channel * cd->num_frames;
+		out[channel] = (float *)cd->output_buffer + channel * cd->num_frames;
 	}
 
-	ref_streamb = &input_buffers[cd->aec_reference_source];
-	ref_stream = ref_streamb->data;
-	ref = audio_stream_get_rptr(ref_stream);
+	GoogleRtcAudioProcessingAnalyzeRender_float32(cd->state, ref);
+	GoogleRtcAudioProcessingProcessCapture_float32(cd->state, mic, out);
+}
+#endif
 
-	num_aec_reference_frames = input_buffers[cd->aec_reference_source].size;
-	num_aec_reference_bytes = audio_stream_frame_bytes(ref_stream) * num_aec_reference_frames;
+static void google_rtc_process_block(struct google_rtc_audio_processing_comp_data *cd)
+{
+	google_rtc_ref_ring_read(cd, cd->mic_frame_count);
+#if CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_FLOAT
+	if (cd->float_fmt) {
+		google_rtc_process_block_float(cd);
+	} else
+#endif
+	{
+		GoogleRtcAudioProcessingAnalyzeRender_int16(cd->state, cd->aec_reference_buffer);
+		GoogleRtcAudioProcessingProcessCapture_int16(cd->state, cd->raw_mic_buffer,
+							     cd->output_buffer);
+	}
+	cd->output_buffer_frame_index = 0;
+	cd->raw_mic_buffer_frame_index = 0;
+	cd->ref_lag_blocks++;
+}
 
-	num_samples_remaining = num_aec_reference_frames * audio_stream_get_channels(ref_stream);
-	while (num_samples_remaining) {
-		nmax = audio_stream_samples_without_wrap_s16(ref_stream, ref);
-		n = MIN(num_samples_remaining, nmax);
-		for (i = 0; i < n; i += cd->num_aec_reference_channels) {
-			j = cd->num_aec_reference_channels * cd->aec_reference_frame_index;
-			for (channel = 0; channel < cd->num_aec_reference_channels; ++channel)
-				cd->aec_reference_buffer[j++] = ref[channel];
+/* As DP module the processing runs once per 10 ms block of the library */
+static bool google_rtc_audio_processing_is_ready_to_process(struct processing_module *mod,
+							    struct sof_source **sources,
+							    int num_of_sources,
+							    struct sof_sink **sinks,
+							    int num_of_sinks)
+{
+	struct google_rtc_audio_processing_comp_data *cd = module_get_private_data(mod);
+	int frames = cd->num_frames - cd->raw_mic_buffer_frame_index;
 
-			ref += audio_stream_get_channels(ref_stream);
-			++cd->aec_reference_frame_index;
+	return source_get_data_frames_available(sources[cd->raw_microphone_source]) >= frames &&
+		sink_get_free_frames(sinks[0]) >= frames;
+}
 
-			if (cd->aec_reference_frame_index == cd->num_frames) {
-				GoogleRtcAudioProcessingAnalyzeRender_int16(cd->state,
-									    cd->aec_reference_buffer);
-				cd->aec_reference_frame_index = 0;
-			}
+/* Move one microphone frame to the block buffer and one processed frame to the sink */
+static void google_rtc_copy_frame(struct google_rtc_audio_processing_comp_data *cd,
+				  const void *src, void *dst)
+{
+	const size_t block_size = cd->num_frames * cd->num_capture_channels;
+
+#if CONFIG_COMP_GOOGLE_RTC_AUDIO_PROCESSING_FLOAT
+	if (cd->float_fmt) {
+		int channel;
+		float *mic = (float *)cd->raw_mic_buffer + cd->raw_mic_buffer_frame_index;
+		const float *out = (const float *)cd->output_buffer +
+				   cd->output_buffer_frame_index;
+
+		for (channel = 0; channel < cd->num_capture_channels; channel++) {
+			mic[channel * cd->num_frames] = ((const float *)src)[channel];
+			((float *)dst)[channel] = out[channel * cd->num_frames];
 		}
-		num_samples_remaining -= n;
-		ref = audio_stream_wrap(ref_stream, ref);
+		return;
+	}
+#endif
+	memcpy_s(&cd->raw_mic_buffer[cd->raw_mic_buffer_frame_index * cd->num_capture_channels],
+		 block_size * sizeof(cd->raw_mic_buffer[0]), src,
+		 sizeof(int16_t) * cd->num_capture_channels);
+	memcpy_s(dst, block_size * sizeof(cd->output_buffer[0]),
+		 &cd->output_buffer[cd->output_buffer_frame_index * cd->num_capture_channels],
+		 sizeof(int16_t) * cd->num_capture_channels);
+}
+
+static int google_rtc_audio_processing_process(struct processing_module *mod,
+					       struct sof_source **sources, int num_of_sources,
+					       struct sof_sink **sinks, int num_of_sinks)
+{
+	struct google_rtc_audio_processing_comp_data *cd = module_get_private_data(mod);
+	struct sof_source *mic_source = sources[cd->raw_microphone_source];
+	struct sof_sink *sink = sinks[0];
+	const uint8_t *src;
+	uint8_t *dst;
+	size_t mic_frame_bytes = source_get_frame_bytes(mic_source);
+	size_t out_frame_bytes = sink_get_frame_bytes(sink);
+	size_t mic_size;
+	size_t out_size;
+	int mic_frames;
+	int frames;
+	int ret;
+	int i, n;
+
+	if (cd->reconfigure) {
+		ret = google_rtc_audio_processing_reconfigure(mod);
+		if (ret)
+			return ret;
 	}
-	input_buffers[cd->aec_reference_source].consumed = num_aec_reference_bytes;
 
-	mic_streamb = &input_buffers[cd->raw_microphone_source];
-	mic_stream = mic_streamb->data;
-	out_streamb = &output_buffers[0];
-	out_stream = out_streamb->data;
+	/* Buffer the reference and align it with the newest microphone frame */
+	google_rtc_ref_ring_write(cd, sources[cd->aec_reference_source]);
+	mic_frames = source_get_data_frames_available(mic_source);
+	google_rtc_ref_lag_update(mod, cd->mic_frame_count + mic_frames);
 
-	src = audio_stream_get_rptr(mic_stream);
-	dst = audio_stream_get_wptr(out_stream);
+	frames = MIN(mic_frames, sink_get_free_frames(sink));
+	while (frames) {
+		ret = source_get_data_linear(mic_source, frames * mic_frame_bytes,
+					     (const void **)&src, &mic_size);
+		if (ret)
+			return ret;
 
-	frames = input_buffers[cd->raw_microphone_source].size;
-	num_frames_remaining = frames;
+		ret = sink_get_buffer_linear(sink, frames * out_frame_bytes, (void **)&dst,
+					     &out_size);
+		if (ret) {
+			source_release_data(mic_source, 0);
+			return ret;
+		}
 
-	while (num_frames_remaining) {
-		nmax = audio_stream_frames_without_wrap(mic_stream, src);
-		n = MIN(num_frames_remaining, nmax);
-		nmax = audio_stream_frames_without_wrap(out_stream, dst);
-		n = MIN(n, nmax);
+		n = MIN(mic_size / mic_frame_bytes, out_size / out_frame_bytes);
 		for (i = 0; i < n; i++) {
-			memcpy_s(&(cd->raw_mic_buffer[cd->raw_mic_buffer_frame_index *
-						      cd->num_capture_channels]),
-				 cd->num_frames * cd->num_capture_channels *
-				 sizeof(cd->raw_mic_buffer[0]), src,
-				 sizeof(int16_t) * cd->num_capture_channels);
+			google_rtc_copy_frame(cd, src, dst);
 			++cd->raw_mic_buffer_frame_index;
-
-			memcpy_s(dst, cd->num_frames * cd->num_capture_channels *
-				 sizeof(cd->output_buffer[0]),
-				 &(cd->output_buffer[cd->output_buffer_frame_index *
-						     cd->num_capture_channels]),
-				 sizeof(int16_t) * cd->num_capture_channels);
+			++cd->mic_frame_count;
 			++cd->output_buffer_frame_index;
 
-			if (cd->raw_mic_buffer_frame_index == cd->num_frames) {
-				GoogleRtcAudioProcessingProcessCapture_int16(cd->state,
-									     cd->raw_mic_buffer,
-									     cd->output_buffer);
-				cd->output_buffer_frame_index = 0;
-				cd->raw_mic_buffer_frame_index = 0;
-			}
+			if (cd->raw_mic_buffer_frame_index == cd->num_frames)
+				google_rtc_process_block(cd);
 
-			src += audio_stream_get_channels(mic_stream);
-			dst += audio_stream_get_channels(out_stream);
+			src += mic_frame_bytes;
+			dst += out_frame_bytes;
 		}
-		num_frames_remaining -= n;
-		src = audio_stream_wrap(mic_stream, src);
-		dst = audio_stream_wrap(out_stream, dst);
-	}
 
-	module_update_buffer_position(&input_buffers[cd->raw_microphone_source],
-				      &output_buffers[0], frames);
+		source_release_data(mic_source, n * mic_frame_bytes);
+		sink_commit_buffer(sink, n * out_frame_bytes);
+		frames -= n;
+	}
 
 	return 0;
 }
 
 static struct module_interface google_rtc_audio_processing_interface = {
 	.init  = google_rtc_audio_processing_init,
+	.init_async = google_rtc_audio_processing_init_async,
 	.free = google_rtc_audio_processing_free,
-	.process_audio_stream = google_rtc_audio_processing_process,
+	.process = google_rtc_audio_processing_process,
+	.is_ready_to_process = google_rtc_audio_processing_is_ready_to_process,
 	.prepare = google_rtc_audio_processing_prepare,
 	.set_configuration = google_rtc_audio_processing_set_config,
 	.get_configuration = google_rtc_audio_processing_get_config,
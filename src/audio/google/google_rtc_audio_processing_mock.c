@@ -24,6 +24,7 @@ struct GoogleRtcAudioProcessingState {
 	int num_output_channels;
 	int num_frames;
 	int16_t *aec_reference;
+	float *aec_reference_float;
 };
 
 static void SetFormats(GoogleRtcAudioProcessingState *const state,
@@ -45,6 +46,12 @@ static void SetFormats(GoogleRtcAudioProcessingState *const state,
 				       sizeof(state->aec_reference[0]) *
 				       state->num_frames *
 				       state->num_aec_reference_channels);
+	rfree(state->aec_reference_float);
+	state->aec_reference_float = rballoc(0,
+					     SOF_MEM_CAPS_RAM,
+					     sizeof(state->aec_reference_float[0]) *
+					     state->num_frames *
+					     state->num_aec_reference_channels);
 }
 
 void GoogleRtcAudioProcessingAttachMemoryBuffer(uint8_t *const buffer,
@@ -70,6 +77,7 @@ GoogleRtcAudioProcessingState *GoogleRtcAudioProcessingCreateWithConfig(int capt
 		return NULL;
 
 	s->aec_reference = NULL;
+	s->aec_reference_float = NULL;
 	SetFormats(s,
 		   capture_sample_rate_hz,
 		   num_capture_input_channels,
@@ -77,7 +85,9 @@ GoogleRtcAudioProcessingState *GoogleRtcAudioProcessingCreateWithConfig(int capt
 		   render_sample_rate_hz,
 		   num_render_channels);
 
-	if (!s->aec_reference) {
+	if (!s->aec_reference || !s->aec_reference_float) {
+		rfree(s->aec_reference);
+		rfree(s->aec_reference_float);
 		rfree(s);
 		return NULL;
 	}
@@ -99,6 +109,7 @@ void GoogleRtcAudioProcessingFree(GoogleRtcAudioProcessingState *state)
 {
 	if (state != NULL) {
 		rfree(state->aec_reference);
+		rfree(state->aec_reference_float);
 		rfree(state);
 	}
 }
@@ -183,6 +194,38 @@ int GoogleRtcAudioProcessingAnalyzeRender_int16(GoogleRtcAudioProcessingState *c
 	return 0;
 }
 
+/* Same mix as the int16 variant on non-interleaved channels */
+int GoogleRtcAudioProcessingProcessCapture_float32(GoogleRtcAudioProcessingState *const state,
+						   const float *const *src,
+						   float *const *dest)
+{
+	float sample;
+	int n, io;
+
+	for (io = 0; io < state->num_output_channels; io++) {
+		for (n = 0; n < state->num_frames; ++n) {
+			sample = (io < state->num_capture_channels ? src[io][n] : 0.0f) +
+				 (io < state->num_aec_reference_channels ?
+				  state->aec_reference_float[io * state->num_frames + n] : 0.0f);
+			dest[io][n] = MAX(MIN(sample, 1.0f), -1.0f);
+		}
+	}
+	return 0;
+}
+
+int GoogleRtcAudioProcessingAnalyzeRender_float32(GoogleRtcAudioProcessingState *const state,
+						  const float *const *src)
+{
+	const size_t channel_size =
+		sizeof(state->aec_reference_float[0]) * state->num_frames;
+	int ch;
+
+	for (ch = 0; ch < state->num_aec_reference_channels; ch++)
+		memcpy_s(&state->aec_reference_float[ch * state->num_frames], channel_size,
+			 src[ch], channel_size);
+	return 0;
+}
+
 void GoogleRtcAudioProcessingParseSofConfigMessage(uint8_t *message,
 						   size_t message_size,
 						   uint8_t **google_rtc_audio_processing_config,
@@ -235,11 +235,26 @@ void host_common_update(struct host_data *hd, struct comp_dev *dev, uint32_t byt
 	if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
 		source = hd->dma_buffer;
 		sink = hd->local_buffer;
-		ret = dma_buffer_copy_from(source, sink, hd->process, bytes);
+#if CONFIG_COPIER_GAIN
+		/* the gain conversion carries the attenuation too */
+		if (hd->gain && !hd->gain->unity)
+			ret = dma_buffer_copy_from_gain(source, sink, hd->process_gain, bytes,
+							hd->gain);
+#else
+		if (hd->process_att && hd->attenuation)
+			ret = dma_buffer_copy_from_att(source, sink, hd->process_att, bytes,
+						       hd->attenuation);
+#endif
+		else
+			ret = dma_buffer_copy_from(source, sink, hd->process, bytes);
 	} else {
 		source = hd->local_buffer;
 		sink = hd->dma_buffer;
-		ret = dma_buffer_copy_to(source, sink, hd->process, bytes);
+		if (hd->gain && !hd->gain->unity)
+			ret = dma_buffer_copy_to_gain(source, sink, hd->process_gain, bytes,
+						      hd->gain);
+		else
+			ret = dma_buffer_copy_to(source, sink, hd->process, bytes);
 	}
 
 	/* assert dma_buffer_copy succeed */
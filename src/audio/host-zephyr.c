@@ -11,16 +11,20 @@
 #include <sof/audio/pipeline.h>
 #include <sof/audio/ipc-config.h>
 #include <sof/common.h>
+#include <sof/debug/telemetry/tracepoint.h>
 #include <rtos/panic.h>
 #include <sof/ipc/msg.h>
 #include <rtos/alloc.h>
 #include <rtos/init.h>
+#include <sof/lib/cpu.h>
 #include <sof/lib/dma.h>
 #include <sof/lib/mailbox.h>
 #include <sof/lib/memory.h>
 #include <sof/lib/uuid.h>
 #include <sof/list.h>
 #include <sof/math/numbers.h>
+#include <sof/schedule/ll_schedule.h>
+#include <sof/schedule/schedule.h>
 #include <rtos/string.h>
 #include <sof/ut.h>
 #include <sof/trace/trace.h>
@@ -45,6 +49,130 @@ DECLARE_SOF_RT_UUID("host", host_uuid, 0x8b9d100c, 0x6d78, 0x418f,
 
 DECLARE_TR_CTX(host_tr, SOF_UUID(host_uuid), LOG_LEVEL_INFO);
 
+#if CONFIG_HOST_DMA_BATCHED_SERVICE
+/* 5d3c8a41-0e6b-4f27-9a1c-7b2d4e6f8a93 */
+DECLARE_SOF_UUID("host-dma-batch", host_dma_batch_uuid, 0x5d3c8a41, 0x0e6b, 0x4f27,
+		 0x9a, 0x1c, 0x7b, 0x2d, 0x4e, 0x6f, 0x8a, 0x93);
+
+/* host streams running on a core, serviced together once per tick */
+struct host_dma_batch {
+	struct task task;		/* reloads, after the pipelines of the tick */
+	struct list_item streams;	/* list of struct host_data */
+	bool status_read;		/* statuses read in the current tick */
+	bool scheduled;
+};
+
+static struct host_dma_batch host_dma_batches[CONFIG_CORE_COUNT];
+
+/* first host copy of the tick, read the DMA status of all streams */
+static void host_dma_batch_read_status(struct host_dma_batch *batch)
+{
+	struct dma_status dma_stat;
+	struct host_data *hd;
+	struct list_item *item;
+
+	list_for_item(item, &batch->streams) {
+		hd = container_of(item, struct host_data, batch_list);
+
+		/* a failed read is retried by the copy of the stream */
+		hd->batch_status = !dma_get_status(hd->chan->dma->z_dev, hd->chan->index,
+						   &dma_stat);
+		if (!hd->batch_status)
+			continue;
+
+		if (hd->ipc_host.direction == SOF_IPC_STREAM_PLAYBACK)
+			hd->dma_ready_bytes = dma_stat.pending_length - hd->partial_size;
+		else
+			hd->dma_ready_bytes = dma_stat.free - hd->partial_size;
+	}
+
+	batch->status_read = true;
+}
+
+/* last task of the tick, reload the DMAs the copies asked for */
+static enum task_state host_dma_batch_run(void *data)
+{
+	struct host_dma_batch *batch = data;
+	struct host_data *hd;
+	struct list_item *item;
+	int ret;
+
+	list_for_item(item, &batch->streams) {
+		hd = container_of(item, struct host_data, batch_list);
+
+		if (hd->batch_reload) {
+			ret = dma_reload(hd->chan->dma->z_dev, hd->chan->index, 0, 0,
+					 hd->partial_size);
+			if (ret < 0)
+				tr_err(&host_tr, "host_dma_batch_run(): dma_reload() failed, ret = %d",
+				       ret);
+
+			hd->partial_size = 0;
+			hd->batch_reload = false;
+		}
+
+		hd->batch_status = false;
+	}
+
+	batch->status_read = false;
+
+	return SOF_TASK_STATE_RESCHEDULE;
+}
+
+static int host_dma_batch_join(struct host_data *hd, struct comp_dev *dev)
+{
+	struct host_dma_batch *batch = host_dma_batches + cpu_get_id();
+	int ret;
+
+	if (!batch->scheduled) {
+		list_init(&batch->streams);
+		batch->status_read = false;
+
+		ret = schedule_task_init_ll(&batch->task, SOF_UUID(host_dma_batch_uuid),
+					    SOF_SCHEDULE_LL_TIMER, SOF_TASK_PRI_LOW,
+					    host_dma_batch_run, batch, cpu_get_id(), 0);
+		if (ret < 0) {
+			comp_err(dev, "host_dma_batch_join(), ll task initialization failed");
+			return ret;
+		}
+
+		ret = schedule_task(&batch->task, 0, 0);
+		if (ret < 0) {
+			comp_err(dev, "host_dma_batch_join(), ll schedule task failed");
+			schedule_task_free(&batch->task);
+			return ret;
+		}
+
+		batch->scheduled = true;
+	}
+
+	hd->batch_status = false;
+	hd->batch_reload = false;
+	hd->batched = true;
+	list_item_append(&hd->batch_list, &batch->streams);
+
+	return 0;
+}
+
+/* the stream is stopping, a pending reload is dropped with its DMA */
+static void host_dma_batch_leave(struct host_data *hd)
+{
+	struct host_dma_batch *batch = host_dma_batches + cpu_get_id();
+
+	if (!hd->batched)
+		return;
+
+	list_item_del(&hd->batch_list);
+	hd->batched = false;
+	hd->batch_reload = false;
+
+	if (list_is_empty(&batch->streams)) {
+		schedule_task_free(&batch->task);
+		batch->scheduled = false;
+	}
+}
+#endif
+
 static inline struct dma_sg_elem *next_buffer(struct hc_buf *hc)
 {
 	if (!hc->elem_array.elems || !hc->elem_array.count)
@@ -241,11 +369,26 @@ void host_common_update(struct host_data *hd, struct comp_dev *dev, uint32_t byt
 	if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
 		source = hd->dma_buffer;
 		sink = hd->local_buffer;
-		ret = dma_buffer_copy_from(source, sink, hd->process, bytes);
+#if CONFIG_COPIER_GAIN
+		/* the gain conversion carries the attenuation too */
+		if (hd->gain && !hd->gain->unity)
+			ret = dma_buffer_copy_from_gain(source, sink, hd->process_gain, bytes,
+							hd->gain);
+#else
+		if (hd->process_att && hd->attenuation)
+			ret = dma_buffer_copy_from_att(source, sink, hd->process_att, bytes,
+						       hd->attenuation);
+#endif
+		else
+			ret = dma_buffer_copy_from(source, sink, hd->process, bytes);
 	} else {
 		source = hd->local_buffer;
 		sink = hd->dma_buffer;
-		ret = dma_buffer_copy_to(source, sink, hd->process, bytes);
+		if (hd->gain && !hd->gain->unity)
+			ret = dma_buffer_copy_to_gain(source, sink, hd->process_gain, bytes,
+						      hd->gain);
+		else
+			ret = dma_buffer_copy_to(source, sink, hd->process, bytes);
 	}
 
 	if (ret < 0) {
@@ -256,6 +399,13 @@ void host_common_update(struct host_data *hd, struct comp_dev *dev, uint32_t byt
 
 	hd->total_data_processed += bytes;
 
+#if CONFIG_IPC4_TIME_CORR
+	time_corr_update(&hd->time_corr, sof_cycle_get_64(), hd->total_data_processed);
+#endif
+#if CONFIG_IPC4_STREAM_POSN
+	stream_posn_update(&hd->stream_posn, dev, hd->total_data_processed);
+#endif
+
 	/* new local period, update host buffer position blks
 	 * local_pos is queried by the ops.position() API
 	 */
@@ -345,6 +495,8 @@ static void host_dma_cb(struct comp_dev *dev, size_t bytes)
 
 	comp_cl_dbg(&comp_host, "host_dma_cb() %p", &comp_host);
 
+	SOF_TRACEPOINT(SOF_TRACEPOINT_HOST_DMA, SOF_TRACEPOINT_INSTANT, dev_comp_id(dev), bytes);
+
 	/* update position */
 	host_common_update(hd, dev, bytes);
 
@@ -353,6 +505,59 @@ static void host_dma_cb(struct comp_dev *dev, size_t bytes)
 		host_common_one_shot(hd, bytes);
 }
 
+/**
+ * Gets bytes ready for copy in the DMA buffer: data to be read for playback,
+ * free space to be written for capture.
+ * @param dev Host component device.
+ * @param ready Ready bytes.
+ * @return 0 if succeeded, error code otherwise.
+ */
+static int host_get_dma_ready_bytes(struct host_data *hd, struct comp_dev *dev,
+				    uint32_t *ready)
+{
+	struct dma_status dma_stat;
+	int ret;
+
+#if CONFIG_HOST_DMA_BATCHED_SERVICE
+	if (hd->batched) {
+		struct host_dma_batch *batch = host_dma_batches + cpu_get_id();
+
+		if (!batch->status_read)
+			host_dma_batch_read_status(batch);
+
+		if (hd->batch_status) {
+			*ready = hd->dma_ready_bytes;
+			return 0;
+		}
+	}
+#endif
+
+#if CONFIG_HOST_DMA_STATUS_CACHE
+	/* The DMA can only add to what was ready at the last status read, so
+	 * while that is enough for a period there is no need to query it.
+	 */
+	if (hd->dma_ready_bytes >= hd->period_bytes &&
+	    !(hd->ipc_host.feature_mask & BIT(IPC4_COPIER_FAST_MODE))) {
+		*ready = hd->dma_ready_bytes;
+		return 0;
+	}
+#endif
+
+	/* get data sizes from DMA */
+	ret = dma_get_status(hd->chan->dma->z_dev, hd->chan->index, &dma_stat);
+	if (ret < 0)
+		return ret;
+
+	if (dev->direction == SOF_IPC_STREAM_PLAYBACK)
+		*ready = dma_stat.pending_length - hd->partial_size;
+	else
+		*ready = dma_stat.free - hd->partial_size;
+
+	hd->dma_ready_bytes = *ready;
+
+	return 0;
+}
+
 /**
  * Calculates bytes to be copied in normal mode.
  * @param dev Host component device.
@@ -361,15 +566,14 @@ static void host_dma_cb(struct comp_dev *dev, size_t bytes)
 static uint32_t host_get_copy_bytes_normal(struct host_data *hd, struct comp_dev *dev)
 {
 	struct comp_buffer *buffer = hd->local_buffer;
-	struct dma_status dma_stat;
 	uint32_t avail_samples;
 	uint32_t free_samples;
 	uint32_t dma_sample_bytes;
 	uint32_t dma_copy_bytes;
+	uint32_t dma_ready;
 	int ret;
 
-	/* get data sizes from DMA */
-	ret = dma_get_status(hd->chan->dma->z_dev, hd->chan->index, &dma_stat);
+	ret = host_get_dma_ready_bytes(hd, dev, &dma_ready);
 	if (ret < 0) {
 		comp_err(dev, "host_get_copy_bytes_normal(): dma_get_status() failed, ret = %u",
 			 ret);
@@ -381,11 +585,11 @@ static uint32_t host_get_copy_bytes_normal(struct host_data *hd, struct comp_dev
 
 	/* calculate minimum size to copy */
 	if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
-		avail_samples = (dma_stat.pending_length - hd->partial_size) / dma_sample_bytes;
+		avail_samples = dma_ready / dma_sample_bytes;
 		free_samples = audio_stream_get_free_samples(&buffer->stream);
 	} else {
 		avail_samples = audio_stream_get_avail_samples(&buffer->stream);
-		free_samples = (dma_stat.free - hd->partial_size) / dma_sample_bytes;
+		free_samples = dma_ready / dma_sample_bytes;
 	}
 
 	dma_copy_bytes = MIN(avail_samples, free_samples) * dma_sample_bytes;
@@ -455,6 +659,7 @@ static int host_copy_normal(struct host_data *hd, struct comp_dev *dev, copy_cal
 	cb(dev, copy_bytes);
 
 	hd->partial_size += copy_bytes;
+	hd->dma_ready_bytes -= copy_bytes;
 
 	/*
 	 * On large buffers we don't need to reload DMA on every period. When
@@ -467,6 +672,13 @@ static int host_copy_normal(struct host_data *hd, struct comp_dev *dev, copy_cal
 	    hd->dma_buffer_size - hd->partial_size <=
 	    (2 + threshold) * hd->period_bytes) {
 		if (stream_sync(hd, dev)) {
+#if CONFIG_HOST_DMA_BATCHED_SERVICE
+			/* the batch reloads the stream after the pipelines of the tick */
+			if (hd->batched) {
+				hd->batch_reload = true;
+				return 0;
+			}
+#endif
 			ret = dma_reload(hd->chan->dma->z_dev, hd->chan->index, 0, 0,
 					 hd->partial_size);
 			if (ret < 0)
@@ -542,13 +754,24 @@ int host_common_trigger(struct host_data *hd, struct comp_dev *dev, int cmd)
 	switch (cmd) {
 	case COMP_TRIGGER_START:
 		hd->partial_size = 0;
+		hd->dma_ready_bytes = 0;
 		ret = dma_start(hd->chan->dma->z_dev, hd->chan->index);
-		if (ret < 0)
+		if (ret < 0) {
 			comp_err(dev, "host_trigger(): dma_start() failed, ret = %u",
 				 ret);
+			break;
+		}
+#if CONFIG_HOST_DMA_BATCHED_SERVICE
+		/* a failed join leaves the stream serviced on its own */
+		if (hd->copy_type == COMP_COPY_NORMAL && !hd->batched)
+			host_dma_batch_join(hd, dev);
+#endif
 		break;
 	case COMP_TRIGGER_STOP:
 	case COMP_TRIGGER_XRUN:
+#if CONFIG_HOST_DMA_BATCHED_SERVICE
+		host_dma_batch_leave(hd);
+#endif
 		ret = dma_stop(hd->chan->dma->z_dev, hd->chan->index);
 		if (ret < 0)
 			comp_err(dev, "host_trigger(): dma stop failed: %d",
@@ -995,6 +1218,9 @@ static int host_position(struct comp_dev *dev,
 
 void host_common_reset(struct host_data *hd, uint16_t state)
 {
+#if CONFIG_HOST_DMA_BATCHED_SERVICE
+	host_dma_batch_leave(hd);
+#endif
 	if (hd->chan) {
 		dma_stop(hd->chan->dma->z_dev, hd->chan->index);
 		dma_release_channel(hd->dma->z_dev, hd->chan->index);
@@ -1017,6 +1243,13 @@ void host_common_reset(struct host_data *hd, uint16_t state)
 	hd->report_pos = 0;
 	hd->total_data_processed = 0;
 
+#if CONFIG_IPC4_TIME_CORR
+	time_corr_reset(&hd->time_corr);
+#endif
+#if CONFIG_IPC4_STREAM_POSN
+	stream_posn_reset(&hd->stream_posn);
+#endif
+
 	hd->copy_type = COMP_COPY_NORMAL;
 	hd->source = NULL;
 	hd->sink = NULL;
@@ -7,6 +7,9 @@
 #include <ipc/control.h>
 #include <ipc/stream.h>
 #include <ipc/topology.h>
+#if CONFIG_IPC_MAJOR_4
+#include <ipc4/header.h>
+#endif
 #include <user/igo_nr.h>
 #include <user/trace.h>
 #include <sof/common.h>
@@ -24,6 +27,9 @@
 #include <sof/audio/pipeline.h>
 #include <sof/audio/ipc-config.h>
 #include <sof/audio/igo_nr/igo_nr_comp.h>
+#include <sof/audio/module_adapter/module/generic.h>
+#include <sof/audio/sink_api.h>
+#include <sof/audio/source_api.h>
 #include <sof/trace/trace.h>
 #include <sof/ut.h>
 #include <errno.h>
@@ -37,8 +43,6 @@ enum IGO_NR_ENUM {
 	IGO_NR_ENUM_LAST,
 };
 
-static const struct comp_driver comp_igo_nr;
-
 /* 696ae2bc-2877-11eb-adc1-0242ac120002 */
 DECLARE_SOF_RT_UUID("igo-nr", igo_nr_uuid,  0x696ae2bc, 0x2877, 0x11eb, 0xad, 0xc1,
 		    0x02, 0x42, 0xac, 0x12, 0x00, 0x02);
@@ -66,17 +70,14 @@ static void igo_nr_lib_process(struct comp_data *cd)
 
 #if CONFIG_FORMAT_S16LE
 static void igo_nr_capture_s16(struct comp_data *cd,
-			       const struct audio_stream *source,
-			       struct audio_stream *sink,
-			       int32_t frames)
+			       const struct igo_nr_buf *source,
+			       const struct igo_nr_buf *sink,
+			       int32_t nch, int32_t frames)
 {
-	int32_t nch = audio_stream_get_channels(source);
+	int16_t *x = source->ptr;
+	int16_t *y = sink->ptr;
 	int32_t i;
 	int32_t j;
-	int32_t idx_in = 0;
-	int32_t idx_out = 0;
-	int16_t *x;
-	int16_t *y;
 #if CONFIG_DEBUG
 	int32_t dbg_en = cd->config.igo_params.dump_data == 1 && nch > 1;
 	int32_t dbg_ch_idx;
@@ -89,53 +90,46 @@ static void igo_nr_capture_s16(struct comp_data *cd,
 		for (j = 0; j < nch; j++) {
 			if (j == cd->config.active_channel_idx)
 				continue;
-			x = audio_stream_read_frag_s16(source, idx_in + j);
-			y = audio_stream_write_frag_s16(sink, idx_in + j);
-			*y = (*x);
+			y[j] = x[j];
 		}
 
-		x = audio_stream_read_frag_s16(source, idx_in + cd->config.active_channel_idx);
-		cd->in[i] = (*x);
+		cd->in[i] = x[cd->config.active_channel_idx];
 
-		idx_in += nch;
+		x = cir_buf_wrap(x + nch, source->addr, source->end_addr);
+		y = cir_buf_wrap(y + nch, sink->addr, sink->end_addr);
 	}
 
 	igo_nr_lib_process(cd);
 
 	/* Interleave write the processed data into active output channel. */
+	y = sink->ptr;
 	for (i = 0; i < frames; i++) {
-		y = audio_stream_write_frag_s16(sink, idx_out + cd->config.active_channel_idx);
-		*y = (cd->out[i]);
+		y[cd->config.active_channel_idx] = cd->out[i];
 
 #if CONFIG_DEBUG
 		/* Under DEBUG mode, overwrite the next channel with input interleavedly. */
-		if (cd->config.active_channel_idx >= nch)
+		if (cd->config.active_channel_idx + 1 >= nch)
 			dbg_ch_idx = 0;
 		else
 			dbg_ch_idx = cd->config.active_channel_idx + 1;
-		if (dbg_en) {
-			y = audio_stream_write_frag_s16(sink, idx_out + dbg_ch_idx);
-			*y = (cd->in[i]);
-		}
+		if (dbg_en)
+			y[dbg_ch_idx] = cd->in[i];
 #endif
-		idx_out += nch;
+		y = cir_buf_wrap(y + nch, sink->addr, sink->end_addr);
 	}
 }
 #endif
 
 #if CONFIG_FORMAT_S24LE
 static void igo_nr_capture_s24(struct comp_data *cd,
-			       const struct audio_stream *source,
-			       struct audio_stream *sink,
-			       int32_t frames)
+			       const struct igo_nr_buf *source,
+			       const struct igo_nr_buf *sink,
+			       int32_t nch, int32_t frames)
 {
-	int32_t nch = audio_stream_get_channels(source);
+	int32_t *x = source->ptr;
+	int32_t *y = sink->ptr;
 	int32_t i;
 	int32_t j;
-	int32_t idx_in = 0;
-	int32_t idx_out = 0;
-	int32_t *x;
-	int32_t *y;
 #if CONFIG_DEBUG
 	int32_t dbg_en = cd->config.igo_params.dump_data == 1 && nch > 1;
 	int32_t dbg_ch_idx;
@@ -148,53 +142,46 @@ static void igo_nr_capture_s24(struct comp_data *cd,
 		for (j = 0; j < nch; j++) {
 			if (j == cd->config.active_channel_idx)
 				continue;
-			x = audio_stream_read_frag_s32(source, idx_in + j);
-			y = audio_stream_write_frag_s32(sink, idx_in + j);
-			*y = (*x);
+			y[j] = x[j];
 		}
 
-		x = audio_stream_read_frag_s32(source, idx_in + cd->config.active_channel_idx);
-		cd->in[i] = Q_SHIFT_RND(*x, 24, 16);
+		cd->in[i] = Q_SHIFT_RND(x[cd->config.active_channel_idx], 24, 16);
 
-		idx_in += nch;
+		x = cir_buf_wrap(x + nch, source->addr, source->end_addr);
+		y = cir_buf_wrap(y + nch, sink->addr, sink->end_addr);
 	}
 
 	igo_nr_lib_process(cd);
 
 	/* Interleave write the processed data into active output channel. */
+	y = sink->ptr;
 	for (i = 0; i < frames; i++) {
-		y = audio_stream_write_frag_s32(sink, idx_out + cd->config.active_channel_idx);
-		*y = (cd->out[i]) << 8;
+		y[cd->config.active_channel_idx] = cd->out[i] << 8;
 
 #if CONFIG_DEBUG
 		/* Under DEBUG mode, overwrite the next channel with input interleavedly. */
-		if (cd->config.active_channel_idx >= nch)
+		if (cd->config.active_channel_idx + 1 >= nch)
 			dbg_ch_idx = 0;
 		else
 			dbg_ch_idx = cd->config.active_channel_idx + 1;
-		if (dbg_en) {
-			y = audio_stream_write_frag_s32(sink, idx_out + dbg_ch_idx);
-			*y = (cd->in[i]) << 8;
-		}
+		if (dbg_en)
+			y[dbg_ch_idx] = cd->in[i] << 8;
 #endif
-		idx_out += nch;
+		y = cir_buf_wrap(y + nch, sink->addr, sink->end_addr);
 	}
 }
 #endif
 
 #if CONFIG_FORMAT_S32LE
 static void igo_nr_capture_s32(struct comp_data *cd,
-			       const struct audio_stream *source,
-			       struct audio_stream *sink,
-			       int32_t frames)
+			       const struct igo_nr_buf *source,
+			       const struct igo_nr_buf *sink,
+			       int32_t nch, int32_t frames)
 {
-	int32_t nch = audio_stream_get_channels(source);
+	int32_t *x = source->ptr;
+	int32_t *y = sink->ptr;
 	int32_t i;
 	int32_t j;
-	int32_t idx_in = 0;
-	int32_t idx_out = 0;
-	int32_t *x;
-	int32_t *y;
 #if CONFIG_DEBUG
 	int32_t dbg_en = cd->config.igo_params.dump_data == 1 && nch > 1;
 	int32_t dbg_ch_idx;
@@ -206,50 +193,43 @@ static void igo_nr_capture_s32(struct comp_data *cd,
 		for (j = 0; j < nch; j++) {
 			if (j == cd->config.active_channel_idx)
 				continue;
-			x = audio_stream_read_frag_s32(source, idx_in + j);
-			y = audio_stream_write_frag_s32(sink, idx_in + j);
-			*y = (*x);
+			y[j] = x[j];
 		}
 
-		x = audio_stream_read_frag_s32(source, idx_in + cd->config.active_channel_idx);
-		cd->in[i] = Q_SHIFT_RND(*x, 32, 16);
+		cd->in[i] = Q_SHIFT_RND(x[cd->config.active_channel_idx], 32, 16);
 
-		idx_in += nch;
+		x = cir_buf_wrap(x + nch, source->addr, source->end_addr);
+		y = cir_buf_wrap(y + nch, sink->addr, sink->end_addr);
 	}
 
 	igo_nr_lib_process(cd);
 
 	/* Interleave write the processed data into active output channel. */
+	y = sink->ptr;
 	for (i = 0; i < frames; i++) {
-		y = audio_stream_write_frag_s32(sink, idx_out + cd->config.active_channel_idx);
-		*y = (cd->out[i]) << 16;
+		y[cd->config.active_channel_idx] = cd->out[i] << 16;
 
 #if CONFIG_DEBUG
 		/* Under DEBUG mode, overwrite the next channel with input interleavedly. */
-		if (cd->config.active_channel_idx >= nch)
+		if (cd->config.active_channel_idx + 1 >= nch)
 			dbg_ch_idx = 0;
 		else
 			dbg_ch_idx = cd->config.active_channel_idx + 1;
-		if (dbg_en) {
-			y = audio_stream_write_frag_s32(sink, idx_out + dbg_ch_idx);
-			*y = (cd->in[i]) << 16;
-		}
+		if (dbg_en)
+			y[dbg_ch_idx] = cd->in[i] << 16;
 #endif
-		idx_out += nch;
+		y = cir_buf_wrap(y + nch, sink->addr, sink->end_addr);
 	}
 }
 #endif
 
-static inline int32_t set_capture_func(struct comp_dev *dev)
+static inline int32_t set_capture_func(struct processing_module *mod, struct sof_source *source)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct comp_buffer *sourceb;
-
-	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
-				  sink_list);
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 
 	/* The igo_nr supports S16_LE data. Format converter is needed. */
-	switch (audio_stream_get_frm_fmt(&sourceb->stream)) {
+	switch (source_get_frm_fmt(source)) {
 #if CONFIG_FORMAT_S16LE
 	case SOF_IPC_FRAME_S16_LE:
 		comp_info(dev, "set_capture_func(), SOF_IPC_FRAME_S16_LE");
@@ -275,183 +255,157 @@ static inline int32_t set_capture_func(struct comp_dev *dev)
 	return 0;
 }
 
-static struct comp_dev *igo_nr_new(const struct comp_driver *drv,
-				   const struct comp_ipc_config *config, const void *spec)
+static int igo_nr_init(struct processing_module *mod)
 {
-	const struct ipc_config_process *ipc_igo_nr = spec;
-	struct comp_dev *dev = NULL;
-	struct comp_data *cd = NULL;
-	size_t bs = ipc_igo_nr->size;
+	struct module_data *md = &mod->priv;
+	struct comp_dev *dev = mod->dev;
+	struct module_config *cfg = &md->cfg;
+	struct comp_data *cd;
+	size_t bs = cfg->size;
 	int32_t ret;
 
-	comp_cl_info(&comp_igo_nr, "igo_nr_new()");
+	comp_info(dev, "igo_nr_init()");
 
 	/* Check first that configuration blob size is sane */
 	if (bs > SOF_IGO_NR_MAX_SIZE) {
-		comp_cl_err(&comp_igo_nr, "igo_nr_new() error: configuration blob size = %u > %d",
-			    bs, SOF_IGO_NR_MAX_SIZE);
-		return NULL;
+		comp_err(dev, "igo_nr_init() error: configuration blob size = %u > %d",
+			 bs, SOF_IGO_NR_MAX_SIZE);
+		return -EINVAL;
 	}
 
-	dev = comp_alloc(drv, sizeof(*dev));
-	if (!dev)
-		return NULL;
-
-	dev->ipc_config = *config;
-
 	cd = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*cd));
 	if (!cd)
-		goto fail;
+		return -ENOMEM;
+
+	md->private = cd;
 
 	ret = IgoLibGetInfo(&cd->igo_lib_info);
 	if (ret != IGO_RET_OK) {
-		comp_cl_err(&comp_igo_nr, "igo_nr_new(): IgoLibGetInfo() Failed.");
+		comp_err(dev, "igo_nr_init(): IgoLibGetInfo() Failed.");
+		ret = -EINVAL;
 		goto cd_fail;
 	}
 
 	cd->p_handle = rballoc(0, SOF_MEM_CAPS_RAM, cd->igo_lib_info.handle_size);
 	if (!cd->p_handle) {
-		comp_cl_err(&comp_igo_nr, "igo_nr_new(): igo_handle memory rballoc error");
+		comp_err(dev, "igo_nr_init(): igo_handle memory rballoc error");
+		ret = -ENOMEM;
 		goto cd_fail;
 	}
 
-	comp_set_drvdata(dev, cd);
-
 	/* Handler for configuration data */
 	cd->model_handler = comp_data_blob_handler_new(dev);
 	if (!cd->model_handler) {
-		comp_cl_err(&comp_igo_nr, "igo_nr_new(): comp_data_blob_handler_new() failed.");
+		comp_err(dev, "igo_nr_init(): comp_data_blob_handler_new() failed.");
+		ret = -ENOMEM;
 		goto cd_fail;
 	}
 
 	/* Get configuration data */
-	ret = comp_init_data_blob(cd->model_handler, bs, ipc_igo_nr->data);
+	ret = comp_init_data_blob(cd->model_handler, bs, cfg->data);
 	if (ret < 0) {
-		comp_cl_err(&comp_igo_nr, "igo_nr_new(): comp_init_data_blob() failed.");
+		comp_err(dev, "igo_nr_init(): comp_init_data_blob() failed.");
 		goto cd_fail;
 	}
-	dev->state = COMP_STATE_READY;
 
-	comp_cl_info(&comp_igo_nr, "igo_nr created");
+	/* update downstream (playback) or upstream (capture) buffer parameters */
+	mod->verify_params_flags = BUFF_PARAMS_RATE;
 
-	return dev;
+	comp_info(dev, "igo_nr created");
+
+	return 0;
 
 cd_fail:
 	comp_data_blob_handler_free(cd->model_handler);
+	rfree(cd->p_handle);
 	rfree(cd);
-fail:
-	rfree(dev);
-	return NULL;
+	return ret;
 }
 
-static void igo_nr_free(struct comp_dev *dev)
+static int igo_nr_free(struct processing_module *mod)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 
-	comp_info(dev, "igo_nr_free()");
+	comp_info(mod->dev, "igo_nr_free()");
 
 	comp_data_blob_handler_free(cd->model_handler);
 
 	rfree(cd->p_handle);
 	rfree(cd);
-	rfree(dev);
+	return 0;
 }
 
-static int32_t igo_nr_verify_params(struct comp_dev *dev,
-				    struct sof_ipc_stream_params *params)
+#if CONFIG_IPC_MAJOR_4
+static void igo_nr_params(struct processing_module *mod)
 {
-	int32_t ret;
+	struct sof_ipc_stream_params *params = mod->stream_params;
+	struct comp_buffer *sinkb, *sourceb;
+	struct comp_dev *dev = mod->dev;
 
-	comp_dbg(dev, "igo_nr_verify_params()");
+	comp_dbg(dev, "igo_nr_params()");
 
-	/* update downstream (playback) or upstream (capture) buffer parameters
-	 */
-	ret = comp_verify_params(dev, BUFF_PARAMS_RATE, params);
-	if (ret < 0)
-		comp_err(dev, "igo_nr_verify_params(): comp_verify_params() failed.");
+	ipc4_base_module_cfg_to_stream_params(&mod->priv.cfg.base_cfg, params);
+	component_set_nearest_period_frames(dev, params->rate);
 
-	return ret;
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+	ipc4_update_buffer_format(sinkb, &mod->priv.cfg.base_cfg.audio_fmt);
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer, sink_list);
+	ipc4_update_buffer_format(sourceb, &mod->priv.cfg.base_cfg.audio_fmt);
 }
+#endif /* CONFIG_IPC_MAJOR_4 */
 
-/* set component audio stream parameters */
-static int32_t igo_nr_params(struct comp_dev *dev,
-			     struct sof_ipc_stream_params *pcm_params)
+/* check the stream parameters of the source and the sink */
+static int32_t igo_nr_check_params(struct processing_module *mod, struct sof_source *source,
+				   struct sof_sink *sink)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct comp_buffer *sinkb, *sourceb;
-	int32_t err;
-
-	comp_info(dev, "igo_nr_params()");
-
-	err = igo_nr_verify_params(dev, pcm_params);
-	if (err < 0) {
-		comp_err(dev, "igo_nr_params(): pcm params verification failed.");
-		return err;
-	}
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 
-	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
-				  sink_list);
-	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
-				source_list);
+	comp_info(dev, "igo_nr_check_params()");
 
 	/* set source/sink_frames/rate */
-	cd->source_rate = audio_stream_get_rate(&sourceb->stream);
-	cd->sink_rate = audio_stream_get_rate(&sinkb->stream);
+	cd->source_rate = source_get_rate(source);
+	cd->sink_rate = sink_get_rate(sink);
 
-	if (audio_stream_get_channels(&sourceb->stream) !=
-	    audio_stream_get_channels(&sinkb->stream)) {
-		comp_err(dev, "igo_nr_params(), mismatch source/sink stream channels");
+	if (source_get_channels(source) != sink_get_channels(sink)) {
+		comp_err(dev, "igo_nr_check_params(), mismatch source/sink stream channels");
 		cd->invalid_param = true;
 	}
 
 	if (!cd->sink_rate) {
-		comp_err(dev, "igo_nr_params(), zero sink rate");
+		comp_err(dev, "igo_nr_check_params(), zero sink rate");
 		return -EINVAL;
 	}
 
-	cd->sink_frames = dev->frames;
-	cd->source_frames = ceil_divide(dev->frames * cd->source_rate,
-					cd->sink_rate);
-
-	/* Use empirical add +10 for target frames number to avoid xruns and
-	 * distorted audio in beginning of streaming. It's slightly more than
-	 * min. needed and does not increase much peak load and buffer memory
-	 * consumption. The copy() function will find the limits and process
-	 * less frames after the buffers levels stabilize.
-	 */
-	cd->source_frames_max = cd->source_frames + 10;
-	cd->sink_frames_max = cd->sink_frames + 10;
-	cd->frames = MAX(cd->source_frames_max, cd->sink_frames_max);
-
-	comp_dbg(dev, "igo_nr_params(), source_rate=%u, sink_rate=%u, source_frames_max=%d, sink_frames_max=%d",
-		 cd->source_rate, cd->sink_rate,
-		 cd->source_frames_max, cd->sink_frames_max);
+	comp_dbg(dev, "igo_nr_check_params(), source_rate=%u, sink_rate=%u",
+		 cd->source_rate, cd->sink_rate);
 
 	/* The igo_nr supports sample rate 48000 only. */
 	switch (cd->source_rate) {
 	case 48000:
-		comp_info(dev, "igo_nr_params(), sample rate = 48000");
+		comp_info(dev, "igo_nr_check_params(), sample rate = 48000");
 		cd->invalid_param = false;
 		break;
 	default:
-		comp_err(dev, "igo_nr_params(), invalid sample rate");
+		comp_err(dev, "igo_nr_check_params(), invalid sample rate");
 		cd->invalid_param = true;
 	}
 
 	return cd->invalid_param ? -EINVAL : 0;
 }
 
-static inline void igo_nr_set_chan_process(struct comp_dev *dev, int32_t chan)
+static inline void igo_nr_set_chan_process(struct processing_module *mod, int32_t chan)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 
 	if (!cd->process_enable[chan])
 		cd->process_enable[chan] = true;
 }
 
-static inline void igo_nr_set_chan_passthrough(struct comp_dev *dev, int32_t chan)
+static inline void igo_nr_set_chan_passthrough(struct processing_module *mod, int32_t chan)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 
 	if (cd->process_enable[chan]) {
 		cd->process_enable[chan] = false;
@@ -459,29 +413,12 @@ static inline void igo_nr_set_chan_passthrough(struct comp_dev *dev, int32_t cha
 	}
 }
 
-static int32_t igo_nr_cmd_get_data(struct comp_dev *dev,
-				   struct sof_ipc_ctrl_data *cdata,
-				   int32_t max_size)
+#if CONFIG_IPC_MAJOR_3
+static int32_t igo_nr_cmd_get_value(struct processing_module *mod,
+				    struct sof_ipc_ctrl_data *cdata)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t ret;
-
-	switch (cdata->cmd) {
-	case SOF_CTRL_CMD_BINARY:
-		comp_info(dev, "igo_nr_cmd_get_data(), SOF_CTRL_CMD_BINARY");
-		ret = comp_data_blob_get_cmd(cd->model_handler, cdata, max_size);
-		break;
-	default:
-		comp_err(dev, "igo_nr_cmd_get_data() error: invalid cdata->cmd %u", cdata->cmd);
-		ret = -EINVAL;
-		break;
-	}
-	return ret;
-}
-
-static int32_t igo_nr_cmd_get_value(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
-{
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 	int32_t j;
 	int32_t ret = 0;
 
@@ -502,11 +439,29 @@ static int32_t igo_nr_cmd_get_value(struct comp_dev *dev, struct sof_ipc_ctrl_da
 	}
 	return ret;
 }
+#endif
 
-static int32_t igo_nr_check_config_validity(struct comp_dev *dev,
+static int igo_nr_get_config(struct processing_module *mod,
+			     uint32_t config_id, uint32_t *data_offset_size,
+			     uint8_t *fragment, size_t fragment_size)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct sof_ipc_ctrl_data *cdata = (struct sof_ipc_ctrl_data *)fragment;
+
+#if CONFIG_IPC_MAJOR_3
+	if (cdata->cmd != SOF_CTRL_CMD_BINARY)
+		return igo_nr_cmd_get_value(mod, cdata);
+#endif
+
+	comp_info(mod->dev, "igo_nr_get_config(), SOF_CTRL_CMD_BINARY");
+	return comp_data_blob_get_cmd(cd->model_handler, cdata, fragment_size);
+}
+
+static int32_t igo_nr_check_config_validity(struct processing_module *mod,
 					    struct comp_data *cd)
 {
 	struct sof_igo_nr_config *p_config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	struct comp_dev *dev = mod->dev;
 
 	if (!p_config) {
 		comp_err(dev, "igo_nr_check_config_validity() error: invalid cd->model_handler");
@@ -519,123 +474,87 @@ static int32_t igo_nr_check_config_validity(struct comp_dev *dev,
 	}
 }
 
-static int32_t igo_nr_cmd_set_data(struct comp_dev *dev,
-				   struct sof_ipc_ctrl_data *cdata)
+static int32_t igo_nr_set_chan(struct processing_module *mod, int32_t ch, uint32_t val)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t ret;
-
-	switch (cdata->cmd) {
-	case SOF_CTRL_CMD_BINARY:
-		comp_info(dev, "igo_nr_cmd_set_data(), SOF_CTRL_CMD_BINARY");
-		ret = comp_data_blob_set_cmd(cd->model_handler, cdata);
-		break;
-	default:
-		comp_err(dev, "igo_nr_cmd_set_data() error: invalid cdata->cmd");
-		ret = -EINVAL;
-		break;
+	comp_info(mod->dev, "igo_nr_set_chan(), channel = %d, value = %u", ch, val);
+	if (ch < 0 || ch >= SOF_IPC_MAX_CHANNELS) {
+		comp_err(mod->dev, "igo_nr_set_chan(), illegal channel = %d", ch);
+		return -EINVAL;
 	}
 
-	if (ret >= 0)
-		ret = igo_nr_check_config_validity(dev, cd);
+	if (val)
+		igo_nr_set_chan_process(mod, ch);
+	else
+		igo_nr_set_chan_passthrough(mod, ch);
 
-	return ret;
+	return 0;
 }
 
-static int32_t igo_nr_set_chan(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
+static int igo_nr_set_config(struct processing_module *mod, uint32_t param_id,
+			     enum module_cfg_fragment_position pos,
+			     uint32_t data_offset_size, const uint8_t *fragment,
+			     size_t fragment_size, uint8_t *response,
+			     size_t response_size)
 {
-	uint32_t val;
-	int32_t ch;
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
+	int32_t ret;
 	int32_t j;
 
-	for (j = 0; j < cdata->num_elems; j++) {
-		ch = cdata->chanv[j].channel;
-		val = cdata->chanv[j].value;
-		comp_info(dev, "igo_nr_cmd_set_value(), channel = %d, value = %u", ch, val);
-		if (ch < 0 || ch >= SOF_IPC_MAX_CHANNELS) {
-			comp_err(dev, "igo_nr_cmd_set_value(), illegal channel = %d", ch);
-			return -EINVAL;
+#if CONFIG_IPC_MAJOR_4
+	struct sof_ipc4_control_msg_payload *ctl = (struct sof_ipc4_control_msg_payload *)fragment;
+
+	switch (param_id) {
+	case SOF_IPC4_SWITCH_CONTROL_PARAM_ID:
+		comp_dbg(dev, "SOF_IPC4_SWITCH_CONTROL_PARAM_ID id = %d, num_elems = %d",
+			 ctl->id, ctl->num_elems);
+
+		for (j = 0; j < ctl->num_elems; j++) {
+			ret = igo_nr_set_chan(mod, ctl->chanv[j].channel, ctl->chanv[j].value);
+			if (ret)
+				return ret;
 		}
+		return 0;
 
-		if (val)
-			igo_nr_set_chan_process(dev, ch);
-		else
-			igo_nr_set_chan_passthrough(dev, ch);
+	case SOF_IPC4_ENUM_CONTROL_PARAM_ID:
+		comp_err(dev, "igo_nr_set_config(), illegal control.");
+		return -EINVAL;
 	}
 
-	return 0;
-}
-
-static int32_t igo_nr_cmd_set_value(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
-{
-	int32_t ret;
+#elif CONFIG_IPC_MAJOR_3
+	struct sof_ipc_ctrl_data *cdata = (struct sof_ipc_ctrl_data *)fragment;
 
 	switch (cdata->cmd) {
+	case SOF_CTRL_CMD_BINARY:
+		break;
 	case SOF_CTRL_CMD_SWITCH:
-		comp_dbg(dev, "igo_nr_cmd_set_value(), SOF_CTRL_CMD_SWITCH, cdata->comp_id = %u",
+		comp_dbg(dev, "igo_nr_set_config(), SOF_CTRL_CMD_SWITCH, cdata->comp_id = %u",
 			 cdata->comp_id);
-		ret = igo_nr_set_chan(dev, cdata);
-		break;
-
-	default:
-		comp_err(dev, "igo_nr_cmd_set_value() error: invalid cdata->cmd");
-		ret = -EINVAL;
-		break;
-	}
-
-	return ret;
-}
-
-/* used to pass standard and bespoke commands (with data) to component */
-static int32_t igo_nr_cmd(struct comp_dev *dev,
-			  int32_t cmd,
-			  void *data,
-			  int32_t max_data_size)
-{
-	struct sof_ipc_ctrl_data *cdata = data;
-
-	comp_info(dev, "igo_nr_cmd()");
-
-	switch (cmd) {
-	case COMP_CMD_SET_DATA:
-		return igo_nr_cmd_set_data(dev, cdata);
-	case COMP_CMD_GET_DATA:
-		return igo_nr_cmd_get_data(dev, cdata, max_data_size);
-	case COMP_CMD_SET_VALUE:
-		return igo_nr_cmd_set_value(dev, cdata);
-	case COMP_CMD_GET_VALUE:
-		return igo_nr_cmd_get_value(dev, cdata);
+		for (j = 0; j < cdata->num_elems; j++) {
+			ret = igo_nr_set_chan(mod, cdata->chanv[j].channel, cdata->chanv[j].value);
+			if (ret)
+				return ret;
+		}
+		return 0;
 	default:
-		comp_err(dev, "igo_nr_cmd() error: invalid command");
+		comp_err(dev, "igo_nr_set_config() error: invalid cdata->cmd");
 		return -EINVAL;
 	}
-}
-
-static void igo_nr_process(struct comp_dev *dev,
-			   struct comp_buffer *source,
-			   struct comp_buffer *sink,
-			   struct comp_copy_limits *cl,
-			   int32_t frames)
-
-{
-	struct comp_data *cd = comp_get_drvdata(dev);
-	uint32_t source_bytes = frames * cl->source_frame_bytes;
-	uint32_t sink_bytes = frames * cl->sink_frame_bytes;
-
-	buffer_stream_invalidate(source, source_bytes);
-
-	cd->igo_nr_func(cd, &source->stream, &sink->stream, frames);
+#endif
 
-	buffer_stream_writeback(sink, sink_bytes);
+	comp_info(dev, "igo_nr_set_config(), SOF_CTRL_CMD_BINARY");
+	ret = comp_data_blob_set(cd->model_handler, pos, data_offset_size, fragment,
+				 fragment_size);
+	if (ret >= 0)
+		ret = igo_nr_check_config_validity(mod, cd);
 
-	/* calc new free and available */
-	comp_update_buffer_consume(source, source_bytes);
-	comp_update_buffer_produce(sink, sink_bytes);
+	return ret;
 }
 
-static void igo_nr_print_config(struct comp_dev *dev)
+static void igo_nr_print_config(struct processing_module *mod)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 
 	comp_dbg(dev, "  igo_params_ver		%d",
 		 cd->config.igo_params.igo_params_ver);
@@ -674,59 +593,96 @@ static void igo_nr_print_config(struct comp_dev *dev)
 
 }
 
-static void igo_nr_set_igo_params(struct comp_dev *dev)
+static void igo_nr_set_igo_params(struct processing_module *mod)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 	struct sof_igo_nr_config *p_config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	struct comp_dev *dev = mod->dev;
 
 	comp_info(dev, "igo_nr_set_igo_params()");
-	igo_nr_check_config_validity(dev, cd);
+	igo_nr_check_config_validity(mod, cd);
 
 	if (p_config) {
 		comp_info(dev, "New config detected.");
 		cd->config = *p_config;
-		igo_nr_print_config(dev);
+		igo_nr_print_config(mod);
 	}
 }
 
-/* copy and process stream data from source to sink buffers */
-static int32_t igo_nr_copy(struct comp_dev *dev)
+/* A DP instance runs once per library frame */
+static bool igo_nr_is_ready_to_process(struct processing_module *mod,
+				       struct sof_source **sources, int num_of_sources,
+				       struct sof_sink **sinks, int num_of_sinks)
 {
-	struct comp_copy_limits cl;
-	struct comp_buffer *sourceb, *sinkb;
-	struct comp_data *cd = comp_get_drvdata(dev);
+	return source_get_data_frames_available(sources[0]) >= IGO_FRAME_SIZE &&
+		sink_get_free_frames(sinks[0]) >= IGO_FRAME_SIZE;
+}
+
+/* process stream data from source to sink */
+static int igo_nr_process(struct processing_module *mod,
+			  struct sof_source **sources, int num_of_sources,
+			  struct sof_sink **sinks, int num_of_sinks)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct sof_source *source = sources[0];
+	struct sof_sink *sink = sinks[0];
+	struct comp_dev *dev = mod->dev;
+	struct igo_nr_buf in, out;
+	const void *src_ptr, *src_start;
+	void *dst_start;
+	size_t src_size, dst_size;
+	uint32_t source_bytes;
+	uint32_t sink_bytes;
 	int32_t src_frames;
 	int32_t sink_frames;
+	int ret;
 
-	comp_dbg(dev, "igo_nr_copy()");
-
-	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
-				  sink_list);
-	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
-				source_list);
+	comp_dbg(dev, "igo_nr_process()");
 
 	/* Check for changed configuration */
 	if (comp_is_new_data_blob_available(cd->model_handler))
-		igo_nr_set_igo_params(dev);
+		igo_nr_set_igo_params(mod);
 
-	/* Get source, sink, number of frames etc. to process. */
-	comp_get_copy_limits(sourceb, sinkb, &cl);
-
-	src_frames = audio_stream_get_avail_frames(&sourceb->stream);
-	sink_frames = audio_stream_get_free_frames(&sinkb->stream);
+	src_frames = source_get_data_frames_available(source);
+	sink_frames = sink_get_free_frames(sink);
 
 	comp_dbg(dev, "src_frames = %d, sink_frames = %d.", src_frames, sink_frames);
 
 	/* Process only when frames count is enough. */
-	if (src_frames >= IGO_FRAME_SIZE && sink_frames >= IGO_FRAME_SIZE)
-		igo_nr_process(dev, sourceb, sinkb, &cl, IGO_FRAME_SIZE);
+	if (src_frames < IGO_FRAME_SIZE || sink_frames < IGO_FRAME_SIZE)
+		return 0;
+
+	source_bytes = IGO_FRAME_SIZE * source_get_frame_bytes(source);
+	sink_bytes = IGO_FRAME_SIZE * sink_get_frame_bytes(sink);
+
+	ret = source_get_data(source, source_bytes, &src_ptr, &src_start, &src_size);
+	if (ret)
+		return ret;
+
+	ret = sink_get_buffer(sink, sink_bytes, &out.ptr, &dst_start, &dst_size);
+	if (ret) {
+		source_release_data(source, 0);
+		return ret;
+	}
+
+	in.ptr = (void *)src_ptr;
+	in.addr = (void *)src_start;
+	in.end_addr = (uint8_t *)src_start + src_size;
+	out.addr = dst_start;
+	out.end_addr = (uint8_t *)dst_start + dst_size;
+
+	cd->igo_nr_func(cd, &in, &out, source_get_channels(source), IGO_FRAME_SIZE);
+
+	/* calc new free and available */
+	source_release_data(source, source_bytes);
+	sink_commit_buffer(sink, sink_bytes);
 
 	return 0;
 }
 
-static void igo_nr_lib_init(struct comp_dev *dev)
+static void igo_nr_lib_init(struct processing_module *mod)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 
 	cd->igo_lib_config.algo_name = "igo_nr";
 	cd->igo_lib_config.in_ch_num = 1;
@@ -750,26 +706,30 @@ static void igo_nr_lib_init(struct comp_dev *dev)
 	cd->igo_stream_data_out.sampling_rate = 48000;
 }
 
-static int32_t igo_nr_prepare(struct comp_dev *dev)
+static int igo_nr_prepare(struct processing_module *mod,
+			  struct sof_source **sources, int num_of_sources,
+			  struct sof_sink **sinks, int num_of_sinks)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 	int32_t ret;
 
 	comp_dbg(dev, "igo_nr_prepare()");
 
-	igo_nr_set_igo_params(dev);
-
-	igo_nr_lib_init(dev);
-
-	comp_dbg(dev, "post igo_nr_lib_init");
-	igo_nr_print_config(dev);
+#if CONFIG_IPC_MAJOR_4
+	igo_nr_params(mod);
+#endif
 
-	ret = comp_set_state(dev, COMP_TRIGGER_PREPARE);
+	ret = igo_nr_check_params(mod, sources[0], sinks[0]);
 	if (ret < 0)
 		return ret;
 
-	if (ret == COMP_STATUS_STATE_ALREADY_SET)
-		return PPL_STATUS_PATH_STOP;
+	igo_nr_set_igo_params(mod);
+
+	igo_nr_lib_init(mod);
+
+	comp_dbg(dev, "post igo_nr_lib_init");
+	igo_nr_print_config(mod);
 
 	/* Clear in/out buffers */
 	memset(cd->in, 0, IGO_NR_IN_BUF_LENGTH * sizeof(int16_t));
@@ -778,67 +738,41 @@ static int32_t igo_nr_prepare(struct comp_dev *dev)
 	/* Default NR on */
 	cd->process_enable[cd->config.active_channel_idx] = true;
 
-	return set_capture_func(dev);
+	/* A DP instance gets whole library frames, size its queues for them */
+	if (dev->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_DP) {
+		source_set_min_available(sources[0],
+					 IGO_FRAME_SIZE * source_get_frame_bytes(sources[0]));
+		sink_set_min_free_space(sinks[0], IGO_FRAME_SIZE * sink_get_frame_bytes(sinks[0]));
+	}
+
+	return set_capture_func(mod, sources[0]);
 }
 
-static int32_t igo_nr_reset(struct comp_dev *dev)
+static int igo_nr_reset(struct processing_module *mod)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 
-	comp_info(dev, "igo_nr_reset()");
+	comp_info(mod->dev, "igo_nr_reset()");
 
 	cd->igo_nr_func = NULL;
 
 	cd->source_rate = 0;
 	cd->sink_rate = 0;
-	cd->source_frames = 0;
-	cd->sink_frames = 0;
-	cd->source_frames_max = 0;
-	cd->sink_frames_max = 0;
-	cd->frames = 0;
 	cd->invalid_param = false;
 
-	comp_set_state(dev, COMP_TRIGGER_RESET);
 	return 0;
 }
 
-static int32_t igo_nr_trigger(struct comp_dev *dev, int32_t cmd)
-{
-	int32_t ret;
-
-	comp_info(dev, "igo_nr_trigger(), command = %u", cmd);
-
-	ret = comp_set_state(dev, cmd);
-	if (ret == COMP_STATUS_STATE_ALREADY_SET)
-		ret = PPL_STATUS_PATH_STOP;
-
-	return ret;
-}
-
-static const struct comp_driver comp_igo_nr = {
-	.uid = SOF_RT_UUID(igo_nr_uuid),
-	.tctx	= &igo_nr_tr,
-	.ops = {
-		.create = igo_nr_new,
-		.free = igo_nr_free,
-		.params = igo_nr_params,
-		.cmd = igo_nr_cmd,
-		.copy = igo_nr_copy,
-		.prepare = igo_nr_prepare,
-		.reset = igo_nr_reset,
-		.trigger = igo_nr_trigger,
-	},
-};
-
-static SHARED_DATA struct comp_driver_info comp_igo_nr_info = {
-	.drv = &comp_igo_nr,
+static struct module_interface igo_nr_interface = {
+	.init = igo_nr_init,
+	.prepare = igo_nr_prepare,
+	.process = igo_nr_process,
+	.is_ready_to_process = igo_nr_is_ready_to_process,
+	.set_configuration = igo_nr_set_config,
+	.get_configuration = igo_nr_get_config,
+	.reset = igo_nr_reset,
+	.free = igo_nr_free,
 };
 
-UT_STATIC void sys_comp_igo_nr_init(void)
-{
-	comp_register(platform_shared_get(&comp_igo_nr_info,
-					  sizeof(comp_igo_nr_info)));
-}
-
-DECLARE_MODULE(sys_comp_igo_nr_init);
-SOF_MODULE_INIT(igo_nr, sys_comp_igo_nr_init);
+DECLARE_MODULE_ADAPTER(igo_nr_interface, igo_nr_uuid, igo_nr_tr);
+SOF_MODULE_INIT(igo_nr, sys_comp_module_igo_nr_interface_init);
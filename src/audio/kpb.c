@@ -86,11 +86,12 @@ struct comp_data {
 #endif
 	struct sof_kpb_config config;   /**< component configuration data */
 	struct history_data hd; /** data related to history buffer */
-	struct task draining_task;
-	struct draining_data draining_task_data;
+	struct task draining_task; /**< drains all active clients */
+	struct draining_data drain[KPB_MAX_NO_OF_CLIENTS]; /**< per client cursors */
 	struct kpb_client clients[KPB_MAX_NO_OF_CLIENTS];
 	struct comp_buffer *sel_sink; /**< real time sink (channel selector)*/
 	struct comp_buffer *host_sink; /**< draining sink (client) */
+	struct comp_buffer *drain_sinks[KPB_MAX_NO_OF_CLIENTS]; /**< sink of each client */
 	uint32_t kpb_no_of_clients; /**< number of registered clients */
 	uint32_t source_period_bytes; /**< source number of period bytes */
 	uint32_t sink_period_bytes; /**< sink number of period bytes */
@@ -222,6 +223,31 @@ static void kpb_lock_init(struct comp_data *kpb)
 
 #endif /* __ZEPHYR__ */
 
+#if CONFIG_KPB_HISTORY_COMPAND
+/* 24 and 32 bit samples are stored as 16 bit companded words */
+static inline bool kpb_is_history_companded(struct comp_data *kpb)
+{
+	return kpb->config.sampling_width != 16;
+}
+#else
+static inline bool kpb_is_history_companded(struct comp_data *kpb)
+{
+	return false;
+}
+#endif
+
+/* history buffer memory used to store size bytes of stream data */
+static inline size_t kpb_stream_to_hb_bytes(struct comp_data *kpb, size_t size)
+{
+	return kpb_is_history_companded(kpb) ? size >> 1 : size;
+}
+
+/* stream data stored in size bytes of history buffer memory */
+static inline size_t kpb_hb_to_stream_bytes(struct comp_data *kpb, size_t size)
+{
+	return kpb_is_history_companded(kpb) ? size << 1 : size;
+}
+
 #if CONFIG_IPC_MAJOR_4
 /**
  * \brief Set and verify ipc params.
@@ -360,10 +386,15 @@ static int kpb_bind(struct comp_dev *dev, void *data)
 		sink_buf_id = sink->id;
 
 		if (sink_buf_id == buf_id) {
-			if (sink_buf_id == 0)
+			if (sink_buf_id == 0) {
 				kpb->sel_sink = sink;
-			else
+			} else {
 				kpb->host_sink = sink;
+				/* output pin n > 0 is the sink of client n - 1 */
+				if (bu->extension.r.src_queue &&
+				    bu->extension.r.src_queue <= KPB_MAX_NO_OF_CLIENTS)
+					kpb->drain_sinks[bu->extension.r.src_queue - 1] = sink;
+			}
 		}
 	}
 
@@ -388,10 +419,14 @@ static int kpb_unbind(struct comp_dev *dev, void *data)
 	buf_id = IPC4_COMP_ID(bu->extension.r.src_queue, bu->extension.r.dst_queue);
 
 	/* Reset sinks when unbinding */
-	if (buf_id == 0)
+	if (buf_id == 0) {
 		kpb->sel_sink = NULL;
-	else
+	} else {
 		kpb->host_sink = NULL;
+		if (bu->extension.r.src_queue &&
+		    bu->extension.r.src_queue <= KPB_MAX_NO_OF_CLIENTS)
+			kpb->drain_sinks[bu->extension.r.src_queue - 1] = NULL;
+	}
 
 	/* Clear fmt config */
 	return clear_fmt_modules_list(&kpb->fmt_device_list, bu->extension.r.src_queue);
@@ -508,9 +543,10 @@ static struct comp_dev *kpb_new(const struct comp_driver *drv,
 	schedule_task_init_edf(&kpb->draining_task, /* task structure */
 			       SOF_UUID(kpb_task_uuid), /* task uuid */
 			       &ops, /* task ops */
-			       &kpb->draining_task_data, /* task private data */
+			       dev, /* task private data */
 			       0, /* core on which we should run */
 			       0); /* no flags */
+	schedule_task_edf_set_class(&kpb->draining_task, EDF_CLASS_DRAIN);
 
 	/* Init basic component data */
 	kpb->hd.c_hb = NULL;
@@ -691,6 +727,7 @@ static void kpb_free(struct comp_dev *dev)
 	kpb_free_history_buffer(kpb->hd.c_hb);
 	kpb->hd.c_hb = NULL;
 	kpb->hd.buffer_size = 0;
+	kpb->hd.alloc_size = 0;
 
 	/* remove scheduling */
 	schedule_task_free(&kpb->draining_task);
@@ -782,6 +819,7 @@ static int kpb_prepare(struct comp_dev *dev)
 	int ret = 0;
 	int i;
 	size_t hb_size_req = KPB_MAX_BUFFER_SIZE(kpb->config.sampling_width, kpb->config.channels);
+	size_t hb_mem_req = kpb_stream_to_hb_bytes(kpb, hb_size_req);
 
 	comp_dbg(dev, "kpb_prepare()");
 
@@ -810,7 +848,7 @@ static int kpb_prepare(struct comp_dev *dev)
 	kpb->kpb_no_of_clients = 0;
 	kpb->hd.buffered = 0;
 
-	if (kpb->hd.c_hb && kpb->hd.buffer_size < hb_size_req) {
+	if (kpb->hd.c_hb && kpb->hd.alloc_size < hb_mem_req) {
 		/* Host params has changed, we need to allocate new buffer */
 		kpb_free_history_buffer(kpb->hd.c_hb);
 		kpb->hd.c_hb = NULL;
@@ -818,18 +856,22 @@ static int kpb_prepare(struct comp_dev *dev)
 
 	if (!kpb->hd.c_hb) {
 		/* Allocate history buffer */
-		kpb->hd.buffer_size = kpb_allocate_history_buffer(kpb,
-								  hb_size_req);
+		kpb->hd.alloc_size = kpb_allocate_history_buffer(kpb,
+								 hb_mem_req);
 
 		/* Have we allocated what we requested? */
-		if (kpb->hd.buffer_size < hb_size_req) {
+		if (kpb->hd.alloc_size < hb_mem_req) {
 			comp_cl_err(&comp_kpb, "kpb_prepare(): failed to allocate space for KPB buffer");
 			kpb_free_history_buffer(kpb->hd.c_hb);
 			kpb->hd.c_hb = NULL;
 			kpb->hd.buffer_size = 0;
+			kpb->hd.alloc_size = 0;
 			return -EINVAL;
 		}
 	}
+	/* The stream data fitting in the buffer depends on the stored format */
+	kpb->hd.buffer_size = kpb_hb_to_stream_bytes(kpb, kpb->hd.alloc_size);
+
 	/* Init history buffer */
 	kpb_reset_history_buffer(kpb->hd.c_hb);
 	kpb->hd.free = kpb->hd.buffer_size;
@@ -838,6 +880,7 @@ static int kpb_prepare(struct comp_dev *dev)
 	for (i = 0; i < KPB_MAX_NO_OF_CLIENTS; i++) {
 		kpb->clients[i].state = KPB_CLIENT_UNREGISTERED;
 		kpb->clients[i].r_ptr = NULL;
+		kpb->drain[i].is_draining_active = 0;
 	}
 
 #if CONFIG_AMS
@@ -863,6 +906,7 @@ static int kpb_prepare(struct comp_dev *dev)
 	 * is connected to the KPB sinks as well as host device.
 	 */
 	struct list_item *blist;
+	int host_sinks = 0;
 
 	list_for_item(blist, &dev->bsink_list) {
 		struct comp_buffer *sink = container_of(blist, struct comp_buffer, source_list);
@@ -880,8 +924,10 @@ static int kpb_prepare(struct comp_dev *dev)
 			kpb->sel_sink = sink;
 			break;
 		case SOF_COMP_HOST:
-			/* We found proper host sink */
+			/* We found proper host sink, clients get them in order */
 			kpb->host_sink = sink;
+			if (host_sinks < KPB_MAX_NO_OF_CLIENTS)
+				kpb->drain_sinks[host_sinks++] = sink;
 			break;
 		default:
 			break;
@@ -977,6 +1023,8 @@ static int kpb_reset(struct comp_dev *dev)
 		for (i = 0; i < KPB_MAX_NO_OF_CLIENTS; i++) {
 			kpb->clients[i].state = KPB_CLIENT_UNREGISTERED;
 			kpb->clients[i].r_ptr = NULL;
+			kpb->drain[i].is_draining_active = 0;
+			kpb->drain_sinks[i] = NULL;
 		}
 
 		if (kpb->hd.c_hb) {
@@ -1000,6 +1048,19 @@ static int kpb_reset(struct comp_dev *dev)
 	return ret;
 }
 
+/*
+ * The selected channels of a frame are copied in one pass over the input.
+ * The frames are processed in chunks that end at the first wrap of the
+ * input or of the output, so the inner loops need no wrap checks.
+ */
+static uint32_t kpb_micselect_chunk(const struct audio_stream *istream, const void *in,
+				    const struct audio_stream *ostream, const void *out,
+				    uint32_t frames)
+{
+	frames = MIN(frames, audio_stream_frames_without_wrap(istream, in));
+	return MIN(frames, audio_stream_frames_without_wrap(ostream, out));
+}
+
 #ifdef KPB_HIFI3
 #if CONFIG_FORMAT_S16LE
 static void kpb_micselect_copy16(struct comp_buffer *sink,
@@ -1008,29 +1069,32 @@ static void kpb_micselect_copy16(struct comp_buffer *sink,
 {
 	struct audio_stream *istream = &source->stream;
 	struct audio_stream *ostream = &sink->stream;
-	uint16_t ch;
-	size_t i;
-
-	AE_SETCBEGIN0(audio_stream_get_addr(ostream));
-	AE_SETCEND0(audio_stream_get_end_addr(ostream));
-
-	buffer_stream_invalidate(source, size);
-	const ae_int16 *in_ptr = audio_stream_get_rptr(istream);
-	ae_int16x4 d16 = AE_ZERO16();
 	const size_t in_offset = in_channels * sizeof(ae_int16);
 	const size_t out_offset = micsel_channels * sizeof(ae_int16);
-	const size_t samples_per_chan = size / (sizeof(uint16_t) * micsel_channels);
-	ae_int16 *out_ptr;
+	uint32_t frames = size / out_offset;
+	const ae_int16 *in_ptr = audio_stream_get_rptr(istream);
+	ae_int16 *out_ptr = audio_stream_get_wptr(ostream);
+	const ae_int16 *input_data;
+	ae_int16 *output_data;
+	ae_int16x4 d16 = AE_ZERO16();
+	uint32_t n, i;
+	uint16_t ch;
 
-	for (ch = 0; ch < micsel_channels; ch++) {
-		const ae_int16 *input_data = (const ae_int16 *)(in_ptr) + offsets[ch];
+	buffer_stream_invalidate(source, frames * in_offset);
 
-		out_ptr = audio_stream_get_wptr(ostream);
-		out_ptr += ch;
-		for (i = 0; i < samples_per_chan; i++) {
-			AE_L16_XP(d16, input_data, in_offset);
-			AE_S16_0_XC(d16, out_ptr, out_offset);
+	while (frames) {
+		n = kpb_micselect_chunk(istream, in_ptr, ostream, out_ptr, frames);
+		for (ch = 0; ch < micsel_channels; ch++) {
+			input_data = in_ptr + offsets[ch];
+			output_data = out_ptr + ch;
+			for (i = 0; i < n; i++) {
+				AE_L16_XP(d16, input_data, in_offset);
+				AE_S16_0_XP(d16, output_data, out_offset);
+			}
 		}
+		in_ptr = audio_stream_wrap(istream, (ae_int16 *)in_ptr + n * in_channels);
+		out_ptr = audio_stream_wrap(ostream, out_ptr + n * micsel_channels);
+		frames -= n;
 	}
 }
 #endif
@@ -1041,30 +1105,32 @@ static void kpb_micselect_copy32(struct comp_buffer *sink,
 {
 	struct audio_stream *istream = &source->stream;
 	struct audio_stream *ostream = &sink->stream;
-	uint16_t ch;
-	size_t i;
-
-	AE_SETCBEGIN0(audio_stream_get_addr(ostream));
-	AE_SETCEND0(audio_stream_get_end_addr(ostream));
-
-	buffer_stream_invalidate(source, size);
-
-	const ae_int32 *in_ptr = audio_stream_get_rptr(istream);
-	ae_int32x2 d32 = AE_ZERO32();
 	const size_t in_offset = in_channels * sizeof(ae_int32);
 	const size_t out_offset = micsel_channels * sizeof(ae_int32);
-	const size_t samples_per_chan = size / (sizeof(uint32_t) * micsel_channels);
-	ae_int32 *out_ptr;
+	uint32_t frames = size / out_offset;
+	const ae_int32 *in_ptr = audio_stream_get_rptr(istream);
+	ae_int32 *out_ptr = audio_stream_get_wptr(ostream);
+	const ae_int32 *input_data;
+	ae_int32 *output_data;
+	ae_int32x2 d32 = AE_ZERO32();
+	uint32_t n, i;
+	uint16_t ch;
 
-	for (ch = 0; ch < micsel_channels; ch++) {
-		const ae_int32 *input_data = (const ae_int32 *)(in_ptr) + offsets[ch];
+	buffer_stream_invalidate(source, frames * in_offset);
 
-		out_ptr = audio_stream_get_wptr(ostream);
-		out_ptr += ch;
-		for (i = 0; i < samples_per_chan; i++) {
-			AE_L32_XP(d32, input_data, in_offset);
-			AE_S32_L_XC(d32, out_ptr, out_offset);
+	while (frames) {
+		n = kpb_micselect_chunk(istream, in_ptr, ostream, out_ptr, frames);
+		for (ch = 0; ch < micsel_channels; ch++) {
+			input_data = in_ptr + offsets[ch];
+			output_data = out_ptr + ch;
+			for (i = 0; i < n; i++) {
+				AE_L32_XP(d32, input_data, in_offset);
+				AE_S32_L_XP(d32, output_data, out_offset);
+			}
 		}
+		in_ptr = audio_stream_wrap(istream, (ae_int32 *)in_ptr + n * in_channels);
+		out_ptr = audio_stream_wrap(ostream, out_ptr + n * micsel_channels);
+		frames -= n;
 	}
 }
 #endif
@@ -1075,29 +1141,25 @@ static void kpb_micselect_copy16(struct comp_buffer *sink,
 {
 	struct audio_stream *istream = &source->stream;
 	struct audio_stream *ostream = &sink->stream;
-
-	buffer_stream_invalidate(source, size);
-	size_t out_samples;
+	uint32_t frames = size / (sizeof(int16_t) * micsel_channels);
+	const int16_t *in_data = audio_stream_get_rptr(istream);
+	int16_t *out_data = audio_stream_get_wptr(ostream);
+	uint32_t n, i;
 	uint16_t ch;
 
-	const int16_t *in_data;
-	int16_t *out_data;
-	const uint32_t samples_per_chan = size / (sizeof(uint16_t) * micsel_channels);
-
-	for (ch = 0; ch < micsel_channels; ch++) {
-		out_samples = 0;
-		in_data = audio_stream_get_rptr(istream);
-		out_data = audio_stream_get_wptr(ostream);
+	buffer_stream_invalidate(source, frames * in_channels * sizeof(int16_t));
 
-		for (size_t i = 0; i < samples_per_chan * in_channels; i += in_channels) {
-			if (&out_data[out_samples + ch]
-					>= (int16_t *)audio_stream_get_end_addr(ostream)) {
-				out_data = (int16_t *)audio_stream_get_addr(ostream);
-				out_samples = 0;
-			}
-			out_data[out_samples + ch] = in_data[i + offsets[ch]];
-			out_samples += micsel_channels;
+	while (frames) {
+		n = kpb_micselect_chunk(istream, in_data, ostream, out_data, frames);
+		for (i = 0; i < n; i++) {
+			for (ch = 0; ch < micsel_channels; ch++)
+				out_data[ch] = in_data[offsets[ch]];
+			in_data += in_channels;
+			out_data += micsel_channels;
 		}
+		in_data = audio_stream_wrap(istream, (int16_t *)in_data);
+		out_data = audio_stream_wrap(ostream, out_data);
+		frames -= n;
 	}
 }
 
@@ -1107,28 +1169,25 @@ static void kpb_micselect_copy32(struct comp_buffer *sink,
 {
 	struct audio_stream *istream = &source->stream;
 	struct audio_stream *ostream = &sink->stream;
-
-	buffer_stream_invalidate(source, size);
-	size_t out_samples;
+	uint32_t frames = size / (sizeof(int32_t) * micsel_channels);
+	const int32_t *in_data = audio_stream_get_rptr(istream);
+	int32_t *out_data = audio_stream_get_wptr(ostream);
+	uint32_t n, i;
 	uint16_t ch;
-	const int32_t *in_data;
-	int32_t *out_data;
-	const uint32_t samples_per_chan = size / (sizeof(uint32_t) * micsel_channels);
-
-	for (ch = 0; ch < micsel_channels; ch++) {
-		out_samples = 0;
-		in_data = audio_stream_get_rptr(istream);
-		out_data = audio_stream_get_wptr(ostream);
-
-		for (size_t i = 0; i < samples_per_chan * in_channels; i += in_channels) {
-			if (&out_data[out_samples + ch]
-					>= (int32_t *)audio_stream_get_end_addr(ostream)) {
-				out_data = (int32_t *)audio_stream_get_addr(ostream);
-				out_samples = 0;
-			}
-			out_data[out_samples + ch] = in_data[i + offsets[ch]];
-			out_samples += micsel_channels;
+
+	buffer_stream_invalidate(source, frames * in_channels * sizeof(int32_t));
+
+	while (frames) {
+		n = kpb_micselect_chunk(istream, in_data, ostream, out_data, frames);
+		for (i = 0; i < n; i++) {
+			for (ch = 0; ch < micsel_channels; ch++)
+				out_data[ch] = in_data[offsets[ch]];
+			in_data += in_channels;
+			out_data += micsel_channels;
 		}
+		in_data = audio_stream_wrap(istream, (int32_t *)in_data);
+		out_data = audio_stream_wrap(ostream, out_data);
+		frames -= n;
 	}
 }
 #endif
@@ -1162,6 +1221,29 @@ static void kpb_micselect_copy(struct comp_dev *dev, struct comp_buffer *sink_c,
 		return;
 	}
 }
+
+/**
+ * \brief Updates the space the real time stream may use in the history
+ *	buffer, new data must not overwrite data the slowest active read
+ *	cursor has not drained yet.
+ *
+ * \param[in] kpb - KPB component data pointer.
+ */
+static void kpb_update_free(struct comp_data *kpb)
+{
+	struct draining_data *dd;
+	size_t pending = 0;
+	int i;
+
+	for (i = 0; i < KPB_MAX_NO_OF_CLIENTS; i++) {
+		dd = &kpb->drain[i];
+		if (dd->is_draining_active)
+			pending = MAX(pending, dd->drain_req + dd->buffered_while_draining);
+	}
+
+	kpb->hd.free = kpb->hd.buffer_size - MIN(pending, kpb->hd.buffer_size);
+}
+
 /**
  * \brief Copy real time input stream into sink buffer,
  *	and in the same time buffers that input for
@@ -1180,9 +1262,10 @@ static int kpb_copy(struct comp_dev *dev)
 	struct comp_buffer *source, *sink;
 	size_t copy_bytes = 0, produced_bytes = 0;
 	size_t sample_width = kpb->config.sampling_width;
-	struct draining_data *dd = &kpb->draining_task_data;
+	struct draining_data *dd;
 	uint32_t avail_bytes;
 	uint32_t channels = kpb->config.channels;
+	int i;
 
 	comp_dbg(dev, "kpb_copy()");
 
@@ -1283,26 +1366,39 @@ static int kpb_copy(struct comp_dev *dev)
 
 		break;
 	case KPB_STATE_HOST_COPY:
-		/* In host copy state we only copy to host buffer. */
-		sink = kpb->host_sink;
+		/* In host copy state we only copy to the sinks of the clients
+		 * that have drained the history.
+		 */
+		copy_bytes = audio_stream_get_avail_bytes(&source->stream);
+		sink = NULL;
+		for (i = 0; i < KPB_MAX_NO_OF_CLIENTS; i++) {
+			if (kpb->clients[i].state != KPB_CLIENT_DRAINNING_OD)
+				continue;
+
+			sink = kpb->drain[i].sink;
+			/* Validate sink */
+			if (!sink || !audio_stream_get_wptr(&sink->stream)) {
+				comp_err(dev, "kpb_copy(): invalid host sink pointers.");
+				ret = -EINVAL;
+				break;
+			}
 
-		if (!sink) {
-			comp_err(dev, "kpb_copy(): no sink.");
-			ret = -EINVAL;
-			break;
+			copy_bytes = MIN(copy_bytes,
+					 audio_stream_get_copy_bytes(&source->stream,
+								     &sink->stream));
 		}
 
-		/* Validate sink */
-		if (!audio_stream_get_wptr(&sink->stream)) {
-			comp_err(dev, "kpb_copy(): invalid host sink pointers.");
+		if (ret)
+			break;
+
+		if (!sink) {
+			comp_err(dev, "kpb_copy(): no sink.");
 			ret = -EINVAL;
 			break;
 		}
 
-		copy_bytes = audio_stream_get_copy_bytes(&source->stream, &sink->stream);
 		if (!copy_bytes) {
-			comp_err(dev, "kpb_copy(): nothing to copy sink->free %d source->avail %d",
-				 audio_stream_get_free_bytes(&sink->stream),
+			comp_err(dev, "kpb_copy(): nothing to copy source->avail %d",
 				 audio_stream_get_avail_bytes(&source->stream));
 			/* NOTE! We should stop further pipeline copy due to
 			 * no data availability however due to HW bug
@@ -1312,9 +1408,15 @@ static int kpb_copy(struct comp_dev *dev)
 			break;
 		}
 
-		kpb_copy_samples(sink, source, copy_bytes, sample_width, channels);
+		for (i = 0; i < KPB_MAX_NO_OF_CLIENTS; i++) {
+			if (kpb->clients[i].state != KPB_CLIENT_DRAINNING_OD)
+				continue;
+
+			sink = kpb->drain[i].sink;
+			kpb_copy_samples(sink, source, copy_bytes, sample_width, channels);
+			comp_update_buffer_produce(sink, copy_bytes);
+		}
 
-		comp_update_buffer_produce(sink, copy_bytes);
 		comp_update_buffer_consume(source, copy_bytes);
 
 		break;
@@ -1329,8 +1431,13 @@ static int kpb_copy(struct comp_dev *dev)
 		if (copy_bytes) {
 			buffer_stream_invalidate(source, copy_bytes);
 			ret = kpb_buffer_data(dev, source, copy_bytes);
-			dd->buffered_while_draining += copy_bytes;
-			kpb->hd.free -= copy_bytes;
+			/* every active cursor has to drain the new data */
+			for (i = 0; i < KPB_MAX_NO_OF_CLIENTS; i++) {
+				dd = &kpb->drain[i];
+				if (dd->is_draining_active)
+					dd->buffered_while_draining += copy_bytes;
+			}
+			kpb_update_free(kpb);
 
 			if (ret) {
 				comp_err(dev, "kpb_copy(): internal buffering failed.");
@@ -1423,7 +1530,8 @@ static int kpb_buffer_data(struct comp_dev *dev,
 		}
 
 		/* Check how much space there is in current write buffer */
-		space_avail = (uintptr_t)buff->end_addr - (uintptr_t)buff->w_ptr;
+		space_avail = kpb_hb_to_stream_bytes(kpb, (uintptr_t)buff->end_addr -
+						     (uintptr_t)buff->w_ptr);
 
 		if (size_to_copy > space_avail) {
 			/* We have more data to copy than available space
@@ -1433,7 +1541,8 @@ static int kpb_buffer_data(struct comp_dev *dev,
 			kpb_buffer_samples(&source->stream, offset, buff->w_ptr,
 					   space_avail, sample_width);
 			/* Update write pointer & requested copy size */
-			buff->w_ptr = (char *)buff->w_ptr + space_avail;
+			buff->w_ptr = (char *)buff->w_ptr +
+				      kpb_stream_to_hb_bytes(kpb, space_avail);
 			size_to_copy = size_to_copy - space_avail;
 			/* Update read pointer's offset before continuing
 			 * with next buffer.
@@ -1447,7 +1556,8 @@ static int kpb_buffer_data(struct comp_dev *dev,
 			kpb_buffer_samples(&source->stream, offset, buff->w_ptr,
 					   size_to_copy, sample_width);
 			/* Update write pointer & requested copy size */
-			buff->w_ptr = (char *)buff->w_ptr + size_to_copy;
+			buff->w_ptr = (char *)buff->w_ptr +
+				      kpb_stream_to_hb_bytes(kpb, size_to_copy);
 			/* Reset requested copy size */
 			size_to_copy = 0;
 		}
@@ -1563,23 +1673,51 @@ static int kpb_register_client(struct comp_data *kpb, struct kpb_client *cli)
 }
 #endif /* CONFIG_AMS */
 
+/**
+ * \brief Returns the sink a client drains to.
+ *
+ * \param[in] kpb - KPB component data pointer.
+ * \param[in] cli - client's data.
+ *
+ * \return sink given by the client, else the sink bound to the client's
+ *	output, else the host sink.
+ */
+static struct comp_buffer *kpb_client_sink(struct comp_data *kpb,
+					   struct kpb_client *cli)
+{
+	if (cli->sink)
+		return cli->sink;
+
+	if (kpb->drain_sinks[cli->id])
+		return kpb->drain_sinks[cli->id];
+
+	return kpb->host_sink;
+}
+
 /**
  * \brief Prepare history buffer for draining.
  *
  * \param[in] dev - kpb component data.
  * \param[in] cli - client's data.
  *
+ * Each client gets its own read cursor in the shared history buffer. A
+ * client may start draining while others are still draining, it then
+ * joins the running draining task.
  */
 static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 {
 	struct comp_data *kpb = comp_get_drvdata(dev);
-	bool is_sink_ready = (kpb->host_sink->sink->state == COMP_STATE_ACTIVE);
+	struct comp_buffer *sink;
+	struct draining_data *dd;
+	bool is_sink_ready;
+	bool is_draining;
 	size_t sample_width = kpb->config.sampling_width;
 	size_t drain_req = cli->drain_req * kpb->config.channels *
 			       (kpb->config.sampling_freq / 1000) *
 			       (KPB_SAMPLE_CONTAINER_SIZE(sample_width) / 8);
 	struct history_buffer *buff = kpb->hd.c_hb;
 	struct history_buffer *first_buff = buff;
+	void *r_ptr = NULL;
 	size_t buffered = 0;
 	size_t local_buffered;
 	size_t drain_interval;
@@ -1588,14 +1726,27 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 			      (KPB_SAMPLE_CONTAINER_SIZE(sample_width) / 8) *
 			      kpb->config.channels;
 	size_t period_bytes_limit;
+	size_t burst_bytes;
 
-	comp_info(dev, "kpb_init_draining(): requested draining of %d [ms] from history buffer",
-		  cli->drain_req);
+	comp_info(dev, "kpb_init_draining(): client %u requested draining of %d [ms] from history buffer",
+		  cli->id, cli->drain_req);
 
-	if (kpb->state != KPB_STATE_RUN) {
-		comp_err(dev, "kpb_init_draining(): wrong KPB state");
-	} else if (cli->id > KPB_MAX_NO_OF_CLIENTS) {
+	if (cli->id >= KPB_MAX_NO_OF_CLIENTS) {
 		comp_err(dev, "kpb_init_draining(): wrong client id");
+		return;
+	}
+
+	dd = &kpb->drain[cli->id];
+	sink = kpb_client_sink(kpb, cli);
+	is_sink_ready = sink && sink->sink->state == COMP_STATE_ACTIVE;
+	is_draining = kpb->state == KPB_STATE_INIT_DRAINING ||
+		      kpb->state == KPB_STATE_DRAINING;
+
+	if (kpb->state != KPB_STATE_RUN && !is_draining) {
+		comp_err(dev, "kpb_init_draining(): wrong KPB state");
+	} else if (dd->is_draining_active) {
+		comp_err(dev, "kpb_init_draining(): client %u is already draining",
+			 cli->id);
 	/* TODO: check also if client is registered */
 	} else if (!is_sink_ready) {
 		comp_err(dev, "kpb_init_draining(): sink not ready for draining");
@@ -1610,27 +1761,23 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 		 */
 		kpb_lock(kpb);
 
-		kpb_change_state(kpb, KPB_STATE_INIT_DRAINING);
-
-		/* Set history buffer size so new data won't overwrite those
-		 * staged for draining.
-		 */
-		kpb->hd.free = kpb->hd.buffer_size - drain_req;
+		if (!is_draining)
+			kpb_change_state(kpb, KPB_STATE_INIT_DRAINING);
 
 		/* Find buffer to start draining from */
 		do {
 			/* Calculate how much data we have stored in
 			 * current buffer.
 			 */
-			buff->r_ptr = buff->start_addr;
+			r_ptr = buff->start_addr;
 			if (buff->state == KPB_BUFFER_FREE) {
 				local_buffered = (uintptr_t)buff->w_ptr -
 						 (uintptr_t)buff->start_addr;
-				buffered += local_buffered;
+				buffered += kpb_hb_to_stream_bytes(kpb, local_buffered);
 			} else if (buff->state == KPB_BUFFER_FULL) {
 				local_buffered = (uintptr_t)buff->end_addr -
 						 (uintptr_t)buff->start_addr;
-				buffered += local_buffered;
+				buffered += kpb_hb_to_stream_bytes(kpb, local_buffered);
 			} else {
 				comp_err(dev, "kpb_init_draining(): incorrect buffer label");
 			}
@@ -1648,26 +1795,25 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 					 * and buffer's end address.
 					 */
 					buff = buff->prev;
-					buffered += (uintptr_t)buff->end_addr -
-						    (uintptr_t)buff->w_ptr;
-					buff->r_ptr = (char *)buff->w_ptr +
-						      (buffered - drain_req);
+					buffered += kpb_hb_to_stream_bytes(kpb,
+									   (uintptr_t)buff->end_addr -
+									   (uintptr_t)buff->w_ptr);
+					r_ptr = (char *)buff->w_ptr +
+						kpb_stream_to_hb_bytes(kpb, buffered - drain_req);
 					break;
 				}
 				buff = buff->prev;
 			} else if (drain_req == buffered) {
-				buff->r_ptr = buff->start_addr;
+				r_ptr = buff->start_addr;
 				break;
 			} else {
-				buff->r_ptr = (char *)buff->start_addr +
-					      (buffered - drain_req);
+				r_ptr = (char *)buff->start_addr +
+					kpb_stream_to_hb_bytes(kpb, buffered - drain_req);
 				break;
 			}
 
 		} while (buff != first_buff);
 
-		kpb_unlock(kpb);
-
 		/* Should we drain in synchronized mode (sync_draining_mode)?
 		 * Note! We have already verified host params during
 		 * kpb_prepare().
@@ -1678,37 +1824,73 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 			 * synchronize us with application interrupts.
 			 */
 			drain_interval = k_ms_to_cyc_ceil64(host_period_size / bytes_per_ms) /
-					 KPB_DRAIN_NUM_OF_PPL_PERIODS_AT_ONCE;
+					 KPB_DRAIN_SYNC_RATE;
 			period_bytes_limit = host_period_size;
-			comp_info(dev, "kpb_init_draining(): sync_draining_mode selected with interval %u [uS].",
-				  (unsigned int)k_cyc_to_us_near64(drain_interval));
+#if CONFIG_KPB_DRAIN_BURST
+			/* Host buffer is empty when draining starts, so we can
+			 * fill it at once leaving one period for the real time
+			 * stream and only pace the rest of the history.
+			 */
+			burst_bytes = kpb->host_buffer_size > host_period_size ?
+				      kpb->host_buffer_size - host_period_size : 0;
+			burst_bytes = MAX(burst_bytes, period_bytes_limit);
+#else
+			burst_bytes = period_bytes_limit;
+#endif
+			comp_info(dev, "kpb_init_draining(): sync_draining_mode selected with interval %u [uS], burst %u",
+				  (unsigned int)k_cyc_to_us_near64(drain_interval),
+				  (unsigned int)burst_bytes);
 		} else {
 			/* Unlimited draining */
 			drain_interval = 0;
 			period_bytes_limit = 0;
+			burst_bytes = 0;
 			comp_info(dev, "kpb_init_draining: unlimited draining speed selected.");
 		}
 
-		comp_info(dev, "kpb_init_draining(), schedule draining task");
-
-		/* Add one-time draining task into the scheduler. */
-		kpb->draining_task_data.sink = kpb->host_sink;
-		kpb->draining_task_data.hb = buff;
-		kpb->draining_task_data.drain_req = drain_req;
-		kpb->draining_task_data.sample_width = sample_width;
-		kpb->draining_task_data.drain_interval = drain_interval;
-		kpb->draining_task_data.pb_limit = period_bytes_limit;
-		kpb->draining_task_data.dev = dev;
-		kpb->draining_task_data.sync_mode_on = kpb->sync_draining_mode;
+		/* Set up the client's read cursor */
+		dd->sink = sink;
+		dd->hb = buff;
+		dd->r_ptr = r_ptr;
+		dd->drain_req = drain_req;
+		dd->buffered_while_draining = 0;
+		dd->sample_width = sample_width;
+		dd->drain_interval = drain_interval;
+		dd->pb_limit = period_bytes_limit;
+		dd->burst_bytes = burst_bytes;
+		dd->period_bytes = 0;
+		dd->period_bytes_limit = burst_bytes;
+		dd->period_copy_start = sof_cycle_get_64();
+		dd->next_copy_time = 0;
+		dd->drained = 0;
+		dd->dev = dev;
+		dd->sync_mode_on = kpb->sync_draining_mode;
 
 		/* save current sink copy type */
-		comp_get_attribute(kpb->host_sink->sink, COMP_ATTR_COPY_TYPE,
-				   &kpb->draining_task_data.copy_type);
+		comp_get_attribute(sink->sink, COMP_ATTR_COPY_TYPE, &dd->copy_type);
 
 		if (kpb->force_copy_type != COMP_COPY_INVALID)
-			comp_set_attribute(kpb->host_sink->sink, COMP_ATTR_COPY_TYPE,
+			comp_set_attribute(sink->sink, COMP_ATTR_COPY_TYPE,
 					   &kpb->force_copy_type);
 
+		kpb->clients[cli->id].state = KPB_CLIENT_DRAINNING;
+		dd->is_draining_active = 1;
+
+		/* Set history buffer size so new data won't overwrite those
+		 * staged for draining.
+		 */
+		kpb_update_free(kpb);
+
+		kpb_unlock(kpb);
+
+		if (is_draining) {
+			comp_info(dev, "kpb_init_draining(), client %u joins draining task",
+				  cli->id);
+			return;
+		}
+
+		comp_info(dev, "kpb_init_draining(), schedule draining task");
+
 		/* Pause selector copy. */
 		kpb->sel_sink->sink->state = COMP_STATE_PAUSED;
 
@@ -1717,39 +1899,118 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 	}
 }
 
+/**
+ * \brief Drains one chunk of a client's history.
+ *
+ * \param[in] kpb - KPB component data pointer.
+ * \param[in] dd - draining data of the client.
+ */
+static void kpb_drain_client(struct comp_data *kpb, struct draining_data *dd)
+{
+	struct comp_buffer *sink = dd->sink;
+	struct history_buffer *buff = dd->hb;
+	size_t size_to_read;
+	size_t size_to_copy;
+	size_t sink_free;
+	bool move_buffer = false;
+	uint64_t current_time;
+	size_t time_taken;
+
+	if (!dd->drain_req)
+		return;
+
+	/* Is this client ready to drain further or host still need some time
+	 * to read the data already provided?
+	 */
+	if (dd->sync_mode_on &&
+	    dd->next_copy_time > sof_cycle_get_64()) {
+		dd->period_bytes = 0;
+		dd->period_copy_start = sof_cycle_get_64();
+		return;
+	} else if (dd->next_copy_time == 0) {
+		dd->period_copy_start = sof_cycle_get_64();
+	}
+
+	size_to_read = kpb_hb_to_stream_bytes(kpb, (uintptr_t)buff->end_addr -
+					      (uintptr_t)dd->r_ptr);
+	sink_free = audio_stream_get_free_bytes(&sink->stream);
+
+	if (size_to_read > sink_free) {
+		size_to_copy = MIN(sink_free, dd->drain_req);
+	} else {
+		if (size_to_read > dd->drain_req) {
+			size_to_copy = dd->drain_req;
+		} else {
+			size_to_copy = size_to_read;
+			move_buffer = true;
+		}
+	}
+
+	kpb_drain_samples(dd->r_ptr, &sink->stream, size_to_copy,
+			  dd->sample_width);
+
+	dd->r_ptr = (char *)dd->r_ptr +
+		    (uint32_t)kpb_stream_to_hb_bytes(kpb, size_to_copy);
+
+	kpb_lock(kpb);
+	dd->drain_req -= size_to_copy;
+	kpb_update_free(kpb);
+	kpb_unlock(kpb);
+
+	dd->drained += size_to_copy;
+	dd->period_bytes += size_to_copy;
+
+	if (move_buffer) {
+		dd->hb = buff->next;
+		dd->r_ptr = dd->hb->start_addr;
+	}
+
+	if (size_to_copy) {
+		comp_update_buffer_produce(sink, size_to_copy);
+		comp_copy(sink->sink);
+	} else if (!sink_free) {
+		/* There is no free space in sink buffer.
+		 * Call .copy() on sink component so it can
+		 * process its data further.
+		 */
+		comp_copy(sink->sink);
+	}
+
+	if (dd->sync_mode_on && dd->period_bytes >= dd->period_bytes_limit) {
+		current_time = sof_cycle_get_64();
+		time_taken = current_time - dd->period_copy_start;
+		dd->next_copy_time = current_time + dd->drain_interval -
+				     time_taken;
+		/* initial burst done, pace the rest period by period */
+		dd->period_bytes_limit = dd->pb_limit;
+	}
+}
+
 /**
  * \brief Draining task.
  *
- * \param[in] arg - pointer keeping drainig data previously prepared
- * by kpb_init_draining().
+ * \param[in] arg - KPB component device, the draining data of the clients
+ * is previously prepared by kpb_init_draining().
+ *
+ * The active clients are drained in turn, each at its own pace. A client
+ * that has caught up with the real time stream keeps following it until
+ * all clients have caught up, then KPB copies the real time stream to
+ * the sinks of all of them.
  *
  * \return none.
  */
 static enum task_state kpb_draining_task(void *arg)
 {
-	struct draining_data *draining_data = (struct draining_data *)arg;
-	struct comp_buffer *sink = draining_data->sink;
-	struct history_buffer *buff = draining_data->hb;
-	size_t drain_req = draining_data->drain_req;
-	size_t sample_width = draining_data->sample_width;
-	size_t size_to_read;
-	size_t size_to_copy;
-	bool move_buffer = false;
-	uint32_t drained = 0;
+	struct comp_dev *dev = arg;
+	struct comp_data *kpb = comp_get_drvdata(dev);
+	struct draining_data *dd;
 	uint64_t draining_time_start;
 	uint64_t draining_time_end;
 	uint64_t draining_time_ms;
-	uint64_t drain_interval = draining_data->drain_interval;
-	uint64_t next_copy_time = 0;
-	uint64_t current_time;
-	size_t period_bytes = 0;
-	size_t period_bytes_limit = draining_data->pb_limit;
-	size_t period_copy_start = sof_cycle_get_64();
-	size_t time_taken;
-	size_t *rt_stream_update = &draining_data->buffered_while_draining;
-	struct comp_data *kpb = comp_get_drvdata(draining_data->dev);
-	bool sync_mode_on = draining_data->sync_mode_on;
 	bool pm_is_active;
+	bool reset_req = false;
+	bool pending;
+	int i;
 
 	comp_cl_info(&comp_kpb, "kpb_draining_task(), start.");
 
@@ -1763,112 +2024,82 @@ static enum task_state kpb_draining_task(void *arg)
 
 	draining_time_start = sof_cycle_get_64();
 
-	while (drain_req > 0) {
+	do {
 		/* Have we received reset request? */
 		if (kpb->state == KPB_STATE_RESETTING) {
 			kpb_change_state(kpb, KPB_STATE_RESET_FINISHING);
-			kpb_reset(draining_data->dev);
+			reset_req = true;
 			goto out;
 		}
-		/* Are we ready to drain further or host still need some time
-		 * to read the data already provided?
-		 */
-		if (sync_mode_on &&
-		    next_copy_time > sof_cycle_get_64()) {
-			period_bytes = 0;
-			period_copy_start = sof_cycle_get_64();
-			continue;
-		} else if (next_copy_time == 0) {
-			period_copy_start = sof_cycle_get_64();
-		}
-
-		size_to_read = (uintptr_t)buff->end_addr - (uintptr_t)buff->r_ptr;
-
-		if (size_to_read > audio_stream_get_free_bytes(&sink->stream)) {
-			if (audio_stream_get_free_bytes(&sink->stream) >= drain_req)
-				size_to_copy = drain_req;
-			else
-				size_to_copy = audio_stream_get_free_bytes(&sink->stream);
-		} else {
-			if (size_to_read > drain_req) {
-				size_to_copy = drain_req;
-			} else {
-				size_to_copy = size_to_read;
-				move_buffer = true;
-			}
-		}
 
-		kpb_drain_samples(buff->r_ptr, &sink->stream, size_to_copy,
-				  sample_width);
-
-		buff->r_ptr = (char *)buff->r_ptr + (uint32_t)size_to_copy;
-		drain_req -= size_to_copy;
-		drained += size_to_copy;
-		period_bytes += size_to_copy;
-		kpb->hd.free += MIN(kpb->hd.buffer_size -
-				    kpb->hd.free, size_to_copy);
-
-		if (move_buffer) {
-			buff->r_ptr = buff->start_addr;
-			buff = buff->next;
-			move_buffer = false;
+		for (i = 0; i < KPB_MAX_NO_OF_CLIENTS; i++) {
+			dd = &kpb->drain[i];
+			if (dd->is_draining_active)
+				kpb_drain_client(kpb, dd);
 		}
 
-		if (size_to_copy) {
-			comp_update_buffer_produce(sink, size_to_copy);
-			comp_copy(sink->sink);
-		} else if (!audio_stream_get_free_bytes(&sink->stream)) {
-			/* There is no free space in sink buffer.
-			 * Call .copy() on sink component so it can
-			 * process its data further.
-			 */
-			comp_copy(sink->sink);
-		}
+		/* Clients that have finished draining of requested data
+		 * also have to drain the new data the real time stream
+		 * provided while they were draining.
+		 */
+		pending = false;
+		kpb_lock(kpb);
+		for (i = 0; i < KPB_MAX_NO_OF_CLIENTS; i++) {
+			dd = &kpb->drain[i];
+			if (!dd->is_draining_active)
+				continue;
+
+			if (!dd->drain_req && dd->buffered_while_draining) {
+				comp_cl_info(&comp_kpb, "kpb: client %d update drain_req by %d",
+					     i, dd->buffered_while_draining);
+				dd->drain_req = dd->buffered_while_draining;
+				dd->buffered_while_draining = 0;
+			}
 
-		if (sync_mode_on && period_bytes >= period_bytes_limit) {
-			current_time = sof_cycle_get_64();
-			time_taken = current_time - period_copy_start;
-			next_copy_time = current_time + drain_interval -
-					 time_taken;
+			if (dd->drain_req)
+				pending = true;
 		}
 
-		if (drain_req == 0) {
-		/* We have finished draining of requested data however
-		 * while we were draining real time stream could provided
-		 * new data which needs to be copy to host.
-		 */
-			comp_cl_info(&comp_kpb, "kpb: update drain_req by %d",
-				     *rt_stream_update);
-			kpb_lock(kpb);
-			drain_req += *rt_stream_update;
-			*rt_stream_update = 0;
-			if (!drain_req && kpb->state == KPB_STATE_DRAINING) {
+		if (!pending && kpb->state == KPB_STATE_DRAINING) {
 			/* Draining is done. Now switch KPB to copy real time
-			 * stream to client's sink. This state is called
+			 * stream to clients' sinks. This state is called
 			 * "draining on demand"
 			 * Note! If KPB state changed during draining due to
 			 * i.e reset request we should not change that state.
 			 */
-				kpb_change_state(kpb, KPB_STATE_HOST_COPY);
-			}
-			kpb_unlock(kpb);
+			for (i = 0; i < KPB_MAX_NO_OF_CLIENTS; i++)
+				if (kpb->drain[i].is_draining_active)
+					kpb->clients[i].state = KPB_CLIENT_DRAINNING_OD;
+			kpb_change_state(kpb, KPB_STATE_HOST_COPY);
 		}
-	}
+		kpb_unlock(kpb);
+	} while (pending);
 
 out:
 	draining_time_end = sof_cycle_get_64();
+	draining_time_ms = k_cyc_to_ms_near64(draining_time_end - draining_time_start);
 
-	/* Reset host-sink copy mode back to its pre-draining value */
-	comp_set_attribute(kpb->host_sink->sink, COMP_ATTR_COPY_TYPE,
-			   &kpb->draining_task_data.copy_type);
+	for (i = 0; i < KPB_MAX_NO_OF_CLIENTS; i++) {
+		dd = &kpb->drain[i];
+		if (!dd->is_draining_active)
+			continue;
 
-	draining_time_ms = k_cyc_to_ms_near64(draining_time_end - draining_time_start);
-	if (draining_time_ms <= UINT_MAX)
-		comp_cl_info(&comp_kpb, "KPB: kpb_draining_task(), done. %u drained in %u ms",
-			     drained, (unsigned int)draining_time_ms);
-	else
-		comp_cl_info(&comp_kpb, "KPB: kpb_draining_task(), done. %u drained in > %u ms",
-			     drained, UINT_MAX);
+		/* Reset client sink copy mode back to its pre-draining value */
+		comp_set_attribute(dd->sink->sink, COMP_ATTR_COPY_TYPE,
+				   &dd->copy_type);
+
+		dd->is_draining_active = 0;
+
+		if (draining_time_ms <= UINT_MAX)
+			comp_cl_info(&comp_kpb, "KPB: kpb_draining_task(), client %d done. %u drained in %u ms",
+				     i, dd->drained, (unsigned int)draining_time_ms);
+		else
+			comp_cl_info(&comp_kpb, "KPB: kpb_draining_task(), client %d done. %u drained in > %u ms",
+				     i, dd->drained, UINT_MAX);
+	}
+
+	if (reset_req)
+		kpb_reset(dev);
 
 	return SOF_TASK_STATE_COMPLETED;
 }
@@ -1946,6 +2177,82 @@ static void kpb_convert_24b_to_32b(const void *source, int ioffset,
 	}
 }
 #endif
+#if CONFIG_KPB_HISTORY_COMPAND
+/* Companded history word: 4 bit exponent and 12 bit two's complement mantissa,
+ * the exponent range covers the 32 bit sample range in steps of the minimum
+ * shift.
+ */
+#define KPB_COMPAND_MANT_BITS	12
+#define KPB_COMPAND_MIN_SHIFT	(32 - KPB_COMPAND_MANT_BITS - 15)
+
+static inline uint16_t kpb_compand_word(int32_t x)
+{
+	/* number of significant bits without the sign bit */
+	uint32_t mag = x ^ (x >> 31);
+	int bits = 32 - clz(mag | 1);
+	int shift = MAX(bits + 1 - KPB_COMPAND_MANT_BITS, KPB_COMPAND_MIN_SHIFT);
+
+	return ((shift - KPB_COMPAND_MIN_SHIFT) << KPB_COMPAND_MANT_BITS) |
+	       ((x >> shift) & (BIT(KPB_COMPAND_MANT_BITS) - 1));
+}
+
+static inline int32_t kpb_expand_word(uint16_t w)
+{
+	int shift = (w >> KPB_COMPAND_MANT_BITS) + KPB_COMPAND_MIN_SHIFT;
+	int32_t m = (int32_t)((uint32_t)w << (32 - KPB_COMPAND_MANT_BITS)) >>
+		    (32 - KPB_COMPAND_MANT_BITS);
+
+	return (int32_t)((uint32_t)m << shift);
+}
+
+/* compand 24 or 32 bit samples of source stream into linear history buffer */
+static void kpb_compand_samples(const struct audio_stream *source, int ioffset,
+				void *sink, unsigned int samples, size_t sample_width)
+{
+	int32_t *src = audio_stream_wrap(source, (int32_t *)audio_stream_get_rptr(source) +
+					 ioffset);
+	uint16_t *dst = sink;
+	int shift = 32 - sample_width;
+	int processed;
+	int nmax, i, n;
+
+	for (processed = 0; processed < samples; processed += n) {
+		src = audio_stream_wrap(source, src);
+		n = samples - processed;
+		nmax = KPB_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(source, src));
+		n = MIN(n, nmax);
+		for (i = 0; i < n; i++) {
+			*dst = kpb_compand_word((int32_t)((uint32_t)*src << shift));
+			dst++;
+			src++;
+		}
+	}
+}
+
+/* expand history buffer words into 24 or 32 bit samples of sink stream */
+static void kpb_expand_samples(const void *source, struct audio_stream *sink,
+			       unsigned int samples, size_t sample_width)
+{
+	const uint16_t *src = source;
+	int32_t *dst = audio_stream_get_wptr(sink);
+	int shift = 32 - sample_width;
+	int processed;
+	int nmax, i, n;
+
+	for (processed = 0; processed < samples; processed += n) {
+		dst = audio_stream_wrap(sink, dst);
+		n = samples - processed;
+		nmax = KPB_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(sink, dst));
+		n = MIN(n, nmax);
+		for (i = 0; i < n; i++) {
+			*dst = kpb_expand_word(*src) >> shift;
+			dst++;
+			src++;
+		}
+	}
+}
+#endif /* CONFIG_KPB_HISTORY_COMPAND */
+
 /**
  * \brief Drain data samples safe, according to configuration.
  *
@@ -1960,6 +2267,13 @@ static void kpb_drain_samples(void *source, struct audio_stream *sink,
 {
 	unsigned int samples;
 
+#if CONFIG_KPB_HISTORY_COMPAND
+	if (sample_width != 16) {
+		kpb_expand_samples(source, sink, KPB_BYTES_TO_S32_SAMPLES(size), sample_width);
+		return;
+	}
+#endif
+
 	switch (sample_width) {
 #if CONFIG_FORMAT_S16LE
 	case 16:
@@ -2062,6 +2376,14 @@ static void kpb_buffer_samples(const struct audio_stream *source,
 	unsigned int samples_count;
 	int samples_offset;
 
+#if CONFIG_KPB_HISTORY_COMPAND
+	if (sample_width != 16) {
+		kpb_compand_samples(source, KPB_BYTES_TO_S32_SAMPLES(offset), sink,
+				    KPB_BYTES_TO_S32_SAMPLES(size), sample_width);
+		return;
+	}
+#endif
+
 	switch (sample_width) {
 #if CONFIG_FORMAT_S16LE
 	case 16:
@@ -2316,11 +2638,11 @@ static inline bool validate_host_params(struct comp_dev *dev,
 		 * case scenario, we copy one period of real time data + some
 		 * of buffered data.
 		 */
-		if ((host_period_size / KPB_DRAIN_NUM_OF_PPL_PERIODS_AT_ONCE) <
+		if ((host_period_size / KPB_DRAIN_SYNC_RATE) <
 		    pipeline_period_size) {
 			comp_err(dev, "kpb: host_period_size (%d) must be at least %d * %d",
 				 host_period_size,
-				 KPB_DRAIN_NUM_OF_PPL_PERIODS_AT_ONCE,
+				 KPB_DRAIN_SYNC_RATE,
 				 pipeline_period_size);
 			return false;
 		}
@@ -0,0 +1,308 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+//
+
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/format.h>
+#include <sof/audio/level_meter.h>
+#include <sof/common.h>
+#include <sof/lib/memory.h>
+#include <sof/lib/uuid.h>
+#include <sof/trace/trace.h>
+#include <rtos/alloc.h>
+#include <rtos/string.h>
+#include <ipc/stream.h>
+#include <ipc/topology.h>
+#include <user/level_meter.h>
+#include <errno.h>
+#include <stdint.h>
+
+LOG_MODULE_REGISTER(level_meter, CONFIG_SOF_LOG_LEVEL);
+
+/* 7f5e0a2c-3d41-4b8e-9c6a-1e2f8b4d7a93 */
+DECLARE_SOF_RT_UUID("level_meter", level_meter_uuid, 0x7f5e0a2c, 0x3d41, 0x4b8e,
+		    0x9c, 0x6a, 0x1e, 0x2f, 0x8b, 0x4d, 0x7a, 0x93);
+DECLARE_TR_CTX(level_meter_tr, SOF_UUID(level_meter_uuid), LOG_LEVEL_INFO);
+
+#define LEVEL_METER_WINDOW_SIZE	(sizeof(struct level_meter_window) + \
+				 CONFIG_LEVEL_METER_SLOTS * sizeof(struct level_meter_slot))
+
+/*
+ * Slots are assigned and released from the IPC context only, which is
+ * serialized, so the window needs no lock. Levels are written by the owner
+ * of the slot only.
+ */
+static struct level_meter_window *level_meter_window;
+
+static int level_meter_window_init(void)
+{
+	struct level_meter_window *window;
+
+	if (level_meter_window)
+		return 0;
+
+#ifdef SRAM_LEVEL_METER_BASE
+	STATIC_ASSERT(LEVEL_METER_WINDOW_SIZE <= SRAM_LEVEL_METER_SIZE,
+		      level_meter_slots_do_not_fit_memory_window);
+	window = (struct level_meter_window *)SRAM_LEVEL_METER_BASE;
+	memset(window, 0, LEVEL_METER_WINDOW_SIZE);
+#else
+	window = rzalloc(SOF_MEM_ZONE_SYS_SHARED, 0, SOF_MEM_CAPS_RAM, LEVEL_METER_WINDOW_SIZE);
+	if (!window)
+		return -ENOMEM;
+#endif
+
+	window->version = LEVEL_METER_WINDOW_VERSION;
+	window->num_slots = CONFIG_LEVEL_METER_SLOTS;
+	window->magic = LEVEL_METER_WINDOW_MAGIC;
+	level_meter_window = window;
+
+	return 0;
+}
+
+/* integer square root, rounded down */
+static uint32_t level_meter_sqrt(uint64_t x)
+{
+	uint64_t bit = 1ULL << 62;
+	uint64_t res = 0;
+
+	while (bit > x)
+		bit >>= 2;
+
+	while (bit) {
+		if (x >= res + bit) {
+			x -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (uint32_t)res;
+}
+
+static uint32_t level_meter_q1_31(uint32_t q1_23)
+{
+	return MIN((uint64_t)q1_23 << 8, (uint64_t)INT32_MAX);
+}
+
+static void level_meter_restart(struct level_meter *meter)
+{
+	meter->frames = 0;
+	memset(meter->peak, 0, sizeof(meter->peak));
+	memset(meter->sum_sq, 0, sizeof(meter->sum_sq));
+}
+
+/* publish the levels of a complete window and start a new one */
+static void level_meter_publish(struct level_meter *meter)
+{
+	struct level_meter_slot *slot = meter->slot;
+	uint32_t window_ms;
+	int ch;
+
+	slot->seq++;
+	for (ch = 0; ch < slot->channels; ch++) {
+		slot->peak[ch] = level_meter_q1_31(meter->peak[ch]);
+		slot->rms[ch] = level_meter_q1_31(level_meter_sqrt(meter->sum_sq[ch] /
+								   meter->frames));
+	}
+	slot->seq++;
+
+	/* pick up the window requested by the host */
+	window_ms = slot->window_ms;
+	if (window_ms != meter->window_ms && level_meter_set_window(meter, window_ms) < 0)
+		slot->window_ms = meter->window_ms;
+
+	level_meter_restart(meter);
+}
+
+#if CONFIG_FORMAT_S16LE
+static void level_meter_acc_s16(struct level_meter *meter, const struct audio_stream *stream,
+				const void *ptr, int samples)
+{
+	const int nch = audio_stream_get_channels(stream);
+	const int16_t *x = ptr;
+	const int16_t *x0;
+	uint64_t sum_sq;
+	int32_t peak;
+	int32_t tmp;
+	int nmax, n, i, j;
+
+	while (samples) {
+		nmax = audio_stream_samples_without_wrap_s16(stream, x);
+		n = MIN(samples, nmax);
+		for (j = 0; j < meter->channels; j++) {
+			x0 = x + j;
+			peak = meter->peak[j];
+			sum_sq = meter->sum_sq[j];
+			for (i = 0; i < n; i += nch) {
+				tmp = (int32_t)x0[i] << 8;
+				peak = MAX(peak, ABS(tmp));
+				sum_sq += (int64_t)tmp * tmp;
+			}
+			meter->peak[j] = peak;
+			meter->sum_sq[j] = sum_sq;
+		}
+		samples -= n;
+		x = audio_stream_wrap(stream, (int16_t *)x + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+static void level_meter_acc_s32(struct level_meter *meter, const struct audio_stream *stream,
+				const void *ptr, int samples, bool s24)
+{
+	const int nch = audio_stream_get_channels(stream);
+	const int32_t *x = ptr;
+	const int32_t *x0;
+	uint64_t sum_sq;
+	int32_t peak;
+	int32_t tmp;
+	int nmax, n, i, j;
+
+	while (samples) {
+		nmax = audio_stream_samples_without_wrap_s32(stream, x);
+		n = MIN(samples, nmax);
+		for (j = 0; j < meter->channels; j++) {
+			x0 = x + j;
+			peak = meter->peak[j];
+			sum_sq = meter->sum_sq[j];
+			for (i = 0; i < n; i += nch) {
+				/* both formats are metered as Q1.23 */
+				tmp = s24 ? sign_extend_s24(x0[i]) : x0[i] >> 8;
+				peak = MAX(peak, ABS(tmp));
+				sum_sq += (int64_t)tmp * tmp;
+			}
+			meter->peak[j] = peak;
+			meter->sum_sq[j] = sum_sq;
+		}
+		samples -= n;
+		x = audio_stream_wrap(stream, (int32_t *)x + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+
+static void level_meter_acc(struct level_meter *meter, const struct audio_stream *stream,
+			    const void *ptr, int samples)
+{
+	switch (audio_stream_get_frm_fmt(stream)) {
+#if CONFIG_FORMAT_S16LE
+	case SOF_IPC_FRAME_S16_LE:
+		level_meter_acc_s16(meter, stream, ptr, samples);
+		break;
+#endif
+#if CONFIG_FORMAT_S24LE
+	case SOF_IPC_FRAME_S24_4LE:
+		level_meter_acc_s32(meter, stream, ptr, samples, true);
+		break;
+#endif
+#if CONFIG_FORMAT_S32LE
+	case SOF_IPC_FRAME_S32_LE:
+		level_meter_acc_s32(meter, stream, ptr, samples, false);
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
+void level_meter_update(struct level_meter *meter, const struct audio_stream *stream,
+			const void *ptr, uint32_t frames)
+{
+	const int nch = audio_stream_get_channels(stream);
+	uint32_t n;
+
+	while (frames) {
+		n = MIN(frames, meter->window_frames - meter->frames);
+		level_meter_acc(meter, stream, ptr, n * nch);
+		ptr = audio_stream_wrap(stream, (uint8_t *)ptr +
+					n * audio_stream_frame_bytes(stream));
+		meter->frames += n;
+		frames -= n;
+
+		if (meter->frames == meter->window_frames)
+			level_meter_publish(meter);
+	}
+}
+
+int level_meter_set_window(struct level_meter *meter, uint32_t window_ms)
+{
+	uint32_t window_frames;
+
+	if (window_ms < LEVEL_METER_WINDOW_MS_MIN || window_ms > LEVEL_METER_WINDOW_MS_MAX)
+		return -EINVAL;
+
+	window_frames = (uint64_t)meter->rate * window_ms / 1000;
+	if (!window_frames || window_frames > LEVEL_METER_MAX_WINDOW_FRAMES)
+		return -EINVAL;
+
+	meter->window_ms = window_ms;
+	meter->window_frames = window_frames;
+	meter->slot->window_ms = window_ms;
+	level_meter_restart(meter);
+
+	return 0;
+}
+
+struct level_meter *level_meter_new(uint32_t id, uint32_t rate, uint32_t channels,
+				    uint32_t window_ms)
+{
+	struct level_meter_slot *slot = NULL;
+	struct level_meter *meter;
+	int i;
+
+	if (!channels || channels > PLATFORM_MAX_CHANNELS || !rate)
+		return NULL;
+
+	if (level_meter_window_init() < 0) {
+		tr_err(&level_meter_tr, "level_meter_new(): window allocation failed");
+		return NULL;
+	}
+
+	for (i = 0; i < level_meter_window->num_slots; i++) {
+		if (!level_meter_window->slots[i].in_use) {
+			slot = &level_meter_window->slots[i];
+			break;
+		}
+	}
+
+	if (!slot) {
+		tr_warn(&level_meter_tr, "level_meter_new(): no free slot for 0x%x", id);
+		return NULL;
+	}
+
+	meter = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*meter));
+	if (!meter)
+		return NULL;
+
+	meter->slot = slot;
+	meter->rate = rate;
+	meter->channels = channels;
+
+	memset(slot, 0, sizeof(*slot));
+	slot->id = id;
+	slot->rate = rate;
+	slot->channels = MIN(channels, LEVEL_METER_MAX_CHANNELS);
+
+	if (level_meter_set_window(meter, window_ms) < 0) {
+		tr_err(&level_meter_tr, "level_meter_new(): invalid window %u ms", window_ms);
+		rfree(meter);
+		return NULL;
+	}
+
+	slot->in_use = 1;
+
+	return meter;
+}
+
+void level_meter_free(struct level_meter *meter)
+{
+	if (!meter)
+		return;
+
+	meter->slot->in_use = 0;
+	rfree(meter);
+}
@@ -0,0 +1,602 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/module_adapter/module/generic.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/audio/ipc-config.h>
+#include <sof/audio/pipeline.h>
+#include <sof/common.h>
+#include <sof/debug/telemetry/telemetry.h>
+#include <sof/lib/uuid.h>
+#include <sof/list.h>
+#include <sof/math/xcorr.h>
+#include <sof/trace/trace.h>
+#include <sof/ut.h>
+#include <rtos/alloc.h>
+#include <rtos/init.h>
+#include <rtos/string.h>
+#include <rtos/timer.h>
+#include <ipc/control.h>
+#include <ipc/stream.h>
+#include <ipc/topology.h>
+#include <user/loopback_latency.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+LOG_MODULE_REGISTER(loopback_latency, CONFIG_SOF_LOG_LEVEL);
+
+/* 3c8a2f54-8e0b-4d5a-b2a4-7f1d6e9c0b31 */
+DECLARE_SOF_RT_UUID("loopback_latency", loopback_latency_uuid, 0x3c8a2f54, 0x8e0b, 0x4d5a,
+		    0xb2, 0xa4, 0x7f, 0x1d, 0x6e, 0x9c, 0x0b, 0x31);
+
+DECLARE_TR_CTX(loopback_latency_tr, SOF_UUID(loopback_latency_uuid), LOG_LEVEL_INFO);
+
+/* IPC4 input pin of the loopback capture */
+#define LOOPBACK_LATENCY_QUEUE_ID	1
+
+#define LOOPBACK_LATENCY_AMPLITUDE_DEFAULT	Q_CONVERT_FLOAT(0.25, 31)	/* -12 dB */
+#define LOOPBACK_LATENCY_PEAK_RATIO_DEFAULT	8
+
+/* Galois LFSR of x^10 + x^7 + 1, period 1023 */
+#define LOOPBACK_LATENCY_LFSR_TAPS	0x240
+
+/* correlation products per copy, the peak search is spread over copies */
+#define LOOPBACK_LATENCY_MACS_PER_COPY	65536
+
+/* loopback frames are waited for up to this many burst lengths */
+#define LOOPBACK_LATENCY_TIMEOUT_BURSTS	4
+
+enum loopback_latency_state {
+	LOOPBACK_LATENCY_IDLE = 0,
+	LOOPBACK_LATENCY_INJECT,	/* burst out, loopback recorded */
+	LOOPBACK_LATENCY_CORRELATE,	/* loopback correlated with the burst */
+};
+
+struct loopback_latency_data {
+	struct sof_loopback_latency_config config;	/* used by process() */
+	struct sof_loopback_latency_config new_config;	/* set by IPC, applied by process() */
+	bool config_pending;
+	struct sof_loopback_latency_result result;
+	enum loopback_latency_state state;
+
+	int16_t burst[LOOPBACK_LATENCY_BURST_FRAMES];	/* MLS scaled to the amplitude */
+	int16_t *capture;	/* loopback from the burst start on */
+	int64_t *r;		/* 2 * lag + 1 accumulated lags */
+	int lag;		/* half of the largest latency */
+	int capture_len;	/* burst frames + 2 * lag */
+	int capture_fill;
+	int burst_pos;		/* burst frames sent, then frames correlated */
+	uint32_t frames;	/* output frames since the burst start */
+	uint32_t interval_frames;
+	uint32_t countdown;	/* output frames until the next measurement */
+
+	int playback_source;	/* index of the playback input */
+	int loopback_source;	/* index of the loopback input, -1 if none */
+	enum sof_ipc_frame format;
+	enum sof_ipc_frame loopback_format;
+	uint32_t channels;
+	uint32_t rate;
+};
+
+static void loopback_latency_set_burst(struct loopback_latency_data *cd)
+{
+	int16_t a = (cd->config.amplitude ? cd->config.amplitude :
+		     LOOPBACK_LATENCY_AMPLITUDE_DEFAULT) >> 16;
+	uint32_t lfsr = 1;
+	int i;
+
+	for (i = 0; i < LOOPBACK_LATENCY_BURST_FRAMES; i++) {
+		cd->burst[i] = lfsr & 1 ? a : -a;
+		lfsr = lfsr & 1 ? (lfsr >> 1) ^ LOOPBACK_LATENCY_LFSR_TAPS : lfsr >> 1;
+	}
+}
+
+static void loopback_latency_apply_config(struct loopback_latency_data *cd)
+{
+	cd->config = cd->new_config;
+	cd->config_pending = false;
+	loopback_latency_set_burst(cd);
+
+	cd->interval_frames = (uint64_t)cd->config.interval_ms * cd->rate / 1000;
+	cd->countdown = 0;
+}
+
+static int16_t loopback_latency_read(const void *ptr, enum sof_ipc_frame format)
+{
+	switch (format) {
+	case SOF_IPC_FRAME_S16_LE:
+		return *(const int16_t *)ptr;
+	case SOF_IPC_FRAME_S24_4LE:
+		return (int32_t)((uint32_t)*(const int32_t *)ptr << 8) >> 16;
+	default:
+		return *(const int32_t *)ptr >> 16;
+	}
+}
+
+static void loopback_latency_write(void *ptr, enum sof_ipc_frame format, int16_t v)
+{
+	switch (format) {
+	case SOF_IPC_FRAME_S16_LE:
+		*(int16_t *)ptr = v;
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		*(int32_t *)ptr = (int32_t)v << 8;
+		break;
+	default:
+		*(int32_t *)ptr = (int32_t)v << 16;
+		break;
+	}
+}
+
+/* replaces the first frames of the output with the rest of the burst */
+static uint32_t loopback_latency_inject(struct loopback_latency_data *cd,
+					struct audio_stream *sink, uint32_t frames)
+{
+	uint32_t sample_bytes = audio_stream_sample_bytes(sink);
+	uint8_t *w = audio_stream_get_wptr(sink);
+	uint32_t n = MIN(frames, LOOPBACK_LATENCY_BURST_FRAMES - cd->burst_pos);
+	uint32_t i;
+	uint32_t ch;
+
+	for (i = 0; i < n; i++) {
+		for (ch = 0; ch < cd->channels; ch++) {
+			loopback_latency_write(w, cd->format, cd->burst[cd->burst_pos]);
+			w = audio_stream_wrap(sink, w + sample_bytes);
+		}
+		cd->burst_pos++;
+	}
+
+	return n;
+}
+
+/* keeps the first channel of the loopback until the capture is complete */
+static void loopback_latency_record(struct loopback_latency_data *cd,
+				    const struct audio_stream *source, uint32_t frames)
+{
+	uint32_t frame_bytes = audio_stream_frame_bytes(source);
+	const uint8_t *r = audio_stream_get_rptr(source);
+	uint32_t n = MIN(frames, cd->capture_len - cd->capture_fill);
+	uint32_t i;
+
+	for (i = 0; i < n; i++) {
+		cd->capture[cd->capture_fill++] = loopback_latency_read(r, cd->loopback_format);
+		r = audio_stream_wrap(source, (uint8_t *)r + frame_bytes);
+	}
+}
+
+static void loopback_latency_done(struct processing_module *mod, uint32_t status,
+				  uint32_t frames, uint32_t peak_ratio)
+{
+	struct loopback_latency_data *cd = module_get_private_data(mod);
+	struct sof_loopback_latency_result *result = &cd->result;
+
+	result->seq++;
+	result->status = status;
+	result->rate = cd->rate;
+	result->frames = frames;
+	result->latency_us = (uint64_t)frames * 1000000 / cd->rate;
+	result->peak_ratio = peak_ratio;
+	result->result_time = sof_cycle_get_64();
+
+	comp_info(mod->dev, "loopback_latency_done(), status %u latency %u frames %u us ratio %u",
+		  status, frames, result->latency_us, peak_ratio);
+
+#if CONFIG_SOF_TELEMETRY
+	if (status == LOOPBACK_LATENCY_OK)
+		telemetry_post(TELEMETRY_RECORD_LATENCY, dev_comp_id(mod->dev),
+			       &result->latency_us, sizeof(result->latency_us));
+#endif
+
+	cd->state = LOOPBACK_LATENCY_IDLE;
+	cd->countdown = cd->interval_frames;
+}
+
+/* The burst is the second signal, the lags 0 .. 2 * lag of the loopback are
+ * the lags -lag .. lag seen from the middle of the capture. A slice of the
+ * burst is correlated per copy to keep the load of every LL tick bounded.
+ */
+static void loopback_latency_correlate(struct processing_module *mod)
+{
+	struct loopback_latency_data *cd = module_get_private_data(mod);
+	int lags = 2 * cd->lag + 1;
+	int n = MAX(LOOPBACK_LATENCY_MACS_PER_COPY / lags, 1);
+	uint32_t min_ratio;
+	uint32_t ratio = 0;
+	int64_t sum = 0;
+	int peak;
+	int i;
+
+	n = MIN(n, LOOPBACK_LATENCY_BURST_FRAMES - cd->burst_pos);
+	sofm_xcorr_acc_16(&cd->capture[cd->lag + cd->burst_pos], &cd->burst[cd->burst_pos],
+			  n, cd->lag, cd->r);
+	cd->burst_pos += n;
+	if (cd->burst_pos < LOOPBACK_LATENCY_BURST_FRAMES)
+		return;
+
+	peak = sofm_xcorr_peak(cd->r, cd->lag);
+	for (i = 0; i < lags; i++)
+		sum += cd->r[i] < 0 ? -cd->r[i] : cd->r[i];
+
+	sum /= lags;
+	if (sum && cd->r[peak + cd->lag] > 0)
+		ratio = MIN(cd->r[peak + cd->lag] / sum, UINT32_MAX);
+
+	min_ratio = cd->config.min_peak_ratio ? cd->config.min_peak_ratio :
+		    LOOPBACK_LATENCY_PEAK_RATIO_DEFAULT;
+	loopback_latency_done(mod, ratio >= min_ratio ? LOOPBACK_LATENCY_OK :
+			      LOOPBACK_LATENCY_NO_PEAK, peak + cd->lag, ratio);
+}
+
+static void loopback_latency_start(struct loopback_latency_data *cd)
+{
+	cd->state = LOOPBACK_LATENCY_INJECT;
+	cd->burst_pos = 0;
+	cd->capture_fill = 0;
+	cd->frames = 0;
+	cd->result.inject_time = sof_cycle_get_64();
+}
+
+static int loopback_latency_process(struct processing_module *mod,
+				    struct input_stream_buffer *input_buffers,
+				    int num_input_buffers,
+				    struct output_stream_buffer *output_buffers,
+				    int num_output_buffers)
+{
+	struct loopback_latency_data *cd = module_get_private_data(mod);
+	struct input_stream_buffer *input = &input_buffers[cd->playback_source];
+	struct input_stream_buffer *loopback = NULL;
+	struct audio_stream *sink = output_buffers[0].data;
+	uint32_t frames = input->size;
+	uint32_t n = 0;
+
+	if (cd->loopback_source >= 0 && cd->loopback_source < num_input_buffers)
+		loopback = &input_buffers[cd->loopback_source];
+
+	if (cd->state == LOOPBACK_LATENCY_IDLE) {
+		if (cd->config_pending) {
+			loopback_latency_apply_config(cd);
+			loopback_latency_start(cd);
+		} else if (cd->interval_frames) {
+			if (cd->countdown > frames)
+				cd->countdown -= frames;
+			else
+				loopback_latency_start(cd);
+		}
+	}
+
+	if (cd->state == LOOPBACK_LATENCY_INJECT) {
+		n = loopback_latency_inject(cd, sink, frames);
+		cd->frames += frames;
+	}
+
+	audio_stream_copy(input->data, n * cd->channels, sink, n * cd->channels,
+			  (frames - n) * cd->channels);
+	module_update_buffer_position(input, &output_buffers[0], frames);
+
+	/* the loopback is always drained to not stall its pipeline */
+	if (loopback) {
+		if (cd->state == LOOPBACK_LATENCY_INJECT)
+			loopback_latency_record(cd, loopback->data, loopback->size);
+		loopback->consumed = loopback->size * audio_stream_frame_bytes(loopback->data);
+	}
+
+	switch (cd->state) {
+	case LOOPBACK_LATENCY_INJECT:
+		if (cd->capture_fill == cd->capture_len) {
+			memset(cd->r, 0, sizeof(*cd->r) * (2 * cd->lag + 1));
+			cd->burst_pos = 0;
+			cd->state = LOOPBACK_LATENCY_CORRELATE;
+		} else if (cd->frames > LOOPBACK_LATENCY_TIMEOUT_BURSTS * cd->capture_len) {
+			loopback_latency_done(mod, LOOPBACK_LATENCY_TIMEOUT, 0, 0);
+		}
+		break;
+	case LOOPBACK_LATENCY_CORRELATE:
+		loopback_latency_correlate(mod);
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static int loopback_latency_check_config(struct comp_dev *dev,
+					 const struct sof_loopback_latency_config *config,
+					 size_t size)
+{
+	if (size != sizeof(*config) || config->size != sizeof(*config)) {
+		comp_err(dev, "loopback_latency_check_config(): invalid config size %u, expect %u",
+			 size, sizeof(*config));
+		return -EINVAL;
+	}
+
+	if (config->amplitude < 0) {
+		comp_err(dev, "loopback_latency_check_config(): invalid amplitude %d",
+			 config->amplitude);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int loopback_latency_set_config(struct processing_module *mod, uint32_t config_id,
+				       enum module_cfg_fragment_position pos,
+				       uint32_t data_offset_size, const uint8_t *fragment,
+				       size_t fragment_size, uint8_t *response,
+				       size_t response_size)
+{
+	struct loopback_latency_data *cd = module_get_private_data(mod);
+	const struct sof_loopback_latency_config *config;
+	struct comp_dev *dev = mod->dev;
+	int ret;
+
+#if CONFIG_IPC_MAJOR_3
+	const struct sof_ipc_ctrl_data *cdata = (const struct sof_ipc_ctrl_data *)fragment;
+
+	if (cdata->cmd != SOF_CTRL_CMD_BINARY) {
+		comp_err(dev, "loopback_latency_set_config(), invalid command %u", cdata->cmd);
+		return -EINVAL;
+	}
+
+	fragment = (const uint8_t *)cdata->data->data;
+	fragment_size = cdata->data->size;
+#endif
+
+	if (config_id != LOOPBACK_LATENCY_SET_CONFIG || pos != MODULE_CFG_FRAGMENT_SINGLE) {
+		comp_err(dev, "loopback_latency_set_config(): unknown config_id %u", config_id);
+		return -EINVAL;
+	}
+
+	config = (const struct sof_loopback_latency_config *)fragment;
+	ret = loopback_latency_check_config(dev, config, fragment_size);
+	if (ret < 0)
+		return ret;
+
+	/* process() owns the active configuration and starts the measurement */
+	if (cd->config_pending)
+		return -EBUSY;
+
+	cd->new_config = *config;
+	cd->config_pending = true;
+
+	comp_info(dev, "loopback_latency_set_config(), interval %u ms", config->interval_ms);
+
+	return 0;
+}
+
+static int loopback_latency_get_config(struct processing_module *mod, uint32_t config_id,
+				       uint32_t *data_offset_size, uint8_t *fragment,
+				       size_t fragment_size)
+{
+	struct loopback_latency_data *cd = module_get_private_data(mod);
+	const void *data;
+	size_t size;
+	int ret;
+
+#if CONFIG_IPC_MAJOR_3
+	struct sof_ipc_ctrl_data *cdata = (struct sof_ipc_ctrl_data *)fragment;
+
+	if (cdata->cmd != SOF_CTRL_CMD_BINARY) {
+		comp_err(mod->dev, "loopback_latency_get_config(), invalid command %u",
+			 cdata->cmd);
+		return -EINVAL;
+	}
+
+	config_id = cdata->data->type;
+	fragment = (uint8_t *)cdata->data->data;
+	fragment_size = cdata->data->size;
+#endif
+
+	switch (config_id) {
+	case LOOPBACK_LATENCY_SET_CONFIG:
+		data = &cd->config;
+		size = sizeof(cd->config);
+		break;
+	case LOOPBACK_LATENCY_GET_RESULT:
+		data = &cd->result;
+		size = sizeof(cd->result);
+		break;
+	default:
+		comp_err(mod->dev, "loopback_latency_get_config(): unknown config_id %u",
+			 config_id);
+		return -EINVAL;
+	}
+
+	ret = memcpy_s(fragment, fragment_size, data, size);
+	if (ret)
+		return ret;
+
+#if CONFIG_IPC_MAJOR_3
+	cdata->data->abi = SOF_ABI_VERSION;
+	cdata->data->size = size;
+#else
+	*data_offset_size = size;
+#endif
+
+	return 0;
+}
+
+static int loopback_latency_init(struct processing_module *mod)
+{
+	struct module_config *cfg = &mod->priv.cfg;
+	struct loopback_latency_data *cd;
+	struct comp_dev *dev = mod->dev;
+
+	comp_info(dev, "loopback_latency_init()");
+
+	cd = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*cd));
+	if (!cd)
+		return -ENOMEM;
+
+	cd->config.size = sizeof(cd->config);
+	cd->result.size = sizeof(cd->result);
+	cd->loopback_source = -1;
+	mod->priv.private = cd;
+	mod->max_sources = 2;
+
+	/* a configuration in the topology starts measuring once prepared */
+	if (cfg->data && cfg->size) {
+		if (loopback_latency_check_config(dev, cfg->data, cfg->size) < 0) {
+			rfree(cd);
+			return -EINVAL;
+		}
+
+		memcpy_s(&cd->new_config, sizeof(cd->new_config), cfg->data, cfg->size);
+		cd->config_pending = true;
+	}
+
+	return 0;
+}
+
+static void loopback_latency_release(struct loopback_latency_data *cd)
+{
+	rfree(cd->capture);
+	rfree(cd->r);
+	cd->capture = NULL;
+	cd->r = NULL;
+}
+
+static int loopback_latency_free(struct processing_module *mod)
+{
+	struct loopback_latency_data *cd = module_get_private_data(mod);
+
+	comp_info(mod->dev, "loopback_latency_free()");
+
+	loopback_latency_release(cd);
+	rfree(cd);
+
+	return 0;
+}
+
+#if CONFIG_IPC_MAJOR_4
+static void loopback_latency_params(struct processing_module *mod)
+{
+	struct sof_ipc_stream_params *params = mod->stream_params;
+	struct comp_buffer *sinkb, *sourceb;
+	struct list_item *source_list;
+	struct comp_dev *dev = mod->dev;
+
+	ipc4_base_module_cfg_to_stream_params(&mod->priv.cfg.base_cfg, params);
+	component_set_nearest_period_frames(dev, params->rate);
+
+	/* the loopback has the format of the playback */
+	list_for_item(source_list, &dev->bsource_list) {
+		sourceb = container_of(source_list, struct comp_buffer, sink_list);
+		ipc4_update_buffer_format(sourceb, &mod->priv.cfg.base_cfg.audio_fmt);
+	}
+
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+	ipc4_update_buffer_format(sinkb, &mod->priv.cfg.base_cfg.audio_fmt);
+}
+#endif /* CONFIG_IPC_MAJOR_4 */
+
+static bool loopback_latency_format_valid(enum sof_ipc_frame format)
+{
+	return format == SOF_IPC_FRAME_S16_LE || format == SOF_IPC_FRAME_S24_4LE ||
+	       format == SOF_IPC_FRAME_S32_LE;
+}
+
+static int loopback_latency_prepare(struct processing_module *mod,
+				    struct sof_source **sources, int num_of_sources,
+				    struct sof_sink **sinks, int num_of_sinks)
+{
+	struct loopback_latency_data *cd = module_get_private_data(mod);
+	struct comp_buffer *sourceb, *sinkb, *playbackb = NULL;
+	struct comp_dev *dev = mod->dev;
+	struct list_item *blist;
+	int i = 0;
+
+	comp_info(dev, "loopback_latency_prepare()");
+
+#if CONFIG_IPC_MAJOR_4
+	loopback_latency_params(mod);
+#endif
+
+	cd->loopback_source = -1;
+	list_for_item(blist, &dev->bsource_list) {
+		sourceb = container_of(blist, struct comp_buffer, sink_list);
+#if CONFIG_IPC_MAJOR_4
+		if (IPC4_SINK_QUEUE_ID(sourceb->id) == LOOPBACK_LATENCY_QUEUE_ID) {
+#else
+		if (sourceb->source->pipeline->pipeline_id != dev->pipeline->pipeline_id) {
+#endif
+			cd->loopback_source = i;
+			cd->loopback_format = audio_stream_get_frm_fmt(&sourceb->stream);
+		} else {
+			cd->playback_source = i;
+			playbackb = sourceb;
+		}
+		i++;
+	}
+
+	if (!playbackb || i > 2) {
+		comp_err(dev, "loopback_latency_prepare(): needs a playback and a loopback source");
+		return -EINVAL;
+	}
+
+	if (cd->loopback_source < 0)
+		comp_warn(dev, "loopback_latency_prepare(): no loopback, measurements time out");
+
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+	cd->format = audio_stream_get_frm_fmt(&playbackb->stream);
+	cd->channels = audio_stream_get_channels(&playbackb->stream);
+	cd->rate = audio_stream_get_rate(&playbackb->stream);
+
+	if (!cd->rate || !loopback_latency_format_valid(cd->format) ||
+	    cd->format != audio_stream_get_frm_fmt(&sinkb->stream) ||
+	    cd->channels != audio_stream_get_channels(&sinkb->stream) ||
+	    (cd->loopback_source >= 0 && !loopback_latency_format_valid(cd->loopback_format))) {
+		comp_err(dev, "loopback_latency_prepare(): unsupported formats");
+		return -EINVAL;
+	}
+
+	/* the burst of each measurement is searched in this many loopback frames */
+	cd->lag = (CONFIG_COMP_LOOPBACK_LATENCY_MAX_MS * cd->rate / 1000 + 1) / 2;
+	cd->capture_len = LOOPBACK_LATENCY_BURST_FRAMES + 2 * cd->lag;
+
+	loopback_latency_release(cd);
+	cd->capture = rballoc(0, SOF_MEM_CAPS_RAM, sizeof(*cd->capture) * cd->capture_len);
+	cd->r = rballoc(0, SOF_MEM_CAPS_RAM, sizeof(*cd->r) * (2 * cd->lag + 1));
+	if (!cd->capture || !cd->r) {
+		comp_err(dev, "loopback_latency_prepare(): no memory for %u lags", 2 * cd->lag + 1);
+		loopback_latency_release(cd);
+		return -ENOMEM;
+	}
+
+	cd->state = LOOPBACK_LATENCY_IDLE;
+	cd->interval_frames = (uint64_t)cd->config.interval_ms * cd->rate / 1000;
+	cd->countdown = cd->interval_frames;
+	loopback_latency_set_burst(cd);
+
+	return 0;
+}
+
+static int loopback_latency_reset(struct processing_module *mod)
+{
+	struct loopback_latency_data *cd = module_get_private_data(mod);
+
+	comp_info(mod->dev, "loopback_latency_reset()");
+
+	loopback_latency_release(cd);
+	cd->state = LOOPBACK_LATENCY_IDLE;
+
+	return 0;
+}
+
+static const struct module_interface loopback_latency_interface = {
+	.init = loopback_latency_init,
+	.prepare = loopback_latency_prepare,
+	.process_audio_stream = loopback_latency_process,
+	.set_configuration = loopback_latency_set_config,
+	.get_configuration = loopback_latency_get_config,
+	.reset = loopback_latency_reset,
+	.free = loopback_latency_free,
+};
+
+DECLARE_MODULE_ADAPTER(loopback_latency_interface, loopback_latency_uuid, loopback_latency_tr);
+SOF_MODULE_INIT(loopback_latency, sys_comp_module_loopback_latency_interface_init);
@@ -225,14 +225,19 @@ static int mfcc_prepare(struct processing_module *mod,
 
 	cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
 
+	/* MFCC has no pass-through, it can't run without a configuration */
+	if (!cd->config) {
+		comp_err(dev, "mfcc_prepare(), no configuration");
+		ret = -EINVAL;
+		goto err;
+	}
+
 	/* Initialize MFCC, max_frames is set to dev->frames + 4 */
-	if (cd->config) {
-		ret = mfcc_setup(mod, dev->frames + 4, audio_stream_get_rate(&sourceb->stream),
-				 audio_stream_get_channels(&sourceb->stream));
-		if (ret < 0) {
-			comp_err(dev, "mfcc_prepare(), setup failed.");
-			goto err;
-		}
+	ret = mfcc_setup(mod, dev->frames + 4, audio_stream_get_rate(&sourceb->stream),
+			 audio_stream_get_channels(&sourceb->stream));
+	if (ret < 0) {
+		comp_err(dev, "mfcc_prepare(), setup failed.");
+		goto err;
 	}
 
 	cd->mfcc_func = mfcc_find_func(source_format, sink_format, mfcc_fm, ARRAY_SIZE(mfcc_fm));
@@ -15,6 +15,7 @@
 #include <sof/math/window.h>
 #include <sof/trace/trace.h>
 #include <user/mfcc.h>
+#include <rtos/string.h>
 #include <errno.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -33,18 +34,107 @@ LOG_MODULE_REGISTER(mfcc_common, CONFIG_SOF_LOG_LEVEL);
 #define MFCC_NORMALIZE_MAX_SHIFT	10
 
 /*
- * The main processing function for MFCC
+ * The STFT front end, compute the Mel band logarithmic spectrum of one
+ * frame into state->mel_spectra.
+ */
+static void mfcc_stft_frame(struct mfcc_state *state)
+{
+	struct mfcc_fft *fft = &state->fft;
+	int mel_scale_shift;
+	int input_shift;
+
+	/* Clear FFT input buffer because it has been used as scratch */
+	bzero(fft->fft_buf, fft->fft_buffer_size);
+
+	/* Copy data to FFT input buffer from overlap buffer and from new samples buffer */
+	mfcc_fill_fft_buffer(state);
+
+	/* TODO: remove_dc_offset */
+
+	/* TODO: use_energy & raw_energy */
+
+#ifdef MFCC_NORMALIZE_FFT
+	/* Find block scale left shift for FFT input */
+	input_shift = mfcc_normalize_fft_buffer(state);
+#else
+	input_shift = 0;
+#endif
+
+	/* Window function */
+	mfcc_apply_window(state, input_shift);
+
+	/* TODO: use_energy & !raw_energy */
+
+	/* The FFT out buffer needs to be cleared to avoid to corrupt
+	 * the output. TODO: check moving it to FFT lib.
+	 */
+	bzero(fft->fft_out, fft->fft_buffer_size);
+
+	/* Compute FFT */
+#if MFCC_FFT_BITS == 16
+	fft_execute_16(fft->fft_plan, false);
+#else
+	fft_execute_32(fft->fft_plan, false);
+#endif
+
+	/* Convert powerspectrum to Mel band logarithmic spectrum */
+	mat_init_16b(state->mel_spectra, 1, state->dct.num_in, 7); /* Q8.7 */
+
+	/* Compensate FFT lib scaling to Mel log values, e.g. for 512 long FFT
+	 * the fft_plan->len is 9. The scaling is 1/512. Subtract from input_shift it
+	 * to add the missing "gain".
+	 */
+	mel_scale_shift = input_shift - fft->fft_plan->len;
+#if MFCC_FFT_BITS == 16
+	psy_apply_mel_filterbank_16(&state->melfb, fft->fft_out, state->power_spectra,
+				    state->mel_spectra->data, mel_scale_shift);
+#else
+	psy_apply_mel_filterbank_32(&state->melfb, fft->fft_out, state->power_spectra,
+				    state->mel_spectra->data, mel_scale_shift);
+#endif
+}
+
+/*
+ * Compute the cepstral coefficients from state->mel_spectra and append them
+ * to the batch of frames waiting for output. The oldest frame is dropped if
+ * the sink has not consumed the batch.
+ */
+static void mfcc_cepstral_frame(struct mfcc_state *state)
+{
+	int num_ceps = state->dct.num_out;
+	int idx;
+
+	/* Multiply Mel spectra with DCT matrix to get cepstral coefficients */
+	mat_init_16b(state->cepstral_coef, 1, num_ceps, 7); /* Q8.7 */
+	mat_multiply(state->mel_spectra, state->dct.matrix, state->cepstral_coef);
+
+	/* Apply cepstral lifter */
+	if (state->lifter.cepstral_lifter != 0)
+		mat_multiply_elementwise(state->cepstral_coef, state->lifter.matrix,
+					 state->cepstral_coef);
+
+	if (state->batch_frames == state->batch_max) {
+		state->batch_read = (state->batch_read + 1) % state->batch_max;
+		state->batch_frames--;
+	}
+
+	idx = (state->batch_read + state->batch_frames) % state->batch_max;
+	memcpy_s(&state->ceps_batch[idx * num_ceps], num_ceps * sizeof(int16_t),
+		 state->cepstral_coef->data, num_ceps * sizeof(int16_t));
+	state->batch_frames++;
+}
+
+/*
+ * The main processing function for MFCC, returns the number of new frames
+ * added to the batch.
  */
 
 static int mfcc_stft_process(const struct comp_dev *dev, struct mfcc_state *state)
 {
 	struct mfcc_buffer *buf = &state->buf;
 	struct mfcc_fft *fft = &state->fft;
-	int mel_scale_shift;
-	int input_shift;
 	int i;
 	int m;
-	int cc_count = 0;
 
 	/* Phase 1, wait until whole fft_size is filled with valid data. This way
 	 * first output cepstral coefficients originate from streamed data and not
@@ -66,77 +156,14 @@ static int mfcc_stft_process(const struct comp_dev *dev, struct mfcc_state *stat
 		state->prev_samples_valid = true;
 	}
 
-	/* Check if enough samples in buffer for FFT hop */
+	/* Process all the hops available in the buffer as a batch */
 	m = buf->s_avail / fft->fft_hop_size;
 	for (i = 0; i < m; i++) {
-		/* Clear FFT input buffer because it has been used as scratch */
-		bzero(fft->fft_buf, fft->fft_buffer_size);
-
-		/* Copy data to FFT input buffer from overlap buffer and from new samples buffer */
-		mfcc_fill_fft_buffer(state);
-
-		/* TODO: remove_dc_offset */
-
-		/* TODO: use_energy & raw_energy */
-
-#ifdef MFCC_NORMALIZE_FFT
-		/* Find block scale left shift for FFT input */
-		input_shift = mfcc_normalize_fft_buffer(state);
-#else
-		input_shift = 0;
-#endif
-
-		/* Window function */
-		mfcc_apply_window(state, input_shift);
-
-		/* TODO: use_energy & !raw_energy */
-
-		/* The FFT out buffer needs to be cleared to avoid to corrupt
-		 * the output. TODO: check moving it to FFT lib.
-		 */
-		bzero(fft->fft_out, fft->fft_buffer_size);
-
-		/* Compute FFT */
-#if MFCC_FFT_BITS == 16
-		fft_execute_16(fft->fft_plan, false);
-#else
-		fft_execute_32(fft->fft_plan, false);
-#endif
-
-		/* Convert powerspectrum to Mel band logarithmic spectrum */
-		mat_init_16b(state->mel_spectra, 1, state->dct.num_in, 7); /* Q8.7 */
-
-		/* Compensate FFT lib scaling to Mel log values, e.g. for 512 long FFT
-		 * the fft_plan->len is 9. The scaling is 1/512. Subtract from input_shift it
-		 * to add the missing "gain".
-		 */
-		mel_scale_shift = input_shift - fft->fft_plan->len;
-#if MFCC_FFT_BITS == 16
-		psy_apply_mel_filterbank_16(&state->melfb, fft->fft_out, state->power_spectra,
-					    state->mel_spectra->data, mel_scale_shift);
-#else
-		psy_apply_mel_filterbank_32(&state->melfb, fft->fft_out, state->power_spectra,
-					    state->mel_spectra->data, mel_scale_shift);
-#endif
-
-		/* Multiply Mel spectra with DCT matrix to get cepstral coefficients */
-		mat_init_16b(state->cepstral_coef, 1, state->dct.num_out, 7); /* Q8.7 */
-		mat_multiply(state->mel_spectra, state->dct.matrix, state->cepstral_coef);
-
-		/* Apply cepstral lifter */
-		if (state->lifter.cepstral_lifter != 0)
-			mat_multiply_elementwise(state->cepstral_coef, state->lifter.matrix,
-						 state->cepstral_coef);
-
-		cc_count += state->dct.num_out;
-
-		/* Output to sink buffer */
+		mfcc_stft_frame(state);
+		mfcc_cepstral_frame(state);
 	}
 
-	/* TODO: This version handles only one FFT run per copy(). How to pass multiple
-	 * cepstral coefficients sets return is an open.
-	 */
-	return cc_count;
+	return m;
 }
 
 #if CONFIG_FORMAT_S16LE
@@ -151,25 +178,31 @@ void mfcc_s16_default(struct processing_module *mod, struct input_stream_buffer
 	int16_t *w_ptr = audio_stream_get_wptr(sink);
 	// int num_magic = sizeof(magic) / sizeof(int16_t);
 	const int num_magic = 2;
-	int num_ceps;
+	const int num_ceps = state->dct.num_out;
 	int zero_samples;
+	int n;
 
 	/* Get samples from source buffer */
 	mfcc_source_copy_s16(bsource, buf, &state->emph, frames, state->source_channel);
 
-	/* Run STFT and processing after FFT: Mel auditory filter and DCT. The sink
-	 * buffer is updated during STDF processing.
+	/* Run STFT and processing after FFT: Mel auditory filter and DCT. The
+	 * new frames are added to the batch.
 	 */
-	num_ceps = mfcc_stft_process(mod->dev, state);
+	mfcc_stft_process(mod->dev, state);
 
-	/* Done, copy data to sink. This works only if the period has room for magic (2)
-	 * plus num_ceps int16_t samples. TODO: split ceps over multiple periods.
+	/* Done, copy to sink the batched frames, magic (2) plus num_ceps int16_t
+	 * samples each, that fit into the period. The rest of the frames are
+	 * output in the next periods.
 	 */
 	zero_samples = frames * audio_stream_get_channels(sink);
-	if (num_ceps > 0) {
-		zero_samples -= num_ceps + num_magic;
+	n = MIN(state->batch_frames, zero_samples / (num_ceps + num_magic));
+	state->batch_frames -= n;
+	zero_samples -= n * (num_ceps + num_magic);
+	while (n--) {
 		w_ptr = mfcc_sink_copy_data_s16(sink, w_ptr, num_magic, (int16_t *)&magic);
-		w_ptr = mfcc_sink_copy_data_s16(sink, w_ptr, num_ceps, state->cepstral_coef->data);
+		w_ptr = mfcc_sink_copy_data_s16(sink, w_ptr, num_ceps,
+						&state->ceps_batch[state->batch_read * num_ceps]);
+		state->batch_read = (state->batch_read + 1) % state->batch_max;
 	}
 
 	w_ptr = mfcc_sink_copy_zero_s16(sink, w_ptr, zero_samples);
@@ -8,6 +8,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/audio_stream.h>
 #include <sof/math/auditory.h>
+#include <sof/math/table_cache.h>
 #include <sof/math/trig.h>
 #include <sof/math/window.h>
 #include <sof/trace/trace.h>
@@ -34,27 +35,60 @@ static void mfcc_init_buffer(struct mfcc_buffer *buf, int16_t *base, int size)
 	buf->s_length = size;
 }
 
+static void mfcc_fill_window(void *table, const struct sofm_table_key *key)
+{
+	int16_t *win = table;
+
+	switch (key->type) {
+	case SOFM_TABLE_WIN_RECTANGULAR:
+		win_rectangular_16b(win, key->length);
+		break;
+	case SOFM_TABLE_WIN_BLACKMAN:
+		win_blackman_16b(win, key->length, key->param);
+		break;
+	case SOFM_TABLE_WIN_HAMMING:
+		win_hamming_16b(win, key->length);
+		break;
+	case SOFM_TABLE_WIN_POVEY:
+		win_povey_16b(win, key->length);
+		break;
+	}
+}
+
+/* The window is shared with other instances using the same window type and
+ * FFT size.
+ */
 static int mfcc_get_window(struct mfcc_state *state, enum sof_mfcc_fft_window_type name)
 {
 	struct mfcc_fft *fft = &state->fft;
+	struct sofm_table_key key = {
+		.bits = 16,
+		.length = fft->fft_size,
+	};
 
 	switch (name) {
 	case MFCC_RECTANGULAR_WINDOW:
-		win_rectangular_16b(state->window, fft->fft_size);
-		return 0;
+		key.type = SOFM_TABLE_WIN_RECTANGULAR;
+		break;
 	case MFCC_BLACKMAN_WINDOW:
-		win_blackman_16b(state->window, fft->fft_size, MFCC_BLACKMAN_A0);
-		return 0;
+		key.type = SOFM_TABLE_WIN_BLACKMAN;
+		key.param = MFCC_BLACKMAN_A0;
+		break;
 	case MFCC_HAMMING_WINDOW:
-		win_hamming_16b(state->window, fft->fft_size);
-		return 0;
+		key.type = SOFM_TABLE_WIN_HAMMING;
+		break;
 	case MFCC_POVEY_WINDOW:
-		win_povey_16b(state->window, fft->fft_size);
-		return 0;
-
+		key.type = SOFM_TABLE_WIN_POVEY;
+		break;
 	default:
 		return -EINVAL;
 	}
+
+	state->window = sofm_table_get(&key, sizeof(int16_t) * fft->fft_size, mfcc_fill_window);
+	if (!state->window)
+		return -ENOMEM;
+
+	return 0;
 }
 
 /* The function returns a vector for multiplying the cepstral coefficients when
@@ -65,31 +99,46 @@ static int mfcc_get_window(struct mfcc_state *state, enum sof_mfcc_fft_window_ty
  * coef[i] = 1.0 + 0.5 * lifter * sin(pi * i / lifter), i = 0 to num_ceps-1
  */
 
-static int mfcc_get_cepstral_lifter(struct mfcc_cepstral_lifter *cl)
+static void mfcc_fill_cepstral_lifter(void *table, const struct sofm_table_key *key)
 {
+	struct mat_matrix_16b *matrix = table;
+	const int16_t cepstral_lifter = key->param;
 	int32_t inv_cepstral_lifter;
 	int32_t val;
 	int32_t sin;
 	int i;
 
-	if (cl->num_ceps > DCT_MATRIX_SIZE_MAX)
-		return -EINVAL;
+	mat_init_16b(matrix, 1, key->length, 9); /* Use Q7.9 */
+	inv_cepstral_lifter = (1 << 30) / cepstral_lifter; /* Q2.30 / Q7.9 -> Q1.21 */
 
-	cl->matrix = mat_matrix_alloc_16b(1, cl->num_ceps, 9); /* Use Q7.9 */
-	if (!cl->matrix)
-		return -ENOMEM;
-
-	inv_cepstral_lifter = (1 << 30) / cl->cepstral_lifter; /* Q2.30 / Q7.9 -> Q1.21 */
-
-	for (i = 0; i < cl->num_ceps; i++) {
+	for (i = 0; i < key->length; i++) {
 		val = Q_MULTSR_32X32((int64_t)inv_cepstral_lifter, PI_Q23 * i, 21, 23, 23);
 		val %= TWO_PI_Q23;
 		sin = sin_fixed_32b(Q_SHIFT_LEFT(val, 23, 28)); /* Q4.28 -> Q1.31 */
 		/* Val is Q7.9 make 0.5 multiply with additional shift */
-		val = Q_MULTSR_32X32((int64_t)sin, cl->cepstral_lifter, 31, 9, 9 - 1);
+		val = Q_MULTSR_32X32((int64_t)sin, cepstral_lifter, 31, 9, 9 - 1);
 		val += ONE_Q9;
-		mat_set_scalar_16b(cl->matrix, 0, i, sat_int16(val));
+		mat_set_scalar_16b(matrix, 0, i, sat_int16(val));
 	}
+}
+
+static int mfcc_get_cepstral_lifter(struct mfcc_cepstral_lifter *cl)
+{
+	struct sofm_table_key key = {
+		.type = SOFM_TABLE_CEPSTRAL_LIFTER,
+		.bits = 16,
+		.length = cl->num_ceps,
+		.param = cl->cepstral_lifter,
+	};
+
+	if (cl->num_ceps > DCT_MATRIX_SIZE_MAX)
+		return -EINVAL;
+
+	cl->matrix = sofm_table_get(&key, sizeof(struct mat_matrix_16b) +
+				    sizeof(int16_t) * cl->num_ceps,
+				    mfcc_fill_cepstral_lifter);
+	if (!cl->matrix)
+		return -ENOMEM;
 
 	return 0;
 }
@@ -149,6 +198,11 @@ int mfcc_setup(struct processing_module *mod, int max_frames, int sample_rate, i
 	else
 		state->source_channel = config->channel;
 
+	if (config->frame_shift < 1 || config->frame_shift > config->frame_length) {
+		comp_err(dev, "mfcc_setup(): Illegal frame_shift %d", config->frame_shift);
+		return -EINVAL;
+	}
+
 	state->emph.enable = config->preemphasis_coefficient > 0;
 	state->emph.coef = -config->preemphasis_coefficient; /* Negate config parameter */
 	fft->fft_size = config->frame_length;
@@ -166,7 +220,7 @@ int mfcc_setup(struct processing_module *mod, int max_frames, int sample_rate, i
 
 	/* Allocate buffer input samples and overlap buffer */
 	state->sample_buffers_size = sizeof(int16_t) *
-		(state->buffer_size + state->prev_data_size + fft->fft_size);
+		(state->buffer_size + state->prev_data_size);
 
 	comp_info(dev, "mfcc_setup(), buffer_size = %d, prev_size = %d",
 		  state->buffer_size, state->prev_data_size);
@@ -181,7 +235,6 @@ int mfcc_setup(struct processing_module *mod, int max_frames, int sample_rate, i
 
 	mfcc_init_buffer(&state->buf, state->buffers, state->buffer_size);
 	state->prev_data = state->buffers + state->buffer_size;
-	state->window = state->prev_data + state->prev_data_size;
 
 	/* Allocate buffers for FFT input and output data */
 #if MFCC_FFT_BITS == 16
@@ -245,7 +298,7 @@ int mfcc_setup(struct processing_module *mod, int max_frames, int sample_rate, i
 	ret = psy_get_mel_filterbank(fb);
 	if (ret < 0) {
 		comp_err(dev, "mfcc_setup(): Failed Mel filterbank");
-		goto free_fft_out;
+		goto free_window;
 	}
 
 	/* Setup DCT */
@@ -267,6 +320,22 @@ int mfcc_setup(struct processing_module *mod, int max_frames, int sample_rate, i
 		goto free_dct_matrix;
 	}
 
+	/* Allocate the batch of output frames for all hops that can be processed
+	 * from the input buffer in one copy.
+	 */
+	state->batch_max = state->buffer_size / fft->fft_hop_size;
+	state->batch_read = 0;
+	state->batch_frames = 0;
+	state->ceps_batch = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+				    state->batch_max * config->num_ceps * sizeof(int16_t));
+	if (!state->ceps_batch) {
+		comp_err(dev, "mfcc_setup(): Failed batch allocate");
+		ret = -ENOMEM;
+		goto free_lifter;
+	}
+
+	comp_info(dev, "mfcc_setup(), batch_max = %d", state->batch_max);
+
 	/* Scratch overlay during runtime
 	 *
 	 *  +--------------------------------------------------------+
@@ -298,12 +367,18 @@ int mfcc_setup(struct processing_module *mod, int max_frames, int sample_rate, i
 	comp_dbg(dev, "mfcc_setup(), done");
 	return 0;
 
+free_lifter:
+	sofm_table_put(state->lifter.matrix);
+
 free_dct_matrix:
-	rfree(state->dct.matrix);
+	dct_free_16(&state->dct);
 
 free_melfb_data:
 	rfree(fb->data);
 
+free_window:
+	sofm_table_put(state->window);
+
 free_fft_out:
 	rfree(fft->fft_out);
 
@@ -324,6 +399,8 @@ void mfcc_free_buffers(struct mfcc_comp_data *cd)
 	rfree(cd->state.fft.fft_out);
 	rfree(cd->state.buffers);
 	rfree(cd->state.melfb.data);
-	rfree(cd->state.dct.matrix);
-	rfree(cd->state.lifter.matrix);
+	dct_free_16(&cd->state.dct);
+	sofm_table_put(cd->state.lifter.matrix);
+	sofm_table_put(cd->state.window);
+	rfree(cd->state.ceps_batch);
 }
@@ -103,6 +103,13 @@ struct mixout_data {
 	 * by mixin but not yet produced in mixout.
 	 */
 	struct pending_frames pending_frames[MIXOUT_MAX_SOURCES];
+
+	/*
+	 * Set when all mixins connected to this mixout leave the mixing to
+	 * mixout_process(), see mixout_fused_process().
+	 */
+	bool fused;
+	fused_mix_func fused_mix;
 };
 
 /* NULL is also a valid mixin argument: in such case the function returns first unused entry */
@@ -118,6 +125,19 @@ static struct pending_frames *get_mixin_pending_frames(struct mixout_data *mixou
 	return NULL;
 }
 
+/* mixout connected to mixin through the unused buffer in between */
+static struct mixout_data *mixin_get_mixout_data(struct audio_stream *unused_in_between_stream)
+{
+	struct comp_buffer *unused_in_between_buf;
+	struct processing_module *mixout_mod;
+
+	unused_in_between_buf = container_of(unused_in_between_stream, struct comp_buffer,
+					     stream);
+	mixout_mod = comp_get_drvdata(unused_in_between_buf->sink);
+
+	return module_get_private_data(mixout_mod);
+}
+
 static int mixin_init(struct processing_module *mod)
 {
 	struct module_data *mod_data = &mod->priv;
@@ -285,6 +305,10 @@ static int mixin_process(struct processing_module *mod,
 		return -EINVAL;
 	}
 
+	/* source data is left to be mixed and consumed by mixout */
+	if (num_output_buffers == 1 && mixin_get_mixout_data(output_buffers[0].data)->fused)
+		return 0;
+
 	/* first, let's find out how many frames can be now processed --
 	 * it is a nimimal value among frames available in source buffer
 	 * and frames free in each connected mixout sink buffer.
@@ -421,6 +445,135 @@ static int mixin_process(struct processing_module *mod,
 	return 0;
 }
 
+/*
+ * Mixins can leave the mixing to mixout when each of them feeds this mixout
+ * only, on the same core and with the same format. mixout then reads all the
+ * mixin sources in a single pass over its sink buffer instead of every mixin
+ * reading back and rewriting the sink.
+ */
+static bool mixout_can_fuse(struct processing_module *mod,
+			    struct input_stream_buffer *input_buffers, int num_input_buffers,
+			    struct output_stream_buffer *output_buffers)
+{
+	struct mixout_data *md = module_get_private_data(mod);
+	struct audio_stream *sink = output_buffers[0].data;
+	int i;
+
+	/* data mixed by mixins has to be produced first */
+	if (!md->fused_mix || md->mixed_frames)
+		return false;
+
+	for (i = 0; i < num_input_buffers; i++) {
+		struct comp_buffer *unused_in_between_buf;
+		struct processing_module *mixin_mod;
+		struct mixin_data *mixin_data;
+		struct comp_buffer *source;
+		struct comp_dev *mixin;
+		uint16_t sink_id;
+
+		unused_in_between_buf = container_of(input_buffers[i].data, struct comp_buffer,
+						     stream);
+		mixin = unused_in_between_buf->source;
+		if (mixin->state != COMP_STATE_ACTIVE)
+			continue;
+
+		if (mixin->ipc_config.core != mod->dev->ipc_config.core ||
+		    list_is_empty(&mixin->bsource_list) ||
+		    !list_item_is_last(mixin->bsink_list.next, &mixin->bsink_list))
+			return false;
+
+		source = list_first_item(&mixin->bsource_list, struct comp_buffer, sink_list);
+		if (audio_stream_get_valid_fmt(&source->stream) != audio_stream_get_valid_fmt(sink) ||
+		    audio_stream_get_channels(&source->stream) != audio_stream_get_channels(sink))
+			return false;
+
+		mixin_mod = comp_get_drvdata(mixin);
+		mixin_data = module_get_private_data(mixin_mod);
+		sink_id = IPC4_SRC_QUEUE_ID(unused_in_between_buf->id);
+		if (sink_id >= MIXIN_MAX_SINKS ||
+		    mixin_data->sink_config[sink_id].mixer_mode != IPC4_MIXER_NORMAL_MODE)
+			return false;
+	}
+
+	return true;
+}
+
+/* mix all mixin sources into mixout sink at once, consume mixins source data */
+static int mixout_fused_process(struct processing_module *mod,
+				struct input_stream_buffer *input_buffers, int num_input_buffers,
+				struct output_stream_buffer *output_buffers)
+{
+	struct mixout_data *md = module_get_private_data(mod);
+	struct audio_stream *sources[MIXOUT_MAX_SOURCES];
+	struct comp_buffer *source_bufs[MIXOUT_MAX_SOURCES];
+	struct processing_module *mixin_mods[MIXOUT_MAX_SOURCES];
+	uint16_t gains[MIXOUT_MAX_SOURCES];
+	struct audio_stream *sink = output_buffers[0].data;
+	uint32_t frames = audio_stream_get_free_frames(sink);
+	uint32_t sink_bytes, source_bytes;
+	int count = 0;
+	int i;
+
+	for (i = 0; i < num_input_buffers && count < MIXOUT_MAX_SOURCES; i++) {
+		struct comp_buffer *unused_in_between_buf;
+		struct mixin_data *mixin_data;
+		struct comp_buffer *source;
+		struct comp_dev *mixin;
+		uint32_t avail_frames;
+		uint16_t sink_id;
+
+		unused_in_between_buf = container_of(input_buffers[i].data, struct comp_buffer,
+						     stream);
+		mixin = unused_in_between_buf->source;
+		if (mixin->state != COMP_STATE_ACTIVE)
+			continue;
+
+		/* a source without data is mixed as silence */
+		source = list_first_item(&mixin->bsource_list, struct comp_buffer, sink_list);
+		avail_frames = audio_stream_get_avail_frames(&source->stream);
+		if (!avail_frames)
+			continue;
+
+		frames = MIN(frames, avail_frames);
+
+		mixin_mods[count] = comp_get_drvdata(mixin);
+		mixin_data = module_get_private_data(mixin_mods[count]);
+		sink_id = IPC4_SRC_QUEUE_ID(unused_in_between_buf->id);
+		gains[count] = mixin_data->sink_config[sink_id].gain;
+		source_bufs[count] = source;
+		sources[count] = &source->stream;
+		count++;
+	}
+
+	if (!count || !frames) {
+		sink_bytes = mod->dev->frames * audio_stream_frame_bytes(sink);
+		if (!audio_stream_set_zero(sink, sink_bytes)) {
+			output_buffers[0].size = sink_bytes;
+			audio_stream_mark_silent(sink);
+		} else {
+			output_buffers[0].size = 0;
+		}
+		return 0;
+	}
+
+	source_bytes = audio_stream_period_bytes(sources[0], frames);
+	for (i = 0; i < count; i++)
+		buffer_stream_invalidate(source_bufs[i], source_bytes);
+
+	md->fused_mix(sink, sources, gains, count, frames * audio_stream_get_channels(sink));
+
+	sink_bytes = audio_stream_period_bytes(sink, frames);
+	buffer_stream_writeback(container_of(sink, struct comp_buffer, stream), sink_bytes);
+	output_buffers[0].size = sink_bytes;
+
+	for (i = 0; i < count; i++) {
+		audio_stream_consume(sources[i], source_bytes);
+		mixin_mods[i]->total_data_consumed += source_bytes;
+	}
+
+	return 0;
+}
+
 /* mixout just calls xxx_produce() on data mixed into its sink buffer by
  * mixins.
  */
@@ -439,6 +592,17 @@ static int mixout_process(struct processing_module *mod,
 
 	md = module_get_private_data(mod);
 
+	if (md->fused) {
+		if (mixout_can_fuse(mod, input_buffers, num_input_buffers, output_buffers))
+			return mixout_fused_process(mod, input_buffers, num_input_buffers,
+						    output_buffers);
+
+		/* mixins not feeding this mixout only mix on their own, the others
+		 * start doing so in the next period
+		 */
+		md->fused = false;
+	}
+
 	/* iterate over all connected mixins to find minimal value of frames they consumed
 	 * (i.e., mixed into mixout sink buffer). That is the amount that can/should be
 	 * produced now.
@@ -492,12 +656,17 @@ static int mixout_process(struct processing_module *mod,
 		output_buffers[0].size = sink_bytes;
 	} else {
 		sink_bytes = dev->frames * audio_stream_frame_bytes(output_buffers[0].data);
-		if (!audio_stream_set_zero(output_buffers[0].data, sink_bytes))
+		if (!audio_stream_set_zero(output_buffers[0].data, sink_bytes)) {
 			output_buffers[0].size = sink_bytes;
-		else
+			audio_stream_mark_silent(output_buffers[0].data);
+		} else {
 			output_buffers[0].size = 0;
+		}
 	}
 
+	/* mixins mix into this mixout sink until it is drained */
+	md->fused = mixout_can_fuse(mod, input_buffers, num_input_buffers, output_buffers);
+
 	return 0;
 }
 
@@ -516,11 +685,14 @@ static int mixin_reset(struct processing_module *mod)
 
 static int mixout_reset(struct processing_module *mod)
 {
+	struct mixout_data *md = module_get_private_data(mod);
 	struct comp_dev *dev = mod->dev;
 	struct list_item *blist;
 
 	comp_dbg(dev, "mixout_reset()");
 
+	md->fused = false;
+
 	/* FIXME: move this to module_adapter_reset() */
 	if (dev->pipeline->source_comp->direction == SOF_IPC_STREAM_PLAYBACK) {
 		list_for_item(blist, &dev->bsource_list) {
@@ -705,6 +877,7 @@ static int mixout_prepare(struct processing_module *mod,
 			  struct sof_sink **sinks, int num_of_sinks)
 {
 	struct comp_dev *dev = mod->dev;
+	struct comp_buffer *sink;
 	struct mixout_data *md;
 	int ret, i;
 
@@ -720,6 +893,10 @@ static int mixout_prepare(struct processing_module *mod,
 	 */
 	md = module_get_private_data(mod);
 	md->mixed_frames = 0;
+	md->fused = false;
+
+	sink = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+	md->fused_mix = fused_mix_get_processing_function(audio_stream_get_valid_fmt(&sink->stream));
 
 	for (i = 0; i < MIXOUT_MAX_SOURCES; i++)
 		md->pending_frames[i].frames = 0;
@@ -751,6 +928,7 @@ int mixout_bind(struct processing_module *mod, void *data)
 	}
 
 	mixout_data = module_get_private_data(mod);
+	mixout_data->fused = false;
 
 	pending_frames = get_mixin_pending_frames(mixout_data, mixin);
 	/*
@@ -800,6 +978,7 @@ int mixout_unbind(struct processing_module *mod, void *data)
 	}
 
 	mixout_data = module_get_private_data(mod);
+	mixout_data->fused = false;
 
 	/* remove mixin from pending_frames array */
 	pending_frames = get_mixin_pending_frames(mixout_data, mixin);
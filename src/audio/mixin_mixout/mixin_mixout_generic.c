@@ -247,3 +247,143 @@ const struct mix_func_map mix_func_map[] = {
 const size_t mix_count = ARRAY_SIZE(mix_func_map);
 
 #endif
+
+/* The fused kernels below are used on all platforms. They accumulate a block of
+ * samples from every source with its gain applied and then write the block to
+ * the sink once, so the sink is not read back for each source.
+ */
+#define FUSED_MIX_BLOCK_SAMPLES 64
+
+/* number of samples that can be processed in all streams without a wrap */
+static int32_t fused_mix_samples_without_wrap(struct audio_stream *sink, void *dst,
+					      struct audio_stream **sources, void **src,
+					      int32_t source_count, int32_t samples)
+{
+	int32_t n = MIN(samples, FUSED_MIX_BLOCK_SAMPLES);
+	int32_t j;
+
+	n = MIN(n, audio_stream_bytes_without_wrap(sink, dst) /
+		   audio_stream_sample_bytes(sink));
+	for (j = 0; j < source_count; j++)
+		n = MIN(n, audio_stream_bytes_without_wrap(sources[j], src[j]) /
+			   audio_stream_sample_bytes(sources[j]));
+
+	return n;
+}
+
+#if CONFIG_FORMAT_S16LE
+static void fused_mix_s16(struct audio_stream *sink, struct audio_stream **sources,
+			  const uint16_t *gains, int32_t source_count, int32_t samples)
+{
+	int32_t acc[FUSED_MIX_BLOCK_SAMPLES];
+	void *src[IPC4_MIXOUT_MODULE_MAX_INPUT_QUEUES];
+	int16_t *dst = audio_stream_get_wptr(sink);
+	int16_t *in;
+	int32_t left, n, i, j;
+
+	for (j = 0; j < source_count; j++)
+		src[j] = audio_stream_get_rptr(sources[j]);
+
+	for (left = samples; left > 0; left -= n) {
+		dst = audio_stream_wrap(sink, dst);
+		for (j = 0; j < source_count; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j]);
+		n = fused_mix_samples_without_wrap(sink, dst, sources, src, source_count, left);
+
+		memset(acc, 0, n * sizeof(acc[0]));
+		for (j = 0; j < source_count; j++) {
+			in = src[j];
+			for (i = 0; i < n; i++)
+				acc[i] += (in[i] * gains[j]) >> IPC4_MIXIN_GAIN_SHIFT;
+			src[j] = in + n;
+		}
+
+		for (i = 0; i < n; i++)
+			dst[i] = sat_int16(acc[i]);
+		dst += n;
+	}
+}
+#endif	/* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void fused_mix_s24(struct audio_stream *sink, struct audio_stream **sources,
+			  const uint16_t *gains, int32_t source_count, int32_t samples)
+{
+	int32_t acc[FUSED_MIX_BLOCK_SAMPLES];
+	void *src[IPC4_MIXOUT_MODULE_MAX_INPUT_QUEUES];
+	int32_t *dst = audio_stream_get_wptr(sink);
+	int32_t *in;
+	int32_t left, n, i, j;
+
+	for (j = 0; j < source_count; j++)
+		src[j] = audio_stream_get_rptr(sources[j]);
+
+	for (left = samples; left > 0; left -= n) {
+		dst = audio_stream_wrap(sink, dst);
+		for (j = 0; j < source_count; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j]);
+		n = fused_mix_samples_without_wrap(sink, dst, sources, src, source_count, left);
+
+		memset(acc, 0, n * sizeof(acc[0]));
+		for (j = 0; j < source_count; j++) {
+			in = src[j];
+			for (i = 0; i < n; i++)
+				acc[i] += ((int64_t)sign_extend_s24(in[i]) * gains[j]) >>
+					  IPC4_MIXIN_GAIN_SHIFT;
+			src[j] = in + n;
+		}
+
+		for (i = 0; i < n; i++)
+			dst[i] = sat_int24(acc[i]);
+		dst += n;
+	}
+}
+#endif	/* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void fused_mix_s32(struct audio_stream *sink, struct audio_stream **sources,
+			  const uint16_t *gains, int32_t source_count, int32_t samples)
+{
+	int64_t acc[FUSED_MIX_BLOCK_SAMPLES];
+	void *src[IPC4_MIXOUT_MODULE_MAX_INPUT_QUEUES];
+	int32_t *dst = audio_stream_get_wptr(sink);
+	int32_t *in;
+	int32_t left, n, i, j;
+
+	for (j = 0; j < source_count; j++)
+		src[j] = audio_stream_get_rptr(sources[j]);
+
+	for (left = samples; left > 0; left -= n) {
+		dst = audio_stream_wrap(sink, dst);
+		for (j = 0; j < source_count; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j]);
+		n = fused_mix_samples_without_wrap(sink, dst, sources, src, source_count, left);
+
+		memset(acc, 0, n * sizeof(acc[0]));
+		for (j = 0; j < source_count; j++) {
+			in = src[j];
+			for (i = 0; i < n; i++)
+				acc[i] += ((int64_t)in[i] * gains[j]) >> IPC4_MIXIN_GAIN_SHIFT;
+			src[j] = in + n;
+		}
+
+		for (i = 0; i < n; i++)
+			dst[i] = sat_int32(acc[i]);
+		dst += n;
+	}
+}
+#endif	/* CONFIG_FORMAT_S32LE */
+
+const struct mix_fused_func_map mix_fused_func_map[] = {
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, fused_mix_s16},
+#endif
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, fused_mix_s24},
+#endif
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, fused_mix_s32}
+#endif
+};
+
+const size_t mix_fused_count = ARRAY_SIZE(mix_fused_func_map);
@@ -23,7 +23,9 @@ namespace dsp_fw
 				       uint32_t instance_id,
 				       uint32_t core_id,
 				       size_t module_size)
-				       :processing_module_(processing_module)
+				       :processing_module_(processing_module),
+				       input_stream_buffers_(),
+				       output_stream_buffers_()
 {
 }
 
@@ -44,33 +46,46 @@ uint32_t IadkModuleAdapter::IadkModuleAdapter_Process(struct input_stream_buffer
 {
 	uint32_t ret = 0;
 	if ((num_input_buffers > 0) && (num_output_buffers > 0)) {
-		intel_adsp::InputStreamBuffer input_stream_buffers[INPUT_PIN_COUNT];
-		intel_adsp::OutputStreamBuffer output_stream_buffers[OUTPUT_PIN_COUNT];
+		/*
+		 * The descriptors are kept across calls. The module buffers of an instance
+		 * do not move, so usually only the sizes are updated, the descriptors with
+		 * their const data pointer and flags are rebuilt only when those change.
+		 */
 		for (int i = 0; i < (int)num_input_buffers; i++) {
-			intel_adsp::InputStreamFlags flags = {};
-			flags.end_of_stream = input_buffers[i].end_of_stream;
-			const intel_adsp::InputStreamBuffer isb_data(
-				(uint8_t *)input_buffers[i].data,
-				input_buffers[i].size,
-				flags);
-			new (&input_stream_buffers[i]) intel_adsp::InputStreamBuffer(isb_data);
+			intel_adsp::InputStreamBuffer &isb = input_stream_buffers_[i];
+
+			if (isb.data != (uint8_t *)input_buffers[i].data ||
+			    isb.flags.end_of_stream != input_buffers[i].end_of_stream) {
+				intel_adsp::InputStreamFlags flags = {};
+				flags.end_of_stream = input_buffers[i].end_of_stream;
+				new (&isb) intel_adsp::InputStreamBuffer(
+					(uint8_t *)input_buffers[i].data,
+					input_buffers[i].size,
+					flags);
+			} else {
+				isb.size = input_buffers[i].size;
+			}
 		}
 
 		for (int i = 0; i < (int)num_output_buffers; i++) {
-			const intel_adsp::OutputStreamBuffer osb_data(
+			intel_adsp::OutputStreamBuffer &osb = output_stream_buffers_[i];
+
+			if (osb.data != (uint8_t *)output_buffers[i].data)
+				new (&osb) intel_adsp::OutputStreamBuffer(
 					(uint8_t *)output_buffers[i].data,
 					output_buffers[i].size);
-			new (&output_stream_buffers[i]) intel_adsp::OutputStreamBuffer(osb_data);
+			else
+				osb.size = output_buffers[i].size;
 		}
 
-		ret = processing_module_.Process(input_stream_buffers, output_stream_buffers);
+		ret = processing_module_.Process(input_stream_buffers_, output_stream_buffers_);
 
 		for (int i = 0; i < (int)num_input_buffers; i++) {
 			input_buffers[i].consumed = input_buffers[i].size;
 		}
 
 		for (int i = 0; i < (int)num_output_buffers; i++) {
-			output_buffers[i].size = output_stream_buffers[i].size;
+			output_buffers[i].size = output_stream_buffers_[i].size;
 		}
 	}
 	return ret;
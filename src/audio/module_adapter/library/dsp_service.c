@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+/*
+ * DSP helper interface for loadable modules, see dsp_service.h.
+ */
+
+#include <sof/audio/format.h>
+#include <sof/audio/sink_api.h>
+#include <sof/audio/source_api.h>
+#include <sof/common.h>
+#include <dsp_service.h>
+#include <stdint.h>
+
+#if CONFIG_MATH_FIR
+#include <sof/math/fir_config.h>
+#if FIR_GENERIC
+#include <sof/math/fir_generic.h>
+#endif
+#if FIR_HIFIEP
+#include <sof/math/fir_hifi2ep.h>
+#endif
+#if FIR_HIFI3
+#include <sof/math/fir_hifi3.h>
+#endif
+#endif
+#if CONFIG_MATH_IIR_DF2T
+#include <sof/math/iir_df2t.h>
+#endif
+#if CONFIG_MATH_FFT && CONFIG_MATH_32BIT_FFT
+#include <sof/math/fft.h>
+#endif
+
+#if CONFIG_MATH_FIR
+static size_t dsp_service_fir_state_size(void)
+{
+	return sizeof(struct fir_state_32x16);
+}
+
+static int dsp_service_fir_init(struct fir_state_32x16 *fir, struct sof_fir_coef_data *config,
+				int32_t *delay)
+{
+	int ret;
+
+	ret = fir_init_coef(fir, config);
+	if (ret < 0)
+		return ret;
+
+	fir_init_delay(fir, &delay);
+	return 0;
+}
+
+/* the hifi cores use the circular addressing set up for the delay line of this filter */
+static void dsp_service_fir_process(struct fir_state_32x16 *fir, const int32_t *in,
+				    int32_t *out, uint32_t samples, uint32_t stride)
+{
+	uint32_t i;
+#if FIR_HIFIEP || FIR_HIFI3
+	int lshift;
+	int rshift;
+
+	fir_get_lrshifts(fir, &lshift, &rshift);
+#endif
+#if FIR_HIFIEP
+	fir_hifiep_setup_circular(fir);
+	for (i = 0; i < samples; i++)
+		fir_32x16_hifiep(fir, in[i * stride], &out[i * stride], lshift, rshift);
+#elif FIR_HIFI3
+	fir_core_setup_circular(fir);
+	for (i = 0; i < samples; i++)
+		fir_32x16_hifi3(fir, in[i * stride], (ae_int32 *)&out[i * stride],
+				lshift - rshift);
+#else
+	for (i = 0; i < samples; i++)
+		out[i * stride] = fir_32x16(fir, in[i * stride]);
+#endif
+}
+#endif /* CONFIG_MATH_FIR */
+
+#if CONFIG_MATH_IIR_DF2T
+static size_t dsp_service_iir_state_size(void)
+{
+	return sizeof(struct iir_state_df2t);
+}
+
+static int dsp_service_iir_init(struct iir_state_df2t *iir, struct sof_eq_iir_header *config,
+				int64_t *delay)
+{
+	int ret;
+
+	ret = iir_init_coef_df2t(iir, config);
+	if (ret < 0)
+		return ret;
+
+	iir_init_delay_df2t(iir, &delay);
+	return 0;
+}
+
+static void dsp_service_iir_process(struct iir_state_df2t *iir, const int32_t *in,
+				    int32_t *out, uint32_t samples, uint32_t stride)
+{
+	uint32_t i;
+
+	for (i = 0; i < samples; i++)
+		out[i * stride] = iir_df2t(iir, in[i * stride]);
+}
+#endif /* CONFIG_MATH_IIR_DF2T */
+
+#if CONFIG_MATH_FFT && CONFIG_MATH_32BIT_FFT
+static struct fft_plan *dsp_service_fft_plan_new(void *inb, void *outb, uint32_t size)
+{
+	return fft_plan_new(inb, outb, size, 32);
+}
+#endif
+
+static void dsp_service_convert_s16_to_s32(const int16_t *in, int32_t *out, uint32_t samples)
+{
+	uint32_t i;
+
+	for (i = 0; i < samples; i++)
+		out[i] = (int32_t)in[i] << 16;
+}
+
+static void dsp_service_convert_s32_to_s16(const int32_t *in, int16_t *out, uint32_t samples)
+{
+	uint32_t i;
+
+	for (i = 0; i < samples; i++)
+		out[i] = sat_int16(Q_SHIFT_RND(in[i], 31, 15));
+}
+
+static void dsp_service_convert_s24_to_s32(const int32_t *in, int32_t *out, uint32_t samples)
+{
+	uint32_t i;
+
+	for (i = 0; i < samples; i++)
+		out[i] = (uint32_t)in[i] << 8;
+}
+
+static void dsp_service_convert_s32_to_s24(const int32_t *in, int32_t *out, uint32_t samples)
+{
+	uint32_t i;
+
+	for (i = 0; i < samples; i++)
+		out[i] = sat_int24(Q_SHIFT_RND(in[i], 31, 23));
+}
+
+const dsp_service_iface native_dsp_service = {
+	.version = DSP_SERVICE_VERSION,
+	.size = sizeof(dsp_service_iface),
+
+	.source_get_data_available = source_get_data_available,
+	.source_get_frame_bytes = source_get_frame_bytes,
+	.source_get_data = source_get_data,
+	.source_release_data = source_release_data,
+	.sink_get_free_size = sink_get_free_size,
+	.sink_get_frame_bytes = sink_get_frame_bytes,
+	.sink_get_buffer = sink_get_buffer,
+	.sink_commit_buffer = sink_commit_buffer,
+
+#if CONFIG_MATH_FIR
+	.fir_state_size = dsp_service_fir_state_size,
+	.fir_delay_size = fir_delay_size,
+	.fir_init = dsp_service_fir_init,
+	.fir_reset = fir_reset,
+	.fir_process = dsp_service_fir_process,
+#endif
+
+#if CONFIG_MATH_IIR_DF2T
+	.iir_state_size = dsp_service_iir_state_size,
+	.iir_delay_size = iir_delay_size_df2t,
+	.iir_init = dsp_service_iir_init,
+	.iir_reset = iir_reset_df2t,
+	.iir_process = dsp_service_iir_process,
+#endif
+
+#if CONFIG_MATH_FFT && CONFIG_MATH_32BIT_FFT
+	.fft_plan_new = dsp_service_fft_plan_new,
+	.fft_execute = fft_execute_32,
+	.fft_plan_free = fft_plan_free,
+#endif
+
+	.convert_s16_to_s32 = dsp_service_convert_s16_to_s32,
+	.convert_s32_to_s16 = dsp_service_convert_s32_to_s16,
+	.convert_s24_to_s32 = dsp_service_convert_s24_to_s32,
+	.convert_s32_to_s24 = dsp_service_convert_s32_to_s24,
+};
@@ -17,9 +17,16 @@
 #include <sof/ipc/msg.h>
 #include <native_system_service.h>
 #include <sof/lib_manager.h>
+#if CONFIG_SOF_TELEMETRY
+#include <sof/debug/telemetry/telemetry.h>
+#endif
 
 #define RSIZE_MAX 0x7FFFFFFF
 
+#if CONFIG_INTEL_MODULES_DSP_SERVICE
+extern const dsp_service_iface native_dsp_service;
+#endif
+
 void native_system_service_log_message(AdspLogPriority log_priority, uint32_t log_entry,
 				       AdspLogHandle const *log_handle, uint32_t param1,
 				       uint32_t param2, uint32_t param3, uint32_t param4)
@@ -121,10 +128,53 @@ AdspErrorCode native_system_service_send_notif_msg(adsp_notification_target noti
 	return ADSP_NO_ERROR;
 }
 
+#if CONFIG_SOF_TELEMETRY
+static AdspErrorCode native_system_service_telemetry_post(uint32_t type, uint32_t resource_id,
+							  const void *data, uint32_t size)
+{
+	int ret = telemetry_post(type, resource_id, data, size);
+
+	switch (ret) {
+	case 0:
+		return ADSP_NO_ERROR;
+	case -ENOSPC:
+		return ADSP_BUSY_RESOURCE;
+	case -ENODEV:
+		return ADSP_SERVICE_UNAVAILABLE;
+	default:
+		return ADSP_INVALID_PARAMETERS;
+	}
+}
+
+static const telemetry_service_iface native_system_service_telemetry = {
+	.post = native_system_service_telemetry_post,
+};
+#endif
+
 AdspErrorCode native_system_service_get_interface(adsp_iface_id id, system_service_iface  **iface)
 {
 	if (id < 0)
 		return ADSP_INVALID_PARAMETERS;
+
+	switch (id) {
+#if CONFIG_SOF_TELEMETRY
+	case INTERFACE_ID_TELEMETRY_SERVICE:
+		if (!iface)
+			return ADSP_INVALID_PARAMETERS;
+		*iface = (system_service_iface *)&native_system_service_telemetry;
+		break;
+#endif
+#if CONFIG_INTEL_MODULES_DSP_SERVICE
+	case INTERFACE_ID_DSP_SERVICE:
+		if (!iface)
+			return ADSP_INVALID_PARAMETERS;
+		*iface = (system_service_iface *)&native_dsp_service;
+		break;
+#endif
+	default:
+		break;
+	}
+
 	return ADSP_NO_ERROR;
 }
 
@@ -710,6 +710,142 @@ free:
 	return ret;
 }
 
+#if CONFIG_CADENCE_CODEC_DECODE_AHEAD
+/* copy one module input buffer of compressed data from the source, release it after decoding */
+static int cadence_codec_fill_input(struct processing_module *mod, struct sof_source *source)
+{
+	struct module_data *codec = &mod->priv;
+	uint8_t *in_buff = codec->mpd.in_buff;
+	void const *data_ptr;
+	void const *buf_start;
+	size_t buf_size;
+	int ret;
+
+	ret = source_get_data(source, codec->mpd.in_buff_size, &data_ptr, &buf_start, &buf_size);
+	if (ret)
+		return ret;
+
+	cir_buf_copy((void *)data_ptr, (void *)buf_start, (uint8_t *)buf_start + buf_size,
+		     in_buff, in_buff, in_buff + codec->mpd.in_buff_size, codec->mpd.in_buff_size);
+	codec->mpd.avail = codec->mpd.in_buff_size;
+
+	return 0;
+}
+
+/* decode one frame from the module input buffer and write it to the sink */
+static int cadence_codec_decode_frame(struct processing_module *mod, struct sof_sink *sink)
+{
+	struct comp_dev *dev = mod->dev;
+	struct module_data *codec = &mod->priv;
+	struct cadence_codec_data *cd = codec->private;
+	uint8_t *out_buff = codec->mpd.out_buff;
+	void *data_ptr;
+	void *buf_start;
+	size_t buf_size;
+	int ret;
+
+	API_CALL(cd, XA_API_CMD_SET_INPUT_BYTES, 0, &codec->mpd.avail, ret);
+	if (ret != LIB_NO_ERROR) {
+		comp_err(dev, "cadence_codec_decode_frame() error %x: failed to set size of input data",
+			 ret);
+		return ret;
+	}
+
+	API_CALL(cd, XA_API_CMD_EXECUTE, XA_CMD_TYPE_DO_EXECUTE, NULL, ret);
+	if (ret != LIB_NO_ERROR) {
+		if (LIB_IS_FATAL_ERROR(ret)) {
+			comp_err(dev, "cadence_codec_decode_frame() error %x: processing failed",
+				 ret);
+			return ret;
+		}
+		comp_warn(dev, "cadence_codec_decode_frame() nonfatal error %x", ret);
+	}
+
+	API_CALL(cd, XA_API_CMD_GET_OUTPUT_BYTES, 0, &codec->mpd.produced, ret);
+	if (ret != LIB_NO_ERROR) {
+		comp_err(dev, "cadence_codec_decode_frame() error %x: could not get produced bytes",
+			 ret);
+		return ret;
+	}
+
+	API_CALL(cd, XA_API_CMD_GET_CURIDX_INPUT_BUF, 0, &codec->mpd.consumed, ret);
+	if (ret != LIB_NO_ERROR) {
+		comp_err(dev, "cadence_codec_decode_frame() error %x: could not get consumed bytes",
+			 ret);
+		return ret;
+	}
+
+	if (!codec->mpd.produced)
+		return 0;
+
+	ret = sink_get_buffer(sink, codec->mpd.produced, &data_ptr, &buf_start, &buf_size);
+	if (ret) {
+		comp_err(dev, "cadence_codec_decode_frame(): no space for %u produced bytes",
+			 codec->mpd.produced);
+		return ret;
+	}
+
+	cir_buf_copy(out_buff, out_buff, out_buff + codec->mpd.out_buff_size, data_ptr,
+		     buf_start, (uint8_t *)buf_start + buf_size, codec->mpd.produced);
+
+	return sink_commit_buffer(sink, codec->mpd.produced);
+}
+
+/*
+ * In the DP domain the codec decodes ahead as long as compressed data is available and
+ * the sink, a DP queue sized by the module OBS, has space for a frame. The LL side pulls
+ * PCM from the queue every period while the host DMA refills the compressed input in
+ * large bursts, so no decoder work is left between the bursts. In the LL domain one
+ * frame is decoded per period, like the raw data processing does.
+ */
+static int
+cadence_codec_process(struct processing_module *mod,
+		      struct sof_source **sources, int num_of_sources,
+		      struct sof_sink **sinks, int num_of_sinks)
+{
+	struct comp_dev *dev = mod->dev;
+	struct module_data *codec = &mod->priv;
+	struct sof_source *source = sources[0];
+	struct sof_sink *sink = sinks[0];
+	bool decode_ahead = dev->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_DP;
+	size_t output_bytes = cadence_codec_get_samples(mod) * sink_get_frame_bytes(sink);
+	int frames = 0;
+	int ret;
+
+	if (!codec->mpd.init_done) {
+		ret = cadence_codec_fill_input(mod, source);
+		if (ret) {
+			comp_dbg(dev, "cadence_codec_process(): not enough data to init");
+			return ret;
+		}
+
+		ret = cadence_codec_init_process(mod);
+		source_release_data(source, ret ? 0 : codec->mpd.consumed);
+		if (ret)
+			return ret;
+	}
+
+	do {
+		if (sink_get_free_size(sink) < output_bytes)
+			return frames ? 0 : -ENOSPC;
+
+		ret = cadence_codec_fill_input(mod, source);
+		if (ret)
+			return frames ? 0 : ret;
+
+		ret = cadence_codec_decode_frame(mod, sink);
+		source_release_data(source, ret ? 0 : codec->mpd.consumed);
+		if (ret)
+			return ret;
+
+		frames++;
+	} while (decode_ahead && codec->mpd.consumed);
+
+	comp_dbg(dev, "cadence_codec_process() decoded %d frames", frames);
+
+	return 0;
+}
+#else
 static int
 cadence_codec_process(struct processing_module *mod,
 		      struct input_stream_buffer *input_buffers, int num_input_buffers,
@@ -805,6 +941,7 @@ cadence_codec_process(struct processing_module *mod,
 
 	return 0;
 }
+#endif /* CONFIG_CADENCE_CODEC_DECODE_AHEAD */
 
 static int cadence_codec_reset(struct processing_module *mod)
 {
@@ -879,7 +1016,11 @@ cadence_codec_set_configuration(struct processing_module *mod, uint32_t config_i
 static const struct module_interface cadence_interface = {
 	.init = cadence_codec_init,
 	.prepare = cadence_codec_prepare,
+#if CONFIG_CADENCE_CODEC_DECODE_AHEAD
+	.process = cadence_codec_process,
+#else
 	.process_raw_data = cadence_codec_process,
+#endif
 	.set_configuration = cadence_codec_set_configuration,
 	.reset = cadence_codec_reset,
 	.free = cadence_codec_free
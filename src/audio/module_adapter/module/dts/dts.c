@@ -128,7 +128,8 @@ static int dts_effect_populate_buffer_configuration(struct comp_dev *dev,
 	buffer_config->bufferFormat = buffer_format;
 	buffer_config->sampleRate = rate;
 	buffer_config->numChannels = channels;
-	buffer_config->periodInFrames = dev->frames;
+	buffer_config->periodInFrames = CONFIG_DTS_CODEC_BLOCK_FRAMES ?
+		CONFIG_DTS_CODEC_BLOCK_FRAMES : dev->frames;
 
 	comp_dbg(dev, "dts_effect_populate_buffer_configuration() done");
 
@@ -192,6 +193,12 @@ static int dts_codec_prepare(struct processing_module *mod,
 
 	comp_dbg(dev, "dts_codec_prepare() start");
 
+	if (num_of_sources != 1 || num_of_sinks != 1) {
+		comp_err(dev, "dts_codec_prepare() %d sources, %d sinks not supported",
+			 num_of_sources, num_of_sinks);
+		return -EINVAL;
+	}
+
 	ret = dts_effect_populate_buffer_configuration(dev, &buffer_configuration);
 	if (ret) {
 		comp_err(dev,
@@ -211,6 +218,11 @@ static int dts_codec_prepare(struct processing_module *mod,
 
 	if (ret)
 		comp_err(dev, "dts_codec_prepare() failed %d", ret);
+	else if (dev->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_DP) {
+		/* a DP instance is woken up for whole blocks */
+		source_set_min_available(sources[0], codec->mpd.in_buff_size);
+		sink_set_min_free_space(sinks[0], codec->mpd.out_buff_size);
+	}
 
 	comp_dbg(dev, "dts_codec_prepare() done");
 
@@ -241,10 +253,68 @@ static int dts_codec_init_process(struct processing_module *mod)
 	return ret;
 }
 
-static int
-dts_codec_process(struct processing_module *mod,
-		  struct input_stream_buffer *input_buffers, int num_input_buffers,
-		  struct output_stream_buffer *output_buffers, int num_output_buffers)
+static bool dts_codec_is_ready_to_process(struct processing_module *mod,
+					  struct sof_source **sources, int num_of_sources,
+					  struct sof_sink **sinks, int num_of_sinks)
+{
+	struct module_data *codec = &mod->priv;
+
+	return source_get_data_available(sources[0]) >= codec->mpd.in_buff_size &&
+		sink_get_free_size(sinks[0]) >= codec->mpd.out_buff_size;
+}
+
+/* the library only processes its own buffers, copy both ends of a wrapping block */
+static int dts_codec_fill_input(struct processing_module *mod, struct sof_source *source)
+{
+	struct module_data *codec = &mod->priv;
+	size_t bytes = codec->mpd.in_buff_size;
+	const uint8_t *buf_start;
+	const uint8_t *ptr;
+	size_t buf_size;
+	size_t head;
+	int ret;
+
+	/* released once the library reported what it consumed */
+	ret = source_get_data(source, bytes, (const void **)&ptr,
+			      (const void **)&buf_start, &buf_size);
+	if (ret)
+		return ret;
+
+	head = MIN(bytes, (size_t)(buf_start + buf_size - ptr));
+	memcpy_s(codec->mpd.in_buff, bytes, ptr, head);
+	if (head < bytes)
+		memcpy_s((uint8_t *)codec->mpd.in_buff + head, bytes - head, buf_start,
+			 bytes - head);
+
+	return 0;
+}
+
+static int dts_codec_drain_output(struct processing_module *mod, struct sof_sink *sink)
+{
+	struct module_data *codec = &mod->priv;
+	const uint8_t *src = codec->mpd.out_buff;
+	size_t bytes = codec->mpd.produced;
+	size_t size;
+	void *ptr;
+	int ret;
+
+	while (bytes) {
+		ret = sink_get_buffer_linear(sink, bytes, &ptr, &size);
+		if (ret)
+			return ret;
+
+		memcpy_s(ptr, size, src, size);
+		sink_commit_buffer(sink, size);
+		src += size;
+		bytes -= size;
+	}
+
+	return 0;
+}
+
+static int dts_codec_process(struct processing_module *mod,
+			     struct sof_source **sources, int num_of_sources,
+			     struct sof_sink **sinks, int num_of_sinks)
 {
 	int ret;
 	struct comp_dev *dev = mod->dev;
@@ -253,9 +323,9 @@ dts_codec_process(struct processing_module *mod,
 	unsigned int bytes_processed = 0;
 
 	/* Proceed only if we have enough data to fill the module buffer completely */
-	if (input_buffers[0].size < codec->mpd.in_buff_size) {
+	if (!dts_codec_is_ready_to_process(mod, sources, num_of_sources, sinks, num_of_sinks)) {
 		comp_dbg(dev, "dts_codec_process(): not enough data to process");
-		return -ENODATA;
+		return 0;
 	}
 
 	if (!codec->mpd.init_done) {
@@ -264,8 +334,9 @@ dts_codec_process(struct processing_module *mod,
 			return ret;
 	}
 
-	memcpy_s(codec->mpd.in_buff, codec->mpd.in_buff_size,
-		 input_buffers[0].data, codec->mpd.in_buff_size);
+	ret = dts_codec_fill_input(mod, sources[0]);
+	if (ret)
+		return ret;
 	codec->mpd.avail = codec->mpd.in_buff_size;
 
 	comp_dbg(dev, "dts_codec_process() start");
@@ -275,7 +346,7 @@ dts_codec_process(struct processing_module *mod,
 
 	codec->mpd.consumed = !ret ? bytes_processed : 0;
 	codec->mpd.produced = !ret ? bytes_processed : 0;
-	input_buffers[0].consumed = codec->mpd.consumed;
+	source_release_data(sources[0], codec->mpd.consumed);
 
 	if (ret) {
 		comp_err(dev, "dts_codec_process() failed %d %d", ret, dts_result);
@@ -283,9 +354,7 @@ dts_codec_process(struct processing_module *mod,
 	}
 
 	/* copy the produced samples into the output buffer */
-	memcpy_s(output_buffers[0].data, codec->mpd.produced, codec->mpd.out_buff,
-		 codec->mpd.produced);
-	output_buffers[0].size = codec->mpd.produced;
+	ret = dts_codec_drain_output(mod, sinks[0]);
 
 	comp_dbg(dev, "dts_codec_process() done");
 
@@ -463,7 +532,8 @@ dts_codec_set_configuration(struct processing_module *mod, uint32_t config_id,
 static const struct module_interface dts_interface = {
 	.init = dts_codec_init,
 	.prepare = dts_codec_prepare,
-	.process_raw_data = dts_codec_process,
+	.process = dts_codec_process,
+	.is_ready_to_process = dts_codec_is_ready_to_process,
 	.set_configuration = dts_codec_set_configuration,
 	.reset = dts_codec_reset,
 	.free = dts_codec_free
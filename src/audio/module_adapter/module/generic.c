@@ -12,6 +12,8 @@
  */
 
 #include <sof/audio/module_adapter/module/generic.h>
+#include <sof/audio/pipeline.h>
+#include <sof/ipc/topology.h>
 
 LOG_MODULE_DECLARE(module_adapter, CONFIG_SOF_LOG_LEVEL);
 
@@ -75,6 +77,26 @@ err:
 	return ret;
 }
 
+/* takes the assembled config, the previous one stays in use if it is not valid */
+static int module_take_config(struct comp_dev *dev, void *cfg, size_t size)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct module_data *md = &mod->priv;
+
+	if (validate_config(cfg)) {
+		comp_err(dev, "module_take_config(): validation of config failed!");
+		rfree(cfg);
+		return -EINVAL;
+	}
+
+	rfree(md->cfg.data);
+	md->cfg.data = cfg;
+	md->cfg.size = size;
+	md->cfg.avail = true;
+
+	return 0;
+}
+
 int module_init(struct processing_module *mod, const struct module_interface *interface)
 {
 	int ret;
@@ -126,10 +148,37 @@ int module_init(struct processing_module *mod, const struct module_interface *in
 	return 0;
 }
 
+/* Account module memory to the pipeline for usage and peak tracking */
+static void module_account_memory(struct processing_module *mod, uint32_t size, bool alloc)
+{
+	struct ipc_comp_dev *ipc_pipe;
+	struct pipeline *p = mod->dev->pipeline;
+
+	/*
+	 * Set once the pipeline is complete. The id may since have been taken
+	 * by a new pipeline if the module is freed in the background.
+	 */
+	if (!p) {
+		ipc_pipe = ipc_get_pipeline_by_id(ipc_get(), mod->dev->ipc_config.pipeline_id);
+		if (!ipc_pipe)
+			return;
+
+		p = ipc_pipe->pipeline;
+	}
+
+	if (alloc) {
+		p->mem_usage += size;
+		p->mem_peak = MAX(p->mem_peak, p->mem_usage);
+	} else {
+		p->mem_usage -= MIN(size, p->mem_usage);
+	}
+}
+
 void *module_allocate_memory(struct processing_module *mod, uint32_t size, uint32_t alignment)
 {
 	struct comp_dev *dev = mod->dev;
 	struct module_memory *container;
+	uint32_t flags;
 	void *ptr;
 
 	if (!size) {
@@ -145,20 +194,27 @@ void *module_allocate_memory(struct processing_module *mod, uint32_t size, uint3
 		return NULL;
 	}
 
-	/* Allocate memory for module */
+	/* Allocate memory for module, in the memory of its core as the module
+	 * itself unless it is a DP module
+	 */
+	flags = dev->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_DP ?
+		0 : SOF_MEM_FLAG_CORE_LOCAL;
 	if (alignment)
-		ptr = rballoc_align(0, SOF_MEM_CAPS_RAM, size, alignment);
+		ptr = rballoc_align(flags, SOF_MEM_CAPS_RAM, size, alignment);
 	else
-		ptr = rballoc(0, SOF_MEM_CAPS_RAM, size);
+		ptr = rballoc(flags, SOF_MEM_CAPS_RAM, size);
 
 	if (!ptr) {
 		comp_err(dev, "module_allocate_memory: failed to allocate memory for comp %x.",
 			 dev_comp_id(dev));
+		rfree(container);
 		return NULL;
 	}
 	/* Store reference to allocated memory */
 	container->ptr = ptr;
+	container->size = size;
 	list_item_prepend(&container->mem_list, &mod->priv.memory.mem_list);
+	module_account_memory(mod, size, true);
 
 	return ptr;
 }
@@ -176,6 +232,7 @@ int module_free_memory(struct processing_module *mod, void *ptr)
 	list_for_item_safe(mem_list, _mem_list, &mod->priv.memory.mem_list) {
 		mem = container_of(mem_list, struct module_memory, mem_list);
 		if (mem->ptr == ptr) {
+			module_account_memory(mod, mem->size, false);
 			rfree(mem->ptr);
 			list_item_del(&mem->mem_list);
 			rfree(mem);
@@ -189,6 +246,86 @@ int module_free_memory(struct processing_module *mod, void *ptr)
 	return -EINVAL;
 }
 
+#if CONFIG_MODULE_SCRATCH_ARENA
+/* one per core, each in its own cache line as it is accessed by its core only */
+struct module_scratch_arena {
+	void *ptr;
+	size_t size;
+	uint32_t users;
+} __aligned(PLATFORM_DCACHE_ALIGN);
+
+static struct module_scratch_arena scratch_arena[CONFIG_CORE_COUNT];
+
+int module_scratch_request(struct processing_module *mod, size_t size)
+{
+	struct comp_dev *dev = mod->dev;
+	struct module_scratch_arena *arena = &scratch_arena[dev->ipc_config.core];
+	void *ptr;
+
+	if (!size)
+		return -EINVAL;
+
+	/* DP modules may preempt each other in the middle of processing */
+	if (dev->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_DP) {
+		comp_err(dev, "module_scratch_request(): not available for DP modules");
+		return -EINVAL;
+	}
+
+	/* a repeated request replaces the previous one */
+	module_scratch_release(mod);
+
+	size = ALIGN_UP(size, PLATFORM_DCACHE_ALIGN);
+	if (size > arena->size) {
+		ptr = rballoc_align(0, SOF_MEM_CAPS_RAM, size, PLATFORM_DCACHE_ALIGN);
+		if (!ptr) {
+			comp_err(dev, "module_scratch_request(): failed to allocate %u bytes",
+				 size);
+			return -ENOMEM;
+		}
+
+		/*
+		 * Called from prepare() in IPC context, which cannot preempt LL processing
+		 * on this core, so the previous block is not in use.
+		 */
+		rfree(arena->ptr);
+		arena->ptr = ptr;
+		arena->size = size;
+	}
+
+	arena->users++;
+	mod->scratch_size = size;
+
+	comp_dbg(dev, "module_scratch_request(): %u bytes, arena %u bytes, %u users",
+		 size, arena->size, arena->users);
+
+	return 0;
+}
+
+void *module_scratch_get(struct processing_module *mod)
+{
+	if (!mod->scratch_size)
+		return NULL;
+
+	return scratch_arena[mod->dev->ipc_config.core].ptr;
+}
+
+void module_scratch_release(struct processing_module *mod)
+{
+	struct module_scratch_arena *arena = &scratch_arena[mod->dev->ipc_config.core];
+
+	if (!mod->scratch_size)
+		return;
+
+	mod->scratch_size = 0;
+	if (--arena->users)
+		return;
+
+	rfree(arena->ptr);
+	arena->ptr = NULL;
+	arena->size = 0;
+}
+#endif /* CONFIG_MODULE_SCRATCH_ARENA */
+
 static int validate_config(struct module_config *cfg)
 {
 	/* TODO: validation of codec specific setup config */
@@ -346,6 +483,10 @@ int module_reset(struct processing_module *mod)
 	rfree(md->cfg.data);
 	md->cfg.data = NULL;
 
+#if CONFIG_MODULE_SCRATCH_ARENA
+	module_scratch_release(mod);
+#endif
+
 #if CONFIG_IPC_MAJOR_3
 	/*
 	 * reset the state to allow the module's prepare callback to be invoked again for the
@@ -365,6 +506,7 @@ void module_free_all_memory(struct processing_module *mod)
 	/* Find which container keeps this memory */
 	list_for_item_safe(mem_list, _mem_list, &mod->priv.memory.mem_list) {
 		mem = container_of(mem_list, struct module_memory, mem_list);
+		module_account_memory(mod, mem->size, false);
 		rfree(mem->ptr);
 		list_item_del(&mem->mem_list);
 		rfree(mem);
@@ -390,6 +532,9 @@ int module_free(struct processing_module *mod)
 		rfree(md->runtime_params);
 		md->runtime_params = NULL;
 	}
+#if CONFIG_MODULE_SCRATCH_ARENA
+	module_scratch_release(mod);
+#endif
 #if CONFIG_IPC_MAJOR_3
 	md->state = MODULE_DISABLED;
 #endif
@@ -486,17 +631,14 @@ int module_set_configuration(struct processing_module *mod,
 	if (pos == MODULE_CFG_FRAGMENT_MIDDLE || pos == MODULE_CFG_FRAGMENT_FIRST)
 		return 0;
 
-	/* config fully copied, now load it */
-	ret = module_load_config(dev, md->runtime_params, md->new_cfg_size);
+	/* config fully copied, the assembly buffer becomes the config */
+	ret = module_take_config(dev, md->runtime_params, md->new_cfg_size);
 	if (ret)
 		comp_err(dev, "module_set_configuration(): error %d: config failed", ret);
 	else
 		comp_dbg(dev, "module_set_configuration(): config load successful");
 
 	md->new_cfg_size = 0;
-
-	if (md->runtime_params)
-		rfree(md->runtime_params);
 	md->runtime_params = NULL;
 
 	return ret;
@@ -189,6 +189,30 @@ static int modules_init_process(struct processing_module *mod)
 	return 0;
 }
 
+#if CONFIG_INTEL_MODULES_BATCH
+/*
+ * A module with an IBS of several periods gets whole IBS blocks only. The input
+ * is left in the source buffers until a block is complete, so the module runs
+ * once per block instead of once per period.
+ */
+static bool modules_block_complete(struct processing_module *mod,
+				   const struct input_stream_buffer *input_buffers,
+				   int num_input_buffers)
+{
+	struct module_data *md = &mod->priv;
+	int i;
+
+	if (md->mpd.in_buff_size < 2 * mod->period_bytes)
+		return true;
+
+	for (i = 0; i < num_input_buffers; i++)
+		if (input_buffers[i].size < md->mpd.in_buff_size)
+			return false;
+
+	return true;
+}
+#endif
+
 /*
  * \brief modules_process.
  * \param[in] mod - processing module pointer.
@@ -211,6 +235,16 @@ static int modules_process(struct processing_module *mod,
 	if (!md->mpd.init_done)
 		modules_init_process(mod);
 
+#if CONFIG_INTEL_MODULES_BATCH
+	if (!modules_block_complete(mod, input_buffers, num_input_buffers)) {
+		for (i = 0; i < num_input_buffers; i++)
+			input_buffers[i].consumed = 0;
+		for (i = 0; i < num_output_buffers; i++)
+			output_buffers[i].size = 0;
+		return -ENODATA;
+	}
+#endif
+
 	/* IADK modules require output buffer size to set to its real size. */
 	list_for_item(blist, &dev->bsource_list) {
 		mod->output_buffers[i].size = md->mpd.out_buff_size;
@@ -78,6 +78,16 @@ passthrough_codec_process(struct processing_module *mod,
 	if (!codec->mpd.init_done)
 		passthrough_codec_init_process(mod);
 
+	codec->mpd.produced = mod->period_bytes;
+	codec->mpd.consumed = mod->period_bytes;
+	input_buffers[0].consumed = codec->mpd.consumed;
+
+	/* processing in place, the samples are already where module adapter expects them */
+	if (output_buffers[0].data == input_buffers[0].data) {
+		output_buffers[0].size = codec->mpd.produced;
+		return 0;
+	}
+
 	memcpy_s(codec->mpd.in_buff, codec->mpd.in_buff_size,
 		 input_buffers[0].data, codec->mpd.in_buff_size);
 
@@ -85,9 +95,6 @@ passthrough_codec_process(struct processing_module *mod,
 
 	memcpy_s(codec->mpd.out_buff, codec->mpd.out_buff_size,
 		 codec->mpd.in_buff, codec->mpd.in_buff_size);
-	codec->mpd.produced = mod->period_bytes;
-	codec->mpd.consumed = mod->period_bytes;
-	input_buffers[0].consumed = codec->mpd.consumed;
 
 	/* copy the produced samples into the output buffer */
 	memcpy_s(output_buffers[0].data, codec->mpd.produced, codec->mpd.out_buff,
@@ -121,7 +128,8 @@ static const struct module_interface passthrough_interface = {
 	.prepare = passthrough_codec_prepare,
 	.process_raw_data = passthrough_codec_process,
 	.reset = passthrough_codec_reset,
-	.free = passthrough_codec_free
+	.free = passthrough_codec_free,
+	.in_place = true,
 };
 
 DECLARE_MODULE_ADAPTER(passthrough_interface, passthrough_uuid, passthrough_tr);
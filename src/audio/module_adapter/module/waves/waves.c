@@ -38,6 +38,9 @@ struct waves_codec_data {
 	MaxxStream_t            o_stream;
 	MaxxBuffer_t            i_buffer;
 	MaxxBuffer_t            o_buffer;
+	void                    *i_copy; /* staging for blocks wrapping in the buffers */
+	void                    *o_copy;
+	bool                    scratch; /* staging taken from the scratch arena */
 	uint32_t                response_max_bytes;
 	uint32_t                request_max_bytes;
 	void                    *response;
@@ -331,11 +334,14 @@ static int waves_effect_init(struct processing_module *mod)
 	waves_codec->o_format = waves_codec->i_format;
 
 	waves_codec->sample_size_in_bytes = sample_bytes;
-	/* Prepare a buffer for 1 period worth of data
+	/* Process blocks of 1 period worth of data unless configured otherwise
 	 * dev->pipeline->period stands for the scheduling period in us
 	 */
-	waves_codec->buffer_samples = audio_stream_get_rate(src_fmt) * dev->pipeline->period /
-		1000000;
+	if (CONFIG_WAVES_CODEC_BLOCK_FRAMES)
+		waves_codec->buffer_samples = CONFIG_WAVES_CODEC_BLOCK_FRAMES;
+	else
+		waves_codec->buffer_samples = audio_stream_get_rate(src_fmt) *
+			dev->pipeline->period / 1000000;
 	waves_codec->buffer_bytes = waves_codec->buffer_samples *
 		audio_stream_get_channels(src_fmt) * waves_codec->sample_size_in_bytes;
 
@@ -359,51 +365,66 @@ static int waves_effect_init(struct processing_module *mod)
 	return 0;
 }
 
-/* allocate additional buffers for MaxxEffect */
-static int waves_effect_buffers(struct processing_module *mod)
+/* allocate staging buffers for blocks which wrap in the source or the sink, blocks
+ * which don't are passed to MaxxEffect in place
+ */
+static int waves_effect_buffers(struct processing_module *mod,
+				struct sof_source *source, struct sof_sink *sink)
 {
 	struct comp_dev *dev = mod->dev;
 	struct module_data *codec = &mod->priv;
 	struct waves_codec_data *waves_codec = codec->private;
 	int ret;
-	void *i_buffer = NULL, *o_buffer = NULL;
+	void *i_copy = NULL, *o_copy = NULL;
 
 	comp_dbg(dev, "waves_effect_buffers() start");
 
-	i_buffer = module_allocate_memory(mod, waves_codec->buffer_bytes, 16);
-	if (!i_buffer) {
+	if (dev->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_DP) {
+		/* a DP instance is woken up for whole blocks */
+		source_set_min_available(source, waves_codec->buffer_bytes);
+		sink_set_min_free_space(sink, waves_codec->buffer_bytes);
+	}
+#if CONFIG_MODULE_SCRATCH_ARENA
+	else {
+		/* LL instances of the core share the staging memory */
+		ret = module_scratch_request(mod, 2 * waves_codec->buffer_bytes);
+		if (ret)
+			return ret;
+
+		waves_codec->scratch = true;
+		comp_dbg(dev, "waves_effect_buffers() %d bytes of scratch",
+			 2 * waves_codec->buffer_bytes);
+		return 0;
+	}
+#endif
+
+	i_copy = module_allocate_memory(mod, waves_codec->buffer_bytes, 16);
+	if (!i_copy) {
 		comp_err(dev, "waves_effect_buffers() failed to allocate %d bytes for i_buffer",
 			 waves_codec->buffer_bytes);
 		ret = -ENOMEM;
 		goto err;
 	}
 
-	o_buffer = module_allocate_memory(mod, waves_codec->buffer_bytes, 16);
-	if (!o_buffer) {
+	o_copy = module_allocate_memory(mod, waves_codec->buffer_bytes, 16);
+	if (!o_copy) {
 		comp_err(dev, "waves_effect_buffers() failed to allocate %d bytes for o_buffer",
 			 waves_codec->buffer_bytes);
 		ret = -ENOMEM;
 		goto err;
 	}
 
-	waves_codec->i_buffer = i_buffer;
-	waves_codec->o_buffer = o_buffer;
-	codec->mpd.in_buff = waves_codec->i_buffer;
-	codec->mpd.in_buff_size = waves_codec->buffer_bytes;
-	codec->mpd.out_buff = waves_codec->o_buffer;
-	codec->mpd.out_buff_size = waves_codec->buffer_bytes;
-
-	comp_dbg(dev, "waves_effect_buffers() in_buff_size %d, out_buff_size %d",
-		  codec->mpd.in_buff_size, codec->mpd.out_buff_size);
+	waves_codec->i_copy = i_copy;
+	waves_codec->o_copy = o_copy;
 
 	comp_dbg(dev, "waves_effect_buffers() done");
 	return 0;
 
 err:
-	if (i_buffer)
-		module_free_memory(mod, i_buffer);
-	if (o_buffer)
-		module_free_memory(mod, o_buffer);
+	if (i_copy)
+		module_free_memory(mod, i_copy);
+	if (o_copy)
+		module_free_memory(mod, o_copy);
 	return ret;
 }
 
@@ -668,13 +689,19 @@ static int waves_codec_prepare(struct processing_module *mod,
 
 	comp_dbg(dev, "waves_codec_prepare() start");
 
+	if (num_of_sources != 1 || num_of_sinks != 1) {
+		comp_err(dev, "waves_codec_prepare() %d sources, %d sinks not supported",
+			 num_of_sources, num_of_sinks);
+		return -EINVAL;
+	}
+
 	ret = waves_effect_check(dev);
 
 	if (!ret)
 		ret = waves_effect_init(mod);
 
 	if (!ret)
-		ret = waves_effect_buffers(mod);
+		ret = waves_effect_buffers(mod, sources[0], sinks[0]);
 
 	if (!ret)
 		ret = waves_effect_setup_config(mod);
@@ -700,49 +727,135 @@ static int waves_codec_init_process(struct processing_module *mod)
 	return 0;
 }
 
-static int
-waves_codec_process(struct processing_module *mod,
-		    struct input_stream_buffer *input_buffers, int num_input_buffers,
-		    struct output_stream_buffer *output_buffers, int num_output_buffers)
+static bool waves_codec_is_ready_to_process(struct processing_module *mod,
+					    struct sof_source **sources, int num_of_sources,
+					    struct sof_sink **sinks, int num_of_sinks)
+{
+	struct waves_codec_data *waves_codec = mod->priv.private;
+
+	return source_get_data_available(sources[0]) >= waves_codec->buffer_bytes &&
+		sink_get_free_size(sinks[0]) >= waves_codec->buffer_bytes;
+}
+
+/* get one input block, in place unless it wraps in the source */
+static int waves_codec_get_input(struct processing_module *mod, struct sof_source *source,
+				 void *i_copy)
+{
+	struct waves_codec_data *waves_codec = mod->priv.private;
+	size_t bytes = waves_codec->buffer_bytes;
+	const uint8_t *buf_start;
+	const uint8_t *ptr;
+	size_t buf_size;
+	size_t head;
+	int ret;
+
+	ret = source_get_data_linear(source, bytes, (const void **)&ptr, &head);
+	if (ret)
+		return ret;
+
+	if (head == bytes) {
+		waves_codec->i_buffer = (void *)ptr;
+		return 0;
+	}
+
+	/* keep the data and gather the block from both ends of the buffer */
+	source_release_data(source, 0);
+	ret = source_get_data(source, bytes, (const void **)&ptr,
+			      (const void **)&buf_start, &buf_size);
+	if (ret)
+		return ret;
+
+	head = buf_start + buf_size - ptr;
+	memcpy_s(i_copy, bytes, ptr, head);
+	memcpy_s((uint8_t *)i_copy + head, bytes - head, buf_start, bytes - head);
+	waves_codec->i_buffer = i_copy;
+
+	return 0;
+}
+
+/* write the produced samples to the sink, unless MaxxEffect wrote them in place */
+static int waves_codec_put_output(struct processing_module *mod, struct sof_sink *sink,
+				  size_t produced)
+{
+	struct waves_codec_data *waves_codec = mod->priv.private;
+	uint8_t *buf_start;
+	uint8_t *ptr;
+	size_t buf_size;
+	size_t head;
+	int ret;
+
+	if (waves_codec->o_buffer != waves_codec->o_copy)
+		return sink_commit_buffer(sink, produced);
+
+	ret = sink_get_buffer(sink, produced, (void **)&ptr, (void **)&buf_start, &buf_size);
+	if (ret)
+		return ret;
+
+	head = MIN(produced, (size_t)(buf_start + buf_size - ptr));
+	memcpy_s(ptr, head, waves_codec->o_copy, head);
+	memcpy_s(buf_start, produced - head, (uint8_t *)waves_codec->o_copy + head,
+		 produced - head);
+
+	return sink_commit_buffer(sink, produced);
+}
+
+static int waves_codec_process(struct processing_module *mod,
+			       struct sof_source **sources, int num_of_sources,
+			       struct sof_sink **sinks, int num_of_sinks)
 {
 	int ret;
 	struct comp_dev *dev = mod->dev;
 	struct module_data *codec = &mod->priv;
 	struct waves_codec_data *waves_codec = codec->private;
+	struct sof_source *source = sources[0];
+	struct sof_sink *sink = sinks[0];
+	void *i_copy = waves_codec->i_copy;
+	void *o_copy = waves_codec->o_copy;
+	MaxxStream_t *i_streams[NUM_IO_STREAMS] = { &waves_codec->i_stream };
+	MaxxStream_t *o_streams[NUM_IO_STREAMS] = { &waves_codec->o_stream };
+	MaxxStatus_t status;
+	size_t out_size;
+	void *out;
 
 	/* Proceed only if we have enough data to fill the module buffer completely */
-	if (input_buffers[0].size < codec->mpd.in_buff_size) {
+	if (!waves_codec_is_ready_to_process(mod, sources, num_of_sources, sinks, num_of_sinks)) {
 		comp_dbg(dev, "waves_codec_process(): not enough data to process");
-		return -ENODATA;
+		return 0;
 	}
 
 	if (!codec->mpd.init_done)
 		waves_codec_init_process(mod);
 
-	memcpy_s(codec->mpd.in_buff, codec->mpd.in_buff_size,
-		 input_buffers[0].data, codec->mpd.in_buff_size);
-	codec->mpd.avail = codec->mpd.in_buff_size;
-
 	comp_dbg(dev, "waves_codec_process() start");
 
-	MaxxStream_t *i_streams[NUM_IO_STREAMS] = { &waves_codec->i_stream };
-	MaxxStream_t *o_streams[NUM_IO_STREAMS] = { &waves_codec->o_stream };
-	MaxxStatus_t status;
-	uint32_t num_input_samples = waves_codec->buffer_samples;
+#if CONFIG_MODULE_SCRATCH_ARENA
+	if (waves_codec->scratch) {
+		i_copy = module_scratch_get(mod);
+		o_copy = (uint8_t *)i_copy + waves_codec->buffer_bytes;
+		waves_codec->o_copy = o_copy;
+	}
+#endif
 
-	/* here input buffer should always be filled up as requested
-	 * since no one updates it`s size except code in prepare.
-	 * on the other hand there is available/produced counters in mpd, check them anyways
-	 */
-	if (codec->mpd.avail != waves_codec->buffer_bytes) {
-		comp_warn(dev, "waves_codec_process() input buffer %d is not full %d",
-			  codec->mpd.avail, waves_codec->buffer_bytes);
-		num_input_samples = codec->mpd.avail /
-			(waves_codec->sample_size_in_bytes * waves_codec->i_format.numChannels);
+	ret = waves_codec_get_input(mod, source, i_copy);
+	if (ret)
+		return ret;
+
+	ret = sink_get_buffer_linear(sink, waves_codec->buffer_bytes, &out, &out_size);
+	if (ret) {
+		source_release_data(source, 0);
+		return ret;
+	}
+
+	/* a wrapping output block is staged and copied once produced */
+	if (out_size == waves_codec->buffer_bytes) {
+		waves_codec->o_buffer = out;
+	} else {
+		sink_commit_buffer(sink, 0);
+		waves_codec->o_buffer = o_copy;
 	}
 
 	waves_codec->i_stream.buffersArray = &waves_codec->i_buffer;
-	waves_codec->i_stream.numAvailableSamples = num_input_samples;
+	waves_codec->i_stream.numAvailableSamples = waves_codec->buffer_samples;
 	waves_codec->i_stream.numProcessedSamples = 0;
 	waves_codec->i_stream.maxNumSamples = waves_codec->buffer_samples;
 
@@ -754,18 +867,19 @@ waves_codec_process(struct processing_module *mod,
 	status = MaxxEffect_Process(waves_codec->effect, i_streams, o_streams);
 	if (status) {
 		comp_err(dev, "waves_codec_process() MaxxEffect_Process returned %d", status);
+		codec->mpd.produced = 0;
 		ret = -EINVAL;
 	} else {
 		codec->mpd.produced = waves_codec->o_stream.numAvailableSamples *
 			waves_codec->o_format.numChannels * waves_codec->sample_size_in_bytes;
-		codec->mpd.consumed = codec->mpd.produced;
-		input_buffers[0].consumed = codec->mpd.consumed;
-		ret = 0;
-		/* copy the produced samples into the output buffer */
-		memcpy_s(output_buffers[0].data, codec->mpd.produced, codec->mpd.out_buff,
-			 codec->mpd.produced);
-		output_buffers[0].size = codec->mpd.produced;
 	}
+	codec->mpd.consumed = codec->mpd.produced;
+
+	if (waves_codec->o_buffer == out)
+		sink_commit_buffer(sink, codec->mpd.produced);
+	else if (!ret)
+		ret = waves_codec_put_output(mod, sink, codec->mpd.produced);
+	source_release_data(source, codec->mpd.consumed);
 
 	if (ret)
 		comp_err(dev, "waves_codec_process() failed %d", ret);
@@ -807,11 +921,23 @@ static int waves_codec_reset(struct processing_module *mod)
 	if (ret)
 		comp_err(dev, "waves_codec_reset() failed %d", ret);
 
-	if (codec->mpd.in_buff)
-		module_free_memory(mod, codec->mpd.in_buff);
+	if (waves_codec->scratch) {
+#if CONFIG_MODULE_SCRATCH_ARENA
+		module_scratch_release(mod);
+#endif
+		waves_codec->scratch = false;
+		waves_codec->o_copy = NULL;
+	}
+
+	if (waves_codec->i_copy) {
+		module_free_memory(mod, waves_codec->i_copy);
+		waves_codec->i_copy = NULL;
+	}
 
-	if (codec->mpd.out_buff)
-		module_free_memory(mod, codec->mpd.out_buff);
+	if (waves_codec->o_copy) {
+		module_free_memory(mod, waves_codec->o_copy);
+		waves_codec->o_copy = NULL;
+	}
 
 	comp_dbg(dev, "waves_codec_reset() done");
 	return ret;
@@ -860,7 +986,8 @@ waves_codec_set_configuration(struct processing_module *mod, uint32_t config_id,
 static const struct module_interface waves_interface = {
 	.init = waves_codec_init,
 	.prepare = waves_codec_prepare,
-	.process_raw_data = waves_codec_process,
+	.process = waves_codec_process,
+	.is_ready_to_process = waves_codec_is_ready_to_process,
 	.set_configuration = waves_codec_set_configuration,
 	.reset = waves_codec_reset,
 	.free = waves_codec_free
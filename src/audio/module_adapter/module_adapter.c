@@ -20,9 +20,13 @@
 #include <sof/audio/dp_queue.h>
 #include <sof/audio/pipeline.h>
 #include <sof/common.h>
+#include <sof/debug/telemetry/telemetry.h>
+#include <sof/debug/telemetry/tracepoint.h>
+#include <sof/ipc/async_init.h>
 #include <sof/platform.h>
 #include <sof/ut.h>
 #include <rtos/interrupt.h>
+#include <rtos/timer.h>
 #include <limits.h>
 #include <stdint.h>
 
@@ -35,6 +39,30 @@ LOG_MODULE_REGISTER(module_adapter, CONFIG_SOF_LOG_LEVEL);
  *
  * \return: a pointer to newly created module adapter component on success. NULL on error.
  */
+static int module_adapter_init_async(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	int ret;
+
+	ret = mod->priv.ops->init_async(mod);
+	if (ret)
+		comp_err(dev, "module_adapter_init_async() %d: module initialization failed", ret);
+
+	return ret;
+}
+
+/* the time consuming part of the init, in the background when possible */
+static int module_adapter_init_async_start(struct comp_dev *dev)
+{
+#if CONFIG_IPC4_ASYNC_INIT
+	/* on other cores the init IPC is handled by IDC, not by the IPC task */
+	if (dev->ipc_config.core == PLATFORM_PRIMARY_CORE_ID &&
+	    !ipc4_async_init_start(dev, module_adapter_init_async))
+		return 0;
+#endif
+	return module_adapter_init_async(dev);
+}
+
 struct comp_dev *module_adapter_new(const struct comp_driver *drv,
 				    const struct comp_ipc_config *config,
 				    const struct module_interface *interface, const void *spec)
@@ -69,7 +97,8 @@ struct comp_dev *module_adapter_new(const struct comp_driver *drv,
 	enum mem_zone zone = config->proc_domain == COMP_PROCESSING_DOMAIN_DP ?
 			     SOF_MEM_ZONE_RUNTIME_SHARED : SOF_MEM_ZONE_RUNTIME;
 
-	mod = rzalloc(zone, 0, SOF_MEM_CAPS_RAM, sizeof(*mod));
+	mod = rzalloc(zone, zone == SOF_MEM_ZONE_RUNTIME ? SOF_MEM_FLAG_CORE_LOCAL : 0,
+		      SOF_MEM_CAPS_RAM, sizeof(*mod));
 	if (!mod) {
 		comp_err(dev, "module_adapter_new(), failed to allocate memory for module");
 		rfree(dev);
@@ -101,12 +130,30 @@ struct comp_dev *module_adapter_new(const struct comp_driver *drv,
 		goto err;
 	}
 
+	if (interface->init_async) {
+		ret = module_adapter_init_async_start(dev);
+		if (ret) {
+			module_free(mod);
+			goto err;
+		}
+	}
+
 #if CONFIG_ZEPHYR_DP_SCHEDULER
 	/* create a task for DP processing */
 	if (config->proc_domain == COMP_PROCESSING_DOMAIN_DP)
 		pipeline_comp_dp_task_init(dev);
 #endif /* CONFIG_ZEPHYR_DP_SCHEDULER */
 
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+	/* not fatal, the module is just not reported in performance data */
+	mod->perf_data = perf_data_item_comp_register(dev);
+	if (!mod->perf_data)
+		comp_warn(dev, "module_adapter_new(): no memory for performance data");
+#if CONFIG_SOF_TELEMETRY_CPC_ACCOUNTING
+	perf_data_item_comp_set_cpc(mod->perf_data, mod->priv.cfg.base_cfg.cpc);
+#endif
+#endif
+
 	module_adapter_reset_data(dst);
 
 	dev->state = COMP_STATE_READY;
@@ -119,19 +166,53 @@ err:
 	return NULL;
 }
 
-static int module_adapter_sink_src_prepare(struct comp_dev *dev)
+#if CONFIG_ZEPHYR_DP_SCHEDULER_DIRECT_QUEUES
+static inline bool module_adapter_buffer_is_bound(struct comp_buffer *buffer)
+{
+	return buffer->dp_queue;
+}
+
+/* sink API handler of a buffer, which is the DP queue bound in its place if there is one */
+static inline struct sof_sink *module_adapter_buffer_sink(struct comp_buffer *buffer)
+{
+	return buffer->dp_queue ? dp_queue_get_sink(buffer->dp_queue) :
+				  audio_stream_get_sink(&buffer->stream);
+}
+
+static inline struct sof_source *module_adapter_buffer_source(struct comp_buffer *buffer)
+{
+	return buffer->dp_queue ? dp_queue_get_source(buffer->dp_queue) :
+				  audio_stream_get_source(&buffer->stream);
+}
+#else
+static inline bool module_adapter_buffer_is_bound(struct comp_buffer *buffer)
+{
+	return false;
+}
+
+static inline struct sof_sink *module_adapter_buffer_sink(struct comp_buffer *buffer)
+{
+	return audio_stream_get_sink(&buffer->stream);
+}
+
+static inline struct sof_source *module_adapter_buffer_source(struct comp_buffer *buffer)
+{
+	return audio_stream_get_source(&buffer->stream);
+}
+#endif /* CONFIG_ZEPHYR_DP_SCHEDULER_DIRECT_QUEUES */
+
+/* acquire all sink and source buffers, get handlers to sink/source API */
+static void module_adapter_sink_src_prepare_handlers(struct comp_dev *dev)
 {
 	struct processing_module *mod = comp_get_drvdata(dev);
 	struct list_item *blist;
-	int ret;
 	int i;
 
-	/* acquire all sink and source buffers, get handlers to sink/source API */
 	i = 0;
 	list_for_item(blist, &dev->bsink_list) {
 		struct comp_buffer *sink_buffer =
 				container_of(blist, struct comp_buffer, source_list);
-		mod->sinks[i] = audio_stream_get_sink(&sink_buffer->stream);
+		mod->sinks[i] = module_adapter_buffer_sink(sink_buffer);
 		i++;
 	}
 	mod->num_of_sinks = i;
@@ -141,43 +222,216 @@ static int module_adapter_sink_src_prepare(struct comp_dev *dev)
 		struct comp_buffer *source_buffer =
 				container_of(blist, struct comp_buffer, sink_list);
 
-		mod->sources[i] = audio_stream_get_source(&source_buffer->stream);
+		mod->sources[i] = module_adapter_buffer_source(source_buffer);
 		i++;
 	}
 	mod->num_of_sources = i;
+}
 
-	/* Prepare module */
-	ret = module_prepare(mod, mod->sources, mod->num_of_sources, mod->sinks, mod->num_of_sinks);
+static int module_adapter_sink_src_prepare(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
 
-	return ret;
+	module_adapter_sink_src_prepare_handlers(dev);
+
+	/* Prepare module */
+	return module_prepare(mod, mod->sources, mod->num_of_sources, mod->sinks,
+			      mod->num_of_sinks);
 }
 
 #if CONFIG_ZEPHYR_DP_SCHEDULER
-static int module_adapter_dp_queue_prepare(struct comp_dev *dev)
+#if CONFIG_ZEPHYR_DP_SCHEDULER_DIRECT_QUEUES
+/*
+ * The DP queue of a module input or output may be bound in place of the buffer to an
+ * LL neighbor of the same pipeline, which uses the sink/source API. The neighbor then
+ * reads or writes the queue itself and the data crosses the LL/DP boundary only once,
+ * instead of being copied between the buffer and the queue in every LL period.
+ */
+static bool module_adapter_dp_queue_bindable(struct comp_dev *dev, struct comp_dev *peer,
+					     struct dp_queue *dp_queue)
+{
+	struct processing_module *peer_mod;
+
+	if (!peer || peer->drv->ops.copy != module_adapter_copy ||
+	    peer->pipeline != dev->pipeline)
+		return false;
+
+	peer_mod = comp_get_drvdata(peer);
+
+	return IS_PROCESSING_MODE_SINK_SOURCE(peer_mod) &&
+	       peer->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_LL &&
+	       (dp_queue_is_shared(dp_queue) ||
+		peer->ipc_config.core == dev->ipc_config.core);
+}
+
+/*
+ * Bind dp_queue in place of buffer, or unbind it with a NULL dp_queue. A neighbor that
+ * is already prepared has a handler of the buffer, it is replaced too.
+ */
+static void module_adapter_dp_queue_bind(struct comp_buffer *buffer, struct dp_queue *dp_queue,
+					 bool dp_input)
+{
+	struct comp_dev *peer = dp_input ? buffer->source : buffer->sink;
+	struct processing_module *peer_mod = comp_get_drvdata(peer);
+	struct list_item *blist;
+	int i = 0;
+
+	buffer->dp_queue = dp_queue;
+
+	if (dp_input) {
+		/* the neighbor is the producer */
+		list_for_item(blist, &peer->bsink_list) {
+			if (container_of(blist, struct comp_buffer, source_list) == buffer)
+				break;
+			i++;
+		}
+		if (i < peer_mod->num_of_sinks)
+			peer_mod->sinks[i] = module_adapter_buffer_sink(buffer);
+	} else {
+		list_for_item(blist, &peer->bsource_list) {
+			if (container_of(blist, struct comp_buffer, sink_list) == buffer)
+				break;
+			i++;
+		}
+		if (i < peer_mod->num_of_sources)
+			peer_mod->sources[i] = module_adapter_buffer_source(buffer);
+	}
+}
+
+static void module_adapter_dp_queue_unbind_all(struct comp_dev *dev)
+{
+	struct comp_buffer *buffer;
+	struct list_item *blist;
+
+	list_for_item(blist, &dev->bsource_list) {
+		buffer = container_of(blist, struct comp_buffer, sink_list);
+		if (buffer->dp_queue)
+			module_adapter_dp_queue_bind(buffer, NULL, true);
+	}
+
+	list_for_item(blist, &dev->bsink_list) {
+		buffer = container_of(blist, struct comp_buffer, source_list);
+		if (buffer->dp_queue)
+			module_adapter_dp_queue_bind(buffer, NULL, false);
+	}
+}
+#else
+static inline bool module_adapter_dp_queue_bindable(struct comp_dev *dev, struct comp_dev *peer,
+						    struct dp_queue *dp_queue)
+{
+	return false;
+}
+
+static inline void module_adapter_dp_queue_bind(struct comp_buffer *buffer,
+						struct dp_queue *dp_queue, bool dp_input)
+{
+}
+
+static inline void module_adapter_dp_queue_unbind_all(struct comp_dev *dev) {}
+#endif /* CONFIG_ZEPHYR_DP_SCHEDULER_DIRECT_QUEUES */
+
+/*
+ * The queues of a module are used by its LL copy and by its DP task, or by an LL neighbor
+ * of the same pipeline, all on the core of the module. Only the DP workers running a core
+ * agnostic module may be on other cores, then the queue is shared. Short blocks of a shared
+ * queue are cheaper to access uncached than to write back and invalidate.
+ */
+static uint32_t module_adapter_dp_queue_mode(struct comp_dev *dev, size_t block)
 {
-	int dp_mode = dev->is_shared ? DP_QUEUE_MODE_SHARED : DP_QUEUE_MODE_LOCAL;
 	struct processing_module *mod = comp_get_drvdata(dev);
+
+	if (!mod->dp_core_agnostic)
+		return DP_QUEUE_MODE_LOCAL;
+
+	if (block <= CONFIG_DP_QUEUE_UNCACHED_MAX_BYTES)
+		return DP_QUEUE_MODE_SHARED | DP_QUEUE_MODE_UNCACHED;
+
+	return DP_QUEUE_MODE_SHARED;
+}
+
+static struct dp_queue *module_adapter_dp_queue_create(struct comp_dev *dev,
+						       size_t min_available,
+						       size_t min_free_space)
+{
+	size_t block = MAX(min_available, min_free_space);
+	uint32_t dp_mode = module_adapter_dp_queue_mode(dev, block);
 	struct dp_queue *dp_queue;
-	struct list_item *blist;
-	int ret;
-	int i;
+#if CONFIG_SOF_TELEMETRY
+	struct telemetry_dp_queue record;
+#endif
 
-	/* for DP processing we need to create a DP QUEUE for each module input/output
-	 * till pipeline2.0 is ready, DP processing requires double buffering
-	 *
-	 * first, set all parameters by calling "module prepare" with pointers to
-	 * "main" audio_stream buffers
-	 */
-	ret = module_adapter_sink_src_prepare(dev);
-	if (ret)
-		return ret;
+	dp_queue = dp_queue_create(min_available, min_free_space, dp_mode);
+	if (!dp_queue)
+		return NULL;
+
+	comp_dbg(dev, "module_adapter_dp_queue_create(): mode %#x, block %u",
+		 dp_mode, (unsigned int)block);
+
+#if CONFIG_SOF_TELEMETRY
+	record.mode = dp_mode;
+	record.size = dp_queue->data_buffer_size;
+	record.block = block;
+	telemetry_post(TELEMETRY_RECORD_DP_QUEUE, dev_comp_id(dev), &record, sizeof(record));
+#endif
+
+	return dp_queue;
+}
+
+#if CONFIG_SOF_CACHE_STATS && CONFIG_SOF_TELEMETRY
+static void module_adapter_dp_queue_stats_post(struct comp_dev *dev, struct dp_queue *dp_queue)
+{
+	const struct cache_stats *stats = dp_queue_get_cache_stats(dp_queue);
+	struct telemetry_cache_stats record;
+
+	if (!stats->invalidates && !stats->writebacks)
+		return;
+
+	cache_stats_record(&record, stats);
+	telemetry_post(TELEMETRY_RECORD_CACHE_STATS, dev_comp_id(dev), &record, sizeof(record));
+}
+#else
+static inline void module_adapter_dp_queue_stats_post(struct comp_dev *dev,
+						      struct dp_queue *dp_queue) {}
+#endif
+
+static void module_adapter_dp_queues_free(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct list_item *dp_queue_list_item;
+	struct list_item *tmp;
+
+	module_adapter_dp_queue_unbind_all(dev);
+
+	list_for_item_safe(dp_queue_list_item, tmp, &mod->dp_queue_dp_to_ll_list) {
+		struct dp_queue *dp_queue =
+				container_of(dp_queue_list_item, struct dp_queue, list);
+
+		module_adapter_dp_queue_stats_post(dev, dp_queue);
+		/* dp free will also remove the queue from a list */
+		dp_queue_free(dp_queue);
+	}
+	list_for_item_safe(dp_queue_list_item, tmp, &mod->dp_queue_ll_to_dp_list) {
+		struct dp_queue *dp_queue =
+				container_of(dp_queue_list_item, struct dp_queue, list);
+
+		module_adapter_dp_queue_stats_post(dev, dp_queue);
+		dp_queue_free(dp_queue);
+	}
+}
+
+/*
+ * Create a "shadow" cross-core DpQueue for each existing buffer and copy the stream
+ * parameters to the shadow queues. The module does not use them until they are attached.
+ */
+static int module_adapter_dp_queues_create(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct dp_queue *dp_queue;
+	struct list_item *blist;
 
-	 /*
-	  * second step - create a "shadow" cross-core DpQueue for existing buffers
-	  * and copy stream parameters to shadow buffers
-	  */
-	i = 0;
 	list_init(&mod->dp_queue_ll_to_dp_list);
+	list_init(&mod->dp_queue_dp_to_ll_list);
+
 	list_for_item(blist, &dev->bsource_list) {
 		struct comp_buffer *source_buffer =
 			container_of(blist, struct comp_buffer, sink_list);
@@ -189,29 +443,19 @@ static int module_adapter_dp_queue_prepare(struct comp_dev *dev)
 			sink_get_min_free_space(audio_stream_get_sink(&source_buffer->stream));
 
 		/* create a shadow dp queue */
-		dp_queue = dp_queue_create(min_available, min_free_space, dp_mode);
+		dp_queue = module_adapter_dp_queue_create(dev, min_available, min_free_space);
 
 		if (!dp_queue)
 			goto err;
 		dp_queue_append_to_list(dp_queue, &mod->dp_queue_ll_to_dp_list);
 
-		/* it will override source pointers set by module_adapter_sink_src_prepare
-		 * module will use shadow dpQueue for processing
-		 */
-		mod->sources[i] = dp_queue_get_source(dp_queue);
-
 		/* copy parameters from buffer to be shadowed */
 		memcpy_s(&dp_queue->audio_stream_params,
 			 sizeof(dp_queue->audio_stream_params),
 			 &source_buffer->stream.runtime_stream_params,
 			 sizeof(source_buffer->stream.runtime_stream_params));
-		i++;
 	}
-	mod->num_of_sources = i;
-	unsigned int period = UINT32_MAX;
 
-	i = 0;
-	list_init(&mod->dp_queue_dp_to_ll_list);
 	list_for_item(blist, &dev->bsink_list) {
 		struct comp_buffer *sink_buffer =
 			container_of(blist, struct comp_buffer, source_list);
@@ -223,22 +467,71 @@ static int module_adapter_dp_queue_prepare(struct comp_dev *dev)
 			sink_get_min_free_space(audio_stream_get_sink(&sink_buffer->stream));
 
 		/* create a shadow dp queue */
-		dp_queue = dp_queue_create(min_available, min_free_space, dp_mode);
+		dp_queue = module_adapter_dp_queue_create(dev, min_available, min_free_space);
 
 		if (!dp_queue)
 			goto err;
-
 		dp_queue_append_to_list(dp_queue, &mod->dp_queue_dp_to_ll_list);
-		/* it will override sink pointers set by module_adapter_sink_src_prepare
-		 * module will use shadow dpQueue for processing
-		 */
-		mod->sinks[i] = dp_queue_get_sink(dp_queue);
 
 		/* copy parameters from buffer to be shadowed */
 		memcpy_s(&dp_queue->audio_stream_params,
 			 sizeof(dp_queue->audio_stream_params),
 			 &sink_buffer->stream.runtime_stream_params,
 			 sizeof(sink_buffer->stream.runtime_stream_params));
+	}
+
+	return 0;
+
+err:
+	module_adapter_dp_queues_free(dev);
+	return -ENOMEM;
+}
+
+/*
+ * Make the module process from and to its shadow queues, binding them to the LL
+ * neighbors where possible. Returns the time the module needs to provide its OBS, in us.
+ */
+static unsigned int module_adapter_dp_queues_attach(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	unsigned int period = UINT32_MAX;
+	struct dp_queue *dp_queue;
+	struct list_item *blist;
+	int i;
+
+	i = 0;
+	dp_queue = dp_queue_get_first_item(&mod->dp_queue_ll_to_dp_list);
+	list_for_item(blist, &dev->bsource_list) {
+		struct comp_buffer *source_buffer =
+			container_of(blist, struct comp_buffer, sink_list);
+
+		/* it will override source pointers set by module_adapter_sink_src_prepare
+		 * module will use shadow dpQueue for processing
+		 */
+		mod->sources[i] = dp_queue_get_source(dp_queue);
+
+		if (module_adapter_dp_queue_bindable(dev, source_buffer->source, dp_queue))
+			module_adapter_dp_queue_bind(source_buffer, dp_queue, true);
+
+		dp_queue = dp_queue_get_next_item(dp_queue);
+		i++;
+	}
+	mod->num_of_sources = i;
+
+	i = 0;
+	dp_queue = dp_queue_get_first_item(&mod->dp_queue_dp_to_ll_list);
+	list_for_item(blist, &dev->bsink_list) {
+		struct comp_buffer *sink_buffer =
+			container_of(blist, struct comp_buffer, source_list);
+
+		/* it will override sink pointers set by module_adapter_sink_src_prepare
+		 * module will use shadow dpQueue for processing
+		 */
+		mod->sinks[i] = dp_queue_get_sink(dp_queue);
+
+		if (module_adapter_dp_queue_bindable(dev, sink_buffer->sink, dp_queue))
+			module_adapter_dp_queue_bind(sink_buffer, dp_queue, false);
+
 		/* calculate time required the module to provide OBS data portion - a period */
 		unsigned int sink_period = 1000000 * sink_get_min_free_space(mod->sinks[i]) /
 					   (sink_get_frame_bytes(mod->sinks[i]) *
@@ -247,9 +540,45 @@ static int module_adapter_dp_queue_prepare(struct comp_dev *dev)
 		if (period > sink_period)
 			period = sink_period;
 
+		dp_queue = dp_queue_get_next_item(dp_queue);
 		i++;
 	}
 	mod->num_of_sinks = i;
+
+	return period;
+}
+
+static int module_adapter_dp_queue_prepare(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	unsigned int period;
+	int ret;
+	int i;
+
+	/* for DP processing we need to create a DP QUEUE for each module input/output
+	 * till pipeline2.0 is ready, DP processing requires double buffering
+	 *
+	 * first, set all parameters by calling "module prepare" with pointers to
+	 * "main" audio_stream buffers
+	 */
+	ret = module_adapter_sink_src_prepare(dev);
+	if (ret)
+		return ret;
+
+	/* second step - create the shadow queues and let the module use them */
+	ret = module_adapter_dp_queues_create(dev);
+	if (ret) {
+		for (i = 0; i < mod->num_of_sources; i++)
+			mod->sources[i] = NULL;
+		for (i = 0; i < mod->num_of_sinks; i++)
+			mod->sinks[i] = NULL;
+		mod->num_of_sources = 0;
+		mod->num_of_sinks = 0;
+		return ret;
+	}
+
+	period = module_adapter_dp_queues_attach(dev);
+
 	/* set the period for the module unless it has already been calculated by the
 	 * module itself during prepare
 	 * It may happen i.e. for modules like phrase detect that do not produce audio data
@@ -262,34 +591,8 @@ static int module_adapter_dp_queue_prepare(struct comp_dev *dev)
 	}
 
 	return 0;
-
-err:;
-	struct list_item *dp_queue_list_item;
-	struct list_item *tmp;
-
-	i = 0;
-	list_for_item_safe(dp_queue_list_item, tmp, &mod->dp_queue_dp_to_ll_list) {
-		struct dp_queue *dp_queue =
-			container_of(dp_queue_list_item, struct dp_queue, list);
-
-		/* dp free will also remove the queue from a list */
-		dp_queue_free(dp_queue);
-		mod->sources[i++] = NULL;
-	}
-	mod->num_of_sources = 0;
-
-	i = 0;
-	list_for_item_safe(dp_queue_list_item, tmp, &mod->dp_queue_ll_to_dp_list) {
-		struct dp_queue *dp_queue =
-			container_of(dp_queue_list_item, struct dp_queue, list);
-
-		dp_queue_free(dp_queue);
-		mod->sinks[i++] = NULL;
-	}
-	mod->num_of_sinks = 0;
-
-	return -ENOMEM;
 }
+
 #else
 static inline int module_adapter_dp_queue_prepare(struct comp_dev *dev)
 {
@@ -305,6 +608,55 @@ static inline int module_adapter_dp_queue_prepare(struct comp_dev *dev)
  *	0 - success
  *	value < 0 - failure.
  */
+/*
+ * Raw data module may process in place if it declares so and it has a single source and sink of
+ * the same format. No deep buffering must be needed, the output is written straight to the sink.
+ */
+static bool module_adapter_in_place_check(struct processing_module *mod, struct comp_dev *dev)
+{
+	struct module_data *md = &mod->priv;
+	struct comp_buffer *source, *sink;
+
+	if (!md->ops->in_place || mod->num_of_sources != 1 || mod->num_of_sinks != 1)
+		return false;
+
+	if (mod->deep_buff_bytes || md->mpd.out_buff_size > mod->period_bytes)
+		return false;
+
+	source = list_first_item(&dev->bsource_list, struct comp_buffer, sink_list);
+	sink = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+
+	return audio_stream_get_frm_fmt(&source->stream) == audio_stream_get_frm_fmt(&sink->stream) &&
+	       audio_stream_get_channels(&source->stream) == audio_stream_get_channels(&sink->stream) &&
+	       audio_stream_get_rate(&source->stream) == audio_stream_get_rate(&sink->stream);
+}
+
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+/* the pipeline task of LL modules is budgeted with the CPC they declare */
+static void module_adapter_task_budget_add(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct task *task = dev->pipeline ? dev->pipeline->pipe_task : NULL;
+
+	if (!task || dev->ipc_config.proc_domain != COMP_PROCESSING_DOMAIN_LL)
+		return;
+
+	mod->task_budget = mod->priv.cfg.base_cfg.cpc;
+	task->cycles_budget += mod->task_budget;
+}
+
+static void module_adapter_task_budget_remove(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+
+	if (!mod->task_budget)
+		return;
+
+	dev->pipeline->pipe_task->cycles_budget -= mod->task_budget;
+	mod->task_budget = 0;
+}
+#endif
+
 int module_adapter_prepare(struct comp_dev *dev)
 {
 	int ret;
@@ -358,6 +710,10 @@ int module_adapter_prepare(struct comp_dev *dev)
 		return PPL_STATUS_PATH_STOP;
 	}
 
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+	module_adapter_task_budget_add(dev);
+#endif
+
 	/* nothing more to do for HOST/DAI type modules */
 	if (dev->ipc_config.type == SOF_COMP_HOST || dev->ipc_config.type == SOF_COMP_DAI)
 		return 0;
@@ -477,12 +833,13 @@ int module_adapter_prepare(struct comp_dev *dev)
 	 */
 	buff_size = MAX(mod->period_bytes, md->mpd.out_buff_size) * buff_periods;
 	mod->output_buffer_size = buff_size;
+	mod->raw_data_in_place = module_adapter_in_place_check(mod, dev);
 
 	/* allocate memory for input buffer data */
 	list_for_item(blist, &dev->bsource_list) {
 		size_t size = MAX(mod->deep_buff_bytes, mod->period_bytes);
 
-		mod->input_buffers[i].data = rballoc(0, SOF_MEM_CAPS_RAM, size);
+		mod->input_buffers[i].data = rballoc(SOF_MEM_FLAG_CORE_LOCAL, SOF_MEM_CAPS_RAM, size);
 		if (!mod->input_buffers[i].data) {
 			comp_err(mod->dev, "module_adapter_prepare(): Failed to alloc input buffer data");
 			ret = -ENOMEM;
@@ -491,10 +848,18 @@ int module_adapter_prepare(struct comp_dev *dev)
 		i++;
 	}
 
+	/* output is produced in the input buffer and copied directly to the sink */
+	if (mod->raw_data_in_place) {
+		mod->output_buffers[0].data = mod->input_buffers[0].data;
+		comp_dbg(dev, "module_adapter_prepare() done, processing in place");
+		return 0;
+	}
+
 	/* allocate memory for output buffer data */
 	i = 0;
 	list_for_item(blist, &dev->bsink_list) {
-		mod->output_buffers[i].data = rballoc(0, SOF_MEM_CAPS_RAM, md->mpd.out_buff_size);
+		mod->output_buffers[i].data = rballoc(SOF_MEM_FLAG_CORE_LOCAL, SOF_MEM_CAPS_RAM,
+						      md->mpd.out_buff_size);
 		if (!mod->output_buffers[i].data) {
 			comp_err(mod->dev, "module_adapter_prepare(): Failed to alloc output buffer data");
 			ret = -ENOMEM;
@@ -681,13 +1046,16 @@ static void generate_zeroes(struct comp_buffer *sink, uint32_t bytes)
 	uint32_t tmp, copy_bytes = bytes;
 	void *ptr;
 
+	ptr = audio_stream_wrap(&sink->stream, audio_stream_get_wptr(&sink->stream));
 	while (copy_bytes) {
-		ptr = audio_stream_wrap(&sink->stream, audio_stream_get_wptr(&sink->stream));
 		tmp = audio_stream_bytes_without_wrap(&sink->stream, ptr);
 		tmp = MIN(tmp, copy_bytes);
-		ptr = (char *)ptr + tmp;
+		audio_block_zero(ptr, tmp);
+		ptr = audio_stream_wrap(&sink->stream, (char *)ptr + tmp);
 		copy_bytes -= tmp;
 	}
+	buffer_stream_writeback(sink, bytes);
+	audio_stream_mark_silent(&sink->stream);
 	comp_update_buffer_produce(sink, bytes);
 }
 
@@ -780,6 +1148,25 @@ static void module_adapter_process_output(struct comp_dev *dev)
 	mod->total_data_produced += mod->output_buffers[0].size;
 }
 
+/* copy output processed in place directly to the sink, no intermediate buffer is used */
+static void module_adapter_process_output_in_place(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct comp_buffer *sink = list_first_item(&dev->bsink_list, struct comp_buffer,
+						   source_list);
+	uint32_t bytes = MIN(mod->output_buffers[0].size,
+			     audio_stream_get_free_bytes(&sink->stream));
+
+	if (bytes) {
+		ca_copy_from_module_to_sink(&sink->stream, mod->output_buffers[0].data, bytes);
+		buffer_stream_writeback(sink, bytes);
+		comp_update_buffer_produce(sink, bytes);
+	}
+
+	mod->total_data_produced += bytes;
+	mod->output_buffers[0].size = 0;
+}
+
 static uint32_t
 module_single_sink_setup(struct comp_dev *dev,
 			 struct comp_buffer **source,
@@ -864,6 +1251,62 @@ module_single_source_setup(struct comp_dev *dev,
 	return num_output_buffers;
 }
 
+#if CONFIG_MODULE_SILENCE_SKIP
+/*
+ * Writes silence instead of calling process() when all inputs are silent and the
+ * module has seen enough silence since the last signal for its state to hold only
+ * zeros, see silence_tail_frames. Returns true when process() was skipped.
+ */
+static bool module_adapter_skip_silence(struct processing_module *mod,
+					uint32_t num_input_buffers, uint32_t num_output_buffers)
+{
+	struct audio_stream *stream;
+	uint32_t frames = mod->input_buffers[0].size;
+	uint32_t bytes;
+	int i;
+
+	if (!mod->silence_tail_frames || !num_input_buffers || !num_output_buffers || !frames)
+		return false;
+
+	for (i = 0; i < num_input_buffers; i++) {
+		if (!audio_stream_is_silent(mod->input_buffers[i].data)) {
+			mod->silent_frames = 0;
+			return false;
+		}
+	}
+
+	if (mod->silent_frames < mod->silence_tail_frames) {
+		mod->silent_frames += frames;
+		return false;
+	}
+
+	for (i = 0; i < num_input_buffers; i++) {
+		stream = mod->input_buffers[i].data;
+		mod->input_buffers[i].consumed =
+			mod->input_buffers[i].size * audio_stream_frame_bytes(stream);
+	}
+
+	for (i = 0; i < num_output_buffers; i++) {
+		stream = mod->output_buffers[i].data;
+		bytes = frames * audio_stream_frame_bytes(stream);
+		if (audio_stream_set_zero(stream, bytes))
+			continue;
+
+		mod->output_buffers[i].size = bytes;
+		audio_stream_mark_silent(stream);
+	}
+
+	return true;
+}
+#else
+static inline bool module_adapter_skip_silence(struct processing_module *mod,
+					       uint32_t num_input_buffers,
+					       uint32_t num_output_buffers)
+{
+	return false;
+}
+#endif
+
 static int module_adapter_audio_stream_copy_1to1(struct comp_dev *dev)
 {
 	struct processing_module *mod = comp_get_drvdata(dev);
@@ -893,8 +1336,11 @@ static int module_adapter_audio_stream_copy_1to1(struct comp_dev *dev)
 	if (mod->sink_comp_buffer->sink->state == dev->state)
 		num_output_buffers = 1;
 
-	ret = module_process_legacy(mod, mod->input_buffers, 1,
-				    mod->output_buffers, num_output_buffers);
+	if (module_adapter_skip_silence(mod, 1, num_output_buffers))
+		ret = 0;
+	else
+		ret = module_process_legacy(mod, mod->input_buffers, 1,
+					    mod->output_buffers, num_output_buffers);
 
 	/* consume from the input buffer */
 	mod->total_data_consumed += mod->input_buffers[0].consumed;
@@ -970,8 +1416,11 @@ static int module_adapter_audio_stream_type_copy(struct comp_dev *dev)
 		goto out;
 	}
 
-	ret = module_process_legacy(mod, mod->input_buffers, num_input_buffers,
-				    mod->output_buffers, num_output_buffers);
+	if (module_adapter_skip_silence(mod, num_input_buffers, num_output_buffers))
+		ret = 0;
+	else
+		ret = module_process_legacy(mod, mod->input_buffers, num_input_buffers,
+					    mod->output_buffers, num_output_buffers);
 	if (ret) {
 		if (ret != -ENOSPC && ret != -ENODATA) {
 			comp_err(dev,
@@ -1056,6 +1505,13 @@ static int module_adapter_copy_dp_queues(struct comp_dev *dev)
 		assert(dp_queue);
 		struct comp_buffer *buffer =
 				container_of(blist, struct comp_buffer, sink_list);
+
+		/* a bound queue is written by the LL neighbor directly */
+		if (module_adapter_buffer_is_bound(buffer)) {
+			dp_queue = dp_queue_get_next_item(dp_queue);
+			continue;
+		}
+
 		struct sof_source *data_src = audio_stream_get_source(&buffer->stream);
 		struct sof_sink *data_sink = dp_queue_get_sink(dp_queue);
 		uint32_t to_copy = MIN(sink_get_free_size(data_sink),
@@ -1076,6 +1532,13 @@ static int module_adapter_copy_dp_queues(struct comp_dev *dev)
 		assert(dp_queue);
 		struct comp_buffer *buffer =
 				container_of(blist, struct comp_buffer, source_list);
+
+		/* a bound queue is read by the LL neighbor directly */
+		if (module_adapter_buffer_is_bound(buffer)) {
+			dp_queue = dp_queue_get_next_item(dp_queue);
+			continue;
+		}
+
 		struct sof_sink *data_sink = audio_stream_get_sink(&buffer->stream);
 		struct sof_source *data_src = dp_queue_get_source(dp_queue);
 		uint32_t to_copy = MIN(sink_get_free_size(data_sink),
@@ -1143,6 +1606,11 @@ static int module_adapter_raw_data_type_copy(struct comp_dev *dev)
 
 	comp_dbg(dev, "module_adapter_raw_data_type_copy(): start");
 
+	if (mod->raw_data_in_place) {
+		sink = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+		min_free_frames = audio_stream_get_free_frames(&sink->stream);
+	}
+
 	list_for_item(blist, &mod->sink_buffer_list) {
 		sink = container_of(blist, struct comp_buffer, sink_list);
 
@@ -1189,6 +1657,10 @@ static int module_adapter_raw_data_type_copy(struct comp_dev *dev)
 		ret = 0;
 	}
 
+	/* the output shares memory with the input, it must be copied out before clearing */
+	if (mod->raw_data_in_place)
+		module_adapter_process_output_in_place(dev);
+
 	i = 0;
 	/* consume from all input buffers */
 	list_for_item(blist, &dev->bsource_list) {
@@ -1206,7 +1678,8 @@ static int module_adapter_raw_data_type_copy(struct comp_dev *dev)
 
 	mod->total_data_consumed += mod->input_buffers[0].consumed;
 
-	module_adapter_process_output(dev);
+	if (!mod->raw_data_in_place)
+		module_adapter_process_output(dev);
 
 	comp_dbg(dev, "module_adapter_raw_data_type_copy(): done");
 
@@ -1225,11 +1698,60 @@ out:
 	return ret;
 }
 
-int module_adapter_copy(struct comp_dev *dev)
+/*
+ * Copies the source to the sink of a module that declared itself transparent
+ * with mod->bypass, without calling its process(). The source and sink must
+ * have the same format, otherwise the module processes normally.
+ */
+static bool module_adapter_bypass_check(struct comp_dev *dev)
 {
-	comp_dbg(dev, "module_adapter_copy(): start");
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct audio_stream *source;
+	struct audio_stream *sink;
+
+	if (!mod->bypass || !mod->stream_copy_single_to_single ||
+	    dev->ipc_config.proc_domain != COMP_PROCESSING_DOMAIN_LL ||
+	    mod->sink_comp_buffer->sink->state != dev->state)
+		return false;
+
+	source = &mod->source_comp_buffer->stream;
+	sink = &mod->sink_comp_buffer->stream;
+	return audio_stream_get_frm_fmt(source) == audio_stream_get_frm_fmt(sink) &&
+	       audio_stream_get_channels(source) == audio_stream_get_channels(sink);
+}
 
+static int module_adapter_bypass_copy(struct comp_dev *dev)
+{
 	struct processing_module *mod = comp_get_drvdata(dev);
+	struct comp_buffer *source = mod->source_comp_buffer;
+	struct comp_buffer *sink = mod->sink_comp_buffer;
+	uint32_t frames;
+	uint32_t bytes;
+
+	frames = audio_stream_avail_frames_aligned(&source->stream, &sink->stream);
+	bytes = frames * audio_stream_frame_bytes(&source->stream);
+	if (!bytes)
+		return 0;
+
+	buffer_stream_invalidate(source, bytes);
+	audio_stream_copy(&source->stream, 0, &sink->stream, 0,
+			  frames * audio_stream_get_channels(&source->stream));
+	buffer_stream_writeback(sink, bytes);
+
+	audio_stream_consume(&source->stream, bytes);
+	comp_update_buffer_produce(sink, bytes);
+	mod->total_data_consumed += bytes;
+	mod->total_data_produced += bytes;
+
+	return 0;
+}
+
+static int module_adapter_copy_by_mode(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+
+	if (module_adapter_bypass_check(dev))
+		return module_adapter_bypass_copy(dev);
 
 	if (IS_PROCESSING_MODE_AUDIO_STREAM(mod))
 		return module_adapter_audio_stream_type_copy(dev);
@@ -1249,6 +1771,30 @@ int module_adapter_copy(struct comp_dev *dev)
 	return -EINVAL;
 }
 
+int module_adapter_copy(struct comp_dev *dev)
+{
+	int ret;
+
+	comp_dbg(dev, "module_adapter_copy(): start");
+
+	SOF_TRACEPOINT(SOF_TRACEPOINT_MODULE_COPY, SOF_TRACEPOINT_BEGIN, dev_comp_id(dev), 0);
+
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+	struct processing_module *mod = comp_get_drvdata(dev);
+	const uint64_t begin_stamp = sof_cycle_get_64();
+
+	ret = module_adapter_copy_by_mode(dev);
+
+	perf_data_item_comp_update(mod->perf_data, sof_cycle_get_64() - begin_stamp);
+#else
+	ret = module_adapter_copy_by_mode(dev);
+#endif
+
+	SOF_TRACEPOINT(SOF_TRACEPOINT_MODULE_COPY, SOF_TRACEPOINT_END, dev_comp_id(dev), 0);
+
+	return ret;
+}
+
 static int module_adapter_get_set_params(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata,
 					 bool set)
 {
@@ -1281,6 +1827,10 @@ static int module_adapter_get_set_params(struct comp_dev *dev, struct sof_ipc_ct
 	 * The type member in struct sof_abi_hdr is used for component's specific blob type
 	 * for IPC3, just like it is used for component's specific blob param_id for IPC4.
 	 */
+	/* process() reevaluates the bypass with the new configuration */
+	if (set)
+		mod->bypass = false;
+
 	if (set && md->ops->set_configuration)
 		return md->ops->set_configuration(mod, cdata->data[0].type, pos, data_offset_size,
 						  (const uint8_t *)cdata, cdata->num_elems,
@@ -1349,6 +1899,7 @@ int module_adapter_cmd(struct comp_dev *dev, int cmd, void *data, int max_data_s
 		 * anyway. Also, pass the 0 as the fragment size as it is not relevant for the
 		 * SET_VALUE command.
 		 */
+		mod->bypass = false;
 		if (md->ops->set_configuration)
 			ret = md->ops->set_configuration(mod, 0, MODULE_CFG_FRAGMENT_SINGLE, 0,
 							  (const uint8_t *)cdata, 0, NULL, 0);
@@ -1413,10 +1964,12 @@ int module_adapter_reset(struct comp_dev *dev)
 	}
 
 	if (IS_PROCESSING_MODE_RAW_DATA(mod)) {
-		for (i = 0; i < mod->num_of_sinks; i++)
+		/* in place output buffer is the input buffer, freed below */
+		for (i = 0; i < mod->num_of_sinks && !mod->raw_data_in_place; i++)
 			rfree((__sparse_force void *)mod->output_buffers[i].data);
 		for (i = 0; i < mod->num_of_sources; i++)
 			rfree((__sparse_force void *)mod->input_buffers[i].data);
+		mod->raw_data_in_place = false;
 	}
 
 	if (IS_PROCESSING_MODE_RAW_DATA(mod) || IS_PROCESSING_MODE_AUDIO_STREAM(mod)) {
@@ -1426,27 +1979,20 @@ int module_adapter_reset(struct comp_dev *dev)
 		mod->num_of_sources = 0;
 		mod->num_of_sinks = 0;
 	}
+
+	mod->bypass = false;
+#if CONFIG_MODULE_SILENCE_SKIP
+	mod->silence_tail_frames = 0;
+	mod->silent_frames = 0;
+#endif
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+	module_adapter_task_budget_remove(dev);
+#endif
 #if CONFIG_ZEPHYR_DP_SCHEDULER
+	/* for DP processing - free DP Queues */
 	if (IS_PROCESSING_MODE_SINK_SOURCE(mod) &&
-	    mod->dev->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_DP) {
-		/* for DP processing - free DP Queues */
-		struct list_item *dp_queue_list_item;
-		struct list_item *tmp;
-
-		list_for_item_safe(dp_queue_list_item, tmp, &mod->dp_queue_dp_to_ll_list) {
-			struct dp_queue *dp_queue =
-					container_of(dp_queue_list_item, struct dp_queue, list);
-
-			/* dp free will also remove the queue from a list */
-			dp_queue_free(dp_queue);
-		}
-		list_for_item_safe(dp_queue_list_item, tmp, &mod->dp_queue_ll_to_dp_list) {
-			struct dp_queue *dp_queue =
-					container_of(dp_queue_list_item, struct dp_queue, list);
-
-			dp_queue_free(dp_queue);
-		}
-	}
+	    mod->dev->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_DP)
+		module_adapter_dp_queues_free(dev);
 #endif /* CONFIG_ZEPHYR_DP_SCHEDULER */
 	if (IS_PROCESSING_MODE_SINK_SOURCE(mod)) {
 		/* for both LL and DP processing */
@@ -1483,10 +2029,18 @@ void module_adapter_free(struct comp_dev *dev)
 
 	comp_dbg(dev, "module_adapter_free(): start");
 
+#if CONFIG_IPC4_ASYNC_INIT
+	ipc4_async_init_cancel(dev);
+#endif
+
 	ret = module_free(mod);
 	if (ret)
 		comp_err(dev, "module_adapter_free(): failed with error: %d", ret);
 
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+	perf_data_item_comp_unregister(mod->perf_data);
+#endif
+
 	list_for_item_safe(blist, _blist, &mod->sink_buffer_list) {
 		struct comp_buffer *buffer = container_of(blist, struct comp_buffer,
 							  sink_list);
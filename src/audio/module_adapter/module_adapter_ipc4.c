@@ -106,6 +106,9 @@ int module_set_large_config(struct comp_dev *dev, uint32_t param_id, bool first_
 		return -EINVAL;
 	}
 
+	/* process() reevaluates the bypass with the new configuration */
+	mod->bypass = false;
+
 	if (md->ops->set_configuration)
 		return md->ops->set_configuration(mod, param_id, pos, data_offset_size,
 						  (const uint8_t *)data,
@@ -140,7 +140,7 @@ static int multiband_drc_init_coef(struct processing_module *mod, int16_t nch, u
 	crossover = config->crossover_coef;
 	for (ch = 0; ch < nch; ch++) {
 		ret = crossover_init_coef_ch(crossover, &state->crossover[ch],
-					     config->num_bands);
+					     config->num_bands, SOF_CROSSOVER_LAYOUT_BIQUAD);
 		/* Free all previously allocated blocks in case of an error */
 		if (ret < 0) {
 			comp_err(dev,
@@ -194,6 +194,10 @@ static int multiband_drc_init_coef(struct processing_module *mod, int16_t nch, u
 			comp_err(dev, "multiband_drc_init_coef(), could not set pre delay time");
 			goto err;
 		}
+
+#if CONFIG_DRC_GAIN_CURVE_TABLE
+		drc_init_gain_table(&state->drc[i], &cd->config->drc_coef[i]);
+#endif
 	}
 
 	return 0;
@@ -269,6 +273,9 @@ static int multiband_drc_init(struct processing_module *mod)
 		goto cd_fail;
 	}
 
+	/* identical configurations of other instances use the same blob */
+	comp_data_blob_set_shared(cd->model_handler);
+
 	/* Get configuration data and reset DRC state */
 	ret = comp_init_data_blob(cd->model_handler, bs, cfg->data);
 	if (ret < 0) {
@@ -18,6 +18,8 @@ static void multiband_drc_default_pass(const struct processing_module *mod,
 	audio_stream_copy(source, 0, sink, 0, audio_stream_get_channels(source) * frames);
 }
 
+#if DRC_GENERIC
+
 static void multiband_drc_process_emp_crossover(struct multiband_drc_state *state,
 						crossover_split split_func,
 						int32_t *buf_src,
@@ -42,7 +44,7 @@ static void multiband_drc_process_emp_crossover(struct multiband_drc_state *stat
 		else
 			emp_out = *buf_src;
 
-		split_func(emp_out, crossover_out, crossover_s);
+		split_func(emp_out, crossover_out, crossover_s, CROSSOVER_ALL_OUTPUTS);
 		buf_sink_band = buf_sink;
 		for (band = 0; band < nband; band++) {
 			*buf_sink_band = crossover_out[band];
@@ -76,12 +78,14 @@ static void multiband_drc_s16_process_drc(struct drc_state *state,
 	pd_write_index = state->pre_delay_write_index;
 	pd_read_index = state->pre_delay_read_index;
 
+	pd_write = (int16_t *)state->pre_delay_buffer + pd_write_index * nch;
+	pd_read = (int16_t *)state->pre_delay_buffer + pd_read_index * nch;
 	for (ch = 0; ch < nch; ++ch) {
-		pd_write = (int16_t *)state->pre_delay_buffers[ch] + pd_write_index;
-		pd_read = (int16_t *)state->pre_delay_buffers[ch] + pd_read_index;
 		*pd_write = sat_int16(Q_SHIFT_RND(*buf_src, 31, 15));
 		*buf_sink = *pd_read << 16;
 
+		pd_write++;
+		pd_read++;
 		buf_src++;
 		buf_sink++;
 	}
@@ -126,12 +130,14 @@ static void multiband_drc_s32_process_drc(struct drc_state *state,
 	pd_write_index = state->pre_delay_write_index;
 	pd_read_index = state->pre_delay_read_index;
 
+	pd_write = (int32_t *)state->pre_delay_buffer + pd_write_index * nch;
+	pd_read = (int32_t *)state->pre_delay_buffer + pd_read_index * nch;
 	for (ch = 0; ch < nch; ++ch) {
-		pd_write = (int32_t *)state->pre_delay_buffers[ch] + pd_write_index;
-		pd_read = (int32_t *)state->pre_delay_buffers[ch] + pd_read_index;
 		*pd_write = *buf_src;
 		*buf_sink = *pd_read;
 
+		pd_write++;
+		pd_read++;
 		buf_src++;
 		buf_sink++;
 	}
@@ -417,6 +423,10 @@ const struct multiband_drc_proc_fnmap multiband_drc_proc_fnmap[] = {
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
+const size_t multiband_drc_proc_fncount = ARRAY_SIZE(multiband_drc_proc_fnmap);
+
+#endif /* DRC_GENERIC */
+
 const struct multiband_drc_proc_fnmap multiband_drc_proc_fnmap_pass[] = {
 /* { SOURCE_FORMAT , PROCESSING FUNCTION } */
 #if CONFIG_FORMAT_S16LE
@@ -431,5 +441,3 @@ const struct multiband_drc_proc_fnmap multiband_drc_proc_fnmap_pass[] = {
 	{ SOF_IPC_FRAME_S32_LE, multiband_drc_default_pass },
 #endif /* CONFIG_FORMAT_S32LE */
 };
-
-const size_t multiband_drc_proc_fncount = ARRAY_SIZE(multiband_drc_proc_fnmap);
@@ -0,0 +1,328 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <stdint.h>
+#include <sof/common.h>
+#include <sof/audio/drc/drc_algorithm.h>
+#include <sof/audio/format.h>
+#include <sof/audio/multiband_drc/multiband_drc.h>
+#include <sof/math/iir_df2t.h>
+
+#if DRC_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/*
+ * The generic version runs the stages of multiband_drc_generic.c one after
+ * another for all channels and bands of a frame. Here one pass over the
+ * channels of a frame does emphasis, crossover split and the DRC pre-delay
+ * of all bands. The bands are then summed for channel pairs and the DRC
+ * divisions of the bands are processed last. The DRC state of a band only
+ * depends on the samples of that band, so the result is the same.
+ */
+
+/* Band outputs of one frame, channels of a band are adjacent for the sum */
+struct multiband_drc_hifi3_frame {
+	int32_t band[SOF_MULTIBAND_DRC_MAX_BANDS][ALIGN_UP_COMPILE(PLATFORM_MAX_CHANNELS, 2)]
+		__aligned(8);
+};
+
+static void multiband_drc_hifi3_drc_prepare(struct multiband_drc_comp_data *cd,
+					    int nbyte, int nch)
+{
+	struct drc_state *state;
+	const struct sof_drc_params *p;
+	int band;
+
+	for (band = 0; band < cd->config->num_bands; band++) {
+		state = &cd->state.drc[band];
+		p = &cd->config->drc_coef[band];
+		if (p->enabled && !state->processed) {
+			drc_update_envelope(state, p);
+			drc_compress_output(state, p, nbyte, nch);
+			state->processed = 1;
+		}
+	}
+}
+
+static void multiband_drc_hifi3_drc_advance(struct multiband_drc_comp_data *cd,
+					    int nbyte, int nch)
+{
+	struct drc_state *state;
+	const struct sof_drc_params *p;
+	int band;
+
+	for (band = 0; band < cd->config->num_bands; band++) {
+		state = &cd->state.drc[band];
+		p = &cd->config->drc_coef[band];
+		state->pre_delay_write_index = (state->pre_delay_write_index + 1) &
+			DRC_MAX_PRE_DELAY_FRAMES_MASK;
+		state->pre_delay_read_index = (state->pre_delay_read_index + 1) &
+			DRC_MAX_PRE_DELAY_FRAMES_MASK;
+
+		/* Process the input division (32 frames). */
+		if (p->enabled && !(state->pre_delay_write_index & DRC_DIVISION_FRAMES_MASK)) {
+			drc_update_detector_average(state, p, nbyte, nch);
+			drc_update_envelope(state, p);
+			drc_compress_output(state, p, nbyte, nch);
+		}
+	}
+}
+
+/* Sum of the bands and deemphasis, buf gets the output of the frame */
+static void multiband_drc_hifi3_mix_deemp(struct multiband_drc_comp_data *cd,
+					  struct multiband_drc_hifi3_frame *frame,
+					  int32_t *buf, int nch)
+{
+	ae_f32x2 mix;
+	ae_f32x2 *in;
+	int nband = cd->config->num_bands;
+	int band;
+	int ch;
+
+	for (ch = 0; ch < nch; ch += 2) {
+		mix = AE_ZERO32();
+		for (band = 0; band < nband; band++) {
+			in = (ae_f32x2 *)&frame->band[band][ch];
+			mix = AE_ADD32S(mix, *in);
+		}
+
+		buf[ch] = AE_MOVAD32_H(mix);
+		if (ch + 1 < nch)
+			buf[ch + 1] = AE_MOVAD32_L(mix);
+	}
+
+	if (!cd->config->enable_emp_deemp)
+		return;
+
+	for (ch = 0; ch < nch; ch++)
+		buf[ch] = iir_df2t(&cd->state.deemphasis[ch], buf[ch]);
+}
+
+#if CONFIG_FORMAT_S16LE
+/* One frame through all stages, buf has Q1.31 input and gets the output */
+static void multiband_drc_hifi3_frame_s16(struct multiband_drc_comp_data *cd,
+					  struct multiband_drc_hifi3_frame *frame,
+					  int32_t *buf, int nch)
+{
+	struct multiband_drc_state *state = &cd->state;
+	int32_t crossover_out[SOF_MULTIBAND_DRC_MAX_BANDS];
+	int16_t *pd;
+	int32_t x;
+	int nband = cd->config->num_bands;
+	int band;
+	int ch;
+
+	multiband_drc_hifi3_drc_prepare(cd, 2, nch);
+	for (ch = 0; ch < nch; ch++) {
+		x = buf[ch];
+		if (cd->config->enable_emp_deemp)
+			x = iir_df2t(&state->emphasis[ch], x);
+
+		cd->crossover_split(x, crossover_out, &state->crossover[ch],
+				    CROSSOVER_ALL_OUTPUTS);
+		for (band = 0; band < nband; band++) {
+			pd = (int16_t *)state->drc[band].pre_delay_buffer + ch;
+			pd[state->drc[band].pre_delay_write_index * nch] =
+				sat_int16(Q_SHIFT_RND(crossover_out[band], 31, 15));
+			frame->band[band][ch] = pd[state->drc[band].pre_delay_read_index * nch] << 16;
+		}
+	}
+
+	multiband_drc_hifi3_mix_deemp(cd, frame, buf, nch);
+	multiband_drc_hifi3_drc_advance(cd, 2, nch);
+}
+
+static void multiband_drc_s16_default(const struct processing_module *mod,
+				      const struct audio_stream *source,
+				      struct audio_stream *sink,
+				      uint32_t frames)
+{
+	struct multiband_drc_comp_data *cd = module_get_private_data(mod);
+	struct multiband_drc_hifi3_frame frame;
+	int32_t buf[PLATFORM_MAX_CHANNELS];
+	int16_t *x = audio_stream_get_rptr(source);
+	int16_t *y = audio_stream_get_wptr(sink);
+	int nbuf;
+	int npcm;
+	int ch;
+	int i;
+	int nch = audio_stream_get_channels(source);
+	int samples = frames * nch;
+
+	/* The unused lane of an odd channels count is summed too */
+	if (nch & 1) {
+		for (i = 0; i < SOF_MULTIBAND_DRC_MAX_BANDS; i++)
+			frame.band[i][nch] = 0;
+	}
+
+	while (samples) {
+		nbuf = audio_stream_samples_without_wrap_s16(source, x);
+		npcm = MIN(samples, nbuf);
+		nbuf = audio_stream_samples_without_wrap_s16(sink, y);
+		npcm = MIN(npcm, nbuf);
+		for (i = 0; i < npcm; i += nch) {
+			for (ch = 0; ch < nch; ch++)
+				buf[ch] = x[ch] << 16;
+
+			multiband_drc_hifi3_frame_s16(cd, &frame, buf, nch);
+			for (ch = 0; ch < nch; ch++)
+				y[ch] = sat_int16(Q_SHIFT_RND(buf[ch], 31, 15));
+
+			x += nch;
+			y += nch;
+		}
+		samples -= npcm;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+/* One frame through all stages, buf has Q1.31 input and gets the output */
+static void multiband_drc_hifi3_frame_s32(struct multiband_drc_comp_data *cd,
+					  struct multiband_drc_hifi3_frame *frame,
+					  int32_t *buf, int nch)
+{
+	struct multiband_drc_state *state = &cd->state;
+	int32_t crossover_out[SOF_MULTIBAND_DRC_MAX_BANDS];
+	int32_t *pd;
+	int32_t x;
+	int nband = cd->config->num_bands;
+	int band;
+	int ch;
+
+	multiband_drc_hifi3_drc_prepare(cd, 4, nch);
+	for (ch = 0; ch < nch; ch++) {
+		x = buf[ch];
+		if (cd->config->enable_emp_deemp)
+			x = iir_df2t(&state->emphasis[ch], x);
+
+		cd->crossover_split(x, crossover_out, &state->crossover[ch],
+				    CROSSOVER_ALL_OUTPUTS);
+		for (band = 0; band < nband; band++) {
+			pd = (int32_t *)state->drc[band].pre_delay_buffer + ch;
+			pd[state->drc[band].pre_delay_write_index * nch] = crossover_out[band];
+			frame->band[band][ch] = pd[state->drc[band].pre_delay_read_index * nch];
+		}
+	}
+
+	multiband_drc_hifi3_mix_deemp(cd, frame, buf, nch);
+	multiband_drc_hifi3_drc_advance(cd, 4, nch);
+}
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+
+#if CONFIG_FORMAT_S24LE
+static void multiband_drc_s24_default(const struct processing_module *mod,
+				      const struct audio_stream *source,
+				      struct audio_stream *sink,
+				      uint32_t frames)
+{
+	struct multiband_drc_comp_data *cd = module_get_private_data(mod);
+	struct multiband_drc_hifi3_frame frame;
+	int32_t buf[PLATFORM_MAX_CHANNELS];
+	int32_t *x = audio_stream_get_rptr(source);
+	int32_t *y = audio_stream_get_wptr(sink);
+	int nbuf;
+	int npcm;
+	int ch;
+	int i;
+	int nch = audio_stream_get_channels(source);
+	int samples = frames * nch;
+
+	/* The unused lane of an odd channels count is summed too */
+	if (nch & 1) {
+		for (i = 0; i < SOF_MULTIBAND_DRC_MAX_BANDS; i++)
+			frame.band[i][nch] = 0;
+	}
+
+	while (samples) {
+		nbuf = audio_stream_samples_without_wrap_s24(source, x);
+		npcm = MIN(samples, nbuf);
+		nbuf = audio_stream_samples_without_wrap_s24(sink, y);
+		npcm = MIN(npcm, nbuf);
+		for (i = 0; i < npcm; i += nch) {
+			for (ch = 0; ch < nch; ch++)
+				buf[ch] = x[ch] << 8;
+
+			multiband_drc_hifi3_frame_s32(cd, &frame, buf, nch);
+			for (ch = 0; ch < nch; ch++)
+				y[ch] = sat_int24(Q_SHIFT_RND(buf[ch], 31, 23));
+
+			x += nch;
+			y += nch;
+		}
+		samples -= npcm;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void multiband_drc_s32_default(const struct processing_module *mod,
+				      const struct audio_stream *source,
+				      struct audio_stream *sink,
+				      uint32_t frames)
+{
+	struct multiband_drc_comp_data *cd = module_get_private_data(mod);
+	struct multiband_drc_hifi3_frame frame;
+	int32_t *x = audio_stream_get_rptr(source);
+	int32_t *y = audio_stream_get_wptr(sink);
+	int32_t buf[PLATFORM_MAX_CHANNELS];
+	int nbuf;
+	int npcm;
+	int ch;
+	int i;
+	int nch = audio_stream_get_channels(source);
+	int samples = frames * nch;
+
+	/* The unused lane of an odd channels count is summed too */
+	if (nch & 1) {
+		for (i = 0; i < SOF_MULTIBAND_DRC_MAX_BANDS; i++)
+			frame.band[i][nch] = 0;
+	}
+
+	while (samples) {
+		nbuf = audio_stream_samples_without_wrap_s32(source, x);
+		npcm = MIN(samples, nbuf);
+		nbuf = audio_stream_samples_without_wrap_s32(sink, y);
+		npcm = MIN(npcm, nbuf);
+		for (i = 0; i < npcm; i += nch) {
+			for (ch = 0; ch < nch; ch++)
+				buf[ch] = x[ch];
+
+			multiband_drc_hifi3_frame_s32(cd, &frame, buf, nch);
+			for (ch = 0; ch < nch; ch++)
+				y[ch] = buf[ch];
+
+			x += nch;
+			y += nch;
+		}
+		samples -= npcm;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+const struct multiband_drc_proc_fnmap multiband_drc_proc_fnmap[] = {
+/* { SOURCE_FORMAT , PROCESSING FUNCTION } */
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, multiband_drc_s16_default },
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, multiband_drc_s24_default },
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, multiband_drc_s32_default },
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+const size_t multiband_drc_proc_fncount = ARRAY_SIZE(multiband_drc_proc_fnmap);
+
+#endif /* DRC_HIFI3 */
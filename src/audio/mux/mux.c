@@ -355,66 +355,20 @@ static int get_stream_index(struct comp_dev *dev, struct comp_data *cd, uint32_t
 	return -EINVAL;
 }
 
-static struct mux_look_up *get_lookup_table(struct comp_dev *dev, struct comp_data *cd,
-					    uint32_t pipe_id)
+static struct chmap_remap *get_remap(struct comp_dev *dev, struct comp_data *cd,
+				     uint32_t pipe_id)
 {
 	int i;
 
 	for (i = 0; i < MUX_MAX_STREAMS; i++)
 		if (cd->config.streams[i].pipeline_id == pipe_id)
-			return &cd->lookup[i];
+			return &cd->remap[i];
 
-	comp_err(dev, "get_lookup_table(): couldn't find configuration for connected pipeline %u",
+	comp_err(dev, "get_remap(): couldn't find configuration for connected pipeline %u",
 		 pipe_id);
 	return 0;
 }
 
-static void mux_prepare_active_look_up(struct comp_data *cd,
-				       struct audio_stream *sink,
-				       const struct audio_stream **sources)
-{
-	const struct audio_stream *source;
-	int elem;
-	int active_elem = 0;
-
-	/* init pointers */
-	for (elem = 0; elem < cd->lookup[0].num_elems; elem++) {
-		source = sources[cd->lookup[0].copy_elem[elem].stream_id];
-		if (!source)
-			continue;
-
-		if (cd->lookup[0].copy_elem[elem].in_ch >= audio_stream_get_channels(source) ||
-		    cd->lookup[0].copy_elem[elem].out_ch >= audio_stream_get_channels(sink))
-			continue;
-
-		cd->active_lookup.copy_elem[active_elem] = cd->lookup[0].copy_elem[elem];
-		active_elem++;
-	}
-
-	cd->active_lookup.num_elems = active_elem;
-}
-
-static void demux_prepare_active_look_up(struct comp_data *cd,
-					 struct audio_stream *sink,
-					 const struct audio_stream *source,
-					 struct mux_look_up *look_up)
-{
-	int elem;
-	int active_elem = 0;
-
-	/* init pointers */
-	for (elem = 0; elem < look_up->num_elems; elem++) {
-		if (look_up->copy_elem[elem].in_ch >= audio_stream_get_channels(source) ||
-		    look_up->copy_elem[elem].out_ch >= audio_stream_get_channels(sink))
-			continue;
-
-		cd->active_lookup.copy_elem[active_elem] = look_up->copy_elem[elem];
-		active_elem++;
-	}
-
-	cd->active_lookup.num_elems = active_elem;
-}
-
 /* process and copy stream data from source to sink buffers */
 static int demux_process(struct processing_module *mod,
 			 struct input_stream_buffer *input_buffers, int num_input_buffers,
@@ -425,7 +379,7 @@ static int demux_process(struct processing_module *mod,
 	struct list_item *clist;
 	struct comp_buffer *sink;
 	struct audio_stream *sinks_stream[MUX_MAX_STREAMS] = { NULL };
-	struct mux_look_up *look_ups[MUX_MAX_STREAMS] = { NULL };
+	struct chmap_remap *remaps[MUX_MAX_STREAMS] = { NULL };
 	int frames;
 	int sink_bytes;
 	int source_bytes;
@@ -443,7 +397,7 @@ static int demux_process(struct processing_module *mod,
 				return i;
 			}
 
-			look_ups[i] = get_lookup_table(dev, cd, sink->pipeline_id);
+			remaps[i] = get_remap(dev, cd, sink->pipeline_id);
 			sinks_stream[i] = &sink->stream;
 		}
 	}
@@ -458,9 +412,7 @@ static int demux_process(struct processing_module *mod,
 
 	/* produce output, one sink at a time */
 	for (i = 0; i < num_output_buffers; i++) {
-		demux_prepare_active_look_up(cd, sinks_stream[i],
-					     input_buffers[0].data, look_ups[i]);
-		cd->demux(dev, sinks_stream[i], input_buffers[0].data, frames, &cd->active_lookup);
+		cd->demux(dev, sinks_stream[i], input_buffers[0].data, frames, remaps[i]);
 		mod->output_buffers[i].size = sink_bytes;
 	}
 
@@ -513,10 +465,9 @@ static int mux_process(struct processing_module *mod,
 
 	source_bytes = frames * audio_stream_frame_bytes(mod->input_buffers[0].data);
 	sink_bytes = frames * audio_stream_frame_bytes(mod->output_buffers[0].data);
-	mux_prepare_active_look_up(cd, output_buffers[0].data, &sources_stream[0]);
 
 	/* produce output */
-	cd->mux(dev, output_buffers[0].data, &sources_stream[0], frames, &cd->active_lookup);
+	cd->mux(dev, output_buffers[0].data, &sources_stream[0], frames, cd->remap);
 
 	/* Update consumed and produced */
 	j = 0;
@@ -19,452 +19,77 @@
 
 LOG_MODULE_DECLARE(muxdemux, CONFIG_SOF_LOG_LEVEL);
 
-static void mux_check_for_wrap(struct audio_stream *sink,
-			       const struct audio_stream **sources,
-			       struct mux_look_up *lookup)
-{
-	const struct audio_stream *source;
-	uint32_t elem;
-
-	/* check sources and destinations for wrap */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		source = sources[lookup->copy_elem[elem].stream_id];
-		lookup->copy_elem[elem].dest =
-			audio_stream_wrap(sink, lookup->copy_elem[elem].dest);
-		lookup->copy_elem[elem].src =
-			audio_stream_wrap(source, lookup->copy_elem[elem].src);
-	}
-}
-
-static void demux_check_for_wrap(struct audio_stream *sink,
-				 const struct audio_stream *source,
-				 struct mux_look_up *lookup)
-{
-	uint32_t elem;
-
-	/* check sources and destinations for wrap */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		lookup->copy_elem[elem].dest =
-			audio_stream_wrap(sink, lookup->copy_elem[elem].dest);
-		lookup->copy_elem[elem].src =
-			audio_stream_wrap(source, lookup->copy_elem[elem].src);
-	}
-}
-
-#if CONFIG_FORMAT_S16LE
-
-static uint32_t demux_calc_frames_without_wrap_s16(struct audio_stream *sink,
-						   const struct audio_stream *source,
-						   struct mux_look_up *lookup)
-{
-	uint32_t frames;
-	uint32_t min_frames;
-	void *ptr;
-
-	/* for demux we process each source buffer separately - dest/src for
-	 * each copy_elem refers to the same sink/source buffer, so min_frames
-	 * calculation based only on lookup table first element is sufficient.
-	 */
-	ptr = (int16_t *)lookup->copy_elem[0].dest -
-		lookup->copy_elem[0].out_ch;
-	min_frames = audio_stream_frames_without_wrap(sink, ptr);
-
-	ptr = (int16_t *)lookup->copy_elem[0].src -
-		lookup->copy_elem[0].in_ch;
-	frames = audio_stream_frames_without_wrap(source, ptr);
-
-	min_frames = (frames < min_frames) ? frames : min_frames;
-
-	return min_frames;
-}
-
-static uint32_t mux_calc_frames_without_wrap_s16(struct audio_stream *sink,
-						 const struct audio_stream **sources,
-						 struct mux_look_up *lookup)
-{
-	const struct audio_stream *source;
-	uint32_t frames;
-	uint32_t min_frames;
-	uint32_t elem;
-	void *ptr;
-
-	/* dest pointer for all copy_elems in lookup refers to the same
-	 * sink buffer (mux has one sink buffer), so dest min_frames
-	 * calculation based only on lookup table first element is sufficient.
-	 */
-	ptr = (int16_t *)lookup->copy_elem[0].dest -
-		lookup->copy_elem[0].out_ch;
-	min_frames = audio_stream_frames_without_wrap(sink, ptr);
-
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		source = sources[lookup->copy_elem[elem].stream_id];
-
-		ptr = (int16_t *)lookup->copy_elem[elem].src -
-			lookup->copy_elem[elem].in_ch;
-		frames = audio_stream_frames_without_wrap(source, ptr);
-
-		min_frames = (frames < min_frames) ? frames : min_frames;
-	}
-
-	return min_frames;
-}
-
-static void mux_init_look_up_pointers_s16(struct audio_stream *sink,
-					  const struct audio_stream **sources,
-					  struct mux_look_up *lookup)
-{
-	const struct audio_stream *source;
-	uint32_t elem;
-
-	/* init pointers */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		source = sources[lookup->copy_elem[elem].stream_id];
-
-		lookup->copy_elem[elem].src = (int16_t *)audio_stream_get_rptr(source) +
-			lookup->copy_elem[elem].in_ch;
-		lookup->copy_elem[elem].src_inc = audio_stream_get_channels(source);
-
-		lookup->copy_elem[elem].dest = (int16_t *)audio_stream_get_wptr(sink) +
-			lookup->copy_elem[elem].out_ch;
-		lookup->copy_elem[elem].dest_inc = audio_stream_get_channels(sink);
-	}
-}
-
-static void demux_init_look_up_pointers_s16(struct audio_stream *sink,
-					    const struct audio_stream *source,
-					    struct mux_look_up *lookup)
-{
-	uint32_t elem;
-
-	/* init pointers */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		lookup->copy_elem[elem].src = (int16_t *)audio_stream_get_rptr(source) +
-			lookup->copy_elem[elem].in_ch;
-		lookup->copy_elem[elem].src_inc = audio_stream_get_channels(source);
-
-		lookup->copy_elem[elem].dest = (int16_t *)audio_stream_get_wptr(sink) +
-			lookup->copy_elem[elem].out_ch;
-		lookup->copy_elem[elem].dest_inc = audio_stream_get_channels(sink);
-	}
-}
-
 /**
- * Source stream are routed to sinks with regard to look up table based on
- * routing bitmasks from mux_stream_data structures array. Each sink channel
- * has it's own lookup[].copy_elem describing source and sink fragment of
- * memory featured in copying.
+ * Source streams are routed to the sink with their compiled channel remaps.
+ * The remap of each source writes the sink channels it is routed to.
  *
  * @param[in] dev Component device
  * @param[in,out] sink Destination buffer.
  * @param[in,out] sources Array of source buffers.
  * @param[in] frames Number of frames to process.
- * @param[in] lookup mux look up table.
+ * @param[in] remaps Channel remaps of the source streams.
  */
-static void demux_s16le(struct comp_dev *dev, struct audio_stream *sink,
-			const struct audio_stream *source, uint32_t frames,
-			struct mux_look_up *lookup)
-{
-	uint32_t i;
-	int16_t *src;
-	int16_t *dst;
-	uint32_t elem;
-	uint32_t frames_without_wrap;
-
-	comp_dbg(dev, "demux_s16le()");
-
-	if (!lookup || !lookup->num_elems)
-		return;
-
-	demux_init_look_up_pointers_s16(sink, source, lookup);
-
-	while (frames) {
-		frames_without_wrap =
-			demux_calc_frames_without_wrap_s16(sink, source, lookup);
-
-		frames_without_wrap = MIN(frames, frames_without_wrap);
-
-		for (i = 0; i < frames_without_wrap; i++) {
-			for (elem = 0; elem < lookup->num_elems; elem++) {
-				src = (int16_t *)lookup->copy_elem[elem].src;
-				dst = (int16_t *)lookup->copy_elem[elem].dest;
-				*dst = *src;
-				lookup->copy_elem[elem].src = src +
-					lookup->copy_elem[elem].src_inc;
-				lookup->copy_elem[elem].dest = dst +
-					lookup->copy_elem[elem].dest_inc;
-			}
-		}
-
-		demux_check_for_wrap(sink, source, lookup);
-
-		frames -= frames_without_wrap;
-	}
-}
-
-/**
- * Source streams are routed to sink with regard to look up table based on
- * routing bitmasks from mux_stream_data structures array. Each sink channel
- * has it's own lookup[].copy_elem describing source and sink fragment of
- * memory featured in copying.
- *
- * @param[in] dev Component device
- * @param[in,out] sink Destination buffer.
- * @param[in,out] sources Array of source buffers.
- * @param[in] frames Number of frames to process.
- * @param[in] lookup mux look up table.
- */
-static void mux_s16le(struct comp_dev *dev, struct audio_stream *sink,
+static void mux_remap(struct comp_dev *dev, struct audio_stream *sink,
 		      const struct audio_stream **sources, uint32_t frames,
-		      struct mux_look_up *lookup)
-{
-	uint32_t i;
-	int16_t *src;
-	int16_t *dst;
-	uint32_t elem;
-	uint32_t frames_without_wrap;
-
-	comp_dbg(dev, "mux_s16le()");
-
-	if (!lookup || !lookup->num_elems)
-		return;
-
-	mux_init_look_up_pointers_s16(sink, sources, lookup);
-
-	while (frames) {
-		frames_without_wrap =
-			mux_calc_frames_without_wrap_s16(sink, sources, lookup);
-
-		frames_without_wrap = MIN(frames, frames_without_wrap);
-
-		for (i = 0; i < frames_without_wrap; i++) {
-			for (elem = 0; elem < lookup->num_elems; elem++) {
-				src = (int16_t *)lookup->copy_elem[elem].src;
-				dst = (int16_t *)lookup->copy_elem[elem].dest;
-				*dst = *src;
-				lookup->copy_elem[elem].src = src +
-					lookup->copy_elem[elem].src_inc;
-				lookup->copy_elem[elem].dest = dst +
-					lookup->copy_elem[elem].dest_inc;
-			}
-		}
-
-		mux_check_for_wrap(sink, sources, lookup);
-
-		frames -= frames_without_wrap;
-	}
-}
-#endif /* CONFIG_FORMAT_S16LE */
-
-#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
-
-static uint32_t mux_calc_frames_without_wrap_s32(struct audio_stream *sink,
-						 const struct audio_stream **sources,
-						 struct mux_look_up *lookup)
+		      struct chmap_remap *remaps)
 {
 	const struct audio_stream *source;
-	uint32_t frames;
-	uint32_t min_frames;
-	uint32_t elem;
-	void *ptr;
+	int i;
 
-	/* dest pointer for all copy_elems in lookup refers to the same
-	 * sink buffer (mux has one sink buffer), so dest min_frames
-	 * calculation based only on lookup table first element is sufficient.
-	 */
-	ptr = (int32_t *)lookup->copy_elem[0].dest - lookup->copy_elem[0].out_ch;
-	min_frames = audio_stream_frames_without_wrap(sink, ptr);
+	comp_dbg(dev, "mux_remap()");
 
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		source = sources[lookup->copy_elem[elem].stream_id];
+	for (i = 0; i < MUX_MAX_STREAMS; i++) {
+		source = sources[i];
+		if (!source)
+			continue;
 
-		ptr = (int32_t *)lookup->copy_elem[elem].src - lookup->copy_elem[elem].in_ch;
-		frames = audio_stream_frames_without_wrap(source, ptr);
+		if (chmap_remap_compile(&remaps[i], audio_stream_get_frm_fmt(source),
+					audio_stream_get_frm_fmt(sink),
+					audio_stream_get_channels(source),
+					audio_stream_get_channels(sink)) < 0)
+			continue;
 
-		min_frames = (frames < min_frames) ? frames : min_frames;
-	}
-
-	return min_frames;
-}
-
-static uint32_t demux_calc_frames_without_wrap_s32(struct audio_stream *sink,
-						   const struct audio_stream *source,
-						   struct mux_look_up *lookup)
-{
-	uint32_t frames;
-	uint32_t min_frames;
-	void *ptr;
-
-	/* for demux we process each source buffer separately - dest/src for
-	 * each copy_elem refers to the same sink/source buffer, so min_frames
-	 * calculation based only on lookup table first element is sufficient.
-	 */
-	ptr = (int32_t *)lookup->copy_elem[0].dest - lookup->copy_elem[0].out_ch;
-	min_frames = audio_stream_frames_without_wrap(sink, ptr);
-
-	ptr = (int32_t *)lookup->copy_elem[0].src - lookup->copy_elem[0].in_ch;
-	frames = audio_stream_frames_without_wrap(source, ptr);
-
-	min_frames = (frames < min_frames) ? frames : min_frames;
-
-	return min_frames;
-}
-
-static void mux_init_look_up_pointers_s32(struct audio_stream *sink,
-					  const struct audio_stream **sources,
-					  struct mux_look_up *lookup)
-{
-	const struct audio_stream *source;
-	uint32_t elem;
-
-	/* init pointers */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		source = sources[lookup->copy_elem[elem].stream_id];
-
-		lookup->copy_elem[elem].src = (int32_t *)audio_stream_get_rptr(source) +
-			lookup->copy_elem[elem].in_ch;
-		lookup->copy_elem[elem].src_inc = audio_stream_get_channels(source);
-
-		lookup->copy_elem[elem].dest = (int32_t *)audio_stream_get_wptr(sink) +
-			lookup->copy_elem[elem].out_ch;
-		lookup->copy_elem[elem].dest_inc = audio_stream_get_channels(sink);
-	}
-}
-
-static void demux_init_look_up_pointers_s32(struct audio_stream *sink,
-					    const struct audio_stream *source,
-					    struct mux_look_up *lookup)
-{
-	uint32_t elem;
-
-	/* init pointers */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		lookup->copy_elem[elem].src = (int32_t *)audio_stream_get_rptr(source) +
-			lookup->copy_elem[elem].in_ch;
-		lookup->copy_elem[elem].src_inc = audio_stream_get_channels(source);
-
-		lookup->copy_elem[elem].dest = (int32_t *)audio_stream_get_wptr(sink) +
-			lookup->copy_elem[elem].out_ch;
-		lookup->copy_elem[elem].dest_inc = audio_stream_get_channels(sink);
+		chmap_remap_process(&remaps[i], source, sink, frames);
 	}
 }
 
 /**
- * Source stream are routed to sinks with regard to look up table based on
- * routing bitmasks from mux_stream_data structures array. Each sink channel
- * has it's own lookup[].copy_elem describing source and sink fragment of
- * memory featured in copying.
+ * The source stream is routed to a sink with the compiled channel remap of
+ * the sink stream.
  *
  * @param[in] dev Component device
  * @param[in,out] sink Destination buffer.
- * @param[in,out] sources Array of source buffers.
+ * @param[in,out] source Source buffer.
  * @param[in] frames Number of frames to process.
- * @param[in] lookup mux look up table.
+ * @param[in] remap Channel remap of the sink stream.
  */
-static void demux_s32le(struct comp_dev *dev, struct audio_stream *sink,
+static void demux_remap(struct comp_dev *dev, struct audio_stream *sink,
 			const struct audio_stream *source, uint32_t frames,
-			struct mux_look_up *lookup)
+			struct chmap_remap *remap)
 {
-	uint32_t i;
-	int32_t *src;
-	int32_t *dst;
-	uint32_t elem;
-	uint32_t frames_without_wrap;
+	comp_dbg(dev, "demux_remap()");
 
-	comp_dbg(dev, "demux_s32le");
-
-	if (!lookup || !lookup->num_elems)
+	if (!remap)
 		return;
 
-	demux_init_look_up_pointers_s32(sink, source, lookup);
-
-	while (frames) {
-		frames_without_wrap =
-			demux_calc_frames_without_wrap_s32(sink, source, lookup);
-
-		frames_without_wrap = MIN(frames, frames_without_wrap);
-
-		for (i = 0; i < frames_without_wrap; i++) {
-			for (elem = 0; elem < lookup->num_elems; elem++) {
-				src = (int32_t *)lookup->copy_elem[elem].src;
-				dst = (int32_t *)lookup->copy_elem[elem].dest;
-				*dst = *src;
-				lookup->copy_elem[elem].src = src +
-					lookup->copy_elem[elem].src_inc;
-				lookup->copy_elem[elem].dest = dst +
-					lookup->copy_elem[elem].dest_inc;
-			}
-		}
-
-		demux_check_for_wrap(sink, source, lookup);
-
-		frames -= frames_without_wrap;
-	}
-}
-
-/**
- * Source streams are routed to sink with regard to look up table based on
- * routing bitmasks from mux_stream_data structures array. Each sink channel
- * has it's own lookup[].copy_elem describing source and sink fragment of
- * memory featured in copying.
- *
- * @param[in] dev Component device
- * @param[in,out] sink Destination buffer.
- * @param[in,out] sources Array of source buffers.
- * @param[in] frames Number of frames to process.
- * @param[in] lookup mux look up table.
- */
-static void mux_s32le(struct comp_dev *dev, struct audio_stream *sink,
-		      const struct audio_stream **sources, uint32_t frames,
-		      struct mux_look_up *lookup)
-{
-	uint32_t i;
-	int32_t *src;
-	int32_t *dst;
-	uint32_t elem;
-	uint32_t frames_without_wrap;
-
-	comp_dbg(dev, "mux_s32le()");
-
-	if (!lookup || !lookup->num_elems)
+	if (chmap_remap_compile(remap, audio_stream_get_frm_fmt(source),
+				audio_stream_get_frm_fmt(sink),
+				audio_stream_get_channels(source),
+				audio_stream_get_channels(sink)) < 0)
 		return;
 
-	mux_init_look_up_pointers_s32(sink, sources, lookup);
-
-	while (frames) {
-		frames_without_wrap =
-			mux_calc_frames_without_wrap_s32(sink, sources, lookup);
-
-		frames_without_wrap = MIN(frames, frames_without_wrap);
-
-		for (i = 0; i < frames_without_wrap; i++) {
-			for (elem = 0; elem < lookup->num_elems; elem++) {
-				src = (int32_t *)lookup->copy_elem[elem].src;
-				dst = (int32_t *)lookup->copy_elem[elem].dest;
-				*dst = *src;
-				lookup->copy_elem[elem].src = src +
-					lookup->copy_elem[elem].src_inc;
-				lookup->copy_elem[elem].dest = dst +
-					lookup->copy_elem[elem].dest_inc;
-			}
-		}
-
-		mux_check_for_wrap(sink, sources, lookup);
-
-		frames -= frames_without_wrap;
-	}
+	chmap_remap_process(remap, source, sink, frames);
 }
 
-#endif /* CONFIG_FORMAT_S24LE CONFIG_FORMAT_S32LE */
-
 const struct comp_func_map mux_func_map[] = {
 #if CONFIG_FORMAT_S16LE
-	{ SOF_IPC_FRAME_S16_LE, &mux_s16le, &demux_s16le },
+	{ SOF_IPC_FRAME_S16_LE, &mux_remap, &demux_remap },
 #endif
 #if CONFIG_FORMAT_S24LE
-	{ SOF_IPC_FRAME_S24_4LE, &mux_s32le, &demux_s32le },
+	{ SOF_IPC_FRAME_S24_4LE, &mux_remap, &demux_remap },
 #endif
 #if CONFIG_FORMAT_S32LE
-	{ SOF_IPC_FRAME_S32_LE, &mux_s32le, &demux_s32le },
+	{ SOF_IPC_FRAME_S32_LE, &mux_remap, &demux_remap },
 #endif
 };
 
@@ -474,21 +99,17 @@ void mux_prepare_look_up_table(struct processing_module *mod)
 	uint32_t i;
 	uint32_t j;
 	uint32_t k;
-	uint32_t idx = 0;
-
-	/* Prepare look up table */
-	for (i = 0; i < cd->config.num_streams; i++) {
-		for (j = 0; j < PLATFORM_MAX_CHANNELS; j++) {
-			for (k = 0; k < PLATFORM_MAX_CHANNELS; k++) {
-				if (cd->config.streams[i].mask[j] & BIT(k)) {
-					/* MUX component has only one sink */
-					cd->lookup[0].copy_elem[idx].in_ch = j;
-					cd->lookup[0].copy_elem[idx].out_ch = k;
-					cd->lookup[0].copy_elem[idx].stream_id = i;
-					cd->lookup[0].num_elems = ++idx;
-				}
-			}
-		}
+
+	/* Prepare the routes of each source stream to the only sink */
+	for (i = 0; i < MUX_MAX_STREAMS; i++) {
+		chmap_remap_reset(&cd->remap[i]);
+		if (i >= cd->config.num_streams)
+			continue;
+
+		for (j = 0; j < PLATFORM_MAX_CHANNELS; j++)
+			for (k = 0; k < PLATFORM_MAX_CHANNELS; k++)
+				if (cd->config.streams[i].mask[j] & BIT(k))
+					chmap_remap_route(&cd->remap[i], j, k);
 	}
 }
 
@@ -498,22 +119,17 @@ void demux_prepare_look_up_table(struct processing_module *mod)
 	uint32_t i;
 	uint32_t j;
 	uint32_t k;
-	uint32_t idx;
-
-	/* Prepare look up table */
-	for (i = 0; i < cd->config.num_streams; i++) {
-		idx = 0;
-		for (j = 0; j < PLATFORM_MAX_CHANNELS; j++) {
-			for (k = 0; k < PLATFORM_MAX_CHANNELS; k++) {
-				if (cd->config.streams[i].mask[j] & BIT(k)) {
-					/* DEMUX component has only one source */
-					cd->lookup[i].copy_elem[idx].in_ch = k;
-					cd->lookup[i].copy_elem[idx].out_ch = j;
-					cd->lookup[i].copy_elem[idx].stream_id = i;
-					cd->lookup[i].num_elems = ++idx;
-				}
-			}
-		}
+
+	/* Prepare the routes of the only source to each sink stream */
+	for (i = 0; i < MUX_MAX_STREAMS; i++) {
+		chmap_remap_reset(&cd->remap[i]);
+		if (i >= cd->config.num_streams)
+			continue;
+
+		for (j = 0; j < PLATFORM_MAX_CHANNELS; j++)
+			for (k = 0; k < PLATFORM_MAX_CHANNELS; k++)
+				if (cd->config.streams[i].mask[j] & BIT(k))
+					chmap_remap_route(&cd->remap[i], k, j);
 	}
 }
 
@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/**
+ * \file
+ * \brief PCM conversion with fused gain
+ *
+ * The source sample is scaled to Q1.31, multiplied by the Q1.31 gain of its
+ * channel and the Q2.62 product is rounded to the sink sample, so a copier
+ * converts and applies the gain and the attenuation of its endpoint in a
+ * single pass. The gain is at most unity, the product always fits the sink
+ * sample.
+ */
+
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/pcm_converter.h>
+#include <sof/common.h>
+#include <ipc/stream.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static inline int32_t pcm_gain_read(const uint8_t *src, bool in16, uint32_t in_shift)
+{
+	if (in16)
+		return (int32_t)((uint32_t)*(const int16_t *)src << in_shift);
+
+	return (int32_t)(*(const uint32_t *)src << in_shift);
+}
+
+static inline void pcm_gain_write(uint8_t *dst, bool out16, int64_t prod, uint32_t out_shift)
+{
+	int32_t sample = (int32_t)((prod + ((int64_t)1 << (out_shift - 1))) >> out_shift);
+
+	if (out16)
+		*(int16_t *)dst = sample;
+	else
+		*(int32_t *)dst = sample;
+}
+
+static inline int pcm_convert_gain(const struct audio_stream *source,
+				   uint32_t ioffset, struct audio_stream *sink,
+				   uint32_t ooffset, uint32_t samples,
+				   const struct pcm_gain *gain, bool in16, bool out16)
+{
+	const uint32_t in_bytes = in16 ? sizeof(int16_t) : sizeof(int32_t);
+	const uint32_t out_bytes = out16 ? sizeof(int16_t) : sizeof(int32_t);
+	uint8_t *src = (uint8_t *)audio_stream_get_rptr(source) + ioffset * in_bytes;
+	uint8_t *dst = (uint8_t *)audio_stream_get_wptr(sink) + ooffset * out_bytes;
+	uint32_t ramp = gain->ramp_frames;
+	/* the attenuation shifts the product further, 63 leaves only the sign */
+	uint32_t out_shift = MIN(gain->out_shift + gain->attenuation, 63);
+	int32_t g[SOF_IPC_MAX_CHANNELS];
+	uint32_t ch = 0;
+	uint32_t c;
+	int processed;
+	int nmax, i, n;
+
+	for (c = 0; c < gain->channels; c++)
+		g[c] = gain->gain[c];
+
+	for (processed = 0; processed < samples; processed += n) {
+		src = audio_stream_wrap(source, src);
+		dst = audio_stream_wrap(sink, dst);
+		n = samples - processed;
+		nmax = audio_stream_bytes_without_wrap(source, src) / in_bytes;
+		n = MIN(n, nmax);
+		nmax = audio_stream_bytes_without_wrap(sink, dst) / out_bytes;
+		n = MIN(n, nmax);
+		for (i = 0; i < n; i++) {
+			pcm_gain_write(dst, out16,
+				       (int64_t)pcm_gain_read(src, in16, gain->in_shift) * g[ch],
+				       out_shift);
+			src += in_bytes;
+			dst += out_bytes;
+			if (++ch < gain->channels)
+				continue;
+
+			/* the gain moves once per frame, the last frame of the ramp hits the target */
+			ch = 0;
+			if (ramp) {
+				ramp--;
+				for (c = 0; c < gain->channels; c++)
+					g[c] = ramp ? g[c] + gain->step[c] : gain->target[c];
+			}
+		}
+	}
+
+	return samples;
+}
+
+static int pcm_convert_c16_to_c16_gain(const struct audio_stream *source,
+				       uint32_t ioffset, struct audio_stream *sink,
+				       uint32_t ooffset, uint32_t samples,
+				       const struct pcm_gain *gain)
+{
+	return pcm_convert_gain(source, ioffset, sink, ooffset, samples, gain, true, true);
+}
+
+static int pcm_convert_c16_to_c32_gain(const struct audio_stream *source,
+				       uint32_t ioffset, struct audio_stream *sink,
+				       uint32_t ooffset, uint32_t samples,
+				       const struct pcm_gain *gain)
+{
+	return pcm_convert_gain(source, ioffset, sink, ooffset, samples, gain, true, false);
+}
+
+static int pcm_convert_c32_to_c16_gain(const struct audio_stream *source,
+				       uint32_t ioffset, struct audio_stream *sink,
+				       uint32_t ooffset, uint32_t samples,
+				       const struct pcm_gain *gain)
+{
+	return pcm_convert_gain(source, ioffset, sink, ooffset, samples, gain, false, true);
+}
+
+static int pcm_convert_c32_to_c32_gain(const struct audio_stream *source,
+				       uint32_t ioffset, struct audio_stream *sink,
+				       uint32_t ooffset, uint32_t samples,
+				       const struct pcm_gain *gain)
+{
+	return pcm_convert_gain(source, ioffset, sink, ooffset, samples, gain, false, false);
+}
+
+/* container bits of a frame format, 0 if not supported */
+static uint32_t pcm_gain_container_bits(enum sof_ipc_frame fmt)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return 16;
+	case SOF_IPC_FRAME_S24_4LE:
+	case SOF_IPC_FRAME_S32_LE:
+		return 32;
+	default:
+		return 0;
+	}
+}
+
+/* valid bits of a frame format, 0 if not supported */
+static uint32_t pcm_gain_valid_bits(enum sof_ipc_frame fmt)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return 16;
+	case SOF_IPC_FRAME_S24_4LE:
+		return 24;
+	case SOF_IPC_FRAME_S32_LE:
+		return 32;
+	default:
+		return 0;
+	}
+}
+
+pcm_converter_gain_func pcm_get_conversion_gain_function(struct pcm_gain *gain,
+							 enum sof_ipc_frame in_bits,
+							 enum sof_ipc_frame valid_in_bits,
+							 enum sof_ipc_frame out_bits,
+							 enum sof_ipc_frame valid_out_bits)
+{
+	uint32_t in_container = pcm_gain_container_bits(in_bits);
+	uint32_t out_container = pcm_gain_container_bits(out_bits);
+	uint32_t in_valid = pcm_gain_valid_bits(valid_in_bits);
+	uint32_t out_valid = pcm_gain_valid_bits(valid_out_bits);
+
+	if (!in_container || !out_container || !in_valid || !out_valid ||
+	    in_valid > in_container || out_valid > out_container)
+		return NULL;
+
+	gain->in_shift = 32 - in_valid;
+	gain->out_shift = 63 - out_valid;
+
+	if (in_container == 16)
+		return out_container == 16 ? pcm_convert_c16_to_c16_gain :
+					     pcm_convert_c16_to_c32_gain;
+
+	return out_container == 16 ? pcm_convert_c32_to_c16_gain : pcm_convert_c32_to_c32_gain;
+}
+
+static void pcm_gain_update_unity(struct pcm_gain *gain)
+{
+	uint32_t ch;
+
+	gain->unity = !gain->ramp_frames && !gain->attenuation;
+	for (ch = 0; ch < gain->channels; ch++)
+		if (gain->gain[ch] != PCM_GAIN_UNITY || gain->target[ch] != PCM_GAIN_UNITY)
+			gain->unity = false;
+}
+
+void pcm_gain_set_target(struct pcm_gain *gain, uint32_t channel, int32_t target,
+			 uint32_t ramp_frames)
+{
+	uint32_t ch;
+
+	gain->target[channel] = target;
+	if (ramp_frames) {
+		/* a new ramp restarts all the channels not at their target yet */
+		gain->ramp_frames = 0;
+		for (ch = 0; ch < gain->channels; ch++) {
+			gain->step[ch] = ((int64_t)gain->target[ch] - gain->gain[ch]) /
+					 (int64_t)ramp_frames;
+			if (gain->gain[ch] != gain->target[ch])
+				gain->ramp_frames = ramp_frames;
+		}
+	} else {
+		/* the channel jumps, the others continue their ramp */
+		gain->gain[channel] = target;
+		gain->step[channel] = 0;
+	}
+
+	pcm_gain_update_unity(gain);
+}
+
+void pcm_gain_set_attenuation(struct pcm_gain *gain, uint32_t attenuation)
+{
+	gain->attenuation = attenuation;
+	pcm_gain_update_unity(gain);
+}
@@ -959,4 +959,202 @@ const struct pcm_func_vc_map pcm_func_vc_map[] = {
 
 const size_t pcm_func_vc_count = ARRAY_SIZE(pcm_func_vc_map);
 
+/*
+ * Conversions with fused attenuation, the sample is converted to the sink
+ * format and shifted right by the attenuation in the same pass. Only 32 bit
+ * sink containers are supported, the same as for copier attenuation.
+ */
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && \
+	(CONFIG_PCM_CONVERTER_FORMAT_S24LE || CONFIG_PCM_CONVERTER_FORMAT_S32LE)
+static inline int pcm_convert_s16_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      int lshift, uint32_t attenuation)
+{
+	int16_t *src = audio_stream_get_rptr(source);
+	int32_t *dst = audio_stream_get_wptr(sink);
+	int processed;
+	int nmax, i, n;
+
+	src += ioffset;
+	dst += ooffset;
+	for (processed = 0; processed < samples; processed += n) {
+		src = audio_stream_wrap(source, src);
+		dst = audio_stream_wrap(sink, dst);
+		n = samples - processed;
+		nmax = audio_stream_bytes_without_wrap(source, src) >> BYTES_TO_S16_SAMPLES;
+		n = MIN(n, nmax);
+		nmax = audio_stream_bytes_without_wrap(sink, dst) >> BYTES_TO_S32_SAMPLES;
+		n = MIN(n, nmax);
+		for (i = 0; i < n; i++) {
+			*dst = ((int32_t)*src << lshift) >> attenuation;
+			src++;
+			dst++;
+		}
+	}
+
+	return samples;
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+static int pcm_convert_s16_to_s32_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t attenuation)
+{
+	return pcm_convert_s16_att(source, ioffset, sink, ooffset, samples, 16, attenuation);
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S24LE
+static int pcm_convert_s16_to_s24_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t attenuation)
+{
+	return pcm_convert_s16_att(source, ioffset, sink, ooffset, samples, 8, attenuation);
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE || CONFIG_PCM_CONVERTER_FORMAT_S32LE || \
+	CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S32_C32 || \
+	CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S24_C32
+static inline int pcm_convert_s32_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      int lshift, uint32_t attenuation)
+{
+	int32_t *src = audio_stream_get_rptr(source);
+	int32_t *dst = audio_stream_get_wptr(sink);
+	int processed;
+	int nmax, i, n;
+
+	src += ioffset;
+	dst += ooffset;
+	for (processed = 0; processed < samples; processed += n) {
+		src = audio_stream_wrap(source, src);
+		dst = audio_stream_wrap(sink, dst);
+		n = samples - processed;
+		nmax = audio_stream_bytes_without_wrap(source, src) >> BYTES_TO_S32_SAMPLES;
+		n = MIN(n, nmax);
+		nmax = audio_stream_bytes_without_wrap(sink, dst) >> BYTES_TO_S32_SAMPLES;
+		n = MIN(n, nmax);
+		for (i = 0; i < n; i++) {
+			*dst = (int32_t)((uint32_t)*src << lshift) >> attenuation;
+			src++;
+			dst++;
+		}
+	}
+
+	return samples;
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE || CONFIG_PCM_CONVERTER_FORMAT_S32LE
+static int pcm_convert_s32_c32_att(const struct audio_stream *source,
+				   uint32_t ioffset, struct audio_stream *sink,
+				   uint32_t ooffset, uint32_t samples,
+				   uint32_t attenuation)
+{
+	return pcm_convert_s32_att(source, ioffset, sink, ooffset, samples, 0, attenuation);
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+static int pcm_convert_s24_to_s32_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t attenuation)
+{
+	return pcm_convert_s32_att(source, ioffset, sink, ooffset, samples, 8, attenuation);
+}
+
+static int pcm_convert_s32_to_s24_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t attenuation)
+{
+	int32_t *src = audio_stream_get_rptr(source);
+	int32_t *dst = audio_stream_get_wptr(sink);
+	int processed;
+	int nmax, i, n;
+
+	src += ioffset;
+	dst += ooffset;
+	for (processed = 0; processed < samples; processed += n) {
+		src = audio_stream_wrap(source, src);
+		dst = audio_stream_wrap(sink, dst);
+		n = samples - processed;
+		nmax = audio_stream_bytes_without_wrap(source, src) >> BYTES_TO_S32_SAMPLES;
+		n = MIN(n, nmax);
+		nmax = audio_stream_bytes_without_wrap(sink, dst) >> BYTES_TO_S32_SAMPLES;
+		n = MIN(n, nmax);
+		for (i = 0; i < n; i++) {
+			*dst = sat_int24(Q_SHIFT_RND(*src, 31, 23)) >> attenuation;
+			src++;
+			dst++;
+		}
+	}
+
+	return samples;
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S32_C32
+static int pcm_convert_s16_c32_to_s32_c32_att(const struct audio_stream *source,
+					      uint32_t ioffset, struct audio_stream *sink,
+					      uint32_t ooffset, uint32_t samples,
+					      uint32_t attenuation)
+{
+	return pcm_convert_s32_att(source, ioffset, sink, ooffset, samples, 16, attenuation);
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S24_C32
+static int pcm_convert_s16_c32_to_s24_c32_att(const struct audio_stream *source,
+					      uint32_t ioffset, struct audio_stream *sink,
+					      uint32_t ooffset, uint32_t samples,
+					      uint32_t attenuation)
+{
+	return pcm_convert_s32_att(source, ioffset, sink, ooffset, samples, 8, attenuation);
+}
+#endif
+
+const struct pcm_func_att_map pcm_func_att_map[] = {
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+		pcm_convert_s16_to_s32_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE,
+		pcm_convert_s16_to_s24_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S32_C32
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+		pcm_convert_s16_c32_to_s32_c32_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S24_C32
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE,
+		pcm_convert_s16_c32_to_s24_c32_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE,
+		pcm_convert_s32_c32_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+		pcm_convert_s24_to_s32_att },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE,
+		pcm_convert_s32_to_s24_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+		pcm_convert_s32_c32_att },
+#endif
+};
+
+const size_t pcm_func_att_count = ARRAY_SIZE(pcm_func_att_map);
+
 #endif
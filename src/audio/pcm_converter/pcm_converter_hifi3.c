@@ -473,6 +473,171 @@ static inline int _round_s(xtfloat x)
 #endif
 }
 
+#if XCHAL_HAVE_HIFI3_VFPU || XCHAL_HAVE_HIFI4_VFPU || XCHAL_HAVE_HIFI5_VFPU
+#define PCM_CONVERTER_VFPU 1
+
+/*
+ * The vector FPU converts two samples per instruction. The kernels below
+ * convert the largest part of a linear buffer that is a multiple of the
+ * vector width with unaligned loads and stores and return the number of
+ * samples converted, the remaining ones are converted one by one. Scaling
+ * by a power of two is exact, so the samples are scaled by a multiplication
+ * instead of the shift immediate of the conversion instructions.
+ */
+
+/* scale factor in both halves of a vector register */
+static inline xtfloatx2 pcm_convert_scale_x2(const float *scale)
+{
+	return XT_LSX2I((const xtfloatx2 *)scale, 0);
+}
+
+/* rounded to nearest, saturated to 32 bit */
+static inline ae_int32x2 pcm_convert_round_x2(xtfloatx2 x, xtfloatx2 scale)
+{
+	return XT_TRUNC_SX2(XT_FIROUND_SX2(XT_MUL_SX2(x, scale)), 0);
+}
+
+#if CONFIG_PCM_CONVERTER_FORMAT_FLOAT && CONFIG_PCM_CONVERTER_FORMAT_S16LE
+static int pcm_convert_s16_to_f_x2(const void *psrc, void *pdst, uint32_t samples)
+{
+	const ae_int16x4 *in = psrc;
+	xtfloatx2 *out = pdst;
+	static const float scale_f[2] __aligned(8) = { 1.f / 32768, 1.f / 32768 };
+	xtfloatx2 scale = pcm_convert_scale_x2(scale_f);
+	ae_valign inu = AE_LA64_PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int16x4 sample;
+	xtfloatx2 fl0, fl1;
+	int n = samples >> 2;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		AE_LA16X4_IP(sample, inu, in);
+		fl0 = XT_FLOAT_SX2(AE_SEXT32X2D16_32(sample), 0);
+		fl1 = XT_FLOAT_SX2(AE_SEXT32X2D16_10(sample), 0);
+		XT_SASX2IP(XT_MUL_SX2(fl0, scale), outu, out);
+		XT_SASX2IP(XT_MUL_SX2(fl1, scale), outu, out);
+	}
+	XT_SASX2POSFP(outu, out);
+
+	return n << 2;
+}
+
+static int pcm_convert_f_to_s16_x2(const void *psrc, void *pdst, uint32_t samples)
+{
+	const xtfloatx2 *in = psrc;
+	ae_int16x4 *out = pdst;
+	static const float scale_f[2] __aligned(8) = { 32768.f, 32768.f };
+	xtfloatx2 scale = pcm_convert_scale_x2(scale_f);
+	ae_valign inu = XT_LASX2PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	xtfloatx2 x0, x1;
+	int n = samples >> 2;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		XT_LASX2IP(x0, inu, in);
+		XT_LASX2IP(x1, inu, in);
+		AE_SA16X4_IP(AE_SAT16X4(pcm_convert_round_x2(x0, scale),
+					pcm_convert_round_x2(x1, scale)), outu, out);
+	}
+	AE_SA64POS_FP(outu, out);
+
+	return n << 2;
+}
+#endif /* CONFIG_PCM_CONVERTER_FORMAT_FLOAT && CONFIG_PCM_CONVERTER_FORMAT_S16LE */
+
+#if CONFIG_PCM_CONVERTER_FORMAT_FLOAT && CONFIG_PCM_CONVERTER_FORMAT_S24LE
+static int pcm_convert_s24_to_f_x2(const void *psrc, void *pdst, uint32_t samples)
+{
+	const ae_int32x2 *in = psrc;
+	xtfloatx2 *out = pdst;
+	static const float scale_f[2] __aligned(8) = { 1.f / 8388608, 1.f / 8388608 };
+	xtfloatx2 scale = pcm_convert_scale_x2(scale_f);
+	ae_valign inu = AE_LA64_PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int32x2 sample;
+	int n = samples >> 1;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		AE_LA32X2_IP(sample, inu, in);
+		/* extend sign */
+		sample = AE_SRAI32(AE_SLAI32(sample, 8), 8);
+		XT_SASX2IP(XT_MUL_SX2(XT_FLOAT_SX2(sample, 0), scale), outu, out);
+	}
+	XT_SASX2POSFP(outu, out);
+
+	return n << 1;
+}
+
+static int pcm_convert_f_to_s24_x2(const void *psrc, void *pdst, uint32_t samples)
+{
+	const xtfloatx2 *in = psrc;
+	ae_int32x2 *out = pdst;
+	static const float scale_f[2] __aligned(8) = { 8388608.f, 8388608.f };
+	xtfloatx2 scale = pcm_convert_scale_x2(scale_f);
+	ae_valign inu = XT_LASX2PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	xtfloatx2 x;
+	int n = samples >> 1;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		XT_LASX2IP(x, inu, in);
+		AE_SA32X2_IP(AE_SAT24S((ae_f32x2)pcm_convert_round_x2(x, scale)), outu, out);
+	}
+	AE_SA64POS_FP(outu, out);
+
+	return n << 1;
+}
+#endif /* CONFIG_PCM_CONVERTER_FORMAT_FLOAT && CONFIG_PCM_CONVERTER_FORMAT_S24LE */
+
+#if CONFIG_PCM_CONVERTER_FORMAT_FLOAT && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+static int pcm_convert_s32_to_f_x2(const void *psrc, void *pdst, uint32_t samples)
+{
+	const ae_int32x2 *in = psrc;
+	xtfloatx2 *out = pdst;
+	static const float scale_f[2] __aligned(8) = { 1.f / 2147483648.f, 1.f / 2147483648.f };
+	xtfloatx2 scale = pcm_convert_scale_x2(scale_f);
+	ae_valign inu = AE_LA64_PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int32x2 sample;
+	int n = samples >> 1;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		AE_LA32X2_IP(sample, inu, in);
+		XT_SASX2IP(XT_MUL_SX2(XT_FLOAT_SX2(sample, 0), scale), outu, out);
+	}
+	XT_SASX2POSFP(outu, out);
+
+	return n << 1;
+}
+
+static int pcm_convert_f_to_s32_x2(const void *psrc, void *pdst, uint32_t samples)
+{
+	const xtfloatx2 *in = psrc;
+	ae_int32x2 *out = pdst;
+	static const float scale_f[2] __aligned(8) = { 2147483648.f, 2147483648.f };
+	xtfloatx2 scale = pcm_convert_scale_x2(scale_f);
+	ae_valign inu = XT_LASX2PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	xtfloatx2 x;
+	int n = samples >> 1;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		XT_LASX2IP(x, inu, in);
+		AE_SA32X2_IP(pcm_convert_round_x2(x, scale), outu, out);
+	}
+	AE_SA64POS_FP(outu, out);
+
+	return n << 1;
+}
+#endif /* CONFIG_PCM_CONVERTER_FORMAT_FLOAT && CONFIG_PCM_CONVERTER_FORMAT_S32LE */
+#endif /* XCHAL_HAVE_HIFI3_VFPU || XCHAL_HAVE_HIFI4_VFPU || XCHAL_HAVE_HIFI5_VFPU */
+
 #if CONFIG_PCM_CONVERTER_FORMAT_FLOAT && CONFIG_PCM_CONVERTER_FORMAT_S16LE
 
 /**
@@ -490,6 +655,12 @@ static void pcm_convert_s16_to_f_lin(const void *psrc, void *pdst,
 	xtfloat fl;
 	int i = 0;
 
+#ifdef PCM_CONVERTER_VFPU
+	i = pcm_convert_s16_to_f_x2(psrc, pdst, samples);
+	in += i;
+	out += i;
+#endif
+
 	while (i < samples) {
 		/* load one 16 bit sample */
 		AE_L16_XC(sample, in, sizeof(ae_int16));
@@ -520,6 +691,12 @@ static void pcm_convert_f_to_s16_lin(const void *psrc, void *pdst,
 	int y;
 	int i = 0;
 
+#ifdef PCM_CONVERTER_VFPU
+	i = pcm_convert_f_to_s16_x2(psrc, pdst, samples);
+	in += i;
+	out = (ae_int16x4 *)((ae_int16 *)out + i);
+#endif
+
 	while (i < samples) {
 		/* load one 32 bit sample */
 		XT_xtfloat_loadip(x, in, sizeof(x));
@@ -583,6 +760,12 @@ static void pcm_convert_s24_to_f_lin(const void *psrc, void *pdst,
 	const xtfloat ratio = (xtfloat)(1.f / (1 << (23 - 15)));
 	int i = 0;
 
+#ifdef PCM_CONVERTER_VFPU
+	i = pcm_convert_s24_to_f_x2(psrc, pdst, samples);
+	in += i;
+	out += i;
+#endif
+
 	while (i < samples) {
 		/* load one 24 bit sample */
 		AE_L32_XC(sample, in, sizeof(*in));
@@ -617,6 +800,12 @@ static void pcm_convert_f_to_s24_lin(const void *psrc, void *pdst,
 	int i = 0;
 	const xtfloat ratio = (xtfloat)(1 << (23 - 15));
 
+#ifdef PCM_CONVERTER_VFPU
+	i = pcm_convert_f_to_s24_x2(psrc, pdst, samples);
+	in += i;
+	out += i;
+#endif
+
 	while (i < samples) {
 		/* load one 32 bit sample */
 		/* need address align to 32 bits */
@@ -684,6 +873,12 @@ static void pcm_convert_s32_to_f_lin(const void *psrc, void *pdst,
 	const xtfloat ratio = (xtfloat)(1.f / (1ul << (31 - 15)));
 	int i = 0;
 
+#ifdef PCM_CONVERTER_VFPU
+	i = pcm_convert_s32_to_f_x2(psrc, pdst, samples);
+	in += i;
+	out += i;
+#endif
+
 	while (i < samples) {
 		/* load one 32 bit sample */
 		AE_L32_XC(sample, in, sizeof(*in));
@@ -716,6 +911,12 @@ static void pcm_convert_f_to_s32_lin(const void *psrc, void *pdst,
 	int i = 0;
 	const xtfloat ratio = (xtfloat)(1ul << (31 - 15));
 
+#ifdef PCM_CONVERTER_VFPU
+	i = pcm_convert_f_to_s32_x2(psrc, pdst, samples);
+	in += i;
+	out += i;
+#endif
+
 	while (i < samples) {
 		/* load one 32 bit sample */
 		/* need address align to 32 bits */
@@ -1278,4 +1479,260 @@ const struct pcm_func_vc_map pcm_func_vc_map[] = {
 
 const size_t pcm_func_vc_count = ARRAY_SIZE(pcm_func_vc_map);
 
+/*
+ * Conversions with fused attenuation, the sample is converted to the sink
+ * format and shifted right by the attenuation in the same pass. Only 32 bit
+ * sink containers are supported, the same as for copier attenuation.
+ */
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && \
+	(CONFIG_PCM_CONVERTER_FORMAT_S24LE || CONFIG_PCM_CONVERTER_FORMAT_S32LE)
+/**
+ * \brief HiFi3 enabled PCM conversion from 16 bit to 32 bit container with
+ *	  attenuation.
+ * \param[in] rshift Right shift of the sample aligned to MSB of 32 bits.
+ */
+static inline int pcm_convert_s16_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t rshift)
+{
+	ae_int16x4 sample = AE_ZERO16();
+	uint32_t nmax, i, n, m, left, left_samples;
+	ae_valign inu = AE_ZALIGN64();
+	ae_valign outu = AE_ZALIGN64();
+	int16_t *src = audio_stream_get_rptr(source);
+	int32_t *dst = audio_stream_get_wptr(sink);
+
+	ae_int16x4 *in = audio_stream_wrap(source, src + ioffset);
+	ae_int32x2 *out = audio_stream_wrap(sink, dst + ooffset);
+
+	for (left_samples = samples; left_samples; left_samples -= n) {
+		nmax = audio_stream_samples_without_wrap_s16(source, in);
+		n = MIN(left_samples, nmax);
+		nmax = audio_stream_samples_without_wrap_s32(sink, out);
+		n = MIN(n, nmax);
+		m = n >> 2;
+		left = n & 0x03;
+		inu = AE_LA64_PP(in);
+
+		for (i = 0; i < m; i++) {
+			/* load four 16 bit samples */
+			AE_LA16X4_IP(sample, inu, in);
+			/* shift right and store four 32 bit samples */
+			AE_SA32X2_IP(AE_SRAA32(AE_CVT32X2F16_32(sample), rshift), outu, out);
+			AE_SA32X2_IP(AE_SRAA32(AE_CVT32X2F16_10(sample), rshift), outu, out);
+		}
+		AE_SA64POS_FP(outu, out);
+
+		/* process the left samples one by one to avoid memory access overrun */
+		for (i = 0; i < left ; i++) {
+			AE_L16_IP(sample, (ae_int16 *)in, sizeof(ae_int16));
+			AE_S32_L_IP(AE_SRAA32(AE_CVT32X2F16_32(sample), rshift), (ae_int32 *)out,
+				    sizeof(ae_int32));
+		}
+
+		in = audio_stream_wrap(source, in);
+		out = audio_stream_wrap(sink, out);
+	}
+
+	return samples;
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+static int pcm_convert_s16_to_s32_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t attenuation)
+{
+	return pcm_convert_s16_att(source, ioffset, sink, ooffset, samples, attenuation);
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S24LE
+static int pcm_convert_s16_to_s24_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t attenuation)
+{
+	return pcm_convert_s16_att(source, ioffset, sink, ooffset, samples, 8 + attenuation);
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE || CONFIG_PCM_CONVERTER_FORMAT_S32LE || \
+	CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S32_C32 || \
+	CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S24_C32
+/**
+ * \brief HiFi3 enabled PCM conversion between 32 bit containers with
+ *	  attenuation.
+ * \param[in] lshift Left shift aligning the valid bits of source to sink.
+ * \param[in] attenuation Right shift applied after the alignment.
+ */
+static inline int pcm_convert_s32_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t lshift, uint32_t attenuation)
+{
+	int32_t *src = audio_stream_get_rptr(source);
+	int32_t *dst = audio_stream_get_wptr(sink);
+	ae_int32x2 sample = AE_ZERO32();
+	uint32_t nmax, i, n, m, left_samples;
+	ae_valign outu = AE_ZALIGN64();
+	ae_valign inu = AE_ZALIGN64();
+
+	ae_int32x2 *in = audio_stream_wrap(source, src + ioffset);
+	ae_int32x2 *out = audio_stream_wrap(sink, dst + ooffset);
+
+	for (left_samples = samples; left_samples; left_samples -= n) {
+		nmax = audio_stream_samples_without_wrap_s32(source, in);
+		n = MIN(left_samples, nmax);
+		nmax = audio_stream_samples_without_wrap_s32(sink, out);
+		n = MIN(n, nmax);
+		m = n >> 1;
+		inu = AE_LA64_PP(in);
+		for (i = 0; i < m; i++) {
+			/* load 2 32 bit samples, align and attenuate */
+			AE_LA32X2_IP(sample, inu, in);
+			sample = AE_SRAA32(AE_SLAA32(sample, lshift), attenuation);
+			AE_SA32X2_IP(sample, outu, out);
+		}
+		AE_SA64POS_FP(outu, out);
+
+		/* process the left 1 sample to avoid memory access overrun */
+		if (n & 0x01) {
+			AE_L32_IP(sample, (ae_int32 *)in, sizeof(ae_int32));
+			sample = AE_SRAA32(AE_SLAA32(sample, lshift), attenuation);
+			AE_S32_L_IP(sample, (ae_int32 *)out, sizeof(ae_int32));
+		}
+
+		in = audio_stream_wrap(source, in);
+		out = audio_stream_wrap(sink, out);
+	}
+
+	return samples;
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE || CONFIG_PCM_CONVERTER_FORMAT_S32LE
+static int pcm_convert_s32_c32_att(const struct audio_stream *source,
+				   uint32_t ioffset, struct audio_stream *sink,
+				   uint32_t ooffset, uint32_t samples,
+				   uint32_t attenuation)
+{
+	return pcm_convert_s32_att(source, ioffset, sink, ooffset, samples, 0, attenuation);
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+static int pcm_convert_s24_to_s32_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t attenuation)
+{
+	return pcm_convert_s32_att(source, ioffset, sink, ooffset, samples, 8, attenuation);
+}
+
+/**
+ * \brief HiFi3 enabled PCM conversion from 32 bit to 24 bit with attenuation.
+ */
+static int pcm_convert_s32_to_s24_att(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t attenuation)
+{
+	int32_t *src = audio_stream_get_rptr(source);
+	int32_t *dst = audio_stream_get_wptr(sink);
+	ae_int32x2 sample = AE_ZERO32();
+	uint32_t nmax, i, n, m, left_samples;
+	ae_valign outu = AE_ZALIGN64();
+	ae_valign inu = AE_ZALIGN64();
+
+	ae_int32x2 *in = audio_stream_wrap(source, src + ioffset);
+	ae_int32x2 *out = audio_stream_wrap(sink, dst + ooffset);
+
+	for (left_samples = samples; left_samples; left_samples -= n) {
+		nmax = audio_stream_samples_without_wrap_s32(source, in);
+		n = MIN(left_samples, nmax);
+		nmax = audio_stream_samples_without_wrap_s32(sink, out);
+		n = MIN(n, nmax);
+		m = n >> 1;
+		inu = AE_LA64_PP(in);
+		for (i = 0; i < m; i++) {
+			AE_LA32X2_IP(sample, inu, in);
+			sample = AE_SRAA32(pcm_shift_s32_to_s24(sample), attenuation);
+			AE_SA32X2_IP(sample, outu, out);
+		}
+		AE_SA64POS_FP(outu, out);
+
+		/* process the left 1 sample to avoid memory access overrun */
+		if (n & 0x01) {
+			AE_L32_IP(sample, (ae_int32 *)in, sizeof(ae_int32));
+			sample = AE_SRAA32(pcm_shift_s32_to_s24(sample), attenuation);
+			AE_S32_L_IP(sample, (ae_int32 *)out, sizeof(ae_int32));
+		}
+
+		in = audio_stream_wrap(source, in);
+		out = audio_stream_wrap(sink, out);
+	}
+
+	return samples;
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S32_C32
+static int pcm_convert_s16_c32_to_s32_c32_att(const struct audio_stream *source,
+					      uint32_t ioffset, struct audio_stream *sink,
+					      uint32_t ooffset, uint32_t samples,
+					      uint32_t attenuation)
+{
+	return pcm_convert_s32_att(source, ioffset, sink, ooffset, samples, 16, attenuation);
+}
+#endif
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S24_C32
+static int pcm_convert_s16_c32_to_s24_c32_att(const struct audio_stream *source,
+					      uint32_t ioffset, struct audio_stream *sink,
+					      uint32_t ooffset, uint32_t samples,
+					      uint32_t attenuation)
+{
+	return pcm_convert_s32_att(source, ioffset, sink, ooffset, samples, 8, attenuation);
+}
+#endif
+
+const struct pcm_func_att_map pcm_func_att_map[] = {
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+		pcm_convert_s16_to_s32_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE,
+		pcm_convert_s16_to_s24_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S32_C32
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+		pcm_convert_s16_c32_to_s32_c32_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S16_C32_AND_S24_C32
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE,
+		pcm_convert_s16_c32_to_s24_c32_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE,
+		pcm_convert_s32_c32_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+		pcm_convert_s24_to_s32_att },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE,
+		pcm_convert_s32_to_s24_att },
+#endif
+#if CONFIG_PCM_CONVERTER_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+		pcm_convert_s32_c32_att },
+#endif
+};
+
+const size_t pcm_func_att_count = ARRAY_SIZE(pcm_func_att_map);
+
 #endif
@@ -187,9 +187,16 @@ int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 
 	irq_local_disable(flags);
 
+	/* the copy order changes with the graph */
+	if (comp->pipeline)
+		pipeline_unfuse(comp->pipeline);
+
 	comp_list = comp_buffer_list(comp, dir);
 	buffer_attach(buffer, comp_list, dir);
 	buffer_set_comp(buffer, comp, dir);
+#if CONFIG_PIPELINE_PARAMS_CACHE
+	buffer->hw_params_cached = false;
+#endif
 
 	irq_local_enable(flags);
 
@@ -208,9 +215,15 @@ void pipeline_disconnect(struct comp_dev *comp, struct comp_buffer *buffer, int
 
 	irq_local_disable(flags);
 
+	if (comp->pipeline)
+		pipeline_unfuse(comp->pipeline);
+
 	comp_list = comp_buffer_list(comp, dir);
 	buffer_detach(buffer, comp_list, dir);
 	buffer_set_comp(buffer, NULL, dir);
+#if CONFIG_PIPELINE_PARAMS_CACHE
+	buffer->hw_params_cached = false;
+#endif
 
 	irq_local_enable(flags);
 }
@@ -218,7 +231,8 @@ void pipeline_disconnect(struct comp_dev *comp, struct comp_buffer *buffer, int
 /* pipelines must be inactive */
 int pipeline_free(struct pipeline *p)
 {
-	pipe_dbg(p, "pipeline_free()");
+	pipe_info(p, "pipeline_free(), module memory usage %u peak %u", p->mem_usage,
+		  p->mem_peak);
 
 	/*
 	 * pipeline_free should always be called only after all the widgets in the pipeline have
@@ -317,6 +331,20 @@ int pipeline_complete(struct pipeline *p, struct comp_dev *source,
 	return ret;
 }
 
+#if CONFIG_PIPELINE_PARAMS_CACHE
+/* the DAI params beyond a reset component may change before it runs again */
+static void pipeline_comp_hw_params_uncache(struct comp_dev *current)
+{
+	struct list_item *clist;
+
+	list_for_item(clist, comp_buffer_list(current, PPL_DIR_DOWNSTREAM))
+		buffer_from_list(clist, PPL_DIR_DOWNSTREAM)->hw_params_cached = false;
+
+	list_for_item(clist, comp_buffer_list(current, PPL_DIR_UPSTREAM))
+		buffer_from_list(clist, PPL_DIR_UPSTREAM)->hw_params_cached = false;
+}
+#endif
+
 static int pipeline_comp_reset(struct comp_dev *current,
 			       struct comp_buffer *calling_buf,
 			       struct pipeline_walk_context *ctx, int dir)
@@ -375,6 +403,10 @@ static int pipeline_comp_reset(struct comp_dev *current,
 	if (err < 0 || err == PPL_STATUS_PATH_STOP)
 		return err;
 
+#if CONFIG_PIPELINE_PARAMS_CACHE
+	pipeline_comp_hw_params_uncache(current);
+#endif
+
 	return pipeline_for_each_comp(current, ctx, dir);
 }
 
@@ -391,6 +423,13 @@ int pipeline_reset(struct pipeline *p, struct comp_dev *host)
 
 	pipe_dbg(p, "pipe reset");
 
+#if CONFIG_PIPELINE_XRUN_FAST_RECOVERY
+	if (p->xrun_stats.count)
+		pipe_info(p, "pipe xrun recoveries %u, last %u us, max %u us",
+			  p->xrun_stats.count, p->xrun_stats.last_us, p->xrun_stats.max_us);
+	memset(&p->xrun_stats, 0, sizeof(p->xrun_stats));
+#endif
+
 	ret = walk_ctx.comp_func(host, NULL, &walk_ctx, host->direction);
 	if (ret < 0) {
 		pipe_err(p, "pipeline_reset(): ret = %d, host->comp.id = %u",
@@ -398,6 +437,7 @@ int pipeline_reset(struct pipeline *p, struct comp_dev *host)
 	} else {
 		 /* pipeline is reset to default state */
 		p->status = COMP_STATE_READY;
+		pipeline_unfuse(p);
 	}
 
 	return ret;
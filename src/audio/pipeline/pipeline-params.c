@@ -142,17 +142,73 @@ static void pipeline_update_buffer_pcm_params(struct comp_buffer *buffer,
 		params->chmap[i] = buffer->chmap[i];
 }
 
+#if CONFIG_PIPELINE_PARAMS_CACHE
+/* copy the params set by comp_dai_get_hw_params() */
+static void pipeline_hw_params_copy(struct sof_ipc_stream_params *dst,
+				    const struct sof_ipc_stream_params *src)
+{
+	dst->rate = src->rate;
+	dst->buffer_fmt = src->buffer_fmt;
+	dst->channels = src->channels;
+	dst->frame_fmt = src->frame_fmt;
+}
+
+/*
+ * The part of the graph beyond a running component can't change its DAI
+ * params until it is reset, so the result of walking it is taken from the
+ * buffer the walk came from.
+ */
+static bool pipeline_hw_params_cache_get(struct comp_dev *current,
+					 struct comp_buffer *calling_buf,
+					 struct pipeline_data *ppl_data)
+{
+	if (!calling_buf || !calling_buf->hw_params_cached ||
+	    current->state != COMP_STATE_ACTIVE)
+		return false;
+
+	if (calling_buf->hw_params_cache_found) {
+		pipeline_hw_params_copy(&ppl_data->params->params,
+					&calling_buf->hw_params_cache);
+		ppl_data->hw_params_found++;
+	}
+
+	return true;
+}
+
+static void pipeline_hw_params_cache_set(struct comp_buffer *calling_buf,
+					 struct pipeline_data *ppl_data,
+					 uint32_t found)
+{
+	if (!calling_buf)
+		return;
+
+	calling_buf->hw_params_cache_found = ppl_data->hw_params_found != found;
+	if (calling_buf->hw_params_cache_found)
+		pipeline_hw_params_copy(&calling_buf->hw_params_cache,
+					&ppl_data->params->params);
+	calling_buf->hw_params_cached = true;
+}
+#endif
+
 /* fetch hardware stream parameters from DAI  */
 static int pipeline_comp_hw_params(struct comp_dev *current,
 				   struct comp_buffer *calling_buf,
 				   struct pipeline_walk_context *ctx, int dir)
 {
 	struct pipeline_data *ppl_data = ctx->comp_data;
+#if CONFIG_PIPELINE_PARAMS_CACHE
+	uint32_t found = ppl_data->hw_params_found;
+#endif
 	int ret;
 
 	pipe_dbg(current->pipeline, "pipeline_comp_hw_params(), current->comp.id = %u, dir = %u",
 		 dev_comp_id(current), dir);
 
+#if CONFIG_PIPELINE_PARAMS_CACHE
+	if (pipeline_hw_params_cache_get(current, calling_buf, ppl_data))
+		return 0;
+#endif
+
 	ret = pipeline_for_each_comp(current, ctx, dir);
 	if (ret < 0)
 		return ret;
@@ -167,8 +223,15 @@ static int pipeline_comp_hw_params(struct comp_dev *current,
 				 ret);
 			return ret;
 		}
+#if CONFIG_PIPELINE_PARAMS_CACHE
+		ppl_data->hw_params_found++;
+#endif
 	}
 
+#if CONFIG_PIPELINE_PARAMS_CACHE
+	pipeline_hw_params_cache_set(calling_buf, ppl_data, found);
+#endif
+
 	return ret;
 }
 
@@ -180,6 +243,13 @@ static int pipeline_comp_hw_params_buf(struct comp_dev *current,
 	struct pipeline_data *ppl_data = ctx->comp_data;
 	int ret;
 
+#if CONFIG_PIPELINE_PARAMS_CACHE
+	/* buffers beyond a running component are all configured already */
+	if (calling_buf && calling_buf->hw_params_configured &&
+	    current->state == COMP_STATE_ACTIVE)
+		return 0;
+#endif
+
 	ret = pipeline_for_each_comp(current, ctx, dir);
 	if (ret < 0)
 		return ret;
@@ -350,5 +420,8 @@ int pipeline_prepare(struct pipeline *p, struct comp_dev *dev)
 
 	p->status = COMP_STATE_PREPARE;
 
+	/* the graph does not change until reset, resolve the copy order once */
+	pipeline_fuse(p);
+
 	return ret;
 }
@@ -12,6 +12,7 @@
 #include <sof/lib/agent.h>
 #include <sof/list.h>
 #include <sof/schedule/ll_schedule.h>
+#include <sof/schedule/ll_schedule_domain.h>
 #include <sof/schedule/dp_schedule.h>
 #include <sof/schedule/schedule.h>
 #include <sof/audio/module_adapter/module/generic.h>
@@ -263,6 +264,9 @@ static struct task *pipeline_task_init(struct pipeline *p, uint32_t type)
 
 	task->sched_comp = p->sched_comp;
 	task->registrable = p == p->sched_comp->pipeline;
+#if CONFIG_ZEPHYR_LL_FLOW_ORDER
+	task->task.flow_rank = p->flow_rank;
+#endif
 
 	return &task->task;
 }
@@ -365,6 +369,11 @@ int pipeline_comp_ll_task_init(struct pipeline *p)
 		 */
 		type = pipeline_is_timer_driven(p) ? SOF_SCHEDULE_LL_TIMER :
 			SOF_SCHEDULE_LL_DMA;
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+		/* pipelines with a period shorter than the regular one run in the fast domain */
+		if (type == SOF_SCHEDULE_LL_TIMER && p->period < LL_TIMER_PERIOD_US)
+			type = SOF_SCHEDULE_LL_FAST;
+#endif
 
 		p->pipe_task = pipeline_task_init(p, type);
 		if (!p->pipe_task) {
@@ -446,10 +455,13 @@ void pipeline_schedule_copy(struct pipeline *p, uint64_t start)
 	if (task_is_active(p->pipe_task))
 		return;
 
-	if (p->sched_next && task_is_active(p->sched_next->pipe_task))
+	/* tasks can only be ordered relative to tasks of the same scheduler */
+	if (p->sched_next && task_is_active(p->sched_next->pipe_task) &&
+	    p->sched_next->pipe_task->type == p->pipe_task->type)
 		schedule_task_before(p->pipe_task, start, p->period,
 				     p->sched_next->pipe_task);
-	else if (p->sched_prev && task_is_active(p->sched_prev->pipe_task))
+	else if (p->sched_prev && task_is_active(p->sched_prev->pipe_task) &&
+		 p->sched_prev->pipe_task->type == p->pipe_task->type)
 		schedule_task_after(p->pipe_task, start, p->period,
 				    p->sched_prev->pipe_task);
 	else
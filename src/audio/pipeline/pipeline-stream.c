@@ -8,7 +8,10 @@
 #include <sof/audio/buffer.h>
 #include <sof/audio/component_ext.h>
 #include <sof/audio/pipeline.h>
+#include <sof/debug/telemetry/tracepoint.h>
 #include <sof/lib/dai.h>
+#include <sof/math/numbers.h>
+#include <rtos/cache.h>
 #include <rtos/wait.h>
 #include <sof/list.h>
 #include <rtos/spinlock.h>
@@ -112,6 +115,155 @@ static int pipeline_comp_copy(struct comp_dev *current,
 	return err;
 }
 
+#if CONFIG_PIPELINE_FUSED_COPY
+struct pipeline_fuse_data {
+	struct pipeline *p;
+	struct comp_dev *start;
+	uint32_t count;		/* components recorded in pre-order */
+	uint32_t post;		/* components recorded in post-order */
+};
+
+/* record the components pipeline_comp_copy() would visit from the start */
+static int pipeline_comp_fuse(struct comp_dev *current,
+			      struct comp_buffer *calling_buf,
+			      struct pipeline_walk_context *ctx, int dir)
+{
+	struct pipeline_fuse_data *data = ctx->comp_data;
+	struct pipeline *p = data->p;
+	uint32_t i;
+	int err;
+
+	if (!comp_is_single_pipeline(current, data->start))
+		return 0;
+
+	if (data->count == PIPELINE_FUSED_MAX_COMPS)
+		return -ENOSPC;
+
+	i = data->count++;
+	p->fused_comps[i] = current;
+
+	err = pipeline_for_each_comp(current, ctx, dir);
+	if (err < 0)
+		return err;
+
+	p->fused_end[i] = data->count;
+	p->fused_post[data->post++] = i;
+
+	return 0;
+}
+
+void pipeline_fuse(struct pipeline *p)
+{
+	struct pipeline_fuse_data data = { .p = p };
+	struct pipeline_walk_context walk_ctx = {
+		.comp_func = pipeline_comp_fuse,
+		.comp_data = &data,
+		.skip_incomplete = true,
+	};
+	int dir;
+	int ret;
+
+	pipeline_unfuse(p);
+
+	if (!p->source_comp || !p->sink_comp)
+		return;
+
+	/* same start and direction as pipeline_copy() */
+	if (p->source_comp->direction == SOF_IPC_STREAM_PLAYBACK) {
+		dir = PPL_DIR_UPSTREAM;
+		data.start = p->sink_comp;
+	} else {
+		dir = PPL_DIR_DOWNSTREAM;
+		data.start = p->source_comp;
+	}
+
+	ret = walk_ctx.comp_func(data.start, NULL, &walk_ctx, dir);
+	if (ret < 0) {
+		pipe_dbg(p, "pipeline_fuse(), left to the graph walk, ret = %d", ret);
+		return;
+	}
+
+	pipe_dbg(p, "pipeline_fuse(), %u components", data.count);
+	p->fused_count = data.count;
+}
+
+#if CONFIG_PIPELINE_PREFETCH
+static void pipeline_prefetch_stream(const struct audio_stream *stream, const void *ptr)
+{
+	dcache_prefetch_region(ptr, MIN(CONFIG_PIPELINE_PREFETCH_BYTES,
+					audio_stream_bytes_without_wrap(stream, ptr)));
+}
+
+/* warm the state and the first lines of the streams of the next component */
+static void pipeline_prefetch_comp(struct comp_dev *dev)
+{
+	struct comp_buffer *buffer;
+
+	dcache_prefetch_region(dev, sizeof(*dev));
+	if (comp_get_drvdata(dev))
+		dcache_prefetch_region(comp_get_drvdata(dev), CONFIG_PIPELINE_PREFETCH_BYTES);
+
+	if (!list_is_empty(&dev->bsource_list)) {
+		buffer = list_first_item(&dev->bsource_list, struct comp_buffer, sink_list);
+		pipeline_prefetch_stream(&buffer->stream, audio_stream_get_rptr(&buffer->stream));
+	}
+
+	if (!list_is_empty(&dev->bsink_list)) {
+		buffer = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+		pipeline_prefetch_stream(&buffer->stream, audio_stream_get_wptr(&buffer->stream));
+	}
+}
+#endif
+
+/*
+ * Same order and stop conditions as the graph walk: an inactive component
+ * is skipped together with the components the walk reaches through it,
+ * downstream copies in pre-order and upstream in post-order, both stop at
+ * the first error or PPL_STATUS_PATH_STOP.
+ */
+static int pipeline_fused_copy(struct pipeline *p, uint32_t dir)
+{
+	struct comp_dev *order[PIPELINE_FUSED_MAX_COMPS];
+	bool run[PIPELINE_FUSED_MAX_COMPS];
+	uint32_t count = 0;
+	uint32_t i;
+	int err = 0;
+
+	for (i = 0; i < p->fused_count; i++)
+		run[i] = false;
+
+	for (i = 0; i < p->fused_count; ) {
+		if (!comp_is_active(p->fused_comps[i])) {
+			i = p->fused_end[i];
+			continue;
+		}
+
+		if (dir == PPL_DIR_DOWNSTREAM)
+			order[count++] = p->fused_comps[i];
+		else
+			run[i] = true;
+		i++;
+	}
+
+	if (dir == PPL_DIR_UPSTREAM)
+		for (i = 0; i < p->fused_count; i++)
+			if (run[p->fused_post[i]])
+				order[count++] = p->fused_comps[p->fused_post[i]];
+
+	for (i = 0; i < count; i++) {
+#if CONFIG_PIPELINE_PREFETCH
+		if (i + 1 < count)
+			pipeline_prefetch_comp(order[i + 1]);
+#endif
+		err = comp_copy(order[i]);
+		if (err < 0 || err == PPL_STATUS_PATH_STOP)
+			return err;
+	}
+
+	return dir == PPL_DIR_UPSTREAM ? err : 0;
+}
+#endif /* CONFIG_PIPELINE_FUSED_COPY */
+
 /* Copy data across all pipeline components.
  * For capture pipelines it always starts from source component
  * and continues downstream and for playback pipelines it first
@@ -140,7 +292,17 @@ int pipeline_copy(struct pipeline *p)
 	data.start = start;
 	data.p = p;
 
+	SOF_TRACEPOINT(SOF_TRACEPOINT_PIPELINE_COPY, SOF_TRACEPOINT_BEGIN, p->pipeline_id, 0);
+
+#if CONFIG_PIPELINE_FUSED_COPY
+	if (p->fused_count)
+		ret = pipeline_fused_copy(p, dir);
+	else
+#endif
 	ret = walk_ctx.comp_func(start, NULL, &walk_ctx, dir);
+
+	SOF_TRACEPOINT(SOF_TRACEPOINT_PIPELINE_COPY, SOF_TRACEPOINT_END, p->pipeline_id, 0);
+
 	if (ret < 0)
 		pipe_err(p, "pipeline_copy(): ret = %d, start->comp.id = %u, dir = %u",
 			 ret, dev_comp_id(start), dir);
@@ -12,6 +12,7 @@
 #include <sof/list.h>
 #include <rtos/spinlock.h>
 #include <rtos/string.h>
+#include <rtos/timer.h>
 #include <ipc/header.h>
 #include <ipc/stream.h>
 #include <ipc/topology.h>
@@ -53,6 +54,14 @@ static int pipeline_comp_xrun(struct comp_dev *current,
 /* recover the pipeline from a XRUN condition */
 int pipeline_xrun_recover(struct pipeline *p)
 {
+#if CONFIG_PIPELINE_XRUN_FAST_RECOVERY
+	/* the copy failed on an xrun already recovered in place */
+	if (p->xrun_stats.recovered) {
+		p->xrun_stats.recovered = false;
+		return 0;
+	}
+#endif
+
 	pipeline_reset(p, p->source_comp);
 	return -EINVAL;
 }
@@ -135,6 +144,95 @@ int pipeline_xrun_handle_trigger(struct pipeline *p, int cmd)
 	return ret;
 }
 
+#if CONFIG_PIPELINE_XRUN_FAST_RECOVERY
+/*
+ * Realign the DAI buffer so that the DAI can copy a full period again:
+ * fill the missing playback data with silence, drop the capture data
+ * the DAI had no room for.
+ */
+static void pipeline_xrun_conceal(struct comp_dev *dev, int32_t bytes)
+{
+	int dir = dev->direction == SOF_IPC_STREAM_PLAYBACK ?
+		PPL_DIR_UPSTREAM : PPL_DIR_DOWNSTREAM;
+	struct list_item *buffer_list = comp_buffer_list(dev, dir);
+	struct comp_buffer *buffer;
+	uint32_t frame_bytes;
+	uint32_t size;
+
+	if (list_is_empty(buffer_list))
+		return;
+
+	buffer = buffer_from_list(buffer_list->next, dir);
+	frame_bytes = audio_stream_frame_bytes(&buffer->stream);
+	if (!frame_bytes)
+		return;
+
+	if (dir == PPL_DIR_UPSTREAM) {
+		if (bytes >= 0)
+			return;
+
+		size = MIN((uint32_t)-bytes, audio_stream_get_free_bytes(&buffer->stream));
+		size -= size % frame_bytes;
+		audio_stream_set_zero(&buffer->stream, size);
+		buffer_stream_writeback(buffer, size);
+		comp_update_buffer_produce(buffer, size);
+	} else {
+		if (bytes <= 0)
+			return;
+
+		size = MIN((uint32_t)bytes, audio_stream_get_avail_bytes(&buffer->stream));
+		size -= size % frame_bytes;
+		comp_update_buffer_consume(buffer, size);
+	}
+}
+
+/* restart the DAI DMA keeping the rest of the pipeline running */
+static int pipeline_xrun_fast_recover(struct pipeline *p, struct comp_dev *dev,
+				      int32_t bytes)
+{
+	struct pipeline_xrun_stats *stats = &p->xrun_stats;
+	uint64_t start = sof_cycle_get_64();
+	int ret;
+
+	if (dev_comp_type(dev) != SOF_COMP_DAI)
+		return -EINVAL;
+
+	/* let the host restart the pipeline if xruns keep occurring */
+	if (!stats->burst_start || start - stats->burst_start >= k_ms_to_cyc_ceil64(1000)) {
+		stats->burst_start = start;
+		stats->burst = 0;
+	}
+
+	if (stats->burst >= CONFIG_PIPELINE_XRUN_FAST_RECOVERY_MAX)
+		return -EBUSY;
+
+	ret = comp_trigger(dev, COMP_TRIGGER_PAUSE);
+	if (ret < 0)
+		return ret;
+
+	pipeline_xrun_conceal(dev, bytes);
+
+	ret = comp_trigger(dev, COMP_TRIGGER_PRE_RELEASE);
+	if (ret >= 0)
+		ret = comp_trigger(dev, COMP_TRIGGER_RELEASE);
+	if (ret < 0) {
+		pipe_err(p, "pipeline_xrun_fast_recover(): DAI restart failed, ret = %d", ret);
+		return ret;
+	}
+
+	stats->last_us = k_cyc_to_us_near64(sof_cycle_get_64() - start);
+	stats->max_us = MAX(stats->max_us, stats->last_us);
+	stats->count++;
+	stats->burst++;
+	stats->recovered = true;
+
+	pipe_warn(p, "xrun of %d bytes recovered in place in %u us, %u recoveries",
+		  bytes, stats->last_us, stats->count);
+
+	return 0;
+}
+#endif
+
 /* Send an XRUN to each host for this component. */
 void pipeline_xrun(struct pipeline *p, struct comp_dev *dev,
 		   int32_t bytes)
@@ -156,6 +254,13 @@ void pipeline_xrun(struct pipeline *p, struct comp_dev *dev,
 	if (dev->state != COMP_STATE_ACTIVE)
 		return;
 
+	p->xrun_count++;
+
+#if CONFIG_PIPELINE_XRUN_FAST_RECOVERY
+	if (!pipeline_xrun_fast_recover(p, dev, bytes))
+		return;
+#endif
+
 	/* notify all pipeline comps we are in XRUN, and stop copying */
 	ret = pipeline_trigger(p, p->source_comp, COMP_TRIGGER_XRUN);
 	if (ret < 0)
@@ -9,8 +9,12 @@
 #include <sof/audio/component.h>
 #include <sof/audio/data_blob.h>
 #include <sof/audio/format.h>
+#include <sof/audio/module_adapter/module/generic.h>
 #include <sof/audio/pipeline.h>
 #include <sof/audio/rtnr/rtnr.h>
+#include <sof/audio/sink_api.h>
+#include <sof/audio/sink_source_utils.h>
+#include <sof/audio/source_api.h>
 #include <sof/common.h>
 #include <rtos/panic.h>
 #include <sof/ipc/msg.h>
@@ -26,6 +30,9 @@
 #include <ipc/control.h>
 #include <ipc/stream.h>
 #include <ipc/topology.h>
+#if CONFIG_IPC_MAJOR_4
+#include <ipc4/header.h>
+#endif
 #include <user/trace.h>
 #include <errno.h>
 #include <stddef.h>
@@ -46,9 +53,6 @@
 /* ID for RTNR data */
 #define RTNR_DATA_ID_PRESET 12345678
 
-
-static const struct comp_driver comp_rtnr;
-
 /** \brief RTNR processing functions map item. */
 struct rtnr_func_map {
 	enum sof_ipc_frame fmt; /**< source frame format */
@@ -66,7 +70,7 @@ DECLARE_TR_CTX(rtnr_tr, SOF_UUID(rtnr_uuid), LOG_LEVEL_INFO);
 /* Generic processing */
 
 /* Static functions */
-static int rtnr_set_config_bytes(struct comp_dev *dev,
+static int rtnr_set_config_bytes(struct processing_module *mod,
 				 const unsigned char *data, uint32_t size);
 
 /* Called by the processing library for debugging purpose */
@@ -74,27 +78,27 @@ void rtnr_printf(int a, int b, int c, int d, int e)
 {
 	switch (a) {
 	case 0xa:
-		comp_cl_info(&comp_rtnr, "rtnr_printf 1st=%08x, 2nd=%08x, 3rd=%08x, 4st=%08x",
+		tr_info(&rtnr_tr, "rtnr_printf 1st=%08x, 2nd=%08x, 3rd=%08x, 4st=%08x",
 					b, c, d, e);
 		break;
 
 	case 0xb:
-		comp_cl_info(&comp_rtnr, "rtnr_printf 1st=%08x, 2nd=%08x, 3rd=%08x, 4st=%08x",
+		tr_info(&rtnr_tr, "rtnr_printf 1st=%08x, 2nd=%08x, 3rd=%08x, 4st=%08x",
 					b, c, d, e);
 		break;
 
 	case 0xc:
-		comp_cl_warn(&comp_rtnr, "rtnr_printf 1st=%08x, 2nd=%08x, 3rd=%08x, 4st=%08x",
+		tr_warn(&rtnr_tr, "rtnr_printf 1st=%08x, 2nd=%08x, 3rd=%08x, 4st=%08x",
 					b, c, d, e);
 		break;
 
 	case 0xd:
-		comp_cl_dbg(&comp_rtnr, "rtnr_printf 1st=%08x, 2nd=%08x, 3rd=%08x, 4st=%08x",
+		tr_dbg(&rtnr_tr, "rtnr_printf 1st=%08x, 2nd=%08x, 3rd=%08x, 4st=%08x",
 					b, c, d, e);
 		break;
 
 	case 0xe:
-		comp_cl_err(&comp_rtnr, "rtnr_printf 1st=%08x, 2nd=%08x, 3rd=%08x, 4st=%08x",
+		tr_err(&rtnr_tr, "rtnr_printf 1st=%08x, 2nd=%08x, 3rd=%08x, 4st=%08x",
 					b, c, d, e);
 		break;
 
@@ -115,10 +119,10 @@ void rtk_rfree(void *ptr)
 
 #if CONFIG_FORMAT_S16LE
 
-static void rtnr_s16_default(struct comp_dev *dev, struct audio_stream_rtnr **sources,
-							struct audio_stream_rtnr *sink, int frames)
+static void rtnr_s16_default(struct processing_module *mod, struct audio_stream_rtnr **sources,
+			       struct audio_stream_rtnr *sink, int frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 
 	RTKMA_API_S16_Default(cd->rtk_agl, sources, sink, frames,
 						0, 0, 0,
@@ -129,10 +133,10 @@ static void rtnr_s16_default(struct comp_dev *dev, struct audio_stream_rtnr **so
 
 #if CONFIG_FORMAT_S24LE
 
-static void rtnr_s24_default(struct comp_dev *dev, struct audio_stream_rtnr **sources,
-							struct audio_stream_rtnr *sink, int frames)
+static void rtnr_s24_default(struct processing_module *mod, struct audio_stream_rtnr **sources,
+			       struct audio_stream_rtnr *sink, int frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 
 	RTKMA_API_S24_Default(cd->rtk_agl, sources, sink, frames,
 						0, 0, 0,
@@ -143,10 +147,10 @@ static void rtnr_s24_default(struct comp_dev *dev, struct audio_stream_rtnr **so
 
 #if CONFIG_FORMAT_S32LE
 
-static void rtnr_s32_default(struct comp_dev *dev, struct audio_stream_rtnr **sources,
-							struct audio_stream_rtnr *sink, int frames)
+static void rtnr_s32_default(struct processing_module *mod, struct audio_stream_rtnr **sources,
+			       struct audio_stream_rtnr *sink, int frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 
 	RTKMA_API_S32_Default(cd->rtk_agl, sources, sink, frames,
 						0, 0, 0,
@@ -193,17 +197,21 @@ static rtnr_func rtnr_find_func(enum sof_ipc_frame fmt)
 	return NULL;
 }
 
-static inline void rtnr_set_process_sample_rate(struct comp_dev *dev, uint32_t sample_rate)
+static inline void rtnr_set_process_sample_rate(struct processing_module *mod,
+						uint32_t sample_rate)
 {
-	comp_dbg(dev, "rtnr_set_process_sample_rate()");
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
+
+	comp_dbg(mod->dev, "rtnr_set_process_sample_rate()");
 
 	cd->process_sample_rate = sample_rate;
 }
 
-static int32_t rtnr_check_config_validity(struct comp_dev *dev,
-									    struct comp_data *cd)
+static int32_t rtnr_check_config_validity(struct processing_module *mod,
+					  struct comp_data *cd)
 {
+	struct comp_dev *dev = mod->dev;
+
 	comp_dbg(dev, "rtnr_check_config_validity() sample_rate:%d enabled: %d",
 		cd->config.params.sample_rate, cd->config.params.enabled);
 
@@ -214,76 +222,78 @@ static int32_t rtnr_check_config_validity(struct comp_dev *dev,
 		return -EINVAL;
 	}
 
-	rtnr_set_process_sample_rate(dev, cd->config.params.sample_rate);
+	rtnr_set_process_sample_rate(mod, cd->config.params.sample_rate);
 
 	return 0;
 }
 
-static struct comp_dev *rtnr_new(const struct comp_driver *drv,
-				 const struct comp_ipc_config *config,
-				 const void *spec)
+static int rtnr_init(struct processing_module *mod)
 {
-	const struct ipc_config_process *ipc_rtnr = spec;
-	struct comp_dev *dev;
+	struct module_data *md = &mod->priv;
+	struct comp_dev *dev = mod->dev;
+	struct module_config *cfg = &md->cfg;
 	struct comp_data *cd;
-	size_t bs = ipc_rtnr->size;
+	size_t bs = cfg->size;
 	int ret;
 
-	comp_cl_info(&comp_rtnr, "rtnr_new()");
+	comp_info(dev, "rtnr_init()");
 
 	/* Check first before proceeding with dev and cd that coefficients
 	 * blob size is sane.
 	 */
 	if (bs > SOF_RTNR_MAX_SIZE) {
-		comp_cl_err(&comp_rtnr, "rtnr_new(), error: configuration blob size = %u > %d",
-					bs, SOF_RTNR_MAX_SIZE);
-		return NULL;
+		comp_err(dev, "rtnr_init(), error: configuration blob size = %u > %d",
+			 bs, SOF_RTNR_MAX_SIZE);
+		return -EINVAL;
 	}
 
-	dev = comp_alloc(drv, sizeof(*dev));
-	if (!dev)
-		return NULL;
-
-	dev->ipc_config = *config;
-
 	cd = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*cd));
 	if (!cd)
-		goto err;
+		return -ENOMEM;
 
-	comp_set_drvdata(dev, cd);
+	md->private = cd;
 
 	cd->process_enable = true;
 
 	/* Handler for component data */
 	cd->model_handler = comp_data_blob_handler_new(dev);
 	if (!cd->model_handler) {
-		comp_cl_err(&comp_rtnr, "rtnr_new(): comp_data_blob_handler_new() failed.");
+		comp_err(dev, "rtnr_init(): comp_data_blob_handler_new() failed.");
+		ret = -ENOMEM;
 		goto cd_fail;
 	}
 
+#if CONFIG_IPC_MAJOR_4
+	/* The init IPC carries no RTNR config, run at the rate of the instance */
+	cd->config.size = sizeof(cd->config);
+	cd->config.params.enabled = 1;
+	cd->config.params.sample_rate = cfg->base_cfg.audio_fmt.sampling_frequency;
+#else
 	/* Get initial configuration from topology */
-	ret = rtnr_set_config_bytes(dev, ipc_rtnr->data, ipc_rtnr->size);
+	ret = rtnr_set_config_bytes(mod, cfg->data, bs);
 	if (ret < 0) {
-		comp_cl_err(&comp_rtnr, "rtnr_new(): failed setting initial config");
+		comp_err(dev, "rtnr_init(): failed setting initial config");
 		goto cd_fail;
 	}
+#endif
 
 	/* Component defaults */
 	cd->source_channel = 0;
 
 	/* check validity of initial config */
-	ret = rtnr_check_config_validity(dev, cd);
+	ret = rtnr_check_config_validity(mod, cd);
 	if (ret < 0) {
-		comp_cl_err(&comp_rtnr, "rtnr_new(): rtnr_check_config_validity() failed.");
+		comp_err(dev, "rtnr_init(): rtnr_check_config_validity() failed.");
 		goto cd_fail;
 	}
 
 	cd->rtk_agl = RTKMA_API_Context_Create(cd->process_sample_rate);
-	if (cd->rtk_agl == 0) {
-		comp_cl_err(&comp_rtnr, "rtnr_new(): RTKMA_API_Context_Create failed.");
+	if (!cd->rtk_agl) {
+		comp_err(dev, "rtnr_init(): RTKMA_API_Context_Create failed.");
+		ret = -ENOMEM;
 		goto cd_fail;
 	}
-	comp_cl_info(&comp_rtnr, "rtnr_new(): RTKMA_API_Context_Create succeeded.");
+	comp_info(dev, "rtnr_init(): RTKMA_API_Context_Create succeeded.");
 
 	/* comp_is_new_data_blob_available always returns false for the first
 	 * control write with non-empty config. The first non-empty write may
@@ -292,99 +302,99 @@ static struct comp_dev *rtnr_new(const struct comp_driver *drv,
 	 */
 	cd->reconfigure = true;
 
-	/* Done. */
-	dev->state = COMP_STATE_READY;
-	return dev;
+	return 0;
 
 cd_fail:
 	comp_data_blob_handler_free(cd->model_handler);
 	rfree(cd);
-
-err:
-	rfree(dev);
-	return NULL;
+	return ret;
 }
 
-static void rtnr_free(struct comp_dev *dev)
+static int rtnr_free(struct processing_module *mod)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 
-	comp_info(dev, "rtnr_free()");
+	comp_info(mod->dev, "rtnr_free()");
 
 	comp_data_blob_handler_free(cd->model_handler);
 
 	RTKMA_API_Context_Free(cd->rtk_agl);
 
 	rfree(cd);
-	rfree(dev);
+	return 0;
 }
 
-/* set component audio stream parameters */
-static int rtnr_params(struct comp_dev *dev, struct sof_ipc_stream_params *params)
+#if CONFIG_IPC_MAJOR_4
+static void rtnr_params(struct processing_module *mod)
 {
-	int ret;
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct sof_ipc_stream_params *params = mod->stream_params;
 	struct comp_buffer *sinkb, *sourceb;
-	bool channels_valid;
+	struct comp_dev *dev = mod->dev;
 
-	comp_info(dev, "rtnr_params()");
+	comp_dbg(dev, "rtnr_params()");
 
-	ret = comp_verify_params(dev, 0, params);
-	if (ret < 0) {
-		comp_err(dev, "rtnr_params() error: comp_verify_params() failed.");
-		return ret;
-	}
+	ipc4_base_module_cfg_to_stream_params(&mod->priv.cfg.base_cfg, params);
+	component_set_nearest_period_frames(dev, params->rate);
+
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+	ipc4_update_buffer_format(sinkb, &mod->priv.cfg.base_cfg.audio_fmt);
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer, sink_list);
+	ipc4_update_buffer_format(sourceb, &mod->priv.cfg.base_cfg.audio_fmt);
+}
+#endif /* CONFIG_IPC_MAJOR_4 */
 
-	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
-							sink_list);
-	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
-							source_list);
+/* check the stream parameters of the source and the sink */
+static int rtnr_check_params(struct processing_module *mod, struct sof_source *source,
+			     struct sof_sink *sink)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 
 	/* set source/sink_frames/rate */
-	cd->source_rate = audio_stream_get_rate(&sourceb->stream);
-	cd->sink_rate = audio_stream_get_rate(&sinkb->stream);
-	cd->sources_stream[0].rate = audio_stream_get_rate(&sourceb->stream);
-	cd->sink_stream.rate = audio_stream_get_rate(&sinkb->stream);
-	channels_valid = audio_stream_get_channels(&sourceb->stream) ==
-		audio_stream_get_channels(&sinkb->stream);
+	cd->source_rate = source_get_rate(source);
+	cd->sink_rate = sink_get_rate(sink);
+	cd->sources_stream[0].rate = cd->source_rate;
+	cd->sink_stream.rate = cd->sink_rate;
 
 	if (!cd->sink_rate) {
-		comp_err(dev, "rtnr_nr_params(), zero sink rate");
+		comp_err(dev, "rtnr_check_params(), zero sink rate");
 		return -EINVAL;
 	}
 
 	/* Currently support 16kHz sample rate only. */
 	switch (cd->source_rate) {
 	case 16000:
-		comp_info(dev, "rtnr_params(), sample rate = 16000 kHz");
+		comp_info(dev, "rtnr_check_params(), sample rate = 16000 kHz");
 		break;
 	case 48000:
-		comp_info(dev, "rtnr_params(), sample rate = 48000 kHz");
+		comp_info(dev, "rtnr_check_params(), sample rate = 48000 kHz");
 		break;
 	default:
-		comp_err(dev, "rtnr_nr_params(), invalid sample rate(%d kHz)",
+		comp_err(dev, "rtnr_check_params(), invalid sample rate(%d kHz)",
 			 cd->source_rate);
 		return -EINVAL;
 	}
 
-	if (!channels_valid) {
-		comp_err(dev, "rtnr_params(), source/sink stream must have same channels");
+	if (source_get_channels(source) != sink_get_channels(sink)) {
+		comp_err(dev, "rtnr_check_params(), source/sink stream must have same channels");
 		return -EINVAL;
 	}
 
 	/* set source/sink stream channels */
-	cd->sources_stream[0].channels = audio_stream_get_channels(&sourceb->stream);
-	cd->sink_stream.channels = audio_stream_get_channels(&sinkb->stream);
+	cd->sources_stream[0].channels = source_get_channels(source);
+	cd->sink_stream.channels = sink_get_channels(sink);
 
 	/* set source/sink stream overrun/underrun permitted */
-	cd->sources_stream[0].overrun_permitted = audio_stream_get_overrun(&sourceb->stream);
-	cd->sink_stream.overrun_permitted = audio_stream_get_overrun(&sinkb->stream);
-	cd->sources_stream[0].underrun_permitted = audio_stream_get_underrun(&sourceb->stream);
-	cd->sink_stream.underrun_permitted = audio_stream_get_underrun(&sinkb->stream);
+	cd->sources_stream[0].overrun_permitted = false;
+	cd->sink_stream.overrun_permitted = sink_get_overrun(sink);
+	cd->sources_stream[0].underrun_permitted = source_get_underrun(source);
+	cd->sink_stream.underrun_permitted = false;
 
 	return 0;
 }
 
+#if CONFIG_IPC_MAJOR_3
 static int rtnr_get_comp_config(struct comp_data *cd, struct sof_ipc_ctrl_data *cdata,
 				int max_data_size)
 {
@@ -402,9 +412,10 @@ static int rtnr_get_comp_config(struct comp_data *cd, struct sof_ipc_ctrl_data *
 	return 0;
 }
 
-static int rtnr_get_comp_data(struct comp_data *cd, struct sof_ipc_ctrl_data *cdata,
-				    int max_data_size)
+static int rtnr_get_comp_data(struct processing_module *mod, struct sof_ipc_ctrl_data *cdata,
+			      int max_data_size)
 {
+	struct comp_data *cd = module_get_private_data(mod);
 	uint8_t *config;
 	size_t size;
 	int ret;
@@ -419,8 +430,8 @@ static int rtnr_get_comp_data(struct comp_data *cd, struct sof_ipc_ctrl_data *cd
 			       max_data_size,
 			       config,
 			       size);
-		comp_cl_info(&comp_rtnr, "rtnr_get_comp_data(): size= %d, ret = %d",
-			     size, ret);
+		comp_info(mod->dev, "rtnr_get_comp_data(): size= %d, ret = %d",
+			  size, ret);
 		if (ret)
 			return ret;
 	}
@@ -431,10 +442,11 @@ static int rtnr_get_comp_data(struct comp_data *cd, struct sof_ipc_ctrl_data *cd
 	return 0;
 }
 
-static int rtnr_get_bin_data(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata,
-				  int max_data_size)
+static int rtnr_get_bin_data(struct processing_module *mod, struct sof_ipc_ctrl_data *cdata,
+			     int max_data_size)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 
 	if (!cd)
 		return -ENODEV;
@@ -448,35 +460,65 @@ static int rtnr_get_bin_data(struct comp_dev *dev, struct sof_ipc_ctrl_data *cda
 		return rtnr_get_comp_config(cd, cdata, max_data_size);
 	case SOF_RTNR_DATA:
 		comp_err(dev, "rtnr_get_bin_data(): SOF_RTNR_DATA");
-		return rtnr_get_comp_data(cd, cdata, max_data_size);
+		return rtnr_get_comp_data(mod, cdata, max_data_size);
 	default:
 		comp_err(dev, "rtnr_get_bin_data(): unknown binary data type");
 		return -EINVAL;
 	}
 }
 
-static int rtnr_cmd_get_data(struct comp_dev *dev,
-						struct sof_ipc_ctrl_data *cdata, int max_size)
+static int32_t rtnr_cmd_get_value(struct processing_module *mod, struct sof_ipc_ctrl_data *cdata)
 {
-	int ret = 0;
-
-	comp_dbg(dev, "rtnr_cmd_get_data(), SOF_CTRL_CMD_BINARY");
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
+	int32_t j;
+	int32_t ret = 0;
 
 	switch (cdata->cmd) {
-	case SOF_CTRL_CMD_BINARY:
-		return rtnr_get_bin_data(dev, cdata, max_size);
+	case SOF_CTRL_CMD_SWITCH:
+		for (j = 0; j < cdata->num_elems; j++) {
+			cdata->chanv[j].channel = j;
+			cdata->chanv[j].value = cd->process_enable;
+			comp_info(dev, "rtnr_cmd_get_value(), channel = %u, value = %u",
+				  cdata->chanv[j].channel,
+				  cdata->chanv[j].value);
+		}
+		break;
 	default:
-		comp_err(dev, "rtnr_cmd_get_data() error: invalid command %d", cdata->cmd);
+		comp_err(dev, "rtnr_cmd_get_value() error: invalid cdata->cmd %d", cdata->cmd);
 		ret = -EINVAL;
 		break;
 	}
-
 	return ret;
 }
+#endif /* CONFIG_IPC_MAJOR_3 */
 
-static int rtnr_reconfigure(struct comp_dev *dev)
+static int rtnr_get_config(struct processing_module *mod,
+			   uint32_t config_id, uint32_t *data_offset_size,
+			   uint8_t *fragment, size_t fragment_size)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct sof_ipc_ctrl_data *cdata = (struct sof_ipc_ctrl_data *)fragment;
+
+	comp_dbg(mod->dev, "rtnr_get_config()");
+
+#if CONFIG_IPC_MAJOR_3
+	switch (cdata->cmd) {
+	case SOF_CTRL_CMD_BINARY:
+		return rtnr_get_bin_data(mod, cdata, fragment_size);
+	default:
+		return rtnr_cmd_get_value(mod, cdata);
+	}
+#else
+	struct comp_data *cd = module_get_private_data(mod);
+
+	return comp_data_blob_get_cmd(cd->model_handler, cdata, fragment_size);
+#endif
+}
+
+static int rtnr_reconfigure(struct processing_module *mod)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 	uint8_t *config;
 	size_t size;
 
@@ -518,10 +560,11 @@ static int rtnr_reconfigure(struct comp_dev *dev)
 	return 0;
 }
 
-static int rtnr_set_config_bytes(struct comp_dev *dev,
+static int rtnr_set_config_bytes(struct processing_module *mod,
 				 const unsigned char *data, uint32_t size)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 	int ret;
 
 	/*
@@ -549,27 +592,38 @@ static int rtnr_set_config_bytes(struct comp_dev *dev,
 	return ret;
 }
 
-static int rtnr_set_bin_data(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
+static int rtnr_set_bin_data(struct processing_module *mod, uint32_t type,
+			     enum module_cfg_fragment_position pos,
+			     uint32_t data_offset_size, const uint8_t *fragment,
+			     size_t fragment_size)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 	int ret = 0;
 
 	assert(cd);
-	comp_dbg(dev,
-		 "rtnr_set_bin_data(): type = %u", cdata->data->type);
+	comp_dbg(dev, "rtnr_set_bin_data(): type = %u", type);
 
 	if (dev->state < COMP_STATE_READY) {
 		comp_err(dev, "rtnr_set_bin_data(): driver in init!");
 		return -EBUSY;
 	}
 
-	switch (cdata->data->type) {
+	switch (type) {
 	case SOF_RTNR_CONFIG:
-		return rtnr_set_config_bytes(dev,
-					     (unsigned char *)cdata->data->data,
+#if CONFIG_IPC_MAJOR_3
+	{
+		struct sof_ipc_ctrl_data *cdata = (struct sof_ipc_ctrl_data *)fragment;
+
+		return rtnr_set_config_bytes(mod, (unsigned char *)cdata->data->data,
 					     cdata->data->size);
+	}
+#else
+		return rtnr_set_config_bytes(mod, fragment, fragment_size);
+#endif
 	case SOF_RTNR_DATA:
-		ret = comp_data_blob_set_cmd(cd->model_handler, cdata);
+		ret = comp_data_blob_set(cd->model_handler, pos, data_offset_size, fragment,
+					 fragment_size);
 		if (ret)
 			return ret;
 		/* Accept the new blob immediately so that userspace can write
@@ -595,168 +649,134 @@ static int rtnr_set_bin_data(struct comp_dev *dev, struct sof_ipc_ctrl_data *cda
 	return ret;
 }
 
-static int rtnr_cmd_set_data(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
+static void rtnr_set_value(struct processing_module *mod, uint32_t val)
 {
-	int ret;
-
-	switch (cdata->cmd) {
-	case SOF_CTRL_CMD_BINARY:
-		comp_info(dev, "rtnr_cmd_set_data(), SOF_CTRL_CMD_BINARY");
-		return rtnr_set_bin_data(dev, cdata);
-	default:
-		comp_err(dev, "rtnr_cmd_set_data() error: invalid command %d", cdata->cmd);
-		ret = -EINVAL;
-		break;
-	}
-
-	return ret;
-}
-
-static int32_t rtnr_cmd_get_value(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
-{
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t j;
-	int32_t ret = 0;
-
-	switch (cdata->cmd) {
-	case SOF_CTRL_CMD_SWITCH:
-		for (j = 0; j < cdata->num_elems; j++) {
-			cdata->chanv[j].channel = j;
-			cdata->chanv[j].value = cd->process_enable;
-			comp_info(dev, "rtnr_cmd_get_value(), channel = %u, value = %u",
-					cdata->chanv[j].channel,
-					cdata->chanv[j].value);
-		}
-		break;
-	default:
-		comp_err(dev, "rtnr_cmd_get_value() error: invalid cdata->cmd %d", cdata->cmd);
-		ret = -EINVAL;
-		break;
-	}
-	return ret;
-}
-
-static int32_t rtnr_set_value(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
-{
-	uint32_t val = 0;
-	int32_t j;
-	struct comp_data *cd = comp_get_drvdata(dev);
-
-	for (j = 0; j < cdata->num_elems; j++) {
-		val |= cdata->chanv[j].value;
-		comp_info(dev, "rtnr_set_value(), value = %u", val);
-	}
+	struct comp_data *cd = module_get_private_data(mod);
 
 	if (val) {
-		comp_info(dev, "rtnr_set_value(): enabled");
+		comp_info(mod->dev, "rtnr_set_value(): enabled");
 		cd->process_enable = true;
 	} else {
-		comp_info(dev, "rtnr_set_value(): passthrough");
+		comp_info(mod->dev, "rtnr_set_value(): passthrough");
 		cd->process_enable = false;
 	}
-
-	return 0;
 }
 
-static int32_t rtnr_cmd_set_value(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
+static int rtnr_set_config(struct processing_module *mod, uint32_t param_id,
+			   enum module_cfg_fragment_position pos,
+			   uint32_t data_offset_size, const uint8_t *fragment,
+			   size_t fragment_size, uint8_t *response,
+			   size_t response_size)
 {
-	int32_t ret = 0;
+	struct comp_dev *dev = mod->dev;
+	uint32_t val = 0;
+	int32_t j;
 
-	switch (cdata->cmd) {
-	case SOF_CTRL_CMD_SWITCH:
-		comp_dbg(dev, "rtnr_cmd_set_value(), SOF_CTRL_CMD_SWITCH, cdata->comp_id = %u",
-				cdata->comp_id);
-		ret = rtnr_set_value(dev, cdata);
-		break;
+	comp_dbg(dev, "rtnr_set_config()");
 
-	default:
-		comp_err(dev, "rtnr_cmd_set_value() error: invalid cdata->cmd");
-		ret = -EINVAL;
-		break;
-	}
+#if CONFIG_IPC_MAJOR_4
+	struct sof_ipc4_control_msg_payload *ctl = (struct sof_ipc4_control_msg_payload *)fragment;
 
-	return ret;
-}
+	switch (param_id) {
+	case SOF_IPC4_SWITCH_CONTROL_PARAM_ID:
+		comp_dbg(dev, "SOF_IPC4_SWITCH_CONTROL_PARAM_ID id = %d, num_elems = %d",
+			 ctl->id, ctl->num_elems);
 
-/* used to pass standard and bespoke commands (with data) to component */
-static int rtnr_cmd(struct comp_dev *dev, int cmd, void *data,
-					int max_data_size)
-{
-	struct sof_ipc_ctrl_data *cdata = ASSUME_ALIGNED(data, 4);
-	int ret = 0;
+		for (j = 0; j < ctl->num_elems; j++)
+			val |= ctl->chanv[j].value;
+		rtnr_set_value(mod, val);
+		return 0;
+
+	case SOF_IPC4_ENUM_CONTROL_PARAM_ID:
+		comp_err(dev, "rtnr_set_config(), illegal control.");
+		return -EINVAL;
+	}
 
-	comp_info(dev, "rtnr_cmd()");
+#elif CONFIG_IPC_MAJOR_3
+	struct sof_ipc_ctrl_data *cdata = (struct sof_ipc_ctrl_data *)fragment;
 
-	switch (cmd) {
-	case COMP_CMD_SET_DATA:
-		ret = rtnr_cmd_set_data(dev, cdata);
-		break;
-	case COMP_CMD_GET_DATA:
-		ret = rtnr_cmd_get_data(dev, cdata, max_data_size);
-		break;
-	case COMP_CMD_SET_VALUE:
-		ret = rtnr_cmd_set_value(dev, cdata);
-		break;
-	case COMP_CMD_GET_VALUE:
-		ret = rtnr_cmd_get_value(dev, cdata);
+	switch (cdata->cmd) {
+	case SOF_CTRL_CMD_BINARY:
 		break;
+	case SOF_CTRL_CMD_SWITCH:
+		comp_dbg(dev, "rtnr_set_config(), SOF_CTRL_CMD_SWITCH, cdata->comp_id = %u",
+			 cdata->comp_id);
+		for (j = 0; j < cdata->num_elems; j++)
+			val |= cdata->chanv[j].value;
+		rtnr_set_value(mod, val);
+		return 0;
 	default:
-		comp_err(dev, "rtnr_cmd() error: invalid command");
+		comp_err(dev, "rtnr_set_config() error: invalid cdata->cmd %d", cdata->cmd);
 		return -EINVAL;
 	}
+#endif
 
-	return ret;
+	comp_info(dev, "rtnr_set_config(), SOF_CTRL_CMD_BINARY");
+	return rtnr_set_bin_data(mod, param_id, pos, data_offset_size, fragment, fragment_size);
 }
 
-static int rtnr_trigger(struct comp_dev *dev, int cmd)
+/* describe a circular buffer fragment of the sink/source API to the library */
+static void rtnr_stream_from_source(struct audio_stream_rtnr *dst, const void *data_ptr,
+				    const void *buffer_start, size_t buffer_size, size_t bytes)
 {
-	comp_info(dev, "rtnr_trigger() cmd: %d", cmd);
-
-	return comp_set_state(dev, cmd);
+	uint8_t *addr = (uint8_t *)buffer_start;
+
+	dst->size = buffer_size;
+	dst->avail = bytes;
+	dst->free = buffer_size - bytes;
+	dst->r_ptr = (void *)data_ptr;
+	dst->w_ptr = cir_buf_wrap((uint8_t *)data_ptr + bytes, addr, addr + buffer_size);
+	dst->addr = addr;
+	dst->end_addr = addr + buffer_size;
 }
 
-static void rtnr_copy_from_sof_stream(struct audio_stream_rtnr *dst,
-				      struct audio_stream *src)
+static void rtnr_stream_from_sink(struct audio_stream_rtnr *dst, void *data_ptr,
+				  void *buffer_start, size_t buffer_size, size_t bytes)
 {
-
-	dst->size = audio_stream_get_size(src);
-	dst->avail = audio_stream_get_avail(src);
-	dst->free = audio_stream_get_free(src);
-	dst->w_ptr = audio_stream_get_wptr(src);
-	dst->r_ptr = audio_stream_get_rptr(src);
-	dst->addr = audio_stream_get_addr(src);
-	dst->end_addr = audio_stream_get_end_addr(src);
+	uint8_t *addr = buffer_start;
+
+	dst->size = buffer_size;
+	dst->avail = buffer_size - bytes;
+	dst->free = bytes;
+	dst->w_ptr = data_ptr;
+	dst->r_ptr = cir_buf_wrap((uint8_t *)data_ptr + bytes, addr, addr + buffer_size);
+	dst->addr = addr;
+	dst->end_addr = addr + buffer_size;
 }
 
-static void rtnr_copy_to_sof_stream(struct audio_stream *dst,
-				    struct audio_stream_rtnr *src)
+/* A DP instance runs once per library block */
+static bool rtnr_is_ready_to_process(struct processing_module *mod,
+				     struct sof_source **sources, int num_of_sources,
+				     struct sof_sink **sinks, int num_of_sinks)
 {
-	audio_stream_set_size(dst, src->size);
-	audio_stream_set_avail(dst, src->avail);
-	audio_stream_set_free(dst, src->free);
-	audio_stream_set_wptr(dst, src->w_ptr);
-	audio_stream_set_rptr(dst, src->r_ptr);
-	audio_stream_set_addr(dst, src->addr);
-	audio_stream_set_end_addr(dst, src->end_addr);
+	struct comp_data *cd = module_get_private_data(mod);
+
+	return source_get_data_frames_available(sources[0]) >= cd->frames &&
+		sink_get_free_frames(sinks[0]) >= cd->frames;
 }
 
-/* copy and process stream data from source to sink buffers */
-static int rtnr_copy(struct comp_dev *dev)
+/* process stream data from source to sink */
+static int rtnr_process(struct processing_module *mod,
+			struct sof_source **sources, int num_of_sources,
+			struct sof_sink **sinks, int num_of_sinks)
 {
-	struct comp_buffer *sink;
-	struct comp_buffer *source;
-	int frames;
-	int sink_bytes;
-	int source_bytes;
-	struct comp_copy_limits cl;
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
+	struct sof_source *source = sources[0];
+	struct sof_sink *sink = sinks[0];
 	struct audio_stream_rtnr *sources_stream[RTNR_MAX_SOURCES];
 	struct audio_stream_rtnr *sink_stream = &cd->sink_stream;
+	const void *src_ptr, *src_start;
+	void *dst_ptr, *dst_start;
+	size_t src_size, dst_size;
+	int source_bytes;
+	int sink_bytes;
+	int frames;
 	int32_t i;
 	int ret;
 
 	if (cd->reconfigure) {
-		ret = rtnr_reconfigure(dev);
+		ret = rtnr_reconfigure(mod);
 		if (ret)
 			return ret;
 	}
@@ -764,114 +784,112 @@ static int rtnr_copy(struct comp_dev *dev)
 	for (i = 0; i < RTNR_MAX_SOURCES; ++i)
 		sources_stream[i] = &cd->sources_stream[i];
 
-	comp_dbg(dev, "rtnr_copy()");
-
-	source = list_first_item(&dev->bsource_list, struct comp_buffer, sink_list);
+	comp_dbg(dev, "rtnr_process()");
 
 	/* put empty data into output queue*/
-	RTKMA_API_First_Copy(cd->rtk_agl, cd->source_rate,
-			     audio_stream_get_channels(&source->stream));
+	RTKMA_API_First_Copy(cd->rtk_agl, cd->source_rate, source_get_channels(source));
 
-	sink = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+	frames = MIN(source_get_data_frames_available(source), sink_get_free_frames(sink));
 
-	if (cd->process_enable) {
-		frames = audio_stream_avail_frames(&source->stream, &sink->stream);
+	if (!cd->process_enable) {
+		comp_dbg(dev, "rtnr_process() passthrough");
+		return source_to_sink_copy(source, sink, true,
+					   frames * source_get_frame_bytes(source));
+	}
 
-		/* Process integer multiple of RTNR internal block length */
+	/* Process integer multiple of RTNR internal block length, in DP
+	 * the library gets whole blocks only
+	 */
+	if (dev->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_DP)
+		frames -= frames % cd->frames;
+	else
 		frames = frames & ~RTNR_BLK_LENGTH_MASK;
 
-		comp_dbg(dev, "rtnr_copy() source->id: %d, frames = %d", source->id, frames);
-
-		if (frames) {
-			source_bytes = frames * audio_stream_frame_bytes(&source->stream);
-			sink_bytes = frames * audio_stream_frame_bytes(&sink->stream);
-
-			buffer_stream_invalidate(source, source_bytes);
-
-			/* Run processing function */
+	comp_dbg(dev, "rtnr_process() frames = %d", frames);
 
-			/* copy required data from sof audio stream to RTNR audio stream */
-			rtnr_copy_from_sof_stream(sources_stream[0], &source->stream);
-			rtnr_copy_from_sof_stream(sink_stream, &sink->stream);
-
-			/*
-			 * Processing function uses an array of pointers to source streams
-			 * as parameter.
-			 */
-			cd->rtnr_func(dev, (struct audio_stream_rtnr **)&sources_stream,
-						sink_stream, frames);
-
-			/*
-			 * real process function of rtnr, consume/produce data from internal queue
-			 * instead of component buffer
-			 */
-			RTKMA_API_Process(cd->rtk_agl, 0, cd->source_rate, MicNum);
+	if (!frames)
+		return 0;
 
-			/* copy required data from RTNR audio stream to sof audio stream */
-			rtnr_copy_to_sof_stream(&source->stream, sources_stream[0]);
-			rtnr_copy_to_sof_stream(&sink->stream, sink_stream);
+	source_bytes = frames * source_get_frame_bytes(source);
+	sink_bytes = frames * sink_get_frame_bytes(sink);
 
-			buffer_stream_writeback(sink, sink_bytes);
+	ret = source_get_data(source, source_bytes, &src_ptr, &src_start, &src_size);
+	if (ret)
+		return ret;
 
-			/* Track consume and produce */
-			comp_update_buffer_consume(source, source_bytes);
-			comp_update_buffer_produce(sink, sink_bytes);
-		}
-	} else {
-		comp_dbg(dev, "rtnr_copy() passthrough");
+	ret = sink_get_buffer(sink, sink_bytes, &dst_ptr, &dst_start, &dst_size);
+	if (ret) {
+		source_release_data(source, 0);
+		return ret;
+	}
 
-		/* Get source, sink, number of frames etc. to process. */
-		comp_get_copy_limits(source, sink, &cl);
+	/* describe the data to the library as RTNR audio streams */
+	rtnr_stream_from_source(sources_stream[0], src_ptr, src_start, src_size, source_bytes);
+	rtnr_stream_from_sink(sink_stream, dst_ptr, dst_start, dst_size, sink_bytes);
 
-		buffer_stream_invalidate(source, cl.source_bytes);
+	/*
+	 * Processing function uses an array of pointers to source streams
+	 * as parameter.
+	 */
+	cd->rtnr_func(mod, (struct audio_stream_rtnr **)&sources_stream, sink_stream, frames);
 
-		audio_stream_copy(&source->stream, 0, &sink->stream, 0,
-				audio_stream_get_channels(&source->stream) * cl.frames);
+	/*
+	 * real process function of rtnr, consume/produce data from internal queue
+	 * instead of component buffer
+	 */
+	RTKMA_API_Process(cd->rtk_agl, 0, cd->source_rate, MicNum);
 
-		buffer_stream_writeback(sink, cl.sink_bytes);
-		comp_update_buffer_consume(source, cl.source_bytes);
-		comp_update_buffer_produce(sink, cl.sink_bytes);
-	}
+	/* Track consume and produce */
+	source_release_data(source, source_bytes);
+	sink_commit_buffer(sink, sink_bytes);
 
 	return 0;
 }
 
-static int rtnr_prepare(struct comp_dev *dev)
+static int rtnr_prepare(struct processing_module *mod,
+			struct sof_source **sources, int num_of_sources,
+			struct sof_sink **sinks, int num_of_sinks)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct comp_buffer *sinkb;
-	struct comp_buffer *sink_c;
+	struct comp_data *cd = module_get_private_data(mod);
+	struct comp_dev *dev = mod->dev;
 	int ret;
 
 	comp_dbg(dev, "rtnr_prepare()");
 
-	ret = comp_set_state(dev, COMP_TRIGGER_PREPARE);
+#if CONFIG_IPC_MAJOR_4
+	rtnr_params(mod);
+#endif
+
+	ret = rtnr_check_params(mod, sources[0], sinks[0]);
 	if (ret < 0)
 		return ret;
 
-	if (ret == COMP_STATUS_STATE_ALREADY_SET)
-		return PPL_STATUS_PATH_STOP;
-
 	/* Check config */
-	ret = rtnr_check_config_validity(dev, cd);
+	ret = rtnr_check_config_validity(mod, cd);
 	if (ret < 0) {
-		comp_cl_err(&comp_rtnr, "rtnr_prepare(): rtnr_check_config_validity() failed.");
-		goto err;
+		comp_err(dev, "rtnr_prepare(): rtnr_check_config_validity() failed.");
+		return ret;
 	}
 
 	/* Initialize RTNR */
 
 	/* Get sink data format */
-	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
-	cd->sink_format = audio_stream_get_frm_fmt(&sinkb->stream);
-	cd->sink_stream.frame_fmt = audio_stream_get_frm_fmt(&sinkb->stream);
+	cd->sink_format = sink_get_frm_fmt(sinks[0]);
+	cd->sink_stream.frame_fmt = cd->sink_format;
 
 	/* Check source and sink PCM format and get processing function */
 	comp_info(dev, "rtnr_prepare(), sink_format=%d", cd->sink_format);
 	cd->rtnr_func = rtnr_find_func(cd->sink_format);
 	if (!cd->rtnr_func) {
 		comp_err(dev, "rtnr_prepare(): No suitable processing function found.");
-		goto err;
+		return -EINVAL;
+	}
+
+	/* A DP instance gets whole library blocks, size its queues for them */
+	cd->frames = cd->source_rate * RTNR_FRAME_MS / 1000;
+	if (dev->ipc_config.proc_domain == COMP_PROCESSING_DOMAIN_DP) {
+		source_set_min_available(sources[0], cd->frames * source_get_frame_bytes(sources[0]));
+		sink_set_min_free_space(sinks[0], cd->frames * sink_get_frame_bytes(sinks[0]));
 	}
 
 	/* Clear in/out buffers */
@@ -880,52 +898,34 @@ static int rtnr_prepare(struct comp_dev *dev)
 	/* Blobs sent during COMP_STATE_READY is assigned to blob_handler->data
 	 * directly, so comp_is_new_data_blob_available always returns false.
 	 */
-	return rtnr_reconfigure(dev);
-
-err:
-	comp_set_state(dev, COMP_TRIGGER_RESET);
-	return ret;
+	return rtnr_reconfigure(mod);
 }
 
-static int rtnr_reset(struct comp_dev *dev)
+static int rtnr_reset(struct processing_module *mod)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_data *cd = module_get_private_data(mod);
 
-	comp_info(dev, "rtnr_reset()");
+	comp_info(mod->dev, "rtnr_reset()");
 
 	cd->sink_format = 0;
 	cd->rtnr_func = NULL;
 	cd->source_rate = 0;
 	cd->sink_rate = 0;
+	cd->frames = 0;
 
-	comp_set_state(dev, COMP_TRIGGER_RESET);
 	return 0;
 }
 
-static const struct comp_driver comp_rtnr = {
-	.uid = SOF_RT_UUID(rtnr_uuid),
-	.tctx = &rtnr_tr,
-	.ops = {
-		.create = rtnr_new,
-		.free = rtnr_free,
-		.params = rtnr_params,
-		.cmd = rtnr_cmd,
-		.trigger = rtnr_trigger,
-		.copy = rtnr_copy,
-		.prepare = rtnr_prepare,
-		.reset = rtnr_reset,
-	},
-};
-
-static SHARED_DATA struct comp_driver_info comp_rtnr_info = {
-	.drv = &comp_rtnr,
+static struct module_interface rtnr_interface = {
+	.init = rtnr_init,
+	.prepare = rtnr_prepare,
+	.process = rtnr_process,
+	.is_ready_to_process = rtnr_is_ready_to_process,
+	.set_configuration = rtnr_set_config,
+	.get_configuration = rtnr_get_config,
+	.reset = rtnr_reset,
+	.free = rtnr_free,
 };
 
-UT_STATIC void sys_comp_rtnr_init(void)
-{
-	comp_register(platform_shared_get(&comp_rtnr_info, sizeof(comp_rtnr_info)));
-}
-
-
-DECLARE_MODULE(sys_comp_rtnr_init);
-SOF_MODULE_INIT(rtnr, sys_comp_rtnr_init);
+DECLARE_MODULE_ADAPTER(rtnr_interface, rtnr_uuid, rtnr_tr);
+SOF_MODULE_INIT(rtnr, sys_comp_module_rtnr_interface_init);
@@ -778,6 +778,16 @@ static int selector_set_config(struct processing_module *mod, uint32_t config_id
 			return -EINVAL;
 
 		memcpy_s(&cd->coeffs_config, sizeof(cd->coeffs_config), fragment, data_offset_size);
+
+		/* new coefficients may need another processing mode once prepared */
+		if (cd->sel_func) {
+			cd->sel_func = sel_get_processing_function(mod);
+			if (!cd->sel_func) {
+				comp_err(mod->dev, "selector_set_config(): no processing function");
+				return -EINVAL;
+			}
+		}
+
 		return 0;
 	}
 
@@ -169,6 +169,145 @@ static void sel_s32le_nch(struct comp_dev *dev, struct audio_stream *sink,
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
 
 #else
+/** \brief Unity mixing coefficient in Q10. */
+#define SEL_COEFF_ONE	(1 << 10)
+
+/**
+ * \brief Channel copy for any format, the sink has the source channels in the same order.
+ * \param[in] mod Selector base module device.
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Sink buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void sel_copy(struct processing_module *mod, struct input_stream_buffer *bsource,
+		     struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	int8_t *src = audio_stream_get_rptr(source);
+	int8_t *dst = audio_stream_get_wptr(sink);
+	int bmax;
+	int b;
+	int bytes_copied = 0;
+	const int bytes_total = frames * audio_stream_frame_bytes(source);
+
+	while (bytes_copied < bytes_total) {
+		b = bytes_total - bytes_copied;
+		bmax = audio_stream_bytes_without_wrap(source, src);
+		b = MIN(b, bmax);
+		bmax = audio_stream_bytes_without_wrap(sink, dst);
+		b = MIN(b, bmax);
+		memcpy_s(dst, b, src, b);
+		src = audio_stream_wrap(source, src + b);
+		dst = audio_stream_wrap(sink, dst + b);
+		bytes_copied += b;
+	}
+
+	module_update_buffer_position(bsource, bsink, frames);
+}
+
+#ifdef SEL_GENERIC
+#if CONFIG_FORMAT_S16LE
+/**
+ * \brief Channel pick for 16-bit, every sink channel copies one source channel.
+ * \param[in] mod Selector base module device.
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Sink buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void sel_s16le_pick(struct processing_module *mod, struct input_stream_buffer *bsource,
+			   struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	int16_t *src = audio_stream_get_rptr(source);
+	int16_t *dest = audio_stream_get_wptr(sink);
+	int16_t *in;
+	int16_t *out;
+	int nmax;
+	int ch;
+	int i;
+	int n;
+	int processed = 0;
+	const int nch_source = audio_stream_get_channels(source);
+	const int nch_sink = audio_stream_get_channels(sink);
+
+	while (processed < frames) {
+		n = frames - processed;
+		nmax = audio_stream_frames_without_wrap(source, src);
+		n = MIN(n, nmax);
+		nmax = audio_stream_frames_without_wrap(sink, dest);
+		n = MIN(n, nmax);
+		for (ch = 0; ch < nch_sink; ch++) {
+			in = src + cd->pick[ch];
+			out = dest + ch;
+			for (i = 0; i < n; i++) {
+				*out = *in;
+				in += nch_source;
+				out += nch_sink;
+			}
+		}
+		src = audio_stream_wrap(source, src + n * nch_source);
+		dest = audio_stream_wrap(sink, dest + n * nch_sink);
+		processed += n;
+	}
+
+	module_update_buffer_position(bsource, bsink, frames);
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+/**
+ * \brief Channel pick for 32-bit, every sink channel copies one source channel.
+ * \param[in] mod Selector base module device.
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Sink buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void sel_s32le_pick(struct processing_module *mod, struct input_stream_buffer *bsource,
+			   struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	int32_t *src = audio_stream_get_rptr(source);
+	int32_t *dest = audio_stream_get_wptr(sink);
+	int32_t *in;
+	int32_t *out;
+	int nmax;
+	int ch;
+	int i;
+	int n;
+	int processed = 0;
+	const int nch_source = audio_stream_get_channels(source);
+	const int nch_sink = audio_stream_get_channels(sink);
+
+	while (processed < frames) {
+		n = frames - processed;
+		nmax = audio_stream_frames_without_wrap(source, src);
+		n = MIN(n, nmax);
+		nmax = audio_stream_frames_without_wrap(sink, dest);
+		n = MIN(n, nmax);
+		for (ch = 0; ch < nch_sink; ch++) {
+			in = src + cd->pick[ch];
+			out = dest + ch;
+			for (i = 0; i < n; i++) {
+				*out = *in;
+				in += nch_source;
+				out += nch_sink;
+			}
+		}
+		src = audio_stream_wrap(source, src + n * nch_source);
+		dest = audio_stream_wrap(sink, dest + n * nch_sink);
+		processed += n;
+	}
+
+	module_update_buffer_position(bsource, bsink, frames);
+}
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+#endif /* SEL_GENERIC */
+
 #if CONFIG_FORMAT_S16LE
 /**
  * \brief Mixing routine for 16-bit, m channel input x n channel output single frame.
@@ -240,7 +379,7 @@ static void sel_s16le(struct processing_module *mod, struct input_stream_buffer
 }
 #endif /* CONFIG_FORMAT_S16LE */
 
-#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+#if (CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE) && defined(SEL_GENERIC)
 /**
  * \brief Mixing routine for 32-bit, m channel input x n channel output single frame.
  * \param[out] dst Sink buffer.
@@ -309,7 +448,7 @@ static void sel_s32le(struct processing_module *mod, struct input_stream_buffer
 
 	module_update_buffer_position(bsource, bsink, frames);
 }
-#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+#endif /* (CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE) && SEL_GENERIC */
 #endif
 
 const struct comp_func_map func_table[] = {
@@ -331,13 +470,33 @@ const struct comp_func_map func_table[] = {
 #endif /* CONFIG_FORMAT_S32LE */
 #else
 #if CONFIG_FORMAT_S16LE
-	{SOF_IPC_FRAME_S16_LE, 0, sel_s16le},
+	{SOF_IPC_FRAME_S16_LE, 0, SEL_MODE_COPY, sel_copy},
+#ifdef SEL_HIFI3
+	{SOF_IPC_FRAME_S16_LE, 0, SEL_MODE_PICK, sel_s16le_pick_hifi3},
+#else
+	{SOF_IPC_FRAME_S16_LE, 0, SEL_MODE_PICK, sel_s16le_pick},
+#endif
+	{SOF_IPC_FRAME_S16_LE, 0, SEL_MODE_MIX, sel_s16le},
 #endif
 #if CONFIG_FORMAT_S24LE
-	{SOF_IPC_FRAME_S24_4LE, 0, sel_s32le},
+	{SOF_IPC_FRAME_S24_4LE, 0, SEL_MODE_COPY, sel_copy},
+#ifdef SEL_HIFI3
+	{SOF_IPC_FRAME_S24_4LE, 0, SEL_MODE_PICK, sel_s32le_pick_hifi3},
+	{SOF_IPC_FRAME_S24_4LE, 0, SEL_MODE_MIX, sel_s32le_hifi3},
+#else
+	{SOF_IPC_FRAME_S24_4LE, 0, SEL_MODE_PICK, sel_s32le_pick},
+	{SOF_IPC_FRAME_S24_4LE, 0, SEL_MODE_MIX, sel_s32le},
+#endif
 #endif
 #if CONFIG_FORMAT_S32LE
-	{SOF_IPC_FRAME_S32_LE, 0, sel_s32le},
+	{SOF_IPC_FRAME_S32_LE, 0, SEL_MODE_COPY, sel_copy},
+#ifdef SEL_HIFI3
+	{SOF_IPC_FRAME_S32_LE, 0, SEL_MODE_PICK, sel_s32le_pick_hifi3},
+	{SOF_IPC_FRAME_S32_LE, 0, SEL_MODE_MIX, sel_s32le_hifi3},
+#else
+	{SOF_IPC_FRAME_S32_LE, 0, SEL_MODE_PICK, sel_s32le_pick},
+	{SOF_IPC_FRAME_S32_LE, 0, SEL_MODE_MIX, sel_s32le},
+#endif
 #endif
 #endif
 };
@@ -362,15 +521,65 @@ sel_func sel_get_processing_function(struct comp_dev *dev)
 	return NULL;
 }
 #else
+/**
+ * \brief Sets the processing mode the coefficients require.
+ *
+ * The coefficients only route channels when every sink channel has a single
+ * unity coefficient, the pick map then holds the source channel of each sink
+ * channel. Unity coefficients result in a bit exact copy with the mixing
+ * functions as well.
+ * \param[in,out] cd Selector private data.
+ */
+static void sel_set_mode(struct comp_data *cd)
+{
+	const int n_source = cd->config.in_channels_count;
+	const int n_sink = cd->config.out_channels_count;
+	bool copy = n_source == n_sink;
+	int picked;
+	int i, j;
+
+	cd->mode = SEL_MODE_MIX;
+
+	/* the mixing functions process the supported channels only */
+	if (n_source > SEL_SOURCE_CHANNELS_MAX || n_sink > SEL_SINK_CHANNELS_MAX)
+		return;
+
+	for (i = 0; i < n_sink; i++) {
+		picked = -1;
+		for (j = 0; j < n_source; j++) {
+			if (!cd->coeffs_config.coeffs[i][j])
+				continue;
+
+			if (cd->coeffs_config.coeffs[i][j] != SEL_COEFF_ONE || picked >= 0)
+				return;
+
+			picked = j;
+		}
+
+		/* a muted sink channel is left to the mixing function */
+		if (picked < 0)
+			return;
+
+		cd->pick[i] = picked;
+		copy = copy && picked == i;
+	}
+
+	cd->mode = copy ? SEL_MODE_COPY : SEL_MODE_PICK;
+}
+
 sel_func sel_get_processing_function(struct processing_module *mod)
 {
 	struct comp_data *cd = module_get_private_data(mod);
 	int i;
 
+	sel_set_mode(cd);
+
 	/* map the channel selection function for source and sink buffers */
 	for (i = 0; i < ARRAY_SIZE(func_table); i++) {
 		if (cd->source_format != func_table[i].source)
 			continue;
+		if (cd->mode != func_table[i].mode)
+			continue;
 
 		/* TODO: add additional criteria as needed */
 		return func_table[i].sel_func;
@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/**
+ * \file
+ * \brief Audio channel selector / extractor - HiFi3 processing functions
+ */
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/audio/selector.h>
+#include <sof/common.h>
+#include <ipc/stream.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if CONFIG_IPC_MAJOR_4 && defined(SEL_HIFI3)
+
+#include <xtensa/tie/xt_hifi3.h>
+
+LOG_MODULE_DECLARE(selector, CONFIG_SOF_LOG_LEVEL);
+
+#if CONFIG_FORMAT_S16LE
+/**
+ * \brief Channel pick for 16-bit, every sink channel copies one source channel.
+ *
+ * Each sink channel is copied with strided loads and stores of one sample per frame.
+ * \param[in] mod Selector base module device.
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Sink buffer.
+ * \param[in] frames Number of frames to process.
+ */
+void sel_s16le_pick_hifi3(struct processing_module *mod, struct input_stream_buffer *bsource,
+			  struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	int16_t *src = audio_stream_get_rptr(source);
+	int16_t *dst = audio_stream_get_wptr(sink);
+	ae_int16x4 sample;
+	ae_int16 *in;
+	ae_int16 *out;
+	const int nch_source = audio_stream_get_channels(source);
+	const int nch_sink = audio_stream_get_channels(sink);
+	const int inc_source = nch_source * sizeof(int16_t);
+	const int inc_sink = nch_sink * sizeof(int16_t);
+	int processed = 0;
+	int nmax;
+	int ch;
+	int i;
+	int n;
+
+	while (processed < frames) {
+		n = frames - processed;
+		nmax = audio_stream_frames_without_wrap(source, src);
+		n = MIN(n, nmax);
+		nmax = audio_stream_frames_without_wrap(sink, dst);
+		n = MIN(n, nmax);
+		for (ch = 0; ch < nch_sink; ch++) {
+			in = (ae_int16 *)(src + cd->pick[ch]);
+			out = (ae_int16 *)(dst + ch);
+			for (i = 0; i < n; i++) {
+				AE_L16_XP(sample, in, inc_source);
+				AE_S16_0_XP(sample, out, inc_sink);
+			}
+		}
+		src = audio_stream_wrap(source, src + n * nch_source);
+		dst = audio_stream_wrap(sink, dst + n * nch_sink);
+		processed += n;
+	}
+
+	module_update_buffer_position(bsource, bsink, frames);
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+/**
+ * \brief Channel pick for 32-bit, every sink channel copies one source channel.
+ *
+ * Each sink channel is copied with strided loads and stores of one sample per frame.
+ * \param[in] mod Selector base module device.
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Sink buffer.
+ * \param[in] frames Number of frames to process.
+ */
+void sel_s32le_pick_hifi3(struct processing_module *mod, struct input_stream_buffer *bsource,
+			  struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	int32_t *src = audio_stream_get_rptr(source);
+	int32_t *dst = audio_stream_get_wptr(sink);
+	ae_int32x2 sample;
+	ae_int32 *in;
+	ae_int32 *out;
+	const int nch_source = audio_stream_get_channels(source);
+	const int nch_sink = audio_stream_get_channels(sink);
+	const int inc_source = nch_source * sizeof(int32_t);
+	const int inc_sink = nch_sink * sizeof(int32_t);
+	int processed = 0;
+	int nmax;
+	int ch;
+	int i;
+	int n;
+
+	while (processed < frames) {
+		n = frames - processed;
+		nmax = audio_stream_frames_without_wrap(source, src);
+		n = MIN(n, nmax);
+		nmax = audio_stream_frames_without_wrap(sink, dst);
+		n = MIN(n, nmax);
+		for (ch = 0; ch < nch_sink; ch++) {
+			in = (ae_int32 *)(src + cd->pick[ch]);
+			out = (ae_int32 *)(dst + ch);
+			for (i = 0; i < n; i++) {
+				AE_L32_XP(sample, in, inc_source);
+				AE_S32_L_XP(sample, out, inc_sink);
+			}
+		}
+		src = audio_stream_wrap(source, src + n * nch_source);
+		dst = audio_stream_wrap(sink, dst + n * nch_sink);
+		processed += n;
+	}
+
+	module_update_buffer_position(bsource, bsink, frames);
+}
+
+/**
+ * \brief Channel selection for 32-bit, m channel input x n channel output data format.
+ *
+ * Accumulates the Q10 weighted source samples in 64 bits and rounds the sum like the
+ * generic version, so the output is bit exact with it.
+ * \param[in] mod Selector base module device.
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Sink buffer.
+ * \param[in] frames Number of frames to process.
+ */
+void sel_s32le_hifi3(struct processing_module *mod, struct input_stream_buffer *bsource,
+		     struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	int32_t *src = audio_stream_get_rptr(source);
+	int32_t *dst = audio_stream_get_wptr(sink);
+	const ae_int64 one = AE_MOVINT64_FROMINT32X2(AE_MOVDA32X2(0, 1));
+	ae_int32x2 sample;
+	ae_int16x4 coef;
+	ae_int64 acc;
+	ae_int32 *in;
+	ae_int32 *out;
+	const int nch_source = audio_stream_get_channels(source);
+	const int nch_sink = audio_stream_get_channels(sink);
+	const int n_chan_source = MIN(SEL_SOURCE_CHANNELS_MAX, nch_source);
+	const int n_chan_sink = MIN(SEL_SINK_CHANNELS_MAX, nch_sink);
+	int processed = 0;
+	int nmax;
+	int i, j, k;
+	int n;
+
+	while (processed < frames) {
+		n = frames - processed;
+		nmax = audio_stream_frames_without_wrap(source, src);
+		n = MIN(n, nmax);
+		nmax = audio_stream_frames_without_wrap(sink, dst);
+		n = MIN(n, nmax);
+		for (k = 0; k < n; k++) {
+			out = (ae_int32 *)(dst + k * nch_sink);
+			for (i = 0; i < n_chan_sink; i++) {
+				in = (ae_int32 *)(src + k * nch_source);
+				acc = AE_ZERO64();
+				for (j = 0; j < n_chan_source; j++) {
+					AE_L32_IP(sample, in, sizeof(int32_t));
+					coef = AE_MOVDA16(cd->coeffs_config.coeffs[i][j]);
+					AE_MULA32X16_L0(acc, sample, coef);
+				}
+
+				/* shift out 10 LSbits with rounding to get 32-bit result */
+				acc = AE_SRAI64(AE_ADD64(AE_SRAI64(acc, 9), one), 1);
+				AE_S32_L_IP(AE_MOVINT32X2_FROMINT64(acc), out, sizeof(int32_t));
+			}
+		}
+		src = audio_stream_wrap(source, src + n * nch_source);
+		dst = audio_stream_wrap(sink, dst + n * nch_sink);
+		processed += n;
+	}
+
+	module_update_buffer_position(bsource, bsink, frames);
+}
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+
+#endif /* CONFIG_IPC_MAJOR_4 && SEL_HIFI3 */
@@ -35,6 +35,30 @@ int sink_get_buffer(struct sof_sink *sink, size_t req_size,
 	return ret;
 }
 
+int sink_get_buffer_linear(struct sof_sink *sink, size_t req_size,
+			   void **data_ptr, size_t *linear_size)
+{
+	void *buffer_start;
+	size_t buffer_size;
+	size_t tail_size;
+	int ret;
+
+	if (sink->requested_write_frag_size)
+		return -EBUSY;
+
+	ret = sink->ops->get_buffer(sink, req_size, data_ptr, &buffer_start, &buffer_size);
+	if (ret)
+		return ret;
+
+	/* space left until the end of the circular buffer */
+	tail_size = (uintptr_t)buffer_start + buffer_size - (uintptr_t)*data_ptr;
+	*linear_size = MIN(req_size, tail_size);
+
+	/* only the linear part may be committed */
+	sink->requested_write_frag_size = *linear_size;
+	return 0;
+}
+
 int sink_commit_buffer(struct sof_sink *sink, size_t commit_size)
 {
 	int ret;
@@ -3,6 +3,7 @@
 // Copyright(c) 2023 Intel Corporation. All rights reserved.
 //
 
+#include <sof/audio/block_copy.h>
 #include <sof/audio/sink_source_utils.h>
 #include <sof/audio/sink_api.h>
 #include <sof/audio/source_api.h>
@@ -55,8 +56,7 @@ int source_to_sink_copy(struct sof_source *source,
 		uint32_t to_copy = MIN(src_to_buf_overlap, dst_to_buf_overlap);
 
 		to_copy = MIN(to_copy, size);
-		ret = memcpy_s(dst_ptr, dst_to_buf_overlap, src_ptr, to_copy);
-		assert(!ret);
+		audio_block_copy(dst_ptr, src_ptr, to_copy);
 
 		size -= to_copy;
 		src_ptr += to_copy;
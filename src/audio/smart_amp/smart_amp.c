@@ -56,6 +56,10 @@ struct smart_amp_data {
 
 	struct smart_amp_buf mod_mems[MOD_MEMBLK_MAX]; /**< memory blocks for mod */
 
+	uint32_t ff_frames; /**< feed-forward frames processed since start */
+	uint32_t fb_frames; /**< feedback frames passed to mod since start */
+	uint32_t fb_stale; /**< zero-filled feedback frames not yet received */
+
 	struct smart_amp_mod_data_base *mod_data; /**< inner model data */
 };
 
@@ -498,6 +502,9 @@ static int smart_amp_trigger(struct comp_dev *dev, int cmd)
 		if (sad->feedback_buf) {
 			buffer_zero(sad->feedback_buf);
 		}
+		sad->ff_frames = 0;
+		sad->fb_frames = 0;
+		sad->fb_stale = 0;
 		break;
 	case COMP_TRIGGER_PAUSE:
 	case COMP_TRIGGER_STOP:
@@ -577,17 +584,99 @@ static int smart_amp_fb_process(struct comp_dev *dev,
 	return 0;
 }
 
+/* Passes zero feedback frames to the inner model in place of the frames
+ * that have not arrived in time.
+ */
+static int smart_amp_fb_zero(struct comp_dev *dev, uint32_t frames)
+{
+	struct smart_amp_data *sad = comp_get_drvdata(dev);
+	struct smart_amp_mod_data_base *mod = sad->mod_data;
+	size_t sample_bytes = sad->fb_mod.frame_fmt == SOF_IPC_FRAME_S16_LE ?
+		sizeof(int16_t) : sizeof(int32_t);
+	size_t frame_bytes = sad->fb_mod.channels * sample_bytes;
+
+	sad->fb_mod.consumed = 0;
+	if (!frame_bytes)
+		return 0;
+
+	frames = MIN(frames, sad->fb_mod.buf.size / frame_bytes);
+	bzero(sad->fb_mod.buf.data, frames * frame_bytes);
+
+	return mod->mod_ops->fb_proc(mod, frames, &sad->fb_mod);
+}
+
+/* The feedback frames are stamped with the feed-forward frame position they
+ * were captured at. Feedback frame n belongs to feed-forward frame
+ * n - CONFIG_SMART_AMP_FEEDBACK_DELAY, so the feedback is passed to the model
+ * up to the position of the processed feed-forward frames minus the delay.
+ * Feedback that is late is replaced with zeros and dropped once it arrives,
+ * and feedback that is early is kept in the buffer until it is due.
+ */
+static void smart_amp_fb_align(struct comp_dev *dev,
+			       struct comp_buffer *feedback_buf)
+{
+	struct smart_amp_data *sad = comp_get_drvdata(dev);
+	uint32_t frame_bytes = audio_stream_frame_bytes(&feedback_buf->stream);
+	uint32_t avail_feedback_frames;
+	uint32_t feedback_frames;
+	uint32_t stale_frames;
+	int32_t due_frames;
+
+	avail_feedback_frames = audio_stream_get_avail_frames(&feedback_buf->stream);
+
+	/* drop the frames that have already been replaced with zeros */
+	stale_frames = MIN(avail_feedback_frames, sad->fb_stale);
+	if (stale_frames) {
+		comp_update_buffer_consume(feedback_buf, stale_frames * frame_bytes);
+		sad->fb_stale -= stale_frames;
+		avail_feedback_frames -= stale_frames;
+	}
+
+	due_frames = (int32_t)(sad->ff_frames - sad->fb_frames) -
+		CONFIG_SMART_AMP_FEEDBACK_DELAY;
+	if (due_frames <= 0)
+		return;
+
+	feedback_frames = MIN(avail_feedback_frames, (uint32_t)due_frames);
+	if (feedback_frames) {
+		comp_dbg(dev, "smart_amp_copy(): processing %u feedback frames (due: %d)",
+			 feedback_frames, due_frames);
+
+		buffer_stream_invalidate(feedback_buf, feedback_frames * frame_bytes);
+		smart_amp_fb_process(dev, &feedback_buf->stream, feedback_frames,
+				     sad->config.feedback_ch_map);
+
+		comp_dbg(dev, "smart_amp_copy(): consumed %u feedback frames",
+			 sad->fb_mod.consumed);
+
+		comp_update_buffer_consume(feedback_buf, sad->fb_mod.consumed * frame_bytes);
+		sad->fb_frames += sad->fb_mod.consumed;
+		due_frames -= sad->fb_mod.consumed;
+	}
+
+	/* the feedback buffer is drained but the model is still owed frames */
+	if (due_frames > 0 && feedback_frames == avail_feedback_frames) {
+		if (!sad->fb_stale)
+			comp_warn(dev, "smart_amp_copy(): feedback late by %d frames",
+				  due_frames);
+
+		if (smart_amp_fb_zero(dev, due_frames) < 0)
+			return;
+
+		sad->fb_frames += sad->fb_mod.consumed;
+		sad->fb_stale += sad->fb_mod.consumed;
+	}
+}
+
 static int smart_amp_copy(struct comp_dev *dev)
 {
 	struct smart_amp_data *sad = comp_get_drvdata(dev);
 	struct comp_buffer *source_buf = sad->source_buf;
 	struct comp_buffer *sink_buf = sad->sink_buf;
 	uint32_t avail_passthrough_frames;
-	uint32_t avail_feedback_frames;
 	uint32_t avail_frames;
 	uint32_t source_bytes;
 	uint32_t sink_bytes;
-	uint32_t feedback_bytes;
 
 	comp_dbg(dev, "smart_amp_copy()");
 
@@ -598,36 +687,14 @@ static int smart_amp_copy(struct comp_dev *dev)
 	avail_frames = avail_passthrough_frames;
 
 	if (sad->feedback_buf) {
-		struct comp_buffer *feedback_buf = sad->feedback_buf;
-
-		if (comp_get_state(dev, feedback_buf->source) == dev->state) {
-			/* feedback */
-			avail_feedback_frames =
-				audio_stream_get_avail_frames(&feedback_buf->stream);
-
-			avail_feedback_frames = MIN(avail_passthrough_frames,
-						    avail_feedback_frames);
-
-			feedback_bytes = avail_feedback_frames *
-				audio_stream_frame_bytes(&feedback_buf->stream);
-
-			comp_dbg(dev, "smart_amp_copy(): processing %u feedback frames (avail_passthrough_frames: %u)",
-				 avail_feedback_frames, avail_passthrough_frames);
-
-			/* perform buffer writeback after source_buf process */
-			buffer_stream_invalidate(feedback_buf, feedback_bytes);
-			smart_amp_fb_process(dev, &feedback_buf->stream,
-					     avail_feedback_frames,
-					     sad->config.feedback_ch_map);
-
-			comp_dbg(dev, "smart_amp_copy(): consumed %u feedback frames",
-				 sad->fb_mod.consumed);
-			if (sad->fb_mod.consumed < avail_feedback_frames) {
-				feedback_bytes = sad->fb_mod.consumed *
-					audio_stream_frame_bytes(&feedback_buf->stream);
-			}
-
-			comp_update_buffer_consume(feedback_buf, feedback_bytes);
+		if (comp_get_state(dev, sad->feedback_buf->source) == dev->state) {
+			smart_amp_fb_align(dev, sad->feedback_buf);
+		} else {
+			/* the feedback that arrives first once the feedback
+			 * pipeline runs belongs to the current position
+			 */
+			sad->fb_frames = sad->ff_frames - CONFIG_SMART_AMP_FEEDBACK_DELAY;
+			sad->fb_stale = 0;
 		}
 	}
 
@@ -643,6 +710,8 @@ static int smart_amp_copy(struct comp_dev *dev)
 	if (sad->ff_mod.consumed < avail_frames)
 		source_bytes = sad->ff_mod.consumed * audio_stream_frame_bytes(&source_buf->stream);
 
+	sad->ff_frames += sad->ff_mod.consumed;
+
 	sink_bytes = sad->out_mod.produced * audio_stream_frame_bytes(&sink_buf->stream);
 	buffer_stream_writeback(sink_buf, sink_bytes);
 
@@ -25,8 +25,13 @@
 #define DSM_FF_BUF_SZ		(DSM_FRM_SZ * SMART_AMP_FF_MAX_CH_NUM)
 #define DSM_FB_BUF_SZ		(DSM_FRM_SZ * SMART_AMP_FB_MAX_CH_NUM)
 
-#define DSM_FF_BUF_DB_SZ	(DSM_FF_BUF_SZ * SMART_AMP_FF_MAX_CH_NUM)
-#define DSM_FB_BUF_DB_SZ	(DSM_FB_BUF_SZ * SMART_AMP_FB_MAX_CH_NUM)
+/* Number of DSM frames processed back to back once buffered */
+#define DSM_BATCH_FRAMES	CONFIG_MAXIM_DSM_BATCH_FRAMES
+#define DSM_FF_BATCH_SZ		(DSM_FF_BUF_SZ * DSM_BATCH_FRAMES)
+#define DSM_FB_BATCH_SZ		(DSM_FB_BUF_SZ * DSM_BATCH_FRAMES)
+
+#define DSM_FF_BUF_DB_SZ	(DSM_FF_BATCH_SZ * SMART_AMP_FF_MAX_CH_NUM)
+#define DSM_FB_BUF_DB_SZ	(DSM_FB_BATCH_SZ * SMART_AMP_FB_MAX_CH_NUM)
 
 /* DSM parameter table structure
  * +--------------+-----------------+---------------------------------+
@@ -222,7 +227,10 @@ static int maxim_dsm_flush(struct smart_amp_mod_struct_t *hspk)
 	memset(hspk->buf.ff_out.buf, 0, DSM_FF_BUF_DB_SZ * sizeof(int32_t));
 	memset(hspk->buf.fb.buf, 0, DSM_FB_BUF_DB_SZ * sizeof(int32_t));
 
-	hspk->buf.ff.avail = DSM_FF_BUF_SZ;
+	/* A batch of zero frames is queued so that the output is available
+	 * on every call while the next batch is being collected.
+	 */
+	hspk->buf.ff.avail = DSM_FF_BATCH_SZ;
 	hspk->buf.ff_out.avail = 0;
 	hspk->buf.fb.avail = 0;
 
@@ -448,6 +456,95 @@ static int maxim_dsm_set_config(struct smart_amp_mod_data_base *mod,
 	return maxim_dsm_set_param(hspk, cdata);
 }
 
+/* Runs the DSM feed-forward process for one DSM frame at sample offset
+ * in_idx of the interleaved input and writes the interleaved output to
+ * sample offset out_idx.
+ */
+static void maxim_dsm_ff_frame(struct smart_amp_mod_struct_t *hspk,
+			       const union maxim_dsm_buf *in, int in_idx,
+			       union maxim_dsm_buf *out, int out_idx,
+			       bool is_16bit)
+{
+	int16_t *input = (int16_t *)hspk->buf.input;
+	int16_t *output = (int16_t *)hspk->buf.output;
+	int32_t *input32 = hspk->buf.input;
+	int32_t *output32 = hspk->buf.output;
+	int idx;
+
+	hspk->ifsamples = hspk->nchannels * hspk->ff_fr_sz_samples;
+
+	if (is_16bit) {
+		/* Buffer ordering for DSM : LRLR... -> LL...RR... */
+		for (idx = 0; idx < DSM_FRM_SZ; idx++) {
+			input[idx] = in->buf16[in_idx + 2 * idx];
+			input[idx + DSM_FRM_SZ] = in->buf16[in_idx + 2 * idx + 1];
+		}
+
+		dsm_api_ff_process(hspk->dsmhandle, hspk->channelmask,
+				   input, &hspk->ifsamples,
+				   output, &hspk->ofsamples);
+
+		for (idx = 0; idx < DSM_FRM_SZ; idx++) {
+			/* Buffer re-ordering LR/LR/LR */
+			out->buf16[out_idx + 2 * idx] = output[idx];
+			out->buf16[out_idx + 2 * idx + 1] = output[idx + DSM_FRM_SZ];
+		}
+	} else {
+		for (idx = 0; idx < DSM_FRM_SZ; idx++) {
+			input32[idx] = in->buf32[in_idx + 2 * idx];
+			input32[idx + DSM_FRM_SZ] = in->buf32[in_idx + 2 * idx + 1];
+		}
+
+		dsm_api_ff_process(hspk->dsmhandle, hspk->channelmask,
+				   (short *)input32, &hspk->ifsamples,
+				   (short *)output32, &hspk->ofsamples);
+
+		for (idx = 0; idx < DSM_FRM_SZ; idx++) {
+			out->buf32[out_idx + 2 * idx] = output32[idx];
+			out->buf32[out_idx + 2 * idx + 1] = output32[idx + DSM_FRM_SZ];
+		}
+	}
+}
+
+/* Runs the DSM feedback process for one DSM frame at sample offset in_idx
+ * of the interleaved V/I input.
+ */
+static void maxim_dsm_fb_frame(struct smart_amp_mod_struct_t *hspk,
+			       const union maxim_dsm_buf *in, int in_idx,
+			       bool is_16bit)
+{
+	int16_t *v = (int16_t *)hspk->buf.voltage;
+	int16_t *i = (int16_t *)hspk->buf.current;
+	int32_t *v32 = hspk->buf.voltage;
+	int32_t *i32 = hspk->buf.current;
+	int idx;
+
+	hspk->ibsamples = hspk->fb_fr_sz_samples * hspk->nchannels;
+
+	if (is_16bit) {
+		/* Buffer ordering for DSM : VIVI... -> VV... II...*/
+		for (idx = 0; idx < DSM_FRM_SZ; idx++) {
+			v[idx] = in->buf16[in_idx + 4 * idx];
+			i[idx] = in->buf16[in_idx + 4 * idx + 1];
+			v[idx + DSM_FRM_SZ] = in->buf16[in_idx + 4 * idx + 2];
+			i[idx + DSM_FRM_SZ] = in->buf16[in_idx + 4 * idx + 3];
+		}
+
+		dsm_api_fb_process(hspk->dsmhandle, hspk->channelmask,
+				   i, v, &hspk->ibsamples);
+	} else {
+		for (idx = 0; idx < DSM_FRM_SZ; idx++) {
+			v32[idx] = in->buf32[in_idx + 4 * idx];
+			i32[idx] = in->buf32[in_idx + 4 * idx + 1];
+			v32[idx + DSM_FRM_SZ] = in->buf32[in_idx + 4 * idx + 2];
+			i32[idx + DSM_FRM_SZ] = in->buf32[in_idx + 4 * idx + 3];
+		}
+
+		dsm_api_fb_process(hspk->dsmhandle, hspk->channelmask,
+				   (short *)i32, (short *)v32, &hspk->ibsamples);
+	}
+}
+
 static int maxim_dsm_ff_proc(struct smart_amp_mod_data_base *mod,
 			     uint32_t frames,
 			     struct smart_amp_mod_stream *in,
@@ -455,10 +552,6 @@ static int maxim_dsm_ff_proc(struct smart_amp_mod_data_base *mod,
 {
 	struct smart_amp_mod_struct_t *hspk = (struct smart_amp_mod_struct_t *)mod;
 	union maxim_dsm_buf buf, buf_out;
-	int16_t *input = (int16_t *)hspk->buf.input;
-	int16_t *output = (int16_t *)hspk->buf.output;
-	int32_t *input32 = hspk->buf.input;
-	int32_t *output32 = hspk->buf.output;
 	int *w_ptr = &hspk->buf.ff.avail;
 	int *r_ptr = &hspk->buf.ff_out.avail;
 	bool is_16bit = (in->frame_fmt == SOF_IPC_FRAME_S16_LE);
@@ -498,60 +591,26 @@ static int maxim_dsm_ff_proc(struct smart_amp_mod_data_base *mod,
 		goto error;
 	}
 
-	/* Run DSM Feedforward process if the buffer is ready */
-	if (*w_ptr >= DSM_FF_BUF_SZ) {
-		if (is_16bit) {
-			/* Buffer ordering for DSM : LRLR... -> LL...RR... */
-			for (idx = 0; idx < DSM_FRM_SZ; idx++) {
-				input[idx] = (buf.buf16[2 * idx]);
-				input[idx + DSM_FRM_SZ] =
-					(buf.buf16[2 * idx + 1]);
-			}
-		} else {
-			for (idx = 0; idx < DSM_FRM_SZ; idx++) {
-				input32[idx] = buf.buf32[2 * idx];
-				input32[idx + DSM_FRM_SZ] =
-					buf.buf32[2 * idx + 1];
-			}
+	/* Run DSM Feedforward process if a batch of frames is ready */
+	if (*w_ptr >= DSM_FF_BATCH_SZ) {
+		for (idx = 0; idx < DSM_BATCH_FRAMES; idx++) {
+			maxim_dsm_ff_frame(hspk, &buf, idx * DSM_FF_BUF_SZ,
+					   &buf_out, *r_ptr, is_16bit);
+			*r_ptr += DSM_FF_BUF_SZ;
 		}
 
-		remain = (*w_ptr - DSM_FF_BUF_SZ);
+		remain = (*w_ptr - DSM_FF_BATCH_SZ);
 		if (remain) {
 			if (is_16bit)
 				memcpy_s(&buf.buf16[0], remain * szsample,
-					 &buf.buf16[DSM_FF_BUF_SZ],
+					 &buf.buf16[DSM_FF_BATCH_SZ],
 					 remain * szsample);
 			else
 				memcpy_s(&buf.buf32[0], remain * szsample,
-					 &buf.buf32[DSM_FF_BUF_SZ],
+					 &buf.buf32[DSM_FF_BATCH_SZ],
 					 remain * szsample);
 		}
-		*w_ptr -= DSM_FF_BUF_SZ;
-
-		hspk->ifsamples = hspk->nchannels * hspk->ff_fr_sz_samples;
-		dsm_api_ff_process(hspk->dsmhandle, hspk->channelmask,
-				   input, &hspk->ifsamples,
-				   output, &hspk->ofsamples);
-
-		if (is_16bit) {
-			for (idx = 0; idx < DSM_FRM_SZ; idx++) {
-				/* Buffer re-ordering LR/LR/LR */
-				buf_out.buf16[*r_ptr + 2 * idx] = (output[idx]);
-				buf_out.buf16[*r_ptr + 2 * idx + 1] =
-					output[idx + DSM_FRM_SZ];
-			}
-		} else {
-			dsm_api_ff_process(hspk->dsmhandle, hspk->channelmask,
-					   (short *)input32, &hspk->ifsamples,
-					   (short *)output32, &hspk->ofsamples);
-			for (idx = 0; idx < DSM_FRM_SZ; idx++) {
-				buf_out.buf32[*r_ptr + 2 * idx] = output32[idx];
-				buf_out.buf32[*r_ptr + 2 * idx + 1] =
-					output32[idx + DSM_FRM_SZ];
-			}
-		}
-
-		*r_ptr += DSM_FF_BUF_SZ;
+		*w_ptr -= DSM_FF_BATCH_SZ;
 	}
 
 	/* Output buffer preparation */
@@ -599,10 +658,6 @@ static int maxim_dsm_fb_proc(struct smart_amp_mod_data_base *mod,
 	struct smart_amp_mod_struct_t *hspk = (struct smart_amp_mod_struct_t *)mod;
 	union maxim_dsm_buf buf;
 	int *w_ptr = &hspk->buf.fb.avail;
-	int16_t *v = (int16_t *)hspk->buf.voltage;
-	int16_t *i = (int16_t *)hspk->buf.current;
-	int32_t *v32 = hspk->buf.voltage;
-	int32_t *i32 = hspk->buf.current;
 	bool is_16bit = (in->frame_fmt == SOF_IPC_FRAME_S16_LE);
 	int szsample = (is_16bit ? 2 : 4);
 	int nsamples = frames * in->channels;
@@ -634,49 +689,23 @@ static int maxim_dsm_fb_proc(struct smart_amp_mod_data_base *mod,
 		return -EOVERFLOW;
 	}
 
-	/* Run DSM Feedback process if the buffer is ready */
-	if (*w_ptr >= DSM_FB_BUF_SZ) {
-		if (is_16bit) {
-			for (idx = 0; idx < DSM_FRM_SZ; idx++) {
-			/* Buffer ordering for DSM : VIVI... -> VV... II...*/
-				v[idx] = buf.buf16[4 * idx];
-				i[idx] = buf.buf16[4 * idx + 1];
-				v[idx + DSM_FRM_SZ] = buf.buf16[4 * idx + 2];
-				i[idx + DSM_FRM_SZ] = buf.buf16[4 * idx + 3];
-			}
-		} else {
-			for (idx = 0; idx < DSM_FRM_SZ; idx++) {
-				v[idx] = buf.buf32[4 * idx];
-				i[idx] = buf.buf32[4 * idx + 1];
-				v[idx + DSM_FRM_SZ] =
-					buf.buf32[4 * idx + 2];
-				i[idx + DSM_FRM_SZ] =
-					buf.buf32[4 * idx + 3];
-			}
-		}
+	/* Run DSM Feedback process if a batch of frames is ready */
+	if (*w_ptr >= DSM_FB_BATCH_SZ) {
+		for (idx = 0; idx < DSM_BATCH_FRAMES; idx++)
+			maxim_dsm_fb_frame(hspk, &buf, idx * DSM_FB_BUF_SZ, is_16bit);
 
-		remain = (*w_ptr - DSM_FB_BUF_SZ);
+		remain = (*w_ptr - DSM_FB_BATCH_SZ);
 		if (remain) {
 			if (is_16bit)
 				memcpy_s(&buf.buf16[0], remain * szsample,
-					 &buf.buf16[DSM_FB_BUF_SZ],
+					 &buf.buf16[DSM_FB_BATCH_SZ],
 					 remain * szsample);
 			else
 				memcpy_s(&buf.buf32[0], remain * szsample,
-					 &buf.buf32[DSM_FB_BUF_SZ],
+					 &buf.buf32[DSM_FB_BATCH_SZ],
 					 remain * szsample);
 		}
-		*w_ptr -= DSM_FB_BUF_SZ;
-
-		hspk->ibsamples = hspk->fb_fr_sz_samples * hspk->nchannels;
-		if (is_16bit)
-			dsm_api_fb_process(hspk->dsmhandle,
-					   hspk->channelmask,
-					   i, v, &hspk->ibsamples);
-		else
-			dsm_api_fb_process(hspk->dsmhandle,
-					   hspk->channelmask,
-					   (short *)i32, (short *)v32, &hspk->ibsamples);
+		*w_ptr -= DSM_FB_BATCH_SZ;
 	}
 	return 0;
 }
@@ -35,6 +35,30 @@ int source_get_data(struct sof_source *source, size_t req_size,
 	return ret;
 }
 
+int source_get_data_linear(struct sof_source *source, size_t req_size,
+			   void const **data_ptr, size_t *linear_size)
+{
+	void const *buffer_start;
+	size_t buffer_size;
+	size_t tail_size;
+	int ret;
+
+	if (source->requested_read_frag_size)
+		return -EBUSY;
+
+	ret = source->ops->get_data(source, req_size, data_ptr, &buffer_start, &buffer_size);
+	if (ret)
+		return ret;
+
+	/* space left until the end of the circular buffer */
+	tail_size = (uintptr_t)buffer_start + buffer_size - (uintptr_t)*data_ptr;
+	*linear_size = MIN(req_size, tail_size);
+
+	/* only the linear part may be released */
+	source->requested_read_frag_size = *linear_size;
+	return 0;
+}
+
 int source_release_data(struct sof_source *source, size_t free_size)
 {
 	int ret;
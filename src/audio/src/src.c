@@ -44,6 +44,10 @@
 #ifdef SRC_LITE
 #include "coef/src_lite_ipc4_int32_define.h"
 #include "coef/src_lite_ipc4_int32_table.h"
+#elif CONFIG_COMP_SRC_RUNTIME
+/* No tables, the coefficients are generated for the rates in use */
+#define MAX_FIR_DELAY_SIZE SRC_RT_MAX_FIR_DELAY
+#define MAX_OUT_DELAY_SIZE SRC_RT_MAX_OUT_DELAY
 #elif SRC_SHORT || CONFIG_COMP_SRC_TINY
 #include "coef/src_tiny_int16_define.h"
 #include "coef/src_tiny_int16_table.h"
@@ -90,6 +94,22 @@ int src_buffer_lengths(struct comp_dev *dev, struct comp_data *cd,
 	}
 
 	a->nch = nch;
+#if CONFIG_COMP_SRC_INTERLEAVED
+	/* mono and stereo have their own filter cores */
+	a->interleaved = nch > 2 && nch <= SRC_INTERLEAVED_MAX_CH;
+#endif
+#if CONFIG_COMP_SRC_RUNTIME
+	a->idx_in = 0;
+	a->idx_out = 0;
+	if (src_rt_stages_get(dev, a, fs_in, fs_out) < 0) {
+		comp_err(dev, "src_buffer_lengths(): rates not supported, fs_in: %u, fs_out: %u",
+			 fs_in, fs_out);
+		return -EINVAL;
+	}
+
+	stage1 = a->stage1;
+	stage2 = a->stage2;
+#else
 	a->idx_in = src_find_fs(src_in_fs, NUM_IN_FS, fs_in);
 	a->idx_out = src_find_fs(src_out_fs, NUM_OUT_FS, fs_out);
 
@@ -102,6 +122,7 @@ int src_buffer_lengths(struct comp_dev *dev, struct comp_data *cd,
 
 	stage1 = src_table1[a->idx_out][a->idx_in];
 	stage2 = src_table2[a->idx_out][a->idx_in];
+#endif
 
 	/* Check from stage1 parameter for a deleted in/out rate combination.*/
 	if (stage1->filter_length < 1) {
@@ -150,6 +171,29 @@ int src_buffer_lengths(struct comp_dev *dev, struct comp_data *cd,
 	return 0;
 }
 
+#if CONFIG_COMP_SRC_FOLDED
+/* A single sub-filter stage with symmetric coefficients can be folded */
+static bool src_stage_foldable(const struct src_stage *stage)
+{
+#if SRC_SHORT
+	const int16_t *coef = stage->coefs;
+#else
+	const int32_t *coef = stage->coefs;
+#endif
+	const int n = stage->subfilter_length;
+	int i;
+
+	if (stage->num_of_subfilters != 1 || stage->filter_length < 2)
+		return false;
+
+	for (i = 0; i < n / 2; i++)
+		if (coef[i] != coef[n - 1 - i])
+			return false;
+
+	return true;
+}
+#endif
+
 int init_stages(struct src_stage *stage1, struct src_stage *stage2,
 		struct polyphase_src *src, struct src_param *p,
 		int n, int32_t *delay_lines_start)
@@ -213,6 +257,12 @@ int init_stages(struct src_stage *stage1, struct src_stage *stage2,
 		return -EINVAL;
 	}
 
+#if CONFIG_COMP_SRC_FOLDED
+	src->state1.folded = src_stage_foldable(stage1);
+	if (n > 1)
+		src->state2.folded = src_stage_foldable(stage2);
+#endif
+
 	return 0;
 }
 
@@ -228,8 +278,15 @@ int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 		return -EINVAL;
 
 	/* Get setup for 2 stage conversion */
+#if CONFIG_COMP_SRC_RUNTIME
+	stage1 = p->stage1;
+	stage2 = p->stage2;
+	if (!stage1 || !stage2)
+		return -EINVAL;
+#else
 	stage1 = src_table1[p->idx_out][p->idx_in];
 	stage2 = src_table2[p->idx_out][p->idx_in];
+#endif
 	ret = init_stages(stage1, stage2, src, p, 2, delay_lines_start);
 	if (ret < 0)
 		return -EINVAL;
@@ -241,8 +298,13 @@ int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 	 * tap.
 	 */
 	n_stages = (src->stage2->filter_length == 1) ? 1 : 2;
+#if CONFIG_COMP_SRC_RUNTIME
+	if (src->stage1->filter_length == 1)
+		n_stages = 0;
+#else
 	if (src_in_fs[p->idx_in] == src_out_fs[p->idx_out])
 		n_stages = 0;
+#endif
 
 	/* If filter length for first stage is zero this is a deleted
 	 * mode from in/out matrix. Computing of such SRC mode needs
@@ -300,6 +362,9 @@ int src_2s(struct comp_data *cd,
 	s1.y_wptr = cd->sbuf_w_ptr;
 	s1.nch = nch;
 	s1.shift = cd->data_shift;
+#if CONFIG_COMP_SRC_INTERLEAVED
+	s1.interleaved = cd->param.interleaved;
+#endif
 
 	s2.x_end_addr = sbuf_end_addr;
 	s2.x_size = sbuf_size;
@@ -308,6 +373,9 @@ int src_2s(struct comp_data *cd,
 	s2.x_rptr = cd->sbuf_r_ptr;
 	s2.nch = nch;
 	s2.shift = cd->data_shift;
+#if CONFIG_COMP_SRC_INTERLEAVED
+	s2.interleaved = cd->param.interleaved;
+#endif
 
 	/* Test if 1st stage can be run with default block length to reach
 	 * the period length or just under it.
@@ -386,6 +454,9 @@ int src_1s(struct comp_data *cd, struct sof_source *source,
 	s1.stage = cd->src.stage1;
 	s1.nch = source_get_channels(source);	/* src channels must == sink channels */
 	s1.shift = cd->data_shift;
+#if CONFIG_COMP_SRC_INTERLEAVED
+	s1.interleaved = cd->param.interleaved;
+#endif
 
 	cd->polyphase_func(&s1);
 
@@ -687,6 +758,9 @@ int src_free(struct processing_module *mod)
 
 	/* Free dynamically reserved buffers for SRC algorithm */
 	rfree(cd->delay_lines);
+#if CONFIG_COMP_SRC_RUNTIME
+	src_rt_stages_put(mod->dev, &cd->param);
+#endif
 
 	rfree(cd);
 	return 0;
@@ -16,6 +16,8 @@
 #include <sof/audio/component.h>
 #include <sof/audio/module_adapter/module/generic.h>
 
+struct src_stage;
+
 struct src_param {
 	int fir_s1;
 	int fir_s2;
@@ -31,6 +33,13 @@ struct src_param {
 	int idx_in;
 	int idx_out;
 	int nch;
+#if CONFIG_COMP_SRC_INTERLEAVED
+	bool interleaved; /* filter all channels of a frame in one pass */
+#endif
+#if CONFIG_COMP_SRC_RUNTIME
+	struct src_stage *stage1; /* generated at runtime for the rates */
+	struct src_stage *stage2;
+#endif
 };
 
 struct src_stage {
@@ -53,6 +62,9 @@ struct src_state {
 	int32_t *out_delay;
 	int32_t *fir_wp;
 	int32_t *out_rp;
+#if CONFIG_COMP_SRC_FOLDED
+	bool folded;		/* symmetric decimator, tap pairs share a multiply */
+#endif
 };
 
 struct polyphase_src {
@@ -74,10 +86,16 @@ struct src_stage_prm {
 	void *y_end_addr;
 	size_t y_size;
 	int shift;
+#if CONFIG_COMP_SRC_INTERLEAVED
+	bool interleaved;
+#endif
 	struct src_state *state;
 	struct src_stage *stage;
 };
 
+/* largest channel count filtered across the frame, one accumulator each */
+#define SRC_INTERLEAVED_MAX_CH	8
+
 static inline void src_inc_wrap(int32_t **ptr, int32_t *end, size_t size)
 {
 	if (*ptr >= end)
@@ -108,6 +126,9 @@ static inline void src_state_reset(struct src_state *state)
 {
 	state->fir_delay_size = 0;
 	state->out_delay_size = 0;
+#if CONFIG_COMP_SRC_FOLDED
+	state->folded = false;
+#endif
 }
 
 static inline void src_polyphase_reset(struct polyphase_src *src)
@@ -122,6 +143,23 @@ static inline void src_polyphase_reset(struct polyphase_src *src)
 int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 		       int32_t *delay_lines_start);
 
+#if CONFIG_COMP_SRC_RUNTIME
+/* Limits for the stages generated at runtime */
+#define SRC_RT_MAX_FACTOR		64	/* max. interpolation or decimation factor */
+#define SRC_RT_MAX_FILTER_LENGTH	4096	/* max. taps in all subfilters */
+#define SRC_RT_MAX_FIR_DELAY		1024	/* max. FIR delay line length per channel */
+#define SRC_RT_MAX_OUT_DELAY		1024	/* max. output delay line length per channel */
+
+/* Gets the polyphase filter banks for fs_in to fs_out to p->stage1 and
+ * p->stage2 and releases the previous ones. The banks are generated, or
+ * shared with other instances converting the same rates on the same core.
+ */
+int src_rt_stages_get(struct comp_dev *dev, struct src_param *p, int fs_in, int fs_out);
+
+/* Releases the polyphase filter banks got with src_rt_stages_get() */
+void src_rt_stages_put(struct comp_dev *dev, struct src_param *p);
+#endif /* CONFIG_COMP_SRC_RUNTIME */
+
 int src_polyphase(struct polyphase_src *src, int32_t x[], int32_t y[],
 		  int n_in);
 
@@ -0,0 +1,517 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2024 Intel Corporation. All rights reserved.
+
+/* Runtime generation of the SRC polyphase filter banks. The conversion is
+ * factorized into two stages similarly to tools/tune/src/src_factor2_lm.m
+ * and every stage gets a windowed sinc prototype filter, decomposed into
+ * the subfilters layout used by src_polyphase_stage_cir(). The prototype
+ * is defined by the pass-band and stop-band edges only, it is a Kaiser
+ * windowed sinc with the length for the transition band. The generated
+ * banks are cached and shared by instances on the same core.
+ */
+
+#include "src_config.h"
+
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/list.h>
+#include <sof/math/numbers.h>
+#include <sof/math/trig.h>
+#include <rtos/alloc.h>
+#include <rtos/string.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "src.h"
+
+LOG_MODULE_DECLARE(src, CONFIG_SOF_LOG_LEVEL);
+
+#if SRC_SHORT
+typedef int16_t src_rt_coef_t;
+#else
+typedef int32_t src_rt_coef_t;
+#endif
+
+/* Pass-band is 20 kHz at 44.1 kHz, same as in tools/tune/src/src_param.m */
+#define SRC_RT_C_PB_Q14		Q_CONVERT_FLOAT(20.0 / 44.1, 14)
+#define SRC_RT_PB_MAX_HZ	20000
+#define SRC_RT_PB_HI_HZ		24000	/* pass-band for rates above 80 kHz */
+#define SRC_RT_HI_FS		80000
+
+/* Kaiser window design for 70 dB stop-band attenuation, reference
+ * https://en.wikipedia.org/wiki/Kaiser_window. The beta is
+ * 0.1102 * (A - 8.7) and the filter length times the normalized transition
+ * width is (A - 7.95) / 14.36, the same as kaiserord() in Octave.
+ */
+#define SRC_RT_KAISER_BETA_Q20	Q_CONVERT_FLOAT(0.1102 * (70 - 8.7), 20)
+#define SRC_RT_TRANSITION_Q8	Q_CONVERT_FLOAT((70 - 7.95) / 14.36, 8)
+
+/* Largest coefficient after scaling, 32767/32768 */
+#define SRC_RT_COEF_MAX_Q31	(INT32_MAX - (INT32_MAX >> 15))
+
+/** \brief Cached polyphase filter bank of a conversion stage */
+struct src_rt_stage {
+	struct list_item list;	/**< entry in the per core list */
+	int fs_in;		/**< stage input rate */
+	int f_pb;		/**< pass-band edge of the conversion */
+	int l;			/**< interpolation factor */
+	int m;			/**< decimation factor */
+	uint32_t refs;		/**< number of SRC instances using the stage */
+	struct src_stage stage;	/**< stage in format of the coefficients tables */
+};
+
+/* per core lists of generated stages, each accessed by its own core only */
+struct src_rt_cache {
+	struct list_item list;
+} __aligned(PLATFORM_DCACHE_ALIGN);
+
+static struct src_rt_cache src_rt_cache[CONFIG_CORE_COUNT];
+
+/* Stage for 1:1 rate and for the unused second stage, same as in the
+ * coefficients tables.
+ */
+#if SRC_SHORT
+static src_rt_coef_t src_rt_fir_one = 16384;
+#else
+static src_rt_coef_t src_rt_fir_one = 1073741824;
+#endif
+static struct src_stage src_rt_stage_one = { 0, 0, 1, 1, 1, 1, 1, 0, -1, &src_rt_fir_one };
+
+static struct list_item *src_rt_cache_list(struct comp_dev *dev)
+{
+	struct list_item *list = &src_rt_cache[dev->ipc_config.core].list;
+
+	/* zero initialized list head is not a valid empty list */
+	if (!list->next)
+		list_init(list);
+
+	return list;
+}
+
+static int src_rt_isqrt(int c)
+{
+	int x = 0;
+
+	while ((x + 1) * (x + 1) <= c)
+		x++;
+
+	/* round to nearest */
+	if (c - x * x > x)
+		x++;
+
+	return x;
+}
+
+/* Splits c to two factors near its square root, see factor2() in
+ * tools/tune/src/src_factor2_lm.m
+ */
+static void src_rt_factor2(int c, int *a, int *b)
+{
+	int x = src_rt_isqrt(c);
+	int a1 = 0;
+	int a2 = 0;
+	int t;
+
+	for (t = x; t <= 2 * x; t++) {
+		if (c % t == 0) {
+			a1 = t;
+			break;
+		}
+	}
+
+	for (t = x; t >= x / 2 && t > 0; t--) {
+		if (c % t == 0) {
+			a2 = t;
+			break;
+		}
+	}
+
+	if (a1 && (!a2 || a1 - x < x - a2))
+		*a = a1;
+	else if (a2)
+		*a = a2;
+	else
+		*a = 1;
+
+	*b = c / *a;
+}
+
+/* Factorizes l/m to l1/m1 * l2/m2, see tools/tune/src/src_factor2_lm.m */
+static void src_rt_factor_lm(int fs_in, int fs_out, int *l1, int *m1, int *l2, int *m2)
+{
+	int g = gcd(fs_in, fs_out);
+	int l = fs_out / g;
+	int m = fs_in / g;
+	int64_t fs3[4];
+	int64_t fs_ref;
+	int64_t best = INT64_MAX;
+	int l0[2];
+	int m0[2];
+	int idx = 0;
+	int i;
+
+	src_rt_factor2(l, &l0[0], &l0[1]);
+	src_rt_factor2(m, &m0[0], &m0[1]);
+
+	/* The 44.1 kHz family conversions use the factors of the
+	 * precomputed coefficients sets.
+	 */
+	if (l == 147 && (m == 640 || m == 320 || m == 160)) {
+		l0[0] = 7;
+		m0[0] = 8;
+	} else if ((l == 160 || l == 320) && m == 147) {
+		l0[0] = 8;
+		m0[0] = 7;
+	} else if ((l == 4 && m == 3) || (l == 3 && m == 4)) {
+		l0[0] = l;
+		m0[0] = m;
+	}
+	l0[1] = l / l0[0];
+	m0[1] = m / m0[0];
+
+	/* Intermediate rates of the four alternatives, choose the one that is
+	 * nearest to but not lower than the lower of the rates.
+	 */
+	fs3[0] = (int64_t)fs_in * l0[0] / m0[0];
+	fs3[1] = (int64_t)fs_in * l0[0] / m0[1];
+	fs3[2] = (int64_t)fs_in * l0[1] / m0[0];
+	fs3[3] = (int64_t)fs_in * l0[1] / m0[1];
+	fs_ref = MIN(fs_in, fs_out);
+	for (i = 0; i < 4; i++) {
+		if (fs3[i] >= fs_ref && fs3[i] - fs_ref < best) {
+			best = fs3[i] - fs_ref;
+			idx = i;
+		}
+	}
+
+	*l1 = l0[idx >> 1];
+	*l2 = l0[1 - (idx >> 1)];
+	*m1 = m0[idx & 1];
+	*m2 = m0[1 - (idx & 1)];
+
+	if (*l1 == 1 && *m1 == 1) {
+		*l1 = *l2;
+		*m1 = *m2;
+		*l2 = 1;
+		*m2 = 1;
+	}
+}
+
+/* Finds the input and output subfilter steps, see
+ * tools/tune/src/src_find_l0m0.m
+ */
+static int src_rt_find_l0m0(int l, int m, int *idm, int *odm)
+{
+	int lt;
+
+	if (m == 1) {
+		*idm = 0;
+		*odm = 1;
+		return 0;
+	}
+
+	if (l == 1) {
+		*idm = 1;
+		*odm = 0;
+		return 0;
+	}
+
+	/* The first match has also the smallest sum */
+	for (lt = 1; lt <= 4 * l; lt++) {
+		if ((1 + lt * l) % m == 0) {
+			*idm = lt;
+			*odm = (1 + lt * l) / m;
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+/* Returns angle 2 * pi * num / den in Q4.28 in range [-pi, pi) */
+static int32_t src_rt_angle(int64_t num, int64_t den)
+{
+	num %= den;
+	if (2 * num >= den)
+		num -= den;
+
+	return (int32_t)(num * PI_MUL2_Q4_28 / den);
+}
+
+static uint64_t src_rt_isqrt64(uint64_t x)
+{
+	uint64_t bit = 1ULL << 62;
+	uint64_t y = 0;
+
+	while (bit > x)
+		bit >>= 2;
+
+	while (bit) {
+		if (x >= y + bit) {
+			x -= y + bit;
+			y = (y >> 1) + bit;
+		} else {
+			y >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return y;
+}
+
+/* Zeroth order modified Bessel function of the first kind, Q20 in, Q30 out */
+static int64_t src_rt_bessel_i0(int64_t x)
+{
+	int64_t y = ((x >> 1) * (x >> 1)) >> 20; /* (x / 2)^2 */
+	int64_t term = 1LL << 30;
+	int64_t sum = term;
+	int k;
+
+	for (k = 1; term > 0; k++) {
+		term = ((term * y) >> 20) / (k * k);
+		sum += term;
+	}
+
+	return sum;
+}
+
+/* Computes the Q1.31 windowed sinc prototype for the stage, returns the sum
+ * of coefficients and the largest coefficient magnitude.
+ */
+static int64_t src_rt_prototype(int32_t *proto, int length, int64_t f_sum, int64_t fs3,
+				int32_t *peak)
+{
+	int64_t i0_beta = src_rt_bessel_i0(SRC_RT_KAISER_BETA_Q20);
+	int64_t len1 = length - 1;
+	int64_t sum = 0;
+	int64_t h;
+	int64_t r;
+	int32_t w;
+	int32_t s;
+	int t2;
+	int n;
+
+	*peak = 0;
+	for (n = 0; n < length; n++) {
+		/* Sinc with cut-off at (f_pb + f_sb) / 2 centered at
+		 * (length - 1) / 2. The time is in units of half samples so
+		 * that even lengths are handled too. The length is always a
+		 * multiple of 4 so t2 is never zero.
+		 */
+		t2 = 2 * n - (length - 1);
+		s = sin_fixed_32b(src_rt_angle(f_sum * ABS(t2), 4 * fs3));
+		h = ((int64_t)s << 29) / ((int64_t)PI_Q4_28 * ABS(t2));
+
+		/* Kaiser window I0(beta * sqrt(1 - (t2 / len1)^2)) / I0(beta) */
+		r = src_rt_isqrt64((uint64_t)(len1 * len1 - (int64_t)t2 * t2) << 40) / len1;
+		r = src_rt_bessel_i0((SRC_RT_KAISER_BETA_Q20 * r) >> 20);
+		w = (int32_t)((r << 23) / (i0_beta >> 8));
+
+		proto[n] = (int32_t)((h * w) >> 31);
+		*peak = MAX(*peak, ABS(proto[n]));
+		sum += proto[n];
+	}
+
+	return sum;
+}
+
+static struct src_rt_stage *src_rt_stage_new(struct comp_dev *dev, int fs_in, int l, int m,
+					     int f_pb)
+{
+	struct src_rt_stage *rt;
+	src_rt_coef_t *coefs;
+	int32_t *proto;
+	int64_t fs_min = MIN(fs_in, (int64_t)fs_in * l / m);
+	int64_t fs3 = (int64_t)fs_in * l;
+	int64_t f_sb;
+	int64_t gain;
+	int64_t sum;
+	int64_t c;
+	int32_t peak;
+	int length;
+	int sub_length;
+	int idm;
+	int odm;
+	int shift;
+	int n;
+	int k;
+
+	if (l > SRC_RT_MAX_FACTOR || m > SRC_RT_MAX_FACTOR)
+		return NULL;
+
+	if (src_rt_find_l0m0(l, m, &idm, &odm) < 0)
+		return NULL;
+
+	/* Stop-band starts at Nyquist frequency of the lower rate */
+	f_sb = fs_min >> 1;
+	if (f_pb >= f_sb)
+		return NULL;
+
+	/* Length for the stop-band attenuation in the transition band, as
+	 * a multiple of 4 subfilters taps for the optimized filter cores.
+	 */
+	length = (int)((SRC_RT_TRANSITION_Q8 * fs3 / (f_sb - f_pb) + 255) >> 8);
+	sub_length = ALIGN_UP((length + l - 1) / l, 4);
+	length = sub_length * l;
+	if (length > SRC_RT_MAX_FILTER_LENGTH ||
+	    sub_length + (l - 1) * idm + m > SRC_RT_MAX_FIR_DELAY ||
+	    1 + (l - 1) * odm > SRC_RT_MAX_OUT_DELAY) {
+		comp_err(dev, "src_rt_stage_new(): too long filter for %d/%d from %d Hz",
+			 l, m, fs_in);
+		return NULL;
+	}
+
+	rt = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*rt));
+	if (!rt)
+		return NULL;
+
+	/* 64 bits aligned for the optimized filter cores */
+	coefs = rballoc_align(0, SOF_MEM_CAPS_RAM, length * sizeof(*coefs), 8);
+	proto = rballoc(0, SOF_MEM_CAPS_RAM, length * sizeof(*proto));
+	if (!coefs || !proto) {
+		rfree(coefs);
+		rfree(proto);
+		rfree(rt);
+		return NULL;
+	}
+
+	sum = src_rt_prototype(proto, length, (int64_t)f_pb + f_sb, fs3, &peak);
+
+	/* Interpolation gain of l with unity gain at DC, the coefficients
+	 * are scaled up by 2^shift for precision the same way as the
+	 * precomputed coefficients.
+	 */
+	gain = ((int64_t)l << 47) / (sum >> 8);
+	c = ((int64_t)peak * gain) >> 24;
+	shift = 0;
+	while (c > SRC_RT_COEF_MAX_Q31) {
+		c >>= 1;
+		shift--;
+	}
+	while ((c << 1) <= SRC_RT_COEF_MAX_Q31) {
+		c <<= 1;
+		shift++;
+	}
+	gain = shift < 0 ? gain >> -shift : gain << shift;
+
+	/* Subfilter k has the prototype taps k, k + l, k + 2l, ... */
+	for (n = 0; n < length; n++) {
+		k = (n % l) * sub_length + n / l;
+		c = sat_int32(((int64_t)proto[n] * gain + (1 << 23)) >> 24);
+#if SRC_SHORT
+		coefs[k] = sat_int16((c + (1 << 15)) >> 16);
+#else
+		coefs[k] = c;
+#endif
+	}
+
+	rfree(proto);
+
+	{
+		struct src_stage stage = {
+			idm, odm, l, sub_length, length,
+			m, l, 0, shift, coefs
+		};
+
+		memcpy_s(&rt->stage, sizeof(rt->stage), &stage, sizeof(stage));
+	}
+
+	rt->fs_in = fs_in;
+	rt->f_pb = f_pb;
+	rt->l = l;
+	rt->m = m;
+
+	comp_info(dev, "src_rt_stage_new(): %d/%d from %d Hz, %d taps, shift %d",
+		  l, m, fs_in, length, shift);
+
+	return rt;
+}
+
+static struct src_stage *src_rt_stage_get(struct comp_dev *dev, int fs_in, int l, int m,
+					   int f_pb)
+{
+	struct list_item *list = src_rt_cache_list(dev);
+	struct src_rt_stage *rt;
+	struct list_item *item;
+
+	if (l == 1 && m == 1)
+		return &src_rt_stage_one;
+
+	list_for_item(item, list) {
+		rt = container_of(item, struct src_rt_stage, list);
+		if (rt->fs_in == fs_in && rt->l == l && rt->m == m && rt->f_pb == f_pb) {
+			rt->refs++;
+			return &rt->stage;
+		}
+	}
+
+	rt = src_rt_stage_new(dev, fs_in, l, m, f_pb);
+	if (!rt)
+		return NULL;
+
+	rt->refs = 1;
+	list_item_append(&rt->list, list);
+
+	return &rt->stage;
+}
+
+static void src_rt_stage_put(struct comp_dev *dev, struct src_stage *stage)
+{
+	struct src_rt_stage *rt;
+
+	if (!stage || stage == &src_rt_stage_one)
+		return;
+
+	rt = container_of(stage, struct src_rt_stage, stage);
+	if (--rt->refs)
+		return;
+
+	list_item_del(&rt->list);
+	rfree((void *)rt->stage.coefs);
+	rfree(rt);
+}
+
+int src_rt_stages_get(struct comp_dev *dev, struct src_param *p, int fs_in, int fs_out)
+{
+	int fs_min = MIN(fs_in, fs_out);
+	int l1, m1, l2, m2;
+	int f_pb;
+
+	src_rt_stages_put(dev, p);
+
+	if (fs_in <= 0 || fs_out <= 0)
+		return -EINVAL;
+
+	src_rt_factor_lm(fs_in, fs_out, &l1, &m1, &l2, &m2);
+
+	/* Pass-band as in tools/tune/src/src_param.m, limited by the lower
+	 * of the conversion rates for both stages for the widest possible
+	 * transition band in each stage.
+	 */
+	if (fs_min > SRC_RT_HI_FS)
+		f_pb = SRC_RT_PB_HI_HZ;
+	else
+		f_pb = MIN(((int64_t)fs_min * SRC_RT_C_PB_Q14) >> 14, SRC_RT_PB_MAX_HZ);
+
+	p->stage1 = src_rt_stage_get(dev, fs_in, l1, m1, f_pb);
+	p->stage2 = src_rt_stage_get(dev, fs_in / m1 * l1, l2, m2, f_pb);
+	if (!p->stage1 || !p->stage2) {
+		comp_err(dev, "src_rt_stages_get(): no filter for fs_in = %d, fs_out = %d",
+			 fs_in, fs_out);
+		src_rt_stages_put(dev, p);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+void src_rt_stages_put(struct comp_dev *dev, struct src_param *p)
+{
+	src_rt_stage_put(dev, p->stage1);
+	src_rt_stage_put(dev, p->stage2);
+	p->stage1 = NULL;
+	p->stage2 = NULL;
+}
@@ -111,6 +111,112 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 	}
 }
 
+#if CONFIG_COMP_SRC_INTERLEAVED
+/*
+ * All channels of a frame are filtered in one pass, each coefficient is loaded
+ * once for the frame. Every channel is accumulated in the same order as in
+ * fir_filter_generic(), so the output is the same.
+ */
+static inline void fir_filter_interleaved(int32_t *rp, const void *cp, int32_t *wp,
+					  int32_t *fir_start, int32_t *fir_end,
+					  const int taps_x_nch,
+					  const int shift, const int nch)
+{
+	int64_t y[SRC_INTERLEAVED_MAX_CH];
+	const int16_t *coef = (const int16_t *)cp;
+	const int qshift = 15 + shift; /* Q2.46 -> Q2.31 */
+	const int32_t rnd = 1 << (qshift - 1); /* Half LSB */
+	int32_t *data;
+	int16_t c;
+	int frames;
+	int n1;
+	int n2;
+	int i;
+	int j;
+
+	/* The channels of a frame are stored in reverse order, data points
+	 * to the last channel. Initialization code ensures that circular
+	 * wrap does not happen mid-frame.
+	 */
+	data = rp - nch + 1;
+	frames = fir_end - data; /* Words until wrap */
+	n1 = ((taps_x_nch < frames) ? taps_x_nch : frames) / nch;
+	n2 = taps_x_nch / nch - n1;
+
+	for (j = 0; j < nch; j++)
+		y[j] = rnd;
+
+	for (i = 0; i < n1; i++, data += nch) {
+		c = *coef++;
+		for (j = 0; j < nch; j++)
+			y[j] += (int64_t)c * data[j];
+	}
+
+	data = fir_start;
+	for (i = 0; i < n2; i++, data += nch) {
+		c = *coef++;
+		for (j = 0; j < nch; j++)
+			y[j] += (int64_t)c * data[j];
+	}
+
+	for (j = 0; j < nch; j++)
+		wp[j] = sat_int32(y[nch - 1 - j] >> qshift);
+}
+#endif
+
+#if CONFIG_COMP_SRC_FOLDED
+/*
+ * Single sub-filter stage with symmetric coefficients, the two samples of a
+ * coefficient pair are added first and share one multiply. The sum of the
+ * products is exact in 64 bits, so the output is the same as with
+ * fir_filter_generic().
+ */
+static inline void fir_filter_folded(int32_t *rp, const void *cp, int32_t *wp,
+				     int32_t *fir_start, int32_t *fir_end,
+				     const int taps_x_nch, const int shift,
+				     const int nch)
+{
+	const int16_t *coef;
+	const int qshift = 15 + shift; /* Q2.46 -> Q2.31 */
+	const int32_t rnd = 1 << (qshift - 1); /* Half LSB */
+	const int fir_words = fir_end - fir_start;
+	const int taps = taps_x_nch / nch;
+	int32_t *front;
+	int32_t *back;
+	int64_t y;
+	int i;
+	int j;
+
+	for (j = 0; j < nch; j++) {
+		/* Initialization code ensures that circular wrap does not
+		 * happen mid-frame.
+		 */
+		front = rp - j;
+		back = front + taps_x_nch - nch;
+		if (back >= fir_end)
+			back -= fir_words;
+
+		y = rnd;
+		coef = (const int16_t *)cp;
+		for (i = 0; i < taps >> 1; i++, coef++) {
+			y += (int64_t)(*coef) * ((int64_t)*front + *back);
+			front += nch;
+			if (front >= fir_end)
+				front -= fir_words;
+			back -= nch;
+			if (back < fir_start)
+				back += fir_words;
+		}
+
+		/* Middle tap of an odd length filter */
+		if (taps & 1)
+			y += (int64_t)(*coef) * (*front);
+
+		wp[j] = sat_int32(y >> qshift);
+	}
+}
+#endif
+
 #else /* 32bit coefficients version */
 
 static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
@@ -207,6 +313,112 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 	}
 }
 
+#if CONFIG_COMP_SRC_INTERLEAVED
+/*
+ * All channels of a frame are filtered in one pass, each coefficient is loaded
+ * and scaled once for the frame. Every channel is accumulated in the same order
+ * as in fir_filter_generic(), so the output is the same.
+ */
+static inline void fir_filter_interleaved(int32_t *rp, const void *cp, int32_t *wp,
+					  int32_t *fir_start, int32_t *fir_end,
+					  const int taps_x_nch, const int shift,
+					  const int nch)
+{
+	int64_t y[SRC_INTERLEAVED_MAX_CH];
+	const int32_t *coef = (const int32_t *)cp;
+	const int qshift = 23 + shift; /* Qx.54 -> Qx.31 */
+	const int32_t rnd = 1 << (qshift - 1); /* Half LSB */
+	int32_t scaled_coef;
+	int32_t *data;
+	int frames;
+	int n1;
+	int n2;
+	int i;
+	int j;
+
+	/* The channels of a frame are stored in reverse order, data points
+	 * to the last channel. Initialization code ensures that circular
+	 * wrap does not happen mid-frame.
+	 */
+	data = rp - nch + 1;
+	frames = fir_end - data; /* Words until wrap */
+	n1 = ((taps_x_nch < frames) ? taps_x_nch : frames) / nch;
+	n2 = taps_x_nch / nch - n1;
+
+	for (j = 0; j < nch; j++)
+		y[j] = rnd;
+
+	for (i = 0; i < n1; i++, data += nch) {
+		scaled_coef = *coef++ >> 8;
+		for (j = 0; j < nch; j++)
+			y[j] += (int64_t)scaled_coef * data[j];
+	}
+
+	data = fir_start;
+	for (i = 0; i < n2; i++, data += nch) {
+		scaled_coef = *coef++ >> 8;
+		for (j = 0; j < nch; j++)
+			y[j] += (int64_t)scaled_coef * data[j];
+	}
+
+	for (j = 0; j < nch; j++)
+		wp[j] = sat_int32(y[nch - 1 - j] >> qshift);
+}
+#endif
+
+#if CONFIG_COMP_SRC_FOLDED
+/*
+ * Single sub-filter stage with symmetric coefficients, the two samples of a
+ * coefficient pair are added first and share one multiply. The sum of the
+ * products is exact in 64 bits, so the output is the same as with
+ * fir_filter_generic().
+ */
+static inline void fir_filter_folded(int32_t *rp, const void *cp, int32_t *wp,
+				     int32_t *fir_start, int32_t *fir_end,
+				     const int taps_x_nch, const int shift,
+				     const int nch)
+{
+	const int32_t *coef;
+	const int qshift = 23 + shift; /* Qx.54 -> Qx.31 */
+	const int32_t rnd = 1 << (qshift - 1); /* Half LSB */
+	const int fir_words = fir_end - fir_start;
+	const int taps = taps_x_nch / nch;
+	int32_t *front;
+	int32_t *back;
+	int64_t y;
+	int i;
+	int j;
+
+	for (j = 0; j < nch; j++) {
+		/* Initialization code ensures that circular wrap does not
+		 * happen mid-frame.
+		 */
+		front = rp - j;
+		back = front + taps_x_nch - nch;
+		if (back >= fir_end)
+			back -= fir_words;
+
+		y = rnd;
+		coef = (const int32_t *)cp;
+		for (i = 0; i < taps >> 1; i++, coef++) {
+			y += (int64_t)(*coef >> 8) * ((int64_t)*front + *back);
+			front += nch;
+			if (front >= fir_end)
+				front -= fir_words;
+			back -= nch;
+			if (back < fir_start)
+				back += fir_words;
+		}
+
+		/* Middle tap of an odd length filter */
+		if (taps & 1)
+			y += (int64_t)(*coef >> 8) * (*front);
+
+		wp[j] = sat_int32(y >> qshift);
+	}
+}
+#endif
+
 #endif /* 32bit coefficients version */
 
 #if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
@@ -274,8 +486,20 @@ void src_polyphase_stage_cir(struct src_stage_prm *s)
 		src_inc_wrap(&rp, fir_end, fir_size);
 		wp = fir->out_rp;
 		for (i = 0; i < cfg->num_of_subfilters; i++) {
-			fir_filter_generic(rp, cp, wp, fir_delay, fir_end,
-					   taps_x_nch, cfg->shift, nch);
+#if CONFIG_COMP_SRC_FOLDED
+			if (fir->folded)
+				fir_filter_folded(rp, cp, wp, fir_delay, fir_end,
+						  taps_x_nch, cfg->shift, nch);
+			else
+#endif
+#if CONFIG_COMP_SRC_INTERLEAVED
+			if (s->interleaved)
+				fir_filter_interleaved(rp, cp, wp, fir_delay, fir_end,
+						       taps_x_nch, cfg->shift, nch);
+			else
+#endif
+				fir_filter_generic(rp, cp, wp, fir_delay, fir_end,
+						   taps_x_nch, cfg->shift, nch);
 			wp += nch_x_odm;
 			cp = (char *)cp + subfilter_size;
 			src_inc_wrap(&wp, out_delay_end, out_size);
@@ -372,8 +596,20 @@ void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
 		src_inc_wrap(&rp, fir_end, fir_size);
 		wp = fir->out_rp;
 		for (i = 0; i < cfg->num_of_subfilters; i++) {
-			fir_filter_generic(rp, cp, wp, fir_delay, fir_end,
-					   taps_x_nch, cfg->shift, nch);
+#if CONFIG_COMP_SRC_FOLDED
+			if (fir->folded)
+				fir_filter_folded(rp, cp, wp, fir_delay, fir_end,
+						  taps_x_nch, cfg->shift, nch);
+			else
+#endif
+#if CONFIG_COMP_SRC_INTERLEAVED
+			if (s->interleaved)
+				fir_filter_interleaved(rp, cp, wp, fir_delay, fir_end,
+						       taps_x_nch, cfg->shift, nch);
+			else
+#endif
+				fir_filter_generic(rp, cp, wp, fir_delay, fir_end,
+						   taps_x_nch, cfg->shift, nch);
 			wp += nch_x_odm;
 			cp = (char *)cp + subfilter_size;
 			src_inc_wrap(&wp, out_delay_end, out_size);
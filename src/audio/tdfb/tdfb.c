@@ -76,6 +76,12 @@ static inline int set_func(struct processing_module *mod, enum sof_ipc_frame fmt
 		comp_err(mod->dev, "set_func(), invalid frame_fmt");
 		return -EINVAL;
 	}
+
+#if CONFIG_COMP_TDFB_FFT
+	/* The frequency domain version handles all formats */
+	if (cd->fft)
+		cd->tdfb_func = tdfb_fft_process;
+#endif
 	return 0;
 }
 
@@ -311,6 +317,15 @@ static int tdfb_setup(struct processing_module *mod, int source_nch, int sink_nc
 	if (delay_size < 0)
 		return delay_size; /* Contains error code */
 
+#if CONFIG_COMP_TDFB_FFT
+	if (tdfb_fft_select(cd)) {
+		tdfb_free_delaylines(cd);
+		return tdfb_fft_setup(mod, source_nch, sink_nch);
+	}
+
+	tdfb_fft_free(cd);
+#endif
+
 	/* If all channels were set to bypass there's no need to
 	 * allocate delay. Just return with success.
 	 */
@@ -339,6 +354,70 @@ static int tdfb_setup(struct processing_module *mod, int source_nch, int sink_nc
 	return 0;
 }
 
+/*
+ * A delta update within the coefficients of one filter or within the output
+ * mix vectors leaves the blob layout unchanged. The filters then switch to
+ * the new blob keeping their delay lines. The frequency domain filters keep
+ * the filter spectra and need the full setup.
+ */
+static bool tdfb_delta_in_place(struct tdfb_comp_data *cd)
+{
+	struct sof_tdfb_config *config = cd->config;
+	struct sof_fir_coef_data *coef_data;
+	int16_t *coefp;
+	uint32_t offset;
+	uint32_t size;
+	int num_mix;
+	int num_filters;
+	int i;
+
+	if (!config || !comp_data_blob_get_delta(cd->model_handler, &offset, &size))
+		return false;
+
+#if CONFIG_COMP_TDFB_FFT
+	if (cd->fft)
+		return false;
+#endif
+
+	num_filters = config->num_filters * (config->num_angles + config->beam_off_defined);
+	coefp = ASSUME_ALIGNED(&config->data[0], 2);
+	for (i = 0; i < num_filters; i++) {
+		coef_data = (struct sof_fir_coef_data *)coefp;
+		if (comp_data_blob_delta_within(offset, size, config, coef_data->coef,
+						coef_data->length * sizeof(int16_t)))
+			return true;
+
+		coefp = coef_data->coef + coef_data->length;
+	}
+
+	/* Output channel, output stream and beam off output channel mixes
+	 * follow the input channel select vector.
+	 */
+	num_mix = 2 + config->beam_off_defined;
+	coefp += config->num_filters;
+	return comp_data_blob_delta_within(offset, size, config, coefp,
+					   num_mix * config->num_filters * sizeof(int16_t));
+}
+
+static void tdfb_rebase(struct tdfb_comp_data *cd, void *old_config)
+{
+	int i;
+
+	cd->input_channel_select = comp_data_blob_rebase(cd->input_channel_select, old_config,
+							 cd->config);
+	cd->output_channel_mix = comp_data_blob_rebase(cd->output_channel_mix, old_config,
+						       cd->config);
+	cd->output_stream_mix = comp_data_blob_rebase(cd->output_stream_mix, old_config,
+						      cd->config);
+	cd->filter_angles = comp_data_blob_rebase(cd->filter_angles, old_config, cd->config);
+	cd->mic_locations = comp_data_blob_rebase(cd->mic_locations, old_config, cd->config);
+	for (i = 0; i < SOF_TDFB_FIR_MAX_COUNT; i++) {
+		if (cd->fir[i].coef)
+			cd->fir[i].coef = comp_data_blob_rebase(cd->fir[i].coef, old_config,
+								cd->config);
+	}
+}
+
 /*
  * End of algorithm code. Next the standard component methods.
  */
@@ -389,6 +468,8 @@ static int tdfb_init(struct processing_module *mod)
 		goto err;
 	}
 
+	comp_data_blob_set_delta(cd->model_handler);
+
 	/* Get configuration data and reset FIR filters */
 	ret = comp_init_data_blob(cd->model_handler, bs, cfg->data);
 	if (ret < 0) {
@@ -424,6 +505,9 @@ static int tdfb_free(struct processing_module *mod)
 
 	ipc_msg_free(cd->msg);
 	tdfb_free_delaylines(cd);
+#if CONFIG_COMP_TDFB_FFT
+	tdfb_fft_free(cd);
+#endif
 	comp_data_blob_handler_free(cd->model_handler);
 	tdfb_direction_free(cd);
 	rfree(cd->ctrl_data);
@@ -459,13 +543,18 @@ static int tdfb_process(struct processing_module *mod,
 	struct tdfb_comp_data *cd = module_get_private_data(mod);
 	struct audio_stream *source = input_buffers[0].data;
 	struct audio_stream *sink = output_buffers[0].data;
+	struct sof_tdfb_config *old_config;
 	int frame_count = input_buffers[0].size;
 	int ret;
 
 	comp_dbg(dev, "tdfb_process()");
 
 	/* Check for changed configuration */
-	if (comp_is_new_data_blob_available(cd->model_handler)) {
+	if (comp_is_new_data_blob_available(cd->model_handler) && tdfb_delta_in_place(cd)) {
+		old_config = cd->config;
+		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+		tdfb_rebase(cd, old_config);
+	} else if (comp_is_new_data_blob_available(cd->model_handler)) {
 		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
 		ret = tdfb_setup(mod, audio_stream_get_channels(source),
 				 audio_stream_get_channels(sink));
@@ -473,6 +562,10 @@ static int tdfb_process(struct processing_module *mod,
 			comp_err(dev, "tdfb_process(), failed FIR setup");
 			return ret;
 		}
+
+		ret = set_func(mod, audio_stream_get_frm_fmt(source));
+		if (ret)
+			return ret;
 	}
 
 	/* Handle enum controls */
@@ -484,6 +577,10 @@ static int tdfb_process(struct processing_module *mod,
 			comp_err(dev, "tdfb_process(), failed FIR setup");
 			return ret;
 		}
+
+		ret = set_func(mod, audio_stream_get_frm_fmt(source));
+		if (ret)
+			return ret;
 	}
 
 	/*
@@ -601,6 +698,9 @@ static int tdfb_reset(struct processing_module *mod)
 	comp_info(mod->dev, "tdfb_reset()");
 
 	tdfb_free_delaylines(cd);
+#if CONFIG_COMP_TDFB_FFT
+	tdfb_fft_free(cd);
+#endif
 
 	cd->tdfb_func = NULL;
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
@@ -14,6 +14,9 @@
 #include <sof/math/fir_hifi2ep.h>
 #include <sof/math/fir_hifi3.h>
 #include <sof/math/iir_df1.h>
+#if CONFIG_COMP_TDFB_FFT
+#include <sof/math/fft.h>
+#endif
 #include <sof/platform.h>
 
 /* Select optimized code variant when xt-xcc compiler is used */
@@ -65,12 +68,18 @@ struct tdfb_direction_data {
 	int32_t level;
 	int32_t unit_delay; /* Q1.31 seconds */
 	int32_t frame_count_since_control;
+	int32_t frame_count_since_update;
+	int32_t update_frames;		/* Frames between direction estimates */
 	int32_t *df1_delay;
-	int32_t *r;
+	int64_t *r;			/* Accumulated xcorr per mic pair */
+	uint32_t pair_mask;		/* Mic pairs with accumulated xcorr */
+	int16_t pair;			/* Next mic pair to correlate */
 	int16_t *d;
 	int16_t *d_end;
 	int16_t *wp;
 	int16_t *rp;
+	int16_t *xcorr_x;		/* Lagged channel with max_lag frames on both sides */
+	int16_t *xcorr_y;		/* First channel */
 	int16_t step_sign;
 	int16_t az_slow;
 	int16_t az;
@@ -80,6 +89,30 @@ struct tdfb_direction_data {
 	bool line_array; /* Limit scan to -90 to 90 degrees */
 };
 
+#if CONFIG_COMP_TDFB_FFT
+/* frequency domain filter bank state, see tdfb_fft.c */
+struct tdfb_fft {
+	struct fft_real_plan *plan;
+	int32_t *time;			/**< size samples work buffer */
+	struct icomplex32 *spec;	/**< bins work buffer */
+	struct icomplex32 *weights;	/**< num_filters x bins, H * 2^-exp */
+	struct icomplex32 *mic_spectra;	/**< mics x bins, newest input spectra */
+	int32_t *in;			/**< previous and current block per mic */
+	int32_t *out;			/**< output block per output channel */
+	int8_t mixed[PLATFORM_MAX_CHANNELS][SOF_TDFB_FIR_MAX_COUNT]; /**< filters per output */
+	int num_mixed[PLATFORM_MAX_CHANNELS];
+	uint32_t mic_mask;		/**< microphones used by the filters */
+	int block;			/**< block length B, power of two */
+	int size;			/**< FFT length 2B */
+	int bins;			/**< stored bins B + 1 */
+	int mics;			/**< max used input channel plus one */
+	int out_nch;
+	int num_filters;
+	int exp;			/**< exponent of the weights */
+	int fill;			/**< frames in the current block */
+};
+#endif /* CONFIG_COMP_TDFB_FFT */
+
 struct tdfb_comp_data {
 	struct fir_state_32x16 fir[SOF_TDFB_FIR_MAX_COUNT]; /**< FIR state */
 	struct comp_data_blob_handler *model_handler;
@@ -99,6 +132,9 @@ struct tdfb_comp_data {
 	int16_t az_value_estimate;	    /**< beam steer azimuth as in control enum */
 	size_t fir_delay_size;              /**< allocated size */
 	unsigned int max_frames;	    /**< max frames to process */
+#if CONFIG_COMP_TDFB_FFT
+	struct tdfb_fft *fft;		    /**< frequency domain processing, if active */
+#endif
 	bool direction_updates:1;	    /**< set true if direction angle control is updated */
 	bool direction_change:1;	    /**< set if direction value has significant change */
 	bool beam_on:1;			    /**< set true if beam is off */
@@ -127,6 +163,17 @@ void tdfb_fir_s32(struct tdfb_comp_data *cd,
 		  struct output_stream_buffer *bsink, int frames);
 #endif
 
+#if CONFIG_COMP_TDFB_FFT
+bool tdfb_fft_select(struct tdfb_comp_data *cd);
+
+int tdfb_fft_setup(struct processing_module *mod, int source_nch, int sink_nch);
+
+void tdfb_fft_free(struct tdfb_comp_data *cd);
+
+void tdfb_fft_process(struct tdfb_comp_data *cd, struct input_stream_buffer *bsource,
+		      struct output_stream_buffer *bsink, int frames);
+#endif /* CONFIG_COMP_TDFB_FFT */
+
 int tdfb_direction_init(struct tdfb_comp_data *cd, int32_t fs, int channels);
 void tdfb_direction_copy_emphasis(struct tdfb_comp_data *cd, int channels, int *channel, int32_t x);
 void tdfb_direction_estimate(struct tdfb_comp_data *cd, int frames, int channels);
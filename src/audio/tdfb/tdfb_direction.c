@@ -9,9 +9,12 @@
 
 #include <ipc/topology.h>
 #include <rtos/alloc.h>
+#include <rtos/bit.h>
+#include <rtos/string.h>
 #include <sof/math/iir_df1.h>
 #include <sof/math/trig.h>
 #include <sof/math/sqrt.h>
+#include <sof/math/xcorr.h>
 #include <user/eq.h>
 #include <stdint.h>
 
@@ -37,9 +40,9 @@
 #define AZ_ITERATIONS		8				/* loops in min err search */
 #define SOURCE_DISTANCE		Q_CONVERT_FLOAT(3.0, 12)	/* source distance in m Q4.12 */
 
-/* Sound direction angle filtering */
-#define SLOW_AZ_C1		Q_CONVERT_FLOAT(0.02, 15)
-#define SLOW_AZ_C2		Q_CONVERT_FLOAT(0.98, 15)
+/* Sound direction angle filtering, per direction search */
+#define SLOW_AZ_C1		Q_CONVERT_FLOAT(0.25, 15)
+#define SLOW_AZ_C2		Q_CONVERT_FLOAT(0.75, 15)
 
 /* Threshold for notifying user space, no more often than every 200 ms */
 #define CONTROL_UPDATE_MIN_TIME	Q_CONVERT_FLOAT(0.2, 16)
@@ -186,6 +189,7 @@ int tdfb_direction_init(struct tdfb_comp_data *cd, int32_t fs, int ch_count)
 	int32_t d_max;
 	int32_t t_max;
 	size_t size;
+	int pairs = MAX(ch_count - 1, 1);
 	int n;
 	int i;
 
@@ -239,22 +243,43 @@ int tdfb_direction_init(struct tdfb_comp_data *cd, int32_t fs, int ch_count)
 	cd->direction.rp = cd->direction.d;
 	cd->direction.wp = cd->direction.d + ch_count * (cd->direction.max_lag + 1);
 
-	/* xcorr result is temporary but too large for stack so it is allocated here */
-	cd->direction.r_size = (2 * cd->direction.max_lag + 1) * sizeof(int32_t);
+	/* The xcorr of each mic pair vs. the first mic is accumulated until the next
+	 * direction search.
+	 */
+	cd->direction.r_size = pairs * (2 * cd->direction.max_lag + 1) * sizeof(int64_t);
 	cd->direction.r = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, cd->direction.r_size);
 	if (!cd->direction.r)
 		goto err_free_all;
 
+	/* Linear copies of the correlated channels */
+	cd->direction.xcorr_x = rballoc(0, SOF_MEM_CAPS_RAM, sizeof(int16_t) *
+					(cd->max_frames + 2 * cd->direction.max_lag));
+	cd->direction.xcorr_y = rballoc(0, SOF_MEM_CAPS_RAM, sizeof(int16_t) * cd->max_frames);
+	if (!cd->direction.xcorr_x || !cd->direction.xcorr_y)
+		goto err_free_all;
+
 	/* Check for line array mode */
 	cd->direction.line_array = line_array_mode_check(cd);
 
 	/* Initialize direction to zero radians, set initial step sign to +1 */
 	cd->direction.az = 0;
 	cd->direction.step_sign = 1;
+
+	/* The direction search runs at a fraction of the processing rate */
+	cd->direction.update_frames = fs / CONFIG_COMP_TDFB_DIRECTION_UPDATE_RATE;
+	cd->direction.frame_count_since_update = 0;
+	cd->direction.pair_mask = 0;
+	cd->direction.pair = 0;
 	return 0;
 
 err_free_all:
+	rfree(cd->direction.xcorr_x);
+	rfree(cd->direction.xcorr_y);
+	rfree(cd->direction.r);
 	rfree(cd->direction.d);
+	cd->direction.xcorr_x = NULL;
+	cd->direction.xcorr_y = NULL;
+	cd->direction.r = NULL;
 	cd->direction.d = NULL;
 
 err_free_iir:
@@ -268,6 +293,8 @@ void tdfb_direction_free(struct tdfb_comp_data *cd)
 	rfree(cd->direction.df1_delay);
 	rfree(cd->direction.d);
 	rfree(cd->direction.r);
+	rfree(cd->direction.xcorr_x);
+	rfree(cd->direction.xcorr_y);
 }
 
 /* Measure level of one channel */
@@ -310,7 +337,7 @@ static void level_update(struct tdfb_comp_data *cd, int frames, int ch_count, in
 		cd->direction.frame_count_since_control = INT32_MAX;
 }
 
-static int find_max_value_index(int32_t *v, int length)
+static int find_max_value_index(int64_t *v, int length)
 {
 	int idx = 0;
 	int i;
@@ -323,45 +350,72 @@ static int find_max_value_index(int32_t *v, int length)
 	return idx;
 }
 
-static void time_differences(struct tdfb_comp_data *cd, int frames, int ch_count)
+/* Copy frames of one channel from the circular delay line */
+static void xcorr_copy_channel(struct tdfb_comp_data *cd, int16_t *p, int16_t *dst,
+			       int frames, int ch_count)
+{
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		dst[i] = *p;
+		p += ch_count;
+		tdfb_cinc_s16(&p, cd->direction.d_end, cd->direction.d_size);
+	}
+}
+
+/* Accumulate xcorr of one mic pair per call, the pairs are correlated in turns */
+static void xcorr_accumulate(struct tdfb_comp_data *cd, int frames, int ch_count)
 {
-	int64_t r;
 	int16_t *x;
-	int16_t *y;
+	int max_lag = cd->direction.max_lag;
+	int c = cd->direction.pair + 1;
+
+	if (ch_count < 2)
+		goto out;
+
+	/* Calculate xcorr for channel 0 vs. c. Scan -maxlag .. +maxlag. The
+	 * channel c is copied with max_lag frames before and after the frames
+	 * of the first channel.
+	 */
+	xcorr_copy_channel(cd, cd->direction.rp, cd->direction.xcorr_y, frames, ch_count);
+	x = cd->direction.rp - max_lag * ch_count + c;
+	tdfb_cinc_s16(&x, cd->direction.d_end, cd->direction.d_size);
+	tdfb_cdec_s16(&x, cd->direction.d, cd->direction.d_size);
+	xcorr_copy_channel(cd, x, cd->direction.xcorr_x, frames + 2 * max_lag, ch_count);
+	sofm_xcorr_acc_16(&cd->direction.xcorr_x[max_lag], cd->direction.xcorr_y, frames,
+			  max_lag, &cd->direction.r[cd->direction.pair * (2 * max_lag + 1)]);
+
+	cd->direction.pair_mask |= BIT(cd->direction.pair);
+	if (c == ch_count - 1)
+		cd->direction.pair = 0;
+	else
+		cd->direction.pair++;
+
+out:
+	cd->direction.rp += frames * ch_count;
+	tdfb_cinc_s16(&cd->direction.rp, cd->direction.d_end, cd->direction.d_size);
+}
+
+/* Get time differences from the accumulated xcorr, returns false if some mic pair
+ * has not been correlated since previous search.
+ */
+static bool time_differences(struct tdfb_comp_data *cd, int ch_count)
+{
 	int r_max_idx;
 	int max_lag = cd->direction.max_lag;
+	int n = 2 * max_lag + 1;
 	int c;
-	int k;
-	int i;
-	int32_t maxval = 0;
 
-	/* Calculate xcorr for channel 0 vs. 1 .. (ch_count-1). Scan -maxlag .. +maxlag*/
+	if (ch_count > 1 && cd->direction.pair_mask != BIT(ch_count - 1) - 1)
+		return false;
+
 	for (c = 1; c < ch_count; c++) {
-		for (k = -max_lag; k <= max_lag; k++) {
-			y = cd->direction.rp; /* First channel */
-			x = y + k * ch_count + c; /* other channel C */
-			tdfb_cinc_s16(&x, cd->direction.d_end, cd->direction.d_size);
-			tdfb_cdec_s16(&x, cd->direction.d, cd->direction.d_size);
-			r = 0;
-			for (i = 0; i < frames; i++) {
-				if (maxval < *y)
-					maxval = *y;
-
-				r += (int32_t)*x * *y;
-				y += ch_count;
-				tdfb_cinc_s16(&y, cd->direction.d_end, cd->direction.d_size);
-				x += ch_count;
-				tdfb_cinc_s16(&x, cd->direction.d_end, cd->direction.d_size);
-			}
-			/* Scale for max. 20 ms 48 kHz frame */
-			cd->direction.r[k + max_lag] = sat_int32(((r >> 8) + 1) >> 1);
-		}
-		r_max_idx = find_max_value_index(&cd->direction.r[0], 2 * max_lag + 1);
+		r_max_idx = find_max_value_index(&cd->direction.r[(c - 1) * n], n);
 		cd->direction.timediff[c - 1] = (int32_t)(r_max_idx - max_lag) *
 			cd->direction.unit_delay;
 	}
-	cd->direction.rp += frames * ch_count;
-	tdfb_cinc_s16(&cd->direction.rp, cd->direction.d_end, cd->direction.d_size);
+
+	return true;
 }
 
 static int16_t distance_from_source(struct tdfb_comp_data *cd, int mic_n,
@@ -530,24 +584,38 @@ static int convert_angle_to_enum(struct tdfb_comp_data *cd)
 	return new_az_value;
 }
 
-/* Placeholder function for sound direction estimate */
+/* Sound direction estimate, the xcorr is accumulated for every processed period
+ * and the direction search runs at CONFIG_COMP_TDFB_DIRECTION_UPDATE_RATE.
+ */
 void tdfb_direction_estimate(struct tdfb_comp_data *cd, int frames, int ch_count)
 {
 	int32_t time_since;
 	int new_az_value;
+	bool complete;
 
 	if (!cd->direction_updates)
 		return;
 
-	/* Update levels, skip rest of estimation if level does not exceed well ambient */
+	/* Update levels, skip xcorr if level does not exceed well ambient */
 	level_update(cd, frames, ch_count, 0);
-	if (!(cd->direction.trigger & 1)) {
+	if (cd->direction.trigger & 1)
+		xcorr_accumulate(cd, frames, ch_count);
+	else
 		updates_when_no_trigger(cd, frames, ch_count);
+
+	cd->direction.frame_count_since_update += frames;
+	if (cd->direction.frame_count_since_update < cd->direction.update_frames)
 		return;
-	}
 
-	/* Compute time differences of ch_count vs. reference channel 1 */
-	time_differences(cd, frames, ch_count);
+	/* Compute time differences of ch_count vs. reference channel 1 and start
+	 * a new accumulation.
+	 */
+	cd->direction.frame_count_since_update = 0;
+	complete = time_differences(cd, ch_count);
+	bzero(cd->direction.r, cd->direction.r_size);
+	cd->direction.pair_mask = 0;
+	if (!complete)
+		return;
 
 	/* Determine direction angle */
 	iterate_source_angle(cd);
@@ -0,0 +1,348 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/module_adapter/module/generic.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/fft.h>
+#include <sof/math/numbers.h>
+#include <sof/trace/trace.h>
+#include <rtos/alloc.h>
+#include <rtos/bit.h>
+#include <rtos/string.h>
+#include <ipc/stream.h>
+#include <ipc/topology.h>
+#include <user/fir.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tdfb.h"
+#include "tdfb_comp.h"
+
+LOG_MODULE_DECLARE(tdfb, CONFIG_SOF_LOG_LEVEL);
+
+/*
+ * Frequency domain filter and sum with overlap-save. The block length B is
+ * the filters length rounded up to a power of two and the FFT length is 2B.
+ * For each block of B input frames the spectrum of the last 2B samples of
+ * each microphone is computed once. Each output channel spectrum is the sum
+ * of the products of the microphone spectra and the complex weights, i.e.
+ * the spectra of the filters mixed to it. The second half of its IFFT is the
+ * output block. The output is delayed by B samples.
+ *
+ * Spectra are kept in the FFT library scale, i.e. divided by the FFT size,
+ * and only the bins 0 to B of the real signals are stored.
+ */
+
+bool tdfb_fft_select(struct tdfb_comp_data *cd)
+{
+	int taps = 0;
+	int i;
+
+	for (i = 0; i < cd->config->num_filters; i++)
+		taps += cd->fir[i].taps;
+
+	return taps > CONFIG_COMP_TDFB_FFT_THRESHOLD;
+}
+
+void tdfb_fft_free(struct tdfb_comp_data *cd)
+{
+	struct tdfb_fft *fft = cd->fft;
+
+	if (!fft)
+		return;
+
+	fft_real_plan_free(fft->plan);
+	rfree(fft->time);
+	rfree(fft->spec);
+	rfree(fft->weights);
+	rfree(fft->mic_spectra);
+	rfree(fft->in);
+	rfree(fft);
+	cd->fft = NULL;
+}
+
+/* Compute the weights of the filters of the current beam with a common
+ * exponent. The output shift of each filter is included in its weights.
+ */
+static void tdfb_fft_init_weights(struct tdfb_comp_data *cd)
+{
+	struct tdfb_fft *fft = cd->fft;
+	struct icomplex32 *w;
+	int16_t *coef;
+	int32_t peak;
+	int norm[SOF_TDFB_FIR_MAX_COUNT];
+	int shift;
+	int exp = INT32_MAX;
+	int i;
+	int k;
+
+	for (i = 0; i < fft->num_filters; i++) {
+		/* the coefficients are in blob order with all FIR versions */
+		coef = (int16_t *)cd->fir[i].coef;
+		bzero(fft->time, fft->size * sizeof(int32_t));
+		for (k = 0; k < cd->fir[i].taps; k++)
+			fft->time[k] = (int32_t)coef[k] << 16;
+
+		w = &fft->weights[i * fft->bins];
+		fft_real_execute_32(fft->plan, fft->time, w);
+		peak = 0;
+		for (k = 0; k < fft->bins; k++)
+			peak |= ABS(w[k].real) | ABS(w[k].imag);
+
+		norm[i] = peak ? norm_int32(peak) : 0;
+		if (peak)
+			exp = MIN(exp, norm[i] + cd->fir[i].out_shift);
+	}
+
+	if (exp == INT32_MAX)
+		exp = 0;
+
+	/* The weights are then H * 2^(exp - out_shift) / size in Q1.31 */
+	for (i = 0; i < fft->num_filters; i++) {
+		shift = exp - cd->fir[i].out_shift;
+		w = &fft->weights[i * fft->bins];
+		for (k = 0; k < fft->bins; k++) {
+			if (shift >= 0) {
+				w[k].real <<= shift;
+				w[k].imag <<= shift;
+			} else {
+				w[k].real >>= -shift;
+				w[k].imag >>= -shift;
+			}
+		}
+	}
+
+	fft->exp = fft->plan->len - exp;
+}
+
+/* Called with a configuration validated by tdfb_init_coef() */
+int tdfb_fft_setup(struct processing_module *mod, int source_nch, int sink_nch)
+{
+	struct tdfb_comp_data *cd = module_get_private_data(mod);
+	struct tdfb_fft *fft = cd->fft;
+	struct comp_dev *dev = mod->dev;
+	const int num_filters = cd->config->num_filters;
+	size_t size;
+	int block = 4;
+	int mics = 0;
+	int om;
+	int i;
+	int k;
+
+	for (i = 0; i < num_filters; i++) {
+		while (block < cd->fir[i].taps)
+			block <<= 1;
+
+		mics = MAX(mics, cd->input_channel_select[i] + 1);
+	}
+
+	/* A beam change keeps the input history and the output block when
+	 * the filter bank geometry does not change.
+	 */
+	if (fft && (fft->block != block || fft->mics != mics || fft->out_nch != sink_nch ||
+		    fft->num_filters != num_filters)) {
+		tdfb_fft_free(cd);
+		fft = NULL;
+	}
+
+	if (!fft) {
+		if (2 * block > FFT_SIZE_MAX) {
+			comp_err(dev, "tdfb_fft_setup(), block %d exceeds FFT size", block);
+			return -EINVAL;
+		}
+
+		fft = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*fft));
+		if (!fft)
+			return -ENOMEM;
+
+		cd->fft = fft;
+		fft->block = block;
+		fft->size = 2 * block;
+		fft->bins = block + 1;
+		fft->mics = mics;
+		fft->out_nch = sink_nch;
+		fft->num_filters = num_filters;
+		fft->plan = fft_real_plan_new(fft->size);
+		fft->time = rballoc(0, SOF_MEM_CAPS_RAM, fft->size * sizeof(int32_t));
+		fft->spec = rballoc(0, SOF_MEM_CAPS_RAM, fft->bins * sizeof(struct icomplex32));
+		fft->weights = rballoc(0, SOF_MEM_CAPS_RAM,
+				       num_filters * fft->bins * sizeof(struct icomplex32));
+		fft->mic_spectra = rballoc(0, SOF_MEM_CAPS_RAM,
+					   mics * fft->bins * sizeof(struct icomplex32));
+
+		/* two input blocks per microphone followed by an output block
+		 * per output channel
+		 */
+		size = (mics * fft->size + sink_nch * block) * sizeof(int32_t);
+		fft->in = rballoc(0, SOF_MEM_CAPS_RAM, size);
+		if (!fft->plan || !fft->time || !fft->spec || !fft->weights ||
+		    !fft->mic_spectra || !fft->in) {
+			comp_err(dev, "tdfb_fft_setup(), allocation failed");
+			tdfb_fft_free(cd);
+			return -ENOMEM;
+		}
+
+		bzero(fft->in, size);
+		fft->out = fft->in + mics * fft->size;
+	}
+
+	/* Get the microphones in use and the filters mixed to each output */
+	fft->mic_mask = 0;
+	for (k = 0; k < sink_nch; k++)
+		fft->num_mixed[k] = 0;
+
+	for (i = 0; i < num_filters; i++) {
+		fft->mic_mask |= BIT(cd->input_channel_select[i]);
+		om = cd->output_channel_mix[i];
+		for (k = 0; k < sink_nch; k++) {
+			if (om & BIT(k))
+				fft->mixed[k][fft->num_mixed[k]++] = i;
+		}
+	}
+
+	tdfb_fft_init_weights(cd);
+	comp_info(dev, "tdfb_fft_setup(), %d filters, %d mics, block %d, exp %d",
+		  num_filters, mics, block, fft->exp);
+	return 0;
+}
+
+static inline int32_t tdfb_fft_scale(int64_t x, int shift)
+{
+	x = shift > 0 ? x << shift : x >> -shift;
+
+	/* symmetric range, the negated value is used for the mirrored bins */
+	return (int32_t)MAX(MIN(x, (int64_t)INT32_MAX), (int64_t)-INT32_MAX);
+}
+
+/* filter one block, the input blocks are complete */
+static void tdfb_fft_block(struct tdfb_fft *fft, struct tdfb_comp_data *cd)
+{
+	struct icomplex32 *buf = fft->spec;
+	struct icomplex32 *x;
+	struct icomplex32 *w;
+	int32_t *in;
+	int64_t re;
+	int64_t im;
+	int f;
+	int i;
+	int j;
+	int k;
+
+	/* one forward transform per microphone serves all beams */
+	for (i = 0; i < fft->mics; i++) {
+		in = &fft->in[i * fft->size];
+		if (fft->mic_mask & BIT(i))
+			fft_real_execute_32(fft->plan, in, &fft->mic_spectra[i * fft->bins]);
+
+		memcpy_s(in, fft->block * sizeof(int32_t),
+			 &in[fft->block], fft->block * sizeof(int32_t));
+	}
+
+	for (i = 0; i < fft->out_nch; i++) {
+		if (!fft->num_mixed[i]) {
+			bzero(&fft->out[i * fft->block], fft->block * sizeof(int32_t));
+			continue;
+		}
+
+		/* Q1.31 x Q1.31 products summed in Q33.31, the exponent of
+		 * the weights is applied to the sum.
+		 */
+		for (k = 0; k < fft->bins; k++) {
+			re = 0;
+			im = 0;
+			for (j = 0; j < fft->num_mixed[i]; j++) {
+				f = fft->mixed[i][j];
+				x = &fft->mic_spectra[cd->input_channel_select[f] * fft->bins + k];
+				w = &fft->weights[f * fft->bins + k];
+				re += ((int64_t)x->real * w->real >> 31) -
+				      ((int64_t)x->imag * w->imag >> 31);
+				im += ((int64_t)x->real * w->imag >> 31) +
+				      ((int64_t)x->imag * w->real >> 31);
+			}
+
+			buf[k].real = tdfb_fft_scale(re, fft->exp);
+			buf[k].imag = tdfb_fft_scale(im, fft->exp);
+		}
+
+		/* the DC and Nyquist bins of a real signal are real */
+		buf[0].imag = 0;
+		buf[fft->block].imag = 0;
+		fft_real_inverse_32(fft->plan, buf, fft->time);
+
+		/* the first half is circular convolution wrap, overlap-save
+		 * drops it
+		 */
+		memcpy_s(&fft->out[i * fft->block], fft->block * sizeof(int32_t),
+			 &fft->time[fft->block], fft->block * sizeof(int32_t));
+	}
+}
+
+static inline int32_t tdfb_fft_read(enum sof_ipc_frame fmt, const void *x)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return (int32_t)*(const int16_t *)x << 16;
+	case SOF_IPC_FRAME_S24_4LE:
+		return *(const int32_t *)x << 8;
+	default:
+		return *(const int32_t *)x;
+	}
+}
+
+static inline void tdfb_fft_write(enum sof_ipc_frame fmt, void *y, int32_t z)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		*(int16_t *)y = sat_int16(Q_SHIFT_RND(z, 31, 15));
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		*(int32_t *)y = sat_int24(Q_SHIFT_RND(z, 31, 23));
+		break;
+	default:
+		*(int32_t *)y = z;
+		break;
+	}
+}
+
+void tdfb_fft_process(struct tdfb_comp_data *cd, struct input_stream_buffer *bsource,
+		      struct output_stream_buffer *bsink, int frames)
+{
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	struct tdfb_fft *fft = cd->fft;
+	const enum sof_ipc_frame fmt = audio_stream_get_frm_fmt(source);
+	const size_t sample_bytes = audio_stream_sample_bytes(source);
+	const int in_nch = audio_stream_get_channels(source);
+	uint8_t *x = audio_stream_get_rptr(source);
+	uint8_t *y = audio_stream_get_wptr(sink);
+	int32_t s;
+	int emp_ch = 0;
+	int i;
+	int j;
+
+	for (i = 0; i < frames; i++) {
+		for (j = 0; j < in_nch; j++) {
+			s = tdfb_fft_read(fmt, x);
+			tdfb_direction_copy_emphasis(cd, in_nch, &emp_ch, s);
+			if (j < fft->mics)
+				fft->in[j * fft->size + fft->block + fft->fill] = s;
+
+			x = audio_stream_wrap(source, x + sample_bytes);
+		}
+
+		for (j = 0; j < fft->out_nch; j++) {
+			tdfb_fft_write(fmt, y, fft->out[j * fft->block + fft->fill]);
+			y = audio_stream_wrap(sink, y + sample_bytes);
+		}
+
+		if (++fft->fill == fft->block) {
+			tdfb_fft_block(fft, cd);
+			fft->fill = 0;
+		}
+	}
+}
@@ -8,6 +8,7 @@
 
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
+#include <sof/audio/data_blob.h>
 #include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
 #include <sof/audio/ipc-config.h>
@@ -44,6 +45,7 @@
 #define TONE_AMPLITUDE_DEFAULT TONE_GAIN(0.1)      /*  -20 dB  */
 #define TONE_FREQUENCY_DEFAULT TONE_FREQ(997.0)
 #define TONE_NUM_FS            13       /* Table size for 8-192 kHz range */
+#define TONE_GEN_SAMPLES       16       /* Max samples per oscillator call */
 
 static const struct comp_driver comp_tone;
 
@@ -78,8 +80,7 @@ struct tone_state {
 	int32_t freq_coef; /* Frequency multiplier Q2.30 */
 	int32_t fs; /* Sample rate in Hertz Q32.0 */
 	int32_t ramp_step; /* Amplitude ramp step Q1.31 */
-	int32_t w; /* Angle radians Q4.28 */
-	int32_t w_step; /* Angle step Q4.28 */
+	struct cordic_osc osc; /* Angle and angle step Q4.28 */
 	uint32_t block_count;
 	uint32_t repeat_count;
 	uint32_t repeats; /* Number of repeats for tone (sweep steps) */
@@ -89,17 +90,32 @@ struct tone_state {
 	uint32_t tone_period; /* Active + idle time in 125 us blocks */
 };
 
+#if CONFIG_COMP_TONE_CLIPS
+struct tone_voice {
+	const int32_t *pos; /* next sample, NULL when idle */
+	uint32_t left; /* samples left to play */
+	int32_t gain; /* Q1.31 */
+	uint32_t start; /* clip to start plus one, set by IPC */
+	bool stop; /* stop request, set by IPC */
+};
+#endif
+
 struct comp_data {
 	uint32_t period_bytes;
 	uint32_t channels;
 	uint32_t frame_bytes;
 	uint32_t rate;
 	struct tone_state sg[PLATFORM_MAX_CHANNELS];
+#if CONFIG_COMP_TONE_CLIPS
+	struct comp_data_blob_handler *clip_handler;
+	struct sof_tone_clip_bank *bank;
+	struct tone_voice voice[CONFIG_COMP_TONE_CLIP_VOICES];
+#endif
 	void (*tone_func)(struct comp_dev *dev, struct audio_stream *sink,
 			  uint32_t frames);
 };
 
-static int32_t tonegen(struct tone_state *sg);
+static void tonegen(struct tone_state *sg, int32_t *sine, uint32_t n);
 static void tonegen_control(struct tone_state *sg);
 static void tonegen_update_f(struct tone_state *sg, int32_t f);
 
@@ -117,51 +133,54 @@ static void tone_s32_default(struct comp_dev *dev, struct audio_stream *sink,
 			     uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *dest = audio_stream_get_wptr(sink);
-	int i;
-	int n;
-	int n_wrap_dest;
-	int n_min;
+	int32_t *dest;
+	int32_t *end = audio_stream_get_end_addr(sink);
+	int32_t sine[TONE_GEN_SAMPLES];
+	struct tone_state *sg;
+	uint32_t left;
+	uint32_t n;
+	uint32_t j;
 	int nch = cd->channels;
+	int i;
 
-	n = frames * nch;
-	while (n > 0) {
-		n_wrap_dest = (int32_t *)audio_stream_get_end_addr(sink) - dest;
-		n_min = (n < n_wrap_dest) ? n : n_wrap_dest;
-		/* Process until wrap or completed n */
-		while (n_min > 0) {
-			n -= nch;
-			n_min -= nch;
-			for (i = 0; i < nch; i++) {
-				tonegen_control(&cd->sg[i]);
-				*dest = tonegen(&cd->sg[i]);
-				dest++;
+	/* The channels are independent, each one is generated in runs of
+	 * samples between the 125 us block boundaries where
+	 * tonegen_control() may change the amplitude, frequency or phase.
+	 */
+	for (i = 0; i < nch; i++) {
+		sg = &cd->sg[i];
+		dest = (int32_t *)audio_stream_get_wptr(sink) + i;
+		for (left = frames; left; left -= n) {
+			if (sg->sample_count + 1 < sg->samples_in_block) {
+				n = MIN(sg->samples_in_block - 1 - sg->sample_count, left);
+				n = MIN(n, TONE_GEN_SAMPLES);
+				sg->sample_count += n;
+			} else {
+				tonegen_control(sg);
+				n = 1;
+			}
+
+			tonegen(sg, sine, n);
+			for (j = 0; j < n; j++) {
+				*dest = sine[j];
+				dest += nch;
+				tone_circ_inc_wrap(&dest, end, audio_stream_get_size(sink));
 			}
 		}
-		tone_circ_inc_wrap(&dest, audio_stream_get_end_addr(sink),
-				   audio_stream_get_size(sink));
 	}
 }
 
-static int32_t tonegen(struct tone_state *sg)
+static void tonegen(struct tone_state *sg, int32_t *sine, uint32_t n)
 {
-	int64_t sine;
-	int64_t w;
-	/* sg->w is angle in Q4.28 radians format, sin() returns Q1.31 */
-	/* sg->a is amplitude as Q1.31 */
-	sine =
-		q_mults_32x32(sin_fixed_32b(sg->w), sg->a,
-			      Q_SHIFT_BITS_64(31, 31, 31));
+	uint32_t i;
 
-	/* Next point */
-	w = (int64_t)sg->w + sg->w_step;
-	sg->w = (w > PI_MUL2_Q4_28)
-		? (int32_t)(w - PI_MUL2_Q4_28) : (int32_t)w;
+	/* sg->osc.w is angle in Q4.28 radians format, sine is Q1.31 */
+	cordic_osc_sin_32b(&sg->osc, sine, n);
 
-	if (sg->mute)
-		return 0;
-	else
-		return (int32_t)sine; /* Q1.31 no saturation need */
+	/* sg->a is amplitude as Q1.31 */
+	for (i = 0; i < n; i++)
+		sine[i] = sg->mute ? 0 :
+			(int32_t)q_mults_32x32(sine[i], sg->a, Q_SHIFT_BITS_64(31, 31, 31));
 }
 
 static void tonegen_control(struct tone_state *sg)
@@ -181,7 +200,7 @@ static void tonegen_control(struct tone_state *sg)
 	/* Fade-in ramp during tone */
 	if (sg->block_count < sg->tone_length) {
 		if (sg->a == 0)
-			sg->w = 0; /* Reset phase to have less clicky ramp */
+			sg->osc.w = 0; /* Reset phase to have less clicky ramp */
 
 		if (sg->a > sg->a_target) {
 			a = (int64_t)sg->a - sg->ramp_step;
@@ -310,7 +329,7 @@ static void tonegen_update_f(struct tone_state *sg, int32_t f)
 	/* Q16 x Q31 -> Q28 */
 	w_tmp = q_multsr_32x32(sg->f, sg->c, Q_SHIFT_BITS_64(16, 31, 28));
 	w_tmp = (w_tmp > PI_Q4_28) ? PI_Q4_28 : w_tmp; /* Limit to pi Q4.28 */
-	sg->w_step = (int32_t)w_tmp;
+	sg->osc.w_step = (int32_t)w_tmp;
 }
 
 static void tonegen_reset(struct tone_state *sg)
@@ -320,8 +339,8 @@ static void tonegen_reset(struct tone_state *sg)
 	sg->a_target = TONE_AMPLITUDE_DEFAULT;
 	sg->c = 0;
 	sg->f = TONE_FREQUENCY_DEFAULT;
-	sg->w = 0;
-	sg->w_step = 0;
+	sg->osc.w = 0;
+	sg->osc.w_step = 0;
 
 	sg->block_count = 0;
 	sg->repeat_count = 0;
@@ -358,7 +377,7 @@ static int tonegen_init(struct tone_state *sg, int32_t fs, int32_t f, int32_t a)
 	}
 
 	if (idx < 0) {
-		sg->w_step = 0;
+		sg->osc.w_step = 0;
 		return -EINVAL;
 	}
 
@@ -373,6 +392,151 @@ static int tonegen_init(struct tone_state *sg, int32_t fs, int32_t f, int32_t a)
 
 	return 0;
 }
+#if CONFIG_COMP_TONE_CLIPS
+static int tone_clip_bank_validate(struct comp_dev *dev, void *new_data,
+				   uint32_t new_data_size)
+{
+	struct sof_tone_clip_bank *bank = new_data;
+	struct sof_tone_clip *clip;
+	uint32_t i;
+
+	if (new_data_size < sizeof(*bank) ||
+	    bank->num_clips > (new_data_size - sizeof(*bank)) / sizeof(*clip)) {
+		comp_err(dev, "tone_clip_bank_validate(): invalid bank size %u", new_data_size);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < bank->num_clips; i++) {
+		clip = &bank->clips[i];
+		if ((clip->offset & (sizeof(int32_t) - 1)) ||
+		    clip->offset > new_data_size ||
+		    clip->samples > (new_data_size - clip->offset) / sizeof(int32_t)) {
+			comp_err(dev, "tone_clip_bank_validate(): invalid clip %u", i);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/* Picks up a new clip bank and the voice requests of IPC, a new bank
+ * stops all voices since the old one is freed.
+ */
+static void tone_voices_update(struct comp_data *cd)
+{
+	struct tone_voice *voice;
+	struct sof_tone_clip *clip;
+	uint32_t start;
+	int i;
+
+	if (comp_is_new_data_blob_available(cd->clip_handler)) {
+		cd->bank = comp_get_data_blob(cd->clip_handler, NULL, NULL);
+		for (i = 0; i < CONFIG_COMP_TONE_CLIP_VOICES; i++)
+			cd->voice[i].pos = NULL;
+	}
+
+	for (i = 0; i < CONFIG_COMP_TONE_CLIP_VOICES; i++) {
+		voice = &cd->voice[i];
+
+		if (voice->stop) {
+			voice->stop = false;
+			voice->pos = NULL;
+		}
+
+		start = voice->start;
+		if (!start)
+			continue;
+
+		voice->start = 0;
+		if (!cd->bank || start > cd->bank->num_clips)
+			continue;
+
+		clip = &cd->bank->clips[start - 1];
+		voice->pos = (const int32_t *)((const uint8_t *)cd->bank + clip->offset);
+		voice->left = clip->samples;
+	}
+}
+
+/* mixes the playing voices on top of the frames just generated */
+static void tone_voices_mix(struct comp_dev *dev, struct audio_stream *sink,
+			    uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct tone_voice *voice;
+	int32_t *dest;
+	int32_t *end = audio_stream_get_end_addr(sink);
+	int32_t sample;
+	uint32_t n;
+	uint32_t i;
+	int nch = cd->channels;
+	int v;
+	int j;
+
+	tone_voices_update(cd);
+
+	for (v = 0; v < CONFIG_COMP_TONE_CLIP_VOICES; v++) {
+		voice = &cd->voice[v];
+		if (!voice->pos)
+			continue;
+
+		dest = audio_stream_get_wptr(sink);
+		n = MIN(frames, voice->left);
+		for (i = 0; i < n; i++) {
+			sample = q_multsr_sat_32x32(*voice->pos++, voice->gain, 31);
+			for (j = 0; j < nch; j++) {
+				*dest = sat_int32((int64_t)*dest + sample);
+				dest++;
+			}
+			tone_circ_inc_wrap(&dest, end, audio_stream_get_size(sink));
+		}
+
+		voice->left -= n;
+		if (!voice->left)
+			voice->pos = NULL;
+	}
+}
+
+static int tone_clips_init(struct comp_dev *dev, struct comp_data *cd)
+{
+	int i;
+
+	cd->clip_handler = comp_data_blob_handler_new(dev);
+	if (!cd->clip_handler)
+		return -ENOMEM;
+
+	comp_data_blob_set_validator(cd->clip_handler, tone_clip_bank_validate);
+
+	for (i = 0; i < CONFIG_COMP_TONE_CLIP_VOICES; i++)
+		cd->voice[i].gain = INT32_MAX;
+
+	return 0;
+}
+
+static int tone_cmd_set_voice(struct comp_dev *dev, uint32_t index,
+			      uint32_t voice, uint32_t val)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	if (voice >= CONFIG_COMP_TONE_CLIP_VOICES) {
+		comp_err(dev, "tone_cmd_set_voice(): invalid voice %u", voice);
+		return -EINVAL;
+	}
+
+	switch (index) {
+	case SOF_TONE_IDX_CLIP_PLAY:
+		cd->voice[voice].start = val + 1;
+		break;
+	case SOF_TONE_IDX_CLIP_STOP:
+		cd->voice[voice].stop = true;
+		break;
+	case SOF_TONE_IDX_CLIP_GAIN:
+		cd->voice[voice].gain = val;
+		break;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_COMP_TONE_CLIPS */
 
 /*
  * End of algorithm code. Next the standard component methods.
@@ -403,6 +567,14 @@ static struct comp_dev *tone_new(const struct comp_driver *drv,
 	comp_set_drvdata(dev, cd);
 	cd->tone_func = tone_s32_default;
 
+#if CONFIG_COMP_TONE_CLIPS
+	if (tone_clips_init(dev, cd) < 0) {
+		rfree(cd);
+		rfree(dev);
+		return NULL;
+	}
+#endif
+
 	cd->rate = ipc_tone->sample_rate;
 
 	/* Reset tone generator and set channels volumes to default */
@@ -415,11 +587,14 @@ static struct comp_dev *tone_new(const struct comp_driver *drv,
 
 static void tone_free(struct comp_dev *dev)
 {
-	struct tone_data *td = comp_get_drvdata(dev);
+	struct comp_data *cd = comp_get_drvdata(dev);
 
 	comp_info(dev, "tone_free()");
 
-	rfree(td);
+#if CONFIG_COMP_TONE_CLIPS
+	comp_data_blob_handler_free(cd->clip_handler);
+#endif
+	rfree(cd);
 	rfree(dev);
 }
 
@@ -528,6 +703,11 @@ static int tone_cmd_set_data(struct comp_dev *dev,
 
 	comp_info(dev, "tone_cmd_set_data()");
 
+#if CONFIG_COMP_TONE_CLIPS
+	if (cdata->cmd == SOF_CTRL_CMD_BINARY)
+		return comp_data_blob_set_cmd(cd->clip_handler, cdata);
+#endif
+
 	if (cdata->type != SOF_CTRL_TYPE_VALUE_COMP_SET) {
 		comp_err(dev, "tone_cmd_set_data(): wrong cdata->type: %u",
 			 cdata->type);
@@ -578,6 +758,16 @@ static int tone_cmd_set_data(struct comp_dev *dev,
 				comp_info(dev, "tone_cmd_set_data(), SOF_TONE_IDX_LIN_RAMP_STEP");
 				tonegen_set_linramp(&cd->sg[ch], val);
 				break;
+#if CONFIG_COMP_TONE_CLIPS
+			case SOF_TONE_IDX_CLIP_PLAY:
+			case SOF_TONE_IDX_CLIP_STOP:
+			case SOF_TONE_IDX_CLIP_GAIN:
+				comp_info(dev, "tone_cmd_set_data(), clip control %u",
+					  cdata->index);
+				if (tone_cmd_set_voice(dev, cdata->index, ch, val) < 0)
+					return -EINVAL;
+				break;
+#endif
 			default:
 				comp_err(dev, "tone_cmd_set_data(): invalid cdata->index");
 				return -EINVAL;
@@ -645,6 +835,9 @@ static int tone_copy(struct comp_dev *dev)
 	if (free >= cd->period_bytes) {
 		/* create tone */
 		cd->tone_func(dev, &sink->stream, dev->frames);
+#if CONFIG_COMP_TONE_CLIPS
+		tone_voices_mix(dev, &sink->stream, dev->frames);
+#endif
 		buffer_stream_writeback(sink, cd->period_bytes);
 
 		/* calc new free and available */
@@ -704,6 +897,14 @@ static int tone_reset(struct comp_dev *dev)
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		tonegen_reset(&cd->sg[i]);
 
+#if CONFIG_COMP_TONE_CLIPS
+	for (i = 0; i < CONFIG_COMP_TONE_CLIP_VOICES; i++) {
+		cd->voice[i].pos = NULL;
+		cd->voice[i].start = 0;
+		cd->voice[i].stop = false;
+	}
+#endif
+
 	comp_set_state(dev, COMP_TRIGGER_RESET);
 
 	return 0;
@@ -40,6 +40,33 @@ DECLARE_TR_CTX(up_down_mixer_comp_tr, SOF_UUID(up_down_mixer_comp_uuid),
 
 int32_t custom_coeffs[UP_DOWN_MIX_COEFFS_LENGTH];
 
+static uint32_t remap_frames(struct up_down_mixer_data *cd, const uint32_t in_size)
+{
+	size_t sample_bytes = cd->remap.in_fmt == SOF_IPC_FRAME_S16_LE ?
+			      sizeof(int16_t) : sizeof(int32_t);
+
+	return in_size / (cd->in_channel_no * sample_bytes);
+}
+
+/* The mono and stereo inputs are copied to the 32 bit stereo output with
+ * the channel remap engine, the routes are set in init_shiftcopy().
+ */
+static void shiftcopy(struct up_down_mixer_data *cd, const uint8_t * const in_data,
+		      const uint32_t in_size, uint8_t * const out_data)
+{
+	chmap_remap_linear(&cd->remap, in_data, out_data, remap_frames(cd, in_size));
+}
+
+/* The downmix of the layouts without a hand-written kernel, and of all
+ * layouts in the generic build, multiplies only the non-zero taps that
+ * init_sparse_mix() compiled from the coefficients.
+ */
+static void sparse_mix(struct up_down_mixer_data *cd, const uint8_t * const in_data,
+		       const uint32_t in_size, uint8_t * const out_data)
+{
+	chmap_remap_linear(&cd->remap, in_data, out_data, remap_frames(cd, in_size));
+}
+
 static int set_downmix_coefficients(struct processing_module *mod,
 				    const struct ipc4_audio_format *format,
 				    const enum ipc4_channel_config out_channel_config,
@@ -47,9 +74,11 @@ static int set_downmix_coefficients(struct processing_module *mod,
 {
 	struct up_down_mixer_data *cd = module_get_private_data(mod);
 	struct comp_dev *dev = mod->dev;
+	/* the sparse downmix takes the Q1.31 coefficients for all depths */
+	bool coeffs16 = format->depth == IPC4_DEPTH_16BIT && cd->mix_routine != sparse_mix;
 	int ret;
 
-	if (cd->downmix_coefficients) {
+	if (downmix_coefficients) {
 		ret = memcpy_s(&custom_coeffs, sizeof(custom_coeffs), downmix_coefficients,
 			       sizeof(int32_t) * UP_DOWN_MIX_COEFFS_LENGTH);
 
@@ -70,24 +99,24 @@ static int set_downmix_coefficients(struct processing_module *mod,
 		break;
 	case IPC4_CHANNEL_CONFIG_3_POINT_0:
 	case IPC4_CHANNEL_CONFIG_3_POINT_1:
-		if (format->depth == IPC4_DEPTH_16BIT)
+		if (coeffs16)
 			cd->downmix_coefficients = k_half_scaled_lo_ro_downmix16bit;
 		else
 			cd->downmix_coefficients = k_half_scaled_lo_ro_downmix32bit;
 		break;
 	case IPC4_CHANNEL_CONFIG_QUATRO:
 		if (out_channel_config == IPC4_CHANNEL_CONFIG_MONO) {
-			cd->downmix_coefficients = (format->depth == IPC4_DEPTH_16BIT) ?
+			cd->downmix_coefficients = coeffs16 ?
 						    k_quatro_mono_scaled_lo_ro_downmix16bit :
 						    k_quatro_mono_scaled_lo_ro_downmix32bit;
 		} else { /*out_channel_config == IPC4_CHANNEL_CONFIG_STEREO*/
-			cd->downmix_coefficients = (format->depth == IPC4_DEPTH_16BIT) ?
+			cd->downmix_coefficients = coeffs16 ?
 						    k_half_scaled_lo_ro_downmix16bit :
 						    k_half_scaled_lo_ro_downmix32bit;
 		}
 		break;
 	case IPC4_CHANNEL_CONFIG_4_POINT_0:
-		if (format->depth == IPC4_DEPTH_16BIT) {
+		if (coeffs16) {
 			cd->downmix_coefficients = k_scaled_lo_ro_downmix16bit;
 		} else {
 			if (out_channel_config == IPC4_CHANNEL_CONFIG_5_POINT_1)
@@ -109,16 +138,119 @@ static int set_downmix_coefficients(struct processing_module *mod,
 	return 0;
 }
 
+static int init_shiftcopy(struct up_down_mixer_data *cd,
+			  const struct ipc4_audio_format *format)
+{
+	enum sof_ipc_frame in_fmt = format->depth == IPC4_DEPTH_16BIT ?
+				    SOF_IPC_FRAME_S16_LE : SOF_IPC_FRAME_S32_LE;
+
+	chmap_remap_reset(&cd->remap);
+	chmap_remap_route(&cd->remap, 0, 0);
+	if (format->ch_cfg == IPC4_CHANNEL_CONFIG_MONO)
+		chmap_remap_route(&cd->remap, 0, 1);
+	else
+		chmap_remap_route(&cd->remap, 1, 1);
+
+	return chmap_remap_compile(&cd->remap, in_fmt, SOF_IPC_FRAME_S32_LE,
+				   format->channels_count, 2);
+}
+
+#define SPARSE_MIX_LEFT		BIT(0)
+#define SPARSE_MIX_RIGHT	BIT(1)
+
+/* Outputs of the stereo downmix for each input channel index */
+static const uint8_t sparse_mix_stereo_outs[UP_DOWN_MIX_COEFFS_LENGTH] = {
+	[CHANNEL_LEFT] = SPARSE_MIX_LEFT,
+	[CHANNEL_CENTER] = SPARSE_MIX_LEFT | SPARSE_MIX_RIGHT,
+	[CHANNEL_RIGHT] = SPARSE_MIX_RIGHT,
+	[CHANNEL_LEFT_SURROUND] = SPARSE_MIX_LEFT,
+	[CHANNEL_RIGHT_SURROUND] = SPARSE_MIX_RIGHT,
+	[CHANNEL_LEFT_SIDE] = SPARSE_MIX_LEFT,
+	[CHANNEL_RIGHT_SIDE] = SPARSE_MIX_RIGHT,
+	[CHANNEL_LFE] = SPARSE_MIX_LEFT | SPARSE_MIX_RIGHT,
+};
+
+static int init_sparse_mix(struct up_down_mixer_data *cd,
+			   const struct ipc4_audio_format *format,
+			   enum ipc4_channel_config out_channel_config)
+{
+	enum sof_ipc_frame in_fmt = format->depth == IPC4_DEPTH_16BIT ?
+				    SOF_IPC_FRAME_S16_LE : SOF_IPC_FRAME_S32_LE;
+	uint32_t out_channels = out_channel_config == IPC4_CHANNEL_CONFIG_MONO ? 1 : 2;
+	enum ipc4_channel_index index;
+	int32_t gain;
+	uint8_t outs;
+	uint32_t ch;
+	int ret;
+
+	chmap_remap_reset(&cd->remap);
+	for (ch = 0; ch < format->channels_count; ch++) {
+		index = get_channel_index(format->ch_map, ch);
+		if (index >= UP_DOWN_MIX_COEFFS_LENGTH)
+			continue;
+
+		/* Q1.31 to Q2.30, the zero taps are left out */
+		gain = cd->downmix_coefficients[index] >> (31 - CHMAP_REMAP_GAIN_SHIFT);
+		if (!gain)
+			continue;
+
+		outs = sparse_mix_stereo_outs[index];
+		/* the center surround of 4.0 goes to both sides */
+		if (format->ch_cfg == IPC4_CHANNEL_CONFIG_4_POINT_0 &&
+		    index == CHANNEL_CENTER_SURROUND)
+			outs = SPARSE_MIX_LEFT | SPARSE_MIX_RIGHT;
+
+		/* the mono output is the average of the stereo downmix */
+		if (out_channels == 1) {
+			if (outs != (SPARSE_MIX_LEFT | SPARSE_MIX_RIGHT))
+				gain >>= 1;
+			outs = SPARSE_MIX_LEFT;
+		}
+
+		if (outs & SPARSE_MIX_LEFT) {
+			ret = chmap_remap_mix(&cd->remap, ch, 0, gain);
+			if (ret < 0)
+				return ret;
+		}
+
+		if (outs & SPARSE_MIX_RIGHT) {
+			ret = chmap_remap_mix(&cd->remap, ch, 1, gain);
+			if (ret < 0)
+				return ret;
+		}
+	}
+
+	return chmap_remap_compile(&cd->remap, in_fmt, SOF_IPC_FRAME_S32_LE,
+				   format->channels_count, out_channels);
+}
+
+/* Uses the sparse downmix when there is no hand-written kernel for the
+ * layout or the kernels are not built.
+ */
+static up_down_mixer_routine select_downmix(up_down_mixer_routine routine,
+					    const struct ipc4_audio_format *format,
+					    uint32_t out_channels)
+{
+	if (routine == shiftcopy || format->channels_count <= out_channels ||
+	    format->ch_cfg == IPC4_CHANNEL_CONFIG_INVALID)
+		return routine;
+
+	if (!routine || UP_DOWN_MIXER_GENERIC)
+		return sparse_mix;
+
+	return routine;
+}
+
 static up_down_mixer_routine select_mix_out_stereo(struct comp_dev *dev,
 						   const struct ipc4_audio_format *format)
 {
 	if (format->depth == IPC4_DEPTH_16BIT) {
 		switch (format->ch_cfg) {
 		case IPC4_CHANNEL_CONFIG_MONO:
-			return shiftcopy16bit_mono;
+			return shiftcopy;
 		case IPC4_CHANNEL_CONFIG_DUAL_MONO:
 		case IPC4_CHANNEL_CONFIG_STEREO:
-			return shiftcopy16bit_stereo;
+			return shiftcopy;
 		case IPC4_CHANNEL_CONFIG_2_POINT_1:
 		case IPC4_CHANNEL_CONFIG_3_POINT_0:
 		case IPC4_CHANNEL_CONFIG_3_POINT_1:
@@ -141,10 +273,10 @@ static up_down_mixer_routine select_mix_out_stereo(struct comp_dev *dev,
 	} else {
 		switch (format->ch_cfg) {
 		case IPC4_CHANNEL_CONFIG_MONO:
-			return shiftcopy32bit_mono;
+			return shiftcopy;
 		case IPC4_CHANNEL_CONFIG_DUAL_MONO:
 		case IPC4_CHANNEL_CONFIG_STEREO:
-			return shiftcopy32bit_stereo;
+			return shiftcopy;
 		case IPC4_CHANNEL_CONFIG_2_POINT_1:
 			return downmix32bit_2_1;
 		case IPC4_CHANNEL_CONFIG_3_POINT_0:
@@ -266,13 +398,14 @@ static int init_mix(struct processing_module *mod,
 {
 	struct up_down_mixer_data *cd = module_get_private_data(mod);
 	struct comp_dev *dev = mod->dev;
+	int ret;
 
 	if (!format)
 		return -EINVAL;
 
 	if (out_channel_config == IPC4_CHANNEL_CONFIG_MONO) {
 		/* Select dowm mixing routine. */
-		cd->mix_routine = select_mix_out_mono(dev, format);
+		cd->mix_routine = select_downmix(select_mix_out_mono(dev, format), format, 1);
 
 		/* Update audio format. */
 		cd->out_fmt[0].channels_count = 1;
@@ -286,7 +419,9 @@ static int init_mix(struct processing_module *mod,
 			return -EINVAL;
 
 		/* Select dowm mixing routine. */
-		cd->mix_routine = select_mix_out_stereo(dev, format);
+		cd->mix_routine = select_downmix(select_mix_out_stereo(dev, format), format, 2);
+		if (cd->mix_routine == shiftcopy && init_shiftcopy(cd, format) < 0)
+			return -EINVAL;
 
 		/* Update audio format. */
 		cd->out_fmt[0].channels_count = 2;
@@ -321,7 +456,14 @@ static int init_mix(struct processing_module *mod,
 	cd->in_channel_map = format->ch_map;
 	cd->in_channel_config = format->ch_cfg;
 
-	return set_downmix_coefficients(mod, format, out_channel_config, downmix_coefficients);
+	ret = set_downmix_coefficients(mod, format, out_channel_config, downmix_coefficients);
+	if (ret < 0)
+		return ret;
+
+	if (cd->mix_routine == sparse_mix)
+		return init_sparse_mix(cd, format, out_channel_config);
+
+	return 0;
 }
 
 static int up_down_mixer_free(struct processing_module *mod)
@@ -6,7 +6,7 @@
 
 #include <sof/audio/up_down_mixer/up_down_mixer.h>
 
-#if defined(__XCC__) && XCHAL_HAVE_HIFI3
+#if UP_DOWN_MIXER_HIFI3
 
 #include <xtensa/tie/xt_hifi3.h>
 #include <errno.h>
@@ -199,30 +199,6 @@ void upmix32bit_2_0_to_7_1(struct up_down_mixer_data *cd, const uint8_t * const
 	}
 }
 
-void shiftcopy32bit_mono(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			 const uint32_t in_size, uint8_t * const out_data)
-{
-	size_t i;
-
-	ae_p24f *in_ptr = (ae_p24f *)in_data;
-	ae_p24x2f *out_ptr = (ae_p24x2f *)out_data;
-
-	for (i = 0; i < (in_size >> 2); ++i)
-		out_ptr[i] = in_ptr[i];
-}
-
-void shiftcopy32bit_stereo(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			   const uint32_t in_size, uint8_t * const out_data)
-{
-	uint32_t i;
-
-	ae_p24x2f *in_ptr = (ae_p24x2f *)in_data;
-	ae_p24x2f *out_ptr = (ae_p24x2f *)out_data;
-
-	for (i = 0; i < (in_size >> 3); ++i)
-		out_ptr[i] = in_ptr[i];
-}
-
 void downmix32bit_2_1(struct up_down_mixer_data *cd, const uint8_t * const in_data,
 		      const uint32_t in_size, uint8_t * const out_data)
 {
@@ -942,33 +918,6 @@ void downmix32bit_7_1(struct up_down_mixer_data *cd, const uint8_t * const in_da
 	}
 }
 
-void shiftcopy16bit_mono(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			 const uint32_t in_size, uint8_t * const out_data)
-{
-	uint32_t i;
-
-	ae_int16 *in_ptrs = (ae_int16 *)in_data;
-	ae_int32x2 *out_ptrs = (ae_int32x2 *)out_data;
-
-	for (i = 0; i < (in_size >> 1); ++i)
-		out_ptrs[i] = AE_MOVINT32_FROMINT16(in_ptrs[i]) << 16;
-}
-
-void shiftcopy16bit_stereo(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			   const uint32_t in_size, uint8_t * const out_data)
-{
-	uint32_t i;
-
-	ae_p16x2s *in_ptrs = (ae_p16x2s *)in_data;
-	ae_p24x2f *out_ptrs = (ae_p24x2f *)out_data;
-	ae_p24x2s in_regs = AE_ZEROP48();
-
-	for (i = 0; i < (in_size >> 2); ++i) {
-		in_regs = in_ptrs[i];
-		AE_SP24X2F_X(in_regs, out_ptrs, i << 3);
-	}
-}
-
 void downmix16bit(struct up_down_mixer_data *cd, const uint8_t * const in_data,
 		  const uint32_t in_size, uint8_t * const out_data)
 {
@@ -1915,7 +1864,7 @@ void upmix32bit_quatro_to_5_1(struct up_down_mixer_data *cd, const uint8_t * con
 	}
 }
 
-#else /* !XCHAL_HAVE_HIFI3 */
+#else /* UP_DOWN_MIXER_GENERIC */
 
 /* TODO: replace with generic ANSI C version */
 
@@ -1949,18 +1898,6 @@ void upmix32bit_2_0_to_7_1(struct up_down_mixer_data *cd, const uint8_t * const
 	sof_panic(0);
 }
 
-void shiftcopy32bit_mono(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			 const uint32_t in_size, uint8_t * const out_data)
-{
-	sof_panic(0);
-}
-
-void shiftcopy32bit_stereo(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			   const uint32_t in_size, uint8_t * const out_data)
-{
-	sof_panic(0);
-}
-
 void downmix32bit_2_1(struct up_down_mixer_data *cd, const uint8_t * const in_data,
 		      const uint32_t in_size, uint8_t * const out_data)
 {
@@ -2014,18 +1951,6 @@ void downmix16bit_stereo(struct up_down_mixer_data *cd, const uint8_t * const in
 {
 }
 
-void shiftcopy16bit_mono(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			 const uint32_t in_size, uint8_t * const out_data)
-{
-	sof_panic(0);
-}
-
-void shiftcopy16bit_stereo(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			   const uint32_t in_size, uint8_t * const out_data)
-{
-	sof_panic(0);
-}
-
 void downmix16bit(struct up_down_mixer_data *cd, const uint8_t * const in_data,
 		  const uint32_t in_size, uint8_t * const out_data)
 {
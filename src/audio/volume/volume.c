@@ -347,6 +347,30 @@ static inline void volume_ramp(struct processing_module *mod)
 	set_volume_process(cd, dev, true);
 }
 
+/**
+ * \brief Advances the ramp by a block and prepares its per sample gain steps.
+ * \param[in,out] mod Volume processing module handle
+ * \param[in] frames Number of frames of the block.
+ *
+ * The block is ramped from the current gain to the gain the ramp reaches at
+ * the end of the block, so the gain update rate doesn't split the block.
+ */
+static void volume_ramp_interpolate(struct processing_module *mod, uint32_t frames)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	int i;
+
+	for (i = 0; i < cd->channels; i++)
+		cd->ramp_gain[i] = cd->volume[i] << VOL_RAMP_FRAC_BITS;
+
+	cd->vol_ramp_elapsed_frames += frames;
+	volume_ramp(mod);
+
+	for (i = 0; i < cd->channels; i++)
+		cd->ramp_inc[i] = ((cd->volume[i] << VOL_RAMP_FRAC_BITS) - cd->ramp_gain[i]) /
+				  (int32_t)frames;
+}
+
 /**
  * \brief Reset state except controls.
  */
@@ -409,6 +433,9 @@ static int volume_free(struct processing_module *mod)
 	comp_dbg(mod->dev, "volume_free()");
 
 	volume_peak_free(cd);
+#if CONFIG_SOF_LEVEL_METER
+	level_meter_free(cd->meter);
+#endif
 	rfree(cd->vol);
 	rfree(cd);
 
@@ -553,6 +580,11 @@ static int volume_process(struct processing_module *mod,
 	uint32_t avail_frames = input_buffers[0].size;
 	uint32_t frames;
 	int64_t prev_sum = 0;
+#if CONFIG_SOF_LEVEL_METER
+	struct audio_stream *sink = output_buffers[0].data;
+	void *out = audio_stream_wrap(sink, (char *)audio_stream_get_wptr(sink) +
+				      output_buffers[0].size);
+#endif
 
 	comp_dbg(mod->dev, "volume_process()");
 
@@ -566,21 +598,35 @@ static int volume_process(struct processing_module *mod,
 		} else if (cd->ramp_type == SOF_VOLUME_LINEAR_ZC) {
 			/* with ZC ramping look for next ZC offset */
 			frames = cd->zc_get(input_buffers[0].data, cd->vol_ramp_frames, &prev_sum);
+		} else if (cd->ramp_vol) {
+			/* gain is interpolated per sample, ramp the whole block at once */
+			frames = avail_frames;
 		} else {
 			/* without ZC process max ramp chunk */
 			frames = cd->vol_ramp_frames;
 		}
 
-		if (!cd->ramp_finished) {
+		if (cd->ramp_finished) {
+			/* copy and scale volume */
+			cd->scale_vol(mod, &input_buffers[0], &output_buffers[0], frames,
+				      cd->attenuation);
+		} else if (cd->ramp_vol && cd->ramp_type != SOF_VOLUME_LINEAR_ZC) {
+			volume_ramp_interpolate(mod, frames);
+			cd->ramp_vol(mod, &input_buffers[0], &output_buffers[0], frames,
+				     cd->attenuation);
+		} else {
 			volume_ramp(mod);
 			cd->vol_ramp_elapsed_frames += frames;
+			cd->scale_vol(mod, &input_buffers[0], &output_buffers[0], frames,
+				      cd->attenuation);
 		}
 
-		/* copy and scale volume */
-		cd->scale_vol(mod, &input_buffers[0], &output_buffers[0], frames, cd->attenuation);
-
 		avail_frames -= frames;
 	}
+#if CONFIG_SOF_LEVEL_METER
+	if (cd->meter)
+		level_meter_update(cd->meter, sink, out, input_buffers[0].size);
+#endif
 #if CONFIG_COMP_PEAK_VOL
 	cd->peak_cnt++;
 	if (cd->peak_cnt == cd->peak_report_cnt) {
@@ -605,6 +651,14 @@ static vol_zc_func vol_get_zc_function(struct comp_dev *dev,
 {
 	int i;
 
+	/* prefer the optimized zc function of the platform */
+	for (i = 0; i < volume_ramp_func_count; i++) {
+		if (audio_stream_get_valid_fmt(&sinkb->stream) != volume_ramp_func_map[i].frame_fmt)
+			continue;
+		if (volume_ramp_func_map[i].zc_func)
+			return volume_ramp_func_map[i].zc_func;
+	}
+
 	/* map the zc function to frame format */
 	for (i = 0; i < ARRAY_SIZE(zc_func_map); i++) {
 		if (audio_stream_get_valid_fmt(&sinkb->stream) == zc_func_map[i].frame_fmt)
@@ -614,6 +668,23 @@ static vol_zc_func vol_get_zc_function(struct comp_dev *dev,
 	return NULL;
 }
 
+/*
+ * \brief Retrieves per sample volume ramp function, NULL if none.
+ * \param[in,out] dev Volume base component device.
+ */
+static vol_scale_func vol_get_ramp_function(struct comp_dev *dev,
+					    struct comp_buffer *sinkb)
+{
+	int i;
+
+	for (i = 0; i < volume_ramp_func_count; i++) {
+		if (audio_stream_get_valid_fmt(&sinkb->stream) == volume_ramp_func_map[i].frame_fmt)
+			return volume_ramp_func_map[i].ramp_func;
+	}
+
+	return NULL;
+}
+
 /**
  * \brief Set volume frames alignment limit.
  * \param[in,out] source Structure pointer of source.
@@ -707,6 +778,8 @@ static int volume_prepare(struct processing_module *mod,
 		goto err;
 	}
 
+	cd->ramp_vol = vol_get_ramp_function(dev, sinkb);
+
 	/* Set current volume to min to ensure ramp starts from minimum
 	 * to previous volume request. Copy() checks for ramp finished
 	 * and executes it if it has not yet finished as result of
@@ -733,6 +806,13 @@ static int volume_prepare(struct processing_module *mod,
 
 	volume_prepare_ramp(dev, cd);
 
+#if CONFIG_SOF_LEVEL_METER
+	/* metering is optional, the stream runs without it if no slot is left */
+	level_meter_free(cd->meter);
+	cd->meter = level_meter_new(dev_comp_id(dev), audio_stream_get_rate(&sinkb->stream),
+				    cd->channels, CONFIG_LEVEL_METER_WINDOW_MS);
+#endif
+
 	/*
 	 * volume component does not do any format conversion, so use the buffer size for source
 	 * and sink
@@ -759,6 +839,10 @@ static int volume_reset(struct processing_module *mod)
 
 	comp_dbg(mod->dev, "volume_reset()");
 	volume_reset_state(cd);
+#if CONFIG_SOF_LEVEL_METER
+	level_meter_free(cd->meter);
+	cd->meter = NULL;
+#endif
 	return 0;
 }
 
@@ -17,6 +17,9 @@
 #define __SOF_AUDIO_VOLUME_H__
 
 #include <sof/audio/component.h>
+#if CONFIG_SOF_LEVEL_METER
+#include <sof/audio/level_meter.h>
+#endif
 #include <sof/audio/ipc-config.h>
 #include <sof/audio/module_adapter/module/generic.h>
 #include <rtos/bit.h>
@@ -118,6 +121,12 @@ struct sof_ipc_ctrl_value_chan;
 /** \brief Volume minimum value. */
 #define VOL_MIN		0
 
+/**
+ * \brief Extra fractional bits of the per sample interpolated ramp gain,
+ * as many as fit VOL_MAX in 32 bits.
+ */
+#define VOL_RAMP_FRAC_BITS	(32 - VOL_QXY_X - VOL_QXY_Y)
+
 /** \brief Macros to convert without division bytes count to samples count */
 #define VOL_BYTES_TO_S16_SAMPLES(b)	((b) >> 1)
 #define VOL_BYTES_TO_S32_SAMPLES(b)	((b) >> 2)
@@ -157,6 +166,9 @@ struct vol_data {
 	int32_t mvolume[SOF_IPC_MAX_CHANNELS];	/**< mute volume */
 	int32_t rvolume[SOF_IPC_MAX_CHANNELS];	/**< ramp start volume */
 	int32_t ramp_coef[SOF_IPC_MAX_CHANNELS]; /**< parameter for slope */
+	/**< interpolated ramp gain, Q(VOL_QXY_Y + VOL_RAMP_FRAC_BITS) */
+	int32_t ramp_gain[SOF_IPC_MAX_CHANNELS];
+	int32_t ramp_inc[SOF_IPC_MAX_CHANNELS];	/**< ramp gain step per frame */
 	/**< store current volume 4 times for scale_vol function */
 	int32_t *vol;
 	uint32_t initial_ramp;			/**< ramp space in ms */
@@ -172,11 +184,15 @@ struct vol_data {
 	bool muted[SOF_IPC_MAX_CHANNELS];	/**< set if channel is muted */
 	bool ramp_finished;			/**< control ramp launch */
 	vol_scale_func scale_vol;		/**< volume processing function */
+	vol_scale_func ramp_vol;		/**< per sample ramp function, optional */
 	vol_zc_func zc_get;			/**< function getting nearest zero crossing frame */
 	bool copy_gain;				/**< control copy gain or not */
 	uint32_t attenuation;			/**< peakmeter adjustment in range [0 - 31] */
 	bool is_passthrough;			/**< is passthrough or do gain multiplication */
 	uint32_t ramp_channel_counter;		/**< channels need new ramp volume */
+#if CONFIG_SOF_LEVEL_METER
+	struct level_meter *meter;		/**< output level meter */
+#endif
 };
 
 /** \brief Volume processing functions map. */
@@ -198,6 +214,40 @@ struct comp_zc_func_map {
 	vol_zc_func func;	/**< volume zc function */
 };
 
+/** \brief Volume ramp and zero crossing kernels map. */
+struct comp_ramp_func_map {
+	uint16_t frame_fmt;	/**< frame format */
+	vol_scale_func ramp_func;	/**< gain interpolated per sample */
+	vol_zc_func zc_func;	/**< optimized zc function, NULL for the generic one */
+};
+
+/** \brief Map of formats with dedicated ramp functions. */
+extern const struct comp_ramp_func_map volume_ramp_func_map[];
+
+/** \brief Number of ramp functions. */
+extern const size_t volume_ramp_func_count;
+
+/**
+ * \brief Updates the peak meter from a ramp function.
+ * \param[in,out] cd Volume component private data.
+ * \param[in] channel Channel of the peak.
+ * \param[in] peak Absolute peak of the input samples.
+ * \param[in] shift Left shift aligning the peak to the peak meter.
+ */
+static inline void vol_ramp_peak_update(struct vol_data *cd, int channel,
+					int32_t peak, int shift)
+{
+#if CONFIG_COMP_PEAK_VOL
+	int32_t tmp = peak << shift;
+
+	cd->peak_regs.peak_meter[channel] = MAX(tmp, cd->peak_regs.peak_meter[channel]);
+#ifdef VOLUME_HIFI4
+	/* HiFi4 scale functions rebuild the peak meter from peak_vol */
+	cd->peak_vol[channel] = MAX(peak, cd->peak_vol[channel]);
+#endif
+#endif
+}
+
 #if CONFIG_IPC_MAJOR_3
 /**
  * \brief Retrievies volume processing function.
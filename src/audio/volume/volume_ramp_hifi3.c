@@ -0,0 +1,431 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/**
+ * \file
+ * \brief Volume HiFi3 ramp processing with per sample gain interpolation and
+ *	  zero crossing search, used for HiFi4 as well.
+ */
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/common.h>
+#include <ipc/stream.h>
+#include <stddef.h>
+#include <stdint.h>
+
+LOG_MODULE_DECLARE(volume_hifi3, CONFIG_SOF_LOG_LEVEL);
+
+#include "volume.h"
+
+#if defined(VOLUME_HIFI3) || defined(VOLUME_HIFI4)
+
+#if defined(VOLUME_HIFI4)
+#include <xtensa/tie/xt_hifi4.h>
+#else
+#include <xtensa/tie/xt_hifi3.h>
+#endif
+
+/* downscale before summing channels, the sum of SOF_IPC_MAX_CHANNELS fits 32 bits */
+#define VOL_ZC_S32_HEADROOM	3
+
+#if CONFIG_FORMAT_S24LE
+/**
+ * \brief HiFi3 enabled volume ramp from 24/32 bit to 24/32 or 32 bit.
+ * \param[in,out] mod Pointer to struct processing_module
+ * \param[in,out] bsource Input buffer.
+ * \param[in,out] bsink Destination buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] attenuation factor for peakmeter adjustment
+ *
+ * Gain of each channel starts from cd->ramp_gain and changes by
+ * cd->ramp_inc every frame.
+ */
+static void vol_ramp_s24_to_s24_s32(struct processing_module *mod,
+				    struct input_stream_buffer *bsource,
+				    struct output_stream_buffer *bsink, uint32_t frames,
+				    uint32_t attenuation)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	ae_f32x2 in_sample = AE_ZERO32();
+	ae_f32x2 out_sample = AE_ZERO32();
+	ae_f32x2 volume;
+	ae_int32x2 gain;
+	ae_int32x2 step;
+	int channel, n, i, m;
+	ae_f32 *in0 = (ae_f32 *)audio_stream_wrap(source, (char *)audio_stream_get_rptr(source)
+						  + bsource->consumed);
+	ae_f32 *out0 = (ae_f32 *)audio_stream_wrap(sink, (char *)audio_stream_get_wptr(sink)
+						   + bsink->size);
+	ae_f32 *in, *out;
+	const int channels_count = audio_stream_get_channels(sink);
+	const int inc = sizeof(ae_f32) * channels_count;
+	int samples = channels_count * frames;
+	ae_f32x2 peak_vol;
+
+	bsource->consumed += VOL_S32_SAMPLES_TO_BYTES(samples);
+	bsink->size += VOL_S32_SAMPLES_TO_BYTES(samples);
+	while (samples) {
+		m = audio_stream_samples_without_wrap_s32(source, in0);
+		n = MIN(m, samples);
+		m = audio_stream_samples_without_wrap_s32(sink, out0);
+		n = MIN(m, n);
+		for (channel = 0; channel < channels_count; channel++) {
+			peak_vol = AE_ZERO32();
+			in = in0 + channel;
+			out = out0 + channel;
+			gain = AE_MOVDA32(cd->ramp_gain[channel]);
+			step = AE_MOVDA32(cd->ramp_inc[channel]);
+			for (i = 0; i < n; i += channels_count) {
+				/* gain of this frame, then step to the next one */
+				volume = AE_SRAI32(gain, VOL_RAMP_FRAC_BITS);
+				gain = AE_ADD32(gain, step);
+
+				AE_L32_XP(in_sample, in, inc);
+				peak_vol = AE_MAXABS32S(in_sample, peak_vol);
+#if COMP_VOLUME_Q8_16
+				out_sample = AE_MULFP32X2RS(AE_SLAI32S(volume, 7),
+							    AE_SLAI32(in_sample, 8));
+#elif COMP_VOLUME_Q1_23
+				out_sample = AE_MULFP32X2RS(volume, AE_SLAI32S(in_sample, 8));
+#else
+#error "Need CONFIG_COMP_VOLUME_Qx_y"
+#endif
+				/* Shift for S24_LE */
+				out_sample = AE_SLAI32S(out_sample, 8);
+				out_sample = AE_SRAI32(out_sample, 8);
+				AE_S32_L_XP(out_sample, out, inc);
+			}
+			cd->ramp_gain[channel] = AE_MOVAD32_L(gain);
+			vol_ramp_peak_update(cd, channel, AE_MOVAD32_L(peak_vol),
+					     attenuation + PEAK_24S_32C_ADJUST);
+		}
+		samples -= n;
+		out0 = audio_stream_wrap(sink, out0 + n);
+		in0 = audio_stream_wrap(source, in0 + n);
+	}
+}
+
+/**
+ * \brief HiFi3 enabled zero crossing search for 24 in 32 bit format.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames.
+ * \param[in,out] prev_sum Previous sum of channel samples.
+ */
+static uint32_t vol_zc_get_s24(const struct audio_stream *source,
+			       uint32_t frames, int64_t *prev_sum)
+{
+	uint32_t curr_frames = frames;
+	ae_f32x2 sample;
+	ae_int32x2 sum;
+	ae_f32 *x = audio_stream_get_rptr(source);
+	int32_t frame_sum;
+	int bytes;
+	int nmax;
+	int i, j, n;
+	const int nch = audio_stream_get_channels(source);
+	const int dec = -(int)sizeof(ae_f32);
+	int remaining_samples = frames * nch;
+
+	x = audio_stream_wrap(source, x + remaining_samples - 1); /* Go to last channel */
+	while (remaining_samples) {
+		bytes = audio_stream_rewind_bytes_without_wrap(source, x);
+		nmax = VOL_BYTES_TO_S32_SAMPLES(bytes) + 1;
+		n = MIN(nmax, remaining_samples);
+		for (i = 0; i < n; i += nch) {
+			sum = AE_ZERO32();
+			for (j = 0; j < nch; j++) {
+				AE_L32_XP(sample, x, dec);
+				/* sign extend the 24 bit sample */
+				sum = AE_ADD32(sum, AE_SRAI32(AE_SLAI32(sample, 8), 8));
+			}
+
+			/* first sign change */
+			frame_sum = AE_MOVAD32_L(sum);
+			if ((frame_sum ^ *prev_sum) < 0)
+				return curr_frames;
+
+			*prev_sum = frame_sum;
+			curr_frames--;
+		}
+		remaining_samples -= n;
+		x = audio_stream_rewind_wrap(source, x);
+	}
+
+	/* sign change not detected, process all samples */
+	return frames;
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+/**
+ * \brief HiFi3 enabled volume ramp from 32 bit to 24/32 or 32 bit.
+ * \param[in,out] mod Pointer to struct processing_module
+ * \param[in,out] bsource Input buffer.
+ * \param[in,out] bsink Destination buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] attenuation factor for peakmeter adjustment
+ */
+static void vol_ramp_s32_to_s24_s32(struct processing_module *mod,
+				    struct input_stream_buffer *bsource,
+				    struct output_stream_buffer *bsink, uint32_t frames,
+				    uint32_t attenuation)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	ae_f32x2 in_sample = AE_ZERO32();
+	ae_f32x2 out_sample = AE_ZERO32();
+	ae_f32x2 volume;
+	ae_int32x2 gain;
+	ae_int32x2 step;
+	int i, n, channel, m;
+	ae_f64 mult0;
+	const int channels_count = audio_stream_get_channels(sink);
+	const int inc = sizeof(ae_f32) * channels_count;
+	int samples = channels_count * frames;
+	ae_f32 *in0 = (ae_f32 *)audio_stream_wrap(source, (char *)audio_stream_get_rptr(source)
+						  + bsource->consumed);
+	ae_f32 *out0 = (ae_f32 *)audio_stream_wrap(sink, (char *)audio_stream_get_wptr(sink)
+						   + bsink->size);
+	ae_f32 *in, *out;
+	ae_f32x2 peak_vol;
+
+	bsource->consumed += VOL_S32_SAMPLES_TO_BYTES(samples);
+	bsink->size += VOL_S32_SAMPLES_TO_BYTES(samples);
+	while (samples) {
+		m = audio_stream_samples_without_wrap_s32(source, in0);
+		n = MIN(m, samples);
+		m = audio_stream_samples_without_wrap_s32(sink, out0);
+		n = MIN(m, n);
+		for (channel = 0; channel < channels_count; channel++) {
+			peak_vol = AE_ZERO32();
+			in = in0 + channel;
+			out = out0 + channel;
+			gain = AE_MOVDA32(cd->ramp_gain[channel]);
+			step = AE_MOVDA32(cd->ramp_inc[channel]);
+			for (i = 0; i < n; i += channels_count) {
+				volume = AE_SRAI32(gain, VOL_RAMP_FRAC_BITS);
+				gain = AE_ADD32(gain, step);
+
+				AE_L32_XP(in_sample, in, inc);
+				peak_vol = AE_MAXABS32S(in_sample, peak_vol);
+#if COMP_VOLUME_Q8_16
+				/* Q8.16 x Q1.31 << 1 -> Q9.48 */
+				mult0 = AE_MULF32S_HH(volume, in_sample);
+				mult0 = AE_SRAI64(mult0, 1);			/* Q9.47 */
+				out_sample = AE_ROUND32F48SASYM(mult0);	/* Q9.47 -> Q1.31 */
+#elif COMP_VOLUME_Q1_23
+				/* Q1.23 x Q1.31 << 1 -> Q2.55 */
+				mult0 = AE_MULF32S_HH(volume, in_sample);
+				mult0 = AE_SRAI64(mult0, 8);			/* Q2.47 */
+				out_sample = AE_ROUND32F48SSYM(mult0);	/* Q2.47 -> Q1.31 */
+#else
+#error "Need CONFIG_COMP_VOLUME_Qx_y"
+#endif
+				AE_S32_L_XP(out_sample, out, inc);
+			}
+			cd->ramp_gain[channel] = AE_MOVAD32_L(gain);
+			vol_ramp_peak_update(cd, channel, AE_MOVAD32_L(peak_vol), attenuation);
+		}
+		samples -= n;
+		out0 = audio_stream_wrap(sink, out0 + n);
+		in0 = audio_stream_wrap(source, in0 + n);
+	}
+}
+
+/**
+ * \brief HiFi3 enabled zero crossing search for 32 bit format.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames.
+ * \param[in,out] prev_sum Previous sum of channel samples.
+ */
+static uint32_t vol_zc_get_s32(const struct audio_stream *source,
+			       uint32_t frames, int64_t *prev_sum)
+{
+	uint32_t curr_frames = frames;
+	ae_f32x2 sample;
+	ae_int32x2 sum;
+	ae_f32 *x = audio_stream_get_rptr(source);
+	int32_t frame_sum;
+	int bytes;
+	int nmax;
+	int i, j, n;
+	const int nch = audio_stream_get_channels(source);
+	const int dec = -(int)sizeof(ae_f32);
+	int remaining_samples = frames * nch;
+
+	x = audio_stream_wrap(source, x + remaining_samples - 1); /* Go to last channel */
+	while (remaining_samples) {
+		bytes = audio_stream_rewind_bytes_without_wrap(source, x);
+		nmax = VOL_BYTES_TO_S32_SAMPLES(bytes) + 1;
+		n = MIN(nmax, remaining_samples);
+		for (i = 0; i < n; i += nch) {
+			sum = AE_ZERO32();
+			for (j = 0; j < nch; j++) {
+				AE_L32_XP(sample, x, dec);
+				sum = AE_ADD32(sum, AE_SRAI32(sample, VOL_ZC_S32_HEADROOM));
+			}
+
+			/* first sign change */
+			frame_sum = AE_MOVAD32_L(sum);
+			if ((frame_sum ^ *prev_sum) < 0)
+				return curr_frames;
+
+			*prev_sum = frame_sum;
+			curr_frames--;
+		}
+		remaining_samples -= n;
+		x = audio_stream_rewind_wrap(source, x);
+	}
+
+	/* sign change not detected, process all samples */
+	return frames;
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+#if CONFIG_FORMAT_S16LE
+/**
+ * \brief HiFi3 enabled volume ramp from 16 bit to 16 bit.
+ * \param[in,out] mod Pointer to struct processing_module
+ * \param[in,out] bsource Input buffer.
+ * \param[in,out] bsink Destination buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] attenuation factor for peakmeter adjustment (unused for 16bit)
+ */
+static void vol_ramp_s16_to_s16(struct processing_module *mod, struct input_stream_buffer *bsource,
+				struct output_stream_buffer *bsink, uint32_t frames,
+				uint32_t attenuation)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	struct audio_stream *source = bsource->data;
+	struct audio_stream *sink = bsink->data;
+	ae_f32x2 volume;
+	ae_int32x2 gain;
+	ae_int32x2 step;
+	ae_f32x2 out_sample0 = AE_ZERO32();
+	ae_f16x4 in_sample = AE_ZERO16();
+	ae_f16x4 out_sample = AE_ZERO16();
+	int i, n, channel, m;
+	ae_f16 *in;
+	ae_f16 *out;
+	ae_f16 *in0 = (ae_f16 *)audio_stream_wrap(source, (char *)audio_stream_get_rptr(source)
+						  + bsource->consumed);
+	ae_f16 *out0 = (ae_f16 *)audio_stream_wrap(sink, (char *)audio_stream_get_wptr(sink)
+						   + bsink->size);
+	const int channels_count = audio_stream_get_channels(sink);
+	const int inc = sizeof(ae_f16) * channels_count;
+	int samples = channels_count * frames;
+	ae_f32x2 peak_vol;
+
+	while (samples) {
+		m = audio_stream_samples_without_wrap_s16(source, in0);
+		n = MIN(m, samples);
+		m = audio_stream_samples_without_wrap_s16(sink, out0);
+		n = MIN(m, n);
+		for (channel = 0; channel < channels_count; channel++) {
+			peak_vol = AE_ZERO32();
+			in = in0 + channel;
+			out = out0 + channel;
+			gain = AE_MOVDA32(cd->ramp_gain[channel]);
+			step = AE_MOVDA32(cd->ramp_inc[channel]);
+			for (i = 0; i < n; i += channels_count) {
+				volume = AE_SRAI32(gain, VOL_RAMP_FRAC_BITS);
+				gain = AE_ADD32(gain, step);
+#if COMP_VOLUME_Q8_16
+				/* Q8.16 to Q9.23 */
+				volume = AE_SLAI32S(volume, 7);
+#elif COMP_VOLUME_Q1_23
+				/* No need to shift, Q1.23 is OK as such */
+#else
+#error "Need CONFIG_COMP_VOLUME_Qx_y"
+#endif
+				AE_L16_XP(in_sample, in, inc);
+				peak_vol = AE_MAXABS32S(AE_SEXT32X2D16_32(in_sample), peak_vol);
+				out_sample0 = AE_MULFP32X16X2RS_H(volume, in_sample);
+
+				/* Q9.23 to Q1.31 */
+				out_sample0 = AE_SLAI32S(out_sample0, 8);
+				out_sample = AE_ROUND16X4F32SSYM(out_sample0, out_sample0);
+				AE_S16_0_XP(out_sample, out, inc);
+			}
+			cd->ramp_gain[channel] = AE_MOVAD32_L(gain);
+			vol_ramp_peak_update(cd, channel, AE_MOVAD32_L(peak_vol),
+					     PEAK_16S_32C_ADJUST);
+		}
+		out0 = audio_stream_wrap(sink, out0 + n);
+		in0 = audio_stream_wrap(source, in0 + n);
+		samples -= n;
+		bsource->consumed += VOL_S16_SAMPLES_TO_BYTES(n);
+		bsink->size += VOL_S16_SAMPLES_TO_BYTES(n);
+	}
+}
+
+/**
+ * \brief HiFi3 enabled zero crossing search for 16 bit format.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames.
+ * \param[in,out] prev_sum Previous sum of channel samples.
+ */
+static uint32_t vol_zc_get_s16(const struct audio_stream *source,
+			       uint32_t frames, int64_t *prev_sum)
+{
+	uint32_t curr_frames = frames;
+	ae_f16x4 sample;
+	ae_int32x2 sum;
+	ae_f16 *x = audio_stream_get_rptr(source);
+	int32_t frame_sum;
+	int bytes;
+	int nmax;
+	int i, j, n;
+	const int nch = audio_stream_get_channels(source);
+	const int dec = -(int)sizeof(ae_f16);
+	int remaining_samples = frames * nch;
+
+	x = audio_stream_wrap(source, x + remaining_samples - 1); /* Go to last channel */
+	while (remaining_samples) {
+		bytes = audio_stream_rewind_bytes_without_wrap(source, x);
+		nmax = VOL_BYTES_TO_S16_SAMPLES(bytes) + 1;
+		n = MIN(nmax, remaining_samples);
+		for (i = 0; i < n; i += nch) {
+			sum = AE_ZERO32();
+			for (j = 0; j < nch; j++) {
+				AE_L16_XP(sample, x, dec);
+				sum = AE_ADD32(sum, AE_SEXT32X2D16_32(sample));
+			}
+
+			/* first sign change */
+			frame_sum = AE_MOVAD32_L(sum);
+			if ((frame_sum ^ *prev_sum) < 0)
+				return curr_frames;
+
+			*prev_sum = frame_sum;
+			curr_frames--;
+		}
+		remaining_samples -= n;
+		x = audio_stream_rewind_wrap(source, x);
+	}
+
+	/* sign change not detected, process all samples */
+	return frames;
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+const struct comp_ramp_func_map volume_ramp_func_map[] = {
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, vol_ramp_s16_to_s16, vol_zc_get_s16 },
+#endif
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, vol_ramp_s24_to_s24_s32, vol_zc_get_s24 },
+#endif
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, vol_ramp_s32_to_s24_s32, vol_zc_get_s32 },
+#endif
+};
+
+const size_t volume_ramp_func_count = ARRAY_SIZE(volume_ramp_func_map);
+
+#endif
@@ -0,0 +1,373 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/**
+ * \file
+ * \brief Per module instance and per core performance (KCPS) accounting
+ *
+ * Every module adapter instance registers one performance data item. The
+ * item is updated by module_adapter_copy() with the number of cycles
+ * consumed by each processing iteration. Average and peak KCPS are derived
+ * from the accumulated data only when the host asks for them, so the
+ * per-iteration cost is limited to a few additions and a comparison.
+ *
+ * With CPC accounting the peak iteration of each window is also compared
+ * to the cycles per chunk declared by the host, and the core KCPS budget
+ * is corrected by the difference so that the clock follows what modules
+ * actually consume.
+ */
+
+#include <sof/audio/component.h>
+#include <sof/debug/telemetry/performance_monitor.h>
+#include <sof/debug/telemetry/telemetry.h>
+#include <sof/lib/cpu-clk-manager.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/memory.h>
+#include <sof/list.h>
+#include <sof/math/numbers.h>
+#include <rtos/alloc.h>
+#include <rtos/clk.h>
+#include <rtos/spinlock.h>
+#include <ipc4/base_fw.h>
+#include <ipc4/module.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(perf_monitor, CONFIG_SOF_LOG_LEVEL);
+
+struct perf_monitor {
+	struct k_spinlock lock;		/* protects items list */
+	struct list_item items;		/* list of struct perf_data_item_comp */
+	uint32_t state;			/* enum ipc4_perf_measurements_state_set */
+};
+
+static SHARED_DATA struct perf_monitor perf_monitor;
+
+static inline struct perf_monitor *perf_monitor_get(void)
+{
+	return platform_shared_get(&perf_monitor, sizeof(perf_monitor));
+}
+
+/* platform timer cycles are converted to cycles of the core clock */
+static inline uint64_t perf_timer_to_cpu_cycles(uint64_t cycles, uint32_t core)
+{
+	return cycles * clock_get_freq(core) / CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
+}
+
+static inline uint32_t perf_cycles_to_kcps(uint64_t cycles, uint32_t period_us)
+{
+	if (!period_us)
+		return 0;
+
+	/* cycles per period * periods per second / 1000 */
+	return (uint32_t)(cycles * 1000 / period_us);
+}
+
+static void perf_data_item_comp_reset(struct perf_data_item_comp *item)
+{
+	item->item.peak_kcps = 0;
+	item->item.avg_kcps = 0;
+	item->total_iteration_count = 0;
+	item->total_cycles_consumed = 0;
+	item->peak_cycles = 0;
+}
+
+struct perf_data_item_comp *perf_data_item_comp_register(struct comp_dev *dev)
+{
+	struct perf_monitor *mon = perf_monitor_get();
+	struct perf_data_item_comp *item;
+	k_spinlock_key_t key;
+
+	item = rzalloc(SOF_MEM_ZONE_RUNTIME_SHARED, 0, SOF_MEM_CAPS_RAM, sizeof(*item));
+	if (!item)
+		return NULL;
+
+	item->item.resource_id = dev->ipc_config.id;
+	item->core = dev->ipc_config.core;
+	item->dev = dev;
+
+	key = k_spin_lock(&mon->lock);
+	list_item_append(&item->list, &mon->items);
+	k_spin_unlock(&mon->lock, key);
+
+	return item;
+}
+
+void perf_data_item_comp_unregister(struct perf_data_item_comp *item)
+{
+	struct perf_monitor *mon = perf_monitor_get();
+	k_spinlock_key_t key;
+
+	if (!item)
+		return;
+
+#if CONFIG_SOF_TELEMETRY_CPC_ACCOUNTING
+	if (item->kcps_correction)
+		core_kcps_adjust(item->core, -item->kcps_correction);
+#endif
+
+	key = k_spin_lock(&mon->lock);
+	list_item_del(&item->list);
+	k_spin_unlock(&mon->lock, key);
+
+	rfree(item);
+}
+
+bool perf_meas_is_started(void)
+{
+	return perf_monitor_get()->state == IPC4_PERF_MEASUREMENTS_STARTED;
+}
+
+#if CONFIG_SOF_TELEMETRY_CPC_ACCOUNTING
+void perf_data_item_comp_set_cpc(struct perf_data_item_comp *item, uint32_t cpc)
+{
+	if (item)
+		item->declared_cpc = cpc;
+}
+
+/* peak CPC of a window against the declared one, corrects the core budget */
+static void perf_cpc_window_end(struct perf_data_item_comp *item)
+{
+	uint32_t measured = perf_timer_to_cpu_cycles(item->window_peak, item->core);
+	uint64_t budget_cpc;
+	int32_t correction;
+#if CONFIG_SOF_TELEMETRY
+	struct telemetry_cpc cpc;
+#endif
+
+	item->window_peak = 0;
+	item->window_iterations = 0;
+
+	/* the first window carries cold caches and first period setup */
+	if (!item->windows++ || !item->declared_cpc)
+		return;
+
+	if (measured <= item->measured_cpc)
+		return;
+
+	item->measured_cpc = measured;
+
+	/* reported once per new peak above the declared CPC */
+	if (measured > item->declared_cpc) {
+		comp_warn(item->dev, "perf_cpc_window_end(): measured cpc %u over declared %u",
+			  measured, item->declared_cpc);
+#if CONFIG_SOF_TELEMETRY
+		cpc.declared_cpc = item->declared_cpc;
+		cpc.measured_cpc = measured;
+		telemetry_post(TELEMETRY_RECORD_CPC, item->item.resource_id, &cpc, sizeof(cpc));
+#endif
+	}
+
+	budget_cpc = (uint64_t)measured * (100 + CONFIG_SOF_TELEMETRY_CPC_MARGIN) / 100;
+	correction = (int32_t)perf_cycles_to_kcps(budget_cpc, item->dev->period) -
+		     (int32_t)perf_cycles_to_kcps(item->declared_cpc, item->dev->period);
+	if (correction == item->kcps_correction)
+		return;
+
+	if (!core_kcps_adjust(item->core, correction - item->kcps_correction))
+		item->kcps_correction = correction;
+}
+
+static inline void perf_cpc_update(struct perf_data_item_comp *item, uint64_t cycles)
+{
+	if (cycles > item->window_peak)
+		item->window_peak = cycles;
+
+	if (++item->window_iterations >= CONFIG_SOF_TELEMETRY_CPC_WINDOW)
+		perf_cpc_window_end(item);
+}
+#endif /* CONFIG_SOF_TELEMETRY_CPC_ACCOUNTING */
+
+void perf_data_item_comp_update(struct perf_data_item_comp *item, uint64_t cycles)
+{
+	if (!item)
+		return;
+
+#if CONFIG_SOF_TELEMETRY_CPC_ACCOUNTING
+	perf_cpc_update(item, cycles);
+#endif
+
+	if (!perf_meas_is_started())
+		return;
+
+	cycles = perf_timer_to_cpu_cycles(cycles, item->core);
+
+	item->total_iteration_count++;
+	item->total_cycles_consumed += cycles;
+	if (cycles > item->peak_cycles)
+		item->peak_cycles = cycles;
+}
+
+int perf_meas_set_state(uint32_t state)
+{
+	struct perf_monitor *mon = perf_monitor_get();
+	struct perf_data_item_comp *item;
+	struct list_item *clist;
+	k_spinlock_key_t key;
+
+	switch (state) {
+	case IPC4_PERF_MEASUREMENTS_DISABLED:
+	case IPC4_PERF_MEASUREMENTS_STOPPED:
+	case IPC4_PERF_MEASUREMENTS_PAUSED:
+		break;
+	case IPC4_PERF_MEASUREMENTS_STARTED:
+		/* resuming from pause keeps the data captured so far */
+		if (mon->state == IPC4_PERF_MEASUREMENTS_PAUSED)
+			break;
+
+		key = k_spin_lock(&mon->lock);
+		list_for_item(clist, &mon->items) {
+			item = container_of(clist, struct perf_data_item_comp, list);
+			perf_data_item_comp_reset(item);
+		}
+		k_spin_unlock(&mon->lock, key);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	mon->state = state;
+
+	return 0;
+}
+
+uint32_t perf_meas_get_state(void)
+{
+	return perf_monitor_get()->state;
+}
+
+/* converts accumulated counters into reported KCPS values */
+static void perf_data_item_comp_finalize(struct perf_data_item_comp *item)
+{
+	uint64_t avg_cycles = 0;
+
+	if (item->total_iteration_count)
+		avg_cycles = item->total_cycles_consumed / item->total_iteration_count;
+
+	item->item.avg_kcps = perf_cycles_to_kcps(avg_cycles, item->dev->period);
+	item->item.peak_kcps = perf_cycles_to_kcps(item->peak_cycles, item->dev->period);
+}
+
+static int perf_meas_get_data(char *data, uint32_t max_size, uint32_t *data_size,
+			      bool extended)
+{
+	struct perf_monitor *mon = perf_monitor_get();
+	struct ipc4_perf_data_item core_items[CONFIG_CORE_COUNT];
+	const size_t item_size = extended ? sizeof(struct ipc4_perf_data_item_mi) :
+					    sizeof(struct ipc4_perf_data_item);
+	struct ipc4_perf_data_item_mi *out_mi;
+	struct ipc4_perf_data_item *out;
+	struct perf_data_item_comp *item;
+	struct list_item *clist;
+	uint32_t max_items;
+	uint32_t count = 0;
+	k_spinlock_key_t key;
+	int core;
+
+	if (max_size < sizeof(uint32_t))
+		return -EINVAL;
+
+	max_items = (max_size - sizeof(uint32_t)) / item_size;
+	out = (struct ipc4_perf_data_item *)(data + sizeof(uint32_t));
+	out_mi = (struct ipc4_perf_data_item_mi *)out;
+
+	memset(core_items, 0, sizeof(core_items));
+	for (core = 0; core < CONFIG_CORE_COUNT; core++)
+		core_items[core].resource_id = IPC4_COMP_ID(0, core);
+
+	key = k_spin_lock(&mon->lock);
+
+	list_for_item(clist, &mon->items) {
+		item = container_of(clist, struct perf_data_item_comp, list);
+		perf_data_item_comp_finalize(item);
+
+		if (item->core < CONFIG_CORE_COUNT) {
+			core_items[item->core].avg_kcps += item->item.avg_kcps;
+			core_items[item->core].peak_kcps += item->item.peak_kcps;
+		}
+
+		/* per core totals are placed in front of module items, the item
+		 * is stored as long as the window holds all of the items so far
+		 */
+		if (CONFIG_CORE_COUNT + count + 1 > max_items)
+			continue;
+
+		if (extended) {
+			out_mi[CONFIG_CORE_COUNT + count].item = item->item;
+			out_mi[CONFIG_CORE_COUNT + count].total_iteration_count =
+				item->total_iteration_count;
+			out_mi[CONFIG_CORE_COUNT + count].total_cycles_consumed =
+				item->total_cycles_consumed;
+		} else {
+			out[CONFIG_CORE_COUNT + count] = item->item;
+		}
+		count++;
+	}
+
+	k_spin_unlock(&mon->lock, key);
+
+	/*
+	 * Disabled cores are reported as well so that the module items always
+	 * begin at the same index.
+	 */
+	for (core = 0; core < CONFIG_CORE_COUNT && core < max_items; core++) {
+		if (extended) {
+			memset(&out_mi[core], 0, sizeof(out_mi[core]));
+			out_mi[core].item = core_items[core];
+		} else {
+			out[core] = core_items[core];
+		}
+	}
+
+	count += MIN(CONFIG_CORE_COUNT, max_items);
+	*(uint32_t *)data = count;
+	*data_size = sizeof(uint32_t) + count * item_size;
+
+	return 0;
+}
+
+uint32_t perf_meas_get_core_kcps(uint32_t core)
+{
+	struct perf_monitor *mon = perf_monitor_get();
+	struct perf_data_item_comp *item;
+	struct list_item *clist;
+	uint32_t kcps = 0;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&mon->lock);
+
+	list_for_item(clist, &mon->items) {
+		item = container_of(clist, struct perf_data_item_comp, list);
+		if (item->core != core)
+			continue;
+
+		perf_data_item_comp_finalize(item);
+		kcps += item->item.avg_kcps;
+	}
+
+	k_spin_unlock(&mon->lock, key);
+
+	return kcps;
+}
+
+int perf_meas_get_global_data(char *data, uint32_t max_size, uint32_t *data_size)
+{
+	return perf_meas_get_data(data, max_size, data_size, false);
+}
+
+int perf_meas_get_extended_global_data(char *data, uint32_t max_size, uint32_t *data_size)
+{
+	return perf_meas_get_data(data, max_size, data_size, true);
+}
+
+void perf_meas_init(void)
+{
+	struct perf_monitor *mon = perf_monitor_get();
+
+	k_spinlock_init(&mon->lock);
+	list_init(&mon->items);
+	mon->state = IPC4_PERF_MEASUREMENTS_DISABLED;
+}
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/**
+ * \file
+ * \brief Statistical PC sampling profiler
+ *
+ * A periodic kernel timer samples the program counter and the thread it
+ * interrupted. The expiry function runs in the system clock interrupt, the
+ * interrupted program counter is read from the EPC register of its level.
+ * Samples are posted to the telemetry buffer of the core handling the
+ * interrupt, i.e. the sampled core. Only the interrupted PC is recorded,
+ * unwinding the windowed stack in the interrupt would cost too much.
+ */
+
+#include <sof/common.h>
+#include <sof/debug/telemetry/profiler.h>
+#include <sof/debug/telemetry/telemetry.h>
+#include <sof/math/numbers.h>
+#include <zephyr/kernel.h>
+#include <stdint.h>
+
+static struct k_timer profiler_timer;
+
+static inline uint32_t profiler_interrupted_pc(void)
+{
+	uint32_t pc;
+
+	__asm__ __volatile__ ("rsr.epc" STRINGIFY(CONFIG_SOF_PROFILER_IRQ_LEVEL) " %0"
+			      : "=a" (pc));
+
+	return pc;
+}
+
+static void profiler_sample(struct k_timer *timer)
+{
+	struct telemetry_pc_sample sample = {
+		.pc = profiler_interrupted_pc(),
+	};
+
+	/* in the interrupt the current thread is the interrupted one */
+	telemetry_post(TELEMETRY_RECORD_PC_SAMPLE, (uint32_t)(uintptr_t)k_current_get(),
+		       &sample, sizeof(sample));
+}
+
+void profiler_set_period(uint32_t period_us)
+{
+	if (!period_us) {
+		k_timer_stop(&profiler_timer);
+		return;
+	}
+
+	period_us = MAX(period_us, (uint32_t)CONFIG_SOF_PROFILER_MIN_PERIOD_US);
+	k_timer_start(&profiler_timer, K_USEC(period_us), K_USEC(period_us));
+}
+
+void profiler_init(void)
+{
+	k_timer_init(&profiler_timer, profiler_sample, NULL);
+}
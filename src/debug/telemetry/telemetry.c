@@ -0,0 +1,411 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/**
+ * \file
+ * \brief Per core telemetry circular buffers
+ *
+ * Each core owns a single producer, single consumer ring. Records are
+ * posted by modules running on the core (directly or through the native
+ * system service) and drained by the primary core in TELEMETRY_DATA
+ * requests. The rings are placed in uncached memory, a memory window when
+ * the platform provides one, so that no cache maintenance nor cross-core
+ * locking is needed on the producer side.
+ *
+ * Host notifications are sent by a low priority task on the primary core
+ * once the unread data reaches the threshold or the aging timer expires.
+ */
+
+#include <sof/common.h>
+#include <sof/debug/telemetry/profiler.h>
+#include <sof/debug/telemetry/telemetry.h>
+#include <sof/debug/telemetry/tracepoint.h>
+#include <sof/ipc/msg.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/memory.h>
+#if CONFIG_SOF_CACHE_STATS
+#include <sof/lib/cache_stats.h>
+#endif
+#if CONFIG_SOF_LOCK_STATS
+#include <sof/lib/ticket_lock.h>
+#endif
+#include <sof/lib/uuid.h>
+#include <sof/math/numbers.h>
+#include <sof/schedule/edf_schedule.h>
+#include <sof/schedule/schedule.h>
+#include <rtos/alloc.h>
+#include <rtos/interrupt.h>
+#include <rtos/task.h>
+#include <rtos/timer.h>
+#include <ipc4/base_fw.h>
+#include <ipc4/notification.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(telemetry, CONFIG_SOF_LOG_LEVEL);
+
+/* 6e3d5a1c-4b2e-4f08-9a51-0c7d2bd6f3a4 */
+DECLARE_SOF_UUID("telemetry-task", telemetry_task_uuid, 0x6e3d5a1c, 0x4b2e, 0x4f08,
+		 0x9a, 0x51, 0x0c, 0x7d, 0x2b, 0xd6, 0xf3, 0xa4);
+
+DECLARE_TR_CTX(telemetry_tr, SOF_UUID(telemetry_task_uuid), LOG_LEVEL_INFO);
+
+#define TELEMETRY_RING_DATA_SIZE	CONFIG_SOF_TELEMETRY_BUFFER_SIZE
+#define TELEMETRY_RING_SIZE		(sizeof(struct telemetry_ring) + TELEMETRY_RING_DATA_SIZE)
+
+STATIC_ASSERT(is_power_of_2(TELEMETRY_RING_DATA_SIZE),
+	      telemetry_buffer_size_must_be_power_of_2);
+
+/* how often the notification task checks the rings */
+#define TELEMETRY_POLL_PERIOD_MS	10
+
+/* how often lock contention and cache maintenance counters are posted */
+#define TELEMETRY_STATS_PERIOD_MS	1000
+
+/* extension of LOG_BUFFER_STATUS notification identifying telemetry data */
+#define TELEMETRY_NOTIFY_EXT		BIT(31)
+
+#define TELEMETRY_IPC_CORE		PLATFORM_PRIMARY_CORE_ID
+
+struct telemetry_ctx {
+	struct telemetry_ring *rings[CONFIG_CORE_COUNT];
+	struct ipc4_telemetry_state state;
+	struct ipc_msg *notify;
+	struct task task;
+	uint64_t last_notify_ms;
+#if CONFIG_SOF_LOCK_STATS || CONFIG_SOF_CACHE_STATS
+	uint64_t last_stats_ms;
+#endif
+};
+
+static struct telemetry_ctx *telemetry;
+
+#if CONFIG_SOF_TRACEPOINTS
+/* read by all cores on every tracepoint, only set while telemetry is started */
+SHARED_DATA uint32_t sof_tracepoint_mask;
+#endif
+
+static inline uint32_t telemetry_ring_used(const struct telemetry_ring *ring)
+{
+	return ring->write_pos - ring->read_pos;
+}
+
+/* copies bytes into the ring starting at free running position pos */
+static void telemetry_ring_write(struct telemetry_ring *ring, uint32_t pos,
+				 const void *src, uint32_t bytes)
+{
+	const uint32_t offset = pos & (ring->size - 1);
+	const uint32_t head = MIN(bytes, ring->size - offset);
+
+	memcpy_s(ring->data + offset, ring->size - offset, src, head);
+	if (head < bytes)
+		memcpy_s(ring->data, ring->size, (const uint8_t *)src + head, bytes - head);
+}
+
+static void telemetry_ring_read(const struct telemetry_ring *ring, uint32_t pos,
+				void *dst, uint32_t bytes)
+{
+	const uint32_t offset = pos & (ring->size - 1);
+	const uint32_t head = MIN(bytes, ring->size - offset);
+
+	memcpy_s(dst, bytes, ring->data + offset, head);
+	if (head < bytes)
+		memcpy_s((uint8_t *)dst + head, bytes - head, ring->data, bytes - head);
+}
+
+int telemetry_post(uint32_t type, uint32_t resource_id, const void *data, uint32_t size)
+{
+	struct telemetry_record record;
+	struct telemetry_ring *ring;
+	uint32_t record_size;
+	uint32_t pos;
+	uint32_t flags;
+
+	if (!telemetry || telemetry->state.state != IPC4_TELEMETRY_STARTED)
+		return -ENODEV;
+
+	if (size > UINT16_MAX)
+		return -EINVAL;
+
+	ring = telemetry->rings[cpu_get_id()];
+	record_size = sizeof(record) + ALIGN_UP(size, sizeof(uint32_t));
+
+	record.type = type;
+	record.size = size;
+	record.resource_id = resource_id;
+	record.timestamp = (uint32_t)sof_cycle_get_64();
+
+	/* LL and DP contexts of the same core may post concurrently */
+	irq_local_disable(flags);
+
+	pos = ring->write_pos;
+	if (ring->size - telemetry_ring_used(ring) < record_size) {
+		ring->overruns++;
+		irq_local_enable(flags);
+		return -ENOSPC;
+	}
+
+	telemetry_ring_write(ring, pos, &record, sizeof(record));
+	if (size)
+		telemetry_ring_write(ring, pos + sizeof(record), data, size);
+
+	/* record becomes visible to the consumer only now */
+	ring->write_pos = pos + record_size;
+
+	irq_local_enable(flags);
+
+	return 0;
+}
+
+#if CONFIG_SOF_TRACEPOINTS
+void sof_tracepoint_emit(uint32_t id, uint32_t phase, uint32_t resource_id, uint32_t bytes)
+{
+	struct telemetry_tracepoint tp = {
+		.id = id,
+		.phase = phase,
+		.bytes = bytes,
+	};
+
+	telemetry_post(TELEMETRY_RECORD_TRACEPOINT, resource_id, &tp, sizeof(tp));
+}
+#endif
+
+static bool telemetry_threshold_reached(void)
+{
+	int core;
+
+	if (!telemetry->state.threshold)
+		return false;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++)
+		if (telemetry_ring_used(telemetry->rings[core]) >= telemetry->state.threshold)
+			return true;
+
+	return false;
+}
+
+static bool telemetry_data_pending(void)
+{
+	int core;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++)
+		if (telemetry_ring_used(telemetry->rings[core]))
+			return true;
+
+	return false;
+}
+
+static enum task_state telemetry_task_run(void *data)
+{
+	const uint64_t now = k_uptime_get();
+	bool aged = telemetry->state.aging_timer &&
+		    now - telemetry->last_notify_ms >= telemetry->state.aging_timer;
+
+#if CONFIG_SOF_LOCK_STATS || CONFIG_SOF_CACHE_STATS
+	if (now - telemetry->last_stats_ms >= TELEMETRY_STATS_PERIOD_MS) {
+#if CONFIG_SOF_LOCK_STATS
+		ticket_lock_stats_post();
+#endif
+#if CONFIG_SOF_CACHE_STATS
+		cache_stats_post();
+#endif
+		telemetry->last_stats_ms = now;
+	}
+#endif
+
+	if (telemetry_threshold_reached() || (aged && telemetry_data_pending())) {
+		ipc_msg_send(telemetry->notify, NULL, false);
+		telemetry->last_notify_ms = now;
+	}
+
+	return SOF_TASK_STATE_RESCHEDULE;
+}
+
+static uint64_t telemetry_task_deadline(void *data)
+{
+	return k_uptime_ticks() + k_ms_to_ticks_ceil64(TELEMETRY_POLL_PERIOD_MS);
+}
+
+int telemetry_set_state(const char *data, uint32_t size)
+{
+	const struct ipc4_telemetry_state *state = (const struct ipc4_telemetry_state *)data;
+	struct task_ops ops = {
+		.run = telemetry_task_run,
+		.get_deadline = telemetry_task_deadline,
+		.complete = NULL,
+	};
+	int ret;
+
+	if (!telemetry)
+		return -ENODEV;
+
+	if (size < offsetof(struct ipc4_telemetry_state, tracepoint_mask))
+		return -EINVAL;
+
+	switch (state->state) {
+	case IPC4_TELEMETRY_STARTED:
+		/* in started state only threshold and aging timer are updated */
+		if (telemetry->state.state == IPC4_TELEMETRY_STARTED)
+			break;
+
+		ret = schedule_task_init_edf(&telemetry->task, SOF_UUID(telemetry_task_uuid),
+					     &ops, NULL, TELEMETRY_IPC_CORE, 0);
+		if (ret < 0)
+			return ret;
+
+		telemetry->last_notify_ms = k_uptime_get();
+		schedule_task(&telemetry->task, TELEMETRY_POLL_PERIOD_MS * 1000, 0);
+		break;
+	case IPC4_TELEMETRY_STOPPED:
+		if (telemetry->state.state == IPC4_TELEMETRY_STARTED) {
+			schedule_task_cancel(&telemetry->task);
+			schedule_task_free(&telemetry->task);
+		}
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	telemetry->state.threshold = MIN(state->threshold, (uint32_t)TELEMETRY_RING_DATA_SIZE);
+	telemetry->state.aging_timer = state->aging_timer;
+	telemetry->state.state = state->state;
+
+	/* older hosts send the state without the tracepoint mask */
+	if (size >= offsetof(struct ipc4_telemetry_state, tracepoint_mask) +
+	    sizeof(state->tracepoint_mask) && state->state == IPC4_TELEMETRY_STARTED)
+		telemetry->state.tracepoint_mask = state->tracepoint_mask;
+	else
+		telemetry->state.tracepoint_mask = 0;
+#if CONFIG_SOF_TRACEPOINTS
+	sof_tracepoint_mask = telemetry->state.tracepoint_mask;
+#endif
+
+	if (size >= offsetof(struct ipc4_telemetry_state, profiler_period_us) +
+	    sizeof(state->profiler_period_us) && state->state == IPC4_TELEMETRY_STARTED)
+		telemetry->state.profiler_period_us = state->profiler_period_us;
+	else
+		telemetry->state.profiler_period_us = 0;
+	profiler_set_period(telemetry->state.profiler_period_us);
+
+	tr_info(&telemetry_tr, "telemetry state %u threshold %u aging %u ms",
+		telemetry->state.state, telemetry->state.threshold,
+		telemetry->state.aging_timer);
+
+	return 0;
+}
+
+int telemetry_get_state(char *data, uint32_t *data_size)
+{
+	if (!telemetry)
+		return -ENODEV;
+
+	memcpy_s(data, sizeof(telemetry->state), &telemetry->state, sizeof(telemetry->state));
+	*data_size = sizeof(telemetry->state);
+
+	return 0;
+}
+
+int telemetry_get_data(char *data, uint32_t max_size, uint32_t *data_size)
+{
+	struct ipc4_telemetry_data_chunk *chunk;
+	struct telemetry_record record;
+	struct telemetry_ring *ring;
+	uint32_t offset = 0;
+	uint32_t record_size;
+	uint32_t write_pos;
+	uint32_t pos;
+	int core;
+
+	if (!telemetry)
+		return -ENODEV;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		if (offset + sizeof(*chunk) > max_size)
+			break;
+
+		ring = telemetry->rings[core];
+		chunk = (struct ipc4_telemetry_data_chunk *)(data + offset);
+		offset += sizeof(*chunk);
+
+		chunk->core_id = core;
+		chunk->overruns = ring->overruns;
+		chunk->size = 0;
+
+		/* snapshot producer position, records past it may be incomplete */
+		write_pos = ring->write_pos;
+
+		/* only whole records are moved to the reply */
+		for (pos = ring->read_pos; pos != write_pos; pos += record_size) {
+			telemetry_ring_read(ring, pos, &record, sizeof(record));
+			record_size = sizeof(record) + ALIGN_UP(record.size, sizeof(uint32_t));
+			if (offset + record_size > max_size)
+				break;
+
+			telemetry_ring_read(ring, pos, data + offset, record_size);
+			offset += record_size;
+			chunk->size += record_size;
+		}
+
+		ring->read_pos = pos;
+	}
+
+	*data_size = offset;
+	telemetry->last_notify_ms = k_uptime_get();
+
+	return 0;
+}
+
+uint32_t telemetry_get_buffer_size(void)
+{
+	return TELEMETRY_RING_DATA_SIZE * CONFIG_CORE_COUNT;
+}
+
+int telemetry_init(void)
+{
+	struct telemetry_ring *ring;
+	uint8_t *rings;
+	int core;
+
+	telemetry = rzalloc(SOF_MEM_ZONE_SYS_SHARED, 0, SOF_MEM_CAPS_RAM, sizeof(*telemetry));
+	if (!telemetry)
+		return -ENOMEM;
+
+#ifdef SRAM_TELEMETRY_BASE
+	STATIC_ASSERT(TELEMETRY_RING_SIZE * CONFIG_CORE_COUNT <= SRAM_TELEMETRY_SIZE,
+		      telemetry_buffers_do_not_fit_memory_window);
+	rings = (uint8_t *)SRAM_TELEMETRY_BASE;
+	memset(rings, 0, TELEMETRY_RING_SIZE * CONFIG_CORE_COUNT);
+#else
+	rings = rzalloc(SOF_MEM_ZONE_SYS_SHARED, 0, SOF_MEM_CAPS_RAM,
+			TELEMETRY_RING_SIZE * CONFIG_CORE_COUNT);
+	if (!rings)
+		goto err;
+#endif
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		ring = (struct telemetry_ring *)(rings + core * TELEMETRY_RING_SIZE);
+		ring->size = TELEMETRY_RING_DATA_SIZE;
+		telemetry->rings[core] = ring;
+	}
+
+	telemetry->notify = ipc_msg_w_ext_init(SOF_IPC4_NOTIF_HEADER(SOF_IPC4_NOTIFY_LOG_BUFFER_STATUS),
+					       TELEMETRY_NOTIFY_EXT, 0);
+	if (!telemetry->notify)
+		goto err;
+
+	telemetry->state.state = IPC4_TELEMETRY_STOPPED;
+	profiler_init();
+
+	return 0;
+
+err:
+#ifndef SRAM_TELEMETRY_BASE
+	rfree(rings);
+#endif
+	rfree(telemetry);
+	telemetry = NULL;
+	return -ENOMEM;
+}
@@ -192,7 +192,7 @@ static int acp_dmic_dma_get_data_size(struct dma_chan_data *channel,
 		       channel->direction);
 	}
 
-	tr_info(&acp_dmic_dma_tr, "avail %d and free %d",
+	tr_dbg(&acp_dmic_dma_tr, "avail %d and free %d",
 		avail[0], free[0]);
 	return 0;
 }
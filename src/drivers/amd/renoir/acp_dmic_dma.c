@@ -186,9 +186,9 @@ int acp_dmic_dma_set_config(struct dma_chan_data *channel,
 		watermark.bits.rx_intr_watermark_size = (dmic_rngbuff_size >> 1);
 		io_reg_write(PU_REGISTER_BASE +
 			ACP_WOV_RX_INTR_WATERMARK_SIZE, watermark.u32all);
+		/* The silence is applied per interrupt, to a half of the ring */
 		timeperiod_ms = dmic_rngbuff_size / (acp_initsilence.num_chs *
-			acp_initsilence.samplerate_khz * acp_initsilence.bytes_per_sample *
-			config->elem_array.count);
+			acp_initsilence.samplerate_khz * acp_initsilence.bytes_per_sample * 2);
 		acp_initsilence.silence_cnt = DMIC_SETTLING_TIME_MS / timeperiod_ms;
 		acp_initsilence.numfilterbuffers = DMIC_SMOOTH_TIME_MS / timeperiod_ms;
 		break;
@@ -221,7 +221,7 @@ int acp_dmic_dma_get_attribute(struct dma *dma, uint32_t type, uint32_t *value)
 		*value = PLATFORM_DCACHE_ALIGN;
 		break;
 	case DMA_ATTR_BUFFER_PERIOD_COUNT:
-		*value = ACP_DAI_DMA_BUFFER_PERIOD_COUNT;
+		*value = ACP_DMIC_DMA_BUFFER_PERIOD_COUNT;
 		break;
 	default:
 		return -ENOENT; /* Attribute not found */
@@ -210,7 +210,7 @@ int acp_dmic_dma_get_attribute(struct dma *dma, uint32_t type, uint32_t *value)
 		*value = PLATFORM_DCACHE_ALIGN;
 		break;
 	case DMA_ATTR_BUFFER_PERIOD_COUNT:
-		*value = ACP_DAI_DMA_BUFFER_PERIOD_COUNT;
+		*value = ACP_DMIC_DMA_BUFFER_PERIOD_COUNT;
 		break;
 	default:
 		return -ENOENT; /* Attribute not found */
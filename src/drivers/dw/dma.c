@@ -68,6 +68,7 @@ struct dw_dma_chan_data {
 	uint32_t cfg_lo;
 	uint32_t cfg_hi;
 	struct dw_dma_ptr_data ptr_data;	/* pointer data */
+	bool auto_reload;			/* cyclic LLI without write back */
 };
 
 /* use array to get burst_elems for specific slot number setting.
@@ -514,6 +515,7 @@ static int dw_dma_set_config(struct dma_chan_data *channel,
 	channel->period = config->period;
 	dw_chan->cfg_lo = DW_CFG_LOW_DEF;
 	dw_chan->cfg_hi = DW_CFG_HIGH_DEF;
+	dw_chan->auto_reload = false;
 
 	if (!config->elem_array.count) {
 		tr_err(&dwdma_tr, "dw_dma_set_config(): dma %d channel %d no elems",
@@ -744,7 +746,21 @@ static int dw_dma_set_config(struct dma_chan_data *channel,
 	}
 
 #if CONFIG_DMA_HW_LLI
-	dw_chan->cfg_lo |= DW_CFG_CTL_HI_UPD_EN;
+	/* A cyclic list is reloaded by the controller forever and the
+	 * position is read from SAR/DAR, so the DONE bits need not be
+	 * written back to the descriptors and cleared by FW every period.
+	 */
+#if CONFIG_DW_DMA_LLI_AUTO_RELOAD
+	dw_chan->auto_reload = config->cyclic;
+
+	/* timer driven pipelines poll the position, no block interrupts */
+	if (dw_chan->auto_reload && config->irq_disabled) {
+		for (i = 0; i < channel->desc_count; i++)
+			dw_chan->lli[i].ctrl_lo &= ~DW_CTLL_INT_EN;
+	}
+#endif
+	if (!dw_chan->auto_reload)
+		dw_chan->cfg_lo |= DW_CFG_CTL_HI_UPD_EN;
 #endif
 
 	/* end of list or cyclic buffer */
@@ -791,6 +807,10 @@ static void dw_dma_verify_transfer(struct dma_chan_data *channel,
 #else
 	struct dw_lli *lli = platform_dw_dma_lli_get(dw_chan->lli_current);
 #endif
+	/* nothing to do per period, the DMA has no DONE bits written back */
+	if (dw_chan->auto_reload && next->status != DMA_CB_STATUS_END)
+		return;
+
 	switch (next->status) {
 	case DMA_CB_STATUS_END:
 		channel->status = COMP_STATE_PREPARE;
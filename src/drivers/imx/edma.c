@@ -241,22 +241,25 @@ static int edma_validate_nonsg_config(struct dma_sg_elem_array *sgelems,
 				      uint32_t soff, uint32_t doff)
 {
 	uint32_t sbase, dbase, size;
+	int i;
 
 	if (!sgelems)
 		return -EINVAL;
-	if (sgelems->count != 2)
+	if (sgelems->count != EDMA_BUFFER_PERIOD_COUNT)
 		return -EINVAL; /* Only ping-pong configs supported */
 
 	sbase = sgelems->elems[0].src;
 	dbase = sgelems->elems[0].dest;
 	size = sgelems->elems[0].size;
 
-	if (sbase + size * SGN(soff) != sgelems->elems[1].src)
-		return -EINVAL; /**< Not contiguous */
-	if (dbase + size * SGN(doff) != sgelems->elems[1].dest)
-		return -EINVAL; /**< Not contiguous */
-	if (size != sgelems->elems[1].size)
-		return -EINVAL; /**< Mismatched sizes */
+	for (i = 1; i < sgelems->count; i++) {
+		if (sbase + i * size * SGN(soff) != sgelems->elems[i].src)
+			return -EINVAL; /**< Not contiguous */
+		if (dbase + i * size * SGN(doff) != sgelems->elems[i].dest)
+			return -EINVAL; /**< Not contiguous */
+		if (size != sgelems->elems[i].size)
+			return -EINVAL; /**< Mismatched sizes */
+	}
 
 	return 0; /* Ok, we good */
 }
@@ -298,7 +301,8 @@ static int edma_setup_tcd(struct dma_chan_data *channel, int16_t soff,
 	 */
 
 	/* The only supported non-SG configurations are:
-	 * -> 2 buffers
+	 * -> EDMA_BUFFER_PERIOD_COUNT buffers, the two halves of them
+	 *    are transferred per interrupt
 	 * -> The buffers must be of equal size
 	 * -> The buffers must be contiguous
 	 * -> The first buffer should be of the lower address
@@ -312,7 +316,7 @@ static int edma_setup_tcd(struct dma_chan_data *channel, int16_t soff,
 
 	sbase = sgelems->elems[0].src;
 	dbase = sgelems->elems[0].dest;
-	total_size = 2 * sgelems->elems[0].size;
+	total_size = sgelems->count * sgelems->elems[0].size;
 	/* TODO more flexible elem_count and elem_size
 	 * calculations
 	 */
@@ -519,8 +523,8 @@ static int edma_get_data_size(struct dma_chan_data *channel,
 	 * return undefined data.
 	 *
 	 * get_data_size() and copy() are run exactly once per
-	 * interrupt, and currently we have the elem size stored
-	 * directly in the hardware register EDMA_TCD_SLAST
+	 * interrupt, and currently we have the size of one interrupt
+	 * stored directly in the hardware register EDMA_TCD_SLAST
 	 * as negative offset divided by 2 for playback and, similarly,
 	 * in EDMA_TCD_DLAST_SGA for capture.
 	 *
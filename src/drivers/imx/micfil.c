@@ -202,9 +202,9 @@ static int micfil_set_config(struct dai *dai, struct ipc_config_dai *common_conf
 		val |= MICFIL_DC_BYPASS << MICFIL_DC_CHX_SHIFT(i);
 	dai_update_bits(dai, REG_MICFIL_DC_CTRL, MICFIL_DC_CTRL_CONFIG, val);
 
-	/* FIFO WMK */
+	/* FIFO WMK, already the deepest one for the fewest DMA requests */
 	dai_update_bits(dai, REG_MICFIL_FIFO_CTRL, MICFIL_FIFO_CTRL_FIFOWMK,
-			MICFIL_FIFO_CTRL_FIFOWMK_BITS(31));
+			MICFIL_FIFO_CTRL_FIFOWMK_BITS(FIFO_LEN - 1));
 
 	/* enable channels */
 	dai_update_bits(dai, REG_MICFIL_CTRL1, MICFIL_CTRL1_CHNEN,
@@ -221,6 +221,22 @@ static void sai_stop(struct dai *dai, int direction)
 		dai_warn(dai, "sai: poll for register delay failed");
 }
 
+/*
+ * Receive FIFO watermark. The half FIFO of the platform data is raised by the
+ * periods per DMA interrupt, keeping a quarter of the FIFO for the latency of
+ * the DMA request.
+ */
+static uint32_t sai_rx_watermark(struct dai *dai)
+{
+	struct dai_plat_fifo_data *fifo = &dai->plat_data.fifo[REG_RX_DIR];
+
+#if CONFIG_IMX_SAI_CAPTURE_DEEP_FIFO
+	return MIN(fifo->watermark * CONFIG_IMX_DMA_PERIODS_PER_IRQ, fifo->depth * 3 / 4);
+#else
+	return fifo->watermark;
+#endif
+}
+
 static inline int sai_set_config(struct dai *dai, struct ipc_config_dai *common_config,
 				 const void *spec_config)
 {
@@ -416,7 +432,7 @@ static inline int sai_set_config(struct dai *dai, struct ipc_config_dai *common_
 	mask_cr2 |= REG_SAI_CR2_SYNC_MASK;
 
 	dai_update_bits(dai, REG_SAI_XCR1(REG_RX_DIR), REG_SAI_CR1_RFW_MASK,
-			dai->plat_data.fifo[REG_RX_DIR].watermark);
+			sai_rx_watermark(dai));
 	dai_update_bits(dai, REG_SAI_XCR2(REG_RX_DIR), mask_cr2, val_cr2);
 	dai_update_bits(dai, REG_SAI_XCR4(REG_RX_DIR), mask_cr4, val_cr4);
 	dai_update_bits(dai, REG_SAI_XCR5(REG_RX_DIR), mask_cr5, val_cr5);
@@ -534,8 +550,12 @@ static int sai_get_fifo(struct dai *dai, int direction, int stream_id)
 static int sai_get_fifo_depth(struct dai *dai, int direction)
 {
 	switch (direction) {
-	case DAI_DIR_PLAYBACK:
 	case DAI_DIR_CAPTURE:
+#if CONFIG_IMX_SAI_CAPTURE_DEEP_FIFO
+		/* the EDMA burst is half the depth, make it match the watermark */
+		return 2 * sai_rx_watermark(dai);
+#endif
+	case DAI_DIR_PLAYBACK:
 		return dai->plat_data.fifo[direction].depth;
 	default:
 		dai_err(dai, "esai_get_fifo_depth(): Invalid direction");
@@ -12,6 +12,7 @@
 #include <sof/lib/io.h>
 #include <sof/lib/notifier.h>
 #include <sof/lib/uuid.h>
+#include <sof/math/numbers.h>
 #include <rtos/wait.h>
 #include <sof/platform.h>
 #include <errno.h>
@@ -26,7 +27,7 @@ DECLARE_SOF_UUID("sdma", sdma_uuid, 0x70d223ef, 0x2b91, 0x4aac,
 
 DECLARE_TR_CTX(sdma_tr, SOF_UUID(sdma_uuid), LOG_LEVEL_INFO);
 
-#define SDMA_BUFFER_PERIOD_COUNT 2
+#define SDMA_BUFFER_PERIOD_COUNT (2 * CONFIG_IMX_DMA_PERIODS_PER_IRQ)
 
 struct sdma_bd {
 	/* SDMA BD (buffer descriptor) configuration */
@@ -553,20 +554,30 @@ static int sdma_copy(struct dma_chan_data *channel, int bytes, uint32_t flags)
 		.elem.size = bytes,
 	};
 	int idx;
+	int i;
 
 	tr_dbg(&sdma_tr, "sdma_copy");
 
-	idx = (pdata->next_bd + 1) % 2;
-	pdata->next_bd = idx;
-
-	/* Work around the fact that we cannot allocate uncached memory
-	 * on all platforms supporting SDMA.
+	/* Give the next descriptor back to the SDMA, and more of them
+	 * if the copy covers several periods with coalesced interrupts.
 	 */
-	dcache_invalidate_region(&pdata->desc[idx].config,
-				 sizeof(pdata->desc[idx].config));
-	pdata->desc[idx].config |= SDMA_BD_DONE;
-	dcache_writeback_region(&pdata->desc[idx].config,
-				sizeof(pdata->desc[idx].config));
+	for (i = 0; i < pdata->desc_count; i++) {
+		idx = (pdata->next_bd + 1) % pdata->desc_count;
+		pdata->next_bd = idx;
+
+		/* Work around the fact that we cannot allocate uncached memory
+		 * on all platforms supporting SDMA.
+		 */
+		dcache_invalidate_region(&pdata->desc[idx].config,
+					 sizeof(pdata->desc[idx].config));
+		pdata->desc[idx].config |= SDMA_BD_DONE;
+		dcache_writeback_region(&pdata->desc[idx].config,
+					sizeof(pdata->desc[idx].config));
+
+		bytes -= pdata->desc[idx].config & SDMA_BD_COUNT_MASK;
+		if (bytes <= 0)
+			break;
+	}
 
 	notifier_event(channel, NOTIFIER_ID_DMA_COPY,
 		       NOTIFIER_TARGET_CORE_LOCAL, &next, sizeof(next));
@@ -722,9 +733,11 @@ static int sdma_read_config(struct dma_chan_data *channel,
  *    buf_addr and keep the FIFO address as a separate variable.
  *    Complain if this address changes between descriptors as we
  *    do not support this for now.
- * 3) Enable interrupts, set up transfer width, length of elem,
- *    wrap bit on the last descriptor, host side address, and
- *    finally the DONE bit so the SDMA can use the descriptors.
+ * 3) Enable interrupts on every CONFIG_IMX_DMA_PERIODS_PER_IRQ'th
+ *    and on the last descriptor, set up transfer width, length of
+ *    elem, wrap bit on the last descriptor, host side address, and
+ *    finally the DONE bit so the SDMA can use the descriptors of
+ *    the first interrupt.
  * 4) The FIFO address will be stored in the context.
  * 5) Actually upload context now as we are inside DAI prepare.
  *    We have no other opportunity in the future.
@@ -751,7 +764,8 @@ static int sdma_prep_desc(struct dma_chan_data *channel,
 		return -EINVAL;
 	}
 
-	pdata->next_bd = 0;
+	pdata->next_bd = MIN(CONFIG_IMX_DMA_PERIODS_PER_IRQ,
+			     config->elem_array.count) - 1;
 
 	/* Silence "may be used uninitialized" warnings with gcc10 -O1
 	 * and maybe other compilers/levels that don't know that
@@ -788,11 +802,13 @@ static int sdma_prep_desc(struct dma_chan_data *channel,
 
 		bd->config = SDMA_BD_COUNT(config->elem_array.elems[i].size) |
 			SDMA_BD_CMD(SDMA_CMD_XFER_SIZE(width));
-		if (!config->irq_disabled)
+		if (!config->irq_disabled &&
+		    (!((i + 1) % CONFIG_IMX_DMA_PERIODS_PER_IRQ) ||
+		     i == config->elem_array.count - 1))
 			bd->config |= SDMA_BD_INT;
 
 		bd->config |= SDMA_BD_CONT;
-		if (pdata->next_bd == i)
+		if (i <= pdata->next_bd)
 			bd->config |= SDMA_BD_DONE;
 	}
 
@@ -289,22 +289,47 @@ int afe_dai_get_config(struct mtk_base_afe *afe, int id, unsigned int *channel,
 	return 0;
 }
 
-/* TODO, IRQ common register name need use config? */
+/* The IRQs are only usable on the platforms that describe them in irq_datas,
+ * the others keep the memifs timer driven.
+ */
 int afe_irq_get_status(struct mtk_base_afe *afe, int id)
 {
-	return 0;
+	const struct mtk_base_irq_data *irq_data;
+	uint32_t value;
+
+	if (id < 0 || id >= afe->irqs_size)
+		return 0;
+
+	irq_data = afe->irqs[id].irq_data;
+	afe_reg_read(afe, irq_data->irq_status_reg, &value);
+
+	return (value >> irq_data->irq_status_shift) & 0x1;
 }
 
 int afe_irq_clear(struct mtk_base_afe *afe, int id)
 {
+	const struct mtk_base_irq_data *irq_data;
+
+	if (id < 0 || id >= afe->irqs_size)
+		return 0;
+
+	irq_data = afe->irqs[id].irq_data;
+	afe_reg_write(afe, irq_data->irq_clr_reg, BIT(irq_data->irq_clr_shift));
+
 	return 0;
 }
 
+/* The period is the number of frames between IRQs */
 int afe_irq_config(struct mtk_base_afe *afe, int id, unsigned int rate, unsigned int period)
 {
-	struct mtk_base_afe_irq *irq = &afe->irqs[id];
+	struct mtk_base_afe_irq *irq;
 	int fs;
 
+	if (id < 0 || id >= afe->irqs_size)
+		return -EINVAL;
+
+	irq = &afe->irqs[id];
+
 	afe_reg_update_bits(afe, irq->irq_data->irq_cnt_reg,
 			    irq->irq_data->irq_cnt_maskbit << irq->irq_data->irq_cnt_shift,
 			    period << irq->irq_data->irq_cnt_shift);
@@ -320,14 +345,30 @@ int afe_irq_config(struct mtk_base_afe *afe, int id, unsigned int rate, unsigned
 	return 0;
 }
 
-/* TODO, for dma based scheduler*/
 int afe_irq_enable(struct mtk_base_afe *afe, int id)
 {
+	const struct mtk_base_irq_data *irq_data;
+
+	if (id < 0 || id >= afe->irqs_size)
+		return -EINVAL;
+
+	irq_data = afe->irqs[id].irq_data;
+	afe_reg_update_bits(afe, irq_data->irq_en_reg, BIT(irq_data->irq_en_shift),
+			    BIT(irq_data->irq_en_shift));
+
 	return 0;
 }
 
 int afe_irq_disable(struct mtk_base_afe *afe, int id)
 {
+	const struct mtk_base_irq_data *irq_data;
+
+	if (id < 0 || id >= afe->irqs_size)
+		return 0;
+
+	irq_data = afe->irqs[id].irq_data;
+	afe_reg_update_bits(afe, irq_data->irq_en_reg, BIT(irq_data->irq_en_shift), 0);
+
 	return 0;
 }
 
@@ -32,6 +32,9 @@ DECLARE_SOF_UUID("memif", memif_uuid, 0xdf5e94d7, 0xfd93, 0x42e9,
 
 DECLARE_TR_CTX(memif_tr, SOF_UUID(memif_uuid), LOG_LEVEL_INFO);
 
+/* Room for two IRQs worth of periods */
+#define MEMIF_BUFFER_PERIOD_COUNT MAX(4, 2 * CONFIG_MEDIATEK_AFE_PERIODS_PER_IRQ)
+
 struct afe_memif_dma {
 	int direction; /* 1 downlink, 0 uplink */
 
@@ -415,7 +418,7 @@ static int memif_interrupt(struct dma_chan_data *channel, enum dma_irq_cmd cmd)
 		return afe_irq_disable(afe, memif->irq_id);
 	case DMA_IRQ_UNMASK:
 		sample_size = ((memif->format == SOF_IPC_FRAME_S16_LE) ? 2 : 4) * memif->channel;
-		period = memif->period_size / sample_size;
+		period = memif->period_size / sample_size * CONFIG_MEDIATEK_AFE_PERIODS_PER_IRQ;
 		ret = afe_irq_config(afe, memif->irq_id, memif->rate, period);
 		if (ret < 0)
 			return ret;
@@ -440,7 +443,7 @@ static int memif_get_attribute(struct dma *dma, uint32_t type, uint32_t *value)
 		*value = 16;
 		break;
 	case DMA_ATTR_BUFFER_PERIOD_COUNT:
-		*value = 4;
+		*value = MEMIF_BUFFER_PERIOD_COUNT;
 		break;
 	default:
 		return -ENOENT;
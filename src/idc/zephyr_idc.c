@@ -9,7 +9,9 @@
  * woken up, it executes irc_handler(), which eventually calls idc_cmd() just
  * like in the native SOF case. One work item per secondary core is enough
  * because IDC on SOF is always synchronous, the primary core always waits for
- * secondary cores to complete operation, so no races can occur.
+ * secondary cores to complete operation, so no races can occur. With
+ * IDC_ASYNC the primary core may send to several cores before waiting, but it
+ * calls idc_msg_wait() before it sends the next message to the same core.
  *
  * Design:
  * - use K_P4WQ_ARRAY_DEFINE() to statically create one queue with one thread
@@ -17,6 +19,8 @@
  * - k_p4wq_submit()
  *	runs on primary CPU
  *	send tasks to other CPUs.
+ * - notifications and AMS messages are queued to a per-core mailbox, see
+ *	idc_mailbox_post().
  */
 
 #include <zephyr/kernel.h>
@@ -26,11 +30,15 @@
 #include <rtos/idc.h>
 #include <sof/init.h>
 #include <sof/ipc/common.h>
+#include <sof/lib/memory.h>
 #include <sof/schedule/edf_schedule.h>
 #include <rtos/alloc.h>
 #include <rtos/spinlock.h>
 #include <ipc/topology.h>
 
+#include <errno.h>
+#include <stdbool.h>
+
 /*
  * Inter-CPU communication is only used in
  * - IPC
@@ -100,6 +108,116 @@ static void idc_handler(struct k_p4wq_work *work)
  */
 static struct zephyr_idc_msg idc_work[CONFIG_CORE_COUNT];
 
+/*
+ * Notifications and AMS messages are not waited for and may be sent to a core
+ * faster than it runs them. They are queued to a mailbox of the target core
+ * instead of the work item above, so they do not overwrite each other, and a
+ * single doorbell work item runs all queued messages. The doorbell has a lower
+ * priority than the work item above, so IPC and pipeline trigger messages go
+ * ahead of queued notifications. At most IDC_MAILBOX_SLOTS messages are run
+ * per doorbell before it is queued again behind other work.
+ *
+ * The doorbell work is never submitted by a sender while it runs: senders only
+ * ring it when the mailbox was empty, and alternate between two work items,
+ * the previous one has returned once the other one runs on the single thread.
+ */
+#define IDC_MAILBOX_SLOTS	8
+
+struct zephyr_idc_mailbox {
+	struct k_spinlock lock;
+	struct k_p4wq_work doorbell[2];
+	struct idc_msg msg[IDC_MAILBOX_SLOTS];
+	unsigned int head;	/**< next message to run */
+	unsigned int count;	/**< queued messages */
+	unsigned int ring;	/**< doorbell to submit next */
+	bool pending;		/**< a doorbell is submitted */
+};
+
+static SHARED_DATA struct zephyr_idc_mailbox idc_mailbox[CONFIG_CORE_COUNT];
+
+static struct zephyr_idc_mailbox *idc_mailbox_get(unsigned int core)
+{
+	return platform_shared_get(idc_mailbox + core, sizeof(*idc_mailbox));
+}
+
+static bool idc_msg_is_bulk(const struct idc_msg *msg)
+{
+	return iTS(msg->header) == iTS(IDC_MSG_NOTIFY) || iTS(msg->header) == iTS(IDC_MSG_AMS);
+}
+
+static void idc_mailbox_handler(struct k_p4wq_work *work)
+{
+	struct zephyr_idc_mailbox *mbox = idc_mailbox_get(cpu_get_id());
+	struct idc *idc = *idc_get();
+	struct idc_msg *msg;
+	k_spinlock_key_t key;
+	int i;
+
+	for (i = 0; i < IDC_MAILBOX_SLOTS; i++) {
+		key = k_spin_lock(&mbox->lock);
+		if (!mbox->count) {
+			mbox->pending = false;
+			k_spin_unlock(&mbox->lock, key);
+			return;
+		}
+
+		msg = &mbox->msg[mbox->head];
+		sys_cache_data_invd_range(msg, sizeof(*msg));
+		idc->received_msg.core = msg->core;
+		idc->received_msg.header = msg->header;
+		idc->received_msg.extension = msg->extension;
+		mbox->head = (mbox->head + 1) % IDC_MAILBOX_SLOTS;
+		mbox->count--;
+		k_spin_unlock(&mbox->lock, key);
+
+		idc_cmd(&idc->received_msg);
+	}
+
+	/* more messages are queued, let other work run first */
+	k_p4wq_submit(q_zephyr_idc + cpu_get_id(), work);
+}
+
+static int idc_mailbox_post(struct idc_msg *msg)
+{
+	struct zephyr_idc_mailbox *mbox = idc_mailbox_get(msg->core);
+	struct k_p4wq_work *work = NULL;
+	struct idc_msg *slot;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&mbox->lock);
+	if (mbox->count == IDC_MAILBOX_SLOTS) {
+		k_spin_unlock(&mbox->lock, key);
+		return -EBUSY;
+	}
+
+	slot = &mbox->msg[(mbox->head + mbox->count) % IDC_MAILBOX_SLOTS];
+	slot->header = msg->header;
+	slot->extension = msg->extension;
+	/* Temporarily store sender core ID */
+	slot->core = cpu_get_id();
+	slot->size = 0;
+	slot->payload = NULL;
+	sys_cache_data_flush_range(slot, sizeof(*slot));
+	mbox->count++;
+
+	if (!mbox->pending) {
+		mbox->pending = true;
+		work = &mbox->doorbell[mbox->ring];
+		mbox->ring ^= 1;
+	}
+	k_spin_unlock(&mbox->lock, key);
+
+	if (work) {
+		work->priority = EDF_ZEPHYR_PRIORITY + 1;
+		work->deadline = 0;
+		work->handler = idc_mailbox_handler;
+		work->sync = false;
+		k_p4wq_submit(q_zephyr_idc + msg->core, work);
+	}
+
+	return 0;
+}
+
 int idc_send_msg(struct idc_msg *msg, uint32_t mode)
 {
 	struct idc *idc = *idc_get();
@@ -111,13 +229,16 @@ int idc_send_msg(struct idc_msg *msg, uint32_t mode)
 	int ret;
 	int idc_send_memcpy_err __unused;
 
+	if (mode == IDC_NON_BLOCKING && idc_msg_is_bulk(msg))
+		return idc_mailbox_post(msg);
+
 	idc_send_memcpy_err = memcpy_s(msg_cp, sizeof(*msg_cp), msg, sizeof(*msg));
 	assert(!idc_send_memcpy_err);
 	/* Same priority as the IPC thread which is an EDF task and under Zephyr */
 	work->priority = EDF_ZEPHYR_PRIORITY;
 	work->deadline = 0;
 	work->handler = idc_handler;
-	work->sync = mode == IDC_BLOCKING;
+	work->sync = mode == IDC_BLOCKING || mode == IDC_ASYNC;
 
 	if (msg->payload) {
 		idc_send_memcpy_err = memcpy_s(payload->data, sizeof(payload->data),
@@ -142,6 +263,7 @@ int idc_send_msg(struct idc_msg *msg, uint32_t mode)
 			/* message was sent and executed successfully, get status code */
 			ret = idc_msg_status_get(msg->core);
 		break;
+	case IDC_ASYNC:
 	case IDC_POWER_UP:
 	case IDC_NON_BLOCKING:
 	default:
@@ -151,6 +273,22 @@ int idc_send_msg(struct idc_msg *msg, uint32_t mode)
 	return ret;
 }
 
+/**
+ * \brief Waits for a message sent with IDC_ASYNC to be executed.
+ * \param[in] core Id of the core the message was sent to.
+ * \return Status of the message or error code.
+ */
+int idc_msg_wait(uint32_t core)
+{
+	int ret;
+
+	ret = k_p4wq_wait(&idc_work[core].work, K_FOREVER);
+	if (!ret)
+		ret = idc_msg_status_get(core);
+
+	return ret;
+}
+
 void idc_init_thread(void)
 {
 	int cpu = cpu_get_id();
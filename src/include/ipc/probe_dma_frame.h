@@ -30,7 +30,7 @@ struct probe_data_packet {
  * Audio format from extraction probes is encoded as 32 bit value. Following
  * graphic explains encoding.
  *
- * A|BBBB|CCCC|DDDD|EEEEE|FF|GG|H|I|J|XXXXXXX
+ * A|BBBB|CCCC|DDDD|EEEEE|FF|GG|H|I|J|KKKK|L|XX
  * A - 1 bit - Specifies Type Encoding - 1 for Standard encoding
  * B - 4 bits - Specify Standard Type - 0 for Audio
  * C - 4 bits - Specify Audio format - 0 for PCM
@@ -57,6 +57,11 @@ struct probe_data_packet {
  * H - 1 bit - Specifies Sample Format - 0 for Integer, 1 for Floating point
  * I - 1 bit - Specifies Sample Endianness - 0 for LE
  * J - 1 bit - Specifies Interleaving - 1 for Sample Interleaving
+ * K - 4 bits - Specify Decimation factor minus 1, sample rate D is the rate
+ *		before decimation
+ * L - 1 bit - Specifies Compression - 1 for per channel delta of samples,
+ *	       zigzag mapped and coded as little endian base 128 varints. The
+ *	       delta is reset to 0 at the start of each packet.
  */
 #define PROBE_SHIFT_FMT_TYPE		31
 #define PROBE_SHIFT_STANDARD_TYPE	27
@@ -68,6 +73,8 @@ struct probe_data_packet {
 #define PROBE_SHIFT_SAMPLE_FMT		9
 #define PROBE_SHIFT_SAMPLE_END		8
 #define PROBE_SHIFT_INTERLEAVING_ST	7
+#define PROBE_SHIFT_DECIMATION		3
+#define PROBE_SHIFT_COMPRESSED		2
 
 #define PROBE_MASK_FMT_TYPE		MASK(31, 31)
 #define PROBE_MASK_STANDARD_TYPE	MASK(30, 27)
@@ -79,5 +86,7 @@ struct probe_data_packet {
 #define PROBE_MASK_SAMPLE_FMT		MASK(9, 9)
 #define PROBE_MASK_SAMPLE_END		MASK(8, 8)
 #define PROBE_MASK_INTERLEAVING_ST	MASK(7, 7)
+#define PROBE_MASK_DECIMATION		MASK(6, 3)
+#define PROBE_MASK_COMPRESSED		MASK(2, 2)
 
 #endif
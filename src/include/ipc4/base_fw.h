@@ -288,6 +288,11 @@ enum ipc4_basefw_params {
 
 	/* Use LARGE_CONFIG_SET to change SDW ownership */
 	IPC4_SDW_OWNERSHIP = 31,
+
+	/* SOF extension: use LARGE_CONFIG_SET to set the coalescing window and
+	 * the priority of the resource event notifications.
+	 */
+	IPC4_XRUN_NOTIFICATION_BATCH = 32,
 };
 
 enum ipc4_fw_config_params {
@@ -523,6 +528,60 @@ struct ipc4_global_perf_data {
 	struct ipc4_perf_data_item  perf_items[1];
 } __attribute__((packed, aligned(4)));
 
+struct ipc4_extended_global_perf_data {
+	/* Specifies number of items in perf_items array */
+	uint32_t      perf_item_count;
+	/* Array of module instance performance measurements */
+	struct ipc4_perf_data_item_mi  perf_items[1];
+} __attribute__((packed, aligned(4)));
+
+enum ipc4_telemetry_state_set {
+	IPC4_TELEMETRY_STOPPED = 0,
+	IPC4_TELEMETRY_STARTED = 1,
+};
+
+/* Payload of TELEMETRY_STATE */
+struct ipc4_telemetry_state {
+	/* enum ipc4_telemetry_state_set */
+	uint32_t state;
+	/* Host is notified once the number of unread bytes on any core
+	 * reaches the threshold, 0 disables threshold notifications
+	 */
+	uint32_t threshold;
+	/* Maximum time in ms new telemetry data may wait before the host
+	 * is notified, 0 disables aging timer notifications
+	 */
+	uint32_t aging_timer;
+	/* Optional, mask of enabled static tracepoints, see
+	 * enum sof_tracepoint_id. Tracepoints are disabled when omitted.
+	 */
+	uint32_t tracepoint_mask;
+	/* Optional, PC sampling period in us, 0 or omitted disables the
+	 * sampling profiler
+	 */
+	uint32_t profiler_period_us;
+} __attribute__((packed, aligned(4)));
+
+/* Header of per core data chunk returned by TELEMETRY_DATA */
+struct ipc4_telemetry_data_chunk {
+	/* ID of the core that produced the data */
+	uint32_t core_id;
+	/* Number of records dropped due to buffer overflow */
+	uint32_t overruns;
+	/* Size in bytes of records following this header */
+	uint32_t size;
+} __attribute__((packed, aligned(4)));
+
+/* Payload of XRUN_NOTIFICATION_BATCH */
+struct ipc4_xrun_notification_batch {
+	/* Time in ms resource events are coalesced before they are sent,
+	 * 0 sends each event as soon as the IPC channel is free
+	 */
+	uint32_t window_ms;
+	/* Non zero queues the notifications ahead of the other messages */
+	uint32_t high_priority;
+} __attribute__((packed, aligned(4)));
+
 enum ipc4_low_latency_interrupt_source {
 	IPC4_LOW_POWER_TIMER_INTERRUPT_SOURCE = 1,
 	IPC4_DMA_GATEWAY_INTERRUPT_SOURCE = 2
@@ -122,6 +122,74 @@ union ipc4_rom_info {
 	} platform;
 } __attribute__((packed, aligned(4)));
 
+/*
+ * Linear model of the position of a gateway against the DSP wallclock, fitted
+ * by the FW over its recent DMA position readings. The position in bytes at
+ * wallclock w is position + ((w - wclk) * rate >> 32). The slot is consistent
+ * when seq is even and didn't change while the slot was read.
+ */
+struct ipc4_time_corr_slot {
+	/* gateway node id, 0 for unused slots */
+	uint32_t node_id;
+	/* incremented before and after each update */
+	uint32_t seq;
+	/* wallclock of the reference point */
+	uint64_t wclk;
+	/* fitted position in bytes at the reference point */
+	uint64_t position;
+	/* bytes per wallclock tick, Q32.32, 0 until the first fit */
+	uint64_t rate;
+} __attribute__((packed, aligned(4)));
+
+/* Number of time correlation slots in FW Regs. */
+#define IPC4_MAX_TIME_CORR_SLOTS 16
+
+/* Links the gateway models with the host system time and the LL scheduler. */
+struct ipc4_time_corr_regs {
+	/* wallclock frequency in Hz */
+	uint32_t wclk_freq;
+	/* LL scheduler tick period in wallclock ticks */
+	uint32_t ll_period;
+	/* incremented before and after host_time and dsp_time are updated */
+	uint32_t seq;
+	uint32_t rsvd;
+	/* host system time set with the SYSTEM_TIME parameter */
+	uint64_t host_time;
+	/* wallclock when the host system time was set */
+	uint64_t dsp_time;
+	struct ipc4_time_corr_slot slots[IPC4_MAX_TIME_CORR_SLOTS];
+} __attribute__((packed, aligned(4)));
+
+/*
+ * Positions of a host stream, published by its host copier on every LL tick.
+ * host_posn and dai_posn are the bytes processed by the host and the DAI
+ * gateways of the stream, timestamp is the wallclock of the update. The slot
+ * is consistent when seq is even and didn't change while the slot was read.
+ */
+struct ipc4_stream_posn_slot {
+	/* host gateway node id, 0 for unused slots */
+	uint32_t node_id;
+	/* incremented before and after each update */
+	uint32_t seq;
+	uint64_t host_posn;
+	uint64_t dai_posn;
+	uint64_t timestamp;
+	/* xruns of the DAI pipeline since it was created */
+	uint32_t xrun_count;
+	/* bytes queued in the playback DAI DMA buffer, 0 if not adaptive */
+	uint32_t dai_watermark;
+} __attribute__((packed, aligned(4)));
+
+/* Number of stream position slots in FW Regs. */
+#define IPC4_MAX_STREAM_POSN_SLOTS 16
+
+struct ipc4_stream_posn_regs {
+	/* wallclock frequency in Hz */
+	uint32_t wclk_freq;
+	uint32_t rsvd;
+	struct ipc4_stream_posn_slot slots[IPC4_MAX_STREAM_POSN_SLOTS];
+} __attribute__((packed, aligned(4)));
+
 /* Number of dsp core supported in FW Regs. */
 #define IPC4_MAX_SUPPORTED_ADSP_CORES 8
 
@@ -183,6 +251,12 @@ struct ipc4_fw_registers {
 
 	/* LLP Readings for EVAD gateway. */
 	struct ipc4_llp_reading_slot llp_evad_reading_slot;
+
+	/* Gateway position models, see struct ipc4_time_corr_slot. */
+	struct ipc4_time_corr_regs time_corr;
+
+	/* Host stream positions, see struct ipc4_stream_posn_slot. */
+	struct ipc4_stream_posn_regs stream_posn;
 } __attribute__((packed, aligned(4)));
 
 #endif
@@ -87,7 +87,9 @@ enum ipc4_message_type {
 	SOF_IPC4_GLB_INTERNAL_MESSAGE = 26,
 	/**< Notification (FW to SW driver) */
 	SOF_IPC4_GLB_NOTIFICATION = 27,
-	/* GAP HERE- DO NOT USE - size 3 (28 .. 30)  */
+	/**< Batch of requests executed with a single reply */
+	SOF_IPC4_GLB_BATCH = 28,
+	/* GAP HERE- DO NOT USE - size 2 (29 .. 30)  */
 
 	/**< Maximum message number */
 	SOF_IPC4_GLB_MAX_IXC_MESSAGE_TYPE = 31
@@ -171,6 +173,36 @@ struct ipc4_message_reply {
 	} extension;
 } __attribute((packed, aligned(4)));
 
+/**
+ * struct ipc4_batch_entry - a single request of SOF_IPC4_GLB_BATCH
+ * @msg: primary and extension words of the request
+ * @payload_size: size in bytes of the request payload following the entry,
+ *		  rounded up to a multiple of 4 bytes in the batch
+ *
+ * Supported requests are SOF_IPC4_GLB_CREATE_PIPELINE,
+ * SOF_IPC4_GLB_SET_PIPELINE_STATE for a single pipeline, SOF_IPC4_MOD_INIT_INSTANCE
+ * with the init payload and SOF_IPC4_MOD_BIND. All created modules and
+ * pipelines must be located on the primary core.
+ */
+struct ipc4_batch_entry {
+	struct ipc4_message_request msg;
+	uint32_t payload_size;
+	uint32_t payload[];
+} __attribute((packed, aligned(4)));
+
+/**
+ * struct ipc4_batch - SOF_IPC4_GLB_BATCH mailbox payload
+ * @count: number of entries
+ * @entries: entries, each followed by its payload
+ *
+ * Entries are executed in order, execution stops at the first failure. The
+ * extension of the reply carries the number of successfully executed entries.
+ */
+struct ipc4_batch {
+	uint32_t count;
+	struct ipc4_batch_entry entries[];
+} __attribute((packed, aligned(4)));
+
 #define SOF_IPC4_SWITCH_CONTROL_PARAM_ID 200
 #define SOF_IPC4_ENUM_CONTROL_PARAM_ID  201
 #define SOF_IPC4_NOTIFY_MODULE_EVENTID_ALSA_MAGIC_VAL ((uint32_t)(0xA15A << 16))
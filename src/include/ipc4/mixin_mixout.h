@@ -125,6 +125,21 @@ struct mix_func_map {
 	mute_func mute_func;			/* mute processing function */
 };
 
+/**
+ * \brief fused mixing function interface, mixes all sources at once with
+ *	  their gains applied, overwriting the sink data
+ */
+typedef void (*fused_mix_func)(struct audio_stream *sink, struct audio_stream **sources,
+			       const uint16_t *gains, int32_t source_count, int32_t samples);
+
+/**
+ * @brief fused mixing functions map.
+ */
+struct mix_fused_func_map {
+	uint16_t frame_fmt;		/* frame format */
+	fused_mix_func fused_func;	/* fused mixing function */
+};
+
 extern const struct mix_func_map mix_func_map[];
 extern const size_t mix_count;
 /**
@@ -161,4 +176,23 @@ static inline mute_func mute_mix_get_processing_function(int fmt)
 	return NULL;
 }
 
+extern const struct mix_fused_func_map mix_fused_func_map[];
+extern const size_t mix_fused_count;
+
+/**
+ * \brief Retrievies fused mixing function.
+ * \param[in] fmt  stream PCM frame format
+ */
+static inline fused_mix_func fused_mix_get_processing_function(int fmt)
+{
+	int i;
+
+	for (i = 0; i < mix_fused_count; i++) {
+		if (fmt == mix_fused_func_map[i].frame_fmt)
+			return mix_fused_func_map[i].fused_func;
+	}
+
+	return NULL;
+}
+
 #endif	/* __SOF_IPC4_MIXIN_MIXOUT_H__ */
@@ -39,6 +39,11 @@
 /* Special large_param_id values */
 #define VENDOR_CONFIG_PARAM 0xFF
 
+/* core_id of pipeline create and module init requests letting the firmware
+ * choose the core, the chosen core is returned in the reply extension
+ */
+#define IPC4_CORE_ANY	0xF
+
 enum sof_ipc4_module_type {
 	SOF_IPC4_MOD_INIT_INSTANCE		= 0,
 	SOF_IPC4_MOD_CONFIG_GET			= 1,
@@ -52,6 +57,8 @@ enum sof_ipc4_module_type {
 	SOF_IPC4_MOD_ENTER_MODULE_RESTORE	= 9,
 	SOF_IPC4_MOD_EXIT_MODULE_RESTORE	= 10,
 	SOF_IPC4_MOD_DELETE_INSTANCE		= 11,
+	/* SOF extension, see struct ipc4_module_clone_instance */
+	SOF_IPC4_MOD_CLONE_INSTANCE		= 12,
 };
 
 /*
@@ -168,6 +175,51 @@ struct ipc4_module_init_instance {
  */
 } __attribute__((packed, aligned(4)));
 
+/*
+ * Host Driver sends this message to create copies of an existing module
+ * instance. Each copy is initialized with the init request of the template
+ * instance, kept by the firmware, and runs on the core of the template. The
+ * mailbox holds extension.r.count struct ipc4_module_clone_dst entries. On
+ * an error the copies created before the failing one are kept.
+ */
+struct ipc4_module_clone_dst {
+	uint8_t instance_id;		/**< instance id of the copy */
+	uint8_t ppl_instance_id;	/**< parent pipeline of the copy */
+	uint16_t rsvd;
+} __attribute__((packed, aligned(4)));
+
+struct ipc4_module_clone_instance {
+
+	union {
+		uint32_t dat;
+
+		struct {
+			/**< module id */
+			uint32_t module_id          : 16;
+			/**< instance id of the template */
+			uint32_t instance_id        : 8;
+			/**< ModuleMsg::CLONE_INSTANCE */
+			uint32_t type               : 5;
+			/**< Msg::MSG_REQUEST */
+			uint32_t rsp                : 1;
+			/**< Msg::MODULE_MSG */
+			uint32_t msg_tgt            : 1;
+			uint32_t _reserved_0        : 1;
+		} r;
+	} primary;
+
+	union {
+		uint32_t dat;
+
+		struct {
+			/**< number of copies */
+			uint32_t count              : 8;
+			uint32_t _reserved_1        : 22;
+			uint32_t _hw_reserved_2     : 2;
+		} r;
+	} extension;
+} __attribute__((packed, aligned(4)));
+
 /*!
   SW Driver sends Bind IPC message to connect two module instances together
   creating data processing path between them.
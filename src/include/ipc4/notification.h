@@ -41,6 +41,8 @@ enum sof_ipc4_notification_type {
 	SOF_IPC4_PROBE_DATA_AVAILABLE		= 14,
 	SOF_IPC4_WATCHDOG_TIMEOUT		= 15,
 	SOF_IPC4_MANAGEMENT_SERVICE		= 16,
+	/* SOF extension: coalesced resource events, ipc4_resource_event_list_notification */
+	SOF_IPC4_NOTIFY_RESOURCE_EVENT_LIST	= 17,
 };
 
 /**
@@ -88,6 +90,10 @@ enum sof_ipc4_resource_event_type {
 	SOF_IPC4_SNDW_DEBUG_INFO		= 18,
 	/* Invalid type */
 	SOF_IPC4_INVALID_RESORUCE_EVENT_TYPE	= 19,
+	/* SOF extension: background init of a module instance completed, event_data.dws[0]
+	 * is the IPC4 status of the init and dws[1] the number of queued binds that failed
+	 */
+	SOF_IPC4_MODULE_INIT_DONE		= 32,
 };
 
 /* Resource Type - source of the event */
@@ -255,3 +261,46 @@ struct ipc4_resource_event_data_notification {
 	/* Detailed event data */
 	union ipc4_resource_event_data event_data;
 } __packed __aligned(8);
+
+/**
+ * \brief Resource event coalesced in a SOF_IPC4_NOTIFY_RESOURCE_EVENT_LIST
+ * notification, count is the number of times it fired in the window.
+ */
+struct ipc4_resource_event_list_entry {
+	uint32_t resource_type;
+	uint32_t resource_id;
+	uint32_t event_type;
+	uint32_t count;
+} __packed __aligned(4);
+
+struct ipc4_resource_event_list_notification {
+	/* Number of entries in events[] */
+	uint32_t num_events;
+	/* Events not listed because the list was full */
+	uint32_t dropped;
+	struct ipc4_resource_event_list_entry events[];
+} __packed __aligned(4);
+
+struct ipc_msg;
+
+#if CONFIG_XRUN_NOTIFICATIONS_ENABLE
+void xrun_notif_msg_init(struct ipc_msg *msg_xrun, uint32_t resource_id, uint32_t event_type);
+#endif
+
+#if CONFIG_XRUN_NOTIFICATIONS_BATCH
+/**
+ * \brief Reports a resource event. Events of a window are counted per
+ * resource and sent as one notification at the end of the window, a window
+ * with a single event sends the plain resource event notification.
+ */
+void xrun_notif_batch_event(uint32_t resource_type, uint32_t resource_id, uint32_t event_type);
+
+/**
+ * \brief Handles XRUN_NOTIFICATION_BATCH set request.
+ */
+int xrun_notif_batch_set_config(const char *data, uint32_t size);
+
+int xrun_notif_batch_init(void);
+#else
+static inline int xrun_notif_batch_init(void) { return 0; }
+#endif
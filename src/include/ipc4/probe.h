@@ -35,6 +35,12 @@
  */
 #define PROBE_LOGGING_BUFFER_ID		0x01000000
 
+/*
+ * Buffer id used in the probe output stream headers for
+ * recorded IPC messages, the data is struct probe_ipc_record.
+ */
+#define PROBE_IPC_BUFFER_ID		0x02000000
+
 #define PROBE_PURPOSE_EXTRACTION	0
 #define PROBE_PURPOSE_INJECTION		1
 
@@ -46,6 +52,11 @@
 #define IPC4_PROBE_MODULE_INJECTION_DMA_DETACH	  2
 #define IPC4_PROBE_MODULE_PROBE_POINTS_ADD	  3
 #define IPC4_PROBE_MODULE_DISCONNECT_PROBE_POINTS 4
+#define IPC4_PROBE_MODULE_EXTRACTION_OPTIONS	  5
+#define IPC4_PROBE_MODULE_INJECTION_FORMAT	  6
+
+#define PROBE_COMPRESSION_NONE		0
+#define PROBE_COMPRESSION_DELTA		1	/**< per channel delta, zigzag varint coded */
 
 /**
  * Description of probe dma
@@ -80,6 +91,40 @@ struct probe_point {
 				 */
 } __attribute__((packed, aligned(4)));
 
+/**
+ * Extraction data reduction options of a probe point, zero keeps the data unchanged
+ */
+struct probe_extraction_options {
+	probe_point_id_t buffer_id;	/**< ID of buffer to which probe is attached */
+	uint32_t channel_mask;		/**< Channels to be extracted, 0 for all */
+	uint8_t decimation;		/**< Extract every n-th frame, up to 16 */
+	uint8_t sample_bytes;		/**< Most significant bytes of sample kept */
+	uint8_t compression;		/**< PROBE_COMPRESSION_xxx */
+	uint8_t reserved;
+} __attribute__((packed, aligned(4)));
+
+/**
+ * Format of the data sent by the host to an injection DMA, converted to the
+ * format of the probed buffer by the firmware
+ */
+struct probe_injection_format {
+	uint32_t stream_tag;		/**< Node_id associated with the injection DMA */
+	uint8_t channels;		/**< Interleaved channels, 0 for probed buffer format */
+	uint8_t container_bytes;	/**< Bytes of sample container, 2 or 4 */
+	uint8_t valid_bytes;		/**< Most significant bytes of sample used */
+	uint8_t reserved;
+} __attribute__((packed, aligned(4)));
+
+/**
+ * IPC message received by the firmware, recorded in the extraction stream
+ */
+struct probe_ipc_record {
+	uint32_t primary;	/**< primary message word */
+	uint32_t extension;	/**< extension message word */
+	uint32_t payload_size;	/**< bytes of mailbox payload recorded */
+	uint8_t payload[];	/**< start of mailbox payload */
+} __attribute__((packed, aligned(4)));
+
 struct sof_ipc_probe_info_params {
 	uint32_t num_elems;				/**< Count of elements in array */
 	union {
@@ -37,6 +37,8 @@
 #define SRAM_REG_LLP_GPDMA_READING_SLOTS offsetof(struct ipc4_fw_registers, llp_gpdma_reading_slots)
 #define SRAM_REG_LLP_SNDW_READING_SLOTS  offsetof(struct ipc4_fw_registers, llp_sndw_reading_slots)
 #define SRAM_REG_LLP_EVAD_SLOTS          offsetof(struct ipc4_fw_registers, llp_evad_reading_slot)
+#define SRAM_REG_TIME_CORR               offsetof(struct ipc4_fw_registers, time_corr)
+#define SRAM_REG_STREAM_POSN             offsetof(struct ipc4_fw_registers, stream_posn)
 #define SRAM_REG_FW_END                  sizeof(struct ipc4_fw_registers)
 #else /* CONFIG_IPC_MAJOR_4 */
 #define SRAM_REG_ROM_STATUS			0x0
@@ -14,6 +14,7 @@
 #ifndef __SOF_AUDIO_AUDIO_STREAM_H__
 #define __SOF_AUDIO_AUDIO_STREAM_H__
 
+#include <sof/audio/block_copy.h>
 #include <sof/audio/format.h>
 #include <sof/audio/sink_api.h>
 #include <sof/audio/sink_api_implementation.h>
@@ -26,6 +27,9 @@
 #include <rtos/cache.h>
 #include <ipc/stream.h>
 #include <ipc4/base-config.h>
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+#include <rtos/interrupt.h>
+#endif
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -88,17 +92,24 @@ struct sof_audio_stream_params {
  * Audio stream implements pipeline2.0 sink and source API
  */
 struct audio_stream {
-	struct sof_source source_api;	/**< source API, don't modify, use helper functions only */
-	struct sof_sink sink_api;	/**< sink API, don't modify, use helper functions only  */
-
-	/* runtime data */
-	uint32_t size;	/**< Runtime buffer size in bytes (period multiple) */
-	uint32_t avail;	/**< Available bytes for reading */
-	uint32_t free;	/**< Free bytes for writing */
+	/* runtime data, updated on every produce/consume, kept first and together */
 	void *w_ptr;	/**< Buffer write pointer */
 	void *r_ptr;	/**< Buffer read position */
+	uint32_t avail;	/**< Available bytes for reading */
+	uint32_t free;	/**< Free bytes for writing */
 	void *addr;	/**< Buffer base address */
 	void *end_addr;	/**< Buffer end address */
+	uint32_t size;	/**< Runtime buffer size in bytes (period multiple) */
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	bool cross_domain;	/**< the ends run in LL domains preempting each other */
+#endif
+#if CONFIG_MODULE_SILENCE_SKIP
+	uint32_t silence;	/**< bytes of digital silence last produced */
+	bool silent_next;	/**< the next produce writes silence */
+#endif
+
+	struct sof_source source_api;	/**< source API, don't modify, use helper functions only */
+	struct sof_sink sink_api;	/**< sink API, don't modify, use helper functions only  */
 
 	/* runtime stream params */
 	struct sof_audio_stream_params runtime_stream_params;
@@ -686,9 +697,22 @@ audio_stream_avail_frames_aligned(const struct audio_stream *source,
  */
 static inline void audio_stream_produce(struct audio_stream *buffer, uint32_t bytes)
 {
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	uint32_t flags = 0;
+
+	/* the consumer must not preempt the update, nor be preempted in its own */
+	if (buffer->cross_domain)
+		irq_local_disable(flags);
+#endif
+
 	buffer->w_ptr = audio_stream_wrap(buffer,
 					  (char *)buffer->w_ptr + bytes);
 
+#if CONFIG_MODULE_SILENCE_SKIP
+	buffer->silence = buffer->silent_next ? MIN(buffer->silence + bytes, buffer->size) : 0;
+	buffer->silent_next = false;
+#endif
+
 	/* "overwrite" old data in circular wrap case */
 	if (bytes > audio_stream_get_free_bytes(buffer))
 		buffer->r_ptr = buffer->w_ptr;
@@ -704,6 +728,11 @@ static inline void audio_stream_produce(struct audio_stream *buffer, uint32_t by
 
 	/* calculate free bytes */
 	buffer->free = buffer->size - buffer->avail;
+
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	if (buffer->cross_domain)
+		irq_local_enable(flags);
+#endif
 }
 
 /**
@@ -713,6 +742,13 @@ static inline void audio_stream_produce(struct audio_stream *buffer, uint32_t by
  */
 static inline void audio_stream_consume(struct audio_stream *buffer, uint32_t bytes)
 {
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	uint32_t flags = 0;
+
+	if (buffer->cross_domain)
+		irq_local_disable(flags);
+#endif
+
 	buffer->r_ptr = audio_stream_wrap(buffer,
 					  (char *)buffer->r_ptr + bytes);
 
@@ -727,6 +763,11 @@ static inline void audio_stream_consume(struct audio_stream *buffer, uint32_t by
 
 	/* calculate free bytes */
 	buffer->free = buffer->size - buffer->avail;
+
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	if (buffer->cross_domain)
+		irq_local_enable(flags);
+#endif
 }
 
 /**
@@ -744,8 +785,38 @@ static inline void audio_stream_reset(struct audio_stream *buffer)
 
 	/* there are no avail samples at reset */
 	buffer->avail = 0;
+
+#if CONFIG_MODULE_SILENCE_SKIP
+	buffer->silence = 0;
+	buffer->silent_next = false;
+#endif
 }
 
+#if CONFIG_MODULE_SILENCE_SKIP
+/**
+ * Marks the data of the next audio_stream_produce() as digital silence,
+ * e.g. after audio_stream_set_zero().
+ * @param buffer Buffer.
+ */
+static inline void audio_stream_mark_silent(struct audio_stream *buffer)
+{
+	buffer->silent_next = true;
+}
+
+/**
+ * Checks whether all the available data is digital silence.
+ * @param buffer Buffer.
+ * @return true if there is data and all of it was produced as silence.
+ */
+static inline bool audio_stream_is_silent(const struct audio_stream *buffer)
+{
+	return buffer->avail && buffer->silence >= buffer->avail;
+}
+#else
+static inline void audio_stream_mark_silent(struct audio_stream *buffer) { }
+static inline bool audio_stream_is_silent(const struct audio_stream *buffer) { return false; }
+#endif
+
 /**
  * Initializes the buffer with specified memory block and size.
  * @param audio_stream the audio_stream a to initialize.
@@ -1015,9 +1086,9 @@ static inline int audio_stream_set_zero(struct audio_stream *buffer, uint32_t by
 		tail_size = bytes - head_size;
 	}
 
-	memset(buffer->w_ptr, 0, head_size);
+	audio_block_zero(buffer->w_ptr, head_size);
 	if (tail_size)
-		memset(buffer->addr, 0, tail_size);
+		audio_block_zero(buffer->addr, tail_size);
 
 	return 0;
 }
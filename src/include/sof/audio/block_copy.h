@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_AUDIO_BLOCK_COPY_H__
+#define __SOF_AUDIO_BLOCK_COPY_H__
+
+#include <rtos/string.h>
+#include <stddef.h>
+
+/* Select optimized code variant when xt-xcc compiler is used */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 || XCHAL_HAVE_HIFI4
+#define BLOCK_COPY_HIFI3	1
+#else
+#define BLOCK_COPY_HIFI3	0
+#endif
+#else
+/* GCC */
+#define BLOCK_COPY_HIFI3	0
+#endif
+
+#if BLOCK_COPY_HIFI3
+
+/**
+ * \brief Copies a block of samples between buffers that do not overlap,
+ *	  64 bits at a time. Blocks not 16 bit aligned are left to memcpy().
+ * \param[out] dst Destination.
+ * \param[in] src Source.
+ * \param[in] bytes Number of bytes.
+ */
+void audio_block_copy(void *dst, const void *src, size_t bytes);
+
+/**
+ * \brief Zeroes a block of samples, 64 bits at a time.
+ * \param[out] dst Destination.
+ * \param[in] bytes Number of bytes.
+ */
+void audio_block_zero(void *dst, size_t bytes);
+
+#else
+
+static inline void audio_block_copy(void *dst, const void *src, size_t bytes)
+{
+	memcpy(dst, src, bytes);
+}
+
+static inline void audio_block_zero(void *dst, size_t bytes)
+{
+	memset(dst, 0, bytes);
+}
+
+#endif /* BLOCK_COPY_HIFI3 */
+
+#endif /* __SOF_AUDIO_BLOCK_COPY_H__ */
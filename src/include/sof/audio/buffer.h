@@ -32,6 +32,7 @@
 #include <stdint.h>
 
 struct comp_dev;
+struct dp_queue;
 
 /** \name Trace macros
  *  @{
@@ -109,6 +110,7 @@ extern struct tr_ctx buffer_tr;
 /* buffer callback types */
 #define BUFF_CB_TYPE_PRODUCE	BIT(0)
 #define BUFF_CB_TYPE_CONSUME	BIT(1)
+#define BUFF_CB_TYPE_COALESCE	BIT(2)	/* one produce callback per LL tick */
 
 #define BUFFER_UPDATE_IF_UNSET	0
 #define BUFFER_UPDATE_FORCE	1
@@ -133,18 +135,27 @@ extern struct tr_ctx buffer_tr;
  * 5) write back cached data and release lock using uncache pointer.
  */
 struct comp_buffer {
-	/* data buffer */
-	CORE_CHECK_STRUCT_FIELD;
-
+	/*
+	 * data buffer, accessed on every copy: kept at the start of the cache
+	 * line aligned object, so that the cold configuration below does not
+	 * share cache lines with it
+	 */
 	struct audio_stream stream;
+	bool is_shared;			/* buffer structure is shared between 2 cores */
+	uint8_t notify_mask;		/* BUFF_CB_TYPE_* events with listeners */
+#if CONFIG_BUFFER_NOTIFY_COALESCE
+	void *notify_begin;		/* start of the produced data not yet notified */
+	uint32_t notify_bytes;		/* amount of produced data not yet notified */
+#endif
 
 	/* configuration */
-	uint32_t id;
+	uint32_t __aligned(PLATFORM_DCACHE_ALIGN) id;
 	uint32_t pipeline_id;
 	uint32_t caps;
 	uint32_t core;
 	struct tr_ctx tctx;			/* trace settings */
-	bool is_shared;			/* buffer structure is shared between 2 cores */
+
+	CORE_CHECK_STRUCT_FIELD;
 
 	/* connected components */
 	struct comp_dev *source;	/* source component */
@@ -159,6 +170,19 @@ struct comp_buffer {
 
 	bool hw_params_configured; /**< indicates whether hw params were set */
 	bool walking;		/**< indicates if the buffer is being walked */
+	bool borrowed;		/**< stream data is owned elsewhere, never freed or moved */
+
+#if CONFIG_ZEPHYR_DP_SCHEDULER_DIRECT_QUEUES
+	/* queue of the DP module at one end, used by the LL module at the other end */
+	struct dp_queue *dp_queue;
+#endif
+
+#if CONFIG_PIPELINE_PARAMS_CACHE
+	/* DAI hw params resolved beyond the buffer, valid while its far end runs */
+	struct sof_ipc_stream_params hw_params_cache;
+	bool hw_params_cached;	/**< indicates whether hw_params_cache is valid */
+	bool hw_params_cache_found;	/**< a DAI was found beyond the buffer */
+#endif
 };
 
 /* Only to be used for synchronous same-core notifications! */
@@ -196,6 +220,40 @@ int buffer_set_size(struct comp_buffer *buffer, uint32_t size, uint32_t alignmen
 void buffer_free(struct comp_buffer *buffer);
 void buffer_zero(struct comp_buffer *buffer);
 
+#if CONFIG_IPC4_DEFERRED_FREE
+/**
+ * \brief Turns a freed but not yet released buffer into a new one.
+ * @param buffer Disconnected buffer, not shared between cores.
+ * @param flags SOF_BUF_ flags of the new buffer.
+ *
+ * The data memory, size and caps are kept, everything else is set as by
+ * buffer_alloc().
+ */
+void buffer_reuse(struct comp_buffer *buffer, uint32_t flags);
+#endif
+
+#if CONFIG_BUFFER_COMPACTION
+/**
+ * \brief Moves the data of a buffer to a lower free block of the heap.
+ * @param buffer Buffer, its source and sink must not be running.
+ * @return Bytes moved, 0 when no lower block was found.
+ */
+uint32_t buffer_relocate(struct comp_buffer *buffer);
+#endif
+
+/*
+ * Enable buffer notifications for the BUFF_CB_TYPE_* events in mask. The
+ * update calls skip the notifier completely for events nobody subscribed to.
+ * With BUFF_CB_TYPE_COALESCE and CONFIG_BUFFER_NOTIFY_COALESCE the produce
+ * updates of one LL tick are delivered as a single transaction. Listeners
+ * that modify the produced data in place must not ask for it, subscribing
+ * to BUFF_CB_TYPE_PRODUCE without it turns coalescing off.
+ */
+void buffer_notify_subscribe(struct comp_buffer *buffer, uint32_t mask);
+
+/* disable buffer notifications for the BUFF_CB_TYPE_* events in mask */
+void buffer_notify_unsubscribe(struct comp_buffer *buffer, uint32_t mask);
+
 /* called by a component after producing data into this buffer */
 void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes);
 
@@ -247,6 +305,9 @@ static inline void buffer_reset_pos(struct comp_buffer *buffer, void *data)
 {
 	/* reset rw pointers and avail/free bytes counters */
 	audio_stream_reset(&buffer->stream);
+#if CONFIG_BUFFER_NOTIFY_COALESCE
+	buffer->notify_bytes = 0;
+#endif
 
 	/* clear buffer contents */
 	buffer_zero(buffer);
@@ -260,11 +321,17 @@ static inline void buffer_init(struct comp_buffer *buffer,
 
 	/* addr should be set in alloc function */
 	audio_stream_init(&buffer->stream, buffer->stream.addr, size);
+#if CONFIG_BUFFER_NOTIFY_COALESCE
+	buffer->notify_bytes = 0;
+#endif
 }
 
 static inline void buffer_reset_params(struct comp_buffer *buffer, void *data)
 {
 	buffer->hw_params_configured = false;
+#if CONFIG_PIPELINE_PARAMS_CACHE
+	buffer->hw_params_cached = false;
+#endif
 }
 
 #endif /* __SOF_AUDIO_BUFFER_H__ */
@@ -9,9 +9,30 @@
 #define __SOF_AUDIO_CHANNEL_MAP_H__
 
 #include <ipc/channel_map.h>
+#include <ipc/stream.h>
 #include <sof/common.h>
+#include <sof/platform.h>
+#include <stdbool.h>
 #include <stdint.h>
 
+/* Select optimized code variant when xt-xcc compiler is used */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define CHMAP_REMAP_GENERIC	0
+#define CHMAP_REMAP_HIFI3	1
+#else
+#define CHMAP_REMAP_GENERIC	1
+#define CHMAP_REMAP_HIFI3	0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define CHMAP_REMAP_GENERIC	1
+#define CHMAP_REMAP_HIFI3	0
+#endif /* __XCC__ */
+
+struct audio_stream;
+
 /* Returns the size of a channel map in bytes */
 static inline uint32_t chmap_get_size(struct sof_ipc_channel_map *chmap)
 {
@@ -23,4 +44,174 @@ static inline uint32_t chmap_get_size(struct sof_ipc_channel_map *chmap)
 struct sof_ipc_channel_map *chmap_get(struct sof_ipc_stream_map *smap,
 				      int index);
 
+/* The channel remap gains are Q2.30 */
+#define CHMAP_REMAP_GAIN_SHIFT	30
+#define CHMAP_REMAP_GAIN_UNITY	(1 << CHMAP_REMAP_GAIN_SHIFT)
+
+#define CHMAP_REMAP_MAX_TERMS	(PLATFORM_MAX_CHANNELS * PLATFORM_MAX_CHANNELS)
+
+/* Kernel classes of a compiled channel remap */
+enum chmap_remap_kind {
+	CHMAP_REMAP_NONE = 0,	/* no output channel is written */
+	CHMAP_REMAP_SHUFFLE,	/* every written output is a copy of one input */
+	CHMAP_REMAP_GAIN,	/* every written output is one input with a gain */
+	CHMAP_REMAP_MATRIX,	/* written outputs are gain weighted input sums */
+};
+
+struct chmap_remap;
+
+/* Processes frames of linear interleaved data with a compiled remap */
+typedef void (*chmap_remap_func)(const struct chmap_remap *remap,
+				 const void *src, void *dst, uint32_t frames);
+
+/* One input channel to output channel route with a Q2.30 gain */
+struct chmap_remap_term {
+	uint8_t in_ch;
+	uint8_t out_ch;
+	uint16_t reserved;
+	int32_t gain;
+};
+
+/*
+ * Table driven channel routing shared by the components that shuffle or
+ * mix channels. The routes are added with chmap_remap_route() or
+ * chmap_remap_mix() and compiled with chmap_remap_compile() once the
+ * formats and channel counts are known, typically in prepare(). The
+ * compile selects the cheapest kernel for the routing: a plain copy, a
+ * pure shuffle, a shuffle with gains or a sparse matrix. The output
+ * channels without a route are not written.
+ */
+struct chmap_remap {
+	uint32_t num_terms;	/* number of configured routes */
+	struct chmap_remap_term terms[CHMAP_REMAP_MAX_TERMS];
+
+	/* set by chmap_remap_compile(), the active terms are first in
+	 * terms[] and sorted by the output channel
+	 */
+	enum chmap_remap_kind kind;
+	enum sof_ipc_frame in_fmt;
+	enum sof_ipc_frame out_fmt;
+	uint32_t in_channels;
+	uint32_t out_channels;
+	uint32_t num_outs;	/* number of written output channels */
+	uint8_t out_ch[PLATFORM_MAX_CHANNELS];	/* written output channels */
+	uint8_t out_terms[PLATFORM_MAX_CHANNELS]; /* terms per written output */
+	chmap_remap_func func;	/* NULL until compiled */
+};
+
+/* Removes all routes */
+void chmap_remap_reset(struct chmap_remap *remap);
+
+/* Routes an input channel to an output channel, replacing an earlier route
+ * to the same output channel.
+ */
+int chmap_remap_route(struct chmap_remap *remap, uint32_t in_ch, uint32_t out_ch);
+
+/* Adds an input channel with a Q2.30 gain to the sum of an output channel */
+int chmap_remap_mix(struct chmap_remap *remap, uint32_t in_ch, uint32_t out_ch,
+		    int32_t gain);
+
+/* Compiles the routes for the formats and channel counts. The routes to or
+ * from channels beyond the channel counts are ignored. Compiling again with
+ * the same parameters is cheap.
+ */
+int chmap_remap_compile(struct chmap_remap *remap, enum sof_ipc_frame in_fmt,
+			enum sof_ipc_frame out_fmt, uint32_t in_channels,
+			uint32_t out_channels);
+
+/* Remaps frames from the read pointer of source to the write pointer of
+ * sink. The caller consumes and produces the frames.
+ */
+void chmap_remap_process(const struct chmap_remap *remap,
+			 const struct audio_stream *source,
+			 struct audio_stream *sink, uint32_t frames);
+
+/* Remaps frames of linear interleaved data */
+static inline void chmap_remap_linear(const struct chmap_remap *remap,
+				      const void *src, void *dst, uint32_t frames)
+{
+	if (remap->num_outs)
+		remap->func(remap, src, dst, frames);
+}
+
+/* Kernels, see channel_map_generic.c and channel_map_hifi3.c */
+void chmap_remap_copy(const struct chmap_remap *remap, const void *src, void *dst,
+		      uint32_t frames);
+void chmap_remap_shuffle_s16(const struct chmap_remap *remap, const void *src, void *dst,
+			     uint32_t frames);
+void chmap_remap_shuffle_s32(const struct chmap_remap *remap, const void *src, void *dst,
+			     uint32_t frames);
+void chmap_remap_shuffle_s16_s32(const struct chmap_remap *remap, const void *src,
+				 void *dst, uint32_t frames);
+void chmap_remap_gain_s16(const struct chmap_remap *remap, const void *src, void *dst,
+			  uint32_t frames);
+void chmap_remap_gain_s24(const struct chmap_remap *remap, const void *src, void *dst,
+			  uint32_t frames);
+void chmap_remap_gain_s32(const struct chmap_remap *remap, const void *src, void *dst,
+			  uint32_t frames);
+void chmap_remap_matrix_s16(const struct chmap_remap *remap, const void *src, void *dst,
+			    uint32_t frames);
+void chmap_remap_matrix_s24(const struct chmap_remap *remap, const void *src, void *dst,
+			    uint32_t frames);
+void chmap_remap_matrix_s32(const struct chmap_remap *remap, const void *src, void *dst,
+			    uint32_t frames);
+void chmap_remap_matrix_s16_s32(const struct chmap_remap *remap, const void *src,
+				void *dst, uint32_t frames);
+
+#define CHMAP_SPLIT_MAX_PARTS	PLATFORM_MAX_CHANNELS
+
+struct chmap_split;
+
+/* Moves frames of linear data between the interleaved and the part buffers */
+typedef void (*chmap_split_func)(const struct chmap_split *split, void *inter,
+				 void **parts, uint32_t frames);
+
+/*
+ * Split of one interleaved stream into several part streams, like the
+ * gateways of an aggregated DAI, and the merge of the parts back, done in a
+ * single pass over the frames. Every channel of a part is one channel of the
+ * interleaved stream. chmap_split_compile() selects the kernels, parts taking
+ * consecutive channel pairs of the interleaved stream in order, like two or
+ * four stereo gateways or two four channel gateways, get kernels moving a
+ * channel pair at a time.
+ */
+struct chmap_split {
+	enum sof_ipc_frame fmt;
+	uint32_t channels;	/* channels of the interleaved stream */
+	uint32_t num_parts;
+	uint8_t part_channels[CHMAP_SPLIT_MAX_PARTS];
+	/* interleaved stream channel of each part channel, part by part */
+	uint8_t map[PLATFORM_MAX_CHANNELS];
+	chmap_split_func split;	/* interleaved to parts, NULL until compiled */
+	chmap_split_func merge;	/* parts to interleaved */
+};
+
+/* Compiles the split for the format and channel counts. map has the
+ * interleaved stream channels of all part channels, part by part.
+ */
+int chmap_split_compile(struct chmap_split *split, enum sof_ipc_frame fmt,
+			uint32_t channels, uint32_t num_parts,
+			const uint32_t *part_channels, const uint8_t *map);
+
+/* Splits frames from the read pointer of inter to the write pointers of the
+ * parts or with merge set, merges frames from the read pointers of the parts
+ * to the write pointer of inter. The caller consumes and produces the frames.
+ */
+void chmap_split_process(const struct chmap_split *split, struct audio_stream *inter,
+			 struct audio_stream **parts, uint32_t frames, bool merge);
+
+/* Split kernels, see channel_map_generic.c and channel_map_hifi3.c */
+void chmap_split_s16(const struct chmap_split *split, void *inter, void **parts,
+		     uint32_t frames);
+void chmap_split_s32(const struct chmap_split *split, void *inter, void **parts,
+		     uint32_t frames);
+void chmap_merge_s16(const struct chmap_split *split, void *inter, void **parts,
+		     uint32_t frames);
+void chmap_merge_s32(const struct chmap_split *split, void *inter, void **parts,
+		     uint32_t frames);
+void chmap_split_pairs_s32(const struct chmap_split *split, void *inter, void **parts,
+			   uint32_t frames);
+void chmap_merge_pairs_s32(const struct chmap_split *split, void *inter, void **parts,
+			   uint32_t frames);
+
 #endif /* __SOF_AUDIO_CHANNEL_MAP_H__ */
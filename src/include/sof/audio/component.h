@@ -178,6 +178,33 @@ enum {
 #define comp_err(comp_p, __e, ...) LOG_ERR(__COMP_FMT __e, trace_comp_get_id(comp_p), \
 					   trace_comp_get_subid(comp_p), ##__VA_ARGS__)
 
+#if CONFIG_SOF_LOG_RATELIMIT
+struct comp_dev;
+
+/**
+ * \brief Takes a token of the log rate limit of the component.
+ * @param dev Component device.
+ * @return true if the message is to be logged.
+ */
+bool comp_log_allowed(struct comp_dev *dev);
+
+/* errors are never limited, the level check keeps disabled levels free */
+#define __comp_log_limited(log_macro, level, comp_p, __e, ...)			\
+	do {									\
+		if (Z_LOG_CONST_LEVEL_CHECK(level) && comp_log_allowed(comp_p))	\
+			log_macro(__COMP_FMT __e, trace_comp_get_id(comp_p),	\
+				  trace_comp_get_subid(comp_p), ##__VA_ARGS__);	\
+	} while (0)
+
+#define comp_warn(comp_p, __e, ...) \
+	__comp_log_limited(LOG_WRN, LOG_LEVEL_WRN, comp_p, __e, ##__VA_ARGS__)
+
+#define comp_info(comp_p, __e, ...) \
+	__comp_log_limited(LOG_INF, LOG_LEVEL_INF, comp_p, __e, ##__VA_ARGS__)
+
+#define comp_dbg(comp_p, __e, ...) \
+	__comp_log_limited(LOG_DBG, LOG_LEVEL_DBG, comp_p, __e, ##__VA_ARGS__)
+#else
 #define comp_warn(comp_p, __e, ...) LOG_WRN(__COMP_FMT __e, trace_comp_get_id(comp_p), \
 					    trace_comp_get_subid(comp_p), ##__VA_ARGS__)
 
@@ -186,6 +213,7 @@ enum {
 
 #define comp_dbg(comp_p, __e, ...) LOG_DBG(__COMP_FMT __e, trace_comp_get_id(comp_p), \
 					   trace_comp_get_subid(comp_p), ##__VA_ARGS__)
+#endif /* CONFIG_SOF_LOG_RATELIMIT */
 
 #else
 /* class (driver) level (no device object) tracing */
@@ -564,6 +592,15 @@ struct comp_ipc_config {
 #endif
 };
 
+#if CONFIG_SOF_LOG_RATELIMIT
+/** \brief Token bucket limiting the warning, info and debug logs of a component. */
+struct comp_log_ratelimit {
+	uint32_t stamp;		/**< cycle count of the last refill */
+	uint16_t tokens;	/**< messages that may be logged now */
+	uint16_t suppressed;	/**< messages dropped since the last logged one */
+};
+#endif
+
 /**
  * Audio component base device "class"
  * - used by other component types.
@@ -610,6 +647,10 @@ struct comp_dev {
 #if CONFIG_PERFORMANCE_COUNTERS
 	struct perf_cnt_data pcd;
 #endif
+
+#if CONFIG_SOF_LOG_RATELIMIT
+	struct comp_log_ratelimit log_rl;	/**< log rate limit state */
+#endif
 };
 
 /** @}*/
@@ -721,10 +762,13 @@ void sys_comp_module_dts_interface_init(void);
 void sys_comp_module_eq_fir_interface_init(void);
 void sys_comp_module_eq_iir_interface_init(void);
 void sys_comp_module_google_rtc_audio_processing_interface_init(void);
+void sys_comp_module_igo_nr_interface_init(void);
+void sys_comp_module_loopback_latency_interface_init(void);
 void sys_comp_module_mfcc_interface_init(void);
 void sys_comp_module_mixer_interface_init(void);
 void sys_comp_module_multiband_drc_interface_init(void);
 void sys_comp_module_mux_interface_init(void);
+void sys_comp_module_rtnr_interface_init(void);
 void sys_comp_module_asrc_interface_init(void);
 void sys_comp_module_src_interface_init(void);
 void sys_comp_module_tdfb_interface_init(void);
@@ -759,6 +803,16 @@ int comp_register(struct comp_driver_info *drv);
  */
 void comp_unregister(struct comp_driver_info *drv);
 
+#if CONFIG_COMP_DRIVER_TABLE
+/**
+ * Finds a module adapter driver of the firmware image, these are placed in
+ * the comp_driver iterable section instead of being registered.
+ * @param uuid UUID of the driver.
+ * @return Component driver or NULL if not found.
+ */
+const struct comp_driver *comp_driver_table_get(const uint8_t *uuid);
+#endif
+
 /** @}*/
 
 /**
@@ -43,6 +43,13 @@ struct comp_driver_list {
 struct comp_dev *comp_new(struct sof_ipc_comp *comp);
 #elif CONFIG_IPC_MAJOR_4
 struct comp_dev *comp_new_ipc4(struct ipc4_module_init_instance *module_init);
+/** \brief Creates a component from an init request with its payload at data. */
+struct comp_dev *comp_new_ipc4_data(struct ipc4_module_init_instance *module_init,
+				    const char *data);
+#if CONFIG_IPC4_MODULE_CLONE
+/** \brief Creates the copies of a module instance listed in the mailbox. */
+int comp_clone_ipc4(struct ipc4_module_clone_instance *clone);
+#endif
 #endif
 
 /** See comp_ops::free */
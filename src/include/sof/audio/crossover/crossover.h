@@ -11,8 +11,25 @@
 #include <sof/math/iir_df2t.h>
 #include <sof/platform.h>
 #include <user/crossover.h>
+#include <stdbool.h>
 #include <stdint.h>
 
+/* Select optimized code variant when xt-xcc compiler is used */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define CROSSOVER_GENERIC	0
+#define CROSSOVER_HIFI3		1
+#else
+#define CROSSOVER_GENERIC	1
+#define CROSSOVER_HIFI3		0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define CROSSOVER_GENERIC	1
+#define CROSSOVER_HIFI3		0
+#endif /* __XCC__ */
+
 struct comp_buffer;
 struct comp_dev;
 
@@ -65,6 +82,8 @@ struct crossover_state {
 	/* Store the state for each LR4 filter. */
 	struct iir_state_df2t lowpass[CROSSOVER_MAX_LR4];
 	struct iir_state_df2t highpass[CROSSOVER_MAX_LR4];
+	/* The coefficients are used from the config blob */
+	bool coef_in_place;
 };
 
 struct comp_data;
@@ -75,8 +94,15 @@ typedef void (*crossover_process)(struct comp_data *cd,
 				  int32_t num_sinks,
 				  uint32_t frames);
 
+/*
+ * Bit n of active is set when out[n] has a sink. The filters feeding only
+ * inactive outputs may be skipped, the other out[] values are then undefined.
+ */
 typedef void (*crossover_split)(int32_t in, int32_t out[],
-				struct crossover_state *state);
+				struct crossover_state *state, uint32_t active);
+
+/* Active mask computing all the outputs */
+#define CROSSOVER_ALL_OUTPUTS	0xf
 
 /* Crossover component private data */
 struct comp_data {
@@ -91,6 +117,7 @@ struct comp_data {
 	enum sof_ipc_frame source_format;         /**< source frame format */
 	crossover_process crossover_process;      /**< processing function */
 	crossover_split crossover_split;          /**< split function */
+	uint32_t active_sinks;                    /**< outputs computed in the last period */
 };
 
 struct crossover_proc_fnmap {
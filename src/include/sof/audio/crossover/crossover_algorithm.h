@@ -19,6 +19,6 @@ void crossover_reset_state_ch(struct crossover_state *ch_state);
 /* crossover init function */
 int crossover_init_coef_ch(struct sof_eq_iir_biquad *coef,
 			   struct crossover_state *ch_state,
-			   int32_t num_sinks);
+			   int32_t num_sinks, uint32_t layout);
 
 #endif //  __SOF_AUDIO_CROSSOVER_CROSSOVER_ALGORITHM_H__
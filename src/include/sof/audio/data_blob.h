@@ -140,6 +140,15 @@ struct comp_data_blob_handler *comp_data_blob_handler_new(struct comp_dev *dev)
  */
 void comp_data_blob_handler_free(struct comp_data_blob_handler *blob_handler);
 
+/**
+ * Lets the handler share identical blobs with other handlers on the same
+ * core. The blob returned by comp_get_data_blob() becomes read only, the
+ * component must not modify it. Not available in single blob mode.
+ *
+ * @param blob_handler Data blob handler
+ */
+void comp_data_blob_set_shared(struct comp_data_blob_handler *blob_handler);
+
 /**
  * Add a validator to check that the new data blob is valid for the given component.
  *
@@ -152,4 +161,83 @@ void comp_data_blob_set_validator(struct comp_data_blob_handler *blob_handler,
 				  int (*validator)(struct comp_dev *dev, void *new_data,
 						   uint32_t new_data_size));
 
+/**
+ * Add a preparer to build the component state derived from a new data blob.
+ *
+ * The preparer is called in the IPC context for a fully received and validated
+ * blob that is going to wait until the component picks it up with
+ * comp_get_data_blob() in copy(). It allows the component to do the expensive
+ * setup ahead, leaving only a switch to the prepared state to the audio thread.
+ * The new blob is discarded if the preparer returns an error.
+ *
+ * @param blob_handler Data blob handler
+ * @param preparer Function used to prepare the state for the new data blob
+ */
+void comp_data_blob_set_preparer(struct comp_data_blob_handler *blob_handler,
+				 int (*preparer)(struct comp_dev *dev, void *new_data,
+						 uint32_t new_data_size));
+
+#if CONFIG_COMP_BLOB_DELTA
+/**
+ * Lets the handler accept delta updates, see user/blob_delta.h. A received
+ * delta is applied to a copy of the current blob, the component picks it
+ * up as any new blob and can use comp_data_blob_get_delta() to update its
+ * state incrementally. Not available in single blob mode.
+ *
+ * @param blob_handler Data blob handler
+ */
+void comp_data_blob_set_delta(struct comp_data_blob_handler *blob_handler);
+
+/**
+ * Checks whether the new data blob differs from the current one only in
+ * the given range. Valid from the preparer call until the new blob is
+ * picked up with comp_get_data_blob().
+ *
+ * @param blob_handler Data blob handler
+ * @param offset Pointer to offset of the changed range
+ * @param size Pointer to size of the changed range
+ */
+bool comp_data_blob_get_delta(struct comp_data_blob_handler *blob_handler,
+			      uint32_t *offset, uint32_t *size);
+#else
+static inline void comp_data_blob_set_delta(struct comp_data_blob_handler *blob_handler)
+{
+}
+
+static inline bool comp_data_blob_get_delta(struct comp_data_blob_handler *blob_handler,
+					    uint32_t *offset, uint32_t *size)
+{
+	return false;
+}
+#endif
+
+/**
+ * Checks whether a delta range is within len bytes at start of the blob.
+ *
+ * @param offset Offset of the changed range
+ * @param size Size of the changed range
+ * @param blob Data blob
+ * @param start Start of the area in the blob
+ * @param len Length of the area
+ */
+static inline bool comp_data_blob_delta_within(uint32_t offset, uint32_t size,
+					       const void *blob, const void *start, size_t len)
+{
+	size_t area = (const uint8_t *)start - (const uint8_t *)blob;
+
+	return offset >= area && offset + size <= area + len;
+}
+
+/**
+ * Returns the pointer to the same data in a new blob of identical layout.
+ *
+ * @param ptr Pointer into the old blob
+ * @param old_blob Old data blob
+ * @param new_blob New data blob
+ */
+static inline void *comp_data_blob_rebase(const void *ptr, const void *old_blob, void *new_blob)
+{
+	return (uint8_t *)new_blob + ((const uint8_t *)ptr - (const uint8_t *)old_blob);
+}
+
 #endif /* __SOF_AUDIO_DATA_BLOB_H__ */
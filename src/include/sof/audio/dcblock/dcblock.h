@@ -67,6 +67,7 @@ struct comp_data {
 struct dcblock_func_map {
 	enum sof_ipc_frame src_fmt; /**< source frame format */
 	dcblock_func func; /**< processing function */
+	uint32_t channels; /**< channels of a specialized function, 0 for any */
 };
 
 /** \brief Map of formats with dedicated processing functions. */
@@ -80,13 +81,16 @@ extern const size_t dcblock_fncount;
  *	  the source buffer's frame format.
  * \param src_fmt the frames' format of the source buffer
  */
-static inline dcblock_func dcblock_find_func(enum sof_ipc_frame src_fmt)
+static inline dcblock_func dcblock_find_func(enum sof_ipc_frame src_fmt, uint32_t channels)
 {
 	int i;
 
-	/* Find suitable processing function from map */
+	/* Find suitable processing function from map, the functions for
+	 * a number of channels are listed before the generic ones.
+	 */
 	for (i = 0; i < dcblock_fncount; i++) {
-		if (src_fmt == dcblock_fnmap[i].src_fmt)
+		if (src_fmt == dcblock_fnmap[i].src_fmt &&
+		    (!dcblock_fnmap[i].channels || dcblock_fnmap[i].channels == channels))
 			return dcblock_fnmap[i].func;
 	}
 
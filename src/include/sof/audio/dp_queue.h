@@ -68,6 +68,9 @@
  *    In this case we need to writeback cache when new data arrive and invalidate cache on
  *    secondary core. dp_queue structure is located in shared memory
  *
+ *    With DP_QUEUE_MODE_UNCACHED the data of a shared queue is located in uncached
+ *    memory instead, which costs less than the cache maintenance for short accesses
+ *
  *
  * dpQueue is a lockless consumer/producer safe buffer. It is achieved by having only 2 shared
  * variables:
@@ -104,6 +107,7 @@ struct sof_audio_stream_params;
 /* DP flags */
 #define DP_QUEUE_MODE_LOCAL 0
 #define DP_QUEUE_MODE_SHARED BIT(1)
+#define DP_QUEUE_MODE_UNCACHED BIT(2)	/* with DP_QUEUE_MODE_SHARED only */
 
 /* the dpQueue structure */
 struct dp_queue {
@@ -127,6 +131,10 @@ struct dp_queue {
 	size_t _read_offset;		/* private: to be modified by data consumer using API */
 
 	bool _hw_params_configured;
+
+#if CONFIG_SOF_CACHE_STATS
+	struct cache_stats _cache_stats;	/* cache maintenance of the data */
+#endif
 };
 
 /**
@@ -141,6 +149,16 @@ struct dp_queue {
  */
 struct dp_queue *dp_queue_create(size_t min_available, size_t min_free_space, uint32_t flags);
 
+#if CONFIG_BUFFER_COMPACTION
+/**
+ * @brief move the data of the queue to a lower free block of the heap
+ *	  the modules at both ends of the queue must not be running
+ *
+ * @return bytes moved, 0 when no lower block was found
+ */
+size_t dp_queue_relocate(struct dp_queue *dp_queue);
+#endif
+
 /**
  * @brief remove the queue from the list, free dp queue memory
  */
@@ -197,6 +215,18 @@ bool dp_queue_is_shared(struct dp_queue *dp_queue)
 	return !!(dp_queue->_flags & DP_QUEUE_MODE_SHARED);
 }
 
+#if CONFIG_SOF_CACHE_STATS
+/**
+ * @brief return the cache maintenance counters of the queue data
+ */
+static inline
+const struct cache_stats *dp_queue_get_cache_stats(struct dp_queue *dp_queue)
+{
+	CORE_CHECK_STRUCT(dp_queue);
+	return &dp_queue->_cache_stats;
+}
+#endif
+
 /**
  * @brief append a dp_queue to the list
  */
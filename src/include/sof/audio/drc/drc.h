@@ -32,6 +32,18 @@ struct comp_dev;
 #define DRC_DIVISION_FRAMES 32
 #define DRC_DIVISION_FRAMES_MASK (DRC_DIVISION_FRAMES - 1)
 
+#if CONFIG_DRC_GAIN_CURVE_TABLE
+/* The compression curve table has DRC_GAIN_TABLE_STEPS points per octave of
+ * input level from 2^DRC_GAIN_TABLE_MIN_LOG2 in Q1.31 (about -144 dB) up to
+ * full scale. DRC_GAIN_TABLE_STEPS_LOG2 needs to be at most 7.
+ */
+#define DRC_GAIN_TABLE_MIN_LOG2 7
+#define DRC_GAIN_TABLE_OCTAVES (31 - DRC_GAIN_TABLE_MIN_LOG2)
+#define DRC_GAIN_TABLE_STEPS_LOG2 3
+#define DRC_GAIN_TABLE_STEPS (1 << DRC_GAIN_TABLE_STEPS_LOG2)
+#define DRC_GAIN_TABLE_SIZE (DRC_GAIN_TABLE_OCTAVES * DRC_GAIN_TABLE_STEPS + 1)
+#endif
+
 /* Stores the state of DRC */
 struct drc_state {
 	/* The detector_average is the target gain obtained by looking at the
@@ -44,8 +56,8 @@ struct drc_state {
 	int32_t detector_average; /* Q2.30 */
 	int32_t compressor_gain;  /* Q2.30 */
 
-	/* Lookahead section. */
-	int8_t *pre_delay_buffers[PLATFORM_MAX_CHANNELS];
+	/* Lookahead section. The frames are interleaved as in the stream. */
+	int8_t *pre_delay_buffer;
 	int32_t last_pre_delay_frames; /* integer */
 	int32_t pre_delay_read_index;  /* integer */
 	int32_t pre_delay_write_index; /* integer */
@@ -57,6 +69,11 @@ struct drc_state {
 	int32_t processed; /* switch */
 
 	int32_t max_attack_compression_diff_db; /* Q8.24 */
+
+#if CONFIG_DRC_GAIN_CURVE_TABLE
+	/* compression curve sampled on setup, see drc_gain_table_lookup() */
+	int32_t gain_table[DRC_GAIN_TABLE_SIZE]; /* Q2.30 */
+#endif
 };
 
 typedef void (*drc_func)(struct processing_module *mod,
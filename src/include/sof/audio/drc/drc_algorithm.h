@@ -9,6 +9,7 @@
 
 #include <stdint.h>
 #include <sof/audio/drc/drc.h>
+#include <sof/math/numbers.h>
 #include <sof/platform.h>
 #include <user/drc.h>
 
@@ -23,6 +24,42 @@ int drc_set_pre_delay_time(struct drc_state *state,
 			   int32_t pre_delay_time,
 			   int32_t rate);
 
+#if CONFIG_DRC_GAIN_CURVE_TABLE
+void drc_init_gain_table(struct drc_state *state, const struct sof_drc_params *p);
+
+/* Input level in Q1.31 of gain table entry i */
+static inline int32_t drc_gain_table_level(int i)
+{
+	return (DRC_GAIN_TABLE_STEPS + (i & (DRC_GAIN_TABLE_STEPS - 1))) <<
+		((i >> DRC_GAIN_TABLE_STEPS_LOG2) + DRC_GAIN_TABLE_MIN_LOG2 -
+		 DRC_GAIN_TABLE_STEPS_LOG2);
+}
+
+/* Compression curve for input level x in Q1.31 by linear interpolation of the
+ * gain table. The octave of x is found from its normalization shift and the
+ * step within the octave from the bits below the leading one.
+ */
+static inline int32_t drc_gain_table_lookup(const struct drc_state *state, int32_t x)
+{
+	const int frac_bits = 30 - DRC_GAIN_TABLE_STEPS_LOG2;
+	const int32_t *g;
+	int32_t frac;
+	int shift;
+	int i;
+
+	if (x < (1 << DRC_GAIN_TABLE_MIN_LOG2))
+		return state->gain_table[0];
+
+	shift = norm_int32(x);
+	x <<= shift; /* 0.5 <= x < 1.0 */
+	i = ((30 - shift - DRC_GAIN_TABLE_MIN_LOG2) << DRC_GAIN_TABLE_STEPS_LOG2) +
+		((x >> frac_bits) & (DRC_GAIN_TABLE_STEPS - 1));
+	frac = x & ((1 << frac_bits) - 1);
+	g = &state->gain_table[i];
+	return g[0] + (int32_t)(((int64_t)(g[1] - g[0]) * frac) >> frac_bits);
+}
+#endif /* CONFIG_DRC_GAIN_CURVE_TABLE */
+
 /* drc process functions */
 void drc_update_detector_average(struct drc_state *state,
 				 const struct sof_drc_params *p,
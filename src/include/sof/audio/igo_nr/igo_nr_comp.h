@@ -13,10 +13,18 @@
 #include <sof/audio/igo_nr/igo_lib.h>
 #include <user/igo_nr.h>
 
+/* 16 ms at 48 kHz, a DP instance processes one frame per period */
 #define IGO_FRAME_SIZE (768)
 #define IGO_NR_IN_BUF_LENGTH (IGO_FRAME_SIZE)
 #define IGO_NR_OUT_BUF_LENGTH (IGO_FRAME_SIZE)
 
+/** \brief Position of the frames to process in a source or sink circular buffer */
+struct igo_nr_buf {
+	void *ptr;		/**< first frame */
+	void *addr;		/**< buffer start */
+	void *end_addr;		/**< buffer end */
+};
+
 /* IGO_NR component private data */
 struct comp_data {
 	void *p_handle;
@@ -35,15 +43,10 @@ struct comp_data {
 	uint32_t source_rate;	/* Sample rate in Hz */
 	uint32_t sink_format;	/* For used PCM sample format */
 	uint32_t source_format;	/* For used PCM sample format */
-	int32_t source_frames;	/* Nominal # of frames to process at source */
-	int32_t sink_frames;	/* Nominal # of frames to process at sink */
-	int32_t source_frames_max;	/* Max # of frames to process at source */
-	int32_t sink_frames_max;	/* Max # of frames to process at sink */
-	int32_t frames;		/* IO buffer length */
 	void (*igo_nr_func)(struct comp_data *cd,
-			    const struct audio_stream *source,
-			    struct audio_stream *sink,
-			    int32_t frames);
+			    const struct igo_nr_buf *source,
+			    const struct igo_nr_buf *sink,
+			    int32_t nch, int32_t frames);
 };
 
 #endif /* __SOF_AUDIO_IGO_NR_CONFIG_H__ */
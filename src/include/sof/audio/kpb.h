@@ -42,7 +42,11 @@ struct comp_buffer;
 #define KPB_MAX_BUFFER_SIZE(sw, channels_number) ((KPB_SAMPLNG_FREQUENCY / 1000) * \
 	(KPB_SAMPLE_CONTAINER_SIZE(sw) / 8) * KPB_MAX_BUFF_TIME * \
 	 (channels_number))
+#ifdef CONFIG_KPB_MAX_CLIENTS
+#define KPB_MAX_NO_OF_CLIENTS CONFIG_KPB_MAX_CLIENTS
+#else
 #define KPB_MAX_NO_OF_CLIENTS 2
+#endif
 #define KPB_MAX_SINK_CNT (1 + KPB_MAX_NO_OF_CLIENTS)
 #define KPB_NO_OF_HISTORY_BUFFERS 2 /**< no of internal buffers */
 #define KPB_ALLOCATION_STEP 0x100
@@ -52,6 +56,12 @@ struct comp_buffer;
 	 (channels_number)))
 /**< Defines how much faster draining is in comparison to pipeline copy. */
 #define KPB_DRAIN_NUM_OF_PPL_PERIODS_AT_ONCE 2
+#if CONFIG_KPB_DRAIN_BURST
+/**< Draining speed in sync draining mode after the initial burst. */
+#define KPB_DRAIN_SYNC_RATE CONFIG_KPB_DRAIN_BURST_RATE
+#else
+#define KPB_DRAIN_SYNC_RATE KPB_DRAIN_NUM_OF_PPL_PERIODS_AT_ONCE
+#endif
 /**< Host buffer shall be at least two times bigger than history buffer. */
 #define HOST_BUFFER_MIN_SIZE(hb, channels_number) ((hb) * (channels_number))
 
@@ -141,16 +151,23 @@ struct history_buffer {
 	struct history_buffer *prev; /**< next history buffer */
 };
 
-/* Draining task data */
+/* Draining data of one client, its read cursor in the shared history */
 struct draining_data {
 	struct comp_buffer *sink;
-	struct history_buffer *hb;
+	struct history_buffer *hb; /**< buffer of the read cursor */
+	void *r_ptr; /**< read cursor */
 	size_t drain_req;
 	uint8_t is_draining_active;
 	size_t sample_width;
 	size_t buffered_while_draining;
 	size_t drain_interval;
 	size_t pb_limit; /**< Period bytes limit */
+	size_t burst_bytes; /**< bytes copied at once before pacing starts */
+	size_t period_bytes; /**< bytes copied in the current interval */
+	size_t period_bytes_limit; /**< bytes allowed in the current interval */
+	uint64_t period_copy_start;
+	uint64_t next_copy_time;
+	uint32_t drained;
 	struct comp_dev *dev;
 	bool sync_mode_on;
 	enum comp_copy_type copy_type;
@@ -158,6 +175,7 @@ struct draining_data {
 
 struct history_data {
 	size_t buffer_size; /**< size of internal history buffer */
+	size_t alloc_size; /**< memory allocated for history buffer */
 	size_t buffered; /**< amount of buffered data */
 	size_t free; /** spce we can use to write new data */
 	struct history_buffer *c_hb; /**< current buffer used for writing */
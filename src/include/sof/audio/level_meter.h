@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file audio/level_meter.h
+ * \brief Streaming peak and RMS level meter
+ *
+ * One meter per metered stream, computing the per channel peak and RMS
+ * levels in a single pass over the samples. The levels are published once
+ * per measurement window into a slot of the level meter memory window,
+ * see user/level_meter.h.
+ */
+
+#ifndef __SOF_AUDIO_LEVEL_METER_H__
+#define __SOF_AUDIO_LEVEL_METER_H__
+
+#include <sof/audio/audio_stream.h>
+#include <sof/platform.h>
+#include <user/level_meter.h>
+#include <stdint.h>
+
+/* accumulator limit keeping the sum of squares of 24 bit samples in 64 bits */
+#define LEVEL_METER_MAX_WINDOW_FRAMES	(1 << 18)
+
+struct level_meter {
+	struct level_meter_slot *slot;		/**< published levels */
+	uint32_t channels;			/**< metered channels */
+	uint32_t rate;				/**< stream sample rate */
+	uint32_t window_ms;			/**< measurement window */
+	uint32_t window_frames;			/**< measurement window in frames */
+	uint32_t frames;			/**< frames accumulated in the window */
+	int32_t peak[PLATFORM_MAX_CHANNELS];	/**< peak of the window, Q1.23 */
+	uint64_t sum_sq[PLATFORM_MAX_CHANNELS];	/**< sum of squares, Q2.46 */
+};
+
+/**
+ * \brief Creates a level meter and assigns it a slot of the memory window.
+ * \param[in] id Metered component ID, published with the levels.
+ * \param[in] rate Stream sample rate.
+ * \param[in] channels Stream channels count.
+ * \param[in] window_ms Initial measurement window in milliseconds.
+ * \return New level meter or NULL on failure.
+ */
+struct level_meter *level_meter_new(uint32_t id, uint32_t rate, uint32_t channels,
+				    uint32_t window_ms);
+
+/**
+ * \brief Releases the memory window slot and frees the level meter.
+ * \param[in] meter Level meter, may be NULL.
+ */
+void level_meter_free(struct level_meter *meter);
+
+/**
+ * \brief Changes the measurement window, restarts the current window.
+ * \param[in,out] meter Level meter.
+ * \param[in] window_ms Measurement window in milliseconds.
+ * \return Error code.
+ */
+int level_meter_set_window(struct level_meter *meter, uint32_t window_ms);
+
+/**
+ * \brief Accumulates samples of a stream, publishes the levels at the end
+ *	  of each measurement window.
+ * \param[in,out] meter Level meter.
+ * \param[in] stream Stream the samples belong to, used for the format and
+ *		     for the circular buffer wrap.
+ * \param[in] ptr First sample to meter.
+ * \param[in] frames Number of frames to meter.
+ */
+void level_meter_update(struct level_meter *meter, const struct audio_stream *stream,
+			const void *ptr, uint32_t frames);
+
+#endif /* __SOF_AUDIO_LEVEL_METER_H__ */
@@ -117,6 +117,10 @@ struct mfcc_state {
 	struct mat_matrix_16b *mel_spectra; /**< Pointer to scratch */
 	struct mat_matrix_16b *cepstral_coef; /**< Pointer to scratch */
 	int32_t *power_spectra; /**< Pointer to scratch */
+	int16_t *ceps_batch; /**< batch_max x num_ceps, frames waiting for output */
+	int batch_max; /**< frames */
+	int batch_read; /**< index of oldest frame in batch */
+	int batch_frames; /**< frames count in batch */
 	int16_t buf_avail;
 	int16_t *buffers;
 	int16_t *prev_data; /**< prev_data_size */
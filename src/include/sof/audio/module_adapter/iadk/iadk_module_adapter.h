@@ -102,6 +102,9 @@ namespace dsp_fw
 	private:
 
 		intel_adsp::ProcessingModuleInterface &processing_module_;
+		/* stream buffer descriptors passed to Process(), kept across calls */
+		intel_adsp::InputStreamBuffer input_stream_buffers_[INPUT_PIN_COUNT];
+		intel_adsp::OutputStreamBuffer output_stream_buffers_[OUTPUT_PIN_COUNT];
 	};
 
 } /* namespace dsp_fw */
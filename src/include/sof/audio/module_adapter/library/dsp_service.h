@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+/*! \file dsp_service.h */
+#ifndef DSP_SERVICE_H
+#define DSP_SERVICE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * DSP helper interface for loadable modules.
+ *
+ * Exposes the firmware's optimized signal processing kernels and the sof_source/sof_sink
+ * helpers, so loadable modules do not need to carry their own copies. The interface is
+ * retrieved with get_interface(DSP_SERVICE_INTERFACE_ID) of the system service in the
+ * module init. This header depends only on the C library, it is the ABI shared with the
+ * Loadable Modules Dev Kit.
+ *
+ * Versioning: the major version changes when an entry changes its meaning, modules must
+ * reject an interface with another major version. Minor versions only append entries,
+ * size tells how many are present. Kernels of math libraries not built into the firmware
+ * are NULL. All state structures are opaque, their size is reported by the interface and
+ * the memory is allocated by the module.
+ */
+
+#define DSP_SERVICE_INTERFACE_ID	0x1008
+
+#define DSP_SERVICE_VERSION_MAJOR	1
+#define DSP_SERVICE_VERSION_MINOR	0
+#define DSP_SERVICE_VERSION		((DSP_SERVICE_VERSION_MAJOR << 16) | \
+					 DSP_SERVICE_VERSION_MINOR)
+#define DSP_SERVICE_VERSION_GET_MAJOR(v)	((v) >> 16)
+
+struct sof_source;
+struct sof_sink;
+struct fir_state_32x16;
+struct sof_fir_coef_data;
+struct iir_state_df2t;
+struct sof_eq_iir_header;
+struct fft_plan;
+
+typedef struct _dsp_service_iface {
+	uint32_t version;	/*!< DSP_SERVICE_VERSION of the firmware */
+	uint32_t size;		/*!< size of this structure as known by the firmware */
+
+	/* sof_source and sof_sink access, see source_api.h and sink_api.h */
+	size_t (*source_get_data_available)(struct sof_source *source);
+	size_t (*source_get_frame_bytes)(struct sof_source *source);
+	int (*source_get_data)(struct sof_source *source, size_t req_size,
+			       void const **data_ptr, void const **buffer_start,
+			       size_t *buffer_size);
+	int (*source_release_data)(struct sof_source *source, size_t free_size);
+	size_t (*sink_get_free_size)(struct sof_sink *sink);
+	size_t (*sink_get_frame_bytes)(struct sof_sink *sink);
+	int (*sink_get_buffer)(struct sof_sink *sink, size_t req_size, void **data_ptr,
+			       void **buffer_start, size_t *buffer_size);
+	int (*sink_commit_buffer)(struct sof_sink *sink, size_t commit_size);
+
+	/* 32 bit data, 16 bit coefficients FIR, the sof_fir_coef_data blob of user/fir.h */
+	size_t (*fir_state_size)(void);
+	int (*fir_delay_size)(struct sof_fir_coef_data *config);
+	int (*fir_init)(struct fir_state_32x16 *fir, struct sof_fir_coef_data *config,
+			int32_t *delay);
+	void (*fir_reset)(struct fir_state_32x16 *fir);
+	/* filters samples of one channel, stride is the distance of samples in words */
+	void (*fir_process)(struct fir_state_32x16 *fir, const int32_t *in, int32_t *out,
+			    uint32_t samples, uint32_t stride);
+
+	/* DF2T IIR, the sof_eq_iir_header blob of user/eq.h */
+	size_t (*iir_state_size)(void);
+	int (*iir_delay_size)(struct sof_eq_iir_header *config);
+	int (*iir_init)(struct iir_state_df2t *iir, struct sof_eq_iir_header *config,
+			int64_t *delay);
+	void (*iir_reset)(struct iir_state_df2t *iir);
+	void (*iir_process)(struct iir_state_df2t *iir, const int32_t *in, int32_t *out,
+			    uint32_t samples, uint32_t stride);
+
+	/* 32 bit complex FFT, the buffers hold size icomplex32 values */
+	struct fft_plan *(*fft_plan_new)(void *inb, void *outb, uint32_t size);
+	void (*fft_execute)(struct fft_plan *plan, bool ifft);
+	void (*fft_plan_free)(struct fft_plan *plan);
+
+	/* sample format conversion with rounding and saturation */
+	void (*convert_s16_to_s32)(const int16_t *in, int32_t *out, uint32_t samples);
+	void (*convert_s32_to_s16)(const int32_t *in, int16_t *out, uint32_t samples);
+	void (*convert_s24_to_s32)(const int32_t *in, int32_t *out, uint32_t samples);
+	void (*convert_s32_to_s24)(const int32_t *in, int32_t *out, uint32_t samples);
+} dsp_service_iface;
+
+#endif /* DSP_SERVICE_H */
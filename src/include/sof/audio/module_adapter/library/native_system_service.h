@@ -8,6 +8,7 @@
 #include "logger.h"
 #include "adsp_stddef.h"
 #include "adsp_error_code.h"
+#include "dsp_service.h"
 #include <stdint.h>
 
 /*! \brief This struct defines the obfuscating type for notifications. */
@@ -73,7 +74,9 @@ typedef enum _adsp_iface_id {
 	INTERFACE_ID_SDCA = 0x1002,			/*!< See SdcaInterface */
 	INTERFACE_ID_ASYNC_MESSAGE_SERVICE = 0x1003,	/*!< See AsyncMessageInterface */
 	INTERFACE_ID_AM_SERVICE = 0x1005,		/*!< Reserved for ADSP system */
-	INTERFACE_ID_KPB_SERVICE = 0x1006		/*!< See KpbInterface */
+	INTERFACE_ID_KPB_SERVICE = 0x1006,		/*!< See KpbInterface */
+	INTERFACE_ID_TELEMETRY_SERVICE = 0x1007,	/*!< See telemetry_service_iface */
+	INTERFACE_ID_DSP_SERVICE = DSP_SERVICE_INTERFACE_ID /*!< See dsp_service_iface */
 } adsp_iface_id;
 
 /*! \brief sub interface definition.
@@ -81,6 +84,22 @@ typedef enum _adsp_iface_id {
  */
 typedef struct _system_service_iface {} system_service_iface;
 
+/*! \brief Telemetry interface returned for INTERFACE_ID_TELEMETRY_SERVICE.
+ *
+ * post() places a record in the telemetry buffer of the calling core, it is
+ * safe to call from the processing context and never blocks.
+ *
+ * \param type record type, see enum telemetry_record_type
+ * \param resource_id module id (LS word) and instance id (MS word)
+ * \param data record payload
+ * \param size payload size in bytes
+ * \return ADSP_NO_ERROR or ADSP_BUSY_RESOURCE when the record is dropped
+ */
+typedef struct _telemetry_service_iface {
+	AdspErrorCode (*post)(uint32_t type, uint32_t resource_id, const void *data,
+			      uint32_t size);
+} telemetry_service_iface;
+
 /*! \brief Defines prototype of the "GetInterface" function
  *
  * \param id service id
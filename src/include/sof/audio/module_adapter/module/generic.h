@@ -24,6 +24,10 @@
 #include "modules.h"
 #endif
 
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+#include <sof/debug/telemetry/performance_monitor.h>
+#endif
+
 /*
  * helpers to determine processing type
  * Needed till all the modules use PROCESSING_MODE_SINK_SOURCE
@@ -49,6 +53,26 @@
 				(value)); \
 	} while (0)
 
+#if CONFIG_COMP_DRIVER_TABLE
+#include <zephyr/sys/iterable_sections.h>
+
+/* The drivers are placed in the comp_driver iterable section at build time and
+ * found there by comp_driver_table_get(), nothing is registered on boot.
+ */
+#define MODULE_ADAPTER_DRIVER(name) STRUCT_SECTION_ITERABLE(comp_driver, name)
+#define MODULE_ADAPTER_DRIVER_INFO(adapter)
+#define MODULE_ADAPTER_DRIVER_REGISTER(adapter)
+#else
+#define MODULE_ADAPTER_DRIVER(name) struct comp_driver name
+#define MODULE_ADAPTER_DRIVER_INFO(adapter) \
+static SHARED_DATA struct comp_driver_info comp_module_##adapter##_info = { \
+	.drv = &comp_##adapter##_module, \
+};
+#define MODULE_ADAPTER_DRIVER_REGISTER(adapter) \
+	comp_register(platform_shared_get(&comp_module_##adapter##_info, \
+					  sizeof(comp_module_##adapter##_info)))
+#endif
+
 #define DECLARE_MODULE_ADAPTER(adapter, uuid, tr) \
 static struct comp_dev *module_##adapter##_shim_new(const struct comp_driver *drv, \
 					 const struct comp_ipc_config *config, \
@@ -57,7 +81,7 @@ static struct comp_dev *module_##adapter##_shim_new(const struct comp_driver *dr
 	return module_adapter_new(drv, config, &(adapter), spec);\
 } \
 \
-static const struct comp_driver comp_##adapter##_module = { \
+static const MODULE_ADAPTER_DRIVER(comp_##adapter##_module) = { \
 	.type = SOF_COMP_MODULE_ADAPTER, \
 	.uid = SOF_RT_UUID(uuid), \
 	.tctx = &(tr), \
@@ -85,14 +109,11 @@ static const struct comp_driver comp_##adapter##_module = { \
 	}, \
 }; \
 \
-static SHARED_DATA struct comp_driver_info comp_module_##adapter##_info = { \
-	.drv = &comp_##adapter##_module, \
-}; \
+MODULE_ADAPTER_DRIVER_INFO(adapter) \
 \
 UT_STATIC void sys_comp_module_##adapter##_init(void) \
 { \
-	comp_register(platform_shared_get(&comp_module_##adapter##_info, \
-					  sizeof(comp_module_##adapter##_info))); \
+	MODULE_ADAPTER_DRIVER_REGISTER(adapter); \
 } \
 \
 DECLARE_MODULE(sys_comp_module_##adapter##_init)
@@ -146,6 +167,7 @@ struct module_config {
  */
 struct module_memory {
 	void *ptr; /**< A pointr to particular memory block */
+	uint32_t size; /**< size of the block, accounted to the module pipeline */
 	struct list_item mem_list; /**< list of memory allocated by module */
 };
 
@@ -228,6 +250,12 @@ struct processing_module {
 	/* flag to indicate module does not pause */
 	bool no_pause;
 
+	/*
+	 * flag to indicate that DP module keeps no core-local (cached) state, so its
+	 * processing may be executed by DP worker threads of any core
+	 */
+	bool dp_core_agnostic;
+
 	/*
 	 * flag to indicate that the sink buffer writeback should be skipped. It will be handled
 	 * in the module's process callback
@@ -240,6 +268,25 @@ struct processing_module {
 	 */
 	bool skip_src_buffer_invalidate;
 
+	/*
+	 * Set by a module that is transparent with its current configuration, e.g. an EQ
+	 * without coefficients. The module adapter then copies the source to the sink
+	 * without calling process(). Cleared on every configuration change, so that
+	 * process() runs and sets it again when the new configuration is transparent.
+	 */
+	bool bypass;
+
+#if CONFIG_MODULE_SILENCE_SKIP
+	/*
+	 * Set by a module producing one output frame per input frame to the number of
+	 * silent input frames after which its output is silent too, e.g. the longest
+	 * filter length. Process() is then skipped for silent input and the module
+	 * adapter writes the silence. 0 when not supported, cleared on reset.
+	 */
+	uint32_t silence_tail_frames;
+	uint32_t silent_frames; /**< silent input frames processed since the last signal */
+#endif
+
 	/*
 	 * True for module with one source component buffer and one sink component buffer
 	 * to enable reduction of module processing overhead. False if component uses
@@ -247,6 +294,12 @@ struct processing_module {
 	 */
 	bool stream_copy_single_to_single;
 
+	/*
+	 * True for raw data module processing in place in the input buffer, the output is copied
+	 * directly to the sink component buffer. Set in prepare() if the module supports it.
+	 */
+	bool raw_data_in_place;
+
 	/* flag to insure that module is loadable */
 	bool is_native_sof;
 
@@ -260,6 +313,17 @@ struct processing_module {
 	/* max source/sinks supported by the module */
 	uint32_t max_sources;
 	uint32_t max_sinks;
+
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+	/* cycles accounting reported to the host in GLOBAL_PERF_DATA */
+	struct perf_data_item_comp *perf_data;
+#endif
+#if CONFIG_MODULE_SCRATCH_ARENA
+	size_t scratch_size; /**< size requested from the per core scratch arena */
+#endif
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+	uint32_t task_budget; /**< cycles added to the budget of the pipeline task */
+#endif
 };
 
 /*****************************************************************************/
@@ -270,6 +334,31 @@ int module_init(struct processing_module *mod, const struct module_interface *in
 void *module_allocate_memory(struct processing_module *mod, uint32_t size, uint32_t alignment);
 int module_free_memory(struct processing_module *mod, void *ptr);
 void module_free_all_memory(struct processing_module *mod);
+
+#if CONFIG_MODULE_SCRATCH_ARENA
+/**
+ * \brief Requests scratch memory from the arena of the module core, to be called from
+ *	  prepare(). The arena is shared by all LL modules of the core, it is grown to the
+ *	  largest request and freed with the last user.
+ * \param[in] mod - struct processing_module pointer
+ * \param[in] size - size of the scratch memory needed during a single process() call
+ * \return: 0 upon success or error upon failure
+ */
+int module_scratch_request(struct processing_module *mod, size_t size);
+
+/**
+ * \brief Returns scratch memory requested with module_scratch_request(). The pointer is
+ *	  valid and the content is preserved during the current process() call only.
+ * \param[in] mod - struct processing_module pointer
+ */
+void *module_scratch_get(struct processing_module *mod);
+
+/**
+ * \brief Drops the request, done automatically on module reset and free.
+ * \param[in] mod - struct processing_module pointer
+ */
+void module_scratch_release(struct processing_module *mod);
+#endif
 int module_prepare(struct processing_module *mod,
 		   struct sof_source **sources, int num_of_sources,
 		   struct sof_sink **sinks, int num_of_sinks);
@@ -158,6 +158,13 @@ struct module_interface {
 	 * module_adapter component creation in .new()
 	 */
 	int (*init)(struct processing_module *mod);
+	/**
+	 * (optional) Time consuming part of the initialization, called after init().
+	 * With CONFIG_IPC4_ASYNC_INIT it runs in a low priority worker once the init IPC
+	 * has been acknowledged, so init() must keep what it needs from the init data.
+	 * free() may then also be called without it having run.
+	 */
+	int (*init_async)(struct processing_module *mod);
 	/**
 	 * Module specific prepare procedure, called as part of module_adapter
 	 * component preparation in .prepare()
@@ -303,6 +310,14 @@ struct module_interface {
 	int (*trigger)(struct processing_module *mod, int cmd);
 
 	const struct module_endpoint_ops *endpoint_ops;
+
+	/**
+	 * (optional) true if process_raw_data() can process in place, i.e. output_buffers[0].data
+	 * may point to the same memory as input_buffers[0].data. For modules with a single source
+	 * and sink of the same format module adapter then uses one buffer for both and writes the
+	 * output directly to the sink, skipping the intermediate output buffers.
+	 */
+	bool in_place;
 };
 
 /* Convert first_block/last_block indicator to fragment position */
@@ -16,6 +16,7 @@
 
 #if CONFIG_COMP_MUX
 
+#include <sof/audio/channel_map.h>
 #include <sof/common.h>
 #include <sof/platform.h>
 #include <sof/trace/trace.h>
@@ -39,23 +40,6 @@ struct comp_dev;
 STATIC_ASSERT(MUX_MAX_STREAMS < PLATFORM_MAX_STREAMS,
 	      unsupported_amount_of_streams_for_mux);
 
-struct mux_copy_elem {
-	uint32_t stream_id;
-	uint32_t in_ch;
-	uint32_t out_ch;
-
-	void *dest;
-	void *src;
-
-	uint32_t dest_inc;
-	uint32_t src_inc;
-};
-
-struct mux_look_up {
-	uint32_t num_elems;
-	struct mux_copy_elem copy_elem[PLATFORM_MAX_CHANNELS];
-};
-
 struct mux_stream_data {
 	uint32_t pipeline_id;
 	uint8_t num_channels_deprecated;	/* deprecated in ABI 3.15 */
@@ -67,10 +51,10 @@ struct mux_stream_data {
 
 typedef void(*demux_func)(struct comp_dev *dev, struct audio_stream *sink,
 			  const struct audio_stream *source, uint32_t frames,
-			  struct mux_look_up *look_up);
+			  struct chmap_remap *remap);
 typedef void(*mux_func)(struct comp_dev *dev, struct audio_stream *sink,
 			const struct audio_stream **sources, uint32_t frames,
-			struct mux_look_up *look_up);
+			struct chmap_remap *remaps);
 
 /**
  * \brief Mux/Demux component config structure.
@@ -170,8 +154,7 @@ struct comp_data {
 		demux_func demux;
 	};
 
-	struct mux_look_up lookup[MUX_MAX_STREAMS];
-	struct mux_look_up active_lookup;
+	struct chmap_remap remap[MUX_MAX_STREAMS]; /* routes per stream */
 	struct comp_data_blob_handler *model_handler;
 	struct sof_mux_config config; /* Keep last due to flexible array member in end */
 };
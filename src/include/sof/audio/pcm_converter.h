@@ -19,6 +19,7 @@
 
 #include <sof/compiler_attributes.h>
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -145,6 +146,173 @@ pcm_get_conversion_vc_function(enum sof_ipc_frame in_bits,
 	return NULL;
 }
 
+/**
+ * \brief PCM conversion function interface with fused attenuation
+ * \param source buffer with samples to process, read pointer is not modified
+ * \param ioffset offset to first sample in source stream
+ * \param sink output buffer, write pointer is not modified
+ * \param ooffset offset to first sample in sink stream
+ * \param samples number of samples to convert
+ * \param attenuation right shift applied to every converted sample
+ * \return error code or number of processed samples.
+ */
+typedef int (*pcm_converter_att_func)(const struct audio_stream *source,
+				      uint32_t ioffset, struct audio_stream *sink,
+				      uint32_t ooffset, uint32_t samples,
+				      uint32_t attenuation);
+
+/**
+ * \brief PCM conversion functions map with fused attenuation. Attenuation is
+ *	  supported for 32 bit sink containers only.
+ */
+struct pcm_func_att_map {
+	enum sof_ipc_frame source;	/**< source frame container format */
+	enum sof_ipc_frame valid_src_bits;	/**< source frame format */
+	enum sof_ipc_frame sink;	/**< sink frame container format */
+	enum sof_ipc_frame valid_sink_bits;	/**< sink frame format */
+
+	pcm_converter_att_func func; /**< PCM conversion function */
+};
+
+/** \brief Map of formats with dedicated conversion and attenuation functions. */
+extern const struct pcm_func_att_map pcm_func_att_map[];
+
+/** \brief Number of conversion and attenuation functions. */
+extern const size_t pcm_func_att_count;
+
+/**
+ * \brief Retrieves PCM conversion function with fused attenuation.
+ * \param in_bits is source container format.
+ * \param valid_in_bits is source valid sample format.
+ * \param out_bits is sink container format.
+ * \param valid_out_bits is sink valid sample format.
+ * \return conversion function or NULL if the combination is not supported.
+ */
+static inline pcm_converter_att_func
+pcm_get_conversion_att_function(enum sof_ipc_frame in_bits,
+				enum sof_ipc_frame valid_in_bits,
+				enum sof_ipc_frame out_bits,
+				enum sof_ipc_frame valid_out_bits)
+{
+	uint32_t i;
+
+	for (i = 0; i < pcm_func_att_count; i++) {
+		if (in_bits != pcm_func_att_map[i].source)
+			continue;
+		if (valid_in_bits != pcm_func_att_map[i].valid_src_bits)
+			continue;
+		if (out_bits != pcm_func_att_map[i].sink)
+			continue;
+		if (valid_out_bits != pcm_func_att_map[i].valid_sink_bits)
+			continue;
+
+		return pcm_func_att_map[i].func;
+	}
+
+	return NULL;
+}
+
+/** \brief Gain of 0 dB in Q1.31, as the target volume of peak volume. */
+#define PCM_GAIN_UNITY		INT32_MAX
+
+/**
+ * \brief Per channel gain applied while converting, with a linear ramp to
+ *	  the target gain. The conversion functions only read it, the gain is
+ *	  moved along the ramp with pcm_gain_advance() after each conversion.
+ */
+struct pcm_gain {
+	int32_t gain[SOF_IPC_MAX_CHANNELS];	/**< gain of the next frame, Q1.31 */
+	int32_t target[SOF_IPC_MAX_CHANNELS];	/**< gain at the end of the ramp */
+	int32_t step[SOF_IPC_MAX_CHANNELS];	/**< gain change per frame of the ramp */
+	uint32_t ramp_frames;	/**< frames left to the target, 0 if not ramping */
+	uint32_t channels;
+	uint32_t in_shift;	/**< left shift of a source sample to Q1.31 */
+	uint32_t out_shift;	/**< right shift of a Q2.62 product to the sink sample */
+	uint32_t attenuation;	/**< extra right shift of the sink sample, 0 if none */
+	bool unity;		/**< all channels at PCM_GAIN_UNITY, not ramping and
+				 *  not attenuated
+				 */
+};
+
+/**
+ * \brief PCM conversion function interface with fused gain
+ * \param source buffer with samples to process, read pointer is not modified
+ * \param ioffset offset to first sample in source stream, frame aligned
+ * \param sink output buffer, write pointer is not modified
+ * \param ooffset offset to first sample in sink stream, frame aligned
+ * \param samples number of samples to convert, frame aligned
+ * \param gain gain applied to the converted samples
+ * \return error code or number of processed samples.
+ */
+typedef int (*pcm_converter_gain_func)(const struct audio_stream *source,
+				       uint32_t ioffset, struct audio_stream *sink,
+				       uint32_t ooffset, uint32_t samples,
+				       const struct pcm_gain *gain);
+
+/**
+ * \brief Retrieves PCM conversion function with fused gain and sets the
+ *	  sample shifts of gain for the formats.
+ * \param gain gain to be applied by the function.
+ * \param in_bits is source container format.
+ * \param valid_in_bits is source valid sample format.
+ * \param out_bits is sink container format.
+ * \param valid_out_bits is sink valid sample format.
+ * \return conversion function or NULL if the combination is not supported.
+ *
+ * 16 and 32 bit containers with 16, 24 or 32 valid LSB aligned bits are
+ * supported.
+ */
+pcm_converter_gain_func pcm_get_conversion_gain_function(struct pcm_gain *gain,
+							 enum sof_ipc_frame in_bits,
+							 enum sof_ipc_frame valid_in_bits,
+							 enum sof_ipc_frame out_bits,
+							 enum sof_ipc_frame valid_out_bits);
+
+/**
+ * \brief Sets the target gain of a channel.
+ * \param gain gain to update.
+ * \param channel channel index.
+ * \param target gain to reach, Q1.31.
+ * \param ramp_frames frames of the ramp from the current gain, 0 to jump.
+ *
+ * A new ramp restarts the ramp of all channels with the new length.
+ */
+void pcm_gain_set_target(struct pcm_gain *gain, uint32_t channel, int32_t target,
+			 uint32_t ramp_frames);
+
+/**
+ * \brief Sets the attenuation applied on top of the gain.
+ * \param gain gain to update.
+ * \param attenuation right shift of the sink sample, in range of [0 - 31].
+ */
+void pcm_gain_set_attenuation(struct pcm_gain *gain, uint32_t attenuation);
+
+/**
+ * \brief Moves the gain along its ramp after frames have been converted.
+ */
+static inline void pcm_gain_advance(struct pcm_gain *gain, uint32_t frames)
+{
+	uint32_t ch;
+
+	if (!gain->ramp_frames)
+		return;
+
+	if (frames < gain->ramp_frames) {
+		for (ch = 0; ch < gain->channels; ch++)
+			gain->gain[ch] += gain->step[ch] * (int32_t)frames;
+		gain->ramp_frames -= frames;
+		return;
+	}
+
+	gain->unity = !gain->attenuation;
+	for (ch = 0; ch < gain->channels; ch++) {
+		gain->gain[ch] = gain->target[ch];
+		if (gain->gain[ch] != PCM_GAIN_UNITY)
+			gain->unity = false;
+	}
+	gain->ramp_frames = 0;
+}
+
 /**
  * \brief Convert data from circular buffer using converter working on linear
  *	  memory space
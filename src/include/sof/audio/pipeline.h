@@ -49,6 +49,21 @@ struct ipc_msg;
 #define PPL_DIR_DOWNSTREAM	0
 #define PPL_DIR_UPSTREAM	1
 
+/* max components in a pipeline copied from a flat list */
+#define PIPELINE_FUSED_MAX_COMPS	16
+
+#if CONFIG_PIPELINE_XRUN_FAST_RECOVERY
+/* xrun recoveries done in place since the last pipeline reset */
+struct pipeline_xrun_stats {
+	uint32_t count;			/* number of recoveries */
+	uint32_t last_us;		/* duration of the last recovery */
+	uint32_t max_us;		/* longest recovery */
+	uint32_t burst;			/* recoveries since burst_start */
+	uint64_t burst_start;		/* start of the one second window */
+	bool recovered;			/* copy error was recovered in place */
+};
+#endif
+
 /*
  * Audio pipeline.
  */
@@ -67,13 +82,28 @@ struct pipeline {
 
 	/* runtime status */
 	int32_t xrun_bytes;		/* last xrun length */
+	uint32_t xrun_count;		/* xruns since the pipeline was created */
+#if CONFIG_COMP_DAI_ADAPTIVE_WATERMARK
+	uint32_t dai_watermark;		/* bytes the playback DAI keeps queued */
+#endif
+#if CONFIG_PIPELINE_XRUN_FAST_RECOVERY
+	struct pipeline_xrun_stats xrun_stats;
+#endif
 	uint32_t status;		/* pipeline status */
 	struct tr_ctx tctx;		/* trace settings */
 
+	/* memory accounting */
+	uint32_t mem_pages;		/* pages requested by host at creation */
+	uint32_t mem_usage;		/* bytes allocated by modules */
+	uint32_t mem_peak;		/* peak of mem_usage */
+
 	/* scheduling */
 	struct task *pipe_task;		/* pipeline processing task */
 	struct pipeline *sched_next;	/* pipeline scheduled after this */
 	struct pipeline *sched_prev;	/* pipeline scheduled before this */
+#if CONFIG_ZEPHYR_LL_FLOW_ORDER
+	uint16_t flow_rank;		/* longest chain of producer pipelines */
+#endif
 
 	/* component that drives scheduling in this pipe */
 	struct comp_dev *sched_comp;
@@ -94,6 +124,14 @@ struct pipeline {
 		bool aborted;		/* STOP or PAUSE failed, stay active */
 		bool pending;		/* trigger scheduled but not executed yet */
 	} trigger;
+
+#if CONFIG_PIPELINE_FUSED_COPY
+	/* components of the copy walk in pre-order, 0 if not resolved */
+	struct comp_dev *fused_comps[PIPELINE_FUSED_MAX_COMPS];
+	uint8_t fused_end[PIPELINE_FUSED_MAX_COMPS];	/* end of the subtree */
+	uint8_t fused_post[PIPELINE_FUSED_MAX_COMPS];	/* post-order indices */
+	uint32_t fused_count;
+#endif
 };
 
 struct pipeline_walk_context {
@@ -122,6 +160,9 @@ struct pipeline_data {
 	struct pipeline *p;
 	int cmd;
 	uint32_t delay_ms;		/* between PRE_{START,RELEASE} and {START,RELEASE} */
+#if CONFIG_PIPELINE_PARAMS_CACHE
+	uint32_t hw_params_found;	/* DAI hw params fetched or taken from cache */
+#endif
 };
 
 /** \brief Task type registered by pipelines. */
@@ -292,6 +333,28 @@ int pipeline_trigger_run(struct pipeline *p, struct comp_dev *host, int cmd);
  */
 int pipeline_copy(struct pipeline *p);
 
+#if CONFIG_PIPELINE_FUSED_COPY
+/**
+ * \brief Resolves the copy order of a pipeline, so pipeline_copy() can run
+ *	  its components from flat lists instead of walking the graph. Pipelines
+ *	  of more than PIPELINE_FUSED_MAX_COMPS visits are left to the graph walk.
+ * \param[in] p pipeline.
+ */
+void pipeline_fuse(struct pipeline *p);
+
+/**
+ * \brief Drops the copy order resolved by pipeline_fuse().
+ * \param[in] p pipeline.
+ */
+static inline void pipeline_unfuse(struct pipeline *p)
+{
+	p->fused_count = 0;
+}
+#else
+static inline void pipeline_fuse(struct pipeline *p) { }
+static inline void pipeline_unfuse(struct pipeline *p) { }
+#endif
+
 /**
  * \brief Get time pipeline timestamps from host to dai.
  * \param[in] p pipeline.
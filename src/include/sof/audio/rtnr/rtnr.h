@@ -12,6 +12,7 @@
 #include <stdbool.h>
 #include <sof/platform.h>
 #include <sof/audio/component.h>
+#include <sof/audio/module_adapter/module/generic.h>
 #include <ipc/stream.h>
 #include <user/rtnr.h>
 
@@ -41,13 +42,16 @@ struct audio_stream_rtnr {
 	bool underrun_permitted; /**< indicates whether underrun is permitted */
 };
 
-typedef void (*rtnr_func)(struct comp_dev *dev,
+typedef void (*rtnr_func)(struct processing_module *mod,
 						  struct audio_stream_rtnr **sources,
 						  struct audio_stream_rtnr *sink,
 						  int frames);
 
 #define RTNR_MAX_SOURCES		1 /* Microphone stream */
 
+/* Block length of the library, a DP instance processes one block per period */
+#define RTNR_FRAME_MS			10
+
 /* RTNR component private data */
 struct comp_data {
 	struct comp_data_blob_handler *model_handler;
@@ -61,6 +65,7 @@ struct comp_data {
 	uint32_t source_rate;
 	bool process_enable;
 	uint32_t process_sample_rate;
+	uint32_t frames;	/**< library block length in frames */
 	int ref_shift;
 	bool ref_32bits;
 	bool ref_active;
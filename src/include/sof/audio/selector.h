@@ -27,6 +27,17 @@
 struct comp_buffer;
 struct comp_dev;
 
+#if defined(__XCC__)
+# include <xtensa/config/core-isa.h>
+# if XCHAL_HAVE_HIFI3 || XCHAL_HAVE_HIFI4
+#  define SEL_HIFI3
+# else
+#  define SEL_GENERIC
+# endif
+#else
+# define SEL_GENERIC
+#endif
+
 #if CONFIG_IPC_MAJOR_3
 /** \brief Supported channel count on input. */
 #define SEL_SOURCE_2CH 2
@@ -99,6 +110,13 @@ struct sof_selector_avs_ipc4_config {
 	struct ipc4_audio_format output_format;
 };
 
+/** \brief Kind of processing the mixing coefficients require. */
+enum sel_mode {
+	SEL_MODE_MIX,	/**< weighted sum of source channels */
+	SEL_MODE_PICK,	/**< every sink channel is a copy of one source channel */
+	SEL_MODE_COPY,	/**< sink channels are the source channels in the same order */
+};
+
 #else
 typedef void (*sel_func)(struct comp_dev *dev, struct audio_stream *sink,
 			 const struct audio_stream *source, uint32_t frames);
@@ -109,6 +127,8 @@ struct comp_data {
 #if CONFIG_IPC_MAJOR_4
 	struct sof_selector_ipc4_config sel_ipc4_cfg;
 	struct ipc4_selector_coeffs_config coeffs_config;
+	enum sel_mode mode;	/**< processing the coefficients require */
+	uint8_t pick[SEL_SINK_CHANNELS_MAX];	/**< source channel of a sink channel */
 #endif
 
 	uint32_t source_period_bytes;	/**< source number of period bytes */
@@ -123,6 +143,9 @@ struct comp_data {
 struct comp_func_map {
 	uint16_t source;	/**< source frame format */
 	uint32_t out_channels;	/**< number of output stream channels */
+#if CONFIG_IPC_MAJOR_4
+	enum sel_mode mode;	/**< coefficients the function is specialized for */
+#endif
 	sel_func sel_func;	/**< selector processing function */
 };
 
@@ -132,10 +155,22 @@ extern const struct comp_func_map func_map[];
 #if CONFIG_IPC_MAJOR_4
 /**
  * \brief Retrieves selector processing function.
+ *
+ * Selects a channel copy or pick function when the coefficients only route
+ * channels, the mixing one otherwise.
  * \param[in,out] mod Selector module adapter.
  */
 sel_func sel_get_processing_function(struct processing_module *mod);
 
+#ifdef SEL_HIFI3
+void sel_s16le_pick_hifi3(struct processing_module *mod, struct input_stream_buffer *bsource,
+			  struct output_stream_buffer *bsink, uint32_t frames);
+void sel_s32le_pick_hifi3(struct processing_module *mod, struct input_stream_buffer *bsource,
+			  struct output_stream_buffer *bsink, uint32_t frames);
+void sel_s32le_hifi3(struct processing_module *mod, struct input_stream_buffer *bsource,
+		     struct output_stream_buffer *bsink, uint32_t frames);
+#endif
+
 #ifdef UNIT_TEST
 void sys_comp_module_selector_interface_init(void);
 #endif
@@ -84,6 +84,29 @@ size_t sink_get_free_frames(struct sof_sink *sink);
 int sink_get_buffer(struct sof_sink *sink, size_t req_size,
 		    void **data_ptr, void **buffer_start, size_t *buffer_size);
 
+/**
+ * Get a linear (non wrapping) buffer to operate on (to write).
+ *
+ * Works like sink_get_buffer(), but instead of the circular buffer boundaries it reports
+ * the size of the space that can be accessed from data_ptr without a wrap-around. The
+ * caller may run wrap-free processing loops on it, commit it with sink_commit_buffer()
+ * and call this function again for the rest of the space, beginning at the start of the
+ * buffer.
+ *
+ * The linear fragment ends either at req_size or at the end of the circular buffer, so
+ * for buffers sized in whole frames it always contains whole frames.
+ *
+ * @param sink a handler to sink
+ * @param [in] req_size requested size of space
+ * @param [out] data_ptr a pointer to the space will be provided there
+ * @param [out] linear_size size of space available from data_ptr without wrap-around,
+ *		never bigger than req_size
+ *
+ * @retval -ENODATA if req_size is bigger than free space
+ */
+int sink_get_buffer_linear(struct sof_sink *sink, size_t req_size,
+			   void **data_ptr, size_t *linear_size);
+
 /**
  * Commits that the buffer previously obtained by get_buffer is filled with data
  * and ready to be used
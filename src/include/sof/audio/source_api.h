@@ -97,7 +97,29 @@ int source_get_data(struct sof_source *source, size_t req_size,
 		    void const **data_ptr, void const **buffer_start, size_t *buffer_size);
 
 /**
- * Releases fragment previously obtained by source_get_data()
+ * Retrieves a linear (non wrapping) fragment of data to be used by the caller (to read)
+ *
+ * Works like source_get_data(), but instead of the circular buffer boundaries it reports
+ * the size of the data that can be accessed from data_ptr without a wrap-around. The caller
+ * may run wrap-free processing loops on it, release it with source_release_data() and call
+ * this function again for the rest of the data, beginning at the start of the buffer.
+ *
+ * The linear fragment ends either at req_size or at the end of the circular buffer, so
+ * for buffers sized in whole frames it always contains whole frames.
+ *
+ * @param source a handler to source
+ * @param [in] req_size requested size of data.
+ * @param [out] data_ptr a pointer to data will be provided there
+ * @param [out] linear_size size of data available from data_ptr without wrap-around,
+ *		never bigger than req_size
+ *
+ * @retval -ENODATA if req_size is bigger than available data
+ */
+int source_get_data_linear(struct sof_source *source, size_t req_size,
+			   void const **data_ptr, size_t *linear_size);
+
+/**
+ * Releases fragment previously obtained by source_get_data() or source_get_data_linear()
  * Once called, the data are no longer available for the caller
  *
  * @param source a handler to source
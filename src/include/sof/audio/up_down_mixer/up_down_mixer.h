@@ -8,6 +8,7 @@
 #ifndef __SOF_AUDIO_UP_DOWN_MIXER_H__
 #define __SOF_AUDIO_UP_DOWN_MIXER_H__
 
+#include <sof/audio/channel_map.h>
 #include <sof/audio/component_ext.h>
 #include <sof/audio/ipc-config.h>
 #include <rtos/bit.h>
@@ -21,6 +22,22 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/* Select optimized code variant when xt-xcc compiler is used */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define UP_DOWN_MIXER_GENERIC	0
+#define UP_DOWN_MIXER_HIFI3	1
+#else
+#define UP_DOWN_MIXER_GENERIC	1
+#define UP_DOWN_MIXER_HIFI3	0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define UP_DOWN_MIXER_GENERIC	1
+#define UP_DOWN_MIXER_HIFI3	0
+#endif /* __XCC__ */
+
 /** This type is introduced for better readability. */
 typedef const int32_t *downmix_coefficients;
 
@@ -130,6 +147,9 @@ struct up_down_mixer_data {
 	/** Downmix coefficients. */
 	downmix_coefficients downmix_coefficients;
 
+	/** Channel routing of the shift copy and of the sparse downmix. */
+	struct chmap_remap remap;
+
 	struct ipc4_audio_format out_fmt[IPC4_UP_DOWN_MIXER_MODULE_OUTPUT_PINS_COUNT];
 
 	const int32_t k_lo_ro_downmix32bit[UP_DOWN_MIX_COEFFS_LENGTH];
@@ -201,30 +221,6 @@ void upmix16bit_2_0_to_5_1(struct up_down_mixer_data *cd, const uint8_t * const
 void upmix32bit_2_0_to_7_1(struct up_down_mixer_data *cd, const uint8_t * const in_data,
 			   const uint32_t in_size, uint8_t * const out_data);
 
-/**
- * \brief 32 bit shift copier for mono streams.
- *		  Copy the 32 MSB input mono stream (left, right) to 32 MSB stereo one.
- *
- * \param[in]   cd                      Component private data.
- * \param[in]   in_data                 Input buffer.
- * \param[in]   in_size                 Input buffer size.
- * \param[out]  out_data                Output buffer.
- */
-void shiftcopy32bit_mono(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			 const uint32_t in_size, uint8_t * const out_data);
-
-/**
- * \brief 32 bit shift copier for stereo.
- *		  Copy the 32 MSB input streo stream (left, right) to 32 MSB one.
- *
- * \param[in]   cd                      Component private data.
- * \param[in]   in_data                 Input buffer.
- * \param[in]   in_size                 Input buffer size.
- * \param[out]  out_data                Output buffer.
- */
-void shiftcopy32bit_stereo(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			   const uint32_t in_size, uint8_t * const out_data);
-
 /**
  * \brief 24 bit downmixer specialized for the 2.1.
  * \note implementation is based on Downmix32bit
@@ -320,30 +316,6 @@ void downmix32bit_5_1(struct up_down_mixer_data *cd, const uint8_t * const in_da
 void downmix32bit_7_1(struct up_down_mixer_data *cd, const uint8_t * const in_data,
 		      const uint32_t in_size, uint8_t * const out_data);
 
-/**
- * \brief 16 bit shift copier for mono.
- *		  Copy the 16 bit input mono stream (left, right) to 32 MSB stereo one.
- *
- * \param[in]   cd                      Component private data.
- * \param[in]   in_data                 Input buffer.
- * \param[in]   in_size                 Input buffer size.
- * \param[out]  out_data                Output buffer.
- */
-void shiftcopy16bit_mono(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			 const uint32_t in_size, uint8_t * const out_data);
-
-/**
- * \brief 16 bit shift copier for stereo.
- *		  Copy the 16 bit input streo stream (left, right) to 32 MSB one.
- *
- * \param[in]   cd                      Component private data.
- * \param[in]   in_data                 Input buffer.
- * \param[in]   in_size                 Input buffer size.
- * \param[out]  out_data                Output buffer.
- */
-void shiftcopy16bit_stereo(struct up_down_mixer_data *cd, const uint8_t * const in_data,
-			   const uint32_t in_size, uint8_t * const out_data);
-
 /**
  * \brief 16 bit downmixer. This function is highly power consuming
  *
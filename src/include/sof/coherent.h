@@ -15,6 +15,7 @@
 #include <rtos/spinlock.h>
 #include <sof/list.h>
 #include <sof/lib/memory.h>
+#include <sof/lib/cache_stats.h>
 #include <sof/lib/cpu.h>
 
 #define __coherent __attribute__((packed, aligned(DCACHE_LINE_SIZE)))
@@ -140,7 +141,7 @@ __must_check static inline struct coherent __sparse_cache *coherent_acquire(stru
 		 */
 
 		/* invalidate local copy */
-		dcache_invalidate_region(cc, size);
+		cache_stats_invalidate_region(NULL, cc, size);
 	}
 
 	/* client can now use cached object safely */
@@ -160,7 +161,7 @@ static inline void coherent_release(struct coherent __sparse_cache *c,
 		CHECK_COHERENT_CORE(c);
 
 		/* wtb and inv local data to coherent object */
-		dcache_writeback_invalidate_region(c, size);
+		cache_stats_writeback_invalidate_region(NULL, c, size);
 
 		/* unlock on uncache alias */
 		k_spin_unlock(&uc->lock, uc->key);
@@ -190,7 +191,7 @@ static inline void *__coherent_init(size_t offset, const size_t size)
 	c->core = cpu_get_id();
 	list_init(&c->list);
 	/* inv local data to coherent object */
-	dcache_invalidate_region(uncache_to_cache(object), size);
+	cache_stats_invalidate_region(NULL, uncache_to_cache(object), size);
 
 	return object;
 }
@@ -207,7 +208,7 @@ static inline void __coherent_shared(struct coherent *c, const size_t size)
 
 	c->key = k_spin_lock(&c->lock);
 	c->shared = true;
-	dcache_invalidate_region(uncache_to_cache(c), size);
+	cache_stats_invalidate_region(NULL, uncache_to_cache(c), size);
 	k_spin_unlock(&c->lock, c->key);
 }
 
@@ -233,7 +234,7 @@ __must_check static inline struct coherent __sparse_cache *coherent_acquire_thre
 		k_mutex_lock(&c->mutex, K_FOREVER);
 
 		/* invalidate local copy */
-		dcache_invalidate_region(cc, size);
+		cache_stats_invalidate_region(NULL, cc, size);
 	}
 
 	/* client can now use cached object safely */
@@ -254,7 +255,7 @@ static inline void coherent_release_thread(struct coherent __sparse_cache *c,
 		CHECK_COHERENT_CORE(c);
 
 		/* wtb and inv local data to coherent object */
-		dcache_writeback_invalidate_region(c, size);
+		cache_stats_writeback_invalidate_region(NULL, c, size);
 
 		/* unlock on uncache alias */
 		k_mutex_unlock(&uc->mutex);
@@ -280,7 +281,7 @@ static inline void *__coherent_init_thread(size_t offset, const size_t size)
 	c->core = cpu_get_id();
 	list_init(&c->list);
 	/* inv local data to coherent object */
-	dcache_invalidate_region(uncache_to_cache(object), size);
+	cache_stats_invalidate_region(NULL, uncache_to_cache(object), size);
 
 	return object;
 }
@@ -297,7 +298,7 @@ static inline void __coherent_shared_thread(struct coherent *c, const size_t siz
 
 	k_mutex_lock(&c->mutex, K_FOREVER);
 	c->shared = true;
-	dcache_invalidate_region(uncache_to_cache(c), size);
+	cache_stats_invalidate_region(NULL, uncache_to_cache(c), size);
 	k_mutex_unlock(&c->mutex);
 }
 
@@ -311,8 +312,8 @@ static inline void __coherent_shared_thread(struct coherent *c, const size_t siz
 		/* assert if someone passes a cache address in here. */		\
 		ADDR_IS_COHERENT(object);					\
 		/* wtb and inv local data to coherent object */			\
-		dcache_writeback_invalidate_region(uncache_to_cache(object),	\
-						   sizeof(*object));		\
+		cache_stats_writeback_invalidate_region(NULL,			\
+			uncache_to_cache(object), sizeof(*object));		\
 		rfree(object);							\
 	} while (0)
 
@@ -330,7 +331,7 @@ __must_check static inline struct coherent __sparse_cache *coherent_acquire(stru
 		c->key = k_spin_lock(&c->lock);
 
 		/* invalidate local copy */
-		dcache_invalidate_region(cc, size);
+		cache_stats_invalidate_region(NULL, cc, size);
 	}
 
 	return (__sparse_force struct coherent __sparse_cache *)c;
@@ -343,7 +344,7 @@ static inline void coherent_release(struct coherent __sparse_cache *c,
 		struct coherent *uc = cache_to_uncache(c);
 
 		/* wtb and inv local data to coherent object */
-		dcache_writeback_invalidate_region(c, size);
+		cache_stats_writeback_invalidate_region(NULL, c, size);
 
 		k_spin_unlock(&uc->lock, uc->key);
 	}
@@ -395,7 +396,7 @@ __must_check static inline struct coherent __sparse_cache *coherent_acquire_thre
 		k_mutex_lock(&c->mutex, K_FOREVER);
 
 		/* invalidate local copy */
-		dcache_invalidate_region(cc, size);
+		cache_stats_invalidate_region(NULL, cc, size);
 	}
 
 	return (__sparse_force struct coherent __sparse_cache *)c;
@@ -408,7 +409,7 @@ static inline void coherent_release_thread(struct coherent __sparse_cache *c,
 		struct coherent *uc = cache_to_uncache(c);
 
 		/* wtb and inv local data to coherent object */
-		dcache_writeback_invalidate_region(c, size);
+		cache_stats_writeback_invalidate_region(NULL, c, size);
 
 		k_mutex_unlock(&uc->mutex);
 	}
@@ -0,0 +1,132 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/debug/telemetry/performance_monitor.h
+ * \brief Per module instance and per core performance (KCPS) accounting
+ */
+
+#ifndef __SOF_DEBUG_TELEMETRY_PERFORMANCE_MONITOR_H__
+#define __SOF_DEBUG_TELEMETRY_PERFORMANCE_MONITOR_H__
+
+#include <ipc4/base_fw.h>
+#include <sof/list.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+struct comp_dev;
+
+/**
+ * \brief Performance data of a single module instance.
+ *
+ * Items are allocated from shared memory, they are updated by the core
+ * running the module and read by the core handling IPC.
+ */
+struct perf_data_item_comp {
+	/* reported data, layout as expected by the host */
+	struct ipc4_perf_data_item item;
+	/* number of processed periods since measurements have been started */
+	uint32_t total_iteration_count;
+	/* DSP cycles consumed since measurements have been started */
+	uint64_t total_cycles_consumed;
+	/* the longest iteration seen since measurements have been started */
+	uint64_t peak_cycles;
+	/* owner of the item, its period is used for KCPS computation */
+	struct comp_dev *dev;
+	/* core the module is running on */
+	uint32_t core;
+#if CONFIG_SOF_TELEMETRY_CPC_ACCOUNTING
+	/* cycles per chunk declared by the host, 0 when not declared */
+	uint32_t declared_cpc;
+	/* peak measured cycles per chunk, over all windows but the first */
+	uint32_t measured_cpc;
+	/* longest iteration of the window in platform timer cycles */
+	uint64_t window_peak;
+	/* iterations in the window */
+	uint32_t window_iterations;
+	/* completed windows */
+	uint32_t windows;
+	/* KCPS this item added to the budget of its core */
+	int32_t kcps_correction;
+#endif
+	/* entry in the list of registered items */
+	struct list_item list;
+};
+
+/**
+ * \brief Allocates and registers performance data item for the component.
+ * @param dev Component device.
+ * @return Pointer to the item or NULL when out of memory.
+ */
+struct perf_data_item_comp *perf_data_item_comp_register(struct comp_dev *dev);
+
+/**
+ * \brief Unregisters and frees performance data item.
+ * @param item Item returned by perf_data_item_comp_register(), may be NULL.
+ */
+void perf_data_item_comp_unregister(struct perf_data_item_comp *item);
+
+/**
+ * \brief Accounts cycles consumed by a single processing iteration.
+ * @param item Performance data item of the module, may be NULL.
+ * @param cycles Number of platform timer cycles consumed by the iteration.
+ */
+void perf_data_item_comp_update(struct perf_data_item_comp *item, uint64_t cycles);
+
+#if CONFIG_SOF_TELEMETRY_CPC_ACCOUNTING
+/**
+ * \brief Sets the cycles per chunk the module declared.
+ * @param item Performance data item of the module, may be NULL.
+ * @param cpc Declared cycles per chunk, 0 when unknown.
+ */
+void perf_data_item_comp_set_cpc(struct perf_data_item_comp *item, uint32_t cpc);
+#endif
+
+/**
+ * \brief Returns true when performance data are being collected.
+ */
+bool perf_meas_is_started(void);
+
+/**
+ * \brief Changes global performance measurements state.
+ * @param state One of enum ipc4_perf_measurements_state_set.
+ * @return 0 on success, negative error code otherwise.
+ */
+int perf_meas_set_state(uint32_t state);
+
+/**
+ * \brief Returns global performance measurements state.
+ */
+uint32_t perf_meas_get_state(void);
+
+/**
+ * \brief Fills struct ipc4_global_perf_data with per core totals followed
+ *	  by the items of all registered module instances.
+ * @param data Output buffer.
+ * @param max_size Size of the output buffer.
+ * @param data_size Size of the data written.
+ * @return 0 on success, negative error code otherwise.
+ */
+int perf_meas_get_global_data(char *data, uint32_t max_size, uint32_t *data_size);
+
+/**
+ * \brief Same as perf_meas_get_global_data() but reports
+ *	  struct ipc4_extended_global_perf_data with total cycles and
+ *	  iteration counts of each module instance.
+ */
+int perf_meas_get_extended_global_data(char *data, uint32_t max_size, uint32_t *data_size);
+
+/**
+ * \brief Returns the sum of average KCPS measured for the modules of a core.
+ * @param core Core ID.
+ */
+uint32_t perf_meas_get_core_kcps(uint32_t core);
+
+/**
+ * \brief Initializes performance monitor.
+ */
+void perf_meas_init(void);
+
+#endif /* __SOF_DEBUG_TELEMETRY_PERFORMANCE_MONITOR_H__ */
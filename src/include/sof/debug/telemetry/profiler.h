@@ -0,0 +1,37 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/debug/telemetry/profiler.h
+ * \brief Statistical PC sampling profiler
+ */
+
+#ifndef __SOF_DEBUG_TELEMETRY_PROFILER_H__
+#define __SOF_DEBUG_TELEMETRY_PROFILER_H__
+
+#include <stdint.h>
+
+#if CONFIG_SOF_PROFILER
+
+/**
+ * \brief Starts sampling with the given period, stops it when 0.
+ * @param period_us Sampling period in us, raised to
+ *	  CONFIG_SOF_PROFILER_MIN_PERIOD_US.
+ */
+void profiler_set_period(uint32_t period_us);
+
+/**
+ * \brief Initializes the sampling timer.
+ */
+void profiler_init(void);
+
+#else
+
+static inline void profiler_set_period(uint32_t period_us) { }
+static inline void profiler_init(void) { }
+
+#endif /* CONFIG_SOF_PROFILER */
+
+#endif /* __SOF_DEBUG_TELEMETRY_PROFILER_H__ */
@@ -0,0 +1,171 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/debug/telemetry/telemetry.h
+ * \brief Per core telemetry circular buffers
+ */
+
+#ifndef __SOF_DEBUG_TELEMETRY_TELEMETRY_H__
+#define __SOF_DEBUG_TELEMETRY_TELEMETRY_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** \brief Types of telemetry records */
+enum telemetry_record_type {
+	TELEMETRY_RECORD_XRUN = 0,	/**< xrun detected, payload is the xrun size */
+	TELEMETRY_RECORD_LATENCY = 1,	/**< measured latency in us */
+	TELEMETRY_RECORD_LOAD = 2,	/**< measured load in KCPS */
+	TELEMETRY_RECORD_CUSTOM = 3,	/**< module defined payload */
+	TELEMETRY_RECORD_TRACEPOINT = 4,	/**< struct telemetry_tracepoint */
+	TELEMETRY_RECORD_CLOCK = 5,	/**< DSP clock set by the DVFS governor in Hz */
+	TELEMETRY_RECORD_LOCK_STATS = 6,	/**< struct telemetry_lock_stats */
+	TELEMETRY_RECORD_PC_SAMPLE = 7,	/**< struct telemetry_pc_sample */
+	TELEMETRY_RECORD_CPC = 8,	/**< struct telemetry_cpc */
+	TELEMETRY_RECORD_LL_OVERRUN = 10,	/**< struct telemetry_ll_overrun */
+	TELEMETRY_RECORD_DP_QUEUE = 11,	/**< struct telemetry_dp_queue */
+	TELEMETRY_RECORD_CACHE_STATS = 12,	/**< struct telemetry_cache_stats */
+};
+
+/**
+ * \brief Payload of TELEMETRY_RECORD_CACHE_STATS records. Record resource id
+ *	  is IPC4_COMP_ID(0, core) for the totals of a core, posted once a
+ *	  second, or the id of a DP module for one of its queues, posted when
+ *	  the queue is freed. Counters are totals, cycles are platform timer
+ *	  cycles, a writeback and invalidate counts in both operations and its
+ *	  cycles in the invalidate ones.
+ */
+struct telemetry_cache_stats {
+	uint32_t invalidates;		/**< invalidate operations */
+	uint32_t writebacks;		/**< writeback operations */
+	uint64_t invalidate_bytes;	/**< bytes invalidated */
+	uint64_t writeback_bytes;	/**< bytes written back */
+	uint64_t invalidate_cycles;	/**< cycles spent invalidating */
+	uint64_t writeback_cycles;	/**< cycles spent writing back */
+} __attribute__((packed, aligned(4)));
+
+/**
+ * \brief Payload of TELEMETRY_RECORD_DP_QUEUE records, posted for each queue
+ *	  created for a DP module instance at prepare.
+ */
+struct telemetry_dp_queue {
+	uint32_t mode;		/**< DP_QUEUE_MODE_ flags chosen for the queue */
+	uint32_t size;		/**< data size of the queue in bytes */
+	uint32_t block;		/**< largest of the IBS and OBS at the queue */
+} __attribute__((packed, aligned(4)));
+
+/**
+ * \brief Payload of TELEMETRY_RECORD_LL_OVERRUN records, posted for each LL
+ *	  tick longer than the LL period. Record resource id is the address of
+ *	  the task furthest over its budget, or of the longest task when no
+ *	  task is over its budget. Cycles are platform timer cycles.
+ */
+struct telemetry_ll_overrun {
+	uint32_t task_uuid;	/**< first word of the task UUID */
+	uint32_t task_cycles;	/**< cycles of the task run */
+	uint32_t task_budget;	/**< budget of the task, 0 for none */
+	uint32_t tick_cycles;	/**< cycles of the whole tick */
+	uint32_t period_cycles;	/**< cycles of the LL period */
+	uint32_t skipped;	/**< non-critical tasks skipped in the tick */
+	uint32_t overruns;	/**< overrunning ticks of the scheduler so far */
+} __attribute__((packed, aligned(4)));
+
+/**
+ * \brief Payload of TELEMETRY_RECORD_CPC records, posted when a module
+ *	  instance is measured above the CPC it declared.
+ */
+struct telemetry_cpc {
+	uint32_t declared_cpc;	/**< CPC of the base module configuration */
+	uint32_t measured_cpc;	/**< peak measured CPC */
+} __attribute__((packed, aligned(4)));
+
+/**
+ * \brief Payload of TELEMETRY_RECORD_PC_SAMPLE records, record resource id
+ *	  is the address of the interrupted thread.
+ */
+struct telemetry_pc_sample {
+	uint32_t pc;		/**< interrupted program counter */
+} __attribute__((packed, aligned(4)));
+
+/**
+ * \brief Payload of TELEMETRY_RECORD_LOCK_STATS records, record resource id
+ *	  is the index of the lock. Counters are totals since boot, cycles
+ *	  are platform timer cycles.
+ */
+struct telemetry_lock_stats {
+	char name[16];			/**< null terminated lock name */
+	uint32_t acquires;		/**< number of acquisitions */
+	uint32_t contended;		/**< acquisitions which had to wait */
+	uint64_t spin_cycles;		/**< total cycles spent waiting */
+	uint32_t max_hold_cycles;	/**< longest time the lock was held */
+} __attribute__((packed, aligned(4)));
+
+/**
+ * \brief Header of every record placed in the telemetry buffer.
+ *
+ * The payload follows the header, both are padded to 32 bit words.
+ */
+struct telemetry_record {
+	uint16_t type;		/**< enum telemetry_record_type */
+	uint16_t size;		/**< payload size in bytes */
+	uint32_t resource_id;	/**< module id (LS word) and instance id (MS word) */
+	uint32_t timestamp;	/**< lower 32 bits of the platform timer */
+	uint32_t data[];	/**< payload */
+} __attribute__((packed, aligned(4)));
+
+/**
+ * \brief Telemetry ring of a single core.
+ *
+ * The ring is written only by its core and read only by the core handling
+ * IPC, so it needs no lock. Both positions are free running byte counters,
+ * the data size is a power of two.
+ */
+struct telemetry_ring {
+	uint32_t write_pos;	/**< updated by producer once record is written */
+	uint32_t read_pos;	/**< updated by consumer once records are read */
+	uint32_t size;		/**< size of data area in bytes */
+	uint32_t overruns;	/**< number of records dropped */
+	uint8_t data[];
+} __attribute__((packed, aligned(4)));
+
+/**
+ * \brief Posts a record into the telemetry buffer of the current core.
+ * @param type Record type, enum telemetry_record_type.
+ * @param resource_id Id of the module posting the record.
+ * @param data Payload.
+ * @param size Payload size in bytes.
+ * @return 0 on success, -ENOSPC when the record was dropped, -ENODEV when
+ *	   telemetry is not started.
+ */
+int telemetry_post(uint32_t type, uint32_t resource_id, const void *data, uint32_t size);
+
+/**
+ * \brief Handles TELEMETRY_STATE set request.
+ */
+int telemetry_set_state(const char *data, uint32_t size);
+
+/**
+ * \brief Handles TELEMETRY_STATE get request.
+ */
+int telemetry_get_state(char *data, uint32_t *data_size);
+
+/**
+ * \brief Moves unread records of all cores into the IPC reply, each core
+ *	  chunk is preceded by struct ipc4_telemetry_data_chunk.
+ */
+int telemetry_get_data(char *data, uint32_t max_size, uint32_t *data_size);
+
+/**
+ * \brief Returns total size in bytes of telemetry buffers of all cores.
+ */
+uint32_t telemetry_get_buffer_size(void);
+
+/**
+ * \brief Allocates telemetry buffers.
+ */
+int telemetry_init(void);
+
+#endif /* __SOF_DEBUG_TELEMETRY_TELEMETRY_H__ */
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/debug/telemetry/tracepoint.h
+ * \brief Static tracepoints of the audio hot path
+ */
+
+#ifndef __SOF_DEBUG_TELEMETRY_TRACEPOINT_H__
+#define __SOF_DEBUG_TELEMETRY_TRACEPOINT_H__
+
+#include <stdint.h>
+
+/** \brief Tracepoints, bit position in the runtime enable mask */
+enum sof_tracepoint_id {
+	SOF_TRACEPOINT_PIPELINE_COPY = 0,	/**< pipeline_copy(), pipeline id */
+	SOF_TRACEPOINT_LL_TASK = 1,		/**< LL task run, task address */
+	SOF_TRACEPOINT_MODULE_COPY = 2,		/**< module_adapter_copy(), component id */
+	SOF_TRACEPOINT_DP_TASK = 3,		/**< DP task run, task address */
+	SOF_TRACEPOINT_HOST_DMA = 4,		/**< host DMA completion, component id */
+	SOF_TRACEPOINT_DAI_COPY = 5,		/**< DAI DMA reload, component id */
+	SOF_TRACEPOINT_COUNT,
+};
+
+/** \brief Tracepoint phases */
+enum sof_tracepoint_phase {
+	SOF_TRACEPOINT_BEGIN = 0,	/**< start of a span */
+	SOF_TRACEPOINT_END = 1,		/**< end of the span started last on the core */
+	SOF_TRACEPOINT_INSTANT = 2,	/**< single event */
+};
+
+/**
+ * \brief Payload of TELEMETRY_RECORD_TRACEPOINT records, record resource id
+ *	  identifies the task or component.
+ */
+struct telemetry_tracepoint {
+	uint16_t id;		/**< enum sof_tracepoint_id */
+	uint16_t phase;		/**< enum sof_tracepoint_phase */
+	uint32_t bytes;		/**< bytes processed, 0 if not applicable */
+} __attribute__((packed, aligned(4)));
+
+#if CONFIG_SOF_TRACEPOINTS
+
+/** \brief Enabled tracepoints, set with TELEMETRY_STATE */
+extern uint32_t sof_tracepoint_mask;
+
+void sof_tracepoint_emit(uint32_t id, uint32_t phase, uint32_t resource_id, uint32_t bytes);
+
+/** \brief Costs a single predicted branch while the tracepoint is disabled */
+#define SOF_TRACEPOINT(id, phase, resource_id, bytes)				\
+	do {									\
+		if (__builtin_expect(sof_tracepoint_mask & (1u << (id)), 0))	\
+			sof_tracepoint_emit(id, phase, resource_id, bytes);	\
+	} while (0)
+
+#else
+
+#define SOF_TRACEPOINT(id, phase, resource_id, bytes) do { } while (0)
+
+#endif /* CONFIG_SOF_TRACEPOINTS */
+
+#endif /* __SOF_DEBUG_TELEMETRY_TRACEPOINT_H__ */
@@ -65,6 +65,8 @@ struct mtk_base_irq_data {
 	int irq_en_shift;
 	int irq_clr_reg;
 	int irq_clr_shift;
+	int irq_status_reg;
+	int irq_status_shift;
 	int irq_ap_en_reg;
 	int irq_ap_en_shift;
 	int irq_scp_en_reg;
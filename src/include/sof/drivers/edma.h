@@ -74,7 +74,8 @@
 #define EDMA_TCD_ATTR_DSIZE_32BYTE	0x0005
 #define EDMA_TCD_ATTR_DSIZE_64BYTE	0x0006
 
-#define EDMA_BUFFER_PERIOD_COUNT	2
+/* Half of the buffer is transferred per interrupt */
+#define EDMA_BUFFER_PERIOD_COUNT	(2 * CONFIG_IMX_DMA_PERIODS_PER_IRQ)
 
 #define EDMA_TCD_ALIGNMENT		32
 
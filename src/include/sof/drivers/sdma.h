@@ -127,8 +127,14 @@
 #define SDMA_BD_CMD_MASK	MASK(31, 24)
 #define SDMA_BD_CMD(cmd)	SET_BITS(31, 24, cmd)
 
-/* We don't need more than 4 buffer descriptors per channel */
+/* Buffer descriptors per channel, enough for two interrupts when the
+ * interrupts are coalesced
+ */
+#if CONFIG_IMX_DMA_PERIODS_PER_IRQ > 2
+#define SDMA_MAX_BDS		(2 * CONFIG_IMX_DMA_PERIODS_PER_IRQ)
+#else
 #define SDMA_MAX_BDS		4
+#endif
 
 #define SDMA_CMD_C0_SET_PM		0x4
 #define SDMA_CMD_C0_SET_DM		0x1
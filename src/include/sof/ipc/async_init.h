@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/ipc/async_init.h
+ * \brief Module instance initialization completed outside of the IPC context
+ */
+
+#ifndef __SOF_IPC_ASYNC_INIT_H__
+#define __SOF_IPC_ASYNC_INIT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct comp_dev;
+struct ipc4_module_bind_unbind;
+
+#if CONFIG_IPC4_ASYNC_INIT
+
+/**
+ * \brief Runs the rest of the initialization of a module instance in the
+ *	  low priority worker.
+ * @param dev Module instance, on the primary core.
+ * @param init Initialization to run.
+ * @return 0 when queued, negative error code to initialize synchronously.
+ *
+ * The init IPC is acknowledged as soon as the instance is created. Binds to
+ * the instance are queued and done once init succeeded, the host is then
+ * notified with a SOF_IPC4_MODULE_INIT_DONE resource event. An instance
+ * which failed to initialize is deleted.
+ */
+int ipc4_async_init_start(struct comp_dev *dev, int (*init)(struct comp_dev *dev));
+
+/**
+ * \brief Waits for the initialization of an instance being freed.
+ */
+void ipc4_async_init_cancel(struct comp_dev *dev);
+
+/**
+ * \brief Tells whether a module instance is still initializing.
+ */
+bool ipc4_async_init_pending(uint32_t comp_id);
+
+/**
+ * \brief Tells whether a pipeline has instances still initializing.
+ */
+bool ipc4_async_init_pipeline_pending(uint32_t pipeline_id);
+
+/**
+ * \brief Queues a bind involving an instance still initializing.
+ * @return 1 when queued, 0 when both instances are ready, -EBUSY when the
+ *	   source is on another core, -ENOMEM.
+ */
+int ipc4_async_init_queue_bind(const struct ipc4_module_bind_unbind *bu);
+
+/**
+ * \brief Drops a queued bind.
+ * @return True when the bind was queued.
+ */
+bool ipc4_async_init_drop_bind(const struct ipc4_module_bind_unbind *bu);
+
+/**
+ * \brief Starts the worker.
+ */
+int ipc4_async_init_setup(void);
+
+#else
+
+static inline int ipc4_async_init_setup(void) { return 0; }
+
+#endif
+
+#endif /* __SOF_IPC_ASYNC_INIT_H__ */
@@ -15,6 +15,9 @@
 #include <rtos/task.h>
 #include <rtos/spinlock.h>
 #include <rtos/sof.h>
+#if CONFIG_IPC_MSG_QUEUE_LOCKLESS
+#include <rtos/atomic.h>
+#endif
 #include <user/trace.h>
 #include <ipc/header.h>
 #include <ipc/stream.h>
@@ -50,6 +53,29 @@ extern struct tr_ctx ipc_tr;
 #define IPC_TASK_SECONDARY_CORE	BIT(2)
 #define IPC_TASK_POWERDOWN      BIT(3)
 
+/* Number of buckets of the IPC object indexes, a power of two */
+#define IPC_COMP_HASH_SIZE	32
+
+#if CONFIG_IPC_MSG_QUEUE_LOCKLESS
+enum ipc_msg_ring_id {
+	IPC_MSG_RING_HIGH = 0,
+	IPC_MSG_RING_LOW,
+	IPC_MSG_RING_COUNT,
+};
+
+/* bounded MPSC ring, the cell seq tells whether it is free or filled */
+struct ipc_msg_ring_cell {
+	atomic_t seq;
+	struct ipc_msg *msg;
+};
+
+struct ipc_msg_ring {
+	atomic_t head;		/* next cell to fill, any core */
+	uint32_t tail;		/* next cell to take, with ipc->lock held */
+	struct ipc_msg_ring_cell cells[CONFIG_IPC_MSG_QUEUE_LOCKLESS_SIZE];
+};
+#endif
+
 struct ipc {
 	struct k_spinlock lock;	/* locking mechanism */
 	void *comp_data;
@@ -58,11 +84,16 @@ struct ipc {
 	int pm_prepare_D3;	/* do we need to prepare for D3 */
 
 	struct list_item msg_list;	/* queue of messages to be sent */
+#if CONFIG_IPC_MSG_QUEUE_LOCKLESS
+	struct ipc_msg_ring msg_ring[IPC_MSG_RING_COUNT]; /* staged for msg_list */
+#endif
 	bool is_notification_pending;	/* notification is being sent to host */
 	uint32_t task_mask;		/* tasks to be completed by this IPC */
 	unsigned int core;		/* core, processing the IPC */
 
 	struct list_item comp_list;	/* list of component devices */
+	struct list_item comp_hash[IPC_COMP_HASH_SIZE];	/* comp_list by type and ID */
+	struct list_item ppl_hash[IPC_COMP_HASH_SIZE];	/* components by pipeline ID */
 
 	/* processing task */
 	struct task ipc_task;
@@ -74,6 +105,12 @@ struct ipc {
 	void *private;
 };
 
+/* Hash bucket of an IPC object ID, the IPC4 module instance is in the high half */
+static inline uint32_t ipc_comp_hash(uint32_t id)
+{
+	return (id ^ (id >> 16)) & (IPC_COMP_HASH_SIZE - 1);
+}
+
 #define ipc_set_drvdata(ipc, data) \
 	((ipc)->private = data)
 #define ipc_get_drvdata(ipc) \
@@ -36,6 +36,9 @@ struct ipc_msg {
 	uint32_t tx_size;	/* payload size in bytes */
 	void *tx_data;		/* pointer to payload data */
 	struct list_item list;
+#if CONFIG_IPC_MSG_QUEUE_LOCKLESS
+	atomic_t staged;	/* in an outbound ring, not on the list yet */
+#endif
 };
 
 /**
@@ -81,6 +84,31 @@ static inline struct ipc_msg *ipc_msg_init(uint32_t header, uint32_t size)
 	return ipc_msg_w_ext_init(header, 0, size);
 }
 
+#if CONFIG_IPC_MSG_QUEUE_LOCKLESS
+/**
+ * \brief Moves the staged messages to the message list.
+ * @param ipc IPC context, ipc->lock must be held.
+ */
+void ipc_msg_queue_drain(struct ipc *ipc);
+
+/**
+ * \brief Tells whether the message waits to be sent.
+ * @param msg IPC message.
+ * @return True if the message is staged or on the message list.
+ */
+static inline bool ipc_msg_is_queued(struct ipc_msg *msg)
+{
+	return atomic_get(&msg->staged) || !list_is_empty(&msg->list);
+}
+#else
+static inline void ipc_msg_queue_drain(struct ipc *ipc) { }
+
+static inline bool ipc_msg_is_queued(struct ipc_msg *msg)
+{
+	return !list_is_empty(&msg->list);
+}
+#endif
+
 /**
  * \brief Frees IPC message header and data.
  * @param msg The IPC message to be freed.
@@ -95,6 +123,8 @@ static inline void ipc_msg_free(struct ipc_msg *msg)
 
 	key = k_spin_lock(&ipc->lock);
 
+	/* a staged message must be on the list before it can be removed */
+	ipc_msg_queue_drain(ipc);
 	list_item_del(&msg->list);
 	rfree(msg->tx_data);
 	rfree(msg);
@@ -0,0 +1,70 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/ipc/stream_posn.h
+ * \brief Host stream positions published in FW Regs
+ */
+
+#ifndef __SOF_IPC_STREAM_POSN_H__
+#define __SOF_IPC_STREAM_POSN_H__
+
+#include <stdint.h>
+
+struct comp_dev;
+
+/**
+ * \brief Stream position slot of one host gateway.
+ */
+struct stream_posn {
+	uint32_t offset;	/**< slot offset in the FW Regs, 0 if none */
+	uint32_t seq;		/**< last seq written to the slot */
+};
+
+#if CONFIG_IPC4_STREAM_POSN
+
+/**
+ * \brief Takes a free stream position slot for a host gateway.
+ * @param sp Stream position slot.
+ * @param node_id Host gateway node id.
+ * @return 0 on success, -ENOSPC when all slots are taken.
+ */
+int stream_posn_get(struct stream_posn *sp, uint32_t node_id);
+
+/**
+ * \brief Releases the slot of a host gateway.
+ */
+void stream_posn_put(struct stream_posn *sp);
+
+/**
+ * \brief Clears the positions, e.g. when the host gateway is reset.
+ */
+void stream_posn_reset(struct stream_posn *sp);
+
+/**
+ * \brief Publishes the positions of the stream.
+ * @param sp Stream position slot.
+ * @param host Host component of the stream.
+ * @param host_posn Bytes processed by the host gateway.
+ */
+void stream_posn_update(struct stream_posn *sp, struct comp_dev *host, uint64_t host_posn);
+
+/**
+ * \brief Initializes the stream position registers.
+ */
+void stream_posn_init(void);
+
+#else
+
+static inline int stream_posn_get(struct stream_posn *sp, uint32_t node_id) { return 0; }
+static inline void stream_posn_put(struct stream_posn *sp) { }
+static inline void stream_posn_reset(struct stream_posn *sp) { }
+static inline void stream_posn_update(struct stream_posn *sp, struct comp_dev *host,
+				      uint64_t host_posn) { }
+static inline void stream_posn_init(void) { }
+
+#endif /* CONFIG_IPC4_STREAM_POSN */
+
+#endif /* __SOF_IPC_STREAM_POSN_H__ */
@@ -0,0 +1,86 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/ipc/time_corr.h
+ * \brief Gateway position to wallclock correlation published in FW Regs
+ */
+
+#ifndef __SOF_IPC_TIME_CORR_H__
+#define __SOF_IPC_TIME_CORR_H__
+
+#include <stdint.h>
+
+/**
+ * \brief Position model of one gateway.
+ *
+ * The position readings are accumulated for a window of
+ * CONFIG_IPC4_TIME_CORR_WINDOW readings, then the least squares line is
+ * published in the FW Regs slot and the next window is started.
+ */
+struct time_corr {
+	uint32_t offset;	/**< slot offset in the FW Regs, 0 if none */
+	uint32_t seq;		/**< last seq written to the slot */
+	uint32_t count;		/**< readings in the current window */
+	uint64_t wclk0;		/**< first reading of the window */
+	uint64_t pos0;
+	uint64_t wclk;		/**< last reading of the window */
+	int64_t sx;		/**< sums of the readings relative to the first */
+	int64_t sy;
+	int64_t sxx;
+	int64_t sxy;
+};
+
+#if CONFIG_IPC4_TIME_CORR
+
+/**
+ * \brief Takes a free time correlation slot for a gateway.
+ * @param tc Gateway position model.
+ * @param node_id Gateway node id.
+ * @return 0 on success, -ENOSPC when all slots are taken.
+ */
+int time_corr_get(struct time_corr *tc, uint32_t node_id);
+
+/**
+ * \brief Releases the slot of a gateway.
+ */
+void time_corr_put(struct time_corr *tc);
+
+/**
+ * \brief Restarts the model, e.g. when the gateway position is reset.
+ */
+void time_corr_reset(struct time_corr *tc);
+
+/**
+ * \brief Adds a position reading of the gateway to the model.
+ * @param tc Gateway position model.
+ * @param wclk Wallclock of the reading.
+ * @param position Position in bytes.
+ */
+void time_corr_update(struct time_corr *tc, uint64_t wclk, uint64_t position);
+
+/**
+ * \brief Publishes the host system time set by the host with the wallclock
+ *	  it was set at.
+ */
+void time_corr_set_host_time(uint64_t host_time, uint64_t dsp_time);
+
+/**
+ * \brief Initializes the time correlation registers.
+ */
+void time_corr_init(void);
+
+#else
+
+static inline int time_corr_get(struct time_corr *tc, uint32_t node_id) { return 0; }
+static inline void time_corr_put(struct time_corr *tc) { }
+static inline void time_corr_reset(struct time_corr *tc) { }
+static inline void time_corr_update(struct time_corr *tc, uint64_t wclk, uint64_t position) { }
+static inline void time_corr_set_host_time(uint64_t host_time, uint64_t dsp_time) { }
+static inline void time_corr_init(void) { }
+
+#endif /* CONFIG_IPC4_TIME_CORR */
+
+#endif /* __SOF_IPC_TIME_CORR_H__ */
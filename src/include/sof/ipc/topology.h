@@ -60,6 +60,10 @@ int ipc4_pipeline_complete(struct ipc *ipc, uint32_t comp_id, uint32_t cmd);
 int ipc4_find_dma_config(struct ipc_config_dai *dai, uint8_t *data_buffer, uint32_t size);
 int ipc4_pipeline_prepare(struct ipc_comp_dev *ppl_icd, uint32_t cmd);
 int ipc4_pipeline_trigger(struct ipc_comp_dev *ppl_icd, uint32_t cmd, bool *delayed);
+struct ipc4_init_block;
+#if CONFIG_IPC4_MODULE_CLONE
+void ipc4_init_block_put(struct ipc4_init_block *block);
+#endif
 
 #else
 #error "No or invalid IPC MAJOR version selected."
@@ -94,8 +98,41 @@ struct ipc_comp_dev {
 
 	/* lists */
 	struct list_item list;		/* list in components */
+	struct list_item hash_list;	/* list in the type and ID index */
+	struct list_item ppl_list;	/* list in the pipeline index, components only */
+
+#if CONFIG_IPC4_MODULE_CLONE
+	struct ipc4_init_block *init_block;	/* init request for copies, components only */
+#endif
 };
 
+/**
+ * \brief Add a component, buffer or pipeline to the IPC lists and indexes.
+ * @param ipc The global IPC context.
+ * @param icd The IPC component device, type, ID and for a component the
+ *	      pipeline ID have to be set.
+ */
+void ipc_comp_list_add(struct ipc *ipc, struct ipc_comp_dev *icd);
+
+/**
+ * \brief Remove a component, buffer or pipeline from the IPC lists and indexes.
+ * @param icd The IPC component device.
+ */
+void ipc_comp_list_del(struct ipc_comp_dev *icd);
+
+/**
+ * \brief Get the pipeline index bucket of a pipeline ID. The components in
+ * the bucket are in the order of their creation and may belong to other
+ * pipelines too, the pipeline ID of each has to be checked.
+ * @param ipc The global IPC context.
+ * @param ppl_id The pipeline ID.
+ * @return List of struct ipc_comp_dev linked by ppl_list.
+ */
+static inline struct list_item *ipc_ppl_bucket(struct ipc *ipc, uint32_t ppl_id)
+{
+	return &ipc->ppl_hash[ipc_comp_hash(ppl_id)];
+}
+
 /**
  * \brief Create a new IPC component.
  * @param ipc The global IPC context.
@@ -152,6 +189,54 @@ int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id);
  */
 int ipc_pipeline_complete(struct ipc *ipc, uint32_t comp_id);
 
+#if CONFIG_BUFFER_COMPACTION
+/**
+ * \brief Packs the buffers of the idle components of the current core.
+ * @param ipc The global IPC context.
+ * @return Bytes moved.
+ *
+ * The data of the buffers and DP queues of components which are not running
+ * is moved to lower free blocks of the heap, merging the free space above.
+ */
+uint32_t ipc_buffers_compact(struct ipc *ipc);
+
+/**
+ * \brief Runs ipc_buffers_compact() from a background EDF task, once a stop
+ *	  or pause still in progress has been done by the pipeline task.
+ * @param ipc The global IPC context.
+ */
+void ipc_buffers_compact_defer(struct ipc *ipc);
+#else
+static inline uint32_t ipc_buffers_compact(struct ipc *ipc) { return 0; }
+static inline void ipc_buffers_compact_defer(struct ipc *ipc) { }
+#endif
+
+#if CONFIG_IPC4_DEFERRED_FREE
+/**
+ * \brief Queues a disconnected component to be freed by a background task.
+ * @param dev Component removed from the IPC component list.
+ * @return False if it was not queued and has to be freed by the caller.
+ */
+bool ipc_comp_free_defer(struct comp_dev *dev);
+#else
+static inline bool ipc_comp_free_defer(struct comp_dev *dev) { return false; }
+#endif
+
+#if CONFIG_ZEPHYR_LL_FLOW_ORDER
+/**
+ * \brief Ranks the pipelines of the current core in data flow order.
+ * @param ipc The global IPC context.
+ *
+ * A pipeline gets the length of the longest chain of pipelines of the same
+ * core feeding it through cross-pipeline buffers, its LL task then runs after
+ * the tasks of its producers of the same priority. Called after binds and
+ * unbinds, tasks already queued keep their place until scheduled again.
+ */
+void ipc_pipeline_flow_order(struct ipc *ipc);
+#else
+static inline void ipc_pipeline_flow_order(struct ipc *ipc) { }
+#endif
+
 /**
  * \brief Connect components together on a pipeline.
  * @param ipc The global IPC context.
@@ -116,6 +116,11 @@ struct ams_shared_context {
 	struct ams_producer producer_table[AMS_ROUTING_TABLE_SIZE];
 	struct uuid_idx uuid_table[AMS_SERVICE_UUID_TABLE_SIZE];
 
+	/* cores with consumers of each message type, indexed by message type ID - 1.
+	 * Written with the lock taken, read without it by producers.
+	 */
+	uint32_t consumer_cores[AMS_SERVICE_UUID_TABLE_SIZE];
+
 	uint32_t slot_uses[CONFIG_CORE_COUNT];
 	/* marks which core already processed slot */
 	uint32_t slot_done[CONFIG_CORE_COUNT];
@@ -126,6 +131,11 @@ struct ams_shared_context {
 struct ams_context {
 	/* shared context must be always accessed with shared->c taken */
 	struct ams_shared_context *shared;
+
+	/* consumers registered on this core, copy of their rt_table entries
+	 * used to call them without taking the shared context
+	 */
+	struct ams_consumer_entry local_rt[AMS_ROUTING_TABLE_SIZE];
 };
 
 struct ams_task {
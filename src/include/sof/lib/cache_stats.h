@@ -0,0 +1,110 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/lib/cache_stats.h
+ * \brief Accounting of data cache maintenance
+ *
+ * With CONFIG_SOF_CACHE_STATS the invalidate and writeback operations of
+ * the coherent API and of the shared DP queues are counted per core, and
+ * per queue for the DP queues, together with the bytes they cover and the
+ * platform timer cycles they take. Without it the wrappers below are the
+ * plain dcache operations.
+ */
+
+#ifndef __SOF_LIB_CACHE_STATS_H__
+#define __SOF_LIB_CACHE_STATS_H__
+
+#include <rtos/bit.h>
+#include <rtos/cache.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * \brief Cache maintenance counters. Invalidates and writebacks of a queue
+ *	  are issued by different cores, so each field has a single writer.
+ */
+struct cache_stats {
+	uint32_t invalidates;		/**< invalidate operations */
+	uint32_t writebacks;		/**< writeback operations */
+	uint64_t invalidate_bytes;	/**< bytes invalidated */
+	uint64_t writeback_bytes;	/**< bytes written back */
+	uint64_t invalidate_cycles;	/**< cycles spent invalidating */
+	uint64_t writeback_cycles;	/**< cycles spent writing back */
+};
+
+#define CACHE_STATS_INVALIDATE	BIT(0)
+#define CACHE_STATS_WRITEBACK	BIT(1)
+
+#if CONFIG_SOF_CACHE_STATS
+
+#include <rtos/timer.h>
+
+/**
+ * \brief Returns the counters of a core.
+ */
+struct cache_stats *cache_stats_core(int core);
+
+/**
+ * \brief Accounts one cache operation to the current core and to stats.
+ * @param stats Counters of the buffer, NULL for the core only.
+ * @param ops CACHE_STATS_ flags of the operation.
+ * @param size Bytes covered by the operation.
+ * @param start Cycle count before the operation.
+ *
+ * The counters are updated without a lock, an update preempted by another
+ * cache operation of the same core may be lost.
+ */
+void cache_stats_account(struct cache_stats *stats, uint32_t ops, size_t size, uint64_t start);
+
+#if CONFIG_SOF_TELEMETRY
+struct telemetry_cache_stats;
+
+/**
+ * \brief Fills a TELEMETRY_RECORD_CACHE_STATS payload.
+ */
+void cache_stats_record(struct telemetry_cache_stats *record, const struct cache_stats *stats);
+
+/**
+ * \brief Posts the counters of all cores to the telemetry buffers, record
+ *	  resource id is IPC4_COMP_ID(0, core).
+ */
+void cache_stats_post(void);
+#endif
+
+#define __cache_stats_op(stats, ops, op, addr, size)			\
+	do {								\
+		uint64_t __start = sof_cycle_get_64();			\
+									\
+		op(addr, size);						\
+		cache_stats_account(stats, ops, size, __start);		\
+	} while (0)
+
+#define cache_stats_invalidate_region(stats, addr, size)		\
+	__cache_stats_op(stats, CACHE_STATS_INVALIDATE,			\
+			 dcache_invalidate_region, addr, size)
+
+#define cache_stats_writeback_region(stats, addr, size)			\
+	__cache_stats_op(stats, CACHE_STATS_WRITEBACK,			\
+			 dcache_writeback_region, addr, size)
+
+#define cache_stats_writeback_invalidate_region(stats, addr, size)	\
+	__cache_stats_op(stats, CACHE_STATS_WRITEBACK | CACHE_STATS_INVALIDATE, \
+			 dcache_writeback_invalidate_region, addr, size)
+
+#else
+
+#define cache_stats_invalidate_region(stats, addr, size)		\
+	dcache_invalidate_region(addr, size)
+
+#define cache_stats_writeback_region(stats, addr, size)			\
+	dcache_writeback_region(addr, size)
+
+#define cache_stats_writeback_invalidate_region(stats, addr, size)	\
+	dcache_writeback_invalidate_region(addr, size)
+
+#endif
+
+#endif /* __SOF_LIB_CACHE_STATS_H__ */
@@ -49,6 +49,48 @@ int core_kcps_adjust(int core, int kcps_delta);
  */
 int core_kcps_get(int core);
 
+/**
+ * \brief Get the enabled core with the most spare KCPS
+ *
+ * The load of a core is the larger of its declared KCPS and, when
+ * performance measurements are built in, the measured KCPS of the
+ * modules running on it.
+ *
+ * @param preferred The core returned when no other core has more spare KCPS
+ */
+int core_kcps_least_loaded(int preferred);
+
+/**
+ * \brief Get the lowest numbered core with enough spare KCPS
+ *
+ * Enabled cores are checked in order. When none of them has room the
+ * first disabled core is returned, the caller is to enable it. When all
+ * cores are enabled the one with the most spare KCPS is returned.
+ *
+ * @param kcps Spare KCPS the core needs
+ */
+int core_kcps_pack(int kcps);
+
+#if CONFIG_KCPS_DVFS_GOVERNOR
+/**
+ * \brief Account busy time of the current core to the DVFS governor
+ *
+ * @param cycles Busy time in platform timer cycles
+ */
+void core_kcps_busy_add(uint32_t cycles);
+
+/**
+ * \brief Report the end of an LL tick of the current core to the governor
+ *
+ * Accounts the tick as busy time, flags a tick close to overrun and once
+ * per window updates the measured load of the core. On the primary core
+ * the clock is then set according to the load of all cores.
+ *
+ * @param start Start of the tick in platform timer cycles
+ */
+void core_kcps_ll_tick(uint64_t start);
+#endif
+
 /**
  * \brief Init KCPS budget mechanism
  */
@@ -181,6 +181,8 @@ struct dai_data {
 	int xrun;				/* true if we are doing xrun recovery */
 
 	pcm_converter_func process;		/* processing function */
+	pcm_converter_gain_func process_gain;	/* processing function with fused gain */
+	struct pcm_gain *gain;			/* gain of process_gain, NULL if none */
 
 	uint32_t period_bytes;			/* number of bytes per one period */
 	uint64_t total_data_processed;
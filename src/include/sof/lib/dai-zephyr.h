@@ -26,6 +26,7 @@
 #include <rtos/sof.h>
 #include <rtos/spinlock.h>
 #include <sof/trace/trace.h>
+#include <sof/ipc/time_corr.h>
 #include <sof/ipc/topology.h>
 #include <sof/audio/pcm_converter.h>
 #include <sof/audio/ipc-config.h>
@@ -35,6 +36,8 @@
 #include <zephyr/device.h>
 #include <zephyr/drivers/dai.h>
 
+struct chmap_remap;
+
 /** \addtogroup sof_dai_drivers DAI Drivers
  *  DAI Drivers API specification.
  *  @{
@@ -98,6 +101,29 @@ struct dai_group {
 	struct list_item list;
 };
 
+#if CONFIG_COMP_DAI_GROUP_HW_SYNC
+/**
+ * \brief Platform operations releasing a DAI group with one hardware operation
+ */
+struct dai_group_sync_ops {
+	/**
+	 * Arms the group, DAIs triggered until go() or disarm() are held by the
+	 * hardware. Returns -ENOTSUP if the group or cmd can't be synchronized.
+	 */
+	int (*arm)(struct dai_group *group, int cmd);
+
+	/**
+	 * Releases the armed DAIs at once
+	 */
+	void (*go)(struct dai_group *group);
+
+	/**
+	 * Disarms the group after a DAI of the group failed to trigger
+	 */
+	void (*disarm)(struct dai_group *group);
+};
+#endif
+
 /**
  * \brief llp slot info for memory window
  */
@@ -106,6 +132,21 @@ struct llp_slot_info {
 	uint32_t reg_offset;
 };
 
+#if CONFIG_COMP_DAI_ADAPTIVE_WATERMARK
+/**
+ * \brief Adaptive DMA buffer fill of a playback DAI
+ */
+struct dai_watermark {
+	uint32_t bytes;				/* current watermark */
+	uint32_t min_bytes;			/* lower bound */
+	uint32_t max_bytes;			/* upper bound, the DMA buffer size */
+	uint32_t low;				/* lowest DMA fill seen in the window */
+	uint32_t copies;			/* copies in the window */
+	uint32_t window;			/* copies per window */
+	uint32_t xrun_count;			/* pipeline xruns already accounted */
+};
+#endif
+
 /**
  * \brief DAI runtime data
  */
@@ -125,6 +166,9 @@ struct dai_data {
 	int xrun;				/* true if we are doing xrun recovery */
 
 	pcm_converter_func process;		/* processing function */
+	pcm_converter_gain_func process_gain;	/* processing function with fused gain */
+	struct pcm_gain *gain;			/* gain of process_gain, NULL if none */
+	struct chmap_remap *remap;		/* multi-endpoint channel copy */
 
 	uint32_t period_bytes;			/* number of bytes per one period */
 	uint64_t total_data_processed;
@@ -145,10 +189,23 @@ struct dai_data {
 
 	/* llp slot info in memory windows */
 	struct llp_slot_info slot_info;
+#if CONFIG_IPC4_TIME_CORR
+	struct time_corr time_corr;		/* LLP to wallclock model */
+#endif
 	/* save current sampling for current dai device */
 	uint32_t sampling;
 	/* fast mode, use one byte memory to save repreated cycles */
 	bool fast_mode;
+#if CONFIG_COMP_DAI_DIRECT_DMA
+	/* local buffer set up on the DMA buffer memory, NULL if none */
+	struct comp_buffer *direct_buffer;
+	void *direct_addr;			/* own memory of direct_buffer */
+	uint32_t direct_size;			/* own size of direct_buffer */
+	uint32_t direct_pending;		/* bytes between DMA and local position */
+#endif
+#if CONFIG_COMP_DAI_ADAPTIVE_WATERMARK
+	struct dai_watermark watermark;
+#endif
 };
 
 /* these 3 are here to satisfy clk.c and ssp.h interconnection, will be removed leter */
@@ -190,6 +247,20 @@ struct dai_group *dai_group_get(uint32_t group_id, uint32_t flags);
  */
 void dai_group_put(struct dai_group *group);
 
+#if CONFIG_COMP_DAI_GROUP_HW_SYNC
+/**
+ * \brief Registers the platform hardware synchronization of DAI groups.
+ *
+ * \param[in] ops Operations, NULL to go back to the software walk
+ */
+void dai_group_sync_register(const struct dai_group_sync_ops *ops);
+
+/**
+ * \brief Returns the registered hardware synchronization, NULL if none.
+ */
+const struct dai_group_sync_ops *dai_group_sync_get(void);
+#endif
+
 /**
  * \brief API to initialize a platform DAI.
  *
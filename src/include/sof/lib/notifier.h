@@ -37,8 +37,15 @@ enum notify_id {
 	NOTIFIER_ID_COUNT
 };
 
+/** \brief Number of caller index buckets per event type, power of two. */
+#define NOTIFIER_CALLER_HASH		8
+
 struct notify {
 	struct list_item list[NOTIFIER_ID_COUNT]; /* list of callback handles */
+	/* callback handles without caller filter */
+	struct list_item any_caller[NOTIFIER_ID_COUNT];
+	/* callback handles with caller filter, indexed by the caller */
+	struct list_item by_caller[NOTIFIER_ID_COUNT][NOTIFIER_CALLER_HASH];
 	struct k_spinlock lock;	/* list lock */
 };
 
@@ -63,6 +63,7 @@
 #define __SOF_LIB_MANAGER_H__
 
 #include <stdint.h>
+#include <sof/list.h>
 #include <rimage/sof/user/manifest.h>
 
 #define LIB_MANAGER_MAX_LIBS				16
@@ -78,10 +79,20 @@ struct ipc_lib_msg {
 	struct list_item list;
 };
 
+/* Module with text and rodata mapped to SRAM */
+struct lib_manager_mod_res {
+	struct list_item list;	/* in ext_library::mods_resident */
+	uint32_t module_id;
+	uint32_t pages;		/* mapped text and rodata pages */
+	uint32_t refs;		/* allocated instances */
+};
+
 struct ext_library {
 	struct k_spinlock lock;	/* last locking CPU record */
 	struct sof_man_fw_desc *desc[LIB_MANAGER_MAX_LIBS];
 	uint32_t mods_exec_load_cnt;
+	struct list_item mods_resident;	/* most recently used first */
+	uint32_t mods_resident_pages;
 	struct ipc_lib_msg *lib_notif_pool;
 	uint32_t lib_notif_count;
 
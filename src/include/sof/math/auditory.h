@@ -14,6 +14,21 @@
 #include <sof/math/log.h>
 #include <stdint.h>
 
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3
+#define AUDITORY_GENERIC	0
+#define AUDITORY_HIFI3		1
+#else
+#define AUDITORY_GENERIC	1
+#define AUDITORY_HIFI3		0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define AUDITORY_GENERIC	1
+#define AUDITORY_HIFI3		0
+#endif
+
 #define AUDITORY_EPS_Q31	1 /* Smallest nonzero Q1.31 value */
 #define AUDITORY_LOG2_2P25_Q16	Q_CONVERT_FLOAT(25.0, 16) /* log2(2^25) */
 
@@ -78,6 +93,17 @@ int16_t psy_mel_to_hz(int16_t mel);
  */
 int psy_get_mel_filterbank(struct psy_mel_filterbank *mel_fb);
 
+/**
+ * \brief Integrate power spectrum with one Mel filterbank triangle.
+ *
+ * \param[in]  power_spectra Power spectra from the start bin of the triangle, Q2.30.
+ * \param[in]  weights       Triangle weights, Q1.15.
+ * \param[in]  num_bins      Number of bins in the triangle.
+ * \return                   Mel band energy, Q3.45.
+ */
+int64_t psy_mel_triangle_sum(const int32_t *power_spectra, const int16_t *weights,
+			     int num_bins);
+
 /**
  * \brief Convert linear complex spectra from FFT into Mel band energies in desired
  * logarithmic format.
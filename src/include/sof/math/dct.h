@@ -30,5 +30,6 @@ struct dct_plan_16 {
 };
 
 int dct_initialize_16(struct dct_plan_16 *dct);
+void dct_free_16(struct dct_plan_16 *dct);
 
 #endif /* __SOF_MATH_DCT_H__ */
@@ -28,4 +28,99 @@
 
 int32_t sofm_exp_int32(int32_t x);
 
+/* Block functions compute 2^t with t = x * log2(base) split into integer k
+ * and fraction f, 2^f is a degree 7 polynomial and 2^k is a shift. Unlike
+ * the scalar sofm_exp_int32() the cost is the same for every input, so the
+ * loops can run two samples per iteration on HiFi.
+ */
+#define SOFM_EXP2_T_QY		26		/* t is Q6.26 */
+#define SOFM_EXP2_LOG2E_Q30	1549082005	/* log2(e) */
+#define SOFM_EXP2_LOG2_10_DIV20_Q30	178344657	/* log2(10) / 20 */
+#define SOFM_DB2LIN_MIN_DB_Q24	(-100 * (1 << 24))
+
+/* ln(2)^n / n! in Q1.31, n = 1 .. 7 */
+#define SOFM_EXP2_C1	1488522236
+#define SOFM_EXP2_C2	515882496
+#define SOFM_EXP2_C3	119194166
+#define SOFM_EXP2_C4	20654775
+#define SOFM_EXP2_C5	2863360
+#define SOFM_EXP2_C6	330788
+#define SOFM_EXP2_C7	32755
+
+/* Q1.31 x Q1.31 -> Q1.31 with rounding, the same as AE_MULFP32X2RAS() */
+static inline int32_t sofm_exp2_mulf(int32_t a, int32_t b)
+{
+	return (int32_t)(((int64_t)a * b + (1LL << 30)) >> 31);
+}
+
+/* Input x in Q(32 - qx).qx is scaled by m in Q2.30 into t in Q6.26 */
+static inline int32_t sofm_exp2_arg(int32_t x, int32_t m, int qx)
+{
+	int32_t r = sofm_exp2_mulf(x, m); /* Q(qx - 1) */
+
+	return qx >= SOFM_EXP2_T_QY + 1 ? r >> (qx - SOFM_EXP2_T_QY - 1) :
+					  r << (SOFM_EXP2_T_QY + 1 - qx);
+}
+
+/* 2^f for f in Q1.31 from 0.0 up to 1.0, returned as Q2.30 */
+static inline int32_t sofm_exp2_frac(int32_t f)
+{
+	int32_t p = SOFM_EXP2_C7;
+
+	p = SOFM_EXP2_C6 + sofm_exp2_mulf(p, f);
+	p = SOFM_EXP2_C5 + sofm_exp2_mulf(p, f);
+	p = SOFM_EXP2_C4 + sofm_exp2_mulf(p, f);
+	p = SOFM_EXP2_C3 + sofm_exp2_mulf(p, f);
+	p = SOFM_EXP2_C2 + sofm_exp2_mulf(p, f);
+	p = SOFM_EXP2_C1 + sofm_exp2_mulf(p, f);
+	return (1 << 30) + (sofm_exp2_mulf(p, f) >> 1);
+}
+
+/* y * 2^k with y in Q2.30 to Q(32 - qy).qy, with rounding and saturation */
+static inline int32_t sofm_exp2_scale(int32_t y, int32_t k, int qy)
+{
+	int shift = 30 - qy - k;
+
+	if (shift < 0)
+		return INT32_MAX;
+
+	if (shift > 31)
+		return 0;
+
+	return shift ? (int32_t)(((int64_t)y + (1LL << (shift - 1))) >> shift) : y;
+}
+
+/* 2^t for t in Q6.26 to output in Q(32 - qy).qy */
+static inline int32_t sofm_exp2_fixed(int32_t t, int qy)
+{
+	int32_t f = (t & ((1 << SOFM_EXP2_T_QY) - 1)) << (31 - SOFM_EXP2_T_QY);
+
+	return sofm_exp2_scale(sofm_exp2_frac(f), t >> SOFM_EXP2_T_QY, qy);
+}
+
+/**
+ * \brief Exponent of a block of values.
+ * @param x Input values in Q4.28, -5.0 .. +5.0.
+ * @param y Output values in Q9.23.
+ * @param n Number of values, x and y may be the same array.
+ */
+void sofm_exp_int32_vec(const int32_t *x, int32_t *y, int n);
+
+/**
+ * \brief Exponent of a block of values, block version of exp_fixed().
+ * @param x Input values in Q5.27, -11.5 .. +7.6.
+ * @param y Output values in Q12.20, saturated to INT32_MAX.
+ * @param n Number of values, x and y may be the same array.
+ */
+void sofm_exp_fixed_vec(const int32_t *x, int32_t *y, int n);
+
+/**
+ * \brief Decibels to linear of a block of values, block version of
+ *	  db2lin_fixed().
+ * @param db Input values in Q8.24.
+ * @param y Output values in Q12.20, saturated to INT32_MAX.
+ * @param n Number of values, db and y may be the same array.
+ */
+void sofm_db2lin_fixed_vec(const int32_t *db, int32_t *y, int n);
+
 #endif
@@ -18,7 +18,10 @@
 #if defined(__XCC__)
 
 #include <xtensa/config/core-isa.h>
-#if XCHAL_HAVE_HIFI3 || XCHAL_HAVE_HIFI4
+#if XCHAL_HAVE_HIFI5
+#undef FFT_GENERIC
+#define FFT_HIFI5
+#elif XCHAL_HAVE_HIFI3 || XCHAL_HAVE_HIFI4
 #undef FFT_GENERIC
 #define FFT_HIFI3
 #endif
@@ -51,10 +54,25 @@ struct fft_plan {
 	struct icomplex16 *outb16;	/* pointer to output integer complex buffer */
 };
 
+/* Real input FFT of size N done with a N/2 points complex FFT */
+struct fft_real_plan {
+	uint32_t size;	/* real fft size N */
+	uint32_t len;	/* real fft length in exponent of 2 */
+	struct fft_plan *plan;	/* N/2 points complex fft */
+	struct icomplex32 *inb;	/* N/2 points complex fft input buffer */
+	struct icomplex32 *outb;	/* N/2 points complex fft output buffer */
+};
+
 /* interfaces of the library */
 struct fft_plan *fft_plan_new(void *inb, void *outb, uint32_t size, int bits);
 void fft_execute_16(struct fft_plan *plan, bool ifft);
 void fft_execute_32(struct fft_plan *plan, bool ifft);
 void fft_plan_free(struct fft_plan *plan16);
 
+/* interfaces for real input and output FFT, the spectra have N/2 + 1 bins */
+struct fft_real_plan *fft_real_plan_new(uint32_t size);
+void fft_real_execute_32(struct fft_real_plan *plan, const int32_t *in, struct icomplex32 *out);
+void fft_real_inverse_32(struct fft_real_plan *plan, const struct icomplex32 *in, int32_t *out);
+void fft_real_plan_free(struct fft_real_plan *plan);
+
 #endif /* __SOF_FFT_H__ */
@@ -21,22 +21,32 @@
 #endif
 #endif
 
-/* Define SOFM_FIR_FORCEARCH 0/2/3 in build command line or temporarily in
- * this file to override the default auto detection.
+/* Define SOFM_FIR_FORCEARCH 0/2/3/5 in build command line or temporarily in
+ * this file to override the default auto detection. HiFi5 shares the HiFi3
+ * state and setup code, only the filter core is replaced so FIR_HIFI3 is set
+ * as well.
  */
 #ifdef SOFM_FIR_FORCEARCH
-#  if SOFM_FIR_FORCEARCH == 3
+#  if SOFM_FIR_FORCEARCH == 5
 #    define FIR_GENERIC	0
 #    define FIR_HIFIEP	0
 #    define FIR_HIFI3	1
+#    define FIR_HIFI5	1
+#  elif SOFM_FIR_FORCEARCH == 3
+#    define FIR_GENERIC	0
+#    define FIR_HIFIEP	0
+#    define FIR_HIFI3	1
+#    define FIR_HIFI5	0
 #  elif SOFM_FIR_FORCEARCH == 2
 #    define FIR_GENERIC	0
 #    define FIR_HIFIEP	1
 #    define FIR_HIFI3	0
+#    define FIR_HIFI5	0
 #  elif SOFM_FIR_FORCEARCH == 0
 #    define FIR_GENERIC	1
 #    define FIR_HIFIEP	0
 #    define FIR_HIFI3	0
+#    define FIR_HIFI5	0
 #  else
 #    error "Unsupported SOFM_FIR_FORCEARCH value."
 #  endif
@@ -47,8 +57,14 @@
 #    if XCHAL_HAVE_HIFI2EP == 1
 #      define FIR_HIFIEP	1
 #      define FIR_HIFI3	0
+#      define FIR_HIFI5	0
+#    elif XCHAL_HAVE_HIFI5 == 1
+#      define FIR_HIFI3	1
+#      define FIR_HIFI5	1
+#      define FIR_HIFIEP	0
 #    elif XCHAL_HAVE_HIFI3 == 1 || XCHAL_HAVE_HIFI4 == 1
 #      define FIR_HIFI3	1
+#      define FIR_HIFI5	0
 #      define FIR_HIFIEP	0
 #    else
 #      error "No HIFIEP or HIFI3 found. Cannot build FIR module."
@@ -56,6 +72,7 @@
 #  else
 #    define FIR_GENERIC	1
 #    define FIR_HIFI3	0
+#    define FIR_HIFI5	0
 #  endif /* __XCC__ */
 #endif /* SOFM_FIR_FORCEARCH */
 
@@ -63,5 +63,21 @@ void fir_32x16_hifi3(struct fir_state_32x16 *fir, ae_int32 x, ae_int32 *y,
 void fir_32x16_2x_hifi3(struct fir_state_32x16 *fir, ae_int32 x0, ae_int32 x1,
 			ae_int32 *y0, ae_int32 *y1, int shift);
 
+#if FIR_HIFI5
+void fir_32x16_2x_hifi5(struct fir_state_32x16 *fir, ae_int32 x0, ae_int32 x1,
+			ae_int32 *y0, ae_int32 *y1, int shift);
+#endif
+
+/* Two samples FIR core, uses the wider MAC units of HiFi5 when available */
+static inline void fir_32x16_2x_hifi(struct fir_state_32x16 *fir, ae_int32 x0, ae_int32 x1,
+				     ae_int32 *y0, ae_int32 *y1, int shift)
+{
+#if FIR_HIFI5
+	fir_32x16_2x_hifi5(fir, x0, x1, y0, y1, shift);
+#else
+	fir_32x16_2x_hifi3(fir, x0, x1, y0, y1, shift);
+#endif
+}
+
 #endif
 #endif /* __SOF_MATH_FIR_HIFI3_H__ */
@@ -0,0 +1,66 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_MATH_IIR_DF2T_MC_H__
+#define __SOF_MATH_IIR_DF2T_MC_H__
+
+#include <sof/math/iir_df2t.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Channel-parallel DF2T IIR. A group of 2 or 4 channels with the same number
+ * of biquads in series is filtered in lockstep, one channel per lane. The
+ * coefficients are interleaved per lane (SoA) so that the same coefficient of
+ * all lanes is adjacent in memory:
+ *
+ *   coef[(section * SOF_EQ_IIR_NBIQUAD + k) * lanes + lane]
+ *
+ * with k in the normal {a2, a1, b2, b1, b0, shift, gain} order. The delay line
+ * of a section is d0 of all lanes followed by d1 of all lanes. The result is
+ * bit exact with iir_df2t() run separately for every channel.
+ */
+
+#define IIR_DF2T_MC_MAX_LANES	4
+
+struct iir_state_df2t_mc {
+	unsigned int lanes; /* Number of channels filtered in parallel, 2 or 4 */
+	unsigned int biquads; /* Number of IIR 2nd order sections in series */
+	int32_t *coef; /* Pointer to interleaved IIR coefficients */
+	int64_t *delay; /* Pointer to IIR delay line */
+};
+
+struct sof_eq_iir_header;
+
+int iir_coef_size_df2t_mc(unsigned int lanes, unsigned int biquads);
+
+int iir_delay_size_df2t_mc(unsigned int lanes, unsigned int biquads);
+
+/**
+ * \brief Set up a channel-parallel filter from per channel responses.
+ * \param iir Filter state to initialize.
+ * \param config Responses of the lanes, all must have the same number of
+ *	  sections and the sections must be in series.
+ * \param lanes Number of lanes, 2 or 4.
+ * \param coef Storage for interleaved coefficients of
+ *	  iir_coef_size_df2t_mc() bytes, 8 bytes aligned.
+ * \return 0 on success or negative error code.
+ */
+int iir_init_coef_df2t_mc(struct iir_state_df2t_mc *iir,
+			  struct sof_eq_iir_header *config[], unsigned int lanes,
+			  int32_t *coef);
+
+void iir_init_delay_df2t_mc(struct iir_state_df2t_mc *iir, int64_t **delay);
+
+void iir_reset_df2t_mc(struct iir_state_df2t_mc *iir);
+
+/**
+ * \brief Filter one sample of every lane.
+ * \param iir Filter state.
+ * \param x Q1.31 samples of the lanes, replaced by the filter output. Must be
+ *	  8 bytes aligned.
+ */
+void iir_df2t_mc(struct iir_state_df2t_mc *iir, int32_t *x);
+
+#endif /* __SOF_MATH_IIR_DF2T_MC_H__ */
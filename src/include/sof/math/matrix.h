@@ -15,6 +15,21 @@
 #include <stdint.h>
 #include <string.h>
 
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3
+#define MAT_GENERIC	0
+#define MAT_HIFI3	1
+#else
+#define MAT_GENERIC	1
+#define MAT_HIFI3	0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define MAT_GENERIC	1
+#define MAT_HIFI3	0
+#endif
+
 struct mat_matrix_16b {
 	int16_t rows;
 	int16_t columns;
@@ -75,6 +90,16 @@ static inline int16_t *mat_get_row_vector_16b(struct mat_matrix_16b *mat, int ro
 	return mat->data + row * mat->columns;
 }
 
+/* Round the Q_a + Q_b product sum to Q_c, the shift is Q_a + Q_b - Q_c - 1 */
+static inline int16_t mat_round_16b(int64_t s, int shift_minus_one)
+{
+	/* If all data is Q0 */
+	if (shift_minus_one == -1)
+		return (int16_t)s;
+
+	return (int16_t)(((s >> shift_minus_one) + 1) >> 1);
+}
+
 int mat_multiply(struct mat_matrix_16b *a, struct mat_matrix_16b *b, struct mat_matrix_16b *c);
 
 int mat_multiply_elementwise(struct mat_matrix_16b *a, struct mat_matrix_16b *b,
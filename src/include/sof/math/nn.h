@@ -0,0 +1,112 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/* Neural network inference with int8 weights and activations */
+
+#ifndef __SOF_MATH_NN_H__
+#define __SOF_MATH_NN_H__
+
+#include <user/nn.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3
+#define SOFM_NN_GENERIC	0
+#define SOFM_NN_HIFI3	1
+#else
+#define SOFM_NN_GENERIC	1
+#define SOFM_NN_HIFI3	0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define SOFM_NN_GENERIC	1
+#define SOFM_NN_HIFI3	0
+#endif
+
+struct sofm_nn_layer {
+	const struct sof_nn_layer_header *hdr;
+	const int32_t *bias[2];		/**< input and hidden state biases */
+	const int8_t *weights[2];	/**< input and hidden state weights */
+	int8_t *history;		/**< DWCONV previous kernel - 1 inputs */
+	int16_t *hidden;		/**< GRU state in Q1.15 */
+	int8_t *hidden_s8;		/**< GRU state in Q1.7, padded */
+	int in_stride;			/**< padded row length of input weights */
+	int out_stride;			/**< padded output length */
+	bool relu;			/**< ReLU fused to the output */
+};
+
+struct sofm_nn {
+	void *model;			/**< copy of the blob, holds the weights */
+	struct sofm_nn_layer *layers;
+	int num_layers;
+	int input_size;
+	int input_shift;
+	int output_size;
+	int8_t *act[2];			/**< ping-pong buffers of the activations */
+	int32_t *acc;			/**< scratch for accumulators */
+	int16_t *gates;			/**< scratch for GRU gate inputs */
+};
+
+/**
+ * \brief Load a model. The weights are copied to memory of the given
+ * capabilities, e.g. SOF_MEM_CAPS_L3 for large models. A ReLU layer is
+ * fused to the output of a preceding FC or DWCONV layer.
+ *
+ * \param[out]  nn    Network
+ * \param[in]   blob  Model blob, see user/nn.h
+ * \param[in]   size  Blob size in bytes
+ * \param[in]   caps  Memory capabilities for the weights
+ * \return 0 or negative error code
+ */
+int sofm_nn_init(struct sofm_nn *nn, const void *blob, size_t size, uint32_t caps);
+void sofm_nn_free(struct sofm_nn *nn);
+
+/**
+ * \brief Clear the DWCONV histories and the GRU states.
+ * \param[in,out]  nn  Network
+ */
+void sofm_nn_reset(struct sofm_nn *nn);
+
+/**
+ * \brief Run the network for a frame of int8 input.
+ * \param[in,out]  nn  Network
+ * \param[in]      in  input_size values
+ * \return output_size values, valid until the next run
+ */
+const int8_t *sofm_nn_run(struct sofm_nn *nn, const int8_t *in);
+
+/**
+ * \brief Run the network for a frame of 16 bit features, e.g. cepstral
+ * coefficients from MFCC. The features are shifted right by the
+ * input_shift of the model and saturated to int8.
+ * \param[in,out]  nn  Network
+ * \param[in]      in  input_size features
+ * \return output_size values, valid until the next run
+ */
+const int8_t *sofm_nn_run_s16(struct sofm_nn *nn, const int16_t *in);
+
+/**
+ * \brief Matrix times vector with bias, out[r] = bias[r] + w[r] . x
+ * \param[in]   w       rows x stride weights, 32 bit aligned
+ * \param[in]   x       stride inputs, 32 bit aligned
+ * \param[in]   bias    rows biases
+ * \param[out]  out     rows accumulators
+ * \param[in]   rows    Number of rows
+ * \param[in]   stride  Row length, a multiple of four
+ */
+void sofm_nn_matvec_s8(const int8_t *w, const int8_t *x, const int32_t *bias,
+		       int32_t *out, int rows, int stride);
+
+/**
+ * \brief Index of the largest output, e.g. the detected class.
+ * \param[in]  out  Output of the network
+ * \param[in]  n    Number of outputs
+ */
+int sofm_nn_argmax(const int8_t *out, int n);
+
+#endif /* __SOF_MATH_NN_H__ */
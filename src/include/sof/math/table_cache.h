@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/* Cache of read-only coefficient tables shared by module instances */
+
+#ifndef __SOF_MATH_TABLE_CACHE_H__
+#define __SOF_MATH_TABLE_CACHE_H__
+
+#include <rtos/alloc.h>
+#include <ipc/topology.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum sofm_table_type {
+	SOFM_TABLE_WIN_RECTANGULAR = 0,
+	SOFM_TABLE_WIN_BLACKMAN,
+	SOFM_TABLE_WIN_HAMMING,
+	SOFM_TABLE_WIN_POVEY,
+	SOFM_TABLE_DCT_II_ORTHO,
+	SOFM_TABLE_CEPSTRAL_LIFTER,
+};
+
+/**
+ * \brief Identification of a table, instances asking for an equal key
+ * share the same copy.
+ */
+struct sofm_table_key {
+	uint16_t type;		/**< enum sofm_table_type */
+	uint16_t bits;		/**< word length of the values */
+	int32_t length;		/**< number of values or first dimension */
+	int32_t param;		/**< type specific, e.g. shape or second dimension */
+};
+
+/**
+ * \brief Computes the table contents.
+ * \param[out]  table  Table to fill, zeroed
+ * \param[in]   key    Key the table was requested with
+ */
+typedef void (*sofm_table_fill)(void *table, const struct sofm_table_key *key);
+
+#if CONFIG_MATH_TABLE_CACHE
+
+/**
+ * \brief Returns a table for the key, computing it with fill if no instance
+ * on this core holds one yet. The table must not be modified.
+ * \param[in]  key   Table identification
+ * \param[in]  size  Table size in bytes
+ * \param[in]  fill  Function to compute the table
+ * \return Pointer to the table, NULL if out of memory
+ */
+void *sofm_table_get(const struct sofm_table_key *key, size_t size, sofm_table_fill fill);
+
+/**
+ * \brief Releases a table returned by sofm_table_get() on the same core,
+ * the last release frees it.
+ * \param[in]  table  Table to release, NULL is ignored
+ */
+void sofm_table_put(void *table);
+
+#else
+
+static inline void *sofm_table_get(const struct sofm_table_key *key, size_t size,
+				   sofm_table_fill fill)
+{
+	void *table = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, size);
+
+	if (table)
+		fill(table, key);
+
+	return table;
+}
+
+static inline void sofm_table_put(void *table)
+{
+	rfree(table);
+}
+
+#endif /* CONFIG_MATH_TABLE_CACHE */
+
+#endif /* __SOF_MATH_TABLE_CACHE_H__ */
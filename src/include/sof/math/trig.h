@@ -13,6 +13,17 @@
 
 #include <stdint.h>
 
+#if defined(__XCC__)
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI5 == 1 || XCHAL_HAVE_HIFI4 == 1 || XCHAL_HAVE_HIFI3 == 1
+#define CORDIC_BLOCK_HIFI 1
+#endif
+#endif
+
+#if !defined(CORDIC_BLOCK_HIFI)
+#define CORDIC_BLOCK_GENERIC 1
+#endif
+
 #define PI_DIV2_Q4_28 421657428
 #define PI_DIV2_Q3_29 843314856
 #define PI_Q4_28      843314857
@@ -36,11 +47,43 @@ struct cordic_cmpx {
 	int32_t im;
 };
 
+/* Phase accumulator sine oscillator */
+struct cordic_osc {
+	int32_t w;	/* Angle radians Q4.28, 0 .. 2 * pi */
+	int32_t w_step;	/* Angle step per sample Q4.28, 0 .. pi */
+};
+
 void cordic_approx(int32_t th_rad_fxp, int32_t a_idx, int32_t *sign, int32_t *b_yn, int32_t *xn,
 		   int32_t *th_cdc_fxp);
 int32_t is_scalar_cordic_acos(int32_t realvalue, int16_t numiters);
 int32_t is_scalar_cordic_asin(int32_t realvalue, int16_t numiters);
 void cmpx_cexp(int32_t sign, int32_t b_yn, int32_t xn, cordic_cfg type, struct cordic_cmpx *cexp);
+
+/**
+ * Block versions of sin_fixed_32b() and cos_fixed_32b(), the output is bit
+ * exact with them. On HiFi two angles are rotated with each instruction.
+ * Input is Q4.28 in range [-2*pi, 2*pi), output is Q1.31. The input and
+ * output may be the same array.
+ */
+void sin_fixed_32b_vec(const int32_t *th_rad_fxp, int32_t *y, int n);
+void cos_fixed_32b_vec(const int32_t *th_rad_fxp, int32_t *y, int n);
+
+/**
+ * CORDIC vectoring mode approximation of four quadrant inverse tangent.
+ * Inputs y and x are Q1.31 or any other equal format, output is angle of
+ * (x, y) in Q3.29 radians in range [-pi, pi]. Zero is returned for
+ * (0, 0). Error is below 2e-7 radians for full scale vectors and grows
+ * as the vector length decreases, e.g. 5e-7 for 1/64 of full scale.
+ */
+int32_t atan2_fixed_32b(int32_t y, int32_t x);
+void atan2_fixed_32b_vec(const int32_t *y, const int32_t *x, int32_t *th, int n);
+
+/**
+ * Generates n samples of sine in Q1.31 and advances the oscillator phase,
+ * the same as calling sin_fixed_32b() for each sample and incrementing the
+ * angle modulo 2 * pi.
+ */
+void cordic_osc_sin_32b(struct cordic_osc *osc, int32_t *y, int n);
 /* Input is Q4.28, output is Q1.31 */
 /**
  * Compute fixed point cordicsine with table lookup and interpolation
@@ -0,0 +1,160 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/* Cross correlation functions */
+
+#ifndef __SOF_MATH_XCORR_H__
+#define __SOF_MATH_XCORR_H__
+
+#include <sof/math/fft.h>
+#include <stdint.h>
+
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3
+#define SOFM_XCORR_GENERIC	0
+#define SOFM_XCORR_HIFI3	1
+#else
+#define SOFM_XCORR_GENERIC	1
+#define SOFM_XCORR_HIFI3	0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define SOFM_XCORR_GENERIC	1
+#define SOFM_XCORR_HIFI3	0
+#endif
+
+/**
+ * \brief Streaming time domain cross correlation of two 16 bit signals. The
+ * cost per frame grows with the number of lags, use for short lags.
+ */
+struct sofm_xcorr_16 {
+	int16_t *x;		/**< 2 * max_lag history and the new frames of x */
+	int16_t *y;		/**< max_lag history and the new frames of y */
+	int64_t *r;		/**< 2 * max_lag + 1 accumulated lags */
+	int max_lag;
+	int max_frames;
+};
+
+/**
+ * \brief Streaming FFT based cross correlation of two 16 bit signals. The
+ * cross spectra of blocks are accumulated, so the cost per frame grows only
+ * with the logarithm of the block length, use for long lags.
+ */
+struct sofm_xcorr_fft_16 {
+	struct fft_real_plan *plan;
+	int16_t *x;		/**< 2 * max_lag history and a block of x */
+	int16_t *y;		/**< max_lag history and a block of y */
+	int32_t *time;		/**< FFT size work buffer */
+	struct icomplex32 *x_spec;	/**< bins work buffer */
+	struct icomplex32 *y_spec;	/**< bins work buffer */
+	int64_t *acc;		/**< accumulated cross spectrum, real and imaginary */
+	int max_lag;
+	int block;		/**< block length B, FFT size is 2B */
+	int bins;		/**< B + 1 */
+	int fill;		/**< frames in the current block */
+};
+
+/**
+ * \brief Accumulate the cross correlation of x and y.
+ *
+ * r[k + max_lag] += sum(x[i + k] * y[i]), i = 0 .. n - 1, for the lags
+ * k = -max_lag .. max_lag. The samples x[-max_lag] to x[n - 1 + max_lag]
+ * need to be valid. The products of Q1.15 samples are summed as Q2.30.
+ *
+ * \param[in]      x        First signal
+ * \param[in]      y        Second signal
+ * \param[in]      n        Number of samples of y
+ * \param[in]      max_lag  Largest lag to compute
+ * \param[in,out]  r        2 * max_lag + 1 accumulated lags
+ */
+void sofm_xcorr_acc_16(const int16_t *x, const int16_t *y, int n, int max_lag, int64_t *r);
+
+/**
+ * \brief Find the lag of the largest value of accumulated cross correlation.
+ * \param[in]  r        2 * max_lag + 1 lags
+ * \param[in]  max_lag  Largest lag
+ * \return Lag -max_lag .. max_lag
+ */
+int sofm_xcorr_peak(const int64_t *r, int max_lag);
+
+/**
+ * \brief Convert accumulated lags to 32 bits.
+ * \param[in]   r        2 * max_lag + 1 lags, Q2.30 product sums
+ * \param[in]   max_lag  Largest lag
+ * \param[in]   shift    Right shift to apply, e.g. the log2 of the number of
+ *                       accumulated samples for a Q2.30 average
+ * \param[out]  out      2 * max_lag + 1 saturated values
+ */
+void sofm_xcorr_to_32(const int64_t *r, int max_lag, int shift, int32_t *out);
+
+/**
+ * \brief Initialize a streaming time domain cross correlation.
+ * \param[out]  xc          Correlation state
+ * \param[in]   max_lag     Largest lag to compute
+ * \param[in]   max_frames  Largest number of frames per process call
+ * \return 0 or negative error code
+ */
+int sofm_xcorr_16_init(struct sofm_xcorr_16 *xc, int max_lag, int max_frames);
+void sofm_xcorr_16_free(struct sofm_xcorr_16 *xc);
+
+/**
+ * \brief Clear the accumulated lags, the signal history is kept.
+ * \param[in,out]  xc  Correlation state
+ */
+void sofm_xcorr_16_reset(struct sofm_xcorr_16 *xc);
+
+/**
+ * \brief Accumulate the correlation of new frames of x and y. The result for
+ * y is delayed by max_lag frames to have the future of x available.
+ *
+ * \param[in,out]  xc      Correlation state
+ * \param[in]      x       First signal, e.g. a channel of an interleaved stream
+ * \param[in]      y       Second signal
+ * \param[in]      stride  Distance of successive samples in x and y
+ * \param[in]      frames  Number of frames, up to max_frames
+ */
+void sofm_xcorr_16_process(struct sofm_xcorr_16 *xc, const int16_t *x, const int16_t *y,
+			   int stride, int frames);
+
+/**
+ * \brief Initialize a streaming FFT based cross correlation.
+ * \param[out]  xc       Correlation state
+ * \param[in]   max_lag  Largest lag to compute
+ * \param[in]   block    Block length, power of two and at least 2 * max_lag
+ * \return 0 or negative error code
+ */
+int sofm_xcorr_fft_16_init(struct sofm_xcorr_fft_16 *xc, int max_lag, int block);
+void sofm_xcorr_fft_16_free(struct sofm_xcorr_fft_16 *xc);
+
+/**
+ * \brief Clear the accumulated cross spectrum, the signal history is kept.
+ * \param[in,out]  xc  Correlation state
+ */
+void sofm_xcorr_fft_16_reset(struct sofm_xcorr_fft_16 *xc);
+
+/**
+ * \brief Accumulate new frames of x and y, the cross spectrum is updated for
+ * every complete block. The result for y is delayed by max_lag frames.
+ *
+ * \param[in,out]  xc      Correlation state
+ * \param[in]      x       First signal
+ * \param[in]      y       Second signal
+ * \param[in]      stride  Distance of successive samples in x and y
+ * \param[in]      frames  Number of frames, any number
+ */
+void sofm_xcorr_fft_16_process(struct sofm_xcorr_fft_16 *xc, const int16_t *x,
+			       const int16_t *y, int stride, int frames);
+
+/**
+ * \brief Get the lags of the accumulated cross spectrum, in the same scale
+ * as with sofm_xcorr_16_process() for the processed complete blocks.
+ *
+ * \param[in,out]  xc  Correlation state, the work buffers are used
+ * \param[out]     r   2 * max_lag + 1 lags
+ */
+void sofm_xcorr_fft_16_get(struct sofm_xcorr_fft_16 *xc, int64_t *r);
+
+#endif /* __SOF_MATH_XCORR_H__ */
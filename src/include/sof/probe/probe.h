@@ -97,6 +97,42 @@ int probe_point_info(struct sof_ipc_probe_info_params *data, uint32_t max_size);
  */
 int probe_point_remove(uint32_t count, const uint32_t *buffer_id);
 
+#if CONFIG_PROBE_IPC_RECORD
+/*
+ * \brief Record an IPC message in the extraction stream
+ *
+ * The message is recorded while extraction probe points are set so that
+ * the audio and the control traffic can be replayed with the same timing.
+ *
+ * param[in] primary - primary message word
+ * param[in] extension - extension message word
+ * param[in] payload - mailbox payload of the message
+ * param[in] size - bytes of payload to record
+ */
+void probe_ipc_record(uint32_t primary, uint32_t extension, const void *payload,
+		      uint32_t size);
+#endif
+
+#if CONFIG_PROBE_EXTRACT_REDUCE
+/*
+ * \brief Set data reduction of extraction probe points
+ *
+ * param[in] count - number of probe points configured this call
+ * param[in] opts - array of size 'count' with options of probe points
+ */
+int probe_point_set_options(uint32_t count, const struct probe_extraction_options *opts);
+#endif
+
+#if CONFIG_PROBE_INJECT_STAGED
+/*
+ * \brief Set format of data sent by the host to injection DMAs
+ *
+ * param[in] count - number of DMAs configured this call
+ * param[in] fmts - array of size 'count' with formats of DMAs
+ */
+int probe_dma_set_format(uint32_t count, const struct probe_injection_format *fmts);
+#endif
+
 /**
  * \brief Retrieves probes structure.
  * \return Pointer to probes structure.
@@ -43,6 +43,12 @@ struct processing_module;
  * the task deadline and set it in Zephyr thread properties, the final scheduling decision is made
  * by Zephyr.
  *
+ * With CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL tasks don't get their own threads. Each core
+ * keeps a fixed pool of worker threads instead, ready tasks are picked in deadline order.
+ * The deadline is extended by the number of periods already buffered in module output
+ * queues. Idle workers may take tasks of other cores if the module is marked as
+ * dp_core_agnostic, stack_size and task_priority of scheduler_dp_task_init() are then ignored.
+ *
  * Each time tick the scheduler iterates through the list of all active tasks and calculates
  * a deadline based on
  *  - knowledge how the modules are bound
@@ -24,6 +24,40 @@ struct edf_task_pdata {
 	void *ctx;
 };
 
+/** \brief EDF task classes, from the shortest latency target */
+enum edf_task_class {
+	EDF_CLASS_IPC = 0,	/**< host IPC processing */
+	EDF_CLASS_DRAIN,	/**< stream draining, like KPB */
+	EDF_CLASS_BACKGROUND,	/**< trace, telemetry and other deferred work */
+	EDF_CLASS_COUNT,
+};
+
+#if CONFIG_ZEPHYR_EDF_CLASSES
+/** \brief Queueing delay statistics of an EDF task class */
+struct edf_class_stats {
+	uint32_t runs;		/**< task runs */
+	uint32_t misses;	/**< runs started after the class latency target */
+	uint32_t delay_max_us;	/**< longest queueing delay */
+	uint64_t delay_sum_us;	/**< sum of the queueing delays */
+};
+
+/**
+ * \brief Sets the class of an EDF task, tasks are background ones by default.
+ */
+static inline void schedule_task_edf_set_class(struct task *task, enum edf_task_class cls)
+{
+	task->priority = cls;
+}
+
+/**
+ * \brief Copies the queueing delay statistics of a class.
+ * \return 0 or -EINVAL for an unknown class.
+ */
+int scheduler_edf_class_stats(enum edf_task_class cls, struct edf_class_stats *stats);
+#else
+static inline void schedule_task_edf_set_class(struct task *task, enum edf_task_class cls) { }
+#endif
+
 int scheduler_init_edf(void);
 
 int schedule_task_init_edf(struct task *task, const struct sof_uuid_entry *uid,
@@ -69,10 +69,12 @@ struct ll_schedule_domain {
 	atomic_t total_num_tasks;	/**< total number of registered tasks */
 	atomic_t enabled_cores;		/**< number of enabled cores */
 	uint32_t ticks_per_ms;		/**< number of clock ticks per ms */
+	uint32_t period_us;		/**< tick period in microseconds */
 	int type;			/**< domain type */
 	int clk;			/**< source clock */
 	bool synchronous;		/**< are tasks should be synchronous */
 	bool full_sync;			/**< tasks should be full synchronous, no time dependent */
+	uint32_t periods_per_tick;	/**< full_sync registrable task periods per tick */
 	void *priv_data;		/**< pointer to private data */
 	bool enabled[CONFIG_CORE_COUNT];		/**< enabled cores */
 	const struct ll_schedule_domain_ops *ops;	/**< domain ops */
@@ -92,6 +94,13 @@ static inline struct ll_schedule_domain *dma_domain_get(void)
 	return sof_get()->platform_dma_domain;
 }
 
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+static inline struct ll_schedule_domain *fast_domain_get(void)
+{
+	return sof_get()->platform_fast_domain;
+}
+#endif
+
 static inline struct ll_schedule_domain *domain_init
 				(int type, int clk, bool synchronous,
 				 const struct ll_schedule_domain_ops *ops)
@@ -103,11 +112,13 @@ static inline struct ll_schedule_domain *domain_init
 	domain->clk = clk;
 	domain->synchronous = synchronous;
 	domain->full_sync = false;
+	domain->periods_per_tick = 1;
 #ifdef __ZEPHYR__
 	domain->ticks_per_ms = k_ms_to_cyc_ceil64(1);
 #else
 	domain->ticks_per_ms = clock_ms_to_ticks(clk, 1);
 #endif
+	domain->period_us = LL_TIMER_PERIOD_US;
 	domain->ops = ops;
 	/* maximum value means no tick has been set to timer */
 	domain->next_tick = UINT64_MAX;
@@ -241,7 +252,18 @@ struct ll_schedule_domain *zephyr_dma_domain_init(struct dma *dma_array,
 						  int clk);
 #endif /* CONFIG_DMA_DOMAIN */
 struct ll_schedule_domain *zephyr_domain_init(int clk);
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+struct ll_schedule_domain *zephyr_fast_domain_init(int clk);
+#endif
 #define timer_domain_init(timer, clk) zephyr_domain_init(clk)
+#if CONFIG_ZEPHYR_LL_TIMEOUT_COALESCE
+uint64_t zephyr_domain_align_expiry(struct ll_schedule_domain *domain, uint64_t expiry);
+#endif
+#if CONFIG_ZEPHYR_LL_TICKLESS
+uint64_t zephyr_domain_tick(struct ll_schedule_domain *domain);
+void zephyr_domain_sleep(struct ll_schedule_domain *domain, uint64_t next);
+void zephyr_domain_wake(struct ll_schedule_domain *domain, uint64_t next);
+#endif
 #endif
 
 struct ll_schedule_domain *dma_multi_chan_domain_init(struct dma *dma_array,
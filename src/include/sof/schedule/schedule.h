@@ -37,9 +37,17 @@ enum {
 				  *  and will be unified with SOF_SCHEDULE_EDF for Zephyr builds
 				  *  current implementation of Zephyr based EDF is depreciated now
 				  */
+	SOF_SCHEDULE_LL_FAST,	/**< Low latency timer with a shorter period,
+				  *  preempts SOF_SCHEDULE_LL_TIMER
+				  */
 	SOF_SCHEDULE_COUNT	/**< indicates number of scheduler types */
 };
 
+/** \brief Task flags */
+#define SOF_SCHEDULE_TASK_NON_CRITICAL	BIT(0) /**< LL task that may be skipped
+						 *  in an overrunning tick
+						 */
+
 /** \brief Scheduler free available flags */
 #define SOF_SCHEDULER_FREE_IRQ_ONLY	BIT(0) /**< Free function disables only
 						 *  interrupts
@@ -27,6 +27,19 @@ struct dma_trace_buf {
 	uint32_t avail;		/* bytes available to read */
 };
 
+#if CONFIG_TRACE_BINARY_PERCORE
+/* compact trace entries of one core, see struct log_compact_block_header */
+struct dtrace_core_ring {
+	uint8_t *addr;		/* ring base address */
+	volatile uint32_t w;	/* bytes written, updated by owning core only */
+	volatile uint32_t r;	/* bytes read, updated by trace_work() only */
+	uint32_t dropped;	/* entries dropped, updated by owning core only */
+	uint32_t dropped_sent;	/* dropped entries already reported to host */
+	uint64_t last_ts;	/* timestamp of last written entry */
+	uint64_t drain_ts;	/* timestamp of last read entry */
+};
+#endif
+
 struct dma_trace_data {
 	struct dma_sg_config config;
 	struct dma_trace_buf dmatb;
@@ -40,6 +53,9 @@ struct dma_trace_data {
 	struct task dmat_work;
 	uint32_t enabled;
 	uint32_t copy_in_progress;
+#if CONFIG_DMA_COPY_ASYNC
+	uint32_t copy_pending;		/* copy queued, pointers not updated yet */
+#endif
 	uint32_t stream_tag;
 	uint32_t active_stream_tag;
 	uint32_t dma_copy_align;	/* Minimal chunk of data possible to be
@@ -48,6 +64,10 @@ struct dma_trace_data {
 	uint32_t dropped_entries;	/* amount of dropped entries */
 	struct k_spinlock lock;		/* dma trace lock */
 	uint64_t time_delta;		/* difference between the host time */
+#if CONFIG_TRACE_BINARY_PERCORE
+	struct dtrace_core_ring rings[CONFIG_CORE_COUNT];
+	uint8_t *block;			/* block being merged from a ring */
+#endif
 };
 
 int dma_trace_init_early(struct sof *sof);
@@ -63,6 +83,10 @@ void dma_trace_off(void);
 
 void dtrace_event(const char *e, uint32_t size);
 void dtrace_event_atomic(const char *e, uint32_t length);
+#if CONFIG_TRACE_BINARY_PERCORE
+void dtrace_event_compact(uint32_t uid, uint32_t id_0, uint32_t id_1, uint32_t entry,
+			  uint64_t timestamp, int arg_count, const uint32_t *args);
+#endif
 
 static inline bool dma_trace_initialized(const struct dma_trace_data *d)
 {
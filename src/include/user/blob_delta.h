@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __USER_BLOB_DELTA_H__
+#define __USER_BLOB_DELTA_H__
+
+#include <stdint.h>
+
+/* "DELT", first word of a delta update instead of the component blob */
+#define SOF_BLOB_DELTA_MAGIC	0x544c4544
+
+/*
+ * A delta update replaces size bytes at offset of the current configuration
+ * blob of a component with data[]. It is sent as the payload of a normal
+ * blob set, the total size is the header plus size. Components that do not
+ * support delta updates, or have no blob yet, reject it.
+ */
+struct sof_blob_delta {
+	uint32_t magic;		/* SOF_BLOB_DELTA_MAGIC */
+	uint32_t offset;	/* offset of the first changed byte in the blob */
+	uint32_t size;		/* number of changed bytes */
+
+	/* reserved */
+	uint32_t reserved[1];
+
+	uint8_t data[];		/* new contents of the range */
+} __attribute__((packed));
+
+#endif /* __USER_BLOB_DELTA_H__ */
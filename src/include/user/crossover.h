@@ -74,6 +74,12 @@
   *             the config takes the coefficients for one biquad and
   *             assigns it to both biquads of the LR4.
   *
+  *             With layout SOF_CROSSOVER_LAYOUT_LR4 each LR4 has both of
+  *             its biquads in a row, coef[(num_sinks - 1)*4], in the order
+  *             [LP0, LP0, HP0, HP0, LP1, LP1, ...]. It is the layout of the
+  *             filter state, all channels then use the coefficients in
+  *             place instead of a copy of them per LR4 and channel.
+  *
   *             <1st Low Pass LR4>
   *             int32_t coef_a2       Q2.30 format
   *             int32_t coef_a1       Q2.30 format
@@ -90,12 +96,17 @@
   *             ... At most 3 Low Pass LR4s and 3 High Pass LR4s ...
   *
   */
+/* Layouts of the coefficients data */
+#define SOF_CROSSOVER_LAYOUT_BIQUAD	0 /* one biquad per LR4 */
+#define SOF_CROSSOVER_LAYOUT_LR4	1 /* both biquads of each LR4 */
+
 struct sof_crossover_config {
 	uint32_t size;
 	uint32_t num_sinks;
+	uint32_t layout; /* SOF_CROSSOVER_LAYOUT_ */
 
 	/* reserved */
-	uint32_t reserved[4];
+	uint32_t reserved[3];
 
 	uint32_t assign_sink[SOF_CROSSOVER_MAX_STREAMS];
 	struct sof_eq_iir_biquad coef[];
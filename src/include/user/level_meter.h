@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __USER_LEVEL_METER_H__
+#define __USER_LEVEL_METER_H__
+
+#include <stdint.h>
+
+/*
+ * Level meter memory window.
+ *
+ * The firmware publishes per channel peak and RMS levels of the metered
+ * streams into a table of slots, the host reads them without any IPC.
+ * Levels are absolute values in Q1.31, i.e. INT32_MAX is full scale
+ * regardless of the stream sample format.
+ *
+ * A slot is updated under a sequence counter: seq is odd while the
+ * firmware writes the levels. The host reads seq, the levels and seq again
+ * and retries when the two values differ or are odd. The host may write
+ * window_ms at any time, it is applied at the end of the current window.
+ */
+
+#define LEVEL_METER_WINDOW_MAGIC	0x4c564d54	/* "LVMT" */
+#define LEVEL_METER_WINDOW_VERSION	1
+
+/* max number of published channels per slot */
+#define LEVEL_METER_MAX_CHANNELS	8
+
+/* measurement window limits in milliseconds */
+#define LEVEL_METER_WINDOW_MS_MIN	1
+#define LEVEL_METER_WINDOW_MS_MAX	5000
+
+struct level_meter_slot {
+	uint32_t in_use;	/* non zero if the slot is assigned */
+	uint32_t id;		/* metered component ID */
+	uint32_t seq;		/* odd while the levels are updated */
+	uint32_t window_ms;	/* measurement window, writable by the host */
+	uint32_t channels;	/* number of valid entries in peak[] and rms[] */
+	uint32_t rate;		/* stream sample rate */
+	uint32_t peak[LEVEL_METER_MAX_CHANNELS];	/* peak level, Q1.31 */
+	uint32_t rms[LEVEL_METER_MAX_CHANNELS];		/* RMS level, Q1.31 */
+} __attribute__((packed, aligned(4)));
+
+struct level_meter_window {
+	uint32_t magic;		/* LEVEL_METER_WINDOW_MAGIC */
+	uint16_t version;	/* LEVEL_METER_WINDOW_VERSION */
+	uint16_t num_slots;	/* number of entries in slots[] */
+	struct level_meter_slot slots[];
+} __attribute__((packed, aligned(4)));
+
+#endif /* __USER_LEVEL_METER_H__ */
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __USER_LOOPBACK_LATENCY_H__
+#define __USER_LOOPBACK_LATENCY_H__
+
+#include <stdint.h>
+
+/*
+ * Loopback latency component.
+ *
+ * The component sits on a playback path and has a second source, the
+ * capture of a loopback (an electrical or acoustic one) of its output. On
+ * request it replaces its output with a maximum length sequence burst on
+ * all channels and correlates the burst with the first channel of the
+ * loopback. The lag of the correlation peak is the round trip latency in
+ * frames from the component output back to its loopback input.
+ *
+ * The configuration is set with config ID LOOPBACK_LATENCY_SET_CONFIG, for
+ * IPC3 it is the type of the binary control data. Setting it starts a
+ * measurement. The last result is read with LOOPBACK_LATENCY_GET_RESULT
+ * and each result is also posted as a TELEMETRY_RECORD_LATENCY record in
+ * microseconds. Timestamps are sof_cycle_get_64() cycles of the LL tick
+ * that processed the event.
+ */
+
+#define LOOPBACK_LATENCY_SET_CONFIG	0
+#define LOOPBACK_LATENCY_GET_RESULT	1
+
+/* length of the maximum length sequence burst in frames */
+#define LOOPBACK_LATENCY_BURST_FRAMES	1023
+
+enum loopback_latency_status {
+	LOOPBACK_LATENCY_NONE = 0,	/* no measurement done yet */
+	LOOPBACK_LATENCY_OK,		/* latency measured */
+	LOOPBACK_LATENCY_NO_PEAK,	/* burst not found in the loopback */
+	LOOPBACK_LATENCY_TIMEOUT,	/* loopback did not deliver the frames */
+	LOOPBACK_LATENCY_BUSY,		/* measurement in progress */
+};
+
+struct sof_loopback_latency_config {
+	uint32_t size;		/* sizeof(struct sof_loopback_latency_config) */
+	int32_t amplitude;	/* burst amplitude Q1.31, 0 for the default */
+	uint32_t interval_ms;	/* repeat period, 0 for a single measurement */
+	uint32_t min_peak_ratio; /* correlation peak to mean of the lags, 0 default */
+	uint32_t reserved[4];
+} __attribute__((packed, aligned(4)));
+
+struct sof_loopback_latency_result {
+	uint32_t size;		/* sizeof(struct sof_loopback_latency_result) */
+	uint32_t seq;		/* number of completed measurements */
+	uint32_t status;	/* enum loopback_latency_status */
+	uint32_t rate;		/* stream sample rate */
+	uint32_t frames;	/* measured latency in frames */
+	uint32_t latency_us;	/* measured latency in microseconds */
+	uint32_t peak_ratio;	/* correlation peak to mean of the lags */
+	uint32_t reserved;
+	uint64_t inject_time;	/* LL tick that started the burst */
+	uint64_t result_time;	/* LL tick that completed the measurement */
+} __attribute__((packed, aligned(4)));
+
+#endif /* __USER_LOOPBACK_LATENCY_H__ */
@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __USER_NN_H__
+#define __USER_NN_H__
+
+#include <stdint.h>
+
+/* Model blob of the int8 neural network runtime
+ *
+ * The blob is a struct sof_nn_model_header followed by num_layers layers.
+ * Each layer is a struct sof_nn_layer_header followed by its parameters,
+ * every array starts at a multiple of four bytes:
+ *
+ *   SOF_NN_LAYER_FC      int32_t bias[out_size]
+ *                        int8_t weights[out_size][ALIGN_UP(in_size, 4)]
+ *   SOF_NN_LAYER_DWCONV  int32_t bias[in_size]
+ *                        int8_t weights[kernel][ALIGN_UP(in_size, 4)]
+ *   SOF_NN_LAYER_GRU     int32_t bias_input[3 * out_size]
+ *                        int32_t bias_hidden[3 * out_size]
+ *                        int8_t weights_input[3 * out_size][ALIGN_UP(in_size, 4)]
+ *                        int8_t weights_hidden[3 * out_size][ALIGN_UP(out_size, 4)]
+ *   SOF_NN_LAYER_RELU    no parameters
+ *
+ * The rows of the weights are padded with zeros. The GRU gate rows are in
+ * order reset, update, new. The activations and weights are symmetric int8
+ * with no zero point. The accumulators are scaled with
+ * (acc * mult) >> (31 + shift), where mult is Q1.31, to the int8 output of
+ * FC and DWCONV, and to the Q4.12 gate inputs of GRU. Index 0 is for the
+ * input and index 1 for the hidden state part of GRU. The GRU hidden state
+ * is the Q1.7 output.
+ */
+
+#define SOF_NN_MAGIC		0x314e4e53 /* "SNN1" */
+#define SOF_NN_MAX_LAYERS	32
+#define SOF_NN_MAX_SIZE		1024	/* max layer input or output size */
+#define SOF_NN_MAX_KERNEL	16	/* max DWCONV taps */
+
+enum sof_nn_layer_type {
+	SOF_NN_LAYER_FC = 0,
+	SOF_NN_LAYER_DWCONV,
+	SOF_NN_LAYER_GRU,
+	SOF_NN_LAYER_RELU,
+};
+
+struct sof_nn_model_header {
+	uint32_t magic;		/**< SOF_NN_MAGIC */
+	uint32_t size;		/**< bytes of the blob including this header */
+	uint16_t num_layers;
+	uint16_t input_size;	/**< features per frame */
+	int16_t input_shift;	/**< right shift from 16 bit features to int8 */
+	int16_t reserved;
+} __attribute__((packed));
+
+struct sof_nn_layer_header {
+	uint32_t size;		/**< bytes of the layer including this header */
+	uint16_t type;		/**< enum sof_nn_layer_type */
+	uint16_t in_size;
+	uint16_t out_size;
+	uint16_t kernel;	/**< DWCONV taps */
+	int32_t mult[2];	/**< Q1.31 multipliers of the accumulators */
+	int8_t shift[2];	/**< right shifts after multiply */
+	int16_t reserved;
+} __attribute__((packed));
+
+#endif /* __USER_NN_H__ */
@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __USER_SYNTHETIC_LOAD_H__
+#define __USER_SYNTHETIC_LOAD_H__
+
+#include <stdint.h>
+
+/*
+ * Synthetic load sample module.
+ *
+ * The module copies its input to its output and adds a configurable cost
+ * to every period, so topologies of any size can be built to find the
+ * scaling limits of the schedulers, the IPC and the heap. It measures the
+ * interval between its own process() calls and reports the deviation from
+ * the nominal period as scheduling jitter.
+ *
+ * The configuration is set with config ID SYNTHETIC_LOAD_SET_CONFIG, the
+ * statistics are read with SYNTHETIC_LOAD_GET_STATS and restart when the
+ * module is prepared. Cycles are counted with sof_cycle_get_64(), the same
+ * counter the module performance data uses.
+ */
+
+#define SYNTHETIC_LOAD_SET_CONFIG	0
+#define SYNTHETIC_LOAD_GET_STATS	1
+
+/* max number of live allocations the heap churn keeps */
+#define SYNTHETIC_LOAD_ALLOCS_MAX	64
+
+/* jitter histogram, bin n counts jitter below 2^n us, the last bin the rest */
+#define SYNTHETIC_LOAD_JITTER_BINS	12
+
+/* heap churn allocates from the buffer zone instead of the runtime zone */
+#define SYNTHETIC_LOAD_FLAG_HEAP_BUFFER	(1 << 0)
+
+struct sof_synthetic_load_config {
+	uint32_t size;		/* sizeof(struct sof_synthetic_load_config) */
+	uint32_t cycles;	/* cost added to every process() call */
+	uint32_t flags;		/* SYNTHETIC_LOAD_FLAG_* */
+	uint32_t heap_allocs;	/* live allocations, 0 disables the heap churn */
+	uint32_t heap_min_size;	/* smallest allocation in bytes */
+	uint32_t heap_max_size;	/* largest allocation in bytes */
+	uint32_t heap_probe_size; /* largest free block probe limit, 0 disables */
+	uint32_t reserved[5];
+} __attribute__((packed, aligned(4)));
+
+struct sof_synthetic_load_stats {
+	uint32_t size;		/* sizeof(struct sof_synthetic_load_stats) */
+	uint32_t periods;	/* process() calls since prepare */
+	uint32_t period_us;	/* nominal period */
+	uint32_t interval_min_us; /* shortest interval between process() calls */
+	uint32_t interval_max_us; /* longest interval between process() calls */
+	uint32_t jitter_avg_us;	/* mean deviation of the interval from the period */
+	uint32_t jitter_max_us;	/* largest deviation of the interval from the period */
+	uint32_t load_max_cycles; /* longest process() call including the copy */
+	uint32_t overruns;	/* process() calls that took longer than the period */
+	uint32_t heap_fails;	/* failed heap churn allocations */
+	uint32_t heap_live_bytes; /* bytes held by the heap churn */
+	uint32_t heap_largest_free; /* largest block found free by the probe */
+	uint32_t jitter_hist[SYNTHETIC_LOAD_JITTER_BINS];
+} __attribute__((packed, aligned(4)));
+
+#endif /* __USER_SYNTHETIC_LOAD_H__ */
@@ -8,6 +8,8 @@
 #ifndef __USER_TONE_H__
 #define __USER_TONE_H__
 
+#include <stdint.h>
+
 #define SOF_TONE_IDX_FREQUENCY		0
 #define SOF_TONE_IDX_AMPLITUDE		1
 #define SOF_TONE_IDX_FREQ_MULT		2
@@ -16,5 +18,20 @@
 #define SOF_TONE_IDX_PERIOD		5
 #define SOF_TONE_IDX_REPEATS		6
 #define SOF_TONE_IDX_LIN_RAMP_STEP	7
+#define SOF_TONE_IDX_CLIP_PLAY		8	/* index is voice, value is clip */
+#define SOF_TONE_IDX_CLIP_STOP		9	/* index is voice */
+#define SOF_TONE_IDX_CLIP_GAIN		10	/* index is voice, value Q1.31 */
+
+/* clip bank binary control, the samples are mono S32_LE at the stream rate */
+struct sof_tone_clip {
+	uint32_t offset;	/* first sample, bytes from the bank start */
+	uint32_t samples;	/* number of samples */
+} __attribute__((packed));
+
+struct sof_tone_clip_bank {
+	uint32_t num_clips;
+	uint32_t reserved;
+	struct sof_tone_clip clips[];
+} __attribute__((packed));
 
 #endif /* __USER_TONE_H__ */
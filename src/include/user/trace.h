@@ -42,4 +42,24 @@ struct log_entry_header {
 	uint32_t log_entry_address;	 /* Address of log entry in ELF */
 } __attribute__((packed));
 
+#define TRACE_COMPACT_BLOCK_MAGIC	0xb10cc0de
+
+/*
+ * Block of compact entries from the trace ring of one core, takes the place
+ * of a log_entry_header in the trace stream and has the same size. Each entry
+ * is a length byte followed by unsigned LEB128 varints: timestamp delta to the
+ * previous entry of the core, log entry address, uid, id_0, id_1 and the log
+ * arguments. Zero length bytes pad the block to a multiple of 4 bytes. The
+ * block with the last flag set ends a merge round, entries of all blocks of
+ * a round are sorted by timestamp.
+ */
+struct log_compact_block_header {
+	uint32_t magic;			 /* TRACE_COMPACT_BLOCK_MAGIC */
+	uint32_t core_id : 8;		 /* Reporting core's id */
+	uint32_t last : 1;		 /* Last block of merge round */
+	uint32_t size : 23;		 /* Bytes of entries following */
+	uint64_t timestamp;		 /* Timestamp first delta refers to */
+	uint32_t dropped;		 /* Entries dropped since previous block */
+} __attribute__((packed));
+
 #endif /* __USER_TRACE_H__ */
@@ -32,6 +32,10 @@
 #include <ipc/trace.h>
 #if CONFIG_IPC_MAJOR_4
 #include <ipc4/fw_reg.h>
+#include <ipc4/notification.h>
+#include <sof/ipc/async_init.h>
+#include <sof/ipc/stream_posn.h>
+#include <sof/ipc/time_corr.h>
 #include <platform/lib/mailbox.h>
 #endif
 #ifdef CONFIG_ZEPHYR_LOG
@@ -181,6 +185,10 @@ int secondary_core_init(struct sof *sof)
 	trace_point(TRACE_BOOT_PLATFORM_SCHED);
 	scheduler_init_ll(timer_domain_get());
 
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	scheduler_init_ll(fast_domain_get());
+#endif
+
 	dma_domain = dma_domain_get();
 	if (dma_domain)
 		scheduler_init_ll(dma_domain);
@@ -197,7 +205,7 @@ int secondary_core_init(struct sof *sof)
 	if (err < 0)
 		return err;
 
-#if CONFIG_AMS
+#if CONFIG_AMS && !CONFIG_AMS_LAZY_INIT
 	err = ams_init();
 	if (err < 0)
 		return err;
@@ -287,7 +295,7 @@ static int primary_core_init(int argc, char *argv[], struct sof *sof)
 	if (platform_init(sof) < 0)
 		sof_panic(SOF_IPC_PANIC_PLATFORM);
 
-#if CONFIG_AMS
+#if CONFIG_AMS && !CONFIG_AMS_LAZY_INIT
 	if (ams_init())
 		LOG_ERR("AMS Init failed!");
 #endif
@@ -299,6 +307,15 @@ static int primary_core_init(int argc, char *argv[], struct sof *sof)
 	mailbox_sw_reg_write(ipc4_abi_ver_offset, IPC4_FW_REGS_ABI_VER);
 
 	k_spinlock_init(&sof->fw_reg_lock);
+
+	time_corr_init();
+	stream_posn_init();
+
+	if (xrun_notif_batch_init() < 0)
+		LOG_ERR("xrun notification batching init failed");
+
+	if (ipc4_async_init_setup() < 0)
+		LOG_ERR("async module init setup failed");
 #endif
 
 	trace_point(TRACE_BOOT_PLATFORM);
@@ -158,10 +158,164 @@ int dma_copy_to_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg,
 
 #endif /* CONFIG_DMA_GW */
 
+#if CONFIG_DMA_COPY_ASYNC
+
+static inline struct dma_copy_req *dma_copy_async_req(struct dma_copy *dc,
+						      uint32_t index)
+{
+	return &dc->queue[index % CONFIG_DMA_COPY_ASYNC_QUEUE];
+}
+
+/* starts copying the remaining bytes of the oldest request, at most one
+ * HOST_PAGE_SIZE block is copied at a time without the DMA gateway
+ */
+static int dma_copy_async_start(struct dma_copy *dc, struct dma_copy_req *req)
+{
+	int ret;
+
+	ret = dma_copy_to_host_nowait(dc, req->host_sg,
+				      req->host_offset + req->done,
+				      (char *)req->local_ptr + req->done,
+				      req->size - req->done);
+	if (ret > 0)
+		dc->in_flight = ret;
+
+	return ret;
+}
+
+int dma_copy_to_host_async(struct dma_copy *dc, struct dma_sg_config *host_sg,
+			   int32_t host_offset, void *local_ptr, int32_t size,
+			   dma_copy_cb cb, void *cb_arg)
+{
+	struct dma_copy_req *req;
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	if (size <= 0)
+		return -EINVAL;
+
+	key = k_spin_lock(&dc->lock);
+
+	/* extend the last request if the new region follows it both in
+	 * local and in host memory and completes to the same callback
+	 */
+	if (dc->tail != dc->head) {
+		req = dma_copy_async_req(dc, dc->tail - 1);
+		if (req->host_sg == host_sg && req->cb == cb &&
+		    req->cb_arg == cb_arg &&
+		    req->host_offset + req->size == host_offset &&
+		    (char *)req->local_ptr + req->size == local_ptr) {
+			req->size += size;
+			goto out;
+		}
+	}
+
+	if (dc->tail - dc->head == CONFIG_DMA_COPY_ASYNC_QUEUE) {
+		ret = -ENOSPC;
+		goto out;
+	}
+
+	req = dma_copy_async_req(dc, dc->tail);
+	req->host_sg = host_sg;
+	req->host_offset = host_offset;
+	req->local_ptr = local_ptr;
+	req->size = size;
+	req->done = 0;
+	req->cb = cb;
+	req->cb_arg = cb_arg;
+
+	/* start right away when idle, otherwise on the next poll */
+	if (dc->tail == dc->head) {
+		ret = dma_copy_async_start(dc, req);
+		if (ret < 0 && ret != -EBUSY)
+			goto out;
+		ret = 0;
+	}
+
+	dc->tail++;
+
+out:
+	k_spin_unlock(&dc->lock, key);
+
+	return ret;
+}
+
+/* Must be called periodically, e.g. from a timer task, with a period long
+ * enough for the DMA to copy a single block: the block started by the
+ * previous call is considered copied.
+ */
+void dma_copy_async_poll(struct dma_copy *dc)
+{
+	struct dma_copy_req *req;
+	k_spinlock_key_t key;
+	dma_copy_cb cb;
+	void *cb_arg;
+	int32_t size;
+	int ret;
+
+	for (;;) {
+		key = k_spin_lock(&dc->lock);
+
+		if (dc->head == dc->tail)
+			break;
+
+		req = dma_copy_async_req(dc, dc->head);
+
+		if (dc->in_flight) {
+			req->done += dc->in_flight;
+			dc->in_flight = 0;
+		}
+
+		if (req->done < req->size) {
+			ret = dma_copy_async_start(dc, req);
+
+			/* the channel is still busy, retry on the next poll */
+			if (ret > 0 || ret == -EBUSY)
+				break;
+
+			tr_err(&dmacpy_tr, "dma_copy_async_poll(): copy failed %d", ret);
+			size = ret;
+		} else {
+			size = req->size;
+		}
+
+		cb = req->cb;
+		cb_arg = req->cb_arg;
+		dc->head++;
+
+		k_spin_unlock(&dc->lock, key);
+
+		if (cb)
+			cb(cb_arg, size);
+	}
+
+	k_spin_unlock(&dc->lock, key);
+}
+
+void dma_copy_async_reset(struct dma_copy *dc)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&dc->lock);
+
+	dc->head = 0;
+	dc->tail = 0;
+	dc->in_flight = 0;
+
+	k_spin_unlock(&dc->lock, key);
+}
+
+#endif /* CONFIG_DMA_COPY_ASYNC */
+
 int dma_copy_new(struct dma_copy *dc)
 {
 	uint32_t dir, cap, dev;
 
+#if CONFIG_DMA_COPY_ASYNC
+	k_spinlock_init(&dc->lock);
+	dma_copy_async_reset(dc);
+#endif
+
 	/* request HDA DMA in the dir LMEM->HMEM with shared access */
 	dir = DMA_DIR_LMEM_TO_HMEM;
 	dev = DMA_DEV_HOST;
@@ -79,7 +79,7 @@ int ipc_process_on_core(uint32_t core, bool blocking)
 }
 
 /*
- * Components, buffers and pipelines are stored in the same lists, hence
+ * Components, buffers and pipelines are stored in the same list and index, hence
  * type and ID have to be used for the identification.
  */
 struct ipc_comp_dev *ipc_get_comp_dev(struct ipc *ipc, uint16_t type, uint32_t id)
@@ -87,8 +87,8 @@ struct ipc_comp_dev *ipc_get_comp_dev(struct ipc *ipc, uint16_t type, uint32_t i
 	struct ipc_comp_dev *icd;
 	struct list_item *clist;
 
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, &ipc->comp_hash[ipc_comp_hash(id)]) {
+		icd = container_of(clist, struct ipc_comp_dev, hash_list);
 		if (icd->id == id && (type == icd->type || type == COMP_TYPE_ANY))
 			return icd;
 	}
@@ -96,6 +96,25 @@ struct ipc_comp_dev *ipc_get_comp_dev(struct ipc *ipc, uint16_t type, uint32_t i
 	return NULL;
 }
 
+void ipc_comp_list_add(struct ipc *ipc, struct ipc_comp_dev *icd)
+{
+	list_item_append(&icd->list, &ipc->comp_list);
+	list_item_append(&icd->hash_list, &ipc->comp_hash[ipc_comp_hash(icd->id)]);
+
+	/* the pipeline of a component is set on its creation */
+	if (icd->type == COMP_TYPE_COMPONENT)
+		list_item_append(&icd->ppl_list,
+				 ipc_ppl_bucket(ipc, dev_comp_pipe_id(icd->cd)));
+}
+
+void ipc_comp_list_del(struct ipc_comp_dev *icd)
+{
+	list_item_del(&icd->list);
+	list_item_del(&icd->hash_list);
+	if (icd->type == COMP_TYPE_COMPONENT)
+		list_item_del(&icd->ppl_list);
+}
+
 /* Walks through the list of components looking for a sink/source endpoint component
  * of the given pipeline
  */
@@ -107,10 +126,8 @@ struct ipc_comp_dev *ipc_get_ppl_comp(struct ipc *ipc, uint32_t pipeline_id, int
 	struct list_item *clist, *blist;
 	struct ipc_comp_dev *next_ppl_icd = NULL;
 
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
-		if (icd->type != COMP_TYPE_COMPONENT)
-			continue;
+	list_for_item(clist, ipc_ppl_bucket(ipc, pipeline_id)) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 
 		/* first try to find the module in the pipeline */
 		if (dev_comp_pipe_id(icd->cd) == pipeline_id) {
@@ -138,20 +155,103 @@ struct ipc_comp_dev *ipc_get_ppl_comp(struct ipc *ipc, uint32_t pipeline_id, int
 	return next_ppl_icd;
 }
 
-void ipc_send_queued_msg(void)
+#if CONFIG_IPC_MSG_QUEUE_LOCKLESS
+STATIC_ASSERT(!(CONFIG_IPC_MSG_QUEUE_LOCKLESS_SIZE & (CONFIG_IPC_MSG_QUEUE_LOCKLESS_SIZE - 1)),
+	      ipc_msg_queue_lockless_size_not_power_of_two);
+
+#define IPC_MSG_RING_MASK	(CONFIG_IPC_MSG_QUEUE_LOCKLESS_SIZE - 1)
+
+static void ipc_msg_ring_init(struct ipc_msg_ring *ring)
 {
-	struct ipc *ipc = ipc_get();
+	int i;
+
+	atomic_set(&ring->head, 0);
+	ring->tail = 0;
+	for (i = 0; i < CONFIG_IPC_MSG_QUEUE_LOCKLESS_SIZE; i++)
+		atomic_set(&ring->cells[i].seq, i);
+}
+
+/*
+ * Any core and context. A cell is free for position pos when its seq is pos
+ * and filled when it is pos + 1, the producers only race on the head.
+ */
+static int ipc_msg_ring_push(struct ipc_msg_ring *ring, struct ipc_msg *msg)
+{
+	struct ipc_msg_ring_cell *cell;
+	uint32_t pos = atomic_get(&ring->head);
+	int32_t diff;
+
+	for (;;) {
+		cell = &ring->cells[pos & IPC_MSG_RING_MASK];
+		diff = (int32_t)((uint32_t)atomic_get(&cell->seq) - pos);
+		if (!diff) {
+			if (atomic_cas(&ring->head, pos, pos + 1))
+				break;
+		} else if (diff < 0) {
+			/* the consumer has not taken this cell yet */
+			return -ENOSPC;
+		}
+		pos = atomic_get(&ring->head);
+	}
+
+	cell->msg = msg;
+	atomic_set(&cell->seq, pos + 1);
+
+	return 0;
+}
+
+/* Locking: call with ipc->lock held, that makes the caller the only consumer */
+static struct ipc_msg *ipc_msg_ring_pop(struct ipc_msg_ring *ring)
+{
+	struct ipc_msg_ring_cell *cell = &ring->cells[ring->tail & IPC_MSG_RING_MASK];
 	struct ipc_msg *msg;
-	k_spinlock_key_t key;
 
-	key = k_spin_lock(&ipc->lock);
+	/* empty, or the producer of the cell has not finished */
+	if ((uint32_t)atomic_get(&cell->seq) != ring->tail + 1)
+		return NULL;
+
+	msg = cell->msg;
+	atomic_set(&cell->seq, ring->tail + CONFIG_IPC_MSG_QUEUE_LOCKLESS_SIZE);
+	ring->tail++;
+
+	return msg;
+}
+
+void ipc_msg_queue_drain(struct ipc *ipc)
+{
+	struct ipc_msg *msg;
+	int i;
+
+	for (i = 0; i < IPC_MSG_RING_COUNT; i++) {
+		while ((msg = ipc_msg_ring_pop(&ipc->msg_ring[i]))) {
+			atomic_clear(&msg->staged);
 
-	if (ipc_get()->pm_prepare_D3)
-		goto out;
+			/* queued before it was staged again */
+			if (!list_is_empty(&msg->list))
+				continue;
+
+			if (i == IPC_MSG_RING_HIGH)
+				list_item_prepend(&msg->list, &ipc->msg_list);
+			else
+				list_item_append(&msg->list, &ipc->msg_list);
+		}
+	}
+}
+#endif
+
+/* Locking: call with ipc->lock held */
+static void ipc_send_first_msg(struct ipc *ipc)
+{
+	struct ipc_msg *msg;
+
+	ipc_msg_queue_drain(ipc);
+
+	if (ipc->pm_prepare_D3)
+		return;
 
 	/* any messages to send ? */
 	if (list_is_empty(&ipc->msg_list))
-		goto out;
+		return;
 
 	msg = list_first_item(&ipc->msg_list, struct ipc_msg,
 			      list);
@@ -159,7 +259,15 @@ void ipc_send_queued_msg(void)
 	if (ipc_platform_send_msg(msg) == 0)
 		/* Remove the message from the list if it has been successfully sent. */
 		list_item_del(&msg->list);
-out:
+}
+
+void ipc_send_queued_msg(void)
+{
+	struct ipc *ipc = ipc_get();
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&ipc->lock);
+	ipc_send_first_msg(ipc);
 	k_spin_unlock(&ipc->lock, key);
 }
 
@@ -196,12 +304,62 @@ void ipc_msg_send_direct(struct ipc_msg *msg, void *data)
 	k_spin_unlock(&ipc->lock, key);
 }
 
+#if CONFIG_IPC_MSG_QUEUE_LOCKLESS
+/*
+ * Stages the message without taking ipc->lock, only the primary core tries
+ * the lock to send a high priority message right away. Returns -ENOSPC when
+ * the ring is full and the message must be queued the locked way.
+ */
+static int ipc_msg_stage(struct ipc *ipc, struct ipc_msg *msg, void *data, bool high_priority)
+{
+	struct ipc_msg_ring *ring = &ipc->msg_ring[high_priority ? IPC_MSG_RING_HIGH :
+						   IPC_MSG_RING_LOW];
+	k_spinlock_key_t key;
+	int ret;
+
+	/* copy mailbox data to message if not already copied */
+	if ((msg->tx_size > 0 && msg->tx_size <= SOF_IPC_MSG_MAX_SIZE) &&
+	    msg->tx_data != data) {
+		ret = memcpy_s(msg->tx_data, msg->tx_size, data, msg->tx_size);
+		assert(!ret);
+	}
+
+	/* already staged, it is sent with the data just copied */
+	if (!atomic_cas(&msg->staged, 0, 1))
+		return 0;
+
+	if (ipc_msg_ring_push(ring, msg) < 0) {
+		atomic_clear(&msg->staged);
+		return -ENOSPC;
+	}
+
+	if (high_priority && cpu_is_primary(cpu_get_id()) &&
+	    !k_spin_trylock(&ipc->lock, &key)) {
+		ipc_send_first_msg(ipc);
+		if (list_is_empty(&ipc->msg_list)) {
+			k_spin_unlock(&ipc->lock, key);
+			return 0;
+		}
+		k_spin_unlock(&ipc->lock, key);
+	}
+
+	schedule_ipc_worker();
+
+	return 0;
+}
+#endif
+
 void ipc_msg_send(struct ipc_msg *msg, void *data, bool high_priority)
 {
 	struct ipc *ipc = ipc_get();
 	k_spinlock_key_t key;
 	int ret;
 
+#if CONFIG_IPC_MSG_QUEUE_LOCKLESS
+	if (!ipc_msg_stage(ipc, msg, data, high_priority))
+		return;
+#endif
+
 	key = k_spin_lock(&ipc->lock);
 
 	/* copy mailbox data to message if not already copied */
@@ -247,10 +405,10 @@ static void ipc_work_handler(struct k_work *work)
 	struct ipc *ipc = ipc_get();
 	k_spinlock_key_t key;
 
-	ipc_send_queued_msg();
-
 	key = k_spin_lock(&ipc->lock);
 
+	ipc_send_first_msg(ipc);
+
 	if (!list_is_empty(&ipc->msg_list) && !ipc->pm_prepare_D3)
 		schedule_ipc_worker();
 
@@ -265,6 +423,8 @@ void ipc_schedule_process(struct ipc *ipc)
 
 int ipc_init(struct sof *sof)
 {
+	int i;
+
 	tr_dbg(&ipc_tr, "ipc_init()");
 
 	/* init ipc data */
@@ -274,7 +434,15 @@ int ipc_init(struct sof *sof)
 
 	k_spinlock_init(&sof->ipc->lock);
 	list_init(&sof->ipc->msg_list);
+#if CONFIG_IPC_MSG_QUEUE_LOCKLESS
+	for (i = 0; i < IPC_MSG_RING_COUNT; i++)
+		ipc_msg_ring_init(&sof->ipc->msg_ring[i]);
+#endif
 	list_init(&sof->ipc->comp_list);
+	for (i = 0; i < IPC_COMP_HASH_SIZE; i++) {
+		list_init(&sof->ipc->comp_hash[i]);
+		list_init(&sof->ipc->ppl_hash[i]);
+	}
 
 #ifdef __ZEPHYR__
 	k_work_init_delayable(&sof->ipc->z_delayed_work, ipc_work_handler);
@@ -8,6 +8,7 @@
 #include <sof/audio/buffer.h>
 #include <sof/audio/component_ext.h>
 #include <sof/audio/pipeline.h>
+#include <sof/audio/module_adapter/module/generic.h>
 #include <sof/common.h>
 #include <rtos/idc.h>
 #include <rtos/interrupt.h>
@@ -20,10 +21,14 @@
 #include <rtos/cache.h>
 #include <sof/lib/cpu.h>
 #include <sof/lib/mailbox.h>
+#include <sof/lib/uuid.h>
 #include <sof/list.h>
 #include <sof/platform.h>
+#include <sof/schedule/edf_schedule.h>
+#include <sof/schedule/schedule.h>
 #include <rtos/sof.h>
 #include <rtos/spinlock.h>
+#include <rtos/task.h>
 #include <ipc/dai.h>
 #include <ipc/header.h>
 #include <ipc/stream.h>
@@ -239,6 +244,192 @@ int ipc_pipeline_complete(struct ipc *ipc, uint32_t comp_id)
 				 ipc_ppl_sink->cd);
 }
 
+#if CONFIG_BUFFER_COMPACTION
+/* 7c2e9b14-5a3d-4f86-a1c0-d84b6e2f9035 */
+DECLARE_SOF_UUID("buffer-compact", buffer_compact_uuid, 0x7c2e9b14, 0x5a3d, 0x4f86,
+		 0xa1, 0xc0, 0xd8, 0x4b, 0x6e, 0x2f, 0x90, 0x35);
+
+/* a delayed stop or pause is run by the pipeline task within a few LL ticks */
+#define IPC_COMPACT_DELAY_US	10000
+
+static struct task ipc_compact_tasks[CONFIG_CORE_COUNT];
+
+/* neither end of the buffer is running or about to start */
+static bool ipc_buffer_idle(struct comp_buffer *buffer)
+{
+	struct comp_dev *ends[] = { buffer->source, buffer->sink };
+	int i;
+
+	/* a shared buffer is used by another core, it is moved by none */
+	if (buffer->is_shared)
+		return false;
+
+	/* borrowed data, e.g. DMA memory of a direct DAI, stays with its owner */
+	if (buffer->borrowed)
+		return false;
+
+	for (i = 0; i < ARRAY_SIZE(ends); i++) {
+		if (!ends[i])
+			continue;
+		if (ends[i]->state == COMP_STATE_ACTIVE)
+			return false;
+		if (ends[i]->pipeline && ends[i]->pipeline->trigger.pending)
+			return false;
+	}
+
+	return true;
+}
+
+static uint32_t ipc_comp_compact(struct comp_dev *dev)
+{
+	struct processing_module *mod;
+	struct comp_buffer *buffer;
+	struct list_item *clist;
+	uint32_t bytes = 0;
+	uint32_t flags;
+
+	list_for_item(clist, &dev->bsink_list) {
+		buffer = container_of(clist, struct comp_buffer, source_list);
+
+		/* no copy of the pipeline task may start while the data moves */
+		irq_local_disable(flags);
+		if (ipc_buffer_idle(buffer))
+			bytes += buffer_relocate(buffer);
+		irq_local_enable(flags);
+	}
+
+	if (dev->ipc_config.proc_domain != COMP_PROCESSING_DOMAIN_DP)
+		return bytes;
+
+	/* the queues of a DP module exist from prepare to reset */
+	mod = comp_get_drvdata(dev);
+	irq_local_disable(flags);
+	if (dev->state != COMP_STATE_ACTIVE) {
+		list_for_item(clist, &mod->dp_queue_ll_to_dp_list)
+			bytes += dp_queue_relocate(container_of(clist, struct dp_queue, list));
+		list_for_item(clist, &mod->dp_queue_dp_to_ll_list)
+			bytes += dp_queue_relocate(container_of(clist, struct dp_queue, list));
+	}
+	irq_local_enable(flags);
+
+	return bytes;
+}
+
+uint32_t ipc_buffers_compact(struct ipc *ipc)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	uint32_t bytes = 0;
+
+	list_for_item(clist, &ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_COMPONENT && cpu_is_me(icd->core))
+			bytes += ipc_comp_compact(icd->cd);
+	}
+
+	if (bytes)
+		tr_info(&ipc_tr, "ipc_buffers_compact(): moved %u bytes", bytes);
+
+	return bytes;
+}
+
+static enum task_state ipc_compact_run(void *data)
+{
+	ipc_buffers_compact(data);
+
+	return SOF_TASK_STATE_COMPLETED;
+}
+
+void ipc_buffers_compact_defer(struct ipc *ipc)
+{
+	struct task_ops ops = {
+		.run = ipc_compact_run,
+		.get_deadline = NULL,
+		.complete = NULL,
+	};
+	struct task *task = &ipc_compact_tasks[cpu_get_id()];
+
+	if (!task->ops.run) {
+		if (schedule_task_init_edf(task, SOF_UUID(buffer_compact_uuid), &ops, ipc,
+					   cpu_get_id(), 0) < 0)
+			return;
+		schedule_task_edf_set_class(task, EDF_CLASS_BACKGROUND);
+	}
+
+	/* a pass already pending covers this pipeline too */
+	if (!task_is_active(task))
+		schedule_task(task, IPC_COMPACT_DELAY_US, 0);
+}
+#endif
+
+#if CONFIG_ZEPHYR_LL_FLOW_ORDER
+/* raises the rank of the consumers of comp, returns true if one changed */
+static bool ipc_comp_flow_rank(struct comp_dev *comp)
+{
+	struct pipeline *p = comp->pipeline;
+	struct comp_buffer *buffer;
+	struct list_item *clist;
+	struct pipeline *next;
+	bool changed = false;
+
+	list_for_item(clist, &comp->bsink_list) {
+		buffer = container_of(clist, struct comp_buffer, source_list);
+		if (!buffer->sink || !buffer->sink->pipeline)
+			continue;
+
+		/* only the tasks of a core are ordered against each other */
+		next = buffer->sink->pipeline;
+		if (next == p || next->core != p->core)
+			continue;
+
+		if (next->flow_rank <= p->flow_rank) {
+			next->flow_rank = p->flow_rank + 1;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+void ipc_pipeline_flow_order(struct ipc *ipc)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	unsigned int pipelines = 0;
+	unsigned int pass;
+	bool changed = true;
+
+	list_for_item(clist, &ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_PIPELINE && cpu_is_me(icd->core)) {
+			icd->pipeline->flow_rank = 0;
+			pipelines++;
+		}
+	}
+
+	/*
+	 * Each pass extends the chains by at least one pipeline, the pass
+	 * count bound keeps the ranks finite when the pipelines form a loop
+	 */
+	for (pass = 0; changed && pass < pipelines; pass++) {
+		changed = false;
+		list_for_item(clist, &ipc->comp_list) {
+			icd = container_of(clist, struct ipc_comp_dev, list);
+			if (icd->type == COMP_TYPE_COMPONENT && cpu_is_me(icd->core) &&
+			    icd->cd->pipeline && ipc_comp_flow_rank(icd->cd))
+				changed = true;
+		}
+	}
+
+	list_for_item(clist, &ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_PIPELINE && cpu_is_me(icd->core) &&
+		    icd->pipeline->pipe_task)
+			icd->pipeline->pipe_task->flow_rank = icd->pipeline->flow_rank;
+	}
+}
+#endif
+
 int ipc_comp_free(struct ipc *ipc, uint32_t comp_id)
 {
 	struct ipc_comp_dev *icd;
@@ -303,12 +494,17 @@ int ipc_comp_free(struct ipc *ipc, uint32_t comp_id)
 	}
 	irq_local_enable(flags);
 
-	/* free component and remove from list */
-	comp_free(icd->cd);
+	/* free component, possibly in the background, and remove from list */
+	if (!ipc_comp_free_defer(icd->cd))
+		comp_free(icd->cd);
 
 	icd->cd = NULL;
 
-	list_item_del(&icd->list);
+#if CONFIG_IPC4_MODULE_CLONE
+	ipc4_init_block_put(icd->init_block);
+#endif
+
+	ipc_comp_list_del(icd);
 	rfree(icd);
 
 	return 0;
@@ -113,6 +113,13 @@ static int ipc_device_suspend_handler(const struct device *dev, void *arg)
 		ret = -EBADMSG;
 	}
 
+#if CONFIG_IPC_MSG_QUEUE_LOCKLESS
+	k_spinlock_key_t key = k_spin_lock(&ipc->lock);
+
+	ipc_msg_queue_drain(ipc);
+	k_spin_unlock(&ipc->lock, key);
+#endif
+
 	if (!list_is_empty(&ipc->msg_list)) {
 		struct list_item *slist;
 		struct ipc_msg *msg;
@@ -164,6 +171,7 @@ static int ipc_device_resume_handler(const struct device *dev, void *arg)
 	/* schedule task */
 	schedule_task_init_edf(&ipc->ipc_task, SOF_UUID(ipc_task_uuid),
 			       &ipc_task_ops, ipc, 0, 0);
+	schedule_task_edf_set_class(&ipc->ipc_task, EDF_CLASS_IPC);
 
 	return 0;
 }
@@ -282,6 +290,7 @@ int platform_ipc_init(struct ipc *ipc)
 	/* schedule task */
 	schedule_task_init_edf(&ipc->ipc_task, SOF_UUID(ipc_task_uuid),
 			       &ipc_task_ops, ipc, 0, 0);
+	schedule_task_edf_set_class(&ipc->ipc_task, EDF_CLASS_IPC);
 
 	/* configure interrupt - work is done internally by Zephyr API */
 
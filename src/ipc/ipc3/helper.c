@@ -121,6 +121,12 @@ static const struct comp_driver *get_drv(struct sof_ipc_comp *comp)
 		goto out;
 	}
 
+#if CONFIG_COMP_DRIVER_TABLE
+	drv = comp_driver_table_get(comp_ext->uuid);
+	if (drv)
+		goto out;
+#endif
+
 	/* search driver list with UUID */
 	key = k_spin_lock(&drivers->lock);
 
@@ -299,6 +305,18 @@ struct ipc_comp_dev *ipc_get_comp_by_ppl_id(struct ipc *ipc,
 	struct ipc_comp_dev *icd;
 	struct list_item *clist;
 
+	if (type == COMP_TYPE_COMPONENT) {
+		list_for_item(clist, ipc_ppl_bucket(ipc, ppl_id)) {
+			icd = container_of(clist, struct ipc_comp_dev, ppl_list);
+			if ((!cpu_is_me(icd->core)) && ignore_remote)
+				continue;
+			if (dev_comp_pipe_id(icd->cd) == ppl_id)
+				return icd;
+		}
+
+		return NULL;
+	}
+
 	list_for_item(clist, &ipc->comp_list) {
 		icd = container_of(clist, struct ipc_comp_dev, list);
 		if (icd->type != type)
@@ -402,7 +420,7 @@ int ipc_pipeline_new(struct ipc *ipc, ipc_pipe_new *_pipe_desc)
 	ipc_pipe->id = pipe_desc->comp_id;
 
 	/* add new pipeline to the list */
-	list_item_append(&ipc_pipe->list, &ipc->comp_list);
+	ipc_comp_list_add(ipc, ipc_pipe);
 
 	return 0;
 }
@@ -435,7 +453,7 @@ int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id)
 		return ret;
 	}
 	ipc_pipe->pipeline = NULL;
-	list_item_del(&ipc_pipe->list);
+	ipc_comp_list_del(ipc_pipe);
 	rfree(ipc_pipe);
 
 	return 0;
@@ -474,7 +492,7 @@ int ipc_buffer_new(struct ipc *ipc, const struct sof_ipc_buffer *desc)
 	ibd->id = desc->comp.id;
 
 	/* add new buffer to the list */
-	list_item_append(&ibd->list, &ipc->comp_list);
+	ipc_comp_list_add(ipc, ibd);
 
 	return ret;
 }
@@ -557,7 +575,7 @@ int ipc_buffer_free(struct ipc *ipc, uint32_t buffer_id)
 
 	/* free buffer and remove from list */
 	buffer_free(ibd->cb);
-	list_item_del(&ibd->list);
+	ipc_comp_list_del(ibd);
 	rfree(ibd);
 
 	return 0;
@@ -670,7 +688,7 @@ int ipc_comp_new(struct ipc *ipc, ipc_comp *_comp)
 	icd->id = comp->id;
 
 	/* add new component to the list */
-	list_item_append(&icd->list, &ipc->comp_list);
+	ipc_comp_list_add(ipc, icd);
 
 	return 0;
 }
@@ -9,6 +9,7 @@
 #include <rtos/alloc.h>
 #include <sof/lib/dma.h>
 #include <sof/platform.h>
+#include <rtos/string.h>
 #include <ipc/stream.h>
 #include <ipc/topology.h>
 #include <errno.h>
@@ -148,6 +149,68 @@ out:
 	return ret;
 }
 
+#if CONFIG_IPC3_PTABLE_CACHE
+struct ipc_ptable_cache_entry {
+	uint32_t phy_addr;	/* host address of the page table */
+	uint32_t pages;		/* 0 for an unused entry */
+	uint32_t last_use;	/* for least recently used replacement */
+	uint8_t *page_table;	/* compressed page table */
+};
+
+static struct ipc_ptable_cache_entry ptable_cache[CONFIG_IPC3_PTABLE_CACHE_ENTRIES];
+static uint32_t ptable_cache_use;
+
+static uint32_t ipc_ptable_size(uint32_t pages)
+{
+	/* 20 bits for each page */
+	return SOF_DIV_ROUND_UP(pages * 20, 8);
+}
+
+static uint8_t *ipc_ptable_cache_get(struct sof_ipc_host_buffer *ring)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ptable_cache); i++) {
+		if (ptable_cache[i].pages == ring->pages &&
+		    ptable_cache[i].phy_addr == ring->phy_addr) {
+			ptable_cache[i].last_use = ++ptable_cache_use;
+			return ptable_cache[i].page_table;
+		}
+	}
+
+	return NULL;
+}
+
+static void ipc_ptable_cache_put(uint32_t phy_addr, uint32_t pages, const uint8_t *page_table)
+{
+	struct ipc_ptable_cache_entry *entry = &ptable_cache[0];
+	uint32_t size = ipc_ptable_size(pages);
+	int i;
+
+	if (!pages)
+		return;
+
+	/* take an unused entry or the least recently used one */
+	for (i = 1; i < ARRAY_SIZE(ptable_cache) && entry->pages; i++)
+		if (!ptable_cache[i].pages ||
+		    ptable_cache[i].last_use - entry->last_use > INT32_MAX)
+			entry = &ptable_cache[i];
+
+	if (entry->pages != pages) {
+		rfree(entry->page_table);
+		entry->pages = 0;
+		entry->page_table = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, size);
+		if (!entry->page_table)
+			return;
+	}
+
+	memcpy_s(entry->page_table, size, page_table, size);
+	entry->phy_addr = phy_addr;
+	entry->pages = pages;
+	entry->last_use = ++ptable_cache_use;
+}
+#endif
+
 int ipc_process_host_buffer(struct ipc *ipc,
 			    struct sof_ipc_host_buffer *ring,
 			    uint32_t direction,
@@ -155,23 +218,37 @@ int ipc_process_host_buffer(struct ipc *ipc,
 			    uint32_t *ring_size)
 {
 	struct ipc_data_host_buffer *data_host_buffer;
+	uint8_t *page_table = NULL;
+#if CONFIG_IPC3_PTABLE_CACHE
+	uint32_t phy_addr = ring->phy_addr;
+#endif
 	int err;
 
 	data_host_buffer = ipc_platform_get_host_buffer(ipc);
 	dma_sg_init(elem_array);
 
-	/* use DMA to read in compressed page table ringbuffer from host */
-	err = ipc_get_page_descriptors(data_host_buffer->dmac,
-				       data_host_buffer->page_table,
-				       ring);
-	if (err < 0) {
-		tr_err(&ipc_tr, "ipc: get descriptors failed %d", err);
-		goto error;
+#if CONFIG_IPC3_PTABLE_CACHE
+	page_table = ipc_ptable_cache_get(ring);
+#endif
+	if (!page_table) {
+		/* use DMA to read in compressed page table ringbuffer from host */
+		err = ipc_get_page_descriptors(data_host_buffer->dmac,
+					       data_host_buffer->page_table,
+					       ring);
+		if (err < 0) {
+			tr_err(&ipc_tr, "ipc: get descriptors failed %d", err);
+			goto error;
+		}
+
+		page_table = data_host_buffer->page_table;
+#if CONFIG_IPC3_PTABLE_CACHE
+		ipc_ptable_cache_put(phy_addr, ring->pages, page_table);
+#endif
 	}
 
 	*ring_size = ring->size;
 
-	err = ipc_parse_page_descriptors(data_host_buffer->page_table,
+	err = ipc_parse_page_descriptors(page_table,
 					 ring,
 					 elem_array, direction);
 	if (err < 0) {
@@ -0,0 +1,375 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/ipc/async_init.h>
+#include <sof/ipc/common.h>
+#include <sof/ipc/msg.h>
+#include <sof/ipc/topology.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/uuid.h>
+#include <sof/list.h>
+#include <sof/schedule/edf_schedule.h>
+#include <sof/schedule/schedule.h>
+#include <rtos/alloc.h>
+#include <rtos/spinlock.h>
+#include <rtos/string.h>
+#include <rtos/task.h>
+#include <ipc4/error_status.h>
+#include <ipc4/module.h>
+#include <ipc4/notification.h>
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+LOG_MODULE_DECLARE(ipc, CONFIG_SOF_LOG_LEVEL);
+
+/* 4b8a1f3e-6c2d-4e59-b7a0-93d15e8c2f61 */
+DECLARE_SOF_UUID("async-init-task", async_init_task_uuid, 0x4b8a1f3e, 0x6c2d, 0x4e59,
+		 0xb7, 0xa0, 0x93, 0xd1, 0x5e, 0x8c, 0x2f, 0x61);
+
+/* below the DP threads, the worker only takes idle time */
+#define ASYNC_INIT_THREAD_PRIORITY	(CONFIG_NUM_PREEMPT_PRIORITIES - 1)
+
+/* retry period while the previous notification is still queued */
+#define ASYNC_INIT_RETRY_US		1000
+
+struct async_init_bind {
+	struct list_item list;
+	struct ipc4_module_bind_unbind bu;
+};
+
+/* one module instance initializing */
+struct async_init_entry {
+	struct list_item list;		/* in async_init::entries */
+	struct comp_dev *dev;
+	int (*init)(struct comp_dev *dev);
+	struct k_work work;
+	struct list_item binds;		/* binds waiting for the instance */
+	int ret;
+	bool done;			/* set by the worker */
+};
+
+/*
+ * The entries and the queued binds are only used in the IPC context, the
+ * worker only sets the result of the entry it ran and schedules the EDF
+ * task, which completes the entries in the IPC context.
+ */
+struct async_init {
+	struct k_work_q queue;
+	struct k_spinlock lock;		/* entry results */
+	struct list_item entries;
+	struct task task;
+	struct ipc_msg *msg;
+};
+
+static struct async_init *async_init;
+static K_THREAD_STACK_DEFINE(async_init_stack, CONFIG_IPC4_ASYNC_INIT_STACK_SIZE);
+
+static struct async_init_entry *async_init_find(uint32_t comp_id)
+{
+	struct async_init_entry *e;
+	struct list_item *item;
+
+	list_for_item(item, &async_init->entries) {
+		e = container_of(item, struct async_init_entry, list);
+		if (dev_comp_id(e->dev) == comp_id)
+			return e;
+	}
+
+	return NULL;
+}
+
+static void async_init_free_binds(struct async_init_entry *e)
+{
+	struct list_item *item, *tmp;
+
+	list_for_item_safe(item, tmp, &e->binds) {
+		list_item_del(item);
+		rfree(container_of(item, struct async_init_bind, list));
+	}
+}
+
+static void async_init_work(struct k_work *work)
+{
+	struct async_init_entry *e = CONTAINER_OF(work, struct async_init_entry, work);
+	k_spinlock_key_t key;
+	int ret;
+
+	ret = e->init(e->dev);
+
+	key = k_spin_lock(&async_init->lock);
+	e->ret = ret;
+	e->done = true;
+	k_spin_unlock(&async_init->lock, key);
+
+	schedule_task(&async_init->task, 0, 0);
+}
+
+static bool async_init_done(struct async_init_entry *e)
+{
+	k_spinlock_key_t key;
+	bool done;
+
+	key = k_spin_lock(&async_init->lock);
+	done = e->done;
+	k_spin_unlock(&async_init->lock, key);
+
+	return done;
+}
+
+static bool async_init_msg_queued(void)
+{
+	struct ipc *ipc = ipc_get();
+	k_spinlock_key_t key;
+	bool queued;
+
+	key = k_spin_lock(&ipc->lock);
+	queued = ipc_msg_is_queued(async_init->msg);
+	k_spin_unlock(&ipc->lock, key);
+
+	return queued;
+}
+
+/* IPC context, the entry is no longer listed */
+static void async_init_finish(struct async_init_entry *e)
+{
+	struct ipc4_resource_event_data_notification notif;
+	struct ipc *ipc = ipc_get();
+	uint32_t comp_id = dev_comp_id(e->dev);
+	struct async_init_bind *b;
+	struct list_item *item, *tmp;
+	uint32_t failed = 0;
+	int ret;
+
+	memset(&notif, 0, sizeof(notif));
+
+	if (e->ret) {
+		tr_err(&ipc_tr, "ipc4 module %x failed to initialize, %d", comp_id, e->ret);
+		list_for_item(item, &e->binds)
+			failed++;
+		async_init_free_binds(e);
+		ipc_comp_free(ipc, comp_id);
+		notif.event_data.dws[0] = IPC4_MOD_NOT_INITIALIZED;
+	} else {
+		list_for_item_safe(item, tmp, &e->binds) {
+			b = container_of(item, struct async_init_bind, list);
+			list_item_del(item);
+
+			/* the other end may still be initializing */
+			ret = ipc4_async_init_queue_bind(&b->bu);
+			if (!ret)
+				ret = ipc_comp_connect(ipc, (ipc_pipe_comp_connect *)&b->bu);
+			else if (ret > 0)
+				ret = 0;
+			if (ret) {
+				tr_err(&ipc_tr, "ipc4 module %x queued bind failed, %d", comp_id, ret);
+				failed++;
+			}
+			rfree(b);
+		}
+	}
+
+	notif.resource_type = SOF_IPC4_MODULE_INSTANCE;
+	notif.resource_id = comp_id;
+	notif.event_type = SOF_IPC4_MODULE_INIT_DONE;
+	notif.event_data.dws[1] = failed;
+	ipc_msg_send(async_init->msg, &notif, false);
+
+	rfree(e);
+}
+
+static enum task_state async_init_complete(void *data)
+{
+	struct async_init_entry *e;
+	struct list_item *item, *tmp;
+
+	list_for_item_safe(item, tmp, &async_init->entries) {
+		e = container_of(item, struct async_init_entry, list);
+		if (!async_init_done(e))
+			continue;
+
+		/* one notification at a time, the message data must not change while queued */
+		if (async_init_msg_queued()) {
+			schedule_task(&async_init->task, ASYNC_INIT_RETRY_US, 0);
+			break;
+		}
+
+		list_item_del(&e->list);
+		async_init_finish(e);
+	}
+
+	return SOF_TASK_STATE_COMPLETED;
+}
+
+int ipc4_async_init_start(struct comp_dev *dev, int (*init)(struct comp_dev *dev))
+{
+	struct async_init_entry *e;
+
+	if (!async_init)
+		return -ENODEV;
+
+	e = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*e));
+	if (!e)
+		return -ENOMEM;
+
+	e->dev = dev;
+	e->init = init;
+	list_init(&e->binds);
+	k_work_init(&e->work, async_init_work);
+	list_item_append(&e->list, &async_init->entries);
+
+	comp_info(dev, "ipc4_async_init_start(): initializing in the background");
+	k_work_submit_to_queue(&async_init->queue, &e->work);
+
+	return 0;
+}
+
+void ipc4_async_init_cancel(struct comp_dev *dev)
+{
+	struct k_work_sync sync;
+	struct async_init_entry *e;
+
+	if (!async_init)
+		return;
+
+	e = async_init_find(dev_comp_id(dev));
+	if (!e || e->dev != dev)
+		return;
+
+	/* waits for an init already running */
+	k_work_cancel_sync(&e->work, &sync);
+
+	list_item_del(&e->list);
+	async_init_free_binds(e);
+	rfree(e);
+}
+
+bool ipc4_async_init_pending(uint32_t comp_id)
+{
+	return async_init && async_init_find(comp_id);
+}
+
+bool ipc4_async_init_pipeline_pending(uint32_t pipeline_id)
+{
+	struct async_init_entry *e;
+	struct list_item *item;
+
+	if (!async_init)
+		return false;
+
+	list_for_item(item, &async_init->entries) {
+		e = container_of(item, struct async_init_entry, list);
+		if (e->dev->ipc_config.pipeline_id == pipeline_id)
+			return true;
+	}
+
+	return false;
+}
+
+int ipc4_async_init_queue_bind(const struct ipc4_module_bind_unbind *bu)
+{
+	uint32_t src_id = IPC4_COMP_ID(bu->primary.r.module_id, bu->primary.r.instance_id);
+	struct async_init_entry *e;
+	struct async_init_bind *b;
+	struct comp_dev *src;
+
+	if (!async_init)
+		return 0;
+
+	e = async_init_find(src_id);
+	if (!e)
+		e = async_init_find(IPC4_COMP_ID(bu->extension.r.dst_module_id,
+						 bu->extension.r.dst_instance_id));
+	if (!e)
+		return 0;
+
+	/* a bind is run by the core of its source, only IPC received from the host is passed */
+	src = ipc4_get_comp_dev(src_id);
+	if (src && !cpu_is_me(src->ipc_config.core))
+		return -EBUSY;
+
+	b = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*b));
+	if (!b)
+		return -ENOMEM;
+
+	b->bu = *bu;
+	list_item_append(&b->list, &e->binds);
+
+	return 1;
+}
+
+bool ipc4_async_init_drop_bind(const struct ipc4_module_bind_unbind *bu)
+{
+	struct async_init_entry *e;
+	struct async_init_bind *b;
+	struct list_item *item, *bitem;
+
+	if (!async_init)
+		return false;
+
+	list_for_item(item, &async_init->entries) {
+		e = container_of(item, struct async_init_entry, list);
+		list_for_item(bitem, &e->binds) {
+			b = container_of(bitem, struct async_init_bind, list);
+			if (b->bu.primary.dat == bu->primary.dat &&
+			    b->bu.extension.dat == bu->extension.dat) {
+				list_item_del(bitem);
+				rfree(b);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+int ipc4_async_init_setup(void)
+{
+	struct task_ops ops = {
+		.run = async_init_complete,
+		.get_deadline = NULL,
+		.complete = NULL,
+	};
+	struct k_thread *thread;
+	int ret;
+
+	async_init = rzalloc(SOF_MEM_ZONE_SYS_SHARED, 0, SOF_MEM_CAPS_RAM, sizeof(*async_init));
+	if (!async_init)
+		return -ENOMEM;
+
+	async_init->msg = ipc_msg_init(SOF_IPC4_NOTIF_HEADER(SOF_IPC4_NOTIFY_RESOURCE_EVENT),
+				       sizeof(struct ipc4_resource_event_data_notification));
+	if (!async_init->msg)
+		goto err;
+
+	ret = schedule_task_init_edf(&async_init->task, SOF_UUID(async_init_task_uuid), &ops,
+				     NULL, PLATFORM_PRIMARY_CORE_ID, 0);
+	if (ret < 0)
+		goto err;
+
+	k_spinlock_init(&async_init->lock);
+	list_init(&async_init->entries);
+
+	k_work_queue_start(&async_init->queue, async_init_stack,
+			   K_THREAD_STACK_SIZEOF(async_init_stack),
+			   ASYNC_INIT_THREAD_PRIORITY, NULL);
+
+	/* the instances it initializes live on the primary core */
+	thread = &async_init->queue.thread;
+	k_thread_suspend(thread);
+	k_thread_cpu_mask_clear(thread);
+	k_thread_cpu_mask_enable(thread, PLATFORM_PRIMARY_CORE_ID);
+	k_thread_name_set(thread, "async_init");
+	k_thread_resume(thread);
+
+	return 0;
+
+err:
+	ipc_msg_free(async_init->msg);
+	rfree(async_init);
+	async_init = NULL;
+	return -ENOMEM;
+}
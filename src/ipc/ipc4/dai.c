@@ -201,6 +201,10 @@ void dai_dma_release(struct dai_data *dd, struct comp_dev *dev)
 			k_spin_unlock(&sof_get()->fw_reg_lock, key);
 		}
 
+#if CONFIG_IPC4_TIME_CORR
+		time_corr_reset(&dd->time_corr);
+#endif
+
 		/* The stop sequnece of host driver is first pause and then reset
 		 * dma is released for reset state and need to change dma state from
 		 * pause to stop.
@@ -237,6 +241,10 @@ void dai_release_llp_slot(struct dai_data *dd)
 
 	dd->slot_info.reg_offset = 0;
 	dd->slot_info.node_id = 0;
+
+#if CONFIG_IPC4_TIME_CORR
+	time_corr_put(&dd->time_corr);
+#endif
 }
 
 static int dai_get_unused_llp_slot(struct comp_dev *dev,
@@ -309,6 +317,12 @@ static int dai_init_llp_info(struct dai_data *dd, struct comp_dev *dev)
 	dd->slot_info.node_id = node.dw & IPC4_NODE_ID_MASK;
 	dd->slot_info.reg_offset = ret;
 
+#if CONFIG_IPC4_TIME_CORR
+	/* the position model is optional, the LLP slot is still there */
+	if (!dd->time_corr.offset && time_corr_get(&dd->time_corr, dd->slot_info.node_id) < 0)
+		comp_warn(dev, "no free time correlation slot");
+#endif
+
 	return 0;
 }
 
@@ -428,6 +442,10 @@ void dai_dma_position_update(struct dai_data *dd, struct comp_dev *dev)
 	slot.reading.wclk_u = (uint32_t)(dd->wallclock >> 32);
 
 	mailbox_sw_regs_write(dd->slot_info.reg_offset, &slot, sizeof(slot));
+
+#if CONFIG_IPC4_TIME_CORR
+	time_corr_update(&dd->time_corr, dd->wallclock, status.total_copied);
+#endif
 }
 #else
 int dai_common_position(struct dai_data *dd, struct comp_dev *dev,
@@ -15,12 +15,15 @@
 #include <sof/audio/component_ext.h>
 #include <sof/audio/pipeline.h>
 #include <sof/common.h>
+#include <sof/ipc/async_init.h>
 #include <sof/ipc/topology.h>
 #include <sof/ipc/common.h>
 #include <sof/ipc/msg.h>
 #include <sof/ipc/driver.h>
+#include <sof/lib/cpu-clk-manager.h>
 #include <sof/lib/mailbox.h>
 #include <sof/lib/pm_runtime.h>
+#include <sof/probe/probe.h>
 #include <sof/math/numbers.h>
 #include <sof/tlv.h>
 #include <sof/trace/trace.h>
@@ -95,6 +98,17 @@ static inline const struct ipc4_pipeline_set_state_data *ipc4_get_pipeline_data(
 
 	return ppl_data;
 }
+
+#if CONFIG_IPC4_BATCH
+static inline const struct ipc4_batch *ipc4_get_batch_data(size_t *size)
+{
+	struct ipc *ipc = ipc_get();
+
+	*size = SOF_IPC_MSG_MAX_SIZE - sizeof(struct ipc4_message_request);
+	return (const struct ipc4_batch *)((char *)ipc->comp_data +
+					   sizeof(struct ipc4_message_request));
+}
+#endif
 #else
 static inline struct ipc4_message_request *ipc4_get_message_request(void)
 {
@@ -120,14 +134,135 @@ static inline const struct ipc4_pipeline_set_state_data *ipc4_get_pipeline_data(
 
 	return ppl_data;
 }
+
+#if CONFIG_IPC4_BATCH
+static inline const struct ipc4_batch *ipc4_get_batch_data(size_t *size)
+{
+	dcache_invalidate_region((__sparse_force void __sparse_cache *)MAILBOX_HOSTBOX_BASE,
+				 MAILBOX_HOSTBOX_SIZE);
+
+	*size = MAILBOX_HOSTBOX_SIZE;
+	return (const struct ipc4_batch *)MAILBOX_HOSTBOX_BASE;
+}
+#endif
 #endif
 /*
  * Global IPC Operations.
  */
+#if CONFIG_IPC4_ANY_CORE
+/* the core chosen for the request is passed on with it to the core and to the
+ * host in the reply extension
+ */
+static void ipc4_request_core_chosen(struct ipc4_message_request *ipc4)
+{
+	msg_reply.extension = ipc4->extension.dat;
+	dcache_writeback_region((__sparse_force void __sparse_cache *)ipc4, sizeof(*ipc4));
+}
+
+#if CONFIG_IPC4_ANY_CORE_PACK
+/* secondary cores powered up by the firmware for the pipelines it placed */
+static uint32_t ipc4_packed_cores;
+
+/* lowest numbered core with room, powering up another core only when needed */
+static uint32_t ipc4_pack_core(void)
+{
+	int core = core_kcps_pack(CONFIG_IPC4_ANY_CORE_PACK_KCPS);
+
+	if (!cpu_is_core_enabled(core)) {
+		if (cpu_enable_core(core) < 0) {
+			tr_warn(&ipc_tr, "ipc4 failed to enable core %d for packing", core);
+			return core_kcps_least_loaded(PLATFORM_PRIMARY_CORE_ID);
+		}
+		ipc4_packed_cores |= BIT(core);
+	}
+
+	return core;
+}
+
+/* power down a packed core once nothing is left on it */
+static void ipc4_pack_release(struct ipc *ipc, uint32_t core)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+
+	list_for_item(clist, &ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->core == core)
+			return;
+	}
+
+	cpu_disable_core(core);
+	if (!cpu_is_core_enabled(core))
+		ipc4_packed_cores &= ~BIT(core);
+}
+
+/* free a resource of a packed core waiting for the core, so that the core can
+ * be released right after
+ */
+static int ipc4_pack_free(struct ipc *ipc, struct ipc_comp_dev *icd)
+{
+	uint32_t core = icd->core;
+	int ret;
+
+	ret = ipc4_process_on_core(core, true);
+	if (ret == IPC4_SUCCESS)
+		ipc4_pack_release(ipc, core);
+
+	return ret;
+}
+
+static bool ipc4_is_packed(struct ipc_comp_dev *icd)
+{
+	return icd && !cpu_is_me(icd->core) && (ipc4_packed_cores & BIT(icd->core));
+}
+#endif
+
+static uint32_t ipc4_any_core(void)
+{
+#if CONFIG_IPC4_ANY_CORE_PACK
+	return ipc4_pack_core();
+#else
+	return core_kcps_least_loaded(PLATFORM_PRIMARY_CORE_ID);
+#endif
+}
+
+/* LL modules are run by their pipeline, DP modules on the core with most spare KCPS */
+static uint32_t ipc4_module_core(const struct ipc4_module_init_instance *module_init)
+{
+	struct ipc_comp_dev *ppl_icd;
+	uint32_t core = PLATFORM_PRIMARY_CORE_ID;
+
+	ppl_icd = ipc_get_comp_by_ppl_id(ipc_get(), COMP_TYPE_PIPELINE,
+					 module_init->extension.r.ppl_instance_id, IPC_COMP_ALL);
+	if (ppl_icd)
+		core = ppl_icd->core;
+
+	if (module_init->extension.r.proc_domain)
+#if CONFIG_IPC4_ANY_CORE_PACK
+		core = ipc4_pack_core();
+#else
+		core = core_kcps_least_loaded(core);
+#endif
+
+	return core;
+}
+#endif
+
 static int ipc4_new_pipeline(struct ipc4_message_request *ipc4)
 {
 	struct ipc *ipc = ipc_get();
 
+#if CONFIG_IPC4_ANY_CORE
+	struct ipc4_pipeline_create *pipe = (struct ipc4_pipeline_create *)ipc4;
+
+	if (pipe->extension.r.core_id == IPC4_CORE_ANY) {
+		pipe->extension.r.core_id = ipc4_any_core();
+		tr_info(&ipc_tr, "ipc4 pipeline %u placed on core %u",
+			(uint32_t)pipe->primary.r.instance_id, (uint32_t)pipe->extension.r.core_id);
+		ipc4_request_core_chosen(ipc4);
+	}
+#endif
+
 	return ipc_pipeline_new(ipc, (ipc_pipe_new *)ipc4);
 }
 
@@ -135,10 +270,19 @@ static int ipc4_delete_pipeline(struct ipc4_message_request *ipc4)
 {
 	struct ipc4_pipeline_delete *pipe;
 	struct ipc *ipc = ipc_get();
+#if CONFIG_IPC4_ANY_CORE_PACK
+	struct ipc_comp_dev *icd;
+#endif
 
 	pipe = (struct ipc4_pipeline_delete *)ipc4;
 	tr_dbg(&ipc_tr, "ipc4 delete pipeline %x:", (uint32_t)pipe->primary.r.instance_id);
 
+#if CONFIG_IPC4_ANY_CORE_PACK
+	icd = ipc_get_pipeline_by_id(ipc, pipe->primary.r.instance_id);
+	if (ipc4_is_packed(icd))
+		return ipc4_pack_free(ipc, icd);
+#endif
+
 	return ipc_pipeline_free(ipc, pipe->primary.r.instance_id);
 }
 
@@ -303,6 +447,9 @@ int ipc4_pipeline_prepare(struct ipc_comp_dev *ppl_icd, uint32_t cmd)
 		switch (status) {
 		case COMP_STATE_ACTIVE:
 		case COMP_STATE_PAUSED:
+#if CONFIG_IPC4_PIPELINE_PREARM
+		case COMP_STATE_PREPARE:
+#endif
 			/* No action needed */
 			break;
 		case COMP_STATE_READY:
@@ -334,6 +481,9 @@ int ipc4_pipeline_prepare(struct ipc_comp_dev *ppl_icd, uint32_t cmd)
 		case COMP_STATE_READY:
 		case COMP_STATE_ACTIVE:
 		case COMP_STATE_PAUSED:
+#if CONFIG_IPC4_PIPELINE_PREARM
+		case COMP_STATE_PREPARE:
+#endif
 			/* No action needed */
 			break;
 		default:
@@ -349,9 +499,26 @@ int ipc4_pipeline_prepare(struct ipc_comp_dev *ppl_icd, uint32_t cmd)
 		case COMP_STATE_INIT:
 			tr_dbg(&ipc_tr, "pipeline %d: pause from init", ppl_icd->id);
 			ret = ipc4_pipeline_complete(ipc, ppl_icd->id, cmd);
-			if (ret < 0)
+			if (ret < 0) {
 				ret = IPC4_INVALID_REQUEST;
+				break;
+			}
+#if CONFIG_IPC4_PIPELINE_PREARM
+			COMPILER_FALLTHROUGH;
+		case COMP_STATE_READY:
+			/*
+			 * Pre-arm: run params and prepare, including the host DMA
+			 * configuration, now so that RUNNING only needs the trigger.
+			 */
+			host = pipeline_get_host_dev(ppl_icd);
+			if (!host)
+				return IPC4_INVALID_RESOURCE_ID;
 
+			tr_dbg(&ipc_tr, "pipeline %d: pre-arm", ppl_icd->id);
+			ret = ipc4_pcm_params(host);
+			if (ret < 0)
+				return IPC4_INVALID_REQUEST;
+#endif
 			break;
 		default:
 			/* No action needed */
@@ -419,6 +586,12 @@ int ipc4_pipeline_trigger(struct ipc_comp_dev *ppl_icd, uint32_t cmd, bool *dela
 		case COMP_STATE_PAUSED:
 			cmd = COMP_TRIGGER_STOP;
 			break;
+#if CONFIG_IPC4_PIPELINE_PREARM
+		case COMP_STATE_PREPARE:
+			/* pre-armed but never started, nothing to stop */
+			ret = pipeline_reset(host->cd->pipeline, host->cd);
+			return ret < 0 ? IPC4_INVALID_REQUEST : 0;
+#endif
 		default:
 			return 0;
 		}
@@ -428,6 +601,9 @@ int ipc4_pipeline_trigger(struct ipc_comp_dev *ppl_icd, uint32_t cmd, bool *dela
 		case COMP_STATE_INIT:
 		case COMP_STATE_READY:
 		case COMP_STATE_PAUSED:
+#if CONFIG_IPC4_PIPELINE_PREARM
+		case COMP_STATE_PREPARE:
+#endif
 			return 0;
 		default:
 			cmd = COMP_TRIGGER_PAUSE;
@@ -464,6 +640,10 @@ int ipc4_pipeline_trigger(struct ipc_comp_dev *ppl_icd, uint32_t cmd, bool *dela
 			ret = IPC4_INVALID_REQUEST;
 	}
 
+	/* the buffers of a stopped pipeline can be moved */
+	if (!ret && (cmd == COMP_TRIGGER_PAUSE || cmd == COMP_TRIGGER_STOP))
+		ipc_buffers_compact_defer(ipc_get());
+
 	return ret;
 }
 
@@ -499,7 +679,7 @@ static void ipc_compound_msg_done(uint32_t msg_id, int error)
 
 	/* error reported in delayed pipeline task */
 	if (error < 0) {
-		if (msg_id == SOF_IPC4_GLB_SET_PIPELINE_STATE)
+		if (msg_id == SOF_IPC4_GLB_SET_PIPELINE_STATE || msg_id == SOF_IPC4_GLB_BATCH)
 			msg_data.delayed_error = IPC4_PIPELINE_STATE_NOT_SET;
 	}
 }
@@ -522,6 +702,97 @@ static int ipc_wait_for_compound_msg(void)
 	return IPC4_SUCCESS;
 }
 
+#if CONFIG_IPC4_PIPELINE_STATE_FANOUT
+/* index of the first pipeline from i on which is run on core */
+static int ipc4_ppl_next_on_core(struct ipc *ipc, const uint32_t *ppl_id, uint32_t ppl_count,
+				 int i, int core)
+{
+	struct ipc_comp_dev *ppl_icd;
+
+	for (; i < ppl_count; i++) {
+		ppl_icd = ipc_get_comp_by_ppl_id(ipc, COMP_TYPE_PIPELINE,
+						 ppl_id[i], IPC_COMP_IGNORE_REMOTE);
+		if (ppl_icd && ppl_icd->core == core)
+			break;
+	}
+
+	return i;
+}
+
+/*
+ * Runs a phase of the state change on the pipelines of all cores in parallel.
+ * In each round the next pipeline of every other core is sent to it without
+ * waiting, the next pipeline of this core is run meanwhile and the round ends
+ * when all cores in the pending mask have replied. The pipelines of a core
+ * are run in the requested order, one per round.
+ */
+static int ipc4_ppl_state_fanout(const uint32_t *ppl_id, uint32_t ppl_count, uint32_t cmd,
+				 uint32_t phase, uint32_t type)
+{
+	struct ipc *ipc = ipc_get();
+	struct idc_msg msg = { IDC_MSG_PPL_STATE, 0, 0, sizeof(cmd), &cmd, };
+	struct ipc_comp_dev *ppl_icd;
+	int next[CONFIG_CORE_COUNT] = { 0 };
+	uint32_t pending;
+	int local;
+	int ret = 0;
+	int err;
+	int core;
+	int i;
+
+	do {
+		pending = 0;
+		local = -1;
+
+		for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+			i = ipc4_ppl_next_on_core(ipc, ppl_id, ppl_count, next[core], core);
+			if (i >= ppl_count)
+				continue;
+
+			next[core] = i + 1;
+			if (cpu_is_me(core)) {
+				local = i;
+				continue;
+			}
+
+			msg.extension = IDC_MSG_PPL_STATE_EXT(ppl_id[i], phase);
+			msg.core = core;
+			ret = idc_send_msg(&msg, IDC_ASYNC);
+			if (ret < 0)
+				break;
+
+			pending |= BIT(core);
+		}
+
+		if (!ret && local >= 0) {
+			ppl_icd = ipc_get_comp_by_ppl_id(ipc, COMP_TYPE_PIPELINE,
+							 ppl_id[local], IPC_COMP_IGNORE_REMOTE);
+			if (phase == IDC_PPL_STATE_PHASE_PREPARE) {
+				ret = ipc4_pipeline_prepare(ppl_icd, cmd);
+			} else {
+				bool delayed = false;
+
+				ipc_compound_pre_start(type);
+				ret = ipc4_pipeline_trigger(ppl_icd, cmd, &delayed);
+				ipc_compound_post_start(type, ret, delayed);
+			}
+		}
+
+		/* every sent message is collected, the first error is reported */
+		for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+			if (!(pending & BIT(core)))
+				continue;
+
+			err = idc_msg_wait(core);
+			if (err && !ret)
+				ret = err;
+		}
+	} while (!ret && (pending || local >= 0));
+
+	return ret;
+}
+#endif /* CONFIG_IPC4_PIPELINE_STATE_FANOUT */
+
 static int ipc4_set_pipeline_state(struct ipc4_message_request *ipc4)
 {
 	const struct ipc4_pipeline_set_state_data *ppl_data;
@@ -560,6 +831,11 @@ static int ipc4_set_pipeline_state(struct ipc4_message_request *ipc4)
 			return IPC4_INVALID_RESOURCE_ID;
 		}
 
+#if CONFIG_IPC4_ASYNC_INIT
+		if (ipc4_async_init_pipeline_pending(ppl_id[i]))
+			return IPC4_BUSY;
+#endif
+
 		if (i) {
 			if (ppl_icd->core != idx)
 				use_idc = true;
@@ -568,6 +844,18 @@ static int ipc4_set_pipeline_state(struct ipc4_message_request *ipc4)
 		}
 	}
 
+#if CONFIG_IPC4_PIPELINE_STATE_FANOUT
+	if (use_idc) {
+		ret = ipc4_ppl_state_fanout(ppl_id, ppl_count, cmd, IDC_PPL_STATE_PHASE_PREPARE,
+					    state.primary.r.type);
+		if (ret != 0)
+			return ret;
+
+		return ipc4_ppl_state_fanout(ppl_id, ppl_count, cmd, IDC_PPL_STATE_PHASE_TRIGGER,
+					     state.primary.r.type);
+	}
+#endif
+
 	/* Run the prepare phase on the pipelines */
 	for (i = 0; i < ppl_count; i++) {
 		ppl_icd = ipc_get_comp_by_ppl_id(ipc, COMP_TYPE_PIPELINE,
@@ -707,7 +995,7 @@ static int ipc4_process_chain_dma(struct ipc4_message_request *ipc4)
 		return IPC4_INVALID_CHAIN_STATE_TRANSITION;
 
 	if (!cdma.primary.r.allocate && !cdma.primary.r.enable)
-		list_item_del(&cdma_comp->list);
+		ipc_comp_list_del(cdma_comp);
 
 	return IPC4_SUCCESS;
 #else
@@ -754,6 +1042,10 @@ static int ipc4_process_ipcgtw_cmd(struct ipc4_message_request *ipc4)
 #endif
 }
 
+#if CONFIG_IPC4_BATCH
+static int ipc4_process_batch(struct ipc4_message_request *ipc4);
+#endif
+
 static int ipc4_process_glb_message(struct ipc4_message_request *ipc4)
 {
 	uint32_t type;
@@ -818,6 +1110,12 @@ static int ipc4_process_glb_message(struct ipc4_message_request *ipc4)
 		ret = ipc4_process_ipcgtw_cmd(ipc4);
 		break;
 
+#if CONFIG_IPC4_BATCH
+	case SOF_IPC4_GLB_BATCH:
+		ret = ipc4_process_batch(ipc4);
+		break;
+#endif
+
 	default:
 		ipc_cmd_err(&ipc_tr, "unsupported ipc message type %d", type);
 		ret = IPC4_UNAVAILABLE;
@@ -850,6 +1148,18 @@ static int ipc4_init_module_instance(struct ipc4_message_request *ipc4)
 		(uint32_t)module_init.primary.r.module_id,
 		(uint32_t)module_init.primary.r.instance_id);
 
+#if CONFIG_IPC4_ANY_CORE
+	if (module_init.extension.r.core_id == IPC4_CORE_ANY) {
+		module_init.extension.r.core_id = ipc4_module_core(&module_init);
+		tr_info(&ipc_tr, "ipc4 module %x : %x placed on core %u",
+			(uint32_t)module_init.primary.r.module_id,
+			(uint32_t)module_init.primary.r.instance_id,
+			(uint32_t)module_init.extension.r.core_id);
+		ipc4->extension.dat = module_init.extension.dat;
+		ipc4_request_core_chosen(ipc4);
+	}
+#endif
+
 	/* Pass IPC to target core */
 	if (!cpu_is_me(module_init.extension.r.core_id))
 		return ipc4_process_on_core(module_init.extension.r.core_id, false);
@@ -865,6 +1175,36 @@ static int ipc4_init_module_instance(struct ipc4_message_request *ipc4)
 	return 0;
 }
 
+#if CONFIG_IPC4_MODULE_CLONE
+static int ipc4_clone_module_instance(struct ipc4_message_request *ipc4)
+{
+	struct ipc4_module_clone_instance clone;
+	struct comp_dev *dev;
+	int ret = memcpy_s(&clone, sizeof(clone), ipc4, sizeof(*ipc4));
+
+	if (ret < 0)
+		return IPC4_FAILURE;
+
+	tr_dbg(&ipc_tr, "ipc4_clone_module_instance %x : %x, %u copies",
+	       (uint32_t)clone.primary.r.module_id, (uint32_t)clone.primary.r.instance_id,
+	       (uint32_t)clone.extension.r.count);
+
+	dev = ipc4_get_comp_dev(IPC4_COMP_ID(clone.primary.r.module_id,
+					     clone.primary.r.instance_id));
+	if (!dev)
+		return IPC4_MOD_INVALID_ID;
+
+	/* the copies run on the core of the template */
+	if (!cpu_is_me(dev->ipc_config.core))
+		return ipc4_process_on_core(dev->ipc_config.core, false);
+
+	if (comp_clone_ipc4(&clone) < 0)
+		return IPC4_MOD_NOT_INITIALIZED;
+
+	return 0;
+}
+#endif
+
 static int ipc4_bind_module_instance(struct ipc4_message_request *ipc4)
 {
 	struct ipc4_module_bind_unbind bu;
@@ -878,6 +1218,17 @@ static int ipc4_bind_module_instance(struct ipc4_message_request *ipc4)
 	       (uint32_t)bu.primary.r.module_id, (uint32_t)bu.primary.r.instance_id,
 	       (uint32_t)bu.extension.r.dst_module_id, (uint32_t)bu.extension.r.dst_instance_id);
 
+#if CONFIG_IPC4_ASYNC_INIT
+	/* done once the module is initialized */
+	ret = ipc4_async_init_queue_bind(&bu);
+	if (ret == -ENOMEM)
+		return IPC4_OUT_OF_MEMORY;
+	if (ret < 0)
+		return IPC4_BUSY;
+	if (ret)
+		return 0;
+#endif
+
 	return ipc_comp_connect(ipc, (ipc_pipe_comp_connect *)&bu);
 }
 
@@ -894,6 +1245,11 @@ static int ipc4_unbind_module_instance(struct ipc4_message_request *ipc4)
 	       (uint32_t)bu.primary.r.module_id, (uint32_t)bu.primary.r.instance_id,
 	       (uint32_t)bu.extension.r.dst_module_id, (uint32_t)bu.extension.r.dst_instance_id);
 
+#if CONFIG_IPC4_ASYNC_INIT
+	if (ipc4_async_init_drop_bind(&bu))
+		return 0;
+#endif
+
 	return ipc_comp_disconnect(ipc, (ipc_pipe_comp_connect *)&bu);
 }
 
@@ -933,6 +1289,11 @@ static int ipc4_get_large_config_module_instance(struct ipc4_message_request *ip
 		if (!dev)
 			return IPC4_MOD_INVALID_ID;
 
+#if CONFIG_IPC4_ASYNC_INIT
+		if (ipc4_async_init_pending(comp_id))
+			return IPC4_BUSY;
+#endif
+
 		/* Pass IPC to target core */
 		if (!cpu_is_me(dev->ipc_config.core))
 			return ipc4_process_on_core(dev->ipc_config.core, false);
@@ -1070,6 +1431,11 @@ static int ipc4_set_large_config_module_instance(struct ipc4_message_request *ip
 		if (!dev)
 			return IPC4_MOD_INVALID_ID;
 
+#if CONFIG_IPC4_ASYNC_INIT
+		if (ipc4_async_init_pending(comp_id))
+			return IPC4_BUSY;
+#endif
+
 		/* Pass IPC to target core */
 		if (!cpu_is_me(dev->ipc_config.core))
 			return ipc4_process_on_core(dev->ipc_config.core, false);
@@ -1103,6 +1469,9 @@ static int ipc4_delete_module_instance(struct ipc4_message_request *ipc4)
 {
 	struct ipc4_module_delete_instance module;
 	struct ipc *ipc = ipc_get();
+#if CONFIG_IPC4_ANY_CORE_PACK
+	struct ipc_comp_dev *icd;
+#endif
 	uint32_t comp_id;
 	int ret = memcpy_s(&module, sizeof(module), ipc4, sizeof(*ipc4));
 
@@ -1113,6 +1482,11 @@ static int ipc4_delete_module_instance(struct ipc4_message_request *ipc4)
 	       (uint32_t)module.primary.r.instance_id);
 
 	comp_id = IPC4_COMP_ID(module.primary.r.module_id, module.primary.r.instance_id);
+#if CONFIG_IPC4_ANY_CORE_PACK
+	icd = ipc_get_comp_by_id(ipc, comp_id);
+	if (ipc4_is_packed(icd))
+		return ipc4_pack_free(ipc, icd);
+#endif
 	ret = ipc_comp_free(ipc, comp_id);
 	if (ret < 0) {
 		ipc_cmd_err(&ipc_tr, "failed to delete module instance %x : %x",
@@ -1159,6 +1533,7 @@ static int ipc4_module_process_dx(struct ipc4_message_request *ipc4)
 	struct ipc4_module_set_dx dx;
 	struct ipc4_dx_state_info dx_info;
 	uint32_t module_id, instance_id;
+	uint32_t enable_mask = 0;
 	uint32_t core_id;
 	int ret = memcpy_s(&dx, sizeof(dx), ipc4, sizeof(*ipc4));
 
@@ -1201,12 +1576,13 @@ static int ipc4_module_process_dx(struct ipc4_message_request *ipc4)
 		if ((dx_info.core_mask & BIT(core_id)) == 0)
 			continue;
 
+#if CONFIG_IPC4_ANY_CORE_PACK
+		/* the host takes over the power of the core */
+		ipc4_packed_cores &= ~BIT(core_id);
+#endif
+
 		if (dx_info.dx_mask & BIT(core_id)) {
-			ret = cpu_enable_core(core_id);
-			if (ret != 0) {
-				ipc_cmd_err(&ipc_tr, "failed to enable core %d", core_id);
-				return IPC4_FAILURE;
-			}
+			enable_mask |= BIT(core_id);
 		} else {
 			cpu_disable_core(core_id);
 			if (cpu_is_core_enabled(core_id)) {
@@ -1216,6 +1592,15 @@ static int ipc4_module_process_dx(struct ipc4_message_request *ipc4)
 		}
 	}
 
+	/* the cores to activate are started together */
+	if (enable_mask) {
+		ret = cpu_enable_cores(enable_mask);
+		if (ret != 0) {
+			ipc_cmd_err(&ipc_tr, "failed to enable cores 0x%x", enable_mask);
+			return IPC4_FAILURE;
+		}
+	}
+
 	/* Deactivating primary core if requested.  */
 	if (dx_info.core_mask & BIT(PLATFORM_PRIMARY_CORE_ID)) {
 		if (cpu_enabled_cores() & ~BIT(PLATFORM_PRIMARY_CORE_ID)) {
@@ -1276,6 +1661,11 @@ static int ipc4_process_module_message(struct ipc4_message_request *ipc4)
 	case SOF_IPC4_MOD_DELETE_INSTANCE:
 		ret = ipc4_delete_module_instance(ipc4);
 		break;
+#if CONFIG_IPC4_MODULE_CLONE
+	case SOF_IPC4_MOD_CLONE_INSTANCE:
+		ret = ipc4_clone_module_instance(ipc4);
+		break;
+#endif
 	case SOF_IPC4_MOD_SET_D0IX:
 		ret = ipc4_module_process_d0ix(ipc4);
 		break;
@@ -1294,6 +1684,147 @@ static int ipc4_process_module_message(struct ipc4_message_request *ipc4)
 	return ret;
 }
 
+#if CONFIG_IPC4_BATCH
+/*
+ * Batched requests are executed in the IPC thread of the primary core, they
+ * cannot be forwarded to other cores as that forwards the whole batch.
+ */
+static int ipc4_batch_create_pipeline(struct ipc4_message_request *msg)
+{
+	struct ipc4_pipeline_create pipe;
+
+	pipe.primary.dat = msg->primary.dat;
+	pipe.extension.dat = msg->extension.dat;
+	if (!cpu_is_me(pipe.extension.r.core_id))
+		return IPC4_INVALID_REQUEST;
+
+	return ipc4_new_pipeline(msg);
+}
+
+static int ipc4_batch_set_pipeline_state(struct ipc4_message_request *msg)
+{
+	struct ipc4_pipeline_set_state state;
+	struct ipc_comp_dev *ppl_icd;
+	int ret;
+
+	state.primary.dat = msg->primary.dat;
+	state.extension.dat = msg->extension.dat;
+
+	/* multiple pipelines need their ids in the mailbox */
+	if (state.extension.r.multi_ppl)
+		return IPC4_INVALID_REQUEST;
+
+	ppl_icd = ipc_get_comp_by_ppl_id(ipc_get(), COMP_TYPE_PIPELINE,
+					 state.primary.r.ppl_id, IPC_COMP_IGNORE_REMOTE);
+	if (!ppl_icd)
+		return IPC4_INVALID_RESOURCE_ID;
+	if (!cpu_is_me(ppl_icd->core))
+		return IPC4_INVALID_REQUEST;
+
+	ret = ipc4_set_pipeline_state(msg);
+	if (ret)
+		return ret;
+
+	/* following requests may depend on the new state, wait for delayed triggers */
+	ret = ipc_wait_for_compound_msg();
+	if (ret)
+		return ret;
+
+	return msg_data.delayed_error;
+}
+
+static int ipc4_batch_init_module_instance(struct ipc4_message_request *msg,
+					   const struct ipc4_batch_entry *entry)
+{
+	struct ipc4_module_init_instance module_init;
+	int ret = memcpy_s(&module_init, sizeof(module_init), msg, sizeof(*msg));
+
+	if (ret < 0)
+		return IPC4_FAILURE;
+
+	if (!cpu_is_me(module_init.extension.r.core_id))
+		return IPC4_INVALID_REQUEST;
+
+	if (entry->payload_size < module_init.extension.r.param_block_size * sizeof(uint32_t))
+		return IPC4_ERROR_INVALID_PARAM;
+
+	if (!comp_new_ipc4_data(&module_init, (const char *)entry->payload)) {
+		ipc_cmd_err(&ipc_tr, "error: failed to init module %x : %x",
+			    (uint32_t)module_init.primary.r.module_id,
+			    (uint32_t)module_init.primary.r.instance_id);
+		return IPC4_MOD_NOT_INITIALIZED;
+	}
+
+	return 0;
+}
+
+static int ipc4_batch_run_entry(const struct ipc4_batch_entry *entry)
+{
+	struct ipc4_message_request request = entry->msg;
+
+	if (request.primary.r.msg_tgt == SOF_IPC4_MESSAGE_TARGET_FW_GEN_MSG) {
+		switch (request.primary.r.type) {
+		case SOF_IPC4_GLB_CREATE_PIPELINE:
+			return ipc4_batch_create_pipeline(&request);
+		case SOF_IPC4_GLB_SET_PIPELINE_STATE:
+			return ipc4_batch_set_pipeline_state(&request);
+		default:
+			break;
+		}
+	} else {
+		switch (request.primary.r.type) {
+		case SOF_IPC4_MOD_INIT_INSTANCE:
+			return ipc4_batch_init_module_instance(&request, entry);
+		case SOF_IPC4_MOD_BIND:
+			return ipc4_bind_module_instance(&request);
+		default:
+			break;
+		}
+	}
+
+	ipc_cmd_err(&ipc_tr, "ipc4: unsupported batched request %#x", request.primary.dat);
+	return IPC4_INVALID_REQUEST;
+}
+
+static int ipc4_process_batch(struct ipc4_message_request *ipc4)
+{
+	const struct ipc4_batch *batch;
+	const struct ipc4_batch_entry *entry;
+	size_t offset = sizeof(*batch);
+	size_t size;
+	uint32_t i;
+	int ret = 0;
+
+	batch = ipc4_get_batch_data(&size);
+
+	tr_dbg(&ipc_tr, "ipc4_process_batch %u requests", batch->count);
+
+	for (i = 0; i < batch->count; i++) {
+		entry = (const struct ipc4_batch_entry *)((const char *)batch + offset);
+
+		if (offset + sizeof(*entry) > size ||
+		    entry->payload_size > size - offset - sizeof(*entry)) {
+			ipc_cmd_err(&ipc_tr, "ipc4: batch entry %u exceeds the mailbox", i);
+			ret = IPC4_ERROR_INVALID_PARAM;
+			break;
+		}
+
+		ret = ipc4_batch_run_entry(entry);
+		if (ret) {
+			ipc_cmd_err(&ipc_tr, "ipc4: batch entry %u failed with err %d", i, ret);
+			break;
+		}
+
+		offset += sizeof(*entry) + ALIGN_UP(entry->payload_size, sizeof(uint32_t));
+	}
+
+	/* let the host know how many requests have been executed */
+	msg_reply.extension = i;
+
+	return ret;
+}
+#endif /* CONFIG_IPC4_BATCH */
+
 struct ipc_cmd_hdr *mailbox_validate(void)
 {
 	struct ipc_cmd_hdr *hdr = ipc_get()->comp_data;
@@ -1370,7 +1901,7 @@ static bool is_notification_queued(struct ipc_msg *msg)
 	bool queued = false;
 
 	key = k_spin_lock(&ipc->lock);
-	if (!list_is_empty(&msg->list))
+	if (ipc_msg_is_queued(msg))
 		queued = true;
 	k_spin_unlock(&ipc->lock, key);
 
@@ -1401,6 +1932,25 @@ void ipc_msg_reply(struct sof_ipc_reply *reply)
 	ipc_compound_msg_done(in.primary.r.type, reply->error);
 }
 
+#if CONFIG_PROBE_IPC_RECORD
+/* records the message and the part of the mailbox payload it may use */
+static void ipc4_record_msg(struct ipc4_message_request *in)
+{
+	struct ipc4_module_large_config *config = (struct ipc4_module_large_config *)in;
+	uint32_t size = CONFIG_PROBE_IPC_RECORD_PAYLOAD;
+
+	if (in->primary.r.msg_tgt == SOF_IPC4_MESSAGE_TARGET_MODULE_MSG &&
+	    in->primary.r.type == SOF_IPC4_MOD_LARGE_CONFIG_SET)
+		size = config->extension.r.data_off_size;
+
+	size = MIN(size, MIN(MAILBOX_HOSTBOX_SIZE, CONFIG_PROBE_IPC_RECORD_PAYLOAD));
+	dcache_invalidate_region((__sparse_force void __sparse_cache *)MAILBOX_HOSTBOX_BASE,
+				 size);
+	probe_ipc_record(in->primary.dat, in->extension.dat,
+			 (const void *)MAILBOX_HOSTBOX_BASE, size);
+}
+#endif
+
 void ipc_cmd(struct ipc_cmd_hdr *_hdr)
 {
 	struct ipc4_message_request *in = ipc4_get_message_request();
@@ -1419,6 +1969,10 @@ void ipc_cmd(struct ipc_cmd_hdr *_hdr)
 
 	target = in->primary.r.msg_tgt;
 
+#if CONFIG_PROBE_IPC_RECORD
+	ipc4_record_msg(in);
+#endif
+
 	switch (target) {
 	case SOF_IPC4_MESSAGE_TARGET_FW_GEN_MSG:
 		err = ipc4_process_glb_message(in);
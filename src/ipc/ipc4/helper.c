@@ -16,9 +16,12 @@
 #include <ipc/dai.h>
 #include <sof/ipc/msg.h>
 #include <sof/lib/mailbox.h>
+#include <sof/lib/uuid.h>
 #include <sof/list.h>
 #include <sof/platform.h>
+#include <sof/schedule/edf_schedule.h>
 #include <sof/schedule/ll_schedule_domain.h>
+#include <sof/schedule/schedule.h>
 #include <rtos/wait.h>
 
 /* TODO: Remove platform-specific code, see https://github.com/thesofproject/sof/issues/7549 */
@@ -88,13 +91,268 @@ static inline char *ipc4_get_comp_new_data(void)
 }
 #endif
 
+/* a pipeline can be released only once it is reset and its task is stopped */
+static int ipc4_pipeline_free_check(struct pipeline *p)
+{
+	if (p->pipe_task && task_is_active(p->pipe_task)) {
+		pipe_err(p, "ipc4_pipeline_free_check(): pipeline task still scheduled");
+		return -EBUSY;
+	}
+
+	switch (p->status) {
+	case COMP_STATE_PRE_ACTIVE:
+	case COMP_STATE_ACTIVE:
+	case COMP_STATE_PAUSED:
+		pipe_err(p, "ipc4_pipeline_free_check(): pipeline not reset, status %d",
+			 p->status);
+		return -EBUSY;
+	default:
+		return 0;
+	}
+}
+
+#if CONFIG_IPC4_DEFERRED_FREE
+/* 5d0f7c2a-3b19-4e68-9a4c-e17b2d86f053 */
+DECLARE_SOF_UUID("deferred-free", deferred_free_uuid, 0x5d0f7c2a, 0x3b19, 0x4e68,
+		 0x9a, 0x4c, 0xe1, 0x7b, 0x2d, 0x86, 0xf0, 0x53);
+
+/* objects released per run, IPC received meanwhile waits for one run at most */
+#define IPC4_DEFERRED_FREE_BATCH	4
+
+enum ipc4_deferred_type {
+	IPC4_DEFERRED_COMP,
+	IPC4_DEFERRED_BUFFER,
+	IPC4_DEFERRED_PIPELINE,
+};
+
+struct ipc4_deferred_item {
+	struct list_item list;
+	enum ipc4_deferred_type type;
+	void *obj;
+};
+
+/*
+ * Deleted objects of the primary core in the order they were deleted, so a
+ * pipeline is released after its components. The task runs in the EDF thread
+ * processing the IPC, the list is never used by both at the same time.
+ */
+static struct list_item ipc4_deferred_list = LIST_INIT(ipc4_deferred_list);
+static struct task ipc4_deferred_task;
+
+static void ipc4_deferred_release(struct ipc4_deferred_item *item)
+{
+	switch (item->type) {
+	case IPC4_DEFERRED_COMP:
+		comp_free(item->obj);
+		break;
+	case IPC4_DEFERRED_BUFFER:
+		buffer_free(item->obj);
+		break;
+	case IPC4_DEFERRED_PIPELINE:
+		pipeline_free(item->obj);
+		break;
+	}
+
+	list_item_del(&item->list);
+	rfree(item);
+}
+
+static enum task_state ipc4_deferred_free_run(void *data)
+{
+	struct ipc4_deferred_item *item;
+	int i;
+
+	for (i = 0; i < IPC4_DEFERRED_FREE_BATCH; i++) {
+		if (list_is_empty(&ipc4_deferred_list))
+			return SOF_TASK_STATE_COMPLETED;
+
+		item = list_first_item(&ipc4_deferred_list, struct ipc4_deferred_item, list);
+		ipc4_deferred_release(item);
+	}
+
+	/* queued behind the IPC received meanwhile */
+	if (!list_is_empty(&ipc4_deferred_list))
+		schedule_task(&ipc4_deferred_task, 0, 0);
+
+	return SOF_TASK_STATE_COMPLETED;
+}
+
+/* returns false when the object has to be released right away */
+static bool ipc4_defer_free(enum ipc4_deferred_type type, void *obj)
+{
+	struct task_ops ops = {
+		.run = ipc4_deferred_free_run,
+		.get_deadline = NULL,
+		.complete = NULL,
+	};
+	struct ipc4_deferred_item *item;
+
+	/* IPC of the other cores is processed by their IDC threads */
+	if (cpu_get_id() != PLATFORM_PRIMARY_CORE_ID)
+		return false;
+
+	if (!ipc4_deferred_task.ops.run) {
+		if (schedule_task_init_edf(&ipc4_deferred_task, SOF_UUID(deferred_free_uuid),
+					   &ops, NULL, PLATFORM_PRIMARY_CORE_ID, 0) < 0)
+			return false;
+		schedule_task_edf_set_class(&ipc4_deferred_task, EDF_CLASS_BACKGROUND);
+	}
+
+	item = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*item));
+	if (!item)
+		return false;
+
+	item->type = type;
+	item->obj = obj;
+	list_item_append(&item->list, &ipc4_deferred_list);
+
+	if (!task_is_active(&ipc4_deferred_task))
+		schedule_task(&ipc4_deferred_task, 0, 0);
+
+	return true;
+}
+
+bool ipc_comp_free_defer(struct comp_dev *dev)
+{
+	return ipc4_defer_free(IPC4_DEFERRED_COMP, dev);
+}
+
+/* deleted instances of a module may still hold its DMA, DAI or library */
+static void ipc4_deferred_free_drv(const struct comp_driver *drv)
+{
+	struct ipc4_deferred_item *item;
+	struct list_item *clist, *tmp;
+
+	if (cpu_get_id() != PLATFORM_PRIMARY_CORE_ID)
+		return;
+
+	list_for_item_safe(clist, tmp, &ipc4_deferred_list) {
+		item = container_of(clist, struct ipc4_deferred_item, list);
+		if (item->type == IPC4_DEFERRED_COMP &&
+		    ((struct comp_dev *)item->obj)->drv == drv)
+			ipc4_deferred_release(item);
+	}
+}
+
+/* takes a deleted buffer of the same size and caps instead of allocating a new one */
+static struct comp_buffer *ipc4_deferred_buffer_get(uint32_t caps, uint32_t size)
+{
+	struct ipc4_deferred_item *item;
+	struct comp_buffer *buffer;
+	struct list_item *clist;
+
+	if (cpu_get_id() != PLATFORM_PRIMARY_CORE_ID)
+		return NULL;
+
+	list_for_item(clist, &ipc4_deferred_list) {
+		item = container_of(clist, struct ipc4_deferred_item, list);
+		if (item->type != IPC4_DEFERRED_BUFFER)
+			continue;
+
+		buffer = item->obj;
+		if (buffer->is_shared || buffer->borrowed || buffer->caps != caps ||
+		    audio_stream_get_size(&buffer->stream) != size)
+			continue;
+
+		list_item_del(&item->list);
+		rfree(item);
+		buffer_reuse(buffer, 0);
+		return buffer;
+	}
+
+	return NULL;
+}
+
+static void ipc4_buffer_free(struct comp_buffer *buffer)
+{
+	if (!ipc4_defer_free(IPC4_DEFERRED_BUFFER, buffer))
+		buffer_free(buffer);
+}
+
+static int ipc4_pipeline_free(struct pipeline *p)
+{
+	if (ipc4_defer_free(IPC4_DEFERRED_PIPELINE, p))
+		return 0;
+
+	return pipeline_free(p);
+}
+#else
+static inline void ipc4_deferred_free_drv(const struct comp_driver *drv) { }
+
+static inline struct comp_buffer *ipc4_deferred_buffer_get(uint32_t caps, uint32_t size)
+{
+	return NULL;
+}
+
+static inline void ipc4_buffer_free(struct comp_buffer *buffer)
+{
+	buffer_free(buffer);
+}
+
+static inline int ipc4_pipeline_free(struct pipeline *p)
+{
+	return pipeline_free(p);
+}
+#endif
+
 struct comp_dev *comp_new_ipc4(struct ipc4_module_init_instance *module_init)
+{
+	dcache_invalidate_region((__sparse_force void __sparse_cache *)MAILBOX_HOSTBOX_BASE,
+				 MAILBOX_HOSTBOX_SIZE);
+
+	return comp_new_ipc4_data(module_init, ipc4_get_comp_new_data());
+}
+
+#if CONFIG_IPC4_MODULE_CLONE
+/* init request of a module instance, shared by the instance and its copies */
+struct ipc4_init_block {
+	uint32_t refs;
+	uint32_t extension;	/* extension of the init request */
+	uint32_t data[];	/* param_block_size words */
+};
+
+void ipc4_init_block_put(struct ipc4_init_block *block)
+{
+	if (block && !--block->refs)
+		rfree(block);
+}
+
+/* attach the init request to the new instance, a copy of it unless shared */
+static void ipc4_init_block_attach(struct comp_dev *dev,
+				   struct ipc4_module_init_instance *module_init,
+				   const char *data, struct ipc4_init_block *block)
+{
+	struct ipc_comp_dev *icd = ipc_get_comp_by_id(ipc_get(), dev_comp_id(dev));
+	size_t size = module_init->extension.r.param_block_size * sizeof(uint32_t);
+
+	if (!icd || icd->cd != dev)
+		return;
+
+	if (!block) {
+		block = rmalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*block) + size);
+		if (!block) {
+			tr_warn(&ipc_tr, "ipc4: comp %x can't be cloned, no memory", dev_comp_id(dev));
+			return;
+		}
+
+		block->refs = 0;
+		block->extension = module_init->extension.dat;
+		if (size)
+			memcpy_s(block->data, size, data, size);
+	}
+
+	block->refs++;
+	icd->init_block = block;
+}
+#endif
+
+static struct comp_dev *comp_new_ipc4_block(struct ipc4_module_init_instance *module_init,
+					    const char *data, struct ipc4_init_block *block)
 {
 	struct comp_ipc_config ipc_config;
 	const struct comp_driver *drv;
 	struct comp_dev *dev;
 	uint32_t comp_id;
-	char *data;
 
 	comp_id = IPC4_COMP_ID(module_init->primary.r.module_id,
 			       module_init->primary.r.instance_id);
@@ -107,6 +365,8 @@ struct comp_dev *comp_new_ipc4(struct ipc4_module_init_instance *module_init)
 		return NULL;
 	}
 
+	ipc4_deferred_free_drv(drv);
+
 	if (module_init->extension.r.core_id >= CONFIG_CORE_COUNT) {
 		tr_err(&ipc_tr, "ipc: comp->core = %u", (uint32_t)module_init->extension.r.core_id);
 		return NULL;
@@ -131,10 +391,6 @@ struct comp_dev *comp_new_ipc4(struct ipc4_module_init_instance *module_init)
 	ipc_config.proc_domain = COMP_PROCESSING_DOMAIN_LL;
 #endif /* CONFIG_ZEPHYR_DP_SCHEDULER */
 
-	dcache_invalidate_region((__sparse_force void __sparse_cache *)MAILBOX_HOSTBOX_BASE,
-				 MAILBOX_HOSTBOX_SIZE);
-
-	data = ipc4_get_comp_new_data();
 	if (drv->type == SOF_COMP_MODULE_ADAPTER) {
 		const struct ipc_config_process spec = {
 			.data = (const unsigned char *)data,
@@ -154,9 +410,65 @@ struct comp_dev *comp_new_ipc4(struct ipc4_module_init_instance *module_init)
 
 	ipc4_add_comp_dev(dev);
 
+#if CONFIG_IPC4_MODULE_CLONE
+	ipc4_init_block_attach(dev, module_init, data, block);
+#endif
+
 	return dev;
 }
 
+struct comp_dev *comp_new_ipc4_data(struct ipc4_module_init_instance *module_init,
+				    const char *data)
+{
+	return comp_new_ipc4_block(module_init, data, NULL);
+}
+
+#if CONFIG_IPC4_MODULE_CLONE
+int comp_clone_ipc4(struct ipc4_module_clone_instance *clone)
+{
+	const struct ipc4_module_clone_dst *dst;
+	struct ipc4_module_init_instance module_init;
+	struct ipc_comp_dev *icd;
+	struct comp_dev *dev;
+	uint32_t comp_id;
+	uint32_t i;
+
+	comp_id = IPC4_COMP_ID(clone->primary.r.module_id, clone->primary.r.instance_id);
+	icd = ipc_get_comp_by_id(ipc_get(), comp_id);
+	if (!icd || icd->type != COMP_TYPE_COMPONENT || !icd->init_block) {
+		tr_err(&ipc_tr, "ipc4: comp %x can't be cloned", comp_id);
+		return -EINVAL;
+	}
+
+	dcache_invalidate_region((__sparse_force void __sparse_cache *)MAILBOX_HOSTBOX_BASE,
+				 MAILBOX_HOSTBOX_SIZE);
+	dst = (const struct ipc4_module_clone_dst *)ipc4_get_comp_new_data();
+
+	module_init.primary.dat = clone->primary.dat;
+	module_init.primary.r.type = SOF_IPC4_MOD_INIT_INSTANCE;
+
+	for (i = 0; i < clone->extension.r.count; i++) {
+		module_init.primary.r.instance_id = dst[i].instance_id;
+		module_init.extension.dat = icd->init_block->extension;
+		module_init.extension.r.ppl_instance_id = dst[i].ppl_instance_id;
+		module_init.extension.r.core_id = icd->core;
+
+		dev = comp_new_ipc4_block(&module_init, (const char *)icd->init_block->data,
+					  icd->init_block);
+		if (!dev) {
+			tr_err(&ipc_tr, "ipc4: failed to clone comp %x as instance %x",
+			       comp_id, dst[i].instance_id);
+			return -EINVAL;
+		}
+	}
+
+	tr_info(&ipc_tr, "ipc4: comp %x cloned %u times", comp_id,
+		(uint32_t)clone->extension.r.count);
+
+	return 0;
+}
+#endif
+
 struct ipc_comp_dev *ipc_get_comp_by_ppl_id(struct ipc *ipc, uint16_t type,
 					    uint32_t ppl_id,
 					    uint32_t ignore_remote)
@@ -164,27 +476,55 @@ struct ipc_comp_dev *ipc_get_comp_by_ppl_id(struct ipc *ipc, uint16_t type,
 	struct ipc_comp_dev *icd;
 	struct list_item *clist;
 
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
-		if (icd->type != type)
-			continue;
+	/* For IPC4, ipc_comp_dev.id field is equal to Pipeline ID
+	 * in case of type COMP_TYPE_PIPELINE - can look it up directly here
+	 */
+	if (type == COMP_TYPE_PIPELINE)
+		return ipc_get_comp_dev(ipc, type, ppl_id);
 
-		/* For IPC4, ipc_comp_dev.id field is equal to Pipeline ID
-		 * in case of type COMP_TYPE_PIPELINE - can check directly here
-		 */
-		if (type == COMP_TYPE_PIPELINE) {
-			if (icd->id == ppl_id)
-				return icd;
-		} else {
+	if (type == COMP_TYPE_COMPONENT) {
+		list_for_item(clist, ipc_ppl_bucket(ipc, ppl_id)) {
+			icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 			if ((!cpu_is_me(icd->core)) && ignore_remote)
 				continue;
-			if (ipc_comp_pipe_id(icd) == ppl_id)
+			if (dev_comp_pipe_id(icd->cd) == ppl_id)
 				return icd;
 		}
+
+		return NULL;
+	}
+
+	list_for_item(clist, &ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != type)
+			continue;
+
+		if ((!cpu_is_me(icd->core)) && ignore_remote)
+			continue;
+		if (ipc_comp_pipe_id(icd) == ppl_id)
+			return icd;
 	}
 	return NULL;
 }
 
+#if CONFIG_IPC4_PIPELINE_MEM_BUDGET
+/* sum of the pages requested by all existing pipelines */
+static uint32_t ipc4_pipeline_mem_pages(struct ipc *ipc)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	uint32_t pages = 0;
+
+	list_for_item(clist, &ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_PIPELINE)
+			pages += icd->pipeline->mem_pages;
+	}
+
+	return pages;
+}
+#endif
+
 static int ipc4_create_pipeline(struct ipc4_pipeline_create *pipe_desc)
 {
 	struct ipc_comp_dev *ipc_pipe;
@@ -199,6 +539,18 @@ static int ipc4_create_pipeline(struct ipc4_pipeline_create *pipe_desc)
 		return IPC4_INVALID_RESOURCE_ID;
 	}
 
+#if CONFIG_IPC4_PIPELINE_MEM_BUDGET
+	/* reject before any allocation rather than fail in module init */
+	if (ipc4_pipeline_mem_pages(ipc) + pipe_desc->primary.r.ppl_mem_size >
+	    CONFIG_IPC4_PIPELINE_MEM_BUDGET) {
+		tr_err(&ipc_tr, "ipc: pipeline %u needs %u pages, %u of %u in use",
+		       (uint32_t)pipe_desc->primary.r.instance_id,
+		       (uint32_t)pipe_desc->primary.r.ppl_mem_size, ipc4_pipeline_mem_pages(ipc),
+		       CONFIG_IPC4_PIPELINE_MEM_BUDGET);
+		return IPC4_OUT_OF_MEMORY;
+	}
+#endif
+
 	/* create the pipeline */
 	pipe = pipeline_new(pipe_desc->primary.r.instance_id, pipe_desc->primary.r.ppl_priority, 0);
 	if (!pipe) {
@@ -206,8 +558,20 @@ static int ipc4_create_pipeline(struct ipc4_pipeline_create *pipe_desc)
 		return IPC4_OUT_OF_MEMORY;
 	}
 
+	pipe->mem_pages = pipe_desc->primary.r.ppl_mem_size;
+
 	pipe->time_domain = SOF_TIME_DOMAIN_TIMER;
 	pipe->period = LL_TIMER_PERIOD_US;
+#if CONFIG_IPC4_LP_PIPELINE_PERIOD_MULTIPLIER
+	/* low power pipelines process a larger block less often */
+	if (pipe_desc->extension.r.lp)
+		pipe->period *= CONFIG_IPC4_LP_PIPELINE_PERIOD_MULTIPLIER;
+#endif
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	/* the period selects the fast LL domain when the pipeline task is created */
+	if (pipe_desc->primary.r.ppl_priority == CONFIG_ZEPHYR_LL_FAST_PIPELINE_PRIORITY)
+		pipe->period = CONFIG_ZEPHYR_LL_FAST_PERIOD_US;
+#endif
 
 	/* sched_id is set in FW so initialize it to a invalid value */
 	pipe->sched_id = 0xFFFFFFFF;
@@ -229,7 +593,7 @@ static int ipc4_create_pipeline(struct ipc4_pipeline_create *pipe_desc)
 	ipc_pipe->pipeline->attributes = pipe_desc->extension.r.attributes;
 
 	/* add new pipeline to the list */
-	list_item_append(&ipc_pipe->list, &ipc->comp_list);
+	ipc_comp_list_add(ipc, ipc_pipe);
 
 	return IPC4_SUCCESS;
 }
@@ -276,7 +640,7 @@ static int ipc_pipeline_module_free(uint32_t pipeline_id)
 
 			/* free the buffer only when the sink module has also been disconnected */
 			if (!sink)
-				buffer_free(buffer);
+				ipc4_buffer_free(buffer);
 		}
 
 		/* free source buffer allocated by current component in bind function */
@@ -289,7 +653,7 @@ static int ipc_pipeline_module_free(uint32_t pipeline_id)
 
 			/* free the buffer only when the source module has also been disconnected */
 			if (!source)
-				buffer_free(buffer);
+				ipc4_buffer_free(buffer);
 		}
 
 		if (!cpu_is_me(icd->core))
@@ -320,6 +684,10 @@ int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id)
 	if (!cpu_is_me(ipc_pipe->core))
 		return ipc4_process_on_core(ipc_pipe->core, false);
 
+	/* checked before anything is released, the deferred pipeline free can't fail */
+	if (ipc4_pipeline_free_check(ipc_pipe->pipeline) < 0)
+		return IPC4_INVALID_RESOURCE_STATE;
+
 	ret = ipc_pipeline_module_free(ipc_pipe->pipeline->pipeline_id);
 	if (ret != IPC4_SUCCESS) {
 		tr_err(&ipc_tr, "ipc_pipeline_free(): module free () failed");
@@ -327,14 +695,14 @@ int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id)
 	}
 
 	/* free buffer, delete all tasks and remove from list */
-	ret = pipeline_free(ipc_pipe->pipeline);
+	ret = ipc4_pipeline_free(ipc_pipe->pipeline);
 	if (ret < 0) {
 		tr_err(&ipc_tr, "ipc_pipeline_free(): pipeline_free() failed");
 		return IPC4_INVALID_RESOURCE_STATE;
 	}
 
 	ipc_pipe->pipeline = NULL;
-	list_item_del(&ipc_pipe->list);
+	ipc_comp_list_del(ipc_pipe);
 	rfree(ipc_pipe);
 
 	return IPC4_SUCCESS;
@@ -351,6 +719,20 @@ static struct comp_buffer *ipc4_create_buffer(struct comp_dev *src, bool is_shar
 	ipc_buf.comp.id = IPC4_COMP_ID(src_queue, dst_queue);
 	ipc_buf.comp.pipeline_id = src->ipc_config.pipeline_id;
 	ipc_buf.comp.core = cpu_get_id();
+
+	if (!is_shared) {
+		struct comp_buffer *buffer = ipc4_deferred_buffer_get(ipc_buf.caps, buf_size);
+
+		if (buffer) {
+			buffer->id = ipc_buf.comp.id;
+			buffer->pipeline_id = ipc_buf.comp.pipeline_id;
+			buffer->core = ipc_buf.comp.core;
+			memcpy_s(&buffer->tctx, sizeof(struct tr_ctx),
+				 &buffer_tr, sizeof(struct tr_ctx));
+			return buffer;
+		}
+	}
+
 	return buffer_new(&ipc_buf, is_shared);
 }
 
@@ -371,10 +753,27 @@ static struct comp_buffer *ipc4_create_buffer(struct comp_dev *src, bool is_shar
  * disable any interrupts.
  */
 
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+static void ll_block_domains(void)
+{
+	domain_block(sof_get()->platform_timer_domain);
+	domain_block(sof_get()->platform_fast_domain);
+}
+
+static void ll_unblock_domains(void)
+{
+	domain_unblock(sof_get()->platform_fast_domain);
+	domain_unblock(sof_get()->platform_timer_domain);
+}
+#else
+#define ll_block_domains()	domain_block(sof_get()->platform_timer_domain)
+#define ll_unblock_domains()	domain_unblock(sof_get()->platform_timer_domain)
+#endif
+
 #define ll_block(cross_core_bind) \
 	do { \
 		if (cross_core_bind) \
-			domain_block(sof_get()->platform_timer_domain); \
+			ll_block_domains(); \
 		else \
 			irq_local_disable(flags); \
 	} while (0)
@@ -382,7 +781,7 @@ static struct comp_buffer *ipc4_create_buffer(struct comp_dev *src, bool is_shar
 #define ll_unblock(cross_core_bind) \
 	do { \
 		if (cross_core_bind) \
-			domain_unblock(sof_get()->platform_timer_domain); \
+			ll_unblock_domains(); \
 		else \
 			irq_local_enable(flags); \
 	} while (0)
@@ -422,6 +821,17 @@ static int ll_wait_finished_on_core(struct comp_dev *dev)
 
 #endif
 
+#if CONFIG_IPC4_LP_PIPELINE_PERIOD_MULTIPLIER
+/* LL ticks of data the module moves in each run, ibs and obs are of one tick */
+static uint32_t ipc4_comp_periods(struct comp_dev *dev)
+{
+	if (!dev->pipeline || dev->pipeline->period <= LL_TIMER_PERIOD_US)
+		return 1;
+
+	return dev->pipeline->period / LL_TIMER_PERIOD_US;
+}
+#endif
+
 int ipc_comp_connect(struct ipc *ipc, ipc_pipe_comp_connect *_connect)
 {
 	struct ipc4_module_bind_unbind *bu;
@@ -466,6 +876,15 @@ int ipc_comp_connect(struct ipc *ipc, ipc_pipe_comp_connect *_connect)
 		return IPC4_FAILURE;
 	}
 
+#if CONFIG_IPC4_LP_PIPELINE_PERIOD_MULTIPLIER
+	/* modules of low power pipelines move several ticks of data in each run */
+	uint32_t source_periods = ipc4_comp_periods(source);
+	uint32_t sink_periods = ipc4_comp_periods(sink);
+
+	source_src_cfg.obs *= source_periods;
+	sink_src_cfg.ibs *= sink_periods;
+#endif
+
 	/* create a buffer
 	 * in case of LL -> LL or LL->DP
 	 *	size = 2*obs of source module (obs is single buffer size)
@@ -479,13 +898,39 @@ int ipc_comp_connect(struct ipc *ipc, ipc_pipe_comp_connect *_connect)
 	else
 		buf_size = sink_src_cfg.ibs * 2;
 
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	/*
+	 * Pipelines of the fast and the regular LL domain exchange data with
+	 * different periods, the buffer must hold two periods of the longer one
+	 */
+	bool cross_domain = source->pipeline && sink->pipeline &&
+			    (source->pipeline->period < LL_TIMER_PERIOD_US) !=
+			    (sink->pipeline->period < LL_TIMER_PERIOD_US);
+
+	if (cross_domain)
+		buf_size = MAX(source_src_cfg.obs, sink_src_cfg.ibs) * 2;
+#endif
+#if CONFIG_IPC4_LP_PIPELINE_PERIOD_MULTIPLIER
+	/* as between LL domains, the buffer holds two blocks of the longer period */
+	if (source_periods != sink_periods)
+		buf_size = MAX(source_src_cfg.obs, sink_src_cfg.ibs) * 2;
+#endif
+
 	buffer = ipc4_create_buffer(source, cross_core_bind, buf_size, bu->extension.r.src_queue,
 				    bu->extension.r.dst_queue);
+	/* the heap may only be fragmented */
+	if (!buffer && ipc_buffers_compact(ipc))
+		buffer = ipc4_create_buffer(source, cross_core_bind, buf_size,
+					    bu->extension.r.src_queue, bu->extension.r.dst_queue);
 	if (!buffer) {
 		tr_err(&ipc_tr, "failed to allocate buffer to bind %d to %d", src_id, sink_id);
 		return IPC4_OUT_OF_MEMORY;
 	}
 
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	buffer->stream.cross_domain = cross_domain;
+#endif
+
 	/*
 	 * set min_free_space and min_available in sink/src api of created buffer.
 	 * buffer is connected like:
@@ -558,6 +1003,10 @@ int ipc_comp_connect(struct ipc *ipc, ipc_pipe_comp_connect *_connect)
 
 	ll_unblock(cross_core_bind);
 
+	/* a bind between pipelines of one core may change their run order */
+	if (!cross_core_bind && source->pipeline != sink->pipeline)
+		ipc_pipeline_flow_order(ipc);
+
 	return IPC4_SUCCESS;
 
 e_sink_bind:
@@ -663,6 +1112,9 @@ int ipc_comp_disconnect(struct ipc *ipc, ipc_pipe_comp_connect *_connect)
 
 	buffer_free(buffer);
 
+	if (!cross_core_unbind)
+		ipc_pipeline_flow_order(ipc);
+
 	if (ret || ret1)
 		return IPC4_INVALID_RESOURCE_ID;
 
@@ -750,11 +1202,8 @@ static int ipc4_update_comps_direction(struct ipc *ipc, uint32_t ppl_id)
 	struct list_item *clist;
 	struct comp_buffer *src_buf;
 
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
-		if (icd->type != COMP_TYPE_COMPONENT)
-			continue;
-
+	list_for_item(clist, ipc_ppl_bucket(ipc, ppl_id)) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 		if (dev_comp_pipe_id(icd->cd) != ppl_id)
 			continue;
 
@@ -830,6 +1279,12 @@ const struct comp_driver *ipc4_get_drv(uint8_t *uuid)
 	struct comp_driver_info *info;
 	uint32_t flags;
 
+#if CONFIG_COMP_DRIVER_TABLE
+	drv = comp_driver_table_get(uuid);
+	if (drv)
+		return drv;
+#endif
+
 	irq_local_disable(flags);
 
 	/* search driver list with UUID */
@@ -989,7 +1444,7 @@ int ipc4_add_comp_dev(struct comp_dev *dev)
 
 	tr_dbg(&ipc_tr, "ipc4_add_comp_dev add comp %x", icd->id);
 	/* add new component to the list */
-	list_item_append(&icd->list, &ipc->comp_list);
+	ipc_comp_list_add(ipc, icd);
 
 	return IPC4_SUCCESS;
 };
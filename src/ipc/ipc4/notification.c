@@ -8,6 +8,18 @@
 #include <sof/common.h>
 #include <stdbool.h>
 #include <ipc4/notification.h>
+#if CONFIG_XRUN_NOTIFICATIONS_BATCH
+#include <sof/ipc/common.h>
+#include <sof/ipc/msg.h>
+#include <sof/list.h>
+#include <rtos/alloc.h>
+#include <rtos/spinlock.h>
+#include <rtos/string.h>
+#include <ipc4/base_fw.h>
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <stdint.h>
+#endif
 
 #if CONFIG_XRUN_NOTIFICATIONS_ENABLE
 void xrun_notif_msg_init(struct ipc_msg *msg_xrun, uint32_t resource_id, uint32_t event_type)
@@ -27,3 +39,163 @@ void xrun_notif_msg_init(struct ipc_msg *msg_xrun, uint32_t resource_id, uint32_
 	memset(&notif_data->event_data, 0, sizeof(notif_data->event_data));
 }
 #endif
+
+#if CONFIG_XRUN_NOTIFICATIONS_BATCH
+#define XRUN_NOTIF_BATCH_WINDOW_MS_MAX	1000
+
+struct xrun_notif_batch {
+	struct k_spinlock lock;
+	struct k_work_delayable work;
+	struct ipc_msg *msg_event;	/* window with a single event */
+	struct ipc_msg *msg_list;	/* window with several events */
+	struct ipc4_resource_event_list_entry events[CONFIG_XRUN_NOTIFICATIONS_BATCH_EVENTS];
+	uint32_t num_events;
+	uint32_t dropped;
+	uint32_t window_ms;
+	bool high_priority;
+	bool scheduled;			/* the end of the window is scheduled */
+};
+
+static struct xrun_notif_batch *batch;
+
+static bool xrun_notif_batch_queued(void)
+{
+	struct ipc *ipc = ipc_get();
+	k_spinlock_key_t key;
+	bool queued;
+
+	key = k_spin_lock(&ipc->lock);
+	queued = ipc_msg_is_queued(batch->msg_event) || ipc_msg_is_queued(batch->msg_list);
+	k_spin_unlock(&ipc->lock, key);
+
+	return queued;
+}
+
+static void xrun_notif_batch_work(struct k_work *work)
+{
+	struct ipc4_resource_event_list_notification *list = batch->msg_list->tx_data;
+	struct ipc4_resource_event_data_notification *notif_data;
+	struct ipc4_resource_event_list_entry *event;
+	struct ipc_msg *msg;
+	k_spinlock_key_t key;
+	bool high_priority;
+
+	key = k_spin_lock(&batch->lock);
+
+	/* the data of a queued notification must not change, keep counting */
+	if (xrun_notif_batch_queued()) {
+		k_work_schedule(&batch->work, K_MSEC(MAX(batch->window_ms, 1)));
+		k_spin_unlock(&batch->lock, key);
+		return;
+	}
+
+	event = &batch->events[0];
+	if (batch->num_events == 1 && event->count == 1 && !batch->dropped) {
+		msg = batch->msg_event;
+		xrun_notif_msg_init(msg, event->resource_id, event->event_type);
+		notif_data = msg->tx_data;
+		notif_data->resource_type = event->resource_type;
+	} else {
+		msg = batch->msg_list;
+		list->num_events = batch->num_events;
+		list->dropped = batch->dropped;
+		memcpy_s(list->events, sizeof(batch->events), batch->events,
+			 sizeof(*event) * batch->num_events);
+		msg->tx_size = sizeof(*list) + sizeof(*event) * batch->num_events;
+	}
+
+	batch->num_events = 0;
+	batch->dropped = 0;
+	batch->scheduled = false;
+	high_priority = batch->high_priority;
+
+	k_spin_unlock(&batch->lock, key);
+
+	ipc_msg_send(msg, msg->tx_data, high_priority);
+}
+
+void xrun_notif_batch_event(uint32_t resource_type, uint32_t resource_id, uint32_t event_type)
+{
+	struct ipc4_resource_event_list_entry *event;
+	k_spinlock_key_t key;
+	uint32_t i;
+
+	if (!batch)
+		return;
+
+	key = k_spin_lock(&batch->lock);
+
+	for (i = 0; i < batch->num_events; i++) {
+		event = &batch->events[i];
+		if (event->resource_type == resource_type && event->resource_id == resource_id &&
+		    event->event_type == event_type) {
+			event->count++;
+			goto out;
+		}
+	}
+
+	if (batch->num_events < CONFIG_XRUN_NOTIFICATIONS_BATCH_EVENTS) {
+		event = &batch->events[batch->num_events++];
+		event->resource_type = resource_type;
+		event->resource_id = resource_id;
+		event->event_type = event_type;
+		event->count = 1;
+	} else {
+		batch->dropped++;
+	}
+
+out:
+	if (!batch->scheduled) {
+		batch->scheduled = true;
+		k_work_schedule(&batch->work, K_MSEC(batch->window_ms));
+	}
+
+	k_spin_unlock(&batch->lock, key);
+}
+
+int xrun_notif_batch_set_config(const char *data, uint32_t size)
+{
+	const struct ipc4_xrun_notification_batch *config =
+		(const struct ipc4_xrun_notification_batch *)data;
+	k_spinlock_key_t key;
+
+	if (!batch)
+		return -ENODEV;
+
+	if (size != sizeof(*config) || config->window_ms > XRUN_NOTIF_BATCH_WINDOW_MS_MAX)
+		return -EINVAL;
+
+	key = k_spin_lock(&batch->lock);
+	batch->window_ms = config->window_ms;
+	batch->high_priority = !!config->high_priority;
+	k_spin_unlock(&batch->lock, key);
+
+	return 0;
+}
+
+int xrun_notif_batch_init(void)
+{
+	batch = rzalloc(SOF_MEM_ZONE_SYS_SHARED, 0, SOF_MEM_CAPS_RAM, sizeof(*batch));
+	if (!batch)
+		return -ENOMEM;
+
+	batch->msg_event = ipc_msg_init(0, sizeof(struct ipc4_resource_event_data_notification));
+	batch->msg_list = ipc_msg_init(SOF_IPC4_NOTIF_HEADER(SOF_IPC4_NOTIFY_RESOURCE_EVENT_LIST),
+				       sizeof(struct ipc4_resource_event_list_notification) +
+				       sizeof(batch->events));
+	if (!batch->msg_event || !batch->msg_list) {
+		ipc_msg_free(batch->msg_event);
+		ipc_msg_free(batch->msg_list);
+		rfree(batch);
+		batch = NULL;
+		return -ENOMEM;
+	}
+
+	k_spinlock_init(&batch->lock);
+	k_work_init_delayable(&batch->work, xrun_notif_batch_work);
+	batch->window_ms = CONFIG_XRUN_NOTIFICATIONS_BATCH_WINDOW_MS;
+	batch->high_priority = true;
+
+	return 0;
+}
+#endif
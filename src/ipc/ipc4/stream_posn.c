@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component_ext.h>
+#include <sof/audio/pipeline.h>
+#include <sof/ipc/stream_posn.h>
+#include <sof/lib/mailbox.h>
+#include <rtos/sof.h>
+#include <rtos/spinlock.h>
+#include <rtos/string.h>
+#include <rtos/timer.h>
+#include <ipc/stream.h>
+#include <ipc4/fw_reg.h>
+#include <kernel/mailbox.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define STREAM_POSN_SLOTS_OFFSET \
+	(SRAM_REG_STREAM_POSN + offsetof(struct ipc4_stream_posn_regs, slots))
+
+/* the slot part written by each update */
+struct stream_posn_data {
+	uint64_t host_posn;
+	uint64_t dai_posn;
+	uint64_t timestamp;
+	uint32_t xrun_count;
+	uint32_t dai_watermark;
+} __attribute__((packed, aligned(4)));
+
+static void stream_posn_write(struct stream_posn *sp, const struct stream_posn_data *data)
+{
+	uint32_t seq_offset = sp->offset + offsetof(struct ipc4_stream_posn_slot, seq);
+
+	/* odd seq tells the host that the slot is being updated */
+	mailbox_sw_reg_write(seq_offset, ++sp->seq);
+	mailbox_sw_regs_write(sp->offset + offsetof(struct ipc4_stream_posn_slot, host_posn),
+			      data, sizeof(*data));
+	mailbox_sw_reg_write(seq_offset, ++sp->seq);
+}
+
+void stream_posn_update(struct stream_posn *sp, struct comp_dev *host, uint64_t host_posn)
+{
+	struct stream_posn_data data;
+	struct sof_ipc_stream_posn posn;
+	struct comp_dev *dai;
+
+	if (!sp->offset)
+		return;
+
+	data.host_posn = host_posn;
+	data.dai_posn = 0;
+	data.xrun_count = 0;
+	data.dai_watermark = 0;
+
+	/* the DAI may be in another pipeline, e.g. behind a mixer */
+	dai = pipeline_get_dai_comp(host->pipeline->pipeline_id,
+				    host->direction == SOF_IPC_STREAM_PLAYBACK ?
+				    PPL_DIR_DOWNSTREAM : PPL_DIR_UPSTREAM);
+	if (dai && dai->pipeline) {
+		posn.dai_posn = 0;
+		comp_position(dai, &posn);
+		data.dai_posn = posn.dai_posn;
+		data.xrun_count = dai->pipeline->xrun_count;
+#if CONFIG_COMP_DAI_ADAPTIVE_WATERMARK
+		data.dai_watermark = dai->pipeline->dai_watermark;
+#endif
+	}
+
+	data.timestamp = sof_cycle_get_64();
+
+	stream_posn_write(sp, &data);
+}
+
+void stream_posn_reset(struct stream_posn *sp)
+{
+	struct stream_posn_data data;
+
+	if (!sp->offset)
+		return;
+
+	memset_s(&data, sizeof(data), 0, sizeof(data));
+	stream_posn_write(sp, &data);
+}
+
+int stream_posn_get(struct stream_posn *sp, uint32_t node_id)
+{
+	struct ipc4_stream_posn_slot slot;
+	k_spinlock_key_t key;
+	uint32_t offset = STREAM_POSN_SLOTS_OFFSET;
+	int i;
+
+	key = k_spin_lock(&sof_get()->fw_reg_lock);
+
+	for (i = 0; i < IPC4_MAX_STREAM_POSN_SLOTS; i++, offset += sizeof(slot))
+		if (!mailbox_sw_reg_read(offset))
+			break;
+
+	if (i == IPC4_MAX_STREAM_POSN_SLOTS) {
+		k_spin_unlock(&sof_get()->fw_reg_lock, key);
+		return -ENOSPC;
+	}
+
+	memset_s(&slot, sizeof(slot), 0, sizeof(slot));
+	slot.node_id = node_id;
+	mailbox_sw_regs_write(offset, &slot, sizeof(slot));
+
+	k_spin_unlock(&sof_get()->fw_reg_lock, key);
+
+	sp->offset = offset;
+	sp->seq = 0;
+
+	return 0;
+}
+
+void stream_posn_put(struct stream_posn *sp)
+{
+	struct ipc4_stream_posn_slot slot;
+	k_spinlock_key_t key;
+
+	if (!sp->offset)
+		return;
+
+	memset_s(&slot, sizeof(slot), 0, sizeof(slot));
+
+	key = k_spin_lock(&sof_get()->fw_reg_lock);
+	mailbox_sw_regs_write(sp->offset, &slot, sizeof(slot));
+	k_spin_unlock(&sof_get()->fw_reg_lock, key);
+
+	sp->offset = 0;
+}
+
+void stream_posn_init(void)
+{
+	struct ipc4_stream_posn_regs regs;
+
+	memset_s(&regs, sizeof(regs), 0, sizeof(regs));
+	regs.wclk_freq = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
+
+	mailbox_sw_regs_write(SRAM_REG_STREAM_POSN, &regs, sizeof(regs));
+}
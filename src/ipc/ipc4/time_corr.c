@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/ipc/time_corr.h>
+#include <sof/lib/mailbox.h>
+#include <sof/schedule/ll_schedule_domain.h>
+#include <rtos/sof.h>
+#include <rtos/spinlock.h>
+#include <rtos/string.h>
+#include <ipc4/fw_reg.h>
+#include <kernel/mailbox.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The readings are accumulated relative to the first one of the window.
+ * Limiting the window span to 2^24 wallclock ticks and bytes and the window
+ * to 64 readings keeps all the sums and their products below 2^61.
+ */
+#define TIME_CORR_MAX_SPAN	(1LL << 24)
+
+#define TIME_CORR_SLOTS_OFFSET	(SRAM_REG_TIME_CORR + offsetof(struct ipc4_time_corr_regs, slots))
+
+/* the slot part written by each update */
+struct time_corr_model {
+	uint64_t wclk;
+	uint64_t position;
+	uint64_t rate;
+} __attribute__((packed, aligned(4)));
+
+static void time_corr_write(struct time_corr *tc, const struct time_corr_model *model)
+{
+	uint32_t seq_offset = tc->offset + offsetof(struct ipc4_time_corr_slot, seq);
+
+	/* odd seq tells the host that the slot is being updated */
+	mailbox_sw_reg_write(seq_offset, ++tc->seq);
+	mailbox_sw_regs_write(tc->offset + offsetof(struct ipc4_time_corr_slot, wclk),
+			      model, sizeof(*model));
+	mailbox_sw_reg_write(seq_offset, ++tc->seq);
+}
+
+/* fits the least squares line of the window and publishes it at the last
+ * reading of the window
+ */
+static void time_corr_publish(struct time_corr *tc)
+{
+	struct time_corr_model model;
+	int64_t n = tc->count;
+	int64_t num = n * tc->sxy - tc->sx * tc->sy;
+	int64_t den = n * tc->sxx - tc->sx * tc->sx;
+	uint64_t dx;
+
+	if (den <= 0)
+		return;
+
+	/* the position only moves forward */
+	if (num < 0)
+		num = 0;
+
+	/* scale to a 31 bit divisor for the Q32.32 rate */
+	while (den >= (1LL << 31) || num >= (1LL << 31)) {
+		den >>= 1;
+		num >>= 1;
+	}
+
+	if (!den)
+		return;
+
+	model.rate = ((uint64_t)num << 32) / den;
+
+	/* the line goes through the means of the readings */
+	dx = (tc->wclk - tc->wclk0) * n - tc->sx;
+	model.wclk = tc->wclk;
+	model.position = tc->pos0 + (tc->sy + (int64_t)((dx * model.rate) >> 32)) / n;
+
+	time_corr_write(tc, &model);
+}
+
+void time_corr_update(struct time_corr *tc, uint64_t wclk, uint64_t position)
+{
+	int64_t x, y;
+
+	if (!tc->offset)
+		return;
+
+	x = wclk - tc->wclk0;
+	y = position - tc->pos0;
+
+	if (tc->count && (x < 0 || x >= TIME_CORR_MAX_SPAN || y < 0 ||
+			  y >= TIME_CORR_MAX_SPAN)) {
+		/* readings too far apart for one window */
+		if (tc->count > 1)
+			time_corr_publish(tc);
+		tc->count = 0;
+	}
+
+	if (!tc->count) {
+		tc->wclk0 = wclk;
+		tc->pos0 = position;
+		tc->sx = 0;
+		tc->sy = 0;
+		tc->sxx = 0;
+		tc->sxy = 0;
+		x = 0;
+		y = 0;
+	}
+
+	tc->wclk = wclk;
+	tc->sx += x;
+	tc->sy += y;
+	tc->sxx += x * x;
+	tc->sxy += x * y;
+
+	if (++tc->count == CONFIG_IPC4_TIME_CORR_WINDOW) {
+		time_corr_publish(tc);
+		tc->count = 0;
+	}
+}
+
+void time_corr_reset(struct time_corr *tc)
+{
+	struct time_corr_model model;
+
+	if (!tc->offset)
+		return;
+
+	tc->count = 0;
+
+	/* zero rate tells the host that there is no model */
+	memset_s(&model, sizeof(model), 0, sizeof(model));
+	time_corr_write(tc, &model);
+}
+
+int time_corr_get(struct time_corr *tc, uint32_t node_id)
+{
+	struct ipc4_time_corr_slot slot;
+	k_spinlock_key_t key;
+	uint32_t offset = TIME_CORR_SLOTS_OFFSET;
+	int i;
+
+	key = k_spin_lock(&sof_get()->fw_reg_lock);
+
+	for (i = 0; i < IPC4_MAX_TIME_CORR_SLOTS; i++, offset += sizeof(slot))
+		if (!mailbox_sw_reg_read(offset))
+			break;
+
+	if (i == IPC4_MAX_TIME_CORR_SLOTS) {
+		k_spin_unlock(&sof_get()->fw_reg_lock, key);
+		return -ENOSPC;
+	}
+
+	memset_s(&slot, sizeof(slot), 0, sizeof(slot));
+	slot.node_id = node_id;
+	mailbox_sw_regs_write(offset, &slot, sizeof(slot));
+
+	k_spin_unlock(&sof_get()->fw_reg_lock, key);
+
+	tc->offset = offset;
+	tc->seq = 0;
+	tc->count = 0;
+
+	return 0;
+}
+
+void time_corr_put(struct time_corr *tc)
+{
+	struct ipc4_time_corr_slot slot;
+	k_spinlock_key_t key;
+
+	if (!tc->offset)
+		return;
+
+	memset_s(&slot, sizeof(slot), 0, sizeof(slot));
+
+	key = k_spin_lock(&sof_get()->fw_reg_lock);
+	mailbox_sw_regs_write(tc->offset, &slot, sizeof(slot));
+	k_spin_unlock(&sof_get()->fw_reg_lock, key);
+
+	tc->offset = 0;
+}
+
+void time_corr_set_host_time(uint64_t host_time, uint64_t dsp_time)
+{
+	uint32_t seq_offset = SRAM_REG_TIME_CORR + offsetof(struct ipc4_time_corr_regs, seq);
+	uint32_t seq = mailbox_sw_reg_read(seq_offset);
+	uint64_t times[2] = { host_time, dsp_time };
+
+	mailbox_sw_reg_write(seq_offset, ++seq);
+	mailbox_sw_regs_write(SRAM_REG_TIME_CORR + offsetof(struct ipc4_time_corr_regs, host_time),
+			      times, sizeof(times));
+	mailbox_sw_reg_write(seq_offset, ++seq);
+}
+
+void time_corr_init(void)
+{
+	struct ipc4_time_corr_regs regs;
+
+	memset_s(&regs, sizeof(regs), 0, sizeof(regs));
+	regs.wclk_freq = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
+	regs.ll_period = LL_TIMER_PERIOD_US * CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC / 1000000;
+
+	mailbox_sw_regs_write(SRAM_REG_TIME_CORR, &regs, sizeof(regs));
+}
@@ -33,6 +33,32 @@ DECLARE_TR_CTX(ams_tr, SOF_UUID(ams_uuid), LOG_LEVEL_INFO);
 
 static struct ams_context ctx[CONFIG_CORE_COUNT];
 
+#if CONFIG_AMS_LAZY_INIT
+static struct k_spinlock ams_init_lock;
+
+/* The service is initialized on the current core on first use */
+static struct async_message_service *ams_get(void)
+{
+	struct async_message_service **ams = arch_ams_get();
+	k_spinlock_key_t key;
+
+	if (*ams)
+		return *ams;
+
+	key = k_spin_lock(&ams_init_lock);
+	if (!*ams && ams_init() < 0)
+		tr_err(&ams_tr, "ams_get(): init failed on core %d", cpu_get_id());
+	k_spin_unlock(&ams_init_lock, key);
+
+	return *ams;
+}
+#else
+static struct async_message_service *ams_get(void)
+{
+	return *arch_ams_get();
+}
+#endif
+
 static struct ams_shared_context __sparse_cache *ams_acquire(struct ams_shared_context *shared)
 {
 	struct coherent __sparse_cache *c = coherent_acquire(&shared->c,
@@ -47,6 +73,95 @@ static void ams_release(struct ams_shared_context __sparse_cache *shared)
 	coherent_release(&shared->c, sizeof(*shared));
 }
 
+/* message type IDs are assigned in uuid_table order and never released */
+static int ams_msg_type_index(uint32_t message_type_id)
+{
+	if (message_type_id == AMS_INVALID_MSG_TYPE ||
+	    message_type_id > AMS_SERVICE_UUID_TABLE_SIZE)
+		return -EINVAL;
+
+	return message_type_id - 1;
+}
+
+/* true if consumers of the message may be registered on other cores */
+static bool ams_has_remote_consumers(struct ams_context *context, uint32_t message_type_id)
+{
+	int idx = ams_msg_type_index(message_type_id);
+
+	if (idx < 0)
+		return true;
+
+	/* read without the lock, a consumer registered meanwhile may miss this message */
+	return context->shared->consumer_cores[idx] & ~BIT(cpu_get_id());
+}
+
+static void ams_local_add(struct ams_context *context, const struct ams_consumer_entry *entry)
+{
+	int flags;
+
+	irq_local_disable(flags);
+	for (int iter = 0; iter < AMS_ROUTING_TABLE_SIZE; iter++) {
+		if (context->local_rt[iter].message_type_id == AMS_INVALID_MSG_TYPE) {
+			context->local_rt[iter] = *entry;
+			break;
+		}
+	}
+	irq_local_enable(flags);
+}
+
+static void ams_local_remove(struct ams_context *context, uint32_t message_type_id,
+			     uint16_t module_id, uint16_t instance_id,
+			     ams_msg_callback_fn function)
+{
+	struct ams_consumer_entry *entry;
+	int flags;
+
+	irq_local_disable(flags);
+	for (int iter = 0; iter < AMS_ROUTING_TABLE_SIZE; iter++) {
+		entry = &context->local_rt[iter];
+		if (entry->message_type_id == message_type_id &&
+		    entry->consumer_module_id == module_id &&
+		    entry->consumer_instance_id == instance_id &&
+		    entry->consumer_callback == function) {
+			entry->message_type_id = AMS_INVALID_MSG_TYPE;
+			entry->consumer_callback = NULL;
+			break;
+		}
+	}
+	irq_local_enable(flags);
+}
+
+/* calls the consumers registered on this core in the producer context */
+static bool ams_send_local(struct ams_context *context,
+			   const struct ams_message_payload *const ams_message_payload,
+			   uint16_t module_id, uint16_t instance_id)
+{
+	struct ams_consumer_entry entry;
+	bool found_any = false;
+	int flags;
+
+	for (int iter = 0; iter < AMS_ROUTING_TABLE_SIZE; iter++) {
+		irq_local_disable(flags);
+		entry = context->local_rt[iter];
+		irq_local_enable(flags);
+
+		if (entry.message_type_id != ams_message_payload->message_type_id)
+			continue;
+
+		/* check if we want to limit to specific module */
+		if (module_id != AMS_ANY_ID && instance_id != AMS_ANY_ID) {
+			if (entry.consumer_module_id != module_id ||
+			    entry.consumer_instance_id != instance_id)
+				continue;
+		}
+
+		found_any = true;
+		entry.consumer_callback(ams_message_payload, entry.ctx);
+	}
+
+	return found_any;
+}
+
 static struct uuid_idx __sparse_cache *ams_find_uuid_entry_by_uuid(struct ams_shared_context __sparse_cache *ctx_shared,
 								   uint8_t const *uuid)
 {
@@ -86,11 +201,11 @@ static struct uuid_idx __sparse_cache *ams_find_uuid_entry_by_uuid(struct ams_sh
 int ams_get_message_type_id(const uint8_t *message_uuid,
 			    uint32_t *message_type_id)
 {
-	struct async_message_service *ams = *arch_ams_get();
+	struct async_message_service *ams = ams_get();
 	struct uuid_idx __sparse_cache *uuid_entry;
 	struct ams_shared_context __sparse_cache *shared_c;
 
-	if (!ams->ams_context)
+	if (!ams || !ams->ams_context)
 		return -EINVAL;
 
 	*message_type_id = AMS_INVALID_MSG_TYPE;
@@ -132,13 +247,13 @@ int ams_register_producer(uint32_t message_type_id,
 			  uint16_t module_id,
 			  uint16_t instance_id)
 {
-	struct async_message_service *ams = *arch_ams_get();
+	struct async_message_service *ams = ams_get();
 	struct ams_producer __sparse_cache *producer_table;
 	struct ams_shared_context __sparse_cache *shared_c;
 	int idx;
 	int err = -EINVAL;
 
-	if (!ams->ams_context)
+	if (!ams || !ams->ams_context)
 		return -EINVAL;
 
 	shared_c = ams_acquire(ams->ams_context->shared);
@@ -171,13 +286,13 @@ int ams_unregister_producer(uint32_t message_type_id,
 			    uint16_t module_id,
 			    uint16_t instance_id)
 {
-	struct async_message_service *ams = *arch_ams_get();
+	struct async_message_service *ams = ams_get();
 	struct ams_producer __sparse_cache *producer_table;
 	struct ams_shared_context __sparse_cache *shared_c;
 	int idx;
 	int err = -EINVAL;
 
-	if (!ams->ams_context)
+	if (!ams || !ams->ams_context)
 		return -EINVAL;
 
 	shared_c = ams_acquire(ams->ams_context->shared);
@@ -211,12 +326,14 @@ int ams_register_consumer(uint32_t message_type_id,
 			  ams_msg_callback_fn function,
 			  void *ctx)
 {
-	struct async_message_service *ams = *arch_ams_get();
+	struct async_message_service *ams = ams_get();
 	struct ams_consumer_entry __sparse_cache *routing_table;
 	struct ams_shared_context __sparse_cache *shared_c;
+	struct ams_consumer_entry local = { 0 };
+	int idx = ams_msg_type_index(message_type_id);
 	int err = -EINVAL;
 
-	if (!ams->ams_context || !function)
+	if (!ams || !ams->ams_context || !function)
 		return -EINVAL;
 
 	shared_c = ams_acquire(ams->ams_context->shared);
@@ -232,6 +349,10 @@ int ams_register_consumer(uint32_t message_type_id,
 			routing_table[iter].consumer_module_id = module_id;
 			routing_table[iter].consumer_core_id = cpu_get_id();
 			routing_table[iter].ctx = ctx;
+			local = routing_table[iter];
+
+			if (idx >= 0)
+				shared_c->consumer_cores[idx] |= BIT(cpu_get_id());
 
 			/* Exit loop since we added new entry */
 			err = 0;
@@ -240,6 +361,10 @@ int ams_register_consumer(uint32_t message_type_id,
 	}
 
 	ams_release(shared_c);
+
+	if (!err)
+		ams_local_add(ams->ams_context, &local);
+
 	return err;
 }
 
@@ -248,12 +373,13 @@ int ams_unregister_consumer(uint32_t message_type_id,
 			    uint16_t instance_id,
 			    ams_msg_callback_fn function)
 {
-	struct async_message_service *ams = *arch_ams_get();
+	struct async_message_service *ams = ams_get();
 	struct ams_consumer_entry __sparse_cache *routing_table;
 	struct ams_shared_context __sparse_cache *shared_c;
 	int err = -EINVAL;
+	int idx;
 
-	if (!ams->ams_context)
+	if (!ams || !ams->ams_context)
 		return -EINVAL;
 
 	shared_c = ams_acquire(ams->ams_context->shared);
@@ -274,7 +400,23 @@ int ams_unregister_consumer(uint32_t message_type_id,
 		}
 	}
 
+	idx = ams_msg_type_index(message_type_id);
+	if (!err && idx >= 0) {
+		uint32_t cores = 0;
+
+		for (int iter = 0; iter < AMS_ROUTING_TABLE_SIZE; iter++)
+			if (routing_table[iter].message_type_id == message_type_id)
+				cores |= BIT(routing_table[iter].consumer_core_id);
+
+		shared_c->consumer_cores[idx] = cores;
+	}
+
 	ams_release(shared_c);
+
+	if (!err)
+		ams_local_remove(ams->ams_context, message_type_id, module_id, instance_id,
+				 function);
+
 	return err;
 }
 
@@ -361,9 +503,20 @@ static int ams_message_send_internal(struct async_message_service *ams,
 	int cpu_id;
 	int err = 0;
 
-	if (!ams->ams_context || !ams_message_payload)
+	if (!ams || !ams->ams_context || !ams_message_payload)
 		return -EINVAL;
 
+	/* consumers on this core are called without the shared context and copy */
+	found_any = ams_send_local(ams->ams_context, ams_message_payload, module_id,
+				   instance_id);
+	if (!incoming &&
+	    !ams_has_remote_consumers(ams->ams_context, ams_message_payload->message_type_id)) {
+		if (!found_any)
+			tr_err(&ams_tr, "No entries found!");
+
+		return 0;
+	}
+
 	shared_c = ams_acquire(ams->ams_context->shared);
 	cpu_id = cpu_get_id();
 
@@ -393,12 +546,8 @@ static int ams_message_send_internal(struct async_message_service *ams,
 							ams_target.consumer_core_id);
 
 		if (ixc_route == cpu_id) {
-			/* we are on target core already */
-			/* release lock here, callback are NOT supposed to change routing_table */
-			ams_release(shared_c);
-
-			ams_target.consumer_callback(ams_message_payload, ams_target.ctx);
-			err = 0;
+			/* we are on target core already, called by ams_send_local() */
+			continue;
 		} else {
 			/* we have to go through idc */
 			if (incoming) {
@@ -460,7 +609,7 @@ static int ams_message_send_internal(struct async_message_service *ams,
 
 int ams_send(const struct ams_message_payload *const ams_message_payload)
 {
-	struct async_message_service *ams = *arch_ams_get();
+	struct async_message_service *ams = ams_get();
 
 	return ams_message_send_internal(ams, ams_message_payload, AMS_ANY_ID, AMS_ANY_ID,
 					 AMS_INVALID_SLOT);
@@ -477,7 +626,7 @@ int ams_message_send_mi(struct async_message_service *ams,
 int ams_send_mi(const struct ams_message_payload *const ams_message_payload,
 		uint16_t module_id, uint16_t instance_id)
 {
-	struct async_message_service *ams = *arch_ams_get();
+	struct async_message_service *ams = ams_get();
 
 	return ams_message_send_mi(ams, ams_message_payload, module_id, instance_id);
 }
@@ -516,9 +665,13 @@ static void ams_task_add_slot_to_process(struct ams_task *ams_task, uint32_t slo
 
 int process_incoming_message(uint32_t slot)
 {
-	struct async_message_service *ams = *arch_ams_get();
-	struct ams_task *task = &ams->ams_task;
+	struct async_message_service *ams = ams_get();
+	struct ams_task *task;
+
+	if (!ams)
+		return -ENOMEM;
 
+	task = &ams->ams_task;
 	ams_task_add_slot_to_process(task, slot);
 
 	return schedule_task(&task->ams_task, 0, 10000);
@@ -552,11 +705,10 @@ static enum task_state process_message(void *arg)
 	return SOF_TASK_STATE_COMPLETED;
 }
 
-static int ams_task_init(void)
+static int ams_task_init(struct async_message_service *ams)
 {
-	int ret;
-	struct async_message_service *ams = *arch_ams_get();
 	struct ams_task *task = &ams->ams_task;
+	int ret;
 
 	task->ams = ams;
 
@@ -581,40 +733,41 @@ static int ams_create_shared_context(struct ams_shared_context *ctx)
 
 int ams_init(void)
 {
-	struct ams_shared_context *ams_shared_ctx;
-	struct async_message_service **ams = arch_ams_get();
-	struct sof *sof;
+	struct async_message_service *ams;
+	struct sof *sof = sof_get();
 	int ret = 0;
 
-	*ams = rzalloc(SOF_MEM_ZONE_SYS, SOF_MEM_FLAG_COHERENT, SOF_MEM_CAPS_RAM,
-		       sizeof(**ams));
-	if (!*ams)
+	ams = rzalloc(SOF_MEM_ZONE_SYS, SOF_MEM_FLAG_COHERENT, SOF_MEM_CAPS_RAM,
+		      sizeof(*ams));
+	if (!ams)
 		return -ENOMEM;
 
-	(*ams)->ams_context = &ctx[cpu_get_id()];
-	memset((*ams)->ams_context, 0, sizeof(*(*ams)->ams_context));
+	ams->ams_context = &ctx[cpu_get_id()];
+	memset(ams->ams_context, 0, sizeof(*ams->ams_context));
 
-	if (cpu_get_id() == PLATFORM_PRIMARY_CORE_ID) {
-		sof = sof_get();
+	/* The context shared by all cores is created by the first core using the
+	 * service, which is the primary core unless CONFIG_AMS_LAZY_INIT is set.
+	 */
+	if (!sof->ams_shared_ctx) {
 		sof->ams_shared_ctx = coherent_init(struct ams_shared_context, c);
 		if (!sof->ams_shared_ctx)
 			goto err;
 		coherent_shared(sof->ams_shared_ctx, c);
+		ams_create_shared_context(sof->ams_shared_ctx);
 	}
 
-	ams_shared_ctx = ams_ctx_get();
-	(*ams)->ams_context->shared = ams_shared_ctx;
-
-	ams_create_shared_context((*ams)->ams_context->shared);
+	ams->ams_context->shared = ams_ctx_get();
 
 #if CONFIG_SMP
-	ret = ams_task_init();
+	ret = ams_task_init(ams);
 #endif /* CONFIG_SMP */
 
+	/* publish last, the lazy init fast path reads it without the lock */
+	*arch_ams_get() = ams;
 	return ret;
 
 err:
-	rfree(*ams);
+	rfree(ams);
 
 	return -ENOMEM;
 }
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/**
+ * \file
+ * \brief Per core accounting of data cache maintenance
+ *
+ * Each core only updates its own counters. They are accessed through the
+ * uncached alias so that the core posting them to the telemetry buffers
+ * reads the current values without any cache operation of its own.
+ */
+
+#include <sof/common.h>
+#include <sof/lib/cache_stats.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/memory.h>
+#if CONFIG_SOF_TELEMETRY
+#include <sof/debug/telemetry/telemetry.h>
+#include <ipc4/module.h>
+#endif
+#include <rtos/timer.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static struct cache_stats cache_stats_cores[CONFIG_CORE_COUNT];
+
+struct cache_stats *cache_stats_core(int core)
+{
+	return cache_to_uncache((__sparse_force void __sparse_cache *)&cache_stats_cores[core]);
+}
+
+static inline void cache_stats_add(struct cache_stats *stats, uint32_t ops, size_t size,
+				   uint64_t cycles)
+{
+	if (ops & CACHE_STATS_INVALIDATE) {
+		stats->invalidates++;
+		stats->invalidate_bytes += size;
+		stats->invalidate_cycles += cycles;
+	}
+
+	if (ops & CACHE_STATS_WRITEBACK) {
+		stats->writebacks++;
+		stats->writeback_bytes += size;
+		/* a combined operation is not split, its cycles go to the invalidates */
+		if (!(ops & CACHE_STATS_INVALIDATE))
+			stats->writeback_cycles += cycles;
+	}
+}
+
+void cache_stats_account(struct cache_stats *stats, uint32_t ops, size_t size, uint64_t start)
+{
+	uint64_t cycles = sof_cycle_get_64() - start;
+
+	cache_stats_add(cache_stats_core(cpu_get_id()), ops, size, cycles);
+	if (stats)
+		cache_stats_add(stats, ops, size, cycles);
+}
+
+#if CONFIG_SOF_TELEMETRY
+void cache_stats_record(struct telemetry_cache_stats *record, const struct cache_stats *stats)
+{
+	/* read while the counters may be updated, fields can be one operation apart */
+	record->invalidates = stats->invalidates;
+	record->writebacks = stats->writebacks;
+	record->invalidate_bytes = stats->invalidate_bytes;
+	record->writeback_bytes = stats->writeback_bytes;
+	record->invalidate_cycles = stats->invalidate_cycles;
+	record->writeback_cycles = stats->writeback_cycles;
+}
+
+void cache_stats_post(void)
+{
+	struct telemetry_cache_stats record;
+	const struct cache_stats *stats;
+	int core;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		stats = cache_stats_core(core);
+		if (!stats->invalidates && !stats->writebacks)
+			continue;
+
+		cache_stats_record(&record, stats);
+		telemetry_post(TELEMETRY_RECORD_CACHE_STATS, IPC4_COMP_ID(0, core),
+			       &record, sizeof(record));
+	}
+}
+#endif
@@ -8,15 +8,39 @@
 #include <rtos/sof.h>
 #include <stdint.h>
 #include <sof/lib/cpu-clk-manager.h>
+#include <sof/lib/cpu.h>
 #include <rtos/clk.h>
 #include <sof/math/numbers.h>
+#include <sof/debug/telemetry/performance_monitor.h>
 #include <errno.h>
 #ifdef __ZEPHYR__
 #include <zephyr/sys/util.h>
 #endif /* __ZEPHYR__ */
+#if CONFIG_KCPS_DVFS_GOVERNOR
+#include <rtos/atomic.h>
+#include <rtos/timer.h>
+#include <sof/debug/telemetry/telemetry.h>
+#endif
 
 static struct kcps_budget_data kcps_data;
 
+#if CONFIG_KCPS_DVFS_GOVERNOR
+/* load of a core, updated by the core itself and read on the primary core */
+struct kcps_gov_core {
+	atomic_t busy;		/* busy platform timer cycles in the window */
+	atomic_t kcps;		/* measured load in the last window */
+	uint64_t window_start;	/* start of the window in platform timer cycles */
+	uint64_t tick_start;	/* start of the previous LL tick */
+	uint32_t ticks;		/* LL ticks in the window */
+};
+
+static struct kcps_gov {
+	struct kcps_gov_core core[CONFIG_CORE_COUNT];
+	atomic_t overrun;	/* an LL tick came close to overrun */
+	uint32_t down_windows;	/* consecutive windows with headroom */
+} kcps_gov;
+#endif
+
 static int request_freq_change(unsigned int core, int freq)
 {
 	int current_freq;
@@ -63,6 +87,11 @@ int core_kcps_adjust(int adjusted_core_id, int kcps_delta)
 	freq = max_core_consumption();
 
 	for (core_id = 0; core_id < CONFIG_CORE_COUNT; core_id++) {
+#if CONFIG_KCPS_DVFS_GOVERNOR
+		/* the governor lowers the clock when the measured load allows */
+		if (freq * 1000 <= clock_get_freq(core_id))
+			continue;
+#endif
 		/* Convert kcps to cps */
 		ret = request_freq_change(core_id, freq * 1000);
 		if (ret < 0)
@@ -86,6 +115,175 @@ int core_kcps_get(int core)
 	return ret;
 }
 
+/* KCPS left on the core at its highest clock, minus the larger of the
+ * declared and measured consumption
+ */
+static int core_kcps_spare(int core)
+{
+	struct clock_info *clk = clocks_get() + core;
+	int load = kcps_data.kcps_consumption[core];
+
+#if CONFIG_SOF_TELEMETRY_PERFORMANCE_MEASUREMENTS
+	load = MAX(load, (int)perf_meas_get_core_kcps(core));
+#endif
+
+	return (int)(clk->freqs[clk->freqs_num - 1].freq / 1000) - load;
+}
+
+int core_kcps_least_loaded(int preferred)
+{
+	k_spinlock_key_t key;
+	int best = preferred;
+	int best_spare;
+	int spare;
+	int core;
+
+	key = k_spin_lock(&kcps_data.lock);
+
+	best_spare = cpu_is_core_enabled(preferred) ? core_kcps_spare(preferred) : INT32_MIN;
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		if (core == preferred || !cpu_is_core_enabled(core))
+			continue;
+
+		spare = core_kcps_spare(core);
+		if (spare > best_spare) {
+			best = core;
+			best_spare = spare;
+		}
+	}
+
+	k_spin_unlock(&kcps_data.lock, key);
+
+	return best;
+}
+
+int core_kcps_pack(int kcps)
+{
+	k_spinlock_key_t key;
+	int disabled = -1;
+	int core;
+
+	key = k_spin_lock(&kcps_data.lock);
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		if (!cpu_is_core_enabled(core)) {
+			if (disabled < 0)
+				disabled = core;
+		} else if (core_kcps_spare(core) >= kcps) {
+			break;
+		}
+	}
+	k_spin_unlock(&kcps_data.lock, key);
+
+	if (core < CONFIG_CORE_COUNT)
+		return core;
+	if (disabled >= 0)
+		return disabled;
+
+	return core_kcps_least_loaded(PLATFORM_PRIMARY_CORE_ID);
+}
+
+#if CONFIG_KCPS_DVFS_GOVERNOR
+/* lowest clock of the core not below freq */
+static int kcps_gov_pick_freq(unsigned int core, int freq)
+{
+	struct clock_info *clk = clocks_get() + core;
+	int i;
+
+	for (i = 0; i < clk->freqs_num - 1; i++)
+		if (freq <= clk->freqs[i].freq)
+			break;
+
+	return clk->freqs[i].freq;
+}
+
+static void kcps_gov_set(int freq)
+{
+	k_spinlock_key_t key;
+	unsigned int core;
+
+	key = k_spin_lock(&kcps_data.lock);
+	for (core = 0; core < CONFIG_CORE_COUNT; core++)
+		if (clock_get_freq(core) != freq)
+			clock_set_freq(core, freq);
+	k_spin_unlock(&kcps_data.lock, key);
+
+#if CONFIG_SOF_TELEMETRY
+	telemetry_post(TELEMETRY_RECORD_CLOCK, 0, &freq, sizeof(freq));
+#endif
+}
+
+/* set the clock so that the most loaded core runs at the target load,
+ * raise right away and lower only after the load stayed low
+ */
+static void kcps_gov_update(void)
+{
+	int current = clock_get_freq(PLATFORM_PRIMARY_CORE_ID);
+	int64_t load = 0;
+	unsigned int core;
+	int freq;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++)
+		if (cpu_is_core_enabled(core))
+			load = MAX(load, (int64_t)atomic_read(&kcps_gov.core[core].kcps));
+
+	/* KCPS to Hz at the target load */
+	freq = kcps_gov_pick_freq(PLATFORM_PRIMARY_CORE_ID,
+				  load * 1000 * 100 / CONFIG_KCPS_DVFS_TARGET_LOAD);
+
+	if (freq < current && ++kcps_gov.down_windows < CONFIG_KCPS_DVFS_DOWN_WINDOWS)
+		return;
+
+	kcps_gov.down_windows = 0;
+	if (freq != current)
+		kcps_gov_set(freq);
+}
+
+void core_kcps_busy_add(uint32_t cycles)
+{
+	atomic_add(&kcps_gov.core[cpu_get_id()].busy, cycles);
+}
+
+void core_kcps_ll_tick(uint64_t start)
+{
+	unsigned int core = cpu_get_id();
+	struct kcps_gov_core *gc = &kcps_gov.core[core];
+	struct clock_info *clk;
+	uint64_t now = sof_cycle_get_64();
+	uint64_t busy = now - start;
+	uint64_t elapsed;
+	uint32_t window_busy;
+
+	atomic_add(&gc->busy, busy);
+
+	/* the tick took most of the time until this one started */
+	if (gc->tick_start &&
+	    busy * 100 > (start - gc->tick_start) * CONFIG_KCPS_DVFS_HIGH_LOAD)
+		atomic_set(&kcps_gov.overrun, 1);
+	gc->tick_start = start;
+
+	if (++gc->ticks >= CONFIG_KCPS_DVFS_WINDOW_TICKS) {
+		elapsed = now - gc->window_start;
+		window_busy = atomic_read(&gc->busy);
+		atomic_sub(&gc->busy, window_busy);
+		atomic_set(&gc->kcps, (int)((uint64_t)window_busy *
+					    (clock_get_freq(core) / 1000) / elapsed));
+		gc->window_start = now;
+		gc->ticks = 0;
+
+		if (core == PLATFORM_PRIMARY_CORE_ID && !atomic_read(&kcps_gov.overrun))
+			kcps_gov_update();
+	}
+
+	if (core == PLATFORM_PRIMARY_CORE_ID && atomic_read(&kcps_gov.overrun)) {
+		atomic_set(&kcps_gov.overrun, 0);
+		kcps_gov.down_windows = 0;
+		clk = clocks_get() + core;
+		if (clock_get_freq(core) != clk->freqs[clk->freqs_num - 1].freq)
+			kcps_gov_set(clk->freqs[clk->freqs_num - 1].freq);
+	}
+}
+#endif /* CONFIG_KCPS_DVFS_GOVERNOR */
+
 int kcps_budget_init(void)
 {
 	k_spinlock_init(&kcps_data.lock);
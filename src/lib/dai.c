@@ -128,6 +128,20 @@ void dai_group_put(struct dai_group *group)
 		group->group_id = 0;
 }
 
+#if CONFIG_COMP_DAI_GROUP_HW_SYNC
+static const struct dai_group_sync_ops *group_sync_ops;
+
+void dai_group_sync_register(const struct dai_group_sync_ops *ops)
+{
+	group_sync_ops = ops;
+}
+
+const struct dai_group_sync_ops *dai_group_sync_get(void)
+{
+	return group_sync_ops;
+}
+#endif
+
 #if CONFIG_ZEPHYR_NATIVE_DRIVERS
 
 #define GET_DEVICE_LIST(node) DEVICE_DT_GET(node),
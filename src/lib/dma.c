@@ -7,6 +7,7 @@
 #include <rtos/atomic.h>
 #include <sof/audio/audio_stream.h>
 #include <sof/audio/buffer.h>
+#include <sof/audio/pcm_converter.h>
 #include <rtos/alloc.h>
 #include <rtos/cache.h>
 #include <sof/lib/dma.h>
@@ -129,10 +130,15 @@ void dma_put(struct dma *dma)
 	k_spinlock_key_t key;
 
 	key = k_spin_lock(&dma->lock);
+#if !CONFIG_DMA_SG_POOL
 	if (--dma->sref == 0) {
 		rfree(dma->chan);
 		dma->chan = NULL;
 	}
+#else
+	/* the channels are kept for the next user */
+	--dma->sref;
+#endif
 
 	tr_info(&dma_tr, "dma_put(), dma = %p, sref = %d",
 		dma, dma->sref);
@@ -144,6 +150,11 @@ static int dma_init(struct dma *dma)
 	struct dma_chan_data *chan;
 	int i;
 
+#if CONFIG_DMA_SG_POOL
+	if (dma->chan)
+		return 0;
+#endif
+
 	/* allocate dma channels */
 	dma->chan = rzalloc(SOF_MEM_ZONE_RUNTIME_SHARED, 0, SOF_MEM_CAPS_RAM,
 			    sizeof(struct dma_chan_data) * dma->plat_data.channels);
@@ -281,6 +292,63 @@ void dma_put(struct dma *dma)
 }
 #endif
 
+#if CONFIG_DMA_SG_POOL
+struct dma_sg_pool_slot {
+	struct dma_sg_elem elems[CONFIG_DMA_SG_POOL_ELEMS];
+	bool used;
+};
+
+struct dma_sg_pool {
+	struct k_spinlock lock;
+	struct dma_sg_pool_slot slots[CONFIG_DMA_SG_POOL_SLOTS];
+};
+
+static SHARED_DATA struct dma_sg_pool sg_pool;
+
+static struct dma_sg_elem *dma_sg_pool_get(uint32_t buffer_count)
+{
+	struct dma_sg_pool_slot *slot;
+	struct dma_sg_elem *elems = NULL;
+	k_spinlock_key_t key;
+
+	if (buffer_count > CONFIG_DMA_SG_POOL_ELEMS)
+		return NULL;
+
+	key = k_spin_lock(&sg_pool.lock);
+
+	for (slot = sg_pool.slots; slot < sg_pool.slots + CONFIG_DMA_SG_POOL_SLOTS; slot++)
+		if (!slot->used) {
+			slot->used = true;
+			elems = slot->elems;
+			break;
+		}
+
+	k_spin_unlock(&sg_pool.lock, key);
+
+	return elems;
+}
+
+/* Returns true when the elements belong to the pool */
+static bool dma_sg_pool_put(struct dma_sg_elem *elems)
+{
+	struct dma_sg_pool_slot *slot;
+	k_spinlock_key_t key;
+
+	for (slot = sg_pool.slots; slot < sg_pool.slots + CONFIG_DMA_SG_POOL_SLOTS; slot++)
+		if (elems == slot->elems)
+			break;
+
+	if (slot == sg_pool.slots + CONFIG_DMA_SG_POOL_SLOTS)
+		return false;
+
+	key = k_spin_lock(&sg_pool.lock);
+	slot->used = false;
+	k_spin_unlock(&sg_pool.lock, key);
+
+	return true;
+}
+#endif
+
 int dma_sg_alloc(struct dma_sg_elem_array *elem_array,
 		 enum mem_zone zone,
 		 uint32_t direction,
@@ -289,10 +357,20 @@ int dma_sg_alloc(struct dma_sg_elem_array *elem_array,
 {
 	int i;
 
-	elem_array->elems = rzalloc(zone, 0, SOF_MEM_CAPS_RAM,
-				    sizeof(struct dma_sg_elem) * buffer_count);
-	if (!elem_array->elems)
-		return -ENOMEM;
+	elem_array->elems = NULL;
+
+#if CONFIG_DMA_SG_POOL
+	/* stream element arrays are taken from the pool */
+	if (zone == SOF_MEM_ZONE_RUNTIME)
+		elem_array->elems = dma_sg_pool_get(buffer_count);
+#endif
+
+	if (!elem_array->elems) {
+		elem_array->elems = rzalloc(zone, 0, SOF_MEM_CAPS_RAM,
+					    sizeof(struct dma_sg_elem) * buffer_count);
+		if (!elem_array->elems)
+			return -ENOMEM;
+	}
 
 	for (i = 0; i < buffer_count; i++) {
 		elem_array->elems[i].size = buffer_bytes;
@@ -317,7 +395,10 @@ int dma_sg_alloc(struct dma_sg_elem_array *elem_array,
 
 void dma_sg_free(struct dma_sg_elem_array *elem_array)
 {
-	rfree(elem_array->elems);
+#if CONFIG_DMA_SG_POOL
+	if (!dma_sg_pool_put(elem_array->elems))
+#endif
+		rfree(elem_array->elems);
 	dma_sg_init(elem_array);
 }
 
@@ -350,6 +431,59 @@ int dma_buffer_copy_from(struct comp_buffer *source,
 	return ret;
 }
 
+int dma_buffer_copy_from_att(struct comp_buffer *source,
+			     struct comp_buffer *sink,
+			     dma_process_att_func process, uint32_t source_bytes,
+			     uint32_t attenuation)
+{
+	struct audio_stream *istream = &source->stream;
+	uint32_t samples = source_bytes /
+			   audio_stream_sample_bytes(istream);
+	uint32_t sink_bytes = audio_stream_sample_bytes(&sink->stream) *
+			      samples;
+	int ret;
+
+	/* source buffer contains data copied by DMA */
+	audio_stream_invalidate(istream, source_bytes);
+
+	/* convert and attenuate data in a single pass */
+	ret = process(istream, 0, &sink->stream, 0, samples, attenuation);
+
+	buffer_stream_writeback(sink, sink_bytes);
+
+	audio_stream_consume(istream, source_bytes);
+	comp_update_buffer_produce(sink, sink_bytes);
+
+	return ret;
+}
+
+int dma_buffer_copy_from_gain(struct comp_buffer *source,
+			      struct comp_buffer *sink,
+			      dma_process_gain_func process, uint32_t source_bytes,
+			      struct pcm_gain *gain)
+{
+	struct audio_stream *istream = &source->stream;
+	uint32_t samples = source_bytes /
+			   audio_stream_sample_bytes(istream);
+	uint32_t sink_bytes = audio_stream_sample_bytes(&sink->stream) *
+			      samples;
+	int ret;
+
+	/* source buffer contains data copied by DMA */
+	audio_stream_invalidate(istream, source_bytes);
+
+	/* convert and apply the gain in a single pass */
+	ret = process(istream, 0, &sink->stream, 0, samples, gain);
+	pcm_gain_advance(gain, samples / gain->channels);
+
+	buffer_stream_writeback(sink, sink_bytes);
+
+	audio_stream_consume(istream, source_bytes);
+	comp_update_buffer_produce(sink, sink_bytes);
+
+	return ret;
+}
+
 int dma_buffer_copy_to(struct comp_buffer *source,
 		       struct comp_buffer *sink,
 		       dma_process_func process, uint32_t sink_bytes)
@@ -379,6 +513,33 @@ int dma_buffer_copy_to(struct comp_buffer *source,
 	return ret;
 }
 
+int dma_buffer_copy_to_gain(struct comp_buffer *source,
+			    struct comp_buffer *sink,
+			    dma_process_gain_func process, uint32_t sink_bytes,
+			    struct pcm_gain *gain)
+{
+	struct audio_stream *ostream = &sink->stream;
+	uint32_t samples = sink_bytes /
+			   audio_stream_sample_bytes(ostream);
+	uint32_t source_bytes = audio_stream_sample_bytes(&source->stream) *
+			      samples;
+	int ret;
+
+	buffer_stream_invalidate(source, source_bytes);
+
+	/* convert and apply the gain in a single pass */
+	ret = process(&source->stream, 0, ostream, 0, samples, gain);
+	pcm_gain_advance(gain, samples / gain->channels);
+
+	/* sink buffer contains data meant to copied to DMA */
+	audio_stream_writeback(ostream, sink_bytes);
+
+	audio_stream_produce(ostream, sink_bytes);
+	comp_update_buffer_consume(source, source_bytes);
+
+	return ret;
+}
+
 int dma_buffer_copy_from_no_consume(struct comp_buffer *source,
 				    struct comp_buffer *sink,
 				    dma_process_func process, uint32_t source_bytes)
@@ -399,3 +560,26 @@ int dma_buffer_copy_from_no_consume(struct comp_buffer *source,
 
 	return ret;
 }
+
+int dma_buffer_copy_from_gain_no_consume(struct comp_buffer *source,
+					 struct comp_buffer *sink,
+					 dma_process_gain_func process, uint32_t source_bytes,
+					 struct pcm_gain *gain)
+{
+	struct audio_stream *istream = &source->stream;
+	uint32_t samples = source_bytes /
+			   audio_stream_sample_bytes(istream);
+	uint32_t sink_bytes = audio_stream_sample_bytes(&sink->stream) *
+			      samples;
+	int ret;
+
+	/* convert and apply the gain in a single pass */
+	ret = process(istream, 0, &sink->stream, 0, samples, gain);
+	pcm_gain_advance(gain, samples / gain->channels);
+
+	buffer_stream_writeback(sink, sink_bytes);
+
+	comp_update_buffer_produce(sink, sink_bytes);
+
+	return ret;
+}
@@ -34,9 +34,23 @@ struct callback_handle {
 	void *caller;
 	void (*cb)(void *arg, enum notify_id, void *data);
 	struct list_item list;
+	struct list_item caller_list;	/* in any_caller or by_caller */
 	uint32_t num_registrations;
 };
 
+/* list of the handles registered with caller as caller filter */
+static struct list_item *notifier_caller_list(struct notify *notify, enum notify_id type,
+					      const void *caller)
+{
+	uintptr_t key = (uintptr_t)caller;
+
+	if (!caller)
+		return &notify->any_caller[type];
+
+	/* callers are structures, their low address bits are mostly zero */
+	return &notify->by_caller[type][((key >> 4) ^ (key >> 10)) & (NOTIFIER_CALLER_HASH - 1)];
+}
+
 int notifier_register(void *receiver, void *caller, enum notify_id type,
 		      void (*cb)(void *arg, enum notify_id type, void *data),
 		      uint32_t flags)
@@ -75,6 +89,7 @@ int notifier_register(void *receiver, void *caller, enum notify_id type,
 	handle->num_registrations = 1;
 
 	list_item_prepend(&handle->list, &notify->list[type]);
+	list_item_prepend(&handle->caller_list, notifier_caller_list(notify, type, caller));
 
 out:
 	k_spin_unlock(&notify->lock, key);
@@ -109,6 +124,7 @@ void notifier_unregister(void *receiver, void *caller, enum notify_id type)
 		    (!caller || handle->caller == caller)) {
 			if (!--handle->num_registrations) {
 				list_item_del(&handle->list);
+				list_item_del(&handle->caller_list);
 				rfree(handle);
 			}
 		}
@@ -135,9 +151,25 @@ static void notifier_notify(const void *caller, enum notify_id type, void *data)
 	/* iterate through notifiers and send event to
 	 * interested clients
 	 */
-	list_for_item_safe(wlist, tlist, &notify->list[type]) {
-		handle = container_of(wlist, struct callback_handle, list);
-		if (!caller || !handle->caller || handle->caller == caller)
+	if (!caller) {
+		list_for_item_safe(wlist, tlist, &notify->list[type]) {
+			handle = container_of(wlist, struct callback_handle, list);
+			handle->cb(handle->receiver, type, data);
+		}
+		return;
+	}
+
+	/* only the clients without caller filter and the ones sharing the
+	 * index bucket of the caller need to be checked
+	 */
+	list_for_item_safe(wlist, tlist, &notify->any_caller[type]) {
+		handle = container_of(wlist, struct callback_handle, caller_list);
+		handle->cb(handle->receiver, type, data);
+	}
+
+	list_for_item_safe(wlist, tlist, notifier_caller_list(notify, type, caller)) {
+		handle = container_of(wlist, struct callback_handle, caller_list);
+		if (handle->caller == caller)
 			handle->cb(handle->receiver, type, data);
 	}
 }
@@ -193,12 +225,17 @@ void init_system_notify(struct sof *sof)
 {
 	struct notify **notify = arch_notify_get();
 	int i;
+	int j;
 	*notify = rzalloc(SOF_MEM_ZONE_SYS, SOF_MEM_FLAG_COHERENT, SOF_MEM_CAPS_RAM,
 			  sizeof(**notify));
 
 	k_spinlock_init(&(*notify)->lock);
-	for (i = NOTIFIER_ID_CPU_FREQ; i < NOTIFIER_ID_COUNT; i++)
+	for (i = NOTIFIER_ID_CPU_FREQ; i < NOTIFIER_ID_COUNT; i++) {
 		list_init(&(*notify)->list[i]);
+		list_init(&(*notify)->any_caller[i]);
+		for (j = 0; j < NOTIFIER_CALLER_HASH; j++)
+			list_init(&(*notify)->by_caller[i][j]);
+	}
 
 	if (cpu_get_id() == PLATFORM_PRIMARY_CORE_ID)
 		sof->notify_data = platform_shared_get(notify_data_shared,
@@ -41,24 +41,119 @@ struct lib_manager_dma_ext {
 	struct dma *dma;
 	struct dma_chan_data *chan;
 	uintptr_t dma_addr;		/**< buffer start pointer */
+	uint32_t dma_size;		/**< buffer size */
+	uint32_t dma_rd;		/**< read offset in buffer */
 	uint32_t addr_align;
 };
 
+/*
+ * The DMA buffer is consumed in halves, the host DMA fills one half while
+ * the other is copied out to the library storage.
+ */
+#define LIB_MANAGER_DMA_CHUNK	(MAN_MAX_SIZE_V1_8 / 2)
+
 static struct ext_library loader_ext_lib;
 
 #if IS_ENABLED(CONFIG_MM_DRV)
 
 #define PAGE_SZ		CONFIG_MM_DRV_PAGE_SIZE
 
+#if CONFIG_LIBRARY_MANAGER_LZ4
+#define LZ4_MIN_MATCH	4
+
+/* adds the extra bytes of an LZ4 length, false at the end of the block */
+static bool lib_manager_lz4_length(const uint8_t **ip, const uint8_t *iend, size_t *len)
+{
+	uint8_t b;
+
+	do {
+		if (*ip >= iend)
+			return false;
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255);
+
+	return true;
+}
+
+/*
+ * Expands the LZ4 block of a compressed segment straight into its mapped
+ * memory, which it has to fill exactly.
+ */
+static int lib_manager_lz4_expand(uint8_t *dst, size_t size,
+				  const struct sof_man_segment_lz4 *stored)
+{
+	const uint8_t *ip = stored->block;
+	const uint8_t *iend = ip + stored->size;
+	uint8_t *op = dst;
+	uint8_t *oend = dst + size;
+	const uint8_t *match;
+	size_t offset;
+	size_t len;
+	uint8_t token;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		len = token >> 4;
+		if (len == 15 && !lib_manager_lz4_length(&ip, iend, &len))
+			return -EINVAL;
+		if (len > iend - ip || len > oend - op)
+			return -EINVAL;
+
+		memcpy(op, ip, len);
+		op += len;
+		ip += len;
+
+		/* the last sequence has no match */
+		if (ip == iend)
+			break;
+
+		if (iend - ip < 2)
+			return -EINVAL;
+		offset = ip[0] | ip[1] << 8;
+		ip += 2;
+
+		len = token & 0xf;
+		if (len == 15 && !lib_manager_lz4_length(&ip, iend, &len))
+			return -EINVAL;
+		len += LZ4_MIN_MATCH;
+		if (!offset || offset > op - dst || len > oend - op)
+			return -EINVAL;
+
+		/* a match closer than its length repeats the bytes it writes */
+		match = op - offset;
+		if (offset >= len) {
+			memcpy(op, match, len);
+			op += len;
+		} else {
+			while (len--)
+				*op++ = *match++;
+		}
+	}
+
+	return op == oend ? 0 : -EINVAL;
+}
+#else
+static int lib_manager_lz4_expand(uint8_t *dst, size_t size,
+				  const struct sof_man_segment_lz4 *stored)
+{
+	return -ENOTSUP;
+}
+#endif
+
 static int lib_manager_load_data_from_storage(void __sparse_cache *vma, void *s_addr,
-					      uint32_t size, uint32_t flags)
+					      uint32_t size, uint32_t flags, bool compressed)
 {
 	int ret = sys_mm_drv_map_region((__sparse_force void *)vma, POINTER_TO_UINT(NULL),
 					size, flags);
 	if (ret < 0)
 		return ret;
 
-	ret = memcpy_s((__sparse_force void *)vma, size, s_addr, size);
+	if (compressed)
+		ret = lib_manager_lz4_expand((__sparse_force uint8_t *)vma, size, s_addr);
+	else
+		ret = memcpy_s((__sparse_force void *)vma, size, s_addr, size);
 	if (ret < 0)
 		return ret;
 
@@ -90,13 +185,15 @@ static int lib_manager_load_module(uint32_t module_id, struct sof_man_module *mo
 
 	/* Copy Code */
 	ret = lib_manager_load_data_from_storage(va_base_text, src_txt, st_text_size,
-						 SYS_MM_MEM_PERM_RW | SYS_MM_MEM_PERM_EXEC);
+						 SYS_MM_MEM_PERM_RW | SYS_MM_MEM_PERM_EXEC,
+						 mod->segment[SOF_MAN_SEGMENT_TEXT].flags.r.compressed);
 	if (ret < 0)
 		goto err;
 
 	/* Copy RODATA */
 	ret = lib_manager_load_data_from_storage(va_base_rodata, src_rodata,
-						 st_rodata_size, SYS_MM_MEM_PERM_RW);
+						 st_rodata_size, SYS_MM_MEM_PERM_RW,
+						 mod->segment[SOF_MAN_SEGMENT_RODATA].flags.r.compressed);
 	if (ret < 0)
 		goto err;
 
@@ -113,7 +210,7 @@ static int lib_manager_load_module(uint32_t module_id, struct sof_man_module *mo
 				++idx, ++module_entry) {
 			if (module_entry->type.lib_code) {
 				ret = lib_manager_load_module(lib_id << LIB_MANAGER_LIB_ID_SHIFT |
-							      idx, mod, desc);
+							      idx, module_entry, desc);
 				if (ret < 0)
 					goto err;
 			}
@@ -170,7 +267,7 @@ static int lib_manager_unload_module(uint32_t module_id, struct sof_man_module *
 			if (module_entry->type.lib_code) {
 				ret =
 				lib_manager_unload_module(lib_id << LIB_MANAGER_LIB_ID_SHIFT |
-							  idx, mod, desc);
+							  idx, module_entry, desc);
 			}
 		}
 	}
@@ -238,31 +335,134 @@ static int lib_manager_free_module_instance(uint32_t module_id, uint32_t instanc
 	return sys_mm_drv_unmap_region((__sparse_force void *)va_base, bss_size);
 }
 
+static struct sof_man_module *lib_manager_get_module_manifest(uint32_t module_id,
+								struct sof_man_fw_desc **desc)
+{
+	*desc = lib_manager_get_library_module_desc(module_id);
+	if (!*desc)
+		return NULL;
+
+	return (struct sof_man_module *)((char *)*desc +
+		SOF_MAN_MODULE_OFFSET(LIB_MANAGER_GET_MODULE_INDEX(module_id)));
+}
+
+static struct lib_manager_mod_res *lib_manager_find_resident(struct ext_library *ext_lib,
+							     uint32_t module_id)
+{
+	struct list_item *item;
+
+	list_for_item(item, &ext_lib->mods_resident) {
+		struct lib_manager_mod_res *res =
+			container_of(item, struct lib_manager_mod_res, list);
+
+		if (res->module_id == module_id)
+			return res;
+	}
+
+	return NULL;
+}
+
+/*
+ * Unmap modules without instances, least recently used first, until the
+ * mapped pages fit in CONFIG_LIBRARY_MANAGER_RESIDENT_PAGES.
+ */
+static void lib_manager_evict(struct ext_library *ext_lib)
+{
+	struct lib_manager_mod_res *victim;
+	struct sof_man_fw_desc *desc;
+	struct sof_man_module *mod;
+	struct list_item *item;
+	int ret;
+
+	while (ext_lib->mods_resident_pages > CONFIG_LIBRARY_MANAGER_RESIDENT_PAGES) {
+		victim = NULL;
+		list_for_item_prev(item, &ext_lib->mods_resident) {
+			struct lib_manager_mod_res *res =
+				container_of(item, struct lib_manager_mod_res, list);
+
+			if (!res->refs) {
+				victim = res;
+				break;
+			}
+		}
+
+		if (!victim)
+			return;
+
+		mod = lib_manager_get_module_manifest(victim->module_id, &desc);
+		ret = lib_manager_unload_module(victim->module_id, mod, desc);
+		if (ret < 0)
+			tr_err(&lib_manager_tr, "lib_manager_evict(): mod_id: %#x unload failed: %d",
+			       victim->module_id, ret);
+
+		tr_dbg(&lib_manager_tr, "lib_manager_evict(): mod_id: %#x, pages: %u",
+		       victim->module_id, victim->pages);
+
+		ext_lib->mods_resident_pages -= victim->pages;
+		list_item_del(&victim->list);
+		rfree(victim);
+	}
+}
+
+/* Map the module unless it is still resident and make it the most recently used */
+static struct lib_manager_mod_res *lib_manager_get_resident(uint32_t module_id,
+							    struct sof_man_module *mod,
+							    struct sof_man_fw_desc *desc)
+{
+	struct ext_library *ext_lib = ext_lib_get();
+	struct lib_manager_mod_res *res;
+	int ret;
+
+	res = lib_manager_find_resident(ext_lib, module_id);
+	if (res) {
+		list_item_del(&res->list);
+		list_item_prepend(&res->list, &ext_lib->mods_resident);
+		return res;
+	}
+
+	res = rzalloc(SOF_MEM_ZONE_RUNTIME_SHARED, 0, SOF_MEM_CAPS_RAM, sizeof(*res));
+	if (!res)
+		return NULL;
+
+	ret = lib_manager_load_module(module_id, mod, desc);
+	if (ret < 0) {
+		rfree(res);
+		return NULL;
+	}
+
+	res->module_id = module_id;
+	res->pages = mod->segment[SOF_MAN_SEGMENT_TEXT].flags.r.length +
+		mod->segment[SOF_MAN_SEGMENT_RODATA].flags.r.length;
+	list_item_prepend(&res->list, &ext_lib->mods_resident);
+	ext_lib->mods_resident_pages += res->pages;
+
+	return res;
+}
+
 uint32_t lib_manager_allocate_module(const struct comp_driver *drv,
 				     struct comp_ipc_config *ipc_config,
 				     const void *ipc_specific_config)
 {
+	struct ext_library *ext_lib = ext_lib_get();
+	struct lib_manager_mod_res *res;
 	struct sof_man_fw_desc *desc;
 	struct sof_man_module *mod;
 	const struct ipc4_base_module_cfg *base_cfg = ipc_specific_config;
 	int ret;
 	uint32_t module_id = IPC4_MOD_ID(ipc_config->id);
-	uint32_t entry_index = LIB_MANAGER_GET_MODULE_INDEX(module_id);
 
 	tr_dbg(&lib_manager_tr, "lib_manager_allocate_module(): mod_id: %#x",
 	       ipc_config->id);
 
-	desc = lib_manager_get_library_module_desc(module_id);
-	if (!desc) {
+	mod = lib_manager_get_module_manifest(module_id, &desc);
+	if (!mod) {
 		tr_err(&lib_manager_tr,
 		       "lib_manager_allocate_module(): failed to get module descriptor");
 		return 0;
 	}
 
-	mod = (struct sof_man_module *)((char *)desc + SOF_MAN_MODULE_OFFSET(entry_index));
-
-	ret = lib_manager_load_module(module_id, mod, desc);
-	if (ret < 0)
+	res = lib_manager_get_resident(module_id, mod, desc);
+	if (!res)
 		return 0;
 
 	ret = lib_manager_allocate_module_instance(module_id, IPC4_INST_ID(ipc_config->id),
@@ -270,28 +470,35 @@ uint32_t lib_manager_allocate_module(const struct comp_driver *drv,
 	if (ret < 0) {
 		tr_err(&lib_manager_tr,
 		       "lib_manager_allocate_module(): module allocation failed: %d", ret);
+		lib_manager_evict(ext_lib);
 		return 0;
 	}
+
+	res->refs++;
+	lib_manager_evict(ext_lib);
+
 	return mod->entry_point;
 }
 
 int lib_manager_free_module(const struct comp_driver *drv,
 			    struct comp_ipc_config *ipc_config)
 {
+	struct ext_library *ext_lib = ext_lib_get();
+	struct lib_manager_mod_res *res;
 	struct sof_man_fw_desc *desc;
 	struct sof_man_module *mod;
 	uint32_t module_id = IPC4_MOD_ID(ipc_config->id);
-	uint32_t entry_index = LIB_MANAGER_GET_MODULE_INDEX(module_id);
 	int ret;
 
 	tr_dbg(&lib_manager_tr, "lib_manager_free_module(): mod_id: %#x", ipc_config->id);
 
-	desc = lib_manager_get_library_module_desc(module_id);
-	mod = (struct sof_man_module *)((char *)desc + SOF_MAN_MODULE_OFFSET(entry_index));
-
-	ret = lib_manager_unload_module(module_id, mod, desc);
-	if (ret < 0)
-		return ret;
+	mod = lib_manager_get_module_manifest(module_id, &desc);
+	res = lib_manager_find_resident(ext_lib, module_id);
+	if (!mod || !res || !res->refs) {
+		tr_err(&lib_manager_tr, "lib_manager_free_module(): mod_id: %#x is not allocated",
+		       ipc_config->id);
+		return -EINVAL;
+	}
 
 	ret = lib_manager_free_module_instance(module_id, IPC4_INST_ID(ipc_config->id), mod);
 	if (ret < 0) {
@@ -299,6 +506,11 @@ int lib_manager_free_module(const struct comp_driver *drv,
 		       "lib_manager_free_module(): free module instance failed: %d", ret);
 		return ret;
 	}
+
+	/* text and rodata stay mapped until evicted */
+	res->refs--;
+	lib_manager_evict(ext_lib);
+
 	return 0;
 }
 
@@ -329,8 +541,10 @@ void lib_manager_init(void)
 {
 	struct sof *sof = sof_get();
 
-	if (!sof->ext_library)
+	if (!sof->ext_library) {
 		sof->ext_library = &loader_ext_lib;
+		list_init(&loader_ext_lib.mods_resident);
+	}
 }
 
 struct sof_man_fw_desc *lib_manager_get_library_module_desc(int module_id)
@@ -430,6 +644,9 @@ static int lib_manager_dma_buffer_alloc(struct lib_manager_dma_ext *dma_ext,
 		return -ENOMEM;
 	}
 
+	dma_ext->dma_size = size;
+	dma_ext->dma_rd = 0;
+
 	dcache_invalidate_region((void __sparse_cache *)dma_ext->dma_addr, size);
 
 	tr_dbg(&lib_manager_tr,
@@ -516,21 +733,37 @@ static int lib_manager_store_data(struct lib_manager_dma_ext *dma_ext,
 	uint32_t copied_bytes = 0;
 
 	while (copied_bytes < dst_size) {
+		uint8_t *dst = (__sparse_force uint8_t *)dst_addr + copied_bytes;
+		void *src = (void *)(dma_ext->dma_addr + dma_ext->dma_rd);
 		uint32_t bytes_to_copy;
+		uint32_t head_bytes;
 		int ret;
 
-		if ((dst_size - copied_bytes) > MAN_MAX_SIZE_V1_8)
-			bytes_to_copy = MAN_MAX_SIZE_V1_8;
-		else
-			bytes_to_copy = dst_size - copied_bytes;
-
+		bytes_to_copy = MIN(dst_size - copied_bytes, LIB_MANAGER_DMA_CHUNK);
 		ret = lib_manager_load_data_from_host(dma_ext, bytes_to_copy);
 		if (ret < 0)
 			return ret;
-		dcache_invalidate_region((void __sparse_cache *)dma_ext->dma_addr, bytes_to_copy);
-		memcpy_s((__sparse_force uint8_t *)dst_addr + copied_bytes, bytes_to_copy,
-			 (void *)dma_ext->dma_addr, bytes_to_copy);
+
+		/* The chunk wraps when the previous copy did not end at a half */
+		head_bytes = MIN(bytes_to_copy, dma_ext->dma_size - dma_ext->dma_rd);
+		dcache_invalidate_region((__sparse_force void __sparse_cache *)src, head_bytes);
+		memcpy_s(dst, head_bytes, src, head_bytes);
+		if (head_bytes < bytes_to_copy) {
+			dcache_invalidate_region((void __sparse_cache *)dma_ext->dma_addr,
+						 bytes_to_copy - head_bytes);
+			memcpy_s(dst + head_bytes, bytes_to_copy - head_bytes,
+				 (void *)dma_ext->dma_addr, bytes_to_copy - head_bytes);
+		}
+
+		dma_ext->dma_rd += bytes_to_copy;
+		if (dma_ext->dma_rd >= dma_ext->dma_size)
+			dma_ext->dma_rd -= dma_ext->dma_size;
+
 		copied_bytes += bytes_to_copy;
+
+		/* Release the consumed bytes, the DMA continues meanwhile to the
+		 * other half.
+		 */
 		dma_reload(dma_ext->chan->dma->z_dev, dma_ext->chan->index, 0, 0, bytes_to_copy);
 	}
 
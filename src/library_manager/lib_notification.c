@@ -33,7 +33,7 @@ struct ipc_msg *lib_notif_msg_init(uint32_t header, uint32_t size)
 		/* Search for not used message handle */
 		list_for_item(list_elem, &lib_notif->list) {
 			msg_pool_elem = container_of(list_elem, struct ipc_lib_msg, list);
-			if (msg_pool_elem->msg && list_is_empty(&msg_pool_elem->msg->list)) {
+			if (msg_pool_elem->msg && !ipc_msg_is_queued(msg_pool_elem->msg)) {
 				msg = msg_pool_elem->msg;
 				break;
 			}
@@ -94,7 +94,7 @@ void lib_notif_msg_clean(bool leave_one_handle)
 		msg_pool_elem = container_of(list_elem, struct ipc_lib_msg, list);
 		assert(msg_pool_elem->msg);
 
-		if (list_is_empty(&msg_pool_elem->msg->list)) {
+		if (!ipc_msg_is_queued(msg_pool_elem->msg)) {
 			k_spinlock_key_t key;
 
 			key = k_spin_lock(&ext_lib->lock);
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <sof/audio/component.h>
+#include <sof/math/numbers.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+LOG_MODULE_REGISTER(log_ratelimit, CONFIG_SOF_LOG_LEVEL);
+
+#define LOG_RATELIMIT_TOKEN_CYCLES \
+	(CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC / CONFIG_SOF_LOG_RATELIMIT_PER_SEC)
+
+/*
+ * A component logs from the core it runs on, the state needs no lock. A
+ * race between its IPC and LL contexts on that core only miscounts a token.
+ */
+bool comp_log_allowed(struct comp_dev *dev)
+{
+	struct comp_log_ratelimit *rl = &dev->log_rl;
+	uint32_t now = k_cycle_get_32();
+	uint32_t refill = (now - rl->stamp) / LOG_RATELIMIT_TOKEN_CYCLES;
+	uint32_t suppressed;
+
+	if (refill >= CONFIG_SOF_LOG_RATELIMIT_BURST || !rl->stamp) {
+		rl->tokens = CONFIG_SOF_LOG_RATELIMIT_BURST;
+		rl->stamp = now;
+	} else if (refill) {
+		rl->tokens = MIN(rl->tokens + refill, CONFIG_SOF_LOG_RATELIMIT_BURST);
+		rl->stamp += refill * LOG_RATELIMIT_TOKEN_CYCLES;
+	}
+
+	if (rl->tokens) {
+		rl->tokens--;
+		if (rl->suppressed) {
+			suppressed = rl->suppressed;
+			rl->suppressed = 0;
+			LOG_WRN(__COMP_FMT "%u messages suppressed", trace_comp_get_id(dev),
+				trace_comp_get_subid(dev), suppressed);
+		}
+		return true;
+	}
+
+	if (rl->suppressed < UINT16_MAX)
+		rl->suppressed++;
+
+	return CONFIG_SOF_LOG_RATELIMIT_SAMPLE &&
+	       !(rl->suppressed % CONFIG_SOF_LOG_RATELIMIT_SAMPLE);
+}
@@ -23,7 +23,7 @@ void psy_apply_mel_filterbank_16(struct psy_mel_filterbank *fb, struct icomplex1
 	int start_bin;
 	int num_bins;
 	int coef_idx;
-	int i, j;
+	int i;
 	int base_idx = 0;
 	int lshift;
 
@@ -34,20 +34,17 @@ void psy_apply_mel_filterbank_16(struct psy_mel_filterbank *fb, struct icomplex1
 	for (i = 0; i < fb->half_fft_bins; i++) {
 		p = (int32_t)fft_out[i].real * fft_out[i].real +
 			(int32_t)fft_out[i].imag * fft_out[i].imag;
+		power_spectra[i] = p;
 		pmax = MAX(pmax, p);
 	}
 
 	/* Power spectra is Q2.30 */
 	lshift = norm_int32(pmax);
-	for (i = 0; i < fb->half_fft_bins; i++) {
-		p = (int32_t)fft_out[i].real * fft_out[i].real +
-			(int32_t)fft_out[i].imag * fft_out[i].imag;
-		power_spectra[i] = p << lshift;
-	}
+	for (i = 0; i < fb->half_fft_bins; i++)
+		power_spectra[i] <<= lshift;
 
 	for (i = 0; i < fb->mel_bins; i++) {
 		/* Integrate power spectrum with Mel filter bank triangle weights */
-		pp = 0;
 		next_idx = fb->data[base_idx];
 		start_bin = fb->data[base_idx + 1];
 		num_bins = fb->data[base_idx + 2];
@@ -57,8 +54,8 @@ void psy_apply_mel_filterbank_16(struct psy_mel_filterbank *fb, struct icomplex1
 		/* Accumulate power as Q3.45 (Q2.30 x Q1.15). Note that filter bank need
 		 * to be later scaled with fb->scale.
 		 */
-		for (j = 0; j < num_bins; j++)
-			pp += (int64_t)power_spectra[start_bin + j] * fb->data[coef_idx + j];
+		pp = psy_mel_triangle_sum(&power_spectra[start_bin], &fb->data[coef_idx],
+					   num_bins);
 
 		/* Convert Mel band energy from Q19.45 to Q7.25 that has sufficient headroom
 		 * for worst-case all ones FFT output. Log2() function input is unsigned Q32.0,
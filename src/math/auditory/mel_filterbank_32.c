@@ -22,7 +22,7 @@ void psy_apply_mel_filterbank_32(struct psy_mel_filterbank *fb, struct icomplex3
 	int start_bin;
 	int num_bins;
 	int coef_idx;
-	int i, j;
+	int i;
 	int base_idx = 0;
 	int lshift;
 
@@ -47,7 +47,6 @@ void psy_apply_mel_filterbank_32(struct psy_mel_filterbank *fb, struct icomplex3
 
 	for (i = 0; i < fb->mel_bins; i++) {
 		/* Integrate power spectrum with Mel filter bank triangle weights */
-		p = 0;
 		next_idx = fb->data[base_idx];
 		start_bin = fb->data[base_idx + 1];
 		num_bins = fb->data[base_idx + 2];
@@ -57,8 +56,8 @@ void psy_apply_mel_filterbank_32(struct psy_mel_filterbank *fb, struct icomplex3
 		/* Accumulate power as Q3.45 (Q2.30 x Q1.15). Note that filter bank need
 		 * to be later scaled with fb->scale.
 		 */
-		for (j = 0; j < num_bins; j++)
-			p += (int64_t)power_spectra[start_bin + j] * fb->data[coef_idx + j];
+		p = psy_mel_triangle_sum(&power_spectra[start_bin], &fb->data[coef_idx],
+					 num_bins);
 
 		/* Convert Mel band energy from Q19.45 to Q7.25 that has sufficient headroom
 		 * for worst-case all ones FFT output. Log2() function input is unsigned Q32.0,
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/math/auditory.h>
+#include <stdint.h>
+
+#if AUDITORY_GENERIC
+
+int64_t psy_mel_triangle_sum(const int32_t *power_spectra, const int16_t *weights,
+			     int num_bins)
+{
+	int64_t p0 = 0;
+	int64_t p1 = 0;
+	int j;
+
+	/* Two accumulators for the even and odd bins */
+	for (j = 0; j + 1 < num_bins; j += 2) {
+		p0 += (int64_t)power_spectra[j] * weights[j];
+		p1 += (int64_t)power_spectra[j + 1] * weights[j + 1];
+	}
+
+	if (j < num_bins)
+		p0 += (int64_t)power_spectra[j] * weights[j];
+
+	return p0 + p1;
+}
+
+#endif /* AUDITORY_GENERIC */
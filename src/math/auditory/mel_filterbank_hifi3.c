@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/math/auditory.h>
+#include <stdint.h>
+
+#if AUDITORY_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+int64_t psy_mel_triangle_sum(const int32_t *power_spectra, const int16_t *weights,
+			     int num_bins)
+{
+	ae_int64 acc = AE_ZERO64();
+	ae_int32x2 p01;
+	ae_int32x2 p23;
+	ae_int16x4 w;
+	ae_valign pu;
+	ae_valign wu;
+	ae_int32x2 *pp = (ae_int32x2 *)power_spectra;
+	ae_int16x4 *wp = (ae_int16x4 *)weights;
+	int64_t sum;
+	int j;
+
+	/* The triangles start from any bin, so the unaligned loads are used.
+	 * The power p[n] is in p01.H and p[n + 1] in p01.L, the weight w[n]
+	 * is in w.3 and w[n + 1] in w.2, etc.
+	 */
+	pu = AE_LA64_PP(pp);
+	wu = AE_LA64_PP(wp);
+	for (j = 0; j + 3 < num_bins; j += 4) {
+		AE_LA32X2_IP(p01, pu, pp);
+		AE_LA32X2_IP(p23, pu, pp);
+		AE_LA16X4_IP(w, wu, wp);
+		AE_MULAAD32X16_H3_L2(acc, p01, w);
+		AE_MULAAD32X16_H1_L0(acc, p23, w);
+	}
+
+	sum = (int64_t)acc;
+	for (; j < num_bins; j++)
+		sum += (int64_t)power_spectra[j] * weights[j];
+
+	return sum;
+}
+
+#endif /* AUDITORY_HIFI3 */
@@ -8,6 +8,7 @@
 #include <sof/math/matrix.h>
 #include <sof/math/dct.h>
 #include <sof/math/sqrt.h>
+#include <sof/math/table_cache.h>
 #include <sof/math/trig.h>
 #include <errno.h>
 #include <stdint.h>
@@ -26,13 +27,12 @@
  * TODO: Add option for no ortho norm.
  */
 
-/**
- * \brief Initialize a 16 bit DCT matrix. The actual DCT transform is a matrix
- * multiply with the returned matrix.
- * \param[in,out]  dct  In input provide DCT type and size, in output the DCT matrix
- */
-int dct_initialize_16(struct dct_plan_16 *dct)
+/* Fill the DCT-II matrix of size (key->length, key->param) */
+static void dct_fill_16(void *table, const struct sofm_table_key *key)
 {
+	struct mat_matrix_16b *matrix = table;
+	const int num_in = key->length;
+	const int num_out = key->param;
 	int16_t dct_val;
 	int32_t arg;
 	int32_t cos;
@@ -42,24 +42,12 @@ int dct_initialize_16(struct dct_plan_16 *dct)
 	int n;
 	int k;
 
-	if (dct->type != DCT_II || dct->ortho != true)
-		return -EINVAL;
-
-	if (dct->num_in < 1 || dct->num_out < 1)
-		return -EINVAL;
-
-	if (dct->num_in > DCT_MATRIX_SIZE_MAX || dct->num_out > DCT_MATRIX_SIZE_MAX)
-		return -EINVAL;
-
-	dct->matrix = mat_matrix_alloc_16b(dct->num_in, dct->num_out, 15);
-	if (!dct->matrix)
-		return -ENOMEM;
-
-	c1 = PI_Q29 / dct->num_in;
-	arg = Q_SHIFT_RND(TWO_Q29 / dct->num_in, 29, 12);
+	mat_init_16b(matrix, num_in, num_out, 15);
+	c1 = PI_Q29 / num_in;
+	arg = Q_SHIFT_RND(TWO_Q29 / num_in, 29, 12);
 	c2 = sqrt_int16(arg); /* Q4.12 */
-	for (n = 0; n < dct->num_in; n++) {
-		for (k = 0; k < dct->num_out; k++) {
+	for (n = 0; n < num_in; n++) {
+		for (k = 0; k < num_out; k++) {
 			/* Note: Current int16_t nk works up to DCT_MATRIX_SIZE_MAX = 91 */
 			nk = (Q_SHIFT_LEFT(n, 0, 1) + HALF_Q1) * Q_SHIFT_LEFT(k, 0, 1); /*Q14.2 */
 			arg = Q_MULTSR_32X32((int64_t)c1, nk, 29, 2, 24); /* Q8.24 */
@@ -71,9 +59,50 @@ int dct_initialize_16(struct dct_plan_16 *dct)
 				dct_val = Q_MULTSR_32X32((int64_t)dct_val,
 							 ONE_OVER_SQRT_TWO, 15, 31, 15);
 
-			mat_set_scalar_16b(dct->matrix, n, k, dct_val);
+			mat_set_scalar_16b(matrix, n, k, dct_val);
 		}
 	}
+}
+
+/**
+ * \brief Initialize a 16 bit DCT matrix. The actual DCT transform is a matrix
+ * multiply with the returned matrix. Plans of equal size share the matrix,
+ * release it with dct_free_16().
+ * \param[in,out]  dct  In input provide DCT type and size, in output the DCT matrix
+ */
+int dct_initialize_16(struct dct_plan_16 *dct)
+{
+	struct sofm_table_key key = {
+		.type = SOFM_TABLE_DCT_II_ORTHO,
+		.bits = 16,
+	};
+
+	if (dct->type != DCT_II || dct->ortho != true)
+		return -EINVAL;
+
+	if (dct->num_in < 1 || dct->num_out < 1)
+		return -EINVAL;
+
+	if (dct->num_in > DCT_MATRIX_SIZE_MAX || dct->num_out > DCT_MATRIX_SIZE_MAX)
+		return -EINVAL;
+
+	key.length = dct->num_in;
+	key.param = dct->num_out;
+	dct->matrix = sofm_table_get(&key, sizeof(struct mat_matrix_16b) +
+				     sizeof(int16_t) * dct->num_in * dct->num_out,
+				     dct_fill_16);
+	if (!dct->matrix)
+		return -ENOMEM;
 
 	return 0;
 }
+
+/**
+ * \brief Release the DCT matrix of a plan initialized with dct_initialize_16().
+ * \param[in,out]  dct  DCT plan
+ */
+void dct_free_16(struct dct_plan_16 *dct)
+{
+	sofm_table_put(dct->matrix);
+	dct->matrix = NULL;
+}
@@ -217,4 +217,30 @@ int32_t sofm_exp_int32(int32_t x)
 	}
 	return ts;
 }
+
+void sofm_exp_int32_vec(const int32_t *x, int32_t *y, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sofm_exp2_fixed(sofm_exp2_arg(x[i], SOFM_EXP2_LOG2E_Q30, 28), 23);
+}
+
+void sofm_exp_fixed_vec(const int32_t *x, int32_t *y, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sofm_exp2_fixed(sofm_exp2_arg(x[i], SOFM_EXP2_LOG2E_Q30, 27), 20);
+}
+
+void sofm_db2lin_fixed_vec(const int32_t *db, int32_t *y, int n)
+{
+	int i;
+
+	/* as db2lin_fixed() values below -100 dB are returned as zero */
+	for (i = 0; i < n; i++)
+		y[i] = db[i] < SOFM_DB2LIN_MIN_DB_Q24 ? 0 :
+			sofm_exp2_fixed(sofm_exp2_arg(db[i], SOFM_EXP2_LOG2_10_DIV20_Q30, 24), 20);
+}
 #endif
@@ -278,4 +278,78 @@ int32_t sofm_exp_int32(int32_t x)
 
 	return AE_MOVAD32_L(AE_MOVINT32X2_FROMINT64(ts));
 }
+
+/* Two values per iteration, see sofm_exp2_fixed() for the generic steps.
+ * Only the final power of two scaling is done per value since the shift
+ * differs between the lanes. Inputs below x_min are returned as zero.
+ */
+static void sofm_exp2_vec(const int32_t *x, int32_t *y, int n, int32_t m, int qx, int qy,
+			  int32_t x_min)
+{
+	ae_int32x2 *in = (ae_int32x2 *)x;
+	ae_int32x2 *out = (ae_int32x2 *)y;
+	const ae_int64 mask = AE_MOVINT64_FROMINT32X2(AE_MOVDA32((1 << SOFM_EXP2_T_QY) - 1));
+	ae_valign inu = AE_LA64_PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int32x2 sample;
+	ae_int32x2 result;
+	ae_int32x2 t;
+	xtbool2 low;
+	ae_int32x2 k;
+	ae_f32x2 f;
+	ae_f32x2 p;
+	int i;
+
+	for (i = 0; i < n >> 1; i++) {
+		AE_LA32X2_IP(sample, inu, in);
+
+		/* t = x * m in Q6.26 */
+		t = AE_MULFP32X2RAS(sample, AE_MOVDA32(m));
+		if (qx >= SOFM_EXP2_T_QY + 1)
+			t = AE_SRAA32(t, qx - SOFM_EXP2_T_QY - 1);
+		else
+			t = AE_SLAA32S(t, SOFM_EXP2_T_QY + 1 - qx);
+
+		/* integer part k and fraction f in Q1.31 */
+		k = AE_SRAI32(t, SOFM_EXP2_T_QY);
+		f = AE_MOVINT32X2_FROMINT64(AE_AND64(AE_MOVINT64_FROMINT32X2(t), mask));
+		f = AE_SLAI32(f, 31 - SOFM_EXP2_T_QY);
+
+		p = AE_MOVDA32(SOFM_EXP2_C7);
+		p = AE_ADD32S(AE_MOVDA32(SOFM_EXP2_C6), AE_MULFP32X2RAS(p, f));
+		p = AE_ADD32S(AE_MOVDA32(SOFM_EXP2_C5), AE_MULFP32X2RAS(p, f));
+		p = AE_ADD32S(AE_MOVDA32(SOFM_EXP2_C4), AE_MULFP32X2RAS(p, f));
+		p = AE_ADD32S(AE_MOVDA32(SOFM_EXP2_C3), AE_MULFP32X2RAS(p, f));
+		p = AE_ADD32S(AE_MOVDA32(SOFM_EXP2_C2), AE_MULFP32X2RAS(p, f));
+		p = AE_ADD32S(AE_MOVDA32(SOFM_EXP2_C1), AE_MULFP32X2RAS(p, f));
+		p = AE_ADD32S(AE_MOVDA32(1 << 30), AE_SRAI32(AE_MULFP32X2RAS(p, f), 1));
+
+		result = AE_MOVDA32X2(sofm_exp2_scale(AE_MOVAD32_H(p), AE_MOVAD32_H(k), qy),
+				      sofm_exp2_scale(AE_MOVAD32_L(p), AE_MOVAD32_L(k), qy));
+		low = AE_LT32(sample, AE_MOVDA32(x_min));
+		AE_MOVT32X2(result, AE_ZERO32(), low);
+		AE_SA32X2_IP(result, outu, out);
+	}
+	AE_SA64POS_FP(outu, out);
+
+	if (n & 1)
+		y[n - 1] = x[n - 1] < x_min ? 0 :
+			sofm_exp2_fixed(sofm_exp2_arg(x[n - 1], m, qx), qy);
+}
+
+void sofm_exp_int32_vec(const int32_t *x, int32_t *y, int n)
+{
+	sofm_exp2_vec(x, y, n, SOFM_EXP2_LOG2E_Q30, 28, 23, INT32_MIN);
+}
+
+void sofm_exp_fixed_vec(const int32_t *x, int32_t *y, int n)
+{
+	sofm_exp2_vec(x, y, n, SOFM_EXP2_LOG2E_Q30, 27, 20, INT32_MIN);
+}
+
+void sofm_db2lin_fixed_vec(const int32_t *db, int32_t *y, int n)
+{
+	/* as db2lin_fixed() values below -100 dB are returned as zero */
+	sofm_exp2_vec(db, y, n, SOFM_EXP2_LOG2_10_DIV20_Q30, 24, 20, SOFM_DB2LIN_MIN_DB_Q24);
+}
 #endif
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/fft.h>
+
+#ifdef FFT_HIFI5
+#include <sof/audio/coefficients/fft/twiddle_16.h>
+#include <xtensa/tie/xt_hifi5.h>
+
+/* one butterfly in place, top and bottom are kept as Q9.23 in the computation */
+static inline void fft_16_butterfly(struct icomplex16 *outb, int top, int bottom, int index)
+{
+	ae_int32x2 res1, res2, res;
+	ae_int24x2 temp1, temp2;
+	ae_p16x2s *outs16;
+
+	temp1 = AE_CVTP24A16X2_LL(outb[bottom].real, outb[bottom].imag);
+	temp2 = AE_CVTP24A16X2_LL(twiddle_real_16[index], twiddle_imag_16[index]);
+	/* calculate the accumulator: twiddle * bottom */
+	res = AE_MULFC24RA(temp1, temp2);
+	/* saturate and round the result to 16bit and put it in the middle element of res */
+	res2 = AE_SRAI32R(res, 8);
+	res2 = AE_SLAI32S(res2, 8);
+	res1 = AE_CVTP24A16X2_LL(outb[top].real, outb[top].imag);
+	/* calculate the top output: top = top + accumulate */
+	res = AE_ADD24S(res1, res2);
+	outs16 = (ae_p16x2s *)&outb[top];
+	AE_S16X2M_I(res, outs16, 0);
+	/* calculate the bottom output: bottom = top - accumulate */
+	res = AE_SUB24S(res1, res2);
+	outs16 = (ae_p16x2s *)&outb[bottom];
+	AE_S16X2M_I(res, outs16, 0);
+}
+
+/**
+ * \brief Execute the 16-bits Fast Fourier Transform (FFT) or Inverse FFT (IFFT)
+ *	  For the configured fft_pan.
+ *
+ * Same algorithm as the HiFi3 version. Two independent butterflies are
+ * computed per iteration so that their complex MACs can be issued in
+ * parallel, the IFFT scaling pass uses 128 bit loads and stores.
+ * \param[in] plan - pointer to fft_plan which will be executed.
+ * \param[in] ifft - set to 1 for IFFT and 0 for FFT.
+ */
+void fft_execute_16(struct fft_plan *plan, bool ifft)
+{
+	struct icomplex16 *outb;
+	ae_int16 *in;
+	ae_int16 *out;
+	ae_int16x4 sample;
+	ae_int16x4 sample1;
+	ae_int16x8 *in16x8;
+	ae_int16x8 *out16x8;
+	ae_valignx2 inu;
+	ae_valignx2 outu = AE_ZALIGN128();
+	int depth, top, index;
+	int i, j, k, m, n;
+	int size;
+	int len;
+
+	if (!plan || !plan->bit_reverse_idx)
+		return;
+
+	outb = plan->outb16;
+	if (!plan->inb16 || !outb)
+		return;
+
+	size = plan->size;
+	len = plan->len;
+
+	/* convert to complex conjugate for ifft */
+	if (ifft) {
+		in = (ae_int16 *)&plan->inb16->imag;
+		for (i = 0; i < size; i++) {
+			AE_L16_IP(sample, in, 0);
+			sample = AE_NEG16S(sample);
+			AE_S16_0_IP(sample, in, sizeof(struct icomplex16));
+		}
+	}
+
+	/* step 1: re-arrange input in bit reverse order, and shrink the level to avoid overflow */
+	in = (ae_int16 *)&plan->inb16[1];
+	for (i = 1; i < size ; ++i) {
+		out = (ae_int16 *)&outb[plan->bit_reverse_idx[i]];
+		AE_L16_IP(sample, in, 2);
+		sample = AE_SRAA16RS(sample, len);
+		AE_S16_0_IP(sample, out, 2);
+
+		AE_L16_IP(sample, in, 2);
+		sample = AE_SRAA16RS(sample, len);
+		AE_S16_0_IP(sample, out, 2);
+	}
+
+	/* step 2: loop to do FFT transform in smaller size */
+	for (depth = 1; depth <= len; ++depth) {
+		m = 1 << depth;
+		n = m >> 1;
+		i = FFT_SIZE_MAX >> depth;
+
+		/* doing FFT transforms in size m */
+		for (k = 0; k < size; k += m) {
+			/* the first stage has a single butterfly */
+			if (n == 1) {
+				fft_16_butterfly(outb, k, k + 1, 0);
+				continue;
+			}
+
+			/* doing one FFT transform for size m, two butterflies at once */
+			for (j = 0; j < n; j += 2) {
+				index = i * j;
+				top = k + j;
+				fft_16_butterfly(outb, top, top + n, index);
+				fft_16_butterfly(outb, top + 1, top + 1 + n, index + i);
+			}
+		}
+	}
+
+	/* shift back for ifft */
+	if (ifft) {
+		/*
+		 * no need to divide N as it is already done in the input side
+		 * for Q1.31 format. Instead, we need to multiply N to compensate
+		 * the shrink we did in the FFT transform.
+		 */
+		in16x8 = (ae_int16x8 *)plan->outb16;
+		out16x8 = (ae_int16x8 *)plan->outb16;
+		n = size >> 2;
+		inu = AE_LA128_PP(in16x8);
+		/* shift 4 samples per loop */
+		for (i = 0; i < n; i++) {
+			AE_LA16X4X2_IP(sample, sample1, inu, in16x8);
+			sample = AE_SLAA16S(sample, len);
+			sample1 = AE_SLAA16S(sample1, len);
+			AE_SA16X4X2_IP(sample, sample1, outu, out16x8);
+		}
+		AE_SA128POS_FP(outu, out16x8);
+
+		/* shift the remaining real & imag parts respectively */
+		in = (ae_int16 *)in16x8;
+		out = (ae_int16 *)out16x8;
+		for (i = 0; i < 2 * (size & 3); i++) {
+			AE_L16_IP(sample, in, 2);
+			sample = AE_SLAA16S(sample, len);
+			AE_S16_0_IP(sample, out, 2);
+		}
+	}
+}
+#endif
@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <rtos/alloc.h>
+#include <sof/math/fft.h>
+
+#ifdef FFT_HIFI5
+#include <sof/audio/coefficients/fft/twiddle_32.h>
+#include <xtensa/tie/xt_hifi5.h>
+
+/* calculate twiddle * bottom as Q1.31 complex */
+static inline ae_int32x2 fft_32_twiddle_mul(ae_int32x2 twiddle, ae_int32x2 bottom)
+{
+	ae_int64 res, res1;
+
+	res = AE_MULF32S_HH(twiddle, bottom);
+	AE_MULSF32S_LL(res, twiddle, bottom);
+	res1 = AE_MULF32S_HL(twiddle, bottom);
+	AE_MULAF32S_LH(res1, twiddle, bottom);
+	return AE_ROUND32X2F64SSYM(res, res1);
+}
+
+/**
+ * \brief Execute the 32-bits Fast Fourier Transform (FFT) or Inverse FFT (IFFT)
+ *	  For the configured fft_pan.
+ *
+ * Same algorithm as the HiFi3 version. Two butterflies are computed per
+ * iteration to keep both MAC slots busy and the linear passes over the data
+ * use 128 bit loads and stores.
+ * \param[in] plan - pointer to fft_plan which will be executed.
+ * \param[in] ifft - set to 1 for IFFT and 0 for FFT.
+ */
+void fft_execute_32(struct fft_plan *plan, bool ifft)
+{
+	struct icomplex32 tw[2];
+	ae_int32x2 *inx;
+	ae_int32x2 *out;
+	ae_int32x2 *outx;
+	ae_int32x4 *inx4;
+	ae_int32x4 *outx4;
+	ae_int32x2 sample;
+	ae_int32x2 sample1;
+	ae_int32x2 acc0, acc1;
+	ae_int32x2 top0, top1;
+	ae_int32x2 tw0, tw1;
+	int depth, top, bottom, index;
+	int i, j, k, m, n;
+	ae_int32 *in;
+	ae_valign inu = AE_ZALIGN64();
+	ae_valign outu = AE_ZALIGN64();
+	ae_valignx2 inu4;
+	ae_valignx2 outu4 = AE_ZALIGN128();
+	int size;
+	int len;
+
+	if (!plan || !plan->bit_reverse_idx)
+		return;
+
+	if (!plan->inb32 || !plan->outb32)
+		return;
+
+	size = plan->size;
+	len = plan->len;
+	inx = (ae_int32x2 *)plan->inb32 + 1;
+	outx = (ae_int32x2 *)plan->outb32;
+
+	/* convert to complex conjugate for ifft */
+	if (ifft) {
+		in = (ae_int32 *)&plan->inb32->imag;
+		for (i = 0; i < size; i++) {
+			AE_L32_IP(sample, in, 0);
+			sample = AE_NEG32S(sample);
+			AE_S32_L_IP(sample, in, sizeof(struct icomplex32));
+		}
+	}
+
+	/* step 1: re-arrange input in bit reverse order, and shrink the level to avoid overflow */
+	inu = AE_LA64_PP(inx);
+	for (i = 1; i < size; ++i) {
+		AE_LA32X2_IP(sample, inu, inx);
+		sample = AE_SRAA32S(sample, len);
+		out = &outx[plan->bit_reverse_idx[i]];
+		AE_SA32X2_IP(sample, outu, out);
+	}
+	AE_SA64POS_FP(outu, out);
+
+	/* step 2: loop to do FFT transform in smaller size */
+	for (depth = 1; depth <= len; ++depth) {
+		m = 1 << depth;
+		n = m >> 1;
+		i = FFT_SIZE_MAX >> depth;
+
+		/* doing FFT transforms in size m */
+		for (k = 0; k < size; k += m) {
+			/* the first stage has a single butterfly with twiddle 1 + 0j */
+			if (n == 1) {
+				tw[0].real = twiddle_real_32[0];
+				tw[0].imag = twiddle_imag_32[0];
+				inx = (ae_int32x2 *)&tw[0];
+				inu = AE_LA64_PP(inx);
+				AE_LA32X2_IP(tw0, inu, inx);
+				acc0 = fft_32_twiddle_mul(tw0, outx[k + 1]);
+				top0 = outx[k];
+				outx[k] = AE_ADD32S(top0, acc0);
+				outx[k + 1] = AE_SUB32S(top0, acc0);
+				continue;
+			}
+
+			/* doing one FFT transform for size m, two butterflies at once */
+			for (j = 0; j < n; j += 2) {
+				index = i * j;
+				top = k + j;
+				bottom = top + n;
+				tw[0].real = twiddle_real_32[index];
+				tw[0].imag = twiddle_imag_32[index];
+				tw[1].real = twiddle_real_32[index + i];
+				tw[1].imag = twiddle_imag_32[index + i];
+				inx4 = (ae_int32x4 *)tw;
+				inu4 = AE_LA128_PP(inx4);
+				AE_LA32X2X2_IP(tw0, tw1, inu4, inx4);
+
+				/* calculate the accumulators: twiddle * bottom */
+				inx4 = (ae_int32x4 *)(outx + bottom);
+				inu4 = AE_LA128_PP(inx4);
+				AE_LA32X2X2_IP(sample, sample1, inu4, inx4);
+				acc0 = fft_32_twiddle_mul(tw0, sample);
+				acc1 = fft_32_twiddle_mul(tw1, sample1);
+
+				inx4 = (ae_int32x4 *)(outx + top);
+				inu4 = AE_LA128_PP(inx4);
+				AE_LA32X2X2_IP(top0, top1, inu4, inx4);
+
+				/* calculate the top output: top = top + accumulate */
+				outx4 = (ae_int32x4 *)(outx + top);
+				AE_SA32X2X2_IP(AE_ADD32S(top0, acc0), AE_ADD32S(top1, acc1),
+					       outu4, outx4);
+				AE_SA128POS_FP(outu4, outx4);
+
+				/* calculate the bottom output: bottom = top - accumulate */
+				outx4 = (ae_int32x4 *)(outx + bottom);
+				AE_SA32X2X2_IP(AE_SUB32S(top0, acc0), AE_SUB32S(top1, acc1),
+					       outu4, outx4);
+				AE_SA128POS_FP(outu4, outx4);
+			}
+		}
+	}
+
+	/* shift back for ifft */
+	if (ifft) {
+		/*
+		 * no need to divide N as it is already done in the input side
+		 * for Q1.31 format. Instead, we need to multiply N to compensate
+		 * the shrink we did in the FFT transform.
+		 */
+		inx4 = (ae_int32x4 *)outx;
+		outx4 = (ae_int32x4 *)outx;
+		inu4 = AE_LA128_PP(inx4);
+		/* shift 2 complex samples per loop */
+		for (i = 0; i < size >> 1; ++i) {
+			AE_LA32X2X2_IP(sample, sample1, inu4, inx4);
+			sample = AE_SLAA32S(sample, len);
+			sample1 = AE_SLAA32S(sample1, len);
+			AE_SA32X2X2_IP(sample, sample1, outu4, outx4);
+		}
+		AE_SA128POS_FP(outu4, outx4);
+
+		/* odd size, shift the last sample */
+		if (size & 1) {
+			out = (ae_int32x2 *)outx4;
+			*out = AE_SLAA32S(*out, len);
+		}
+	}
+}
+#endif
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <rtos/alloc.h>
+#include <rtos/string.h>
+#include <sof/math/fft.h>
+#include <ipc/topology.h>
+#include <stdint.h>
+
+/*
+ * A real signal x of N samples is transformed with a complex FFT of N/2
+ * points. The even samples are the real part and the odd samples are the
+ * imaginary part of the complex input z. The spectrum of x is then
+ *
+ *   X[k] = E[k] + W^k O[k], W = exp(-j2pi/N)
+ *   E[k] = (Z[k] + conj(Z[N/2 - k])) / 2
+ *   O[k] = (Z[k] - conj(Z[N/2 - k])) / 2j
+ *
+ * for the bins 0 to N/2. The inverse transform is done in reverse order. The
+ * spectra are in the same scale as with fft_execute_32() of N points, i.e.
+ * divided by N, and the inverse transform returns the original signal.
+ */
+
+/* The twiddle factors are defined with the FFT version in use */
+extern const int32_t twiddle_real_32[];
+extern const int32_t twiddle_imag_32[];
+
+struct fft_real_plan *fft_real_plan_new(uint32_t size)
+{
+	struct fft_real_plan *plan;
+	size_t buf_size = (size >> 1) * sizeof(struct icomplex32);
+
+	/* N/2 is a power of two and the twiddle factors of N points are needed */
+	if (size < 4 || size > FFT_SIZE_MAX || (size & (size - 1)))
+		return NULL;
+
+	plan = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*plan));
+	if (!plan)
+		return NULL;
+
+	plan->size = size;
+	while ((1 << plan->len) < size)
+		plan->len++;
+
+	plan->inb = rballoc(0, SOF_MEM_CAPS_RAM, buf_size);
+	plan->outb = rballoc(0, SOF_MEM_CAPS_RAM, buf_size);
+	if (!plan->inb || !plan->outb)
+		goto err;
+
+	plan->plan = fft_plan_new(plan->inb, plan->outb, size >> 1, 32);
+	if (!plan->plan)
+		goto err;
+
+	return plan;
+
+err:
+	fft_real_plan_free(plan);
+	return NULL;
+}
+
+void fft_real_plan_free(struct fft_real_plan *plan)
+{
+	if (!plan)
+		return;
+
+	fft_plan_free(plan->plan);
+	rfree(plan->inb);
+	rfree(plan->outb);
+	rfree(plan);
+}
+
+/**
+ * \brief Execute the 32-bits FFT for a real input.
+ * \param[in] plan - pointer to fft_real_plan which will be executed.
+ * \param[in] in - pointer to N input samples.
+ * \param[out] out - pointer to N/2 + 1 output bins.
+ */
+void fft_real_execute_32(struct fft_real_plan *plan, const int32_t *in, struct icomplex32 *out)
+{
+	struct icomplex32 *z;
+	struct icomplex32 *a;
+	struct icomplex32 *b;
+	int64_t sr;
+	int64_t si;
+	int64_t pr;
+	int64_t pi;
+	int32_t wr;
+	int32_t wi;
+	const int m = plan->size >> 1;
+	const int step = FFT_SIZE_MAX / plan->size;
+	int k;
+
+	z = plan->outb;
+	memcpy_s(plan->inb, m * sizeof(struct icomplex32), in, plan->size * sizeof(int32_t));
+
+	/* The FFT does not move the first input to the output */
+	z[0].real = plan->inb[0].real >> plan->plan->len;
+	z[0].imag = plan->inb[0].imag >> plan->plan->len;
+	fft_execute_32(plan->plan, false);
+
+	/* Z is divided by N/2 and the bins are computed as
+	 * X[k] / N = (Z[k] + conj(Z[-k]) - jW^k (Z[k] - conj(Z[-k]))) / 4
+	 * with the halved terms to keep the products in 64 bits.
+	 */
+	for (k = 0; k < m; k++) {
+		a = &z[k];
+		b = &z[(m - k) & (m - 1)];
+		sr = ((int64_t)a->real + b->real) >> 1;
+		si = ((int64_t)a->imag - b->imag) >> 1;
+		pr = ((int64_t)a->imag + b->imag) >> 1;
+		pi = ((int64_t)b->real - a->real) >> 1;
+		wr = twiddle_real_32[k * step];
+		wi = twiddle_imag_32[k * step];
+		sr += (wr * pr >> 31) - (wi * pi >> 31);
+		si += (wr * pi >> 31) + (wi * pr >> 31);
+		out[k].real = sat_int32(sr >> 1);
+		out[k].imag = sat_int32(si >> 1);
+	}
+
+	out[m].real = ((int64_t)z[0].real - z[0].imag) >> 1;
+	out[m].imag = 0;
+}
+
+/**
+ * \brief Execute the 32-bits IFFT for a real output.
+ * \param[in] plan - pointer to fft_real_plan which will be executed.
+ * \param[in] in - pointer to N/2 + 1 input bins.
+ * \param[out] out - pointer to N output samples.
+ */
+void fft_real_inverse_32(struct fft_real_plan *plan, const struct icomplex32 *in, int32_t *out)
+{
+	struct icomplex32 *z;
+	const struct icomplex32 *a;
+	const struct icomplex32 *b;
+	int64_t er;
+	int64_t ei;
+	int64_t dr;
+	int64_t di;
+	int64_t odd_r;
+	int64_t odd_i;
+	int32_t wr;
+	int32_t wi;
+	const int m = plan->size >> 1;
+	const int step = FFT_SIZE_MAX / plan->size;
+	int k;
+
+	/* Compute Z[k] / 2 = E[k] + jO[k] from the halved terms, the factor
+	 * of two to the N/2 points inverse transform is applied to the output.
+	 */
+	z = plan->inb;
+	for (k = 0; k < m; k++) {
+		a = &in[k];
+		b = &in[m - k];
+		er = ((int64_t)a->real + b->real) >> 1;
+		ei = ((int64_t)a->imag - b->imag) >> 1;
+		dr = ((int64_t)a->real - b->real) >> 1;
+		di = ((int64_t)a->imag + b->imag) >> 1;
+		wr = twiddle_real_32[k * step];
+		wi = twiddle_imag_32[k * step];
+		odd_r = (wr * dr >> 31) + (wi * di >> 31);
+		odd_i = (wr * di >> 31) - (wi * dr >> 31);
+		z[k].real = sat_int32(er - odd_i);
+		z[k].imag = sat_int32(ei + odd_r);
+	}
+
+	/* The IFFT conjugates the input and does not move the first input
+	 * to the output.
+	 */
+	plan->outb[0].real = z[0].real >> plan->plan->len;
+	plan->outb[0].imag = -(z[0].imag >> plan->plan->len);
+	fft_execute_32(plan->plan, true);
+
+	/* The output of the IFFT is the complex conjugate of z */
+	z = plan->outb;
+	for (k = 0; k < m; k++) {
+		out[2 * k] = sat_int32((int64_t)z[k].real << 1);
+		out[2 * k + 1] = sat_int32(-((int64_t)z[k].imag << 1));
+	}
+}
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/math/fir_config.h>
+
+#if FIR_HIFI5
+
+#include <sof/audio/buffer.h>
+#include <sof/math/fir_hifi3.h>
+#include <user/fir.h>
+#include <xtensa/config/defs.h>
+#include <xtensa/tie/xt_hifi5.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * HiFi5 version of the two samples FIR core. The state, delay line layout
+ * and setup functions are shared with HiFi3, see fir_hifi3.c.
+ *
+ * Eight coefficients are loaded per iteration with a single 128 bit load
+ * and the taps are split to two independent pairs of accumulators so that
+ * the quad MACs of subsequent tap groups don't depend on each other and can
+ * be issued in the two MAC slots of HiFi5.
+ */
+
+void fir_32x16_2x_hifi5(struct fir_state_32x16 *fir, ae_int32 x0, ae_int32 x1,
+			ae_int32 *y0, ae_int32 *y1, int shift)
+{
+	/* This function uses
+	 * 4x 64 bit accumulators,
+	 * 5x 64 bit data registers
+	 * 3x integers
+	 * 2x address pointers,
+	 */
+	ae_f64 a0;
+	ae_f64 b0;
+	ae_f64 a1;
+	ae_f64 b1;
+	ae_valignx2 u;
+	ae_valign u4;
+	ae_f32x2 d0;
+	ae_f32x2 d1;
+	ae_f32x2 d2;
+	ae_f32x2 d3;
+	ae_f32x2 d4;
+	ae_f16x4 coefs0;
+	ae_f16x4 coefs1;
+	int i;
+	ae_f32x2 *dp;
+	ae_int16x8 *coefp = (ae_int16x8 *)fir->coef;
+	ae_f16x4 *coefp4;
+	const int taps_div_8 = fir->taps >> 3;
+	const int inc = 2 * sizeof(int32_t);
+
+	/* Bypass samples if taps count is zero. */
+	if (!fir->taps) {
+		*y0 = x0;
+		*y1 = x1;
+		return;
+	}
+
+	/* Write samples to delay */
+	AE_S32_L_XC(x0, fir->rwp, -sizeof(int32_t));
+	dp = (ae_f32x2 *)fir->rwp;
+	AE_S32_L_XC(x1, fir->rwp, -sizeof(int32_t));
+
+	a0 = AE_ZERO64();
+	b0 = AE_ZERO64();
+	a1 = AE_ZERO64();
+	b1 = AE_ZERO64();
+
+	/* Prime the coefficients stream */
+	u = AE_LA128_PP(coefp);
+
+	/* Load two data samples, d0_h is x[n+1] and d0_l is x[n] */
+	AE_L32X2_XC(d0, dp, inc);
+	for (i = 0; i < taps_div_8; i++) {
+		/* Load eight coefficients, coefs0 contains taps h[n] to h[n+3]
+		 * and coefs1 contains h[n+4] to h[n+7].
+		 */
+		AE_LA16X4X2_IP(coefs0, coefs1, u, coefp);
+
+		/* Load next eight data samples */
+		AE_L32X2_XC(d1, dp, inc);
+		AE_L32X2_XC(d2, dp, inc);
+		AE_L32X2_XC(d3, dp, inc);
+		AE_L32X2_XC(d4, dp, inc);
+
+		/* Taps h[n] to h[n+3] accumulate to b0 and a0, taps h[n+4]
+		 * to h[n+7] to b1 and a1.
+		 */
+		AE_MULAFD32X16X2_FIR_HH(b0, a0, d0, d1, coefs0);
+		AE_MULAFD32X16X2_FIR_HH(b1, a1, d2, d3, coefs1);
+		AE_MULAFD32X16X2_FIR_HL(b0, a0, d1, d2, coefs0);
+		AE_MULAFD32X16X2_FIR_HL(b1, a1, d3, d4, coefs1);
+		d0 = d4;
+	}
+
+	/* The tap count is a multiple of four, process the remaining four taps */
+	if (fir->taps & 0x4) {
+		coefp4 = (ae_f16x4 *)coefp;
+		u4 = AE_LA64_PP(coefp4);
+		AE_LA16X4_IP(coefs0, u4, coefp4);
+		AE_L32X2_XC(d1, dp, inc);
+		AE_L32X2_XC(d2, dp, inc);
+		AE_MULAFD32X16X2_FIR_HH(b0, a0, d0, d1, coefs0);
+		AE_MULAFD32X16X2_FIR_HL(b1, a1, d1, d2, coefs0);
+	}
+
+	/* Combine the partial sums, do scaling shifts and store sample. */
+	b0 = AE_ADD64S(b0, b1);
+	a0 = AE_ADD64S(a0, a1);
+	b0 = AE_SLAA64S(b0, shift);
+	a0 = AE_SLAA64S(a0, shift);
+	AE_S32_L_I(AE_ROUND32F48SSYM(b0), (ae_int32 *)y1, 0);
+	AE_S32_L_I(AE_ROUND32F48SSYM(a0), (ae_int32 *)y0, 0);
+}
+
+#endif
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <sof/audio/format.h>
+#include <sof/math/iir_df2t.h>
+#include <user/eq.h>
+
+#if IIR_HIFI5
+
+#include <xtensa/tie/xt_hifi5.h>
+
+/*
+ * Direct form II transposed second order filter block (biquad), see
+ * iir_df2t_hifi3.c for the block diagram and the fixed point formats.
+ *
+ * Compared to HiFi3 version the coefficients of a biquad are fetched with
+ * two 128 bit loads and the products of b1, b2 with the input sample are
+ * computed before the section output is known. Only the feedback products
+ * depend on the output so the two MAC slots of HiFi5 are kept busy.
+ */
+
+/* Series DF2T IIR */
+
+/* 32 bit data, 32 bit coefficients and 64 bit state variables */
+
+int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x)
+{
+	ae_f64 acc;
+	ae_f64 acc_d0;
+	ae_f64 acc_d1;
+	ae_valignx2 align;
+	ae_f32x2 coef_a2a1;
+	ae_f32x2 coef_b2b1;
+	ae_f32x2 coef_b0shift;
+	ae_f32x2 gain;
+	ae_f32 in;
+	ae_f32 tmp;
+	ae_int32x4 *coefp;
+	ae_f64 *delayp;
+	ae_f32 out = 0;
+	int i;
+	int j;
+	int shift;
+	int nseries = iir->biquads_in_series;
+
+	/* Bypass is set with number of biquads set to zero. */
+	if (!iir->biquads)
+		return x;
+
+	/* Coefficients order in coef[] is {a2, a1, b2, b1, b0, shift, gain} */
+	coefp = (ae_int32x4 *)&iir->coef[0];
+	delayp = (ae_f64 *)&iir->delay[0];
+	for (j = 0; j < iir->biquads; j += nseries) {
+		/* the first for loop is for parallel EQs, and they have the same input */
+		in = x;
+		for (i = 0; i < nseries; i++) {
+			align = AE_LA128_PP(coefp);
+			AE_LA32X2X2_IP(coef_a2a1, coef_b2b1, align, coefp);
+			AE_LA32X2X2_IP(coef_b0shift, gain, align, coefp);
+
+			/* Feed forward part, depends only on the input */
+			acc = AE_SRAI64(delayp[0], 1); /* Convert d0 to Q18.46 */
+			AE_MULAF32R_HH(acc, coef_b0shift, in); /* Coef b0 */
+			acc_d0 = AE_SRAI64(delayp[1], 1); /* Convert d1 to Q18.46 */
+			AE_MULAF32R_LL(acc_d0, coef_b2b1, in); /* Coef b1 */
+			acc_d1 = AE_MULF32R_HH(coef_b2b1, in); /* Coef b2 */
+
+			acc = AE_SLAI64S(acc, 1); /* Convert to Q17.47 */
+			tmp = AE_ROUND32F48SSYM(acc); /* Round to Q1.31 */
+
+			/* Feedback part, compute delays d0 and d1 */
+			AE_MULAF32R_LL(acc_d0, coef_a2a1, tmp); /* Coef a1 */
+			AE_MULAF32R_HH(acc_d1, coef_a2a1, tmp); /* Coef a2 */
+			delayp[0] = AE_SLAI64S(acc_d0, 1); /* Store d0 as Q17.47 */
+			delayp[1] = AE_SLAI64S(acc_d1, 1); /* Store d1 as Q17.47 */
+
+			/* Apply gain Q18.14 x Q1.31 -> Q34.30 */
+			acc = AE_MULF32R_HH(gain, tmp); /* Gain */
+			acc = AE_SLAI64S(acc, 17); /* Convert to Q17.47 */
+
+			/* Apply biquad output shift right parameter and then
+			 * round and saturate to 32 bits Q1.31.
+			 */
+			shift = AE_SEL32_LL(coef_b0shift, coef_b0shift);
+			acc = AE_SRAA64(acc, shift);
+			in = AE_ROUND32F48SSYM(acc);
+
+			/* Proceed to next biquad coefficients and delay
+			 * lines. The coefp needs rewind by one int32_t
+			 * due to odd number of words in coefficient block.
+			 */
+			delayp += IIR_DF2T_NUM_DELAYS;
+			coefp = (ae_int32x4 *)((int32_t *)coefp - 1);
+		}
+		/* Output of previous section is in variable in */
+		out = AE_F32_ADDS_F32(out, in);
+	}
+	return out;
+}
+
+#endif
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/common.h>
+#include <sof/audio/format.h>
+#include <sof/math/iir_df2t_mc.h>
+#include <user/eq.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static int iir_check_df2t_mc(unsigned int lanes, unsigned int biquads)
+{
+	if (lanes != 2 && lanes != IIR_DF2T_MC_MAX_LANES)
+		return -EINVAL;
+
+	if (biquads > SOF_EQ_IIR_BIQUADS_MAX || biquads < 1)
+		return -EINVAL;
+
+	return 0;
+}
+
+int iir_coef_size_df2t_mc(unsigned int lanes, unsigned int biquads)
+{
+	int ret = iir_check_df2t_mc(lanes, biquads);
+
+	if (ret < 0)
+		return ret;
+
+	/* Keep the size a multiple of 8 bytes to let the delay line follow */
+	return ALIGN_UP(SOF_EQ_IIR_NBIQUAD * biquads * lanes * sizeof(int32_t),
+			sizeof(int64_t));
+}
+
+int iir_delay_size_df2t_mc(unsigned int lanes, unsigned int biquads)
+{
+	int ret = iir_check_df2t_mc(lanes, biquads);
+
+	if (ret < 0)
+		return ret;
+
+	return IIR_DF2T_NUM_DELAYS * biquads * lanes * sizeof(int64_t);
+}
+
+int iir_init_coef_df2t_mc(struct iir_state_df2t_mc *iir,
+			  struct sof_eq_iir_header *config[], unsigned int lanes,
+			  int32_t *coef)
+{
+	unsigned int biquads = config[0]->num_sections;
+	unsigned int nwords;
+	unsigned int i;
+	unsigned int l;
+	int ret;
+
+	ret = iir_check_df2t_mc(lanes, biquads);
+	if (ret < 0)
+		return ret;
+
+	/* Parallel sections would need a separate accumulation per lane */
+	for (l = 0; l < lanes; l++) {
+		if (config[l]->num_sections != biquads ||
+		    config[l]->num_sections_in_series != biquads)
+			return -EINVAL;
+	}
+
+	/* Transpose the coefficients blocks of the lanes */
+	nwords = SOF_EQ_IIR_NBIQUAD * biquads;
+	for (l = 0; l < lanes; l++)
+		for (i = 0; i < nwords; i++)
+			coef[i * lanes + l] = config[l]->biquads[i];
+
+	iir->lanes = lanes;
+	iir->biquads = biquads;
+	iir->coef = ASSUME_ALIGNED(coef, 8);
+
+	return 0;
+}
+
+void iir_init_delay_df2t_mc(struct iir_state_df2t_mc *iir, int64_t **delay)
+{
+	/* Set delay line of this IIR */
+	iir->delay = *delay;
+
+	/* Point to next IIR delay line start */
+	*delay += IIR_DF2T_NUM_DELAYS * iir->biquads * iir->lanes;
+}
+
+void iir_reset_df2t_mc(struct iir_state_df2t_mc *iir)
+{
+	iir->lanes = 0;
+	iir->biquads = 0;
+	iir->coef = NULL;
+	/* Note: May need to know the beginning of dynamic allocation after so
+	 * omitting setting iir->delay to NULL.
+	 */
+}
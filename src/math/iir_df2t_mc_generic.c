@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/math/iir_df2t_mc.h>
+#include <user/eq.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if IIR_GENERIC
+
+/* Series DF2T IIR, see iir_df2t_generic.c for the biquad structure. The inner
+ * loops run over the lanes with the same coefficient kind so that a compiler
+ * can map them to SIMD operations.
+ */
+
+/* 32 bit data, 32 bit coefficients and 64 bit state variables */
+
+void iir_df2t_mc(struct iir_state_df2t_mc *iir, int32_t *x)
+{
+	const int lanes = iir->lanes;
+	const int32_t *a2;
+	const int32_t *a1;
+	const int32_t *b2;
+	const int32_t *b1;
+	const int32_t *b0;
+	const int32_t *shift;
+	const int32_t *gain;
+	const int32_t *coef = iir->coef;
+	int64_t *d0 = iir->delay;
+	int64_t *d1;
+	int32_t tmp[IIR_DF2T_MC_MAX_LANES];
+	int64_t acc;
+	int i;
+	int l;
+
+	/* Bypass is set with number of biquads set to zero. */
+	if (!iir->biquads)
+		return;
+
+	for (i = 0; i < iir->biquads; i++) {
+		/* Coefficients order is {a2, a1, b2, b1, b0, shift, gain} */
+		a2 = coef;
+		a1 = a2 + lanes;
+		b2 = a1 + lanes;
+		b1 = b2 + lanes;
+		b0 = b1 + lanes;
+		shift = b0 + lanes;
+		gain = shift + lanes;
+		d1 = d0 + lanes;
+
+		/* Compute output: Delay is Q3.61
+		 * Q2.30 x Q1.31 -> Q3.61
+		 * Shift Q3.61 to Q3.31 with rounding, saturate to Q1.31
+		 */
+		for (l = 0; l < lanes; l++) {
+			acc = ((int64_t)b0[l]) * x[l] + d0[l];
+			tmp[l] = (int32_t)sat_int32(Q_SHIFT_RND(acc, 61, 31));
+		}
+
+		/* Compute first delay */
+		for (l = 0; l < lanes; l++)
+			d0[l] = d1[l] + ((int64_t)b1[l]) * x[l] + ((int64_t)a1[l]) * tmp[l];
+
+		/* Compute second delay */
+		for (l = 0; l < lanes; l++)
+			d1[l] = ((int64_t)b2[l]) * x[l] + ((int64_t)a2[l]) * tmp[l];
+
+		/* Apply gain Q2.14 x Q1.31 -> Q3.45 and the biquad output
+		 * shift right simultaneously with Q3.45 to Q3.31 conversion.
+		 * Then saturate to 32 bits Q1.31 for the next biquad.
+		 */
+		for (l = 0; l < lanes; l++) {
+			acc = ((int64_t)gain[l]) * tmp[l];
+			x[l] = sat_int32(Q_SHIFT_RND(acc, 45 + shift[l], 31));
+		}
+
+		/* Proceed to next biquad coefficients and delay lines */
+		coef += SOF_EQ_IIR_NBIQUAD * lanes;
+		d0 += IIR_DF2T_NUM_DELAYS * lanes;
+	}
+}
+
+#endif
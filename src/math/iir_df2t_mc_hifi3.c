@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sof/audio/format.h>
+#include <sof/math/iir_df2t_mc.h>
+#include <user/eq.h>
+
+/* HiFi5 uses the HiFi3 version, the lanes are processed in pairs */
+#if IIR_HIFI3 || IIR_HIFI5
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/* Series DF2T IIR, see iir_df2t_hifi3.c for the biquad structure and the
+ * delay line alignment. The H and L halves of the 32x2 registers are two
+ * channels with the same coefficient kind.
+ */
+
+/* 32 bit data, 32 bit coefficients and 64 bit state variables */
+
+void iir_df2t_mc(struct iir_state_df2t_mc *iir, int32_t *x)
+{
+	ae_f64 acc_h;
+	ae_f64 acc_l;
+	ae_f32x2 a2;
+	ae_f32x2 a1;
+	ae_f32x2 b2;
+	ae_f32x2 b1;
+	ae_f32x2 b0;
+	ae_f32x2 shift;
+	ae_f32x2 gain;
+	ae_f32x2 in;
+	ae_f32x2 tmp;
+	ae_f32x2 *xp;
+	ae_f32x2 *coefp;
+	ae_f64 *d0p;
+	ae_f64 *d1p;
+	const int lanes = iir->lanes;
+	const int stride = lanes * sizeof(int32_t);
+	int i;
+	int l;
+
+	/* Bypass is set with number of biquads set to zero. */
+	if (!iir->biquads)
+		return;
+
+	for (l = 0; l < lanes; l += 2) {
+		xp = (ae_f32x2 *)&x[l];
+		in = *xp;
+		coefp = (ae_f32x2 *)&iir->coef[l];
+		d0p = (ae_f64 *)&iir->delay[l];
+		for (i = 0; i < iir->biquads; i++) {
+			/* Coefficients order is {a2, a1, b2, b1, b0, shift, gain} */
+			AE_L32X2_XP(a2, coefp, stride);
+			AE_L32X2_XP(a1, coefp, stride);
+			AE_L32X2_XP(b2, coefp, stride);
+			AE_L32X2_XP(b1, coefp, stride);
+			AE_L32X2_XP(b0, coefp, stride);
+			AE_L32X2_XP(shift, coefp, stride);
+			AE_L32X2_XP(gain, coefp, stride);
+			d1p = d0p + lanes;
+
+			/* Compute output with delay d0 converted to Q18.46 */
+			acc_h = AE_SRAI64(d0p[0], 1);
+			acc_l = AE_SRAI64(d0p[1], 1);
+			AE_MULAF32R_HH(acc_h, b0, in); /* Coef b0 */
+			AE_MULAF32R_LL(acc_l, b0, in);
+			acc_h = AE_SLAI64S(acc_h, 1); /* Convert to Q17.47 */
+			acc_l = AE_SLAI64S(acc_l, 1);
+			tmp = AE_ROUND32X2F48SSYM(acc_h, acc_l); /* Round to Q1.31 */
+
+			/* Compute 1st delay d0 */
+			acc_h = AE_SRAI64(d1p[0], 1); /* Convert d1 to Q18.46 */
+			acc_l = AE_SRAI64(d1p[1], 1);
+			AE_MULAF32R_HH(acc_h, b1, in); /* Coef b1 */
+			AE_MULAF32R_LL(acc_l, b1, in);
+			AE_MULAF32R_HH(acc_h, a1, tmp); /* Coef a1 */
+			AE_MULAF32R_LL(acc_l, a1, tmp);
+			d0p[0] = AE_SLAI64S(acc_h, 1); /* Store d0 as Q17.47 */
+			d0p[1] = AE_SLAI64S(acc_l, 1);
+
+			/* Compute delay d1 */
+			acc_h = AE_MULF32R_HH(b2, in); /* Coef b2 */
+			acc_l = AE_MULF32R_LL(b2, in);
+			AE_MULAF32R_HH(acc_h, a2, tmp); /* Coef a2 */
+			AE_MULAF32R_LL(acc_l, a2, tmp);
+			d1p[0] = AE_SLAI64S(acc_h, 1); /* Store d1 as Q17.47 */
+			d1p[1] = AE_SLAI64S(acc_l, 1);
+
+			/* Apply gain Q18.14 x Q1.31 -> Q34.30 */
+			acc_h = AE_MULF32R_HH(gain, tmp);
+			acc_l = AE_MULF32R_LL(gain, tmp);
+			acc_h = AE_SLAI64S(acc_h, 17); /* Convert to Q17.47 */
+			acc_l = AE_SLAI64S(acc_l, 17);
+
+			/* Apply biquad output shift right parameter and then
+			 * round and saturate to 32 bits Q1.31.
+			 */
+			acc_h = AE_SRAA64(acc_h, AE_MOVAD32_H(shift));
+			acc_l = AE_SRAA64(acc_l, AE_MOVAD32_L(shift));
+			in = AE_ROUND32X2F48SSYM(acc_h, acc_l);
+
+			/* Proceed to next biquad delay lines */
+			d0p += IIR_DF2T_NUM_DELAYS * lanes;
+		}
+		*xp = in;
+	}
+}
+
+#endif
@@ -8,9 +8,19 @@
 #include <errno.h>
 #include <stdint.h>
 
+#if MAT_GENERIC
+
+/* The columns of c are computed in blocks of four to read the rows of b
+ * in sequence and to have independent accumulators.
+ */
+
 int mat_multiply(struct mat_matrix_16b *a, struct mat_matrix_16b *b, struct mat_matrix_16b *c)
 {
-	int64_t s;
+	int64_t s0;
+	int64_t s1;
+	int64_t s2;
+	int64_t s3;
+	int32_t xk;
 	int16_t *x;
 	int16_t *y;
 	int16_t *z = c->data;
@@ -21,43 +31,46 @@ int mat_multiply(struct mat_matrix_16b *a, struct mat_matrix_16b *b, struct mat_
 	if (a->columns != b->rows || a->rows != c->rows || b->columns != c->columns)
 		return -EINVAL;
 
-	/* If all data is Q0 */
-	if (shift_minus_one == -1) {
-		for (i = 0; i < a->rows; i++) {
-			for (j = 0; j < b->columns; j++) {
-				s = 0;
-				x = a->data + a->columns * i;
-				y = b->data + j;
-				for (k = 0; k < b->rows; k++) {
-					s += (int32_t)(*x) * (*y);
-					x++;
-					y += y_inc;
-				}
-				*z = (int16_t)s; /* For Q16.0 */
-				z++;
+	for (i = 0; i < a->rows; i++) {
+		x = a->data + a->columns * i;
+		for (j = 0; j + 3 < b->columns; j += 4) {
+			s0 = 0;
+			s1 = 0;
+			s2 = 0;
+			s3 = 0;
+			y = b->data + j;
+			for (k = 0; k < b->rows; k++) {
+				xk = x[k];
+				s0 += xk * y[0];
+				s1 += xk * y[1];
+				s2 += xk * y[2];
+				s3 += xk * y[3];
+				y += y_inc;
 			}
+			z[0] = mat_round_16b(s0, shift_minus_one);
+			z[1] = mat_round_16b(s1, shift_minus_one);
+			z[2] = mat_round_16b(s2, shift_minus_one);
+			z[3] = mat_round_16b(s3, shift_minus_one);
+			z += 4;
 		}
 
-		return 0;
-	}
-
-	for (i = 0; i < a->rows; i++) {
-		for (j = 0; j < b->columns; j++) {
-			s = 0;
-			x = a->data + a->columns * i;
+		for (; j < b->columns; j++) {
+			s0 = 0;
 			y = b->data + j;
 			for (k = 0; k < b->rows; k++) {
-				s += (int32_t)(*x) * (*y);
-				x++;
+				s0 += (int32_t)x[k] * (*y);
 				y += y_inc;
 			}
-			*z = (int16_t)(((s >> shift_minus_one) + 1) >> 1); /*Shift to Qx.y */
+			*z = mat_round_16b(s0, shift_minus_one);
 			z++;
 		}
 	}
+
 	return 0;
 }
 
+#endif /* MAT_GENERIC */
+
 int mat_multiply_elementwise(struct mat_matrix_16b *a, struct mat_matrix_16b *b,
 			     struct mat_matrix_16b *c)
 {	int64_t p;
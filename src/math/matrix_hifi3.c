@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/math/matrix.h>
+#include <errno.h>
+#include <stdint.h>
+
+#if MAT_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/* The columns of c are computed in blocks of four. For each row of b four
+ * values are loaded to one register and multiplied with the same value of
+ * the row of a into four 64 bit accumulators. The matrix data is not 64 bit
+ * aligned, so the unaligned loads are used.
+ */
+
+int mat_multiply(struct mat_matrix_16b *a, struct mat_matrix_16b *b, struct mat_matrix_16b *c)
+{
+	ae_int64 s0;
+	ae_int64 s1;
+	ae_int64 s2;
+	ae_int64 s3;
+	ae_int32x2 xk;
+	ae_int16x4 y4;
+	ae_valign u;
+	ae_int16x4 *yp;
+	int16_t *x;
+	int16_t *y;
+	int16_t *z = c->data;
+	int64_t s;
+	int i, j, k;
+	const int y_inc = b->columns;
+	const int shift_minus_one = a->fractions + b->fractions - c->fractions - 1;
+
+	if (a->columns != b->rows || a->rows != c->rows || b->columns != c->columns)
+		return -EINVAL;
+
+	for (i = 0; i < a->rows; i++) {
+		x = a->data + a->columns * i;
+		for (j = 0; j + 3 < b->columns; j += 4) {
+			s0 = AE_ZERO64();
+			s1 = AE_ZERO64();
+			s2 = AE_ZERO64();
+			s3 = AE_ZERO64();
+			y = b->data + j;
+			for (k = 0; k < b->rows; k++) {
+				/* y4.3 is column j, y4.2 is j + 1, etc. */
+				yp = (ae_int16x4 *)y;
+				u = AE_LA64_PP(yp);
+				AE_LA16X4_IP(y4, u, yp);
+				xk = AE_MOVDA32(x[k]);
+				AE_MULA32X16_L3(s0, xk, y4);
+				AE_MULA32X16_L2(s1, xk, y4);
+				AE_MULA32X16_L1(s2, xk, y4);
+				AE_MULA32X16_L0(s3, xk, y4);
+				y += y_inc;
+			}
+			z[0] = mat_round_16b((int64_t)s0, shift_minus_one);
+			z[1] = mat_round_16b((int64_t)s1, shift_minus_one);
+			z[2] = mat_round_16b((int64_t)s2, shift_minus_one);
+			z[3] = mat_round_16b((int64_t)s3, shift_minus_one);
+			z += 4;
+		}
+
+		for (; j < b->columns; j++) {
+			s = 0;
+			y = b->data + j;
+			for (k = 0; k < b->rows; k++) {
+				s += (int32_t)x[k] * (*y);
+				y += y_inc;
+			}
+			*z = mat_round_16b(s, shift_minus_one);
+			z++;
+		}
+	}
+
+	return 0;
+}
+
+#endif /* MAT_HIFI3 */
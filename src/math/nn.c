@@ -0,0 +1,457 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/numbers.h>
+#include <sof/math/nn.h>
+#include <rtos/alloc.h>
+#include <rtos/string.h>
+#include <ipc/topology.h>
+#include <user/nn.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define NN_ONE_Q15		32768
+#define NN_SIGMOID_MAX_Q12	(8 << 12)
+#define NN_SIGMOID_STEP_SHIFT	9 /* table step of 1/8 in Q4.12 */
+
+/* sigmoid(i / 8) in Q1.15 for i = 0 .. 64 */
+static const int16_t nn_sigmoid_table[65] = {
+	16384, 17407, 18421, 19420, 20397, 21344, 22255, 23127,
+	23955, 24737, 25471, 26155, 26790, 27377, 27917, 28411,
+	28862, 29272, 29644, 29979, 30282, 30555, 30799, 31018,
+	31214, 31389, 31545, 31684, 31807, 31917, 32015, 32102,
+	32179, 32247, 32307, 32361, 32408, 32450, 32487, 32520,
+	32549, 32574, 32597, 32617, 32635, 32650, 32664, 32676,
+	32687, 32696, 32705, 32712, 32719, 32725, 32730, 32734,
+	32738, 32742, 32745, 32747, 32750, 32752, 32754, 32756,
+	32757,
+};
+
+/* Q4.12 in, Q1.15 out */
+static int32_t nn_sigmoid(int32_t x)
+{
+	int32_t ax = x < 0 ? -x : x;
+	int32_t frac;
+	int32_t v;
+	int idx;
+
+	if (ax >= NN_SIGMOID_MAX_Q12) {
+		v = nn_sigmoid_table[64];
+	} else {
+		idx = ax >> NN_SIGMOID_STEP_SHIFT;
+		frac = ax & ((1 << NN_SIGMOID_STEP_SHIFT) - 1);
+		v = nn_sigmoid_table[idx] + (((nn_sigmoid_table[idx + 1] - nn_sigmoid_table[idx]) *
+					      frac) >> NN_SIGMOID_STEP_SHIFT);
+	}
+
+	return x < 0 ? NN_ONE_Q15 - v : v;
+}
+
+/* Q4.12 in, Q1.15 out, tanh(x) = 2 * sigmoid(2 * x) - 1 */
+static int32_t nn_tanh(int32_t x)
+{
+	return 2 * nn_sigmoid(2 * x) - NN_ONE_Q15;
+}
+
+static int32_t nn_scale(int32_t acc, int32_t mult, int shift)
+{
+	int s = 31 + shift;
+
+	return ((int64_t)acc * mult + (1LL << (s - 1))) >> s;
+}
+
+void sofm_nn_free(struct sofm_nn *nn)
+{
+	int i;
+
+	if (nn->layers) {
+		for (i = 0; i < nn->num_layers; i++) {
+			rfree(nn->layers[i].history);
+			rfree(nn->layers[i].hidden);
+			rfree(nn->layers[i].hidden_s8);
+		}
+	}
+
+	rfree(nn->layers);
+	rfree(nn->model);
+	rfree(nn->act[0]);
+	rfree(nn->act[1]);
+	rfree(nn->acc);
+	rfree(nn->gates);
+	memset(nn, 0, sizeof(*nn));
+}
+
+/* Check the parameter size of a layer and set the pointers to them */
+static int nn_layer_params(struct sofm_nn_layer *layer)
+{
+	const struct sof_nn_layer_header *hdr = layer->hdr;
+	const uint8_t *p = (const uint8_t *)(hdr + 1);
+	size_t size;
+	int rows;
+
+	layer->in_stride = ALIGN_UP(hdr->in_size, 4);
+	layer->out_stride = ALIGN_UP(hdr->out_size, 4);
+
+	switch (hdr->type) {
+	case SOF_NN_LAYER_FC:
+		rows = hdr->out_size;
+		layer->bias[0] = (const int32_t *)p;
+		layer->weights[0] = (const int8_t *)(p + rows * sizeof(int32_t));
+		size = rows * sizeof(int32_t) + rows * layer->in_stride;
+		break;
+	case SOF_NN_LAYER_DWCONV:
+		if (hdr->in_size != hdr->out_size || !hdr->kernel ||
+		    hdr->kernel > SOF_NN_MAX_KERNEL)
+			return -EINVAL;
+
+		rows = hdr->in_size;
+		layer->bias[0] = (const int32_t *)p;
+		layer->weights[0] = (const int8_t *)(p + rows * sizeof(int32_t));
+		size = rows * sizeof(int32_t) + hdr->kernel * layer->in_stride;
+		break;
+	case SOF_NN_LAYER_GRU:
+		rows = 3 * hdr->out_size;
+		layer->bias[0] = (const int32_t *)p;
+		layer->bias[1] = layer->bias[0] + rows;
+		layer->weights[0] = (const int8_t *)(layer->bias[1] + rows);
+		layer->weights[1] = layer->weights[0] + rows * layer->in_stride;
+		size = 2 * rows * sizeof(int32_t) + rows * (layer->in_stride + layer->out_stride);
+		break;
+	case SOF_NN_LAYER_RELU:
+		if (hdr->in_size != hdr->out_size)
+			return -EINVAL;
+
+		size = 0;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (hdr->size != sizeof(*hdr) + size)
+		return -EINVAL;
+
+	if (hdr->shift[0] <= -31 || hdr->shift[0] >= 32 ||
+	    hdr->shift[1] <= -31 || hdr->shift[1] >= 32)
+		return -EINVAL;
+
+	return 0;
+}
+
+static int nn_layer_state(struct sofm_nn_layer *layer)
+{
+	const struct sof_nn_layer_header *hdr = layer->hdr;
+
+	switch (hdr->type) {
+	case SOF_NN_LAYER_DWCONV:
+		if (hdr->kernel == 1)
+			return 0;
+
+		layer->history = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+					 (hdr->kernel - 1) * layer->in_stride);
+		return layer->history ? 0 : -ENOMEM;
+	case SOF_NN_LAYER_GRU:
+		layer->hidden = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+					hdr->out_size * sizeof(int16_t));
+		layer->hidden_s8 = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+					   layer->out_stride);
+		return layer->hidden && layer->hidden_s8 ? 0 : -ENOMEM;
+	default:
+		return 0;
+	}
+}
+
+int sofm_nn_init(struct sofm_nn *nn, const void *blob, size_t size, uint32_t caps)
+{
+	const struct sof_nn_model_header *model = blob;
+	const struct sof_nn_layer_header *hdr;
+	struct sofm_nn_layer *layer;
+	struct sofm_nn_layer *prev = NULL;
+	size_t offset = sizeof(*model);
+	int max_size;
+	int max_acc;
+	int max_gates = 0;
+	int prev_size;
+	int ret;
+	int i;
+
+	memset(nn, 0, sizeof(*nn));
+	if (size < sizeof(*model) || model->magic != SOF_NN_MAGIC || model->size != size ||
+	    !model->num_layers || model->num_layers > SOF_NN_MAX_LAYERS ||
+	    !model->input_size || model->input_size > SOF_NN_MAX_SIZE)
+		return -EINVAL;
+
+	/* The weights are used from the copy of the blob */
+	nn->model = rballoc_align(0, caps, size, sizeof(int64_t));
+	nn->layers = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			     model->num_layers * sizeof(*nn->layers));
+	if (!nn->model || !nn->layers) {
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	memcpy_s(nn->model, size, blob, size);
+	nn->input_size = model->input_size;
+	nn->input_shift = model->input_shift;
+	prev_size = model->input_size;
+	max_size = prev_size;
+	max_acc = prev_size;
+
+	for (i = 0; i < model->num_layers; i++) {
+		hdr = (const struct sof_nn_layer_header *)((uint8_t *)nn->model + offset);
+		if (offset + sizeof(*hdr) > size || hdr->size > size - offset || hdr->size & 3 ||
+		    hdr->in_size != prev_size || !hdr->out_size ||
+		    hdr->out_size > SOF_NN_MAX_SIZE) {
+			ret = -EINVAL;
+			goto err;
+		}
+
+		offset += hdr->size;
+		prev_size = hdr->out_size;
+
+		/* Fuse ReLU to the output of the previous layer */
+		if (hdr->type == SOF_NN_LAYER_RELU && prev && !prev->relu &&
+		    (prev->hdr->type == SOF_NN_LAYER_FC || prev->hdr->type == SOF_NN_LAYER_DWCONV)) {
+			if (hdr->size != sizeof(*hdr) || hdr->in_size != hdr->out_size) {
+				ret = -EINVAL;
+				goto err;
+			}
+
+			prev->relu = true;
+			continue;
+		}
+
+		layer = &nn->layers[nn->num_layers];
+		layer->hdr = hdr;
+		ret = nn_layer_params(layer);
+		if (ret < 0)
+			goto err;
+
+		/* Count the layer before allocating its state to free it on error */
+		nn->num_layers++;
+		ret = nn_layer_state(layer);
+		if (ret < 0)
+			goto err;
+
+		max_size = MAX(max_size, hdr->out_size);
+		if (hdr->type == SOF_NN_LAYER_GRU) {
+			max_acc = MAX(max_acc, 3 * hdr->out_size);
+			max_gates = MAX(max_gates, 6 * hdr->out_size);
+		} else {
+			max_acc = MAX(max_acc, hdr->out_size);
+		}
+
+		prev = layer;
+	}
+
+	if (offset != size) {
+		ret = -EINVAL;
+		goto err;
+	}
+
+	nn->output_size = prev_size;
+	max_size = ALIGN_UP(max_size, 4);
+	nn->act[0] = rballoc_align(0, SOF_MEM_CAPS_RAM, max_size, sizeof(int64_t));
+	nn->act[1] = rballoc_align(0, SOF_MEM_CAPS_RAM, max_size, sizeof(int64_t));
+	nn->acc = rballoc(0, SOF_MEM_CAPS_RAM, max_acc * sizeof(int32_t));
+	if (max_gates)
+		nn->gates = rballoc(0, SOF_MEM_CAPS_RAM, max_gates * sizeof(int16_t));
+
+	if (!nn->act[0] || !nn->act[1] || !nn->acc || (max_gates && !nn->gates)) {
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	/* The padding of the inputs is multiplied by zero weights */
+	memset(nn->act[0], 0, max_size);
+	memset(nn->act[1], 0, max_size);
+	return 0;
+
+err:
+	sofm_nn_free(nn);
+	return ret;
+}
+
+void sofm_nn_reset(struct sofm_nn *nn)
+{
+	struct sofm_nn_layer *layer;
+	int i;
+
+	for (i = 0; i < nn->num_layers; i++) {
+		layer = &nn->layers[i];
+		if (layer->history)
+			memset(layer->history, 0, (layer->hdr->kernel - 1) * layer->in_stride);
+
+		if (layer->hidden) {
+			memset(layer->hidden, 0, layer->hdr->out_size * sizeof(int16_t));
+			memset(layer->hidden_s8, 0, layer->out_stride);
+		}
+	}
+}
+
+static void nn_output_s8(const struct sofm_nn_layer *layer, const int32_t *acc, int8_t *out)
+{
+	const struct sof_nn_layer_header *hdr = layer->hdr;
+	int32_t v;
+	int i;
+
+	for (i = 0; i < hdr->out_size; i++) {
+		v = nn_scale(acc[i], hdr->mult[0], hdr->shift[0]);
+		if (layer->relu && v < 0)
+			v = 0;
+
+		out[i] = sat_int8(v);
+	}
+}
+
+static void nn_fc(struct sofm_nn *nn, const struct sofm_nn_layer *layer,
+		  const int8_t *in, int8_t *out)
+{
+	sofm_nn_matvec_s8(layer->weights[0], in, layer->bias[0], nn->acc,
+			  layer->hdr->out_size, layer->in_stride);
+	nn_output_s8(layer, nn->acc, out);
+}
+
+/* Depthwise convolution over time, the tap k is applied to the input
+ * of k frames ago.
+ */
+static void nn_dwconv(struct sofm_nn *nn, const struct sofm_nn_layer *layer,
+		      const int8_t *in, int8_t *out)
+{
+	const int channels = layer->hdr->in_size;
+	const int taps = layer->hdr->kernel;
+	const int stride = layer->in_stride;
+	const int8_t *w = layer->weights[0];
+	const int8_t *h;
+	int32_t *acc = nn->acc;
+	int c;
+	int k;
+
+	for (c = 0; c < channels; c++)
+		acc[c] = layer->bias[0][c] + (int32_t)w[c] * in[c];
+
+	for (k = 1; k < taps; k++) {
+		w += stride;
+		h = &layer->history[(taps - 1 - k) * stride];
+		for (c = 0; c < channels; c++)
+			acc[c] += (int32_t)w[c] * h[c];
+	}
+
+	if (taps > 1) {
+		memmove(layer->history, &layer->history[stride], (taps - 2) * stride);
+		memcpy_s(&layer->history[(taps - 2) * stride], stride, in, channels);
+	}
+
+	nn_output_s8(layer, acc, out);
+}
+
+static void nn_gru(struct sofm_nn *nn, const struct sofm_nn_layer *layer,
+		   const int8_t *in, int8_t *out)
+{
+	const struct sof_nn_layer_header *hdr = layer->hdr;
+	const int units = hdr->out_size;
+	const int rows = 3 * units;
+	int16_t *gx = nn->gates;
+	int16_t *gh = nn->gates + rows;
+	int32_t r;
+	int32_t z;
+	int32_t n;
+	int32_t h;
+	int i;
+
+	/* Gate inputs in Q4.12 from the input and from the previous state */
+	sofm_nn_matvec_s8(layer->weights[0], in, layer->bias[0], nn->acc, rows, layer->in_stride);
+	for (i = 0; i < rows; i++)
+		gx[i] = sat_int16(nn_scale(nn->acc[i], hdr->mult[0], hdr->shift[0]));
+
+	sofm_nn_matvec_s8(layer->weights[1], layer->hidden_s8, layer->bias[1], nn->acc, rows,
+			  layer->out_stride);
+	for (i = 0; i < rows; i++)
+		gh[i] = sat_int16(nn_scale(nn->acc[i], hdr->mult[1], hdr->shift[1]));
+
+	for (i = 0; i < units; i++) {
+		r = nn_sigmoid((int32_t)gx[i] + gh[i]);
+		z = nn_sigmoid((int32_t)gx[units + i] + gh[units + i]);
+		n = nn_tanh((int32_t)gx[2 * units + i] + ((r * gh[2 * units + i]) >> 15));
+		h = n + ((z * (layer->hidden[i] - n)) >> 15);
+		layer->hidden[i] = sat_int16(h);
+		out[i] = sat_int8((h + 128) >> 8);
+		layer->hidden_s8[i] = out[i];
+	}
+}
+
+static void nn_relu(const struct sofm_nn_layer *layer, const int8_t *in, int8_t *out)
+{
+	int i;
+
+	for (i = 0; i < layer->hdr->out_size; i++)
+		out[i] = in[i] < 0 ? 0 : in[i];
+}
+
+/* The input frame is in act[0] */
+static const int8_t *nn_run_layers(struct sofm_nn *nn)
+{
+	const struct sofm_nn_layer *layer;
+	int8_t *in = nn->act[0];
+	int8_t *out = nn->act[1];
+	int8_t *tmp;
+	int i;
+
+	for (i = 0; i < nn->num_layers; i++) {
+		layer = &nn->layers[i];
+		switch (layer->hdr->type) {
+		case SOF_NN_LAYER_FC:
+			nn_fc(nn, layer, in, out);
+			break;
+		case SOF_NN_LAYER_DWCONV:
+			nn_dwconv(nn, layer, in, out);
+			break;
+		case SOF_NN_LAYER_GRU:
+			nn_gru(nn, layer, in, out);
+			break;
+		case SOF_NN_LAYER_RELU:
+			nn_relu(layer, in, out);
+			break;
+		}
+
+		tmp = in;
+		in = out;
+		out = tmp;
+	}
+
+	return in;
+}
+
+const int8_t *sofm_nn_run(struct sofm_nn *nn, const int8_t *in)
+{
+	/* Copy to the padded and aligned buffer */
+	memcpy_s(nn->act[0], nn->input_size, in, nn->input_size);
+	return nn_run_layers(nn);
+}
+
+const int8_t *sofm_nn_run_s16(struct sofm_nn *nn, const int16_t *in)
+{
+	int i;
+
+	for (i = 0; i < nn->input_size; i++)
+		nn->act[0][i] = sat_int8(in[i] >> nn->input_shift);
+
+	return nn_run_layers(nn);
+}
+
+int sofm_nn_argmax(const int8_t *out, int n)
+{
+	int idx = 0;
+	int i;
+
+	for (i = 1; i < n; i++) {
+		if (out[i] > out[idx])
+			idx = i;
+	}
+
+	return idx;
+}
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/math/nn.h>
+#include <stdint.h>
+
+#if SOFM_NN_GENERIC
+
+void sofm_nn_matvec_s8(const int8_t *w, const int8_t *x, const int32_t *bias,
+		       int32_t *out, int rows, int stride)
+{
+	int32_t acc;
+	int r;
+	int i;
+
+	for (r = 0; r < rows; r++) {
+		acc = bias[r];
+		for (i = 0; i < stride; i++)
+			acc += (int32_t)w[i] * x[i];
+
+		out[r] = acc;
+		w += stride;
+	}
+}
+
+#endif /* SOFM_NN_GENERIC */
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/math/nn.h>
+#include <stdint.h>
+
+#if SOFM_NN_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/* The int8 values are loaded to the upper bytes of 16 bit lanes, so the
+ * sum of four products is 2^16 times the product sum of the int8 values.
+ * The 64 bit accumulator holds it without overflow for any row length.
+ */
+void sofm_nn_matvec_s8(const int8_t *w, const int8_t *x, const int32_t *bias,
+		       int32_t *out, int rows, int stride)
+{
+	signed char *wp = (signed char *)w;
+	signed char *xp;
+	ae_int16x4 w4;
+	ae_int16x4 x4;
+	ae_int64 acc;
+	int r;
+	int i;
+
+	for (r = 0; r < rows; r++) {
+		xp = (signed char *)x;
+		acc = AE_ZERO64();
+		for (i = 0; i < (stride >> 2); i++) {
+			AE_L8X4F_IP(w4, wp, 4);
+			AE_L8X4F_IP(x4, xp, 4);
+			AE_MULAAAAQ16(acc, w4, x4);
+		}
+
+		out[r] = bias[r] + (int32_t)AE_MOVINT32_FROMINT64(AE_SRAI64(acc, 16));
+	}
+}
+
+#endif /* SOFM_NN_HIFI3 */
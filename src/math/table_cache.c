@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/common.h>
+#include <sof/lib/cpu.h>
+#include <sof/list.h>
+#include <sof/math/table_cache.h>
+#include <ipc/topology.h>
+#include <rtos/alloc.h>
+#include <rtos/interrupt.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* The tables are kept per core in the local runtime heap, so the instances
+ * read them through the data cache as they did their private copies. The
+ * list of a core is modified only on that core with interrupts disabled.
+ */
+
+struct sofm_table_entry {
+	struct list_item list;
+	struct sofm_table_key key;
+	size_t size;
+	int refs;
+	uint8_t data[] __aligned(8);
+};
+
+static struct list_item sofm_table_list[CONFIG_CORE_COUNT];
+
+static struct list_item *sofm_table_core_list(void)
+{
+	struct list_item *tables = &sofm_table_list[cpu_get_id()];
+
+	if (!tables->next)
+		list_init(tables);
+
+	return tables;
+}
+
+static struct sofm_table_entry *sofm_table_find(struct list_item *tables,
+						const struct sofm_table_key *key,
+						size_t size)
+{
+	struct sofm_table_entry *entry;
+	struct list_item *item;
+
+	list_for_item(item, tables) {
+		entry = container_of(item, struct sofm_table_entry, list);
+		if (entry->size == size && !memcmp(&entry->key, key, sizeof(*key)))
+			return entry;
+	}
+
+	return NULL;
+}
+
+void *sofm_table_get(const struct sofm_table_key *key, size_t size, sofm_table_fill fill)
+{
+	struct list_item *tables;
+	struct sofm_table_entry *entry;
+	struct sofm_table_entry *new_entry;
+	uint32_t flags;
+
+	irq_local_disable(flags);
+	tables = sofm_table_core_list();
+	entry = sofm_table_find(tables, key, size);
+	if (entry)
+		entry->refs++;
+
+	irq_local_enable(flags);
+	if (entry)
+		return entry->data;
+
+	/* Compute the table with interrupts enabled, it may take long */
+	new_entry = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			    sizeof(*new_entry) + size);
+	if (!new_entry)
+		return NULL;
+
+	new_entry->key = *key;
+	new_entry->size = size;
+	new_entry->refs = 1;
+	fill(new_entry->data, key);
+
+	/* Another instance may have added the same table meanwhile */
+	irq_local_disable(flags);
+	entry = sofm_table_find(tables, key, size);
+	if (entry)
+		entry->refs++;
+	else
+		list_item_append(&new_entry->list, tables);
+
+	irq_local_enable(flags);
+	if (entry) {
+		rfree(new_entry);
+		return entry->data;
+	}
+
+	return new_entry->data;
+}
+
+void sofm_table_put(void *table)
+{
+	struct sofm_table_entry *entry;
+	uint32_t flags;
+	int refs;
+
+	if (!table)
+		return;
+
+	entry = container_of(table, struct sofm_table_entry, data);
+
+	irq_local_disable(flags);
+	refs = --entry->refs;
+	if (!refs)
+		list_item_del(&entry->list);
+
+	irq_local_enable(flags);
+	if (!refs)
+		rfree(entry);
+}
@@ -279,3 +279,97 @@ void cmpx_cexp(int32_t sign, int32_t b_yn, int32_t xn, cordic_cfg type, struct c
 		cexp->im = sat_int16(Q_SHIFT_RND((cexp->im), 30, 15));
 	}
 }
+
+#if CORDIC_BLOCK_GENERIC
+void sin_fixed_32b_vec(const int32_t *th_rad_fxp, int32_t *y, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sin_fixed_32b(th_rad_fxp[i]);
+}
+
+void cos_fixed_32b_vec(const int32_t *th_rad_fxp, int32_t *y, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = cos_fixed_32b(th_rad_fxp[i]);
+}
+
+void atan2_fixed_32b_vec(const int32_t *y, const int32_t *x, int32_t *th, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		th[i] = atan2_fixed_32b(y[i], x[i]);
+}
+#endif
+
+/**
+ * CORDIC-based approximation of inverse tangent
+ * Arguments	: int32_t y
+ *		  int32_t x
+ * Return Type	: int32_t, Q3.29
+ */
+int32_t atan2_fixed_32b(int32_t y, int32_t x)
+{
+	int32_t xs;
+	int32_t z = 0;
+	int i;
+
+	/* Q3.29 leaves room for the sqrt(2) * CORDIC gain growth of x */
+	x >>= 2;
+	y >>= 2;
+	if (!x && !y)
+		return 0;
+
+	/* The iteration converges for the right half plane, rotate the left
+	 * half plane there by -pi/2 or pi/2.
+	 */
+	if (x < 0) {
+		if (y >= 0) {
+			xs = y;
+			y = -x;
+			z = PI_DIV2_Q3_29;
+		} else {
+			xs = -y;
+			y = x;
+			z = -PI_DIV2_Q3_29;
+		}
+		x = xs;
+	}
+
+	/* Rotate (x, y) towards the x-axis, the sum of the rotation angles
+	 * atan(2^-i) converges to the angle of the vector.
+	 */
+	for (i = 0; i < CORDIC_31B_TABLE_SIZE - 1; i++) {
+		xs = x;
+		if (y > 0) {
+			x += y >> i;
+			y -= xs >> i;
+			z += cordic_lookup[i] >> 1;
+		} else {
+			x -= y >> i;
+			y += xs >> i;
+			z -= cordic_lookup[i] >> 1;
+		}
+	}
+
+	return z;
+}
+
+void cordic_osc_sin_32b(struct cordic_osc *osc, int32_t *y, int n)
+{
+	int64_t w;
+	int i;
+
+	/* the angles are computed first to the output and rotated in place */
+	for (i = 0; i < n; i++) {
+		y[i] = osc->w;
+		w = (int64_t)osc->w + osc->w_step;
+		osc->w = (w > PI_MUL2_Q4_28) ? (int32_t)(w - PI_MUL2_Q4_28) : (int32_t)w;
+	}
+
+	sin_fixed_32b_vec(y, y, n);
+}
@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/math/trig.h>
+#include <sof/math/cordic.h>
+#include <stdint.h>
+
+#if CORDIC_BLOCK_HIFI
+
+#if XCHAL_HAVE_HIFI5
+#include <xtensa/tie/xt_hifi5.h>
+#elif XCHAL_HAVE_HIFI4
+#include <xtensa/tie/xt_hifi4.h>
+#else
+#include <xtensa/tie/xt_hifi3.h>
+#endif
+
+/* 1 / CORDIC gain, the same as cordic_sine_cos_lut_q29fl in trig.c */
+#define CORDIC_INV_GAIN_Q29	652032874
+
+/*
+ * Two lanes of cordic_approx() with 31 iterations. The data dependent
+ * branches of the scalar version are replaced by computing both directions
+ * and selecting one with the sign of the residual angle, so the outputs
+ * are bit exact with it. Returns sign * cos and sign * sin in Q2.30.
+ */
+static void cordic_approx_x2(ae_int32x2 th, ae_int32x2 *cos_out, ae_int32x2 *sin_out)
+{
+	const ae_int32x2 zero = AE_ZERO32();
+	const ae_int32x2 th0 = th;
+	ae_int32x2 sign = AE_MOVDA32(1);
+	ae_int32x2 xtmp, ytmp;
+	ae_int32x2 t1, t2, s;
+	ae_int32x2 x, y;
+	ae_int32x2 lut;
+	xtbool2 fold;
+	xtbool2 near;
+	xtbool2 neg;
+	int i;
+
+	/* angles above pi/2 are moved down by pi with sign change, or by 2*pi */
+	fold = AE_LT32(AE_MOVDA32(PI_DIV2_Q4_28), th0);
+	t1 = AE_SUB32(th0, AE_MOVDA32(PI_Q4_28));
+	t2 = AE_SUB32(th0, AE_MOVDA32(PI_MUL2_Q4_28));
+	near = AE_LE32(t1, AE_MOVDA32(PI_DIV2_Q4_28));
+	s = AE_MOVDA32(1);
+	AE_MOVT32X2(t2, t1, near);
+	AE_MOVT32X2(s, AE_MOVDA32(-1), near);
+	AE_MOVT32X2(th, t2, fold);
+	AE_MOVT32X2(sign, s, fold);
+
+	/* angles below -pi/2 are moved up by pi with sign change, or by 2*pi */
+	fold = AE_LT32(th0, AE_MOVDA32(-PI_DIV2_Q4_28));
+	t1 = AE_ADD32(th0, AE_MOVDA32(PI_Q4_28));
+	t2 = AE_ADD32(th0, AE_MOVDA32(PI_MUL2_Q4_28));
+	near = AE_LE32(AE_MOVDA32(-PI_DIV2_Q4_28), t1);
+	s = AE_MOVDA32(1);
+	AE_MOVT32X2(t2, t1, near);
+	AE_MOVT32X2(s, AE_MOVDA32(-1), near);
+	AE_MOVT32X2(th, t2, fold);
+	AE_MOVT32X2(sign, s, fold);
+
+	th = AE_SLAI32(th, 2);
+	x = AE_MOVDA32(CORDIC_INV_GAIN_Q29);
+	y = zero;
+	xtmp = x;
+	ytmp = zero;
+
+	for (i = 0; i < CORDIC_31B_TABLE_SIZE; i++) {
+		lut = AE_MOVDA32(cordic_lookup[i]);
+		neg = AE_LT32(th, zero);
+
+		t1 = AE_SUB32(th, lut);
+		AE_MOVT32X2(t1, AE_ADD32(th, lut), neg);
+		th = t1;
+
+		t1 = AE_SUB32(x, ytmp);
+		AE_MOVT32X2(t1, AE_ADD32(x, ytmp), neg);
+		x = t1;
+
+		t1 = AE_ADD32(y, xtmp);
+		AE_MOVT32X2(t1, AE_SUB32(y, xtmp), neg);
+		y = t1;
+
+		xtmp = AE_SRAA32(x, i + 1);
+		ytmp = AE_SRAA32(y, i + 1);
+	}
+
+	neg = AE_LT32(sign, zero);
+	AE_MOVT32X2(x, AE_NEG32S(x), neg);
+	AE_MOVT32X2(y, AE_NEG32S(y), neg);
+	*cos_out = x;
+	*sin_out = y;
+}
+
+void sin_fixed_32b_vec(const int32_t *th_rad_fxp, int32_t *y, int n)
+{
+	ae_int32x2 *in = (ae_int32x2 *)th_rad_fxp;
+	ae_int32x2 *out = (ae_int32x2 *)y;
+	ae_valign inu = AE_LA64_PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int32x2 th;
+	ae_int32x2 c;
+	ae_int32x2 s;
+	int i;
+
+	for (i = 0; i < n >> 1; i++) {
+		AE_LA32X2_IP(th, inu, in);
+		cordic_approx_x2(th, &c, &s);
+		/* Q2.30 to Q1.31 with saturation */
+		s = AE_SLAI32S(s, 1);
+		AE_SA32X2_IP(s, outu, out);
+	}
+	AE_SA64POS_FP(outu, out);
+
+	if (n & 1)
+		y[n - 1] = sin_fixed_32b(th_rad_fxp[n - 1]);
+}
+
+void cos_fixed_32b_vec(const int32_t *th_rad_fxp, int32_t *y, int n)
+{
+	ae_int32x2 *in = (ae_int32x2 *)th_rad_fxp;
+	ae_int32x2 *out = (ae_int32x2 *)y;
+	ae_valign inu = AE_LA64_PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int32x2 th;
+	ae_int32x2 c;
+	ae_int32x2 s;
+	int i;
+
+	for (i = 0; i < n >> 1; i++) {
+		AE_LA32X2_IP(th, inu, in);
+		cordic_approx_x2(th, &c, &s);
+		/* Q2.30 to Q1.31 with saturation */
+		c = AE_SLAI32S(c, 1);
+		AE_SA32X2_IP(c, outu, out);
+	}
+	AE_SA64POS_FP(outu, out);
+
+	if (n & 1)
+		y[n - 1] = cos_fixed_32b(th_rad_fxp[n - 1]);
+}
+
+/* Two lanes of atan2_fixed_32b(), bit exact with it */
+static ae_int32x2 cordic_atan2_x2(ae_int32x2 y, ae_int32x2 x)
+{
+	const ae_int32x2 zero = AE_ZERO32();
+	ae_int32x2 xr, yr, zr;
+	ae_int32x2 xs, ys;
+	ae_int32x2 z = zero;
+	ae_int32x2 lut;
+	ae_int32x2 t;
+	xtbool2 left;
+	xtbool2 up;
+	xtbool2 pos;
+	int i;
+
+	x = AE_SRAI32(x, 2);
+	y = AE_SRAI32(y, 2);
+
+	/* left half plane is rotated by -pi/2 when y >= 0, otherwise by pi/2 */
+	left = AE_LT32(x, zero);
+	up = AE_LE32(zero, y);
+	xr = AE_NEG32S(y);
+	yr = x;
+	zr = AE_MOVDA32(-PI_DIV2_Q3_29);
+	AE_MOVT32X2(xr, y, up);
+	AE_MOVT32X2(yr, AE_NEG32S(x), up);
+	AE_MOVT32X2(zr, AE_MOVDA32(PI_DIV2_Q3_29), up);
+	AE_MOVT32X2(x, xr, left);
+	AE_MOVT32X2(y, yr, left);
+	AE_MOVT32X2(z, zr, left);
+
+	for (i = 0; i < CORDIC_31B_TABLE_SIZE - 1; i++) {
+		lut = AE_MOVDA32(cordic_lookup[i] >> 1);
+		pos = AE_LT32(zero, y);
+		xs = AE_SRAA32(x, i);
+		ys = AE_SRAA32(y, i);
+
+		t = AE_SUB32(x, ys);
+		AE_MOVT32X2(t, AE_ADD32(x, ys), pos);
+		x = t;
+
+		t = AE_ADD32(y, xs);
+		AE_MOVT32X2(t, AE_SUB32(y, xs), pos);
+		y = t;
+
+		t = AE_SUB32(z, lut);
+		AE_MOVT32X2(t, AE_ADD32(z, lut), pos);
+		z = t;
+	}
+
+	return z;
+}
+
+void atan2_fixed_32b_vec(const int32_t *y, const int32_t *x, int32_t *th, int n)
+{
+	ae_int32x2 *in_y = (ae_int32x2 *)y;
+	ae_int32x2 *in_x = (ae_int32x2 *)x;
+	ae_int32x2 *out = (ae_int32x2 *)th;
+	ae_valign yu = AE_LA64_PP(in_y);
+	ae_valign xu = AE_LA64_PP(in_x);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int32x2 vy;
+	ae_int32x2 vx;
+	ae_int32x2 z;
+	xtbool2 zero_in;
+	int i;
+
+	for (i = 0; i < n >> 1; i++) {
+		AE_LA32X2_IP(vy, yu, in_y);
+		AE_LA32X2_IP(vx, xu, in_x);
+
+		/* (0, 0) after the input scaling returns zero */
+		z = AE_MOVINT32X2_FROMINT64(AE_OR64(AE_MOVINT64_FROMINT32X2(AE_SRAI32(vy, 2)),
+						    AE_MOVINT64_FROMINT32X2(AE_SRAI32(vx, 2))));
+		zero_in = AE_EQ32(z, AE_ZERO32());
+		z = cordic_atan2_x2(vy, vx);
+		AE_MOVT32X2(z, AE_ZERO32(), zero_in);
+		AE_SA32X2_IP(z, outu, out);
+	}
+	AE_SA64POS_FP(outu, out);
+
+	if (n & 1)
+		th[n - 1] = atan2_fixed_32b(y[n - 1], x[n - 1]);
+}
+
+#endif /* CORDIC_BLOCK_HIFI */
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+#include <sof/math/numbers.h>
+#include <sof/math/xcorr.h>
+#include <rtos/alloc.h>
+#include <ipc/topology.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+int sofm_xcorr_peak(const int64_t *r, int max_lag)
+{
+	int n = 2 * max_lag + 1;
+	int idx = 0;
+	int i;
+
+	for (i = 1; i < n; i++) {
+		if (r[i] > r[idx])
+			idx = i;
+	}
+
+	return idx - max_lag;
+}
+
+void sofm_xcorr_to_32(const int64_t *r, int max_lag, int shift, int32_t *out)
+{
+	int n = 2 * max_lag + 1;
+	int i;
+
+	for (i = 0; i < n; i++)
+		out[i] = sat_int32(r[i] >> shift);
+}
+
+static void xcorr_copy_in(int16_t *dst, const int16_t *src, int stride, int frames)
+{
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		dst[i] = *src;
+		src += stride;
+	}
+}
+
+int sofm_xcorr_16_init(struct sofm_xcorr_16 *xc, int max_lag, int max_frames)
+{
+	if (max_lag < 0 || max_frames < 1)
+		return -EINVAL;
+
+	xc->max_lag = max_lag;
+	xc->max_frames = max_frames;
+	xc->x = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			sizeof(int16_t) * (2 * max_lag + max_frames));
+	xc->y = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			sizeof(int16_t) * (max_lag + max_frames));
+	xc->r = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			sizeof(int64_t) * (2 * max_lag + 1));
+	if (!xc->x || !xc->y || !xc->r) {
+		sofm_xcorr_16_free(xc);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+void sofm_xcorr_16_free(struct sofm_xcorr_16 *xc)
+{
+	rfree(xc->x);
+	rfree(xc->y);
+	rfree(xc->r);
+	xc->x = NULL;
+	xc->y = NULL;
+	xc->r = NULL;
+}
+
+void sofm_xcorr_16_reset(struct sofm_xcorr_16 *xc)
+{
+	memset(xc->r, 0, sizeof(int64_t) * (2 * xc->max_lag + 1));
+}
+
+void sofm_xcorr_16_process(struct sofm_xcorr_16 *xc, const int16_t *x, const int16_t *y,
+			   int stride, int frames)
+{
+	const int max_lag = xc->max_lag;
+
+	/* The new frames are appended to the history. The y frames max_lag
+	 * before the newest are correlated to have the lags up to max_lag of
+	 * x available on both sides.
+	 */
+	xcorr_copy_in(&xc->x[2 * max_lag], x, stride, frames);
+	xcorr_copy_in(&xc->y[max_lag], y, stride, frames);
+	sofm_xcorr_acc_16(&xc->x[max_lag], xc->y, frames, max_lag, xc->r);
+
+	memmove(xc->x, &xc->x[frames], sizeof(int16_t) * 2 * max_lag);
+	memmove(xc->y, &xc->y[frames], sizeof(int16_t) * max_lag);
+}
+
+#if CONFIG_MATH_FFT && CONFIG_MATH_32BIT_FFT
+
+int sofm_xcorr_fft_16_init(struct sofm_xcorr_fft_16 *xc, int max_lag, int block)
+{
+	/* The FFT of 2B points holds the B frames of y correlated with
+	 * B + 2 * max_lag frames of x without wrap around.
+	 */
+	if (max_lag < 0 || 2 * max_lag > block || (block & (block - 1)))
+		return -EINVAL;
+
+	memset(xc, 0, sizeof(*xc));
+	xc->max_lag = max_lag;
+	xc->block = block;
+	xc->bins = block + 1;
+	xc->plan = fft_real_plan_new(2 * block);
+	if (!xc->plan)
+		return -EINVAL;
+
+	xc->x = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			sizeof(int16_t) * (2 * max_lag + block));
+	xc->y = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			sizeof(int16_t) * (max_lag + block));
+	xc->time = rballoc(0, SOF_MEM_CAPS_RAM, sizeof(int32_t) * 2 * block);
+	xc->x_spec = rballoc(0, SOF_MEM_CAPS_RAM, sizeof(struct icomplex32) * xc->bins);
+	xc->y_spec = rballoc(0, SOF_MEM_CAPS_RAM, sizeof(struct icomplex32) * xc->bins);
+	xc->acc = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			  sizeof(int64_t) * 2 * xc->bins);
+	if (!xc->x || !xc->y || !xc->time || !xc->x_spec || !xc->y_spec || !xc->acc) {
+		sofm_xcorr_fft_16_free(xc);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+void sofm_xcorr_fft_16_free(struct sofm_xcorr_fft_16 *xc)
+{
+	fft_real_plan_free(xc->plan);
+	rfree(xc->x);
+	rfree(xc->y);
+	rfree(xc->time);
+	rfree(xc->x_spec);
+	rfree(xc->y_spec);
+	rfree(xc->acc);
+	memset(xc, 0, sizeof(*xc));
+}
+
+void sofm_xcorr_fft_16_reset(struct sofm_xcorr_fft_16 *xc)
+{
+	memset(xc->acc, 0, sizeof(int64_t) * 2 * xc->bins);
+}
+
+static void xcorr_fft_spectrum(struct sofm_xcorr_fft_16 *xc, const int16_t *in, int n,
+			       struct icomplex32 *spec)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		xc->time[i] = (int32_t)in[i] << 16;
+
+	for (; i < 2 * xc->block; i++)
+		xc->time[i] = 0;
+
+	fft_real_execute_32(xc->plan, xc->time, spec);
+}
+
+/* Accumulate X * conj(Y) in Q1.31 of a complete block */
+static void xcorr_fft_block(struct sofm_xcorr_fft_16 *xc)
+{
+	const struct icomplex32 *sx = xc->x_spec;
+	const struct icomplex32 *sy = xc->y_spec;
+	int64_t *acc = xc->acc;
+	int k;
+
+	xcorr_fft_spectrum(xc, xc->x, xc->block + 2 * xc->max_lag, xc->x_spec);
+	xcorr_fft_spectrum(xc, xc->y, xc->block, xc->y_spec);
+	for (k = 0; k < xc->bins; k++) {
+		acc[0] += (((int64_t)sx->real * sy->real >> 1) +
+			   ((int64_t)sx->imag * sy->imag >> 1)) >> 30;
+		acc[1] += (((int64_t)sx->imag * sy->real >> 1) -
+			   ((int64_t)sx->real * sy->imag >> 1)) >> 30;
+		acc += 2;
+		sx++;
+		sy++;
+	}
+}
+
+void sofm_xcorr_fft_16_process(struct sofm_xcorr_fft_16 *xc, const int16_t *x,
+			       const int16_t *y, int stride, int frames)
+{
+	const int max_lag = xc->max_lag;
+	int n;
+
+	while (frames) {
+		n = MIN(frames, xc->block - xc->fill);
+		xcorr_copy_in(&xc->x[2 * max_lag + xc->fill], x, stride, n);
+		xcorr_copy_in(&xc->y[max_lag + xc->fill], y, stride, n);
+		x += n * stride;
+		y += n * stride;
+		frames -= n;
+		xc->fill += n;
+		if (xc->fill < xc->block)
+			break;
+
+		xcorr_fft_block(xc);
+		memmove(xc->x, &xc->x[xc->block], sizeof(int16_t) * 2 * max_lag);
+		memmove(xc->y, &xc->y[xc->block], sizeof(int16_t) * max_lag);
+		xc->fill = 0;
+	}
+}
+
+static int64_t xcorr_shift64(int64_t v, int shift)
+{
+	return shift >= 0 ? v << shift : v >> -shift;
+}
+
+void sofm_xcorr_fft_16_get(struct sofm_xcorr_fft_16 *xc, int64_t *r)
+{
+	const int len = xc->plan->len;
+	const int n = 2 * xc->bins;
+	int64_t max_abs = 0;
+	int64_t v;
+	int msb = 0;
+	int shift;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		v = xc->acc[i] < 0 ? -xc->acc[i] : xc->acc[i];
+		if (v > max_abs)
+			max_abs = v;
+	}
+
+	if (!max_abs) {
+		memset(r, 0, sizeof(int64_t) * (2 * xc->max_lag + 1));
+		return;
+	}
+
+	/* Scale the largest value to 2^(30 - len) so that the sum of the N bins
+	 * of the inverse transform can't exceed Q1.31.
+	 */
+	while (max_abs >> (msb + 1))
+		msb++;
+
+	shift = msb + len - 30;
+	for (i = 0; i < xc->bins; i++) {
+		xc->x_spec[i].real = xcorr_shift64(xc->acc[2 * i], -shift);
+		xc->x_spec[i].imag = xcorr_shift64(xc->acc[2 * i + 1], -shift);
+	}
+
+	fft_real_inverse_32(xc->plan, xc->x_spec, xc->time);
+
+	/* The product sum of the 16 bit samples is N / 2 times the inverse
+	 * transform of the Q1.31 cross spectrum.
+	 */
+	for (i = 0; i <= 2 * xc->max_lag; i++)
+		r[i] = xcorr_shift64(xc->time[i], shift + len - 1);
+}
+
+#endif /* CONFIG_MATH_FFT && CONFIG_MATH_32BIT_FFT */
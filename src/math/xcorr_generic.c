@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/math/xcorr.h>
+#include <stdint.h>
+
+#if SOFM_XCORR_GENERIC
+
+void sofm_xcorr_acc_16(const int16_t *x, const int16_t *y, int n, int max_lag, int64_t *r)
+{
+	const int16_t *xk;
+	int64_t acc;
+	int k;
+	int i;
+
+	for (k = -max_lag; k <= max_lag; k++) {
+		xk = x + k;
+		acc = 0;
+		for (i = 0; i < n; i++)
+			acc += (int32_t)xk[i] * y[i];
+
+		r[k + max_lag] += acc;
+	}
+}
+
+#endif /* SOFM_XCORR_GENERIC */
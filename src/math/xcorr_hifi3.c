@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/math/xcorr.h>
+#include <stdint.h>
+
+#if SOFM_XCORR_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/* Four products per instruction are summed to the 64 bit accumulator. The
+ * lagged x is not aligned to 64 bits, so both signals are read with the
+ * unaligned loads.
+ */
+void sofm_xcorr_acc_16(const int16_t *x, const int16_t *y, int n, int max_lag, int64_t *r)
+{
+	ae_int16x4 *xp;
+	ae_int16x4 *yp;
+	ae_int16x4 x4;
+	ae_int16x4 y4;
+	ae_valign xu;
+	ae_valign yu;
+	ae_int64 acc;
+	ae_int64 *rp = (ae_int64 *)r;
+	const int16_t *xt;
+	const int16_t *yt;
+	int64_t tail;
+	int k;
+	int i;
+
+	for (k = -max_lag; k <= max_lag; k++) {
+		xp = (ae_int16x4 *)(x + k);
+		yp = (ae_int16x4 *)y;
+		xu = AE_LA64_PP(xp);
+		yu = AE_LA64_PP(yp);
+		acc = AE_ZERO64();
+		for (i = 0; i < (n >> 2); i++) {
+			AE_LA16X4_IP(x4, xu, xp);
+			AE_LA16X4_IP(y4, yu, yp);
+			AE_MULAAAAQ16(acc, x4, y4);
+		}
+
+		xt = (const int16_t *)xp;
+		yt = (const int16_t *)yp;
+		tail = 0;
+		for (i = 0; i < (n & 3); i++)
+			tail += (int32_t)xt[i] * yt[i];
+
+		*rp = AE_ADD64(*rp, AE_ADD64(acc, tail));
+		rp++;
+	}
+}
+
+#endif /* SOFM_XCORR_HIFI3 */
@@ -17,6 +17,9 @@
 #define DMIC_SETTLING_TIME_MS 360
 #define DMIC_SMOOTH_TIME_MS 40
 
+/* The ring interrupts at half, every CONFIG_AMD_DMIC_PERIODS_PER_IRQ periods */
+#define ACP_DMIC_DMA_BUFFER_PERIOD_COUNT (2 * CONFIG_AMD_DMIC_PERIODS_PER_IRQ)
+
 struct acp_dmic_silence {
 	uint32_t bytes_per_sample;
 	uint32_t num_chs;
@@ -194,6 +194,7 @@ int platform_init(struct sof *sof)
 
 	/* i.MX platform DMA domain will be full synchronous, no time dependent */
 	sof->platform_dma_domain->full_sync = true;
+	sof->platform_dma_domain->periods_per_tick = CONFIG_IMX_DMA_PERIODS_PER_IRQ;
 	scheduler_init_ll(sof->platform_dma_domain);
 
 	/* initialize the host IPC mechanims */
@@ -104,6 +104,13 @@ int platform_init(struct sof *sof)
 	if (ret < 0)
 		return ret;
 
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	sof->platform_fast_domain = zephyr_fast_domain_init(PLATFORM_DEFAULT_CLOCK);
+	ret = scheduler_init_ll(sof->platform_fast_domain);
+	if (ret < 0)
+		return ret;
+#endif
+
 #if CONFIG_ZEPHYR_DP_SCHEDULER
 	ret = scheduler_dp_init();
 	if (ret < 0)
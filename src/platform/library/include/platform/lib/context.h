@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __PLATFORM_LIB_CONTEXT_H__
+#define __PLATFORM_LIB_CONTEXT_H__
+
+#include <rtos/alloc.h>
+#include <rtos/sof.h>
+#include <sof/list.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct notify;
+struct schedulers;
+
+/**
+ * \brief State of one SOF instance of the library.
+ *
+ * sof_get(), the schedulers, the notifier, the LL task list and the
+ * mailbox of the library all come from the context of the calling thread.
+ * Threads that never set a context use the default one, which is the only
+ * context of single instance builds.
+ */
+struct sof_lib_context {
+	struct sof sof;
+	struct schedulers *schedulers;
+	struct notify *notify;
+	struct list_item ll_tasks;	/* LL tasks, run by schedule_ll_run_tasks() */
+	uint8_t *mailbox;		/* NULL for the default mailbox */
+	size_t alloc_bytes;		/* bytes held by rmalloc() and friends */
+	size_t alloc_limit;		/* allocation budget, 0 for none */
+};
+
+/**
+ * \brief Returns the context of the calling thread.
+ */
+struct sof_lib_context *sof_lib_context_get(void);
+
+#if CONFIG_LIBRARY_MULTI_INSTANCE
+/**
+ * \brief Creates an empty context.
+ * @param alloc_limit Bytes the context may allocate, 0 for no limit.
+ * @return New context or NULL.
+ *
+ * The context becomes usable once a thread has made it its own with
+ * sof_lib_context_set() and has run the usual initialization, such as
+ * sys_comp_init(), the component driver inits, ipc_init() and the
+ * scheduler inits, exactly as for the default context.
+ */
+struct sof_lib_context *sof_lib_context_new(size_t alloc_limit);
+
+/**
+ * \brief Frees a context, its pipelines must have been freed first.
+ */
+void sof_lib_context_free(struct sof_lib_context *ctx);
+
+/**
+ * \brief Makes ctx the context of the calling thread.
+ * @param ctx Context, NULL for the default one.
+ * @return Previous context of the thread.
+ *
+ * A context must only be used by one thread at a time.
+ */
+struct sof_lib_context *sof_lib_context_set(struct sof_lib_context *ctx);
+#endif
+
+/**
+ * \brief Hooks called on every successful rmalloc(), rzalloc(),
+ *	  rballoc(), rbrealloc() and rfree(), for the tools to profile
+ *	  memory use.
+ *
+ * A reallocation reports the old block, still held at that point, with
+ * the new pointer and size. A failed reallocation is not reported, the old
+ * block stays in use. The hooks are called from the
+ * allocating thread, they must not allocate with rmalloc() themselves.
+ */
+struct lib_alloc_observer {
+	void (*alloc)(void *ptr, size_t bytes, enum mem_zone zone);
+	void (*realloc)(void *old_ptr, void *ptr, size_t bytes);
+	void (*free)(void *ptr);
+};
+
+/**
+ * \brief Sets the allocation observer of the whole process.
+ * @param observer Hooks, NULL to stop observing.
+ */
+void lib_alloc_observer_set(const struct lib_alloc_observer *observer);
+
+/* platform.c */
+uint8_t *library_mailbox_alloc(void);
+
+#endif /* __PLATFORM_LIB_CONTEXT_H__ */
@@ -1,12 +1,68 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <rtos/sof.h>
+#include <platform/lib/context.h>
 #include <stdlib.h>
 
 /* main firmware context */
-static struct sof sof;
+static struct sof_lib_context default_ctx;
+
+#if CONFIG_LIBRARY_MULTI_INSTANCE
+/* context of the calling thread, NULL for the default one */
+static __thread struct sof_lib_context *thread_ctx;
+
+struct sof_lib_context *sof_lib_context_get(void)
+{
+	return thread_ctx ? thread_ctx : &default_ctx;
+}
+
+struct sof_lib_context *sof_lib_context_new(size_t alloc_limit)
+{
+	struct sof_lib_context *ctx;
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (!ctx)
+		return NULL;
+
+	ctx->mailbox = library_mailbox_alloc();
+	if (!ctx->mailbox) {
+		free(ctx);
+		return NULL;
+	}
+
+	ctx->alloc_limit = alloc_limit;
+
+	return ctx;
+}
+
+void sof_lib_context_free(struct sof_lib_context *ctx)
+{
+	if (!ctx || ctx == &default_ctx)
+		return;
+
+	if (thread_ctx == ctx)
+		thread_ctx = NULL;
+
+	free(ctx->mailbox);
+	free(ctx);
+}
+
+struct sof_lib_context *sof_lib_context_set(struct sof_lib_context *ctx)
+{
+	struct sof_lib_context *prev = sof_lib_context_get();
+
+	thread_ctx = ctx == &default_ctx ? NULL : ctx;
+
+	return prev;
+}
+#else
+struct sof_lib_context *sof_lib_context_get(void)
+{
+	return &default_ctx;
+}
+#endif
 
 struct sof *sof_get()
 {
-	return &sof;
+	return &sof_lib_context_get()->sof;
 }
@@ -10,37 +10,116 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <malloc.h>
 #include <rtos/alloc.h>
 #include <sof/lib/mm_heap.h>
+#include <sof/math/numbers.h>
+#include <platform/lib/context.h>
+#include <stdbool.h>
 
 /* testbench mem alloc definition */
 
+/*
+ * Each context accounts for the memory it holds and may have a budget. The
+ * memory itself comes from malloc(), the tools free some of it with free().
+ */
+static const struct lib_alloc_observer *alloc_observer;
+
+void lib_alloc_observer_set(const struct lib_alloc_observer *observer)
+{
+	alloc_observer = observer;
+}
+
+static void *alloc_notify(void *ptr, size_t bytes, enum mem_zone zone)
+{
+	if (ptr && alloc_observer)
+		alloc_observer->alloc(ptr, bytes, zone);
+
+	return ptr;
+}
+
+static bool alloc_fits(struct sof_lib_context *ctx, size_t bytes)
+{
+	return !ctx->alloc_limit || ctx->alloc_bytes + bytes <= ctx->alloc_limit;
+}
+
+static void *alloc_account(struct sof_lib_context *ctx, void *ptr)
+{
+	ctx->alloc_bytes += malloc_usable_size(ptr);
+
+	return ptr;
+}
+
+static void alloc_release(struct sof_lib_context *ctx, size_t bytes)
+{
+	/* freed by another context than the one that allocated it */
+	ctx->alloc_bytes = bytes < ctx->alloc_bytes ? ctx->alloc_bytes - bytes : 0;
+}
+
 void *rmalloc(enum mem_zone zone, uint32_t flags, uint32_t caps, size_t bytes)
 {
-	return malloc(bytes);
+	struct sof_lib_context *ctx = sof_lib_context_get();
+
+	if (!alloc_fits(ctx, bytes))
+		return NULL;
+
+	return alloc_notify(alloc_account(ctx, malloc(bytes)), bytes, zone);
 }
 
 void *rzalloc(enum mem_zone zone, uint32_t flags, uint32_t caps, size_t bytes)
 {
-	return calloc(bytes, 1);
+	struct sof_lib_context *ctx = sof_lib_context_get();
+
+	if (!alloc_fits(ctx, bytes))
+		return NULL;
+
+	return alloc_notify(alloc_account(ctx, calloc(bytes, 1)), bytes, zone);
 }
 
 void rfree(void *ptr)
 {
+	if (ptr && alloc_observer)
+		alloc_observer->free(ptr);
+
+	alloc_release(sof_lib_context_get(), malloc_usable_size(ptr));
 	free(ptr);
 }
 
 void *rballoc_align(uint32_t flags, uint32_t caps, size_t bytes,
 		    uint32_t alignment)
 {
-	return malloc(bytes);
+	return rmalloc(SOF_MEM_ZONE_BUFFER, flags, caps, bytes);
 }
 
 void *rbrealloc_align(void *ptr, uint32_t flags, uint32_t caps, size_t bytes,
 		      size_t old_bytes, uint32_t alignment)
 {
-	return realloc(ptr, bytes);
+	struct sof_lib_context *ctx = sof_lib_context_get();
+	size_t old_size = malloc_usable_size(ptr);
+	void *new_ptr;
+
+	/* ptr stays valid when the new size does not fit the budget */
+	if (bytes > old_size && !alloc_fits(ctx, bytes - old_size))
+		return NULL;
+
+	if (!ptr)
+		return alloc_notify(alloc_account(ctx, malloc(bytes)), bytes,
+				    SOF_MEM_ZONE_BUFFER);
+
+	/* copied like the firmware does, the old block is reported while held */
+	new_ptr = malloc(bytes);
+	if (!new_ptr)
+		return NULL;
+
+	memcpy(new_ptr, ptr, MIN(bytes, old_bytes));
+	if (alloc_observer)
+		alloc_observer->realloc(ptr, new_ptr, bytes);
+
+	alloc_release(ctx, old_size);
+	free(ptr);
+
+	return alloc_account(ctx, new_ptr);
 }
 
 void heap_trace(struct mm_heap *heap, int size)
@@ -12,21 +12,32 @@
 #include <sof/schedule/ll_schedule_domain.h>
 #include <sof/lib/mailbox.h>
 #include <sof/lib/dai.h>
+#include <platform/lib/context.h>
+#include <stdlib.h>
 
 #ifndef __ZEPHYR__
 static SHARED_DATA struct timer timer = {};
 #endif /* __ZEPHYR__ */
 
-static uint8_t mailbox[MAILBOX_DSPBOX_SIZE +
-		       MAILBOX_HOSTBOX_SIZE +
-		       MAILBOX_EXCEPTION_SIZE +
-		       MAILBOX_DEBUG_SIZE +
-		       MAILBOX_STREAM_SIZE +
-		       MAILBOX_TRACE_SIZE];
+#define LIBRARY_MAILBOX_SIZE	(MAILBOX_DSPBOX_SIZE +		\
+				 MAILBOX_HOSTBOX_SIZE +		\
+				 MAILBOX_EXCEPTION_SIZE +	\
+				 MAILBOX_DEBUG_SIZE +		\
+				 MAILBOX_STREAM_SIZE +		\
+				 MAILBOX_TRACE_SIZE)
+
+static uint8_t mailbox[LIBRARY_MAILBOX_SIZE];
 
 uint8_t *get_library_mailbox()
 {
-	return mailbox;
+	uint8_t *ctx_mailbox = sof_lib_context_get()->mailbox;
+
+	return ctx_mailbox ? ctx_mailbox : mailbox;
+}
+
+uint8_t *library_mailbox_alloc(void)
+{
+	return calloc(1, LIBRARY_MAILBOX_SIZE);
 }
 
 static void platform_clock_init(struct sof *sof) {}
@@ -12,6 +12,7 @@
 #include <platform/lib/ll_schedule.h>
 #include <sof/schedule/ll_schedule_domain.h>
 #include <rtos/wait.h>
+#include <platform/lib/context.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -26,20 +27,18 @@ DECLARE_SOF_UUID("ll-schedule", ll_sched_uuid, 0x77de2074, 0x828c, 0x4044,
 
 DECLARE_TR_CTX(ll_tr, SOF_UUID(ll_sched_uuid), LOG_LEVEL_INFO);
 
-/* list of all tasks */
-static struct list_item sched_list;
-
 void schedule_ll_run_tasks(void)
 {
+	struct list_item *sched_list = &sof_lib_context_get()->ll_tasks;
 	struct list_item *tlist, *tlist_;
 	struct task *task;
 
 	/* list empty then return */
-	if (list_is_empty(&sched_list))
+	if (list_is_empty(sched_list))
 		fprintf(stdout, "LL scheduler thread exit - list empty\n");
 
 	/* iterate through the task list */
-	list_for_item_safe(tlist, tlist_, &sched_list) {
+	list_for_item_safe(tlist, tlist_, sched_list) {
 		task = container_of(tlist, struct task, list);
 
 		/* only run queued tasks */
@@ -61,7 +60,7 @@ static int schedule_ll_task(void *data, struct task *task, uint64_t start,
 			    uint64_t period)
 {
 	/* add task to list */
-	list_item_prepend(&task->list, &sched_list);
+	list_item_prepend(&task->list, &sof_lib_context_get()->ll_tasks);
 	task->state = SOF_TASK_STATE_QUEUED;
 	task->start = 0;
 
@@ -115,7 +114,7 @@ int scheduler_init_ll(struct ll_schedule_domain *domain)
 {
 	tr_info(&ll_tr, "ll_scheduler_init()");
 
-	list_init(&sched_list);
+	list_init(&sof_lib_context_get()->ll_tasks);
 	scheduler_init(SOF_SCHEDULE_LL_TIMER, &schedule_ll_ops, NULL);
 
 	return 0;
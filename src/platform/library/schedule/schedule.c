@@ -11,13 +11,12 @@
 #include <rtos/task.h>
 #include <stdint.h>
 #include <rtos/wait.h>
+#include <platform/lib/context.h>
 #include <stdlib.h>
 
-static struct schedulers *testbench_schedulers_ptr; /* Initialized as NULL */
-
 struct schedulers **arch_schedulers_get(void)
 {
-	return &testbench_schedulers_ptr;
+	return &sof_lib_context_get()->schedulers;
 }
 
 int schedule_task_init(struct task *task,
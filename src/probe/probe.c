@@ -12,6 +12,7 @@
 #include <user/trace.h>
 #include <rtos/alloc.h>
 #include <rtos/init.h>
+#include <rtos/interrupt.h>
 #include <sof/lib/dma.h>
 #include <sof/lib/notifier.h>
 #include <sof/lib/uuid.h>
@@ -67,6 +68,26 @@ struct probe_dma_buf {
 	uint32_t avail;		/**< buffer avail data */
 };
 
+#if CONFIG_PROBE_INJECT_STAGED
+/**
+ * Injection DMA buffer consumed as two blocks, the host fills one block
+ * while the other one is injected
+ */
+struct probe_inject_stage {
+	uint32_t block_size;	/**< bytes of one block, half of DMA buffer */
+	uint32_t block_read;	/**< bytes consumed from current block */
+	bool block_ready;	/**< current block received and invalidated */
+	uint32_t channels;	/**< host channels, 0 for probed buffer format */
+	uint32_t container;	/**< host sample container bytes */
+	uint32_t valid;		/**< host sample valid bytes */
+	uint32_t frame_ch;	/**< samples of current host frame received */
+	uint32_t skip;		/**< bytes of interrupted host frame to drop */
+	uint32_t underruns;	/**< transactions concealed */
+	int32_t frame[PLATFORM_MAX_CHANNELS];	/**< current host frame, Q1.31 */
+	int32_t last[PLATFORM_MAX_CHANNELS];	/**< last injected frame, Q1.31 */
+};
+#endif
+
 /**
  * Probe DMA
  */
@@ -76,7 +97,37 @@ struct probe_dma_ext {
 	struct dma_sg_config config;	/**< DMA SG config */
 	struct probe_dma_buf dmapb;	/**< DMA buffer pointer */
 	struct dma_copy dc;		/**< DMA copy */
+#if CONFIG_PROBE_INJECT_STAGED
+	struct probe_inject_stage stage; /**< injection blocks and format */
+#endif
+};
+
+#if CONFIG_PROBE_EXTRACT_REDUCE
+/**
+ * Extraction data reduction of a probe point
+ */
+struct probe_extract_cfg {
+	uint32_t channel_mask;	/**< channels to be extracted, 0 for all */
+	uint32_t decimation;	/**< extract every n-th frame */
+	uint32_t sample_bytes;	/**< most significant bytes kept, 0 for all */
+	uint32_t compression;	/**< PROBE_COMPRESSION_xxx */
+	uint32_t phase;		/**< frames to be skipped before next extracted one */
+};
+#endif
+
+#if CONFIG_PROBE_DEFERRED_TAP
+/**
+ * Region of a probed buffer, copied later by the probe task
+ */
+struct probe_tap_desc {
+	struct comp_buffer *buffer;	/**< probed buffer, NULL if dropped */
+	void *begin;			/**< produced data */
+	uint32_t amount;		/**< produced bytes */
+	uint32_t point;			/**< probe point index */
+	uint64_t position;		/**< bytes produced to buffer before region */
+	uint64_t timestamp;		/**< time of production */
 };
+#endif
 
 /**
  * Probe main struct
@@ -87,6 +138,17 @@ struct probe_pdata {
 	struct probe_point probe_points[CONFIG_PROBE_POINTS_MAX]; /**< probe points */
 	struct probe_data_packet header;			  /**< data packet header */
 	struct task dmap_work;					  /**< probe task */
+#if CONFIG_PROBE_EXTRACT_REDUCE
+	struct probe_extract_cfg ext_cfg[CONFIG_PROBE_POINTS_MAX]; /**< data reduction */
+	uint8_t ext_scratch[CONFIG_PROBE_EXTRACT_SCRATCH_SIZE];	  /**< reduced data */
+#endif
+#if CONFIG_PROBE_DEFERRED_TAP
+	struct probe_tap_desc tap_desc[CONFIG_PROBE_TAP_DESC_COUNT]; /**< pending regions */
+	uint32_t tap_first;					  /**< oldest pending region */
+	uint32_t tap_count;					  /**< pending regions */
+	uint32_t tap_overruns;					  /**< regions lost */
+	uint64_t tap_produced[CONFIG_PROBE_POINTS_MAX];		  /**< bytes produced */
+#endif
 };
 
 /**
@@ -285,6 +347,10 @@ static int probe_dma_deinit(struct probe_dma_ext *dma)
 	return 0;
 }
 
+#if CONFIG_PROBE_DEFERRED_TAP
+static void probe_tap_drain(struct probe_pdata *_probe);
+#endif
+
 /*
  * \brief Probe task for extraction.
  *
@@ -297,6 +363,9 @@ static enum task_state probe_task(void *data)
 	uint32_t copy_align, avail;
 	int err;
 
+#if CONFIG_PROBE_DEFERRED_TAP
+	probe_tap_drain(_probe);
+#endif
 	if (!_probe->ext_dma.dmapb.avail)
 		return SOF_TASK_STATE_RESCHEDULE;
 #if CONFIG_ZEPHYR_NATIVE_DRIVERS
@@ -393,7 +462,7 @@ int probe_init(const struct probe_dma *probe_dma)
 		schedule_task_init_ll(&_probe->dmap_work,
 				      SOF_UUID(probe_task_uuid),
 				      SOF_SCHEDULE_LL_TIMER, SOF_TASK_PRI_LOW,
-				      probe_task, _probe, 0, 0);
+				      probe_task, _probe, 0, SOF_SCHEDULE_TASK_NON_CRITICAL);
 	} else {
 		tr_dbg(&pr_tr, "\tno extraction DMA setup");
 
@@ -518,6 +587,12 @@ int probe_dma_add(uint32_t count, const struct probe_dma *probe_dma)
 				PROBE_DMA_INVALID;
 			return err;
 		}
+#if CONFIG_PROBE_INJECT_STAGED
+		bzero(&_probe->inject_dma[first_free].stage,
+		      sizeof(_probe->inject_dma[first_free].stage));
+		_probe->inject_dma[first_free].stage.block_size =
+			_probe->inject_dma[first_free].dmapb.size / 2;
+#endif
 	}
 
 	return 0;
@@ -575,6 +650,58 @@ int probe_dma_remove(uint32_t count, const uint32_t *stream_tag)
 	return 0;
 }
 
+#if CONFIG_PROBE_INJECT_STAGED
+int probe_dma_set_format(uint32_t count, const struct probe_injection_format *fmts)
+{
+	struct probe_pdata *_probe = probe_get();
+	struct probe_inject_stage *stage;
+	uint32_t i;
+	uint32_t j;
+
+	tr_dbg(&pr_tr, "probe_dma_set_format() count = %u", count);
+
+	if (!_probe) {
+		tr_err(&pr_tr, "probe_dma_set_format(): Not initialized.");
+
+		return -EINVAL;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (fmts[i].channels > PLATFORM_MAX_CHANNELS ||
+		    (fmts[i].channels &&
+		     (fmts[i].container_bytes != 2 && fmts[i].container_bytes != 4)) ||
+		    (fmts[i].channels &&
+		     (fmts[i].valid_bytes < 2 || fmts[i].valid_bytes > fmts[i].container_bytes))) {
+			tr_err(&pr_tr, "probe_dma_set_format(): invalid format for DMA %u",
+			       fmts[i].stream_tag);
+
+			return -EINVAL;
+		}
+
+		for (j = 0; j < CONFIG_PROBE_DMA_MAX; j++)
+			if (_probe->inject_dma[j].stream_tag != PROBE_DMA_INVALID &&
+			    _probe->inject_dma[j].stream_tag == fmts[i].stream_tag)
+				break;
+
+		if (j == CONFIG_PROBE_DMA_MAX) {
+			tr_err(&pr_tr, "probe_dma_set_format(): no injection DMA %u",
+			       fmts[i].stream_tag);
+
+			return -EINVAL;
+		}
+
+		stage = &_probe->inject_dma[j].stage;
+		stage->channels = fmts[i].channels;
+		stage->container = fmts[i].container_bytes;
+		stage->valid = fmts[i].valid_bytes;
+		stage->frame_ch = 0;
+		stage->skip = 0;
+	}
+
+	return 0;
+}
+#endif
+
 /**
  * \brief Copy data to probe buffer and update buffer pointers.
  * \param[out] pbuf DMA buffer.
@@ -630,6 +757,7 @@ static int copy_to_pbuffer(struct probe_dma_buf *pbuf, void *data,
 	return 0;
 }
 
+#if !CONFIG_PROBE_INJECT_STAGED
 /**
  * \brief Copy data from probe buffer and update buffer pointers.
  * \param[out] pbuf DMA buffer.
@@ -686,6 +814,7 @@ static int copy_from_pbuffer(struct probe_dma_buf *pbuf, void *data,
 
 	return 0;
 }
+#endif
 
 /**
  * \brief Generate probe data packet header, update timestamp, calc crc
@@ -693,18 +822,17 @@ static int copy_from_pbuffer(struct probe_dma_buf *pbuf, void *data,
  * \param[in] buffer_id component buffer id
  * \param[in] size data size.
  * \param[in] format audio format.
+ * \param[in] timestamp of data capture.
  * \param[out] checksum.
  * \return 0 on success, error code otherwise.
  */
 static int probe_gen_header(uint32_t buffer_id, uint32_t size,
-			    uint32_t format, uint64_t *checksum)
+			    uint32_t format, uint64_t timestamp, uint64_t *checksum)
 {
 	struct probe_pdata *_probe = probe_get();
 	struct probe_data_packet *header;
-	uint64_t timestamp;
 
 	header = &_probe->header;
-	timestamp = sof_cycle_get_64();
 
 	header->sync_word = PROBE_EXTRACT_SYNC_WORD;
 	header->buffer_id = buffer_id;
@@ -847,7 +975,8 @@ void probe_logging_hook(uint8_t *buffer, size_t length)
 	uint64_t checksum;
 	int ret;
 
-	ret = probe_gen_header(PROBE_LOGGING_BUFFER_ID, length, 0, &checksum);
+	ret = probe_gen_header(PROBE_LOGGING_BUFFER_ID, length, 0, sof_cycle_get_64(),
+			       &checksum);
 	if (ret < 0)
 		return;
 
@@ -865,6 +994,806 @@ void probe_logging_hook(uint8_t *buffer, size_t length)
 }
 #endif
 
+#if CONFIG_PROBE_IPC_RECORD
+void probe_ipc_record(uint32_t primary, uint32_t extension, const void *payload,
+		      uint32_t size)
+{
+	struct probe_pdata *_probe = probe_get();
+	struct probe_ipc_record record;
+	struct probe_dma_buf *pbuf;
+	uint32_t flags;
+	uint64_t checksum;
+	int i;
+
+	if (!_probe || _probe->ext_dma.stream_tag == PROBE_DMA_INVALID)
+		return;
+
+	for (i = 0; i < CONFIG_PROBE_POINTS_MAX; i++)
+		if (_probe->probe_points[i].stream_tag != PROBE_POINT_INVALID &&
+		    _probe->probe_points[i].purpose == PROBE_PURPOSE_EXTRACTION)
+			break;
+
+	if (i == CONFIG_PROBE_POINTS_MAX)
+		return;
+
+	pbuf = &_probe->ext_dma.dmapb;
+	record.primary = primary;
+	record.extension = extension;
+	record.payload_size = MIN(size, CONFIG_PROBE_IPC_RECORD_PAYLOAD);
+
+	/* don't let probed buffers interleave their packets with the record */
+	irq_local_disable(flags);
+
+	/* drop the whole record rather than send a truncated packet */
+	if (pbuf->size - pbuf->avail < sizeof(struct probe_data_packet) + sizeof(record) +
+	    record.payload_size + sizeof(checksum)) {
+		irq_local_enable(flags);
+		tr_warn(&pr_tr, "probe_ipc_record(): no room for %#x|%#x", primary, extension);
+		return;
+	}
+
+	probe_gen_header(PROBE_IPC_BUFFER_ID, sizeof(record) + record.payload_size, 0,
+			 sof_cycle_get_64(), &checksum);
+	copy_to_pbuffer(pbuf, &record, sizeof(record));
+	copy_to_pbuffer(pbuf, (void *)payload, record.payload_size);
+	copy_to_pbuffer(pbuf, &checksum, sizeof(checksum));
+
+	irq_local_enable(flags);
+
+	kick_probe_task(_probe);
+}
+#endif
+
+#if CONFIG_PROBE_EXTRACT_REDUCE
+static bool probe_extract_is_reduced(const struct probe_extract_cfg *cfg)
+{
+	return cfg->channel_mask || cfg->decimation > 1 || cfg->sample_bytes ||
+	       cfg->compression != PROBE_COMPRESSION_NONE;
+}
+
+/**
+ * \brief Send reduced data prepared in scratch buffer as one data packet.
+ * \param[in] buffer_id component buffer id
+ * \param[in] format encoded data format.
+ * \param[in] size data size.
+ * \param[in] timestamp of data capture.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_extract_packet(uint32_t buffer_id, uint32_t format, uint32_t size,
+				uint64_t timestamp)
+{
+	struct probe_pdata *_probe = probe_get();
+	uint64_t checksum;
+	int ret;
+
+	ret = probe_gen_header(buffer_id, size, format, timestamp, &checksum);
+	if (ret < 0)
+		return ret;
+
+	ret = copy_to_pbuffer(&_probe->ext_dma.dmapb, _probe->ext_scratch, size);
+	if (ret < 0)
+		return ret;
+
+	return copy_to_pbuffer(&_probe->ext_dma.dmapb, &checksum, sizeof(checksum));
+}
+
+/* zigzag map the delta so small negative values get short varints too */
+static uint8_t *probe_extract_put_delta(uint8_t *dst, uint32_t delta)
+{
+	uint32_t zz = (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+
+	while (zz >= 0x80) {
+		*dst++ = (zz & 0x7f) | 0x80;
+		zz >>= 7;
+	}
+	*dst++ = zz;
+
+	return dst;
+}
+
+/**
+ * \brief Extract channel subset of every n-th frame, truncated and compressed
+ *	  as configured for the probe point. Transaction is sent as several data
+ *	  packets if reduced data does not fit in the scratch buffer.
+ * \param[in,out] cfg data reduction of the probe point.
+ * \param[in] buffer_id component buffer id
+ * \param[in] stream probed audio stream.
+ * \param[in] cb_data produce transaction.
+ * \param[in] timestamp of data capture.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_extract_reduced(struct probe_extract_cfg *cfg, uint32_t buffer_id,
+				 const struct audio_stream *stream,
+				 const struct buffer_cb_transact *cb_data, uint64_t timestamp)
+{
+	struct probe_pdata *_probe = probe_get();
+	enum sof_ipc_frame frame_fmt = audio_stream_get_frm_fmt(stream);
+	uint32_t channels = audio_stream_get_channels(stream);
+	uint32_t container = audio_stream_sample_bytes(stream);
+	uint32_t frames = cb_data->transaction_amount / audio_stream_frame_bytes(stream);
+	uint32_t all_mask = channels < 32 ? BIT(channels) - 1 : UINT32_MAX;
+	uint32_t ch_mask = cfg->channel_mask & all_mask;
+	uint32_t valid_bytes = container;
+	uint32_t out_bytes = container;
+	uint32_t lshift = 0;
+	uint32_t rshift = 0;
+	uint32_t prev[PLATFORM_MAX_CHANNELS] = { 0 };
+	uint32_t max_frame_bytes;
+	uint32_t chunk_frames;
+	uint32_t out_frames = 0;
+	uint32_t format;
+	uint8_t *src = cb_data->transaction_begin_address;
+	uint8_t *dst = _probe->ext_scratch;
+	uint32_t frame, ch, b;
+	int32_t sample;
+	int ret;
+
+	if (channels > PLATFORM_MAX_CHANNELS)
+		return -EINVAL;
+
+	if (!ch_mask)
+		ch_mask = all_mask;
+
+	if (frame_fmt == SOF_IPC_FRAME_S24_4LE)
+		valid_bytes = 3;
+
+	/* keep most significant bytes, float samples are never truncated */
+	if (cfg->sample_bytes && cfg->sample_bytes < valid_bytes &&
+	    frame_fmt != SOF_IPC_FRAME_FLOAT) {
+		out_bytes = cfg->sample_bytes;
+		lshift = 32 - 8 * valid_bytes;
+		rshift = 32 - 8 * out_bytes;
+	}
+
+	format = probe_gen_format(frame_fmt, audio_stream_get_rate(stream), popcount(ch_mask));
+	if (out_bytes != container) {
+		format &= ~(PROBE_MASK_SAMPLE_SIZE | PROBE_MASK_CONTAINER_SIZE);
+		format |= ((out_bytes - 1) << PROBE_SHIFT_SAMPLE_SIZE) & PROBE_MASK_SAMPLE_SIZE;
+		format |= ((out_bytes - 1) << PROBE_SHIFT_CONTAINER_SIZE) &
+			  PROBE_MASK_CONTAINER_SIZE;
+	}
+	format |= ((cfg->decimation - 1) << PROBE_SHIFT_DECIMATION) & PROBE_MASK_DECIMATION;
+	if (cfg->compression == PROBE_COMPRESSION_DELTA)
+		format |= PROBE_MASK_COMPRESSED;
+
+	/* varint of 32 bit delta takes up to 5 bytes */
+	max_frame_bytes = popcount(ch_mask) *
+		(cfg->compression == PROBE_COMPRESSION_DELTA ? 5 : out_bytes);
+	chunk_frames = sizeof(_probe->ext_scratch) / max_frame_bytes;
+
+	for (frame = 0; frame < frames; frame++) {
+		if (cfg->phase) {
+			cfg->phase--;
+			src = audio_stream_wrap(stream, src + container * channels);
+			continue;
+		}
+		cfg->phase = cfg->decimation - 1;
+
+		for (ch = 0; ch < channels; ch++) {
+			if (ch_mask & BIT(ch)) {
+				if (container == sizeof(int16_t))
+					sample = *(int16_t *)src;
+				else
+					sample = *(int32_t *)src;
+				sample = (int32_t)((uint32_t)sample << lshift) >> rshift;
+
+				if (cfg->compression == PROBE_COMPRESSION_DELTA) {
+					dst = probe_extract_put_delta(dst, (uint32_t)sample - prev[ch]);
+					prev[ch] = sample;
+				} else {
+					for (b = 0; b < out_bytes; b++)
+						*dst++ = (uint32_t)sample >> (8 * b);
+				}
+			}
+			src = audio_stream_wrap(stream, src + container);
+		}
+
+		if (++out_frames == chunk_frames) {
+			ret = probe_extract_packet(buffer_id, format, dst - _probe->ext_scratch,
+						   timestamp);
+			if (ret < 0)
+				return ret;
+
+			/* each packet can be decoded on its own */
+			memset(prev, 0, sizeof(prev));
+			dst = _probe->ext_scratch;
+			out_frames = 0;
+		}
+	}
+
+	if (!out_frames)
+		return 0;
+
+	return probe_extract_packet(buffer_id, format, dst - _probe->ext_scratch, timestamp);
+}
+
+int probe_point_set_options(uint32_t count, const struct probe_extraction_options *opts)
+{
+	struct probe_pdata *_probe = probe_get();
+	struct probe_extract_cfg *cfg;
+	uint32_t i;
+	uint32_t j;
+
+	tr_dbg(&pr_tr, "probe_point_set_options() count = %u", count);
+
+	if (!_probe) {
+		tr_err(&pr_tr, "probe_point_set_options(): Not initialized.");
+
+		return -EINVAL;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (opts[i].decimation > 16 || opts[i].sample_bytes > 4 ||
+		    opts[i].compression > PROBE_COMPRESSION_DELTA) {
+			tr_err(&pr_tr, "probe_point_set_options(): invalid options for buffer %u",
+			       opts[i].buffer_id.full_id);
+
+			return -EINVAL;
+		}
+
+		for (j = 0; j < CONFIG_PROBE_POINTS_MAX; j++)
+			if (_probe->probe_points[j].stream_tag != PROBE_POINT_INVALID &&
+			    _probe->probe_points[j].purpose == PROBE_PURPOSE_EXTRACTION &&
+			    _probe->probe_points[j].buffer_id.full_id ==
+			    opts[i].buffer_id.full_id)
+				break;
+
+		if (j == CONFIG_PROBE_POINTS_MAX) {
+			tr_err(&pr_tr, "probe_point_set_options(): no extraction probe for buffer %u",
+			       opts[i].buffer_id.full_id);
+
+			return -EINVAL;
+		}
+
+		cfg = &_probe->ext_cfg[j];
+		cfg->channel_mask = opts[i].channel_mask;
+		cfg->decimation = MAX(opts[i].decimation, 1);
+		cfg->sample_bytes = opts[i].sample_bytes;
+		cfg->compression = opts[i].compression;
+		cfg->phase = 0;
+	}
+
+	return 0;
+}
+#endif
+
+/**
+ * \brief Copy produced data of extraction probe point to probe buffer.
+ * \param[in] _probe probes main struct.
+ * \param[in] point probe point index.
+ * \param[in] buffer_id component buffer id
+ * \param[in] buffer probed buffer.
+ * \param[in] cb_data produce transaction.
+ * \param[in] timestamp of data capture.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_extract(struct probe_pdata *_probe, uint32_t point, uint32_t buffer_id,
+			 struct comp_buffer *buffer,
+			 const struct buffer_cb_transact *cb_data, uint64_t timestamp)
+{
+	uint32_t head, tail;
+	uint32_t format;
+	uint64_t checksum;
+	int ret;
+
+#if CONFIG_PROBE_EXTRACT_REDUCE
+	if (probe_extract_is_reduced(&_probe->ext_cfg[point]))
+		return probe_extract_reduced(&_probe->ext_cfg[point], buffer_id,
+					     &buffer->stream, cb_data, timestamp);
+#endif
+	format = probe_gen_format(audio_stream_get_frm_fmt(&buffer->stream),
+				  audio_stream_get_rate(&buffer->stream),
+				  audio_stream_get_channels(&buffer->stream));
+	ret = probe_gen_header(buffer_id,
+			       cb_data->transaction_amount,
+			       format, timestamp, &checksum);
+	if (ret < 0)
+		return ret;
+
+	/* check if transaction amount exceeds component buffer end addr */
+	/* if yes: divide copying into two stages, head and tail */
+	if ((char *)cb_data->transaction_begin_address + cb_data->transaction_amount >
+	    (char *)audio_stream_get_end_addr(&buffer->stream)) {
+		head = (uintptr_t)audio_stream_get_end_addr(&buffer->stream) -
+		       (uintptr_t)cb_data->transaction_begin_address;
+		tail = (uintptr_t)cb_data->transaction_amount - head;
+		ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
+				      cb_data->transaction_begin_address,
+				      head);
+		if (ret < 0)
+			return ret;
+
+		ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
+				      audio_stream_get_addr(&buffer->stream), tail);
+		if (ret < 0)
+			return ret;
+	} else {
+		ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
+				      cb_data->transaction_begin_address,
+				      cb_data->transaction_amount);
+		if (ret < 0)
+			return ret;
+	}
+
+	return copy_to_pbuffer(&_probe->ext_dma.dmapb,
+			       &checksum, sizeof(checksum));
+}
+
+#if CONFIG_PROBE_DEFERRED_TAP
+/**
+ * \brief Record produced region of extraction probe point, data is copied
+ *	  later by the probe task.
+ * \param[in] _probe probes main struct.
+ * \param[in] point probe point index.
+ * \param[in] buffer probed buffer.
+ * \param[in] cb_data produce transaction.
+ */
+static void probe_tap_record(struct probe_pdata *_probe, uint32_t point,
+			     struct comp_buffer *buffer,
+			     const struct buffer_cb_transact *cb_data)
+{
+	struct probe_tap_desc *desc;
+
+	if (_probe->tap_count == CONFIG_PROBE_TAP_DESC_COUNT) {
+		_probe->tap_overruns++;
+	} else {
+		desc = &_probe->tap_desc[(_probe->tap_first + _probe->tap_count) %
+					 CONFIG_PROBE_TAP_DESC_COUNT];
+		desc->buffer = buffer;
+		desc->begin = cb_data->transaction_begin_address;
+		desc->amount = cb_data->transaction_amount;
+		desc->point = point;
+		desc->position = _probe->tap_produced[point];
+		desc->timestamp = sof_cycle_get_64();
+		_probe->tap_count++;
+	}
+
+	_probe->tap_produced[point] += cb_data->transaction_amount;
+
+	/* copy right after this LL tick, before the producer wraps over the region */
+	reschedule_task(&_probe->dmap_work, 0);
+}
+
+/**
+ * \brief Copy all recorded regions, which are not yet overwritten by the
+ *	  producer, to probe buffer.
+ * \param[in] _probe probes main struct.
+ */
+static void probe_tap_drain(struct probe_pdata *_probe)
+{
+	struct buffer_cb_transact cb_data;
+	struct probe_tap_desc *desc;
+	uint64_t produced;
+	int ret;
+
+	for (; _probe->tap_count; _probe->tap_count--) {
+		desc = &_probe->tap_desc[_probe->tap_first];
+		_probe->tap_first = (_probe->tap_first + 1) % CONFIG_PROBE_TAP_DESC_COUNT;
+
+		if (!desc->buffer)
+			continue;
+
+		/* producer may already be writing next region of the same size */
+		produced = _probe->tap_produced[desc->point] + desc->amount;
+		if (produced - desc->position > audio_stream_get_size(&desc->buffer->stream)) {
+			_probe->tap_overruns++;
+			continue;
+		}
+
+		cb_data.buffer = desc->buffer;
+		cb_data.transaction_begin_address = desc->begin;
+		cb_data.transaction_amount = desc->amount;
+		ret = probe_extract(_probe, desc->point,
+				    _probe->probe_points[desc->point].buffer_id.full_id,
+				    desc->buffer, &cb_data, desc->timestamp);
+		if (ret < 0)
+			_probe->tap_overruns++;
+	}
+
+	if (_probe->tap_overruns) {
+		tr_warn(&pr_tr, "probe_tap_drain(): %u regions lost", _probe->tap_overruns);
+		_probe->tap_overruns = 0;
+	}
+}
+
+/* drop recorded regions of removed probe point */
+static void probe_tap_forget(struct probe_pdata *_probe, uint32_t point)
+{
+	uint32_t i;
+
+	for (i = 0; i < CONFIG_PROBE_TAP_DESC_COUNT; i++)
+		if (_probe->tap_desc[i].point == point)
+			_probe->tap_desc[i].buffer = NULL;
+}
+#endif
+
+#if CONFIG_PROBE_INJECT_STAGED
+/**
+ * \brief Hand consumed block back to the host and check if the next one has
+ *	  been received.
+ * \param[in,out] dma injection DMA.
+ * \return 1 if next block is ready, 0 if not yet received, error code otherwise.
+ */
+static int probe_inject_next_block(struct probe_dma_ext *dma)
+{
+	struct probe_inject_stage *stage = &dma->stage;
+	uint32_t free_bytes;
+	int ret;
+
+	if (stage->block_ready) {
+		/* host refills the block while the next one is injected */
+#if CONFIG_ZEPHYR_NATIVE_DRIVERS
+		ret = dma_reload(dma->dc.dmac->z_dev, dma->dc.chan->index, 0, 0,
+				 stage->block_size);
+#else
+		ret = dma_copy_to_host_nowait(&dma->dc, &dma->config, 0,
+					      (void *)dma->dmapb.r_ptr, stage->block_size);
+#endif
+		if (ret < 0)
+			return ret;
+
+		dma->dmapb.r_ptr += stage->block_size;
+		if (dma->dmapb.r_ptr >= dma->dmapb.end_addr)
+			dma->dmapb.r_ptr = dma->dmapb.addr;
+		stage->block_ready = false;
+		stage->block_read = 0;
+	}
+
+#if CONFIG_ZEPHYR_NATIVE_DRIVERS
+	struct dma_status stat;
+
+	ret = dma_get_status(dma->dc.dmac->z_dev, dma->dc.chan->index, &stat);
+	dma->dmapb.avail = stat.pending_length;
+	free_bytes = stat.free;
+#else
+	ret = dma_get_data_size_legacy(dma->dc.chan, &dma->dmapb.avail, &free_bytes);
+#endif
+	if (ret < 0)
+		return ret;
+
+	if (dma->dmapb.avail < stage->block_size)
+		return 0;
+
+	/* data from DMA, invalidated once for the whole block */
+	dcache_invalidate_region((__sparse_force void __sparse_cache *)dma->dmapb.r_ptr,
+				 stage->block_size);
+	stage->block_ready = true;
+
+	return 1;
+}
+
+static inline int32_t probe_inject_get(const uint8_t *src, uint32_t container, uint32_t valid)
+{
+	if (container == sizeof(int16_t))
+		return (int32_t)((uint32_t)*(int16_t *)src << 16);
+
+	return (int32_t)(*(uint32_t *)src << (32 - 8 * valid));
+}
+
+static inline void probe_inject_put(uint8_t *dst, enum sof_ipc_frame frame_fmt, int32_t sample)
+{
+	switch (frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		*(int16_t *)dst = sample >> 16;
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		*(int32_t *)dst = sample >> 8;
+		break;
+	default:
+		/* float is only injected as sent, concealed with zeros */
+		*(int32_t *)dst = sample;
+		break;
+	}
+}
+
+/* keep frame ending at end of probed buffer for concealment */
+static void probe_inject_hold(struct probe_inject_stage *stage,
+			      const struct audio_stream *stream, uint8_t *end)
+{
+	enum sof_ipc_frame frame_fmt = audio_stream_get_frm_fmt(stream);
+	uint32_t channels = audio_stream_get_channels(stream);
+	uint32_t container = audio_stream_sample_bytes(stream);
+	uint32_t valid = frame_fmt == SOF_IPC_FRAME_S24_4LE ? 3 : container;
+	uint8_t *src = audio_stream_rewind_wrap(stream, end - audio_stream_frame_bytes(stream));
+	uint32_t ch;
+
+	if (frame_fmt == SOF_IPC_FRAME_FLOAT) {
+		memset(stage->last, 0, sizeof(stage->last));
+		return;
+	}
+
+	for (ch = 0; ch < channels; ch++) {
+		stage->last[ch] = probe_inject_get(src, container, valid);
+		src = audio_stream_wrap(stream, src + container);
+	}
+}
+
+/**
+ * \brief Fill frames the host has not sent in time with the last injected
+ *	  frame, faded out by about 1.2 dB per frame.
+ * \param[in,out] stage injection state.
+ * \param[in] stream probed audio stream.
+ * \param[out] dst first frame to fill.
+ * \param[in] frames frames to fill.
+ */
+static void probe_inject_conceal(struct probe_inject_stage *stage,
+				 const struct audio_stream *stream, uint8_t *dst,
+				 uint32_t frames)
+{
+	enum sof_ipc_frame frame_fmt = audio_stream_get_frm_fmt(stream);
+	uint32_t channels = audio_stream_get_channels(stream);
+	uint32_t sample_bytes = audio_stream_sample_bytes(stream);
+	uint32_t frame, ch;
+
+	stage->underruns++;
+	tr_dbg(&pr_tr, "probe_inject_conceal(): %u frames, underruns %u", frames,
+	       stage->underruns);
+
+	for (frame = 0; frame < frames; frame++) {
+		for (ch = 0; ch < channels; ch++) {
+			stage->last[ch] = (int32_t)((int64_t)stage->last[ch] * 7 / 8);
+			probe_inject_put(dst, frame_fmt, stage->last[ch]);
+			dst = audio_stream_wrap(stream, dst + sample_bytes);
+		}
+	}
+}
+
+/* host sends data in the format of the probed buffer, copy it as is */
+static int probe_inject_raw(struct probe_dma_ext *dma, const struct audio_stream *stream,
+			    uint8_t *dst, uint32_t bytes)
+{
+	struct probe_inject_stage *stage = &dma->stage;
+	uint32_t frame_bytes = audio_stream_frame_bytes(stream);
+	uint32_t done = 0;
+	uint32_t partial;
+	uint32_t n;
+	uint8_t *src;
+	int ret;
+
+	while (done < bytes) {
+		if (!stage->block_ready || stage->block_read == stage->block_size) {
+			ret = probe_inject_next_block(dma);
+			if (ret < 0)
+				return ret;
+			if (!ret)
+				break;
+		}
+
+		src = (uint8_t *)dma->dmapb.r_ptr + stage->block_read;
+		n = stage->block_size - stage->block_read;
+
+		/* resume host stream at a frame boundary */
+		if (stage->skip) {
+			n = MIN(n, stage->skip);
+			stage->skip -= n;
+			stage->block_read += n;
+			continue;
+		}
+
+		n = MIN(n, bytes - done);
+		n = MIN(n, (uint8_t *)audio_stream_get_end_addr(stream) - dst);
+		if (memcpy_s(dst, (uint8_t *)audio_stream_get_end_addr(stream) - dst, src, n)) {
+			tr_err(&pr_tr, "probe_inject_raw(): memcpy_s() failed");
+			return -EINVAL;
+		}
+
+		stage->block_read += n;
+		done += n;
+		dst = audio_stream_wrap(stream, dst + n);
+	}
+
+	if (done == bytes) {
+		probe_inject_hold(stage, stream, dst);
+		return 0;
+	}
+
+	/* complete interrupted frame with silence and drop its rest from the host */
+	partial = done % frame_bytes;
+	if (partial) {
+		stage->skip = frame_bytes - partial;
+		if (done > frame_bytes)
+			probe_inject_hold(stage, stream,
+					  audio_stream_rewind_wrap(stream, dst - partial));
+		for (n = 0; n < stage->skip; n++) {
+			*dst = 0;
+			dst = audio_stream_wrap(stream, dst + 1);
+		}
+		done += stage->skip;
+	} else if (done) {
+		probe_inject_hold(stage, stream, dst);
+	}
+
+	probe_inject_conceal(stage, stream, dst, (bytes - done) / frame_bytes);
+
+	return 0;
+}
+
+/* convert host samples and map host channels to the probed buffer */
+static int probe_inject_convert(struct probe_dma_ext *dma, const struct audio_stream *stream,
+				uint8_t *dst, uint32_t frames)
+{
+	struct probe_inject_stage *stage = &dma->stage;
+	enum sof_ipc_frame frame_fmt = audio_stream_get_frm_fmt(stream);
+	uint32_t channels = audio_stream_get_channels(stream);
+	uint32_t sample_bytes = audio_stream_sample_bytes(stream);
+	uint32_t out_frames = 0;
+	uint32_t samples;
+	uint32_t i, ch;
+	uint8_t *src;
+	int32_t sample;
+	int ret;
+
+	while (out_frames < frames) {
+		if (!stage->block_ready || stage->block_read == stage->block_size) {
+			ret = probe_inject_next_block(dma);
+			if (ret < 0)
+				return ret;
+			if (!ret)
+				break;
+		}
+
+		src = (uint8_t *)dma->dmapb.r_ptr + stage->block_read;
+		samples = (stage->block_size - stage->block_read) / stage->container;
+
+		for (i = 0; i < samples && out_frames < frames; i++) {
+			stage->frame[stage->frame_ch++] = probe_inject_get(src, stage->container,
+									   stage->valid);
+			src += stage->container;
+			if (stage->frame_ch < stage->channels)
+				continue;
+
+			/*
+			 * Mono is copied to all channels, the channels not sent
+			 * are silent and the extra ones are dropped.
+			 */
+			stage->frame_ch = 0;
+			for (ch = 0; ch < channels; ch++) {
+				if (ch < stage->channels)
+					sample = stage->frame[ch];
+				else if (stage->channels == 1)
+					sample = stage->frame[0];
+				else
+					sample = 0;
+
+				stage->last[ch] = sample;
+				probe_inject_put(dst, frame_fmt, sample);
+				dst = audio_stream_wrap(stream, dst + sample_bytes);
+			}
+			out_frames++;
+		}
+
+		stage->block_read += i * stage->container;
+	}
+
+	if (out_frames < frames)
+		probe_inject_conceal(stage, stream, dst, frames - out_frames);
+
+	return 0;
+}
+
+/**
+ * \brief Inject data received from the host to probed buffer, converted to
+ *	  the buffer format if the host has set a different one.
+ * \param[in,out] dma injection DMA.
+ * \param[in] buffer probed buffer.
+ * \param[in] cb_data produce transaction.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_inject(struct probe_dma_ext *dma, struct comp_buffer *buffer,
+			const struct buffer_cb_transact *cb_data)
+{
+	struct probe_inject_stage *stage = &dma->stage;
+	const struct audio_stream *stream = &buffer->stream;
+	enum sof_ipc_frame frame_fmt = audio_stream_get_frm_fmt(stream);
+	uint32_t valid = frame_fmt == SOF_IPC_FRAME_S24_4LE ? 3 :
+			 audio_stream_sample_bytes(stream);
+
+	if (audio_stream_get_channels(stream) > PLATFORM_MAX_CHANNELS)
+		return -EINVAL;
+
+	if (!stage->channels || frame_fmt == SOF_IPC_FRAME_FLOAT ||
+	    (stage->channels == audio_stream_get_channels(stream) &&
+	     stage->container == audio_stream_sample_bytes(stream) &&
+	     stage->valid == valid))
+		return probe_inject_raw(dma, stream, cb_data->transaction_begin_address,
+					cb_data->transaction_amount);
+
+	return probe_inject_convert(dma, stream, cb_data->transaction_begin_address,
+				    cb_data->transaction_amount /
+				    audio_stream_frame_bytes(stream));
+}
+#else
+/**
+ * \brief Copy injection data received from the host to probed buffer and
+ *	  request more data from the host.
+ * \param[in,out] dma injection DMA.
+ * \param[in] buffer probed buffer.
+ * \param[in] cb_data produce transaction.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_inject(struct probe_dma_ext *dma, struct comp_buffer *buffer,
+			const struct buffer_cb_transact *cb_data)
+{
+	uint32_t head, tail;
+	uint32_t free_bytes = 0;
+	int32_t copy_bytes = 0;
+	int ret;
+
+	/* get avail data info */
+#if CONFIG_ZEPHYR_NATIVE_DRIVERS
+	struct dma_status stat;
+
+	ret = dma_get_status(dma->dc.dmac->z_dev, dma->dc.chan->index, &stat);
+	dma->dmapb.avail = stat.pending_length;
+	free_bytes = stat.free;
+#else
+	ret = dma_get_data_size_legacy(dma->dc.chan,
+				       &dma->dmapb.avail,
+				       &free_bytes);
+#endif
+	if (ret < 0) {
+		tr_err(&pr_tr, "probe_inject(): dma_get_data_size() failed, ret = %u",
+		       ret);
+		return ret;
+	}
+
+	/* check if transaction amount exceeds component buffer end addr */
+	/* if yes: divide copying into two stages, head and tail */
+	if ((char *)cb_data->transaction_begin_address + cb_data->transaction_amount >
+	    (char *)audio_stream_get_end_addr(&buffer->stream)) {
+		head = (char *)audio_stream_get_end_addr(&buffer->stream) -
+			(char *)cb_data->transaction_begin_address;
+		tail = cb_data->transaction_amount - head;
+
+		ret = copy_from_pbuffer(&dma->dmapb,
+					cb_data->transaction_begin_address, head);
+		if (ret < 0)
+			return ret;
+
+		ret = copy_from_pbuffer(&dma->dmapb,
+					audio_stream_get_addr(&buffer->stream), tail);
+		if (ret < 0)
+			return ret;
+	} else {
+		ret = copy_from_pbuffer(&dma->dmapb,
+					cb_data->transaction_begin_address,
+					cb_data->transaction_amount);
+		if (ret < 0)
+			return ret;
+	}
+
+	/* calc how many data can be requested */
+	copy_bytes = dma->dmapb.r_ptr - dma->dmapb.w_ptr;
+	if (copy_bytes < 0)
+		copy_bytes += dma->dmapb.size;
+
+	/* align down to request at least 32 */
+	copy_bytes = ALIGN_DOWN(copy_bytes, 32);
+
+	/* check if copy_bytes is still valid for dma copy */
+	if (copy_bytes > 0) {
+#if CONFIG_ZEPHYR_NATIVE_DRIVERS
+		ret = dma_reload(dma->dc.dmac->z_dev,
+				 dma->dc.chan->index, 0, 0, copy_bytes);
+#else
+		ret = dma_copy_to_host_nowait(&dma->dc,
+					      &dma->config, 0,
+					      (void *)dma->dmapb.r_ptr,
+					      copy_bytes);
+#endif
+		if (ret < 0)
+			return ret;
+
+		/* update pointers */
+		dma->dmapb.w_ptr = dma->dmapb.w_ptr + copy_bytes;
+		if (dma->dmapb.w_ptr > dma->dmapb.end_addr)
+			dma->dmapb.w_ptr = dma->dmapb.w_ptr - dma->dmapb.size;
+	}
+
+	return 0;
+}
+#endif
+
 /**
  * \brief General extraction probe callback, called from buffer produce.
  *	  It will search for probe point connected to this buffer.
@@ -882,13 +1811,8 @@ static void probe_cb_produce(void *arg, enum notify_id type, void *data)
 	struct comp_buffer *buffer = cb_data->buffer;
 	struct probe_dma_ext *dma;
 	uint32_t buffer_id;
-	uint32_t head, tail;
-	uint32_t free_bytes = 0;
-	int32_t copy_bytes = 0;
 	int ret;
 	uint32_t i, j;
-	uint32_t format;
-	uint64_t checksum;
 
 	buffer_id = *(int *)arg;
 
@@ -904,46 +1828,15 @@ static void probe_cb_produce(void *arg, enum notify_id type, void *data)
 	}
 
 	if (_probe->probe_points[i].purpose == PROBE_PURPOSE_EXTRACTION) {
-		format = probe_gen_format(audio_stream_get_frm_fmt(&buffer->stream),
-					  audio_stream_get_rate(&buffer->stream),
-					  audio_stream_get_channels(&buffer->stream));
-		ret = probe_gen_header(buffer_id,
-				       cb_data->transaction_amount,
-				       format, &checksum);
-		if (ret < 0)
-			goto err;
-
-		/* check if transaction amount exceeds component buffer end addr */
-		/* if yes: divide copying into two stages, head and tail */
-		if ((char *)cb_data->transaction_begin_address + cb_data->transaction_amount >
-		    (char *)audio_stream_get_end_addr(&buffer->stream)) {
-			head = (uintptr_t)audio_stream_get_end_addr(&buffer->stream) -
-			       (uintptr_t)cb_data->transaction_begin_address;
-			tail = (uintptr_t)cb_data->transaction_amount - head;
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      cb_data->transaction_begin_address,
-					      head);
-			if (ret < 0)
-				goto err;
-
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      audio_stream_get_addr(&buffer->stream), tail);
-			if (ret < 0)
-				goto err;
-		} else {
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      cb_data->transaction_begin_address,
-					      cb_data->transaction_amount);
-			if (ret < 0)
-				goto err;
-		}
-
-		ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-				      &checksum, sizeof(checksum));
+#if CONFIG_PROBE_DEFERRED_TAP
+		probe_tap_record(_probe, i, buffer, cb_data);
+#else
+		ret = probe_extract(_probe, i, buffer_id, buffer, cb_data, sof_cycle_get_64());
 		if (ret < 0)
 			goto err;
 
 		kick_probe_task(_probe);
+#endif
 	} else {
 		/* search for DMA used by this probe point */
 		for (j = 0; j < CONFIG_PROBE_DMA_MAX; j++) {
@@ -959,76 +1852,9 @@ static void probe_cb_produce(void *arg, enum notify_id type, void *data)
 			return;
 		}
 		dma = &_probe->inject_dma[j];
-		/* get avail data info */
-#if CONFIG_ZEPHYR_NATIVE_DRIVERS
-		struct dma_status stat;
-
-		ret = dma_get_status(dma->dc.dmac->z_dev, dma->dc.chan->index, &stat);
-		dma->dmapb.avail = stat.pending_length;
-		free_bytes = stat.free;
-#else
-		ret = dma_get_data_size_legacy(dma->dc.chan,
-					       &dma->dmapb.avail,
-					       &free_bytes);
-#endif
-		if (ret < 0) {
-			tr_err(&pr_tr, "probe_cb_produce(): dma_get_data_size() failed, ret = %u",
-			       ret);
+		ret = probe_inject(dma, buffer, cb_data);
+		if (ret < 0)
 			goto err;
-		}
-
-		/* check if transaction amount exceeds component buffer end addr */
-		/* if yes: divide copying into two stages, head and tail */
-		if ((char *)cb_data->transaction_begin_address + cb_data->transaction_amount >
-		    (char *)audio_stream_get_end_addr(&buffer->stream)) {
-			head = (char *)audio_stream_get_end_addr(&buffer->stream) -
-				(char *)cb_data->transaction_begin_address;
-			tail = cb_data->transaction_amount - head;
-
-			ret = copy_from_pbuffer(&dma->dmapb,
-						cb_data->transaction_begin_address, head);
-			if (ret < 0)
-				goto err;
-
-			ret = copy_from_pbuffer(&dma->dmapb,
-						audio_stream_get_addr(&buffer->stream), tail);
-			if (ret < 0)
-				goto err;
-		} else {
-			ret = copy_from_pbuffer(&dma->dmapb,
-						cb_data->transaction_begin_address,
-						cb_data->transaction_amount);
-			if (ret < 0)
-				goto err;
-		}
-
-		/* calc how many data can be requested */
-		copy_bytes = dma->dmapb.r_ptr - dma->dmapb.w_ptr;
-		if (copy_bytes < 0)
-			copy_bytes += dma->dmapb.size;
-
-		/* align down to request at least 32 */
-		copy_bytes = ALIGN_DOWN(copy_bytes, 32);
-
-		/* check if copy_bytes is still valid for dma copy */
-		if (copy_bytes > 0) {
-#if CONFIG_ZEPHYR_NATIVE_DRIVERS
-			ret = dma_reload(dma->dc.dmac->z_dev,
-					 dma->dc.chan->index, 0, 0, copy_bytes);
-#else
-			ret = dma_copy_to_host_nowait(&dma->dc,
-						      &dma->config, 0,
-						      (void *)dma->dmapb.r_ptr,
-						      copy_bytes);
-#endif
-			if (ret < 0)
-				goto err;
-
-			/* update pointers */
-			dma->dmapb.w_ptr = dma->dmapb.w_ptr + copy_bytes;
-			if (dma->dmapb.w_ptr > dma->dmapb.end_addr)
-				dma->dmapb.w_ptr = dma->dmapb.w_ptr - dma->dmapb.size;
-		}
 	}
 	return;
 err:
@@ -1276,6 +2102,12 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 		_probe->probe_points[first_free].buffer_id = *buf_id;
 		_probe->probe_points[first_free].purpose = probe[i].purpose;
 		_probe->probe_points[first_free].stream_tag = stream_tag;
+#if CONFIG_PROBE_EXTRACT_REDUCE
+		bzero(&_probe->ext_cfg[first_free], sizeof(_probe->ext_cfg[first_free]));
+#endif
+#if CONFIG_PROBE_DEFERRED_TAP
+		_probe->tap_produced[first_free] = 0;
+#endif
 
 		if (fw_logs) {
 #if CONFIG_LOG_BACKEND_SOF_PROBE
@@ -1285,17 +2117,22 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 #endif
 		} else {
 			probe_point_id_t *new_buf_id = &_probe->probe_points[first_free].buffer_id;
+			/* extraction only reads the data, one copy per LL tick is enough */
+			uint32_t notify_mask = probe[i].purpose == PROBE_PURPOSE_EXTRACTION ?
+				BUFF_CB_TYPE_PRODUCE | BUFF_CB_TYPE_COALESCE : BUFF_CB_TYPE_PRODUCE;
 
 #if CONFIG_IPC_MAJOR_4
 			notifier_register(&new_buf_id->full_id, buf, NOTIFIER_ID_BUFFER_PRODUCE,
 					  &probe_cb_produce, 0);
 			notifier_register(&new_buf_id->full_id, buf, NOTIFIER_ID_BUFFER_FREE,
 					  &probe_cb_free, 0);
+			buffer_notify_subscribe(buf, notify_mask);
 #else
 			notifier_register(&new_buf_id->full_id, dev->cb, NOTIFIER_ID_BUFFER_PRODUCE,
 					  &probe_cb_produce, 0);
 			notifier_register(&new_buf_id->full_id, dev->cb, NOTIFIER_ID_BUFFER_FREE,
 					  &probe_cb_free, 0);
+			buffer_notify_subscribe(dev->cb, notify_mask);
 #endif
 		}
 	}
@@ -1412,6 +2249,7 @@ int probe_point_remove(uint32_t count, const uint32_t *buffer_id)
 				if (dev) {
 					buf = ipc4_get_buffer(dev, *buf_id);
 					if (buf) {
+						buffer_notify_unsubscribe(buf, BUFF_CB_TYPE_PRODUCE);
 						notifier_unregister(NULL, buf,
 								    NOTIFIER_ID_BUFFER_PRODUCE);
 						notifier_unregister(NULL, buf,
@@ -1421,10 +2259,14 @@ int probe_point_remove(uint32_t count, const uint32_t *buffer_id)
 #else
 				dev = ipc_get_comp_by_id(ipc_get(), buffer_id[i]);
 				if (dev) {
+					buffer_notify_unsubscribe(dev->cb, BUFF_CB_TYPE_PRODUCE);
 					notifier_unregister(_probe, dev->cb,
 							    NOTIFIER_ID_BUFFER_PRODUCE);
 					notifier_unregister(_probe, dev->cb, NOTIFIER_ID_BUFFER_FREE);
 				}
+#endif
+#if CONFIG_PROBE_DEFERRED_TAP
+				probe_tap_forget(_probe, j);
 #endif
 				_probe->probe_points[j].stream_tag =
 					PROBE_POINT_INVALID;
@@ -1495,6 +2337,17 @@ static int probe_set_large_config(struct comp_dev *dev, uint32_t param_id,
 				     (const struct probe_dma *)data);
 	case IPC4_PROBE_MODULE_INJECTION_DMA_DETACH:
 		return probe_dma_remove(data_offset / sizeof(uint32_t), (const uint32_t *)data);
+#if CONFIG_PROBE_EXTRACT_REDUCE
+	case IPC4_PROBE_MODULE_EXTRACTION_OPTIONS:
+		return probe_point_set_options(data_offset /
+					       sizeof(struct probe_extraction_options),
+					       (const struct probe_extraction_options *)data);
+#endif
+#if CONFIG_PROBE_INJECT_STAGED
+	case IPC4_PROBE_MODULE_INJECTION_FORMAT:
+		return probe_dma_set_format(data_offset / sizeof(struct probe_injection_format),
+					    (const struct probe_injection_format *)data);
+#endif
 	default:
 		return -EINVAL;
 	}
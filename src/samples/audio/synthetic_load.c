@@ -0,0 +1,439 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <sof/audio/module_adapter/module/generic.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/audio/ipc-config.h>
+#include <sof/audio/sink_api.h>
+#include <sof/audio/sink_source_utils.h>
+#include <sof/audio/source_api.h>
+#include <sof/common.h>
+#include <sof/lib/uuid.h>
+#include <sof/list.h>
+#include <sof/trace/trace.h>
+#include <sof/ut.h>
+#include <rtos/alloc.h>
+#include <rtos/init.h>
+#include <rtos/string.h>
+#include <rtos/timer.h>
+#include <ipc/topology.h>
+#include <user/synthetic_load.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+LOG_MODULE_REGISTER(synthetic_load, CONFIG_SOF_LOG_LEVEL);
+
+/* 6d0ee8fb-8f5b-4d21-9a55-1a38c45e7b92 */
+DECLARE_SOF_RT_UUID("synthetic_load", synthetic_load_uuid, 0x6d0ee8fb, 0x8f5b, 0x4d21,
+		    0x9a, 0x55, 0x1a, 0x38, 0xc4, 0x5e, 0x7b, 0x92);
+
+DECLARE_TR_CTX(synthetic_load_tr, SOF_UUID(synthetic_load_uuid), LOG_LEVEL_INFO);
+
+/* 6d0ee8fb-8f5b-4d21-9a55-1a38c45e7b93 */
+DECLARE_SOF_RT_UUID("synthetic_load_dp", synthetic_load_dp_uuid, 0x6d0ee8fb, 0x8f5b, 0x4d21,
+		    0x9a, 0x55, 0x1a, 0x38, 0xc4, 0x5e, 0x7b, 0x93);
+
+DECLARE_TR_CTX(synthetic_load_dp_tr, SOF_UUID(synthetic_load_dp_uuid), LOG_LEVEL_INFO);
+
+/* resolution of the largest free block probe */
+#define SYNTHETIC_LOAD_PROBE_STEP	64
+
+struct synthetic_load_data {
+	struct sof_synthetic_load_config config;	/* used by process() */
+	struct sof_synthetic_load_config new_config;	/* set by IPC, applied by process() */
+	bool config_pending;
+
+	struct sof_synthetic_load_stats stats;
+	uint64_t period_cycles;
+	uint64_t last_stamp;
+	uint64_t interval_min;
+	uint64_t interval_max;
+	uint64_t jitter_max;
+	uint64_t jitter_sum;
+	uint64_t load_max;
+
+	void *allocs[SYNTHETIC_LOAD_ALLOCS_MAX];
+	uint32_t alloc_sizes[SYNTHETIC_LOAD_ALLOCS_MAX];
+	uint32_t alloc_next;
+	uint32_t seed;
+};
+
+static void *synthetic_load_alloc(const struct sof_synthetic_load_config *config, size_t size)
+{
+	if (config->flags & SYNTHETIC_LOAD_FLAG_HEAP_BUFFER)
+		return rballoc(0, SOF_MEM_CAPS_RAM, size);
+
+	return rmalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, size);
+}
+
+static void synthetic_load_heap_release(struct synthetic_load_data *sld)
+{
+	int i;
+
+	for (i = 0; i < SYNTHETIC_LOAD_ALLOCS_MAX; i++) {
+		rfree(sld->allocs[i]);
+		sld->allocs[i] = NULL;
+		sld->alloc_sizes[i] = 0;
+	}
+
+	sld->alloc_next = 0;
+	sld->stats.heap_live_bytes = 0;
+}
+
+/* replaces the oldest allocation with a new one of random size */
+static void synthetic_load_heap_churn(struct synthetic_load_data *sld)
+{
+	const struct sof_synthetic_load_config *config = &sld->config;
+	uint32_t range = config->heap_max_size - config->heap_min_size + 1;
+	uint32_t i = sld->alloc_next;
+	uint32_t size;
+
+	rfree(sld->allocs[i]);
+	sld->stats.heap_live_bytes -= sld->alloc_sizes[i];
+
+	sld->seed = sld->seed * 1664525u + 1013904223u;
+	size = config->heap_min_size + (sld->seed >> 8) % range;
+
+	sld->allocs[i] = synthetic_load_alloc(config, size);
+	if (sld->allocs[i]) {
+		sld->alloc_sizes[i] = size;
+		sld->stats.heap_live_bytes += size;
+	} else {
+		sld->alloc_sizes[i] = 0;
+		sld->stats.heap_fails++;
+	}
+
+	sld->alloc_next = (i + 1) % config->heap_allocs;
+}
+
+/* the largest block the heap can still serve, the free bytes don't show fragmentation */
+static uint32_t synthetic_load_heap_probe(const struct sof_synthetic_load_config *config)
+{
+	uint32_t lo = 0;
+	uint32_t hi = config->heap_probe_size;
+	uint32_t mid;
+	void *ptr;
+
+	while (hi - lo > SYNTHETIC_LOAD_PROBE_STEP) {
+		mid = lo + (hi - lo) / 2;
+		ptr = synthetic_load_alloc(config, mid);
+		if (ptr) {
+			rfree(ptr);
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static void synthetic_load_burn(uint32_t cycles)
+{
+	uint64_t end = sof_cycle_get_64() + cycles;
+
+	while (sof_cycle_get_64() < end)
+		;
+}
+
+static void synthetic_load_stats_reset(struct synthetic_load_data *sld)
+{
+	uint32_t live = sld->stats.heap_live_bytes;
+
+	memset(&sld->stats, 0, sizeof(sld->stats));
+	sld->stats.size = sizeof(sld->stats);
+	sld->stats.heap_live_bytes = live;
+
+	sld->period_cycles = 0;
+	sld->last_stamp = 0;
+	sld->interval_min = UINT64_MAX;
+	sld->interval_max = 0;
+	sld->jitter_max = 0;
+	sld->jitter_sum = 0;
+	sld->load_max = 0;
+}
+
+static void synthetic_load_apply_config(struct synthetic_load_data *sld)
+{
+	synthetic_load_heap_release(sld);
+	sld->config = sld->new_config;
+	sld->config_pending = false;
+}
+
+static void synthetic_load_account(struct processing_module *mod, uint64_t now)
+{
+	struct synthetic_load_data *sld = module_get_private_data(mod);
+	uint64_t interval;
+	uint64_t jitter;
+	uint32_t jitter_us;
+	int bin;
+
+	sld->stats.periods++;
+
+	/* DP modules get their period only once they are prepared */
+	if (!sld->last_stamp) {
+		sld->period_cycles = k_us_to_cyc_ceil64(mod->dev->period);
+		sld->last_stamp = now;
+		return;
+	}
+
+	interval = now - sld->last_stamp;
+	sld->last_stamp = now;
+
+	jitter = interval > sld->period_cycles ? interval - sld->period_cycles :
+		 sld->period_cycles - interval;
+
+	sld->interval_min = MIN(sld->interval_min, interval);
+	sld->interval_max = MAX(sld->interval_max, interval);
+	sld->jitter_max = MAX(sld->jitter_max, jitter);
+	sld->jitter_sum += jitter;
+
+	jitter_us = k_cyc_to_us_near64(jitter);
+	bin = jitter_us ? 32 - clz(jitter_us) : 0;
+	sld->stats.jitter_hist[MIN(bin, SYNTHETIC_LOAD_JITTER_BINS - 1)]++;
+}
+
+static int synthetic_load_init(struct processing_module *mod)
+{
+	struct synthetic_load_data *sld;
+
+	comp_info(mod->dev, "synthetic_load_init()");
+
+	sld = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*sld));
+	if (!sld)
+		return -ENOMEM;
+
+	/* a plain copy until the host sets the cost */
+	sld->config.size = sizeof(sld->config);
+	sld->seed = 1;
+	synthetic_load_stats_reset(sld);
+	mod->priv.private = sld;
+
+	return 0;
+}
+
+#if CONFIG_IPC_MAJOR_4
+static void synthetic_load_params(struct processing_module *mod)
+{
+	struct sof_ipc_stream_params *params = mod->stream_params;
+	struct comp_buffer *sinkb, *sourceb;
+	struct comp_dev *dev = mod->dev;
+
+	ipc4_base_module_cfg_to_stream_params(&mod->priv.cfg.base_cfg, params);
+	component_set_nearest_period_frames(dev, params->rate);
+
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+	ipc4_update_buffer_format(sinkb, &mod->priv.cfg.base_cfg.audio_fmt);
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer, sink_list);
+	ipc4_update_buffer_format(sourceb, &mod->priv.cfg.base_cfg.audio_fmt);
+}
+#endif /* CONFIG_IPC_MAJOR_4 */
+
+static int synthetic_load_prepare(struct processing_module *mod,
+				  struct sof_source **sources, int num_of_sources,
+				  struct sof_sink **sinks, int num_of_sinks)
+{
+	struct synthetic_load_data *sld = module_get_private_data(mod);
+
+	comp_info(mod->dev, "synthetic_load_prepare()");
+
+	if (num_of_sources != 1 || num_of_sinks != 1)
+		return -EINVAL;
+
+#if CONFIG_IPC_MAJOR_4
+	synthetic_load_params(mod);
+#endif
+
+	if (sld->config_pending)
+		synthetic_load_apply_config(sld);
+
+	synthetic_load_stats_reset(sld);
+
+	comp_info(mod->dev, "synthetic_load_prepare(), cycles %u heap allocs %u",
+		  sld->config.cycles, sld->config.heap_allocs);
+
+	return 0;
+}
+
+static int synthetic_load_process(struct processing_module *mod,
+				  struct sof_source **sources, int num_of_sources,
+				  struct sof_sink **sinks, int num_of_sinks)
+{
+	struct synthetic_load_data *sld = module_get_private_data(mod);
+	uint64_t now = sof_cycle_get_64();
+	uint64_t load;
+	size_t frames;
+	int ret;
+
+	if (sld->config_pending)
+		synthetic_load_apply_config(sld);
+
+	synthetic_load_account(mod, now);
+
+	frames = MIN(source_get_data_frames_available(sources[0]),
+		     sink_get_free_frames(sinks[0]));
+	ret = source_to_sink_copy(sources[0], sinks[0], true,
+				  frames * source_get_frame_bytes(sources[0]));
+	if (ret)
+		return ret;
+
+	if (sld->config.cycles)
+		synthetic_load_burn(sld->config.cycles);
+
+	if (sld->config.heap_allocs)
+		synthetic_load_heap_churn(sld);
+
+	load = sof_cycle_get_64() - now;
+	sld->load_max = MAX(sld->load_max, load);
+	if (sld->period_cycles && load > sld->period_cycles)
+		sld->stats.overruns++;
+
+	return 0;
+}
+
+static int synthetic_load_set_config(struct processing_module *mod, uint32_t config_id,
+				     enum module_cfg_fragment_position pos,
+				     uint32_t data_offset_size, const uint8_t *fragment,
+				     size_t fragment_size, uint8_t *response,
+				     size_t response_size)
+{
+	struct synthetic_load_data *sld = module_get_private_data(mod);
+	const struct sof_synthetic_load_config *config =
+		(const struct sof_synthetic_load_config *)fragment;
+	struct comp_dev *dev = mod->dev;
+
+	if (config_id != SYNTHETIC_LOAD_SET_CONFIG) {
+		comp_err(dev, "synthetic_load_set_config(): unknown config_id %u", config_id);
+		return -EINVAL;
+	}
+
+	if (fragment_size != sizeof(*config) || config->size != sizeof(*config)) {
+		comp_err(dev, "synthetic_load_set_config(): invalid config size %u, expect %u",
+			 fragment_size, sizeof(*config));
+		return -EINVAL;
+	}
+
+	if (config->heap_allocs > SYNTHETIC_LOAD_ALLOCS_MAX ||
+	    (config->heap_allocs &&
+	     (!config->heap_min_size || config->heap_min_size > config->heap_max_size))) {
+		comp_err(dev, "synthetic_load_set_config(): invalid heap churn %u x %u..%u",
+			 config->heap_allocs, config->heap_min_size, config->heap_max_size);
+		return -EINVAL;
+	}
+
+	/* process() owns the active configuration and applies the new one */
+	if (sld->config_pending)
+		return -EBUSY;
+
+	sld->new_config = *config;
+	if (dev->state == COMP_STATE_ACTIVE)
+		sld->config_pending = true;
+	else
+		synthetic_load_apply_config(sld);
+
+	comp_info(dev, "synthetic_load_set_config(), cycles %u heap allocs %u",
+		  config->cycles, config->heap_allocs);
+
+	return 0;
+}
+
+static int synthetic_load_get_config(struct processing_module *mod, uint32_t config_id,
+				     uint32_t *data_offset_size, uint8_t *fragment,
+				     size_t fragment_size)
+{
+	struct synthetic_load_data *sld = module_get_private_data(mod);
+	struct sof_synthetic_load_stats *stats = &sld->stats;
+	uint32_t intervals = stats->periods > 1 ? stats->periods - 1 : 0;
+	int ret;
+
+	switch (config_id) {
+	case SYNTHETIC_LOAD_SET_CONFIG:
+		ret = memcpy_s(fragment, fragment_size, &sld->config, sizeof(sld->config));
+		if (ret)
+			return ret;
+		*data_offset_size = sizeof(sld->config);
+		return 0;
+	case SYNTHETIC_LOAD_GET_STATS:
+		break;
+	default:
+		comp_err(mod->dev, "synthetic_load_get_config(): unknown config_id %u",
+			 config_id);
+		return -EINVAL;
+	}
+
+	/* process() counts in cycles, the host gets microseconds */
+	stats->period_us = mod->dev->period;
+	stats->interval_min_us = intervals ? k_cyc_to_us_near64(sld->interval_min) : 0;
+	stats->interval_max_us = k_cyc_to_us_near64(sld->interval_max);
+	stats->jitter_avg_us = intervals ? k_cyc_to_us_near64(sld->jitter_sum / intervals) : 0;
+	stats->jitter_max_us = k_cyc_to_us_near64(sld->jitter_max);
+	stats->load_max_cycles = sld->load_max;
+	if (sld->config.heap_probe_size)
+		stats->heap_largest_free = synthetic_load_heap_probe(&sld->config);
+
+	ret = memcpy_s(fragment, fragment_size, stats, sizeof(*stats));
+	if (ret)
+		return ret;
+
+	*data_offset_size = sizeof(*stats);
+
+	return 0;
+}
+
+static int synthetic_load_reset(struct processing_module *mod)
+{
+	struct synthetic_load_data *sld = module_get_private_data(mod);
+
+	comp_info(mod->dev, "synthetic_load_reset()");
+
+	synthetic_load_heap_release(sld);
+
+	return 0;
+}
+
+static int synthetic_load_free(struct processing_module *mod)
+{
+	struct synthetic_load_data *sld = module_get_private_data(mod);
+
+	comp_info(mod->dev, "synthetic_load_free()");
+
+	synthetic_load_heap_release(sld);
+	rfree(sld);
+
+	return 0;
+}
+
+static const struct module_interface synthetic_load_interface = {
+	.init = synthetic_load_init,
+	.prepare = synthetic_load_prepare,
+	.process = synthetic_load_process,
+	.set_configuration = synthetic_load_set_config,
+	.get_configuration = synthetic_load_get_config,
+	.reset = synthetic_load_reset,
+	.free = synthetic_load_free,
+};
+
+/* The host picks the scheduling domain from the module manifest entry, the DP
+ * variant is the same module under its own UUID.
+ */
+static const struct module_interface synthetic_load_dp_interface = {
+	.init = synthetic_load_init,
+	.prepare = synthetic_load_prepare,
+	.process = synthetic_load_process,
+	.set_configuration = synthetic_load_set_config,
+	.get_configuration = synthetic_load_get_config,
+	.reset = synthetic_load_reset,
+	.free = synthetic_load_free,
+};
+
+DECLARE_MODULE_ADAPTER(synthetic_load_interface, synthetic_load_uuid, synthetic_load_tr);
+SOF_MODULE_INIT(synthetic_load, sys_comp_module_synthetic_load_interface_init);
+
+DECLARE_MODULE_ADAPTER(synthetic_load_dp_interface, synthetic_load_dp_uuid,
+		       synthetic_load_dp_tr);
+SOF_MODULE_INIT(synthetic_load_dp, sys_comp_module_synthetic_load_dp_interface_init);
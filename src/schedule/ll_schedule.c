@@ -19,6 +19,7 @@
 #include <sof/lib/perf_cnt.h>
 #include <sof/lib/uuid.h>
 #include <sof/list.h>
+#include <sof/math/numbers.h>
 #include <sof/platform.h>
 #include <sof/schedule/ll_schedule.h>
 #include <sof/schedule/ll_schedule_domain.h>
@@ -555,7 +556,11 @@ static int schedule_ll_task_common(struct ll_schedule_data *sch, struct task *ta
 					goto out;
 				}
 
-				pdata->ratio = period / reg_pdata->period;
+				/* a tick may cover several periods of the
+				 * registrable task
+				 */
+				pdata->ratio = MAX(period / (reg_pdata->period *
+							     sch->domain->periods_per_tick), 1);
 			}
 		}
 	}
@@ -63,6 +63,12 @@ struct zephyr_dma_domain_channel {
 	struct zephyr_dma_domain_irq *irq_data;
 	/* used to keep track of channels using the same INTID */
 	struct list_item list;
+#if CONFIG_DMA_DOMAIN_COALESCE
+	/* last coalescing round in which the channel raised its IRQ */
+	uint32_t round;
+	/* true if the channel missed a round and isn't waited for */
+	bool stalled;
+#endif
 };
 
 struct zephyr_dma_domain_irq {
@@ -79,6 +85,14 @@ struct zephyr_dma_domain_thread {
 	void (*handler)(void *arg); /* work to be done */
 	void *arg; /* data used by work function */
 	bool started; /* true if the thread was started */
+#if CONFIG_DMA_DOMAIN_COALESCE
+	struct zephyr_dma_domain *domain; /* parent domain */
+	struct k_timer stall_timer; /* ends a round if a channel stalls */
+	uint32_t round; /* current coalescing round */
+	uint32_t round_fired; /* channels which raised their IRQ in this round */
+	uint32_t num_channels; /* channels registered on this core */
+	uint32_t stalled_channels; /* channels not waited for */
+#endif
 };
 
 struct zephyr_dma_domain {
@@ -100,6 +114,9 @@ static int zephyr_dma_domain_unregister(struct ll_schedule_domain *domain,
 					uint32_t num_tasks);
 static void zephyr_dma_domain_task_cancel(struct ll_schedule_domain *domain,
 					  struct task *task);
+#if CONFIG_DMA_DOMAIN_COALESCE
+static void dma_domain_stall_handler(struct k_timer *timer);
+#endif
 
 static const struct ll_schedule_domain_ops zephyr_dma_domain_ops = {
 	.domain_register	= zephyr_dma_domain_register,
@@ -131,6 +148,16 @@ struct ll_schedule_domain *zephyr_dma_domain_init(struct dma *dma_array,
 
 	list_init(&zephyr_dma_domain->irqs);
 
+#if CONFIG_DMA_DOMAIN_COALESCE
+	for (int i = 0; i < CONFIG_CORE_COUNT; i++) {
+		struct zephyr_dma_domain_thread *dt = zephyr_dma_domain->domain_thread + i;
+
+		dt->domain = zephyr_dma_domain;
+		k_timer_init(&dt->stall_timer, dma_domain_stall_handler, NULL);
+		k_timer_user_data_set(&dt->stall_timer, dt);
+	}
+#endif
+
 	/* set pdata */
 	ll_sch_domain_set_pdata(domain, zephyr_dma_domain);
 
@@ -150,6 +177,93 @@ static void zephyr_dma_domain_thread_fn(void *p1, void *p2, void *p3)
 	}
 }
 
+#if CONFIG_DMA_DOMAIN_COALESCE
+static void dma_domain_round_end(struct zephyr_dma_domain_thread *dt)
+{
+	dt->round++;
+	dt->round_fired = 0;
+}
+
+/* Called with local IRQs disabled for each channel which raised its IRQ.
+ * Returns true once all channels of the core, except the stalled ones,
+ * have raised their IRQ in the current round and the LL tick can run.
+ */
+static bool dma_domain_chan_fired(struct zephyr_dma_domain_thread *dt,
+				  struct zephyr_dma_domain_channel *chan_data)
+{
+	/* channel already accounted for in this round */
+	if (chan_data->round == dt->round)
+		return false;
+
+	chan_data->round = dt->round;
+
+	/* channel is back, wait for it again from now on */
+	if (chan_data->stalled) {
+		chan_data->stalled = false;
+		dt->stalled_channels--;
+	}
+
+	/* first channel of the round arms the stall timeout */
+	if (!dt->round_fired++)
+		k_timer_start(&dt->stall_timer,
+			      K_USEC(CONFIG_DMA_DOMAIN_COALESCE_TIMEOUT_US), K_NO_WAIT);
+
+	if (dt->round_fired < dt->num_channels - dt->stalled_channels)
+		return false;
+
+	k_timer_stop(&dt->stall_timer);
+	dma_domain_round_end(dt);
+
+	return true;
+}
+
+/* Some channel didn't raise its IRQ in time: run the LL tick from the timer
+ * and stop waiting for the late channels until they raise their IRQ again.
+ */
+static void dma_domain_stall_handler(struct k_timer *timer)
+{
+	struct zephyr_dma_domain_thread *dt = k_timer_user_data_get(timer);
+	struct zephyr_dma_domain_irq *irq_data;
+	struct zephyr_dma_domain_channel *chan_data;
+	struct list_item *i, *j;
+	uint32_t flags;
+
+	irq_local_disable(flags);
+
+	/* round completed while the timer was expiring */
+	if (!dt->round_fired) {
+		irq_local_enable(flags);
+		return;
+	}
+
+	list_for_item(i, &dt->domain->irqs) {
+		irq_data = container_of(i, struct zephyr_dma_domain_irq, list);
+		if (irq_data->dt != dt)
+			continue;
+
+		list_for_item(j, &irq_data->channels) {
+			chan_data = container_of(j, struct zephyr_dma_domain_channel, list);
+
+			if (chan_data->round == dt->round || chan_data->stalled)
+				continue;
+
+			tr_warn(&ll_tr, "DMA channel %u stalled, not waiting for it",
+				chan_data->channel->index);
+
+			chan_data->stalled = true;
+			dt->stalled_channels++;
+		}
+	}
+
+	dma_domain_round_end(dt);
+
+	irq_local_enable(flags);
+
+	if (dt->handler)
+		k_sem_give(&dt->sem);
+}
+#endif /* CONFIG_DMA_DOMAIN_COALESCE */
+
 static void dma_irq_handler(void *data)
 {
 	struct zephyr_dma_domain_irq *irq_data;
@@ -157,6 +271,10 @@ static void dma_irq_handler(void *data)
 	struct k_sem *sem;
 	struct list_item *i;
 	struct zephyr_dma_domain_channel *chan_data;
+#if CONFIG_DMA_DOMAIN_COALESCE
+	bool tick = false;
+	uint32_t flags;
+#endif
 
 	irq_data = data;
 	sem = &irq_data->dt->sem;
@@ -169,13 +287,26 @@ static void dma_irq_handler(void *data)
 	list_for_item(i, &irq_data->channels) {
 		chan_data = container_of(i, struct zephyr_dma_domain_channel, list);
 
-		if (dma_interrupt_legacy(chan_data->channel, DMA_IRQ_STATUS_GET))
+		if (dma_interrupt_legacy(chan_data->channel, DMA_IRQ_STATUS_GET)) {
 			dma_interrupt_legacy(chan_data->channel, DMA_IRQ_CLEAR);
+#if CONFIG_DMA_DOMAIN_COALESCE
+			irq_local_disable(flags);
+			if (dma_domain_chan_fired(dt, chan_data))
+				tick = true;
+			irq_local_enable(flags);
+#endif
+		}
 	}
 
 	/* clear IRQ - the mask argument is unused ATM */
 	interrupt_clear_mask(irq_data->intid, 0);
 
+#if CONFIG_DMA_DOMAIN_COALESCE
+	/* wait for the remaining channels of the round */
+	if (!tick)
+		return;
+#endif
+
 	/* give resources to thread semaphore */
 	if (dt->handler)
 		k_sem_give(sem);
@@ -335,6 +466,12 @@ static int register_dma_irq(struct zephyr_dma_domain *domain,
 
 			list_item_append(&chan_data->list, &crt_irq_data->channels);
 
+#if CONFIG_DMA_DOMAIN_COALESCE
+			/* new channel takes part starting with the current round */
+			chan_data->round = dt->round - 1;
+			dt->num_channels++;
+#endif
+
 			if (dt->started) {
 				/* the IRQ should only be enabled after the DT has
 				 * been started to avoid missing some interrupts.
@@ -585,6 +722,14 @@ static int zephyr_dma_domain_unregister(struct ll_schedule_domain *domain,
 	/* remove channel from parent IRQ's list */
 	list_item_del(&chan_data->list);
 
+#if CONFIG_DMA_DOMAIN_COALESCE
+	dt->num_channels--;
+	if (chan_data->stalled)
+		dt->stalled_channels--;
+	else if (chan_data->round == dt->round)
+		dt->round_fired--;
+#endif
+
 	/* disable DMA IRQ if need be */
 	disable_dma_irq(chan_data);
 
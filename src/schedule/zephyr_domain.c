@@ -20,6 +20,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys_clock.h>
@@ -37,7 +38,24 @@ LOG_MODULE_DECLARE(ll_schedule, CONFIG_SOF_LOG_LEVEL);
 
 #define ZEPHYR_LL_STACK_SIZE	8192
 
-K_KERNEL_STACK_ARRAY_DEFINE(ll_sched_stack, CONFIG_CORE_COUNT, ZEPHYR_LL_STACK_SIZE);
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+BUILD_ASSERT(LL_TIMER_PERIOD_US % CONFIG_ZEPHYR_LL_FAST_PERIOD_US == 0,
+	     "the LL period must be a multiple of the fast LL period");
+
+#define ZEPHYR_LL_DOMAINS	2
+
+/* the fast domain thread preempts the regular one, which is then a preemptible thread */
+#define ZEPHYR_LL_PRIORITY	0
+#define ZEPHYR_LL_FAST_PRIORITY	(-CONFIG_NUM_COOP_PRIORITIES)
+#else
+#define ZEPHYR_LL_DOMAINS	1
+
+#define ZEPHYR_LL_PRIORITY	(-CONFIG_NUM_COOP_PRIORITIES)
+#endif
+
+/* stacks of the domain threads, CONFIG_CORE_COUNT for each domain */
+K_KERNEL_STACK_ARRAY_DEFINE(ll_sched_stack, CONFIG_CORE_COUNT * ZEPHYR_LL_DOMAINS,
+			    ZEPHYR_LL_STACK_SIZE);
 
 struct zephyr_domain_thread {
 	struct k_thread ll_thread;
@@ -50,6 +68,14 @@ struct zephyr_domain {
 	struct k_timer timer;
 	struct zephyr_domain_thread domain_thread[CONFIG_CORE_COUNT];
 	struct ll_schedule_domain *ll_domain;
+	unsigned int index;		/* domain index in ll_sched_stack */
+	int priority;			/* domain thread priority */
+	const char *name;		/* domain thread name prefix */
+	bool watchdog;			/* domain threads feed the watchdog */
+#if CONFIG_ZEPHYR_LL_TICKLESS
+	uint64_t next[CONFIG_CORE_COUNT];	/* earliest tick needed by the core tasks */
+	uint64_t tick;				/* timer grid time of the last expiry */
+#endif
 #if CONFIG_CROSS_CORE_STREAM
 	atomic_t block;
 	struct k_mutex block_mutex;
@@ -117,7 +143,8 @@ static void zephyr_domain_thread_fn(void *p1, void *p2, void *p3)
 		}
 
 		/* Feed the watchdog */
-		watchdog_feed(core);
+		if (zephyr_domain->watchdog)
+			watchdog_feed(core);
 	}
 }
 
@@ -140,9 +167,23 @@ static void zephyr_domain_timer_fn(struct k_timer *timer)
 		return;
 	}
 
+#if CONFIG_ZEPHYR_LL_TICKLESS
+	/*
+	 * The periodic timer is already rearmed one period later, this expiry
+	 * is on the grid however late the interrupt is served.
+	 */
+	zephyr_domain->tick = k_timer_expires_ticks(timer) -
+		k_us_to_ticks_ceil64(zephyr_domain->ll_domain->period_us);
+#endif
+
 	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
 		struct zephyr_domain_thread *dt = zephyr_domain->domain_thread + core;
 
+#if CONFIG_ZEPHYR_LL_TICKLESS
+		/* the tasks of the core have nothing to do on this tick */
+		if (zephyr_domain->next[core] > zephyr_domain->tick)
+			continue;
+#endif
 		if (dt->handler)
 			k_sem_give(&dt->sem);
 	}
@@ -155,7 +196,7 @@ static int zephyr_domain_register(struct ll_schedule_domain *domain,
 	struct zephyr_domain *zephyr_domain = ll_sch_domain_get_pdata(domain);
 	int core = cpu_get_id();
 	struct zephyr_domain_thread *dt = zephyr_domain->domain_thread + core;
-	char thread_name[] = "ll_thread0";
+	char thread_name[16];
 	k_tid_t thread;
 	k_spinlock_key_t key;
 
@@ -167,17 +208,20 @@ static int zephyr_domain_register(struct ll_schedule_domain *domain,
 
 	dt->handler = handler;
 	dt->arg = arg;
+#if CONFIG_ZEPHYR_LL_TICKLESS
+	zephyr_domain->next[core] = 0;
+#endif
 
 	/* 10 is rather random, we better not accumulate 10 missed timer interrupts */
 	k_sem_init(&dt->sem, 0, 10);
 
-	thread_name[sizeof(thread_name) - 2] = '0' + core;
+	snprintf(thread_name, sizeof(thread_name), "%s%d", zephyr_domain->name, core);
 
 	thread = k_thread_create(&dt->ll_thread,
-				 ll_sched_stack[core],
+				 ll_sched_stack[zephyr_domain->index * CONFIG_CORE_COUNT + core],
 				 ZEPHYR_LL_STACK_SIZE,
 				 zephyr_domain_thread_fn, zephyr_domain, NULL, NULL,
-				 -CONFIG_NUM_COOP_PRIORITIES, 0, K_FOREVER);
+				 zephyr_domain->priority, 0, K_FOREVER);
 
 	k_thread_cpu_mask_clear(thread);
 	k_thread_cpu_mask_enable(thread, core);
@@ -193,16 +237,17 @@ static int zephyr_domain_register(struct ll_schedule_domain *domain,
 		k_timer_init(&zephyr_domain->timer, zephyr_domain_timer_fn, NULL);
 		k_timer_user_data_set(&zephyr_domain->timer, zephyr_domain);
 
-		k_timer_start(&zephyr_domain->timer, start, K_USEC(LL_TIMER_PERIOD_US));
+		k_timer_start(&zephyr_domain->timer, start, K_USEC(domain->period_us));
 
 		/* Enable the watchdog */
-		watchdog_enable(core);
+		if (zephyr_domain->watchdog)
+			watchdog_enable(core);
 	}
 
 	k_spin_unlock(&domain->lock, key);
 
 	tr_info(&ll_tr, "zephyr_domain_register domain->type %d domain->clk %d domain->ticks_per_ms %d period %d",
-		domain->type, domain->clk, domain->ticks_per_ms, (uint32_t)LL_TIMER_PERIOD_US);
+		domain->type, domain->clk, domain->ticks_per_ms, domain->period_us);
 
 	return 0;
 }
@@ -224,7 +269,8 @@ static int zephyr_domain_unregister(struct ll_schedule_domain *domain,
 
 	if (!atomic_read(&domain->total_num_tasks)) {
 		/* Disable the watchdog */
-		watchdog_disable(core);
+		if (zephyr_domain->watchdog)
+			watchdog_disable(core);
 
 		k_timer_stop(&zephyr_domain->timer);
 		k_timer_user_data_set(&zephyr_domain->timer, NULL);
@@ -280,18 +326,23 @@ static const struct ll_schedule_domain_ops zephyr_domain_ops = {
 #endif
 };
 
-struct ll_schedule_domain *zephyr_domain_init(int clk)
+static struct ll_schedule_domain *zephyr_domain_create(int type, int clk, uint32_t period_us,
+							unsigned int index, int priority,
+							const char *name)
 {
 	struct ll_schedule_domain *domain;
 	struct zephyr_domain *zephyr_domain;
 
-	domain = domain_init(SOF_SCHEDULE_LL_TIMER, clk, false,
-			     &zephyr_domain_ops);
+	domain = domain_init(type, clk, false, &zephyr_domain_ops);
+	domain->period_us = period_us;
 
 	zephyr_domain = rzalloc(SOF_MEM_ZONE_SYS_SHARED, 0, SOF_MEM_CAPS_RAM,
 				sizeof(*zephyr_domain));
 
 	zephyr_domain->ll_domain = domain;
+	zephyr_domain->index = index;
+	zephyr_domain->priority = priority;
+	zephyr_domain->name = name;
 
 #if CONFIG_CROSS_CORE_STREAM
 	atomic_set(&zephyr_domain->block, 0);
@@ -303,3 +354,136 @@ struct ll_schedule_domain *zephyr_domain_init(int clk)
 
 	return domain;
 }
+
+struct ll_schedule_domain *zephyr_domain_init(int clk)
+{
+	struct ll_schedule_domain *domain;
+	struct zephyr_domain *zephyr_domain;
+
+	domain = zephyr_domain_create(SOF_SCHEDULE_LL_TIMER, clk, LL_TIMER_PERIOD_US, 0,
+				      ZEPHYR_LL_PRIORITY, "ll_thread");
+	zephyr_domain = ll_sch_domain_get_pdata(domain);
+
+	/* the watchdog period follows the regular LL period */
+	zephyr_domain->watchdog = true;
+
+	return domain;
+}
+
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+struct ll_schedule_domain *zephyr_fast_domain_init(int clk)
+{
+	return zephyr_domain_create(SOF_SCHEDULE_LL_FAST, clk, CONFIG_ZEPHYR_LL_FAST_PERIOD_US, 1,
+				    ZEPHYR_LL_FAST_PRIORITY, "ll_fast");
+}
+#endif
+
+#if CONFIG_ZEPHYR_LL_TIMEOUT_COALESCE
+/*
+ * Delay an absolute expiry time in kernel ticks to the first LL timer
+ * expiry at or after it, so that the wakeup is served by the LL timer
+ * interrupt instead of programming a separate one. The expiry is returned
+ * unchanged while the LL timer isn't running.
+ */
+uint64_t zephyr_domain_align_expiry(struct ll_schedule_domain *domain, uint64_t expiry)
+{
+	struct zephyr_domain *zephyr_domain = ll_sch_domain_get_pdata(domain);
+	uint64_t period = k_us_to_ticks_ceil64(domain->period_us);
+	uint64_t next;
+
+	if (!k_timer_user_data_get(&zephyr_domain->timer))
+		return expiry;
+
+	next = k_timer_expires_ticks(&zephyr_domain->timer);
+	if (expiry <= next)
+		return next;
+
+	return next + SOF_DIV_ROUND_UP(expiry - next, period) * period;
+}
+#endif
+
+#if CONFIG_ZEPHYR_LL_TICKLESS
+/* timer grid time in kernel ticks of the tick the LL threads are serving */
+uint64_t zephyr_domain_tick(struct ll_schedule_domain *domain)
+{
+	struct zephyr_domain *zephyr_domain = ll_sch_domain_get_pdata(domain);
+
+	return zephyr_domain->tick;
+}
+
+/*
+ * Restart the LL timer on the first expiry of the period grid at or after
+ * an absolute time in kernel ticks.
+ */
+static void zephyr_domain_timer_restart(struct zephyr_domain *zephyr_domain, uint64_t at)
+{
+	uint64_t period = k_us_to_ticks_ceil64(zephyr_domain->ll_domain->period_us);
+	uint64_t next = k_timer_expires_ticks(&zephyr_domain->timer);
+
+	if (at >= next)
+		at = next + SOF_DIV_ROUND_UP(at - next, period) * period;
+	else
+		at = next - (next - at) / period * period;
+
+	if (at == next)
+		return;
+
+	k_timer_start(&zephyr_domain->timer, K_TIMEOUT_ABS_TICKS(at),
+		      K_USEC(zephyr_domain->ll_domain->period_us));
+}
+
+/*
+ * Called by the LL scheduler after a tick with the earliest time in kernel
+ * ticks any of its tasks needs to run again. When no core needs the next
+ * tick, the timer is moved to the earliest tick still needed.
+ */
+void zephyr_domain_sleep(struct ll_schedule_domain *domain, uint64_t next)
+{
+	struct zephyr_domain *zephyr_domain = ll_sch_domain_get_pdata(domain);
+	uint64_t earliest = UINT64_MAX;
+	k_spinlock_key_t key;
+	int core;
+
+	if (domain->type != SOF_SCHEDULE_LL_TIMER && domain->type != SOF_SCHEDULE_LL_FAST)
+		return;
+
+	key = k_spin_lock(&domain->lock);
+
+	zephyr_domain->next[cpu_get_id()] = next;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++)
+		if (zephyr_domain->domain_thread[core].handler)
+			earliest = MIN(earliest, zephyr_domain->next[core]);
+
+	if (k_timer_user_data_get(&zephyr_domain->timer) && earliest != UINT64_MAX &&
+	    earliest > k_timer_expires_ticks(&zephyr_domain->timer))
+		zephyr_domain_timer_restart(zephyr_domain, earliest);
+
+	k_spin_unlock(&domain->lock, key);
+}
+
+/*
+ * Called when a task of the current core needs to run earlier than it
+ * reported, brings the timer back to the first tick at or after next.
+ */
+void zephyr_domain_wake(struct ll_schedule_domain *domain, uint64_t next)
+{
+	struct zephyr_domain *zephyr_domain = ll_sch_domain_get_pdata(domain);
+	int core = cpu_get_id();
+	k_spinlock_key_t key;
+
+	if (domain->type != SOF_SCHEDULE_LL_TIMER && domain->type != SOF_SCHEDULE_LL_FAST)
+		return;
+
+	key = k_spin_lock(&domain->lock);
+
+	if (next < zephyr_domain->next[core]) {
+		zephyr_domain->next[core] = next;
+		if (k_timer_user_data_get(&zephyr_domain->timer) &&
+		    next < k_timer_expires_ticks(&zephyr_domain->timer))
+			zephyr_domain_timer_restart(zephyr_domain, next);
+	}
+
+	k_spin_unlock(&domain->lock, key);
+}
+#endif
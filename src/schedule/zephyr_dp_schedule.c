@@ -6,7 +6,9 @@
  */
 
 #include <sof/audio/component.h>
+#include <sof/audio/dp_queue.h>
 #include <sof/audio/module_adapter/module/generic.h>
+#include <sof/debug/telemetry/tracepoint.h>
 #include <rtos/task.h>
 #include <stdint.h>
 #include <sof/schedule/dp_schedule.h>
@@ -17,7 +19,10 @@
 #include <rtos/interrupt.h>
 #include <zephyr/kernel.h>
 #include <zephyr/sys_clock.h>
+#include <sof/lib/cpu-clk-manager.h>
 #include <sof/lib/notifier.h>
+#include <sof/lib/memory.h>
+#include <sof/lib/ticket_lock.h>
 
 #include <zephyr/kernel/thread.h>
 
@@ -39,8 +44,51 @@ struct task_dp_pdata {
 	k_thread_stack_t __sparse_cache *p_stack;	/* pointer to thread stack */
 	struct k_sem sem;		/* semaphore for task scheduling */
 	struct processing_module *mod;	/* the module to be scheduled */
+#if CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
+	struct list_item ready;		/* entry in the ready list of the owner core */
+	uint64_t deadline;		/* absolute deadline in Zephyr ticks */
+	bool in_progress;		/* the task is being executed by a worker */
+#endif
 };
 
+#if CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
+/* per core pool of DP worker threads */
+struct dp_worker_pool {
+	struct list_item ready;		/* ready tasks, sorted by deadline */
+	struct k_sem sem;		/* given once for each ready task */
+	uint32_t idle_workers;		/* number of workers waiting for a task */
+	struct k_thread threads[CONFIG_ZEPHYR_DP_SCHEDULER_POOL_THREADS];
+};
+
+/* same priority as per task DP threads, see pipeline-schedule.c */
+#define DP_POOL_THREAD_PRIORITY (CONFIG_NUM_PREEMPT_PRIORITIES - 2)
+
+/* data accessed by all cores */
+struct dp_pool_shared {
+	struct ticket_lock lock;	/* protects ready lists and states of all DP tasks */
+	struct dp_worker_pool *pools[CONFIG_CORE_COUNT];
+};
+
+static SHARED_DATA struct dp_pool_shared dp_pool_shared;
+
+static inline struct dp_pool_shared *dp_pool_shared_get(void)
+{
+	return platform_shared_get(&dp_pool_shared, sizeof(dp_pool_shared));
+}
+
+/* Workers may execute tasks of other cores, so a cross-core lock is required */
+static inline unsigned int scheduler_dp_lock(void)
+{
+	return ticket_lock_acquire(&dp_pool_shared_get()->lock).key;
+}
+
+static inline void scheduler_dp_unlock(unsigned int key)
+{
+	k_spinlock_key_t spin_key = { .key = key };
+
+	ticket_lock_release(&dp_pool_shared_get()->lock, spin_key);
+}
+#else
 /* Single CPU-wide lock
  * as each per-core instance if dp-scheduler has separate structures, it is enough to
  * use irq_lock instead of cross-core spinlocks
@@ -54,6 +102,7 @@ static inline void scheduler_dp_unlock(unsigned int key)
 {
 	irq_unlock(key);
 }
+#endif /* CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL */
 
 /* dummy LL task - to start LL on secondary cores */
 static enum task_state scheduler_dp_ll_tick_dummy(void *data)
@@ -213,6 +262,105 @@ static enum task_state scheduler_dp_ll_tick_dummy(void *data)
  * Now - pipeline is in stable state, CPU used almost in 100% (it would be 100% if DP3
  * needed 1.2ms for processing - but the example would be too complicated)
  */
+#if CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
+/*
+ * Number of whole periods of output already buffered in the module output queues.
+ * The module may be delayed by that many periods without starving the consumer.
+ */
+static uint32_t dp_task_buffered_periods(struct processing_module *mod)
+{
+	uint32_t periods = UINT32_MAX;
+	struct list_item *qlist;
+
+	list_for_item(qlist, &mod->dp_queue_dp_to_ll_list) {
+		struct dp_queue *dp_queue = container_of(qlist, struct dp_queue, list);
+		size_t obs = sink_get_min_free_space(dp_queue_get_sink(dp_queue));
+		size_t buffered = source_get_data_available(dp_queue_get_source(dp_queue));
+
+		if (obs)
+			periods = MIN(periods, buffered / obs);
+	}
+
+	return periods == UINT32_MAX ? 0 : periods;
+}
+
+/* must be called with scheduler_dp_lock() held */
+static void dp_pool_task_ready(struct task *task, struct task_dp_pdata *pdata)
+{
+	struct dp_pool_shared *shared = dp_pool_shared_get();
+	struct dp_worker_pool *pool = shared->pools[task->core];
+	struct task_dp_pdata *other;
+	struct list_item *rlist;
+	int core;
+
+	pdata->deadline = k_uptime_ticks() + (uint64_t)pdata->period_clock_ticks *
+			  (1 + dp_task_buffered_periods(pdata->mod));
+
+	/* keep the ready list sorted - earliest deadline first */
+	list_for_item(rlist, &pool->ready) {
+		other = container_of(rlist, struct task_dp_pdata, ready);
+		if (other->deadline > pdata->deadline)
+			break;
+	}
+	list_item_append(&pdata->ready, rlist);
+
+	if (pool->idle_workers || !pdata->mod->dp_core_agnostic) {
+		k_sem_give(&pool->sem);
+		return;
+	}
+
+	/* all workers of the owner core are busy, wake an idle core to steal the task */
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		if (shared->pools[core] && shared->pools[core]->idle_workers) {
+			k_sem_give(&shared->pools[core]->sem);
+			return;
+		}
+	}
+
+	k_sem_give(&pool->sem);
+}
+
+/*
+ * Takes the task with the earliest deadline, tasks of the local core first, then core agnostic
+ * tasks of other cores. Must be called with scheduler_dp_lock() held.
+ */
+static struct task_dp_pdata *dp_pool_task_pick(struct dp_worker_pool *pool)
+{
+	struct dp_pool_shared *shared = dp_pool_shared_get();
+	struct task_dp_pdata *best = NULL;
+	struct task_dp_pdata *pdata;
+	struct list_item *rlist;
+	int core;
+
+	if (!list_is_empty(&pool->ready)) {
+		best = list_first_item(&pool->ready, struct task_dp_pdata, ready);
+	} else {
+		for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+			if (!shared->pools[core] || shared->pools[core] == pool)
+				continue;
+
+			list_for_item(rlist, &shared->pools[core]->ready) {
+				pdata = container_of(rlist, struct task_dp_pdata, ready);
+				if (!pdata->mod->dp_core_agnostic)
+					continue;
+				if (!best || pdata->deadline < best->deadline)
+					best = pdata;
+				/* list is sorted, the first agnostic task is the earliest one */
+				break;
+			}
+		}
+	}
+
+	if (best) {
+		list_item_del(&best->ready);
+		list_init(&best->ready);
+		best->in_progress = true;
+	}
+
+	return best;
+}
+#endif /* CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL */
+
 void scheduler_dp_ll_tick(void *receiver_data, enum notify_id event_type, void *caller_data)
 {
 	(void)receiver_data;
@@ -239,12 +387,15 @@ void scheduler_dp_ll_tick(void *receiver_data, enum notify_id event_type, void *
 							       mod->sinks,
 							       mod->num_of_sinks);
 			if (mod_ready) {
-				/* set a deadline for given num of ticks, starting now */
-				k_thread_deadline_set(pdata->thread_id, pdata->period_clock_ticks);
-
 				/* trigger the task */
 				curr_task->state = SOF_TASK_STATE_RUNNING;
+#if CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
+				dp_pool_task_ready(curr_task, pdata);
+#else
+				/* set a deadline for given num of ticks, starting now */
+				k_thread_deadline_set(pdata->thread_id, pdata->period_clock_ticks);
 				k_sem_give(&pdata->sem);
+#endif
 			}
 		}
 	}
@@ -277,15 +428,137 @@ static int scheduler_dp_task_free(void *data, struct task *task)
 
 	scheduler_dp_task_cancel(data, task);
 
+#if CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
+	unsigned int lock_key = scheduler_dp_lock();
+
+	/* drop the task from the ready list if it has not been picked up yet */
+	list_item_del(&pdata->ready);
+	list_init(&pdata->ready);
+
+	/* wait for a worker, possibly on another core, to finish the run in progress */
+	while (pdata->in_progress) {
+		scheduler_dp_unlock(lock_key);
+		k_msleep(1);
+		lock_key = scheduler_dp_lock();
+	}
+	scheduler_dp_unlock(lock_key);
+#else
 	/* abort the execution of the thread */
 	k_thread_abort(pdata->thread_id);
 	/* free task stack */
 	rfree((__sparse_force void *)pdata->p_stack);
+#endif
 
 	/* all other memory has been allocated as a single malloc, will be freed later by caller */
 	return 0;
 }
 
+/*
+ * Sets the state returned by task run procedure and calls task_complete() when needed.
+ * Must be called with scheduler_dp_lock() held, releases the lock.
+ */
+static void scheduler_dp_task_run_done(struct task *task, enum task_state state,
+				       unsigned int lock_key)
+{
+	/*
+	 * check if task is still running, may have been canceled by external call
+	 * if not, set the state returned by run procedure
+	 */
+	if (task->state == SOF_TASK_STATE_RUNNING) {
+		task->state = state;
+		switch (state) {
+		case SOF_TASK_STATE_RESCHEDULE:
+			/* mark to reschedule, schedule time is already calculated */
+			task->state = SOF_TASK_STATE_QUEUED;
+			break;
+
+		case SOF_TASK_STATE_CANCEL:
+		case SOF_TASK_STATE_COMPLETED:
+			/* remove from scheduling */
+			list_item_del(&task->list);
+			break;
+
+		default:
+			/* illegal state, serious defect, won't happen */
+			k_panic();
+		}
+	}
+
+	/* call task_complete  */
+	if (task->state == SOF_TASK_STATE_COMPLETED) {
+		/* call task_complete out of lock, it may eventually call schedule again */
+		scheduler_dp_unlock(lock_key);
+		task_complete(task);
+	} else {
+		scheduler_dp_unlock(lock_key);
+	}
+}
+
+#if CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
+/* Worker thread function, executes ready tasks of its own core or steals from other cores */
+static void dp_pool_thread_fn(void *p1, void *p2, void *p3)
+{
+	struct dp_worker_pool *pool = p1;
+	(void)p2;
+	(void)p3;
+	struct task_dp_pdata *pdata;
+	unsigned int lock_key;
+	enum task_state state;
+#if CONFIG_KCPS_DVFS_GOVERNOR
+	uint64_t start;
+#endif
+	struct task *task;
+	int64_t deadline;
+
+	while (1) {
+		lock_key = scheduler_dp_lock();
+		pool->idle_workers++;
+		scheduler_dp_unlock(lock_key);
+
+		k_sem_take(&pool->sem, K_FOREVER);
+
+		lock_key = scheduler_dp_lock();
+		pool->idle_workers--;
+		pdata = dp_pool_task_pick(pool);
+		scheduler_dp_unlock(lock_key);
+
+		/* the task may have been taken by a worker of another core */
+		if (!pdata)
+			continue;
+
+		task = pdata->mod->dev->task;
+
+		/* let Zephyr EDF order the workers of this core by task deadline */
+		deadline = (int64_t)(pdata->deadline - k_uptime_ticks());
+		k_thread_deadline_set(k_current_get(), MAX(deadline, 1));
+
+		if (task->state == SOF_TASK_STATE_RUNNING) {
+			SOF_TRACEPOINT(SOF_TRACEPOINT_DP_TASK, SOF_TRACEPOINT_BEGIN,
+				       (uint32_t)(uintptr_t)task, 0);
+#if CONFIG_KCPS_DVFS_GOVERNOR
+			start = sof_cycle_get_64();
+			state = task_run(task);
+			/* includes LL ticks preempting the task, so the DVFS
+			 * governor rather overestimates the load
+			 */
+			core_kcps_busy_add(sof_cycle_get_64() - start);
+#else
+			state = task_run(task);
+#endif
+			SOF_TRACEPOINT(SOF_TRACEPOINT_DP_TASK, SOF_TRACEPOINT_END,
+				       (uint32_t)(uintptr_t)task, 0);
+		} else {
+			state = task->state;	/* to avoid undefined variable warning */
+		}
+
+		lock_key = scheduler_dp_lock();
+		pdata->in_progress = false;
+		scheduler_dp_task_run_done(task, state, lock_key);
+	}
+
+	/* never be here */
+}
+#else
 /* Thread function called in component context, on target core */
 static void dp_thread_fn(void *p1, void *p2, void *p3)
 {
@@ -295,6 +568,9 @@ static void dp_thread_fn(void *p1, void *p2, void *p3)
 	struct task_dp_pdata *task_pdata = task->priv_data;
 	unsigned int lock_key;
 	enum task_state state;
+#if CONFIG_KCPS_DVFS_GOVERNOR
+	uint64_t start;
+#endif
 
 	while (1) {
 		/*
@@ -303,48 +579,32 @@ static void dp_thread_fn(void *p1, void *p2, void *p3)
 		 */
 		k_sem_take(&task_pdata->sem, K_FOREVER);
 
-		if (task->state == SOF_TASK_STATE_RUNNING)
+		if (task->state == SOF_TASK_STATE_RUNNING) {
+			SOF_TRACEPOINT(SOF_TRACEPOINT_DP_TASK, SOF_TRACEPOINT_BEGIN,
+				       (uint32_t)(uintptr_t)task, 0);
+#if CONFIG_KCPS_DVFS_GOVERNOR
+			start = sof_cycle_get_64();
+			state = task_run(task);
+			/* includes LL ticks preempting the task, so the DVFS
+			 * governor rather overestimates the load
+			 */
+			core_kcps_busy_add(sof_cycle_get_64() - start);
+#else
 			state = task_run(task);
-		else
+#endif
+			SOF_TRACEPOINT(SOF_TRACEPOINT_DP_TASK, SOF_TRACEPOINT_END,
+				       (uint32_t)(uintptr_t)task, 0);
+		} else {
 			state = task->state;	/* to avoid undefined variable warning */
-
-		lock_key = scheduler_dp_lock();
-		/*
-		 * check if task is still running, may have been canceled by external call
-		 * if not, set the state returned by run procedure
-		 */
-		if (task->state == SOF_TASK_STATE_RUNNING) {
-			task->state = state;
-			switch (state) {
-			case SOF_TASK_STATE_RESCHEDULE:
-				/* mark to reschedule, schedule time is already calculated */
-				task->state = SOF_TASK_STATE_QUEUED;
-				break;
-
-			case SOF_TASK_STATE_CANCEL:
-			case SOF_TASK_STATE_COMPLETED:
-				/* remove from scheduling */
-				list_item_del(&task->list);
-				break;
-
-			default:
-				/* illegal state, serious defect, won't happen */
-				k_panic();
-			}
 		}
 
-		/* call task_complete  */
-		if (task->state == SOF_TASK_STATE_COMPLETED) {
-			/* call task_complete out of lock, it may eventually call schedule again */
-			scheduler_dp_unlock(lock_key);
-			task_complete(task);
-		} else {
-			scheduler_dp_unlock(lock_key);
-		}
+		lock_key = scheduler_dp_lock();
+		scheduler_dp_task_run_done(task, state, lock_key);
 	};
 
 	/* never be here */
 }
+#endif /* CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL */
 
 static int scheduler_dp_task_shedule(void *data, struct task *task, uint64_t start,
 				     uint64_t period)
@@ -390,6 +650,55 @@ static struct scheduler_ops schedule_dp_ops = {
 	.schedule_task_free	= scheduler_dp_task_free,
 };
 
+#if CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
+static int scheduler_dp_pool_init(void)
+{
+	const size_t stack_size = Z_KERNEL_STACK_SIZE_ADJUST(CONFIG_ZEPHYR_DP_SCHEDULER_POOL_STACK_SIZE);
+	int core = cpu_get_id();
+	struct dp_worker_pool *pool;
+	void __sparse_cache *p_stack;
+	k_tid_t thread_id;
+	int i;
+
+	/* the primary core initializes the scheduler before secondary cores start */
+	if (core == PLATFORM_PRIMARY_CORE_ID)
+		ticket_lock_init(&dp_pool_shared_get()->lock, "dp_pool");
+
+	/* kernel objects must be located in shared, non cached memory */
+	pool = rzalloc(SOF_MEM_ZONE_SYS_SHARED, 0, SOF_MEM_CAPS_RAM, sizeof(*pool));
+	if (!pool)
+		return -ENOMEM;
+
+	list_init(&pool->ready);
+	k_sem_init(&pool->sem, 0, K_SEM_MAX_LIMIT);
+
+	for (i = 0; i < CONFIG_ZEPHYR_DP_SCHEDULER_POOL_THREADS; i++) {
+		/* workers live as long as the scheduler, stacks are never freed */
+		p_stack = (__sparse_force void __sparse_cache *)
+			rballoc_align(SOF_MEM_FLAG_CORE_LOCAL, SOF_MEM_CAPS_RAM, stack_size,
+				      Z_KERNEL_STACK_OBJ_ALIGN);
+		if (!p_stack) {
+			tr_err(&dp_tr, "scheduler_dp_pool_init(): stack alloc failed");
+			return -ENOMEM;
+		}
+
+		thread_id = k_thread_create(&pool->threads[i], (__sparse_force void *)p_stack,
+					    stack_size, dp_pool_thread_fn, pool, NULL, NULL,
+					    DP_POOL_THREAD_PRIORITY, K_USER, K_FOREVER);
+		if (!thread_id || k_thread_cpu_pin(thread_id, core) < 0) {
+			tr_err(&dp_tr, "scheduler_dp_pool_init(): worker thread create failed");
+			return -EFAULT;
+		}
+
+		k_thread_start(thread_id);
+	}
+
+	dp_pool_shared_get()->pools[core] = pool;
+
+	return 0;
+}
+#endif /* CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL */
+
 int scheduler_dp_init(void)
 {
 	int ret;
@@ -400,6 +709,12 @@ int scheduler_dp_init(void)
 
 	list_init(&dp_sch->tasks);
 
+#if CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
+	ret = scheduler_dp_pool_init();
+	if (ret)
+		return ret;
+#endif
+
 	scheduler_init(SOF_SCHEDULE_DP, &schedule_dp_ops, dp_sch);
 
 	/* init src of DP tick */
@@ -431,7 +746,9 @@ int scheduler_dp_task_init(struct task **task,
 	struct {
 		struct task task;
 		struct task_dp_pdata pdata;
+#if !CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
 		struct k_thread thread;
+#endif
 	} *task_memory;
 
 	k_tid_t thread_id = NULL;
@@ -454,10 +771,12 @@ int scheduler_dp_task_init(struct task **task,
 		return -ENOMEM;
 	}
 
+#if !CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
 	/* allocate stack - must be aligned and cached so a separate alloc */
 	stack_size = Z_KERNEL_STACK_SIZE_ADJUST(stack_size);
 	p_stack = (__sparse_force void __sparse_cache *)
-		rballoc_align(0, SOF_MEM_CAPS_RAM, stack_size, Z_KERNEL_STACK_OBJ_ALIGN);
+		rballoc_align(SOF_MEM_FLAG_CORE_LOCAL, SOF_MEM_CAPS_RAM, stack_size,
+			      Z_KERNEL_STACK_OBJ_ALIGN);
 	if (!p_stack) {
 		tr_err(&dp_tr, "zephyr_dp_task_init(): stack alloc failed");
 		ret = -ENOMEM;
@@ -480,6 +799,7 @@ int scheduler_dp_task_init(struct task **task,
 		tr_err(&dp_tr, "zephyr_dp_task_init(): zephyr task pin to core failed");
 		goto err;
 	}
+#endif /* !CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL */
 
 	/* internal SOF task init */
 	ret = schedule_task_init(&task_memory->task, uid, SOF_SCHEDULE_DP, 0, ops->run,
@@ -505,8 +825,13 @@ int scheduler_dp_task_init(struct task **task,
 	task_memory->pdata.mod = mod;
 	*task = &task_memory->task;
 
+#if CONFIG_ZEPHYR_DP_SCHEDULER_THREAD_POOL
+	/* tasks are executed by the worker pool, no dedicated thread nor stack */
+	list_init(&task_memory->pdata.ready);
+#else
 	/* start the thread - it will immediately stop at a semaphore */
 	k_thread_start(thread_id);
+#endif
 
 	return 0;
 err:
@@ -7,7 +7,10 @@
 #include <sof/list.h>
 #include <rtos/spinlock.h>
 #include <sof/audio/component.h>
+#include <sof/debug/telemetry/telemetry.h>
+#include <sof/debug/telemetry/tracepoint.h>
 #include <rtos/interrupt.h>
+#include <sof/lib/cpu-clk-manager.h>
 #include <sof/lib/notifier.h>
 #include <sof/schedule/ll_schedule_domain.h>
 #include <sof/schedule/schedule.h>
@@ -29,6 +32,9 @@ struct zephyr_ll {
 	unsigned int n_tasks;			/* task counter */
 	struct ll_schedule_domain *ll_domain;	/* scheduling domain */
 	unsigned int core;			/* core ID of this instance */
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+	uint32_t overruns;			/* ticks longer than the period */
+#endif
 };
 
 /* per-task scheduler data */
@@ -36,6 +42,14 @@ struct zephyr_ll_pdata {
 	bool run;
 	bool freeing;
 	struct k_sem sem;
+#if CONFIG_ZEPHYR_LL_PERIOD_MULTIPLIER
+	unsigned int period_ticks;		/* task period in scheduler ticks */
+#if CONFIG_ZEPHYR_LL_TICKLESS
+	uint64_t next_run;			/* timer grid time of the next run */
+#else
+	unsigned int ticks_left;		/* ticks to skip before next run */
+#endif
+#endif
 };
 
 static void zephyr_ll_lock(struct zephyr_ll *sch, uint32_t *flags)
@@ -98,7 +112,8 @@ static void zephyr_ll_task_insert_unlocked(struct zephyr_ll *sch, struct task *t
 	/*
 	 * Tasks are added into the list from highest to lowest priority. This
 	 * way they can then be run in the same order. Tasks with the same
-	 * priority are served on a first-come-first-serve basis
+	 * priority are served on a first-come-first-serve basis, or with
+	 * CONFIG_ZEPHYR_LL_FLOW_ORDER in the order of their flow rank
 	 */
 	list_for_item(list, &sch->tasks) {
 		task_iter = container_of(list, struct task, list);
@@ -106,6 +121,13 @@ static void zephyr_ll_task_insert_unlocked(struct zephyr_ll *sch, struct task *t
 			list_item_append(&task->list, &task_iter->list);
 			break;
 		}
+#if CONFIG_ZEPHYR_LL_FLOW_ORDER
+		if (task->priority == task_iter->priority &&
+		    task->flow_rank < task_iter->flow_rank) {
+			list_item_append(&task->list, &task_iter->list);
+			break;
+		}
+#endif
 	}
 
 	/*
@@ -147,6 +169,68 @@ static inline enum task_state do_task_run(struct task *task)
 	return state;
 }
 
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+/* budget accounting of one tick */
+struct zephyr_ll_tick {
+	uint64_t start;
+	uint64_t period_cycles;
+	uint32_t task;				/* task reported on an overrun */
+	uint32_t excess;			/* cycles of that task over its budget */
+	bool over_budget;			/* a task of the tick went over its budget */
+	struct telemetry_ll_overrun incident;
+};
+
+static void zephyr_ll_tick_start(const struct zephyr_ll *sch, struct zephyr_ll_tick *tick)
+{
+	memset(tick, 0, sizeof(*tick));
+	tick->period_cycles = k_us_to_cyc_floor64(sch->ll_domain->period_us);
+	tick->start = sof_cycle_get_64();
+}
+
+/* keeps the task furthest over its budget, or the longest one while none is over */
+static void zephyr_ll_tick_account(struct zephyr_ll_tick *tick, const struct task *task,
+				   uint32_t cycles)
+{
+	uint32_t budget = task->cycles_budget;
+
+	if (budget && cycles > budget) {
+		if (tick->over_budget && cycles - budget <= tick->excess)
+			return;
+		tick->over_budget = true;
+		tick->excess = cycles - budget;
+	} else if (tick->over_budget || cycles <= tick->incident.task_cycles) {
+		return;
+	}
+
+	/* the task may be freed before the end of the tick, keep a copy */
+	tick->task = (uint32_t)(uintptr_t)task;
+	tick->incident.task_uuid = task->uid ? task->uid->id.a : 0;
+	tick->incident.task_cycles = cycles;
+	tick->incident.task_budget = budget;
+}
+
+#if CONFIG_ZEPHYR_LL_OVERRUN_SKIP
+static bool zephyr_ll_tick_overrunning(const struct zephyr_ll_tick *tick)
+{
+	return tick->over_budget || sof_cycle_get_64() - tick->start > tick->period_cycles;
+}
+#endif
+
+static void zephyr_ll_tick_end(struct zephyr_ll *sch, struct zephyr_ll_tick *tick)
+{
+	uint64_t cycles = sof_cycle_get_64() - tick->start;
+
+	if (cycles <= tick->period_cycles)
+		return;
+
+	tick->incident.tick_cycles = cycles;
+	tick->incident.period_cycles = tick->period_cycles;
+	tick->incident.overruns = ++sch->overruns;
+	telemetry_post(TELEMETRY_RECORD_LL_OVERRUN, tick->task, &tick->incident,
+		       sizeof(tick->incident));
+}
+#endif /* CONFIG_ZEPHYR_LL_TASK_BUDGET */
+
 /*
  * Task state machine:
  * INIT:	initialized
@@ -173,6 +257,21 @@ static void zephyr_ll_run(void *data)
 	struct task *task;
 	struct list_item *list, *tmp, task_head = LIST_INIT(task_head);
 	uint32_t flags;
+#if CONFIG_KCPS_DVFS_GOVERNOR
+	uint64_t start = sof_cycle_get_64();
+#endif
+#if CONFIG_ZEPHYR_LL_TICKLESS
+	/* timer grid time of this tick, the timer interrupt latency doesn't move it */
+	uint64_t now = zephyr_domain_tick(sch->ll_domain);
+	uint64_t period = k_us_to_ticks_ceil64(sch->ll_domain->period_us);
+	uint64_t next = UINT64_MAX;
+#endif
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+	struct zephyr_ll_tick tick;
+	uint64_t task_start;
+
+	zephyr_ll_tick_start(sch, &tick);
+#endif
 
 	zephyr_ll_lock(sch, &flags);
 
@@ -197,6 +296,40 @@ static void zephyr_ll_run(void *data)
 			continue;
 		}
 
+#if CONFIG_ZEPHYR_LL_TICKLESS
+		/*
+		 * The timer skips the ticks no task needs, so they can't be
+		 * counted. Long period tasks keep the grid time of their next
+		 * run instead.
+		 */
+		if (pdata->next_run > now) {
+			list_item_del(list);
+			list_item_append(list, &task_head);
+			continue;
+		}
+		pdata->next_run = now + pdata->period_ticks * period;
+#elif CONFIG_ZEPHYR_LL_PERIOD_MULTIPLIER
+		/* long period tasks run once every period_ticks on a larger block */
+		if (pdata->ticks_left) {
+			pdata->ticks_left--;
+			list_item_del(list);
+			list_item_append(list, &task_head);
+			continue;
+		}
+		pdata->ticks_left = pdata->period_ticks - 1;
+#endif
+
+#if CONFIG_ZEPHYR_LL_OVERRUN_SKIP
+		/* leave the rest of an overrunning tick to the critical tasks */
+		if ((task->flags & SOF_SCHEDULE_TASK_NON_CRITICAL) &&
+		    zephyr_ll_tick_overrunning(&tick)) {
+			tick.incident.skipped++;
+			list_item_del(list);
+			list_item_append(list, &task_head);
+			continue;
+		}
+#endif
+
 		pdata->run = true;
 		task->state = SOF_TASK_STATE_RUNNING;
 
@@ -210,7 +343,17 @@ static void zephyr_ll_run(void *data)
 		 * task's .run() should only return either
 		 * SOF_TASK_STATE_COMPLETED or SOF_TASK_STATE_RESCHEDULE
 		 */
+		SOF_TRACEPOINT(SOF_TRACEPOINT_LL_TASK, SOF_TRACEPOINT_BEGIN,
+			       (uint32_t)(uintptr_t)task, 0);
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+		task_start = sof_cycle_get_64();
+		state = do_task_run(task);
+		zephyr_ll_tick_account(&tick, task, sof_cycle_get_64() - task_start);
+#else
 		state = do_task_run(task);
+#endif
+		SOF_TRACEPOINT(SOF_TRACEPOINT_LL_TASK, SOF_TRACEPOINT_END,
+			       (uint32_t)(uintptr_t)task, 0);
 		if (state != SOF_TASK_STATE_COMPLETED &&
 		    state != SOF_TASK_STATE_RESCHEDULE) {
 			tr_err(&ll_tr,
@@ -240,12 +383,28 @@ static void zephyr_ll_run(void *data)
 
 	/* Move tasks back */
 	list_for_item_safe(list, tmp, &task_head) {
+#if CONFIG_ZEPHYR_LL_TICKLESS
+		task = container_of(list, struct task, list);
+		next = MIN(next, ((struct zephyr_ll_pdata *)task->priv_data)->next_run);
+#endif
 		list_item_del(list);
 		list_item_append(list, &sch->tasks);
 	}
 
 	zephyr_ll_unlock(sch, &flags);
 
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+	zephyr_ll_tick_end(sch, &tick);
+#endif
+
+#if CONFIG_ZEPHYR_LL_TICKLESS
+	zephyr_domain_sleep(sch->ll_domain, next);
+#endif
+
+#if CONFIG_KCPS_DVFS_GOVERNOR
+	core_kcps_ll_tick(start);
+#endif
+
 	notifier_event(sch, NOTIFIER_ID_LL_POST_RUN,
 		       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
 }
@@ -254,9 +413,10 @@ static void zephyr_ll_run(void *data)
  * Called once for periodic tasks or multiple times for one-shot tasks
  * TODO: start should be ignored in Zephyr LL scheduler implementation. Tasks
  * are scheduled to start on the following tick and run on each subsequent timer
- * event. In the future we shall add support for long-period tasks with periods
- * equal to a multiple of the scheduler tick time. Ignoring start will eliminate
- * the use of task::start and ll_schedule_domain::next in this scheduler.
+ * event. With CONFIG_ZEPHYR_LL_PERIOD_MULTIPLIER tasks with periods equal to a
+ * multiple of the scheduler tick time run only on every n-th tick. Ignoring start
+ * will eliminate the use of task::start and ll_schedule_domain::next in this
+ * scheduler.
  */
 static int zephyr_ll_task_schedule_common(struct zephyr_ll *sch, struct task *task,
 					  uint64_t start, uint64_t period,
@@ -314,6 +474,16 @@ static int zephyr_ll_task_schedule_common(struct zephyr_ll *sch, struct task *ta
 		return 0;
 	}
 
+#if CONFIG_ZEPHYR_LL_PERIOD_MULTIPLIER
+	/* start is ignored, the task runs on the next tick and then every period */
+	pdata->period_ticks = MAX(period / sch->ll_domain->period_us, 1);
+#if CONFIG_ZEPHYR_LL_TICKLESS
+	pdata->next_run = 0;
+#else
+	pdata->ticks_left = 0;
+#endif
+#endif
+
 	if (!reference)
 		zephyr_ll_task_insert_unlocked(sch, task);
 	else if (before)
@@ -330,6 +500,10 @@ static int zephyr_ll_task_schedule_common(struct zephyr_ll *sch, struct task *ta
 		tr_err(&ll_tr, "zephyr_ll_task_schedule: cannot register domain %d",
 		       ret);
 
+#if CONFIG_ZEPHYR_LL_TICKLESS
+	zephyr_domain_wake(sch->ll_domain, k_uptime_ticks());
+#endif
+
 	return 0;
 }
 
@@ -413,7 +587,7 @@ static int zephyr_ll_task_free(void *data, struct task *task)
 
 	if (must_wait)
 		/* Wait for up to 100 periods */
-		k_sem_take(&pdata->sem, K_USEC(LL_TIMER_PERIOD_US * 100));
+		k_sem_take(&pdata->sem, K_USEC(sch->ll_domain->period_us * 100));
 
 	/* Protect against racing with schedule_task() */
 	zephyr_ll_lock(sch, &flags);
@@ -521,6 +695,9 @@ int zephyr_ll_scheduler_init(struct ll_schedule_domain *domain)
 	sch->ll_domain = domain;
 	sch->core = cpu_get_id();
 	sch->n_tasks = 0;
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+	sch->overruns = 0;
+#endif
 
 	scheduler_init(domain->type, &zephyr_ll_ops, sch);
 
@@ -10,6 +10,7 @@
 #include <sof/ipc/msg.h>
 #include <rtos/alloc.h>
 #include <rtos/cache.h>
+#include <rtos/interrupt.h>
 #include <sof/lib/cpu.h>
 #include <sof/lib/dma.h>
 #include <sof/lib/memory.h>
@@ -26,6 +27,7 @@
 #include <ipc/trace.h>
 #include <kernel/abi.h>
 #include <user/abi_dbg.h>
+#include <user/trace.h>
 #include <sof_versions.h>
 
 #ifdef __ZEPHYR__
@@ -52,6 +54,54 @@ static int dma_trace_get_avail_data(struct dma_trace_data *d,
 				    struct dma_trace_buf *buffer,
 				    int avail);
 
+#if CONFIG_TRACE_BINARY_PERCORE
+static void dtrace_merge_rings(struct dma_trace_data *d);
+#endif
+
+/** Updates the pointers once size bytes are copied to host */
+static void trace_work_done(void *data, int32_t size)
+{
+	struct dma_trace_data *d = data;
+	struct dma_trace_buf *buffer = &d->dmatb;
+	k_spinlock_key_t key;
+
+	if (size < 0) {
+		tr_err(&dt_tr, "trace_work(): dma_copy_to_host() failed");
+		goto out;
+	}
+
+	/* update host pointer and check for wrap */
+	d->posn.host_offset += size;
+	if (d->posn.host_offset >= d->host_size)
+		d->posn.host_offset -= d->host_size;
+
+	/* update local pointer and check for wrap */
+	buffer->r_ptr = (char *)buffer->r_ptr + size;
+	if (buffer->r_ptr >= buffer->end_addr)
+		buffer->r_ptr = (char *)buffer->r_ptr - DMA_TRACE_LOCAL_SIZE;
+
+	ipc_msg_send(d->msg, &d->posn, false);
+
+out:
+	key = k_spin_lock(&d->lock);
+
+	/* disregard any old messages and don't resend them if we overflow */
+	if (size > 0) {
+		if (d->posn.overflow)
+			buffer->avail = DMA_TRACE_LOCAL_SIZE - size;
+		else
+			buffer->avail -= size;
+	}
+
+	/* DMA trace copying is done, allow reschedule */
+	d->copy_in_progress = 0;
+#if CONFIG_DMA_COPY_ASYNC
+	d->copy_pending = 0;
+#endif
+
+	k_spin_unlock(&d->lock, key);
+}
+
 /** Periodically runs and starts the DMA even when the buffer is not
  * full.
  */
@@ -60,15 +110,26 @@ static enum task_state trace_work(void *data)
 	struct dma_trace_data *d = data;
 	struct dma_trace_buf *buffer = &d->dmatb;
 	struct dma_sg_config *config = &d->config;
-	k_spinlock_key_t key;
-	uint32_t avail = buffer->avail;
+	uint32_t avail;
 	int32_t size;
 	uint32_t overflow;
 
+#if CONFIG_TRACE_BINARY_PERCORE
+	dtrace_merge_rings(d);
+#endif
+
 	/* The host DMA channel is not available */
 	if (!d->dc.chan)
 		return SOF_TASK_STATE_RESCHEDULE;
 
+#if CONFIG_DMA_COPY_ASYNC
+	/* complete the copy started on the previous run */
+	dma_copy_async_poll(&d->dc);
+	if (d->copy_pending)
+		return SOF_TASK_STATE_RESCHEDULE;
+#endif
+	avail = buffer->avail;
+
 	if (!ipc_trigger_trace_xfer(avail))
 		return SOF_TASK_STATE_RESCHEDULE;
 
@@ -95,41 +156,19 @@ static enum task_state trace_work(void *data)
 	/* DMA trace copying is working */
 	d->copy_in_progress = 1;
 
+#if CONFIG_DMA_COPY_ASYNC
+	/* the pointers are updated once the copy is done */
+	d->copy_pending = 1;
+	size = dma_copy_to_host_async(&d->dc, config, d->posn.host_offset,
+				      buffer->r_ptr, size, trace_work_done, d);
+	if (size < 0)
+		trace_work_done(d, size);
+#else
 	/* copy this section to host */
 	size = dma_copy_to_host(&d->dc, config, d->posn.host_offset,
 				buffer->r_ptr, size);
-	if (size < 0) {
-		tr_err(&dt_tr, "trace_work(): dma_copy_to_host() failed");
-		goto out;
-	}
-
-	/* update host pointer and check for wrap */
-	d->posn.host_offset += size;
-	if (d->posn.host_offset >= d->host_size)
-		d->posn.host_offset -= d->host_size;
-
-	/* update local pointer and check for wrap */
-	buffer->r_ptr = (char *)buffer->r_ptr + size;
-	if (buffer->r_ptr >= buffer->end_addr)
-		buffer->r_ptr = (char *)buffer->r_ptr - DMA_TRACE_LOCAL_SIZE;
-
-	ipc_msg_send(d->msg, &d->posn, false);
-
-out:
-	key = k_spin_lock(&d->lock);
-
-	/* disregard any old messages and don't resend them if we overflow */
-	if (size > 0) {
-		if (d->posn.overflow)
-			buffer->avail = DMA_TRACE_LOCAL_SIZE - size;
-		else
-			buffer->avail -= size;
-	}
-
-	/* DMA trace copying is done, allow reschedule */
-	d->copy_in_progress = 0;
-
-	k_spin_unlock(&d->lock, key);
+	trace_work_done(d, size);
+#endif
 
 	/* reschedule the trace copying work */
 	return SOF_TASK_STATE_RESCHEDULE;
@@ -179,6 +218,41 @@ err:
 	return ret;
 }
 
+#if CONFIG_TRACE_BINARY_PERCORE
+STATIC_ASSERT(!(CONFIG_TRACE_CORE_RING_SIZE & (CONFIG_TRACE_CORE_RING_SIZE - 1)),
+	      trace_core_ring_size_not_power_of_two);
+
+/* compact blocks are merged into the DMA trace buffer as a single event */
+#define DTRACE_BLOCK_SIZE	(DMA_TRACE_LOCAL_SIZE / 8)
+
+/* entry length byte, 64 bit timestamp delta, 4 ids and arguments */
+#define DTRACE_COMPACT_ENTRY_MAX	(1 + 10 + 5 * (4 + _TRACE_EVENT_MAX_ARGUMENT_COUNT))
+
+/** Rings are used by all cores without a lock, so they are never freed */
+static int dtrace_rings_init(struct dma_trace_data *d)
+{
+	uint8_t *rings;
+	int i;
+
+	rings = rzalloc(SOF_MEM_ZONE_RUNTIME_SHARED, 0, SOF_MEM_CAPS_RAM,
+			CONFIG_CORE_COUNT * CONFIG_TRACE_CORE_RING_SIZE);
+	if (!rings)
+		return -ENOMEM;
+
+	d->block = rzalloc(SOF_MEM_ZONE_RUNTIME_SHARED, 0, SOF_MEM_CAPS_RAM,
+			   DTRACE_BLOCK_SIZE);
+	if (!d->block) {
+		rfree(rings);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < CONFIG_CORE_COUNT; i++)
+		d->rings[i].addr = rings + i * CONFIG_TRACE_CORE_RING_SIZE;
+
+	return 0;
+}
+#endif
+
 /** Run after dma_trace_init_early() and before dma_trace_enable() */
 int dma_trace_init_complete(struct dma_trace_data *d)
 {
@@ -215,7 +289,15 @@ int dma_trace_init_complete(struct dma_trace_data *d)
 
 	schedule_task_init_ll(&d->dmat_work, SOF_UUID(dma_trace_task_uuid),
 			      SOF_SCHEDULE_LL_TIMER,
-			      SOF_TASK_PRI_MED, trace_work, d, 0, 0);
+			      SOF_TASK_PRI_MED, trace_work, d, 0,
+			      SOF_SCHEDULE_TASK_NON_CRITICAL);
+
+#if CONFIG_TRACE_BINARY_PERCORE
+	ret = dtrace_rings_init(d);
+	if (ret < 0)
+		mtrace_printf(LOG_LEVEL_ERROR,
+			      "dma_trace_init_complete(): dtrace_rings_init() failed: %d", ret);
+#endif
 
 out:
 
@@ -382,6 +464,11 @@ static int dma_trace_start(struct dma_trace_data *d)
 
 		schedule_task_cancel(&d->dmat_work);
 		err = dma_stop_legacy(d->dc.chan);
+#if CONFIG_DMA_COPY_ASYNC
+		dma_copy_async_reset(&d->dc);
+		d->copy_pending = 0;
+		d->copy_in_progress = 0;
+#endif
 		if (err < 0) {
 			mtrace_printf(LOG_LEVEL_ERROR,
 				      "dma_trace_start(): DMA channel failed to stop");
@@ -516,6 +603,13 @@ void dma_trace_disable(struct dma_trace_data *d)
 		d->dc.chan = NULL;
 	}
 
+#if CONFIG_DMA_COPY_ASYNC
+	/* the copy in flight is dropped with the channel */
+	dma_copy_async_reset(&d->dc);
+	d->copy_pending = 0;
+	d->copy_in_progress = 0;
+#endif
+
 #if (CONFIG_HOST_PTABLE)
 	/* Free up the host SG if it is set */
 	if (d->host_size) {
@@ -749,6 +843,152 @@ void dtrace_event(const char *e, uint32_t length)
 
 }
 
+#if CONFIG_TRACE_BINARY_PERCORE
+static uint8_t *dtrace_put_varint(uint8_t *p, uint64_t value)
+{
+	while (value >= 0x80) {
+		*p++ = (value & 0x7f) | 0x80;
+		value >>= 7;
+	}
+	*p++ = value;
+
+	return p;
+}
+
+static inline uint8_t dtrace_ring_byte(const struct dtrace_core_ring *ring, uint32_t pos)
+{
+	return ring->addr[pos & (CONFIG_TRACE_CORE_RING_SIZE - 1)];
+}
+
+/** Lock-free entry point, each core writes its own ring only */
+void dtrace_event_compact(uint32_t uid, uint32_t id_0, uint32_t id_1, uint32_t entry,
+			  uint64_t timestamp, int arg_count, const uint32_t *args)
+{
+	struct dma_trace_data *trace_data = dma_trace_data_get();
+	struct dtrace_core_ring *ring;
+	uint8_t e[DTRACE_COMPACT_ENTRY_MAX];
+	uint8_t *p;
+	uint32_t length;
+	uint32_t flags;
+	uint32_t w;
+	int i;
+
+	if (!dma_trace_initialized(trace_data))
+		return;
+
+	ring = &trace_data->rings[cpu_get_id()];
+	if (!ring->addr)
+		return;
+
+	/* only other contexts of this core can write to the ring */
+	irq_local_disable(flags);
+
+	p = dtrace_put_varint(e + 1, timestamp - ring->last_ts);
+	p = dtrace_put_varint(p, entry);
+	p = dtrace_put_varint(p, uid);
+	p = dtrace_put_varint(p, id_0);
+	p = dtrace_put_varint(p, id_1);
+	for (i = 0; i < arg_count; i++)
+		p = dtrace_put_varint(p, args[i]);
+
+	length = p - e;
+	e[0] = length - 1;
+
+	w = ring->w;
+	if (CONFIG_TRACE_CORE_RING_SIZE - (w - ring->r) < length) {
+		ring->dropped++;
+	} else {
+		for (i = 0; i < length; i++)
+			ring->addr[(w + i) & (CONFIG_TRACE_CORE_RING_SIZE - 1)] = e[i];
+		ring->last_ts = timestamp;
+		/* publish the entry to trace_work() */
+		ring->w = w + length;
+	}
+
+	irq_local_enable(flags);
+}
+
+/** Copy compact entries of all cores as blocks to the DMA trace buffer */
+static void dtrace_merge_rings(struct dma_trace_data *d)
+{
+	struct log_compact_block_header *block = (struct log_compact_block_header *)d->block;
+	uint8_t *data = d->block + sizeof(*block);
+	struct dtrace_core_ring *ring;
+	k_spinlock_key_t key;
+	bool merged = false;
+	uint64_t delta;
+	uint32_t dropped;
+	uint32_t length;
+	uint32_t size;
+	uint32_t r, w, i;
+	int shift;
+	int core;
+
+	if (!d->block)
+		return;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		ring = &d->rings[core];
+		w = ring->w;
+		dropped = ring->dropped;
+
+		while (ring->r != w || ring->dropped_sent != dropped) {
+			block->magic = TRACE_COMPACT_BLOCK_MAGIC;
+			block->core_id = core;
+			block->last = 0;
+			block->timestamp = ring->drain_ts + d->time_delta;
+			block->dropped = dropped - ring->dropped_sent;
+			ring->dropped_sent = dropped;
+
+			/* whole entries only */
+			for (r = ring->r, size = 0; r != w; r += length, size += length) {
+				length = dtrace_ring_byte(ring, r) + 1;
+				if (sizeof(*block) + size + length > DTRACE_BLOCK_SIZE)
+					break;
+
+				for (i = 0; i < length; i++)
+					data[size + i] = dtrace_ring_byte(ring, r + i);
+
+				/* timestamp delta is the first varint of the entry */
+				delta = 0;
+				shift = 0;
+				for (i = 1; i < length; i++, shift += 7) {
+					delta |= (uint64_t)(data[size + i] & 0x7f) << shift;
+					if (!(data[size + i] & 0x80))
+						break;
+				}
+				ring->drain_ts += delta;
+			}
+			ring->r = r;
+
+			while (size % sizeof(uint32_t))
+				data[size++] = 0;
+			block->size = size;
+
+			key = k_spin_lock(&d->lock);
+			dtrace_add_event((const char *)block, sizeof(*block) + size);
+			k_spin_unlock(&d->lock, key);
+			merged = true;
+		}
+	}
+
+	if (!merged)
+		return;
+
+	/* let the host sort the entries of this round */
+	block->magic = TRACE_COMPACT_BLOCK_MAGIC;
+	block->core_id = PLATFORM_PRIMARY_CORE_ID;
+	block->last = 1;
+	block->size = 0;
+	block->timestamp = 0;
+	block->dropped = 0;
+
+	key = k_spin_lock(&d->lock);
+	dtrace_add_event((const char *)block, sizeof(*block));
+	k_spin_unlock(&d->lock, key);
+}
+#endif
+
 void dtrace_event_atomic(const char *e, uint32_t length)
 {
 	struct dma_trace_data *trace_data = dma_trace_data_get();
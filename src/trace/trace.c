@@ -246,6 +246,15 @@ static void dma_trace_log(bool send_atomic, uint32_t log_entry, const struct tr_
 	const int message_size = MESSAGE_SIZE(arg_count);
 	int i;
 
+#if CONFIG_TRACE_BINARY_PERCORE
+	for (i = 0; i < arg_count; ++i)
+		data[i] = va_arg(vargs, uint32_t);
+
+	/* formatting is left to the host, no lock shared with other cores */
+	dtrace_event_compact((uintptr_t)ctx->uuid_p, id_1 & TRACE_ID_MASK, id_2 & TRACE_ID_MASK,
+			     log_entry, sof_cycle_get_64_safe(), arg_count, data);
+	return;
+#endif
 	/* fill log content. arg_count is in the dictionary. */
 	put_header(data, ctx->uuid_p, id_1, id_2, log_entry, sof_cycle_get_64_safe());
 
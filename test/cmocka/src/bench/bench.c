@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmocka.h>
+#include <errno.h>
+#if !defined __XTENSA__
+#include <time.h>
+#endif
+
+#include <ipc/topology.h>
+#include <rtos/alloc.h>
+#include <sof/audio/audio_stream.h>
+
+#include "bench.h"
+
+#define BENCH_BASELINE_MAX	64
+#define BENCH_LINE_SIZE		128
+
+struct bench_baseline {
+	char name[BENCH_NAME_SIZE];
+	double cost;
+};
+
+static struct bench_baseline baseline[BENCH_BASELINE_MAX];
+static int baseline_count;
+static int baseline_tolerance;
+
+static inline uint32_t bench_time(void)
+{
+#if defined __XTENSA__
+	uint32_t ccount;
+
+	__asm__ __volatile__("rsr.ccount %0" : "=a" (ccount));
+	return ccount;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+void bench_init(const char *path, int tolerance)
+{
+	char line[BENCH_LINE_SIZE];
+	struct bench_baseline *b;
+	FILE *f;
+
+	baseline_count = 0;
+	baseline_tolerance = tolerance;
+
+	f = fopen(path, "r");
+	if (!f) {
+		printf("# no baseline %s\n", path);
+		return;
+	}
+
+	/* anything but the result lines is a comment */
+	while (baseline_count < BENCH_BASELINE_MAX && fgets(line, sizeof(line), f)) {
+		b = &baseline[baseline_count];
+		if (sscanf(line, BENCH_TAG " %47s %lf", b->name, &b->cost) == 2 &&
+		    b->cost > 0)
+			baseline_count++;
+	}
+
+	fclose(f);
+}
+
+static const struct bench_baseline *bench_baseline_get(const char *name)
+{
+	int i;
+
+	for (i = 0; i < baseline_count; i++)
+		if (!strcmp(baseline[i].name, name))
+			return &baseline[i];
+
+	return NULL;
+}
+
+void bench_run(const char *name, void (*kernel)(void *data), void *data,
+	       uint32_t samples)
+{
+	const struct bench_baseline *b = bench_baseline_get(name);
+	uint32_t best = UINT32_MAX;
+	uint32_t start;
+	uint32_t t;
+	double cost;
+	double delta;
+	int i;
+
+	kernel(data);
+
+	for (i = 0; i < BENCH_RUNS; i++) {
+		start = bench_time();
+		kernel(data);
+		t = bench_time() - start;
+		if (t < best)
+			best = t;
+	}
+
+	cost = (double)best / samples;
+	if (!b) {
+		printf(BENCH_TAG " %-32s %10.2f %s/sample\n", name, cost, BENCH_UNIT);
+		return;
+	}
+
+	delta = 100.0 * (cost - b->cost) / b->cost;
+	printf(BENCH_TAG " %-32s %10.2f %s/sample, baseline %.2f, %+.1f%%\n",
+	       name, cost, BENCH_UNIT, b->cost, delta);
+
+	if (baseline_tolerance && delta > baseline_tolerance)
+		fail_msg("%s is %.1f%% slower than the baseline", name, delta);
+}
+
+void bench_noise(int32_t *data, uint32_t words)
+{
+	uint32_t seed = 1;
+	uint32_t i;
+
+	/* same sequence for every buffer so the runs are comparable */
+	for (i = 0; i < words; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		data[i] = seed;
+	}
+}
+
+int bench_stream_init(struct audio_stream *stream, enum sof_ipc_frame fmt,
+		      uint32_t channels, uint32_t frames)
+{
+	uint32_t size = frames * get_frame_bytes(fmt, channels);
+	uint32_t words = size / sizeof(int32_t);
+	int32_t *data;
+	uint32_t i;
+
+	data = rballoc(0, SOF_MEM_CAPS_RAM, size);
+	if (!data)
+		return -ENOMEM;
+
+	bench_noise(data, words);
+
+	/* noise in the range of the format */
+	switch (fmt) {
+	case SOF_IPC_FRAME_S24_4LE:
+		for (i = 0; i < words; i++)
+			data[i] >>= 8;
+		break;
+	case SOF_IPC_FRAME_S24_4LE_MSB:
+		for (i = 0; i < words; i++)
+			data[i] &= 0xffffff00;
+		break;
+#if CONFIG_FORMAT_FLOAT
+	case SOF_IPC_FRAME_FLOAT:
+		for (i = 0; i < words; i++)
+			((float *)data)[i] = (float)data[i] / 2147483648.0f;
+		break;
+#endif
+	default:
+		break;
+	}
+
+	audio_stream_init(stream, data, size);
+	audio_stream_set_frm_fmt(stream, fmt);
+	audio_stream_set_valid_fmt(stream, fmt);
+	audio_stream_set_buffer_fmt(stream, SOF_IPC_BUFFER_INTERLEAVED);
+	audio_stream_set_channels(stream, channels);
+
+	/* the kernels may check both, the stream can be used as source and sink */
+	audio_stream_set_avail(stream, size);
+	audio_stream_set_free(stream, size);
+
+	return 0;
+}
+
+void bench_stream_free(struct audio_stream *stream)
+{
+	rfree(stream->addr);
+}
@@ -0,0 +1,77 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __TEST_CMOCKA_BENCH_H__
+#define __TEST_CMOCKA_BENCH_H__
+
+#include <ipc/stream.h>
+#include <stdint.h>
+
+struct audio_stream;
+
+/* The xt-run simulator is cycle accurate and counts the core clock, on host
+ * the monotonic clock in ns is the closest portable equivalent.
+ */
+#if defined __XTENSA__
+#define BENCH_UNIT	"cycles"
+#define BENCH_RUNS	3
+#else
+#define BENCH_UNIT	"ns"
+#define BENCH_RUNS	20
+#endif
+
+/* Prefix of the result lines, baseline files are made of the same lines
+ * so they can be regenerated with grep "^bench:" from the test output.
+ */
+#define BENCH_TAG	"bench:"
+
+#define BENCH_NAME_SIZE	48
+
+/**
+ * \brief Loads the baseline the results get compared to.
+ * \param[in] path Baseline file, a missing file only disables the comparison.
+ * \param[in] tolerance Allowed regression in percent, zero only reports
+ *	      the deviation from the baseline.
+ */
+void bench_init(const char *path, int tolerance);
+
+/**
+ * \brief Times a kernel and checks the result against the baseline.
+ *
+ * The kernel is run once to warm up the caches and then BENCH_RUNS times,
+ * the fastest run is reported to filter out interrupts and preemption.
+ * Fails the current cmocka test if the kernel got slower than the baseline
+ * by more than the tolerance.
+ *
+ * \param[in] name Kernel name in the report and the baseline.
+ * \param[in] kernel Runs the kernel once.
+ * \param[in] data Kernel data passed to kernel().
+ * \param[in] samples Number of samples processed by one kernel() call.
+ */
+void bench_run(const char *name, void (*kernel)(void *data), void *data,
+	       uint32_t samples);
+
+/**
+ * \brief Allocates the buffer of a stream and fills it with noise.
+ * \param[out] stream Stream to initialize.
+ * \param[in] fmt Frame format.
+ * \param[in] channels Number of channels.
+ * \param[in] frames Number of frames the buffer holds.
+ * \return 0 on success, -ENOMEM when the buffer can't be allocated.
+ */
+int bench_stream_init(struct audio_stream *stream, enum sof_ipc_frame fmt,
+		      uint32_t channels, uint32_t frames);
+
+/**
+ * \brief Frees the buffer of a stream initialized by bench_stream_init().
+ */
+void bench_stream_free(struct audio_stream *stream);
+
+/**
+ * \brief Fills a buffer with 32 bit noise.
+ */
+void bench_noise(int32_t *data, uint32_t words);
+
+#endif /* __TEST_CMOCKA_BENCH_H__ */
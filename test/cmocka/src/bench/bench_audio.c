@@ -0,0 +1,356 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include <ipc/topology.h>
+#include <rtos/alloc.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/module_adapter/module/generic.h>
+#include <sof/audio/pcm_converter.h>
+#include <ipc4/mixin_mixout.h>
+#include <volume/volume.h>
+#include <src/src.h>
+#include <src/src_config.h>
+
+/* one interpolating and one decimating stage of the conversions from 48 kHz */
+#if SRC_SHORT
+#include <src/coef/src_tiny_int16_2_3_1814_5000.h>
+#include <src/coef/src_tiny_int16_21_20_1667_5000.h>
+#define BENCH_SRC_STAGE_2_3	src_int16_2_3_1814_5000
+#define BENCH_SRC_STAGE_21_20	src_int16_21_20_1667_5000
+#else
+#include <src/coef/src_std_int32_2_3_4535_5000.h>
+#include <src/coef/src_std_int32_21_20_4167_5000.h>
+#define BENCH_SRC_STAGE_2_3	src_int32_2_3_4535_5000
+#define BENCH_SRC_STAGE_21_20	src_int32_21_20_4167_5000
+#endif
+
+#include "bench.h"
+
+#define BENCH_CHANNELS		2
+#define BENCH_FRAMES		1024
+#define BENCH_SAMPLES		(BENCH_CHANNELS * BENCH_FRAMES)
+#define BENCH_MIX_SOURCES	2
+
+static const char *bench_fmt_name(enum sof_ipc_frame fmt)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return "s16";
+	case SOF_IPC_FRAME_S24_4LE:
+		return "s24";
+	case SOF_IPC_FRAME_S32_LE:
+		return "s32";
+	case SOF_IPC_FRAME_FLOAT:
+		return "float";
+	case SOF_IPC_FRAME_S24_3LE:
+		return "s24_3le";
+	case SOF_IPC_FRAME_S24_4LE_MSB:
+		return "s24_msb";
+	case SOF_IPC_FRAME_U8:
+		return "u8";
+	default:
+		return "unknown";
+	}
+}
+
+struct bench_pcm {
+	pcm_converter_func func;
+	struct audio_stream source;
+	struct audio_stream sink;
+};
+
+static void pcm_kernel(void *data)
+{
+	struct bench_pcm *pcm = data;
+
+	pcm->func(&pcm->source, 0, &pcm->sink, 0, BENCH_SAMPLES);
+}
+
+static void bench_pcm_converter(void **state)
+{
+	char name[BENCH_NAME_SIZE];
+	struct bench_pcm pcm;
+	int ret;
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < pcm_func_count; i++) {
+		ret = bench_stream_init(&pcm.source, pcm_func_map[i].source, BENCH_CHANNELS,
+					BENCH_FRAMES);
+		assert_int_equal(ret, 0);
+		ret = bench_stream_init(&pcm.sink, pcm_func_map[i].sink, BENCH_CHANNELS,
+					BENCH_FRAMES);
+		assert_int_equal(ret, 0);
+		pcm.func = pcm_func_map[i].func;
+
+		snprintf(name, sizeof(name), "pcm_convert_%s_to_%s",
+			 bench_fmt_name(pcm_func_map[i].source),
+			 bench_fmt_name(pcm_func_map[i].sink));
+		bench_run(name, pcm_kernel, &pcm, BENCH_SAMPLES);
+
+		bench_stream_free(&pcm.sink);
+		bench_stream_free(&pcm.source);
+	}
+}
+
+struct bench_vol {
+	struct processing_module mod;
+	struct comp_dev dev;
+	struct vol_data cd;
+	struct audio_stream source;
+	struct audio_stream sink;
+	struct input_stream_buffer bsource;
+	struct output_stream_buffer bsink;
+	vol_scale_func func;
+};
+
+static void vol_kernel(void *data)
+{
+	struct bench_vol *vol = data;
+
+	/* the kernels advance the offsets, process the same period again */
+	vol->bsource.consumed = 0;
+	vol->bsink.size = 0;
+	vol->func(&vol->mod, &vol->bsource, &vol->bsink, BENCH_FRAMES, 0);
+}
+
+static void bench_volume(void **state)
+{
+	/* the kernels keep four copies of the gains for the SIMD loads */
+	const size_t gain_size = sizeof(int32_t) * SOF_IPC_MAX_CHANNELS * 4;
+	char name[BENCH_NAME_SIZE];
+	struct bench_vol *vol;
+	enum sof_ipc_frame fmt;
+	int ret;
+	int i;
+	int j;
+
+	(void)state;
+
+	vol = test_calloc(1, sizeof(*vol));
+	vol->mod.dev = &vol->dev;
+	vol->mod.priv.private = &vol->cd;
+	vol->cd.vol = rballoc(0, SOF_MEM_CAPS_RAM, gain_size);
+	assert_non_null(vol->cd.vol);
+#if CONFIG_IPC_MAJOR_4
+	vol->cd.peak_vol = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, gain_size);
+	assert_non_null(vol->cd.peak_vol);
+#endif
+
+	/* -6 dB */
+	for (j = 0; j < SOF_IPC_MAX_CHANNELS; j++)
+		vol->cd.volume[j] = VOL_ZERO_DB / 2;
+
+	for (i = 0; i < volume_func_count; i++) {
+		fmt = volume_func_map[i].frame_fmt;
+		ret = bench_stream_init(&vol->source, fmt, BENCH_CHANNELS, BENCH_FRAMES);
+		assert_int_equal(ret, 0);
+		ret = bench_stream_init(&vol->sink, fmt, BENCH_CHANNELS, BENCH_FRAMES);
+		assert_int_equal(ret, 0);
+		vol->bsource.data = &vol->source;
+		vol->bsink.data = &vol->sink;
+		vol->func = volume_func_map[i].func;
+
+		snprintf(name, sizeof(name), "volume_%s", bench_fmt_name(fmt));
+		bench_run(name, vol_kernel, vol, BENCH_SAMPLES);
+
+		bench_stream_free(&vol->sink);
+		bench_stream_free(&vol->source);
+	}
+
+#if CONFIG_IPC_MAJOR_4
+	rfree(vol->cd.peak_vol);
+#endif
+	rfree(vol->cd.vol);
+	test_free(vol);
+}
+
+struct bench_mix {
+	normal_mix_func normal;
+	fused_mix_func fused;
+	struct audio_stream sink;
+	struct audio_stream source[BENCH_MIX_SOURCES];
+	struct audio_stream *sources[BENCH_MIX_SOURCES];
+	uint16_t gains[BENCH_MIX_SOURCES];
+};
+
+static void mix_kernel(void *data)
+{
+	struct bench_mix *mix = data;
+
+	/* all the samples are mixed into the sink, like for the second mixin */
+	mix->normal(&mix->sink, 0, BENCH_SAMPLES, &mix->source[0], BENCH_SAMPLES,
+		    IPC4_MIXIN_UNITY_GAIN);
+}
+
+static void mix_fused_kernel(void *data)
+{
+	struct bench_mix *mix = data;
+
+	mix->fused(&mix->sink, mix->sources, mix->gains, BENCH_MIX_SOURCES, BENCH_SAMPLES);
+}
+
+static void bench_mix_init(struct bench_mix *mix, enum sof_ipc_frame fmt)
+{
+	int ret;
+	int j;
+
+	ret = bench_stream_init(&mix->sink, fmt, BENCH_CHANNELS, BENCH_FRAMES);
+	assert_int_equal(ret, 0);
+
+	for (j = 0; j < BENCH_MIX_SOURCES; j++) {
+		ret = bench_stream_init(&mix->source[j], fmt, BENCH_CHANNELS, BENCH_FRAMES);
+		assert_int_equal(ret, 0);
+		mix->sources[j] = &mix->source[j];
+		mix->gains[j] = IPC4_MIXIN_UNITY_GAIN;
+	}
+}
+
+static void bench_mix_free(struct bench_mix *mix)
+{
+	int j;
+
+	for (j = 0; j < BENCH_MIX_SOURCES; j++)
+		bench_stream_free(&mix->source[j]);
+
+	bench_stream_free(&mix->sink);
+}
+
+static void bench_mixin_mixout(void **state)
+{
+	char name[BENCH_NAME_SIZE];
+	struct bench_mix mix;
+	enum sof_ipc_frame fmt;
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < mix_count; i++) {
+		fmt = mix_func_map[i].frame_fmt;
+		bench_mix_init(&mix, fmt);
+		mix.normal = mix_func_map[i].normal_func;
+
+		snprintf(name, sizeof(name), "mix_%s", bench_fmt_name(fmt));
+		bench_run(name, mix_kernel, &mix, BENCH_SAMPLES);
+
+		bench_mix_free(&mix);
+	}
+
+	/* per sink sample, with two sources */
+	for (i = 0; i < mix_fused_count; i++) {
+		fmt = mix_fused_func_map[i].frame_fmt;
+		bench_mix_init(&mix, fmt);
+		mix.fused = mix_fused_func_map[i].fused_func;
+
+		snprintf(name, sizeof(name), "mix_fused_%s_2src", bench_fmt_name(fmt));
+		bench_run(name, mix_fused_kernel, &mix, BENCH_SAMPLES);
+
+		bench_mix_free(&mix);
+	}
+}
+
+struct bench_src {
+	struct src_stage_prm prm;
+	struct src_state state;
+	struct audio_stream source;
+	struct audio_stream sink;
+	void (*func)(struct src_stage_prm *s);
+};
+
+static void src_kernel(void *data)
+{
+	struct bench_src *src = data;
+
+	/* the pointers wrap back to the start of the buffers */
+	src->func(&src->prm);
+}
+
+static void bench_src_stage(const char *name, struct src_stage *stage,
+			    enum sof_ipc_frame fmt, void (*func)(struct src_stage_prm *s))
+{
+	struct bench_src src;
+	int32_t *delay;
+	int times = BENCH_FRAMES / stage->blk_in;
+	int ret;
+
+	memset(&src, 0, sizeof(src));
+
+	src.state.fir_delay_size = BENCH_CHANNELS * src_fir_delay_length(stage);
+	src.state.out_delay_size = BENCH_CHANNELS * src_out_delay_length(stage);
+	delay = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			(src.state.fir_delay_size + src.state.out_delay_size) * sizeof(int32_t));
+	assert_non_null(delay);
+	src.state.fir_delay = delay;
+	src.state.out_delay = delay + src.state.fir_delay_size;
+	src.state.fir_wp = &src.state.fir_delay[src.state.fir_delay_size - 1];
+	src.state.out_rp = src.state.out_delay;
+
+	ret = bench_stream_init(&src.source, fmt, BENCH_CHANNELS, times * stage->blk_in);
+	assert_int_equal(ret, 0);
+	ret = bench_stream_init(&src.sink, fmt, BENCH_CHANNELS, times * stage->blk_out);
+	assert_int_equal(ret, 0);
+
+	src.prm.nch = BENCH_CHANNELS;
+	src.prm.times = times;
+	src.prm.x_rptr = src.source.addr;
+	src.prm.x_end_addr = src.source.end_addr;
+	src.prm.x_size = src.source.size;
+	src.prm.y_wptr = src.sink.addr;
+	src.prm.y_addr = src.sink.addr;
+	src.prm.y_end_addr = src.sink.end_addr;
+	src.prm.y_size = src.sink.size;
+	src.prm.shift = fmt == SOF_IPC_FRAME_S24_4LE ? 8 : 0;
+	src.prm.state = &src.state;
+	src.prm.stage = stage;
+	src.func = func;
+
+	bench_run(name, src_kernel, &src, BENCH_CHANNELS * times * stage->blk_out);
+
+	bench_stream_free(&src.sink);
+	bench_stream_free(&src.source);
+	rfree(delay);
+}
+
+static void bench_src(void **state)
+{
+	(void)state;
+
+#if CONFIG_FORMAT_S32LE
+	bench_src_stage("src_stage_2_3_s32", &BENCH_SRC_STAGE_2_3, SOF_IPC_FRAME_S32_LE,
+			src_polyphase_stage_cir);
+	bench_src_stage("src_stage_21_20_s32", &BENCH_SRC_STAGE_21_20, SOF_IPC_FRAME_S32_LE,
+			src_polyphase_stage_cir);
+#endif
+#if CONFIG_FORMAT_S16LE
+	bench_src_stage("src_stage_2_3_s16", &BENCH_SRC_STAGE_2_3, SOF_IPC_FRAME_S16_LE,
+			src_polyphase_stage_cir_s16);
+	bench_src_stage("src_stage_21_20_s16", &BENCH_SRC_STAGE_21_20, SOF_IPC_FRAME_S16_LE,
+			src_polyphase_stage_cir_s16);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(bench_pcm_converter),
+		cmocka_unit_test(bench_volume),
+		cmocka_unit_test(bench_mixin_mixout),
+		cmocka_unit_test(bench_src),
+	};
+
+	bench_init(argc > 1 ? argv[1] : BENCH_BASELINE, BENCH_TOLERANCE);
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
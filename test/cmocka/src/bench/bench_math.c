@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include <ipc/topology.h>
+#include <rtos/alloc.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/module_adapter/module/generic.h>
+#include <sof/math/fft.h>
+#include <sof/math/iir_df2t.h>
+#include <user/eq.h>
+#include <user/fir.h>
+#include <eq_fir/eq_fir.h>
+
+#include "bench.h"
+
+#define BENCH_FIR_TAPS		64
+#define BENCH_FIR_CHANNELS	2
+#define BENCH_FIR_FRAMES	1024
+#define BENCH_IIR_BIQUADS	4
+#define BENCH_IIR_SAMPLES	1024
+
+/* 2nd order Butterworth lowpass at fs / 8 */
+static const int32_t bench_biquad[SOF_EQ_IIR_NBIQUAD] = {
+	-357913941,	/* a2 Q2.30 */
+	1012333500,	/* a1 */
+	104830566,	/* b2 */
+	209661133,	/* b1 */
+	104830566,	/* b0 */
+	0,		/* output shift */
+	16384,		/* output gain Q2.14 */
+};
+
+struct bench_fft {
+	struct fft_plan *plan;
+	void *inb;
+	void *outb;
+	bool ifft;
+	int bits;
+};
+
+static void fft_kernel(void *data)
+{
+	struct bench_fft *fft = data;
+
+	if (fft->bits == 16)
+		fft_execute_16(fft->plan, fft->ifft);
+	else
+		fft_execute_32(fft->plan, fft->ifft);
+}
+
+static void bench_fft(const char *name, uint32_t size, int bits, bool ifft)
+{
+	struct bench_fft fft = { .bits = bits, .ifft = ifft };
+	size_t bytes = size * (bits == 16 ? sizeof(struct icomplex16) :
+			       sizeof(struct icomplex32));
+
+	fft.inb = rballoc(0, SOF_MEM_CAPS_RAM, bytes);
+	fft.outb = rballoc(0, SOF_MEM_CAPS_RAM, bytes);
+	assert_non_null(fft.inb);
+	assert_non_null(fft.outb);
+
+	/* the input is not modified, every run transforms the same noise */
+	bench_noise(fft.inb, bytes / sizeof(int32_t));
+	fft.plan = fft_plan_new(fft.inb, fft.outb, size, bits);
+	assert_non_null(fft.plan);
+
+	bench_run(name, fft_kernel, &fft, size);
+
+	fft_plan_free(fft.plan);
+	rfree(fft.outb);
+	rfree(fft.inb);
+}
+
+static void bench_fft_16(void **state)
+{
+	(void)state;
+
+	bench_fft("fft_execute_16_256", 256, 16, false);
+	bench_fft("fft_execute_16_1024", 1024, 16, false);
+}
+
+static void bench_fft_32(void **state)
+{
+	(void)state;
+
+	bench_fft("fft_execute_32_256", 256, 32, false);
+	bench_fft("fft_execute_32_1024", 1024, 32, false);
+	bench_fft("fft_execute_32_1024_ifft", 1024, 32, true);
+}
+
+#if CONFIG_FORMAT_S32LE
+struct bench_fir {
+	struct comp_data cd;
+	struct audio_stream source;
+	struct audio_stream sink;
+	struct input_stream_buffer bsource;
+	struct output_stream_buffer bsink;
+};
+
+static void fir_kernel(void *data)
+{
+	struct bench_fir *fir = data;
+
+	fir->cd.eq_fir_func(fir->cd.fir, &fir->bsource, &fir->bsink, BENCH_FIR_FRAMES);
+}
+
+static void bench_fir_s32(void **state)
+{
+	struct sof_fir_coef_data *coef;
+	struct bench_fir *fir;
+	int32_t *delay;
+	int32_t *d;
+	int size;
+	int ret;
+	int i;
+
+	(void)state;
+
+	fir = test_calloc(1, sizeof(*fir));
+	coef = test_calloc(1, sizeof(*coef) + BENCH_FIR_TAPS * sizeof(int16_t));
+
+	/* moving average, the coefficients don't change the cost */
+	coef->length = BENCH_FIR_TAPS;
+	coef->out_shift = 0;
+	for (i = 0; i < BENCH_FIR_TAPS; i++)
+		coef->coef[i] = INT16_MAX / BENCH_FIR_TAPS;
+
+	size = fir_delay_size(coef);
+	assert_true(size > 0);
+	delay = rballoc(0, SOF_MEM_CAPS_RAM, size * BENCH_FIR_CHANNELS);
+	assert_non_null(delay);
+	memset(delay, 0, size * BENCH_FIR_CHANNELS);
+
+	d = delay;
+	for (i = 0; i < BENCH_FIR_CHANNELS; i++) {
+		fir_init_coef(&fir->cd.fir[i], coef);
+		fir_init_delay(&fir->cd.fir[i], &d);
+	}
+
+	/* the kernel the component selects for the format */
+	set_s32_fir(&fir->cd);
+
+	ret = bench_stream_init(&fir->source, SOF_IPC_FRAME_S32_LE, BENCH_FIR_CHANNELS,
+				BENCH_FIR_FRAMES);
+	assert_int_equal(ret, 0);
+	ret = bench_stream_init(&fir->sink, SOF_IPC_FRAME_S32_LE, BENCH_FIR_CHANNELS,
+				BENCH_FIR_FRAMES);
+	assert_int_equal(ret, 0);
+	fir->bsource.data = &fir->source;
+	fir->bsink.data = &fir->sink;
+
+	bench_run("eq_fir_s32_64taps_2ch", fir_kernel, fir,
+		  BENCH_FIR_FRAMES * BENCH_FIR_CHANNELS);
+
+	bench_stream_free(&fir->sink);
+	bench_stream_free(&fir->source);
+	rfree(delay);
+	test_free(coef);
+	test_free(fir);
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+struct bench_iir {
+	struct iir_state_df2t iir;
+	int32_t *x;
+	int32_t *y;
+};
+
+static void iir_kernel(void *data)
+{
+	struct bench_iir *iir = data;
+	int i;
+
+	for (i = 0; i < BENCH_IIR_SAMPLES; i++)
+		iir->y[i] = iir_df2t(&iir->iir, iir->x[i]);
+}
+
+static void bench_iir_df2t(void **state)
+{
+	struct sof_eq_iir_header *config;
+	struct bench_iir iir;
+	int64_t *delay;
+	int64_t *d;
+	int size;
+	int i;
+
+	(void)state;
+
+	config = test_calloc(1, sizeof(*config) +
+			     BENCH_IIR_BIQUADS * SOF_EQ_IIR_NBIQUAD * sizeof(int32_t));
+	config->num_sections = BENCH_IIR_BIQUADS;
+	config->num_sections_in_series = BENCH_IIR_BIQUADS;
+	for (i = 0; i < BENCH_IIR_BIQUADS; i++)
+		memcpy(&config->biquads[i * SOF_EQ_IIR_NBIQUAD], bench_biquad,
+		       sizeof(bench_biquad));
+
+	size = iir_delay_size_df2t(config);
+	assert_true(size > 0);
+	delay = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, size);
+	assert_non_null(delay);
+
+	iir_init_coef_df2t(&iir.iir, config);
+	d = delay;
+	iir_init_delay_df2t(&iir.iir, &d);
+
+	iir.x = rballoc(0, SOF_MEM_CAPS_RAM, BENCH_IIR_SAMPLES * sizeof(int32_t));
+	iir.y = rballoc(0, SOF_MEM_CAPS_RAM, BENCH_IIR_SAMPLES * sizeof(int32_t));
+	assert_non_null(iir.x);
+	assert_non_null(iir.y);
+	bench_noise(iir.x, BENCH_IIR_SAMPLES);
+
+	bench_run("iir_df2t_4biquads", iir_kernel, &iir, BENCH_IIR_SAMPLES);
+
+	rfree(iir.y);
+	rfree(iir.x);
+	rfree(delay);
+	test_free(config);
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(bench_fft_16),
+		cmocka_unit_test(bench_fft_32),
+#if CONFIG_FORMAT_S32LE
+		cmocka_unit_test(bench_fir_s32),
+#endif
+		cmocka_unit_test(bench_iir_df2t),
+	};
+
+	bench_init(argc > 1 ? argv[1] : BENCH_BASELINE, BENCH_TOLERANCE);
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
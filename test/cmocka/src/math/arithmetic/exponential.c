@@ -81,10 +81,70 @@ static void test_math_arithmetic_exponential_fixed(void **state)
 	}
 }
 
+static void test_math_arithmetic_exponential_vec(void **state)
+{
+	(void)state;
+
+	int32_t x[NUMTESTSAMPLES];
+	int32_t y[NUMTESTSAMPLES];
+	double max_ulp;
+	double a_i;
+	int i;
+
+	/* uniform sweep of -5 .. +5, odd length to cover the single value tail */
+	for (i = 0; i < NUMTESTSAMPLES - 1; i++)
+		x[i] = (int32_t)((-5.0 + 10.0 * i / (NUMTESTSAMPLES - 2)) * (1 << 28));
+
+	sofm_exp_int32_vec(x, y, NUMTESTSAMPLES - 1);
+
+	for (i = 0; i < NUMTESTSAMPLES - 1; i++) {
+		a_i = (double)x[i] / (1 << 28);
+		max_ulp = fabs(exp(a_i) - (double)y[i] / (1 << 23)) / ULP_SCALE;
+		if (max_ulp > ULP_TOLERANCE) {
+			printf("%s: ULP for %.16f: value = %.16f, Exp = %.16f\n", __func__,
+			       max_ulp, a_i, (double)y[i] / (1 << 23));
+			assert_true(max_ulp <= ULP_TOLERANCE);
+		}
+	}
+}
+
+static void test_math_arithmetic_db2lin_vec(void **state)
+{
+	(void)state;
+
+	int32_t x[NUMTESTSAMPLES];
+	int32_t y[NUMTESTSAMPLES];
+	double ref;
+	double db;
+	int i;
+
+	/* -100 .. +66 dB, the range of db2lin_fixed() */
+	for (i = 0; i < NUMTESTSAMPLES; i++)
+		x[i] = (int32_t)((-100.0 + 166.0 * i / (NUMTESTSAMPLES - 1)) * (1 << 24));
+
+	/* in place */
+	memcpy(y, x, sizeof(y));
+	sofm_db2lin_fixed_vec(y, y, NUMTESTSAMPLES);
+
+	for (i = 0; i < NUMTESTSAMPLES; i++) {
+		db = (double)x[i] / (1 << 24);
+		ref = pow(10.0, db / 20.0);
+		/* within 0.01 dB or a Q12.20 LSB */
+		assert_true(fabs((double)y[i] / (1 << 20) - ref) <=
+			    MAX(ref * 0.00115, 1.0 / (1 << 20)));
+	}
+
+	x[0] = (int32_t)(-101.0 * (1 << 24));
+	sofm_db2lin_fixed_vec(x, y, 1);
+	assert_int_equal(y[0], 0);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
-		cmocka_unit_test(test_math_arithmetic_exponential_fixed)
+		cmocka_unit_test(test_math_arithmetic_exponential_fixed),
+		cmocka_unit_test(test_math_arithmetic_exponential_vec),
+		cmocka_unit_test(test_math_arithmetic_db2lin_vec),
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
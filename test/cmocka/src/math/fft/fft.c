@@ -38,6 +38,8 @@
 #define MIN_SNR_256	132.0
 #define MIN_SNR_512	125.0
 #define MIN_SNR_1024	119.0
+#define MIN_SNR_REAL_1024	125.0
+#define FFT_REAL_DB_TH	100.0
 
 /**
  * \brief Doing Fast Fourier Transform (FFT) for mono real input buffers.
@@ -786,6 +788,92 @@ static void test_math_fft_1024_ifft_16(void **state)
 	assert_int_equal(db < FFT_DB_TH_16, 0);
 }
 
+static void test_math_fft_real_1024(void **state)
+{
+	struct fft_real_plan *plan;
+	static struct icomplex32 out[1024 / 2 + 1];
+	static int32_t in[1024];
+	int fft_size = 1024;
+	int r;
+	int i;
+	double signal;
+	double noise;
+	double snr;
+
+	(void)state;
+
+	plan = fft_real_plan_new(fft_size);
+	assert_non_null(plan);
+
+	/* create sine wave */
+	get_sine_32(in, SINE_FREQ, SINE_FS, fft_size);
+
+	/* do fft transform, the bins are 0 to fft_size / 2 */
+	fft_real_execute_32(plan, in, out);
+	fft_real_plan_free(plan);
+
+	/* find peak */
+	r = power_peak_index_32(out, fft_size);
+	i = (int)round((SINE_FREQ * fft_size) / SINE_FS);
+	printf("%s: peak at point %d\n", __func__, r);
+
+	/* the peak should be in range i +/-1 */
+	assert_in_range(r, i - 1, i + 1);
+
+	/* the min. SNR should be met */
+	noise = integrate_power_32(out, 0, i - 2);
+	signal = integrate_power_32(out, i - 1, i + 1);
+	noise += integrate_power_32(out, i + 2, fft_size / 2);
+	snr = 10 * log10(signal / noise);
+	printf("%s: SNR %5.2f dB\n", __func__, snr);
+	assert_int_equal(snr < MIN_SNR_REAL_1024, 0);
+}
+
+static void test_math_fft_real_1024_ifft(void **state)
+{
+	struct fft_real_plan *plan;
+	static struct icomplex32 intm[1024 / 2 + 1];
+	static int32_t in[1024];
+	static int32_t out[1024];
+	double signal = 0;
+	double noise = 0;
+	double db;
+	int fft_size = 1024;
+	int i;
+
+	(void)state;
+
+	plan = fft_real_plan_new(fft_size);
+	assert_non_null(plan);
+
+	get_sine_32(in, SINE_FREQ, SINE_FS, fft_size);
+
+	/* do fft and ifft transforms */
+	fft_real_execute_32(plan, in, intm);
+	fft_real_inverse_32(plan, intm, out);
+	fft_real_plan_free(plan);
+
+	/* calculate signal and noise */
+	for (i = 0; i < fft_size; i++) {
+		signal += (double)in[i] * in[i];
+		noise += ((double)out[i] - in[i]) * ((double)out[i] - in[i]);
+	}
+
+	db = 10 * log10(signal / noise);
+	printf("%s: SNR: %6.2f dB\n", __func__, db);
+	assert_int_equal(db < FFT_REAL_DB_TH, 0);
+}
+
+static void test_math_fft_real_size(void **state)
+{
+	(void)state;
+
+	/* N/2 must be a power of two and N up to FFT_SIZE_MAX */
+	assert_null(fft_real_plan_new(2));
+	assert_null(fft_real_plan_new(480));
+	assert_null(fft_real_plan_new(2 * FFT_SIZE_MAX));
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -798,6 +886,9 @@ int main(void)
 		cmocka_unit_test(test_math_fft_1024),
 		cmocka_unit_test(test_math_fft_1024_ifft),
 		cmocka_unit_test(test_math_fft_512_2ch),
+		cmocka_unit_test(test_math_fft_real_1024),
+		cmocka_unit_test(test_math_fft_real_1024_ifft),
+		cmocka_unit_test(test_math_fft_real_size),
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
@@ -0,0 +1,228 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <errno.h>
+#include <string.h>
+#include <cmocka.h>
+#include <math.h>
+#include <sof/math/nn.h>
+#include <rtos/alloc.h>
+#include <ipc/topology.h>
+#include <user/nn.h>
+
+#define TEST_BLOB_SIZE		4096
+#define TEST_GRU_IN		4
+#define TEST_GRU_UNITS		3
+#define TEST_GRU_FRAMES		32
+#define TEST_GRU_MAX_ERROR	0.01
+#define TEST_MULT_HALF		(1 << 30)
+
+#define TEST_ALIGN4(x)		(((x) + 3) & ~3)
+
+static uint8_t test_blob[TEST_BLOB_SIZE];
+static size_t test_size;
+
+static void test_model(int num_layers, int input_size)
+{
+	struct sof_nn_model_header *model = (struct sof_nn_model_header *)test_blob;
+
+	memset(test_blob, 0, sizeof(test_blob));
+	model->magic = SOF_NN_MAGIC;
+	model->num_layers = num_layers;
+	model->input_size = input_size;
+	test_size = sizeof(*model);
+}
+
+/* Append a layer with zero parameters, the size of parameters is returned
+ * in bytes and the pointer to them in params.
+ */
+static void *test_layer(int type, int in_size, int out_size, int kernel,
+			int32_t mult, int shift, size_t params)
+{
+	struct sof_nn_layer_header *hdr = (struct sof_nn_layer_header *)&test_blob[test_size];
+
+	hdr->size = sizeof(*hdr) + params;
+	hdr->type = type;
+	hdr->in_size = in_size;
+	hdr->out_size = out_size;
+	hdr->kernel = kernel;
+	hdr->mult[0] = mult;
+	hdr->mult[1] = mult;
+	hdr->shift[0] = shift;
+	hdr->shift[1] = shift;
+	test_size += hdr->size;
+	((struct sof_nn_model_header *)test_blob)->size = test_size;
+	return hdr + 1;
+}
+
+/* Identity FC with 64 * x scaled back by 0.5 >> 5, the ReLU is fused */
+static void test_math_nn_fc_relu(void **state)
+{
+	const int n = 5;
+	const int stride = TEST_ALIGN4(n);
+	const int8_t in[5] = { -100, -1, 0, 1, 100 };
+	const int8_t *out;
+	struct sofm_nn nn;
+	int8_t *w;
+	int i;
+
+	(void)state;
+
+	test_model(2, n);
+	w = (int8_t *)test_layer(SOF_NN_LAYER_FC, n, n, 0, TEST_MULT_HALF, 5,
+				 n * sizeof(int32_t) + n * stride) + n * sizeof(int32_t);
+	for (i = 0; i < n; i++)
+		w[i * stride + i] = 64;
+
+	test_layer(SOF_NN_LAYER_RELU, n, n, 0, 0, 0, 0);
+
+	assert_int_equal(sofm_nn_init(&nn, test_blob, test_size, SOF_MEM_CAPS_RAM), 0);
+	assert_int_equal(nn.num_layers, 1);
+	assert_int_equal(nn.output_size, n);
+
+	out = sofm_nn_run(&nn, in);
+	for (i = 0; i < n; i++)
+		assert_int_equal(out[i], in[i] < 0 ? 0 : in[i]);
+
+	assert_int_equal(sofm_nn_argmax(out, n), n - 1);
+	sofm_nn_free(&nn);
+
+	/* A corrupted chain of sizes is rejected */
+	((struct sof_nn_layer_header *)&test_blob[sizeof(struct sof_nn_model_header)])->in_size++;
+	assert_int_equal(sofm_nn_init(&nn, test_blob, test_size, SOF_MEM_CAPS_RAM), -EINVAL);
+}
+
+/* Depthwise convolution with only the last of three taps is a delay of two frames */
+static void test_math_nn_dwconv(void **state)
+{
+	const int n = 3;
+	const int taps = 3;
+	const int stride = TEST_ALIGN4(n);
+	const int8_t *out;
+	struct sofm_nn nn;
+	int8_t in[3];
+	int8_t *w;
+	int t;
+	int i;
+
+	(void)state;
+
+	test_model(1, n);
+	w = (int8_t *)test_layer(SOF_NN_LAYER_DWCONV, n, n, taps, TEST_MULT_HALF, 5,
+				 n * sizeof(int32_t) + taps * stride) + n * sizeof(int32_t);
+	for (i = 0; i < n; i++)
+		w[(taps - 1) * stride + i] = 64;
+
+	assert_int_equal(sofm_nn_init(&nn, test_blob, test_size, SOF_MEM_CAPS_RAM), 0);
+	for (t = 0; t < 8; t++) {
+		for (i = 0; i < n; i++)
+			in[i] = t * 10 + i;
+
+		out = sofm_nn_run(&nn, in);
+		for (i = 0; i < n; i++)
+			assert_int_equal(out[i], t < 2 ? 0 : (t - 2) * 10 + i);
+	}
+
+	sofm_nn_free(&nn);
+}
+
+static double test_sigmoid(double x)
+{
+	return 1.0 / (1.0 + exp(-x));
+}
+
+/* The gate inputs are (acc * 0.5) in Q4.12 */
+static void test_math_nn_gru(void **state)
+{
+	const int rows = 3 * TEST_GRU_UNITS;
+	const int in_stride = TEST_ALIGN4(TEST_GRU_IN);
+	const int h_stride = TEST_ALIGN4(TEST_GRU_UNITS);
+	const double scale = 0.5 / 4096;
+	double gx[3 * TEST_GRU_UNITS];
+	double gh[3 * TEST_GRU_UNITS];
+	double h[TEST_GRU_UNITS] = { 0 };
+	double r, z, c, delta;
+	const int8_t *out;
+	struct sofm_nn nn;
+	int8_t in[TEST_GRU_IN];
+	int32_t *bias_in;
+	int32_t *bias_h;
+	int8_t *w;
+	int8_t *u;
+	int t, i, j;
+
+	(void)state;
+
+	test_model(1, TEST_GRU_IN);
+	bias_in = test_layer(SOF_NN_LAYER_GRU, TEST_GRU_IN, TEST_GRU_UNITS, 0, TEST_MULT_HALF, 0,
+			     2 * rows * sizeof(int32_t) + rows * (in_stride + h_stride));
+	bias_h = bias_in + rows;
+	w = (int8_t *)(bias_h + rows);
+	u = w + rows * in_stride;
+
+	srand(1);
+	for (j = 0; j < rows; j++) {
+		bias_in[j] = rand() % 2001 - 1000;
+		bias_h[j] = rand() % 2001 - 1000;
+		for (i = 0; i < TEST_GRU_IN; i++)
+			w[j * in_stride + i] = rand() % 81 - 40;
+
+		for (i = 0; i < TEST_GRU_UNITS; i++)
+			u[j * h_stride + i] = rand() % 81 - 40;
+	}
+
+	assert_int_equal(sofm_nn_init(&nn, test_blob, test_size, SOF_MEM_CAPS_RAM), 0);
+	for (t = 0; t < TEST_GRU_FRAMES; t++) {
+		for (i = 0; i < TEST_GRU_IN; i++)
+			in[i] = rand() % 201 - 100;
+
+		out = sofm_nn_run(&nn, in);
+
+		for (j = 0; j < rows; j++) {
+			gx[j] = bias_in[j];
+			gh[j] = bias_h[j];
+			for (i = 0; i < TEST_GRU_IN; i++)
+				gx[j] += w[j * in_stride + i] * in[i];
+
+			for (i = 0; i < TEST_GRU_UNITS; i++)
+				gh[j] += u[j * h_stride + i] * h[i] * 128;
+
+			gx[j] *= scale;
+			gh[j] *= scale;
+		}
+
+		for (i = 0; i < TEST_GRU_UNITS; i++) {
+			r = test_sigmoid(gx[i] + gh[i]);
+			z = test_sigmoid(gx[TEST_GRU_UNITS + i] + gh[TEST_GRU_UNITS + i]);
+			c = tanh(gx[2 * TEST_GRU_UNITS + i] + r * gh[2 * TEST_GRU_UNITS + i]);
+			h[i] = c + z * (h[i] - c);
+			delta = fabs(out[i] / 128.0 - h[i]);
+			if (delta > TEST_GRU_MAX_ERROR)
+				printf("%s: frame %d unit %d error %g\n", __func__, t, i, delta);
+
+			assert_true(delta <= TEST_GRU_MAX_ERROR);
+		}
+	}
+
+	sofm_nn_free(&nn);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_nn_fc_relu),
+		cmocka_unit_test(test_math_nn_dwconv),
+		cmocka_unit_test(test_math_nn_gru),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
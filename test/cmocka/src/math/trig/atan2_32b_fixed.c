@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <sof/audio/format.h>
+#include <sof/math/trig.h>
+
+#define CMP_TOLERANCE	0.0000002
+#define _M_PI		3.14159265358979323846	/* pi */
+
+static void test_math_trig_atan2_fixed(void **state)
+{
+	(void)state;
+
+	int32_t x[360];
+	int32_t y[360];
+	int32_t th[360];
+	double ref;
+	double diff;
+	int theta;
+
+	for (theta = 0; theta < 360; ++theta) {
+		double rad = _M_PI * ((theta - 179) / 180.0);
+
+		y[theta] = Q_CONVERT_FLOAT(0.999 * sin(rad), 31);
+		x[theta] = Q_CONVERT_FLOAT(0.999 * cos(rad), 31);
+	}
+
+	atan2_fixed_32b_vec(y, x, th, 360);
+
+	for (theta = 0; theta < 360; ++theta) {
+		assert_int_equal(th[theta], atan2_fixed_32b(y[theta], x[theta]));
+
+		ref = atan2((double)y[theta], (double)x[theta]);
+		diff = fabs(Q_CONVERT_QTOF(th[theta], 29) - ref);
+		if (diff > CMP_TOLERANCE) {
+			printf("%s: diff for %d deg = %.10f\n", __func__,
+			       theta - 179, diff);
+		}
+
+		assert_true(diff <= CMP_TOLERANCE);
+	}
+
+	assert_int_equal(atan2_fixed_32b(0, 0), 0);
+}
+
+static void test_math_trig_cordic_osc(void **state)
+{
+	(void)state;
+
+	struct cordic_osc osc = { .w = 0, .w_step = Q_CONVERT_FLOAT(0.3, 28) };
+	int32_t y[101];
+	int32_t w = 0;
+	int64_t next;
+	int i;
+
+	cordic_osc_sin_32b(&osc, y, 101);
+
+	for (i = 0; i < 101; i++) {
+		assert_int_equal(y[i], sin_fixed_32b(w));
+		next = (int64_t)w + Q_CONVERT_FLOAT(0.3, 28);
+		w = next > PI_MUL2_Q4_28 ? next - PI_MUL2_Q4_28 : next;
+	}
+
+	assert_int_equal(osc.w, w);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_trig_atan2_fixed),
+		cmocka_unit_test(test_math_trig_cordic_osc),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
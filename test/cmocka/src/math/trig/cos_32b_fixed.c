@@ -41,10 +41,28 @@ static void test_math_trig_cos_fixed(void **state)
 	}
 }
 
+static void test_math_trig_cos_fixed_vec(void **state)
+{
+	(void)state;
+
+	int32_t th[361];
+	int32_t y[361];
+	int theta;
+
+	/* odd length to cover the single value tail, -2*pi .. 2*pi */
+	for (theta = 0; theta < 361; ++theta)
+		th[theta] = Q_CONVERT_FLOAT(_M_PI * ((2 * theta - 360) / 180.0), 28);
+
+	cos_fixed_32b_vec(th, y, 361);
+	for (theta = 0; theta < 361; ++theta)
+		assert_int_equal(y[theta], cos_fixed_32b(th[theta]));
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
-		cmocka_unit_test(test_math_trig_cos_fixed)
+		cmocka_unit_test(test_math_trig_cos_fixed),
+		cmocka_unit_test(test_math_trig_cos_fixed_vec),
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <math.h>
+#include <sof/math/numbers.h>
+#include <sof/math/xcorr.h>
+
+#define TEST_FRAMES	1024
+#define TEST_MAX_LAG	16
+#define TEST_DELAY	5
+#define TEST_BLOCK	64
+#define TEST_FFT_MAX_ERROR	1e-4 /* relative to the peak of correlation */
+
+static int16_t test_x[TEST_FRAMES];
+static int16_t test_y[TEST_FRAMES];
+
+/* Noise in x and the same noise delayed in y */
+static void test_signals(void)
+{
+	int i;
+
+	srand(1);
+	for (i = 0; i < TEST_FRAMES; i++)
+		test_x[i] = (rand() & 0xffff) - 32768;
+
+	for (i = 0; i < TEST_FRAMES; i++)
+		test_y[i] = i < TEST_DELAY ? 0 : test_x[i - TEST_DELAY];
+}
+
+/* The y frames up to TEST_MAX_LAG before the last are correlated */
+static void test_ref_xcorr(int frames, int64_t *r)
+{
+	int64_t acc;
+	int k;
+	int t;
+
+	for (k = -TEST_MAX_LAG; k <= TEST_MAX_LAG; k++) {
+		acc = 0;
+		for (t = 0; t < frames - TEST_MAX_LAG; t++) {
+			if (t + k >= 0)
+				acc += (int32_t)test_x[t + k] * test_y[t];
+		}
+
+		r[k + TEST_MAX_LAG] = acc;
+	}
+}
+
+static void test_math_xcorr_16(void **state)
+{
+	struct sofm_xcorr_16 xc;
+	int64_t ref[2 * TEST_MAX_LAG + 1];
+	int frames;
+	int done;
+	int i;
+
+	(void)state;
+
+	test_signals();
+	assert_int_equal(sofm_xcorr_16_init(&xc, TEST_MAX_LAG, 100), 0);
+
+	/* Process in varying chunks to test the history handling */
+	for (done = 0, frames = 1; done < TEST_FRAMES; done += frames) {
+		frames = MIN(frames + 7, 100);
+		frames = MIN(frames, TEST_FRAMES - done);
+		sofm_xcorr_16_process(&xc, &test_x[done], &test_y[done], 1, frames);
+	}
+
+	test_ref_xcorr(TEST_FRAMES, ref);
+	for (i = 0; i < 2 * TEST_MAX_LAG + 1; i++)
+		assert_true(xc.r[i] == ref[i]);
+
+	/* y is x delayed, so y matches x at negative lag */
+	assert_int_equal(sofm_xcorr_peak(xc.r, TEST_MAX_LAG), -TEST_DELAY);
+
+	sofm_xcorr_16_free(&xc);
+}
+
+#if CONFIG_MATH_FFT && CONFIG_MATH_32BIT_FFT
+static void test_math_xcorr_fft_16(void **state)
+{
+	struct sofm_xcorr_fft_16 xc;
+	int64_t ref[2 * TEST_MAX_LAG + 1];
+	int64_t r[2 * TEST_MAX_LAG + 1];
+	double delta;
+	double peak;
+	int i;
+
+	(void)state;
+
+	test_signals();
+	assert_int_equal(sofm_xcorr_fft_16_init(&xc, TEST_MAX_LAG, TEST_BLOCK), 0);
+
+	/* Interleaved stereo input */
+	for (i = 0; i < TEST_FRAMES; i++) {
+		int16_t frame[2] = { test_x[i], test_y[i] };
+
+		sofm_xcorr_fft_16_process(&xc, &frame[0], &frame[1], 2, 1);
+	}
+
+	sofm_xcorr_fft_16_get(&xc, r);
+	test_ref_xcorr(TEST_FRAMES, ref);
+
+	peak = (double)ref[TEST_MAX_LAG - TEST_DELAY];
+	for (i = 0; i < 2 * TEST_MAX_LAG + 1; i++) {
+		delta = fabs((double)(r[i] - ref[i])) / peak;
+		if (delta > TEST_FFT_MAX_ERROR)
+			printf("%s: lag %d error %g\n", __func__, i - TEST_MAX_LAG, delta);
+
+		assert_true(delta <= TEST_FFT_MAX_ERROR);
+	}
+
+	assert_int_equal(sofm_xcorr_peak(r, TEST_MAX_LAG), -TEST_DELAY);
+
+	sofm_xcorr_fft_16_free(&xc);
+}
+#endif
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_xcorr_16),
+#if CONFIG_MATH_FFT && CONFIG_MATH_32BIT_FFT
+		cmocka_unit_test(test_math_xcorr_fft_16),
+#endif
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -14,7 +14,10 @@
 #include <errno.h>
 #include <unistd.h>
 #include <math.h>
+#include <pthread.h>
 #include <sof/lib/uuid.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <time.h>
 #include <user/abi_dbg.h>
 #include <user/trace.h>
@@ -31,6 +34,9 @@
 #define TRACE_IDS_MASK			((1 << TRACE_ID_LENGTH) - 1)
 #define INVALID_TRACE_ID		(-1 & TRACE_IDS_MASK)
 
+/* log lines formatted at once, split between the jobs */
+#define LOG_BATCH_LINES			4096
+
 /** Dictionary entry. This MUST match the start of the linker output
  * defined by _DECLARE_LOG_ENTRY().
  */
@@ -43,30 +49,84 @@ struct ldc_entry_header {
 	uint32_t text_len;
 };
 
-/** Dictionary entry + unformatted parameters */
+/** Parameter conversions found in the text of a dictionary entry */
+enum ldc_param_type {
+	LDC_PARAM_VALUE = 0,	/* passed to printf() unmodified */
+	LDC_PARAM_STRING,	/* %s, not supported */
+	LDC_PARAM_UUID,		/* %pUx */
+	LDC_PARAM_ENTRY,	/* %pQ, text of another dictionary entry */
+};
+
+struct ldc_param {
+	enum ldc_param_type type;
+	bool be;		/* %pUb and %pUB */
+	bool upper;		/* %pUB and %pUL */
+};
+
+/** Dictionary entry, decoded on first use and kept in the dictionary index */
 struct ldc_entry {
 	struct ldc_entry_header header;
 	char *file_name;
-	char *text;
-	uint32_t *params;
+	char *short_name;	/* file_name shortened to the last 24 chars */
+	char *text;		/* text as in the dictionary */
+	char *format;		/* text with %pU and %pQ replaced by %s */
+	struct ldc_param params[TRACE_MAX_PARAMS_COUNT];
+};
+
+/** Dictionary index, sorted by entry address */
+struct ldc_index_entry {
+	uint32_t address;
+	struct ldc_entry *entry;
 };
 
-/** Dictionary entry + formatted parameters */
+/** Log statement waiting in the output batch */
+struct log_line {
+	struct log_entry_header dma_log;
+	const struct ldc_entry *entry;
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
+	const char *entry_texts[TRACE_MAX_PARAMS_COUNT];	/* %pQ */
+	uint64_t last_timestamp;
+	uint64_t timestamp_origin;
+	bool first;
+};
+
+/** Formatted parameters */
 struct proc_ldc_entry {
 	int subst_mask;
-	struct ldc_entry_header header;
-	char *file_name;
-	char *text;
 	uintptr_t params[TRACE_MAX_PARAMS_COUNT];
 };
 
+/** Growing buffer the log lines are formatted into */
+struct log_buf {
+	char *data;
+	size_t len;
+	size_t size;
+};
+
+/** Formats a slice of the output batch */
+struct log_job {
+	pthread_t thread;
+	bool started;
+	const struct log_line *lines;
+	size_t count;
+	struct log_buf buf;
+};
+
 #define BAD_PTR_STR "<bad uid ptr 0x%.8x>"
 #define UUID_LOWER "%s%s%s<%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x>%s%s%s"
 #define UUID_UPPER "%s%s%s<%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X>%s%s%s"
 
 static const char *missing = "<missing>";
 
-static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address);
+static const uint8_t *ldc_map;
+static size_t ldc_map_size;
+static struct ldc_index_entry *ldc_index;
+static size_t ldc_index_count;
+static size_t ldc_index_size;
+
+static struct log_line *log_batch;
+static size_t log_batch_count;
+static struct log_job *log_jobs;
 
 char *format_uid_raw(const struct sof_uuid_entry *uid_entry, int use_colors, int name_first,
 		     bool be, bool upper)
@@ -142,82 +202,52 @@ static const char *format_uid(uint32_t uid_ptr, int use_colors, bool be, bool up
 	return str;
 }
 
-/* fmt should point '%pUx`, return pointer to UUID string or zero */
-static const char *asprintf_uuid(const char *fmt, uint32_t uuid_key, bool use_colors, int *fmt_len)
+/* fmt should point '%pUx`, returns the length of the conversion */
+static int scan_uuid_format(const char *fmt, struct ldc_param *param)
 {
 	const char *fmt_end = fmt + strlen(fmt);
-	int be, upper;
 	int len = 4; /* assure full formating, with x */
 
-	if (fmt + 2 >= fmt_end || fmt[1] != 'p' || fmt[2] != 'U') {
-		*fmt_len = 0;
-		return NULL;
-	}
 	/* check 'x' value */
 	switch (fmt + 3 < fmt_end ? fmt[3] : 0) {
 	case 'b':
-		be = 1;
-		upper = 0;
+		param->be = true;
+		param->upper = false;
 		break;
 	case 'B':
-		be = 1;
-		upper = 1;
+		param->be = true;
+		param->upper = true;
 		break;
 	case 'l':
-		be = 0;
-		upper = 0;
+		param->be = false;
+		param->upper = false;
 		break;
 	case 'L':
-		be = 0;
-		upper = 1;
+		param->be = false;
+		param->upper = true;
 		break;
 	default:
-		be = 0;
-		upper = 0;
+		param->be = false;
+		param->upper = false;
 		--len;
 		break;
 	}
-	*fmt_len = len;
-	return format_uid(uuid_key, use_colors, be, upper);
+	return len;
 }
 
-static const char *asprintf_entry_text(uint32_t entry_address)
-{
-	struct ldc_entry entry;
-	int ret;
-
-	ret = read_entry_from_ldc_file(&entry, entry_address);
-	if (ret)
-		return NULL;
-
-	free(entry.file_name);
-
-	return entry.text;
-}
-
-/** printf-like formatting from the binary ldc_entry input to the
- *  formatted proc_lpc_entry output. Also copies the unmodified
- *  ldc_entry_header from input to output.
+/** Finds the parameter conversions of a dictionary entry and prepares the
+ * format used for printing it, with the %pU and %pQ conversions replaced by
+ * %s for the strings substituted by process_params().
  *
- * @param[out] pe copy of the header + formatted output
- * @param[in] e copy of the dictionary entry where unformatted,
-    uint32_t params have been inserted.
-   @param[in] use_colors whether to use ANSI terminal codes
-*/
-static void process_params(struct proc_ldc_entry *pe,
-			   const struct ldc_entry *e,
-			   int use_colors)
+ * @param[in,out] e dictionary entry, e->format is modified in place
+ */
+static void scan_params(struct ldc_entry *e)
 {
-	char *p = e->text;
-	const char *t_end = p + strlen(e->text);
+	char *p = e->format;
+	const char *t_end = p + strlen(e->format);
 	int uuid_fmt_len;
 	int i = 0;
 
-	pe->subst_mask = 0;
-	pe->header =  e->header;
-	pe->file_name = e->file_name;
-	pe->text = e->text;
-
 	/*
 	 * Scan the text for possible replacements. We follow the Linux kernel
 	 * that uses %pUx formats for UUID / GUID printing, where 'x' is
@@ -225,15 +255,12 @@ static void process_params(struct proc_ldc_entry *pe,
 	 * For decoding log entry text from pointer %pQ is used.
 	 */
 	while ((p = strchr(p, '%'))) {
-		uint32_t raw_param;
-
 		if (i >= e->header.params_num) {
-			/* Don't read e->params[] out of bounds. */
+			/* Don't read params out of bounds. */
 			log_err("Too many %% conversion specifiers in '%s'\n",
 				e->text);
 			break;
 		}
-		raw_param = e->params[i];
 
 		/* % can't be the last char */
 		if (p + 1 >= t_end) {
@@ -249,38 +276,20 @@ static void process_params(struct proc_ldc_entry *pe,
 			/* %s format specifier */
 			/* check for string printing, because it leads to logger crash */
 			log_err("String printing is not supported\n");
-			pe->params[i] = (uintptr_t)log_asprintf("<String @ 0x%08x>", raw_param);
-			if (!pe->params[i])
-				abort();
-			pe->subst_mask |= 1 << i;
-			++i;
+			e->params[i++].type = LDC_PARAM_STRING;
 			p += 2;
 		} else if (p + 2 < t_end && p[1] == 'p' && p[2] == 'U') {
 			/* %pUx format specifier */
-			/* substitute UUID entry address with formatted string pointer from heap */
-			pe->params[i] = (uintptr_t)asprintf_uuid(p, raw_param, use_colors,
-								 &uuid_fmt_len);
-			if (!pe->params[i])
-				abort();
-			pe->subst_mask |= 1 << i;
-			++i;
+			uuid_fmt_len = scan_uuid_format(p, &e->params[i]);
+			e->params[i++].type = LDC_PARAM_UUID;
 			/* replace uuid formatter with %s */
 			p[1] = 's';
 			memmove(&p[2], &p[uuid_fmt_len], (int)(t_end - &p[uuid_fmt_len]) + 1);
-			p += uuid_fmt_len - 2;
+			p += 2;
 			t_end -= uuid_fmt_len - 2;
 		} else if (p + 2 < t_end && p[1] == 'p' && p[2] == 'Q') {
 			/* %pQ format specifier */
-			/* substitute log entry address with formatted entry text */
-			pe->params[i] = (uintptr_t)asprintf_entry_text(raw_param);
-
-			if (pe->params[i])
-				pe->subst_mask |= 1 << i;
-			else
-				pe->params[i] = (uintptr_t)missing;
-
-			++i;
-
+			e->params[i++].type = LDC_PARAM_ENTRY;
 			/* replace entry formatter with %s */
 			p[1] = 's';
 			memmove(&p[2], &p[3], t_end - &p[2]);
@@ -290,8 +299,7 @@ static void process_params(struct proc_ldc_entry *pe,
 			/* arguments different from %pU and %pQ should be passed without
 			 * modification
 			 */
-			pe->params[i] = raw_param;
-			++i;
+			e->params[i++].type = LDC_PARAM_VALUE;
 			p += 2;
 		}
 	}
@@ -299,6 +307,52 @@ static void process_params(struct proc_ldc_entry *pe,
 		log_err("Too few %% conversion specifiers in '%s'\n", e->text);
 }
 
+/** printf-like formatting of the log parameters, as prepared by
+ *  scan_params() for the dictionary entry of the line.
+ *
+ * @param[out] pe formatted parameters
+ * @param[in] line log line with the unformatted uint32_t params
+   @param[in] use_colors whether to use ANSI terminal codes
+*/
+static void process_params(struct proc_ldc_entry *pe,
+			   const struct log_line *line,
+			   int use_colors)
+{
+	const struct ldc_entry *e = line->entry;
+	uint32_t raw_param;
+	int i;
+
+	pe->subst_mask = 0;
+
+	for (i = 0; i < e->header.params_num; i++) {
+		raw_param = line->params[i];
+
+		switch (e->params[i].type) {
+		case LDC_PARAM_STRING:
+			pe->params[i] = (uintptr_t)log_asprintf("<String @ 0x%08x>", raw_param);
+			if (!pe->params[i])
+				abort();
+			pe->subst_mask |= 1 << i;
+			break;
+		case LDC_PARAM_UUID:
+			/* substitute UUID entry address with formatted string pointer from heap */
+			pe->params[i] = (uintptr_t)format_uid(raw_param, use_colors,
+							      e->params[i].be, e->params[i].upper);
+			if (!pe->params[i])
+				abort();
+			pe->subst_mask |= 1 << i;
+			break;
+		case LDC_PARAM_ENTRY:
+			/* looked up when the line was read */
+			pe->params[i] = (uintptr_t)line->entry_texts[i];
+			break;
+		default:
+			pe->params[i] = raw_param;
+			break;
+		}
+	}
+}
+
 static void free_proc_ldc_entry(struct proc_ldc_entry *pe)
 {
 	int i;
@@ -454,16 +508,228 @@ static char *format_file_name(char *file_name_raw, int full_name)
 }
 
 static int entry_number = 1;
-/** Formats and outputs one entry from the trace + the corresponding
- * ldc_entry from the dictionary passed as arguments. Expects the log
- * variables to have already been copied into the ldc_entry.
+
+static void log_buf_reserve(struct log_buf *buf, size_t len)
+{
+	size_t size = buf->size ? buf->size : 4096;
+	char *data;
+
+	if (buf->len + len < buf->size)
+		return;
+
+	while (buf->len + len >= size)
+		size *= 2;
+
+	data = realloc(buf->data, size);
+	if (!data) {
+		log_err("can't allocate %zu bytes for the output\n", size);
+		exit(EXIT_FAILURE);
+	}
+	buf->data = data;
+	buf->size = size;
+}
+
+#ifdef __GNUC__
+__attribute__((format(printf, 2, 3)))
+#endif
+static int log_buf_printf(struct log_buf *buf, const char *fmt, ...)
+{
+	va_list args;
+	int len;
+
+	log_buf_reserve(buf, 0);
+
+	va_start(args, fmt);
+	len = vsnprintf(buf->data + buf->len, buf->size - buf->len, fmt, args);
+	va_end(args);
+	if (len < 0)
+		return len;
+
+	if (buf->len + len >= buf->size) {
+		log_buf_reserve(buf, len);
+		va_start(args, fmt);
+		len = vsnprintf(buf->data + buf->len, buf->size - buf->len, fmt, args);
+		va_end(args);
+		if (len < 0)
+			return len;
+	}
+
+	buf->len += len;
+	return len;
+}
+
+/** JSON escapes in place what was printed to the buffer from start on */
+static void log_buf_json_escape(struct log_buf *buf, size_t start)
+{
+	const char *src;
+	char *dst;
+	size_t extra = 0;
+	char code[8];
+	size_t i;
+
+	for (i = start; i < buf->len; i++) {
+		uint8_t c = buf->data[i];
+
+		if (c == '"' || c == '\\' || c == '\n' || c == '\t' || c == '\r')
+			extra += 1;
+		else if (c < 0x20)
+			extra += 5;
+	}
+	if (!extra)
+		return;
+
+	log_buf_reserve(buf, extra);
+
+	/* from the end, so that nothing is overwritten before it is read */
+	src = buf->data + buf->len;
+	dst = buf->data + buf->len + extra;
+	buf->len += extra;
+
+	while (src > buf->data + start) {
+		uint8_t c = *--src;
+
+		switch (c) {
+		case '"':
+		case '\\':
+			*--dst = c;
+			*--dst = '\\';
+			break;
+		case '\n':
+			*--dst = 'n';
+			*--dst = '\\';
+			break;
+		case '\t':
+			*--dst = 't';
+			*--dst = '\\';
+			break;
+		case '\r':
+			*--dst = 'r';
+			*--dst = '\\';
+			break;
+		default:
+			if (c < 0x20) {
+				sprintf(code, "\\u%04x", c);
+				dst -= 6;
+				memcpy(dst, code, 6);
+			} else {
+				*--dst = c;
+			}
+			break;
+		}
+	}
+}
+
+static void log_buf_json_string(struct log_buf *buf, const char *name, const char *value)
+{
+	size_t start;
+
+	log_buf_printf(buf, "\"%s\":\"", name);
+	start = buf->len;
+	log_buf_printf(buf, "%s", value);
+	log_buf_json_escape(buf, start);
+	log_buf_printf(buf, "\"");
+}
+
+/** Prints the text of the log line with its formatted parameters. */
+static void print_text(struct log_buf *out, const struct log_line *line,
+		       const struct proc_ldc_entry *pe)
+{
+	const struct ldc_entry *entry = line->entry;
+	int ret;
+
+	switch (entry->header.params_num) {
+	case 0:
+		ret = log_buf_printf(out, "%s", entry->format);
+		break;
+	case 1:
+		ret = log_buf_printf(out, entry->format, pe->params[0]);
+		break;
+	case 2:
+		ret = log_buf_printf(out, entry->format, pe->params[0], pe->params[1]);
+		break;
+	case 3:
+		ret = log_buf_printf(out, entry->format, pe->params[0], pe->params[1],
+				     pe->params[2]);
+		break;
+	case 4:
+		ret = log_buf_printf(out, entry->format, pe->params[0], pe->params[1],
+				     pe->params[2], pe->params[3]);
+		break;
+	default:
+		log_err("Unsupported number of arguments for '%s'", entry->format);
+		ret = 0; /* don't log the error */
+		break;
+	}
+	/* log format text comes from ldc file (may be invalid), so error check is needed here */
+	if (ret < 0)
+		log_err("trace formatting failed for '%s', %d '%s'",
+			entry->format, errno, strerror(errno));
+}
+
+/** Formats one log line as a JSON object on a line of its own. */
+static void print_entry_json(struct log_buf *out, const struct log_line *line, float dt)
+{
+	const struct log_entry_header *dma_log = &line->dma_log;
+	const struct ldc_entry *entry = line->entry;
+	int time_precision = global_config->time_precision;
+	const char *level = get_level_name(entry->header.level);
+	struct proc_ldc_entry proc_entry;
+	char ids[TRACE_MAX_IDS_STR];
+	size_t start;
+
+	log_buf_printf(out, "{");
+
+	if (time_precision >= 0) {
+		log_buf_printf(out, "\"timestamp\":%.*f,", time_precision,
+			       to_usecs(dma_log->timestamp - line->timestamp_origin));
+		if (isnan(dt))
+			log_buf_printf(out, "\"delta\":null,");
+		else
+			log_buf_printf(out, "\"delta\":%.*f,", time_precision, dt);
+	}
+
+	log_buf_printf(out, "\"core\":%u,", dma_log->core_id);
+
+	/* level names are padded with one space */
+	log_buf_printf(out, "\"level\":\"%.*s\",", (int)strlen(level) - 1, level);
+
+	log_buf_json_string(out, "component",
+			    get_component_name(entry->header.component_class, dma_log->uid));
+
+	if (dma_log->id_0 != INVALID_TRACE_ID &&
+	    dma_log->id_1 != INVALID_TRACE_ID)
+		sprintf(ids, "%d.%d", (dma_log->id_0 & TRACE_IDS_MASK),
+			(dma_log->id_1 & TRACE_IDS_MASK));
+	else
+		ids[0] = '\0';
+	log_buf_printf(out, ",\"ids\":\"%s\",", ids);
+
+	if (!global_config->hide_location) {
+		log_buf_json_string(out, "file", format_file_name(entry->file_name, 1));
+		log_buf_printf(out, ",\"line\":%u,", entry->header.line_idx);
+	}
+
+	process_params(&proc_entry, line, 0);
+
+	log_buf_printf(out, "\"message\":\"");
+	start = out->len;
+	print_text(out, line, &proc_entry);
+	log_buf_json_escape(out, start);
+	log_buf_printf(out, "\"}\n");
+
+	free_proc_ldc_entry(&proc_entry);
+}
+
+/** Formats and outputs one log line, the log variables and the dictionary
+ * entry were collected by fetch_entry().
  */
-static void print_entry_params(const struct log_entry_header *dma_log,
-			       const struct ldc_entry *entry, uint64_t last_timestamp)
+static void print_entry_params(struct log_buf *out, const struct log_line *line)
 {
-	static uint64_t timestamp_origin;
+	const struct log_entry_header *dma_log = &line->dma_log;
+	const struct ldc_entry *entry = line->entry;
+	uint64_t last_timestamp = line->last_timestamp;
+	uint64_t timestamp_origin = line->timestamp_origin;
 
-	FILE *out_fd = global_config->out_fd;
 	int use_colors = global_config->use_colors;
 	int raw_output = global_config->raw_output;
 	int hide_location = global_config->hide_location;
@@ -472,7 +738,6 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 	char ids[TRACE_MAX_IDS_STR];
 	float dt = to_usecs(dma_log->timestamp - last_timestamp);
 	struct proc_ldc_entry proc_entry;
-	int ret;
 
 	if (raw_output)
 		use_colors = 0;
@@ -481,28 +746,21 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 	if (dt > 1000.0 * 1000.0 * 1000.0)
 		dt = NAN;
 
-	if (dma_log->timestamp < last_timestamp) {
-		fprintf(out_fd,
-			"\n\t\t --- negative DELTA = %.3f us: wrap, IPC_TRACE, other? ---\n\n",
-			-to_usecs(last_timestamp - dma_log->timestamp));
-		entry_number = 1;
-	}
-
-	/* The first entry:
-	 *  - is never shown with a relative TIMESTAMP (to itself!?)
-	 *  - shows a zero DELTA
+	/* The first entry is never shown with a relative TIMESTAMP and shows
+	 * a zero DELTA.
 	 */
-	if (entry_number == 1) {
-		entry_number++;
-		/* Display absolute (and random) timestamps */
-		timestamp_origin = 0;
+	if (line->first)
 		dt = 0;
-	} else if (entry_number == 2) {
-		entry_number++;
-		if (global_config->relative_timestamps == 1)
-			/* Switch to relative timestamps from now on. */
-			timestamp_origin = last_timestamp;
-	} /* We don't need the exact entry_number after 3 */
+
+	if (global_config->json_output) {
+		print_entry_json(out, line, dt);
+		return;
+	}
+
+	if (dma_log->timestamp < last_timestamp)
+		log_buf_printf(out,
+			       "\n\t\t --- negative DELTA = %.3f us: wrap, IPC_TRACE, other? ---\n\n",
+			       -to_usecs(last_timestamp - dma_log->timestamp));
 
 	if (dma_log->id_0 != INVALID_TRACE_ID &&
 	    dma_log->id_1 != INVALID_TRACE_ID)
@@ -512,249 +770,520 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 		ids[0] = '\0';
 
 	if (raw_output) { /* "raw" means script-friendly (not all hex) */
-		fprintf(out_fd, "%s%u %u %s%s%s ",
-			entry->header.level == use_colors ?
-				(LOG_LEVEL_CRITICAL ? KRED : KNRM) : "",
-			dma_log->core_id,
-			entry->header.level,
-			get_component_name(entry->header.component_class, dma_log->uid),
-			raw_output && strlen(ids) ? "-" : "",
-			ids);
+		log_buf_printf(out, "%s%u %u %s%s%s ",
+			       entry->header.level == use_colors ?
+					(LOG_LEVEL_CRITICAL ? KRED : KNRM) : "",
+			       dma_log->core_id,
+			       entry->header.level,
+			       get_component_name(entry->header.component_class, dma_log->uid),
+			       raw_output && strlen(ids) ? "-" : "",
+			       ids);
 
 		if (time_precision >= 0)
-			fprintf(out_fd, "%.*f %.*f ",
-				time_precision, to_usecs(dma_log->timestamp - timestamp_origin),
-				time_precision, dt);
+			log_buf_printf(out, "%.*f %.*f ",
+				       time_precision,
+				       to_usecs(dma_log->timestamp - timestamp_origin),
+				       time_precision, dt);
 
 		if (!hide_location)
-			fprintf(out_fd, "(%s:%u) ",
-				format_file_name(entry->file_name, raw_output),
-				entry->header.line_idx);
+			log_buf_printf(out, "(%s:%u) ",
+				       format_file_name(entry->file_name, raw_output),
+				       entry->header.line_idx);
 	} else {
 		if (time_precision >= 0) {
 			const unsigned int ts_width = timestamp_width(time_precision);
 
-			fprintf(out_fd, "%s[%*.*f] (%*.*f)%s ",
-				use_colors ? KGRN : "",
-				ts_width, time_precision,
-				to_usecs(dma_log->timestamp - timestamp_origin),
-				ts_width, time_precision, dt,
-				use_colors ? KNRM : "");
+			log_buf_printf(out, "%s[%*.*f] (%*.*f)%s ",
+				       use_colors ? KGRN : "",
+				       ts_width, time_precision,
+				       to_usecs(dma_log->timestamp - timestamp_origin),
+				       ts_width, time_precision, dt,
+				       use_colors ? KNRM : "");
 		}
 
 		/* core id */
-		fprintf(out_fd, "c%d ", dma_log->core_id);
+		log_buf_printf(out, "c%d ", dma_log->core_id);
 
 		/* component name and id */
-		fprintf(out_fd, "%s%-12s %-5s%s ",
-			use_colors ? KYEL : "",
-			get_component_name(entry->header.component_class, dma_log->uid),
-			ids,
-			use_colors ? KNRM : "");
+		log_buf_printf(out, "%s%-12s %-5s%s ",
+			       use_colors ? KYEL : "",
+			       get_component_name(entry->header.component_class, dma_log->uid),
+			       ids,
+			       use_colors ? KNRM : "");
 
 		/* location */
 		if (!hide_location)
-			fprintf(out_fd, "%24s:%-4u ",
-				format_file_name(entry->file_name, raw_output),
-				entry->header.line_idx);
+			log_buf_printf(out, "%24s:%-4u ", entry->short_name,
+				       entry->header.line_idx);
 
 		/* level name */
-		fprintf(out_fd, "%s%s",
-			use_colors ? get_level_color(entry->header.level) : "",
-			get_level_name(entry->header.level));
+		log_buf_printf(out, "%s%s",
+			       use_colors ? get_level_color(entry->header.level) : "",
+			       get_level_name(entry->header.level));
 	}
 
 	/* Minimal, printf-like formatting */
-	process_params(&proc_entry, entry, use_colors);
-
-	switch (proc_entry.header.params_num) {
-	case 0:
-		ret = fprintf(out_fd, "%s", proc_entry.text);
-		break;
-	case 1:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0]);
-		break;
-	case 2:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1]);
-		break;
-	case 3:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1],
-			      proc_entry.params[2]);
-		break;
-	case 4:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1],
-			      proc_entry.params[2], proc_entry.params[3]);
-		break;
-	default:
-		log_err("Unsupported number of arguments for '%s'", proc_entry.text);
-		ret = 0; /* don't log ferror */
-		break;
-	}
+	process_params(&proc_entry, line, use_colors);
+	print_text(out, line, &proc_entry);
 	free_proc_ldc_entry(&proc_entry);
-	/* log format text comes from ldc file (may be invalid), so error check is needed here */
-	if (ret < 0)
-		log_err("trace fprintf failed for '%s', %d '%s'",
-			proc_entry.text, ferror(out_fd), strerror(ferror(out_fd)));
-	fprintf(out_fd, "%s\n", use_colors ? KNRM : "");
-	fflush(out_fd);
+
+	log_buf_printf(out, "%s\n", use_colors ? KNRM : "");
 }
 
-static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address)
+/** Maps the dictionary and indexes the entries found by walking the log
+ * entries section. Entries the walk misses are added by get_ldc_entry().
+ */
+static int ldc_index_init(void)
 {
 	uint32_t base_address = global_config->logs_header->base_address;
 	uint32_t data_offset = global_config->logs_header->data_offset;
-
+	uint32_t data_length = global_config->logs_header->data_length;
+	struct ldc_index_entry *index;
+	struct ldc_entry_header header;
+	struct stat st;
+	size_t offset;
+	void *map;
 	int ret;
 
-	/* evaluate entry offset in input file */
-	uint32_t entry_offset = (log_entry_address - base_address) + data_offset;
+	if (fstat(fileno(global_config->ldc_fd), &st) < 0) {
+		ret = -errno;
+		log_err("Failed to stat %s: %s\n", global_config->ldc_file, strerror(-ret));
+		return ret;
+	}
 
-	entry->file_name = NULL;
-	entry->text = NULL;
-	entry->params = NULL;
+	if ((size_t)data_offset + data_length > (size_t)st.st_size) {
+		log_err("Log entries exceed the size of %s\n", global_config->ldc_file);
+		return -EINVAL;
+	}
 
-	/* set file position to beginning of processed entry */
-	ret = fseek(global_config->ldc_fd, entry_offset, SEEK_SET);
-	if (ret) {
-		log_err("Failed to seek to entry header for offset 0x%x in dictionary.\n",
-			entry_offset);
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(global_config->ldc_fd), 0);
+	if (map == MAP_FAILED) {
 		ret = -errno;
-		goto out;
+		log_err("Failed to map %s: %s\n", global_config->ldc_file, strerror(-ret));
+		return ret;
 	}
+	ldc_map = map;
+	ldc_map_size = st.st_size;
+
+	/* every entry is padded to 4 bytes, zero words pad the sections */
+	offset = data_offset;
+	while (offset + sizeof(header) <= (size_t)data_offset + data_length) {
+		memcpy(&header, ldc_map + offset, sizeof(header));
+		if (!header.file_name_len) {
+			offset += sizeof(uint32_t);
+			continue;
+		}
+		if (header.file_name_len > TRACE_MAX_FILENAME_LEN ||
+		    header.text_len > TRACE_MAX_TEXT_LEN)
+			break;
 
-	/* fetching elf header params */
-	ret = fread(&entry->header, sizeof(entry->header), 1, global_config->ldc_fd);
-	if (ret != 1) {
-		log_err("Failed to read entry header for offset 0x%x in dictionary.\n",
-			entry_offset);
-		ret = -1;
-		goto out;
+		if (ldc_index_count == ldc_index_size) {
+			ldc_index_size = ldc_index_size ? ldc_index_size * 2 : 1024;
+			index = realloc(ldc_index, ldc_index_size * sizeof(*index));
+			if (!index)
+				return -ENOMEM;
+			ldc_index = index;
+		}
+		ldc_index[ldc_index_count].address = offset - data_offset + base_address;
+		ldc_index[ldc_index_count].entry = NULL;
+		ldc_index_count++;
+
+		offset += (sizeof(header) + header.file_name_len + header.text_len + 3) & ~3;
 	}
-	if (entry->header.file_name_len > TRACE_MAX_FILENAME_LEN) {
-		log_err("Invalid filename length %d or ldc file does not match firmware\n",
-			entry->header.file_name_len);
-		ret = -EINVAL;
-		goto out;
+
+	return 0;
+}
+
+static void ldc_index_free(void)
+{
+	struct ldc_entry *entry;
+	size_t i;
+
+	for (i = 0; i < ldc_index_count; i++) {
+		entry = ldc_index[i].entry;
+		if (!entry)
+			continue;
+		free(entry->file_name);
+		free(entry->short_name);
+		free(entry->text);
+		free(entry->format);
+		free(entry);
 	}
-	entry->file_name = (char *)malloc(entry->header.file_name_len + 1);
+	free(ldc_index);
+	ldc_index = NULL;
+	ldc_index_count = 0;
+	ldc_index_size = 0;
+
+	if (ldc_map)
+		munmap((void *)ldc_map, ldc_map_size);
+	ldc_map = NULL;
+}
 
-	if (!entry->file_name) {
-		log_err("can't allocate %d byte for entry.file_name\n",
-			entry->header.file_name_len);
-		ret = -ENOMEM;
-		goto out;
+static char *ldc_strndup(const uint8_t *str, uint32_t len)
+{
+	char *dup = malloc(len + 1);
+
+	if (!dup) {
+		log_err("can't allocate %d byte for dictionary string\n", len + 1);
+		return NULL;
 	}
+	memcpy(dup, str, len);
+	dup[len] = '\0';
+
+	return dup;
+}
 
-	ret = fread(entry->file_name, sizeof(char), entry->header.file_name_len,
-		    global_config->ldc_fd);
-	entry->file_name[entry->header.file_name_len] = '\0';
+static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address)
+{
+	uint32_t base_address = global_config->logs_header->base_address;
+	uint32_t data_offset = global_config->logs_header->data_offset;
+	const uint8_t *data;
+	char *name;
+
+	/* evaluate entry offset in input file */
+	size_t entry_offset = (size_t)(uint32_t)(log_entry_address - base_address) + data_offset;
 
-	if (ret != entry->header.file_name_len) {
-		log_err("Failed to read source filename for offset 0x%x in dictionary.\n",
+	if (log_entry_address < base_address ||
+	    entry_offset + sizeof(entry->header) > ldc_map_size) {
+		log_err("Failed to read entry header for offset 0x%zx in dictionary.\n",
 			entry_offset);
-		ret = -1;
-		goto out;
+		return -EINVAL;
+	}
+
+	/* fetching elf header params */
+	memcpy(&entry->header, ldc_map + entry_offset, sizeof(entry->header));
+	data = ldc_map + entry_offset + sizeof(entry->header);
+
+	if (entry->header.file_name_len > TRACE_MAX_FILENAME_LEN) {
+		log_err("Invalid filename length %d or ldc file does not match firmware\n",
+			entry->header.file_name_len);
+		return -EINVAL;
 	}
 
 	/* fetching text */
 	if (entry->header.text_len > TRACE_MAX_TEXT_LEN) {
 		log_err("Invalid text length.\n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry->text = (char *)malloc(entry->header.text_len + 1);
-	if (!entry->text) {
-		log_err("can't allocate %d byte for entry.text\n", entry->header.text_len);
-		ret = -ENOMEM;
-		goto out;
+		return -EINVAL;
 	}
-	ret = fread(entry->text, sizeof(char), entry->header.text_len, global_config->ldc_fd);
-	if (ret != entry->header.text_len) {
-		log_err("Failed to read log message at offset 0x%x from dictionary.\n",
+
+	if (entry_offset + sizeof(entry->header) + entry->header.file_name_len +
+	    entry->header.text_len > ldc_map_size) {
+		log_err("Failed to read log message at offset 0x%zx from dictionary.\n",
 			entry_offset);
-		ret = -1;
-		goto out;
+		return -EINVAL;
+	}
+
+	/* fetching entry params from dma dump */
+	if (entry->header.params_num > TRACE_MAX_PARAMS_COUNT) {
+		log_err("Invalid number of parameters.\n");
+		return -EINVAL;
+	}
+
+	entry->file_name = ldc_strndup(data, entry->header.file_name_len);
+	entry->short_name = ldc_strndup(data, entry->header.file_name_len);
+	data += entry->header.file_name_len;
+	entry->text = ldc_strndup(data, entry->header.text_len);
+	entry->format = ldc_strndup(data, entry->header.text_len);
+	if (!entry->file_name || !entry->short_name || !entry->text || !entry->format)
+		return -ENOMEM;
+
+	name = format_file_name(entry->short_name, 0);
+	memmove(entry->short_name, name, strlen(name) + 1);
+
+	scan_params(entry);
+
+	return 0;
+}
+
+/** Gets the decoded dictionary entry at the log entry address, decodes the
+ * entry and adds it to the index on first use.
+ *
+ * @param[in] log_entry_address address of the entry in the firmware
+ * @param[out] entry the dictionary entry, valid until ldc_index_free()
+ */
+static int get_ldc_entry(uint32_t log_entry_address, const struct ldc_entry **entry)
+{
+	struct ldc_index_entry *index;
+	struct ldc_entry *e;
+	size_t lo = 0;
+	size_t hi = ldc_index_count;
+	size_t mid;
+	int ret;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (ldc_index[mid].address < log_entry_address)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo < ldc_index_count && ldc_index[lo].address == log_entry_address &&
+	    ldc_index[lo].entry) {
+		*entry = ldc_index[lo].entry;
+		return 0;
+	}
+
+	e = calloc(1, sizeof(*e));
+	if (!e)
+		return -ENOMEM;
+
+	ret = read_entry_from_ldc_file(e, log_entry_address);
+	if (ret < 0) {
+		free(e->file_name);
+		free(e->short_name);
+		free(e->text);
+		free(e->format);
+		free(e);
+		return ret;
+	}
+
+	if (lo == ldc_index_count || ldc_index[lo].address != log_entry_address) {
+		/* not found by the walk of the dictionary */
+		if (ldc_index_count == ldc_index_size) {
+			ldc_index_size = ldc_index_size ? ldc_index_size * 2 : 1024;
+			index = realloc(ldc_index, ldc_index_size * sizeof(*index));
+			if (!index) {
+				free(e);
+				return -ENOMEM;
+			}
+			ldc_index = index;
+		}
+		memmove(&ldc_index[lo + 1], &ldc_index[lo],
+			(ldc_index_count - lo) * sizeof(*ldc_index));
+		ldc_index[lo].address = log_entry_address;
+		ldc_index_count++;
 	}
-	entry->text[entry->header.text_len] = '\0';
+	ldc_index[lo].entry = e;
 
+	*entry = e;
 	return 0;
+}
 
-out:
-	free(entry->text);
-	entry->text = NULL;
-	free(entry->file_name);
-	entry->file_name = NULL;
+static void *log_job_run(void *data)
+{
+	struct log_job *job = data;
+	size_t i;
 
-	return ret;
+	for (i = 0; i < job->count; i++)
+		print_entry_params(&job->buf, &job->lines[i]);
+
+	return NULL;
 }
 
+/** Formats the lines of the output batch, split between the jobs, and
+ * writes them out in order.
+ */
+static void log_batch_flush(void)
+{
+	FILE *out_fd = global_config->out_fd;
+	size_t count = CEIL(log_batch_count, (size_t)global_config->jobs);
+	size_t first = 0;
+	struct log_job *job;
+	int jobs;
+	int i;
+
+	if (!log_batch_count)
+		return;
+
+	for (jobs = 0; first < log_batch_count; jobs++) {
+		job = &log_jobs[jobs];
+		job->lines = log_batch + first;
+		job->count = log_batch_count - first < count ? log_batch_count - first : count;
+		job->buf.len = 0;
+		first += job->count;
+	}
+
+	/* the first slice is formatted by this thread */
+	for (i = 1; i < jobs; i++) {
+		job = &log_jobs[i];
+		job->started = !pthread_create(&job->thread, NULL, log_job_run, job);
+		if (!job->started)
+			log_job_run(job);
+	}
+	log_job_run(&log_jobs[0]);
+
+	for (i = 0; i < jobs; i++) {
+		job = &log_jobs[i];
+		if (job->started)
+			pthread_join(job->thread, NULL);
+		job->started = false;
+		fwrite(job->buf.data, 1, job->buf.len, out_fd);
+	}
+	fflush(out_fd);
+
+	log_batch_count = 0;
+}
+
+/** Writes out the pending log lines and returns the stream for messages
+ * printed between them. The JSON output gets no such messages.
+ */
+static FILE *log_notice_fd(void)
+{
+	log_batch_flush();
+
+	return global_config->json_output ? stderr : global_config->out_fd;
+}
+
+static int log_batch_init(void)
+{
+	log_batch = calloc(LOG_BATCH_LINES, sizeof(*log_batch));
+	log_jobs = calloc(global_config->jobs, sizeof(*log_jobs));
+	if (!log_batch || !log_jobs)
+		return -ENOMEM;
+
+	return 0;
+}
+
+static void log_batch_free(void)
+{
+	int i;
+
+	if (log_jobs)
+		for (i = 0; i < global_config->jobs; i++)
+			free(log_jobs[i].buf.data);
+	free(log_jobs);
+	log_jobs = NULL;
+	free(log_batch);
+	log_batch = NULL;
+	log_batch_count = 0;
+}
+
+/** Adds a log line to the output batch. Timestamps are made relative and
+ * the dictionary entries printed by %pQ are looked up here, in log order.
+ */
+static int log_batch_add(const struct log_entry_header *dma_log, const struct ldc_entry *entry,
+			 const uint32_t *params, uint64_t last_timestamp)
+{
+	static uint64_t timestamp_origin;
+	struct log_line *line = &log_batch[log_batch_count];
+	const struct ldc_entry *text_entry;
+	bool live;
+	int i;
+
+	line->dma_log = *dma_log;
+	line->entry = entry;
+	line->last_timestamp = last_timestamp;
+	memcpy(line->params, params, sizeof(uint32_t) * entry->header.params_num);
+
+	for (i = 0; i < entry->header.params_num; i++) {
+		if (entry->params[i].type != LDC_PARAM_ENTRY)
+			continue;
+		/* substitute log entry address with formatted entry text */
+		if (get_ldc_entry(params[i], &text_entry) < 0)
+			line->entry_texts[i] = missing;
+		else
+			line->entry_texts[i] = text_entry->text;
+	}
+
+	if (dma_log->timestamp < last_timestamp)
+		entry_number = 1;
+
+	/* The first entry:
+	 *  - is never shown with a relative TIMESTAMP (to itself!?)
+	 *  - shows a zero DELTA
+	 */
+	line->first = entry_number == 1;
+	if (entry_number == 1) {
+		entry_number++;
+		/* Display absolute (and random) timestamps */
+		timestamp_origin = 0;
+	} else if (entry_number == 2) {
+		entry_number++;
+		if (global_config->relative_timestamps == 1)
+			/* Switch to relative timestamps from now on. */
+			timestamp_origin = last_timestamp;
+	} /* We don't need the exact entry_number after 3 */
+	line->timestamp_origin = timestamp_origin;
+
+	/* without jobs, live logs are written out line by line */
+	live = global_config->trace || global_config->input_std ||
+	       global_config->serial_fd >= 0;
+
+	if (++log_batch_count == LOG_BATCH_LINES || (live && global_config->jobs == 1))
+		log_batch_flush();
+
+	return 0;
+}
+
+/** Decoded entry of a compact block, kept until the merge round ends */
+struct compact_entry {
+	struct log_entry_header header;
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
+	int params_num;
+	size_t seq;
+};
+
+static struct compact_entry *compact_entries;
+static size_t compact_count;
+static size_t compact_size;
+
 /** Gets the dictionary entry matching the log entry argument, reads
  * from the log the variable number of arguments needed by this entry
- * and passes everything to print_entry_params() to finish processing
+ * and passes everything to the output batch to finish processing
  * this log entry. So not just "fetch" but everything else after it too.
  *
  * @param[in] dma_log protocol header from any trace (not just from the
  * "DMA" trace)
+ * @param[in] params arguments of compact entries, read from the input
+ * when NULL
+ * @param[in] params_num number of params
  * @param[in,out] last_timestamp timestamp found for this entry
  */
-static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_timestamp)
+static int fetch_entry(const struct log_entry_header *dma_log, const uint32_t *params,
+		       int params_num, uint64_t *last_timestamp)
 {
-	struct ldc_entry entry;
+	const struct ldc_entry *entry;
+	uint32_t entry_params[TRACE_MAX_PARAMS_COUNT];
 	int ret;
 
-	ret = read_entry_from_ldc_file(&entry, dma_log->log_entry_address);
+	ret = get_ldc_entry(dma_log->log_entry_address, &entry);
 	if (ret < 0) {
-		log_err("read_entry_from_ldc_file(0x%x) returned %d\n",
+		log_err("get_ldc_entry(0x%x) returned %d\n",
 			dma_log->log_entry_address, ret);
-		goto out;
+		return ret;
 	}
 
-	/* fetching entry params from dma dump */
-	if (entry.header.params_num > TRACE_MAX_PARAMS_COUNT) {
-		log_err("Invalid number of parameters.\n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry.params = (uint32_t *)malloc(sizeof(uint32_t) * entry.header.params_num);
-	if (!entry.params) {
-		log_err("can't allocate %d byte for entry.params\n",
-			(int)(sizeof(uint32_t) * entry.header.params_num));
-		ret = -ENOMEM;
-		goto out;
-	}
-
-	if (global_config->serial_fd < 0) {
-		ret = fread(entry.params, sizeof(uint32_t), entry.header.params_num,
+	if (params) {
+		if (params_num < entry->header.params_num) {
+			log_err("Compact entry has %d of %d params\n", params_num,
+				entry->header.params_num);
+			return -EINVAL;
+		}
+		memcpy(entry_params, params, sizeof(uint32_t) * entry->header.params_num);
+	} else if (global_config->serial_fd < 0) {
+		/* fetching entry params from dma dump */
+		ret = fread(entry_params, sizeof(uint32_t), entry->header.params_num,
 			    global_config->in_fd);
-		if (ret != entry.header.params_num) {
-			fprintf(global_config->out_fd,
+		if (ret != entry->header.params_num) {
+			fprintf(log_notice_fd(),
 				"warn: failed to fread() %d params from the log for %s:%d\n",
-				entry.header.params_num,
-				entry.file_name, entry.header.line_idx);
+				entry->header.params_num,
+				entry->file_name, entry->header.line_idx);
 
 			ret = ferror(global_config->in_fd) ? -1 : 0;
 
 			if (feof(global_config->in_fd))
-				fprintf(global_config->out_fd,
+				fprintf(log_notice_fd(),
 					"warn: log's End Of File. Device suspend?\n");
 
-			goto out;
+			return ret;
 		}
 	} else { /* serial */
-		size_t size = sizeof(uint32_t) * entry.header.params_num;
+		size_t size = sizeof(uint32_t) * entry->header.params_num;
 		uint8_t *n;
 
 		/* Repeatedly read() how much we still miss until we got
 		 * enough for the number of params needed by this
 		 * particular statement.
 		 */
-		for (n = (uint8_t *)entry.params; size; n += ret, size -= ret) {
+		for (n = (uint8_t *)entry_params; size; n += ret, size -= ret) {
 			ret = read(global_config->serial_fd, n, size);
 			if (ret < 0) {
 				ret = -errno;
 				log_err("Failed to fread %d params from serial: %s\n",
-					entry.header.params_num, strerror(errno));
-				goto out;
+					entry->header.params_num, strerror(errno));
+				return ret;
 			}
 			if (ret != size)
 				log_err("Partial read of %u bytes of %zu, reading more\n",
@@ -762,20 +1291,131 @@ static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_ti
 		}
 	} /* serial */
 
-	/* printing entry content */
-	print_entry_params(dma_log, &entry, *last_timestamp);
+	ret = log_batch_add(dma_log, entry, entry_params, *last_timestamp);
 	*last_timestamp = dma_log->timestamp;
 
-	/* set f_ldc file position to the beginning */
-	rewind(global_config->ldc_fd);
+	return ret;
+}
 
-	ret = 0;
-out:
-	/* free alocated memory */
-	free(entry.params);
-	free(entry.text);
-	free(entry.file_name);
+static const uint8_t *read_varint(const uint8_t *p, const uint8_t *end, uint64_t *value)
+{
+	int shift;
+
+	for (*value = 0, shift = 0; p < end && shift < 64; shift += 7) {
+		*value |= (uint64_t)(*p & 0x7f) << shift;
+		if (!(*p++ & 0x80))
+			return p;
+	}
 
+	return NULL;
+}
+
+static int compact_entry_cmp(const void *a, const void *b)
+{
+	const struct compact_entry *ea = a;
+	const struct compact_entry *eb = b;
+
+	if (ea->header.timestamp != eb->header.timestamp)
+		return ea->header.timestamp < eb->header.timestamp ? -1 : 1;
+
+	return ea->seq < eb->seq ? -1 : ea->seq > eb->seq;
+}
+
+/** Decode the entries of a per core compact block, print all entries of
+ * the merge round in timestamp order when the last block of round comes.
+ */
+static int read_compact_block(const struct log_compact_block_header *block,
+			      uint64_t *last_timestamp)
+{
+	struct compact_entry *entry;
+	uint64_t timestamp = block->timestamp;
+	uint64_t value[5];
+	const uint8_t *p, *end;
+	uint8_t *data;
+	size_t pos;
+	size_t i;
+	int ret = 0;
+
+	if (block->dropped)
+		fprintf(log_notice_fd(), "warn: core %u dropped %u log entries\n",
+			block->core_id, block->dropped);
+
+	data = malloc(block->size ? block->size : 1);
+	if (!data)
+		return -ENOMEM;
+
+	if (fread(data, 1, block->size, global_config->in_fd) != block->size) {
+		ret = ferror(global_config->in_fd) ? -EIO : 0;
+		goto out;
+	}
+
+	for (pos = 0; pos < block->size; pos += data[pos] + 1) {
+		/* padding */
+		if (!data[pos])
+			continue;
+
+		p = data + pos + 1;
+		end = p + data[pos];
+		if (end > data + block->size) {
+			log_err("Compact entry exceeds block\n");
+			ret = -EINVAL;
+			goto out;
+		}
+
+		/* timestamp delta, log entry address, uid, id_0, id_1 */
+		for (i = 0; i < ARRAY_SIZE(value) && p; i++)
+			p = read_varint(p, end, &value[i]);
+		if (!p) {
+			log_err("Invalid compact entry\n");
+			ret = -EINVAL;
+			goto out;
+		}
+
+		if (compact_count == compact_size) {
+			compact_size = compact_size ? compact_size * 2 : 64;
+			entry = realloc(compact_entries, compact_size * sizeof(*entry));
+			if (!entry) {
+				ret = -ENOMEM;
+				goto out;
+			}
+			compact_entries = entry;
+		}
+
+		timestamp += value[0];
+		entry = &compact_entries[compact_count];
+		memset(entry, 0, sizeof(*entry));
+		entry->header.timestamp = timestamp;
+		entry->header.log_entry_address = value[1];
+		entry->header.uid = value[2];
+		entry->header.id_0 = value[3];
+		entry->header.id_1 = value[4];
+		entry->header.core_id = block->core_id;
+		entry->seq = compact_count;
+
+		while (p < end && entry->params_num < TRACE_MAX_PARAMS_COUNT) {
+			p = read_varint(p, end, &value[0]);
+			if (!p)
+				break;
+			entry->params[entry->params_num++] = value[0];
+		}
+		compact_count++;
+	}
+
+	if (!block->last)
+		goto out;
+
+	qsort(compact_entries, compact_count, sizeof(*compact_entries), compact_entry_cmp);
+	for (i = 0; i < compact_count; i++) {
+		entry = &compact_entries[i];
+		ret = fetch_entry(&entry->header, entry->params, entry->params_num,
+				  last_timestamp);
+		if (ret)
+			break;
+	}
+	compact_count = 0;
+
+out:
+	free(data);
 	return ret;
 }
 
@@ -814,7 +1454,7 @@ static int serial_read(uint64_t *last_timestamp)
 
 		memcpy(s, c, sizeof(s) - 1);
 		s[sizeof(s) - 1] = '\0';
-		fprintf(global_config->out_fd, "Trace point %s", s);
+		fprintf(log_notice_fd(), "Trace point %s", s);
 
 		memmove(&dma_log, c + 9, sizeof(dma_log) - 9);
 
@@ -829,28 +1469,31 @@ static int serial_read(uint64_t *last_timestamp)
 	/* fetching entry from elf dump and complete processing this log
 	 * line
 	 */
-	return fetch_entry(&dma_log, last_timestamp);
+	return fetch_entry(&dma_log, NULL, 0, last_timestamp);
 }
 
 /** Main logger loop */
 static int logger_read(void)
 {
 	struct log_entry_header dma_log;
+	FILE *out_fd;
 	int ret = 0;
 	uint64_t last_timestamp = 0;
 
 	bool ldc_address_OK = false;
 	unsigned int skipped_dwords = 0;
 
-	if (!global_config->raw_output)
+	if (!global_config->raw_output && !global_config->json_output)
 		print_table_header();
 
 	if (global_config->serial_fd >= 0)
 		/* Wait for CTRL-C */
 		for (;;) {
 			ret = serial_read(&last_timestamp);
-			if (ret < 0)
+			if (ret < 0) {
+				log_batch_flush();
 				return ret;
+			}
 		}
 
 	/* One iteration per log statement */
@@ -871,7 +1514,7 @@ static int logger_read(void)
 			}
 			/* for trace mode, try to reopen */
 			if (global_config->trace) {
-				fprintf(global_config->out_fd,
+				fprintf(log_notice_fd(),
 					"\n       ---- %s; %s -----\n\n",
 					"Re-opening trace input file",
 					"device suspend?");
@@ -894,6 +1537,17 @@ static int logger_read(void)
 			}
 		}
 
+		/* per core compact block, see CONFIG_TRACE_BINARY_PERCORE */
+		if (dma_log.uid == TRACE_COMPACT_BLOCK_MAGIC) {
+			ret = read_compact_block((const struct log_compact_block_header *)&dma_log,
+						 &last_timestamp);
+			if (ret) {
+				log_err("read_compact_block() failed with: %d, aborting\n", ret);
+				break;
+			}
+			continue;
+		}
+
 		/* checking if received trace address is located in
 		 * entry section in elf file.
 		 */
@@ -907,7 +1561,7 @@ static int logger_read(void)
 			if (global_config->trace && ldc_address_OK) {
 				log_err("log_entry_address %#10x is not in dictionary range!\n",
 					dma_log.log_entry_address);
-				fprintf(global_config->out_fd,
+				fprintf(log_notice_fd(),
 					"warn: Seeking forward 4 bytes at a time until re-synchronize.\n");
 			}
 			ldc_address_OK = false;
@@ -931,7 +1585,7 @@ static int logger_read(void)
 			 * only when we just started to run.
 			 */
 			if (skipped_dwords != 0) {
-				fprintf(global_config->out_fd,
+				fprintf(log_notice_fd(),
 					"\nFound valid LDC address after skipping %zu bytes (one line uses %zu + 0 to 16 bytes)\n",
 				       sizeof(uint32_t) * skipped_dwords, sizeof(dma_log));
 			}
@@ -944,7 +1598,7 @@ static int logger_read(void)
 		 * arguments needed and finish the entire processing of
 		 * this log line.
 		 */
-		ret = fetch_entry(&dma_log, &last_timestamp);
+		ret = fetch_entry(&dma_log, NULL, 0, &last_timestamp);
 		if (ret) {
 			log_err("fetch_entry() failed with: %d, aborting\n", ret);
 			break;
@@ -952,17 +1606,17 @@ static int logger_read(void)
 	} /* next log entry */
 
 	/* End of (etrace) file */
-	fprintf(global_config->out_fd,
-		"Skipped %zu bytes after the last statement",
+	out_fd = log_notice_fd();
+	fprintf(out_fd, "Skipped %zu bytes after the last statement",
 		sizeof(uint32_t) * skipped_dwords);
 
 	if (!global_config->trace &&
 	    /* maximum 4 arguments supported */
 	    skipped_dwords < sizeof(dma_log) + 4 * sizeof(uint32_t))
-		fprintf(global_config->out_fd,
+		fprintf(out_fd,
 			". Potential mailbox wrap, check the start of the output for later logs");
 
-	fprintf(global_config->out_fd, ".\n");
+	fprintf(out_fd, ".\n");
 
 	return ret;
 }
@@ -1148,8 +1802,17 @@ int convert(void)
 		}
 	}
 
-	ret = logger_read();
+	ret = ldc_index_init();
+	if (ret)
+		goto out;
+
+	ret = log_batch_init();
+	if (!ret)
+		ret = logger_read();
+
+	log_batch_free();
 out:
+	ldc_index_free();
 	free(config->uids_dict);
 	return ret;
 }
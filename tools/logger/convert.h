@@ -42,6 +42,8 @@ struct convert_config {
 	int hide_location;
 	int relative_timestamps;
 	int time_precision;
+	int json_output;
+	int jobs;
 	struct snd_sof_uids_header *uids_dict;
 	struct snd_sof_logs_header *logs_header;
 };
@@ -30,6 +30,7 @@
 
 #include "convert.h"
 #include "misc.h"
+#include "timeline.h"
 
 #define APP_NAME "sof-logger"
 
@@ -86,6 +87,12 @@ static void usage(void)
 	fprintf(stdout, "%s:\t -F filter\t\tUpdate trace filter, format: "
 		"<level>=<comp1>[, <comp2>]\n",
 		APP_NAME);
+	fprintf(stdout, "%s:\t -T telemetry_file\tConvert telemetry tracepoints "
+		"to Chrome / Perfetto JSON\n", APP_NAME);
+	fprintf(stdout, "%s:\t -J\t\t\tJSON output, one object per log line\n",
+		APP_NAME);
+	fprintf(stdout, "%s:\t -j jobs\t\tFormat batches of log lines in jobs threads, "
+		"live logs are then written out per batch\n", APP_NAME);
 	exit(0);
 }
 
@@ -193,6 +200,40 @@ static int append_filter_config(struct convert_config *config, const char *input
 	return 0;
 }
 
+/* telemetry data dump to timeline, no dictionary needed */
+static int telemetry_timeline(struct convert_config *config, const char *file)
+{
+	FILE *in_fd, *out_fd = stdout;
+	int ret;
+
+	in_fd = fopen(file, "rb");
+	if (!in_fd) {
+		ret = -errno;
+		fprintf(stderr, "error: Unable to open telemetry file %s: %s\n",
+			file, strerror(errno));
+		return ret;
+	}
+
+	if (config->out_file) {
+		out_fd = fopen(config->out_file, "w");
+		if (!out_fd) {
+			ret = -errno;
+			fprintf(stderr, "error: Unable to open out file %s: %s\n",
+				config->out_file, strerror(errno));
+			fclose(in_fd);
+			return ret;
+		}
+	}
+
+	ret = timeline_convert(in_fd, out_fd, config->clock);
+
+	if (out_fd != stdout)
+		fclose(out_fd);
+	fclose(in_fd);
+
+	return ret;
+}
+
 #if !HAS_INOTIFY
 static void *wait_open(const char *watched_dir, const char *expected_file)
 {
@@ -297,10 +338,11 @@ struct convert_config * const global_config = &_global_config;
 
 int main(int argc, char *argv[])
 {
-	static const char optstring[] = "ho:i:l:ps:c:u:tv:rd:Le:f:gF:n";
+	static const char optstring[] = "ho:i:l:ps:c:u:tv:rd:Le:f:gF:nT:Jj:";
 	struct convert_config config;
 	unsigned int baud = 0;
 	const char *snapshot_file = 0;
+	const char *telemetry_file = NULL;
 	int opt, ret = 0;
 
 	config.trace = 0;
@@ -322,6 +364,8 @@ int main(int argc, char *argv[])
 	config.dump_ldc = 0;
 	config.hide_location = 0;
 	config.time_precision = 6;
+	config.json_output = 0;
+	config.jobs = 1;
 	config.relative_timestamps = INT_MAX; /* unspecified */
 	config.filter_config = NULL;
 
@@ -404,6 +448,20 @@ int main(int argc, char *argv[])
 			if (ret < 0)
 				return ret;
 			break;
+		case 'T':
+			telemetry_file = optarg;
+			break;
+		case 'J':
+			config.json_output = 1;
+			break;
+		case 'j':
+			config.jobs = atoi(optarg);
+			if (config.jobs < 1) {
+				usage();
+				ret = -EINVAL;
+				goto out;
+			}
+			break;
 		case 'h':
 		default: /* '?' */
 			usage();
@@ -420,6 +478,11 @@ int main(int argc, char *argv[])
 		goto out;
 	}
 
+	if (telemetry_file) {
+		ret = -telemetry_timeline(&config, telemetry_file);
+		goto out;
+	}
+
 	if (!config.ldc_file) {
 		fprintf(stderr, "error: Missing ldc file\n");
 		usage();
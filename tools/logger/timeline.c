@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ipc4/base_fw.h>
+#include <sof/debug/telemetry/telemetry.h>
+#include <sof/debug/telemetry/tracepoint.h>
+
+#include "timeline.h"
+
+/* telemetry_post() limits the payload to 0xffff bytes */
+#define TIMELINE_RECORD_MAX	(sizeof(struct telemetry_record) + 0x10000)
+
+/* highest core id accepted in the dump */
+#define TIMELINE_MAX_CORES	16
+
+static const char * const tracepoint_names[SOF_TRACEPOINT_COUNT] = {
+	[SOF_TRACEPOINT_PIPELINE_COPY]	= "pipeline_copy",
+	[SOF_TRACEPOINT_LL_TASK]	= "ll_task",
+	[SOF_TRACEPOINT_MODULE_COPY]	= "module_copy",
+	[SOF_TRACEPOINT_DP_TASK]	= "dp_task",
+	[SOF_TRACEPOINT_HOST_DMA]	= "host_dma",
+	[SOF_TRACEPOINT_DAI_COPY]	= "dai_copy",
+};
+
+static const char tracepoint_phases[] = {
+	[SOF_TRACEPOINT_BEGIN]		= 'B',
+	[SOF_TRACEPOINT_END]		= 'E',
+	[SOF_TRACEPOINT_INSTANT]	= 'i',
+};
+
+struct timeline_core {
+	uint64_t time;		/* 64 bit extension of the record timestamps */
+	uint32_t last;
+	int started;
+};
+
+/* record timestamps are the 32 LSBs of the platform timer, widen per core */
+static uint64_t timeline_time(struct timeline_core *core, uint32_t timestamp)
+{
+	if (!core->started) {
+		core->time = timestamp;
+		core->started = 1;
+	} else {
+		core->time += (uint32_t)(timestamp - core->last);
+	}
+	core->last = timestamp;
+
+	return core->time;
+}
+
+static void timeline_event(FILE *out_fd, int *events, uint32_t core_id,
+			   const struct telemetry_record *rec, double ts_us)
+{
+	struct telemetry_tracepoint tp;
+	const char *name;
+
+	if (rec->size < sizeof(tp))
+		return;
+	memcpy(&tp, rec->data, sizeof(tp));
+
+	if (tp.phase >= sizeof(tracepoint_phases))
+		return;
+	name = tp.id < SOF_TRACEPOINT_COUNT ? tracepoint_names[tp.id] : "unknown";
+
+	fprintf(out_fd, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,"
+		"\"pid\":%u,\"tid\":%u",
+		*events ? "," : "", name, tracepoint_phases[tp.phase], ts_us,
+		core_id, rec->resource_id);
+	if (tp.phase == SOF_TRACEPOINT_INSTANT)
+		fprintf(out_fd, ",\"s\":\"t\"");
+	if (tp.bytes)
+		fprintf(out_fd, ",\"args\":{\"bytes\":%u}", tp.bytes);
+	fprintf(out_fd, "}");
+
+	(*events)++;
+}
+
+int timeline_convert(FILE *in_fd, FILE *out_fd, double clock_mhz)
+{
+	struct timeline_core cores[TIMELINE_MAX_CORES] = { 0 };
+	struct ipc4_telemetry_data_chunk chunk;
+	struct telemetry_record *rec;
+	uint64_t overruns = 0;
+	uint32_t rec_size;
+	int events = 0;
+	int ret = 0;
+
+	if (clock_mhz <= 0) {
+		fprintf(stderr, "error: invalid clock %f MHz\n", clock_mhz);
+		return -EINVAL;
+	}
+
+	rec = malloc(TIMELINE_RECORD_MAX);
+	if (!rec)
+		return -ENOMEM;
+
+	fprintf(out_fd, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+	while (fread(&chunk, sizeof(chunk), 1, in_fd) == 1) {
+		if (chunk.core_id >= TIMELINE_MAX_CORES) {
+			fprintf(stderr, "error: invalid core %u in telemetry data\n",
+				chunk.core_id);
+			ret = -EINVAL;
+			break;
+		}
+		overruns += chunk.overruns;
+
+		while (chunk.size >= sizeof(*rec)) {
+			if (fread(rec, sizeof(*rec), 1, in_fd) != 1)
+				goto truncated;
+
+			/* payload is padded to 32 bit words */
+			rec_size = (rec->size + 3) & ~3u;
+			if (sizeof(*rec) + rec_size > chunk.size) {
+				fprintf(stderr, "error: record overflows core %u chunk\n",
+					chunk.core_id);
+				ret = -EINVAL;
+				goto out;
+			}
+			if (rec_size && fread(rec->data, rec_size, 1, in_fd) != 1)
+				goto truncated;
+			chunk.size -= sizeof(*rec) + rec_size;
+
+			if (rec->type != TELEMETRY_RECORD_TRACEPOINT)
+				continue;
+
+			timeline_event(out_fd, &events, chunk.core_id, rec,
+				       timeline_time(&cores[chunk.core_id], rec->timestamp) /
+				       clock_mhz);
+		}
+
+		if (chunk.size) {
+			fprintf(stderr, "error: %u trailing bytes in core %u chunk\n",
+				chunk.size, chunk.core_id);
+			ret = -EINVAL;
+			break;
+		}
+	}
+	goto out;
+
+truncated:
+	fprintf(stderr, "error: telemetry data truncated\n");
+	ret = -EINVAL;
+out:
+	fprintf(out_fd, "\n]}\n");
+	if (overruns)
+		fprintf(stderr, "warning: %" PRIu64 " telemetry records lost in overruns\n",
+			overruns);
+
+	free(rec);
+	return ret;
+}
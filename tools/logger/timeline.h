@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __LOGGER_TIMELINE_H__
+#define __LOGGER_TIMELINE_H__
+
+#include <stdio.h>
+
+/*
+ * Converts a dump of IPC4 TELEMETRY_DATA payloads to a Chrome / Perfetto
+ * JSON trace. Tracepoint records become events with the core as pid and
+ * the task or component as tid, other records are skipped.
+ */
+int timeline_convert(FILE *in_fd, FILE *out_fd, double clock_mhz);
+
+#endif /* __LOGGER_TIMELINE_H__ */
@@ -0,0 +1,503 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/*
+ * Worst case cost fuzzing of the processing modules. Every input creates
+ * one module with the configuration blob and stream format it carries,
+ * feeds it the audio of the input for a number of periods and measures
+ * the time of each copy(). The cost of the input is the time per frame of
+ * its slowest copy, the first copy is not counted to keep cold cache
+ * effects out.
+ *
+ * The fuzzer only keeps inputs with new coverage, so the cost is exposed
+ * as extra coverage counters, one per module and cost bucket. An input
+ * reaching a new cost bucket of a module is new coverage and is kept,
+ * which drives the search towards the most expensive configurations and
+ * inputs.
+ *
+ * Input layout:
+ *   byte 0	module, index of fuzz_modules[]
+ *   byte 1	channels - 1
+ *   byte 2	frame format, S16_LE, S24_4LE or S32_LE
+ *   byte 3	source rate, index of fuzz_rates[]
+ *   byte 4	sink rate of SRC and ASRC, index of fuzz_rates[]
+ *   byte 5-6	configuration blob size, little endian
+ *   ...	configuration blob, the IPC3 init data of the module
+ *   ...	audio, repeated to fill the periods
+ *
+ * Environment:
+ *   SOF_FUZZ_WORST_DIR	inputs with a new worst cost of their module are
+ *			written there, as regression cases
+ *   SOF_FUZZ_LIMIT_NS	abort on inputs slower than this many nanoseconds
+ *			per frame, to run the regression cases as a check
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/component_ext.h>
+#include <sof/audio/pipeline.h>
+#include <sof/ipc/driver.h>
+#include <sof/ipc/topology.h>
+#include <sof/lib/notifier.h>
+#include <sof/lib/uuid.h>
+#include <sof/math/numbers.h>
+#include <ipc/stream.h>
+#include <ipc/topology.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size);
+int LLVMFuzzerInitialize(int *argc, char ***argv);
+
+#define FUZZ_HDR_SIZE		7
+#define FUZZ_MAX_CHANNELS	8
+#define FUZZ_PERIODS		9
+#define FUZZ_BUFFER_PERIODS	4
+#define FUZZ_PERIOD_US		1000
+#define FUZZ_COST_BUCKETS	80
+
+#define FUZZ_PPL_ID		1
+#define FUZZ_SOURCE_BUF_ID	1
+#define FUZZ_COMP_ID		2
+#define FUZZ_SINK_BUF_ID	3
+
+/* struct sof_uuid in memory order */
+#define FUZZ_UUID(a, b, c, d0, d1, d2, d3, d4, d5, d6, d7)			\
+	{ (a) & 0xff, ((a) >> 8) & 0xff, ((a) >> 16) & 0xff, ((a) >> 24) & 0xff,	\
+	  (b) & 0xff, ((b) >> 8) & 0xff, (c) & 0xff, ((c) >> 8) & 0xff,		\
+	  d0, d1, d2, d3, d4, d5, d6, d7 }
+
+struct fuzz_module {
+	const char *name;
+	uint8_t uuid[UUID_SIZE];
+	uint32_t type;		/* enum sof_comp_type */
+	bool resampler;		/* SRC and ASRC, sof_ipc_comp_src layout */
+};
+
+static const struct fuzz_module fuzz_modules[] = {
+	{"eq-iir", FUZZ_UUID(0x5150c0e6, 0x27f9, 0x4ec8,
+			     0x83, 0x51, 0xc7, 0x05, 0xb6, 0x42, 0xd1, 0x2f), SOF_COMP_EQ_IIR},
+	{"eq-fir", FUZZ_UUID(0x43a90ce7, 0xf3a5, 0x41df,
+			     0xac, 0x06, 0xba, 0x98, 0x65, 0x1a, 0xe6, 0xa3), SOF_COMP_EQ_FIR},
+	{"drc", FUZZ_UUID(0xb36ee4da, 0x006f, 0x47f9,
+			  0xa0, 0x6d, 0xfe, 0xcb, 0xe2, 0xd8, 0xb6, 0xce), SOF_COMP_NONE},
+	{"tdfb", FUZZ_UUID(0xdd511749, 0xd9fa, 0x455c,
+			   0xb3, 0xa7, 0x13, 0x58, 0x56, 0x93, 0xf1, 0xaf), SOF_COMP_NONE},
+	{"mfcc", FUZZ_UUID(0xdb10a773, 0x1aa4, 0x4cea,
+			   0xa2, 0x1f, 0x2d, 0x57, 0xa5, 0xc9, 0x82, 0xeb), SOF_COMP_NONE},
+	{"src", FUZZ_UUID(0xc1c5326d, 0x8390, 0x46b4,
+			  0xaa, 0x47, 0x95, 0xc3, 0xbe, 0xca, 0x65, 0x50), SOF_COMP_SRC, true},
+	{"asrc", FUZZ_UUID(0xc8ec72f6, 0x8526, 0x4faf,
+			   0x9d, 0x39, 0xa2, 0x3d, 0x0b, 0x54, 0x1d, 0xe2), SOF_COMP_ASRC, true},
+};
+
+static const uint32_t fuzz_rates[] = {8000, 16000, 24000, 32000, 44100, 48000, 96000};
+
+static const uint32_t fuzz_formats[] = {
+	SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE,
+};
+
+/* the fuzzer treats every non-zero counter as a feature */
+__attribute__((used, section("__libfuzzer_extra_counters")))
+static uint8_t fuzz_cost_counters[ARRAY_SIZE(fuzz_modules)][FUZZ_COST_BUCKETS];
+
+static uint64_t fuzz_worst_ns[ARRAY_SIZE(fuzz_modules)];
+static const char *fuzz_worst_dir;
+static uint64_t fuzz_limit_ns;
+
+struct fuzz_case {
+	const struct fuzz_module *mod;
+	unsigned int mod_index;
+	uint32_t channels;
+	uint32_t frame_fmt;
+	uint32_t sample_bytes;
+	uint32_t source_rate;
+	uint32_t sink_rate;
+	const uint8_t *blob;
+	size_t blob_size;
+	const uint8_t *audio;
+	size_t audio_size;
+};
+
+static const uint8_t fuzz_silence[FUZZ_MAX_CHANNELS * sizeof(int32_t)];
+
+static uint64_t fuzz_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* four buckets per octave of the time per frame, in 1/16 ns */
+static unsigned int fuzz_cost_bucket(uint64_t ns_per_frame_q4)
+{
+	unsigned int msb;
+
+	if (ns_per_frame_q4 < 4)
+		return ns_per_frame_q4;
+
+	/* octave and the two bits below its leading one */
+	msb = 63 - __builtin_clzll(ns_per_frame_q4);
+	return MIN(4 * (msb - 1) + ((ns_per_frame_q4 >> (msb - 2)) & 3),
+		   FUZZ_COST_BUCKETS - 1);
+}
+
+static int fuzz_parse(const uint8_t *data, size_t size, struct fuzz_case *fc)
+{
+	if (size < FUZZ_HDR_SIZE)
+		return -EINVAL;
+
+	fc->mod_index = data[0] % ARRAY_SIZE(fuzz_modules);
+	fc->mod = &fuzz_modules[fc->mod_index];
+	fc->channels = data[1] % FUZZ_MAX_CHANNELS + 1;
+	fc->frame_fmt = fuzz_formats[data[2] % ARRAY_SIZE(fuzz_formats)];
+	fc->sample_bytes = fc->frame_fmt == SOF_IPC_FRAME_S16_LE ? 2 : 4;
+	fc->source_rate = fuzz_rates[data[3] % ARRAY_SIZE(fuzz_rates)];
+	fc->sink_rate = fc->mod->resampler ?
+		fuzz_rates[data[4] % ARRAY_SIZE(fuzz_rates)] : fc->source_rate;
+	fc->blob_size = MIN((size_t)(data[5] | data[6] << 8), size - FUZZ_HDR_SIZE);
+	fc->blob = data + FUZZ_HDR_SIZE;
+	fc->audio = fc->blob + fc->blob_size;
+	fc->audio_size = size - FUZZ_HDR_SIZE - fc->blob_size;
+
+	/* whole samples only */
+	fc->audio_size -= fc->audio_size % fc->sample_bytes;
+	if (!fc->audio_size) {
+		fc->audio = fuzz_silence;
+		fc->audio_size = sizeof(fuzz_silence);
+	}
+
+	return 0;
+}
+
+static int fuzz_new_module(struct ipc *ipc, const struct fuzz_case *fc)
+{
+	struct sof_ipc_comp_process *proc;
+	struct sof_ipc_comp_src *src;
+	struct sof_ipc_comp_asrc *asrc;
+	struct sof_ipc_comp *comp;
+	size_t comp_size;
+	size_t size;
+	int ret;
+
+	if (fc->mod->type == SOF_COMP_SRC)
+		comp_size = sizeof(*src);
+	else if (fc->mod->type == SOF_COMP_ASRC)
+		comp_size = sizeof(*asrc);
+	else
+		comp_size = sizeof(*proc);
+
+	/* the library keeps the init data after the UUID */
+	size = comp_size + UUID_SIZE + (fc->mod->resampler ? 0 : fc->blob_size);
+	comp = calloc(1, size);
+	if (!comp)
+		return -ENOMEM;
+
+	comp->hdr.cmd = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
+	comp->hdr.size = comp_size + UUID_SIZE;
+	comp->id = FUZZ_COMP_ID;
+	comp->type = fc->mod->type;
+	comp->pipeline_id = FUZZ_PPL_ID;
+	comp->ext_data_length = UUID_SIZE;
+	memcpy((uint8_t *)comp + comp_size, fc->mod->uuid, UUID_SIZE);
+
+	if (fc->mod->type == SOF_COMP_SRC) {
+		src = (struct sof_ipc_comp_src *)comp;
+		src->config.hdr.size = sizeof(src->config);
+		src->config.frame_fmt = fc->frame_fmt;
+		src->source_rate = fc->source_rate;
+		src->sink_rate = fc->sink_rate;
+		src->rate_mask = UINT32_MAX;
+	} else if (fc->mod->type == SOF_COMP_ASRC) {
+		asrc = (struct sof_ipc_comp_asrc *)comp;
+		asrc->config.hdr.size = sizeof(asrc->config);
+		asrc->config.frame_fmt = fc->frame_fmt;
+		asrc->source_rate = fc->source_rate;
+		asrc->sink_rate = fc->sink_rate;
+	} else {
+		proc = (struct sof_ipc_comp_process *)comp;
+		proc->config.hdr.size = sizeof(proc->config);
+		proc->config.frame_fmt = fc->frame_fmt;
+		proc->size = fc->blob_size;
+		memcpy(proc->data + UUID_SIZE, fc->blob, fc->blob_size);
+	}
+
+	ret = ipc_comp_new(ipc, ipc_to_comp_new(comp));
+	free(comp);
+
+	return ret;
+}
+
+static int fuzz_new_buffer(struct ipc *ipc, uint32_t id, uint32_t size)
+{
+	struct sof_ipc_buffer desc;
+
+	memset(&desc, 0, sizeof(desc));
+	desc.comp.hdr.size = sizeof(desc);
+	desc.comp.id = id;
+	desc.comp.type = SOF_COMP_BUFFER;
+	desc.comp.pipeline_id = FUZZ_PPL_ID;
+	desc.size = size;
+	desc.caps = SOF_MEM_CAPS_RAM;
+
+	return ipc_buffer_new(ipc, &desc);
+}
+
+static int fuzz_connect(struct ipc *ipc, uint32_t source_id, uint32_t sink_id)
+{
+	struct sof_ipc_pipe_comp_connect connect;
+
+	memset(&connect, 0, sizeof(connect));
+	connect.hdr.size = sizeof(connect);
+	connect.source_id = source_id;
+	connect.sink_id = sink_id;
+
+	return ipc_comp_connect(ipc, ipc_to_pipe_connect(&connect));
+}
+
+static int fuzz_set_params(struct comp_buffer *buf, const struct fuzz_case *fc,
+			   struct sof_ipc_stream_params *params, uint32_t rate)
+{
+	memset(params, 0, sizeof(*params));
+	params->direction = SOF_IPC_STREAM_PLAYBACK;
+	params->frame_fmt = fc->frame_fmt;
+	params->buffer_fmt = SOF_IPC_BUFFER_INTERLEAVED;
+	params->rate = rate;
+	params->channels = fc->channels;
+	params->sample_container_bytes = fc->sample_bytes;
+	params->sample_valid_bytes = fc->frame_fmt == SOF_IPC_FRAME_S24_4LE ? 3 :
+				     fc->sample_bytes;
+
+	return buffer_set_params(buf, params, BUFFER_UPDATE_FORCE);
+}
+
+/* fills the free space of the source with the audio of the input */
+static void fuzz_fill(struct comp_buffer *source, const struct fuzz_case *fc, size_t *audio_pos)
+{
+	struct audio_stream *stream = &source->stream;
+	uint32_t samples = audio_stream_get_free_samples(stream);
+	uint32_t audio_samples = fc->audio_size / fc->sample_bytes;
+	uint32_t offset = 0;
+	uint32_t n;
+
+	while (offset < samples) {
+		n = MIN(samples - offset, audio_samples - *audio_pos);
+		audio_stream_copy_from_linear(fc->audio, *audio_pos, stream, offset, n);
+		offset += n;
+		*audio_pos = (*audio_pos + n) % audio_samples;
+	}
+
+	comp_update_buffer_produce(source, samples * fc->sample_bytes);
+}
+
+/* runs the module of the input, returns the time per frame of its slowest copy */
+static int fuzz_run(const struct fuzz_case *fc, uint64_t *ns_per_frame_q4)
+{
+	struct ipc *ipc = sof_get()->ipc;
+	struct sof_ipc_stream_params params;
+	struct comp_buffer *source, *sink = NULL;
+	struct ipc_comp_dev *icd;
+	struct pipeline *p;
+	struct comp_dev *dev;
+	uint64_t worst = 0;
+	uint64_t t0, t1;
+	size_t audio_pos = 0;
+	uint32_t buffer_size;
+	int ret;
+	int i;
+
+	p = pipeline_new(FUZZ_PPL_ID, 0, FUZZ_COMP_ID);
+	if (!p)
+		return -ENOMEM;
+
+	p->period = FUZZ_PERIOD_US;
+
+	/* room for a few periods of the faster side, 44.1 kHz rounds up */
+	buffer_size = FUZZ_BUFFER_PERIODS * fc->channels * fc->sample_bytes *
+		      (MAX(fc->source_rate, fc->sink_rate) / 1000 + 1);
+
+	ret = fuzz_new_buffer(ipc, FUZZ_SOURCE_BUF_ID, buffer_size);
+	if (ret < 0)
+		goto out_pipeline;
+
+	ret = fuzz_new_buffer(ipc, FUZZ_SINK_BUF_ID, buffer_size);
+	if (ret < 0)
+		goto out_source;
+
+	ret = fuzz_new_module(ipc, fc);
+	if (ret < 0)
+		goto out_sink;
+
+	ret = fuzz_connect(ipc, FUZZ_SOURCE_BUF_ID, FUZZ_COMP_ID);
+	if (ret < 0)
+		goto out_comp;
+
+	ret = fuzz_connect(ipc, FUZZ_COMP_ID, FUZZ_SINK_BUF_ID);
+	if (ret < 0)
+		goto out_comp;
+
+	icd = ipc_get_comp_by_id(ipc, FUZZ_COMP_ID);
+	dev = icd->cd;
+	dev->pipeline = p;
+	dev->period = FUZZ_PERIOD_US;
+	p->sched_comp = dev;
+	source = ipc_get_buffer_by_id(ipc, FUZZ_SOURCE_BUF_ID)->cb;
+	sink = ipc_get_buffer_by_id(ipc, FUZZ_SINK_BUF_ID)->cb;
+
+	/*
+	 * Nothing consumes the sink, the module adapter only copies while
+	 * the consumer has the state of the module, so it stands in for it.
+	 */
+	sink->sink = dev;
+
+	ret = fuzz_set_params(sink, fc, &params, fc->sink_rate);
+	if (ret < 0)
+		goto out_comp;
+
+	ret = fuzz_set_params(source, fc, &params, fc->source_rate);
+	if (ret < 0)
+		goto out_comp;
+
+	component_set_nearest_period_frames(dev, fc->sink_rate);
+
+	ret = comp_params(dev, &params);
+	if (ret < 0)
+		goto out_comp;
+
+	ret = comp_prepare(dev);
+	if (ret < 0)
+		goto out_reset;
+
+	ret = comp_trigger(dev, COMP_TRIGGER_PRE_START);
+	if (ret < 0)
+		goto out_reset;
+
+	ret = comp_trigger(dev, COMP_TRIGGER_START);
+	if (ret < 0)
+		goto out_reset;
+
+	for (i = 0; i < FUZZ_PERIODS; i++) {
+		fuzz_fill(source, fc, &audio_pos);
+
+		t0 = fuzz_ns();
+		ret = comp_copy(dev);
+		t1 = fuzz_ns();
+		if (ret < 0)
+			break;
+
+		if (i)
+			worst = MAX(worst, t1 - t0);
+
+		comp_update_buffer_consume(sink, audio_stream_get_avail_bytes(&sink->stream));
+	}
+
+	*ns_per_frame_q4 = (worst << 4) / MAX(dev->frames, 1);
+
+	comp_trigger(dev, COMP_TRIGGER_STOP);
+out_reset:
+	comp_reset(dev);
+out_comp:
+	if (sink)
+		sink->sink = NULL;
+	ipc_comp_free(ipc, FUZZ_COMP_ID);
+out_sink:
+	ipc_buffer_free(ipc, FUZZ_SINK_BUF_ID);
+out_source:
+	ipc_buffer_free(ipc, FUZZ_SOURCE_BUF_ID);
+out_pipeline:
+	pipeline_free(p);
+
+	return ret;
+}
+
+static void fuzz_save(const struct fuzz_case *fc, uint64_t ns_per_frame_q4,
+		      const uint8_t *data, size_t size)
+{
+	char name[256];
+	FILE *f;
+
+	snprintf(name, sizeof(name), "%s/%s-%uch-%u-%u-%" PRIu64 "ns.bin", fuzz_worst_dir,
+		 fc->mod->name, fc->channels, fc->source_rate, fc->sink_rate,
+		 ns_per_frame_q4 >> 4);
+
+	f = fopen(name, "wb");
+	if (!f)
+		return;
+
+	fwrite(data, 1, size, f);
+	fclose(f);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size)
+{
+	struct fuzz_case fc;
+	uint64_t cost, again;
+
+	if (fuzz_parse(Data, Size, &fc) < 0)
+		return 0;
+
+	if (fuzz_run(&fc, &cost) < 0)
+		return 0;
+
+	/* a new worst case must repeat to count, timer noise does not */
+	if (cost > fuzz_worst_ns[fc.mod_index]) {
+		if (fuzz_run(&fc, &again) < 0)
+			return 0;
+
+		cost = MIN(cost, again);
+		if (cost > fuzz_worst_ns[fc.mod_index]) {
+			fuzz_worst_ns[fc.mod_index] = cost;
+			printf("worst: %s %u ch %u -> %u Hz %" PRIu64 ".%02" PRIu64 " ns/frame\n",
+			       fc.mod->name, fc.channels, fc.source_rate, fc.sink_rate,
+			       cost >> 4, ((cost & 15) * 100) >> 4);
+			if (fuzz_worst_dir)
+				fuzz_save(&fc, cost, Data, Size);
+		}
+	}
+
+	fuzz_cost_counters[fc.mod_index][fuzz_cost_bucket(cost)] = 1;
+
+	if (fuzz_limit_ns && cost > fuzz_limit_ns << 4) {
+		fprintf(stderr, "%s: %" PRIu64 " ns/frame over the limit of %" PRIu64 "\n",
+			fc.mod->name, cost >> 4, fuzz_limit_ns);
+		abort();
+	}
+
+	return 0;
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+	const char *limit;
+
+	fuzz_worst_dir = getenv("SOF_FUZZ_WORST_DIR");
+	limit = getenv("SOF_FUZZ_LIMIT_NS");
+	if (limit)
+		fuzz_limit_ns = strtoull(limit, NULL, 0);
+
+	init_system_notify(sof_get());
+
+	trace_init(sof_get());
+
+	platform_init(sof_get());
+
+	/* init components */
+	sys_comp_init(sof_get());
+	sys_comp_module_eq_iir_interface_init();
+	sys_comp_module_eq_fir_interface_init();
+	sys_comp_module_drc_interface_init();
+	sys_comp_module_tdfb_interface_init();
+	sys_comp_module_mfcc_interface_init();
+	sys_comp_module_src_interface_init();
+	sys_comp_module_asrc_interface_init();
+
+	pipeline_posn_init(sof_get());
+
+	return 0;
+}
@@ -120,6 +120,71 @@ static int plug_pipelines_set_state(snd_sof_plug_t *plug, int state)
 	return 0;
 }
 
+/* wait for a pipeline to process the period or timeout */
+static int plug_pipeline_wait(snd_sof_pcm_t *pcm, int i, snd_pcm_uframes_t frames)
+{
+	int err, delay;
+
+	err = clock_gettime(CLOCK_REALTIME, &pcm->wait_timeout);
+	if (err == -1) {
+		SNDERR("pipeline %d: cant get time: %s", i, strerror(errno));
+		return -EPIPE;
+	}
+
+	/* work out delay TODO: fix ALSA reader */
+	delay = pcm->frame_us * frames / 500;
+	plug_timespec_add_ms(&pcm->wait_timeout, delay);
+
+	/* now block caller on pipeline IO to PCM device */
+	err = sem_timedwait(pcm->done[i].sem, &pcm->wait_timeout);
+	if (err == -1) {
+		SNDERR("pipeline %d: waited %d ms for %ld frames, fatal timeout: %s",
+		       i, delay, frames, strerror(errno));
+		return -errno;
+	}
+
+	return 0;
+}
+
+/*
+ * Tell the pipelines a period is ready, starting at the source pipeline, and
+ * wait for them to process it. The pipeline list is populated from the host
+ * to the DAI, so the source pipeline is the last one for capture. When
+ * sof-pipe orders the pipelines by their connections, they are all woken at
+ * once so that independent ones run in parallel.
+ */
+static int plug_pipelines_copy(snd_sof_plug_t *plug, struct tplg_pipeline_list *pipeline_list,
+			       snd_pcm_uframes_t frames)
+{
+	snd_sof_pcm_t *pcm = plug->module_prv;
+	struct plug_shm_glb_state *glb = pcm->glb_ctx.addr;
+	int count = pipeline_list->count;
+	int i, j, err;
+
+	for (i = 0; i < count; i++) {
+		j = pcm->capture ? count - 1 - i : i;
+
+		sem_post(pcm->ready[j].sem);
+
+		if (!glb->graph) {
+			err = plug_pipeline_wait(pcm, j, frames);
+			if (err < 0)
+				return err;
+		}
+	}
+
+	if (!glb->graph)
+		return 0;
+
+	for (i = 0; i < count; i++) {
+		err = plug_pipeline_wait(pcm, i, frames);
+		if (err < 0)
+			return err;
+	}
+
+	return 0;
+}
+
 static int plug_pcm_start(snd_pcm_ioplug_t *io)
 {
 	snd_sof_plug_t *plug = io->private_data;
@@ -134,39 +199,14 @@ static int plug_pcm_start(snd_pcm_ioplug_t *io)
 			return err;
 		break;
 	case SOF_PLUGIN_STATE_STREAM_RUNNING:
-	{
-		struct tplg_pipeline_list *pipeline_list;
-		int i, delay;
-
 		if (!pcm->capture)
 			break;
 
-		pipeline_list = &plug->pcm_info->capture_pipeline_list;
-
 		/* start the first period copy for capture */
-		for (i = pipeline_list->count - 1; i >= 0; i--) {
-			sem_post(pcm->ready[i].sem);
-
-			/* wait for sof-pipe reader to consume data or timeout */
-			err = clock_gettime(CLOCK_REALTIME, &pcm->wait_timeout);
-			if (err == -1) {
-				SNDERR("write: cant get time: %s", strerror(errno));
-				return -EPIPE;
-			}
-
-			/* work out delay TODO: fix ALSA reader */
-			delay = pcm->frame_us * io->period_size / 500;
-			plug_timespec_add_ms(&pcm->wait_timeout, delay);
-
-			/* wait for sof-pipe writer to produce data or timeout */
-			err = sem_timedwait(pcm->done[i].sem, &pcm->wait_timeout);
-			if (err == -1) {
-				SNDERR("read: waited %d ms for %ld frames fatal timeout: %s",
-				       delay, io->period_size, strerror(errno));
-				return -errno;
-			}
-		}
-	}
+		err = plug_pipelines_copy(plug, &plug->pcm_info->capture_pipeline_list,
+					  io->period_size);
+		if (err < 0)
+			return err;
 		break;
 	case SOF_PLUGIN_STATE_INIT:
 	case SOF_PLUGIN_STATE_STREAM_ERROR:
@@ -230,9 +270,9 @@ static snd_pcm_sframes_t plug_pcm_pointer(snd_pcm_ioplug_t *io)
 	case SOF_PLUGIN_STATE_STREAM_RUNNING:
 	case SOF_PLUGIN_STATE_STREAM_ERROR:
 		if (pcm->capture)
-			ptr =  ctx->wtotal / pcm->frame_size;
+			ptr = plug_ep_load(&ctx->wtotal) / pcm->frame_size;
 		else
-			ptr =  ctx->rtotal / pcm->frame_size;
+			ptr = plug_ep_load(&ctx->rtotal) / pcm->frame_size;
 		break;
 	case SOF_PLUGIN_STATE_READY:
 		/* not running */
@@ -287,14 +327,10 @@ static snd_pcm_sframes_t plug_pcm_write(snd_pcm_ioplug_t *io, const snd_pcm_chan
 	snd_sof_plug_t *plug = io->private_data;
 	snd_sof_pcm_t *pcm = plug->module_prv;
 	struct plug_shm_endpoint *ctx = pcm->shm_pcm.addr;
-	struct tplg_pipeline_list *pipeline_list;
 	snd_pcm_sframes_t frames = 0;
-	int i;
 	ssize_t bytes;
 	const char *buf;
-	int err, delay;
-
-	pipeline_list = &plug->pcm_info->playback_pipeline_list;
+	int err;
 
 	/* calculate the buffer position and size from application */
 	buf = (char *)areas->addr + (areas->first + areas->step * offset) / 8;
@@ -309,35 +345,12 @@ static snd_pcm_sframes_t plug_pcm_write(snd_pcm_ioplug_t *io, const snd_pcm_chan
 		return frames;
 
 	/* write audio data to the pipe */
-	memcpy(plug_ep_wptr(ctx), buf, bytes);
-
-	plug_ep_produce(ctx, bytes);
-
-	/* tell the pipelines data is ready starting at the source pipeline */
-	for (i = 0; i < pipeline_list->count; i++) {
-		struct tplg_pipeline_info *pipe_info = pipeline_list->pipelines[i];
-
-		sem_post(pcm->ready[i].sem);
+	plug_ep_write(ctx, buf, bytes);
 
-		/* wait for sof-pipe reader to consume data or timeout */
-		err = clock_gettime(CLOCK_REALTIME, &pcm->wait_timeout);
-		if (err == -1) {
-			SNDERR("write: cant get time: %s", strerror(errno));
-			return -EPIPE;
-		}
-
-		/* work out delay */
-		delay = pcm->frame_us * frames / 500;
-		plug_timespec_add_ms(&pcm->wait_timeout, delay);
-
-		/* now block caller on pipeline IO to PCM device */
-		err = sem_timedwait(pcm->done[i].sem, &pcm->wait_timeout);
-		if (err == -1) {
-			SNDERR("write: waited %d ms for %ld frames, fatal timeout: %s",
-			       delay, frames, strerror(errno));
-			return -errno;
-		}
-	}
+	/* tell the pipelines data is ready */
+	err = plug_pipelines_copy(plug, &plug->pcm_info->playback_pipeline_list, frames);
+	if (err < 0)
+		return err;
 
 	return frames;
 }
@@ -350,12 +363,9 @@ static snd_pcm_sframes_t plug_pcm_read(snd_pcm_ioplug_t *io, const snd_pcm_chann
 	snd_sof_pcm_t *pcm = plug->module_prv;
 	snd_pcm_sframes_t frames;
 	struct plug_shm_endpoint *ctx = pcm->shm_pcm.addr;
-	struct tplg_pipeline_list *pipeline_list;
 	ssize_t bytes;
 	char *buf;
-	int err, delay, i;
-
-	pipeline_list = &plug->pcm_info->capture_pipeline_list;
+	int err;
 
 	/* calculate the buffer position and size */
 	buf = (char *)areas->addr + (areas->first + areas->step * offset) / 8;
@@ -369,32 +379,12 @@ static snd_pcm_sframes_t plug_pcm_read(snd_pcm_ioplug_t *io, const snd_pcm_chann
 		return 0;
 
 	/* tell the pipe ready we are ready for next period */
-	for (i = pipeline_list->count - 1; i >= 0; i--) {
-		sem_post(pcm->ready[i].sem);
-
-		/* wait for sof-pipe reader to consume data or timeout */
-		err = clock_gettime(CLOCK_REALTIME, &pcm->wait_timeout);
-		if (err == -1) {
-			SNDERR("write: cant get time: %s", strerror(errno));
-			return -EPIPE;
-		}
-
-		/* work out delay TODO: fix ALSA reader */
-		delay = pcm->frame_us * frames / 500;
-		plug_timespec_add_ms(&pcm->wait_timeout, delay);
-
-		/* wait for sof-pipe writer to produce data or timeout */
-		err = sem_timedwait(pcm->done[i].sem, &pcm->wait_timeout);
-		if (err == -1) {
-			SNDERR("read: waited %d ms for %ld frames fatal timeout: %s",
-			       delay, frames, strerror(errno));
-			return -errno;
-		}
-	}
+	err = plug_pipelines_copy(plug, &plug->pcm_info->capture_pipeline_list, frames);
+	if (err < 0)
+		return err;
 
 	/* copy audio data from pipe */
-	memcpy(buf, plug_ep_rptr(ctx), bytes);
-	plug_ep_consume(ctx, bytes);
+	plug_ep_read(ctx, buf, bytes);
 
 	return frames;
 }
@@ -814,7 +804,7 @@ static int plug_hw_constraint(snd_sof_plug_t *plug)
 /*
  * Register the plugin with ALSA and make available for use.
  * TODO: setup all audio params
- * TODO: setup polling fd for RW or mmap IOs
+ * TODO: setup polling fd for RW IOs
  */
 static int plug_create(snd_sof_plug_t *plug, snd_pcm_t **pcmp, const char *name,
 		       snd_pcm_stream_t stream, int mode)
@@ -826,7 +816,8 @@ static int plug_create(snd_sof_plug_t *plug, snd_pcm_t **pcmp, const char *name,
 	pcm->io.name = "ALSA <-> SOF PCM I/O Plugin";
 	pcm->io.poll_fd = pcm->shm_pcm.fd;
 	pcm->io.poll_events = POLLIN;
-	pcm->io.mmap_rw = 0;
+	/* the ring is copied in transfer(), let ioplug emulate mmap access */
+	pcm->io.mmap_rw = 1;
 
 	if (stream == SND_PCM_STREAM_PLAYBACK)
 		pcm->io.callback = &sof_playback_callback;
@@ -63,4 +63,11 @@ int plug_set_up_pipelines(snd_sof_plug_t *plug, int dir);
 int plug_free_pipelines(snd_sof_plug_t *plug, struct tplg_pipeline_list *pipeline_list, int dir);
 void plug_free_topology(snd_sof_plug_t *plug);
 
+/*
+ * Compiled topology cache
+ */
+uint64_t plug_tplg_hash(const void *data, size_t size);
+int plug_tplg_cache_load(snd_sof_plug_t *plug, uint64_t hash);
+int plug_tplg_cache_store(snd_sof_plug_t *plug, uint64_t hash);
+
 #endif
@@ -754,6 +754,7 @@ int plug_parse_topology(snd_sof_plug_t *plug)
 	int ret = 0;
 	FILE *file;
 	size_t size;
+	uint64_t hash;
 
 	tplg_debug("parsing topology file %s\n", ctx->tplg_file);
 
@@ -803,6 +804,11 @@ int plug_parse_topology(snd_sof_plug_t *plug)
 	list_init(&plug->pcm_list);
 	list_init(&plug->pipeline_list);
 
+	/* use the lists stored by an earlier parse of the same topology */
+	hash = plug_tplg_hash(ctx->tplg_base, ctx->tplg_size);
+	if (!plug_tplg_cache_load(plug, hash))
+		return 0;
+
 	while (ctx->tplg_offset < ctx->tplg_size) {
 		/* read next topology header */
 		hdr = tplg_get_hdr(ctx);
@@ -870,6 +876,9 @@ int plug_parse_topology(snd_sof_plug_t *plug)
 			return -EINVAL;
 		}
 	}
+
+	/* the cache is only an optimization, failing to store it is not an error */
+	plug_tplg_cache_store(plug, hash);
 out:
 	return ret;
 }
@@ -1457,6 +1466,8 @@ void plug_free_topology(snd_sof_plug_t *plug)
 		free(comp_info->name);
 		free(comp_info->stream_name);
 		free(comp_info->ipc_payload);
+		free(comp_info->available_fmt.input_pin_fmts);
+		free(comp_info->available_fmt.output_pin_fmts);
 		free(comp_info);
 	}
 
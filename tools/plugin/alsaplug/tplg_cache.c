@@ -0,0 +1,631 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/*
+ * Compiled topology cache.
+ *
+ * The resolved pipelines, widgets with their IPC4 init payloads and audio
+ * formats, routes and PCMs of a parsed topology are stored in a flat file
+ * named after the hash of the topology file. The next plugin instance using
+ * the same topology maps the file and rebuilds the lists from it instead of
+ * parsing the topology again.
+ *
+ * The cache directory is $SOF_TPLG_CACHE_DIR, $XDG_CACHE_HOME/sof or
+ * $HOME/.cache/sof. Setting SOF_TPLG_CACHE_DIR to an empty string disables
+ * the cache.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <tplg_parser/topology.h>
+
+#include <alsa/asoundlib.h>
+
+#include "plugin.h"
+
+#define TPLG_CACHE_MAGIC	0x43475054	/* "TPGC" */
+#define TPLG_CACHE_VERSION	1
+#define TPLG_CACHE_NONE		UINT32_MAX	/* NULL string or missing list index */
+
+struct tplg_cache_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t layout;	/* size of the structures copied as they are */
+	uint32_t num_pipelines;
+	uint32_t num_widgets;
+	uint32_t num_routes;
+	uint32_t num_pcms;
+	uint32_t reserved;
+	uint64_t tplg_hash;
+	uint64_t tplg_size;
+	int32_t instance_ids[SND_SOC_TPLG_DAPM_LAST];
+};
+
+/* reads and writes latch the first error so that records are checked once */
+struct tplg_cache_reader {
+	const uint8_t *pos;
+	const uint8_t *end;
+	int err;
+};
+
+struct tplg_cache_writer {
+	FILE *file;
+	int err;
+};
+
+static uint32_t tplg_cache_layout(void)
+{
+	return sizeof(struct ipc4_module_init_instance) + sizeof(struct ipc4_base_module_cfg) +
+	       sizeof(struct sof_uuid) + sizeof(struct sof_ipc4_pin_format);
+}
+
+/* FNV-1a hash of the topology file */
+uint64_t plug_tplg_hash(const void *data, size_t size)
+{
+	const uint8_t *p = data;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		hash ^= p[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+static int tplg_cache_path(char *path, size_t size, uint64_t hash)
+{
+	const char *dir = getenv("SOF_TPLG_CACHE_DIR");
+	const char *base;
+	size_t len;
+	int ret;
+
+	if (dir) {
+		if (!*dir)
+			return -ENOENT;
+		ret = snprintf(path, size, "%s", dir);
+	} else if ((base = getenv("XDG_CACHE_HOME")) && *base) {
+		ret = snprintf(path, size, "%s/sof", base);
+	} else if ((base = getenv("HOME")) && *base) {
+		ret = snprintf(path, size, "%s/.cache/sof", base);
+	} else {
+		return -ENOENT;
+	}
+
+	if (ret < 0 || ret >= size)
+		return -ENAMETOOLONG;
+
+	len = ret;
+	ret = snprintf(path + len, size - len, "/tplg-%016llx.bin", (unsigned long long)hash);
+	if (ret < 0 || ret >= size - len)
+		return -ENAMETOOLONG;
+
+	return 0;
+}
+
+static const void *tplg_cache_get(struct tplg_cache_reader *r, size_t size)
+{
+	const void *data = r->pos;
+
+	if (r->err || r->end - r->pos < size) {
+		r->err = -EINVAL;
+		return NULL;
+	}
+
+	r->pos += size;
+	return data;
+}
+
+static void tplg_cache_get_data(struct tplg_cache_reader *r, void *dst, size_t size)
+{
+	const void *data = tplg_cache_get(r, size);
+
+	if (data)
+		memcpy(dst, data, size);
+	else
+		memset(dst, 0, size);
+}
+
+static uint32_t tplg_cache_get_u32(struct tplg_cache_reader *r)
+{
+	uint32_t val;
+
+	tplg_cache_get_data(r, &val, sizeof(val));
+	return val;
+}
+
+static char *tplg_cache_get_str(struct tplg_cache_reader *r)
+{
+	uint32_t len = tplg_cache_get_u32(r);
+	const char *data;
+	char *str;
+
+	if (r->err || len == TPLG_CACHE_NONE)
+		return NULL;
+
+	data = tplg_cache_get(r, len);
+	if (!data)
+		return NULL;
+
+	str = strndup(data, len);
+	if (!str)
+		r->err = -ENOMEM;
+
+	return str;
+}
+
+static struct sof_ipc4_pin_format *tplg_cache_get_fmts(struct tplg_cache_reader *r,
+						       uint32_t *num)
+{
+	struct sof_ipc4_pin_format *fmts;
+	const void *data;
+	size_t size;
+
+	*num = tplg_cache_get_u32(r);
+	if (r->err || !*num)
+		return NULL;
+
+	size = sizeof(*fmts) * *num;
+	data = tplg_cache_get(r, size);
+	if (!data)
+		return NULL;
+
+	fmts = calloc(size, 1);
+	if (!fmts) {
+		r->err = -ENOMEM;
+		return NULL;
+	}
+
+	memcpy(fmts, data, size);
+	return fmts;
+}
+
+static void tplg_cache_put(struct tplg_cache_writer *w, const void *data, size_t size)
+{
+	if (!w->err && size && fwrite(data, 1, size, w->file) != size)
+		w->err = -EIO;
+}
+
+static void tplg_cache_put_u32(struct tplg_cache_writer *w, uint32_t val)
+{
+	tplg_cache_put(w, &val, sizeof(val));
+}
+
+static void tplg_cache_put_str(struct tplg_cache_writer *w, const char *str)
+{
+	uint32_t len = str ? strlen(str) : TPLG_CACHE_NONE;
+
+	tplg_cache_put_u32(w, len);
+	if (str)
+		tplg_cache_put(w, str, len);
+}
+
+/* index of a list entry, the pointer of a list item is converted by the caller */
+static uint32_t tplg_cache_index(struct list_item *list, struct list_item *entry)
+{
+	struct list_item *item;
+	uint32_t i = 0;
+
+	if (!entry)
+		return TPLG_CACHE_NONE;
+
+	list_for_item(item, list) {
+		if (item == entry)
+			return i;
+		i++;
+	}
+
+	return TPLG_CACHE_NONE;
+}
+
+static struct list_item *tplg_cache_item(struct list_item **items, uint32_t num, uint32_t index)
+{
+	if (index == TPLG_CACHE_NONE || index >= num)
+		return NULL;
+
+	return items[index];
+}
+
+static void tplg_cache_write_pipelines(snd_sof_plug_t *plug, struct tplg_cache_writer *w)
+{
+	struct list_item *item;
+
+	list_for_item(item, &plug->pipeline_list) {
+		struct tplg_pipeline_info *pipe_info;
+
+		pipe_info = container_of(item, struct tplg_pipeline_info, item);
+		tplg_cache_put_u32(w, pipe_info->id);
+		tplg_cache_put_u32(w, pipe_info->mem_usage);
+		tplg_cache_put_str(w, pipe_info->name);
+	}
+}
+
+static void tplg_cache_write_widgets(snd_sof_plug_t *plug, struct tplg_cache_writer *w)
+{
+	struct list_item *item;
+
+	list_for_item(item, &plug->widget_list) {
+		struct tplg_comp_info *comp_info = container_of(item, struct tplg_comp_info, item);
+		struct sof_ipc4_available_audio_format *fmt = &comp_info->available_fmt;
+		uint32_t payload_size = comp_info->ipc_payload ? comp_info->ipc_size : TPLG_CACHE_NONE;
+
+		tplg_cache_put_u32(w, tplg_cache_index(&plug->pipeline_list,
+						       comp_info->pipe_info ?
+						       &comp_info->pipe_info->item : NULL));
+		tplg_cache_put(w, &comp_info->module_init, sizeof(comp_info->module_init));
+		tplg_cache_put(w, &comp_info->basecfg, sizeof(comp_info->basecfg));
+		tplg_cache_put(w, &comp_info->uuid, sizeof(comp_info->uuid));
+		tplg_cache_put_u32(w, comp_info->id);
+		tplg_cache_put_u32(w, comp_info->type);
+		tplg_cache_put_u32(w, comp_info->pipeline_id);
+		tplg_cache_put_u32(w, comp_info->instance_id);
+		tplg_cache_put_u32(w, comp_info->module_id);
+		tplg_cache_put_str(w, comp_info->name);
+		tplg_cache_put_str(w, comp_info->stream_name);
+		tplg_cache_put_u32(w, payload_size);
+		if (payload_size != TPLG_CACHE_NONE)
+			tplg_cache_put(w, comp_info->ipc_payload, payload_size);
+		tplg_cache_put_u32(w, fmt->num_input_formats);
+		tplg_cache_put(w, fmt->input_pin_fmts,
+			       sizeof(*fmt->input_pin_fmts) * fmt->num_input_formats);
+		tplg_cache_put_u32(w, fmt->num_output_formats);
+		tplg_cache_put(w, fmt->output_pin_fmts,
+			       sizeof(*fmt->output_pin_fmts) * fmt->num_output_formats);
+	}
+}
+
+static void tplg_cache_write_routes(snd_sof_plug_t *plug, struct tplg_cache_writer *w)
+{
+	struct list_item *item;
+
+	list_for_item(item, &plug->route_list) {
+		struct tplg_route_info *route_info = container_of(item, struct tplg_route_info,
+								  item);
+
+		tplg_cache_put_u32(w, tplg_cache_index(&plug->widget_list,
+						       &route_info->source->item));
+		tplg_cache_put_u32(w, tplg_cache_index(&plug->widget_list,
+						       &route_info->sink->item));
+	}
+}
+
+static void tplg_cache_write_pcms(snd_sof_plug_t *plug, struct tplg_cache_writer *w)
+{
+	struct list_item *item;
+
+	list_for_item(item, &plug->pcm_list) {
+		struct tplg_pcm_info *pcm_info = container_of(item, struct tplg_pcm_info, item);
+
+		tplg_cache_put_u32(w, pcm_info->id);
+		tplg_cache_put_str(w, pcm_info->name);
+		tplg_cache_put_u32(w, tplg_cache_index(&plug->widget_list,
+						       pcm_info->playback_host ?
+						       &pcm_info->playback_host->item : NULL));
+		tplg_cache_put_u32(w, tplg_cache_index(&plug->widget_list,
+						       pcm_info->capture_host ?
+						       &pcm_info->capture_host->item : NULL));
+	}
+}
+
+static uint32_t tplg_cache_count(struct list_item *list)
+{
+	struct list_item *item;
+	uint32_t count = 0;
+
+	list_for_item(item, list)
+		count++;
+
+	return count;
+}
+
+/* create the cache directory and its parent, they may exist already */
+static void tplg_cache_mkdir(char *path)
+{
+	char *sep = strrchr(path, '/');
+	char *parent;
+
+	if (!sep)
+		return;
+
+	*sep = '\0';
+	if (mkdir(path, 0755) < 0 && errno == ENOENT) {
+		parent = strrchr(path, '/');
+		if (parent && parent != path) {
+			*parent = '\0';
+			mkdir(path, 0755);
+			*parent = '/';
+		}
+		mkdir(path, 0755);
+	}
+	*sep = '/';
+}
+
+/* store the parsed topology, the file is renamed into place once complete */
+int plug_tplg_cache_store(snd_sof_plug_t *plug, uint64_t hash)
+{
+	struct tplg_context *ctx = &plug->tplg;
+	struct tplg_cache_writer w = { 0 };
+	struct tplg_cache_hdr hdr;
+	char path[PATH_MAX];
+	char tmp[PATH_MAX + 16];
+	int ret;
+	int i;
+
+	ret = tplg_cache_path(path, sizeof(path), hash);
+	if (ret < 0)
+		return ret;
+
+	tplg_cache_mkdir(path);
+
+	/* concurrent writers each use their own file */
+	snprintf(tmp, sizeof(tmp), "%s.%d", path, getpid());
+	w.file = fopen(tmp, "wb");
+	if (!w.file)
+		return -errno;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = TPLG_CACHE_MAGIC;
+	hdr.version = TPLG_CACHE_VERSION;
+	hdr.layout = tplg_cache_layout();
+	hdr.num_pipelines = tplg_cache_count(&plug->pipeline_list);
+	hdr.num_widgets = tplg_cache_count(&plug->widget_list);
+	hdr.num_routes = tplg_cache_count(&plug->route_list);
+	hdr.num_pcms = tplg_cache_count(&plug->pcm_list);
+	hdr.tplg_hash = hash;
+	hdr.tplg_size = ctx->tplg_size;
+	for (i = 0; i < SND_SOC_TPLG_DAPM_LAST; i++)
+		hdr.instance_ids[i] = plug->instance_ids[i];
+
+	tplg_cache_put(&w, &hdr, sizeof(hdr));
+	tplg_cache_write_pipelines(plug, &w);
+	tplg_cache_write_widgets(plug, &w);
+	tplg_cache_write_routes(plug, &w);
+	tplg_cache_write_pcms(plug, &w);
+
+	ret = w.err;
+	if (fclose(w.file) && !ret)
+		ret = -EIO;
+
+	if (!ret && rename(tmp, path) < 0)
+		ret = -errno;
+
+	if (ret < 0)
+		unlink(tmp);
+	else
+		tplg_debug("stored topology cache %s\n", path);
+
+	return ret;
+}
+
+static void tplg_cache_read_pipelines(snd_sof_plug_t *plug, struct tplg_cache_reader *r,
+				      struct list_item **items, uint32_t num)
+{
+	struct tplg_pipeline_info *pipe_info;
+	uint32_t i;
+
+	for (i = 0; i < num && !r->err; i++) {
+		pipe_info = calloc(sizeof(*pipe_info), 1);
+		if (!pipe_info) {
+			r->err = -ENOMEM;
+			return;
+		}
+
+		list_item_append(&pipe_info->item, &plug->pipeline_list);
+		items[i] = &pipe_info->item;
+
+		pipe_info->id = tplg_cache_get_u32(r);
+		pipe_info->mem_usage = tplg_cache_get_u32(r);
+		pipe_info->name = tplg_cache_get_str(r);
+	}
+}
+
+static void tplg_cache_read_widget(struct tplg_comp_info *comp_info, struct tplg_cache_reader *r)
+{
+	struct sof_ipc4_available_audio_format *fmt = &comp_info->available_fmt;
+	uint32_t size;
+
+	tplg_cache_get_data(r, &comp_info->module_init, sizeof(comp_info->module_init));
+	tplg_cache_get_data(r, &comp_info->basecfg, sizeof(comp_info->basecfg));
+	tplg_cache_get_data(r, &comp_info->uuid, sizeof(comp_info->uuid));
+	comp_info->id = tplg_cache_get_u32(r);
+	comp_info->type = tplg_cache_get_u32(r);
+	comp_info->pipeline_id = tplg_cache_get_u32(r);
+	comp_info->instance_id = tplg_cache_get_u32(r);
+	comp_info->module_id = tplg_cache_get_u32(r);
+	comp_info->name = tplg_cache_get_str(r);
+	comp_info->stream_name = tplg_cache_get_str(r);
+
+	size = tplg_cache_get_u32(r);
+	if (!r->err && size != TPLG_CACHE_NONE) {
+		if (r->end - r->pos < size) {
+			r->err = -EINVAL;
+			return;
+		}
+
+		/* the base config, or the copier config of buffers, is updated in place */
+		comp_info->ipc_size = size;
+		comp_info->ipc_payload = calloc(MAX(size, sizeof(struct ipc4_copier_module_cfg)), 1);
+		if (!comp_info->ipc_payload) {
+			r->err = -ENOMEM;
+			return;
+		}
+
+		tplg_cache_get_data(r, comp_info->ipc_payload, size);
+	}
+
+	fmt->input_pin_fmts = tplg_cache_get_fmts(r, &fmt->num_input_formats);
+	fmt->output_pin_fmts = tplg_cache_get_fmts(r, &fmt->num_output_formats);
+}
+
+static void tplg_cache_read_widgets(snd_sof_plug_t *plug, struct tplg_cache_reader *r,
+				    struct list_item **pipes, uint32_t num_pipes,
+				    struct list_item **items, uint32_t num)
+{
+	struct tplg_comp_info *comp_info;
+	struct list_item *pipe_item;
+	uint32_t i;
+
+	for (i = 0; i < num && !r->err; i++) {
+		comp_info = calloc(sizeof(*comp_info), 1);
+		if (!comp_info) {
+			r->err = -ENOMEM;
+			return;
+		}
+
+		list_item_append(&comp_info->item, &plug->widget_list);
+		items[i] = &comp_info->item;
+
+		pipe_item = tplg_cache_item(pipes, num_pipes, tplg_cache_get_u32(r));
+		if (pipe_item)
+			comp_info->pipe_info = container_of(pipe_item, struct tplg_pipeline_info,
+							    item);
+
+		tplg_cache_read_widget(comp_info, r);
+	}
+}
+
+static void tplg_cache_read_routes(snd_sof_plug_t *plug, struct tplg_cache_reader *r,
+				   struct list_item **widgets, uint32_t num_widgets, uint32_t num)
+{
+	struct tplg_route_info *route_info;
+	struct list_item *source, *sink;
+	uint32_t i;
+
+	for (i = 0; i < num && !r->err; i++) {
+		source = tplg_cache_item(widgets, num_widgets, tplg_cache_get_u32(r));
+		sink = tplg_cache_item(widgets, num_widgets, tplg_cache_get_u32(r));
+		if (!source || !sink) {
+			r->err = -EINVAL;
+			return;
+		}
+
+		route_info = calloc(sizeof(*route_info), 1);
+		if (!route_info) {
+			r->err = -ENOMEM;
+			return;
+		}
+
+		route_info->source = container_of(source, struct tplg_comp_info, item);
+		route_info->sink = container_of(sink, struct tplg_comp_info, item);
+		list_item_append(&route_info->item, &plug->route_list);
+	}
+}
+
+static void tplg_cache_read_pcms(snd_sof_plug_t *plug, struct tplg_cache_reader *r,
+				 struct list_item **widgets, uint32_t num_widgets, uint32_t num)
+{
+	struct tplg_pcm_info *pcm_info;
+	struct list_item *host;
+	uint32_t i;
+
+	for (i = 0; i < num && !r->err; i++) {
+		pcm_info = calloc(sizeof(*pcm_info), 1);
+		if (!pcm_info) {
+			r->err = -ENOMEM;
+			return;
+		}
+
+		list_item_append(&pcm_info->item, &plug->pcm_list);
+
+		pcm_info->id = tplg_cache_get_u32(r);
+		pcm_info->name = tplg_cache_get_str(r);
+
+		host = tplg_cache_item(widgets, num_widgets, tplg_cache_get_u32(r));
+		if (host)
+			pcm_info->playback_host = container_of(host, struct tplg_comp_info, item);
+
+		host = tplg_cache_item(widgets, num_widgets, tplg_cache_get_u32(r));
+		if (host)
+			pcm_info->capture_host = container_of(host, struct tplg_comp_info, item);
+	}
+}
+
+/*
+ * Load the lists of a topology from the cache. The lists must be empty, on
+ * failure they are freed again and the topology has to be parsed.
+ */
+int plug_tplg_cache_load(snd_sof_plug_t *plug, uint64_t hash)
+{
+	struct tplg_context *ctx = &plug->tplg;
+	struct tplg_cache_reader r = { 0 };
+	struct tplg_cache_hdr hdr;
+	struct list_item **pipes;
+	struct list_item **widgets;
+	char path[PATH_MAX];
+	struct stat st;
+	void *map;
+	int fd;
+	int ret;
+	int i;
+
+	ret = tplg_cache_path(path, sizeof(path), hash);
+	if (ret < 0)
+		return ret;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -errno;
+
+	if (fstat(fd, &st) < 0 || st.st_size < sizeof(hdr)) {
+		close(fd);
+		return -EINVAL;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return -errno;
+
+	r.pos = map;
+	r.end = r.pos + st.st_size;
+	tplg_cache_get_data(&r, &hdr, sizeof(hdr));
+
+	if (hdr.magic != TPLG_CACHE_MAGIC || hdr.version != TPLG_CACHE_VERSION ||
+	    hdr.layout != tplg_cache_layout() || hdr.tplg_hash != hash ||
+	    hdr.tplg_size != ctx->tplg_size) {
+		munmap(map, st.st_size);
+		return -EINVAL;
+	}
+
+	pipes = calloc(sizeof(*pipes), hdr.num_pipelines + 1);
+	widgets = calloc(sizeof(*widgets), hdr.num_widgets + 1);
+	if (!pipes || !widgets)
+		r.err = -ENOMEM;
+
+	tplg_cache_read_pipelines(plug, &r, pipes, hdr.num_pipelines);
+	tplg_cache_read_widgets(plug, &r, pipes, hdr.num_pipelines, widgets, hdr.num_widgets);
+	tplg_cache_read_routes(plug, &r, widgets, hdr.num_widgets, hdr.num_routes);
+	tplg_cache_read_pcms(plug, &r, widgets, hdr.num_widgets, hdr.num_pcms);
+
+	free(widgets);
+	free(pipes);
+	munmap(map, st.st_size);
+
+	if (r.err < 0) {
+		plug_free_topology(plug);
+		list_init(&plug->widget_list);
+		list_init(&plug->route_list);
+		list_init(&plug->pcm_list);
+		list_init(&plug->pipeline_list);
+		return r.err;
+	}
+
+	for (i = 0; i < SND_SOC_TPLG_DAPM_LAST; i++)
+		plug->instance_ids[i] = hdr.instance_ids[i];
+
+	tplg_debug("loaded topology cache %s\n", path);
+
+	return 0;
+}
@@ -9,6 +9,7 @@
 #define __SOF_PLUGIN_COMMON_H__
 
 #include <stdint.h>
+#include <string.h>
 #include <mqueue.h>
 #include <semaphore.h>
 #include <alsa/asoundlib.h>
@@ -139,6 +140,7 @@ struct plug_shm_glb_state {
 	char magic[8];			/* SOF_MAGIC */
 	uint64_t size;			/* size of this structure in bytes */
 	uint64_t state;			/* enum plugin_state */
+	uint64_t graph;			/* sof-pipe orders the pipelines of a PCM */
 	struct endpoint_hw_config ep_config[NUM_EP_CONFIGS];
 	int num_ep_configs;
 	uint64_t num_ctls;		/* number of ctls */
@@ -171,6 +173,22 @@ struct plug_ctl_container {
 	int count;
 };
 
+/*
+ * The endpoint ring has a single producer and a single consumer, possibly in
+ * different processes. Each side only moves its own position and publishes it
+ * with its total, the totals are free running so the fill level is their
+ * difference and no lock is needed.
+ */
+static inline unsigned long plug_ep_load(unsigned long *total)
+{
+	return __atomic_load_n(total, __ATOMIC_ACQUIRE);
+}
+
+static inline void plug_ep_store(unsigned long *total, unsigned long value)
+{
+	__atomic_store_n(total, value, __ATOMIC_RELEASE);
+}
+
 static inline void *plug_ep_rptr(struct plug_shm_endpoint *ep)
 {
 	return ep->data + ep->rpos;
@@ -191,35 +209,20 @@ static inline int plug_ep_wrap_wsize(struct plug_shm_endpoint *ep)
 	return ep->buffer_size - ep->wpos;
 }
 
+/* called by the producer */
 static inline int plug_ep_get_free(struct plug_shm_endpoint *ep)
 {
-	if (ep->rwrap == ep->wwrap) {
-		/* calculate available bytes */
-		if (ep->rpos < ep->wpos)
-			return ep->buffer_size - (ep->wpos - ep->rpos);
-		else
-			return ep->buffer_size;
-	} else {
-		return ep->rpos - ep->wpos;
-	}
+	return ep->buffer_size - (ep->wtotal - plug_ep_load(&ep->rtotal));
 }
 
+/* called by the consumer */
 static inline int plug_ep_get_avail(struct plug_shm_endpoint *ep)
 {
-	if (ep->rwrap == ep->wwrap) {
-		/* calculate available bytes */
-		if (ep->rpos < ep->wpos)
-			return ep->wpos - ep->rpos;
-		else
-			return 0;
-	} else {
-		return (ep->buffer_size - ep->rpos) + ep->wpos;
-	}
+	return plug_ep_load(&ep->wtotal) - ep->rtotal;
 }
 
 static inline void *plug_ep_consume(struct plug_shm_endpoint *ep, unsigned int bytes)
 {
-	ep->rtotal += bytes;
 	ep->rpos += bytes;
 
 	if (ep->rpos >= ep->buffer_size) {
@@ -227,12 +230,14 @@ static inline void *plug_ep_consume(struct plug_shm_endpoint *ep, unsigned int b
 		ep->rwrap++;
 	}
 
+	/* the data is read, let the producer overwrite it */
+	plug_ep_store(&ep->rtotal, ep->rtotal + bytes);
+
 	return ep->data + ep->rpos;
 }
 
 static inline void *plug_ep_produce(struct plug_shm_endpoint *ep, unsigned int bytes)
 {
-	ep->wtotal += bytes;
 	ep->wpos += bytes;
 
 	if (ep->wpos >= ep->buffer_size) {
@@ -240,9 +245,36 @@ static inline void *plug_ep_produce(struct plug_shm_endpoint *ep, unsigned int b
 		ep->wwrap++;
 	}
 
+	/* the data is written, let the consumer read it */
+	plug_ep_store(&ep->wtotal, ep->wtotal + bytes);
+
 	return ep->data + ep->wpos;
 }
 
+/* copy into the ring, the caller checks the free space */
+static inline void plug_ep_write(struct plug_shm_endpoint *ep, const void *src,
+				 unsigned int bytes)
+{
+	unsigned int wrap = plug_ep_wrap_wsize(ep);
+	unsigned int head = bytes < wrap ? bytes : wrap;
+
+	memcpy(plug_ep_wptr(ep), src, head);
+	memcpy(ep->data, (const char *)src + head, bytes - head);
+	plug_ep_produce(ep, bytes);
+}
+
+/* copy from the ring, the caller checks the available data */
+static inline void plug_ep_read(struct plug_shm_endpoint *ep, void *dest,
+				unsigned int bytes)
+{
+	unsigned int wrap = plug_ep_wrap_rsize(ep);
+	unsigned int head = bytes < wrap ? bytes : wrap;
+
+	memcpy(dest, plug_ep_rptr(ep), head);
+	memcpy((char *)dest + head, ep->data, bytes - head);
+	plug_ep_consume(ep, bytes);
+}
+
 /*
  * SHM
  */
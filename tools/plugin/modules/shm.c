@@ -77,8 +77,8 @@ static int shm_process_new(struct comp_dev *dev,
 
 	cd->ctx = cd->pcm.addr;
 	ctx = cd->ctx;
-	ctx->buffer_size = cd->pcm.size;
 	memset(ctx, 0, sizeof(*ctx));
+	ctx->buffer_size = cd->pcm.size - sizeof(*ctx);
 	ctx->comp_id = config->id;
 	ctx->pipeline_id = config->pipeline_id;
 	ctx->state = SOF_PLUGIN_STATE_INIT;
@@ -64,6 +64,8 @@ static void shutdown(struct sof_pipe *sp)
 	plug_mq_free(&sp->ipc_rx_mq);
 
 	pthread_mutex_destroy(&sp->ipc_lock);
+	pthread_cond_destroy(&sp->graph_cond);
+	pthread_mutex_destroy(&sp->graph_lock);
 
 	fflush(sp->log);
 	fflush(stdout);
@@ -250,6 +252,7 @@ void plug_mq_free(struct plug_mq_desc *ipc)
  * -p Force run on P core
  * -e Force run on E core
  * -t topology name.
+ * -G run connected pipelines of a PCM in parallel, ordered by their connections
  * -L log file (otherwise stdout)
  * -h help
  */
@@ -270,7 +273,7 @@ int main(int argc, char *argv[], char *env[])
 	_sp = &sp;
 
 	/* parse all args */
-	while ((option = getopt(argc, argv, "hD:RpeT:")) != -1) {
+	while ((option = getopt(argc, argv, "hD:RpeT:G")) != -1) {
 		switch (option) {
 		/* Alsa device  */
 		case 'D':
@@ -290,6 +293,9 @@ int main(int argc, char *argv[], char *env[])
 		case 'T':
 			snprintf(sp.topology_name, NAME_SIZE, "%s", optarg);
 			break;
+		case 'G':
+			sp.graph = 1;
+			break;
 
 		/* print usage */
 		default:
@@ -314,6 +320,15 @@ int main(int argc, char *argv[], char *env[])
 		exit(EXIT_FAILURE);
 	}
 
+	/* pipeline graph scheduling */
+	ret = pthread_mutex_init(&sp.graph_lock, NULL);
+	if (ret == 0)
+		ret = pthread_cond_init(&sp.graph_cond, NULL);
+	if (ret != 0) {
+		fprintf(sp.log, "error: cant create graph lock %s\n", strerror(ret));
+		exit(EXIT_FAILURE);
+	}
+
 	fprintf(sp.log, "sof-pipe-%s: using topology %s\n", VERSION, sp.topology_name);
 
 	/* set CPU affinity */
@@ -353,6 +368,7 @@ int main(int argc, char *argv[], char *env[])
 	sprintf(sp.glb->magic, "%s", SOF_MAGIC);
 	sp.glb->size = sizeof(*sp.glb);
 	sp.glb->state = SOF_PLUGIN_STATE_INIT;
+	sp.glb->graph = sp.graph;
 	sp.tplg.tplg_file = sp.topology_name;
 	sp.tplg.ipc_major = 4; //HACK hard code to v4
 
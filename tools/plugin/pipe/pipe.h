@@ -36,6 +36,12 @@ struct pipethread_data {
 	struct plug_sem_desc ready;
 	struct plug_sem_desc done;
 	atomic_int pipe_users;
+
+	/* graph scheduling, all under graph_lock */
+	struct pipethread_data *inputs[MAX_PIPELINES];	/* pipelines feeding this one */
+	unsigned long input_copies[MAX_PIPELINES];	/* input copies already waited for */
+	int num_inputs;
+	unsigned long copies;				/* completed copies */
 };
 
 struct sof_pipe_module {
@@ -53,6 +59,11 @@ struct sof_pipe {
 	int capture;
 	int file_mode;
 	int pipe_thread_count;
+	int graph;
+
+	/* graph scheduling of connected pipelines */
+	pthread_mutex_t graph_lock;
+	pthread_cond_t graph_cond;
 
 	struct sigaction action;
 
@@ -28,9 +28,12 @@
 #include <dlfcn.h>
 
 #include <rtos/sof.h>
+#include <sof/audio/buffer.h>
 #include <sof/audio/pipeline.h>
 #include <sof/audio/component.h>
 #include <sof/audio/component_ext.h>
+#include <sof/ipc/topology.h>
+#include <sof/math/numbers.h>
 #include <rtos/task.h>
 #include <sof/lib/notifier.h>
 #include <sof/schedule/edf_schedule.h>
@@ -113,6 +116,117 @@ static inline void pipe_copy_done(struct pipethread_data *pd)
 	sem_post(pd->done.sem);
 }
 
+/*
+ * Graph scheduling.
+ *
+ * The plugin wakes all the pipelines of a PCM at once and each pipeline
+ * thread waits until the pipelines feeding it, e.g. the inputs of a mixer,
+ * have copied a new period. Independent branches then run in parallel and
+ * a join point runs once all its inputs are ready, in the same period.
+ */
+static void pipe_graph_add_input(struct sof_pipe *sp, int pipeline_id, int input_id)
+{
+	struct pipethread_data *pd = &sp->pipeline_ctx[pipeline_id];
+	struct pipethread_data *in = &sp->pipeline_ctx[input_id];
+	int i;
+
+	if (!pd->sp || !in->sp)
+		return;
+
+	for (i = 0; i < pd->num_inputs; i++)
+		if (pd->inputs[i] == in)
+			return;
+
+	pd->inputs[pd->num_inputs] = in;
+	pd->input_copies[pd->num_inputs] = in->copies;
+	pd->num_inputs++;
+}
+
+/* rebuild the pipeline dependencies from the buffers crossing pipelines */
+static void pipe_graph_build(struct sof_pipe *sp)
+{
+	struct ipc *ipc = ipc_get();
+	struct list_item *clist, *blist;
+	struct ipc_comp_dev *icd;
+	struct comp_buffer *buffer;
+	struct comp_dev *src;
+	struct comp_dev *dev;
+	int i;
+
+	pthread_mutex_lock(&sp->graph_lock);
+
+	for (i = 0; i < MAX_PIPELINES; i++)
+		sp->pipeline_ctx[i].num_inputs = 0;
+
+	list_for_item(clist, &ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT)
+			continue;
+
+		dev = icd->cd;
+		if (!dev->pipeline || dev->pipeline->pipeline_id >= MAX_PIPELINES)
+			continue;
+
+		list_for_item(blist, &dev->bsource_list) {
+			buffer = container_of(blist, struct comp_buffer, sink_list);
+			src = buffer->source;
+			if (!src || !src->pipeline || src->pipeline == dev->pipeline ||
+			    src->pipeline->pipeline_id >= MAX_PIPELINES)
+				continue;
+
+			pipe_graph_add_input(sp, dev->pipeline->pipeline_id,
+					     src->pipeline->pipeline_id);
+		}
+	}
+
+	pthread_mutex_unlock(&sp->graph_lock);
+}
+
+/* wait for a new period from every running input pipeline */
+static void pipe_graph_wait(struct pipethread_data *pd)
+{
+	struct sof_pipe *sp = pd->sp;
+	struct pipethread_data *in;
+	struct timespec timeout;
+	int cancel_state;
+	int i;
+
+	/* the mutex must not be left locked by a cancelled thread */
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancel_state);
+
+	/* wait at most two periods, stalled inputs are skipped */
+	clock_gettime(CLOCK_REALTIME, &timeout);
+	plug_timespec_add_ms(&timeout, MAX(1, pd->pcm_pipeline->period / 500));
+
+	pthread_mutex_lock(&sp->graph_lock);
+
+	for (i = 0; i < pd->num_inputs; i++) {
+		in = pd->inputs[i];
+
+		while (in->copies == pd->input_copies[i] && in->pcm_pipeline &&
+		       in->pcm_pipeline->status == COMP_STATE_ACTIVE)
+			if (pthread_cond_timedwait(&sp->graph_cond, &sp->graph_lock,
+						   &timeout) == ETIMEDOUT)
+				break;
+
+		pd->input_copies[i] = in->copies;
+	}
+
+	pthread_mutex_unlock(&sp->graph_lock);
+
+	pthread_setcancelstate(cancel_state, NULL);
+}
+
+static void pipe_graph_done(struct pipethread_data *pd)
+{
+	struct sof_pipe *sp = pd->sp;
+
+	pthread_mutex_lock(&sp->graph_lock);
+	pd->copies++;
+	pthread_cond_broadcast(&sp->graph_cond);
+	pthread_mutex_unlock(&sp->graph_lock);
+}
+
 static void *pipe_process_thread(void *arg)
 {
 	struct pipethread_data *pd = arg;
@@ -142,9 +256,15 @@ static void *pipe_process_thread(void *arg)
 			break;
 		}
 
+		if (pd->sp->graph)
+			pipe_graph_wait(pd);
+
 		/* sink has read data so now generate more it */
 		err = pipeline_copy(pd->pcm_pipeline);
 
+		if (pd->sp->graph)
+			pipe_graph_done(pd);
+
 		pipe_copy_done(pd);
 
 		if (err < 0) {
@@ -210,6 +330,10 @@ int pipe_thread_start(struct sof_pipe *sp, struct pipeline *p)
 	}
 	pd = &pipeline_ctx[pipeline_id];
 
+	/* the pipeline connections are complete once it is started */
+	if (sp->graph)
+		pipe_graph_build(sp);
+
 	/* only create thread if not active */
 	pipe_users = atomic_fetch_add(&pd->pipe_users, 1);
 	if (pipe_users > 0) {
@@ -376,5 +500,10 @@ int pipe_thread_free(struct sof_pipe *sp, int pipeline_id)
 	plug_lock_free(&pd->done);
 
 	pd->sp = NULL;
+
+	/* drop the references to the freed pipeline */
+	if (sp->graph)
+		pipe_graph_build(sp);
+
 	return 0;
 }
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/stat.h>
 
 #include <ipc/probe_dma_frame.h>
 
@@ -23,12 +24,14 @@
 #define APP_NAME "sof-probes"
 
 #define PACKET_MAX_SIZE	4096	/**< Size limit for probe data packet */
-#define DATA_READ_LIMIT 4096	/**< Data limit for file read */
+#define DATA_READ_LIMIT 65536	/**< Data limit for file read */
 #define FILES_LIMIT	32	/**< Maximum num of probe output files */
-#define FILE_PATH_LIMIT 128	/**< Path limit for probe output files */
+#define FILE_PATH_LIMIT 256	/**< Path limit for probe output files */
+#define FILE_BUF_SIZE	262144	/**< stdio buffer of probe output files */
 
 struct wave_files {
 	FILE *fd;
+	bool stream;		/* pipe or stdout, written out after each read */
 	uint32_t buffer_id;
 	uint32_t fmt;
 	uint32_t size;
@@ -43,11 +46,17 @@ enum p_state {
 
 struct dma_frame_parser {
 	bool log_to_stdout;
+	bool audio_to_stdout;
+	uint32_t stdout_buffer_id;		/* Buffer of audio_to_stdout */
+	const char *out_dir;			/* Directory of output files */
+	FILE *timeline;				/* Packet timeline output */
 	enum p_state state;
 	struct probe_data_packet *packet;
 	size_t packet_size;
 	uint8_t *w_ptr;				/* Write pointer to copy data to */
 	uint32_t total_data_to_copy;		/* Total bytes left to copy */
+	uint8_t *decoded;			/* Decompressed packet data */
+	size_t decoded_size;
 	int start;				/* Start of unfilled data */
 	int len;				/* Data buffer fill level */
 	uint8_t data[DATA_READ_LIMIT];
@@ -98,19 +107,30 @@ int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 		exit(0);
 	}
 
-	sprintf(path, "buffer_%d.%s", buffer_id, audio ? "wav" : "bin");
-
-	fprintf(stderr, "%s:\t Creating file %s\n", APP_NAME, path);
+	if (snprintf(path, sizeof(path), "%s%sbuffer_%d.%s", p->out_dir ? p->out_dir : "",
+		     p->out_dir ? "/" : "", buffer_id, audio ? "wav" : "bin") >= sizeof(path)) {
+		fprintf(stderr, "error: too long path for buffer %u\n", buffer_id);
+		exit(0);
+	}
 
-	if (!audio && p->log_to_stdout) {
+	if ((!audio && p->log_to_stdout) ||
+	    (audio && p->audio_to_stdout && buffer_id == p->stdout_buffer_id)) {
+		fprintf(stderr, "%s:\t Writing buffer %u to stdout\n", APP_NAME, buffer_id);
 		p->files[i].fd = stdout;
+		p->files[i].stream = true;
 	} else {
+		struct stat st;
+
+		/* a named pipe created in advance is written as a stream */
+		fprintf(stderr, "%s:\t Creating file %s\n", APP_NAME, path);
 		p->files[i].fd = fopen(path, "wb");
 		if (!p->files[i].fd) {
 			fprintf(stderr, "error: unable to create file %s, error %d\n",
 				path, errno);
 			exit(0);
 		}
+		setvbuf(p->files[i].fd, NULL, _IOFBF, FILE_BUF_SIZE);
+		p->files[i].stream = !fstat(fileno(p->files[i].fd), &st) && !S_ISREG(st.st_mode);
 	}
 
 	p->files[i].buffer_id = buffer_id;
@@ -125,7 +145,8 @@ int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 	p->files[i].header.fmt.subchunk_size = 16;
 	p->files[i].header.fmt.audio_format = 1;
 	p->files[i].header.fmt.num_channels = ((format & PROBE_MASK_NB_CHANNELS) >> PROBE_SHIFT_NB_CHANNELS) + 1;
-	p->files[i].header.fmt.sample_rate = sample_rate[(format & PROBE_MASK_SAMPLE_RATE) >> PROBE_SHIFT_SAMPLE_RATE];
+	p->files[i].header.fmt.sample_rate = sample_rate[(format & PROBE_MASK_SAMPLE_RATE) >> PROBE_SHIFT_SAMPLE_RATE] /
+					(((format & PROBE_MASK_DECIMATION) >> PROBE_SHIFT_DECIMATION) + 1);
 	p->files[i].header.fmt.bits_per_sample = (((format & PROBE_MASK_CONTAINER_SIZE) >> PROBE_SHIFT_CONTAINER_SIZE) + 1) * 8;
 	p->files[i].header.fmt.byte_rate = p->files[i].header.fmt.sample_rate *
 					p->files[i].header.fmt.num_channels *
@@ -134,6 +155,12 @@ int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 					  p->files[i].header.fmt.bits_per_sample / 8;
 	p->files[i].header.data.subchunk_id = HEADER_DATA;
 
+	/* the size of a stream is not known, nor can it be written later */
+	if (p->files[i].stream) {
+		p->files[i].header.riff.chunk_size = UINT32_MAX;
+		p->files[i].header.data.subchunk_size = UINT32_MAX;
+	}
+
 	fwrite(&p->files[i].header, sizeof(struct wave), 1, p->files[i].fd);
 
 	return i;
@@ -148,10 +175,10 @@ void finalize_wave_files(struct dma_frame_parser *p)
 	/* and close all opened files */
 	/* check wave struct to understand the offsets */
 	for (i = 0; i < FILES_LIMIT; i++) {
-		if (!is_audio_format(files[i].fmt))
+		if (!files[i].fd)
 			continue;
 
-		if (files[i].fd) {
+		if (is_audio_format(files[i].fmt) && !files[i].stream) {
 			chunk_size = files[i].size + sizeof(struct wave) -
 				     offsetof(struct riff_chunk, format);
 
@@ -161,9 +188,13 @@ void finalize_wave_files(struct dma_frame_parser *p)
 			      offsetof(struct data_subchunk, subchunk_size),
 			      SEEK_SET);
 			fwrite(&files[i].size, sizeof(uint32_t), 1, files[i].fd);
+		}
 
+		if (files[i].fd == stdout)
+			fflush(stdout);
+		else
 			fclose(files[i].fd);
-		}
+		files[i].fd = NULL;
 	}
 }
 
@@ -190,6 +221,56 @@ int validate_data_packet(struct probe_data_packet *packet)
 	return 0;
 }
 
+/* undo per channel delta compression, see PROBE_MASK_COMPRESSED */
+int decode_delta_packet(struct dma_frame_parser *p, uint8_t **data, uint32_t *size)
+{
+	struct probe_data_packet *packet = p->packet;
+	uint32_t channels = ((packet->format & PROBE_MASK_NB_CHANNELS) >> PROBE_SHIFT_NB_CHANNELS) + 1;
+	uint32_t bytes = ((packet->format & PROBE_MASK_CONTAINER_SIZE) >> PROBE_SHIFT_CONTAINER_SIZE) + 1;
+	const uint8_t *in = packet->data;
+	const uint8_t *end = in + packet->data_size_bytes;
+	uint32_t prev[32] = { 0 };
+	uint32_t ch = 0;
+	uint32_t shift, zz, b;
+	uint8_t byte, *out, *temp;
+
+	/* each varint takes at least one byte */
+	if (p->decoded_size < packet->data_size_bytes * bytes) {
+		temp = realloc(p->decoded, packet->data_size_bytes * bytes);
+		if (!temp)
+			return -ENOMEM;
+
+		p->decoded = temp;
+		p->decoded_size = packet->data_size_bytes * bytes;
+	}
+
+	out = p->decoded;
+	while (in < end) {
+		zz = 0;
+		shift = 0;
+		do {
+			if (in == end || shift > 28) {
+				fprintf(stderr, "Invalid compressed data\n");
+				return -EINVAL;
+			}
+			byte = *in++;
+			zz |= (uint32_t)(byte & 0x7f) << shift;
+			shift += 7;
+		} while (byte & 0x80);
+
+		prev[ch] += (zz >> 1) ^ -(zz & 1);
+		for (b = 0; b < bytes; b++)
+			*out++ = prev[ch] >> (8 * b);
+
+		ch = (ch + 1) % channels;
+	}
+
+	*data = p->decoded;
+	*size = out - p->decoded;
+
+	return 0;
+}
+
 int process_sync(struct dma_frame_parser *p)
 {
 	struct probe_data_packet *temp_packet;
@@ -225,7 +306,7 @@ struct dma_frame_parser *parser_init(void)
 	}
 	memset(p, 0, sizeof(*p));
 	p->packet = malloc(PACKET_MAX_SIZE);
-	if (!p) {
+	if (!p->packet) {
 		fprintf(stderr, "error: allocation failed, err %d\n",
 			errno);
 		free(p);
@@ -238,6 +319,7 @@ struct dma_frame_parser *parser_init(void)
 
 void parser_free(struct dma_frame_parser *p)
 {
+	free(p->decoded);
 	free(p->packet);
 	free(p);
 }
@@ -247,6 +329,22 @@ void parser_log_to_stdout(struct dma_frame_parser *p)
 	p->log_to_stdout = true;
 }
 
+void parser_timeline_to_file(struct dma_frame_parser *p, FILE *fd)
+{
+	p->timeline = fd;
+}
+
+void parser_audio_to_stdout(struct dma_frame_parser *p, uint32_t buffer_id)
+{
+	p->audio_to_stdout = true;
+	p->stdout_buffer_id = buffer_id;
+}
+
+void parser_output_dir(struct dma_frame_parser *p, const char *dir)
+{
+	p->out_dir = dir;
+}
+
 void parser_fetch_free_buffer(struct dma_frame_parser *p, uint8_t **d, size_t *len)
 {
 	*d = &p->data[p->start];
@@ -255,6 +353,7 @@ void parser_fetch_free_buffer(struct dma_frame_parser *p, uint8_t **d, size_t *l
 
 int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 {
+	uint8_t *next;
 	uint i = 0;
 
 	p->len = p->start + d_len;
@@ -270,7 +369,7 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 					i += p->start;
 				} else if (*((uint32_t *)&p->data[i]) ==
 					   PROBE_EXTRACT_SYNC_WORD) {
-					memset(p->packet, 0, p->packet_size);
+					memset(p->packet, 0, sizeof(*p->packet));
 					/* request to copy full data packet */
 					p->total_data_to_copy =
 						sizeof(struct probe_data_packet);
@@ -278,7 +377,10 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 					p->state = SYNC;
 					p->start = 0;
 				} else {
-					i++;
+					/* skip to the next possible start of SYNC */
+					next = memchr(&p->data[i + 1], PROBE_EXTRACT_SYNC_WORD & 0xff,
+						      p->len - i - 1);
+					i = next ? next - p->data : p->len;
 				}
 				break;
 			case SYNC:
@@ -295,6 +397,15 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 				if (validate_data_packet(p->packet) == 0) {
 					int file = get_buffer_file(p->files,
 								   p->packet->buffer_id);
+					uint8_t *data = p->packet->data;
+					uint32_t size = p->packet->data_size_bytes;
+
+					if (is_audio_format(p->packet->format) &&
+					    (p->packet->format & PROBE_MASK_COMPRESSED) &&
+					    decode_delta_packet(p, &data, &size) < 0) {
+						p->state = READY;
+						break;
+					}
 
 					if (file < 0)
 						file = init_wave(p, p->packet->buffer_id,
@@ -307,10 +418,15 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 						return -EIO;
 					}
 
-					fwrite(p->packet->data, 1,
-					       p->packet->data_size_bytes,
-					       p->files[file].fd);
-					p->files[file].size += p->packet->data_size_bytes;
+					/* timestamp, buffer and file offset of the packet */
+					if (p->timeline)
+						fprintf(p->timeline, "%" PRIu64 " %#x %u %u\n",
+							((uint64_t)p->packet->timestamp_high << 32) |
+							p->packet->timestamp_low,
+							p->packet->buffer_id, p->files[file].size, size);
+
+					fwrite(data, 1, size, p->files[file].fd);
+					p->files[file].size += size;
 					}
 				p->state = READY;
 				break;
@@ -334,5 +450,11 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 			i += data_to_copy;
 		}
 	}
+
+	/* live analysis gets the data as soon as it is read */
+	for (i = 0; i < FILES_LIMIT; i++)
+		if (p->files[i].fd && p->files[i].stream)
+			fflush(p->files[i].fd);
+
 	return 0;
 }
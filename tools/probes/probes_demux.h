@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
 
 struct dma_frame_parser;
 
@@ -18,6 +19,12 @@ struct dma_frame_parser *parser_init(void);
 
 void parser_log_to_stdout(struct dma_frame_parser *p);
 
+void parser_timeline_to_file(struct dma_frame_parser *p, FILE *fd);
+
+void parser_audio_to_stdout(struct dma_frame_parser *p, uint32_t buffer_id);
+
+void parser_output_dir(struct dma_frame_parser *p, const char *dir);
+
 void parser_free(struct dma_frame_parser *p);
 
 void parser_fetch_free_buffer(struct dma_frame_parser *p, uint8_t **d, size_t *len);
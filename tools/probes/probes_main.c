@@ -11,6 +11,12 @@
  *
  * Usage to parse data and create wave files: ./sof-probes -p data.bin
  *
+ * For live analysis the data can be read from stdin, while wave files
+ * are written to named pipes created in the output directory in advance
+ * or the audio of one buffer is written to stdout:
+ * ./sof-probes -d fifos < /dev/...
+ * ./sof-probes -a 0x10 < /dev/... | aplay
+ *
  */
 
 #include <errno.h>
@@ -19,6 +25,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "probes_demux.h"
@@ -30,17 +37,25 @@ static void usage(void)
 	fprintf(stdout, "Usage %s <option(s)> <buffer_id/file>\n\n", APP_NAME);
 	fprintf(stdout, "%s:\t -p file\tParse extracted file\n\n", APP_NAME);
 	fprintf(stdout, "%s:\t -l \t\tLog to stdout\n\n", APP_NAME);
+	fprintf(stdout, "%s:\t -t file\tWrite timestamp, buffer id, offset and size of packets\n\n",
+		APP_NAME);
+	fprintf(stdout, "%s:\t -d dir\t\tCreate output files in dir, existing named pipes\n"
+		"\t\t\tare written to as data is read\n\n", APP_NAME);
+	fprintf(stdout, "%s:\t -a buffer_id\tWrite audio of buffer_id to stdout as data is read\n\n",
+		APP_NAME);
 	fprintf(stdout, "%s:\t -h \t\tHelp, usage info\n", APP_NAME);
 	exit(0);
 }
 
-void parse_data(const char *file_in, bool log_to_stdout)
+void parse_data(const char *file_in, const char *timeline, bool log_to_stdout,
+		const char *out_dir, const char *audio_buffer)
 {
 	struct dma_frame_parser *p = parser_init();
+	FILE *fd_timeline = NULL;
 	FILE *fd_in;
 	uint8_t *data;
 	size_t len;
-	int ret;
+	ssize_t count;
 
 	if (!p) {
 		fprintf(stderr, "parser_init() failed\n");
@@ -50,6 +65,22 @@ void parse_data(const char *file_in, bool log_to_stdout)
 	if (log_to_stdout)
 		parser_log_to_stdout(p);
 
+	if (audio_buffer)
+		parser_audio_to_stdout(p, strtoul(audio_buffer, NULL, 0));
+
+	if (out_dir)
+		parser_output_dir(p, out_dir);
+
+	if (timeline) {
+		fd_timeline = fopen(timeline, "w");
+		if (!fd_timeline) {
+			fprintf(stderr, "error: unable to open file %s, error %d\n",
+				timeline, errno);
+			exit(0);
+		}
+		parser_timeline_to_file(p, fd_timeline);
+	}
+
 	if (file_in) {
 		fd_in = fopen(file_in, "rb");
 		if (!fd_in) {
@@ -61,28 +92,48 @@ void parse_data(const char *file_in, bool log_to_stdout)
 		fd_in = stdin;
 	}
 
-	do {
+	/* read() returns what is available, a live stream is not waited for to fill the buffer */
+	for (;;) {
 		parser_fetch_free_buffer(p, &data, &len);
-		len = fread(data, 1, len, fd_in);
-		ret = parser_parse_data(p, len);
-	} while (!ret && !feof(fd_in));
+		count = read(fileno(fd_in), data, len);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count < 0)
+			fprintf(stderr, "error: unable to read input, error %d\n", errno);
+		if (count <= 0 || parser_parse_data(p, count))
+			break;
+	}
 
-	if (!log_to_stdout)
-		finalize_wave_files(p);
+	finalize_wave_files(p);
+
+	if (fd_timeline)
+		fclose(fd_timeline);
 
 }
 
 int main(int argc, char *argv[])
 {
 	const char *fname = NULL;
+	const char *timeline = NULL;
+	const char *out_dir = NULL;
+	const char *audio_buffer = NULL;
 	bool log_to_stdout = false;
 	int opt;
 
-	while ((opt = getopt(argc, argv, "lhp:")) != -1) {
+	while ((opt = getopt(argc, argv, "lhp:t:d:a:")) != -1) {
 		switch (opt) {
 		case 'p':
 			fname = optarg;
 			break;
+		case 't':
+			timeline = optarg;
+			break;
+		case 'd':
+			out_dir = optarg;
+			break;
+		case 'a':
+			audio_buffer = optarg;
+			break;
 		case 'l':
 			log_to_stdout = true;
 			break;
@@ -92,7 +143,12 @@ int main(int argc, char *argv[])
 			return 0;
 		}
 	}
-	parse_data(fname, log_to_stdout);
+	if (log_to_stdout && audio_buffer) {
+		fprintf(stderr, "error: -l and -a both write to stdout\n");
+		return 1;
+	}
+
+	parse_data(fname, timeline, log_to_stdout, out_dir, audio_buffer);
 
 	return 0;
 }
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+"""Profile guided placement of hot code into fast memory.
+
+Ranks the functions of a profile, the folded stacks written by
+sof-profile.py or by stackcollapse-perf.pl for the testbench, by their
+samples and selects the hottest ones that fit the byte budget. Function
+sizes and sources come from the ELF the profile was taken with.
+
+ld      input section descriptions of the selected functions, included in
+        the .iram.text output section of the XTOS linker scripts. The
+        firmware must be built with -ffunction-sections.
+zephyr  zephyr_code_relocate() calls moving the sources of the selected
+        functions to the given location, Zephyr relocates whole files.
+"""
+
+import argparse
+import collections
+import os
+import subprocess
+import sys
+
+def read_profile(files):
+    """Samples per leaf function of the folded stacks"""
+    counts = collections.Counter()
+    for name in files:
+        with open(name) as f:
+            for line in f:
+                stack, _, count = line.strip().rpartition(" ")
+                if not stack or not count.isdigit():
+                    continue
+                leaf = stack.rsplit(";", 1)[-1]
+                # unsymbolized samples
+                if leaf.startswith("0x"):
+                    continue
+                counts[leaf] += int(count)
+    return counts
+
+def read_functions(nm, elf):
+    """Address and size of the sized text symbols"""
+    out = subprocess.run([nm, "-S", "--defined-only", elf],
+                         check=True, capture_output=True, text=True).stdout
+    funcs = {}
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) != 4 or fields[2] not in "Tt":
+            continue
+        # static functions of the same name keep the first one
+        funcs.setdefault(fields[3], (int(fields[0], 16), int(fields[1], 16)))
+    return funcs
+
+def read_sources(addr2line, elf, addrs):
+    """Source file of each address"""
+    out = subprocess.run([addr2line, "-e", elf] + ["0x%x" % a for a in addrs],
+                         check=True, capture_output=True, text=True).stdout
+    return [line.rsplit(":", 1)[0] for line in out.splitlines()]
+
+def select(counts, funcs, budget):
+    """Hottest functions fitting the budget, in decreasing order of samples"""
+    total = sum(counts.values())
+    selected = []
+    used = 0
+    covered = 0
+    for name, count in counts.most_common():
+        if name not in funcs:
+            continue
+        size = funcs[name][1]
+        if used + size > budget:
+            continue
+        selected.append(name)
+        used += size
+        covered += count
+    print("%u functions, %u bytes, %.1f%% of %u samples" %
+          (len(selected), used, 100.0 * covered / max(total, 1), total), file=sys.stderr)
+    return selected
+
+def write_ld(out, selected):
+    out.write("/* generated by sof-hot-sections.py, hottest first */\n")
+    for name in selected:
+        out.write("    *(.literal.%s .text.%s)\n" % (name, name))
+
+def write_zephyr(out, args, counts, funcs):
+    # Zephyr relocates whole files, the budget applies to their text
+    names = sorted(funcs)
+    sources = read_sources(args.addr2line, args.elf, [funcs[n][0] for n in names])
+    file_size = collections.Counter()
+    file_count = collections.Counter()
+    for name, src in zip(names, sources):
+        file_size[src] += funcs[name][1]
+        file_count[src] += counts.get(name, 0)
+
+    root = os.path.realpath(args.src_root) if args.src_root else None
+    used = 0
+    out.write("# generated by sof-hot-sections.py, hottest first\n")
+    for src, count in file_count.most_common():
+        if not count or not os.path.isfile(src):
+            continue
+        if root and not os.path.realpath(src).startswith(root + os.sep):
+            continue
+        if used + file_size[src] > args.budget:
+            continue
+        used += file_size[src]
+        out.write("zephyr_code_relocate(FILES %s LOCATION %s)\n" % (src, args.location))
+    print("%u bytes of hot sources relocated" % used, file=sys.stderr)
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-e", "--elf", required=True, help="ELF the profile was taken with")
+    parser.add_argument("-f", "--format", choices=["ld", "zephyr"], default="ld")
+    parser.add_argument("-b", "--budget", type=int, default=16384,
+                        help="bytes of fast memory for hot code, default %(default)s")
+    parser.add_argument("-n", "--nm", default="nm",
+                        help="nm of the DSP toolchain, default %(default)s")
+    parser.add_argument("-a", "--addr2line", default="addr2line",
+                        help="addr2line of the DSP toolchain, default %(default)s")
+    parser.add_argument("-l", "--location", default="RAM_TEXT",
+                        help="zephyr_code_relocate() location, default %(default)s")
+    parser.add_argument("-s", "--src-root", help="relocate only sources under this directory")
+    parser.add_argument("-o", "--output", help="output file, default stdout")
+    parser.add_argument("profiles", nargs="+", help="folded stacks")
+    args = parser.parse_args()
+
+    counts = read_profile(args.profiles)
+    funcs = read_functions(args.nm, args.elf)
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    if args.format == "ld":
+        write_ld(out, select(counts, funcs, args.budget))
+    else:
+        write_zephyr(out, args, counts, funcs)
+    if out is not sys.stdout:
+        out.close()
+
+if __name__ == "__main__":
+    main()
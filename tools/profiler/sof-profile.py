@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+"""Folds PC samples of the SOF sampling profiler into flame graph stacks.
+
+Reads TELEMETRY_DATA dumps, the same files sof-logger -T converts, and
+symbolizes the TELEMETRY_RECORD_PC_SAMPLE records against the firmware ELF.
+Each output line is "core;thread;function count", the input of
+flamegraph.pl or speedscope.
+"""
+
+import argparse
+import bisect
+import collections
+import struct
+import subprocess
+import sys
+
+# struct ipc4_telemetry_data_chunk and struct telemetry_record
+CHUNK = struct.Struct("<III")
+RECORD = struct.Struct("<HHII")
+
+# enum telemetry_record_type
+TELEMETRY_RECORD_PC_SAMPLE = 7
+
+class Symbols:
+    """Address to symbol lookup from the nm output of the ELF"""
+
+    def __init__(self, nm, elf):
+        out = subprocess.run([nm, "-n", "-S", "--defined-only", elf],
+                             check=True, capture_output=True, text=True).stdout
+        self.addrs = []
+        self.syms = []
+        for line in out.splitlines():
+            fields = line.split()
+            if len(fields) == 4:
+                addr, size, _, name = fields
+            elif len(fields) == 3:
+                addr, _, name = fields
+                size = "0"
+            else:
+                continue
+            self.addrs.append(int(addr, 16))
+            self.syms.append((name, int(size, 16)))
+
+    def lookup(self, addr, sized=False):
+        """Symbol containing addr, symbols without size match up to the next
+        one unless sized is set"""
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        if i < 0:
+            return None
+        name, size = self.syms[i]
+        if (sized or size) and addr >= self.addrs[i] + size:
+            return None
+        return name
+
+def samples(files):
+    """Yields (core, thread, pc) of every PC sample in the dumps"""
+    overruns = 0
+    for name in files:
+        with open(name, "rb") as f:
+            data = f.read()
+        pos = 0
+        while pos + CHUNK.size <= len(data):
+            core, chunk_overruns, size = CHUNK.unpack_from(data, pos)
+            overruns += chunk_overruns
+            pos += CHUNK.size
+            end = pos + size
+            if end > len(data):
+                sys.exit("error: %s truncated" % name)
+            while pos + RECORD.size <= end:
+                rec_type, rec_size, resource_id, _ = RECORD.unpack_from(data, pos)
+                payload = pos + RECORD.size
+                pos = payload + ((rec_size + 3) & ~3)
+                if rec_type == TELEMETRY_RECORD_PC_SAMPLE and rec_size >= 4:
+                    pc, = struct.unpack_from("<I", data, payload)
+                    yield core, resource_id, pc
+            pos = end
+    if overruns:
+        print("warning: %u telemetry records lost in overruns" % overruns,
+              file=sys.stderr)
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-e", "--elf", required=True, help="firmware ELF, e.g. zephyr.elf")
+    parser.add_argument("-n", "--nm", default="nm",
+                        help="nm of the DSP toolchain, default %(default)s")
+    parser.add_argument("-o", "--output", help="folded stacks, default stdout")
+    parser.add_argument("--no-core", action="store_true",
+                        help="merge the samples of all cores")
+    parser.add_argument("--no-thread", action="store_true",
+                        help="merge the samples of all threads")
+    parser.add_argument("dumps", nargs="+", help="TELEMETRY_DATA dumps")
+    args = parser.parse_args()
+
+    symbols = Symbols(args.nm, args.elf)
+    stacks = collections.Counter()
+
+    for core, thread, pc in samples(args.dumps):
+        frames = []
+        if not args.no_core:
+            frames.append("core%u" % core)
+        if not args.no_thread:
+            # dynamically allocated threads, e.g. DP tasks, have no symbol
+            frames.append(symbols.lookup(thread, sized=True) or "thread-0x%08x" % thread)
+        frames.append(symbols.lookup(pc) or "0x%08x" % pc)
+        stacks[";".join(frames)] += 1
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    for stack, count in sorted(stacks.items()):
+        print("%s %u" % (stack, count), file=out)
+    if out is not sys.stdout:
+        out.close()
+
+    if not stacks:
+        print("warning: no PC samples in the telemetry data", file=sys.stderr)
+
+if __name__ == "__main__":
+    main()
@@ -8,15 +8,18 @@
  */
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #include <openssl/conf.h>
 #include <openssl/evp.h>
 #include <openssl/err.h>
+#include <openssl/sha.h>
 
 #include <rimage/rimage.h>
 #include <rimage/manifest.h>
@@ -194,3 +197,120 @@ int hash_sha384(const void *data, size_t size, void *output, size_t output_len)
 {
 	return hash_single(data, size, EVP_sha384(), output, output_len);
 }
+
+/* 64 bit key of the data, many times cheaper to compute than the digest */
+static uint64_t hash_cache_key(const uint8_t *data, size_t size)
+{
+	const uint64_t prime = 0x9e3779b97f4a7c15ULL;
+	uint64_t lane[4] = { 1, 2, 3, 4 };
+	uint64_t key = size;
+	uint64_t value;
+	size_t i, j;
+
+	for (i = 0; i + sizeof(lane) <= size; i += sizeof(lane)) {
+		for (j = 0; j < 4; j++) {
+			memcpy(&value, data + i + j * sizeof(value), sizeof(value));
+			lane[j] = (lane[j] ^ value) * prime;
+			lane[j] ^= lane[j] >> 29;
+		}
+	}
+
+	for (; i < size; i++) {
+		lane[0] = (lane[0] ^ data[i]) * prime;
+		lane[0] ^= lane[0] >> 29;
+	}
+
+	for (j = 0; j < 4; j++) {
+		key = (key ^ lane[j]) * prime;
+		key ^= key >> 32;
+	}
+
+	return key;
+}
+
+static void hash_cache_store(const char *path, const void *digest, size_t digest_len)
+{
+	char tmp_path[FILENAME_MAX];
+	FILE *fd;
+	int tmp;
+
+	/* write a file of its own and rename it, concurrent builds may share the cache */
+	snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", path);
+	tmp = mkstemp(tmp_path);
+	if (tmp < 0) {
+		fprintf(stderr, "hash: unable to store digest in cache: %s\n", strerror(errno));
+		return;
+	}
+
+	fd = fdopen(tmp, "wb");
+	if (!fd) {
+		close(tmp);
+		unlink(tmp_path);
+		return;
+	}
+
+	if (fwrite(digest, digest_len, 1, fd) != 1 || fclose(fd) || rename(tmp_path, path)) {
+		fprintf(stderr, "hash: unable to store digest in cache %s\n", path);
+		unlink(tmp_path);
+	}
+}
+
+int hash_sha256_cached(const char *cache_dir, const void *data, size_t size, void *output,
+		       size_t output_len)
+{
+	uint8_t digest[SHA256_DIGEST_LENGTH];
+	char path[FILENAME_MAX];
+	FILE *fd;
+	int ret;
+
+	if (!cache_dir)
+		return hash_sha256(data, size, output, output_len);
+
+	if (output_len > sizeof(digest))
+		return -ENOBUFS;
+
+	/* the file name is the key and the size of the data */
+	snprintf(path, sizeof(path), "%s/sha256-%016" PRIx64 "-%zx", cache_dir,
+		 hash_cache_key(data, size), size);
+
+	fd = fopen(path, "rb");
+	if (fd) {
+		ret = fread(digest, sizeof(digest), 1, fd) == 1 && fgetc(fd) == EOF;
+		fclose(fd);
+		if (ret) {
+			memcpy(output, digest, output_len);
+			return 0;
+		}
+	}
+
+	ret = hash_sha256(data, size, digest, sizeof(digest));
+	if (ret)
+		return ret;
+
+	hash_cache_store(path, digest, sizeof(digest));
+
+	memcpy(output, digest, output_len);
+	return 0;
+}
+
+int hash_cache_init(const char *cache_dir)
+{
+	struct stat st;
+	int ret;
+
+	if (!stat(cache_dir, &st)) {
+		if (S_ISDIR(st.st_mode))
+			return 0;
+		fprintf(stderr, "error: hash cache %s is not a directory\n", cache_dir);
+		return -ENOTDIR;
+	}
+
+	if (mkdir(cache_dir, 0755) && errno != EEXIST) {
+		ret = -errno;
+		fprintf(stderr, "error: unable to create hash cache %s: %s\n", cache_dir,
+			strerror(-ret));
+		return ret;
+	}
+
+	return 0;
+}
@@ -108,4 +108,24 @@ int hash_sha256(const void* data, size_t size, void *output, size_t output_len);
  */
 int hash_sha384(const void* data, size_t size, void *output, size_t output_len);
 
+/**
+ * Calculates sha256 hash of a memory buffer, the digest is reused when the
+ * cache already holds the digest of data with the same size and 64 bit key
+ * @param [in]cache_dir directory of the digest cache, no cache when NULL
+ * @param [in]data pointer to the data to be processed
+ * @param [in]size length of the data to be processed
+ * @param [out]output pointer to array where place hash value
+ * @param [in]output_len size of the output buffer
+ * @return error code, 0 when success
+ */
+int hash_sha256_cached(const char *cache_dir, const void *data, size_t size, void *output,
+		       size_t output_len);
+
+/**
+ * Creates the digest cache directory when it doesn't exist
+ * @param [in]cache_dir directory of the digest cache
+ * @return error code, 0 when success
+ */
+int hash_cache_init(const char *cache_dir);
+
 #endif /* __HASH_H__ */
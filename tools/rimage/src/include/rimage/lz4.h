@@ -0,0 +1,26 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __LZ4_H__
+#define __LZ4_H__
+
+#include <stddef.h>
+
+/**
+ * Worst case size of the LZ4 block of size bytes of input
+ * @param size of the input
+ */
+size_t lz4_compress_bound(size_t size);
+
+/**
+ * Compresses the input into a single LZ4 block, without frame header
+ * @param src input data
+ * @param size of the input
+ * @param dst output buffer of at least lz4_compress_bound(size) bytes
+ * @return size of the block
+ */
+size_t lz4_compress(const void *src, size_t size, void *dst);
+
+#endif /* __LZ4_H__ */
@@ -65,6 +65,12 @@ struct image {
 
 	/* Output image is a loadable module */
 	bool loadable_module;
+
+	/* Text and rodata of loadable modules are stored LZ4 compressed */
+	bool compress;
+
+	/* directory of the module digest cache, NULL when not used */
+	const char *hash_cache_dir;
 };
 
 struct memory_zone {
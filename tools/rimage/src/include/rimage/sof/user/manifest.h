@@ -59,7 +59,8 @@ union sof_man_segment_flags {
 		uint32_t readonly:1;
 		uint32_t code:1;
 		uint32_t data:1;
-		uint32_t _rsvd0:2;
+		uint32_t compressed:1;	/* stored as struct sof_man_segment_lz4 */
+		uint32_t _rsvd0:1;
 		uint32_t type:4;	/* MAN_SEGMENT_ */
 		uint32_t _rsvd1:4;
 		uint32_t length:16;	/* of segment in pages */
@@ -75,6 +76,16 @@ struct sof_man_segment_desc {
 	uint32_t file_offset;
 } __attribute__((packed));
 
+/*
+ * Stored data of a segment of a loadable module with flags.compressed set:
+ * this header followed by an LZ4 block which decodes to the length of the
+ * segment. The stored size is rounded up to whole pages.
+ */
+struct sof_man_segment_lz4 {
+	uint32_t size;		/* of the LZ4 block in bytes */
+	uint8_t block[];
+} __attribute__((packed));
+
 /*
  * The firmware binary can be split into several modules.
  */
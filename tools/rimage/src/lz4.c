@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/*
+ * Greedy LZ4 block compressor. Matches are found through a single entry hash
+ * table of the last position of each 4 byte sequence, the output follows the
+ * LZ4 block format so any LZ4 decoder can expand it.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <rimage/lz4.h>
+
+#define LZ4_MIN_MATCH		4
+#define LZ4_LAST_LITERALS	5	/* the block ends with literals */
+#define LZ4_MF_LIMIT		12	/* no match starts closer to the end */
+#define LZ4_MAX_OFFSET		65535
+#define LZ4_HASH_LOG		14
+#define LZ4_NO_POS		UINT32_MAX
+
+static uint32_t lz4_read32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static uint32_t lz4_hash(uint32_t v)
+{
+	return (v * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+static uint8_t *lz4_put_length(uint8_t *op, size_t len)
+{
+	while (len >= 255) {
+		*op++ = 255;
+		len -= 255;
+	}
+	*op++ = len;
+
+	return op;
+}
+
+/* match_len 0 writes the last literals only */
+static uint8_t *lz4_put_sequence(uint8_t *op, const uint8_t *lit, size_t lit_len,
+				 size_t offset, size_t match_len)
+{
+	size_t ml = match_len ? match_len - LZ4_MIN_MATCH : 0;
+	uint8_t *token = op++;
+
+	*token = (lit_len < 15 ? lit_len : 15) << 4;
+	if (lit_len >= 15)
+		op = lz4_put_length(op, lit_len - 15);
+
+	memcpy(op, lit, lit_len);
+	op += lit_len;
+
+	if (!match_len)
+		return op;
+
+	*token |= ml < 15 ? ml : 15;
+	*op++ = offset & 0xff;
+	*op++ = offset >> 8;
+	if (ml >= 15)
+		op = lz4_put_length(op, ml - 15);
+
+	return op;
+}
+
+size_t lz4_compress_bound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t lz4_compress(const void *src, size_t size, void *dst)
+{
+	static uint32_t table[1 << LZ4_HASH_LOG];
+	const uint8_t *in = src;
+	uint8_t *op = dst;
+	size_t anchor = 0;
+	size_t pos = 0;
+	size_t len;
+	uint32_t seq;
+	uint32_t ref;
+	uint32_t h;
+
+	memset(table, 0xff, sizeof(table));
+
+	while (pos + LZ4_MF_LIMIT < size) {
+		seq = lz4_read32(in + pos);
+		h = lz4_hash(seq);
+		ref = table[h];
+		table[h] = pos;
+
+		if (ref == LZ4_NO_POS || pos - ref > LZ4_MAX_OFFSET ||
+		    lz4_read32(in + ref) != seq) {
+			pos++;
+			continue;
+		}
+
+		len = LZ4_MIN_MATCH;
+		while (pos + len < size - LZ4_LAST_LITERALS && in[ref + len] == in[pos + len])
+			len++;
+
+		op = lz4_put_sequence(op, in + anchor, pos - anchor, pos - ref, len);
+		pos += len;
+		anchor = pos;
+	}
+
+	op = lz4_put_sequence(op, in + anchor, size - anchor, 0, 0);
+
+	return op - (uint8_t *)dst;
+}
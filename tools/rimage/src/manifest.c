@@ -13,6 +13,7 @@
 #include <errno.h>
 #include <string.h>
 #include <time.h>
+#include <pthread.h>
 #include <sys/time.h>
 
 #include <rimage/sof/user/manifest.h>
@@ -25,6 +26,7 @@
 #include <rimage/file_utils.h>
 #include <rimage/misc_utils.h>
 #include <rimage/hash.h>
+#include <rimage/lz4.h>
 
 static int man_open_rom_file(struct image *image)
 {
@@ -195,6 +197,54 @@ static int man_copy_elf_sections(struct image *image, struct manifest_module *mo
 	return 0;
 }
 
+/*
+ * Replaces the data of a segment by its LZ4 block, returns the stored size in
+ * bytes. A segment which would not get at least a page smaller is kept as is.
+ */
+static int man_compress_segment(struct image *image, struct sof_man_segment_desc *segment)
+{
+	size_t size = segment->flags.r.length * MAN_PAGE_SIZE;
+	uint8_t *data = (uint8_t *)image->fw_image + segment->file_offset;
+	struct sof_man_segment_lz4 *stored = (struct sof_man_segment_lz4 *)data;
+	size_t stored_size;
+	uint8_t *block;
+	size_t block_size;
+
+	if (!size)
+		return 0;
+
+	block = malloc(lz4_compress_bound(size));
+	if (!block)
+		return -ENOMEM;
+
+	block_size = lz4_compress(data, size, block);
+	stored_size = DIV_ROUND_UP(sizeof(*stored) + block_size, MAN_PAGE_SIZE) * MAN_PAGE_SIZE;
+	if (stored_size < size) {
+		memset(data, 0, size);
+		stored->size = block_size;
+		memcpy(stored->block, block, block_size);
+		segment->flags.r.compressed = 1;
+		fprintf(stdout, "\tcompressed 0x%zx to 0x%zx bytes\n", size, stored_size);
+	} else {
+		stored_size = size;
+	}
+
+	free(block);
+	return stored_size;
+}
+
+/* bytes of the segment in the image file */
+static size_t man_segment_file_size(struct image *image, const struct sof_man_segment_desc *segment)
+{
+	const struct sof_man_segment_lz4 *stored;
+
+	if (!segment->flags.r.compressed)
+		return segment->flags.r.length * MAN_PAGE_SIZE;
+
+	stored = (const void *)((uint8_t *)image->fw_image + segment->file_offset);
+	return DIV_ROUND_UP(sizeof(*stored) + stored->size, MAN_PAGE_SIZE) * MAN_PAGE_SIZE;
+}
+
 static int man_get_module_manifest(struct image *image, struct manifest_module *module,
 				   struct sof_man_module *man_module)
 {
@@ -366,6 +416,14 @@ static int man_module_create(struct image *image, struct manifest_module *module
 	if (err)
 		return err;
 
+	/* rodata follows the compressed text, uncompressed text keeps its fixup size */
+	if (image->compress) {
+		err = man_compress_segment(image, &man_module->segment[SOF_MAN_SEGMENT_TEXT]);
+		if (err < 0)
+			return err;
+		if (man_module->segment[SOF_MAN_SEGMENT_TEXT].flags.r.compressed)
+			module->text_fixup_size = err;
+	}
 
 	/* data section */
 	man_module->segment[SOF_MAN_SEGMENT_RODATA].v_base_addr = module->file.data.start;
@@ -383,6 +441,14 @@ static int man_module_create(struct image *image, struct manifest_module *module
 	if (err)
 		return err;
 
+	/* the uncompressed copies moved the end beyond the stored data */
+	if (image->compress) {
+		err = man_compress_segment(image, &man_module->segment[SOF_MAN_SEGMENT_RODATA]);
+		if (err < 0)
+			return err;
+		image->image_end = man_module->segment[SOF_MAN_SEGMENT_RODATA].file_offset + err;
+	}
+
 	/* bss is last */
 
 	/* I do not understand why only the section named .bss was taken into account. Other
@@ -638,12 +704,37 @@ static void man_create_modules_in_config(struct image *image, struct sof_man_fw_
 	desc->header.num_module_entries = modules->mod_man_count;
 }
 
+struct man_hash_job {
+	pthread_t thread;
+	bool started;
+	const char *cache_dir;
+	const void *data;
+	size_t size;
+	struct sof_man_module *man_module;
+	int ret;
+};
+
+static void *man_hash_module(void *arg)
+{
+	struct man_hash_job *job = arg;
+
+	job->ret = hash_sha256_cached(job->cache_dir, job->data, job->size,
+				      job->man_module->hash, sizeof(job->man_module->hash));
+
+	return NULL;
+}
+
+/* modules are hashed in parallel, one thread each */
 static int man_hash_modules(struct image *image, struct sof_man_fw_desc *desc)
 {
+	struct man_hash_job jobs[MAX_MODULES];
+	struct man_hash_job *job;
 	struct sof_man_module *man_module;
 	size_t mod_offset, mod_size;
 	int i, ret = 0;
 
+	memset(jobs, 0, sizeof(jobs));
+
 	for (i = 0; i < image->num_modules; i++) {
 		man_module = (void *)desc + SOF_MAN_MODULE_OFFSET(i);
 
@@ -653,16 +744,30 @@ static int man_hash_modules(struct image *image, struct sof_man_fw_desc *desc)
 			continue;
 		}
 
+		/* the stored data, which is compressed with -z */
 		mod_offset = man_module->segment[SOF_MAN_SEGMENT_TEXT].file_offset;
-		mod_size = (man_module->segment[SOF_MAN_SEGMENT_TEXT].flags.r.length +
-			man_module->segment[SOF_MAN_SEGMENT_RODATA].flags.r.length) *
-			MAN_PAGE_SIZE;
+		mod_size = man_segment_file_size(image, &man_module->segment[SOF_MAN_SEGMENT_TEXT]) +
+			man_segment_file_size(image, &man_module->segment[SOF_MAN_SEGMENT_RODATA]);
 
 		assert((mod_offset + mod_size) <= image->adsp->image_size);
 
-		ret = hash_sha256(image->fw_image + mod_offset, mod_size, man_module->hash, sizeof(man_module->hash));
-		if (ret)
-			break;
+		job = &jobs[i];
+		job->cache_dir = image->hash_cache_dir;
+		job->data = image->fw_image + mod_offset;
+		job->size = mod_size;
+		job->man_module = man_module;
+
+		job->started = !pthread_create(&job->thread, NULL, man_hash_module, job);
+		if (!job->started)
+			man_hash_module(job);
+	}
+
+	for (i = 0; i < image->num_modules; i++) {
+		job = &jobs[i];
+		if (job->started)
+			pthread_join(job->thread, NULL);
+		if (job->ret && !ret)
+			ret = job->ret;
 	}
 
 	return ret;
@@ -15,6 +15,7 @@
 #include <rimage/rimage.h>
 #include <rimage/manifest.h>
 #include <rimage/file_utils.h>
+#include <rimage/hash.h>
 
 
 static void usage(char *name)
@@ -31,9 +32,11 @@ static void usage(char *name)
 	fprintf(stdout, "\t -b build version\n");
 	fprintf(stdout, "\t -e build extended manifest\n");
 	fprintf(stdout, "\t -l build loadable modules image (don't treat the first module as a bootloader)\n");
+	fprintf(stdout, "\t -z compress the segments of a loadable modules image\n");
 	fprintf(stdout, "\t -y verify signed file\n");
 	fprintf(stdout, "\t -q resign binary\n");
 	fprintf(stdout, "\t -p set PV bit\n");
+	fprintf(stdout, "\t -C cache directory, reuse module digests of unchanged modules\n");
 }
 
 int main(int argc, char *argv[])
@@ -50,7 +53,7 @@ int main(int argc, char *argv[])
 
 	image.imr_type = MAN_DEFAULT_IMR_TYPE;
 
-	while ((opt = getopt(argc, argv, "ho:va:s:k:ri:f:b:ec:y:q:pl")) != -1) {
+	while ((opt = getopt(argc, argv, "ho:va:s:k:ri:f:b:ec:y:q:plzC:")) != -1) {
 		switch (opt) {
 		case 'o':
 			image.out_file = optarg;
@@ -101,6 +104,12 @@ int main(int argc, char *argv[])
 		case 'l':
 			image.loadable_module = true;
 			break;
+		case 'z':
+			image.compress = true;
+			break;
+		case 'C':
+			image.hash_cache_dir = optarg;
+			break;
 		default:
 		 /* getopt's default error message is good enough */
 			return 1;
@@ -128,6 +137,12 @@ int main(int argc, char *argv[])
 		return -EINVAL;
 	}
 
+	/* compressed segments are only expanded by the library manager */
+	if (image.compress && (!image.loadable_module || image.reloc)) {
+		fprintf(stderr, "error: -z requires a loadable modules image of non relocatable ELF files\n");
+		return -EINVAL;
+	}
+
 	/* firmware version: major.minor.micro */
 	if (image.fw_ver_string) {
 		ret = sscanf(image.fw_ver_string, "%hu.%hu.%hu",
@@ -204,6 +219,12 @@ int main(int argc, char *argv[])
 		goto out;
 	}
 
+	if (image.hash_cache_dir) {
+		ret = hash_cache_init(image.hash_cache_dir);
+		if (ret < 0)
+			goto out;
+	}
+
 	/* Some platforms dont have modules configuration in toml file */
 	if (image.adsp->modules && image.num_modules > image.adsp->modules->mod_man_count) {
 		fprintf(stderr, "error: Each ELF input module requires entry in toml file.\n");
@@ -0,0 +1,389 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+"""Synthetic load topologies for scheduler, IPC and heap scalability tests.
+
+gen    writes and builds one topology of synthetic load pipelines
+report reads the statistics of the synthetic load modules of a running topology
+sweep  runs gen, the DUT commands and report over a grid of parameters
+"""
+
+import argparse
+import csv
+import itertools
+import json
+import os
+import pathlib
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import time
+
+SOF_TOP = pathlib.Path(__file__).resolve().parents[3]
+TPLG2_DIR = SOF_TOP / "tools" / "topology" / "topology2"
+ABI_H = SOF_TOP / "src" / "include" / "kernel" / "abi.h"
+
+# load pipeline IDs, clear of the HDA, HDMI and DMIC pipelines of sof-hda-generic
+FIRST_PIPELINE = 100
+MAX_PIPELINES = 150
+# SYNTHETIC_LOAD_ALLOCS_MAX in user/synthetic_load.h
+ALLOCS_MAX = 64
+
+# config IDs, struct sof_synthetic_load_config and struct sof_synthetic_load_stats
+SET_CONFIG = 0
+GET_STATS = 1
+CONFIG_WORDS = 12
+JITTER_BINS = 12
+STATS_FIELDS = ["size", "periods", "period_us", "interval_min_us", "interval_max_us",
+                "jitter_avg_us", "jitter_max_us", "load_max_cycles", "overruns",
+                "heap_fails", "heap_live_bytes", "heap_largest_free"]
+STATS_WORDS = len(STATS_FIELDS) + JITTER_BINS
+FLAG_HEAP_BUFFER = 1
+
+ABI_MAGIC = 0x34464f53	# "SOF4"
+ABI_HDR_WORDS = 8
+
+DEFAULT_READ = "sof-ctl -i 4 -D hw:0 -r -c name={control}"
+
+def abi_version():
+    text = ABI_H.read_text()
+    ver = [int(re.search(r"#define SOF_ABI_%s\s+(\d+)" % f, text).group(1))
+           for f in ("MAJOR", "MINOR", "PATCH")]
+    return ver[0] << 24 | ver[1] << 12 | ver[2]
+
+def control_bytes(param_id, words):
+    """Topology bytes of a control, sof_abi_hdr followed by the payload words"""
+    hdr = [ABI_MAGIC, param_id, len(words) * 4, abi_version(), 0, 0, 0, 0]
+    data = b"".join(w.to_bytes(4, "little") for w in hdr + words)
+    return ",".join("0x%02x" % b for b in data)
+
+def module_layout(args):
+    """The load modules, pipeline p runs on core p % cores"""
+    modules = []
+    for p in range(args.pipelines):
+        core = p % args.cores
+        for i in range(1, args.depth + 1):
+            if args.domain == "mixed":
+                dp = i % 2 == 0
+            else:
+                dp = args.domain == "dp"
+            name = "Load %d.%d" % (FIRST_PIPELINE + p, i)
+            modules.append({"pipeline": FIRST_PIPELINE + p, "instance": i, "core": core,
+                            "dp": dp, "config": name + " config", "stats": name + " stats"})
+    return modules
+
+def config_words(args):
+    flags = FLAG_HEAP_BUFFER if args.heap_buffer else 0
+    words = [CONFIG_WORDS * 4, args.cycles, flags, args.heap_allocs, args.heap_min,
+             args.heap_max, args.heap_probe]
+    return words + [0] * (CONFIG_WORDS - len(words))
+
+def widget_conf(args, module):
+    uuid = "\n\t\t\t\tuuid $SYNTHETIC_LOAD_DP_UUID" if module["dp"] else ""
+    return """			Object.Widget.synthetic_load.{instance} {{{uuid}
+				num_input_audio_formats 1
+				num_output_audio_formats 1
+				Object.Base.input_audio_format [
+					{{
+						in_bit_depth		32
+						in_valid_bit_depth	32
+					}}
+				]
+				Object.Base.output_audio_format [
+					{{
+						out_bit_depth		32
+						out_valid_bit_depth	32
+					}}
+				]
+				Object.Control.bytes.1 {{
+					name '{config}'
+					max {config_max}
+					Object.Base.data.config {{
+						bytes "{config_bytes}"
+					}}
+				}}
+				Object.Control.bytes.2 {{
+					name '{stats}'
+					max {stats_max}
+					!access [
+						tlv_read
+						tlv_callback
+						volatile
+					]
+					Object.Base.extops.1 {{
+						name	"extctl"
+						get	260
+						put	0
+					}}
+					Object.Base.data.stats {{
+						bytes "{stats_bytes}"
+					}}
+				}}
+			}}
+""".format(instance=module["instance"], uuid=uuid, config=module["config"],
+           stats=module["stats"], config_max=(ABI_HDR_WORDS + CONFIG_WORDS) * 4,
+           config_bytes=control_bytes(SET_CONFIG, config_words(args)),
+           stats_max=(ABI_HDR_WORDS + STATS_WORDS) * 4,
+           stats_bytes=control_bytes(GET_STATS, [0] * STATS_WORDS))
+
+def load_conf(args, modules):
+    """The load pipelines and routes appended to sof-hda-generic with HDA_CONFIG=load"""
+    out = ["", "# Generated with: %s" % " ".join(shlex.quote(a) for a in sys.argv),
+           "Object.Pipeline.mixout-synthetic-load-mixin ["]
+    routes = []
+    for p in range(args.pipelines):
+        index = FIRST_PIPELINE + p
+        chain = [m for m in modules if m["pipeline"] == index]
+        out.append("\t{\n\t\tindex %d\n\t\tcore_id %d\n" % (index, chain[0]["core"]))
+        out.append("\t\tObject.Widget.pipeline.1 {\n\t\t\tcore %d\n\t\t\tperiod %d\n\t\t}\n"
+                   % (chain[0]["core"], args.period))
+        for m in chain:
+            out.append(widget_conf(args, m))
+        out.append("\t}")
+
+        names = ["mixout.%d.1" % index]
+        names += ["synthetic_load.%d.%d" % (index, m["instance"]) for m in chain]
+        names += ["mixin.%d.1" % index]
+        routes.append(("mixin.1.1", names[0]))
+        routes += zip(names, names[1:])
+        routes.append((names[-1], "mixout.2.1"))
+    out.append("]\n\nObject.Base.route [")
+    for source, sink in routes:
+        out.append("\t{\n\t\tsource '%s'\n\t\tsink '%s'\n\t}" % (source, sink))
+    out.append("]\n")
+    return "\n".join(out)
+
+def check_args(args):
+    if not 1 <= args.pipelines <= MAX_PIPELINES:
+        sys.exit("error: 1 to %d pipelines" % MAX_PIPELINES)
+    if args.depth < 1 or args.cores < 1:
+        sys.exit("error: depth and cores must be positive")
+    if args.heap_allocs > ALLOCS_MAX:
+        sys.exit("error: at most %d heap allocations" % ALLOCS_MAX)
+    if args.heap_allocs and not 0 < args.heap_min <= args.heap_max:
+        sys.exit("error: heap sizes must satisfy 0 < min <= max")
+
+def gen(args):
+    """Writes <output>.conf, <output>.json and builds <output>.tplg"""
+    check_args(args)
+    output = pathlib.Path(args.output)
+    output.parent.mkdir(parents=True, exist_ok=True)
+    modules = module_layout(args)
+
+    # the same input the topology2 CMake build feeds to alsatplg
+    abi = subprocess.run([str(TPLG2_DIR / "get_abi.sh"), str(SOF_TOP), "ipc4"],
+                         check=True, capture_output=True, text=True).stdout
+    conf = output.with_suffix(".conf")
+    conf.write_text(abi + (TPLG2_DIR / "sof-hda-generic.conf").read_text() +
+                    load_conf(args, modules))
+    output.with_suffix(".json").write_text(json.dumps({"modules": modules}, indent=1))
+
+    tplg = output.with_suffix(".tplg")
+    if args.no_build:
+        return tplg
+    if not shutil.which("alsatplg"):
+        sys.exit("error: alsatplg not found, use --no-build to only write %s" % conf)
+    defines = "PLATFORM=%s,HDA_CONFIG=load" % args.platform
+    subprocess.run(["alsatplg", "-I", str(TPLG2_DIR), "-D", defines, "-p",
+                    "-c", str(conf), "-o", str(tplg)],
+                   check=True, env=dict(os.environ, ALSA_CONFIG_DIR=str(TPLG2_DIR)))
+    return tplg
+
+def read_stats(read_cmd, control):
+    """Reads one stats control, returns the stats and the round trip in us"""
+    cmd = read_cmd.format(control=shlex.quote(control))
+    start = time.monotonic()
+    res = subprocess.run(cmd, shell=True, check=True, capture_output=True, text=True)
+    rtt = (time.monotonic() - start) * 1e6
+
+    words = None
+    for line in res.stdout.splitlines():
+        if re.fullmatch(r"\s*\d+(\s*,\s*\d+)*\s*", line):
+            words = [int(w) for w in line.split(",")]
+    if not words or len(words) < STATS_WORDS or words[0] != STATS_WORDS * 4:
+        raise RuntimeError("%s: no synthetic load stats in %r" % (control, res.stdout))
+
+    stats = dict(zip(STATS_FIELDS, words))
+    stats["jitter_hist"] = words[len(STATS_FIELDS):STATS_WORDS]
+    return stats, rtt
+
+def collect(layout, read_cmd):
+    modules = json.loads(pathlib.Path(layout).read_text())["modules"]
+    results = []
+    for m in modules:
+        stats, rtt = read_stats(read_cmd, m["stats"])
+        results.append((m, stats, rtt))
+    return results
+
+def summary(results):
+    """One row for all modules of a topology"""
+    stats = [s for _, s, _ in results]
+    rtts = sorted(r for _, _, r in results)
+    hist = [sum(s["jitter_hist"][b] for s in stats) for b in range(JITTER_BINS)]
+    return {
+        "modules": len(stats),
+        "periods_min": min(s["periods"] for s in stats),
+        "jitter_avg_us": round(sum(s["jitter_avg_us"] for s in stats) / len(stats), 1),
+        "jitter_max_us": max(s["jitter_max_us"] for s in stats),
+        "load_max_cycles": max(s["load_max_cycles"] for s in stats),
+        "overruns": sum(s["overruns"] for s in stats),
+        "heap_fails": sum(s["heap_fails"] for s in stats),
+        "heap_largest_free": min(s["heap_largest_free"] for s in stats),
+        "ipc_min_us": round(rtts[0]),
+        "ipc_avg_us": round(sum(rtts) / len(rtts)),
+        "ipc_max_us": round(rtts[-1]),
+        "jitter_hist": " ".join(str(h) for h in hist),
+    }
+
+def report(args):
+    results = collect(args.layout, args.read)
+    if args.verbose:
+        for m, s, rtt in results:
+            print("%-24s core %d %s periods %u jitter avg %u max %u us load max %u "
+                  "overruns %u heap fails %u largest free %u ipc %.0f us" %
+                  (m["stats"], m["core"], "DP" if m["dp"] else "LL", s["periods"],
+                   s["jitter_avg_us"], s["jitter_max_us"], s["load_max_cycles"],
+                   s["overruns"], s["heap_fails"], s["heap_largest_free"], rtt))
+    for key, value in summary(results).items():
+        print("%-18s %s" % (key, value))
+
+def run(cmd, point, **kwargs):
+    if not cmd:
+        return None
+    return subprocess.Popen(cmd.format(**point), shell=True, **kwargs)
+
+def sweep_points(args):
+    for pipelines, depth, cycles, cores in itertools.product(
+            args.pipelines, args.depth, args.cycles, args.cores):
+        yield dict(pipelines=pipelines, depth=depth, cycles=cycles, cores=cores)
+
+def sweep(args):
+    """Runs every point of the grid, the pipeline counts in the outer loop"""
+    out = pathlib.Path(args.output)
+    out.mkdir(parents=True, exist_ok=True)
+    rows = []
+    failed = set()
+
+    for point in sweep_points(args):
+        line = (point["depth"], point["cycles"], point["cores"])
+        if args.stop_on_fail and line in failed:
+            continue
+
+        name = "p%(pipelines)d_d%(depth)d_c%(cycles)d_k%(cores)d" % point
+        gen_args = argparse.Namespace(**vars(args))
+        gen_args.__dict__.update(point, output=str(out / name))
+        tplg = gen(gen_args)
+        point.update(name=name, tplg=tplg, conf=tplg.with_suffix(".conf"),
+                     duration=args.duration)
+
+        status = "ok"
+        row = dict(name=name, **{k: point[k] for k in ("pipelines", "depth", "cycles",
+                                                        "cores")})
+        if args.install and run(args.install, point).wait():
+            status = "install failed"
+        else:
+            play = run(args.play, point)
+            time.sleep(args.settle)
+            try:
+                row.update(summary(collect(tplg.with_suffix(".json"), args.read)))
+            except (RuntimeError, subprocess.CalledProcessError) as e:
+                status = "stats failed"
+                print(e, file=sys.stderr)
+            if play and play.wait():
+                status = "play failed"
+
+        if status == "ok" and (row["overruns"] or row["heap_fails"] or
+                               row["jitter_max_us"] > args.jitter_limit):
+            status = "limit"
+        row["status"] = status
+        rows.append(row)
+        print("%-24s %s" % (name, status), flush=True)
+        if status != "ok":
+            failed.add(line)
+
+    fields = list(dict.fromkeys(k for r in rows for k in r))
+    with open(out / "sweep.csv", "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=fields)
+        writer.writeheader()
+        writer.writerows(rows)
+
+    # the scaling limit of each depth, cost and core count
+    print("\n%-6s %-10s %-6s %s" % ("depth", "cycles", "cores", "max pipelines"))
+    for depth, cycles, cores in itertools.product(args.depth, args.cycles, args.cores):
+        ok = [r["pipelines"] for r in rows if r["status"] == "ok" and
+              (r["depth"], r["cycles"], r["cores"]) == (depth, cycles, cores)]
+        print("%-6d %-10d %-6d %s" % (depth, cycles, cores, max(ok) if ok else "none"))
+
+def int_list(text):
+    return [int(v, 0) for v in text.split(",")]
+
+def add_load_args(parser, grid):
+    kind = int_list if grid else lambda v: int(v, 0)
+    parser.add_argument("--pipelines", type=kind, default=kind("1"),
+                        help="number of parallel load pipelines")
+    parser.add_argument("--depth", type=kind, default=kind("1"),
+                        help="synthetic load modules per pipeline")
+    parser.add_argument("--cycles", type=kind, default=kind("0"),
+                        help="cost of every module per period in sof_cycle_get_64() cycles")
+    parser.add_argument("--cores", type=kind, default=kind("1"),
+                        help="spread the load pipelines over the cores, pipelines on "
+                        "other cores than 0 link across cores to the host and DAI "
+                        "pipelines")
+    parser.add_argument("--domain", choices=["ll", "dp", "mixed"], default="ll",
+                        help="scheduling domain of the modules, mixed alternates")
+    parser.add_argument("--period", type=int, default=1000, help="LL period in us")
+    parser.add_argument("--heap-allocs", type=int, default=0,
+                        help="live allocations of the heap churn of every module")
+    parser.add_argument("--heap-min", type=int, default=64, help="smallest allocation")
+    parser.add_argument("--heap-max", type=int, default=4096, help="largest allocation")
+    parser.add_argument("--heap-buffer", action="store_true",
+                        help="churn the buffer zone instead of the runtime zone")
+    parser.add_argument("--heap-probe", type=int, default=0,
+                        help="probe the largest free block up to this size on stats reads")
+    parser.add_argument("--platform", default="mtl", help="topology PLATFORM define")
+    parser.add_argument("--no-build", action="store_true", help="only write the conf")
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("gen", help="write and build one topology")
+    add_load_args(p, False)
+    p.add_argument("-o", "--output", required=True,
+                   help="output path without suffix, writes .conf, .json and .tplg")
+    p.set_defaults(func=gen)
+
+    read_help = ("command printing a stats control as sof-ctl CSV, {control} is "
+                 "replaced with the quoted control name, default: " + DEFAULT_READ)
+    p = sub.add_parser("report", help="read the statistics of a running topology")
+    p.add_argument("layout", help="the .json file written by gen")
+    p.add_argument("--read", default=DEFAULT_READ, help=read_help)
+    p.add_argument("-v", "--verbose", action="store_true", help="print every module")
+    p.set_defaults(func=report)
+
+    p = sub.add_parser("sweep", help="run a grid of topologies, comma separated values")
+    add_load_args(p, True)
+    p.add_argument("-o", "--output", required=True, help="output directory")
+    p.add_argument("--install", help="command installing {tplg} and reloading the driver")
+    p.add_argument("--play", help="command streaming to the topology for {duration} s "
+                   "in the background, e.g. aplay -D hw:0,0 -f S32_LE -c 2 -r 48000 "
+                   "-d {duration} /dev/zero")
+    p.add_argument("--read", default=DEFAULT_READ, help=read_help)
+    p.add_argument("--duration", type=int, default=10, help="stream duration in s")
+    p.add_argument("--settle", type=float, default=5, help="wait before reading the stats")
+    p.add_argument("--jitter-limit", type=int, default=500,
+                   help="largest accepted jitter in us")
+    p.add_argument("--stop-on-fail", action="store_true",
+                   help="skip larger pipeline counts once a point fails")
+    p.set_defaults(func=sweep)
+
+    args = parser.parse_args()
+    args.func(args)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,399 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/*
+ * Benchmark mode of the testbench. The copy() operation of every component
+ * of the tested pipelines is wrapped with a timer and the time of each call
+ * is recorded. The same topology and input files are run several times and
+ * the median and percentile time per frame and the MCPS of each component
+ * are reported, optionally also as a JSON file for automated comparison.
+ *
+ * With xt-run the time is measured in DSP cycles. On host it's measured in
+ * nanoseconds, so the reported MCPS is the equivalent of a 1 GHz core.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sof/ipc/topology.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include "testbench/common_test.h"
+#include "testbench/benchmark.h"
+
+#if defined __XCC__
+#include <xtensa/tie/xt_timer.h>
+#endif
+
+#define TB_BENCH_INITIAL_SAMPLES	1024
+
+static uint64_t tb_bench_ticks(void)
+{
+#if defined __XCC__
+	return XT_RSR_CCOUNT();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static int tb_bench_add_sample(struct tb_bench_comp *stats, uint64_t ticks, uint32_t frames)
+{
+	uint64_t *new_ticks;
+	uint32_t *new_frames;
+	int new_size;
+
+	if (stats->count == stats->size) {
+		new_size = stats->size ? 2 * stats->size : TB_BENCH_INITIAL_SAMPLES;
+		new_ticks = realloc(stats->ticks, new_size * sizeof(*new_ticks));
+		if (!new_ticks)
+			return -ENOMEM;
+
+		stats->ticks = new_ticks;
+		new_frames = realloc(stats->frames, new_size * sizeof(*new_frames));
+		if (!new_frames)
+			return -ENOMEM;
+
+		stats->frames = new_frames;
+		stats->size = new_size;
+	}
+
+	stats->ticks[stats->count] = ticks;
+	stats->frames[stats->count] = frames;
+	stats->count++;
+	return 0;
+}
+
+/* copy() of every benchmarked component is routed here */
+static int tb_bench_copy(struct comp_dev *cd)
+{
+	struct tb_bench_drv *bd = container_of(cd->drv, struct tb_bench_drv, drv);
+	struct tb_bench_comp *stats = bd->stats;
+	uint64_t t0, t1;
+	int ret;
+
+	t0 = tb_bench_ticks();
+	ret = bd->orig->ops.copy(cd);
+	t1 = tb_bench_ticks();
+
+	if (ret < 0 || stats->copies_in_run++ < TB_BENCH_WARMUP_COPIES)
+		return ret;
+
+#if defined __XCC__
+	/* the cycle counter is 32 bits */
+	if (tb_bench_add_sample(stats, (uint32_t)(t1 - t0), cd->frames) < 0)
+#else
+	if (tb_bench_add_sample(stats, t1 - t0, cd->frames) < 0)
+#endif
+		fprintf(stderr, "error: benchmark out of memory, comp %d\n", stats->comp_id);
+
+	return ret;
+}
+
+static bool tb_bench_pipeline_tested(struct testbench_prm *tp, uint32_t pipeline_id)
+{
+	int i;
+
+	for (i = 0; i < tp->pipeline_num; i++)
+		if (tp->pipelines[i] == pipeline_id)
+			return true;
+
+	return false;
+}
+
+static struct tb_bench_comp *tb_bench_get_stats(struct tb_benchmark *bench,
+						struct comp_dev *cd)
+{
+	struct tb_bench_comp *stats;
+	int i;
+
+	for (i = 0; i < bench->num_comps; i++)
+		if (bench->comps[i].comp_id == cd->ipc_config.id)
+			return &bench->comps[i];
+
+	if (bench->num_comps == TB_BENCH_MAX_COMPS)
+		return NULL;
+
+	stats = &bench->comps[bench->num_comps++];
+	stats->comp_id = cd->ipc_config.id;
+	stats->pipeline_id = cd->pipeline->pipeline_id;
+	stats->name = cd->tctx.uuid_p ? cd->tctx.uuid_p->name : "unknown";
+	return stats;
+}
+
+/* channels processed by a component, from its first input or output */
+uint32_t tb_bench_channels(struct comp_dev *cd)
+{
+	struct comp_buffer *buffer;
+
+	if (!list_is_empty(&cd->bsource_list)) {
+		buffer = list_first_item(&cd->bsource_list, struct comp_buffer, sink_list);
+		return audio_stream_get_channels(&buffer->stream);
+	}
+
+	if (!list_is_empty(&cd->bsink_list)) {
+		buffer = list_first_item(&cd->bsink_list, struct comp_buffer, source_list);
+		return audio_stream_get_channels(&buffer->stream);
+	}
+
+	return 0;
+}
+
+/*
+ * Wrap copy() of all components of the tested pipelines. Must be called
+ * after the pipelines are loaded and before they are started.
+ */
+int tb_benchmark_attach(struct testbench_prm *tp)
+{
+	struct tb_benchmark *bench = tp->bench;
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	struct tb_bench_drv *bd;
+	struct comp_dev *cd;
+
+	list_for_item(clist, &sof_get()->ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT)
+			continue;
+
+		cd = icd->cd;
+		if (!tb_bench_pipeline_tested(tp, cd->pipeline->pipeline_id) ||
+		    !cd->drv->ops.copy)
+			continue;
+
+		if (bench->num_drvs == TB_BENCH_MAX_COMPS) {
+			fprintf(stderr, "error: max %d components can be benchmarked\n",
+				TB_BENCH_MAX_COMPS);
+			return -EINVAL;
+		}
+
+		bd = calloc(1, sizeof(*bd));
+		if (!bd)
+			return -ENOMEM;
+
+		bd->stats = tb_bench_get_stats(bench, cd);
+		if (!bd->stats) {
+			free(bd);
+			return -EINVAL;
+		}
+
+		/* period is known only after pipeline params */
+		bd->stats->period_us = cd->period ? cd->period : cd->pipeline->period;
+		bd->stats->channels = tb_bench_channels(cd);
+		bd->stats->copies_in_run = 0;
+		bd->orig = cd->drv;
+		bd->cd = cd;
+		bd->drv = *cd->drv;
+		bd->drv.ops.copy = tb_bench_copy;
+		cd->drv = &bd->drv;
+		bench->drvs[bench->num_drvs++] = bd;
+	}
+
+	return 0;
+}
+
+/* restore the original drivers, must be called before the components are freed */
+void tb_benchmark_detach(struct testbench_prm *tp)
+{
+	struct tb_benchmark *bench = tp->bench;
+	int i;
+
+	for (i = 0; i < bench->num_drvs; i++) {
+		bench->drvs[i]->cd->drv = bench->drvs[i]->orig;
+		free(bench->drvs[i]);
+		bench->drvs[i] = NULL;
+	}
+
+	bench->num_drvs = 0;
+	bench->runs++;
+}
+
+static int tb_bench_cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* nearest rank percentile of sorted samples */
+static uint64_t tb_bench_percentile(const uint64_t *sorted, int count, int percentile)
+{
+	int rank = (percentile * count + 99) / 100;
+
+	return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+struct tb_bench_result {
+	uint64_t median_ticks;
+	uint64_t pct_ticks;
+	/* per frame values are scaled by 1000 to keep three decimals */
+	uint64_t median_frame_mticks;
+	uint64_t pct_frame_mticks;
+	float mcps;
+	float pct_mcps;
+};
+
+static int tb_bench_calc(struct tb_bench_comp *stats, struct tb_bench_result *res)
+{
+	uint64_t *per_copy;
+	uint64_t *per_frame;
+	int n = 0;
+	int i;
+
+	memset(res, 0, sizeof(*res));
+	if (!stats->count)
+		return 0;
+
+	per_copy = malloc(stats->count * sizeof(*per_copy));
+	per_frame = malloc(stats->count * sizeof(*per_frame));
+	if (!per_copy || !per_frame) {
+		free(per_copy);
+		free(per_frame);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < stats->count; i++) {
+		per_copy[i] = stats->ticks[i];
+		if (stats->frames[i])
+			per_frame[n++] = stats->ticks[i] * 1000 / stats->frames[i];
+	}
+
+	qsort(per_copy, stats->count, sizeof(*per_copy), tb_bench_cmp_u64);
+	res->median_ticks = tb_bench_percentile(per_copy, stats->count, 50);
+	res->pct_ticks = tb_bench_percentile(per_copy, stats->count, TB_BENCH_PERCENTILE);
+
+	if (n) {
+		qsort(per_frame, n, sizeof(*per_frame), tb_bench_cmp_u64);
+		res->median_frame_mticks = tb_bench_percentile(per_frame, n, 50);
+		res->pct_frame_mticks = tb_bench_percentile(per_frame, n, TB_BENCH_PERCENTILE);
+	}
+
+	/* ticks in one period over period length in us gives MCPS */
+	if (stats->period_us) {
+		res->mcps = (float)res->median_ticks / stats->period_us;
+		res->pct_mcps = (float)res->pct_ticks / stats->period_us;
+	}
+
+	free(per_copy);
+	free(per_frame);
+	return 0;
+}
+
+static int tb_bench_write_json(struct testbench_prm *tp, struct tb_bench_result *res)
+{
+	struct tb_benchmark *bench = tp->bench;
+	struct tb_bench_comp *stats;
+	FILE *f;
+	int i;
+
+	f = fopen(tp->bench_json, "w");
+	if (!f) {
+		fprintf(stderr, "error: can't open %s\n", tp->bench_json);
+		return -errno;
+	}
+
+	fprintf(f, "{\n");
+	fprintf(f, "\t\"topology\": \"%s\",\n", tp->tplg_file);
+#if defined __XCC__
+	fprintf(f, "\t\"time_unit\": \"cycles\",\n");
+#else
+	fprintf(f, "\t\"time_unit\": \"ns\",\n");
+#endif
+	fprintf(f, "\t\"runs\": %d,\n", bench->runs);
+	fprintf(f, "\t\"percentile\": %d,\n", TB_BENCH_PERCENTILE);
+	fprintf(f, "\t\"modules\": [\n");
+	for (i = 0; i < bench->num_comps; i++) {
+		stats = &bench->comps[i];
+		fprintf(f, "\t\t{\n");
+		fprintf(f, "\t\t\t\"id\": %u,\n", stats->comp_id);
+		fprintf(f, "\t\t\t\"name\": \"%s\",\n", stats->name);
+		fprintf(f, "\t\t\t\"pipeline\": %u,\n", stats->pipeline_id);
+		fprintf(f, "\t\t\t\"period_us\": %u,\n", stats->period_us);
+		fprintf(f, "\t\t\t\"channels\": %u,\n", stats->channels);
+		fprintf(f, "\t\t\t\"copies\": %d,\n", stats->count);
+		fprintf(f, "\t\t\t\"median_per_copy\": %llu,\n",
+			(unsigned long long)res[i].median_ticks);
+		fprintf(f, "\t\t\t\"p%d_per_copy\": %llu,\n", TB_BENCH_PERCENTILE,
+			(unsigned long long)res[i].pct_ticks);
+		fprintf(f, "\t\t\t\"median_per_frame\": %.3f,\n",
+			res[i].median_frame_mticks / 1000.0);
+		fprintf(f, "\t\t\t\"p%d_per_frame\": %.3f,\n", TB_BENCH_PERCENTILE,
+			res[i].pct_frame_mticks / 1000.0);
+		/* per channel sample cost, to be used in an estimate cost model */
+		fprintf(f, "\t\t\t\"median_per_sample\": %.3f,\n", stats->channels ?
+			res[i].median_frame_mticks / 1000.0 / stats->channels : 0.0);
+		fprintf(f, "\t\t\t\"mcps\": %.3f,\n", res[i].mcps);
+		fprintf(f, "\t\t\t\"p%d_mcps\": %.3f\n", TB_BENCH_PERCENTILE, res[i].pct_mcps);
+		fprintf(f, "\t\t}%s\n", i < bench->num_comps - 1 ? "," : "");
+	}
+	fprintf(f, "\t]\n");
+	fprintf(f, "}\n");
+
+	fclose(f);
+	return 0;
+}
+
+int tb_benchmark_report(struct testbench_prm *tp)
+{
+	struct tb_benchmark *bench = tp->bench;
+	struct tb_bench_result res[TB_BENCH_MAX_COMPS];
+	struct tb_bench_comp *stats;
+	int ret;
+	int i;
+
+	for (i = 0; i < bench->num_comps; i++) {
+		ret = tb_bench_calc(&bench->comps[i], &res[i]);
+		if (ret < 0)
+			return ret;
+	}
+
+	printf("==========================================================\n");
+	printf("		           Benchmark Summary\n");
+	printf("==========================================================\n");
+	printf("Runs: %d, time unit: %s\n", bench->runs,
+#if defined __XCC__
+	       "cycles"
+#else
+	       "ns"
+#endif
+	       );
+	printf("%4s %-24s %8s %12s %8s%2d/frm %10s %7s%2d MCPS\n", "id", "module", "copies",
+	       "median/frm", "p", TB_BENCH_PERCENTILE, "MCPS", "p", TB_BENCH_PERCENTILE);
+	for (i = 0; i < bench->num_comps; i++) {
+		stats = &bench->comps[i];
+		printf("%4u %-24s %8d %12.3f %12.3f %10.3f %10.3f\n", stats->comp_id,
+		       stats->name, stats->count, res[i].median_frame_mticks / 1000.0,
+		       res[i].pct_frame_mticks / 1000.0, res[i].mcps, res[i].pct_mcps);
+	}
+	printf("\n");
+
+	if (tp->bench_json)
+		return tb_bench_write_json(tp, res);
+
+	return 0;
+}
+
+void tb_benchmark_free(struct testbench_prm *tp)
+{
+	struct tb_benchmark *bench = tp->bench;
+	int i;
+
+	if (!bench)
+		return;
+
+	for (i = 0; i < bench->num_comps; i++) {
+		free(bench->comps[i].ticks);
+		free(bench->comps[i].frames);
+	}
+
+	free(bench);
+	tp->bench = NULL;
+}
@@ -0,0 +1,240 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/*
+ * Estimate mode of the testbench. The topology is loaded and the pipeline
+ * parameters are set as for a normal run, then instead of running the
+ * pipelines the configured graph is walked. The cost of every component is
+ * predicted from a cost model file, and the load of each core, the buffer
+ * memory of each core and the buffered latency of each tested pipeline are
+ * reported. A load above the budget of the model file fails the test.
+ *
+ * The cost model file has one module per line, named as in the benchmark
+ * report, with the ticks of a copy() and the ticks of one frame of one
+ * channel. They are calibrated with -B -J, the per sample cost is the
+ * median_per_sample of the benchmark results. Modules whose cost depends
+ * on filter lengths are calibrated with the configuration blob of the
+ * estimated topology. Empty lines and lines starting with # are skipped,
+ * "budget <MCPS>" sets the load limit of each core:
+ *
+ *	budget 400
+ *	volume 150 2.5
+ *	src 900 48
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sof/ipc/topology.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include "testbench/common_test.h"
+#include "testbench/benchmark.h"
+#include "testbench/estimate.h"
+
+#define TB_EST_LINE_LEN		128
+
+int tb_estimate_load(struct testbench_prm *tp, const char *file)
+{
+	struct tb_estimate *est;
+	struct tb_est_model *model;
+	char line[TB_EST_LINE_LEN];
+	char name[TB_EST_NAME_LEN];
+	int line_num = 0;
+	float budget;
+	FILE *f;
+
+	f = fopen(file, "r");
+	if (!f) {
+		fprintf(stderr, "error: can't open cost model %s\n", file);
+		return -errno;
+	}
+
+	est = calloc(1, sizeof(*est));
+	if (!est) {
+		fclose(f);
+		return -ENOMEM;
+	}
+
+	while (fgets(line, sizeof(line), f)) {
+		line_num++;
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+
+		if (sscanf(line, "budget %f", &budget) == 1) {
+			est->budget_mcps = budget;
+			continue;
+		}
+
+		if (est->num_models == TB_EST_MAX_MODELS) {
+			fprintf(stderr, "error: max %d modules in cost model\n", TB_EST_MAX_MODELS);
+			goto err;
+		}
+
+		model = &est->models[est->num_models];
+		if (sscanf(line, "%31s %f %f", name, &model->per_copy, &model->per_sample) != 3) {
+			fprintf(stderr, "error: %s:%d: expected <module> <per copy> <per sample>\n",
+				file, line_num);
+			goto err;
+		}
+
+		strcpy(model->name, name);
+		est->num_models++;
+	}
+
+	fclose(f);
+	tp->estimate = est;
+	return 0;
+
+err:
+	fclose(f);
+	free(est);
+	return -EINVAL;
+}
+
+static const struct tb_est_model *tb_est_find(struct tb_estimate *est, const char *name)
+{
+	int i;
+
+	for (i = 0; i < est->num_models; i++)
+		if (!strcmp(est->models[i].name, name))
+			return &est->models[i];
+
+	return NULL;
+}
+
+static bool tb_est_pipeline_tested(struct testbench_prm *tp, uint32_t pipeline_id)
+{
+	int i;
+
+	for (i = 0; i < tp->pipeline_num; i++)
+		if (tp->pipelines[i] == pipeline_id)
+			return true;
+
+	return false;
+}
+
+/* time to fill a buffer at its stream rate */
+static uint64_t tb_est_buffer_us(struct comp_buffer *buffer)
+{
+	uint32_t frame_bytes = audio_stream_frame_bytes(&buffer->stream);
+	uint32_t rate = audio_stream_get_rate(&buffer->stream);
+
+	if (!frame_bytes || !rate)
+		return 0;
+
+	return (uint64_t)audio_stream_get_size(&buffer->stream) / frame_bytes * 1000000 / rate;
+}
+
+/*
+ * Report the predicted costs of the tested pipelines. Must be called after
+ * the pipelines are loaded and their parameters set.
+ */
+int tb_estimate_report(struct testbench_prm *tp)
+{
+	struct tb_estimate *est = tp->estimate;
+	float core_mcps[CONFIG_CORE_COUNT] = { 0 };
+	size_t core_bytes[CONFIG_CORE_COUNT] = { 0 };
+	uint64_t latency_us[MAX_OUTPUT_FILE_NUM] = { 0 };
+	const struct tb_est_model *model;
+	struct ipc_comp_dev *icd;
+	struct comp_buffer *buffer;
+	struct list_item *clist;
+	struct comp_dev *cd;
+	const char *name;
+	uint32_t period_us;
+	uint32_t channels;
+	float ticks;
+	float mcps;
+	int unknown = 0;
+	int ret = 0;
+	int i;
+
+	printf("==========================================================\n");
+	printf("		           Estimate Summary\n");
+	printf("==========================================================\n");
+	printf("%4s %-24s %4s %4s %8s %10s\n", "id", "module", "core", "ch", "frames", "MCPS");
+
+	list_for_item(clist, &sof_get()->ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT)
+			continue;
+
+		cd = icd->cd;
+		if (!tb_est_pipeline_tested(tp, cd->pipeline->pipeline_id))
+			continue;
+
+		name = cd->tctx.uuid_p ? cd->tctx.uuid_p->name : "unknown";
+		model = tb_est_find(est, name);
+		if (!model) {
+			printf("%4u %-24s %4u %4s %8s %10s\n", cd->ipc_config.id, name,
+			       cd->ipc_config.core, "-", "-", "no model");
+			unknown++;
+			continue;
+		}
+
+		/* period is known only after pipeline params */
+		period_us = cd->period ? cd->period : cd->pipeline->period;
+		channels = tb_bench_channels(cd);
+		ticks = model->per_copy + model->per_sample * cd->frames * channels;
+		mcps = period_us ? ticks / period_us : 0;
+		if (cd->ipc_config.core < CONFIG_CORE_COUNT)
+			core_mcps[cd->ipc_config.core] += mcps;
+
+		printf("%4u %-24s %4u %4u %8u %10.3f\n", cd->ipc_config.id, name,
+		       cd->ipc_config.core, channels, cd->frames, mcps);
+	}
+	printf("\n");
+
+	list_for_item(clist, &sof_get()->ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_BUFFER)
+			continue;
+
+		buffer = icd->cb;
+		if (!tb_est_pipeline_tested(tp, buffer->pipeline_id))
+			continue;
+
+		if (icd->core < CONFIG_CORE_COUNT)
+			core_bytes[icd->core] += audio_stream_get_size(&buffer->stream);
+
+		for (i = 0; i < tp->pipeline_num; i++)
+			if (tp->pipelines[i] == buffer->pipeline_id)
+				latency_us[i] += tb_est_buffer_us(buffer);
+	}
+
+	printf("%4s %10s %12s\n", "core", "MCPS", "buffer bytes");
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		if (!core_mcps[i] && !core_bytes[i])
+			continue;
+
+		printf("%4d %10.3f %12zu%s\n", i, core_mcps[i], core_bytes[i],
+		       est->budget_mcps && core_mcps[i] > est->budget_mcps ? "  overcommitted" : "");
+		if (est->budget_mcps && core_mcps[i] > est->budget_mcps)
+			ret = -ERANGE;
+	}
+	printf("\n");
+
+	/* every buffer full is the worst case delay from input to output */
+	for (i = 0; i < tp->pipeline_num; i++)
+		printf("Pipeline %d buffered latency: %llu us\n", tp->pipelines[i],
+		       (unsigned long long)latency_us[i]);
+
+	if (unknown)
+		printf("Warning: %d modules without cost model are not counted.\n", unknown);
+	if (ret < 0)
+		printf("Error: load above the budget of %.3f MCPS per core.\n", est->budget_mcps);
+	printf("\n");
+
+	return ret;
+}
+
+void tb_estimate_free(struct testbench_prm *tp)
+{
+	free(tp->estimate);
+	tp->estimate = NULL;
+}
@@ -10,6 +10,11 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <rtos/sof.h>
 #include <sof/list.h>
 #include <sof/audio/stream.h>
@@ -31,6 +36,276 @@ DECLARE_TR_CTX(file_tr, SOF_UUID(file_uuid), LOG_LEVEL_INFO);
 static const struct comp_driver comp_file_dai;
 static const struct comp_driver comp_file_host;
 
+#define WAV_FORMAT_PCM		0x0001
+#define WAV_FORMAT_EXTENSIBLE	0xfffe
+
+struct wav_chunk {
+	char id[4];
+	uint32_t size;
+} __attribute__((packed));
+
+struct wav_fmt {
+	uint16_t format;
+	uint16_t channels;
+	uint32_t rate;
+	uint32_t byte_rate;
+	uint16_t block_align;
+	uint16_t bits;
+} __attribute__((packed));
+
+/* header of WAV files written by the file component */
+struct wav_header {
+	char riff[4];
+	uint32_t riff_size;
+	char wave[4];
+	struct wav_chunk fmt_chunk;
+	struct wav_fmt fmt;
+	struct wav_chunk data_chunk;
+} __attribute__((packed));
+
+/* finds the format and the sample data of a memory mapped WAV file */
+static int wav_parse(struct file_state *fs)
+{
+	struct wav_chunk chunk;
+	struct wav_fmt fmt;
+	size_t pos = 12;
+	bool fmt_found = false;
+
+	if (fs->map_size < pos || memcmp(fs->map, "RIFF", 4) || memcmp(fs->map + 8, "WAVE", 4)) {
+		fprintf(stderr, "error: %s is not a WAV file\n", fs->fn);
+		return -EINVAL;
+	}
+
+	while (pos + sizeof(chunk) <= fs->map_size) {
+		memcpy(&chunk, fs->map + pos, sizeof(chunk));
+		pos += sizeof(chunk);
+
+		if (!memcmp(chunk.id, "fmt ", 4) && chunk.size >= sizeof(fmt) &&
+		    pos + sizeof(fmt) <= fs->map_size) {
+			memcpy(&fmt, fs->map + pos, sizeof(fmt));
+			if (fmt.format != WAV_FORMAT_PCM && fmt.format != WAV_FORMAT_EXTENSIBLE) {
+				fprintf(stderr, "error: %s is not a PCM WAV file\n", fs->fn);
+				return -EINVAL;
+			}
+
+			fs->wav_rate = fmt.rate;
+			fs->wav_channels = fmt.channels;
+			fs->wav_block_align = fmt.block_align;
+			fs->wav_bits = fmt.bits;
+			fmt_found = true;
+		} else if (!memcmp(chunk.id, "data", 4)) {
+			if (!fmt_found)
+				break;
+
+			fs->map_pos = pos;
+			fs->map_end = MIN(pos + chunk.size, fs->map_size);
+			return 0;
+		}
+
+		/* chunks are padded to an even size */
+		pos += chunk.size + (chunk.size & 1);
+	}
+
+	fprintf(stderr, "error: no format or data in WAV file %s\n", fs->fn);
+	return -EINVAL;
+}
+
+/*
+ * Maps a raw or WAV input file. Files that can't be mapped, like pipes, are
+ * read with stdio, except WAV files which need the header to be parsed.
+ */
+static int file_map_input(struct file_state *fs)
+{
+	struct stat st;
+	void *map;
+	int fd = fileno(fs->rfh);
+
+	if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || !st.st_size)
+		goto no_map;
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED)
+		goto no_map;
+
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+	fs->map = map;
+	fs->map_size = st.st_size;
+	fs->map_pos = 0;
+	fs->map_end = st.st_size;
+
+	if (fs->f_format == FILE_WAV)
+		return wav_parse(fs);
+
+	return 0;
+
+no_map:
+	if (fs->f_format == FILE_WAV) {
+		fprintf(stderr, "error: can't map WAV file %s\n", fs->fn);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* maps an output file with a new size, the file grows with the mapping */
+static int file_map_resize(struct file_state *fs, size_t size)
+{
+	void *map;
+	int fd = fileno(fs->wfh);
+
+	if (fs->map) {
+		munmap(fs->map, fs->map_size);
+		fs->map = NULL;
+	}
+
+	if (ftruncate(fd, size) < 0)
+		return -errno;
+
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED)
+		return -errno;
+
+	fs->map = map;
+	fs->map_size = size;
+	return 0;
+}
+
+/*
+ * Maps a raw or WAV output file, a WAV header is reserved at the start of
+ * the file. Raw files that can't be mapped are written with stdio.
+ */
+static int file_map_output(struct file_state *fs)
+{
+	struct stat st;
+	int fd = fileno(fs->wfh);
+	int ret;
+
+	fs->map_pos = fs->f_format == FILE_WAV ? sizeof(struct wav_header) : 0;
+
+	if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+		ret = -EINVAL;
+		goto no_map;
+	}
+
+	ret = file_map_resize(fs, FILE_MAP_CHUNK_SIZE);
+	if (ret < 0) {
+		if (ftruncate(fd, 0) < 0)
+			fs->write_failed = true;
+		goto no_map;
+	}
+
+	return 0;
+
+no_map:
+	if (fs->f_format == FILE_WAV) {
+		fprintf(stderr, "error: can't map WAV file %s\n", fs->fn);
+		return ret;
+	}
+
+	fs->map_pos = 0;
+	return 0;
+}
+
+/* writes the WAV header, unmaps the file and drops the unused mapping tail */
+static void file_unmap(struct file_state *fs)
+{
+	struct wav_header hdr;
+	uint32_t data_size;
+
+	if (!fs->map)
+		return;
+
+	if (fs->mode == FILE_READ) {
+		munmap(fs->map, fs->map_size);
+		fs->map = NULL;
+		return;
+	}
+
+	if (fs->f_format == FILE_WAV) {
+		data_size = fs->map_pos - sizeof(hdr);
+
+		memcpy(hdr.riff, "RIFF", 4);
+		hdr.riff_size = fs->map_pos - sizeof(struct wav_chunk);
+		memcpy(hdr.wave, "WAVE", 4);
+		memcpy(hdr.fmt_chunk.id, "fmt ", 4);
+		hdr.fmt_chunk.size = sizeof(hdr.fmt);
+		hdr.fmt.format = WAV_FORMAT_PCM;
+		hdr.fmt.channels = fs->wav_channels;
+		hdr.fmt.rate = fs->wav_rate;
+		hdr.fmt.block_align = fs->wav_block_align;
+		hdr.fmt.byte_rate = fs->wav_rate * fs->wav_block_align;
+		hdr.fmt.bits = fs->wav_bits;
+		memcpy(hdr.data_chunk.id, "data", 4);
+		hdr.data_chunk.size = data_size;
+		memcpy(fs->map, &hdr, sizeof(hdr));
+	}
+
+	munmap(fs->map, fs->map_size);
+	fs->map = NULL;
+
+	if (ftruncate(fileno(fs->wfh), fs->map_pos) < 0)
+		fprintf(stderr, "error: truncating file %s - %s\n", fs->fn, strerror(errno));
+}
+
+/*
+ * Copy samples from a memory mapped file
+ */
+static int read_map(struct file_comp_data *cd, const struct audio_stream *sink, int samples,
+		    int sample_bytes)
+{
+	struct file_state *fs = &cd->fs;
+	uint8_t *snk = sink->w_ptr;
+	size_t bytes = MIN((size_t)samples * sample_bytes, fs->map_end - fs->map_pos);
+	size_t bytes_snk;
+	size_t copied;
+
+	bytes -= bytes % sample_bytes;
+	if (!bytes) {
+		fs->reached_eof = 1;
+		return 0;
+	}
+
+	copied = bytes;
+	while (bytes) {
+		bytes_snk = MIN(bytes, audio_stream_bytes_without_wrap(sink, snk));
+		memcpy(snk, fs->map + fs->map_pos, bytes_snk);
+		fs->map_pos += bytes_snk;
+		bytes -= bytes_snk;
+		snk = audio_stream_wrap(sink, snk + bytes_snk);
+	}
+
+	return copied / sample_bytes;
+}
+
+/*
+ * Copy samples to a memory mapped file
+ */
+static int write_map(struct file_comp_data *cd, const struct audio_stream *source, int samples,
+		     int sample_bytes)
+{
+	struct file_state *fs = &cd->fs;
+	uint8_t *src = source->r_ptr;
+	size_t bytes = (size_t)samples * sample_bytes;
+	size_t bytes_src;
+
+	if (fs->map_pos + bytes > fs->map_size &&
+	    file_map_resize(fs, MAX(fs->map_size * 2, fs->map_pos + bytes)) < 0) {
+		fs->write_failed = true;
+		return 0;
+	}
+
+	while (bytes) {
+		bytes_src = MIN(bytes, audio_stream_bytes_without_wrap(source, src));
+		memcpy(fs->map + fs->map_pos, src, bytes_src);
+		fs->map_pos += bytes_src;
+		bytes -= bytes_src;
+		src = audio_stream_wrap(source, src + bytes_src);
+	}
+
+	return samples;
+}
+
 /*
  * Helpers for s24_4le data. To avoid an overflown 24 bit to be taken as valid 32 bit
  * sample mask in file read the 8 most signing bits to zeros. In file write similarly
@@ -204,8 +479,12 @@ static int read_samples_s32(struct file_comp_data *cd, const struct audio_stream
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
-		n_samples = read_binary_s32(cd, sink, samples);
+	case FILE_WAV:
+		/* raw or WAV input file */
+		if (cd->fs.map)
+			n_samples = read_map(cd, sink, samples, sizeof(int32_t));
+		else
+			n_samples = read_binary_s32(cd, sink, samples);
 		break;
 	case FILE_TEXT:
 		/* text input file */
@@ -234,8 +513,12 @@ static int write_samples_s32(struct file_comp_data *cd, struct audio_stream *sou
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
-		samples_written = write_binary_s32(cd, source, samples);
+	case FILE_WAV:
+		/* raw or WAV output file */
+		if (cd->fs.map)
+			samples_written = write_map(cd, source, samples, sizeof(int32_t));
+		else
+			samples_written = write_binary_s32(cd, source, samples);
 		break;
 	case FILE_TEXT:
 		/* text input file */
@@ -373,8 +656,12 @@ static int read_samples_s16(struct file_comp_data *cd, const struct audio_stream
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
-		n_samples = read_binary_s16(cd, sink, samples);
+	case FILE_WAV:
+		/* raw or WAV input file */
+		if (cd->fs.map)
+			n_samples = read_map(cd, sink, samples, sizeof(int16_t));
+		else
+			n_samples = read_binary_s16(cd, sink, samples);
 		break;
 	case FILE_TEXT:
 		/* text input file */
@@ -396,8 +683,12 @@ static int write_samples_s16(struct file_comp_data *cd, struct audio_stream *sou
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
-		samples_written = write_binary_s16(cd, source, samples);
+	case FILE_WAV:
+		/* raw or WAV output file */
+		if (cd->fs.map)
+			samples_written = write_map(cd, source, samples, sizeof(int16_t));
+		else
+			samples_written = write_binary_s16(cd, source, samples);
 		break;
 	case FILE_TEXT:
 		/* text input file */
@@ -529,6 +820,9 @@ static enum file_format get_file_format(char *filename)
 	if (!strcmp(ext, ".txt"))
 		return FILE_TEXT;
 
+	if (!strcmp(ext, ".wav"))
+		return FILE_WAV;
+
 	return FILE_RAW;
 }
 
@@ -598,6 +892,10 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 				cd->fs.fn, strerror(errno));
 			goto error;
 		}
+
+		setvbuf(cd->fs.rfh, NULL, _IOFBF, FILE_STDIO_BUF_SIZE);
+		if (cd->fs.f_format != FILE_TEXT && file_map_input(&cd->fs) < 0)
+			goto error_file;
 		break;
 	case FILE_WRITE:
 		cd->fs.wfh = fopen(cd->fs.fn, "w+");
@@ -606,6 +904,12 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 				cd->fs.fn, strerror(errno));
 			goto error;
 		}
+
+		setvbuf(cd->fs.wfh, NULL, _IOFBF, FILE_STDIO_BUF_SIZE);
+		if (cd->fs.f_format != FILE_TEXT && file_map_output(&cd->fs) < 0) {
+			fclose(cd->fs.wfh);
+			goto error;
+		}
 		break;
 	default:
 		/* TODO: duplex mode */
@@ -621,7 +925,12 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	dev->state = COMP_STATE_READY;
 	return dev;
 
+error_file:
+	file_unmap(&cd->fs);
+	fclose(cd->fs.rfh);
+
 error:
+	free(cd->fs.fn);
 	free(cd);
 
 error_skip_cd:
@@ -645,6 +954,8 @@ static void file_free(struct comp_dev *dev)
 
 	comp_dbg(dev, "file_free()");
 
+	file_unmap(&cd->fs);
+
 	if (cd->fs.mode == FILE_READ)
 		fclose(cd->fs.rfh);
 	else
@@ -674,6 +985,41 @@ static int file_verify_params(struct comp_dev *dev,
 	return 0;
 }
 
+/* checks the stream format can be read from or written to a WAV file */
+static int file_wav_params(struct file_comp_data *cd, struct audio_stream *stream)
+{
+	struct file_state *fs = &cd->fs;
+	uint16_t channels = audio_stream_get_channels(stream);
+	uint16_t block_align = channels * cd->sample_container_bytes;
+
+	/* 24 bit WAV samples are packed or MSB aligned, no match for S24_4LE */
+	if (audio_stream_get_frm_fmt(stream) == SOF_IPC_FRAME_S24_4LE) {
+		fprintf(stderr, "error: S24_4LE is not supported for WAV file %s\n", fs->fn);
+		return -EINVAL;
+	}
+
+	if (fs->mode == FILE_WRITE) {
+		fs->wav_rate = audio_stream_get_rate(stream);
+		fs->wav_channels = channels;
+		fs->wav_block_align = block_align;
+		fs->wav_bits = cd->sample_container_bytes * 8;
+		return 0;
+	}
+
+	if (fs->wav_channels != channels || fs->wav_block_align != block_align) {
+		fprintf(stderr, "error: WAV file %s has %u channels of %u bits, expected %u of %d\n",
+			fs->fn, fs->wav_channels, fs->wav_bits, channels,
+			cd->sample_container_bytes * 8);
+		return -EINVAL;
+	}
+
+	if (fs->wav_rate != audio_stream_get_rate(stream))
+		fprintf(stderr, "warning: WAV file %s rate %u differs from stream rate %u\n",
+			fs->fn, fs->wav_rate, audio_stream_get_rate(stream));
+
+	return 0;
+}
+
 /**
  * \brief Sets file component audio stream parameters.
  * \param[in,out] dev Volume base component device.
@@ -760,6 +1106,12 @@ static int file_params(struct comp_dev *dev,
 	cd->sample_container_bytes = audio_stream_sample_bytes(stream);
 	buffer_reset_pos(buffer, NULL);
 
+	if (cd->fs.f_format == FILE_WAV) {
+		ret = file_wav_params(cd, stream);
+		if (ret < 0)
+			return ret;
+	}
+
 	return 0;
 }
 
@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include <stdint.h>
+#include <sof/audio/component.h>
+
+struct testbench_prm;
+
+/* percentile reported in addition to median */
+#define TB_BENCH_PERCENTILE	99
+
+/* copies of each run ignored to keep cold cache effects out of the results */
+#define TB_BENCH_WARMUP_COPIES	1
+
+/* max number of benchmarked components */
+#define TB_BENCH_MAX_COMPS	64
+
+/*
+ * Timing samples of one component, collected over all benchmark runs.
+ * Components are matched by IPC component ID, so the same topology loaded
+ * in each run accumulates to the same entry.
+ */
+struct tb_bench_comp {
+	uint32_t comp_id;
+	uint32_t pipeline_id;
+	uint32_t period_us;
+	uint32_t channels;
+	const char *name;
+	uint64_t *ticks;	/* ticks of each copy() */
+	uint32_t *frames;	/* frames of each copy() */
+	int count;
+	int size;
+	int copies_in_run;
+};
+
+/*
+ * Copy of a component driver with copy() replaced by a timing wrapper.
+ * One per component device, cd->drv points to drv for the duration of a
+ * benchmark run.
+ */
+struct tb_bench_drv {
+	struct comp_driver drv;
+	const struct comp_driver *orig;
+	struct comp_dev *cd;
+	struct tb_bench_comp *stats;
+};
+
+struct tb_benchmark {
+	struct tb_bench_comp comps[TB_BENCH_MAX_COMPS];
+	int num_comps;
+	struct tb_bench_drv *drvs[TB_BENCH_MAX_COMPS];
+	int num_drvs;
+	int runs;
+};
+
+uint32_t tb_bench_channels(struct comp_dev *cd);
+int tb_benchmark_attach(struct testbench_prm *tp);
+void tb_benchmark_detach(struct testbench_prm *tp);
+int tb_benchmark_report(struct testbench_prm *tp);
+void tb_benchmark_free(struct testbench_prm *tp);
+
+#endif
@@ -28,6 +28,9 @@
 #define NUM_WIDGETS_SUPPORTED	16
 
 struct tplg_context;
+struct tb_benchmark;
+struct tb_estimate;
+struct tb_memory;
 
 /*
  * Global testbench data.
@@ -79,6 +82,17 @@ struct testbench_prm {
 	uint32_t channels_in;
 	uint32_t channels_out;
 	enum sof_ipc_frame frame_fmt;
+
+	/* benchmark mode, see benchmark.c */
+	int bench_runs; /* number of benchmark runs, 0 when not benchmarking */
+	char *bench_json; /* benchmark results JSON file */
+	struct tb_benchmark *bench;
+
+	/* estimate mode, see estimate.c */
+	struct tb_estimate *estimate;
+
+	/* memory profile, see memory.c */
+	struct tb_memory *memory;
 };
 
 extern int debug;
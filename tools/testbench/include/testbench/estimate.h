@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef _ESTIMATE_H
+#define _ESTIMATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct testbench_prm;
+
+/* max number of module cost models */
+#define TB_EST_MAX_MODELS	64
+
+/* max length of a module name in the cost model file */
+#define TB_EST_NAME_LEN		32
+
+/*
+ * Cost of one module, calibrated from a benchmark run of the module in the
+ * same configuration. Units are the benchmark time unit.
+ */
+struct tb_est_model {
+	char name[TB_EST_NAME_LEN];
+	float per_copy;		/* ticks of each copy() on top of the frames */
+	float per_sample;	/* ticks of each frame and channel */
+};
+
+struct tb_estimate {
+	struct tb_est_model models[TB_EST_MAX_MODELS];
+	int num_models;
+	float budget_mcps;	/* load limit of each core, 0 for none */
+};
+
+int tb_estimate_load(struct testbench_prm *tp, const char *file);
+int tb_estimate_report(struct testbench_prm *tp);
+void tb_estimate_free(struct testbench_prm *tp);
+
+#endif
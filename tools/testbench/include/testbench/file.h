@@ -17,6 +17,12 @@
 #define FILE_BYTES_TO_S16_SAMPLES(s)	((s) >> 1)
 #define FILE_BYTES_TO_S32_SAMPLES(s)	((s) >> 2)
 
+/* stdio buffer size of text files and not mappable raw files */
+#define FILE_STDIO_BUF_SIZE	(1 << 20)
+
+/* initial size of memory mapped output files, doubled when full */
+#define FILE_MAP_CHUNK_SIZE	(16 << 20)
+
 /* file component modes */
 enum file_mode {
 	FILE_READ = 0,
@@ -27,6 +33,7 @@ enum file_mode {
 enum file_format {
 	FILE_TEXT = 0,
 	FILE_RAW,
+	FILE_WAV,
 };
 
 /* file component state */
@@ -40,6 +47,18 @@ struct file_state {
 	enum file_format f_format;
 	bool reached_eof;
 	bool write_failed;
+
+	/* memory mapped raw or WAV file, NULL when stdio is used */
+	uint8_t *map;
+	size_t map_size;	/* size of the mapping */
+	size_t map_pos;		/* read or write position in the mapping */
+	size_t map_end;		/* end of the sample data when reading */
+
+	/* WAV file format */
+	uint32_t wav_rate;
+	uint16_t wav_channels;
+	uint16_t wav_block_align;
+	uint16_t wav_bits;
 };
 
 /* file comp data */
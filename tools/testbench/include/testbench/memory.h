@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+#ifndef _MEMORY_H
+#define _MEMORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <rtos/alloc.h>
+#include <sof/audio/component.h>
+
+struct testbench_prm;
+
+/* max number of profiled components, the others are counted as other */
+#define TB_MEM_MAX_COMPS	64
+
+/* max number of wrapped component drivers */
+#define TB_MEM_MAX_DRVS		128
+
+/* buckets of the table of live allocations */
+#define TB_MEM_HASH_SIZE	1024
+
+#define TB_MEM_ZONES		(SOF_MEM_ZONE_SYS_SHARED + 1)
+
+/*
+ * Allocations of one owner. Components are matched by IPC component ID, so
+ * the same topology loaded in each run accumulates to the same entry.
+ */
+struct tb_mem_stats {
+	uint32_t comp_id;
+	const char *name;
+	size_t live;		/* bytes held now */
+	size_t peak;		/* max bytes held at once */
+	uint32_t allocs;
+	uint32_t hot_allocs;	/* allocations made in copy() */
+	size_t hot_bytes;
+};
+
+/* one live allocation */
+struct tb_mem_block {
+	void *ptr;
+	size_t bytes;
+	enum mem_zone zone;
+	struct tb_mem_stats *owner;
+	struct tb_mem_block *next;
+};
+
+/*
+ * Copy of a component driver with the operations replaced by wrappers that
+ * set the owner of the allocations. It replaces the original driver in the
+ * driver list, so every component created from it is profiled.
+ */
+struct tb_mem_drv {
+	struct comp_driver drv;
+	const struct comp_driver *orig;
+	struct comp_driver_info *info;
+};
+
+struct tb_memory {
+	struct tb_mem_stats other;	/* IPC, pipelines, buffers */
+	struct tb_mem_stats comps[TB_MEM_MAX_COMPS];
+	int num_comps;
+	struct tb_mem_drv drvs[TB_MEM_MAX_DRVS];
+	int num_drvs;
+	struct tb_mem_block *blocks[TB_MEM_HASH_SIZE];
+	size_t zone_live[TB_MEM_ZONES];
+	size_t zone_peak[TB_MEM_ZONES];
+	size_t live;
+	size_t peak;
+	struct tb_mem_stats *owner;	/* owner of the allocations made now */
+	bool hot;			/* inside a copy() */
+};
+
+int tb_memory_attach(struct testbench_prm *tp);
+void tb_memory_detach(struct testbench_prm *tp);
+void tb_memory_report(struct testbench_prm *tp);
+void tb_memory_free(struct testbench_prm *tp);
+
+#endif
@@ -0,0 +1,457 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/*
+ * Memory profiler of the testbench. Every rmalloc(), rzalloc(), rballoc()
+ * and module allocation of the firmware code is observed and accounted to
+ * the component whose operation made it, allocations outside of component
+ * operations go to "other". The live and peak bytes of each component and
+ * of each memory zone are reported at the end of the test, the bytes still
+ * held there are leaks. Allocations made in copy() are flagged, they cost
+ * time in the real time path and may fail under memory pressure.
+ *
+ * The owner is known by wrapping the operations of all registered component
+ * drivers, the same way the benchmark wraps copy().
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sof/audio/component.h>
+#include <sof/audio/component_ext.h>
+#include <platform/lib/context.h>
+#include "testbench/common_test.h"
+#include "testbench/memory.h"
+
+/* the allocation hooks have no context, only one profiler is active */
+static struct tb_memory *tb_mem;
+
+static const char * const tb_mem_zone_names[TB_MEM_ZONES] = {
+	[SOF_MEM_ZONE_SYS] = "sys",
+	[SOF_MEM_ZONE_SYS_RUNTIME] = "sys_runtime",
+	[SOF_MEM_ZONE_RUNTIME] = "runtime",
+	[SOF_MEM_ZONE_BUFFER] = "buffer",
+	[SOF_MEM_ZONE_RUNTIME_SHARED] = "runtime_shared",
+	[SOF_MEM_ZONE_SYS_SHARED] = "sys_shared",
+};
+
+static unsigned int tb_mem_hash(void *ptr)
+{
+	return ((uintptr_t)ptr >> 4) % TB_MEM_HASH_SIZE;
+}
+
+static void tb_mem_alloc(void *ptr, size_t bytes, enum mem_zone zone)
+{
+	struct tb_memory *mem = tb_mem;
+	struct tb_mem_stats *owner = mem->owner;
+	struct tb_mem_block *block;
+	unsigned int hash = tb_mem_hash(ptr);
+
+	/* host memory, the profiler must not observe itself */
+	block = malloc(sizeof(*block));
+	if (!block) {
+		fprintf(stderr, "error: memory profiler out of memory\n");
+		return;
+	}
+
+	if (zone >= TB_MEM_ZONES)
+		zone = SOF_MEM_ZONE_RUNTIME;
+
+	block->ptr = ptr;
+	block->bytes = bytes;
+	block->zone = zone;
+	block->owner = owner;
+	block->next = mem->blocks[hash];
+	mem->blocks[hash] = block;
+
+	owner->allocs++;
+	owner->live += bytes;
+	owner->peak = MAX(owner->peak, owner->live);
+	mem->zone_live[zone] += bytes;
+	mem->zone_peak[zone] = MAX(mem->zone_peak[zone], mem->zone_live[zone]);
+	mem->live += bytes;
+	mem->peak = MAX(mem->peak, mem->live);
+
+	if (mem->hot) {
+		if (!owner->hot_allocs)
+			fprintf(stderr, "warning: comp %u %s allocates %zu bytes in copy()\n",
+				owner->comp_id, owner->name, bytes);
+		owner->hot_allocs++;
+		owner->hot_bytes += bytes;
+	}
+}
+
+static void tb_mem_free(void *ptr)
+{
+	struct tb_memory *mem = tb_mem;
+	struct tb_mem_block **prev = &mem->blocks[tb_mem_hash(ptr)];
+	struct tb_mem_block *block;
+
+	for (block = *prev; block; prev = &block->next, block = block->next) {
+		if (block->ptr != ptr)
+			continue;
+
+		/* freed by another owner than the allocating one still counts to it */
+		block->owner->live -= block->bytes;
+		mem->zone_live[block->zone] -= block->bytes;
+		mem->live -= block->bytes;
+		*prev = block->next;
+		free(block);
+		return;
+	}
+
+	/* allocated before the profiler was attached */
+}
+
+static void tb_mem_realloc(void *old_ptr, void *ptr, size_t bytes)
+{
+	struct tb_memory *mem = tb_mem;
+	struct tb_mem_block **prev = &mem->blocks[tb_mem_hash(old_ptr)];
+	struct tb_mem_block *block;
+	unsigned int hash = tb_mem_hash(ptr);
+
+	for (block = *prev; block; prev = &block->next, block = block->next) {
+		if (block->ptr != old_ptr)
+			continue;
+
+		/* the block moves with its owner and zone, only its size changes */
+		block->owner->live = block->owner->live - block->bytes + bytes;
+		block->owner->peak = MAX(block->owner->peak, block->owner->live);
+		mem->zone_live[block->zone] = mem->zone_live[block->zone] - block->bytes + bytes;
+		mem->zone_peak[block->zone] = MAX(mem->zone_peak[block->zone],
+						  mem->zone_live[block->zone]);
+		mem->live = mem->live - block->bytes + bytes;
+		mem->peak = MAX(mem->peak, mem->live);
+
+		*prev = block->next;
+		block->ptr = ptr;
+		block->bytes = bytes;
+		block->next = mem->blocks[hash];
+		mem->blocks[hash] = block;
+		return;
+	}
+
+	/* allocated before the profiler was attached, reallocations are buffers */
+	tb_mem_alloc(ptr, bytes, SOF_MEM_ZONE_BUFFER);
+}
+
+static const struct lib_alloc_observer tb_mem_observer = {
+	.alloc = tb_mem_alloc,
+	.realloc = tb_mem_realloc,
+	.free = tb_mem_free,
+};
+
+static struct tb_mem_stats *tb_mem_get_stats(struct tb_memory *mem, uint32_t comp_id,
+					     const struct comp_driver *drv)
+{
+	struct tb_mem_stats *stats;
+	int i;
+
+	for (i = 0; i < mem->num_comps; i++)
+		if (mem->comps[i].comp_id == comp_id)
+			return &mem->comps[i];
+
+	if (mem->num_comps == TB_MEM_MAX_COMPS)
+		return &mem->other;
+
+	stats = &mem->comps[mem->num_comps++];
+	stats->comp_id = comp_id;
+	stats->name = drv->tctx && drv->tctx->uuid_p ? drv->tctx->uuid_p->name : "unknown";
+	return stats;
+}
+
+/*
+ * The device may run with a copy of the wrapper made by the benchmark, the
+ * copy keeps the UUID of the driver.
+ */
+static const struct comp_driver *tb_mem_orig(const struct comp_driver *drv)
+{
+	int i;
+
+	for (i = 0; i < tb_mem->num_drvs; i++)
+		if (&tb_mem->drvs[i].drv == drv ||
+		    (tb_mem->drvs[i].drv.uid == drv->uid && tb_mem->drvs[i].drv.type == drv->type))
+			return tb_mem->drvs[i].orig;
+
+	return NULL;
+}
+
+/* make the component the owner of the allocations, returns the previous owner */
+static struct tb_mem_stats *tb_mem_enter(struct comp_dev *dev)
+{
+	struct tb_mem_stats *prev = tb_mem->owner;
+
+	tb_mem->owner = tb_mem_get_stats(tb_mem, dev->ipc_config.id, dev->drv);
+	return prev;
+}
+
+static void tb_mem_leave(struct tb_mem_stats *prev)
+{
+	tb_mem->owner = prev;
+}
+
+static struct comp_dev *tb_mem_create(const struct comp_driver *drv,
+				      const struct comp_ipc_config *config,
+				      const void *spec)
+{
+	struct tb_mem_stats *prev = tb_mem->owner;
+	struct comp_dev *dev;
+
+	/* components created without IPC config are system objects */
+	if (config)
+		tb_mem->owner = tb_mem_get_stats(tb_mem, config->id, drv);
+
+	dev = tb_mem_orig(drv)->ops.create(drv, config, spec);
+	tb_mem_leave(prev);
+	return dev;
+}
+
+static void tb_mem_comp_free(struct comp_dev *dev)
+{
+	const struct comp_driver *orig = tb_mem_orig(dev->drv);
+	struct tb_mem_stats *prev = tb_mem_enter(dev);
+
+	orig->ops.free(dev);
+	tb_mem_leave(prev);
+}
+
+static int tb_mem_params(struct comp_dev *dev, struct sof_ipc_stream_params *params)
+{
+	struct tb_mem_stats *prev = tb_mem_enter(dev);
+	int ret;
+
+	ret = tb_mem_orig(dev->drv)->ops.params(dev, params);
+	tb_mem_leave(prev);
+	return ret;
+}
+
+static int tb_mem_cmd(struct comp_dev *dev, int cmd, void *data, int max_data_size)
+{
+	struct tb_mem_stats *prev = tb_mem_enter(dev);
+	int ret;
+
+	ret = tb_mem_orig(dev->drv)->ops.cmd(dev, cmd, data, max_data_size);
+	tb_mem_leave(prev);
+	return ret;
+}
+
+static int tb_mem_trigger(struct comp_dev *dev, int cmd)
+{
+	struct tb_mem_stats *prev = tb_mem_enter(dev);
+	int ret;
+
+	ret = tb_mem_orig(dev->drv)->ops.trigger(dev, cmd);
+	tb_mem_leave(prev);
+	return ret;
+}
+
+static int tb_mem_prepare(struct comp_dev *dev)
+{
+	struct tb_mem_stats *prev = tb_mem_enter(dev);
+	int ret;
+
+	ret = tb_mem_orig(dev->drv)->ops.prepare(dev);
+	tb_mem_leave(prev);
+	return ret;
+}
+
+static int tb_mem_reset(struct comp_dev *dev)
+{
+	struct tb_mem_stats *prev = tb_mem_enter(dev);
+	int ret;
+
+	ret = tb_mem_orig(dev->drv)->ops.reset(dev);
+	tb_mem_leave(prev);
+	return ret;
+}
+
+static int tb_mem_copy(struct comp_dev *dev)
+{
+	struct tb_mem_stats *prev = tb_mem_enter(dev);
+	bool hot = tb_mem->hot;
+	int ret;
+
+	tb_mem->hot = true;
+	ret = tb_mem_orig(dev->drv)->ops.copy(dev);
+	tb_mem->hot = hot;
+	tb_mem_leave(prev);
+	return ret;
+}
+
+static int tb_mem_bind(struct comp_dev *dev, void *data)
+{
+	struct tb_mem_stats *prev = tb_mem_enter(dev);
+	int ret;
+
+	ret = tb_mem_orig(dev->drv)->ops.bind(dev, data);
+	tb_mem_leave(prev);
+	return ret;
+}
+
+static int tb_mem_unbind(struct comp_dev *dev, void *data)
+{
+	struct tb_mem_stats *prev = tb_mem_enter(dev);
+	int ret;
+
+	ret = tb_mem_orig(dev->drv)->ops.unbind(dev, data);
+	tb_mem_leave(prev);
+	return ret;
+}
+
+static int tb_mem_set_large_config(struct comp_dev *dev, uint32_t param_id, bool first_block,
+				   bool last_block, uint32_t data_offset, const char *data)
+{
+	struct tb_mem_stats *prev = tb_mem_enter(dev);
+	int ret;
+
+	ret = tb_mem_orig(dev->drv)->ops.set_large_config(dev, param_id, first_block,
+							  last_block, data_offset, data);
+	tb_mem_leave(prev);
+	return ret;
+}
+
+/* wrap the operations the driver has, NULL operations stay NULL */
+static void tb_mem_wrap(struct tb_mem_drv *md, const struct comp_driver *drv)
+{
+	struct comp_ops *ops = &md->drv.ops;
+
+	md->orig = drv;
+	md->drv = *drv;
+	if (ops->create)
+		ops->create = tb_mem_create;
+	if (ops->free)
+		ops->free = tb_mem_comp_free;
+	if (ops->params)
+		ops->params = tb_mem_params;
+	if (ops->cmd)
+		ops->cmd = tb_mem_cmd;
+	if (ops->trigger)
+		ops->trigger = tb_mem_trigger;
+	if (ops->prepare)
+		ops->prepare = tb_mem_prepare;
+	if (ops->reset)
+		ops->reset = tb_mem_reset;
+	if (ops->copy)
+		ops->copy = tb_mem_copy;
+	if (ops->bind)
+		ops->bind = tb_mem_bind;
+	if (ops->unbind)
+		ops->unbind = tb_mem_unbind;
+	if (ops->set_large_config)
+		ops->set_large_config = tb_mem_set_large_config;
+}
+
+/*
+ * Start observing the allocations. Must be called after the component
+ * drivers are registered and before any component is created.
+ */
+int tb_memory_attach(struct testbench_prm *tp)
+{
+	struct tb_memory *mem = tp->memory;
+	struct comp_driver_info *info;
+	struct list_item *clist;
+	struct tb_mem_drv *md;
+
+	mem->other.name = "other";
+	mem->owner = &mem->other;
+
+	list_for_item(clist, &comp_drivers_get()->list) {
+		info = container_of(clist, struct comp_driver_info, list);
+		if (mem->num_drvs == TB_MEM_MAX_DRVS) {
+			fprintf(stderr, "error: max %d drivers can be profiled\n", TB_MEM_MAX_DRVS);
+			tb_memory_detach(tp);
+			return -EINVAL;
+		}
+
+		md = &mem->drvs[mem->num_drvs++];
+		tb_mem_wrap(md, info->drv);
+		md->info = info;
+		info->drv = &md->drv;
+	}
+
+	tb_mem = mem;
+	lib_alloc_observer_set(&tb_mem_observer);
+	return 0;
+}
+
+/* restore the original drivers, must be called after all components are freed */
+void tb_memory_detach(struct testbench_prm *tp)
+{
+	struct tb_memory *mem = tp->memory;
+	int i;
+
+	lib_alloc_observer_set(NULL);
+	tb_mem = NULL;
+
+	for (i = 0; i < mem->num_drvs; i++)
+		mem->drvs[i].info->drv = mem->drvs[i].orig;
+
+	mem->num_drvs = 0;
+}
+
+static void tb_mem_print_stats(const struct tb_mem_stats *stats, bool comp)
+{
+	char id[12] = "-";
+
+	if (comp)
+		snprintf(id, sizeof(id), "%u", stats->comp_id);
+
+	printf("%4s %-24s %10zu %8u %10u %10zu %10zu\n", id, stats->name, stats->peak,
+	       stats->allocs, stats->hot_allocs, stats->hot_bytes, stats->live);
+}
+
+/* report the memory use, the bytes still held are leaked by the test */
+void tb_memory_report(struct testbench_prm *tp)
+{
+	struct tb_memory *mem = tp->memory;
+	int hot = 0;
+	int i;
+
+	printf("==========================================================\n");
+	printf("		           Memory Summary\n");
+	printf("==========================================================\n");
+	printf("%4s %-24s %10s %8s %10s %10s %10s\n", "id", "module", "peak", "allocs",
+	       "copy alloc", "copy bytes", "leaked");
+	for (i = 0; i < mem->num_comps; i++) {
+		tb_mem_print_stats(&mem->comps[i], true);
+		if (mem->comps[i].hot_allocs)
+			hot++;
+	}
+	tb_mem_print_stats(&mem->other, false);
+	printf("\n");
+
+	printf("%-16s %10s %10s\n", "zone", "peak", "leaked");
+	for (i = 0; i < TB_MEM_ZONES; i++)
+		if (mem->zone_peak[i])
+			printf("%-16s %10zu %10zu\n", tb_mem_zone_names[i], mem->zone_peak[i],
+			       mem->zone_live[i]);
+	printf("%-16s %10zu %10zu\n", "total", mem->peak, mem->live);
+	printf("\n");
+
+	if (hot)
+		printf("Warning: %d modules allocate memory in copy().\n\n", hot);
+}
+
+void tb_memory_free(struct testbench_prm *tp)
+{
+	struct tb_memory *mem = tp->memory;
+	struct tb_mem_block *block;
+	int i;
+
+	if (!mem)
+		return;
+
+	for (i = 0; i < TB_MEM_HASH_SIZE; i++) {
+		while (mem->blocks[i]) {
+			block = mem->blocks[i];
+			mem->blocks[i] = block->next;
+			free(block);
+		}
+	}
+
+	free(mem);
+	tp->memory = NULL;
+}
@@ -9,11 +9,17 @@
 #include <sof/ipc/topology.h>
 #include <platform/lib/ll_schedule.h>
 #include <sof/list.h>
+#if CONFIG_SOF_CACHE_STATS
+#include <sof/lib/cache_stats.h>
+#endif
 #include <getopt.h>
 #include "testbench/common_test.h"
 #include <tplg_parser/topology.h>
 #include "testbench/trace.h"
 #include "testbench/file.h"
+#include "testbench/benchmark.h"
+#include "testbench/estimate.h"
+#include "testbench/memory.h"
 #include <limits.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -113,6 +119,8 @@ static void print_usage(char *executable)
 {
 	printf("Usage: %s <options> -i <input_file> ", executable);
 	printf("-o <output_file1,output_file2,...>\n\n");
+	printf("Files ending in .txt are text, .wav PCM WAV, others raw samples.\n");
+	printf("Raw and WAV files are memory mapped when possible.\n\n");
 	printf("Options for processing:\n");
 	printf("  -t <topology file>\n");
 	printf("  -a <comp1=comp1_library,comp2=comp2_library>, override default library\n\n");
@@ -125,6 +133,10 @@ static void print_usage(char *executable)
 	printf("  -D <pipeline duration in ms>\n");
 	printf("  -P <number of dynamic pipeline iterations>\n");
 	printf("  -T <microseconds for tick, 0 for batch mode>\n");
+	printf("  -B <number of benchmark runs>, report per module time per frame and MCPS\n");
+	printf("  -J <json file>, write benchmark results to file\n");
+	printf("  -E <cost model file>, estimate per core load and memory instead of running\n");
+	printf("  -M, report per module and per zone memory use and allocations in copy()\n");
 	printf("Options for input and output format override:\n");
 	printf("  -b <input_format>, S16_LE, S24_LE, or S32_LE\n");
 	printf("  -c <input channels>\n");
@@ -274,7 +286,7 @@ static int parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 	int option = 0;
 	int ret = 0;
 
-	while ((option = getopt(argc, argv, "hdqi:o:t:b:a:r:R:c:n:C:P:Vp:T:D:")) != -1) {
+	while ((option = getopt(argc, argv, "hdqi:o:t:b:a:r:R:c:n:C:P:Vp:T:D:B:J:E:M")) != -1) {
 		switch (option) {
 		/* input sample file */
 		case 'i':
@@ -352,6 +364,28 @@ static int parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 			tp->pipeline_duration_ms = atoi(optarg);
 			break;
 
+		/* number of benchmark runs */
+		case 'B':
+			tp->bench_runs = atoi(optarg);
+			break;
+
+		/* benchmark results JSON file */
+		case 'J':
+			tp->bench_json = strdup(optarg);
+			break;
+
+		/* estimate with a cost model instead of running */
+		case 'E':
+			ret = tb_estimate_load(tp, optarg);
+			break;
+
+		/* memory profile */
+		case 'M':
+			tp->memory = calloc(1, sizeof(*tp->memory));
+			if (!tp->memory)
+				ret = -ENOMEM;
+			break;
+
 		/* print usage */
 		case 'h':
 			print_usage(argv[0]);
@@ -614,6 +648,22 @@ static void test_pipeline_stats(struct testbench_prm *tp,
 		printf("Total execution time: %lld us, %.2f x realtime\n",
 		       delta_t, (float)frames_out / tp->fs_out * 1000000 / delta_t);
 
+#if CONFIG_SOF_CACHE_STATS
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		const struct cache_stats *cs = cache_stats_core(i);
+
+		if (!cs->invalidates && !cs->writebacks)
+			continue;
+
+		printf("Core %d cache invalidates: %u, %llu bytes, %llu cycles\n", i,
+		       cs->invalidates, (unsigned long long)cs->invalidate_bytes,
+		       (unsigned long long)cs->invalidate_cycles);
+		printf("Core %d cache writebacks: %u, %llu bytes, %llu cycles\n", i,
+		       cs->writebacks, (unsigned long long)cs->writeback_bytes,
+		       (unsigned long long)cs->writeback_cycles);
+	}
+#endif
+
 	printf("\n");
 }
 
@@ -656,6 +706,23 @@ static int pipline_test(struct testbench_prm *tp)
 			break;
 		}
 
+		if (tp->bench) {
+			err = tb_benchmark_attach(tp);
+			if (err < 0) {
+				fprintf(stderr, "error: benchmark attach %d failed %d\n",
+					dp_count, err);
+				break;
+			}
+		}
+
+		/* the estimate only needs the configured graph */
+		if (tp->estimate) {
+			err = tb_estimate_report(tp);
+			test_pipeline_reset(tp);
+			test_pipeline_free(tp);
+			return err;
+		}
+
 		err = test_pipeline_start(tp);
 		if (err < 0) {
 			fprintf(stderr, "error: pipeline run %d failed %d\n",
@@ -720,11 +787,20 @@ static int pipline_test(struct testbench_prm *tp)
 			break;
 		}
 
+		if (tp->bench)
+			tb_benchmark_detach(tp);
+
 		test_pipeline_free(tp);
 
 		dp_count++;
 	}
 
+	if (tp->bench)
+		tb_benchmark_report(tp);
+
+	if (tp->memory)
+		tb_memory_report(tp);
+
 	return 0;
 }
 
@@ -760,6 +836,11 @@ int main(int argc, char **argv)
 	tp.tick_period_us = 0; /* Execute fast non-real time, for 1 ms tick use -T 1000 */
 	tp.pipeline_duration_ms = 5000;
 	tp.copy_iterations = 1;
+	tp.bench_runs = 0;
+	tp.bench_json = NULL;
+	tp.bench = NULL;
+	tp.estimate = NULL;
+	tp.memory = NULL;
 
 	/* command line arguments*/
 	err = parse_input_args(argc, argv, &tp);
@@ -769,6 +850,16 @@ int main(int argc, char **argv)
 	if (!tp.channels_out)
 		tp.channels_out = tp.channels_in;
 
+	/* benchmark runs the same topology and input files several times */
+	if (tp.bench_runs > 0) {
+		tp.bench = calloc(1, sizeof(*tp.bench));
+		if (!tp.bench) {
+			fprintf(stderr, "error: benchmark alloc\n");
+			exit(EXIT_FAILURE);
+		}
+		tp.dynamic_pipeline_iterations = tp.bench_runs;
+	}
+
 	/* check mandatory args */
 	if (!tp.tplg_file) {
 		fprintf(stderr, "topology file not specified, use -t file.tplg\n");
@@ -806,8 +897,20 @@ int main(int argc, char **argv)
 		exit(EXIT_FAILURE);
 	}
 
+	/* drivers are registered, wrap them before any component is created */
+	if (tp.memory) {
+		err = tb_memory_attach(&tp);
+		if (err < 0) {
+			fprintf(stderr, "error: memory profile attach failed %d\n", err);
+			exit(EXIT_FAILURE);
+		}
+	}
+
 	/* build, run and teardown pipelines */
-	pipline_test(&tp);
+	err = pipline_test(&tp);
+
+	if (tp.memory)
+		tb_memory_detach(&tp);
 
 	/* free other core FW services */
 	tb_free(sof_get());
@@ -823,6 +926,10 @@ out:
 		free(tp.input_file[i]);
 
 	free(tp.pipeline_string);
+	free(tp.bench_json);
+	tb_benchmark_free(&tp);
+	tb_estimate_free(&tp);
+	tb_memory_free(&tp);
 
-	return EXIT_SUCCESS;
+	return err < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
 }
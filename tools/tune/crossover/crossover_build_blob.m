@@ -18,6 +18,12 @@ switch lower(endian)
                 error('Unknown endiannes');
 end
 
+if isfield(blob_struct, 'layout')
+	layout = blob_struct.layout;
+else
+	layout = 0;
+end
+
 %% Build Blob
 % refer to sof/src/include/user/crossover.h for the config struct.
 data_size = 4 * (2 + 4 + 4 + numel(blob_struct.all_coef));
@@ -34,7 +40,7 @@ j = abi_size + 1;
 % Insert Data
 blob8(j:j+3) = word2byte(data_size, sh); j=j+4;
 blob8(j:j+3) = word2byte(blob_struct.num_sinks, sh); j=j+4;
-blob8(j:j+3) = word2byte(0, sh); j=j+4; % Reserved
+blob8(j:j+3) = word2byte(layout, sh); j=j+4;
 blob8(j:j+3) = word2byte(0, sh); j=j+4; % Reserved
 blob8(j:j+3) = word2byte(0, sh); j=j+4; % Reserved
 blob8(j:j+3) = word2byte(0, sh); j=j+4; % Reserved
@@ -1,7 +1,15 @@
-function config = crossover_generate_config(crossover_bqs, num_sinks, assign_sinks);
+function config = crossover_generate_config(crossover_bqs, num_sinks, assign_sinks, layout);
+
+% layout - optional, 0 stores one biquad per LR4, 1 stores both biquads of
+% each LR4 for firmware to use them in place. Default is 0, the layout 1
+% is not understood by firmware versions without it.
+if nargin < 4
+	layout = 0;
+end
 
 config.num_sinks = num_sinks;
 config.assign_sinks = assign_sinks;
+config.layout = layout;
 % Interleave the coefficients for the low and high pass filters
 % For 2 way crossover we have 1 pair of LR4s.
 % For 3,4 way crossover we have 3 pair of LR4s.
@@ -14,7 +22,13 @@ j = 1;
 k = 1;
 for i = 1:n
 	config.all_coef(k:k+6) = crossover_bqs.lp_coef(j:j+6); k = k+7;
+	if layout == 1
+		config.all_coef(k:k+6) = crossover_bqs.lp_coef(j:j+6); k = k+7;
+	end
 	config.all_coef(k:k+6) = crossover_bqs.hp_coef(j:j+6); k = k+7;
+	if layout == 1
+		config.all_coef(k:k+6) = crossover_bqs.hp_coef(j:j+6); k = k+7;
+	end
 	j = j+7;
 end
 end
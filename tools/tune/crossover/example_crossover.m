@@ -8,6 +8,10 @@ cr.fc_low = 200;
 cr.fc_med = 1000;
 cr.fc_high = 3000;
 
+% Coefficients layout, 1 lets firmware use the blob in place but is not
+% understood by firmware versions without it
+cr.layout = 0;
+
 % 2 way crossover, pipeline IDs of sinks are 1 and 2 (IPC3)
 % and component output pins 0 and 1 (IPC4)
 cr.num_sinks = 2;
@@ -75,7 +79,7 @@ end
 crossover_bqs = crossover_coef_quant(crossover.lp, crossover.hp);
 
 % Convert coefficients to sof_crossover_config struct
-config = crossover_generate_config(crossover_bqs, cr.num_sinks, assign_sinks);
+config = crossover_generate_config(crossover_bqs, cr.num_sinks, assign_sinks, cr.layout);
 
 % Convert struct to binary blob
 blob8 = crossover_build_blob(config, endian, 3);
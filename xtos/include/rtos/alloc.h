@@ -69,6 +69,8 @@ enum mem_zone {
 #define SOF_MEM_FLAG_NO_COPY	BIT(1)
 /** \brief Indicates that if we should return uncached address. */
 #define SOF_MEM_FLAG_COHERENT  BIT(2)
+/** \brief Indicates that the memory is used only by the allocating core. */
+#define SOF_MEM_FLAG_CORE_LOCAL	BIT(3)
 
 /** @} */
 
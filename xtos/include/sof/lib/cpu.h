@@ -20,7 +20,9 @@
 #if !defined(__ASSEMBLER__) && !defined(LINKER)
 
 #include <arch/lib/cpu.h>
+#include <rtos/bit.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 /* let the compiler optimise when in single core mode */
 #if CONFIG_CORE_COUNT == 1
@@ -63,6 +65,23 @@ static inline int cpu_enable_core(int id)
 	return arch_cpu_enable_core(id);
 }
 
+static inline int cpu_enable_cores(uint32_t mask)
+{
+	int ret;
+	int id;
+
+	for (id = 0; id < CONFIG_CORE_COUNT; id++) {
+		if (!(mask & BIT(id)))
+			continue;
+
+		ret = cpu_enable_core(id);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
 static inline void cpu_disable_core(int id)
 {
 	arch_cpu_disable_core(id);
@@ -261,6 +261,17 @@ typedef int (*dma_process_func)(const struct audio_stream *source,
 				uint32_t ioffset, struct audio_stream *sink,
 				uint32_t ooffset, uint32_t frames);
 
+typedef int (*dma_process_att_func)(const struct audio_stream *source,
+				    uint32_t ioffset, struct audio_stream *sink,
+				    uint32_t ooffset, uint32_t frames,
+				    uint32_t attenuation);
+
+struct pcm_gain;
+typedef int (*dma_process_gain_func)(const struct audio_stream *source,
+				     uint32_t ioffset, struct audio_stream *sink,
+				     uint32_t ooffset, uint32_t frames,
+				     const struct pcm_gain *gain);
+
 /**
  * \brief API to initialize a platform DMA controllers.
  *
@@ -537,6 +548,12 @@ int dma_buffer_copy_from(struct comp_buffer *source,
 			 struct comp_buffer *sink,
 			 dma_process_func process, uint32_t source_bytes);
 
+/* copies data from DMA buffer converting and attenuating it in a single pass */
+int dma_buffer_copy_from_att(struct comp_buffer *source,
+			     struct comp_buffer *sink,
+			     dma_process_att_func process, uint32_t source_bytes,
+			     uint32_t attenuation);
+
 /*
  * Used when copying DMA buffer bytes into multiple sink buffers, one at a time using the provided
  * conversion function. DMA buffer consume should be performed after the data has been copied
@@ -546,16 +563,57 @@ int dma_buffer_copy_from_no_consume(struct comp_buffer *source,
 				    struct comp_buffer *sink,
 				    dma_process_func process, uint32_t source_bytes);
 
+int dma_buffer_copy_from_gain_no_consume(struct comp_buffer *source,
+					 struct comp_buffer *sink,
+					 dma_process_gain_func process, uint32_t source_bytes,
+					 struct pcm_gain *gain);
+
 /* copies data to DMA buffer using provided processing function */
 int dma_buffer_copy_to(struct comp_buffer *source,
 		       struct comp_buffer *sink,
 		       dma_process_func process, uint32_t sink_bytes);
 
+/*
+ * Gain variants of the copies, data is converted and the gain applied in a
+ * single pass. The gain is then advanced by the copied frames.
+ */
+int dma_buffer_copy_from_gain(struct comp_buffer *source,
+			      struct comp_buffer *sink,
+			      dma_process_gain_func process, uint32_t source_bytes,
+			      struct pcm_gain *gain);
+
+int dma_buffer_copy_to_gain(struct comp_buffer *source,
+			    struct comp_buffer *sink,
+			    dma_process_gain_func process, uint32_t sink_bytes,
+			    struct pcm_gain *gain);
+
 /* generic DMA DSP <-> Host copier */
 
+#if CONFIG_DMA_COPY_ASYNC
+/* called once all bytes of a request are copied, size is negative on error */
+typedef void (*dma_copy_cb)(void *arg, int32_t size);
+
+struct dma_copy_req {
+	struct dma_sg_config *host_sg;
+	int32_t host_offset;
+	void *local_ptr;
+	int32_t size;
+	int32_t done;		/* bytes already copied */
+	dma_copy_cb cb;
+	void *cb_arg;
+};
+#endif
+
 struct dma_copy {
 	struct dma_chan_data *chan;
 	struct dma *dmac;
+#if CONFIG_DMA_COPY_ASYNC
+	struct dma_copy_req queue[CONFIG_DMA_COPY_ASYNC_QUEUE];
+	struct k_spinlock lock;	/* protects the queue */
+	uint32_t head;		/* oldest request, free running */
+	uint32_t tail;		/* next free entry, free running */
+	int32_t in_flight;	/* bytes of the oldest request being copied */
+#endif
 };
 
 /* init dma copy context */
@@ -581,6 +639,19 @@ int dma_copy_to_host(struct dma_copy *dc, struct dma_sg_config *host_sg,
 int dma_copy_to_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg,
 			    int32_t host_offset, void *local_ptr, int32_t size);
 
+#if CONFIG_DMA_COPY_ASYNC
+/* queue DSP to host copy, cb is called from dma_copy_async_poll() once done */
+int dma_copy_to_host_async(struct dma_copy *dc, struct dma_sg_config *host_sg,
+			   int32_t host_offset, void *local_ptr, int32_t size,
+			   dma_copy_cb cb, void *cb_arg);
+
+/* complete the copy started by the previous call and start the next one */
+void dma_copy_async_poll(struct dma_copy *dc);
+
+/* drop all queued copies without calling their callbacks */
+void dma_copy_async_reset(struct dma_copy *dc);
+#endif
+
 
 int dma_copy_set_stream_tag(struct dma_copy *dc, uint32_t stream_tag);
 
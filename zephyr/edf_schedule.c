@@ -8,7 +8,11 @@
 #include <rtos/task.h>
 #include <stdint.h>
 #include <sof/schedule/edf_schedule.h>
+#include <sof/schedule/ll_schedule_domain.h>
+#include <rtos/spinlock.h>
 #include <rtos/wait.h>
+#include <sof/list.h>
+#include <errno.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys_clock.h>
@@ -22,26 +26,32 @@ static K_THREAD_STACK_DEFINE(edf_workq_stack, 8192);
  */
 #define EDF_SCHEDULE_DELAY	0
 
-static void edf_work_handler(struct k_work *work)
+/* timeout for a work item to run no earlier than deadline, in kernel ticks */
+static k_timeout_t edf_timeout(uint64_t deadline)
 {
-	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-	struct task *task = CONTAINER_OF(dwork, struct task, z_delayed_work);
+	uint64_t now = k_uptime_ticks();
+
+	if (deadline <= now)
+		return K_NO_WAIT;
 
+#if CONFIG_ZEPHYR_LL_TIMEOUT_COALESCE
+	/* share the wakeup with the LL timer tick */
+	deadline = zephyr_domain_align_expiry(timer_domain_get(), deadline);
+#endif
+
+	return K_TICKS(deadline - now);
+}
+
+static void edf_task_run(struct task *task)
+{
 	task->state = SOF_TASK_STATE_RUNNING;
 
 	task->state = task_run(task);
 
 	if (task->state == SOF_TASK_STATE_RESCHEDULE) {
-		uint64_t deadline = task_get_deadline(task);
-		uint64_t now = k_uptime_ticks();
-		k_timeout_t timeout = K_MSEC(0);
-
-		if (deadline > now)
-			timeout = K_TICKS(deadline - now);
-
 		k_work_reschedule_for_queue(&edf_workq,
 					    &task->z_delayed_work,
-					    timeout);
+					    edf_timeout(task_get_deadline(task)));
 		task->state = SOF_TASK_STATE_QUEUED;
 	} else {
 		task_complete(task);
@@ -49,6 +59,135 @@ static void edf_work_handler(struct k_work *work)
 	}
 }
 
+#if CONFIG_ZEPHYR_EDF_CLASSES
+/*
+ * A task whose start time has come is added to the ready list, sorted by its
+ * deadline: the time it became ready plus the latency target of its class. The
+ * dispatch work runs the earliest one and queues itself again behind the tasks
+ * which became ready meanwhile, so they are sorted in before the next pick.
+ */
+static const uint32_t edf_class_latency_us[EDF_CLASS_COUNT] = {
+	[EDF_CLASS_IPC] = CONFIG_ZEPHYR_EDF_IPC_LATENCY_US,
+	[EDF_CLASS_DRAIN] = CONFIG_ZEPHYR_EDF_DRAIN_LATENCY_US,
+	[EDF_CLASS_BACKGROUND] = CONFIG_ZEPHYR_EDF_BACKGROUND_LATENCY_US,
+};
+
+static struct k_spinlock edf_ready_lock;
+static struct list_item edf_ready = LIST_INIT(edf_ready);
+static struct k_work edf_dispatch_work;
+static struct edf_class_stats edf_stats[EDF_CLASS_COUNT];
+
+static enum edf_task_class edf_task_class(struct task *task)
+{
+	return task->priority < EDF_CLASS_COUNT ? task->priority : EDF_CLASS_BACKGROUND;
+}
+
+static uint64_t edf_task_deadline(struct task *task)
+{
+	return task->edf_ready +
+		k_us_to_cyc_ceil64(edf_class_latency_us[edf_task_class(task)]);
+}
+
+static void edf_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct task *task = CONTAINER_OF(dwork, struct task, z_delayed_work);
+	struct list_item *item;
+	k_spinlock_key_t key;
+	uint64_t deadline;
+
+	key = k_spin_lock(&edf_ready_lock);
+
+	/* already waiting for its turn */
+	if (!list_is_empty(&task->list)) {
+		k_spin_unlock(&edf_ready_lock, key);
+		return;
+	}
+
+	task->edf_ready = k_cycle_get_64();
+	deadline = edf_task_deadline(task);
+
+	list_for_item(item, &edf_ready) {
+		if (deadline < edf_task_deadline(container_of(item, struct task, list)))
+			break;
+	}
+	/* before the first later deadline, or at the end */
+	list_item_append(&task->list, item);
+
+	k_spin_unlock(&edf_ready_lock, key);
+
+	k_work_submit_to_queue(&edf_workq, &edf_dispatch_work);
+}
+
+static void edf_dispatch_handler(struct k_work *work)
+{
+	struct edf_class_stats *stats;
+	struct task *task = NULL;
+	k_spinlock_key_t key;
+	uint32_t delay_us;
+	uint64_t now;
+
+	key = k_spin_lock(&edf_ready_lock);
+	if (!list_is_empty(&edf_ready)) {
+		task = list_first_item(&edf_ready, struct task, list);
+		list_item_del(&task->list);
+		list_init(&task->list);
+	}
+	k_spin_unlock(&edf_ready_lock, key);
+
+	if (!task)
+		return;
+
+	now = k_cycle_get_64();
+	delay_us = k_cyc_to_us_floor64(now - task->edf_ready);
+	stats = edf_stats + edf_task_class(task);
+	stats->runs++;
+	stats->delay_sum_us += delay_us;
+	if (delay_us > stats->delay_max_us)
+		stats->delay_max_us = delay_us;
+	if (now > edf_task_deadline(task))
+		stats->misses++;
+
+	edf_task_run(task);
+
+	key = k_spin_lock(&edf_ready_lock);
+	if (!list_is_empty(&edf_ready))
+		k_work_submit_to_queue(&edf_workq, &edf_dispatch_work);
+	k_spin_unlock(&edf_ready_lock, key);
+}
+
+/* drop a task waiting in the ready list */
+static void edf_ready_remove(struct task *task)
+{
+	k_spinlock_key_t key = k_spin_lock(&edf_ready_lock);
+
+	if (!list_is_empty(&task->list)) {
+		list_item_del(&task->list);
+		list_init(&task->list);
+	}
+
+	k_spin_unlock(&edf_ready_lock, key);
+}
+
+int scheduler_edf_class_stats(enum edf_task_class cls, struct edf_class_stats *stats)
+{
+	if (cls >= EDF_CLASS_COUNT)
+		return -EINVAL;
+
+	*stats = edf_stats[cls];
+
+	return 0;
+}
+#else
+static void edf_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct task *task = CONTAINER_OF(dwork, struct task, z_delayed_work);
+
+	edf_task_run(task);
+}
+#endif
+
 /* schedule task */
 static int schedule_edf_task(void *data, struct task *task, uint64_t start,
 			     uint64_t period)
@@ -56,6 +195,11 @@ static int schedule_edf_task(void *data, struct task *task, uint64_t start,
 	/* start time is microseconds from now */
 	k_timeout_t start_time = K_USEC(start + EDF_SCHEDULE_DELAY);
 
+	/* work to be run right away, as IPC processing, is never delayed */
+	if (start)
+		start_time = edf_timeout(k_uptime_ticks() +
+					 k_us_to_ticks_ceil64(start + EDF_SCHEDULE_DELAY));
+
 	k_work_reschedule_for_queue(&edf_workq,
 				    &task->z_delayed_work,
 				    start_time);
@@ -68,6 +212,9 @@ static int schedule_edf_task_cancel(void *data, struct task *task)
 {
 	if (task->state == SOF_TASK_STATE_QUEUED) {
 		k_work_cancel_delayable(&task->z_delayed_work);
+#if CONFIG_ZEPHYR_EDF_CLASSES
+		edf_ready_remove(task);
+#endif
 
 		/* delete task */
 		task->state = SOF_TASK_STATE_CANCEL;
@@ -84,6 +231,10 @@ static int schedule_edf_task_running(void *data, struct task *task)
 
 static int schedule_edf_task_free(void *data, struct task *task)
 {
+#if CONFIG_ZEPHYR_EDF_CLASSES
+	k_work_cancel_delayable(&task->z_delayed_work);
+	edf_ready_remove(task);
+#endif
 	task->state = SOF_TASK_STATE_FREE;
 	task->ops.run = NULL;
 	task->data = NULL;
@@ -104,6 +255,10 @@ int scheduler_init_edf(void)
 
 	scheduler_init(SOF_SCHEDULE_EDF, &schedule_edf_ops, NULL);
 
+#if CONFIG_ZEPHYR_EDF_CLASSES
+	k_work_init(&edf_dispatch_work, edf_dispatch_handler);
+#endif
+
 	k_work_queue_start(&edf_workq,
 		       edf_workq_stack,
 		       K_THREAD_STACK_SIZEOF(edf_workq_stack),
@@ -126,11 +281,17 @@ int schedule_task_init_edf(struct task *task, const struct sof_uuid_entry *uid,
 {
 	int ret;
 
-	ret = schedule_task_init(task, uid, SOF_SCHEDULE_EDF, 0, ops->run, data,
-				 core, flags);
+	ret = schedule_task_init(task, uid, SOF_SCHEDULE_EDF,
+				 IS_ENABLED(CONFIG_ZEPHYR_EDF_CLASSES) ? EDF_CLASS_BACKGROUND : 0,
+				 ops->run, data, core, flags);
 	if (ret < 0)
 		return ret;
 
+#if CONFIG_ZEPHYR_EDF_CLASSES
+	/* not in the ready list */
+	list_init(&task->list);
+#endif
+
 	task->ops = *ops;
 
 	k_work_init_delayable(&task->z_delayed_work, edf_work_handler);
@@ -59,6 +59,18 @@ static inline void dcache_writeback_invalidate_region(void __sparse_cache *addr,
 	sys_cache_data_flush_and_invd_range((__sparse_force void *)addr, size);
 }
 
+/* hints only, lines of uncached addresses are not fetched */
+static inline void dcache_prefetch_region(const void *addr, size_t size)
+{
+#if defined(CONFIG_XTENSA) && CONFIG_DCACHE_LINE_SIZE > 0
+	uintptr_t line = (uintptr_t)addr & ~(uintptr_t)(DCACHE_LINE_SIZE - 1);
+	const uintptr_t end = (uintptr_t)addr + size;
+
+	for (; line < end; line += DCACHE_LINE_SIZE)
+		__asm__ __volatile__ ("dpfr %0, 0" : : "a" (line));
+#endif
+}
+
 #endif /* !defined(__ASSEMBLER__) && !defined(LINKER) */
 
 #endif /* __ZEPHYR_RTOS_CACHE_H__ */
@@ -33,6 +33,9 @@
 /** \brief IDC send core power down flag. */
 #define IDC_POWER_DOWN		3
 
+/** \brief IDC send asynchronous flag, completion collected with idc_msg_wait(). */
+#define IDC_ASYNC		4
+
 /** \brief IDC send timeout in microseconds. */
 #define IDC_TIMEOUT	10000
 
@@ -199,6 +202,8 @@ int idc_wait_in_blocking_mode(uint32_t target_core, bool (*cond)(int));
 
 int idc_msg_status_get(uint32_t core);
 
+int idc_msg_wait(uint32_t core);
+
 void idc_init_thread(void);
 
 struct idc **idc_get(void);
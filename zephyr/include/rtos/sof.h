@@ -67,6 +67,11 @@ struct sof {
 	/* DMA domain for driving DMA LL scheduler */
 	struct ll_schedule_domain *platform_dma_domain;
 
+#if CONFIG_ZEPHYR_LL_FAST_DOMAIN
+	/* timer domain with a shorter period for the fast LL scheduler */
+	struct ll_schedule_domain *platform_fast_domain;
+#endif
+
 	/* memory map */
 	struct mm *memory_map;
 
@@ -68,6 +68,15 @@ struct task {
 	uint32_t cycles_sum;
 	uint32_t cycles_max;
 	uint32_t cycles_cnt;
+#if CONFIG_ZEPHYR_EDF_CLASSES
+	uint64_t edf_ready;	/**< cycle count when the EDF task became ready */
+#endif
+#if CONFIG_ZEPHYR_LL_FLOW_ORDER
+	uint16_t flow_rank;	/**< LL tasks of lower rank run first */
+#endif
+#if CONFIG_ZEPHYR_LL_TASK_BUDGET
+	uint32_t cycles_budget;	/**< cycles a LL run may take, 0 for no budget */
+#endif
 #if CONFIG_PERFORMANCE_COUNTERS
 	struct perf_cnt_data pcd;
 #endif
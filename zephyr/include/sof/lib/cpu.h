@@ -52,6 +52,9 @@ static inline bool cpu_is_me(int id)
 
 int cpu_enable_core(int id);
 
+/* enables the cores in mask at once, returns when all of them have started */
+int cpu_enable_cores(uint32_t mask);
+
 void cpu_disable_core(int id);
 
 int cpu_is_core_enabled(int id);
@@ -73,6 +76,8 @@ static inline bool cpu_is_me(int id) { return 1; };
 
 static inline int cpu_enable_core(int id) { return 0; };
 
+static inline int cpu_enable_cores(uint32_t mask) { return 0; };
+
 static inline void cpu_disable_core(int id) { };
 
 static inline int cpu_is_core_enabled(int id) { return 1; };
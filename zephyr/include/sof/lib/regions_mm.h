@@ -109,6 +109,8 @@ struct vmh_heap *vmh_init_heap(const struct vmh_heap_config *cfg,
 void *vmh_alloc(struct vmh_heap *heap, uint32_t alloc_size);
 int vmh_free_heap(struct vmh_heap *heap);
 int vmh_free(struct vmh_heap *heap, void *ptr);
+int vmh_release_unused_pages(struct vmh_heap *heap);
+uint32_t vmh_get_bank_pages(uint32_t bank);
 struct vmh_heap *vmh_reconfigure_heap(struct vmh_heap *heap,
 		struct vmh_heap_config *cfg, int core_id, bool allocating_continuously);
 void vmh_get_default_heap_config(const struct sys_mm_drv_region *region,
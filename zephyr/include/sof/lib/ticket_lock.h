@@ -0,0 +1,151 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright(c) 2023 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file
+ * \brief Fair spinlock for locks contended by several cores
+ *
+ * With CONFIG_SOF_TICKET_LOCK the lock is a ticket lock: each core takes
+ * the next ticket and spins until it is served, so the cores get the lock
+ * in the order in which they asked for it and no core can be starved by
+ * the others. Otherwise the lock is a plain k_spinlock, so the users need
+ * no conditional code.
+ *
+ * With CONFIG_SOF_LOCK_STATS every lock initialized with a name counts its
+ * acquisitions, the contended acquisitions, the cycles spent waiting and
+ * the longest hold time. The counters are posted to the telemetry buffers.
+ */
+
+#ifndef __ZEPHYR_SOF_LIB_TICKET_LOCK_H__
+#define __ZEPHYR_SOF_LIB_TICKET_LOCK_H__
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/** \brief Contention counters of a single lock, updated with the lock held. */
+struct ticket_lock_stats {
+	const char *name;		/**< name reported to the host */
+	uint32_t acquires;		/**< number of acquisitions */
+	uint32_t contended;		/**< acquisitions which had to wait */
+	uint64_t spin_cycles;		/**< total cycles spent waiting */
+	uint32_t max_hold_cycles;	/**< longest time the lock was held */
+	uint32_t hold_start;		/**< cycle count of the last acquisition */
+};
+
+struct ticket_lock {
+#if CONFIG_SOF_TICKET_LOCK
+	atomic_t next;			/**< next ticket to hand out */
+	atomic_t owner;			/**< ticket being served */
+#else
+	struct k_spinlock lock;
+#endif
+#if CONFIG_SOF_LOCK_STATS
+	struct ticket_lock_stats stats;
+#endif
+};
+
+#if CONFIG_SOF_LOCK_STATS
+/**
+ * \brief Registers the lock for reporting of its contention counters.
+ * @param lock Lock to register.
+ * @param name Name of the lock, up to 15 characters are reported.
+ */
+void ticket_lock_stats_register(struct ticket_lock *lock, const char *name);
+
+/**
+ * \brief Posts contention counters of all registered locks to telemetry.
+ */
+void ticket_lock_stats_post(void);
+#endif
+
+/**
+ * \brief Initializes the lock.
+ * @param lock Lock to initialize.
+ * @param name Name used for contention statistics.
+ */
+static inline void ticket_lock_init(struct ticket_lock *lock, const char *name)
+{
+#if CONFIG_SOF_TICKET_LOCK
+	atomic_set(&lock->next, 0);
+	atomic_set(&lock->owner, 0);
+#else
+	lock->lock = (struct k_spinlock){};
+#endif
+#if CONFIG_SOF_LOCK_STATS
+	ticket_lock_stats_register(lock, name);
+#endif
+}
+
+/**
+ * \brief Disables local interrupts and acquires the lock.
+ * @param lock Lock to acquire.
+ * @return Key to be passed to ticket_lock_release().
+ */
+static inline k_spinlock_key_t ticket_lock_acquire(struct ticket_lock *lock)
+{
+	k_spinlock_key_t key;
+#if CONFIG_SOF_LOCK_STATS
+	uint32_t start = k_cycle_get_32();
+	uint32_t now;
+	bool contended;
+#endif
+
+#if CONFIG_SOF_TICKET_LOCK
+	atomic_val_t ticket;
+
+	key.key = arch_irq_lock();
+	ticket = atomic_inc(&lock->next);
+#if CONFIG_SOF_LOCK_STATS
+	contended = atomic_get(&lock->owner) != ticket;
+#endif
+	while (atomic_get(&lock->owner) != ticket)
+		arch_spin_relax();
+#else
+#if CONFIG_SOF_LOCK_STATS
+	contended = k_spin_trylock(&lock->lock, &key) != 0;
+	if (contended)
+#endif
+		key = k_spin_lock(&lock->lock);
+#endif
+
+#if CONFIG_SOF_LOCK_STATS
+	now = k_cycle_get_32();
+	lock->stats.acquires++;
+	if (contended) {
+		lock->stats.contended++;
+		lock->stats.spin_cycles += now - start;
+	}
+	lock->stats.hold_start = now;
+#endif
+
+	return key;
+}
+
+/**
+ * \brief Releases the lock and restores local interrupts.
+ * @param lock Lock to release.
+ * @param key Key returned by ticket_lock_acquire().
+ */
+static inline void ticket_lock_release(struct ticket_lock *lock, k_spinlock_key_t key)
+{
+#if CONFIG_SOF_LOCK_STATS
+	uint32_t hold = k_cycle_get_32() - lock->stats.hold_start;
+
+	if (hold > lock->stats.max_hold_cycles)
+		lock->stats.max_hold_cycles = hold;
+#endif
+
+#if CONFIG_SOF_TICKET_LOCK
+	atomic_inc(&lock->owner);
+	arch_irq_unlock(key.key);
+#else
+	k_spin_unlock(&lock->lock, key);
+#endif
+}
+
+#endif /* __ZEPHYR_SOF_LIB_TICKET_LOCK_H__ */
@@ -9,10 +9,12 @@
 #include <rtos/idc.h>
 #include <rtos/interrupt.h>
 #include <sof/drivers/interrupt-map.h>
+#include <sof/lib/cpu.h>
 #include <sof/lib/dma.h>
 #include <sof/schedule/schedule.h>
 #include <platform/drivers/interrupt.h>
 #include <sof/lib/notifier.h>
+#include <sof/lib/ticket_lock.h>
 #include <sof/lib/pm_runtime.h>
 #include <sof/audio/pipeline.h>
 #include <sof/audio/component_ext.h>
@@ -31,6 +33,10 @@
 #include <zephyr/sys/sys_heap.h>
 #endif
 
+#if CONFIG_SOF_ZEPHYR_VIRTUAL_HEAP
+#include <sof/lib/regions_mm.h>
+#endif
+
 LOG_MODULE_REGISTER(mem_allocator, CONFIG_SOF_LOG_LEVEL);
 
 extern struct tr_ctx zephyr_tr;
@@ -98,9 +104,11 @@ extern char _end[], _heap_sentry[];
 #endif
 
 static struct k_heap sof_heap;
+static struct ticket_lock sof_heap_lock;
 
 #if CONFIG_L3_HEAP
 static struct k_heap l3_heap;
+static struct ticket_lock l3_heap_lock;
 
 /**
  * Returns the start of L3 memory heap.
@@ -154,17 +162,73 @@ static bool is_l3_heap_pointer(void *ptr)
 }
 #endif
 
+#if CONFIG_SOF_ZEPHYR_CORE_HEAP
+/*
+ * Per core heaps for memory used only by the allocating core, like module
+ * state, buffers between components of the same core and DP thread stacks.
+ * Each core allocates from its own heap under its own lock, so the heap
+ * metadata and lock cache lines are not bounced between cores. The heaps are
+ * carved out of the SOF heap at boot, when the heap of a core is exhausted
+ * the SOF heap is used.
+ */
+struct core_heap {
+	struct k_heap heap;
+	struct ticket_lock lock;
+	uintptr_t start;	/* uncached address of the heap memory */
+	uintptr_t end;		/* uncached address past the heap memory */
+};
+
+static struct core_heap core_heaps[CONFIG_CORE_COUNT];
+
+static struct core_heap *core_heap_get(void *ptr)
+{
+	uintptr_t addr;
+	int core;
+
+#ifdef CONFIG_SOF_ZEPHYR_HEAP_CACHED
+	if (is_cached(ptr))
+		ptr = z_soc_uncached_ptr((__sparse_force void __sparse_cache *)ptr);
+#endif
+
+	addr = POINTER_TO_UINT(ptr);
+	for (core = 0; core < CONFIG_CORE_COUNT; core++)
+		if (addr >= core_heaps[core].start && addr < core_heaps[core].end)
+			return &core_heaps[core];
+
+	return NULL;
+}
+#endif /* CONFIG_SOF_ZEPHYR_CORE_HEAP */
+
+/*
+ * The heaps are used by all cores and only through the functions below, so
+ * they are protected by SOF locks instead of the k_heap ones.
+ */
+static struct ticket_lock *heap_lock(struct k_heap *h)
+{
+#if CONFIG_L3_HEAP
+	if (h == &l3_heap)
+		return &l3_heap_lock;
+#endif
+#if CONFIG_SOF_ZEPHYR_CORE_HEAP
+	/* blocks of a core heap may be freed by another core */
+	if (h != &sof_heap)
+		return &CONTAINER_OF(h, struct core_heap, heap)->lock;
+#endif
+	return &sof_heap_lock;
+}
+
 static void *heap_alloc_aligned(struct k_heap *h, size_t min_align, size_t bytes)
 {
+	struct ticket_lock *lock = heap_lock(h);
 	k_spinlock_key_t key;
 	void *ret;
 #if CONFIG_SYS_HEAP_RUNTIME_STATS && CONFIG_IPC_MAJOR_4
 	struct sys_memory_stats stats;
 #endif
 
-	key = k_spin_lock(&h->lock);
+	key = ticket_lock_acquire(lock);
 	ret = sys_heap_aligned_alloc(&h->heap, min_align, bytes);
-	k_spin_unlock(&h->lock, key);
+	ticket_lock_release(lock, key);
 
 #if CONFIG_SYS_HEAP_RUNTIME_STATS && CONFIG_IPC_MAJOR_4
 	sys_heap_runtime_stats_get(&h->heap, &stats);
@@ -206,7 +270,8 @@ static void __sparse_cache *heap_alloc_aligned_cached(struct k_heap *h,
 
 static void heap_free(struct k_heap *h, void *mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	struct ticket_lock *lock = heap_lock(h);
+	k_spinlock_key_t key = ticket_lock_acquire(lock);
 #ifdef CONFIG_SOF_ZEPHYR_HEAP_CACHED
 	void *mem_uncached;
 
@@ -221,8 +286,215 @@ static void heap_free(struct k_heap *h, void *mem)
 
 	sys_heap_free(&h->heap, mem);
 
-	k_spin_unlock(&h->lock, key);
+	ticket_lock_release(lock, key);
+}
+
+#if CONFIG_SOF_ZEPHYR_OBJ_SLAB
+/*
+ * Per core slab caches for small runtime objects. Buffers, component devices,
+ * module and IPC helper structures are created and freed on every pipeline
+ * create and delete, serving them from fixed size blocks keeps the heap from
+ * fragmenting and takes only the lock of the slab instead of the heap one.
+ * The slab memory is carved out of the heap once at boot.
+ */
+static const size_t obj_slab_sizes[] = { 64, 128, 256, 512, 1024 };
+
+#define OBJ_SLAB_CLASSES	ARRAY_SIZE(obj_slab_sizes)
+
+struct obj_slab {
+	struct k_mem_slab slab;
+	uintptr_t start;	/* uncached address of the first block */
+	uintptr_t end;		/* uncached address past the last block */
+	size_t block_size;
+};
+
+static struct obj_slab obj_slabs[CONFIG_CORE_COUNT][OBJ_SLAB_CLASSES];
+
+static void *obj_slab_alloc(size_t bytes)
+{
+	struct obj_slab *cache = obj_slabs[cpu_get_id()];
+	void *ptr;
+	int i;
+
+	for (i = 0; i < OBJ_SLAB_CLASSES; i++) {
+		if (bytes > cache[i].block_size)
+			continue;
+
+		/* fall back to the heap if the matching class is exhausted */
+		if (k_mem_slab_alloc(&cache[i].slab, &ptr, K_NO_WAIT))
+			return NULL;
+
+		return ptr;
+	}
+
+	return NULL;
+}
+
+static struct obj_slab *obj_slab_get(void *ptr)
+{
+	uintptr_t addr = POINTER_TO_UINT(ptr);
+	int core, i;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++)
+		for (i = 0; i < OBJ_SLAB_CLASSES; i++)
+			if (addr >= obj_slabs[core][i].start && addr < obj_slabs[core][i].end)
+				return &obj_slabs[core][i];
+
+	return NULL;
+}
+
+/* returns false if the pointer doesn't belong to any slab */
+static bool obj_slab_free(void *ptr)
+{
+	struct obj_slab *cache;
+	void *mem = ptr;
+
+#ifdef CONFIG_SOF_ZEPHYR_HEAP_CACHED
+	if (is_cached(ptr))
+		mem = z_soc_uncached_ptr((__sparse_force void __sparse_cache *)ptr);
+#endif
+
+	cache = obj_slab_get(mem);
+	if (!cache)
+		return false;
+
+#ifdef CONFIG_SOF_ZEPHYR_HEAP_CACHED
+	if (mem != ptr)
+		sys_cache_data_flush_and_invd_range(ptr, cache->block_size);
+#endif
+
+	/* blocks may be freed by any core, the slab has its own lock */
+	k_mem_slab_free(&cache->slab, mem);
+
+	return true;
+}
+
+static int obj_slab_init(void)
+{
+	struct obj_slab *cache;
+	size_t bytes;
+	void *mem;
+	int core, i;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		for (i = 0; i < OBJ_SLAB_CLASSES; i++) {
+			cache = &obj_slabs[core][i];
+			cache->block_size = ALIGN_UP(obj_slab_sizes[i], PLATFORM_DCACHE_ALIGN);
+			bytes = cache->block_size * CONFIG_SOF_ZEPHYR_OBJ_SLAB_BLOCKS;
+
+			mem = heap_alloc_aligned(&sof_heap, PLATFORM_DCACHE_ALIGN, bytes);
+			if (!mem)
+				return -ENOMEM;
+
+			cache->start = POINTER_TO_UINT(mem);
+			cache->end = cache->start + bytes;
+			k_mem_slab_init(&cache->slab, mem, cache->block_size,
+					CONFIG_SOF_ZEPHYR_OBJ_SLAB_BLOCKS);
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_SOF_ZEPHYR_OBJ_SLAB */
+
+#if CONFIG_SOF_ZEPHYR_CORE_HEAP
+static int core_heap_init(void)
+{
+	const size_t bytes = ALIGN_UP(CONFIG_SOF_ZEPHYR_CORE_HEAP_SIZE, PLATFORM_DCACHE_ALIGN);
+	struct core_heap *core_heap;
+	void *mem;
+	int core;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		core_heap = &core_heaps[core];
+		mem = heap_alloc_aligned(&sof_heap, PLATFORM_DCACHE_ALIGN, bytes);
+		if (!mem)
+			return -ENOMEM;
+
+		core_heap->start = POINTER_TO_UINT(mem);
+		core_heap->end = core_heap->start + bytes;
+		sys_heap_init(&core_heap->heap.heap, mem, bytes);
+		ticket_lock_init(&core_heap->lock, "core_heap");
+	}
+
+	return 0;
+}
+
+/* core local memory is never accessed by other cores, so it is always cached */
+static void *core_heap_alloc(uint32_t flags, size_t bytes, uint32_t align)
+{
+	if (!(flags & SOF_MEM_FLAG_CORE_LOCAL) || (flags & SOF_MEM_FLAG_COHERENT))
+		return NULL;
+
+	return (__sparse_force void *)heap_alloc_aligned_cached(&core_heaps[cpu_get_id()].heap,
+								 align, bytes);
 }
+#endif /* CONFIG_SOF_ZEPHYR_CORE_HEAP */
+
+#if CONFIG_SOF_ZEPHYR_VIRTUAL_HEAP
+/*
+ * Large buffers are served from per core virtual heaps. Physical pages are
+ * mapped when a block is allocated and unmapped when no allocation uses them
+ * any longer, so memory banks can power down with few streams active. The
+ * heaps are created on first use and are only usable from their own core.
+ */
+static struct vmh_heap *virtual_heaps[CONFIG_CORE_COUNT];
+static struct k_spinlock virtual_heap_lock;
+
+static void *virtual_heap_alloc(size_t bytes, uint32_t align)
+{
+	int core = cpu_get_id();
+	struct vmh_heap_config cfg = { 0 };
+	k_spinlock_key_t key;
+	void *ptr = NULL;
+
+	if (bytes < CONFIG_SOF_ZEPHYR_VIRTUAL_HEAP_MIN_SIZE || align > DCACHE_LINE_SIZE)
+		return NULL;
+
+	key = k_spin_lock(&virtual_heap_lock);
+
+	if (!virtual_heaps[core]) {
+		vmh_get_default_heap_config(&sys_mm_drv_query_memory_regions()[core], &cfg);
+		virtual_heaps[core] = vmh_init_heap(&cfg, MEM_REG_ATTR_CORE_HEAP, core, true);
+	}
+
+	if (virtual_heaps[core])
+		ptr = vmh_alloc(virtual_heaps[core], bytes);
+
+	k_spin_unlock(&virtual_heap_lock, key);
+
+	return ptr;
+}
+
+static bool virtual_heap_free(void *ptr)
+{
+	const struct sys_mm_drv_region *region;
+	k_spinlock_key_t key;
+	int core;
+	int ret;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		if (!virtual_heaps[core])
+			continue;
+
+		region = virtual_heaps[core]->virtual_region;
+		if (!vmh_is_ptr_in_memory_range((uintptr_t)ptr, (uintptr_t)region->addr,
+						region->size))
+			continue;
+
+		key = k_spin_lock(&virtual_heap_lock);
+		ret = vmh_free(virtual_heaps[core], ptr);
+		k_spin_unlock(&virtual_heap_lock, key);
+		if (ret < 0)
+			tr_err(&zephyr_tr, "virtual heap free %p of core %d failed: %d",
+			       ptr, core, ret);
+
+		return true;
+	}
+
+	return false;
+}
+#endif /* CONFIG_SOF_ZEPHYR_VIRTUAL_HEAP */
 
 static inline bool zone_is_cached(enum mem_zone zone)
 {
@@ -257,6 +529,29 @@ void *rmalloc(enum mem_zone zone, uint32_t flags, uint32_t caps, size_t bytes)
 		heap = &sof_heap;
 	}
 
+#if CONFIG_SOF_ZEPHYR_CORE_HEAP
+	if (heap == &sof_heap) {
+		ptr = core_heap_alloc(flags, bytes, 0);
+		if (ptr)
+			return ptr;
+	}
+#endif
+
+#if CONFIG_SOF_ZEPHYR_OBJ_SLAB
+	/* small runtime objects come from the per core slabs */
+	if (heap == &sof_heap && (zone == SOF_MEM_ZONE_RUNTIME ||
+				  zone == SOF_MEM_ZONE_RUNTIME_SHARED)) {
+		ptr = obj_slab_alloc(bytes);
+		if (ptr) {
+#ifdef CONFIG_SOF_ZEPHYR_HEAP_CACHED
+			if (zone_is_cached(zone) && !(flags & SOF_MEM_FLAG_COHERENT))
+				ptr = (__sparse_force void *)z_soc_cached_ptr(ptr);
+#endif
+			return ptr;
+		}
+	}
+#endif
+
 	if (zone_is_cached(zone) && !(flags & SOF_MEM_FLAG_COHERENT)) {
 		ptr = (__sparse_force void *)heap_alloc_aligned_cached(heap, 0, bytes);
 	} else {
@@ -332,10 +627,26 @@ void *rzalloc(enum mem_zone zone, uint32_t flags, uint32_t caps, size_t bytes)
 void *rballoc_align(uint32_t flags, uint32_t caps, size_t bytes,
 		    uint32_t align)
 {
+	void *ptr;
+
 	if (flags & SOF_MEM_FLAG_COHERENT)
 		return heap_alloc_aligned(&sof_heap, align, bytes);
 
-	return (__sparse_force void *)heap_alloc_aligned_cached(&sof_heap, align, bytes);
+#if CONFIG_SOF_ZEPHYR_VIRTUAL_HEAP
+	ptr = virtual_heap_alloc(bytes, align);
+	if (ptr)
+		return ptr;
+#endif
+
+#if CONFIG_SOF_ZEPHYR_CORE_HEAP
+	ptr = core_heap_alloc(flags, bytes, align);
+	if (ptr)
+		return ptr;
+#endif
+
+	ptr = (__sparse_force void *)heap_alloc_aligned_cached(&sof_heap, align, bytes);
+
+	return ptr;
 }
 
 /*
@@ -343,6 +654,10 @@ void *rballoc_align(uint32_t flags, uint32_t caps, size_t bytes,
  */
 void rfree(void *ptr)
 {
+#if CONFIG_SOF_ZEPHYR_CORE_HEAP
+	struct core_heap *core_heap;
+#endif
+
 	if (!ptr)
 		return;
 
@@ -353,18 +668,52 @@ void rfree(void *ptr)
 	}
 #endif
 
+#if CONFIG_SOF_ZEPHYR_OBJ_SLAB
+	if (obj_slab_free(ptr))
+		return;
+#endif
+
+#if CONFIG_SOF_ZEPHYR_VIRTUAL_HEAP
+	if (virtual_heap_free(ptr))
+		return;
+#endif
+
+#if CONFIG_SOF_ZEPHYR_CORE_HEAP
+	core_heap = core_heap_get(ptr);
+	if (core_heap) {
+		heap_free(&core_heap->heap, ptr);
+		return;
+	}
+#endif
+
 	heap_free(&sof_heap, ptr);
 }
 
 static int heap_init(void)
 {
+#if CONFIG_SOF_ZEPHYR_CORE_HEAP
+	int ret;
+#endif
+
 	sys_heap_init(&sof_heap.heap, heapmem, HEAPMEM_SIZE);
+	ticket_lock_init(&sof_heap_lock, "sof_heap");
 
 #if CONFIG_L3_HEAP
 	sys_heap_init(&l3_heap.heap, UINT_TO_POINTER(get_l3_heap_start()), get_l3_heap_size());
+	ticket_lock_init(&l3_heap_lock, "l3_heap");
 #endif
 
+#if CONFIG_SOF_ZEPHYR_CORE_HEAP
+	ret = core_heap_init();
+	if (ret < 0)
+		return ret;
+#endif
+
+#if CONFIG_SOF_ZEPHYR_OBJ_SLAB
+	return obj_slab_init();
+#else
 	return 0;
+#endif
 }
 
 SYS_INIT(heap_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
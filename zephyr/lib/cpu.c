@@ -13,6 +13,9 @@
 #include <sof/init.h>
 #include <sof/lib/cpu.h>
 #include <sof/lib/pm_runtime.h>
+#if CONFIG_SOF_ZEPHYR_VIRTUAL_HEAP
+#include <sof/lib/regions_mm.h>
+#endif
 #include <ipc/topology.h>
 #include <rtos/alloc.h>
 
@@ -28,7 +31,7 @@ extern K_KERNEL_STACK_ARRAY_DEFINE(z_interrupt_stacks, CONFIG_MP_MAX_NUM_CPUS,
 				   CONFIG_ISR_STACK_SIZE);
 
 static atomic_t start_flag;
-static atomic_t ready_flag;
+static atomic_t ready_flag;	/* bit mask of the started cores */
 
 /* Zephyr kernel_internal.h interface */
 extern void smp_timer_init(void);
@@ -43,7 +46,7 @@ static FUNC_NORETURN void secondary_init(void *arg)
 	 * secondary_core_init() for each core.
 	 */
 
-	atomic_set(&ready_flag, 1);
+	atomic_or(&ready_flag, BIT(arch_proc_id()));
 	z_smp_thread_init(arg, &dummy_thread);
 	smp_timer_init();
 
@@ -75,6 +78,19 @@ extern void *global_imr_ram_storage;
 
 void cpu_notify_state_entry(enum pm_state state)
 {
+#if CONFIG_SOF_ZEPHYR_VIRTUAL_HEAP
+	struct vmh_heap *heap;
+
+	/* give back pages freed since last idle so their banks can be gated, and
+	 * before D3 so that they aren't saved to IMR and restored on resume
+	 */
+	if (state == PM_STATE_RUNTIME_IDLE || state == PM_STATE_SOFT_OFF) {
+		heap = vmh_get_heap_by_attribute(MEM_REG_ATTR_CORE_HEAP, arch_proc_id());
+		if (heap)
+			vmh_release_unused_pages(heap);
+	}
+#endif
+
 	if (!cpu_is_primary(arch_proc_id()))
 		return;
 
@@ -113,7 +129,7 @@ void cpu_notify_state_exit(enum pm_state state)
 			/* Notifying primary core that secondary core successfully exit the D3
 			 * state and is back in the Idle thread.
 			 */
-			atomic_set(&ready_flag, 1);
+			atomic_or(&ready_flag, BIT(arch_proc_id()));
 			return;
 		}
 #endif
@@ -129,36 +145,43 @@ void cpu_notify_state_exit(enum pm_state state)
 	}
 }
 
-int cpu_enable_core(int id)
+int cpu_enable_cores(uint32_t mask)
 {
+	uint32_t started = 0;
+	int id;
+
 	/* only called from single core, no RMW lock */
 	__ASSERT_NO_MSG(cpu_is_primary(arch_proc_id()));
 	/*
 	 * This is an open-coded version of zephyr/kernel/smp.c
 	 * z_smp_start_cpu(). We do this, so we can use a customized
-	 * secondary_init() for SOF.
+	 * secondary_init() for SOF. All cores are started before waiting,
+	 * so that their restore from D3 or their boot overlap.
 	 */
 
-	if (arch_cpu_active(id))
-		return 0;
+	atomic_clear(&start_flag);
+	atomic_clear(&ready_flag);
+
+	for (id = 0; id < CONFIG_MP_MAX_NUM_CPUS; id++) {
+		if (!(mask & BIT(id)) || arch_cpu_active(id))
+			continue;
 
 #if ZEPHYR_VERSION(3, 0, 99) <= ZEPHYR_VERSION_CODE
-	/* During kernel initialization, the next pm state is set to ACTIVE. By checking this
-	 * value, we determine if this is the first core boot, if not, we need to skip idle thread
-	 * initialization. By reinitializing the idle thread, we would overwrite the kernel structs
-	 * and the idle thread stack.
-	 */
-	if (pm_state_next_get(id)->state == PM_STATE_ACTIVE)
-		z_init_cpu(id);
+		/* During kernel initialization, the next pm state is set to ACTIVE. By checking
+		 * this value, we determine if this is the first core boot, if not, we need to skip
+		 * idle thread initialization. By reinitializing the idle thread, we would overwrite
+		 * the kernel structs and the idle thread stack.
+		 */
+		if (pm_state_next_get(id)->state == PM_STATE_ACTIVE)
+			z_init_cpu(id);
 #endif
 
-	atomic_clear(&start_flag);
-	atomic_clear(&ready_flag);
-
-	arch_start_cpu(id, z_interrupt_stacks[id], CONFIG_ISR_STACK_SIZE,
-		       secondary_init, &start_flag);
+		arch_start_cpu(id, z_interrupt_stacks[id], CONFIG_ISR_STACK_SIZE,
+			       secondary_init, &start_flag);
+		started |= BIT(id);
+	}
 
-	while (!atomic_get(&ready_flag))
+	while ((atomic_get(&ready_flag) & started) != started)
 		k_busy_wait(100);
 
 	atomic_set(&start_flag, 1);
@@ -166,6 +189,11 @@ int cpu_enable_core(int id)
 	return 0;
 }
 
+int cpu_enable_core(int id)
+{
+	return cpu_enable_cores(BIT(id));
+}
+
 void cpu_disable_core(int id)
 {
 	/* only called from single core, no RMW lock */
@@ -237,6 +265,17 @@ int cpu_enable_core(int id)
 	return 0;
 }
 
+int cpu_enable_cores(uint32_t mask)
+{
+	int id;
+
+	for (id = 0; id < CONFIG_CORE_COUNT; id++)
+		if (mask & BIT(id))
+			cpu_enable_core(id);
+
+	return 0;
+}
+
 int cpu_enable_secondary_core(int id)
 {
 	/*
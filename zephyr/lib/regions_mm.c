@@ -6,12 +6,61 @@
  */
 
 #include <zephyr/init.h>
+#include <zephyr/spinlock.h>
 
+#include <sof/lib/memory.h>
 #include <sof/lib/regions_mm.h>
 
 /* list of vmh_heap objects created */
 static struct list_item vmh_list;
 
+/* number of mapped virtual heap pages in each HPSRAM bank */
+static uint16_t vmh_bank_pages[PLATFORM_HPSRAM_EBB_COUNT];
+static struct k_spinlock vmh_bank_lock;
+
+/**
+ * @brief Update bank occupancy for a page
+ *
+ * Finds the HPSRAM bank backing the virtual page and counts the page in or
+ * out of it. Must be called while the page is still mapped.
+ * @param page_ptr Virtual address of the page.
+ * @param mapped True when the page was just mapped, false before unmapping.
+ */
+static void vmh_bank_page_update(uintptr_t page_ptr, bool mapped)
+{
+	k_spinlock_key_t key;
+	uintptr_t phys;
+	uint32_t bank;
+
+	if (sys_mm_drv_page_phys_get((void *)page_ptr, &phys))
+		return;
+
+	bank = (phys - L2_SRAM_BASE) / SRAM_BANK_SIZE;
+	if (bank >= PLATFORM_HPSRAM_EBB_COUNT)
+		return;
+
+	key = k_spin_lock(&vmh_bank_lock);
+	if (mapped)
+		vmh_bank_pages[bank]++;
+	else if (vmh_bank_pages[bank])
+		vmh_bank_pages[bank]--;
+	k_spin_unlock(&vmh_bank_lock, key);
+}
+
+/**
+ * @brief Unmap a physical page of a heap
+ *
+ * The memory management driver powers a bank down once the last page
+ * mapped from it is released, so pages are always unmapped through here
+ * to keep the bank occupancy in sync.
+ * @param page_ptr Virtual address of the page.
+ */
+static void vmh_unmap_page(uintptr_t page_ptr)
+{
+	vmh_bank_page_update(page_ptr, false);
+	sys_mm_drv_unmap_region((void *)page_ptr, CONFIG_MM_DRV_PAGE_SIZE);
+}
+
 /**
  * @brief Initialize new heap
  *
@@ -409,6 +458,8 @@ void *vmh_alloc(struct vmh_heap *heap, uint32_t alloc_size)
 			ptrs_to_map[i] = (uintptr_t)NULL;
 			goto fail;
 		}
+
+		vmh_bank_page_update(phys_block_ptr, true);
 	}
 
 	/* Set back allocation bits */
@@ -430,8 +481,7 @@ fail:
 		 */
 		for (i = 0; i < physical_block_count; i++) {
 			if (ptrs_to_map[i])
-				sys_mm_drv_unmap_region((void *)ptrs_to_map[i],
-					CONFIG_MM_DRV_PAGE_SIZE);
+				vmh_unmap_page(ptrs_to_map[i]);
 		}
 		rfree(ptrs_to_map);
 	}
@@ -502,6 +552,9 @@ int vmh_free(struct vmh_heap *heap, void *ptr)
 	for (mem_block_iter = 0, ptr_range_found = false;
 		mem_block_iter < MAX_MEMORY_ALLOCATORS_COUNT;
 		mem_block_iter++) {
+		if (!heap->physical_blocks_allocators[mem_block_iter])
+			continue;
+
 		block_size =
 			1 << heap->physical_blocks_allocators[mem_block_iter]->info.blk_sz_shift;
 
@@ -600,7 +653,7 @@ int vmh_free(struct vmh_heap *heap, void *ptr)
 
 	/* Calculate how many blocks we need to check */
 	physical_block_count = (phys_aligned_alloc_end
-		- phys_aligned_alloc_end) / CONFIG_MM_DRV_PAGE_SIZE;
+		- phys_aligned_ptr) / CONFIG_MM_DRV_PAGE_SIZE;
 
 	/* Unmap physical blocks that are not currently used
 	 * we check that by looking for allocations on mem_block
@@ -613,18 +666,78 @@ int vmh_free(struct vmh_heap *heap, void *ptr)
 			- (uintptr_t)heap->physical_blocks_allocators[mem_block_iter]->buffer;
 		check_position = check_offset / block_size;
 
-		check_size = CONFIG_MM_DRV_PAGE_SIZE / block_size;
+		check_size = MAX(CONFIG_MM_DRV_PAGE_SIZE / block_size, 1);
 
 		if (sys_bitarray_is_region_cleared(
 				heap->physical_blocks_allocators[mem_block_iter]->bitmap,
-				check_size, check_offset))
-			sys_mm_drv_unmap_region((void *)phys_block_ptr,
-					CONFIG_MM_DRV_PAGE_SIZE);
+				check_size, check_position))
+			vmh_unmap_page(phys_block_ptr);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Release physical pages without live allocations
+ *
+ * Walks all allocators of the heap and unmaps every mapped page that no
+ * longer holds an allocated block, so that banks left without mapped pages
+ * can be powered down by the memory management driver. Intended to be
+ * called on low power state entry.
+ * @param heap Pointer to the heap to be trimmed.
+ *
+ * @retval 0 on success;
+ * @retval -EINVAL if called from a core not owning the heap.
+ */
+int vmh_release_unused_pages(struct vmh_heap *heap)
+{
+	struct sys_mem_blocks *allocator;
+	uintptr_t page_ptr, buffer_end, phys;
+	size_t i, block_size, check_size;
+
+	if (heap->core_id != cpu_get_id())
+		return -EINVAL;
+
+	for (i = 0; i < MAX_MEMORY_ALLOCATORS_COUNT; i++) {
+		allocator = heap->physical_blocks_allocators[i];
+		if (!allocator)
+			continue;
+
+		block_size = 1 << allocator->info.blk_sz_shift;
+		check_size = MAX(CONFIG_MM_DRV_PAGE_SIZE / block_size, 1);
+		buffer_end = (uintptr_t)allocator->buffer +
+			allocator->info.num_blocks * block_size;
+
+		for (page_ptr = (uintptr_t)allocator->buffer; page_ptr < buffer_end;
+		     page_ptr += CONFIG_MM_DRV_PAGE_SIZE) {
+			/* skip pages that are not mapped */
+			if (sys_mm_drv_page_phys_get((void *)page_ptr, &phys))
+				continue;
+
+			if (sys_bitarray_is_region_cleared(allocator->bitmap, check_size,
+					(page_ptr - (uintptr_t)allocator->buffer) / block_size))
+				vmh_unmap_page(page_ptr);
+		}
 	}
 
 	return 0;
 }
 
+/**
+ * @brief Get number of virtual heap pages mapped from a bank
+ *
+ * @param bank HPSRAM bank index.
+ *
+ * @retval number of pages mapped by the virtual heaps in the bank.
+ */
+uint32_t vmh_get_bank_pages(uint32_t bank)
+{
+	if (bank >= PLATFORM_HPSRAM_EBB_COUNT)
+		return 0;
+
+	return vmh_bank_pages[bank];
+}
+
 /**
  * @brief Reconfigure heap with given config
  *
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2023 Intel Corporation. All rights reserved.
+
+/**
+ * \file
+ * \brief Contention statistics of the cross-core locks
+ *
+ * Locks are registered when initialized, usually once at boot. The
+ * counters of all registered locks are posted to the telemetry buffers
+ * periodically by the telemetry task while telemetry is started.
+ */
+
+#include <sof/common.h>
+#include <sof/debug/telemetry/telemetry.h>
+#include <sof/lib/ticket_lock.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <stdint.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(ticket_lock, CONFIG_SOF_LOG_LEVEL);
+
+static struct ticket_lock *lock_stats_locks[CONFIG_SOF_LOCK_STATS_MAX];
+static atomic_t lock_stats_count;
+
+void ticket_lock_stats_register(struct ticket_lock *lock, const char *name)
+{
+	atomic_val_t idx;
+
+	lock->stats = (struct ticket_lock_stats){ .name = name };
+
+	idx = atomic_inc(&lock_stats_count);
+	if (idx >= CONFIG_SOF_LOCK_STATS_MAX) {
+		atomic_dec(&lock_stats_count);
+		LOG_WRN("no room to report statistics of lock %s", name);
+		return;
+	}
+
+	lock_stats_locks[idx] = lock;
+}
+
+void ticket_lock_stats_post(void)
+{
+	struct telemetry_lock_stats record;
+	const struct ticket_lock_stats *stats;
+	int count = MIN(atomic_get(&lock_stats_count), CONFIG_SOF_LOCK_STATS_MAX);
+	int i;
+
+	for (i = 0; i < count; i++) {
+		stats = &lock_stats_locks[i]->stats;
+		if (!stats->acquires)
+			continue;
+
+		memset(&record, 0, sizeof(record));
+		strncpy(record.name, stats->name, sizeof(record.name) - 1);
+
+		/* read without the lock, the counters may be one acquisition apart */
+		record.acquires = stats->acquires;
+		record.contended = stats->contended;
+		record.spin_cycles = stats->spin_cycles;
+		record.max_hold_cycles = stats->max_hold_cycles;
+
+		telemetry_post(TELEMETRY_RECORD_LOCK_STATS, i, &record, sizeof(record));
+	}
+}